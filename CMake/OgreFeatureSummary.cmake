@@ -149,6 +149,9 @@ endif ()
 if (OGRE_BUILD_TESTS)
 	set(_programs "${_programs}  + Tests\n")
 endif ()
+if (OGRE_BUILD_BENCHMARKS)
+	set(_programs "${_programs}  + Benchmarks\n")
+endif ()
 if (OGRE_BUILD_TOOLS)
 	set(_programs "${_programs}  + Tools\n")
 endif ()
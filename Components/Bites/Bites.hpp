@@ -3,6 +3,7 @@ export module Ogre.Components.Bites;
 export import :AdvancedRenderControls;
 export import :ApplicationContext;
 export import :ApplicationContextBase;
+export import :ApplicationContextHeadless;
 export import :CameraMan;
 export import :ConfigDialog;
 export import :Input;
@@ -109,10 +109,7 @@ namespace OgreBites
         void closeApp();
 
         // callback interface copied from various listeners to be used by ApplicationContext
-        auto frameStarted(const Ogre::FrameEvent& evt) -> bool override {
-            pollEvents();
-            return true;
-        }
+        auto frameStarted(const Ogre::FrameEvent& evt) -> bool override;
         auto frameRenderingQueued(const Ogre::FrameEvent& evt) -> bool override;
         auto frameEnded(const Ogre::FrameEvent& evt) noexcept -> bool override { return true; }
         virtual void windowMoved(Ogre::RenderWindow* rw) {}
@@ -206,6 +203,33 @@ namespace OgreBites
         */
         virtual void pollEvents();
 
+        /**
+        Limits the frame rate, 0 for no limit.
+        @remarks
+            Each frame start is delayed until its due time. The loop sleeps until shortly
+            before that and spins for the rest, as sleeping alone overshoots by up to a
+            scheduler tick. A frame which starts later than one period after its due time
+            restarts the schedule, so no burst of frames follows a hitch.
+        */
+        void setTargetFrameRate(Ogre::Real fps) { mTargetFrameRate = fps; }
+        [[nodiscard]] auto getTargetFrameRate() const noexcept -> Ogre::Real { return mTargetFrameRate; }
+
+        /**
+        Waits for the GPU to finish the previous frame before polling the input of a frame.
+        @remarks
+            The input is then shown by the very next frame, instead of after the frames the
+            driver queued up. This costs the overlap of the CPU and GPU work.
+        @see Ogre::RenderSystem::_waitForFramesInFlight
+        */
+        void setLowLatencyMode(bool enabled) { mLowLatencyMode = enabled; }
+        [[nodiscard]] auto getLowLatencyMode() const noexcept -> bool { return mLowLatencyMode; }
+
+        /**
+        Sets how many frames the CPU may queue up ahead of the GPU.
+        @see Ogre::RenderSystem::setMaxFramesInFlight
+        */
+        void setMaxFramesInFlight(Ogre::uint32 frames);
+
         /**
         Creates dummy scene to allow rendering GUI in viewport.
           */
@@ -289,6 +313,13 @@ namespace OgreBites
 
         Ogre::RTShader::ShaderGenerator*       mShaderGenerator; // The Shader generator instance.
         SGTechniqueResolverListener*       mMaterialMgrListener; // Shader generator material manager listener.
+
+        Ogre::Real mTargetFrameRate{0};
+        bool mLowLatencyMode{false};
+        Ogre::uint64 mNextFrameTime{0};    // due time of the next frame in microseconds, 0 to restart
+
+        /// internal method to delay the start of a frame, see setTargetFrameRate and setLowLatencyMode
+        void paceFrame();
     };
 
     /** @} */
@@ -0,0 +1,47 @@
+// This file is part of the OGRE project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at https://www.ogre3d.org/licensing.
+module;
+
+#include <cstdint>
+
+export module Ogre.Components.Bites:ApplicationContextHeadless;
+
+export import :ApplicationContextBase;
+
+export
+namespace OgreBites
+{
+    /** \addtogroup Optional
+    *  @{
+    */
+    /** \addtogroup Bites
+    *  @{
+    */
+    /**
+    Context for rendering without a display, e.g. thumbnails or video on GPU servers.
+    @remarks
+        The windows are created hidden and have no native window. With the EGL GL support
+        (OGRE_GLSUPPORT_USE_EGL) they are offscreen surfaces, so no display server is needed.
+        The config dialog is never shown: a saved config is restored, else the first
+        RenderSystem is used with its defaults. There is no input, the rendered frames are
+        meant to be read back, see Ogre::RenderTarget::startContentsReadback.
+    */
+    class ApplicationContextHeadless : public ApplicationContextBase
+    {
+    public:
+        explicit ApplicationContextHeadless(std::string_view appName = "Ogre3D");
+
+        auto oneTimeConfig() -> bool override;
+
+        /// nothing to poll without windows
+        void pollEvents() override {}
+
+        auto
+        createWindow(std::string_view name, uint32_t w = 0, uint32_t h = 0,
+                     Ogre::NameValuePairList miscParams = Ogre::NameValuePairList()) -> NativeWindowPair override;
+    };
+
+    /** @} */
+    /** @} */
+}
@@ -737,6 +737,70 @@ namespace OgreBites
         Ogre::Real mProgress{0.0f};
     };
 
+    /**
+    Performance HUD, graphs of the CPU and GPU frame time above a breakdown of the frame.
+    @remarks
+        The values are the Profiler counters Root publishes every frame, so nothing is shown
+        while the Profiler is disabled. The GPU frame time requires Profiler::setGPUTiming.
+        The budget rows add up the SceneManager::RenderLoopStats of all scene managers, the
+        memory rows are the usage of the texture, mesh and GPU program managers.
+    */
+    class PerformanceHUD : public ParamsPanel
+    {
+    public:
+
+        /// Do not instantiate any widgets directly. Use TrayManager.
+        PerformanceHUD(std::string_view name, Ogre::Real width, unsigned int samples = 64);
+
+        /**
+        Adds the CPU and GPU time of the frame just rendered to the graphs.
+        */
+        void addFrame();
+
+        /**
+        Updates the budget breakdown and the memory counters.
+        */
+        void updateStats();
+
+        /**
+        Sets the frame time shown at the top of the graphs, in milliseconds.
+        */
+        void setGraphRange(Ogre::Real milliseconds)
+        {
+            mGraphRange = milliseconds;
+        }
+
+        auto getGraphRange() -> Ogre::Real
+        {
+            return mGraphRange;
+        }
+
+    protected:
+
+        struct Graph
+        {
+            Ogre::OverlayContainer* panel;
+            std::vector<Ogre::OverlayElement*> bars;
+        };
+
+        /**
+        Internal method - creates the panel and bars of a graph.
+        */
+        auto createGraph(std::string_view name, std::string_view material, Ogre::Real top, unsigned int samples) -> Graph;
+
+        /**
+        Internal method - sets the bar heights of a graph, the oldest sample on the left.
+        */
+        void updateGraph(const Graph& graph, const std::vector<Ogre::Real>& samples);
+
+        Graph mCPUGraph;
+        Graph mGPUGraph;
+        std::vector<Ogre::Real> mCPUSamples;   // ring buffer of CPU frame times in ms
+        std::vector<Ogre::Real> mGPUSamples;   // ring buffer of GPU frame times in ms
+        size_t mNextSample{0};
+        Ogre::Real mGraphRange{33.3f};
+    };
+
     /**
     Main class to manage a cursor, backdrop, trays and widgets.
     */
@@ -911,6 +975,28 @@ namespace OgreBites
             if (mFpsLabel) labelHit(mFpsLabel);
         }
 
+        /**
+        Shows the performance HUD in the specified location.
+        @remarks
+            Turns on the GPU timing of the Profiler until the HUD is hidden.
+        */
+        void showPerformanceHUD(TrayLocation trayLoc, size_t place = -1);
+
+        /**
+        Hides the performance HUD.
+        */
+        void hidePerformanceHUD();
+
+        auto isPerformanceHUDVisible() -> bool
+        {
+            return mPerformanceHUD != nullptr;
+        }
+
+        auto getPerformanceHUD() -> PerformanceHUD*
+        {
+            return mPerformanceHUD;
+        }
+
         /**
         Shows logo in the specified location.
         */
@@ -1167,6 +1253,7 @@ namespace OgreBites
         bool mCursorWasVisible{false};               // cursor state before showing dialog
         Label* mFpsLabel{nullptr};                     // FPS label
         ParamsPanel* mStatsPanel{nullptr};             // frame stats panel
+        PerformanceHUD* mPerformanceHUD{nullptr};      // performance HUD
         DecorWidget* mLogo{nullptr};                   // logo
         Ogre::Real mGroupInitProportion{0.0f};      // proportion of load job assigned to initialising one resource group
         Ogre::Real mGroupLoadProportion{0.0f};      // proportion of load job assigned to loading one resource group
@@ -17,15 +17,19 @@ import Ogre.Components.Overlay;
 import Ogre.Components.RTShaderSystem;
 import Ogre.Core;
 
-import <ios>;
+import <chrono>;
 import <map>;
 import <ranges>;
 import <string>;
+import <thread>;
 import <type_traits>;
 
 namespace OgreBites {
 
 static const char constexpr SHADER_CACHE_FILENAME[] = "cache.bin";
+static const char constexpr CAPABILITIES_CACHE_FILENAME[] = "capabilities.rendercaps";
+/// remaining time of a paced frame which is spun instead of slept, in microseconds
+static Ogre::uint64 constexpr FRAME_PACING_SPIN_TIME = 2000;
 
 ApplicationContextBase::ApplicationContextBase(std::string_view appName)
 {
@@ -132,7 +136,11 @@ void ApplicationContextBase::destroyRTShaderSystem()
 
 void ApplicationContextBase::setup()
 {
+    // the capabilities are probed once per device and driver
+    mRoot->getRenderSystem()->setCapabilitiesCacheFile(mFSLayer->getWritablePath(CAPABILITIES_CACHE_FILENAME));
     mRoot->initialise(false);
+    // programs linked in earlier sessions are loaded from there, new ones appended
+    Ogre::GpuProgramManager::getSingleton().setMicrocodeCacheFile(mFSLayer->getWritablePath(SHADER_CACHE_FILENAME));
     createWindow(mAppName);
 
     locateResources();
@@ -215,6 +223,50 @@ void ApplicationContextBase::removeInputListener(NativeWindowType* win, InputLis
     mInputListeners.erase(std::make_pair(0, lis));
 }
 
+auto ApplicationContextBase::frameStarted(const Ogre::FrameEvent& evt) -> bool
+{
+    paceFrame();
+    pollEvents();
+    return true;
+}
+
+void ApplicationContextBase::paceFrame()
+{
+    if (mTargetFrameRate > 0)
+    {
+        Ogre::Timer* timer = mRoot->getTimer();
+        auto period = Ogre::uint64(1000000 / mTargetFrameRate);
+        Ogre::uint64 now = timer->getMicroseconds();
+
+        if (mNextFrameTime == 0 || now > mNextFrameTime + period)
+        {
+            mNextFrameTime = now;
+        }
+        else
+        {
+            if (now + FRAME_PACING_SPIN_TIME < mNextFrameTime)
+                std::this_thread::sleep_for(std::chrono::microseconds(mNextFrameTime - now - FRAME_PACING_SPIN_TIME));
+            while (timer->getMicroseconds() < mNextFrameTime)
+                std::this_thread::yield();
+        }
+        mNextFrameTime += period;
+    }
+    else
+    {
+        mNextFrameTime = 0;
+    }
+
+    // after the pacing, so the input is sampled as late as possible
+    if (mLowLatencyMode && mRoot->getRenderSystem())
+        mRoot->getRenderSystem()->_waitForFramesInFlight(0);
+}
+
+void ApplicationContextBase::setMaxFramesInFlight(Ogre::uint32 frames)
+{
+    Ogre::OgreAssert(mRoot && mRoot->getRenderSystem(), "create the root and select a RenderSystem first");
+    mRoot->getRenderSystem()->setMaxFramesInFlight(frames);
+}
+
 auto ApplicationContextBase::frameRenderingQueued(const Ogre::FrameEvent& evt) -> bool
 {
     for(const auto & mInputListener : mInputListeners) {
@@ -417,22 +469,6 @@ void ApplicationContextBase::reconfigure(std::string_view renderer, Ogre::NameVa
 
 void ApplicationContextBase::shutdown()
 {
-    const auto& gpuMgr = Ogre::GpuProgramManager::getSingleton();
-    if (gpuMgr.getSaveMicrocodesToCache() && gpuMgr.isCacheDirty())
-    {
-        Ogre::String path = mFSLayer->getWritablePath(SHADER_CACHE_FILENAME);
-        std::fstream outFile(path.c_str(), std::ios::out | std::ios::binary);
-
-        if (outFile.is_open())
-        {
-            Ogre::LogManager::getSingleton().logMessage(::std::format("Writing shader cache to {}", path));
-            Ogre::DataStreamPtr ostream(new Ogre::FileStreamDataStream(path, &outFile, false));
-            gpuMgr.saveMicrocodeCache(ostream);
-        }
-        else
-            Ogre::LogManager::getSingleton().logWarning(::std::format("Cannot open shader cache for writing {}", path));
-    }
-
     // Destroy the RT Shader System.
     destroyRTShaderSystem();
 
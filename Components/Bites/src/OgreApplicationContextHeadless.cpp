@@ -0,0 +1,44 @@
+// This file is part of the OGRE project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at https://www.ogre3d.org/licensing.
+module;
+
+#include <cstdint>
+
+module Ogre.Components.Bites;
+
+import :ApplicationContextHeadless;
+
+import Ogre.Core;
+
+namespace OgreBites {
+
+ApplicationContextHeadless::ApplicationContextHeadless(std::string_view appName)
+    : ApplicationContextBase(appName)
+{
+}
+
+auto ApplicationContextHeadless::oneTimeConfig() -> bool
+{
+    if(mRoot->getAvailableRenderers().empty())
+    {
+        Ogre::LogManager::getSingleton().logError("No RenderSystems available");
+        return false;
+    }
+
+    // nobody is there to answer a dialog
+    if (!mRoot->restoreConfig())
+        mRoot->setRenderSystem(mRoot->getAvailableRenderers().front());
+
+    return true;
+}
+
+auto ApplicationContextHeadless::createWindow(std::string_view name, uint32_t w, uint32_t h, Ogre::NameValuePairList miscParams) -> NativeWindowPair
+{
+    miscParams["hidden"] = "true";
+    // nothing is displayed, so there is nothing to wait for
+    miscParams["vsync"] = "false";
+    return ApplicationContextBase::createWindow(name, w, h, miscParams);
+}
+
+}
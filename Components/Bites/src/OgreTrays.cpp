@@ -1108,6 +1108,142 @@ void ProgressBar::setProgress(Ogre::Real progress)
     mFill->setWidth(std::max<int>((int)mFill->getHeight(), (int)(mProgress * (mMeter->getWidth() - 2 * mFill->getLeft()))));
 }
 
+static Ogre::Real constexpr HUD_GRAPH_HEIGHT = 40;
+static Ogre::Real constexpr HUD_GRAPH_SPACING = 5;
+
+// sums a counter over all scene managers, which publish it as "<name>/<counter>"
+static auto sumSceneCounter(const Ogre::ProfileCounterMap& counters, std::string_view counter) -> Ogre::uint64
+{
+    Ogre::uint64 sum = 0;
+    for (const auto& [name, value] : counters)
+    {
+        if (name.size() > counter.size() && name.ends_with(counter) && name[name.size() - counter.size() - 1] == '/')
+            sum += value;
+    }
+    return sum;
+}
+
+static auto formatMilliseconds(Ogre::uint64 microseconds) -> Ogre::String
+{
+    return ::std::format("{:.2f} ms", microseconds / 1000.0);
+}
+
+static auto formatMegabytes(size_t bytes) -> Ogre::String
+{
+    return ::std::format("{:.1f} MB", bytes / (1024.0 * 1024.0));
+}
+
+PerformanceHUD::PerformanceHUD(std::string_view name, Ogre::Real width, unsigned int samples)
+    : ParamsPanel(name, width, 0)
+    , mCPUSamples(samples, 0)
+    , mGPUSamples(samples, 0)
+{
+    Ogre::StringVector rows;
+    rows.push_back("CPU frame");
+    rows.push_back("GPU frame");
+    rows.push_back("Scene update");
+    rows.push_back("Culling");
+    rows.push_back("Queue sort");
+    rows.push_back("Submission");
+    rows.push_back("Shadows");
+    rows.push_back("Compositor");
+    rows.push_back("Draw calls");
+    rows.push_back("Textures");
+    rows.push_back("Meshes");
+    rows.push_back("GPU programs");
+    setAllParamNames(rows);
+
+    // the graphs go below the text
+    Ogre::Real top = mElement->getHeight() - mNamesArea->getTop() + HUD_GRAPH_SPACING;
+    mCPUGraph = createGraph(::std::format("{}/CPUGraph", getName()), "SdkTrays/Button/Up", top, samples);
+    top += HUD_GRAPH_HEIGHT + HUD_GRAPH_SPACING;
+    mGPUGraph = createGraph(::std::format("{}/GPUGraph", getName()), "SdkTrays/Button/Over", top, samples);
+    mElement->setHeight(top + HUD_GRAPH_HEIGHT + mNamesArea->getTop());
+}
+
+auto PerformanceHUD::createGraph(std::string_view name, std::string_view material, Ogre::Real top, unsigned int samples) -> Graph
+{
+    Ogre::OverlayManager& om = Ogre::OverlayManager::getSingleton();
+
+    Graph graph;
+    graph.panel = (Ogre::OverlayContainer*)om.createOverlayElement("Panel", name);
+    graph.panel->setMetricsMode(Ogre::GuiMetricsMode::PIXELS);
+    graph.panel->setMaterialName("SdkTrays/MiniTextBox");
+    graph.panel->setLeft(mNamesArea->getLeft());
+    graph.panel->setTop(top);
+    graph.panel->setWidth(mElement->getWidth() - 2 * mNamesArea->getLeft());
+    graph.panel->setHeight(HUD_GRAPH_HEIGHT);
+    ((Ogre::OverlayContainer*)mElement)->addChild(graph.panel);
+
+    Ogre::Real barWidth = graph.panel->getWidth() / samples;
+    for (unsigned int i = 0; i < samples; i++)
+    {
+        Ogre::OverlayElement* bar = om.createOverlayElement("Panel", ::std::format("{}/Bar{}", name, i));
+        bar->setMetricsMode(Ogre::GuiMetricsMode::PIXELS);
+        bar->setMaterialName(material);
+        bar->setLeft(i * barWidth);
+        bar->setWidth(barWidth);
+        bar->setTop(HUD_GRAPH_HEIGHT);
+        bar->setHeight(0);
+        graph.panel->addChild(bar);
+        graph.bars.push_back(bar);
+    }
+
+    return graph;
+}
+
+void PerformanceHUD::addFrame()
+{
+    Ogre::Profiler& profiler = Ogre::Profiler::getSingleton();
+    const Ogre::ProfileCounterMap& counters = profiler.getCounters();
+
+    auto it = counters.find("Frame/cpuMicroseconds");
+    mCPUSamples[mNextSample] = it != counters.end() ? it->second / 1000.0f : 0;
+    mGPUSamples[mNextSample] = profiler.getGPUFrameTime();
+    mNextSample = (mNextSample + 1) % mCPUSamples.size();
+
+    updateGraph(mCPUGraph, mCPUSamples);
+    updateGraph(mGPUGraph, mGPUSamples);
+}
+
+void PerformanceHUD::updateGraph(const Graph& graph, const std::vector<Ogre::Real>& samples)
+{
+    for (size_t i = 0; i < graph.bars.size(); i++)
+    {
+        Ogre::Real sample = samples[(mNextSample + i) % samples.size()];
+        Ogre::Real height = std::round(Ogre::Math::Clamp<Ogre::Real>(sample / mGraphRange, 0, 1) * HUD_GRAPH_HEIGHT);
+        graph.bars[i]->setTop(HUD_GRAPH_HEIGHT - height);
+        graph.bars[i]->setHeight(height);
+    }
+}
+
+void PerformanceHUD::updateStats()
+{
+    Ogre::Profiler& profiler = Ogre::Profiler::getSingleton();
+    const Ogre::ProfileCounterMap& counters = profiler.getCounters();
+
+    auto counter = [&](std::string_view name) -> Ogre::uint64
+    {
+        auto it = counters.find(name);
+        return it != counters.end() ? it->second : 0;
+    };
+
+    Ogre::StringVector values;
+    values.push_back(formatMilliseconds(counter("Frame/cpuMicroseconds")));
+    values.push_back(profiler.getGPUTiming() ? ::std::format("{:.2f} ms", profiler.getGPUFrameTime()) : "-");
+    values.push_back(formatMilliseconds(sumSceneCounter(counters, "updateMicroseconds")));
+    values.push_back(formatMilliseconds(sumSceneCounter(counters, "cullMicroseconds")));
+    values.push_back(formatMilliseconds(sumSceneCounter(counters, "sortMicroseconds")));
+    values.push_back(formatMilliseconds(sumSceneCounter(counters, "submitMicroseconds")));
+    values.push_back(formatMilliseconds(sumSceneCounter(counters, "shadowMicroseconds")));
+    values.push_back(formatMilliseconds(sumSceneCounter(counters, "compositorMicroseconds")));
+    values.push_back(Ogre::StringConverter::toString(counter("RenderSystem/drawCalls")));
+    values.push_back(formatMegabytes(Ogre::TextureManager::getSingleton().getMemoryUsage()));
+    values.push_back(formatMegabytes(Ogre::MeshManager::getSingleton().getMemoryUsage()));
+    values.push_back(formatMegabytes(Ogre::GpuProgramManager::getSingleton().getMemoryUsage()));
+    setAllParamValues(values);
+}
+
 TrayManager::TrayManager(std::string_view name, Ogre::RenderWindow *window, TrayListener *listener) :
     mName(name), mWindow(window), mWidgetDeathRow(), mListener(listener)
 {
@@ -1549,6 +1685,26 @@ void TrayManager::hideFrameStats()
     }
 }
 
+void TrayManager::showPerformanceHUD(TrayLocation trayLoc, size_t place)
+{
+    if (!isPerformanceHUDVisible())
+    {
+        mPerformanceHUD = new PerformanceHUD(::std::format("{}/PerformanceHUD", mName), 240);
+        Ogre::Profiler::getSingleton().setGPUTiming(true);
+    }
+
+    moveWidgetToTray(mPerformanceHUD, trayLoc, place);
+}
+
+void TrayManager::hidePerformanceHUD()
+{
+    if (isPerformanceHUDVisible())
+    {
+        destroyWidget(mPerformanceHUD);
+        mPerformanceHUD = nullptr;
+    }
+}
+
 void TrayManager::showLogo(TrayLocation trayLoc, size_t place)
 {
     if (!isLogoVisible()) mLogo = createDecorWidget(TrayLocation::NONE, ::std::format("{}/Logo", mName), "SdkTrays/Logo");
@@ -1761,6 +1917,11 @@ void TrayManager::destroyWidget(Widget *widget)
     if (widget == mLogo) mLogo = nullptr;
     else if (widget == mStatsPanel) mStatsPanel = nullptr;
     else if (widget == mFpsLabel) mFpsLabel = nullptr;
+    else if (widget == mPerformanceHUD)
+    {
+        mPerformanceHUD = nullptr;
+        Ogre::Profiler::getSingleton().setGPUTiming(false);
+    }
 
     mTrays[std::to_underlying(widget->getTrayLocation())]->removeChild(widget->getName());
 
@@ -1841,7 +2002,20 @@ void TrayManager::frameRendered(const Ogre::FrameEvent &evt)
 
 
     unsigned long currentTime = mTimer->getMilliseconds();
-    if (areFrameStatsVisible() && currentTime - mLastStatUpdateTime >= FRAME_UPDATE_DELAY)
+    bool statsDue = currentTime - mLastStatUpdateTime >= FRAME_UPDATE_DELAY;
+
+    if (isPerformanceHUDVisible())
+    {
+        // the graphs follow every frame, the text only as fast as it can be read
+        mPerformanceHUD->addFrame();
+        if (statsDue)
+        {
+            mLastStatUpdateTime = currentTime;
+            mPerformanceHUD->updateStats();
+        }
+    }
+
+    if (areFrameStatsVisible() && statsDue)
     {
         Ogre::RenderTarget::FrameStats stats = mWindow->getStatistics();
 
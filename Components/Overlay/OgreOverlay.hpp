@@ -27,6 +27,7 @@ THE SOFTWARE.
 */
 export module Ogre.Components.Overlay;
 
+export import :Batch;
 export import :BorderPanelOverlayElement;
 export import :Container;
 export import :Element;
@@ -107,6 +108,8 @@ namespace Ogre {
         bool mVisible{false};
         bool mInitialised{false};
         String mOrigin;
+        /// See setBatching
+        ::std::unique_ptr<OverlayBatcher> mBatcher;
         /** Internal lazy update method. */
         void updateTransform() const;
         /** Internal method for initialising an overlay */
@@ -259,9 +262,25 @@ namespace Ogre {
         /** Used to transform the overlay when scrolling, scaling etc. */
         void _getWorldTransforms(Matrix4* xform) const;
 
+        /** Sets whether the 2D elements are merged into few draws.
+        @remarks
+            Elements with the same material are then drawn from one dynamic vertex buffer,
+            per range of Z-orders in which nothing else is drawn, see OverlayBatcher.
+            This pays off for overlays of many small elements, like a HUD of panels and text.
+            The default is false.
+        */
+        void setBatching(bool enabled);
+        /** Gets whether the 2D elements are merged into few draws. */
+        auto getBatching() const noexcept -> bool { return mBatcher != nullptr; }
+        /** Gets the batcher used if setBatching is enabled, nullptr otherwise. */
+        auto _getBatcher() const noexcept -> OverlayBatcher* { return mBatcher.get(); }
+
         /** Internal method to put the overlay contents onto the render queue. */
         virtual void _findVisibleObjects(Camera* cam, RenderQueue* queue, Viewport* vp);
 
+        /** Releases the vertex buffers of the batches, see OverlayElement::_releaseManualHardwareResources. */
+        void _releaseManualHardwareResources();
+
         /** This returns a OverlayElement at position x,y. */
         virtual auto findElementAt(Real x, Real y) -> OverlayElement*;
 
@@ -239,6 +239,8 @@ namespace Ogre {
             mUseIdentityView = true;
             mPolygonModeOverrideable = parent->getPolygonModeOverrideable();
         }
+        /** Gets the panel this border belongs to. */
+        [[nodiscard]] auto getParent() const noexcept -> BorderPanelOverlayElement* { return mParent; }
         [[nodiscard]] auto getMaterial() const noexcept -> const MaterialPtr& override { return mParent->mBorderMaterial; }
         void getRenderOperation(RenderOperation& op) override { op = mParent->mRenderOp2; }
         void getWorldTransforms(Matrix4* xform) const override { mParent->getWorldTransforms(xform); }
@@ -34,6 +34,7 @@ export import Ogre.Core;
 export import <algorithm>;
 export import <format>;
 export import <map>;
+export import <memory>;
 export import <utility>;
 export import <vector>;
 
@@ -73,6 +74,55 @@ namespace Ogre
         float advance; // advanceX/ height
     };
 
+    /** A texture which the glyphs of several fonts are packed into, as they are needed.
+    @remarks
+        The atlas has a fixed width and doubles its height when full, up to a maximum.
+        This scales the v coordinates of all glyphs in it, users compare getHeight to
+        the height they computed their coordinates with. Space is not given back
+        before the atlas is destroyed.
+    @see FontManager::getGlyphAtlas, Font::setGlyphsOnDemand
+    */
+    class GlyphAtlas : public ManualResourceLoader, public OverlayAlloc
+    {
+    public:
+        /** Creates the texture, of width x initialHeight pixels in PixelFormat::BYTE_LA.
+        @param maxHeight Height the atlas does not grow beyond
+        */
+        GlyphAtlas(std::string_view name, uint32 width = 1024, uint32 initialHeight = 256, uint32 maxHeight = 8192);
+        ~GlyphAtlas() override;
+
+        /** Reserves a box of width x height pixels, growing the atlas if needed.
+        @return false if the atlas is full
+        */
+        auto allocate(uint32 width, uint32 height, uint32& x, uint32& y) -> bool;
+
+        /** Gets the pixels, to write the contents of allocated boxes to. */
+        auto getImage() noexcept -> Image& { return mImage; }
+
+        /** Uploads box of the image to the texture. */
+        void upload(const Box& box);
+
+        [[nodiscard]] auto getTexture() const noexcept -> const TexturePtr& { return mTexture; }
+        [[nodiscard]] auto getWidth() const -> uint32 { return mImage.getWidth(); }
+        [[nodiscard]] auto getHeight() const -> uint32 { return mImage.getHeight(); }
+
+        /** Implementation of ManualResourceLoader::loadResource, uploads the whole image. */
+        void loadResource(Resource* resource) override;
+
+    private:
+        /// A row of boxes of up to the same height
+        struct Shelf
+        {
+            uint32 y;
+            uint32 height;
+            uint32 used;
+        };
+        std::vector<Shelf> mShelves;
+        uint32 mMaxHeight;
+        Image mImage;
+        TexturePtr mTexture;
+    };
+
     /** Class representing a font in the system.
     @remarks
     This class is simply a way of getting a font texture into the OGRE system and
@@ -126,8 +176,24 @@ namespace Ogre
         /// Range of code points to generate glyphs for (truetype only)
         CodePointRangeList mCodePointRangeList;
 
+        /// See setGlyphsOnDemand
+        bool mGlyphsOnDemand{false};
+        /// The face glyphs are rendered from, while loaded with mGlyphsOnDemand
+        struct FreeTypeFace;
+        ::std::unique_ptr<FreeTypeFace> mFace;
+        /// Height of the GlyphAtlas the v coordinates of the glyphs refer to
+        uint32 mAtlasHeight{0};
+        /// See _getGlyphsVersion
+        uint32 mGlyphsVersion{0};
+
         /// Internal method for loading from ttf
         void createTextureFromFont();
+        /// Opens the truetype source at the configured size
+        auto openFace() -> ::std::unique_ptr<FreeTypeFace>;
+        /// Renders a glyph into the GlyphAtlas
+        void renderGlyph(CodePoint id);
+        /// Rescales the v coordinates of the glyphs if the GlyphAtlas has grown
+        void updateAtlasCoords();
 
         /// @copydoc Resource::loadImpl
         void loadImpl() override;
@@ -260,6 +326,36 @@ namespace Ogre
             return i->second;
         }
 
+        /** Gets the information of a glyph like getGlyphInfo, rendering it first if needed.
+        @remarks
+            Only fonts with setGlyphsOnDemand render glyphs here, for all others this
+            is the same as getGlyphInfo.
+        */
+        auto requestGlyphInfo(CodePoint id) -> const GlyphInfo&;
+
+        /** Sets whether a truetype font renders its glyphs when they are first requested.
+        @remarks
+            The glyphs then go to the GlyphAtlas shared by all such fonts, instead of a
+            texture of their own which holds all of them from the start. This saves
+            loading time and memory for large fonts, like CJK ones, of which only few code
+            points are used. If code point ranges are given, other code points are
+            still not found. Must be set before loading, the default is false.
+        @note
+            Glyphs are only rendered through requestGlyphInfo, and their v coordinates
+            change when the atlas grows, see _getGlyphsVersion.
+        */
+        void setGlyphsOnDemand(bool enabled) { mGlyphsOnDemand = enabled; }
+
+        /** Gets whether a truetype font renders its glyphs when they are first requested. */
+        [[nodiscard]] auto getGlyphsOnDemand() const noexcept -> bool { return mGlyphsOnDemand; }
+
+        /** Gets a number which changes whenever the information of existing glyphs changes.
+        @remarks
+            This happens on loading and, for fonts with setGlyphsOnDemand, when the
+            GlyphAtlas has grown. Newly rendered glyphs do not change it.
+        */
+        auto _getGlyphsVersion() -> uint32;
+
         /** Adds a range of code points to the list of code point ranges to generate
             glyphs for, if this is a truetype based font.
         @remarks
@@ -56,6 +56,13 @@ namespace Ogre
         /// @see ResourceManager::getResourceByName
         auto getByName(std::string_view name, std::string_view groupName = RGN_DEFAULT) const -> FontPtr;
 
+        /** Gets the atlas shared by the fonts which render glyphs on demand.
+        @remarks
+            Created on first use.
+        @see Font::setGlyphsOnDemand
+        */
+        auto getGlyphAtlas() -> GlyphAtlas&;
+
         /** Override standard Singleton retrieval.
         @remarks
         Why do we do this? Well, it's because the Singleton
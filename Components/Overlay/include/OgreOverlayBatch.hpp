@@ -0,0 +1,152 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+module;
+
+#include <cstddef>
+
+export module Ogre.Components.Overlay:Batch;
+
+export import Ogre.Core;
+
+export import <memory>;
+export import <span>;
+export import <utility>;
+export import <vector>;
+
+export
+namespace Ogre {
+
+    /** \addtogroup Optional
+    *  @{
+    */
+    /** \addtogroup Overlays
+    *  @{
+    */
+    /** Merges the geometry of overlay elements into few draws.
+    @remarks
+        While capturing, the renderables of the 2D elements are taken off the RenderQueue.
+        Consecutive ones in Z-order which use the same Technique and vertex layout are
+        then copied into one dynamic vertex buffer and queued as a single batch, with the
+        priority of the lowest Z-order it contains. Elements of the same Z-order, which
+        the RenderQueue does not order among themselves, are grouped by Technique first.
+    @par
+        A batch is only rebuilt if one of its elements rewrote its geometry or the
+        elements it covers changed, see OverlayElement::_getGeometryVersion. The data is
+        read back from the shadow buffers of the elements; renderables without those,
+        or which are not owned by an OverlayElement, are queued as they are.
+    @see Overlay::setBatching
+    */
+    class OverlayBatcher : public RenderQueue::RenderableListener, public OverlayAlloc
+    {
+    public:
+        OverlayBatcher();
+        ~OverlayBatcher();
+
+        /** Starts taking the renderables added to queue.
+        @remarks
+            A RenderableListener of queue is still called, before the renderable is captured.
+        */
+        void begin(RenderQueue* queue);
+
+        /** Stops capturing and adds the batches to the queue passed to begin. */
+        void end();
+
+        /** Releases the vertex buffers of all batches, they are rebuilt when needed. */
+        void clear();
+
+        /** Gets the number of batches queued by the last call to end. */
+        [[nodiscard]] auto getNumBatches() const noexcept -> size_t { return mNumBatches; }
+
+        auto renderableQueued(Renderable* rend, RenderQueueGroupID groupID,
+            ushort priority, Technique** ppTech, RenderQueue* pQueue) -> bool override;
+
+    private:
+        /// A renderable taken off the queue
+        struct Entry
+        {
+            Renderable* renderable;
+            /// nullptr for a renderable left in the queue, which ends the current batch
+            Technique* technique;
+            RenderQueueGroupID groupID;
+            ushort priority;
+            uint32 version;
+            RenderOperation op;
+        };
+
+        /// The merged geometry of consecutive entries
+        class Batch : public Renderable, public OverlayAlloc
+        {
+        public:
+            Batch();
+            ~Batch() override;
+
+            /// Whether the geometry was built from entries, as they are now
+            [[nodiscard]] auto matches(std::span<const Entry> entries) const -> bool;
+            /// Copies the geometry of entries into the vertex buffer
+            void build(std::span<const Entry> entries);
+            /// Releases the vertex buffer
+            void clear();
+
+            [[nodiscard]] auto getMaterial() const noexcept -> const MaterialPtr& override { return mMaterial; }
+            [[nodiscard]] auto getTechnique() const noexcept -> Technique* override { return mTechnique; }
+            void getRenderOperation(RenderOperation& op) override { op = mRenderOp; }
+            void getWorldTransforms(Matrix4* xform) const override;
+            auto getSquaredViewDepth(const Camera* cam) const -> Real override;
+            [[nodiscard]] auto getLights() const noexcept -> const LightList& override;
+
+        private:
+            struct Source
+            {
+                Renderable* renderable;
+                VertexData* vertexData;
+                uint32 version;
+            };
+            std::vector<Source> mSources;
+            Technique* mTechnique{nullptr};
+            MaterialPtr mMaterial;
+            ::std::unique_ptr<VertexData> mVertexData;
+            RenderOperation mRenderOp;
+        };
+
+        /// Whether the geometry of entry can be merged at all
+        static auto isBatchable(const Entry& entry) -> bool;
+        /// Whether a and b can be drawn as one
+        static auto isCompatible(const Entry& a, const Entry& b) -> bool;
+
+        RenderQueue* mQueue{nullptr};
+        RenderQueue::RenderableListener* mChainedListener{nullptr};
+        std::vector<Entry> mEntries;
+        /// Ranges of mEntries drawn as one
+        std::vector<std::pair<size_t, size_t>> mRuns;
+        std::vector<::std::unique_ptr<Batch>> mBatches;
+        size_t mNumBatches{0};
+    };
+    /** @} */
+    /** @} */
+
+} // namespace Ogre
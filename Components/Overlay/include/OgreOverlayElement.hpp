@@ -138,6 +138,8 @@ namespace Ogre {
         bool mGeomPositionsOutOfDate{true};
         /// Flag indicating if the vertex uvs need recalculating
         bool mGeomUVsOutOfDate{true};
+        /// Changes whenever the vertex buffers are rewritten, unique across all elements
+        uint32 mGeometryVersion{0};
 
         /** Zorder for when sending to render queue.
             Derived from parent */
@@ -162,6 +164,8 @@ namespace Ogre {
         subclasses must implement this.
         */
         virtual void updateTextureGeometry() = 0;
+        /// Internal method to be called after the vertex buffers of the element have been rewritten
+        void _geometryUpdated();
 
         /** Internal method for setting up the basic parameter definitions for a subclass. 
         @remarks
@@ -334,6 +338,12 @@ namespace Ogre {
         /** Internal method to put the contents onto the render queue. */
         virtual void _updateRenderQueue(RenderQueue* queue);
 
+        /** Gets the version of the geometry last put onto the render queue.
+        @remarks
+            Used by OverlayBatcher to tell whether merged geometry is still current.
+        */
+        [[nodiscard]] auto _getGeometryVersion() const noexcept -> uint32 { return mGeometryVersion; }
+
         /// @copydoc MovableObject::visitRenderables
         void visitRenderables(Renderable::Visitor* visitor, 
             bool debugRenderables = false);
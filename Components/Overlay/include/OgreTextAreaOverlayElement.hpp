@@ -157,6 +157,30 @@ namespace Ogre
         ColourValue mColourTop;
         bool mColoursChanged;
 
+        /// The pen before a code point of the caption, where the layout can resume from
+        struct LayoutState
+        {
+            float left;
+            float top;
+            float largestWidth;
+            size_t vertex;
+        };
+        /// What the layout in the vertex buffer depends on besides the caption
+        struct LayoutKey
+        {
+            const Font* font{nullptr};
+            uint32 glyphsVersion{0};
+            float left{0}, top{0};
+            Real charHeight{0}, spaceWidth{0}, aspectCoef{0};
+            Alignment alignment{Alignment::Left};
+
+            auto operator==(const LayoutKey&) const -> bool = default;
+        };
+        /// The decoded caption the vertex buffer holds
+        std::vector<Font::CodePoint> mLayoutCaption;
+        /// The state before each code point of mLayoutCaption, and after the last one
+        std::vector<LayoutState> mLayout;
+        LayoutKey mLayoutKey;
 
         /// Internal method to allocate memory, only reallocates when necessary
         void checkMemoryAllocation( size_t numChars );
@@ -25,6 +25,8 @@ THE SOFTWARE
 -------------------------------------------------------------------------*/
 module;
 
+#include <cstring>
+
 #define generic _generic    // keyword for C++/CX
 #include <freetype/freetype.h>
 #undef generic
@@ -32,12 +34,14 @@ module;
 module Ogre.Components.Overlay;
 
 import :Font;
+import :FontManager;
 import :Manager;
 import :utf8;
 
 import Ogre.Core;
 
 import <algorithm>;
+import <memory>;
 import <ostream>;
 import <string>;
 
@@ -89,6 +93,130 @@ namespace Ogre
     static CmdSize msSizeCmd;
     static CmdResolution msResolutionCmd;
     static CmdCodePoints msCodePointsCmd;
+
+    /** Copies a rendered glyph to the cell at x, y of img, skipping rows outside of it.
+    @param yBearing Row of the cell the top of the bitmap goes to
+    */
+    void copyGlyph(const FT_Bitmap& bitmap, Image& img, uint32 x, uint32 y, FT_Pos yBearing, uint32 cellHeight,
+                   bool antialiasColour)
+    {
+        for (int j = 0; j < int(bitmap.rows); j++)
+        {
+            FT_Pos cellRow = j + yBearing;
+            if (cellRow < 0 || cellRow >= FT_Pos(cellHeight))
+                continue;
+
+            const uchar* pSrc = bitmap.buffer + j * bitmap.pitch;
+            uchar* pDest = img.getData(x, uint32(y + cellRow));
+            for (unsigned int k = 0; k < bitmap.width; k++)
+            {
+                if (antialiasColour)
+                {
+                    // Use the same greyscale pixel for all components RGBA
+                    *pDest++= *pSrc;
+                }
+                else
+                {
+                    // Always white whether 'on' or 'off' pixel, since alpha
+                    // will turn off
+                    *pDest++= 0xFF;
+                }
+                // Always use the greyscale value for alpha
+                *pDest++= *pSrc++;
+            }
+        }
+    }
+    }
+
+    //---------------------------------------------------------------------
+    struct Font::FreeTypeFace
+    {
+        /// The face reads from this, so it has to stay around
+        ::std::unique_ptr<MemoryDataStream> data;
+        FT_Library library{nullptr};
+        FT_Face face{nullptr};
+        /// Height of the cell of every glyph, in pixels
+        uint32 cellHeight{0};
+
+        ~FreeTypeFace()
+        {
+            // also releases the face
+            if (library)
+                FT_Done_FreeType(library);
+        }
+    };
+
+    //---------------------------------------------------------------------
+    GlyphAtlas::GlyphAtlas(std::string_view name, uint32 width, uint32 initialHeight, uint32 maxHeight)
+        : mMaxHeight(maxHeight)
+        , mImage(PixelFormat::BYTE_LA, width, initialHeight)
+    {
+        mImage.setTo(ColourValue::ZERO);
+
+        mTexture = TextureManager::getSingleton().create(name, RGN_INTERNAL, true, this);
+        mTexture->setTextureType(TextureType::_2D);
+        mTexture->setNumMipmaps(TextureMipmap{});
+        mTexture->load();
+    }
+    //---------------------------------------------------------------------
+    GlyphAtlas::~GlyphAtlas()
+    {
+        if (auto textureManager = TextureManager::getSingletonPtr())
+            textureManager->remove(mTexture);
+    }
+    //---------------------------------------------------------------------
+    auto GlyphAtlas::allocate(uint32 width, uint32 height, uint32& x, uint32& y) -> bool
+    {
+        if (width > getWidth())
+            return false;
+
+        // the shelf wasting the least height, fonts of the same size use the same ones
+        Shelf* best = nullptr;
+        for (auto& shelf : mShelves)
+        {
+            if (shelf.height >= height && shelf.used + width <= getWidth() &&
+                (!best || shelf.height < best->height))
+                best = &shelf;
+        }
+
+        if (!best)
+        {
+            uint32 top = mShelves.empty() ? 0 : mShelves.back().y + mShelves.back().height;
+            if (top + height > getHeight())
+            {
+                uint32 newHeight = getHeight();
+                while (top + height > newHeight)
+                    newHeight *= 2;
+                if (newHeight > mMaxHeight)
+                    return false;
+
+                // same width, so the rows of the old image are the start of the new one
+                Image grown(PixelFormat::BYTE_LA, getWidth(), newHeight);
+                grown.setTo(ColourValue::ZERO);
+                memcpy(grown.getData(), mImage.getData(), mImage.getSize());
+                mImage = grown;
+
+                mTexture->unload();
+                mTexture->load();
+            }
+
+            best = &mShelves.emplace_back(top, height, 0);
+        }
+
+        x = best->used;
+        y = best->y;
+        best->used += width;
+        return true;
+    }
+    //---------------------------------------------------------------------
+    void GlyphAtlas::upload(const Box& box)
+    {
+        mTexture->getBuffer()->blitFromMemory(mImage.getPixelBox().getSubVolume(box), box);
+    }
+    //---------------------------------------------------------------------
+    void GlyphAtlas::loadResource(Resource* resource)
+    {
+        static_cast<Texture*>(resource)->_loadImages({&mImage});
     }
 
     auto utftoc32(String str) -> std::vector<uint32>
@@ -209,7 +337,7 @@ namespace Ogre
         bbs->setBillboardOrigin(BillboardOrigin::CENTER_LEFT);
         bbs->setDefaultDimensions(0, 0);
 
-        float spaceWidth = mCodePointMap.find('0')->second.advance * height;
+        float spaceWidth = requestGlyphInfo('0').advance * height;
 
         text.resize(text.size() + 3); // add padding for decoder
         auto it = text.c_str();
@@ -240,6 +368,9 @@ namespace Ogre
                 continue;
             }
 
+            if (mFace)
+                requestGlyphInfo(cpId);
+
             auto cp = mCodePointMap.find(cpId);
             if (cp == mCodePointMap.end())
                 continue;
@@ -267,7 +398,16 @@ namespace Ogre
                 "Error creating new material!", "Font::load" );
         }
 
-        if (mType == FontType::TRUETYPE)
+        if (mType == FontType::TRUETYPE && mGlyphsOnDemand)
+        {
+            mFace = openFace();
+            mTtfMaxBearingY = int(mFace->face->size->metrics.ascender >> 6);
+
+            GlyphAtlas& atlas = FontManager::getSingleton().getGlyphAtlas();
+            mTexture = atlas.getTexture();
+            mAtlasHeight = atlas.getHeight();
+        }
+        else if (mType == FontType::TRUETYPE)
         {
             createTextureFromFont();
         }
@@ -307,6 +447,8 @@ namespace Ogre
             // Use add if no alpha (assume black background)
             mMaterial->setSceneBlending(SceneBlendType::ADD);
         }
+
+        ++mGlyphsVersion;
     }
     //---------------------------------------------------------------------
     void Font::unloadImpl()
@@ -317,6 +459,14 @@ namespace Ogre
             mMaterial.reset();
         }
 
+        if (mFace)
+        {
+            // the atlas is shared, only the glyphs of this font go
+            mFace.reset();
+            mTexture.reset();
+            mCodePointMap.clear();
+        }
+
         if (mTexture)
         {
             TextureManager::getSingleton().remove(mTexture);
@@ -334,42 +484,138 @@ namespace Ogre
         mTexture->load();
     }
     //---------------------------------------------------------------------
-    void Font::loadResource(Resource* res)
+    auto Font::openFace() -> ::std::unique_ptr<FreeTypeFace>
     {
+        auto ftFace = ::std::make_unique<FreeTypeFace>();
+
         // Locate ttf file, load it pre-buffered into memory by wrapping the
         // original DataStream in a MemoryDataStream
         DataStreamPtr dataStreamPtr =
             ResourceGroupManager::getSingleton().openResource(
                 mSource, mGroup, this);
-        MemoryDataStream ttfchunk(dataStreamPtr);
+        ftFace->data = ::std::make_unique<MemoryDataStream>(dataStreamPtr);
 
-        // If codepoints not supplied, assume ASCII
-        if (mCodePointRangeList.empty())
-        {
-            mCodePointRangeList.push_back(CodePointRange(33, 126));
-        }
         float vpScale = OverlayManager::getSingleton().getPixelRatio();
 
-        // ManualResourceLoader implementation - load the texture
-        FT_Library ftLibrary;
         // Init freetype
-        if( FT_Init_FreeType( &ftLibrary ) )
+        if( FT_Init_FreeType( &ftFace->library ) )
             OGRE_EXCEPT( ExceptionCodes::INTERNAL_ERROR, "Could not init FreeType library!",
             "Font::Font");
 
-        FT_Face face;
-
         // Load font
-        if( FT_New_Memory_Face( ftLibrary, ttfchunk.getPtr(), (FT_Long)ttfchunk.size() , 0, &face ) )
+        if( FT_New_Memory_Face( ftFace->library, ftFace->data->getPtr(), (FT_Long)ftFace->data->size() , 0, &ftFace->face ) )
             OGRE_EXCEPT( ExceptionCodes::INTERNAL_ERROR,
             "Could not open font face!", "Font::createTextureFromFont" );
 
-
         // Convert our point size to freetype 26.6 fixed point format
         auto ftSize = (FT_F26Dot6)(mTtfSize * (1 << 6));
-        if (FT_Set_Char_Size(face, ftSize, 0, mTtfResolution * vpScale, mTtfResolution * vpScale))
+        if (FT_Set_Char_Size(ftFace->face, ftSize, 0, mTtfResolution * vpScale, mTtfResolution * vpScale))
             OGRE_EXCEPT(ExceptionCodes::INTERNAL_ERROR, "Could not set char size!");
 
+        const FT_Size_Metrics& metrics = ftFace->face->size->metrics;
+        ftFace->cellHeight = uint32((metrics.ascender - metrics.descender) >> 6);
+        return ftFace;
+    }
+    //---------------------------------------------------------------------
+    auto Font::requestGlyphInfo(CodePoint id) -> const GlyphInfo&
+    {
+        if (!mFace)
+            return getGlyphInfo(id);
+
+        updateAtlasCoords();
+
+        auto i = mCodePointMap.find(id);
+        if (i != mCodePointMap.end())
+            return i->second;
+
+        bool inRange = mCodePointRangeList.empty() ||
+                       std::ranges::any_of(mCodePointRangeList, [id](const CodePointRange& range)
+                                           { return range.first <= id && id <= range.second; });
+        if (!inRange)
+            return getGlyphInfo(id);
+
+        renderGlyph(id);
+        return mCodePointMap[id];
+    }
+    //---------------------------------------------------------------------
+    auto Font::_getGlyphsVersion() -> uint32
+    {
+        updateAtlasCoords();
+        return mGlyphsVersion;
+    }
+    //---------------------------------------------------------------------
+    void Font::renderGlyph(CodePoint id)
+    {
+        FT_Face face = mFace->face;
+        uint32 cellHeight = mFace->cellHeight;
+
+        // a code point that fails stays empty, rather than being tried again and again
+        GlyphInfo info{id, UVRect{0, 0, 0, 0}, 0, 0, 0};
+        if (FT_Load_Char(face, id, FT_LOAD_RENDER))
+        {
+            LogManager::getSingleton().logError(std::format(
+                "Freetype could not load charcode {} in font {}", id, mSource.c_str()));
+            setGlyphInfo(info);
+            return;
+        }
+
+        uint width = face->glyph->bitmap.width;
+        info.bearing = float(face->glyph->metrics.horiBearingX >> 6) / cellHeight;
+        info.advance = float(face->glyph->advance.x >> 6) / cellHeight;
+
+        GlyphAtlas& atlas = FontManager::getSingleton().getGlyphAtlas();
+        uint32 x = 0, y = 0;
+        // one pixel apart, like the glyphs of a font texture
+        if (width == 0 || !atlas.allocate(width + 1, cellHeight + 1, x, y))
+        {
+            if (width != 0)
+                LogManager::getSingleton().logError(std::format(
+                    "Glyph atlas is full, charcode {} of font {} is left out", id, mSource.c_str()));
+            setGlyphInfo(info);
+            return;
+        }
+        updateAtlasCoords();
+
+        FT_Pos yBearing = mTtfMaxBearingY - (face->glyph->metrics.horiBearingY >> 6);
+        copyGlyph(face->glyph->bitmap, atlas.getImage(), x, y, yBearing, cellHeight, mAntialiasColour);
+        atlas.upload(Box{x, y, x + width, y + cellHeight});
+
+        info.uvRect = UVRect{float(x) / atlas.getWidth(), float(y) / atlas.getHeight(),
+                             float(x + width) / atlas.getWidth(), float(y + cellHeight) / atlas.getHeight()};
+        info.aspectRatio = float(width) / cellHeight;
+        setGlyphInfo(info);
+    }
+    //---------------------------------------------------------------------
+    void Font::updateAtlasCoords()
+    {
+        if (!mFace)
+            return;
+
+        uint32 height = FontManager::getSingleton().getGlyphAtlas().getHeight();
+        if (height == mAtlasHeight)
+            return;
+
+        float scale = float(mAtlasHeight) / height;
+        for (auto& [cp, info] : mCodePointMap)
+        {
+            info.uvRect.top *= scale;
+            info.uvRect.bottom *= scale;
+        }
+        mAtlasHeight = height;
+        ++mGlyphsVersion;
+    }
+    //---------------------------------------------------------------------
+    void Font::loadResource(Resource* res)
+    {
+        auto ftFace = openFace();
+        FT_Face face = ftFace->face;
+
+        // If codepoints not supplied, assume ASCII
+        if (mCodePointRangeList.empty())
+        {
+            mCodePointRangeList.push_back(CodePointRange(33, 126));
+        }
+
         //FILE *fo_def = stdout;
 
         FT_Pos max_height = 0, max_width = 0;
@@ -421,9 +667,6 @@ namespace Ogre
         {
             for(CodePoint cp = begin; cp <= end; ++cp )
             {
-                uchar* buffer;
-                int buffer_h = 0, buffer_pitch = 0;
-
                 // Load & render glyph
                 FT_Error ftResult = FT_Load_Char( face, cp, FT_LOAD_RENDER );
                 if (ftResult)
@@ -434,8 +677,7 @@ namespace Ogre
                     continue;
                 }
 
-                buffer = face->glyph->bitmap.buffer;
-                if (!buffer)
+                if (!face->glyph->bitmap.buffer)
                 {
                     // Yuck, FT didn't detect this but generated a null pointer!
                     LogManager::getSingleton().logWarning(std::format(
@@ -445,8 +687,6 @@ namespace Ogre
 
                 uint advance = face->glyph->advance.x >> 6;
                 uint width = face->glyph->bitmap.width;
-                buffer_pitch = face->glyph->bitmap.pitch;
-                buffer_h = face->glyph->bitmap.rows;
 
                 FT_Pos y_bearing = mTtfMaxBearingY - (face->glyph->metrics.horiBearingY >> 6);
                 FT_Pos x_bearing = face->glyph->metrics.horiBearingX >> 6;
@@ -458,28 +698,7 @@ namespace Ogre
                     l = 0;
                 }
 
-                for(int j = 0; j < buffer_h; j++ )
-                {
-                    uchar* pSrc = buffer + j * buffer_pitch;
-                    uint32 row = j + m + y_bearing;
-                    uchar* pDest = img.getData(l, row);
-                    for(unsigned int k = 0; k < width; k++ )
-                    {
-                        if (mAntialiasColour)
-                        {
-                            // Use the same greyscale pixel for all components RGBA
-                            *pDest++= *pSrc;
-                        }
-                        else
-                        {
-                            // Always white whether 'on' or 'off' pixel, since alpha
-                            // will turn off
-                            *pDest++= 0xFF;
-                        }
-                        // Always use the greyscale value for alpha
-                        *pDest++= *pSrc++;
-                    }
-                }
+                copyGlyph(face->glyph->bitmap, img, l, m, y_bearing, finalHeight - m, mAntialiasColour);
 
                 UVRect uvs{(Real)l / (Real)finalWidth,                   // u1
                            (Real)m / (Real)finalHeight,                  // v1
@@ -493,8 +712,6 @@ namespace Ogre
             }
         }
 
-        FT_Done_FreeType(ftLibrary);
-
         auto* tex = static_cast<Texture*>(res);
         // Call internal _loadImages, not loadImage since that's external and 
         // will determine load status etc again, and this is a manual loader inside load()
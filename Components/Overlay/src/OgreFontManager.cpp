@@ -91,4 +91,11 @@ namespace Ogre
     {
         return static_pointer_cast<Font>(createResource(name,group,isManual,loader,createParams));
     }
+    //---------------------------------------------------------------------
+    auto FontManager::getGlyphAtlas() -> GlyphAtlas&
+    {
+        if (!mGlyphAtlas)
+            mGlyphAtlas = ::std::make_unique<GlyphAtlas>("Fonts/GlyphAtlas");
+        return *mGlyphAtlas;
+    }
 }
@@ -32,6 +32,7 @@ module;
 
 module Ogre.Components.Overlay;
 
+import :Batch;
 import :Container;
 import :Element;
 
@@ -293,15 +294,35 @@ namespace Ogre {
             queue->setDefaultQueueGroup(oldgrp);
             queue->setDefaultRenderablePriority(oldPriority);
             // Add 2D elements
+            if (mBatcher)
+                mBatcher->begin(queue);
+
             for (auto const& i : m2DElements)
             {
                 i->_update();
 
                 i->_updateRenderQueue(queue);
             }
+
+            if (mBatcher)
+                mBatcher->end();
         }
     }
     //---------------------------------------------------------------------
+    void Overlay::setBatching(bool enabled)
+    {
+        if (enabled == getBatching())
+            return;
+
+        mBatcher = enabled ? ::std::make_unique<OverlayBatcher>() : nullptr;
+    }
+    //---------------------------------------------------------------------
+    void Overlay::_releaseManualHardwareResources()
+    {
+        if (mBatcher)
+            mBatcher->clear();
+    }
+    //---------------------------------------------------------------------
     void Overlay::updateTransform() const
     {
         // Ordering:
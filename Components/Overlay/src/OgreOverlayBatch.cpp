@@ -0,0 +1,383 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+module;
+
+#include <cstddef>
+#include <cstring>
+
+module Ogre.Components.Overlay;
+
+import :Batch;
+import :BorderPanelOverlayElement;
+import :Element;
+
+import Ogre.Core;
+
+import <algorithm>;
+import <map>;
+import <memory>;
+import <span>;
+import <utility>;
+import <vector>;
+
+namespace Ogre {
+
+    //---------------------------------------------------------------------
+    /// Gets the version of the element owning rend, false for a renderable of something else
+    static auto getGeometryVersion(Renderable* rend, uint32& version) -> bool
+    {
+        if (auto elem = dynamic_cast<OverlayElement*>(rend))
+        {
+            version = elem->_getGeometryVersion();
+            return true;
+        }
+        if (auto border = dynamic_cast<BorderRenderable*>(rend))
+        {
+            version = border->getParent()->_getGeometryVersion();
+            return true;
+        }
+        return false;
+    }
+    //---------------------------------------------------------------------
+    /// Number of vertices of op as a triangle list
+    static auto getTriangleListSize(const RenderOperation& op) -> size_t
+    {
+        size_t count = op.useIndexes ? op.indexData->indexCount : op.vertexData->vertexCount;
+        if (op.operationType == RenderOperation::OperationType::TRIANGLE_STRIP)
+            return count < 3 ? 0 : (count - 2) * 3;
+        return count - count % 3;
+    }
+    //---------------------------------------------------------------------
+    OverlayBatcher::OverlayBatcher() = default;
+    //---------------------------------------------------------------------
+    OverlayBatcher::~OverlayBatcher() = default;
+    //---------------------------------------------------------------------
+    void OverlayBatcher::begin(RenderQueue* queue)
+    {
+        mQueue = queue;
+        mChainedListener = queue->getRenderableListener();
+        mEntries.clear();
+        queue->setRenderableListener(this);
+    }
+    //---------------------------------------------------------------------
+    auto OverlayBatcher::renderableQueued(Renderable* rend, RenderQueueGroupID groupID,
+        ushort priority, Technique** ppTech, RenderQueue* pQueue) -> bool
+    {
+        if (mChainedListener && !mChainedListener->renderableQueued(rend, groupID, priority, ppTech, pQueue))
+            return false;
+
+        Entry entry{rend, *ppTech, groupID, priority, 0, {}};
+        rend->getRenderOperation(entry.op);
+        bool batchable = getGeometryVersion(rend, entry.version) && isBatchable(entry);
+        if (!batchable)
+            entry.technique = nullptr;
+
+        // keep the renderables left in the queue too, as they end the batches around them
+        mEntries.push_back(entry);
+        return !batchable;
+    }
+    //---------------------------------------------------------------------
+    void OverlayBatcher::end()
+    {
+        mQueue->setRenderableListener(mChainedListener);
+
+        // The queue keeps no order among renderables of the same priority, so those are grouped
+        // by technique; the technique of the open batch comes first, to continue it.
+        std::ranges::stable_sort(mEntries, {}, &Entry::priority);
+
+        mRuns.clear();
+        bool open = false;
+        for (size_t i = 0; i < mEntries.size();)
+        {
+            size_t j = i + 1;
+            while (j < mEntries.size() && mEntries[j].priority == mEntries[i].priority)
+                ++j;
+
+            auto group = std::span{mEntries}.subspan(i, j - i);
+            auto it = group.begin();
+            if (open)
+            {
+                Technique* technique = mEntries[mRuns.back().first].technique;
+                it = std::ranges::stable_partition(group, [technique](const Entry& e)
+                                                    { return e.technique == technique; }).begin();
+            }
+            std::ranges::stable_sort(it, group.end(), std::less<>{}, &Entry::technique);
+
+            for (size_t k = i; k < j;)
+            {
+                size_t l = k + 1;
+                if (mEntries[k].technique)
+                {
+                    while (l < j && isCompatible(mEntries[k], mEntries[l]))
+                        ++l;
+
+                    // a batch may only reach into the next priority if it holds everything before,
+                    // otherwise that would be drawn in between
+                    if (open && k == i && isCompatible(mEntries[mRuns.back().first], mEntries[k]))
+                        mRuns.back().second = l;
+                    else
+                        mRuns.emplace_back(k, l);
+                }
+                k = l;
+            }
+
+            open = !mRuns.empty() && mRuns.back().first <= i && mRuns.back().second == j;
+            i = j;
+        }
+
+        // the batches are queued with the captured techniques, so pass them on as they are
+        mQueue->setRenderableListener(nullptr);
+        for (mNumBatches = 0; mNumBatches < mRuns.size(); ++mNumBatches)
+        {
+            if (mNumBatches == mBatches.size())
+                mBatches.push_back(::std::make_unique<Batch>());
+
+            auto [first, last] = mRuns[mNumBatches];
+            auto entries = std::span{mEntries}.subspan(first, last - first);
+            Batch* batch = mBatches[mNumBatches].get();
+            if (!batch->matches(entries))
+                batch->build(entries);
+
+            mQueue->addRenderable(batch, entries.front().groupID, entries.front().priority);
+        }
+        mQueue->setRenderableListener(mChainedListener);
+
+        mQueue = nullptr;
+        mChainedListener = nullptr;
+        mEntries.clear();
+    }
+    //---------------------------------------------------------------------
+    void OverlayBatcher::clear()
+    {
+        for (auto& batch : mBatches)
+            batch->clear();
+    }
+    //---------------------------------------------------------------------
+    auto OverlayBatcher::isBatchable(const Entry& entry) -> bool
+    {
+        const RenderOperation& op = entry.op;
+        if (op.operationType != RenderOperation::OperationType::TRIANGLE_LIST &&
+            op.operationType != RenderOperation::OperationType::TRIANGLE_STRIP)
+            return false;
+
+        Renderable* rend = entry.renderable;
+        if (!op.vertexData || rend->getNumWorldTransforms() != 1 ||
+            !rend->getUseIdentityProjection() || !rend->getUseIdentityView())
+            return false;
+
+        // the geometry is read back, which would stall without shadow buffers
+        if (op.useIndexes && !(op.indexData && op.indexData->indexBuffer &&
+                               op.indexData->indexBuffer->hasShadowBuffer()))
+            return false;
+
+        const VertexBufferBinding* binding = op.vertexData->vertexBufferBinding;
+        for (const auto& elem : op.vertexData->vertexDeclaration->getElements())
+        {
+            if (!binding->isBufferBound(elem.getSource()) ||
+                !binding->getBuffer(elem.getSource())->hasShadowBuffer())
+                return false;
+        }
+        return true;
+    }
+    //---------------------------------------------------------------------
+    auto OverlayBatcher::isCompatible(const Entry& a, const Entry& b) -> bool
+    {
+        if (a.technique != b.technique || a.groupID != b.groupID)
+            return false;
+
+        const auto& elemsA = a.op.vertexData->vertexDeclaration->getElements();
+        const auto& elemsB = b.op.vertexData->vertexDeclaration->getElements();
+        return std::ranges::equal(elemsA, elemsB, [](const VertexElement& ea, const VertexElement& eb)
+        {
+            return ea.getSemantic() == eb.getSemantic() && ea.getType() == eb.getType() &&
+                   ea.getIndex() == eb.getIndex();
+        });
+    }
+    //---------------------------------------------------------------------
+    OverlayBatcher::Batch::Batch()
+    {
+        mUseIdentityProjection = true;
+        mUseIdentityView = true;
+    }
+    //---------------------------------------------------------------------
+    OverlayBatcher::Batch::~Batch() = default;
+    //---------------------------------------------------------------------
+    auto OverlayBatcher::Batch::matches(std::span<const Entry> entries) const -> bool
+    {
+        if (!mVertexData || mTechnique != entries.front().technique)
+            return false;
+
+        return std::ranges::equal(mSources, entries, [](const Source& s, const Entry& e)
+        {
+            return s.renderable == e.renderable && s.vertexData == e.op.vertexData && s.version == e.version;
+        });
+    }
+    //---------------------------------------------------------------------
+    void OverlayBatcher::Batch::build(std::span<const Entry> entries)
+    {
+        mSources.clear();
+        size_t vertexCount = 0;
+        for (const auto& e : entries)
+        {
+            mSources.push_back({e.renderable, e.op.vertexData, e.version});
+            vertexCount += getTriangleListSize(e.op);
+        }
+        mTechnique = entries.front().technique;
+        mMaterial = entries.front().renderable->getMaterial();
+
+        if (!mVertexData)
+            mVertexData = ::std::make_unique<VertexData>();
+
+        // same elements as the sources, interleaved in one buffer
+        VertexDeclaration* decl = mVertexData->vertexDeclaration;
+        decl->removeAllElements();
+        size_t vertexSize = 0;
+        for (const auto& elem : entries.front().op.vertexData->vertexDeclaration->getElements())
+        {
+            decl->addElement(0, vertexSize, elem.getType(), elem.getSemantic(), elem.getIndex());
+            vertexSize += elem.getSize();
+        }
+
+        VertexBufferBinding* binding = mVertexData->vertexBufferBinding;
+        HardwareVertexBufferSharedPtr vbuf;
+        if (binding->isBufferBound(0))
+            vbuf = binding->getBuffer(0);
+        if (!vbuf || vbuf->getVertexSize() != vertexSize || vbuf->getNumVertices() < vertexCount)
+        {
+            // grow in powers of two, as text changes its length all the time
+            vbuf = HardwareBufferManager::getSingleton().createVertexBuffer(
+                vertexSize, std::max<size_t>(Bitwise::firstPO2From(uint32(vertexCount)), 64),
+                HardwareBuffer::DYNAMIC_WRITE_ONLY_DISCARDABLE);
+            binding->setBinding(0, vbuf);
+        }
+
+        mVertexData->vertexStart = 0;
+        mVertexData->vertexCount = vertexCount;
+        mRenderOp.vertexData = mVertexData.get();
+        mRenderOp.operationType = RenderOperation::OperationType::TRIANGLE_LIST;
+        mRenderOp.useIndexes = false;
+        mRenderOp.useGlobalInstancingVertexBufferIsAvailable = false;
+
+        if (vertexCount == 0)
+            return;
+
+        HardwareBufferLockGuard dstLock(vbuf, HardwareBuffer::LockOptions::DISCARD);
+        auto* dst = static_cast<uchar*>(dstLock.pData);
+
+        struct Copy
+        {
+            const uchar* src;
+            size_t stride;
+            size_t size;
+        };
+        std::vector<Copy> copies;
+        for (const auto& e : entries)
+        {
+            const VertexData* vertexData = e.op.vertexData;
+            const VertexBufferBinding* srcBinding = vertexData->vertexBufferBinding;
+
+            // read only locks go to the shadow buffers
+            std::map<unsigned short, HardwareBufferLockGuard> srcLocks;
+            copies.clear();
+            for (const auto& elem : vertexData->vertexDeclaration->getElements())
+            {
+                const auto& srcBuf = srcBinding->getBuffer(elem.getSource());
+                auto [it, inserted] = srcLocks.try_emplace(elem.getSource());
+                if (inserted)
+                    it->second.lock(srcBuf.get(), HardwareBuffer::LockOptions::READ_ONLY);
+
+                copies.push_back({static_cast<const uchar*>(it->second.pData) + elem.getOffset(),
+                                  srcBuf->getVertexSize(), elem.getSize()});
+            }
+
+            HardwareBufferLockGuard indexLock;
+            const HardwareIndexBuffer* ibuf = nullptr;
+            if (e.op.useIndexes)
+            {
+                ibuf = e.op.indexData->indexBuffer.get();
+                indexLock.lock(e.op.indexData->indexBuffer.get(), HardwareBuffer::LockOptions::READ_ONLY);
+            }
+
+            auto index = [&](size_t i) -> size_t
+            {
+                if (!ibuf)
+                    return vertexData->vertexStart + i;
+
+                i += e.op.indexData->indexStart;
+                if (ibuf->getType() == HardwareIndexBuffer::IndexType::_16BIT)
+                    return vertexData->vertexStart + static_cast<const uint16*>(indexLock.pData)[i];
+                return vertexData->vertexStart + static_cast<const uint32*>(indexLock.pData)[i];
+            };
+
+            bool strip = e.op.operationType == RenderOperation::OperationType::TRIANGLE_STRIP;
+            size_t count = getTriangleListSize(e.op);
+            for (size_t i = 0; i < count; ++i)
+            {
+                // strips alternate the winding of their triangles, flip every other one back
+                size_t src = i;
+                if (strip)
+                {
+                    size_t tri = i / 3, corner = i % 3;
+                    src = (tri % 2 == 1 && corner < 2) ? tri + 1 - corner : tri + corner;
+                }
+
+                size_t vertex = index(src);
+                for (const auto& c : copies)
+                {
+                    memcpy(dst, c.src + vertex * c.stride, c.size);
+                    dst += c.size;
+                }
+            }
+        }
+    }
+    //---------------------------------------------------------------------
+    void OverlayBatcher::Batch::clear()
+    {
+        mSources.clear();
+        mVertexData.reset();
+        mRenderOp.vertexData = nullptr;
+    }
+    //---------------------------------------------------------------------
+    void OverlayBatcher::Batch::getWorldTransforms(Matrix4* xform) const
+    {
+        mSources.front().renderable->getWorldTransforms(xform);
+    }
+    //---------------------------------------------------------------------
+    auto OverlayBatcher::Batch::getSquaredViewDepth(const Camera* cam) const -> Real
+    {
+        return mSources.front().renderable->getSquaredViewDepth(cam);
+    }
+    //---------------------------------------------------------------------
+    auto OverlayBatcher::Batch::getLights() const noexcept -> const LightList&
+    {
+        // N/A, overlays are not lit
+        static LightList ll;
+        return ll;
+    }
+
+} // namespace Ogre
@@ -336,6 +336,12 @@ namespace Ogre {
         mGeomPositionsOutOfDate = true;
     }
     //---------------------------------------------------------------------
+    void OverlayElement::_geometryUpdated()
+    {
+        static uint32 lastVersion = 0;
+        mGeometryVersion = ++lastVersion;
+    }
+    //---------------------------------------------------------------------
     void OverlayElement::_update()
     {
         Real vpWidth, vpHeight;
@@ -387,6 +393,7 @@ namespace Ogre {
         if (mGeomPositionsOutOfDate && mInitialised)
         {
             updatePositionGeometry();
+            _geometryUpdated();
 
             // Within updatePositionGeometry() of TextOverlayElements,
             // the needed pixel width is calculated and as a result a new 
@@ -403,6 +410,7 @@ namespace Ogre {
         if (mGeomUVsOutOfDate && mInitialised)
         {
             updateTextureGeometry();
+            _geometryUpdated();
             mGeomUVsOutOfDate = false;
         } 
     }
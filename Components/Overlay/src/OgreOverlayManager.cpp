@@ -81,6 +81,9 @@ namespace Ogre {
     {
         for(auto & mElement : mElements)
             mElement.second->_releaseManualHardwareResources();
+
+        for(auto & [name, overlay] : mOverlayMap)
+            overlay->_releaseManualHardwareResources();
     }
     //---------------------------------------------------------------------
     void OverlayManager::_restoreManualHardwareResources()
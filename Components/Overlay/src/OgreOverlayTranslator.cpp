@@ -117,6 +117,16 @@ void FontTranslator::parseAttribute(ScriptCompiler* compiler, FontPtr& pFont,
         }
         pFont->setAntialiasColour(flag);
     }
+    else if (attrib == "glyphs_on_demand")
+    {
+        bool flag;
+        if (prop->values.empty() || !getBoolean(prop->values.front(), &flag))
+        {
+            compiler->addError(ScriptCompiler::CE_STRINGEXPECTED, prop->file, prop->line);
+            return;
+        }
+        pFont->setGlyphsOnDemand(flag);
+    }
     else if (attrib == "code_points")
     {
         if (prop->values.empty())
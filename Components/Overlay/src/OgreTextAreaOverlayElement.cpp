@@ -33,6 +33,7 @@ import :TextAreaOverlayElement;
 
 import Ogre.Core;
 
+import <algorithm>;
 import <span>;
 import <string>;
 import <vector>;
@@ -107,6 +108,11 @@ namespace Ogre {
     #define UNICODE_LF 0x000A
     #define UNICODE_SPACE 0x0020
     #define UNICODE_ZERO 0x0030
+
+    static auto isNewLine(Font::CodePoint character) -> bool
+    {
+        return character == UNICODE_CR || character == UNICODE_NEL || character == UNICODE_LF;
+    }
     //---------------------------------------------------------------------
     TextAreaOverlayElement::TextAreaOverlayElement(std::string_view name)
         : OverlayElement(name), mColourBottom(ColourValue::White), mColourTop(ColourValue::White)
@@ -205,6 +211,7 @@ namespace Ogre {
         bind->setBinding(COLOUR_BINDING, vbuf);
 
         // Buffers are restored, but with trash within
+        mLayoutKey = {};
         mGeomPositionsOutOfDate = true;
         mGeomUVsOutOfDate = true;
         mColoursChanged = true;
@@ -236,36 +243,63 @@ namespace Ogre {
         size_t charlen = decoded.size();
         checkMemoryAllocation( charlen );
 
-        mRenderOp.vertexData->vertexCount = charlen * 6;
-        // Get position / texcoord buffer
-        const HardwareVertexBufferSharedPtr& vbuf = 
-            mRenderOp.vertexData->vertexBufferBinding->getBuffer(POS_TEX_BINDING);
-        HardwareBufferLockGuard vbufLock(vbuf, HardwareBuffer::LockOptions::DISCARD);
-        pVert = static_cast<float*>(vbufLock.pData);
-
-        float largestWidth = 0;
-        float left = _getDerivedLeft() * 2.0f - 1.0f;
-        float top = -( (_getDerivedTop() * 2.0f ) - 1.0f );
-
         // Derive space with from a number 0
         if(mSpaceWidth == 0)
         {
-            mSpaceWidth = mFont->getGlyphInfo(UNICODE_ZERO).advance * mCharHeight;
+            mSpaceWidth = mFont->requestGlyphInfo(UNICODE_ZERO).advance * mCharHeight;
         }
 
-        // Use iterator
-        auto iend = decoded.end();
-        bool newLine = true;
-        for( auto i = decoded.begin(); i != iend; ++i )
+        LayoutKey key{mFont.get(), mFont->_getGlyphsVersion(),
+                      _getDerivedLeft() * 2.0f - 1.0f, -( (_getDerivedTop() * 2.0f ) - 1.0f ),
+                      mCharHeight, mSpaceWidth, mViewportAspectCoef, mAlignment};
+
+        // Only the glyphs from the first changed code point on move, like the digits of a
+        // counter. Unless left aligned, the length of a line moves all of it though.
+        size_t start = 0;
+        if (key == mLayoutKey)
         {
+            start = std::ranges::mismatch(decoded, mLayoutCaption).in1 - decoded.begin();
+            if (start == charlen && charlen == mLayoutCaption.size())
+                return;
+
+            // CR LF is laid out as one
+            if (start > 0 && decoded[start - 1] == UNICODE_CR)
+                --start;
+            while (mAlignment != Alignment::Left && start > 0 && !isNewLine(decoded[start - 1]))
+                --start;
+        }
+
+        LayoutState state = start > 0 ? mLayout[start] : LayoutState{key.left, key.top, 0, 0};
+        mLayout.resize(start);
+        mLayoutCaption = decoded;
+
+        float largestWidth = state.largestWidth;
+        float left = state.left;
+        float top = state.top;
+        size_t vertex = state.vertex;
+
+        // Get position / texcoord buffer, locking only what is rewritten
+        const HardwareVertexBufferSharedPtr& vbuf = 
+            mRenderOp.vertexData->vertexBufferBinding->getBuffer(POS_TEX_BINDING);
+        HardwareBufferLockGuard vbufLock;
+        if (charlen * 6 > vertex)
+        {
+            vbufLock.lock(vbuf.get(), vertex * vbuf->getVertexSize(), (charlen * 6 - vertex) * vbuf->getVertexSize(),
+                          start == 0 ? HardwareBuffer::LockOptions::DISCARD : HardwareBuffer::LockOptions::NORMAL);
+        }
+        pVert = static_cast<float*>(vbufLock.pData);
+
+        bool newLine = start == 0 || isNewLine(decoded[start - 1]);
+        for (size_t i = start; i < charlen; ++i)
+        {
+            mLayout.push_back({left, top, largestWidth, vertex});
+
             if( newLine )
             {
                 Real len = 0.0f;
-                for(Font::CodePoint character : std::span{i,  iend})
+                for(Font::CodePoint character : std::span{decoded}.subspan(i))
                 {
-                    if (character == UNICODE_CR
-                        || character == UNICODE_NEL
-                        || character == UNICODE_LF) 
+                    if (isNewLine(character))
                     {
                         break;
                     }
@@ -275,7 +309,7 @@ namespace Ogre {
                     }
                     else 
                     {
-                        len += mFont->getGlyphInfo(character).advance * mCharHeight * 2.0f * mViewportAspectCoef;
+                        len += mFont->requestGlyphInfo(character).advance * mCharHeight * 2.0f * mViewportAspectCoef;
                     }
                 }
 
@@ -287,28 +321,18 @@ namespace Ogre {
                 newLine = false;
             }
 
-            Font::CodePoint character = *i;
-            if (character == UNICODE_CR
-                || character == UNICODE_NEL
-                || character == UNICODE_LF)
+            Font::CodePoint character = decoded[i];
+            if (isNewLine(character))
             {
-                left = _getDerivedLeft() * 2.0f - 1.0f;
+                left = key.left;
                 top -= mCharHeight * 2.0f;
                 newLine = true;
-                // Also reduce tri count
-                mRenderOp.vertexData->vertexCount -= 6;
 
                 // consume CR/LF in one
-                if (character == UNICODE_CR)
+                if (character == UNICODE_CR && i + 1 < charlen && decoded[i + 1] == UNICODE_LF)
                 {
-                    auto peeki = i + 1;
-                    if (peeki != iend && *peeki == UNICODE_LF)
-                    {
-                        i = peeki; // skip both as one newline
-                        // Also reduce tri count
-                        mRenderOp.vertexData->vertexCount -= 6;
-                    }
-
+                    mLayout.push_back(mLayout.back());
+                    ++i; // skip both as one newline
                 }
                 continue;
             }
@@ -316,12 +340,10 @@ namespace Ogre {
             {
                 // Just leave a gap, no tris
                 left += mSpaceWidth * 2.0f * mViewportAspectCoef;
-                // Also reduce tri count
-                mRenderOp.vertexData->vertexCount -= 6;
                 continue;
             }
 
-            const auto& glyphInfo = mFont->getGlyphInfo(character);
+            const auto& glyphInfo = mFont->requestGlyphInfo(character);
             Real horiz_height = glyphInfo.aspectRatio * mViewportAspectCoef ;
             const Font::UVRect& uvRect = glyphInfo.uvRect;
 
@@ -390,6 +412,7 @@ namespace Ogre {
 
             // Go back up with top
             top += mCharHeight * 2.0f;
+            vertex += 6;
 
             // advance
             left -= horiz_height  * mCharHeight * 2.0f;
@@ -402,6 +425,18 @@ namespace Ogre {
 
             }
         }
+        mLayout.push_back({left, top, largestWidth, vertex});
+        mRenderOp.vertexData->vertexCount = vertex;
+        vbufLock.unlock();
+
+        // glyphs rendered just now may have grown the atlas under the ones before
+        if (mFont->_getGlyphsVersion() != key.glyphsVersion)
+        {
+            mLayoutKey = {};
+            updatePositionGeometry();
+            return;
+        }
+        mLayoutKey = key;
 
         if (mMetricsMode == GuiMetricsMode::PIXELS)
         {
@@ -690,6 +725,7 @@ namespace Ogre {
         if (mColoursChanged && mInitialised)
         {
             updateColours();
+            _geometryUpdated();
             mColoursChanged = false;
         }
     }
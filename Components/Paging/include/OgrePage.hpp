@@ -0,0 +1,158 @@
+// This file is part of the OGRE project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at https://www.ogre3d.org/licensing.
+module;
+
+#include <cstddef>
+
+export module Ogre.Components.Paging:Page;
+
+export import Ogre.Core;
+
+export import <compare>;
+export import <functional>;
+export import <vector>;
+
+export
+namespace Ogre {
+
+    /** \addtogroup Optional
+    *  @{
+    */
+    /** \defgroup Paging Paging
+    * Streaming of the world in pages around the camera
+    *  @{
+    */
+    class PagedWorld;
+
+    /** Identifies a page by its cell on the grid of a PagedWorld.
+    @remarks
+        x counts along the world X axis and y along the world Z axis, the cell covering
+        [x, x + 1) * page size and [y, y + 1) * page size.
+    */
+    struct PageID
+    {
+        int32 x{0};
+        int32 y{0};
+
+        auto operator<=>(const PageID&) const = default;
+    };
+
+    /** A resource a page needs loaded before it is activated. */
+    struct PageResource
+    {
+        /// As ResourceManager::getResourceType
+        String type;
+        String name;
+        String group;
+
+        auto operator<=>(const PageResource&) const = default;
+    };
+
+    /** A cell of a PagedWorld with the content the PageProvider defined for it.
+    @remarks
+        While a page is LOADING its resources are loaded in the background through the
+        ResourceBackgroundQueue, shared with the other pages needing them. Once all are loaded
+        the activation tasks are run in the order they were added, within the per frame budget
+        of the world, and create the content below getSceneNode.
+    @par
+        When the page is unloaded everything attached below its scene node and the StaticGeometry
+        created through it are destroyed, and the resources no other page needs are unloaded.
+    */
+    class Page
+    {
+    public:
+        enum class State
+        {
+            /// Waiting for its resources
+            LOADING,
+            /// Resources loaded, waiting to be activated
+            LOADED,
+            /// Some of the activation tasks were run
+            ACTIVATING,
+            /// All activation tasks were run
+            ACTIVE
+        };
+
+        /// A step of the activation, run on the main thread
+        using Task = std::function<void(Page&)>;
+
+        Page(PagedWorld* world, PageID id);
+        ~Page();
+
+        Page(const Page&) = delete;
+        auto operator=(const Page&) -> Page& = delete;
+
+        [[nodiscard]] auto getID() const noexcept -> PageID { return mID; }
+        [[nodiscard]] auto getWorld() const noexcept -> PagedWorld* { return mWorld; }
+        [[nodiscard]] auto getState() const noexcept -> State { return mState; }
+
+        /** Adds a resource to load before the page is activated.
+        @remarks
+            Only valid in PageProvider::definePage.
+        */
+        void addResource(std::string_view type, std::string_view name, std::string_view group = RGN_DEFAULT);
+        [[nodiscard]] auto getResources() const noexcept -> const std::vector<PageResource>& { return mResources; }
+
+        /** Adds a step of the activation.
+        @remarks
+            Only valid in PageProvider::definePage. Each task should do a bounded amount of work,
+            e.g. create the entities of one kind or build one StaticGeometry, since the world runs
+            them as its activation budget allows, but never splits one.
+        */
+        void addActivationTask(Task task);
+        /// Gets the number of activation tasks not run yet
+        [[nodiscard]] auto getNumPendingTasks() const noexcept -> size_t { return mTasks.size() - mNextTask; }
+
+        /** Gets the node holding the content of the page.
+        @remarks
+            Created with the first call, at the minimum corner of the page below
+            PagedWorld::getSceneNode.
+        */
+        auto getSceneNode() -> SceneNode*;
+
+        /** Creates a StaticGeometry destroyed with the page.
+        @remarks
+            The name has to be unique in the SceneManager of the world.
+        */
+        auto createStaticGeometry(std::string_view name) -> StaticGeometry*;
+
+    private:
+        friend class PagedWorld;
+
+        PagedWorld* mWorld;
+        PageID mID;
+        State mState{State::LOADING};
+
+        std::vector<PageResource> mResources;
+        std::vector<Task> mTasks;
+        size_t mNextTask{0};
+
+        SceneNode* mSceneNode{nullptr};
+        std::vector<StaticGeometry*> mStaticGeometries;
+
+        /// Runs the next activation task
+        void runNextTask();
+        /// Destroys the scene node with all below it and the StaticGeometry
+        void destroyContent();
+    };
+
+    /** Defines the content of the pages of a PagedWorld. */
+    class PageProvider
+    {
+    public:
+        virtual ~PageProvider() = default;
+
+        /** Declares the resources and activation tasks of a page coming into range.
+        @remarks
+            Called on the main thread, so this should only describe the page but not create it.
+        @return false if the world has no page at this cell
+        */
+        virtual auto definePage(Page& page) -> bool = 0;
+
+        /** Called before the content of an activating or active page is destroyed. */
+        virtual void deactivatePage(Page& page) { (void)page; }
+    };
+    /** @} */
+    /** @} */
+}
@@ -0,0 +1,160 @@
+// This file is part of the OGRE project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at https://www.ogre3d.org/licensing.
+module;
+
+#include <cstddef>
+
+export module Ogre.Components.Paging:PagedWorld;
+
+export import :Page;
+
+export import Ogre.Core;
+
+export import <map>;
+export import <memory>;
+export import <set>;
+export import <vector>;
+
+export
+namespace Ogre {
+
+    /** \addtogroup Optional
+    *  @{
+    */
+    /** \addtogroup Paging
+    *  @{
+    */
+    /** Streams a world partitioned into square pages on the XZ plane around a camera.
+    @remarks
+        Each update the pages within the load radius of the camera are defined by the
+        PageProvider, nearest first, and their resources are queued on the
+        ResourceBackgroundQueue with the negated distance as RequestPriority. Pages whose
+        resources are loaded are activated nearest first, running their tasks while the
+        activation budget of the frame allows. Pages beyond the unload radius are destroyed
+        and the resources no other page needs are unloaded in the background.
+    @par
+        The memory budget counts the size of the loaded resources. While it is exceeded, the
+        pages between the load and unload radius are unloaded farthest first, and no new pages
+        are defined. The pages within the load radius are always kept, and those already
+        loading may exceed the budget.
+    @par
+        The loads are polled each update rather than waited for. A resource is unloaded once no
+        page needs it, so the pages should only list resources used by the world alone.
+    @par
+        Add the world with Root::addFrameListener to update it each frame, or call update. It
+        has to be destroyed before its SceneManager.
+    */
+    class PagedWorld : public FrameListener
+    {
+    public:
+        PagedWorld(SceneManager* sceneMgr, PageProvider* provider, Real pageSize);
+        ~PagedWorld() override;
+
+        PagedWorld(const PagedWorld&) = delete;
+        auto operator=(const PagedWorld&) -> PagedWorld& = delete;
+
+        [[nodiscard]] auto getSceneManager() const noexcept -> SceneManager* { return mSceneMgr; }
+        [[nodiscard]] auto getPageSize() const noexcept -> Real { return mPageSize; }
+        /// Gets the parent of the nodes of the pages
+        [[nodiscard]] auto getSceneNode() const noexcept -> SceneNode* { return mSceneNode; }
+
+        /** Sets the camera the pages are streamed around, nothing is loaded without one. */
+        void setCamera(const Camera* cam) { mCamera = cam; }
+        [[nodiscard]] auto getCamera() const noexcept -> const Camera* { return mCamera; }
+
+        /** Sets the distance up to which pages are loaded, twice the page size by default.
+        @remarks
+            The distance is measured on the XZ plane from the camera to the closest point of
+            the page. The unload radius grows along if it would be smaller.
+        */
+        void setLoadRadius(Real radius);
+        [[nodiscard]] auto getLoadRadius() const noexcept -> Real { return mLoadRadius; }
+
+        /** Sets the distance beyond which pages are unloaded, three times the page size by
+            default.
+        @remarks
+            The margin to the load radius keeps the pages at the border from being loaded and
+            unloaded again as the camera moves back and forth. At least the load radius.
+        */
+        void setUnloadRadius(Real radius);
+        [[nodiscard]] auto getUnloadRadius() const noexcept -> Real { return mUnloadRadius; }
+
+        /** Sets the size of the loaded resources in bytes above which pages are evicted, 0
+            for no limit, the default. */
+        void setMemoryBudget(size_t bytes) { mMemoryBudget = bytes; }
+        [[nodiscard]] auto getMemoryBudget() const noexcept -> size_t { return mMemoryBudget; }
+        /// Gets the size of the resources loaded for the pages in bytes
+        [[nodiscard]] auto getMemoryUsage() const noexcept -> size_t { return mMemoryUsage; }
+
+        /** Sets the main thread time per update spent running activation tasks.
+        @remarks
+            At least one task is run per update. 0, the default, activates the loaded pages
+            completely in the update they finished loading.
+        @param micros The budget in microseconds
+        */
+        void setActivationBudget(unsigned long micros) { mActivationBudget = micros; }
+        [[nodiscard]] auto getActivationBudget() const noexcept -> unsigned long { return mActivationBudget; }
+
+        /// Gets the page of the cell containing a world position
+        [[nodiscard]] auto getPageID(const Vector3& position) const -> PageID;
+        /// Gets the minimum corner of the cell of a page
+        [[nodiscard]] auto getPageOrigin(PageID id) const -> Vector3;
+        /// Gets a page, @c nullptr if it is not loaded
+        [[nodiscard]] auto getPage(PageID id) const -> Page*;
+        [[nodiscard]] auto getNumPages() const noexcept -> size_t { return mPages.size(); }
+
+        /** Loads, activates and unloads the pages for the current camera position. */
+        void update();
+
+        /** Unloads all pages. */
+        void unloadAllPages();
+
+        auto frameStarted(const FrameEvent& evt) -> bool override;
+
+    private:
+        /// A resource of the pages, loaded once for all needing it
+        struct ResourceUse
+        {
+            /// Number of pages needing it, 0 while an abandoned load is still finishing
+            size_t pages{0};
+            /// Ticket of the load, 0 once it completed
+            BackgroundProcessTicket ticket{0};
+            size_t size{0};
+            bool loaded{false};
+        };
+        using ResourceMap = std::map<PageResource, ResourceUse>;
+
+        SceneManager* mSceneMgr;
+        PageProvider* mProvider;
+        Real mPageSize;
+        SceneNode* mSceneNode;
+        const Camera* mCamera{nullptr};
+
+        Real mLoadRadius;
+        Real mUnloadRadius;
+        size_t mMemoryBudget{0};
+        size_t mMemoryUsage{0};
+        unsigned long mActivationBudget{0};
+
+        std::map<PageID, std::unique_ptr<Page>> mPages;
+        /// Cells without a page, so the provider is not asked again while they stay in range
+        std::set<PageID> mEmptyCells;
+        ResourceMap mResources;
+        std::map<BackgroundProcessTicket, PageResource> mTickets;
+
+        /// Distance on the XZ plane from a position to the closest point of a page
+        [[nodiscard]] auto getDistance(PageID id, const Vector3& position) const -> Real;
+
+        void loadPage(PageID id, Real distance);
+        void unloadPage(PageID id);
+        void acquireResource(const PageResource& resource, Real distance);
+        void releaseResource(const PageResource& resource);
+        /// Accounts a finished load, or unloads it again if no page needs it any more
+        void completeLoad(ResourceMap::iterator it);
+        /// Checks whether the resources of a loading page are all loaded
+        [[nodiscard]] auto isLoaded(const Page& page) const -> bool;
+    };
+    /** @} */
+    /** @} */
+}
@@ -0,0 +1,96 @@
+// This file is part of the OGRE project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at https://www.ogre3d.org/licensing.
+module;
+
+#include <cstddef>
+
+module Ogre.Components.Paging;
+
+import :Page;
+import :PagedWorld;
+
+import Ogre.Core;
+
+import <string>;
+import <utility>;
+import <vector>;
+
+namespace Ogre {
+    namespace {
+        /// Destroys the objects attached to a node and its children
+        void destroyAttachedObjects(SceneNode* node)
+        {
+            SceneManager* sceneMgr = node->getCreator();
+            while (!node->getAttachedObjects().empty())
+                sceneMgr->destroyMovableObject(node->getAttachedObjects().back());
+
+            for (Node* child : node->getChildren())
+                destroyAttachedObjects(static_cast<SceneNode*>(child));
+        }
+    }
+    //-----------------------------------------------------------------------
+    Page::Page(PagedWorld* world, PageID id)
+        : mWorld(world), mID(id)
+    {
+    }
+    //-----------------------------------------------------------------------
+    Page::~Page()
+    {
+        destroyContent();
+    }
+    //-----------------------------------------------------------------------
+    void Page::addResource(std::string_view type, std::string_view name, std::string_view group)
+    {
+        OgreAssert(mState == State::LOADING && !mSceneNode, "resources can only be added while the page is defined");
+        mResources.push_back({String{type}, String{name}, String{group}});
+    }
+    //-----------------------------------------------------------------------
+    void Page::addActivationTask(Task task)
+    {
+        OgreAssert(mState == State::LOADING && !mSceneNode, "tasks can only be added while the page is defined");
+        mTasks.push_back(std::move(task));
+    }
+    //-----------------------------------------------------------------------
+    auto Page::getSceneNode() -> SceneNode*
+    {
+        if (!mSceneNode)
+            mSceneNode = mWorld->getSceneNode()->createChildSceneNode(mWorld->getPageOrigin(mID));
+        return mSceneNode;
+    }
+    //-----------------------------------------------------------------------
+    auto Page::createStaticGeometry(std::string_view name) -> StaticGeometry*
+    {
+        StaticGeometry* geom = mWorld->getSceneManager()->createStaticGeometry(name);
+        mStaticGeometries.push_back(geom);
+        return geom;
+    }
+    //-----------------------------------------------------------------------
+    void Page::runNextTask()
+    {
+        mState = State::ACTIVATING;
+        Task& task = mTasks[mNextTask++];
+        task(*this);
+        // release what it captured
+        task = nullptr;
+
+        if (mNextTask == mTasks.size())
+            mState = State::ACTIVE;
+    }
+    //-----------------------------------------------------------------------
+    void Page::destroyContent()
+    {
+        SceneManager* sceneMgr = mWorld->getSceneManager();
+        for (StaticGeometry* geom : mStaticGeometries)
+            sceneMgr->destroyStaticGeometry(geom);
+        mStaticGeometries.clear();
+
+        if (mSceneNode)
+        {
+            destroyAttachedObjects(mSceneNode);
+            mSceneNode->removeAndDestroyAllChildren();
+            sceneMgr->destroySceneNode(mSceneNode);
+            mSceneNode = nullptr;
+        }
+    }
+}
@@ -0,0 +1,315 @@
+// This file is part of the OGRE project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at https://www.ogre3d.org/licensing.
+module;
+
+#include <cstddef>
+
+module Ogre.Components.Paging;
+
+import :Page;
+import :PagedWorld;
+
+import Ogre.Core;
+
+import <algorithm>;
+import <cmath>;
+import <format>;
+import <functional>;
+import <map>;
+import <memory>;
+import <utility>;
+import <vector>;
+
+namespace Ogre {
+    //-----------------------------------------------------------------------
+    PagedWorld::PagedWorld(SceneManager* sceneMgr, PageProvider* provider, Real pageSize)
+        : mSceneMgr(sceneMgr), mProvider(provider), mPageSize(pageSize),
+          mLoadRadius(pageSize * 2), mUnloadRadius(pageSize * 3)
+    {
+        OgreAssert(sceneMgr && provider, "PagedWorld needs a SceneManager and a PageProvider");
+        OgreAssert(pageSize > 0, "page size must be positive");
+        mSceneNode = mSceneMgr->getRootSceneNode()->createChildSceneNode();
+    }
+    //-----------------------------------------------------------------------
+    PagedWorld::~PagedWorld()
+    {
+        unloadAllPages();
+
+        // abandoned loads which are still finishing
+        for (auto const& [ticket, resource] : mTickets)
+            ResourceBackgroundQueue::getSingleton().abortRequest(ticket);
+
+        mSceneMgr->destroySceneNode(mSceneNode);
+    }
+    //-----------------------------------------------------------------------
+    void PagedWorld::setLoadRadius(Real radius)
+    {
+        mLoadRadius = radius;
+        mUnloadRadius = std::max(mUnloadRadius, radius);
+    }
+    //-----------------------------------------------------------------------
+    void PagedWorld::setUnloadRadius(Real radius)
+    {
+        OgreAssert(radius >= mLoadRadius, "unload radius smaller than the load radius");
+        mUnloadRadius = radius;
+    }
+    //-----------------------------------------------------------------------
+    auto PagedWorld::getPageID(const Vector3& position) const -> PageID
+    {
+        return {static_cast<int32>(std::floor(position.x / mPageSize)),
+                static_cast<int32>(std::floor(position.z / mPageSize))};
+    }
+    //-----------------------------------------------------------------------
+    auto PagedWorld::getPageOrigin(PageID id) const -> Vector3
+    {
+        return {Real(id.x) * mPageSize, 0, Real(id.y) * mPageSize};
+    }
+    //-----------------------------------------------------------------------
+    auto PagedWorld::getPage(PageID id) const -> Page*
+    {
+        auto it = mPages.find(id);
+        return it == mPages.end() ? nullptr : it->second.get();
+    }
+    //-----------------------------------------------------------------------
+    auto PagedWorld::getDistance(PageID id, const Vector3& position) const -> Real
+    {
+        Vector3 origin = getPageOrigin(id);
+        Real dx = std::max({origin.x - position.x, Real(0), position.x - origin.x - mPageSize});
+        Real dz = std::max({origin.z - position.z, Real(0), position.z - origin.z - mPageSize});
+        return std::sqrt(dx * dx + dz * dz);
+    }
+    //-----------------------------------------------------------------------
+    auto PagedWorld::frameStarted(const FrameEvent& evt) -> bool
+    {
+        (void)evt;
+        update();
+        return true;
+    }
+    //-----------------------------------------------------------------------
+    void PagedWorld::update()
+    {
+        if (!mCamera)
+            return;
+
+        const Vector3& position = mCamera->getDerivedPosition();
+
+        // unload the pages out of range, and note those only kept by the margin
+        std::vector<std::pair<Real, PageID>> margin;
+        for (auto it = mPages.begin(); it != mPages.end();)
+        {
+            PageID id = (it++)->first;
+            Real distance = getDistance(id, position);
+            if (distance > mUnloadRadius)
+                unloadPage(id);
+            else if (distance > mLoadRadius)
+                margin.emplace_back(distance, id);
+        }
+        std::erase_if(mEmptyCells, [&](PageID id) { return getDistance(id, position) > mUnloadRadius; });
+
+        if (mMemoryBudget)
+        {
+            std::ranges::sort(margin, std::greater{});
+            for (auto const& [distance, id] : margin)
+            {
+                if (mMemoryUsage <= mMemoryBudget)
+                    break;
+                unloadPage(id);
+            }
+        }
+
+        // define the missing pages in range, nearest first
+        std::vector<std::pair<Real, PageID>> missing;
+        PageID centre = getPageID(position);
+        auto cells = static_cast<int32>(std::ceil(mLoadRadius / mPageSize));
+        for (int32 y = centre.y - cells; y <= centre.y + cells; ++y)
+        {
+            for (int32 x = centre.x - cells; x <= centre.x + cells; ++x)
+            {
+                PageID id{x, y};
+                if (mPages.contains(id) || mEmptyCells.contains(id))
+                    continue;
+                Real distance = getDistance(id, position);
+                if (distance <= mLoadRadius)
+                    missing.emplace_back(distance, id);
+            }
+        }
+        std::ranges::sort(missing);
+        for (auto const& [distance, id] : missing)
+        {
+            if (mMemoryBudget && mMemoryUsage >= mMemoryBudget)
+                break;
+            loadPage(id, distance);
+        }
+
+        // account the finished loads
+        ResourceBackgroundQueue& queue = ResourceBackgroundQueue::getSingleton();
+        for (auto it = mTickets.begin(); it != mTickets.end();)
+        {
+            if (!queue.isProcessComplete(it->first))
+            {
+                ++it;
+                continue;
+            }
+            auto resource = mResources.find(it->second);
+            it = mTickets.erase(it);
+            if (resource != mResources.end())
+                completeLoad(resource);
+        }
+
+        // the loaded pages, and the nearest page waiting for each load
+        std::vector<std::pair<Real, Page*>> activation;
+        std::map<BackgroundProcessTicket, Real> priorities;
+        for (auto const& [id, page] : mPages)
+        {
+            Real distance = getDistance(id, position);
+            if (page->mState == Page::State::LOADING)
+            {
+                if (!isLoaded(*page))
+                {
+                    for (const PageResource& resource : page->mResources)
+                    {
+                        const ResourceUse& use = mResources.at(resource);
+                        if (!use.ticket)
+                            continue;
+                        auto [priority, inserted] = priorities.emplace(use.ticket, -distance);
+                        if (!inserted)
+                            priority->second = std::max(priority->second, -distance);
+                    }
+                    continue;
+                }
+                page->mState = Page::State::LOADED;
+            }
+            if (page->mState != Page::State::ACTIVE)
+                activation.emplace_back(distance, page.get());
+        }
+        for (auto const& [ticket, priority] : priorities)
+            queue.updateRequestPriority(ticket, {priority});
+
+        // activate within the budget, at least one task per update
+        std::ranges::sort(activation, {}, &std::pair<Real, Page*>::first);
+        Timer* timer = Root::getSingleton().getTimer();
+        unsigned long start = timer->getMicroseconds();
+        bool ranTask = false;
+        for (auto const& [distance, page] : activation)
+        {
+            while (page->getNumPendingTasks() > 0)
+            {
+                if (mActivationBudget && ranTask && timer->getMicroseconds() - start >= mActivationBudget)
+                    return;
+                page->runNextTask();
+                ranTask = true;
+            }
+            page->mState = Page::State::ACTIVE;
+        }
+    }
+    //-----------------------------------------------------------------------
+    void PagedWorld::unloadAllPages()
+    {
+        while (!mPages.empty())
+            unloadPage(mPages.begin()->first);
+        mEmptyCells.clear();
+    }
+    //-----------------------------------------------------------------------
+    void PagedWorld::loadPage(PageID id, Real distance)
+    {
+        auto page = std::make_unique<Page>(this, id);
+        if (!mProvider->definePage(*page))
+        {
+            mEmptyCells.insert(id);
+            return;
+        }
+
+        for (const PageResource& resource : page->mResources)
+            acquireResource(resource, distance);
+        mPages.emplace(id, std::move(page));
+    }
+    //-----------------------------------------------------------------------
+    void PagedWorld::unloadPage(PageID id)
+    {
+        auto it = mPages.find(id);
+        if (it == mPages.end())
+            return;
+
+        std::unique_ptr<Page> page = std::move(it->second);
+        mPages.erase(it);
+
+        if (page->mState == Page::State::ACTIVATING || page->mState == Page::State::ACTIVE)
+            mProvider->deactivatePage(*page);
+        page->destroyContent();
+
+        for (const PageResource& resource : page->mResources)
+            releaseResource(resource);
+    }
+    //-----------------------------------------------------------------------
+    void PagedWorld::acquireResource(const PageResource& resource, Real distance)
+    {
+        ResourceUse& use = mResources[resource];
+        ++use.pages;
+        if (use.loaded || use.ticket)
+            return;
+
+        ResourceBackgroundQueue& queue = ResourceBackgroundQueue::getSingleton();
+        ResourceBackgroundQueue::RequestPriority previous = queue.getRequestPriority();
+        queue.setRequestPriority({-distance});
+        use.ticket = queue.load(resource.type, resource.name, resource.group);
+        queue.setRequestPriority(previous);
+        mTickets.emplace(use.ticket, resource);
+    }
+    //-----------------------------------------------------------------------
+    void PagedWorld::releaseResource(const PageResource& resource)
+    {
+        auto it = mResources.find(resource);
+        if (it == mResources.end() || --it->second.pages > 0)
+            return;
+
+        ResourceUse& use = it->second;
+        ResourceBackgroundQueue& queue = ResourceBackgroundQueue::getSingleton();
+        if (use.ticket)
+        {
+            queue.abortRequest(use.ticket);
+            // already handed to a worker, unloaded again once it finished
+            if (!queue.isProcessComplete(use.ticket))
+                return;
+            mTickets.erase(use.ticket);
+        }
+        else if (use.loaded)
+        {
+            mMemoryUsage -= use.size;
+            queue.unload(resource.type, resource.name);
+        }
+        mResources.erase(it);
+    }
+    //-----------------------------------------------------------------------
+    void PagedWorld::completeLoad(ResourceMap::iterator it)
+    {
+        const PageResource& resource = it->first;
+        ResourceUse& use = it->second;
+        use.ticket = 0;
+
+        if (use.pages == 0)
+        {
+            ResourceBackgroundQueue::getSingleton().unload(resource.type, resource.name);
+            mResources.erase(it);
+            return;
+        }
+
+        use.loaded = true;
+        ResourcePtr res = ResourceGroupManager::getSingleton()._getResourceManager(resource.type)
+                              ->getResourceByName(resource.name, resource.group);
+        if (!res || !res->isLoaded())
+        {
+            LogManager::getSingleton().logWarning(
+                std::format("PagedWorld: could not load {} '{}'", resource.type, resource.name));
+            return;
+        }
+        use.size = res->getSize();
+        mMemoryUsage += use.size;
+    }
+    //-----------------------------------------------------------------------
+    auto PagedWorld::isLoaded(const Page& page) const -> bool
+    {
+        return std::ranges::all_of(page.mResources,
+                                   [this](const PageResource& resource) { return mResources.at(resource).loaded; });
+    }
+}
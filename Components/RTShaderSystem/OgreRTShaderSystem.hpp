@@ -26,10 +26,12 @@ THE SOFTWARE.
 */
 export module Ogre.Components.RTShaderSystem;
 
+export import :ShaderExClusteredLighting;
 export import :ShaderExGBuffer;
 export import :ShaderExHardwareSkinning;
 export import :ShaderExIntegratedPSSM3;
 export import :ShaderExLayeredBlending;
+export import :ShaderExTextureArrayLayer;
 export import :ShaderExTriplanarTexturing;
 export import :ShaderFFPRenderState;
 export import :ShaderFFPTexturing;
@@ -0,0 +1,176 @@
+// This file is part of the OGRE project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at https://www.ogre3d.org/licensing.
+// SPDX-License-Identifier: MIT
+export module Ogre.Components.RTShaderSystem:ShaderExClusteredLighting;
+
+export import :ShaderFFPRenderState;
+export import :ShaderPrerequisites;
+export import :ShaderSubRenderState;
+
+export import Ogre.Core;
+
+export import <span>;
+export import <vector>;
+
+export
+namespace Ogre::RTShader
+{
+
+/** \addtogroup Optional
+ *  @{
+ */
+/** \addtogroup RTShader
+ *  @{
+ */
+
+/** The lights affecting the frustum of a camera, binned into view space clusters.
+@remarks
+The clusters divide the frustum in GRID_X * GRID_Y tiles in normalised device coordinates and
+GRID_Z slices, that are distributed logarithmically between the near and far clip distance.
+Point and spot lights are added to all clusters the bounding box of their range overlaps,
+directional lights affect every cluster and are kept apart.
+@par
+The result is stored in three textures, which ClusteredLighting reads:
+- the light data: for every light a column of 6 texels, holding the view space position,
+  the view space direction, the attenuation, the spotlight parameters and the power scaled diffuse
+  and specular colour, in the layout of the matching auto constants. Directional lights come first.
+- the clusters: for every cluster the offset and count of its lights in the index list
+- the index list: the light indices of all clusters, one after the other
+*/
+class LightClusters
+{
+public:
+    static constexpr uint32 GRID_X = 16;
+    static constexpr uint32 GRID_Y = 8;
+    static constexpr uint32 GRID_Z = 24;
+    /// Lights beyond this count are ignored
+    static constexpr uint32 MAX_LIGHTS = 1024;
+    static constexpr uint32 INDEX_TEXTURE_WIDTH = 1024;
+    static constexpr uint32 INDEX_TEXTURE_HEIGHT = 64;
+
+    LightClusters();
+    ~LightClusters();
+
+    /** Assign the given lights to the clusters of the camera and upload the result.
+    @remarks
+    Does nothing if called again with the same camera during a frame.
+    */
+    void update(const Camera* cam, const LightList& lights);
+
+    /// The CPU part of update
+    void assign(const Camera* cam, const LightList& lights);
+
+    /** Add texture units for the light data, the clusters and the index list to pass.
+    @remarks
+    Creates the textures first, if there is a RenderSystem to create them with.
+    @return the index of the first of the three texture units
+    */
+    auto bindTextures(Pass* pass) -> uint8;
+
+    /// The indices, into the light data, of the point and spot lights affecting a cluster, as stored in the index list
+    [[nodiscard]] auto getClusterLights(uint32 x, uint32 y, uint32 z) const -> std::span<const float>;
+
+    /// Count of the directional lights, which are at the start of the light data
+    [[nodiscard]] auto getDirectionalLightCount() const noexcept -> size_t { return mDirectionalCount; }
+
+    /// Count of all lights in the light data
+    [[nodiscard]] auto getLightCount() const noexcept -> size_t { return mLightCount; }
+
+    /// The shader parameters, see SGXLib_ClusteredLighting
+    [[nodiscard]] auto getGridParams() const noexcept -> const Vector4& { return mGridParams; }
+    [[nodiscard]] auto getDepthParams() const noexcept -> const Vector4& { return mDepthParams; }
+    [[nodiscard]] auto getTexelParams() const -> Vector4;
+    [[nodiscard]] auto getProjectionMatrix() const noexcept -> const Matrix4& { return mProjectionMatrix; }
+
+    static std::string_view const LIGHT_TEXTURE_NAME;
+    static std::string_view const CLUSTER_TEXTURE_NAME;
+    static std::string_view const INDEX_TEXTURE_NAME;
+
+private:
+    void createTextures();
+    void upload();
+
+    std::vector<float> mLightData;
+    std::vector<float> mClusterData;
+    std::vector<float> mIndices;
+    size_t mDirectionalCount{0};
+    size_t mLightCount{0};
+    Vector4 mGridParams;
+    Vector4 mDepthParams;
+    Matrix4 mProjectionMatrix;
+
+    TexturePtr mLightTexture;
+    TexturePtr mClusterTexture;
+    TexturePtr mIndexTexture;
+
+    const Camera* mLastCamera{nullptr};
+    unsigned long mLastFrame{0};
+};
+
+/** Per pixel lighting of a single pass with any count of lights.
+@remarks
+Instead of a fixed count of lights per pass, this evaluates the lights that LightClusters
+assigned to the cluster of the pixel, and all directional lights. The pass does not need to be
+iterated per light, so hundreds of lights render in one pass.
+The lighting model is the one of PerPixelLighting. Vertex colour tracking is not supported.
+*/
+class ClusteredLighting : public SubRenderState
+{
+public:
+    auto getType() const noexcept -> std::string_view override;
+
+    auto getExecutionOrder() const noexcept -> FFPShaderStage override { return FFPShaderStage::LIGHTING; }
+
+    void copyFrom(const SubRenderState& rhs) override;
+
+    auto preAddToRenderState(const RenderState* renderState, Pass* srcPass, Pass* dstPass) noexcept -> bool override;
+
+    auto createCpuSubPrograms(ProgramSet* programSet) -> bool override;
+
+    void updateGpuProgramsParams(Renderable* rend, const Pass* pass, const AutoParamDataSource* source,
+                                 const LightList* pLightList) override;
+
+    // Type of this render state.
+    static std::string_view const Type;
+
+private:
+    friend class ClusteredLightingFactory;
+
+    LightClusters* mClusters{nullptr};
+    bool mSpecularEnable{false};
+    uint8 mLightDataSamplerIndex{0};
+
+    UniformParameterPtr mProjectionMatrix;
+    UniformParameterPtr mGridParams;
+    UniformParameterPtr mDepthParams;
+    UniformParameterPtr mTexelParams;
+};
+
+/**
+A factory that enables creation of ClusteredLighting instances.
+@remarks Sub class of SubRenderStateFactory. It owns the LightClusters shared by all instances.
+*/
+class ClusteredLightingFactory : public SubRenderStateFactory
+{
+public:
+    [[nodiscard]] auto getType() const noexcept -> std::string_view override;
+
+    auto createInstance(ScriptCompiler* compiler, PropertyAbstractNode* prop, Pass* pass,
+                                   SGScriptTranslator* translator) noexcept -> SubRenderState* override;
+    void writeInstance(MaterialSerializer* ser, SubRenderState* subRenderState, Pass* srcPass, Pass* dstPass) override;
+
+    /// The clusters read by all ClusteredLighting instances
+    [[nodiscard]] auto getLightClusters() noexcept -> LightClusters* { return &mClusters; }
+
+protected:
+    auto createInstanceImpl() -> SubRenderState* override;
+
+private:
+    LightClusters mClusters;
+};
+
+/** @} */
+/** @} */
+
+} // namespace Ogre
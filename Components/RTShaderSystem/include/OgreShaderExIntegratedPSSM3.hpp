@@ -98,6 +98,11 @@ public:
 
     void setDebug(bool enable) { mDebug = enable; }
 
+    /** Sets "debug" or "filter", the latter being one of
+    - pcf4, pcf16: 2x2 or 4x4 depth comparisons per pixel, the default is pcf4
+    - esm, evsm: a single tap of an exponential or exponential variance shadow map, see
+      SceneManager::setShadowTextureCompositor for rendering and pre-filtering them
+    */
     auto setParameter(std::string_view name, std::string_view value) noexcept -> bool override;
 
     static std::string_view const Type;
@@ -125,6 +130,13 @@ protected:
 
     };
 
+    enum class Filter : uint8
+    {
+        PCF,
+        ESM,
+        EVSM
+    };
+
     using ShadowTextureParamsList = std::vector<ShadowTextureParams>;
     using ShadowTextureParamsIterator = ShadowTextureParamsList::iterator;
     using ShadowTextureParamsConstIterator = ShadowTextureParamsList::const_iterator;
@@ -189,6 +201,7 @@ protected:
     UniformParameterPtr mPSDerivedSceneColour;
 
     float mPCFxSamples;
+    Filter mFilter;
     bool mUseTextureCompare;
     bool mUseColourShadows;
     bool mDebug;
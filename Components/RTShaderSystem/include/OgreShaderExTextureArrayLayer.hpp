@@ -0,0 +1,87 @@
+// This file is part of the OGRE project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at https://www.ogre3d.org/licensing.
+// SPDX-License-Identifier: MIT
+module;
+
+#include <cstddef>
+
+export module Ogre.Components.RTShaderSystem:ShaderExTextureArrayLayer;
+
+export import :ShaderFFPRenderState;
+export import :ShaderPrerequisites;
+export import :ShaderSubRenderState;
+
+export import Ogre.Core;
+
+export import <vector>;
+
+export
+namespace Ogre::RTShader
+{
+
+/** \addtogroup Optional
+ *  @{
+ */
+/** \addtogroup RTShader
+ *  @{
+ */
+
+/** Selects the layer of the texture arrays of a pass by a custom parameter of the renderable.
+@remarks
+FFPTexturing samples TextureType::_2D_ARRAY textures with three texture coordinates, the third
+being the layer. For every array unit without a texture matrix, this sets the third coordinate
+passed to the fragment program to the x component of the custom parameter, see
+Renderable::setCustomParameter, so that objects sharing a material sample different layers.
+This is how the materials of TextureArrayPacker draw. The script keyword is
+@code
+texture_array_layer <custom parameter index>
+@endcode
+*/
+class TextureArrayLayer : public SubRenderState
+{
+public:
+    auto getType() const noexcept -> std::string_view override;
+
+    auto getExecutionOrder() const noexcept -> FFPShaderStage override { return FFPShaderStage::TEXTURING + 1; }
+
+    void copyFrom(const SubRenderState& rhs) override;
+
+    auto preAddToRenderState(const RenderState* renderState, Pass* srcPass, Pass* dstPass) noexcept -> bool override;
+
+    auto createCpuSubPrograms(ProgramSet* programSet) -> bool override;
+
+    /// Sets the index of the custom parameter holding the layer, 0 by default
+    void setLayerParameter(size_t index) { mLayerParameter = index; }
+    [[nodiscard]] auto getLayerParameter() const noexcept -> size_t { return mLayerParameter; }
+
+    // Type of this render state.
+    static std::string_view const Type;
+
+private:
+    size_t mLayerParameter{0};
+    /// Texture coordinate sets of the array units
+    std::vector<unsigned int> mTexCoordSets;
+};
+
+/**
+A factory that enables creation of TextureArrayLayer instances.
+@remarks Sub class of SubRenderStateFactory
+*/
+class TextureArrayLayerFactory : public SubRenderStateFactory
+{
+public:
+    [[nodiscard]] auto getType() const noexcept -> std::string_view override;
+
+    auto createInstance(ScriptCompiler* compiler, PropertyAbstractNode* prop, Pass* pass,
+                                   SGScriptTranslator* translator) noexcept -> SubRenderState* override;
+    void writeInstance(MaterialSerializer* ser, SubRenderState* subRenderState, Pass* srcPass, Pass* dstPass) override;
+
+protected:
+    auto createInstanceImpl() -> SubRenderState* override;
+};
+
+/** @} */
+/** @} */
+
+} // namespace Ogre
@@ -79,11 +79,19 @@ public:
         mTexCoordIndex = Parameter::Content(std::to_underlying(Parameter::Content::TEXTURE_COORDINATE0) + texCoordIndex);
     }
 
+    /// Expand instanced billboards from their instance data, see BillboardSet::setInstancedRenderingEnabled
+    void setInstancedBillboards(bool enabled) { mBillboards = enabled; }
+
+    /// Expand the segments of a chain on the GPU, see BillboardChain::setIncrementalUpdatesEnabled
+    void setChainExpansion(bool enabled) { mChains = enabled; }
+
     static std::string_view const Type;
 protected:
     Parameter::Content mTexCoordIndex = Parameter::Content::TEXTURE_COORDINATE0;
     bool mSetPointSize;
     bool mInstanced = false;
+    bool mBillboards = false;
+    bool mChains = false;
     bool mDoLightCalculations;
 };
 
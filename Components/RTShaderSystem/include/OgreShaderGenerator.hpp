@@ -31,11 +31,13 @@ module;
 export module Ogre.Components.RTShaderSystem:ShaderGenerator;
 
 export import :ShaderPrerequisites;
+export import :ShaderRenderState;
 export import :ShaderScriptTranslator;
 
 export import Ogre.Core;
 
 export import <algorithm>;
+export import <iosfwd>;
 export import <map>;
 export import <memory>;
 export import <set>;
@@ -170,6 +172,31 @@ public:
     */
     [[nodiscard]] auto getShaderCachePath() const noexcept -> std::string_view { return mShaderCachePath; }
 
+    /**
+    Write the variant manifest to the shader cache path: every material, source and destination scheme
+    that shaders were generated for so far, one per line.
+    This is done by destroy, when a shader cache path is set.
+    @see warmUpVariants
+    */
+    void writeVariantManifest();
+
+    /**
+    Generate the shaders of the variants in the manifest of a previous run, before the first frame needs them.
+    @remarks
+    Materials that do not exist are skipped, so call this once their resource groups are initialised and
+    the schemes configured. With a RenderSystem the generated programs are also loaded, which compiles them.
+    All of this runs on the calling thread, as creating programs is not thread safe.
+    @return The number of variants generated
+    @see writeVariantManifest
+    */
+    auto warmUpVariants() -> size_t;
+
+    /** Generate the shaders of the variants in a manifest, as warmUpVariants does with that of the shader cache path.
+    @remarks
+    Also reads the manifest of ShaderTelemetry::writeVariantManifest, e.g. of a test run of every level.
+    */
+    auto warmUpVariants(std::istream& manifest) -> size_t;
+
     /** 
     Flush the shader cache. This operation will cause all active schemes to be invalidated and will
     destroy any CPU/GPU program that created by this shader generator.
@@ -506,6 +533,11 @@ private:
         /** Build the render state and acquire the CPU/GPU programs */
         void buildTargetRenderState();
 
+        /** Build the render state, leaving its programs to TargetRenderState::acquirePrograms.
+        @param pending Receives the render state and the pass, unless the pass keeps its shaders
+        */
+        void buildTargetRenderState(TargetRenderState::PendingProgramList& pending);
+
         /** Get source pass. */
         auto getSrcPass() noexcept -> Pass* { return mSrcPass; }
 
@@ -562,6 +594,9 @@ private:
         /** Build the render state. */
         void buildTargetRenderState();
 
+        /** Build the render state, leaving the programs of the passes to TargetRenderState::acquirePrograms. */
+        void buildTargetRenderState(TargetRenderState::PendingProgramList& pending);
+
 		/** Build the render state for illumination passes. */
 		void buildIlluminationTargetRenderState();
 
@@ -137,6 +137,14 @@ private:
     @param programSet The program set container.
     */
     void createGpuPrograms(ProgramSet* programSet);
+
+    /** Create GPU programs for several program sets, see createGpuPrograms.
+    @remarks
+    Writing the source code, the bulk of the work, is spread over the WorkQueue of Root, if there is one.
+    Creating the GpuProgram resources and loading them stays on the calling thread.
+    @param programSets The program set containers, each with its own CPU programs.
+    */
+    void createGpuPrograms(const std::vector<ProgramSet*>& programSets);
         
     /** 
     Generates a unique hash from a string
@@ -149,6 +157,7 @@ private:
     /** Create GPU program based on the give CPU program.
     @param shaderProgram The CPU program instance.
     @param programWriter The program writer instance.
+    @param source The source code programWriter wrote for shaderProgram.
     @param language The target shader language.
     @param profiles The profiles string for program compilation.
     @param profilesList The profiles string for program compilation as string list.
@@ -156,6 +165,7 @@ private:
     */
     auto createGpuProgram(Program* shaderProgram, 
         ProgramWriter* programWriter,
+        String source,
         std::string_view language,
         std::string_view profiles,
         std::string_view cachePath) -> GpuProgramPtr;
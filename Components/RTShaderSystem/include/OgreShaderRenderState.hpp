@@ -32,6 +32,8 @@ export import :ShaderSubRenderState;
 export import Ogre.Core;
 
 export import <memory>;
+export import <utility>;
+export import <vector>;
 
 export
 namespace Ogre {
@@ -113,6 +115,22 @@ public:
     */
     [[nodiscard]] auto getLightCountAutoUpdate() const noexcept -> bool { return mLightCountAutoUpdate; }
 
+    /** 
+    Set whether few general programs are generated instead of many specialised ones.
+    @remarks
+    In this mode the lighting evaluates all lights with the same code, selecting the light type at
+    runtime, and the lights get counted in total, rounded up to a power of two. The fog mode becomes
+    a uniform as well. This bounds the number of programs of a scheme and avoids recompiling it every
+    time lights or fog change, at the cost of branching in the shaders.
+    The default is false.
+    */
+    void setUberShaders(bool enable) { mUberShaders = enable; }
+
+    /** 
+    Return true if this render state generates general programs, see setUberShaders.
+    */
+    [[nodiscard]] auto getUberShaders() const noexcept -> bool { return mUberShaders; }
+
     
 
 
@@ -124,6 +142,8 @@ protected:
     Vector3i mLightCount;
     // True if light count was explicitly set.
     bool mLightCountAutoUpdate;
+    // True if general programs with runtime branching are generated.
+    bool mUberShaders;
 
 private:
     friend class ProgramManager;
@@ -174,6 +194,14 @@ public:
     */
     void acquirePrograms(Pass* pass);
 
+    using PendingProgramList = std::vector<std::pair<TargetRenderState*, Pass*>>;
+    /** Acquire the programs of several render states and bind each to its pass, see acquirePrograms.
+    @remarks
+    The GPU programs of all are created by a single ProgramManager::createGpuPrograms,
+    which writes their source code in parallel.
+    */
+    static void acquirePrograms(const PendingProgramList& renderStates);
+
     /** Release CPU/GPU programs set associated with the given render state and pass.
     @param pass The pass to release the programs from.
     */
@@ -182,6 +210,9 @@ public:
     /// Key name for associating with a Pass instance.
     static const char* UserKey;
 private:
+    /** Bind the created GPU programs and their uniform parameters to the pass. */
+    void bindPrograms(Pass* pass);
+
     /** Bind the uniform parameters of a given CPU and GPU program set. */
     static void bindUniformParameters(Program* pCpuProgram, const GpuProgramParametersSharedPtr& passParams);
 
@@ -0,0 +1,482 @@
+// This file is part of the OGRE project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at https://www.ogre3d.org/licensing.
+// SPDX-License-Identifier: MIT
+module;
+
+#include <cstddef>
+
+module Ogre.Components.RTShaderSystem;
+
+import :ShaderExClusteredLighting;
+import :ShaderFFPRenderState;
+import :ShaderFunction;
+import :ShaderFunctionAtom;
+import :ShaderGenerator;
+import :ShaderParameter;
+import :ShaderPrecompiledHeaders;
+import :ShaderProgram;
+import :ShaderProgramSet;
+import :ShaderScriptTranslator;
+import :ShaderSubRenderState;
+
+import Ogre.Core;
+
+import <algorithm>;
+import <cmath>;
+import <limits>;
+import <span>;
+import <string>;
+import <vector>;
+
+#define SGX_LIB_CLUSTEREDLIGHTING                   "SGXLib_ClusteredLighting"
+#define SGX_FUNC_LIGHT_CLUSTERED                    "SGX_Light_Clustered"
+namespace Ogre::RTShader
+{
+
+/************************************************************************/
+/*                                                                      */
+/************************************************************************/
+std::string_view const constinit LightClusters::LIGHT_TEXTURE_NAME = "RTShaderSystem/ClusteredLights";
+std::string_view const constinit LightClusters::CLUSTER_TEXTURE_NAME = "RTShaderSystem/LightClusters";
+std::string_view const constinit LightClusters::INDEX_TEXTURE_NAME = "RTShaderSystem/LightClusterIndices";
+
+static constexpr uint32 LIGHT_TEXTURE_ROWS = 6;
+static constexpr uint32 CLUSTER_COUNT = LightClusters::GRID_X * LightClusters::GRID_Y * LightClusters::GRID_Z;
+
+//-----------------------------------------------------------------------
+LightClusters::LightClusters()
+    : mLightData(MAX_LIGHTS * LIGHT_TEXTURE_ROWS * 4), mClusterData(CLUSTER_COUNT * 2),
+      mGridParams{Real(GRID_X), Real(GRID_Y), Real(GRID_Z), 0}, mDepthParams{1, 1, Real(1) / MAX_LIGHTS, 0},
+      mProjectionMatrix{Matrix4::IDENTITY}
+{
+}
+
+//-----------------------------------------------------------------------
+LightClusters::~LightClusters()
+{
+    if (!mLightTexture || !TextureManager::getSingletonPtr())
+        return;
+
+    TextureManager::getSingleton().remove(mLightTexture);
+    TextureManager::getSingleton().remove(mClusterTexture);
+    TextureManager::getSingleton().remove(mIndexTexture);
+}
+
+//-----------------------------------------------------------------------
+void LightClusters::createTextures()
+{
+    if (mLightTexture || !TextureManager::getSingletonPtr())
+        return;
+
+    auto& texMgr = TextureManager::getSingleton();
+    mLightTexture = texMgr.createManual(LIGHT_TEXTURE_NAME, RGN_INTERNAL, TextureType::_2D, MAX_LIGHTS,
+                                        LIGHT_TEXTURE_ROWS, TextureMipmap{}, PixelFormat::FLOAT32_RGBA,
+                                        TextureUsage::DYNAMIC_WRITE_ONLY_DISCARDABLE);
+    mClusterTexture = texMgr.createManual(CLUSTER_TEXTURE_NAME, RGN_INTERNAL, TextureType::_2D, GRID_X * GRID_Y,
+                                          GRID_Z, TextureMipmap{}, PixelFormat::FLOAT32_GR,
+                                          TextureUsage::DYNAMIC_WRITE_ONLY_DISCARDABLE);
+    mIndexTexture = texMgr.createManual(INDEX_TEXTURE_NAME, RGN_INTERNAL, TextureType::_2D, INDEX_TEXTURE_WIDTH,
+                                        INDEX_TEXTURE_HEIGHT, TextureMipmap{}, PixelFormat::FLOAT32_R,
+                                        TextureUsage::DYNAMIC_WRITE_ONLY_DISCARDABLE);
+
+    OgreAssert(mLightTexture->getFormat() == PixelFormat::FLOAT32_RGBA, "float texture support required");
+}
+
+//-----------------------------------------------------------------------
+auto LightClusters::bindTextures(Pass* pass) -> uint8
+{
+    createTextures();
+
+    auto first = uint8(pass->getNumTextureUnitStates());
+    for (auto [name, tex] : {std::pair{LIGHT_TEXTURE_NAME, mLightTexture}, std::pair{CLUSTER_TEXTURE_NAME, mClusterTexture},
+                             std::pair{INDEX_TEXTURE_NAME, mIndexTexture}})
+    {
+        TextureUnitState* tus = pass->createTextureUnitState();
+        if (tex)
+            tus->setTexture(tex);
+        else
+            tus->setTextureName(name);
+        tus->setTextureFiltering(TextureFilterOptions::NONE);
+        tus->setTextureAddressingMode(TextureAddressingMode::CLAMP);
+    }
+
+    return first;
+}
+
+//-----------------------------------------------------------------------
+void LightClusters::update(const Camera* cam, const LightList& lights)
+{
+    auto frame = Root::getSingleton().getNextFrameNumber();
+    if (cam == mLastCamera && frame == mLastFrame)
+        return;
+
+    mLastCamera = cam;
+    mLastFrame = frame;
+
+    assign(cam, lights);
+    upload();
+}
+
+//-----------------------------------------------------------------------
+void LightClusters::assign(const Camera* cam, const LightList& lights)
+{
+    const Affine3& view = cam->getViewMatrix();
+    mProjectionMatrix = cam->getProjectionMatrix();
+
+    // directional lights first, they affect all clusters
+    std::vector<const Light*> localLights;
+    mLightCount = 0;
+    auto writeLight = [&](const Light* l)
+    {
+        auto texel = [&](uint32 row, auto x, auto y, auto z, auto w)
+        {
+            float* dst = &mLightData[(row * MAX_LIGHTS + mLightCount) * 4];
+            dst[0] = float(x);
+            dst[1] = float(y);
+            dst[2] = float(z);
+            dst[3] = float(w);
+        };
+
+        Vector4 pos = view * l->getAs4DVector();
+        Vector3 dir = (view.linear() * l->getDerivedDirection()).normalisedCopy();
+        const Vector4f& att = l->getAttenuation();
+        ColourValue diffuse = l->getDiffuseColour() * l->getPowerScale();
+        ColourValue specular = l->getSpecularColour() * l->getPowerScale();
+
+        texel(0, pos.x, pos.y, pos.z, pos.w);
+        texel(1, dir.x, dir.y, dir.z, 0);
+        texel(2, att[0], att[1], att[2], att[3]);
+        // the same values as AutoParamDataSource::getSpotlightParams
+        if (l->getType() == Light::LightTypes::SPOTLIGHT)
+            texel(3, Math::Cos(l->getSpotlightInnerAngle().valueRadians() * 0.5f),
+                  Math::Cos(l->getSpotlightOuterAngle().valueRadians() * 0.5f), l->getSpotlightFalloff(), 1);
+        else
+            texel(3, 1, 0, 0, 0);
+        texel(4, diffuse.r, diffuse.g, diffuse.b, diffuse.a);
+        texel(5, specular.r, specular.g, specular.b, specular.a);
+
+        mLightCount++;
+    };
+
+    for (auto l : lights)
+    {
+        if (mLightCount == MAX_LIGHTS)
+            break;
+        if (l->getType() == Light::LightTypes::DIRECTIONAL)
+            writeLight(l);
+        else
+            localLights.push_back(l);
+    }
+    mDirectionalCount = mLightCount;
+
+    if (localLights.size() > MAX_LIGHTS - mLightCount)
+        localLights.resize(MAX_LIGHTS - mLightCount);
+
+    // depth range of the slices, up to the farthest light for an infinite far clip distance
+    Real nearDist = cam->getNearClipDistance();
+    Real farDist = cam->getFarClipDistance();
+    if (farDist == 0)
+    {
+        farDist = nearDist * 2;
+        for (auto l : localLights)
+            farDist = std::max(farDist, -(view * l->getDerivedPosition()).z + l->getAttenuationRange());
+    }
+    Real sliceScale = GRID_Z / std::log(farDist / nearDist);
+
+    auto slice = [&](Real depth)
+    {
+        auto s = std::floor(std::log(std::max(depth, nearDist) / nearDist) * sliceScale);
+        return uint32(std::clamp<Real>(s, 0, GRID_Z - 1));
+    };
+    auto tile = [](Real ndc, uint32 count)
+    {
+        auto t = std::floor((ndc * 0.5f + 0.5f) * count);
+        return uint32(std::clamp<Real>(t, 0, count - 1));
+    };
+
+    // the cluster range of every local light, or an empty one
+    struct ClusterRange
+    {
+        uint32 x0, x1, y0, y1, z0, z1;
+    };
+    std::vector<ClusterRange> ranges;
+    ranges.reserve(localLights.size());
+    for (auto l : localLights)
+    {
+        Vector3 centre = view * l->getDerivedPosition();
+        Real radius = l->getAttenuationRange();
+        Real minDepth = -centre.z - radius;
+        Real maxDepth = -centre.z + radius;
+
+        ClusterRange range{1, 0, 1, 0, 1, 0};
+        if (maxDepth >= nearDist && minDepth <= farDist)
+        {
+            // project the corners of the bounding box, clipped to the near plane
+            constexpr Real inf = std::numeric_limits<Real>::max();
+            Vector2 ndcMin{inf, inf};
+            Vector2 ndcMax{-inf, -inf};
+            for (Real z : {-std::max(minDepth, nearDist), -maxDepth})
+                for (Real y : {centre.y - radius, centre.y + radius})
+                    for (Real x : {centre.x - radius, centre.x + radius})
+                    {
+                        Vector3 ndc = mProjectionMatrix * Vector3{x, y, z};
+                        ndcMin.makeFloor(Vector2{ndc.x, ndc.y});
+                        ndcMax.makeCeil(Vector2{ndc.x, ndc.y});
+                    }
+
+            if (ndcMax.x >= -1 && ndcMin.x <= 1 && ndcMax.y >= -1 && ndcMin.y <= 1)
+            {
+                range = {tile(ndcMin.x, GRID_X), tile(ndcMax.x, GRID_X), tile(ndcMin.y, GRID_Y),
+                         tile(ndcMax.y, GRID_Y), slice(minDepth), slice(maxDepth)};
+            }
+        }
+        ranges.push_back(range);
+    }
+
+    // count the lights per cluster, then place them in the index list
+    std::vector<uint32> counts(CLUSTER_COUNT, 0);
+    auto forEachCluster = [](const ClusterRange& r, auto&& func)
+    {
+        for (uint32 z = r.z0; z <= r.z1; z++)
+            for (uint32 y = r.y0; y <= r.y1; y++)
+                for (uint32 x = r.x0; x <= r.x1; x++)
+                    func(x + (y + z * GRID_Y) * GRID_X);
+    };
+    for (const auto& r : ranges)
+        forEachCluster(r, [&](uint32 c) { counts[c]++; });
+
+    uint32 offset = 0;
+    constexpr uint32 capacity = INDEX_TEXTURE_WIDTH * INDEX_TEXTURE_HEIGHT;
+    for (uint32 c = 0; c < CLUSTER_COUNT; c++)
+    {
+        counts[c] = std::min(counts[c], capacity - offset);
+        mClusterData[c * 2] = float(offset);
+        mClusterData[c * 2 + 1] = 0;
+        offset += counts[c];
+    }
+
+    mIndices.assign(offset, 0.0f);
+    for (size_t i = 0; i < ranges.size(); i++)
+    {
+        forEachCluster(ranges[i], [&](uint32 c) {
+            auto& count = mClusterData[c * 2 + 1];
+            if (uint32(count) < counts[c])
+                mIndices[size_t(mClusterData[c * 2] + count++)] = float(mDirectionalCount + i);
+        });
+    }
+
+    mGridParams.w = Real(mDirectionalCount);
+    mDepthParams.x = nearDist;
+    mDepthParams.y = sliceScale;
+}
+
+//-----------------------------------------------------------------------
+void LightClusters::upload()
+{
+    if (!mLightTexture)
+        return;
+
+    mLightTexture->getBuffer()->blitFromMemory(
+        PixelBox(MAX_LIGHTS, LIGHT_TEXTURE_ROWS, 1, PixelFormat::FLOAT32_RGBA, mLightData.data()));
+    mClusterTexture->getBuffer()->blitFromMemory(
+        PixelBox(GRID_X * GRID_Y, GRID_Z, 1, PixelFormat::FLOAT32_GR, mClusterData.data()));
+
+    if (mIndices.empty())
+        return;
+
+    // only the rows in use
+    auto rows = uint32((mIndices.size() + INDEX_TEXTURE_WIDTH - 1) / INDEX_TEXTURE_WIDTH);
+    mIndices.resize(rows * INDEX_TEXTURE_WIDTH);
+    mIndexTexture->getBuffer()->blitFromMemory(
+        PixelBox(INDEX_TEXTURE_WIDTH, rows, 1, PixelFormat::FLOAT32_R, mIndices.data()),
+        Box{0, 0, INDEX_TEXTURE_WIDTH, rows});
+}
+
+//-----------------------------------------------------------------------
+auto LightClusters::getClusterLights(uint32 x, uint32 y, uint32 z) const -> std::span<const float>
+{
+    uint32 c = x + (y + z * GRID_Y) * GRID_X;
+    return {mIndices.data() + size_t(mClusterData[c * 2]), size_t(mClusterData[c * 2 + 1])};
+}
+
+//-----------------------------------------------------------------------
+auto LightClusters::getTexelParams() const -> Vector4
+{
+    return {Real(INDEX_TEXTURE_WIDTH), Real(1) / INDEX_TEXTURE_WIDTH, Real(1) / INDEX_TEXTURE_HEIGHT, 0};
+}
+
+/************************************************************************/
+/*                                                                      */
+/************************************************************************/
+std::string_view const constinit ClusteredLighting::Type = "SGX_ClusteredLighting";
+
+//-----------------------------------------------------------------------
+auto ClusteredLighting::getType() const noexcept -> std::string_view { return Type; }
+
+//-----------------------------------------------------------------------
+auto ClusteredLighting::createCpuSubPrograms(ProgramSet* programSet) -> bool
+{
+    Program* vsProgram = programSet->getCpuProgram(GpuProgramType::VERTEX_PROGRAM);
+    Function* vsMain = vsProgram->getEntryPointFunction();
+    Program* psProgram = programSet->getCpuProgram(GpuProgramType::FRAGMENT_PROGRAM);
+    Function* psMain = psProgram->getEntryPointFunction();
+
+    vsProgram->addDependency(FFP_LIB_TRANSFORM);
+
+    psProgram->addDependency(SGX_LIB_PERPIXELLIGHTING);
+    psProgram->addDependency(SGX_LIB_CLUSTEREDLIGHTING);
+
+    // resolve view position
+    auto vsInPosition = vsMain->getLocalParameter(Parameter::Content::POSITION_OBJECT_SPACE);
+    if (!vsInPosition)
+        vsInPosition = vsMain->resolveInputParameter(Parameter::Content::POSITION_OBJECT_SPACE);
+    auto vsOutViewPos = vsMain->resolveOutputParameter(Parameter::Content::POSITION_VIEW_SPACE);
+    auto viewPos = psMain->resolveInputParameter(vsOutViewPos);
+    auto worldViewMatrix = vsProgram->resolveParameter(GpuProgramParameters::AutoConstantType::WORLDVIEW_MATRIX);
+
+    // Resolve normal.
+    auto viewNormal = psMain->getLocalParameter(Parameter::Content::NORMAL_VIEW_SPACE);
+    ParameterPtr vsInNormal, vsOutNormal;
+
+    if (!viewNormal)
+    {
+        // Resolve input vertex shader normal.
+        vsInNormal = vsMain->resolveInputParameter(Parameter::Content::NORMAL_OBJECT_SPACE);
+
+        // Resolve output vertex shader normal.
+        vsOutNormal = vsMain->resolveOutputParameter(Parameter::Content::NORMAL_VIEW_SPACE);
+
+        // Resolve input pixel shader normal.
+        viewNormal = psMain->resolveInputParameter(vsOutNormal);
+    }
+
+    auto inDiffuse = psMain->getInputParameter(Parameter::Content::COLOR_DIFFUSE);
+    if (!inDiffuse)
+        inDiffuse = psMain->getLocalParameter(Parameter::Content::COLOR_DIFFUSE);
+    OgreAssert(inDiffuse, "inDiffuse is NULL");
+
+    auto outDiffuse = psMain->resolveOutputParameter(Parameter::Content::COLOR_DIFFUSE);
+    auto outSpecular = psMain->resolveLocalParameter(Parameter::Content::COLOR_SPECULAR);
+
+    // surface and cluster parameters
+    auto sceneColour = psProgram->resolveParameter(GpuProgramParameters::AutoConstantType::DERIVED_SCENE_COLOUR);
+    auto surfaceDiffuse = psProgram->resolveParameter(GpuProgramParameters::AutoConstantType::SURFACE_DIFFUSE_COLOUR);
+    auto shininess = psProgram->resolveParameter(GpuProgramParameters::AutoConstantType::SURFACE_SHININESS);
+    In surfaceSpecular(Vector3{});
+    if (mSpecularEnable)
+        surfaceSpecular = In(psProgram->resolveParameter(GpuProgramParameters::AutoConstantType::SURFACE_SPECULAR_COLOUR)).xyz();
+
+    mProjectionMatrix = psProgram->resolveParameter(GpuConstantType::MATRIX_4X4, "gClusterProjMatrix");
+    mGridParams = psProgram->resolveParameter(GpuConstantType::FLOAT4, "gClusterGrid");
+    mDepthParams = psProgram->resolveParameter(GpuConstantType::FLOAT4, "gClusterDepth");
+    mTexelParams = psProgram->resolveParameter(GpuConstantType::FLOAT4, "gClusterTexels");
+
+    auto lightData = psProgram->resolveParameter(GpuConstantType::SAMPLER2D, "gClusterLightData", mLightDataSamplerIndex);
+    auto clusterData = psProgram->resolveParameter(GpuConstantType::SAMPLER2D, "gClusterData", mLightDataSamplerIndex + 1);
+    auto lightIndices =
+        psProgram->resolveParameter(GpuConstantType::SAMPLER2D, "gClusterLightIndices", mLightDataSamplerIndex + 2);
+
+    auto vstage = vsMain->getStage(std::to_underlying(FFPVertexShaderStage::LIGHTING));
+    auto fstage = psMain->getStage(std::to_underlying(FFPFragmentShaderStage::COLOUR_BEGIN) + 1);
+
+    vstage.callFunction(FFP_FUNC_TRANSFORM, worldViewMatrix, vsInPosition, vsOutViewPos);
+
+    // transform normal in VS
+    if (vsOutNormal)
+    {
+        auto worldViewITMatrix = vsProgram->resolveParameter(GpuProgramParameters::AutoConstantType::NORMAL_MATRIX);
+        vstage.callFunction(FFP_FUNC_TRANSFORM, worldViewITMatrix, vsInNormal, vsOutNormal);
+    }
+
+    fstage.assign(sceneColour, outDiffuse);
+    fstage.callFunction(SGX_FUNC_LIGHT_CLUSTERED,
+                        {In(viewNormal), In(viewPos), In(mProjectionMatrix), In(mGridParams), In(mDepthParams),
+                         In(mTexelParams), In(lightData), In(clusterData), In(lightIndices),
+                         In(surfaceDiffuse).xyz(), surfaceSpecular, In(shininess), InOut(outDiffuse).xyz(),
+                         InOut(outSpecular).xyz()});
+
+    // Assign back temporary variables
+    fstage.assign(outDiffuse, inDiffuse);
+
+    return true;
+}
+
+//-----------------------------------------------------------------------
+void ClusteredLighting::updateGpuProgramsParams(Renderable* rend, const Pass* pass, const AutoParamDataSource* source,
+                                                const LightList* pLightList)
+{
+    const Camera* cam = source->getCurrentCamera();
+    if (!cam || !mClusters)
+        return;
+
+    mClusters->update(cam, cam->getSceneManager()->_getLightsAffectingFrustum());
+
+    mProjectionMatrix->setGpuParameter(mClusters->getProjectionMatrix());
+    mGridParams->setGpuParameter(mClusters->getGridParams());
+    mDepthParams->setGpuParameter(mClusters->getDepthParams());
+    mTexelParams->setGpuParameter(mClusters->getTexelParams());
+}
+
+//-----------------------------------------------------------------------
+void ClusteredLighting::copyFrom(const SubRenderState& rhs)
+{
+    const auto& rhsLighting = static_cast<const ClusteredLighting&>(rhs);
+    mClusters = rhsLighting.mClusters;
+}
+
+//-----------------------------------------------------------------------
+auto ClusteredLighting::preAddToRenderState(const RenderState* renderState, Pass* srcPass, Pass* dstPass) noexcept -> bool
+{
+    if (!srcPass->getLightingEnabled() || !mClusters)
+        return false;
+
+    mSpecularEnable = srcPass->getShininess() > 0.0 && srcPass->getSpecular() != ColourValue::Black;
+
+    // all lights are handled in one go
+    dstPass->setIteratePerLight(false);
+    mLightDataSamplerIndex = mClusters->bindTextures(dstPass);
+
+    return true;
+}
+
+//-----------------------------------------------------------------------
+auto ClusteredLightingFactory::getType() const noexcept -> std::string_view { return ClusteredLighting::Type; }
+
+//-----------------------------------------------------------------------
+auto ClusteredLightingFactory::createInstance(ScriptCompiler* compiler, PropertyAbstractNode* prop, Pass* pass,
+                                              SGScriptTranslator* translator) noexcept -> SubRenderState*
+{
+    if (prop->name != "lighting_stage" || prop->values.empty())
+        return nullptr;
+
+    String val;
+    if (!SGScriptTranslator::getString(prop->values.front(), &val))
+    {
+        compiler->addError(ScriptCompiler::CE_INVALIDPARAMETERS, prop->file, prop->line);
+        return nullptr;
+    }
+
+    if (val != "clustered")
+        return nullptr;
+
+    return createOrRetrieveInstance(translator);
+}
+
+//-----------------------------------------------------------------------
+void ClusteredLightingFactory::writeInstance(MaterialSerializer* ser, SubRenderState* subRenderState, Pass* srcPass,
+                                             Pass* dstPass)
+{
+    ser->writeAttribute(4, "lighting_stage");
+    ser->writeValue("clustered");
+}
+
+//-----------------------------------------------------------------------
+auto ClusteredLightingFactory::createInstanceImpl() -> SubRenderState*
+{
+    auto ret = new ClusteredLighting;
+    ret->mClusters = &mClusters;
+    return ret;
+}
+
+} // namespace Ogre
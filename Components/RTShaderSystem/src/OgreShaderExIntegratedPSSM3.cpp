@@ -66,6 +66,7 @@ std::string_view const constinit IntegratedPSSM3::Type = "SGX_IntegratedPSSM3";
 IntegratedPSSM3::IntegratedPSSM3()
 {
     mPCFxSamples = 2;
+    mFilter = Filter::PCF;
     mUseTextureCompare = false;
     mUseColourShadows = false;
     mDebug = false;
@@ -118,6 +119,7 @@ void IntegratedPSSM3::copyFrom(const SubRenderState& rhs)
     const auto& rhsPssm= static_cast<const IntegratedPSSM3&>(rhs);
 
     mPCFxSamples = rhsPssm.mPCFxSamples;
+    mFilter = rhsPssm.mFilter;
     mUseTextureCompare = rhsPssm.mUseTextureCompare;
     mUseColourShadows = rhsPssm.mUseColourShadows;
     mDebug = rhsPssm.mDebug;
@@ -146,16 +148,26 @@ auto IntegratedPSSM3::preAddToRenderState(const RenderState* renderState,
     const auto& configs = ShaderGenerator::getSingleton().getActiveSceneManager()->getShadowTextureConfigList();
     if (!configs.empty())
         shadowTexFormat = configs[0].format; // assume first texture is representative
-    mUseTextureCompare = PixelUtil::isDepth(shadowTexFormat) && !mIsD3D9;
-    mUseColourShadows = PixelUtil::getComponentType(shadowTexFormat) == PixelComponentType::BYTE; // use colour shadowmaps for byte textures
+    // exponential shadow maps hold warped depths, whatever the format
+    bool exponential = mFilter != Filter::PCF;
+    mUseTextureCompare = PixelUtil::isDepth(shadowTexFormat) && !mIsD3D9 && !exponential;
+    mUseColourShadows = PixelUtil::getComponentType(shadowTexFormat) == PixelComponentType::BYTE && !exponential; // use colour shadowmaps for byte textures
 
     for(auto& it : mShadowTextureParamsList)
     {
         TextureUnitState* curShadowTexture = dstPass->createTextureUnitState();
             
         curShadowTexture->setContentType(TextureUnitState::ContentType::SHADOW);
-        curShadowTexture->setTextureAddressingMode(TextureAddressingMode::BORDER);
-        curShadowTexture->setTextureBorderColour(ColourValue::White);
+        if (exponential)
+        {
+            // the border colour is clamped on some targets, the program tests the range instead
+            curShadowTexture->setTextureAddressingMode(TextureAddressingMode::CLAMP);
+        }
+        else
+        {
+            curShadowTexture->setTextureAddressingMode(TextureAddressingMode::BORDER);
+            curShadowTexture->setTextureBorderColour(ColourValue::White);
+        }
         if(mUseTextureCompare)
         {
             curShadowTexture->setTextureCompareEnabled(true);
@@ -190,12 +202,18 @@ auto IntegratedPSSM3::setParameter(std::string_view name, std::string_view value
     }
     else if (name == "filter")
     {
+        mFilter = Filter::PCF;
         if(value == "pcf4")
             mPCFxSamples = 2;
         else if(value == "pcf16")
             mPCFxSamples = 4;
+        else if(value == "esm")
+            mFilter = Filter::ESM;
+        else if(value == "evsm")
+            mFilter = Filter::EVSM;
         else
             return false;
+        return true;
     }
 
     return false;
@@ -292,6 +310,11 @@ auto IntegratedPSSM3::resolveDependencies(ProgramSet* programSet) -> bool
     if(mUseColourShadows)
         psProgram->addPreprocessorDefines("PSSM_SAMPLE_COLOUR");
 
+    if(mFilter == Filter::ESM)
+        psProgram->addPreprocessorDefines("PSSM_ESM");
+    else if(mFilter == Filter::EVSM)
+        psProgram->addPreprocessorDefines("PSSM_EVSM");
+
     return true;
 }
 
@@ -342,7 +365,7 @@ auto IntegratedPSSM3::addPSInvocation(Program* psProgram, const int groupOrder)
     if(mShadowTextureParamsList.size() < 2)
     {
         ShadowTextureParams& splitParams0 = mShadowTextureParamsList[0];
-        stage.callFunction("SGX_ShadowPCF4",
+        stage.callFunction(mFilter == Filter::PCF ? "SGX_ShadowPCF4" : "SGX_ShadowExp",
                            {In(splitParams0.mTextureSampler), In(splitParams0.mPSInLightPosition),
                             In(splitParams0.mInvTextureSize).xy(), Out(mPSLocalShadowFactor)});
     }
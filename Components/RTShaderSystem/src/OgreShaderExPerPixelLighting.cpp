@@ -173,7 +173,8 @@ auto PerPixelLighting::resolvePerLightParameters(ProgramSet* programSet) -> bool
     // Resolve per light parameters.
     for (unsigned int i=0; i < mLightParamsList.size(); ++i)
     {       
-        switch (mLightParamsList[i].mType)
+        // General programs need the parameters of all light types.
+        switch (mGenericLights ? Light::LightTypes::SPOTLIGHT : mLightParamsList[i].mType)
         {
             using enum Light::LightTypes;
         case DIRECTIONAL:
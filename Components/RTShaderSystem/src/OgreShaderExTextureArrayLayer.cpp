@@ -0,0 +1,122 @@
+// This file is part of the OGRE project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at https://www.ogre3d.org/licensing.
+// SPDX-License-Identifier: MIT
+module;
+
+#include <cstddef>
+
+module Ogre.Components.RTShaderSystem;
+
+import :ShaderExTextureArrayLayer;
+import :ShaderFFPRenderState;
+import :ShaderFunction;
+import :ShaderFunctionAtom;
+import :ShaderGenerator;
+import :ShaderParameter;
+import :ShaderProgram;
+import :ShaderProgramSet;
+import :ShaderScriptTranslator;
+
+import Ogre.Core;
+
+import <algorithm>;
+import <format>;
+import <utility>;
+import <vector>;
+
+namespace Ogre::RTShader
+{
+
+/************************************************************************/
+/*                                                                      */
+/************************************************************************/
+std::string_view const constinit TextureArrayLayer::Type = "TextureArrayLayer";
+
+//-----------------------------------------------------------------------
+auto TextureArrayLayer::getType() const noexcept -> std::string_view { return Type; }
+
+//-----------------------------------------------------------------------
+void TextureArrayLayer::copyFrom(const SubRenderState& rhs)
+{
+    const auto& rhsLayer = static_cast<const TextureArrayLayer&>(rhs);
+    mLayerParameter = rhsLayer.mLayerParameter;
+    mTexCoordSets = rhsLayer.mTexCoordSets;
+}
+
+//-----------------------------------------------------------------------
+auto TextureArrayLayer::preAddToRenderState(const RenderState* renderState, Pass* srcPass, Pass* dstPass) noexcept
+    -> bool
+{
+    mTexCoordSets.clear();
+    for (const TextureUnitState* tus : srcPass->getTextureUnitStates())
+    {
+        if (tus->getTextureType() != TextureType::_2D_ARRAY ||
+            tus->getContentType() != TextureUnitState::ContentType::NAMED)
+            continue;
+
+        if (std::ranges::find(mTexCoordSets, tus->getTextureCoordSet()) == mTexCoordSets.end())
+            mTexCoordSets.push_back(tus->getTextureCoordSet());
+    }
+    return !mTexCoordSets.empty();
+}
+
+//-----------------------------------------------------------------------
+auto TextureArrayLayer::createCpuSubPrograms(ProgramSet* programSet) -> bool
+{
+    Program* vsProgram = programSet->getCpuProgram(GpuProgramType::VERTEX_PROGRAM);
+    Function* vsMain = vsProgram->getEntryPointFunction();
+
+    auto layer = vsProgram->resolveParameter(GpuProgramParameters::AutoConstantType::CUSTOM,
+                                             static_cast<uint32>(mLayerParameter));
+
+    // after FFPTexturing passed the coordinates through
+    auto stage = vsMain->getStage(std::to_underlying(FFPVertexShaderStage::TEXTURING) + 1);
+    for (unsigned int set : mTexCoordSets)
+    {
+        auto content = Parameter::Content(std::to_underlying(Parameter::Content::TEXTURE_COORDINATE0) + set);
+        // units with a texture matrix compute their coordinates through it, keeping the mesh layer
+        auto texCoord = vsMain->getOutputParameter(content, GpuConstantType::FLOAT3);
+        if (!texCoord)
+            continue;
+
+        stage.assign(In(layer).x(), Out(texCoord).z());
+    }
+
+    return true;
+}
+
+//-----------------------------------------------------------------------
+auto TextureArrayLayerFactory::getType() const noexcept -> std::string_view { return TextureArrayLayer::Type; }
+
+//-----------------------------------------------------------------------
+auto TextureArrayLayerFactory::createInstance(ScriptCompiler* compiler, PropertyAbstractNode* prop, Pass* pass,
+                                              SGScriptTranslator* translator) noexcept -> SubRenderState*
+{
+    if (prop->name != "texture_array_layer" || prop->values.empty())
+        return nullptr;
+
+    uint32 index;
+    if (!SGScriptTranslator::getUInt(prop->values.front(), &index))
+    {
+        compiler->addError(ScriptCompiler::CE_INVALIDPARAMETERS, prop->file, prop->line);
+        return nullptr;
+    }
+
+    auto ret = static_cast<TextureArrayLayer*>(createOrRetrieveInstance(translator));
+    ret->setLayerParameter(index);
+    return ret;
+}
+
+//-----------------------------------------------------------------------
+void TextureArrayLayerFactory::writeInstance(MaterialSerializer* ser, SubRenderState* subRenderState, Pass* srcPass,
+                                             Pass* dstPass)
+{
+    ser->writeAttribute(4, "texture_array_layer");
+    ser->writeValue(std::format("{}", static_cast<TextureArrayLayer*>(subRenderState)->getLayerParameter()));
+}
+
+//-----------------------------------------------------------------------
+auto TextureArrayLayerFactory::createInstanceImpl() -> SubRenderState* { return new TextureArrayLayer; }
+
+} // namespace Ogre
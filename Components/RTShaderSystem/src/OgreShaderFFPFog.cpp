@@ -40,6 +40,7 @@ import :ShaderPrecompiledHeaders;
 import :ShaderPrerequisites;
 import :ShaderProgram;
 import :ShaderProgramSet;
+import :ShaderRenderState;
 import :ShaderScriptTranslator;
 
 import Ogre.Core;
@@ -59,6 +60,7 @@ FFPFog::FFPFog()
 {
     mFogMode                = FogMode::NONE;
     mCalcMode               = CalcMode::PER_VERTEX;
+    mGenericFog             = false;
 }
 
 //-----------------------------------------------------------------------
@@ -76,7 +78,7 @@ auto FFPFog::getExecutionOrder() const noexcept -> FFPShaderStage
 //-----------------------------------------------------------------------
 auto FFPFog::resolveParameters(ProgramSet* programSet) -> bool
 {
-    if (mFogMode == FogMode::NONE)
+    if (mFogMode == FogMode::NONE && !mGenericFog)
         return true;
 
     Program* vsProgram = programSet->getCpuProgram(GpuProgramType::VERTEX_PROGRAM);
@@ -104,6 +106,9 @@ auto FFPFog::resolveParameters(ProgramSet* programSet) -> bool
         
         // Resolve pixel shader input depth.
         mPSInDepth = psMain->resolveInputParameter(mVSOutDepth);
+
+        if (mGenericFog)
+            mFogModeParam = psProgram->resolveParameter(GpuConstantType::FLOAT1, "gFogMode");
     }
     // Per vertex fog.
     else
@@ -116,6 +121,9 @@ auto FFPFog::resolveParameters(ProgramSet* programSet) -> bool
 
         // Resolve pixel shader input fog factor.
         mPSInFogFactor = psMain->resolveInputParameter(mVSOutFogFactor);
+
+        if (mGenericFog)
+            mFogModeParam = vsProgram->resolveParameter(GpuConstantType::FLOAT1, "gFogMode");
     }
 
     return true;
@@ -124,7 +132,7 @@ auto FFPFog::resolveParameters(ProgramSet* programSet) -> bool
 //-----------------------------------------------------------------------
 auto FFPFog::resolveDependencies(ProgramSet* programSet) -> bool
 {
-    if (mFogMode == FogMode::NONE)
+    if (mFogMode == FogMode::NONE && !mGenericFog)
         return true;
 
     Program* vsProgram = programSet->getCpuProgram(GpuProgramType::VERTEX_PROGRAM);
@@ -158,6 +166,14 @@ auto FFPFog::addFunctionInvocations(ProgramSet* programSet) -> bool
     {
         vsMain->getStage(std::to_underlying(FFPVertexShaderStage::FOG)).assign(In(mVSOutPos).w(), mVSOutDepth);
 
+        if (mGenericFog)
+        {
+            psMain->getStage(std::to_underlying(FFPFragmentShaderStage::FOG))
+                .callFunction(FFP_FUNC_PIXELFOG_GENERIC, {In(mPSInDepth), In(mFogParams), In(mFogModeParam),
+                                                          In(mFogColour), In(mPSOutDiffuse), Out(mPSOutDiffuse)});
+            return true;
+        }
+
         switch (mFogMode)
         {
             using enum FogMode;
@@ -182,7 +198,7 @@ auto FFPFog::addFunctionInvocations(ProgramSet* programSet) -> bool
     else
     {
         using enum FogMode;
-        switch (mFogMode)
+        switch (mGenericFog ? LINEAR : mFogMode)
         {
         case LINEAR:
             fogfunc = FFP_FUNC_VERTEXFOG_LINEAR;
@@ -199,7 +215,10 @@ auto FFPFog::addFunctionInvocations(ProgramSet* programSet) -> bool
 
         //! [func_invoc]
         auto vsFogStage = vsMain->getStage(std::to_underlying(FFPVertexShaderStage::FOG));
-        vsFogStage.callFunction(fogfunc, mVSOutPos, mFogParams, mVSOutFogFactor);
+        if (mGenericFog)
+            vsFogStage.callFunction(FFP_FUNC_VERTEXFOG_GENERIC, {In(mVSOutPos), In(mFogParams), In(mFogModeParam), Out(mVSOutFogFactor)});
+        else
+            vsFogStage.callFunction(fogfunc, mVSOutPos, mFogParams, mVSOutFogFactor);
         //! [func_invoc]
         psMain->getStage(std::to_underlying(FFPVertexShaderStage::FOG))
             .callFunction(FFP_FUNC_LERP, {In(mFogColour), In(mPSOutDiffuse), In(mPSInFogFactor), Out(mPSOutDiffuse)});
@@ -216,6 +235,7 @@ void FFPFog::copyFrom(const SubRenderState& rhs)
     const auto& rhsFog = static_cast<const FFPFog&>(rhs);
 
     mFogMode            = rhsFog.mFogMode;
+    mGenericFog         = rhsFog.mGenericFog;
 
     setCalcMode(rhsFog.mCalcMode);
 }
@@ -232,7 +252,27 @@ auto FFPFog::preAddToRenderState(const RenderState* renderState, Pass* srcPass,
         mFogMode         = sceneMgr->getFogMode();
     }
 
-    return mFogMode != FogMode::NONE;
+    // General programs are the same with and without fog.
+    mGenericFog = renderState->getUberShaders();
+
+    return mFogMode != FogMode::NONE || mGenericFog;
+}
+
+//-----------------------------------------------------------------------
+void FFPFog::updateGpuProgramsParams(Renderable* rend, const Pass* pass, const AutoParamDataSource* source,
+                                     const LightList* pLightList)
+{
+    if (!mFogModeParam)
+        return;
+
+    // The same choice the SceneManager makes for the fog parameters
+    FogMode fogMode = FogMode::NONE;
+    if (pass->getFogOverride())
+        fogMode = pass->getFogMode();
+    else if (SceneManager* sceneMgr = ShaderGenerator::getSingleton().getActiveSceneManager())
+        fogMode = sceneMgr->getFogMode();
+
+    mFogModeParam->setGpuParameter(float(std::to_underlying(fogMode)));
 }
 
 //-----------------------------------------------------------------------
@@ -81,6 +81,11 @@ public:
     */
     auto preAddToRenderState(const RenderState* renderState, Pass* srcPass, Pass* dstPass) noexcept -> bool override;
 
+    /** 
+    @see SubRenderState::updateGpuProgramsParams.
+    */
+    void updateGpuProgramsParams(Renderable* rend, const Pass* pass, const AutoParamDataSource* source, const LightList* pLightList) override;
+
     /** 
     Set the fog calculation mode. Either per vertex or per pixel.
     @param calcMode The calculation mode to set.
@@ -120,11 +125,15 @@ protected:
     CalcMode mCalcMode;
     // Fog formula. 
     FogMode mFogMode;
+    // The fog formula is a uniform, see RenderState::setUberShaders.
+    bool mGenericFog;
 
     // Fog colour parameter.    
     UniformParameterPtr mFogColour;
     // Fog parameters program parameter.    
     UniformParameterPtr mFogParams;
+    // Fog formula program parameter.
+    UniformParameterPtr mFogModeParam;
     // Vertex shader output position parameter.
     ParameterPtr mVSOutPos;
     // Vertex shader output fog colour parameter.
@@ -63,6 +63,7 @@ FFPLighting::FFPLighting()
 	mSpecularEnable					= false;
 	mNormalisedEnable               = false;
 	mTwoSidedLighting               = false;
+	mGenericLights                  = false;
 }
 
 //-----------------------------------------------------------------------
@@ -82,7 +83,8 @@ auto FFPLighting::getExecutionOrder() const noexcept -> FFPShaderStage
 void FFPLighting::updateGpuProgramsParams(Renderable* rend, const Pass* pass, const AutoParamDataSource* source,
 										  const LightList* pLightList)
 {		
-	if (mLightParamsList.empty())
+	// General programs take the lights in the order of the list, which is their default index.
+	if (mLightParamsList.empty() || mGenericLights)
 		return;
 
 	Light::LightTypes curLightType = Light::LightTypes::DIRECTIONAL; 
@@ -194,7 +196,8 @@ auto FFPLighting::resolveParameters(ProgramSet* programSet) -> bool
 	for (unsigned int i=0; i < mLightParamsList.size(); ++i)
 	{		
 		using enum Light::LightTypes;
-		switch (mLightParamsList[i].mType)
+		// General programs need the parameters of all light types.
+		switch (mGenericLights ? SPOTLIGHT : mLightParamsList[i].mType)
 		{
 		case DIRECTIONAL:
 			mLightParamsList[i].mDirection = vsProgram->resolveParameter(GpuProgramParameters::AutoConstantType::LIGHT_DIRECTION_VIEW_SPACE, i);
@@ -351,6 +354,28 @@ void FFPLighting::addIlluminationInvocation(const LightParams* curLightParams, c
                   Out(curLightParams->mSpecularColour).xyz());
     }
 
+    if (mGenericLights)
+    {
+        if (mSpecularEnable)
+        {
+            stage.callFunction(SGX_FUNC_LIGHT_GENERIC_DIFFUSESPECULAR,
+                               {In(mViewNormal), In(mViewPos), In(curLightParams->mPosition),
+                                In(curLightParams->mPSInDirection).xyz(), In(curLightParams->mAttenuatParams),
+                                In(curLightParams->mSpotParams), In(curLightParams->mDiffuseColour).xyz(),
+                                In(curLightParams->mSpecularColour).xyz(), In(mSurfaceShininess),
+                                InOut(mOutDiffuse).xyz(), InOut(mOutSpecular).xyz()});
+        }
+        else
+        {
+            stage.callFunction(SGX_FUNC_LIGHT_GENERIC_DIFFUSE,
+                               {In(mViewNormal), In(mViewPos), In(curLightParams->mPosition),
+                                In(curLightParams->mPSInDirection).xyz(), In(curLightParams->mAttenuatParams),
+                                In(curLightParams->mSpotParams), In(curLightParams->mDiffuseColour).xyz(),
+                                InOut(mOutDiffuse).xyz()});
+        }
+        return;
+    }
+
     using enum Light::LightTypes;
     switch (curLightParams->mType)
     {
@@ -418,6 +443,7 @@ void FFPLighting::copyFrom(const SubRenderState& rhs)
 {
 	const auto& rhsLighting = static_cast<const FFPLighting&>(rhs);
 
+	mGenericLights = rhsLighting.mGenericLights;
 	setLightCount(rhsLighting.getLightCount());
 	mNormalisedEnable = rhsLighting.mNormalisedEnable;
 	mTwoSidedLighting = rhsLighting.mTwoSidedLighting;
@@ -432,6 +458,7 @@ auto FFPLighting::preAddToRenderState(const RenderState* renderState, Pass* srcP
 	//! [disable]
 
 	auto lightCount = renderState->getLightCount();
+	mGenericLights = renderState->getUberShaders();
 	
 	setTrackVertexColourType(srcPass->getVertexColourTracking());			
 
@@ -448,9 +475,14 @@ auto FFPLighting::preAddToRenderState(const RenderState* renderState, Pass* srcP
 	// Case this pass should run once per light(s) -> override the light policy.
 	if (srcPass->getIteratePerLight())
 	{		
+		// General programs handle any light type.
+		if (mGenericLights)
+		{
+			lightCount = Vector3i{int(srcPass->getLightCountPerIteration()), 0, 0};
+		}
 
 		// This is the preferred case -> only one type of light is handled.
-		if (srcPass->getRunOnlyForOneLightType())
+		else if (srcPass->getRunOnlyForOneLightType())
 		{
 			if (srcPass->getOnlyLightType() == Light::LightTypes::POINT)
 			{
@@ -500,6 +532,14 @@ auto FFPLighting::setParameter(std::string_view name, std::string_view value) no
 //-----------------------------------------------------------------------
 void FFPLighting::setLightCount(const Vector3i& lightCount)
 {
+	// General programs count all lights as point lights, see getLightCount.
+	if (mGenericLights)
+	{
+		mLightParamsList.resize(mLightParamsList.size() + lightCount[0] + lightCount[1] + lightCount[2],
+								LightParams{Light::LightTypes::POINT});
+		return;
+	}
+
 	for (int type=0; type < 3; ++type)
 	{
 		for (int i=0; i < lightCount[type]; ++i)
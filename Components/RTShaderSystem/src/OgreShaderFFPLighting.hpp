@@ -199,6 +199,8 @@ protected:
     bool mSpecularEnable;
     bool mNormalisedEnable;
     bool mTwoSidedLighting;
+    // Lights of any type share the same code, see RenderState::setUberShaders.
+    bool mGenericLights;
     // Light list.
     LightParamsList mLightParamsList;
     // World view matrix parameter.
@@ -102,7 +102,34 @@ auto FFPTransform::createCpuSubPrograms(ProgramSet* programSet) -> bool
         mInstanced = false;
 
     auto stage = vsEntry->getStage(std::to_underlying(FFPVertexShaderStage::TRANSFORM));
-    if(mInstanced)
+    if(mBillboards)
+    {
+        // shared quad corner in texcoord 0, the rest is per instance
+        auto axisX = vsProgram->resolveParameter(GpuProgramParameters::AutoConstantType::CUSTOM,
+                                                 BillboardSet::INSTANCED_PARAM_AXIS_X);
+        auto axisY = vsProgram->resolveParameter(GpuProgramParameters::AutoConstantType::CUSTOM,
+                                                 BillboardSet::INSTANCED_PARAM_AXIS_Y);
+        auto offsets = vsProgram->resolveParameter(GpuProgramParameters::AutoConstantType::CUSTOM,
+                                                   BillboardSet::INSTANCED_PARAM_OFFSETS);
+        auto corner = vsEntry->resolveInputParameter(Parameter::Content::TEXTURE_COORDINATE0, GpuConstantType::FLOAT2);
+        auto sizeRotation =
+            vsEntry->resolveInputParameter(Parameter::Content::TEXTURE_COORDINATE1, GpuConstantType::FLOAT3);
+        auto texcoordRect =
+            vsEntry->resolveInputParameter(Parameter::Content::TEXTURE_COORDINATE2, GpuConstantType::FLOAT4);
+
+        // the quad is expanded in object space, so the code below applies as usual
+        stage.callFunction("FFP_ExpandBillboard", {In(axisX), In(axisY), In(offsets), In(sizeRotation),
+                                                   In(texcoordRect), InOut(positionIn).xyz(), InOut(corner)});
+    }
+    else if(mChains)
+    {
+        // element position in POSITION, tangent and signed half width in texcoord 1
+        auto eyePos = vsProgram->resolveParameter(GpuProgramParameters::AutoConstantType::CAMERA_POSITION_OBJECT_SPACE);
+        auto expansion =
+            vsEntry->resolveInputParameter(Parameter::Content::TEXTURE_COORDINATE1, GpuConstantType::FLOAT4);
+        stage.callFunction("FFP_ExpandChain", {In(eyePos).xyz(), In(expansion), InOut(positionIn).xyz()});
+    }
+    else if(mInstanced)
     {
         if (isHLSL)
         {
@@ -145,6 +172,8 @@ void FFPTransform::copyFrom(const SubRenderState& rhs)
     mSetPointSize = rhsTransform.mSetPointSize;
     mInstanced = rhsTransform.mInstanced;
     mTexCoordIndex = rhsTransform.mTexCoordIndex;
+    mBillboards = rhsTransform.mBillboards;
+    mChains = rhsTransform.mChains;
 }
 
 //-----------------------------------------------------------------------
@@ -183,6 +212,8 @@ auto FFPTransformFactory::createInstance(ScriptCompiler* compiler,
 
             auto ret = static_cast<FFPTransform*>(createOrRetrieveInstance(translator));
             ret->setInstancingParams(modelType == "instanced", texCoordSlot);
+            ret->setInstancedBillboards(modelType == "billboard");
+            ret->setChainExpansion(modelType == "chain");
 
             return ret;
         }
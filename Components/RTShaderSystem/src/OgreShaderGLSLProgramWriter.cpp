@@ -226,6 +226,8 @@ void GLSLProgramWriter::writeMainSourceCode(std::ostream& os, Program* program)
     }
     os << std::endl;
 
+    // a local, so programs can be written concurrently, see ProgramManager::createGpuPrograms
+    std::set<String, std::less<>> localRenames;
     for (const auto& pFuncInvoc : curFunction->getAtomInstances())
     {
         for (auto& operand : pFuncInvoc->getOperandList())
@@ -250,7 +252,7 @@ void GLSLProgramWriter::writeMainSourceCode(std::ostream& os, Program* program)
                 }
 
                 // now we check if we already declared a redirector var
-                if(doLocalRename && mLocalRenames.find(param->getName()) == mLocalRenames.end())
+                if(doLocalRename && localRenames.find(param->getName()) == localRenames.end())
                 {
                     // Declare the copy variable and assign the original
                     String newVar = ::std::format("local_{}", param->getName());
@@ -258,7 +260,7 @@ void GLSLProgramWriter::writeMainSourceCode(std::ostream& os, Program* program)
 
                     // From now on we replace it automatic
                     param->_rename(newVar, true);
-                    mLocalRenames.insert(newVar);
+                    localRenames.insert(newVar);
                 }
             }
 
@@ -98,8 +98,6 @@ protected:
 
     // Attributes.
 protected:
-    std::set<std::string, std::less<>> mLocalRenames;
-
     // Map parameter content to vertex attributes 
     ParamContentToStringMap mContentToPerVertexAttributes;
     // Holds the current glsl version
@@ -32,12 +32,14 @@ module;
 module Ogre.Components.RTShaderSystem;
 
 import :ShaderCookTorranceLighting;
+import :ShaderExClusteredLighting;
 import :ShaderExGBuffer;
 import :ShaderExHardwareSkinning;
 import :ShaderExIntegratedPSSM3;
 import :ShaderExLayeredBlending;
 import :ShaderExNormalMapLighting;
 import :ShaderExPerPixelLighting;
+import :ShaderExTextureArrayLayer;
 import :ShaderExTriplanarTexturing;
 import :ShaderExWBOIT;
 import :ShaderFFPAlphaTest;
@@ -60,6 +62,8 @@ import Ogre.Core;
 
 import <algorithm>;
 import <any>;
+import <bit>;
+import <fstream>;
 import <ios>;
 import <map>;
 import <memory>;
@@ -301,6 +305,10 @@ void ShaderGenerator::createBuiltinSRSFactories()
         addSubRenderStateFactory(curFactory);
         mBuiltinSRSFactories.push_back(curFactory);
 
+        curFactory = new ClusteredLightingFactory;
+        addSubRenderStateFactory(curFactory);
+        mBuiltinSRSFactories.push_back(curFactory);
+
         curFactory = new IntegratedPSSM3Factory;
         addSubRenderStateFactory(curFactory);
         mBuiltinSRSFactories.push_back(curFactory);
@@ -325,6 +333,10 @@ void ShaderGenerator::createBuiltinSRSFactories()
     curFactory = new WBOITFactory;
     addSubRenderStateFactory(curFactory);
     mBuiltinSRSFactories.push_back(curFactory);
+
+    curFactory = new TextureArrayLayerFactory;
+    addSubRenderStateFactory(curFactory);
+    mBuiltinSRSFactories.push_back(curFactory);
 }
 
 //-----------------------------------------------------------------------------
@@ -342,6 +354,10 @@ void ShaderGenerator::destroy()
 //-----------------------------------------------------------------------------
 void ShaderGenerator::_destroy()
 {
+    // record the variants of this run for warmUpVariants of the next one
+    if (!mShaderCachePath.empty())
+        writeVariantManifest();
+
     mIsFinalizing = true;
     
     // Delete technique entries.
@@ -1271,6 +1287,84 @@ void ShaderGenerator::setShaderCachePath( std::string_view cachePath )
     }
 }
 
+//-----------------------------------------------------------------------------
+static auto getVariantManifestName(std::string_view cachePath) -> String
+{
+    return ::std::format("{}ShaderGenerator.variants", cachePath);
+}
+
+//-----------------------------------------------------------------------------
+void ShaderGenerator::writeVariantManifest()
+{
+    OgreAssert(!mShaderCachePath.empty(), "no shader cache path set");
+
+    String manifest;
+    for (auto const& [key, matEntry] : mMaterialEntriesMap)
+    {
+        for (auto* techEntry : matEntry->getTechniqueList())
+        {
+            // only those that were rendered, or validated explicitly
+            if (!techEntry->getDestinationTechnique())
+                continue;
+
+            manifest += ::std::format("{}\t{}\t{}\t{}\t{}\n", matEntry->getMaterialName(), matEntry->getGroupName(),
+                                      techEntry->getSourceTechnique()->getSchemeName(),
+                                      techEntry->getDestinationTechniqueSchemeName(),
+                                      int(techEntry->overProgrammablePass()));
+        }
+    }
+
+    String fileName = getVariantManifestName(mShaderCachePath);
+    std::ofstream outFile(fileName.c_str(), std::ios::binary);
+    outFile << manifest;
+    if (!outFile)
+        LogManager::getSingleton().logWarning(::std::format("ShaderGenerator: could not write '{}'", fileName));
+}
+
+//-----------------------------------------------------------------------------
+auto ShaderGenerator::warmUpVariants() -> size_t
+{
+    if (mShaderCachePath.empty())
+        return 0;
+
+    std::ifstream inFile(getVariantManifestName(mShaderCachePath).c_str(), std::ios::binary);
+    return warmUpVariants(inFile);
+}
+
+//-----------------------------------------------------------------------------
+auto ShaderGenerator::warmUpVariants(std::istream& manifest) -> size_t
+{
+    bool canCompile = Root::getSingleton().getRenderSystem() != nullptr;
+
+    size_t count = 0;
+    String line;
+    while (std::getline(manifest, line))
+    {
+        auto fields = StringUtil::split(line, "\t", 0, false);
+        if (fields.size() != 5)
+            continue;
+
+        std::string_view materialName = fields[0], groupName = fields[1], dstScheme = fields[3];
+
+        MaterialPtr mat = MaterialManager::getSingleton().getByName(materialName, groupName);
+        if (!mat || !createShaderBasedTechnique(*mat, fields[2], dstScheme, fields[4] == "1") ||
+            !validateMaterial(dstScheme, materialName, groupName))
+            continue;
+
+        if (canCompile)
+        {
+            for (auto* techEntry : findMaterialEntryIt(materialName, groupName)->second->getTechniqueList())
+            {
+                if (techEntry->getDestinationTechniqueSchemeName() == dstScheme && techEntry->getDestinationTechnique())
+                    techEntry->getDestinationTechnique()->_load();
+            }
+        }
+        ++count;
+    }
+
+    return count;
+}
+
 //-----------------------------------------------------------------------------
 auto ShaderGenerator::findMaterialEntryIt(std::string_view materialName, std::string_view groupName) -> ShaderGenerator::SGMaterialIterator
 {
@@ -1386,6 +1480,14 @@ ShaderGenerator::SGPass::~SGPass()
 
 //-----------------------------------------------------------------------------
 void ShaderGenerator::SGPass::buildTargetRenderState()
+{
+    TargetRenderState::PendingProgramList pending;
+    buildTargetRenderState(pending);
+    TargetRenderState::acquirePrograms(pending);
+}
+
+//-----------------------------------------------------------------------------
+void ShaderGenerator::SGPass::buildTargetRenderState(TargetRenderState::PendingProgramList& pending)
 {   
     if(mSrcPass->isProgrammable() && !mParent->overProgrammablePass() && !isIlluminationPass()) return;
     std::string_view schemeName = mParent->getDestinationTechniqueSchemeName();
@@ -1411,6 +1513,7 @@ void ShaderGenerator::SGPass::buildTargetRenderState()
     
     
     targetRenderState->setLightCount(lightCount);
+    targetRenderState->setUberShaders(renderStateGlobal != nullptr && renderStateGlobal->getUberShaders());
 
     // Link the target render state with the custom render state of this pass if exists.
     if (mCustomRenderState != nullptr)
@@ -1427,7 +1530,7 @@ void ShaderGenerator::SGPass::buildTargetRenderState()
     // Build the FFP state.
     FFPRenderStateBuilder::buildRenderState(this, targetRenderState.get());
 
-    targetRenderState->acquirePrograms(mDstPass);
+    pending.emplace_back(targetRenderState.get(), mDstPass);
     mDstPass->getUserObjectBindings().setUserAny(TargetRenderState::UserKey, targetRenderState);
 }
 
@@ -1566,6 +1669,21 @@ void ShaderGenerator::SGTechnique::destroySGPasses()
 //-----------------------------------------------------------------------------
 void ShaderGenerator::SGTechnique::buildTargetRenderState()
 {
+    TargetRenderState::PendingProgramList pending;
+    buildTargetRenderState(pending);
+    TargetRenderState::acquirePrograms(pending);
+}
+
+//-----------------------------------------------------------------------------
+void ShaderGenerator::SGTechnique::buildTargetRenderState(TargetRenderState::PendingProgramList& pending)
+{
+    ShaderTelemetry::Scope telemetry{ShaderTelemetry::EventType::GENERATION, mParent->getMaterialName()};
+    if (telemetry.isRecording())
+    {
+        telemetry.setVariant({String{mParent->getMaterialName()}, String{mParent->getGroupName()},
+                              String{mSrcTechnique->getSchemeName()}, mDstTechniqueSchemeName, mOverProgrammable});
+    }
+
     // Remove existing destination technique and passes
     // in order to build it again from scratch.
     if (mDstTechnique != nullptr)
@@ -1595,7 +1713,7 @@ void ShaderGenerator::SGTechnique::buildTargetRenderState()
     for (auto & mPassEntrie : mPassEntries)
     {
 		assert(!mPassEntrie->isIlluminationPass()); // this is not so important, but intended to be so here.
-        mPassEntrie->buildTargetRenderState();
+        mPassEntrie->buildTargetRenderState(pending);
     }
 
     // Turn off the build destination technique flag.
@@ -1742,12 +1860,15 @@ void ShaderGenerator::SGScheme::validate()
     if (mOutOfDate == false)
         return;
 
-    // Build render state for each technique and acquire GPU programs.
+    // Build render state for each technique, then acquire the GPU programs of all at once,
+    // which writes their source code in parallel.
+    TargetRenderState::PendingProgramList pending;
     for (SGTechnique* curTechEntry : mTechniqueEntries)
     {
         if (curTechEntry->getBuildDestinationTechnique())
-            curTechEntry->buildTargetRenderState();
+            curTechEntry->buildTargetRenderState(pending);
     }
+    TargetRenderState::acquirePrograms(pending);
     
     // Mark this scheme as up to date.
     mOutOfDate = false;
@@ -1770,6 +1891,13 @@ void ShaderGenerator::SGScheme::synchronizeWithLightSettings()
         {
             sceneLightCount[std::to_underlying(i->getType())]++;
         }
+
+        // General programs handle any light type, count them in total and only grow in steps.
+        if (curRenderState->getUberShaders())
+        {
+            auto total = uint32(sceneLightCount[0] + sceneLightCount[1] + sceneLightCount[2]);
+            sceneLightCount = Vector3i{total ? int(std::bit_ceil(total)) : 0, 0, 0};
+        }
         
         auto currLightCount = mRenderState->getLightCount();
 
@@ -1792,6 +1920,10 @@ void ShaderGenerator::SGScheme::synchronizeWithFogSettings()
 {
     SceneManager* sceneManager = ShaderGenerator::getSingleton().getActiveSceneManager();
 
+    // General programs take the fog mode as a uniform.
+    if (getRenderState()->getUberShaders())
+        return;
+
     if (sceneManager != nullptr && sceneManager->getFogMode() != mFogMode)
     {
         LogManager::getSingleton().stream(LogMessageLevel::Trivial)
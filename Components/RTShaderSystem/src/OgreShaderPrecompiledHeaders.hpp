@@ -100,6 +100,12 @@ char const constexpr inline FFP_FUNC_PIXELFOG_EXP[] =
 char const constexpr inline FFP_FUNC_PIXELFOG_EXP2[] =
     "FFP_PixelFog_Exp2";
 
+char const constexpr inline FFP_FUNC_VERTEXFOG_GENERIC[] =
+    "FFP_VertexFog_Generic";
+
+char const constexpr inline FFP_FUNC_PIXELFOG_GENERIC[] =
+    "FFP_PixelFog_Generic";
+
 // Fixed Function Library: Alpha Test
 char const constexpr inline FFP_LIB_ALPHA_TEST[] =
     "FFPLib_AlphaTest";
@@ -126,3 +132,9 @@ char const constexpr inline SGX_FUNC_LIGHT_SPOT_DIFFUSE[] =
 
 char const constexpr inline SGX_FUNC_LIGHT_SPOT_DIFFUSESPECULAR[] =
     "SGX_Light_Spot_DiffuseSpecular";
+
+char const constexpr inline SGX_FUNC_LIGHT_GENERIC_DIFFUSE[] =
+    "SGX_Light_Generic_Diffuse";
+
+char const constexpr inline SGX_FUNC_LIGHT_GENERIC_DIFFUSESPECULAR[] =
+    "SGX_Light_Generic_DiffuseSpecular";
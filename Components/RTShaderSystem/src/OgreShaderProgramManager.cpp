@@ -51,6 +51,7 @@ import Ogre.Core;
 import <algorithm>;
 import <fstream>;
 import <initializer_list>;
+import <iterator>;
 import <map>;
 import <memory>;
 import <string>;
@@ -174,6 +175,12 @@ void ProgramManager::destroyDefaultProgramProcessors()
 
 //-----------------------------------------------------------------------------
 void ProgramManager::createGpuPrograms(ProgramSet* programSet)
+{
+    createGpuPrograms(std::vector<ProgramSet*>{programSet});
+}
+
+//-----------------------------------------------------------------------------
+void ProgramManager::createGpuPrograms(const std::vector<ProgramSet*>& programSets)
 {
     // Before we start we need to make sure that the pixel shader input
     //  parameters are the same as the vertex output, this required by 
@@ -183,7 +190,8 @@ void ProgramManager::createGpuPrograms(ProgramSet* programSet)
     bool isVs4 = GpuProgramManager::getSingleton().isSyntaxSupported("vs_4_0_level_9_1");
     if (isVs4)
     {
-        synchronizePixelnToBeVertexOut(programSet);
+        for (auto* programSet : programSets)
+            synchronizePixelnToBeVertexOut(programSet);
     }
 
     // Grab the matching writer.
@@ -204,40 +212,62 @@ void ProgramManager::createGpuPrograms(ProgramSet* programSet)
     programProcessor = itProcessor->second;
     
     // Call the pre creation of GPU programs method.
-    if (!programProcessor->preCreateGpuPrograms(programSet))
-        OGRE_EXCEPT(ExceptionCodes::INTERNAL_ERROR, "preCreateGpuPrograms failed");
-    
-    // Create the shader programs
-    for(auto type : {GpuProgramType::VERTEX_PROGRAM, GpuProgramType::FRAGMENT_PROGRAM})
+    for (auto* programSet : programSets)
     {
-        auto gpuProgram = createGpuProgram(programSet->getCpuProgram(type), programWriter, language,
-                                           ShaderGenerator::getSingleton().getShaderProfiles(type),
-                                           ShaderGenerator::getSingleton().getShaderCachePath());
-        programSet->setGpuProgram(gpuProgram);
+        if (!programProcessor->preCreateGpuPrograms(programSet))
+            OGRE_EXCEPT(ExceptionCodes::INTERNAL_ERROR, "preCreateGpuPrograms failed");
     }
 
-    //update flags
-    programSet->getGpuProgram(GpuProgramType::VERTEX_PROGRAM)->setSkeletalAnimationIncluded(
-        programSet->getCpuProgram(GpuProgramType::VERTEX_PROGRAM)->getSkeletalAnimationIncluded());
+    // Generate the source code, which only touches the CPU programs of the respective set
+    static constexpr GpuProgramType programTypes[] = {GpuProgramType::VERTEX_PROGRAM, GpuProgramType::FRAGMENT_PROGRAM};
+    std::vector<String> sources(programSets.size() * std::size(programTypes));
+    auto writeSource = [&](size_t i)
+    {
+        std::stringstream sourceCodeStringStream;
+        Program* program = programSets[i / std::size(programTypes)]->getCpuProgram(programTypes[i % std::size(programTypes)]);
+        programWriter->writeSourceCode(sourceCodeStringStream, program);
+        sources[i] = sourceCodeStringStream.str();
+    };
+
+    Root* root = Root::getSingletonPtr();
+    if (root && root->getWorkQueue() && programSets.size() > 1)
+        root->getWorkQueue()->parallelFor(sources.size(), writeSource);
+    else
+        for (size_t i = 0; i < sources.size(); ++i)
+            writeSource(i);
+
+    // Create the shader programs
+    for (size_t i = 0; i < programSets.size(); ++i)
+    {
+        ProgramSet* programSet = programSets[i];
+        for (size_t t = 0; t < std::size(programTypes); ++t)
+        {
+            auto type = programTypes[t];
+            auto gpuProgram = createGpuProgram(programSet->getCpuProgram(type), programWriter,
+                                               std::move(sources[i * std::size(programTypes) + t]), language,
+                                               ShaderGenerator::getSingleton().getShaderProfiles(type),
+                                               ShaderGenerator::getSingleton().getShaderCachePath());
+            programSet->setGpuProgram(gpuProgram);
+        }
 
-    // Call the post creation of GPU programs method.
-    if(!programProcessor->postCreateGpuPrograms(programSet))
-        OGRE_EXCEPT(ExceptionCodes::INTERNAL_ERROR, "postCreateGpuPrograms failed");
+        //update flags
+        programSet->getGpuProgram(GpuProgramType::VERTEX_PROGRAM)->setSkeletalAnimationIncluded(
+            programSet->getCpuProgram(GpuProgramType::VERTEX_PROGRAM)->getSkeletalAnimationIncluded());
+
+        // Call the post creation of GPU programs method.
+        if(!programProcessor->postCreateGpuPrograms(programSet))
+            OGRE_EXCEPT(ExceptionCodes::INTERNAL_ERROR, "postCreateGpuPrograms failed");
+    }
 }
 
 //-----------------------------------------------------------------------------
 auto ProgramManager::createGpuProgram(Program* shaderProgram, 
                                                ProgramWriter* programWriter,
+                                               String source,
                                                std::string_view language,
                                                std::string_view profiles,
                                                std::string_view cachePath) -> GpuProgramPtr
 {
-    std::stringstream sourceCodeStringStream;
-
-    // Generate source code.
-    programWriter->writeSourceCode(sourceCodeStringStream, shaderProgram);
-    String source = sourceCodeStringStream.str();
-
     // Generate program name.
     String programName = generateHash(source, shaderProgram->getPreprocessorDefines());
 
@@ -44,6 +44,7 @@ import <initializer_list>;
 import <memory>;
 import <string>;
 import <type_traits>;
+import <utility>;
 import <vector>;
 
 namespace Ogre {
@@ -55,6 +56,7 @@ const char* TargetRenderState::UserKey = "TargetRenderState";
 RenderState::RenderState()
 {
     mLightCountAutoUpdate    = true;    
+    mUberShaders             = false;
     mLightCount[0]           = 0;
     mLightCount[1]           = 0;
     mLightCount[2]           = 0;   
@@ -166,7 +168,35 @@ void TargetRenderState::acquirePrograms(Pass* pass)
 {
     createCpuPrograms();
     ProgramManager::getSingleton().createGpuPrograms(mProgramSet.get());
+    bindPrograms(pass);
+}
 
+//-----------------------------------------------------------------------
+void TargetRenderState::acquirePrograms(const PendingProgramList& renderStates)
+{
+    if (renderStates.empty())
+        return;
+
+    // the programs of several techniques at once, so not of any variant
+    ShaderTelemetry::Scope telemetry{ShaderTelemetry::EventType::GENERATION, "RTSS programs"};
+    telemetry.setVariant({});
+    std::vector<ProgramSet*> programSets;
+    programSets.reserve(renderStates.size());
+    for (auto [renderState, pass] : renderStates)
+    {
+        renderState->createCpuPrograms();
+        programSets.push_back(renderState->mProgramSet.get());
+    }
+
+    ProgramManager::getSingleton().createGpuPrograms(programSets);
+
+    for (auto [renderState, pass] : renderStates)
+        renderState->bindPrograms(pass);
+}
+
+//-----------------------------------------------------------------------
+void TargetRenderState::bindPrograms(Pass* pass)
+{
     bool hasError = false;
     bool logProgramNames = !ShaderGenerator::getSingleton().getShaderCachePath().empty();
     std::string_view matName = pass->getParent()->getParent()->getName();
@@ -0,0 +1,11 @@
+// This file is part of the OGRE project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at https://www.ogre3d.org/licensing.
+export module Ogre.Components.Terrain;
+
+export import :TerrainPageProvider;
+export import :TerrainQuadTree;
+export import :TerrainRTShaderSRS;
+export import :TerrainTile;
+
+export import Ogre.Core;
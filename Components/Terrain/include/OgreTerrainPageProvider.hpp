@@ -0,0 +1,130 @@
+// This file is part of the OGRE project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at https://www.ogre3d.org/licensing.
+module;
+
+#include <cstddef>
+
+export module Ogre.Components.Terrain:TerrainPageProvider;
+
+export import :TerrainRTShaderSRS;
+export import :TerrainTile;
+
+export import Ogre.Components.Paging;
+export import Ogre.Core;
+
+export import <map>;
+export import <memory>;
+
+export
+namespace Ogre {
+
+    /** \addtogroup Optional
+    *  @{
+    */
+    /** \addtogroup Terrain
+    *  @{
+    */
+    /** Streams a TerrainTile per page of a PagedWorld from per tile maps.
+    @remarks
+        The maps of the page at (x, y) are found in the resource group by the names
+        prefix_x_y_height.extension, prefix_x_y_normal.extension and prefix_x_y_splat.extension,
+        the first row at the minimum Z. Cells without a height map have no page. The normal and
+        splat maps are loaded as textures in the background through the PagedWorld, while the
+        height map is read on activation, since the quadtree needs the heights on the CPU, and
+        uploaded as a float texture.
+    @par
+        The height map is a square grey image, e.g. a 16 bit PNG, with a power of two multiple of
+        the grid size plus one texels per side, the border texels shared with the neighbouring
+        tiles. Its normalised values are scaled by the height scale. The normal map should have
+        the same size.
+    @par
+        Every tile gets a clone of the material set here, with the texture units TerrainHeight,
+        TerrainNormal and TerrainSplat added to its first pass, and draws through the
+        RTShader::ShaderGenerator with the TerrainTransforms and, given a splat map, the
+        TerrainSurface SubRenderState. The material should hold the splatted layers in texture
+        units named TerrainLayer0 to TerrainLayer3.
+    @par
+        The provider registers the TerrainTileFactory and the SubRenderState factories unless
+        they already are, and has to outlive the PagedWorld.
+    */
+    class TerrainPageProvider : public PageProvider
+    {
+    public:
+        /**
+        @param prefix start of the names of the maps
+        @param group resource group of the maps, the textures and the materials
+        @param gridSize quads per side of the grid shared by the tiles
+        */
+        explicit TerrainPageProvider(std::string_view prefix, std::string_view group = RGN_DEFAULT,
+                                     uint32 gridSize = 32);
+        ~TerrainPageProvider() override;
+
+        TerrainPageProvider(const TerrainPageProvider&) = delete;
+        auto operator=(const TerrainPageProvider&) -> TerrainPageProvider& = delete;
+
+        /// Sets the extension of the maps, png by default
+        void setExtension(std::string_view extension) { mExtension = extension; }
+        [[nodiscard]] auto getExtension() const noexcept -> std::string_view { return mExtension; }
+
+        /// Sets the height of a white texel of the height maps, 1 by default
+        void setHeightScale(Real scale) { mHeightScale = scale; }
+        [[nodiscard]] auto getHeightScale() const noexcept -> Real { return mHeightScale; }
+
+        /// Sets the material cloned for the tiles, the default material of the group if not set
+        void setMaterial(const MaterialPtr& material) { mMaterial = material; }
+        [[nodiscard]] auto getMaterial() const noexcept -> const MaterialPtr& { return mMaterial; }
+
+        /// See TerrainTile::setLodDistance, for the tiles activated afterwards
+        void setLodDistance(Real distance) { mLodDistance = distance; }
+        [[nodiscard]] auto getLodDistance() const noexcept -> Real { return mLodDistance; }
+
+        /// See TerrainTile::setLayerScales, for the tiles activated afterwards
+        void setLayerScales(const Vector4& scales) { mLayerScales = scales; }
+        [[nodiscard]] auto getLayerScales() const noexcept -> const Vector4& { return mLayerScales; }
+
+        [[nodiscard]] auto getGrid() const noexcept -> const std::shared_ptr<TerrainGrid>& { return mGrid; }
+
+        /// Gets the name of a map of a page, e.g. "height"
+        [[nodiscard]] auto getMapName(PageID id, std::string_view map) const -> String;
+
+        /// Gets the tile of an active page, @c nullptr if it has none
+        [[nodiscard]] auto getTile(PageID id) const -> TerrainTile*;
+
+        auto definePage(Page& page) -> bool override;
+        void deactivatePage(Page& page) override;
+
+    private:
+        /// What a tile owns besides the object below the page node
+        struct TileResources
+        {
+            TerrainTile* tile;
+            TexturePtr heightTexture;
+            MaterialPtr material;
+        };
+
+        String mPrefix;
+        String mGroup;
+        String mExtension{"png"};
+        Real mHeightScale{1};
+        MaterialPtr mMaterial;
+        Real mLodDistance{0};
+        Vector4 mLayerScales{1, 1, 1, 1};
+
+        std::shared_ptr<TerrainGrid> mGrid;
+        std::map<PageID, TileResources> mTiles;
+
+        TerrainTileFactory mTileFactory;
+        TerrainTransformsFactory mTransformsFactory;
+        TerrainSurfaceFactory mSurfaceFactory;
+        bool mOwnsTileFactory{false};
+        bool mOwnsShaderFactories{false};
+
+        /// Reads the heights and creates the tile of an active page
+        void createTile(Page& page, bool hasNormalMap, bool hasSplatMap);
+        auto createMaterial(PageID id, const TexturePtr& heightTexture, bool hasNormalMap, bool hasSplatMap)
+            -> MaterialPtr;
+    };
+    /** @} */
+    /** @} */
+}
@@ -0,0 +1,101 @@
+// This file is part of the OGRE project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at https://www.ogre3d.org/licensing.
+module;
+
+#include <cstddef>
+
+export module Ogre.Components.Terrain:TerrainQuadTree;
+
+export import Ogre.Core;
+
+export import <vector>;
+
+export
+namespace Ogre {
+
+    /** \addtogroup Optional
+    *  @{
+    */
+    /** \defgroup Terrain Terrain
+    * Heightfield terrain drawn with a CDLOD quadtree over a shared grid
+    *  @{
+    */
+    /** The min/max height quadtree of a heightfield tile, selecting the patches to draw.
+    @remarks
+        Level 0 holds the leaves, which are as large as the shared grid, and each level above
+        doubles the node size up to the root covering the whole tile. The selection follows
+        continuous distance-dependent LOD (CDLOD): a node of level l is drawn when it lies within
+        the range of its level, lodDistance * 2^l, but not within the range of the level below.
+        Its children are selected instead otherwise, and those outside their own range are drawn
+        at their level, where the vertex shader morphs them fully to the resolution of the
+        parent.
+    @par
+        The range of the finest level should be at least twice the diagonal of a leaf, so that
+        neighbouring patches never differ by more than one level.
+    */
+    class TerrainQuadTree
+    {
+    public:
+        /// A node to draw with the shared grid, in the space of the tile
+        struct Patch
+        {
+            /// Minimum corner on the XZ plane
+            float x{0};
+            float z{0};
+            float size{0};
+            /// Level of the node, selecting its morph range
+            float level{0};
+        };
+
+        TerrainQuadTree() = default;
+
+        /** Builds the tree of a tile.
+        @param heights samples * samples heights, row by row along +X then +Z
+        @param samples heights per side, a power of two multiple of leafSize plus one
+        @param leafSize quads per side of a leaf, the size of the shared grid
+        @param spacing distance between two heights
+        */
+        TerrainQuadTree(const float* heights, uint32 samples, uint32 leafSize, Real spacing);
+
+        [[nodiscard]] auto getNumLevels() const noexcept -> uint32 { return uint32(mLevels.size()); }
+        [[nodiscard]] auto getLeafSize() const noexcept -> uint32 { return mLeafSize; }
+        /// Gets the number of leaves per side, the most patches the selection returns is its square
+        [[nodiscard]] auto getNumLeaves() const noexcept -> uint32 { return mLevels.empty() ? 0 : mLevels[0].nodes; }
+
+        /// Gets the bounds of a node in the space of the tile
+        [[nodiscard]] auto getNodeBounds(uint32 level, uint32 x, uint32 z) const -> AxisAlignedBox;
+        /// Gets the bounds of the whole tile
+        [[nodiscard]] auto getBounds() const -> AxisAlignedBox;
+
+        /** Selects the patches to draw.
+        @param eye the LOD camera position in the space of the tile
+        @param lodDistance range of the finest level
+        @param patches receives the patches, cleared first
+        @param frustum culls the nodes not visible if given
+        @param toWorld transform of the tile for culling
+        */
+        void select(const Vector3& eye, Real lodDistance, std::vector<Patch>& patches,
+                    const Frustum* frustum = nullptr, const Affine3& toWorld = Affine3::IDENTITY) const;
+
+    private:
+        struct Level
+        {
+            /// Nodes per side
+            uint32 nodes;
+            /// Min and max height of each node, row by row
+            std::vector<float> minHeights;
+            std::vector<float> maxHeights;
+        };
+
+        std::vector<Level> mLevels;
+        uint32 mLeafSize{0};
+        Real mSpacing{0};
+
+        /// Adds the node or its children, false if the node is beyond the range of its level
+        auto selectNode(uint32 level, uint32 x, uint32 z, const Vector3& eye, Real lodDistance,
+                        std::vector<Patch>& patches, const Frustum* frustum, const Affine3& toWorld) const -> bool;
+    };
+    /** @} */
+    /** @} */
+}
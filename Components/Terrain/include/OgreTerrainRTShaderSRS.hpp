@@ -0,0 +1,103 @@
+// This file is part of the OGRE project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at https://www.ogre3d.org/licensing.
+module;
+
+#include <cstddef>
+
+export module Ogre.Components.Terrain:TerrainRTShaderSRS;
+
+export import Ogre.Components.RTShaderSystem;
+export import Ogre.Core;
+
+export import <vector>;
+
+export
+namespace Ogre {
+
+    /** \addtogroup Optional
+    *  @{
+    */
+    /** \addtogroup Terrain
+    *  @{
+    */
+    /** Transform stage of the TerrainTile patches, replacing RTShader::FFPTransform.
+    @remarks
+        Places the vertices of the shared grid on the patch of the instance, fetches their height
+        from the texture unit named TerrainHeight, and morphs them towards the next coarser level
+        as they approach the end of the range of their level, see TerrainQuadTree. The normal is
+        fetched from the texture unit named TerrainNormal if the pass has one, and the texture
+        coordinates of the tile, 0 to 1 over it, are passed on in texture coordinate 0.
+    @par
+        Both textures are expected to hold one texel per height, the normals encoded as
+        n * 0.5 + 0.5 with Y up.
+    */
+    class TerrainTransforms : public RTShader::SubRenderState
+    {
+    public:
+        static std::string_view const Type;
+
+        auto getType() const noexcept -> std::string_view override { return Type; }
+        auto getExecutionOrder() const noexcept -> RTShader::FFPShaderStage override
+        {
+            return RTShader::FFPShaderStage::TRANSFORM;
+        }
+        void copyFrom(const RTShader::SubRenderState& rhs) override;
+        auto preAddToRenderState(const RTShader::RenderState* renderState, Pass* srcPass,
+                                 Pass* dstPass) noexcept -> bool override;
+        auto createCpuSubPrograms(RTShader::ProgramSet* programSet) -> bool override;
+
+    private:
+        int mHeightSampler{-1};
+        int mNormalSampler{-1};
+    };
+
+    /** Texturing stage splatting up to four layers, replacing RTShader::FFPTexturing.
+    @remarks
+        The layers are the texture units named TerrainLayer0 to TerrainLayer3, weighted by the
+        channels of the texture unit named TerrainSplat and repeated as
+        TerrainTile::setLayerScales specifies. The blend modulates the diffuse colour.
+    */
+    class TerrainSurface : public RTShader::SubRenderState
+    {
+    public:
+        static constexpr size_t MAX_LAYERS = 4;
+        static std::string_view const Type;
+
+        auto getType() const noexcept -> std::string_view override { return Type; }
+        auto getExecutionOrder() const noexcept -> RTShader::FFPShaderStage override
+        {
+            return RTShader::FFPShaderStage::TEXTURING;
+        }
+        void copyFrom(const RTShader::SubRenderState& rhs) override;
+        auto preAddToRenderState(const RTShader::RenderState* renderState, Pass* srcPass,
+                                 Pass* dstPass) noexcept -> bool override;
+        auto createCpuSubPrograms(RTShader::ProgramSet* programSet) -> bool override;
+
+    private:
+        int mSplatSampler{-1};
+        std::vector<int> mLayerSamplers;
+    };
+
+    /** A factory creating TerrainTransforms instances. */
+    class TerrainTransformsFactory : public RTShader::SubRenderStateFactory
+    {
+    public:
+        [[nodiscard]] auto getType() const noexcept -> std::string_view override { return TerrainTransforms::Type; }
+
+    protected:
+        auto createInstanceImpl() -> RTShader::SubRenderState* override { return new TerrainTransforms; }
+    };
+
+    /** A factory creating TerrainSurface instances. */
+    class TerrainSurfaceFactory : public RTShader::SubRenderStateFactory
+    {
+    public:
+        [[nodiscard]] auto getType() const noexcept -> std::string_view override { return TerrainSurface::Type; }
+
+    protected:
+        auto createInstanceImpl() -> RTShader::SubRenderState* override { return new TerrainSurface; }
+    };
+    /** @} */
+    /** @} */
+}
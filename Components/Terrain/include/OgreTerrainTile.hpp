@@ -0,0 +1,166 @@
+// This file is part of the OGRE project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at https://www.ogre3d.org/licensing.
+module;
+
+#include <cstddef>
+
+export module Ogre.Components.Terrain:TerrainTile;
+
+export import :TerrainQuadTree;
+
+export import Ogre.Core;
+
+export import <memory>;
+export import <vector>;
+
+export
+namespace Ogre {
+
+    /** \addtogroup Optional
+    *  @{
+    */
+    /** \addtogroup Terrain
+    *  @{
+    */
+    /** The grid drawn for every patch of the terrain tiles.
+    @remarks
+        The vertices only hold their grid coordinates, 0 to the size, in the x and y of POSITION.
+        The TerrainTransforms SubRenderState places them on the patch and fetches the height.
+    */
+    class TerrainGrid
+    {
+    public:
+        /// @param size quads per side, a power of two up to 128
+        explicit TerrainGrid(uint32 size);
+
+        [[nodiscard]] auto getSize() const noexcept -> uint32 { return mSize; }
+        [[nodiscard]] auto getVertexBuffer() const noexcept -> const HardwareVertexBufferSharedPtr& { return mVertexBuffer; }
+        [[nodiscard]] auto getIndexBuffer() const noexcept -> const HardwareIndexBufferSharedPtr& { return mIndexBuffer; }
+
+    private:
+        uint32 mSize;
+        HardwareVertexBufferSharedPtr mVertexBuffer;
+        HardwareIndexBufferSharedPtr mIndexBuffer;
+    };
+
+    /** A square heightfield drawn as instances of a shared TerrainGrid.
+    @remarks
+        The heights are kept on the CPU for the TerrainQuadTree and height queries, while the
+        material samples them from a float texture in the vertex shader. Each time the tile is
+        queued for a camera, the patches selected for the LOD camera and culled against the
+        frustum are written to an instance buffer and drawn in one call, the patch in
+        TEXTURE_COORDINATES 1 as offset x/z, size and level.
+    @par
+        The material has to draw through the TerrainTransforms SubRenderState, which reads the
+        custom parameters below. The tile spans [0, size] on the X and Z axis of its node, which
+        should neither be rotated nor scaled.
+    */
+    class TerrainTile : public MovableObject, public Renderable
+    {
+    public:
+        /// Custom parameters set for the vertex shader
+        enum CustomParam : size_t
+        {
+            /// Size of the tile, heights per side
+            PARAM_TILE = 0,
+            /// Range of the finest level, fraction of the range the morph starts at, grid size
+            PARAM_LOD = 1,
+            /// Texture coordinate scale of the four splatted layers
+            PARAM_LAYER_SCALES = 2
+        };
+
+        explicit TerrainTile(std::string_view name);
+        ~TerrainTile() override;
+
+        /** Sets the heightfield.
+        @param grid the grid shared by the tiles, the leaf size of the quadtree
+        @param size extent of the tile on the X and Z axis
+        @param samples heights per side, a power of two multiple of the grid size plus one
+        @param heights samples * samples heights, row by row along +X then +Z
+        */
+        void setHeights(const std::shared_ptr<TerrainGrid>& grid, Real size, uint32 samples, std::vector<float> heights);
+
+        [[nodiscard]] auto getSize() const noexcept -> Real { return mSize; }
+        [[nodiscard]] auto getNumSamples() const noexcept -> uint32 { return mSamples; }
+        [[nodiscard]] auto getHeights() const noexcept -> const std::vector<float>& { return mHeights; }
+        [[nodiscard]] auto getQuadTree() const noexcept -> const TerrainQuadTree& { return mQuadTree; }
+
+        /** Gets the height interpolated at a position in the space of the tile, clamped to its
+            borders. */
+        [[nodiscard]] auto getHeightAt(Real x, Real z) const -> Real;
+
+        /** Sets the range of the finest level, each level above doubles it.
+        @remarks
+            0, the default, uses four times the size of a leaf. Scaled by Camera::getLodBias.
+        */
+        void setLodDistance(Real distance) { mLodDistance = distance; }
+        [[nodiscard]] auto getLodDistance() const -> Real;
+
+        /** Sets the fraction of the range of a level after which its vertices morph towards the
+            next level, 0.7 by default. */
+        void setMorphStart(Real start) { mMorphStart = start; }
+        [[nodiscard]] auto getMorphStart() const noexcept -> Real { return mMorphStart; }
+
+        /** Sets how often each of the four splatted layers repeats over the tile. */
+        void setLayerScales(const Vector4& scales) { setCustomParameter(PARAM_LAYER_SCALES, scales); }
+
+        void setMaterial(const MaterialPtr& material) { mMaterial = material; }
+        auto getMaterial() const noexcept -> const MaterialPtr& override { return mMaterial; }
+
+        /// Gets the number of patches drawn for the last camera
+        [[nodiscard]] auto getNumPatches() const noexcept -> size_t { return mPatches.size(); }
+
+        /** Selects the patches for a camera and writes them to the instance buffer.
+        @remarks
+            Called when the tile is queued, exposed for drawing the tile from elsewhere.
+        */
+        void updatePatches(const Camera* cam);
+
+        auto getMovableType() const noexcept -> std::string_view override;
+        auto getBoundingBox() const noexcept -> const AxisAlignedBox& override { return mBounds; }
+        auto getBoundingRadius() const noexcept -> Real override { return mBoundingRadius; }
+        void _notifyCurrentCamera(Camera* cam) override;
+        void _updateRenderQueue(RenderQueue* queue) override;
+        void visitRenderables(Renderable::Visitor* visitor, bool debugRenderables = false) override;
+
+        void getRenderOperation(RenderOperation& op) override;
+        void getWorldTransforms(Matrix4* xform) const override;
+        auto getSquaredViewDepth(const Camera* cam) const -> Real override;
+        auto getLights() const noexcept -> const LightList& override { return queryLights(); }
+
+    private:
+        std::shared_ptr<TerrainGrid> mGrid;
+        Real mSize{0};
+        uint32 mSamples{0};
+        std::vector<float> mHeights;
+        TerrainQuadTree mQuadTree;
+
+        Real mLodDistance{0};
+        Real mMorphStart{0.7};
+
+        AxisAlignedBox mBounds;
+        Real mBoundingRadius{0};
+        MaterialPtr mMaterial;
+        Camera* mCurrentCamera{nullptr};
+
+        std::unique_ptr<VertexData> mVertexData;
+        std::unique_ptr<IndexData> mIndexData;
+        HardwareVertexBufferSharedPtr mInstanceBuffer;
+        std::vector<TerrainQuadTree::Patch> mPatches;
+    };
+
+    /** Factory creating TerrainTile instances, see SceneManager::createMovableObject. */
+    class TerrainTileFactory : public MovableObjectFactory
+    {
+    protected:
+        auto createInstanceImpl(std::string_view name, const NameValuePairList* params) -> MovableObject* override;
+
+    public:
+        static std::string_view const FACTORY_TYPE_NAME;
+
+        [[nodiscard]] auto getType() const noexcept -> std::string_view override;
+    };
+    /** @} */
+    /** @} */
+}
@@ -0,0 +1,179 @@
+// This file is part of the OGRE project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at https://www.ogre3d.org/licensing.
+module;
+
+#include <cstddef>
+
+module Ogre.Components.Terrain;
+
+import :TerrainPageProvider;
+import :TerrainRTShaderSRS;
+import :TerrainTile;
+
+import Ogre.Components.Paging;
+import Ogre.Components.RTShaderSystem;
+import Ogre.Core;
+
+import <format>;
+import <memory>;
+import <string>;
+import <vector>;
+
+namespace Ogre {
+    //-----------------------------------------------------------------------
+    TerrainPageProvider::TerrainPageProvider(std::string_view prefix, std::string_view group, uint32 gridSize)
+        : mPrefix(prefix)
+        , mGroup(group)
+        , mGrid(std::make_shared<TerrainGrid>(gridSize))
+    {
+        Root* root = Root::getSingletonPtr();
+        if (!root->hasMovableObjectFactory(TerrainTileFactory::FACTORY_TYPE_NAME))
+        {
+            root->addMovableObjectFactory(&mTileFactory);
+            mOwnsTileFactory = true;
+        }
+    }
+    //-----------------------------------------------------------------------
+    TerrainPageProvider::~TerrainPageProvider()
+    {
+        if (mOwnsShaderFactories)
+        {
+            if (auto* sg = RTShader::ShaderGenerator::getSingletonPtr())
+            {
+                sg->removeSubRenderStateFactory(&mTransformsFactory);
+                sg->removeSubRenderStateFactory(&mSurfaceFactory);
+            }
+        }
+        if (mOwnsTileFactory)
+            Root::getSingleton().removeMovableObjectFactory(&mTileFactory);
+    }
+    //-----------------------------------------------------------------------
+    auto TerrainPageProvider::getMapName(PageID id, std::string_view map) const -> String
+    {
+        return std::format("{}_{}_{}_{}.{}", mPrefix, id.x, id.y, map, mExtension);
+    }
+    //-----------------------------------------------------------------------
+    auto TerrainPageProvider::getTile(PageID id) const -> TerrainTile*
+    {
+        auto it = mTiles.find(id);
+        return it != mTiles.end() ? it->second.tile : nullptr;
+    }
+    //-----------------------------------------------------------------------
+    auto TerrainPageProvider::definePage(Page& page) -> bool
+    {
+        auto& resourceMgr = ResourceGroupManager::getSingleton();
+        PageID id = page.getID();
+        if (!resourceMgr.resourceExists(mGroup, getMapName(id, "height")))
+            return false;
+
+        bool hasNormalMap = resourceMgr.resourceExists(mGroup, getMapName(id, "normal"));
+        bool hasSplatMap = resourceMgr.resourceExists(mGroup, getMapName(id, "splat"));
+        if (hasNormalMap)
+            page.addResource("Texture", getMapName(id, "normal"), mGroup);
+        if (hasSplatMap)
+            page.addResource("Texture", getMapName(id, "splat"), mGroup);
+
+        page.addActivationTask([this, hasNormalMap, hasSplatMap](Page& page)
+        {
+            createTile(page, hasNormalMap, hasSplatMap);
+        });
+        return true;
+    }
+    //-----------------------------------------------------------------------
+    void TerrainPageProvider::deactivatePage(Page& page)
+    {
+        auto it = mTiles.find(page.getID());
+        if (it == mTiles.end())
+            return;
+
+        // the tile itself is destroyed with the content of the page
+        if (auto* sg = RTShader::ShaderGenerator::getSingletonPtr())
+            sg->removeAllShaderBasedTechniques(*it->second.material);
+        MaterialManager::getSingleton().remove(it->second.material);
+        TextureManager::getSingleton().remove(it->second.heightTexture);
+        mTiles.erase(it);
+    }
+    //-----------------------------------------------------------------------
+    void TerrainPageProvider::createTile(Page& page, bool hasNormalMap, bool hasSplatMap)
+    {
+        PageID id = page.getID();
+        Image source;
+        source.load(getMapName(id, "height"), mGroup);
+        uint32 samples = source.getWidth();
+        OgreAssert(source.getHeight() == samples, "height maps have to be square");
+
+        // normalised heights to float, then scaled
+        Image heightImage{PixelFormat::FLOAT32_R, samples, samples};
+        PixelUtil::bulkPixelConversion(source.getPixelBox(), heightImage.getPixelBox());
+        auto* data = heightImage.getData<float>();
+        std::vector<float> heights{data, data + size_t(samples) * samples};
+        for (size_t i = 0; i < heights.size(); ++i)
+            data[i] = heights[i] *= float(mHeightScale);
+
+        String name = std::format("TerrainTile/{}_{}_{}", mPrefix, id.x, id.y);
+        // one texel per height, filtered by hand in the vertex shader
+        TexturePtr heightTexture = TextureManager::getSingleton().loadImage(
+            std::format("{}/Height", name), mGroup, heightImage, TextureType::_2D, TextureMipmap{},
+            1.0f, false, PixelFormat::FLOAT32_R);
+
+        SceneManager* sceneMgr = page.getWorld()->getSceneManager();
+        auto* tile = static_cast<TerrainTile*>(sceneMgr->createMovableObject(name, TerrainTileFactory::FACTORY_TYPE_NAME));
+        tile->setHeights(mGrid, page.getWorld()->getPageSize(), samples, std::move(heights));
+        tile->setLodDistance(mLodDistance);
+        tile->setLayerScales(mLayerScales);
+
+        MaterialPtr material = createMaterial(id, heightTexture, hasNormalMap, hasSplatMap);
+        tile->setMaterial(material);
+        page.getSceneNode()->attachObject(tile);
+
+        mTiles[id] = {tile, heightTexture, material};
+    }
+    //-----------------------------------------------------------------------
+    auto TerrainPageProvider::createMaterial(PageID id, const TexturePtr& heightTexture, bool hasNormalMap,
+                                             bool hasSplatMap) -> MaterialPtr
+    {
+        const MaterialPtr& base = mMaterial ? mMaterial : MaterialManager::getSingleton().getDefaultMaterial();
+        MaterialPtr material = base->clone(std::format("TerrainTile/{}_{}_{}", mPrefix, id.x, id.y), mGroup);
+        Pass* pass = material->getTechnique(0)->getPass(0);
+
+        TextureUnitState* tus = pass->createTextureUnitState();
+        tus->setName("TerrainHeight");
+        tus->setTexture(heightTexture);
+        tus->setTextureFiltering(TextureFilterOptions::NONE);
+        tus->setTextureAddressingMode(TextureAddressingMode::CLAMP);
+        if (hasNormalMap)
+        {
+            tus = pass->createTextureUnitState(getMapName(id, "normal"));
+            tus->setName("TerrainNormal");
+            tus->setTextureAddressingMode(TextureAddressingMode::CLAMP);
+        }
+        if (hasSplatMap)
+        {
+            tus = pass->createTextureUnitState(getMapName(id, "splat"));
+            tus->setName("TerrainSplat");
+            tus->setTextureAddressingMode(TextureAddressingMode::CLAMP);
+        }
+
+        auto* sg = RTShader::ShaderGenerator::getSingletonPtr();
+        if (!sg)
+            return material;
+
+        if (!sg->getSubRenderStateFactory(TerrainTransforms::Type))
+        {
+            sg->addSubRenderStateFactory(&mTransformsFactory);
+            sg->addSubRenderStateFactory(&mSurfaceFactory);
+            mOwnsShaderFactories = true;
+        }
+
+        sg->createShaderBasedTechnique(*material, MaterialManager::DEFAULT_SCHEME_NAME,
+                                       RTShader::ShaderGenerator::DEFAULT_SCHEME_NAME);
+        RTShader::RenderState* renderState =
+            sg->getRenderState(RTShader::ShaderGenerator::DEFAULT_SCHEME_NAME, *material);
+        renderState->addTemplateSubRenderState(sg->createSubRenderState<TerrainTransforms>());
+        if (hasSplatMap)
+            renderState->addTemplateSubRenderState(sg->createSubRenderState<TerrainSurface>());
+
+        return material;
+    }
+}
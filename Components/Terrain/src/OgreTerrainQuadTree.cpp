@@ -0,0 +1,153 @@
+// This file is part of the OGRE project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at https://www.ogre3d.org/licensing.
+module;
+
+#include <cstddef>
+
+module Ogre.Components.Terrain;
+
+import :TerrainQuadTree;
+
+import Ogre.Core;
+
+import <algorithm>;
+import <bit>;
+import <vector>;
+
+namespace Ogre {
+    //-----------------------------------------------------------------------
+    TerrainQuadTree::TerrainQuadTree(const float* heights, uint32 samples, uint32 leafSize, Real spacing)
+        : mLeafSize(leafSize), mSpacing(spacing)
+    {
+        OgreAssert(leafSize > 0 && samples > leafSize && (samples - 1) % leafSize == 0,
+                   "samples must be a multiple of the leaf size plus one");
+        uint32 leaves = (samples - 1) / leafSize;
+        OgreAssert(std::has_single_bit(leaves), "samples must be a power of two multiple of the leaf size plus one");
+
+        // the leaves from the heights they cover, borders included
+        Level& leaf = mLevels.emplace_back(leaves);
+        leaf.minHeights.resize(size_t(leaves) * leaves);
+        leaf.maxHeights.resize(size_t(leaves) * leaves);
+        for (uint32 z = 0; z < leaves; ++z)
+        {
+            for (uint32 x = 0; x < leaves; ++x)
+            {
+                float minHeight = heights[size_t(z) * leafSize * samples + x * leafSize];
+                float maxHeight = minHeight;
+                for (uint32 j = z * leafSize; j <= (z + 1) * leafSize; ++j)
+                {
+                    const float* row = heights + size_t(j) * samples;
+                    auto [lo, hi] = std::minmax_element(row + x * leafSize, row + (x + 1) * leafSize + 1);
+                    minHeight = std::min(minHeight, *lo);
+                    maxHeight = std::max(maxHeight, *hi);
+                }
+                leaf.minHeights[size_t(z) * leaves + x] = minHeight;
+                leaf.maxHeights[size_t(z) * leaves + x] = maxHeight;
+            }
+        }
+
+        // each parent from its four children
+        while (mLevels.back().nodes > 1)
+        {
+            uint32 nodes = mLevels.back().nodes / 2;
+            Level parent{nodes};
+            parent.minHeights.resize(size_t(nodes) * nodes);
+            parent.maxHeights.resize(size_t(nodes) * nodes);
+
+            const Level& child = mLevels.back();
+            for (uint32 z = 0; z < nodes; ++z)
+            {
+                for (uint32 x = 0; x < nodes; ++x)
+                {
+                    size_t c0 = size_t(z * 2) * child.nodes + x * 2;
+                    size_t c1 = c0 + child.nodes;
+                    parent.minHeights[size_t(z) * nodes + x] =
+                        std::min({child.minHeights[c0], child.minHeights[c0 + 1], child.minHeights[c1],
+                                  child.minHeights[c1 + 1]});
+                    parent.maxHeights[size_t(z) * nodes + x] =
+                        std::max({child.maxHeights[c0], child.maxHeights[c0 + 1], child.maxHeights[c1],
+                                  child.maxHeights[c1 + 1]});
+                }
+            }
+            mLevels.push_back(std::move(parent));
+        }
+    }
+    //-----------------------------------------------------------------------
+    auto TerrainQuadTree::getNodeBounds(uint32 level, uint32 x, uint32 z) const -> AxisAlignedBox
+    {
+        const Level& l = mLevels.at(level);
+        size_t index = size_t(z) * l.nodes + x;
+        Real size = mLeafSize * mSpacing * Real(1u << level);
+        return {AxisAlignedBox::Extent::Finite, Vector3{Real(x) * size, l.minHeights.at(index), Real(z) * size},
+                Vector3{Real(x + 1) * size, l.maxHeights.at(index), Real(z + 1) * size}};
+    }
+    //-----------------------------------------------------------------------
+    auto TerrainQuadTree::getBounds() const -> AxisAlignedBox
+    {
+        if (mLevels.empty())
+            return AxisAlignedBox::BOX_NULL;
+        return getNodeBounds(getNumLevels() - 1, 0, 0);
+    }
+    //-----------------------------------------------------------------------
+    void TerrainQuadTree::select(const Vector3& eye, Real lodDistance, std::vector<Patch>& patches,
+                                 const Frustum* frustum, const Affine3& toWorld) const
+    {
+        patches.clear();
+        if (mLevels.empty())
+            return;
+
+        // beyond the range of the root the tile is still drawn, at its coarsest
+        uint32 root = getNumLevels() - 1;
+        if (!selectNode(root, 0, 0, eye, lodDistance, patches, frustum, toWorld))
+        {
+            AxisAlignedBox bounds = getBounds();
+            bounds.transform(toWorld);
+            if (!frustum || frustum->isVisible(bounds))
+                patches.push_back({0, 0, float(mLeafSize * mSpacing * Real(1u << root)), float(root)});
+        }
+    }
+    //-----------------------------------------------------------------------
+    auto TerrainQuadTree::selectNode(uint32 level, uint32 x, uint32 z, const Vector3& eye, Real lodDistance,
+                                     std::vector<Patch>& patches, const Frustum* frustum,
+                                     const Affine3& toWorld) const -> bool
+    {
+        AxisAlignedBox bounds = getNodeBounds(level, x, z);
+        Real range = lodDistance * Real(1u << level);
+        Real distance = bounds.squaredDistance(eye);
+        if (distance > range * range)
+            return false;
+
+        if (frustum)
+        {
+            AxisAlignedBox worldBounds = bounds;
+            worldBounds.transform(toWorld);
+            // covered, nothing to draw
+            if (!frustum->isVisible(worldBounds))
+                return true;
+        }
+
+        auto addPatch = [&](uint32 l, uint32 px, uint32 pz)
+        {
+            Real size = mLeafSize * mSpacing * Real(1u << l);
+            patches.push_back({float(px * size), float(pz * size), float(size), float(l)});
+        };
+
+        if (level == 0 || distance > range * range / 4)
+        {
+            addPatch(level, x, z);
+            return true;
+        }
+
+        for (uint32 j = 0; j < 2; ++j)
+        {
+            for (uint32 i = 0; i < 2; ++i)
+            {
+                // drawn at its own level, fully morphed to the resolution of this one
+                if (!selectNode(level - 1, x * 2 + i, z * 2 + j, eye, lodDistance, patches, frustum, toWorld))
+                    addPatch(level - 1, x * 2 + i, z * 2 + j);
+            }
+        }
+        return true;
+    }
+}
@@ -0,0 +1,155 @@
+// This file is part of the OGRE project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at https://www.ogre3d.org/licensing.
+module;
+
+#include <cstddef>
+
+module Ogre.Components.Terrain;
+
+import :TerrainRTShaderSRS;
+import :TerrainTile;
+
+import Ogre.Components.RTShaderSystem;
+import Ogre.Core;
+
+import <format>;
+import <string>;
+import <utility>;
+import <vector>;
+
+#define TERRAIN_LIB_TRANSFORMS "TerrainTransforms"
+#define TERRAIN_LIB_SURFACE "TerrainSurface"
+#define TERRAIN_FUNC_EXPAND_VERTEX "expandCDLODVertex"
+#define TERRAIN_FUNC_SAMPLE_NORMAL "sampleTerrainNormal"
+#define TERRAIN_FUNC_BLEND_LAYER "blendTerrainLayer"
+namespace Ogre {
+    using namespace RTShader;
+
+    namespace {
+        /// Index of the texture unit of a pass with the given name, -1 if it has none
+        auto findTextureUnit(const Pass* pass, std::string_view name) -> int
+        {
+            const TextureUnitState* tus = pass->getTextureUnitState(name);
+            return tus ? int(pass->getTextureUnitStateIndex(tus)) : -1;
+        }
+    }
+
+    std::string_view const constinit TerrainTransforms::Type = "TerrainTransforms";
+    std::string_view const constinit TerrainSurface::Type = "TerrainSurface";
+
+    //-----------------------------------------------------------------------
+    void TerrainTransforms::copyFrom(const SubRenderState& rhs)
+    {
+        const auto& rhsTransforms = static_cast<const TerrainTransforms&>(rhs);
+        mHeightSampler = rhsTransforms.mHeightSampler;
+        mNormalSampler = rhsTransforms.mNormalSampler;
+    }
+    //-----------------------------------------------------------------------
+    auto TerrainTransforms::preAddToRenderState(const RenderState* renderState, Pass* srcPass,
+                                                Pass* dstPass) noexcept -> bool
+    {
+        mHeightSampler = findTextureUnit(dstPass, "TerrainHeight");
+        mNormalSampler = findTextureUnit(dstPass, "TerrainNormal");
+        return mHeightSampler >= 0;
+    }
+    //-----------------------------------------------------------------------
+    auto TerrainTransforms::createCpuSubPrograms(ProgramSet* programSet) -> bool
+    {
+        Program* vsProgram = programSet->getCpuProgram(GpuProgramType::VERTEX_PROGRAM);
+        Function* vsEntry = vsProgram->getEntryPointFunction();
+
+        auto wvpMatrix = vsProgram->resolveParameter(GpuProgramParameters::AutoConstantType::WORLDVIEWPROJ_MATRIX);
+        auto eyePos = vsProgram->resolveParameter(GpuProgramParameters::AutoConstantType::LOD_CAMERA_POSITION_OBJECT_SPACE);
+        auto tileParams =
+            vsProgram->resolveParameter(GpuProgramParameters::AutoConstantType::CUSTOM, TerrainTile::PARAM_TILE);
+        auto lodParams =
+            vsProgram->resolveParameter(GpuProgramParameters::AutoConstantType::CUSTOM, TerrainTile::PARAM_LOD);
+        auto heightMap = vsProgram->resolveParameter(GpuConstantType::SAMPLER2D, "terrainHeightMap", mHeightSampler);
+
+        // grid coordinates in POSITION, the patch per instance
+        auto position = vsEntry->resolveInputParameter(Parameter::Content::POSITION_OBJECT_SPACE);
+        auto patch = vsEntry->resolveInputParameter(Parameter::Content::TEXTURE_COORDINATE1, GpuConstantType::FLOAT4);
+        auto uv = vsEntry->resolveInputParameter(Parameter::Content::TEXTURE_COORDINATE0, GpuConstantType::FLOAT2);
+        auto positionOut = vsEntry->resolveOutputParameter(Parameter::Content::POSITION_PROJECTIVE_SPACE);
+
+        vsProgram->addDependency("FFPLib_Transform");
+        vsProgram->addDependency(TERRAIN_LIB_TRANSFORMS);
+
+        // the object space position, normal and texture coordinates for the stages below
+        auto stage = vsEntry->getStage(std::to_underlying(FFPVertexShaderStage::TRANSFORM));
+        stage.callFunction(TERRAIN_FUNC_EXPAND_VERTEX, {In(heightMap), In(eyePos).xyz(), In(position).xy(), In(patch),
+                                                        In(lodParams).xyz(), In(tileParams).xy(), Out(position),
+                                                        Out(uv)});
+        if (mNormalSampler >= 0)
+        {
+            auto normalMap =
+                vsProgram->resolveParameter(GpuConstantType::SAMPLER2D, "terrainNormalMap", mNormalSampler);
+            auto normal = vsEntry->resolveInputParameter(Parameter::Content::NORMAL_OBJECT_SPACE);
+            stage.callFunction(TERRAIN_FUNC_SAMPLE_NORMAL, {In(normalMap), In(uv), In(tileParams).xy(), Out(normal)});
+        }
+        stage.callFunction("FFP_Transform", wvpMatrix, position, positionOut);
+
+        return true;
+    }
+    //-----------------------------------------------------------------------
+    void TerrainSurface::copyFrom(const SubRenderState& rhs)
+    {
+        const auto& rhsSurface = static_cast<const TerrainSurface&>(rhs);
+        mSplatSampler = rhsSurface.mSplatSampler;
+        mLayerSamplers = rhsSurface.mLayerSamplers;
+    }
+    //-----------------------------------------------------------------------
+    auto TerrainSurface::preAddToRenderState(const RenderState* renderState, Pass* srcPass,
+                                             Pass* dstPass) noexcept -> bool
+    {
+        mSplatSampler = findTextureUnit(dstPass, "TerrainSplat");
+        mLayerSamplers.clear();
+        for (size_t i = 0; i < MAX_LAYERS; ++i)
+        {
+            int layer = findTextureUnit(dstPass, std::format("TerrainLayer{}", i));
+            if (layer < 0)
+                break;
+            mLayerSamplers.push_back(layer);
+        }
+        return mSplatSampler >= 0 && !mLayerSamplers.empty();
+    }
+    //-----------------------------------------------------------------------
+    auto TerrainSurface::createCpuSubPrograms(ProgramSet* programSet) -> bool
+    {
+        Program* vsProgram = programSet->getCpuProgram(GpuProgramType::VERTEX_PROGRAM);
+        Function* vsMain = vsProgram->getEntryPointFunction();
+        Program* psProgram = programSet->getCpuProgram(GpuProgramType::FRAGMENT_PROGRAM);
+        Function* psMain = psProgram->getEntryPointFunction();
+
+        psProgram->addDependency(TERRAIN_LIB_SURFACE);
+
+        // the tile coordinates from TerrainTransforms
+        auto vsInUV = vsMain->resolveInputParameter(Parameter::Content::TEXTURE_COORDINATE0, GpuConstantType::FLOAT2);
+        auto vsOutUV = vsMain->resolveOutputParameter(Parameter::Content::TEXTURE_COORDINATE0, GpuConstantType::FLOAT2);
+        vsMain->getStage(std::to_underlying(FFPVertexShaderStage::TEXTURING)).assign(vsInUV, vsOutUV);
+        auto uv = psMain->resolveInputParameter(vsOutUV);
+
+        auto splatMap = psProgram->resolveParameter(GpuConstantType::SAMPLER2D, "terrainSplatMap", mSplatSampler);
+        auto layerScales =
+            psProgram->resolveParameter(GpuProgramParameters::AutoConstantType::CUSTOM, TerrainTile::PARAM_LAYER_SCALES);
+        auto weights = psMain->resolveLocalParameter(GpuConstantType::FLOAT4, "terrainWeights");
+        auto colour = psMain->resolveLocalParameter(GpuConstantType::FLOAT4, "terrainColour");
+        auto outDiffuse = psMain->resolveOutputParameter(Parameter::Content::COLOR_DIFFUSE);
+
+        auto stage = psMain->getStage(std::to_underlying(FFPFragmentShaderStage::TEXTURING));
+        stage.sampleTexture(splatMap, uv, weights);
+        stage.assign(Vector4{0, 0, 0, 0}, colour);
+        for (size_t i = 0; i < mLayerSamplers.size(); ++i)
+        {
+            auto layer = psProgram->resolveParameter(GpuConstantType::SAMPLER2D, std::format("terrainLayer{}", i),
+                                                     mLayerSamplers[i]);
+            auto channel = Operand::OpMask::X << i;
+            stage.callFunction(TERRAIN_FUNC_BLEND_LAYER, {In(layer), In(uv), In(layerScales).mask(channel),
+                                                          In(weights).mask(channel), InOut(colour)});
+        }
+        stage.mul(In(outDiffuse).xyz(), In(colour).xyz(), Out(outDiffuse).xyz());
+
+        return true;
+    }
+}
@@ -0,0 +1,225 @@
+// This file is part of the OGRE project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at https://www.ogre3d.org/licensing.
+module;
+
+#include <cstddef>
+
+module Ogre.Components.Terrain;
+
+import :TerrainQuadTree;
+import :TerrainTile;
+
+import Ogre.Core;
+
+import <algorithm>;
+import <bit>;
+import <memory>;
+import <utility>;
+import <vector>;
+
+namespace Ogre {
+    //-----------------------------------------------------------------------
+    TerrainGrid::TerrainGrid(uint32 size)
+        : mSize(size)
+    {
+        OgreAssert(std::has_single_bit(size) && size <= 128, "grid size must be a power of two up to 128");
+
+        uint32 verts = size + 1;
+        std::vector<float> vertices;
+        vertices.reserve(size_t(verts) * verts * 2);
+        for (uint32 z = 0; z < verts; ++z)
+        {
+            for (uint32 x = 0; x < verts; ++x)
+            {
+                vertices.push_back(float(x));
+                vertices.push_back(float(z));
+            }
+        }
+
+        // counter clockwise seen from above
+        std::vector<uint16> indices;
+        indices.reserve(size_t(size) * size * 6);
+        for (uint32 z = 0; z < size; ++z)
+        {
+            for (uint32 x = 0; x < size; ++x)
+            {
+                auto v0 = uint16(z * verts + x);
+                auto v1 = uint16(v0 + 1);
+                auto v2 = uint16(v0 + verts);
+                auto v3 = uint16(v2 + 1);
+                indices.insert(indices.end(), {v0, v2, v1, v1, v2, v3});
+            }
+        }
+
+        HardwareBufferManager& mgr = HardwareBufferManager::getSingleton();
+        mVertexBuffer = mgr.createVertexBuffer(sizeof(float) * 2, size_t(verts) * verts, HardwareBuffer::STATIC_WRITE_ONLY);
+        mVertexBuffer->writeData(0, mVertexBuffer->getSizeInBytes(), vertices.data(), true);
+        mIndexBuffer = mgr.createIndexBuffer(HardwareIndexBuffer::IndexType::_16BIT, indices.size(),
+                                             HardwareBuffer::STATIC_WRITE_ONLY);
+        mIndexBuffer->writeData(0, mIndexBuffer->getSizeInBytes(), indices.data(), true);
+    }
+    //-----------------------------------------------------------------------
+    TerrainTile::TerrainTile(std::string_view name)
+        : MovableObject(name)
+    {
+        mMaterial = MaterialManager::getSingleton().getDefaultMaterial();
+        setCastShadows(false);
+        setCustomParameter(PARAM_LAYER_SCALES, Vector4{1, 1, 1, 1});
+    }
+    //-----------------------------------------------------------------------
+    TerrainTile::~TerrainTile() = default;
+    //-----------------------------------------------------------------------
+    void TerrainTile::setHeights(const std::shared_ptr<TerrainGrid>& grid, Real size, uint32 samples,
+                                 std::vector<float> heights)
+    {
+        OgreAssert(grid && heights.size() == size_t(samples) * samples, "samples * samples heights expected");
+
+        mGrid = grid;
+        mSize = size;
+        mSamples = samples;
+        mHeights = std::move(heights);
+        mQuadTree = TerrainQuadTree{mHeights.data(), samples, grid->getSize(), size / Real(samples - 1)};
+
+        mBounds = mQuadTree.getBounds();
+        mBoundingRadius = Math::boundingRadiusFromAABB(mBounds);
+        setCustomParameter(PARAM_TILE, Vector4{size, Real(samples), 0, 0});
+
+        // the shared grid, and the patches of this tile per instance
+        uint32 verts = grid->getSize() + 1;
+        mVertexData = std::make_unique<VertexData>();
+        mVertexData->vertexStart = 0;
+        mVertexData->vertexCount = size_t(verts) * verts;
+
+        VertexDeclaration* decl = mVertexData->vertexDeclaration;
+        decl->addElement(0, 0, VertexElementType::FLOAT2, VertexElementSemantic::POSITION);
+        decl->addElement(1, 0, VertexElementType::FLOAT4, VertexElementSemantic::TEXTURE_COORDINATES, 1);
+        mVertexData->vertexBufferBinding->setBinding(0, grid->getVertexBuffer());
+
+        uint32 leaves = mQuadTree.getNumLeaves();
+        mInstanceBuffer = HardwareBufferManager::getSingleton().createVertexBuffer(
+            sizeof(TerrainQuadTree::Patch), size_t(leaves) * leaves, HardwareBuffer::DYNAMIC_WRITE_ONLY_DISCARDABLE);
+        mInstanceBuffer->setIsInstanceData(true);
+        mInstanceBuffer->setInstanceDataStepRate(1);
+        mVertexData->vertexBufferBinding->setBinding(1, mInstanceBuffer);
+
+        mIndexData = std::make_unique<IndexData>();
+        mIndexData->indexBuffer = grid->getIndexBuffer();
+        mIndexData->indexStart = 0;
+        mIndexData->indexCount = grid->getIndexBuffer()->getNumIndexes();
+
+        mPatches.clear();
+        if (mParentNode)
+            mParentNode->needUpdate();
+    }
+    //-----------------------------------------------------------------------
+    auto TerrainTile::getHeightAt(Real x, Real z) const -> Real
+    {
+        if (mHeights.empty())
+            return 0;
+
+        Real scale = Real(mSamples - 1) / mSize;
+        Real fx = std::clamp(x * scale, Real(0), Real(mSamples - 1));
+        Real fz = std::clamp(z * scale, Real(0), Real(mSamples - 1));
+        uint32 x0 = std::min(uint32(fx), mSamples - 2);
+        uint32 z0 = std::min(uint32(fz), mSamples - 2);
+
+        const float* row0 = &mHeights[size_t(z0) * mSamples + x0];
+        const float* row1 = row0 + mSamples;
+        Real tx = fx - Real(x0);
+        Real tz = fz - Real(z0);
+        return Math::lerp(Math::lerp(Real(row0[0]), Real(row0[1]), tx), Math::lerp(Real(row1[0]), Real(row1[1]), tx), tz);
+    }
+    //-----------------------------------------------------------------------
+    auto TerrainTile::getLodDistance() const -> Real
+    {
+        if (mLodDistance > 0 || !mGrid)
+            return mLodDistance;
+        return mSize / Real(mQuadTree.getNumLeaves()) * 4;
+    }
+    //-----------------------------------------------------------------------
+    void TerrainTile::updatePatches(const Camera* cam)
+    {
+        if (!mGrid)
+        {
+            mPatches.clear();
+            return;
+        }
+
+        const Camera* lodCam = cam->getLodCamera();
+        const Affine3& toWorld = _getParentNodeFullTransform();
+        Vector3 eye = toWorld.inverse() * lodCam->getDerivedPosition();
+        Real range = getLodDistance() * lodCam->getLodBias();
+
+        mQuadTree.select(eye, range, mPatches, cam, toWorld);
+        setCustomParameter(PARAM_LOD, Vector4{range, mMorphStart, Real(mGrid->getSize()), 0});
+
+        if (!mPatches.empty())
+            mInstanceBuffer->writeData(0, mPatches.size() * sizeof(TerrainQuadTree::Patch), mPatches.data(), true);
+    }
+    //-----------------------------------------------------------------------
+    auto TerrainTile::getMovableType() const noexcept -> std::string_view
+    {
+        return TerrainTileFactory::FACTORY_TYPE_NAME;
+    }
+    //-----------------------------------------------------------------------
+    void TerrainTile::_notifyCurrentCamera(Camera* cam)
+    {
+        MovableObject::_notifyCurrentCamera(cam);
+        mCurrentCamera = cam;
+    }
+    //-----------------------------------------------------------------------
+    void TerrainTile::_updateRenderQueue(RenderQueue* queue)
+    {
+        updatePatches(mCurrentCamera);
+        if (mPatches.empty())
+            return;
+
+        if (mRenderQueuePrioritySet)
+            queue->addRenderable(this, mRenderQueueID, mRenderQueuePriority);
+        else if (mRenderQueueIDSet)
+            queue->addRenderable(this, mRenderQueueID);
+        else
+            queue->addRenderable(this);
+    }
+    //-----------------------------------------------------------------------
+    void TerrainTile::visitRenderables(Renderable::Visitor* visitor, bool debugRenderables)
+    {
+        (void)debugRenderables;
+        visitor->visit(this, 0, false);
+    }
+    //-----------------------------------------------------------------------
+    void TerrainTile::getRenderOperation(RenderOperation& op)
+    {
+        op.operationType = RenderOperation::OperationType::TRIANGLE_LIST;
+        op.useIndexes = true;
+        op.useGlobalInstancingVertexBufferIsAvailable = false;
+        op.vertexData = mVertexData.get();
+        op.indexData = mIndexData.get();
+        op.numberOfInstances = uint32(mPatches.size());
+    }
+    //-----------------------------------------------------------------------
+    void TerrainTile::getWorldTransforms(Matrix4* xform) const
+    {
+        *xform = _getParentNodeFullTransform();
+    }
+    //-----------------------------------------------------------------------
+    auto TerrainTile::getSquaredViewDepth(const Camera* cam) const -> Real
+    {
+        return mParentNode->getSquaredViewDepth(cam);
+    }
+    //-----------------------------------------------------------------------
+    std::string_view const constinit TerrainTileFactory::FACTORY_TYPE_NAME = "TerrainTile";
+    //-----------------------------------------------------------------------
+    auto TerrainTileFactory::getType() const noexcept -> std::string_view
+    {
+        return FACTORY_TYPE_NAME;
+    }
+    //-----------------------------------------------------------------------
+    auto TerrainTileFactory::createInstanceImpl(std::string_view name, const NameValuePairList* params)
+        -> MovableObject*
+    {
+        (void)params;
+        return new TerrainTile(name);
+    }
+}
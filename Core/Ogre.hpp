@@ -36,6 +36,8 @@ export import :Any;
 export import :Archive;
 export import :ArchiveFactory;
 export import :ArchiveManager;
+export import :Async;
+export import :AsyncFileReader;
 export import :AutoParamDataSource;
 export import :AxisAlignedBox;
 export import :Billboard;
@@ -45,7 +47,9 @@ export import :BillboardSet;
 export import :Bitwise;
 export import :BlendMode;
 export import :Bone;
+export import :BundleArchive;
 export import :Camera;
+export import :CategoryAllocators;
 export import :Codec;
 export import :ColourValue;
 export import :Common;
@@ -57,6 +61,7 @@ export import :CompositorChain;
 export import :CompositorInstance;
 export import :CompositorLogic;
 export import :CompositorManager;
+export import :CompressedNodeTrack;
 export import :Config;
 export import :ConfigDialog;
 export import :ConfigFile;
@@ -64,6 +69,7 @@ export import :ConfigOptionMap;
 export import :Controller;
 export import :ControllerManager;
 export import :ConvexBody;
+export import :ConvexPolytope;
 export import :CustomCompositionPass;
 export import :DataStream;
 export import :DefaultDebugDrawer;
@@ -83,8 +89,10 @@ export import :ExternalTextureSourceManager;
 export import :FactoryObj;
 export import :FileSystem;
 export import :FileSystemLayer;
+export import :FrameAllocator;
 export import :FrameListener;
 export import :Frustum;
+export import :GpuParticleRenderer;
 export import :GpuProgram;
 export import :GpuProgramManager;
 export import :GpuProgramParams;
@@ -95,11 +103,14 @@ export import :HardwareIndexBuffer;
 export import :HardwareOcclusionQuery;
 export import :HardwarePixelBuffer;
 export import :HardwareVertexBuffer;
+export import :HiZBuffer;
 export import :HighLevelGpuProgram;
+export import :HitchMonitor;
 export import :Image;
 export import :ImageCodec;
 export import :InstanceBatch;
 export import :InstanceBatchHW;
+export import :InstanceBatchHW_GPUCulled;
 export import :InstanceBatchHW_VTF;
 export import :InstanceBatchShader;
 export import :InstanceBatchVTF;
@@ -108,6 +119,7 @@ export import :InstancedEntity;
 export import :IteratorWrapper;
 export import :KeyFrame;
 export import :Light;
+export import :LightGrid;
 export import :LodListener;
 export import :LodStrategy;
 export import :LodStrategyManager;
@@ -122,14 +134,22 @@ export import :Matrix3;
 export import :Matrix4;
 export import :MemoryAllocatorConfig;
 export import :Mesh;
+export import :MeshLayoutOptimiser;
+export import :MeshLodGenerator;
 export import :MeshManager;
+export import :MeshOptimiser;
+export import :MeshQuantiser;
 export import :MeshSerializer;
 export import :MeshSerializerImpl;
+export import :MeshTriangleBVH;
 export import :MovableObject;
 export import :MovablePlane;
 export import :MurmurHash3;
 export import :NameGenerator;
 export import :Node;
+export import :NodeTransformSoA;
+export import :OcclusionCulling;
+export import :OctreeSceneManager;
 export import :OptimisedUtil;
 export import :Particle;
 export import :ParticleAffector;
@@ -184,13 +204,16 @@ export import :SceneManager;
 export import :SceneManagerEnumerator;
 export import :SceneNode;
 export import :SceneQuery;
+export import :SceneSerializer;
 export import :ScriptCompiler;
 export import :ScriptLoader;
 export import :ScriptTranslator;
 export import :Serializer;
+export import :ShaderTelemetry;
 export import :ShadowCameraSetup;
 export import :ShadowCameraSetupFocused;
 export import :ShadowCameraSetupLiSPSM;
+export import :ShadowCameraSetupPSSM;
 export import :ShadowCaster;
 export import :SharedPtr;
 export import :SimpleRenderable;
@@ -200,8 +223,12 @@ export import :Skeleton;
 export import :SkeletonFileFormat;
 export import :SkeletonInstance;
 export import :SkeletonManager;
+export import :SkeletonPoseCache;
 export import :SkeletonSerializer;
+export import :SkinnedVertexCache;
+export import :SoftwareOcclusionCulling;
 export import :Sphere;
+export import :StartupProfiler;
 export import :StaticGeometry;
 export import :StdHeaders;
 export import :StreamSerialiser;
@@ -213,8 +240,10 @@ export import :SubEntity;
 export import :SubMesh;
 export import :TagPoint;
 export import :TangentSpaceCalc;
+export import :TaskScheduler;
 export import :Technique;
 export import :Texture;
+export import :TextureArrayPacker;
 export import :TextureManager;
 export import :TextureUnitState;
 export import :Timer;
@@ -224,5 +253,6 @@ export import :Vector;
 export import :VertexBoneAssignment;
 export import :VertexIndexData;
 export import :Viewport;
+export import :VisibilityStage;
 export import :WorkQueue;
 export import :Zip;
@@ -243,8 +243,9 @@ class VertexData;
           other animations.
         @param scale The scale to apply to translations and scalings, useful for 
             adapting an animation to a different size target.
+        @param keyIndexHint Optional keyframe cursor of the caller, see _getTimeIndex.
         */
-        void apply(Real timePos, Real weight = 1.0, Real scale = 1.0f);
+        void apply(Real timePos, Real weight = 1.0, Real scale = 1.0f, uint* keyIndexHint = nullptr);
 
         /** Applies all node tracks given a specific time point and weight to the specified node.
         @remarks
@@ -269,8 +270,10 @@ class VertexData;
             other animations.
         @param scale The scale to apply to translations and scalings, useful for 
             adapting an animation to a different size target.
+        @param keyIndexHint Optional keyframe cursor of the caller, see _getTimeIndex.
         */
-        void apply(Skeleton* skeleton, Real timePos, Real weight = 1.0, Real scale = 1.0f);
+        void apply(Skeleton* skeleton, Real timePos, Real weight = 1.0, Real scale = 1.0f,
+                   uint* keyIndexHint = nullptr);
 
         /** Applies all node tracks given a specific time point and weight to a given skeleton.
         @remarks
@@ -284,9 +287,10 @@ class VertexData;
             be modulated with the weight factor.
         @param scale The scale to apply to translations and scalings, useful for 
             adapting an animation to a different size target.
+        @param keyIndexHint Optional keyframe cursor of the caller, see _getTimeIndex.
         */
         void apply(Skeleton* skeleton, Real timePos, float weight,
-          const AnimationState::BoneBlendMask* blendMask, Real scale);
+          const AnimationState::BoneBlendMask* blendMask, Real scale, uint* keyIndexHint = nullptr);
 
         /** Applies all vertex tracks given a specific time point and weight to a given entity.
         @param entity The Entity to which this animation should be applied
@@ -295,9 +299,10 @@ class VertexData;
             (only affects pose animation)
         @param software Whether to populate the software morph vertex data
         @param hardware Whether to populate the hardware morph vertex data
+        @param keyIndexHint Optional keyframe cursor of the caller, see _getTimeIndex.
         */
         void apply(Entity* entity, Real timePos, Real weight, bool software, 
-            bool hardware);
+            bool hardware, uint* keyIndexHint = nullptr);
 
         /** Applies all numeric tracks given a specific time point and weight to the specified animable value.
         @remarks
@@ -455,11 +460,16 @@ class VertexData;
             the animation object, if the animation object altered (e.g. create/remove
             keyframe or track), all related time index will invalidated.
         @param timePos The time position.
+        @param keyIndexHint Optional cursor holding the index found by the previous
+            call, e.g. AnimationState::_getKeyIndexHint. If the time is still within,
+            or has moved on to the next, keyframe interval the index is found without
+            searching, which is the common case for sequential playback. Receives the
+            new index.
         @return The time index object which contains wrapped time position (in
             relation to the whole animation sequence) and lower bound index of
             global keyframe time list.
         */
-        auto _getTimeIndex(Real timePos) const -> TimeIndex;
+        auto _getTimeIndex(Real timePos, uint* keyIndexHint = nullptr) const -> TimeIndex;
         
         /** Sets a base keyframe which for the skeletal / pose keyframes 
             in this animation. 
@@ -498,6 +508,13 @@ class VertexData;
         
         /// Internal method to adjust keyframes relative to a base keyframe (@see setUseBaseKeyFrame) */
         void _applyBaseKeyFrame();
+
+        /** Internal method to build all lazily cached data used by apply.
+        @remarks
+            Afterwards the animation can be applied from several threads at once, as long
+            as each applies it to a different target.
+        */
+        void _prepareForApply();
         
         void _notifyContainer(AnimationContainer* c);
         /** Retrieve the container of this animation. */
@@ -136,6 +136,12 @@ class AnimationStateSet;
         /// Get the parent animation state set
         [[nodiscard]] auto getParent() const noexcept -> AnimationStateSet* { return mParent; }
 
+        /** Gets the keyframe cursor used to speed up the keyframe search.
+        @remarks
+            Internal, passed to Animation::apply by the users of this state.
+        */
+        [[nodiscard]] auto _getKeyIndexHint() const noexcept -> uint* { return &mKeyIndexHint; }
+
       /** @brief Create a new blend mask with the given number of entries
        *
        * In addition to assigning a single weight value to a skeletal animation,
@@ -188,6 +194,8 @@ class AnimationStateSet;
         Real mWeight;
         bool mEnabled;
         bool mLoop;
+        /// Global keyframe index found by the last lookup
+        mutable uint mKeyIndexHint{0};
 
     };
 
@@ -31,6 +31,7 @@ module;
 
 export module Ogre.Core:AnimationTrack;
 
+export import :CompressedNodeTrack;
 export import :MemoryAllocatorConfig;
 export import :Platform;
 export import :Pose;
@@ -41,6 +42,7 @@ export import :SimpleSpline;
 
 export import <algorithm>;
 export import <memory>;
+export import <span>;
 export import <vector>;
 
 export
@@ -191,6 +193,18 @@ class VertexMorphKeyFrame;
         virtual auto getKeyFramesAtTime(const TimeIndex& timeIndex, KeyFrame** keyFrame1, KeyFrame** keyFrame2,
             unsigned short* firstKeyIndex = nullptr) const -> Real;
 
+        /** Gets the indices of the 2 KeyFrame objects which are active at the time given.
+        @remarks
+            As getKeyFramesAtTime, but only searches the contiguous keyframe time
+            list, so that subclasses can interpolate packed keyframe data.
+        @param timeIndex The time index.
+        @param index1 Receives the index of the keyframe just before or at this time index.
+        @param index2 Receives the index of the keyframe just after this time index.
+        @return Parametric value indicating how far along the gap between the 2 keyframes the timeIndex
+            value is, in the range 0.0 <= returnValue < 1.0 .
+        */
+        auto getKeyFrameIndicesAtTime(const TimeIndex& timeIndex, size_t* index1, size_t* index2) const -> Real;
+
         /** Creates a new KeyFrame and adds it to this animation at the given time index.
         @remarks
             It is better to create KeyFrames in time order. Creating them out of order can result 
@@ -259,6 +273,8 @@ class VertexMorphKeyFrame;
         /// Map used to translate global keyframe time lower bound index to local lower bound index
         using KeyFrameIndexMap = std::vector<ushort>;
         KeyFrameIndexMap mKeyFrameIndexMap;
+        /// Times of mKeyFrames, stored contiguously for searching
+        std::vector<Real> mKeyFrameTimes;
 
         /// Create a keyframe implementation - must be overridden
         virtual auto createKeyFrameImpl(Real time) -> KeyFrame* = 0;
@@ -271,6 +287,13 @@ class VertexMorphKeyFrame;
 
         /// Internal method for clone implementation
         virtual void populateClone(AnimationTrack* clone) const;
+
+        /** Creates keyframes at the given times after the existing ones, notifying once.
+        @remarks
+            The times have to be ascending and not before the last keyframe, so they are
+            appended without searching for their place.
+        */
+        void appendKeyFrames(std::span<const Real> times);
     };
 
     /** Specialised AnimationTrack for dealing with generic animable values.
@@ -354,6 +377,21 @@ class VertexMorphKeyFrame;
         @param timePos The time from which this KeyFrame will apply.
         */
         virtual auto createNodeKeyFrame(Real timePos) -> TransformKeyFrame*;
+
+        /** Creates keyframes from contiguous arrays, as read by the SkeletonSerializer.
+        @remarks
+            Same as calling createNodeKeyFrame and setting the transform for every key, but the
+            keyframes are appended without searching and the animation is notified once. On an
+            empty track the arrays become the packed transforms interpolated by apply, instead of
+            being collected from the keyframes again. The times have to be ascending and not
+            before the last keyframe.
+        @param times The time of every key
+        @param translates The translation of every key
+        @param rotates The rotation of every key
+        @param scales The scale of every key, or empty for unit scales
+        */
+        void _appendKeyFrames(std::span<const Real> times, std::vector<Vector3> translates,
+                              std::vector<Quaternion> rotates, std::vector<Vector3> scales);
         /** Returns a pointer to the associated Node object (if any). */
         virtual auto getAssociatedNode() const noexcept -> Node*;
 
@@ -364,6 +402,15 @@ class VertexMorphKeyFrame;
         virtual void applyToNode(Node* node, const TimeIndex& timeIndex, Real weight = 1.0, 
             Real scale = 1.0f);
 
+        /** As applyToNode, but accumulates into a detached local transform.
+        @remarks
+            The result is the same as calling applyToNode on a node holding the given
+            transform, without touching the node or triggering its update notifications.
+            Used to blend several animations into a pose buffer before writing it out.
+        */
+        void applyToTransform(const TimeIndex& timeIndex, Real weight, Real scale,
+            Vector3& position, Quaternion& orientation, Vector3& nodeScale) const;
+
         /** Sets the method of rotation calculation */
         virtual void setUseShortestRotationPath(bool useShortestPath);
 
@@ -392,16 +439,49 @@ class VertexMorphKeyFrame;
         /** Optimise the current track by removing any duplicate keyframes. */
         void optimise() override;
 
+        /** Replaces the keyframes by a CompressedNodeTrack.
+        @remarks
+            The keyframes are destroyed, so getNumKeyFrames returns 0 afterwards and
+            no keyframes can be created until decompress is called. The track is
+            still applied as before, within the given tolerance. Any base keyframe
+            of the animation has to be applied first, see Animation::_applyBaseKeyFrame.
+            Does nothing if there are no keyframes.
+        @param tolerance The largest error allowed, e.g. larger for bones far from the root
+        */
+        void compress(const CompressedNodeTrack::Tolerance& tolerance = {});
+
+        /** Recreates keyframes from the compressed representation.
+        @remarks
+            A keyframe is created at every key time of the compressed curves.
+        */
+        void decompress();
+
+        /** Gets the compressed representation, @c nullptr unless compress was called. */
+        [[nodiscard]] auto getCompressed() const noexcept -> const CompressedNodeTrack* { return mCompressed.get(); }
+
         /** Clone this track (internal use only) */
         auto _clone(Animation* newParent) const -> NodeAnimationTrack*;
         
         void _applyBaseKeyFrame(const KeyFrame* base) override;
+
+        /// Builds the lazily cached interpolation data, see Animation::_prepareForApply
+        void _prepareForApply() const;
         
     private:
         /// Specialised keyframe creation
         auto createKeyFrameImpl(Real time) -> KeyFrame* override;
         // Flag indicating we need to rebuild the splines next time
         virtual void buildInterpolationSplines() const;
+        /// Copies the keyframe transforms into mPackedKeyFrames
+        void buildPackedKeyFrames() const;
+
+        /// The transforms of all keyframes by component, in keyframe order
+        struct PackedKeyFrames
+        {
+            std::vector<Vector3> translate;
+            std::vector<Quaternion> rotate;
+            std::vector<Vector3> scale;
+        };
 
         // Struct for store splines, allocate on demand for better memory footprint
         struct Splines
@@ -417,6 +497,11 @@ class VertexMorphKeyFrame;
         Node* mTargetNode;
         // Prebuilt splines, must be mutable since lazy-update in const method
         mutable ::std::unique_ptr<Splines> mSplines;
+        // Packed keyframe data, must be mutable since lazy-update in const method
+        mutable PackedKeyFrames mPackedKeyFrames;
+        mutable bool mPackedBuildNeeded{true};
+        // Replaces the keyframes once compressed
+        ::std::unique_ptr<CompressedNodeTrack> mCompressed;
     };
 
     /** Type of vertex animation.
@@ -583,7 +668,7 @@ class VertexMorphKeyFrame;
         auto createKeyFrameImpl(Real time) -> KeyFrame* override;
 
         /// Utility method for applying pose animation
-        void applyPoseToVertexData(const Pose* pose, VertexData* data, Real influence);
+        void applyPoseToVertexData(ushort poseIndex, const Pose* pose, VertexData* data, Real influence);
 
 
     };
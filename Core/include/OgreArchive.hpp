@@ -74,6 +74,16 @@ class Archive;
     using FileInfoList = std::vector<FileInfo>;
     using FileInfoListPtr = SharedPtr<FileInfoList>;
 
+    /// A resource an archive declares, see Archive::getResourceDeclarations
+    struct ArchiveResourceDeclaration {
+        /// The name of the resource
+        std::string name;
+        /// The type of the resource, as registered by its ResourceManager
+        std::string resourceType;
+    };
+
+    using ArchiveResourceDeclarationList = std::vector<ArchiveResourceDeclaration>;
+
     /** Archive-handling class.
     @remarks
         An archive is a generic term for a container of files. This may be a
@@ -222,6 +232,14 @@ class Archive;
         [[nodiscard]] virtual auto findFileInfo(std::string_view pattern, 
             bool recursive = true, bool dirs = false) const -> FileInfoListPtr = 0;
 
+        /** Gets the resources the archive declares.
+        @remarks
+            Prebuilt archives can record which resources their files provide, so
+            ResourceGroupManager::addResourceLocation can declare them without
+            inspecting the files. None by default.
+        */
+        [[nodiscard]] virtual auto getResourceDeclarations() const -> ArchiveResourceDeclarationList { return {}; }
+
         /// Return the type code of this Archive
         [[nodiscard]] auto getType() const noexcept -> std::string_view { return mType; }
         
@@ -0,0 +1,265 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+module;
+
+#include <cstddef>
+
+export module Ogre.Core:Async;
+
+export import :Exception;
+export import :MemoryAllocatorConfig;
+export import :Prerequisites;
+export import :Resource;
+export import :ResourceBackgroundQueue;
+export import :SharedPtr;
+
+export import <coroutine>;
+export import <exception>;
+export import <functional>;
+export import <map>;
+export import <memory>;
+export import <optional>;
+export import <utility>;
+
+export
+namespace Ogre {
+
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Resources
+    *  @{
+    */
+    /** Lets the owner of an asynchronous operation give up on it.
+    @remarks
+        Copies share their state, so the token can be handed to any number of
+        operations and all of them are cancelled together. Cancelling resumes the
+        coroutines awaiting these operations from within cancel.
+    @note
+        Tokens are not thread safe, use them on the main thread only.
+    */
+    class CancellationToken
+    {
+    public:
+        using CallbackID = size_t;
+
+        CancellationToken() : mState(std::make_shared<State>()) {}
+
+        /// Cancels the operations using the token, does nothing if it already is
+        void cancel() const;
+        [[nodiscard]] auto isCancelled() const noexcept -> bool { return mState->cancelled; }
+
+        /// Registers a function called on cancel, immediately if it already is
+        auto _addCallback(std::function<void()> callback) const -> CallbackID;
+        void _removeCallback(CallbackID id) const;
+
+    private:
+        struct State
+        {
+            bool cancelled{false};
+            CallbackID nextID{0};
+            std::map<CallbackID, std::function<void()>> callbacks;
+        };
+        std::shared_ptr<State> mState;
+    };
+
+    template <typename T> class Async;
+
+    /// Storage of the result of an Async
+    template <typename T> struct AsyncResult
+    {
+        std::optional<T> value;
+
+        void return_value(T v) { value.emplace(std::move(v)); }
+        auto take() -> T { return std::move(*value); }
+    };
+    template <> struct AsyncResult<void>
+    {
+        void return_void() noexcept {}
+        void take() noexcept {}
+    };
+
+    /** A coroutine, e.g. streaming in the resources of a level, returning T.
+    @remarks
+        The coroutine starts running when called and runs until the first co_await
+        which has to wait, where the caller continues. It is resumed wherever the
+        awaited operation completes, on the main thread for the ResourceAwaiter of
+        ResourceManager::loadAsync. Poll isReady from code which is no coroutine, or
+        co_await the Async from another coroutine, which then continues where this
+        one returns.
+    @par
+        Destroying an Async which is not finished detaches it: the coroutine runs to
+        its end and destroys itself, its result discarded.
+    */
+    template <typename T = void> class Async
+    {
+    public:
+        struct promise_type : AsyncResult<T>
+        {
+            std::coroutine_handle<> continuation;
+            std::exception_ptr exception;
+            bool detached{false};
+
+            auto get_return_object() -> Async { return Async{std::coroutine_handle<promise_type>::from_promise(*this)}; }
+            auto initial_suspend() noexcept -> std::suspend_never { return {}; }
+            auto final_suspend() noexcept
+            {
+                struct FinalAwaiter
+                {
+                    auto await_ready() noexcept -> bool { return false; }
+                    auto await_suspend(std::coroutine_handle<promise_type> h) noexcept -> std::coroutine_handle<>
+                    {
+                        promise_type& promise = h.promise();
+                        if (promise.detached)
+                        {
+                            h.destroy();
+                            return std::noop_coroutine();
+                        }
+                        return promise.continuation ? promise.continuation : std::noop_coroutine();
+                    }
+                    void await_resume() noexcept {}
+                };
+                return FinalAwaiter{};
+            }
+            void unhandled_exception() noexcept { exception = std::current_exception(); }
+        };
+
+        Async(Async&& rhs) noexcept : mHandle(std::exchange(rhs.mHandle, {})) {}
+        auto operator=(Async&& rhs) noexcept -> Async&
+        {
+            if (this != &rhs)
+            {
+                release();
+                mHandle = std::exchange(rhs.mHandle, {});
+            }
+            return *this;
+        }
+        ~Async() { release(); }
+
+        /// Whether the coroutine has returned
+        [[nodiscard]] auto isReady() const noexcept -> bool { return !mHandle || mHandle.done(); }
+
+        /** Gets the result of a finished coroutine, rethrowing what escaped it.
+        @remarks
+            The result is moved out, so call this once.
+        */
+        auto get() -> T
+        {
+            OgreAssert(mHandle && mHandle.done(), "the coroutine has not returned yet");
+            promise_type& promise = mHandle.promise();
+            if (promise.exception)
+                std::rethrow_exception(promise.exception);
+            return promise.take();
+        }
+
+        auto await_ready() const noexcept -> bool { return isReady(); }
+        void await_suspend(std::coroutine_handle<> awaiting) noexcept { mHandle.promise().continuation = awaiting; }
+        auto await_resume() -> T { return get(); }
+
+    private:
+        explicit Async(std::coroutine_handle<promise_type> handle) : mHandle(handle) {}
+
+        void release() noexcept
+        {
+            if (!mHandle)
+                return;
+            if (mHandle.done())
+                mHandle.destroy();
+            else
+                mHandle.promise().detached = true;
+            mHandle = {};
+        }
+
+        std::coroutine_handle<promise_type> mHandle;
+    };
+
+    /** Awaits a resource being prepared or loaded through the ResourceBackgroundQueue.
+    @remarks
+        Returned by ResourceManager::loadAsync and prepareAsync. The request is queued
+        when awaited, unless the resource is loaded already, and the coroutine is
+        resumed on the main thread once the queue reports its completion.
+    @par
+        co_await yields the resource, or @c nullptr if the token was cancelled before
+        the request completed, in which case a request still waiting is dropped. A
+        failed request throws an Exception with its message.
+    */
+    class ResourceRequestAwaiter : public ResourceBackgroundQueue::Listener
+    {
+    public:
+        ResourceRequestAwaiter(bool load, std::string_view type, std::string_view name, std::string_view group,
+                               CancellationToken token);
+        ~ResourceRequestAwaiter() override;
+
+        ResourceRequestAwaiter(const ResourceRequestAwaiter&) = delete;
+        auto operator=(const ResourceRequestAwaiter&) -> ResourceRequestAwaiter& = delete;
+
+        auto await_ready() -> bool;
+        auto await_suspend(std::coroutine_handle<> awaiting) -> bool;
+        auto await_resume() -> ResourcePtr;
+
+        void operationCompleted(BackgroundProcessTicket ticket, const BackgroundProcessResult& result) override;
+
+    private:
+        enum class State
+        {
+            IDLE,
+            /// Queued, the coroutine not suspended yet
+            QUEUEING,
+            /// Queued, the coroutine suspended
+            WAITING,
+            DONE
+        };
+
+        bool mLoad;
+        String mType;
+        String mName;
+        String mGroup;
+        CancellationToken mToken;
+        std::optional<CancellationToken::CallbackID> mCancelCallback;
+
+        State mState{State::IDLE};
+        BackgroundProcessTicket mTicket{0};
+        std::coroutine_handle<> mAwaiting;
+        std::optional<String> mError;
+
+        /// Looks the resource up, whether the request is needed
+        auto isComplete() const -> bool;
+        void finish();
+    };
+
+    /** A ResourceRequestAwaiter yielding the resource as a T. */
+    template <typename T> class ResourceAwaiter : public ResourceRequestAwaiter
+    {
+    public:
+        using ResourceRequestAwaiter::ResourceRequestAwaiter;
+
+        auto await_resume() -> SharedPtr<T> { return static_pointer_cast<T>(ResourceRequestAwaiter::await_resume()); }
+    };
+    /** @} */
+    /** @} */
+}
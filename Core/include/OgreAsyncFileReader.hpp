@@ -0,0 +1,166 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+module;
+
+#include <cstddef>
+
+export module Ogre.Core:AsyncFileReader;
+
+export import :MemoryAllocatorConfig;
+export import :Platform;
+export import :Prerequisites;
+
+export import <deque>;
+export import <filesystem>;
+export import <vector>;
+
+export
+namespace Ogre {
+
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Resources
+    *  @{
+    */
+    /** Issues many file reads at once and reports their completion later.
+    @remarks
+        DataStream reads block the calling thread until the data has arrived.
+        This class instead queues reads and lets the storage device process
+        them in parallel, so a single thread can keep it busy while streaming.
+        The reads are submitted with io_uring. Where it is not available, e.g.
+        on older kernels or in sandboxes which forbid it, every read is
+        performed synchronously by read() and completes on the next poll().
+    @par
+        At most the queue depth given on construction is submitted to the kernel
+        at a time, further reads wait in submission order until a slot is free.
+        The destination buffers must stay valid until the read has completed.
+    @note
+        An instance is not thread safe, it is meant to be owned by one thread.
+    */
+    class AsyncFileReader : public StreamAlloc
+    {
+    public:
+        /// Default number of reads in flight
+        static constexpr uint32 DEFAULT_QUEUE_DEPTH = 64;
+
+        /// A finished read
+        struct Completion
+        {
+            /// The value passed to read()
+            uint64 userData;
+            /// Number of bytes read, less than requested at the end of the file
+            size_t bytesRead;
+            /// The errno value of a failed read, 0 on success
+            int error;
+        };
+
+        /** Creates the reader.
+        @param queueDepth Maximum number of reads submitted at a time
+        */
+        explicit AsyncFileReader(uint32 queueDepth = DEFAULT_QUEUE_DEPTH);
+        ~AsyncFileReader();
+
+        AsyncFileReader(const AsyncFileReader&) = delete;
+        auto operator=(const AsyncFileReader&) -> AsyncFileReader& = delete;
+
+        /** Opens a file for reading.
+        @return The file handle to pass to read(), or -1 if the file can not be opened
+        */
+        auto openFile(const std::filesystem::path& path) -> int;
+
+        /** Closes a file.
+        @remarks
+            The file must not have any reads outstanding.
+        */
+        void closeFile(int file);
+
+        /** Queues a read.
+        @param file The handle returned by openFile
+        @param offset Position in the file to read from
+        @param buf Destination of the data, valid until the read has completed
+        @param count Number of bytes to read
+        @param userData Value identifying the read in its Completion
+        */
+        void read(int file, uint64 offset, void* buf, size_t count, uint64 userData);
+
+        /** Collects the finished reads.
+        @param completions The finished reads are appended to this
+        @param wait Whether to block until at least one read has finished, if
+            any is outstanding
+        @return The number of completions appended
+        */
+        auto poll(std::vector<Completion>& completions, bool wait = false) -> size_t;
+
+        /// Gets the number of reads which have not been reported by poll() yet
+        [[nodiscard]] auto getNumOutstanding() const noexcept -> size_t
+        {
+            return mNumInFlight + mBacklog.size() + mCompleted.size();
+        }
+
+        /// Whether reads are processed asynchronously by io_uring
+        [[nodiscard]] auto isAsynchronous() const noexcept -> bool { return mRingFd >= 0; }
+
+    private:
+        struct Request
+        {
+            int file;
+            uint64 offset;
+            void* buf;
+            uint32 count;
+            uint64 userData;
+        };
+
+        uint32 mQueueDepth;
+        size_t mNumInFlight{0};
+        /// Reads waiting for a free submission slot
+        std::deque<Request> mBacklog;
+        /// Reads performed synchronously, without io_uring
+        std::vector<Completion> mCompleted;
+
+        int mRingFd{-1};
+        void* mRingMemory[3]{};
+        size_t mRingSize[3]{};
+        uint32* mSqHead{nullptr};
+        uint32* mSqTail{nullptr};
+        uint32* mSqMask{nullptr};
+        uint32* mSqArray{nullptr};
+        uint32* mCqHead{nullptr};
+        uint32* mCqTail{nullptr};
+        uint32* mCqMask{nullptr};
+        void* mSqes{nullptr};
+        void* mCqes{nullptr};
+
+        auto setupRing() -> bool;
+        void destroyRing();
+        /// Moves reads from the backlog to the ring
+        void submit(uint32 minComplete);
+    };
+    /** @} */
+    /** @} */
+}
@@ -42,6 +42,9 @@ export import :Prerequisites;
 export import :SceneNode;
 export import :Vector;
 
+export import <span>;
+export import <utility>;
+
 export
 namespace Ogre {
 
@@ -133,9 +136,14 @@ class Viewport;
         const Renderable* mCurrentRenderable{nullptr};
         const Camera* mCurrentCamera{nullptr};
         bool mCameraRelativeRendering{false};
+        bool mLargeWorldRendering{false};
         Vector3 mCameraRelativePosition;
+        /// mCameraRelativePosition in double precision, for large world rendering
+        Vector3d mCameraRelativePositionDouble{0.0, 0.0, 0.0};
         const LightList* mCurrentLightList{nullptr};
         const Frustum* mCurrentTextureProjector[OGRE_MAX_SIMULTANEOUS_LIGHTS];
+        /// Part of the texture each projector renders to, see setTextureProjector
+        Vector4 mTextureProjectorTile[OGRE_MAX_SIMULTANEOUS_LIGHTS];
         const RenderTarget* mCurrentRenderTarget{nullptr};
         const Viewport* mCurrentViewport{nullptr};
         const SceneManager* mCurrentSceneManager{nullptr};
@@ -144,18 +152,78 @@ class Viewport;
 
         SceneNode mDummyNode;
         Light mBlankLight;
+
+        /// One per Source
+        uint64 mSourceVersions[5];
+        /// Shared by all instances, so versions of different instances never compare equal
+        static uint64 msLastVersion;
+        mutable size_t mAutoConstantsUpdated{0};
+        mutable size_t mAutoConstantsSkipped{0};
     public:
+        /** The inputs the auto constants are derived from, see getSourceVersion. */
+        enum class Source : uint8
+        {
+            /// The camera
+            CAMERA,
+            /// The renderable and its world matrices
+            WORLD,
+            /// The light list
+            LIGHTS,
+            /// The pass and pass number
+            PASS,
+            /// Everything else, e.g. the viewport, render target, fog or texture projectors
+            OTHER
+        };
+
         AutoParamDataSource();
+
+        /** Gets the version of a source, which changes whenever any of its setters is called.
+        @remarks
+            Versions are drawn from one counter shared by all instances, see getLastVersion.
+            GpuProgramParameters::_updateAutoParams uses them to skip recomputing auto
+            constants none of whose sources changed since they were last written.
+        */
+        [[nodiscard]] auto getSourceVersion(Source source) const -> uint64 { return mSourceVersions[std::to_underlying(source)]; }
+        /// Gets the latest version handed out to any source
+        [[nodiscard]] static auto getLastVersion() noexcept -> uint64 { return msLastVersion; }
+
+        /// Counts auto constants which were recomputed or skipped by GpuProgramParameters::_updateAutoParams
+        void _notifyAutoConstantUpdates(size_t updated, size_t skipped) const
+        {
+            mAutoConstantsUpdated += updated;
+            mAutoConstantsSkipped += skipped;
+        }
+        /// Gets the counts of the recomputed and skipped auto constants, and resets them
+        auto _takeAutoConstantCounts() -> std::pair<size_t, size_t>
+        {
+            return {std::exchange(mAutoConstantsUpdated, 0), std::exchange(mAutoConstantsSkipped, 0)};
+        }
         /** Updates the current renderable */
         void setCurrentRenderable(const Renderable* rend);
         /** Sets the world matrices, avoid query from renderable again */
         void setWorldMatrices(const Affine3* m, size_t count);
-        /** Updates the current camera */
-        void setCurrentCamera(const Camera* cam, bool useCameraRelative);
+        /** Updates the current camera
+        @param largeWorld Whether camera relative world matrices are made from the double
+            precision node positions, see SceneManager::setLargeWorldRendering
+        */
+        void setCurrentCamera(const Camera* cam, bool useCameraRelative, bool largeWorld = false);
+        /** Makes the world matrices of a renderable relative to the current camera, if camera relative.
+        @remarks
+            Done to the matrices of every renderable as they are fetched, also by the SceneManager
+            for those it prepares in bulk. With large world rendering, the translation of the
+            node of the renderable is replaced by its double precision position relative to the
+            camera, leaving only the offset of the matrices from the node in single precision.
+        */
+        void makeCameraRelative(const Renderable* rend, Affine3* matrices, size_t count) const;
         /** Sets the light list that should be used, and it's base index from the global list */
         void setCurrentLightList(const LightList* ll);
         /** Sets the current texture projector for a index */
         void setTextureProjector(const Frustum* frust, size_t index);
+        /** Sets the current texture projector for a index, rendering to a part of the texture.
+        @param tile Left, top, width and height of the part in texture coordinates, which
+            the texture matrices of the projector map to
+        */
+        void setTextureProjector(const Frustum* frust, size_t index, const Vector4& tile);
         /** Sets the current render target */
         void setCurrentRenderTarget(const RenderTarget* target);
         /** Sets the current viewport */
@@ -187,6 +255,26 @@ class Viewport;
         auto getInverseViewMatrix() const noexcept -> const Affine3&;
         auto getInverseTransposeWorldMatrix() const noexcept -> const Matrix4&;
         auto getInverseTransposeWorldViewMatrix() const noexcept -> const Matrix4&;
+
+        /** Matrices derived from one world matrix, see computeDerivedMatrices. */
+        struct DerivedMatrices
+        {
+            Affine3 worldView;
+            Matrix4 worldViewProj;
+            /// The normal matrix
+            Matrix4 inverseTransposeWorldView;
+        };
+        /** Computes the derived matrices of many world matrices in one pass.
+        @remarks
+            Gives the same results as getWorldViewMatrix, getWorldViewProjMatrix and
+            getInverseTransposeWorldViewMatrix for renderables using neither an identity view
+            nor projection, including camera relative rendering. The camera matrices are set up
+            once for the whole array and the cached per renderable state is left untouched, so
+            constant or instance buffers can be filled in bulk while any renderable is current.
+        @param worldMatrices The world matrices, as returned by Renderable::getWorldTransforms
+        @param out Receives the matrices, at least as many as worldMatrices
+        */
+        void computeDerivedMatrices(std::span<const Affine3> worldMatrices, std::span<DerivedMatrices> out) const;
         auto getCameraPosition() const noexcept -> const Vector4&;
         auto getCameraPositionObjectSpace() const noexcept -> const Vector4&;
         auto  getCameraRelativePosition() const -> const Vector4;
@@ -282,6 +370,11 @@ class Viewport;
         void setPassNumber(const int passNumber);
         void incPassNumber();
         void updateLightCustomGpuParameter(const GpuProgramParameters::AutoConstantEntry& constantEntry, GpuProgramParameters *params) const;
+
+    private:
+        /// Inverts the y axis of the projection, if the render target requires texture flipping
+        void applyTextureFlipping(Matrix4& proj) const;
+        void markChanged(Source source) { mSourceVersions[std::to_underlying(source)] = ++msLastVersion; }
     };
     /** @} */
     /** @} */
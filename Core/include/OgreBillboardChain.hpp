@@ -216,6 +216,27 @@ class VertexData;
             for dynamic alteration.
         */
         virtual auto getDynamic() const noexcept -> bool { return mDynamic; }
+
+        /** Sets whether only changed elements are written to the vertex buffer. (default: off)
+        @remarks
+            Normally every element is expanded into its two vertices on the CPU and the
+            whole buffer is uploaded again whenever anything changed or another camera
+            renders the chain, since camera facing segments depend on the camera position.
+            With incremental updates the vertex buffer is used as the same ring as the
+            elements: each vertex holds the element position and an extra float4 texture
+            coordinate 1 with the chain tangent and the signed half width, and the vertex
+            program moves it perpendicular to the tangent and the view direction. Adding
+            an element to the head or removing one from the tail then only writes the
+            affected element and its neighbours.
+        @par
+            The material must do the expansion, e.g. with the RTSS `transform_stage chain`.
+            Non camera facing segments are expanded on the CPU as before with a zero
+            expansion vector, so they work with the same material. Changing all elements,
+            e.g. by fading a RibbonTrail, still writes all of them.
+        */
+        void setIncrementalUpdatesEnabled(bool enabled);
+        /// Gets whether only changed elements are written to the vertex buffer
+        [[nodiscard]] auto getIncrementalUpdatesEnabled() const noexcept -> bool { return mIncrementalUpdates; }
         
         /** Add an element to the 'head' of a chain.
         @remarks
@@ -321,6 +342,11 @@ class VertexData;
         bool mIndexContentDirty{true};
         /// Is the vertex buffer dirty?
         bool mVertexContentDirty{true};
+        /// Write only the changed elements, see setIncrementalUpdatesEnabled
+        bool mIncrementalUpdates{false};
+        /// Buffer slots of the elements changed since the last update, if incremental
+        std::vector<size_t> mDirtyElements;
+        std::vector<bool> mElementDirty;
         /// AABB
         mutable AxisAlignedBox mAABB;
         /// Bounding radius
@@ -374,6 +400,13 @@ class VertexData;
         /// Update the contents of the index buffer
         virtual void updateIndexBuffer();
         virtual void updateBoundingBox() const;
+        /** Marks an element as changed, along with the neighbours whose tangent depends on it
+        @param chainIndex The index of the chain
+        @param element The element relative to the start of the segment (not to the head)
+        */
+        void markElementDirty(size_t chainIndex, size_t element);
+        /// Writes both vertices of an element of a segment with at least two elements
+        void writeElementVertices(const ChainSegment& seg, size_t element, const Vector3& eyePos, float* pFloat);
 
         /// Chain segment has no elements
         static const size_t SEGMENT_EMPTY;
@@ -117,6 +117,10 @@ class RenderQueue;
         void setPointRenderingEnabled(bool enabled) { mBillboardSet->setPointRenderingEnabled(enabled); }
         /// @copydoc BillboardSet::isPointRenderingEnabled
         [[nodiscard]] auto isPointRenderingEnabled() const noexcept -> bool { return mBillboardSet->isPointRenderingEnabled(); }
+        /// @copydoc BillboardSet::setInstancedRenderingEnabled
+        void setInstancedRenderingEnabled(bool enabled) { mBillboardSet->setInstancedRenderingEnabled(enabled); }
+        /// @copydoc BillboardSet::isInstancedRenderingEnabled
+        [[nodiscard]] auto isInstancedRenderingEnabled() const noexcept -> bool { return mBillboardSet->isInstancedRenderingEnabled(); }
 
         /// @copydoc ParticleSystemRenderer::getType
         [[nodiscard]] auto getType() const noexcept -> std::string_view override;
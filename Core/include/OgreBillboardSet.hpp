@@ -40,12 +40,14 @@ export import :MovableObject;
 export import :Platform;
 export import :Prerequisites;
 export import :Quaternion;
+export import :RadixSort;
 export import :Renderable;
 export import :ResourceGroupManager;
 export import :SharedPtr;
 export import :Vector;
 
 export import <algorithm>;
+export import <future>;
 export import <memory>;
 export import <vector>;
 
@@ -262,6 +264,9 @@ class VertexData;
 
         void genPointVertices(const Billboard& pBillboard);
 
+        /// Internal method for generating the instance data of a billboard in instanced rendering
+        void genInstanceData(const Billboard& pBillboard);
+
         /** Internal method generates vertex offsets.
         @remarks
             Takes in parametric offsets as generated from getParametericOffsets, width and height values
@@ -302,6 +307,8 @@ class VertexData;
 
         /// Use point rendering?
         bool mPointRendering;
+        /// Use instanced rendering where the billboard type allows it?
+        bool mInstancedRendering{false};
 
 
 
@@ -316,6 +323,33 @@ class VertexData;
         bool mAutoUpdate;
         /// True if the billboard data changed. Will cause vertex buffer update.
         bool mBillboardDataChanged;
+        /// Whether the current buffers hold instance data instead of quads
+        bool mBuffersInstanced{false};
+
+        CoherentSort<BillboardPool, ::std::unique_ptr<Billboard>> mSorter;
+        /// Running asynchronous sort, see setSortAsync
+        std::future<void> mSortTask;
+        bool mSortAsync{false};
+        /// Changes whenever the active billboards change, invalidating a running sort
+        size_t mPoolGeneration{0};
+        size_t mSortGeneration{0};
+        unsigned int mSortInterval{1};
+        Real mSortDistanceThreshold{0};
+        Radian mSortAngleThreshold{0};
+        /// State of the last sort, to tell whether the next one is due
+        bool mSortDone{false};
+        unsigned long mLastSortFrame{0};
+        Vector3 mLastSortCamPos;
+        Vector3 mLastSortCamDir;
+
+        /// Waits for a running asynchronous sort and applies its result if still valid
+        void finishSort();
+
+        /// Whether the billboards can currently be expanded in the vertex shader
+        [[nodiscard]] auto canRenderInstanced() const noexcept -> bool;
+        /** Internal method creates the shared quad and the instance buffer.
+        */
+        void _createInstancedBuffers();
 
         /** Internal method creates vertex and index buffers.
         */
@@ -415,6 +449,43 @@ class VertexData;
         */
         auto getSortingEnabled() const noexcept -> bool { return mSortingEnabled; }
 
+        /** Sets how often the billboards are sorted, if sorting is enabled.
+        @remarks
+            The order changes little from one frame to the next, so sorting can be skipped on
+            most frames. With an interval of N the billboards are sorted every N frames, and
+            additionally whenever the camera moved further than distanceThreshold or turned
+            by more than angleThreshold since the last sort. The default interval of 1 sorts
+            every frame; 0 only sorts on camera movement. Billboards created in between are
+            drawn in creation order until the next sort.
+        @param interval The number of frames between two sorts
+        @param distanceThreshold How far the camera can move without a sort
+        @param angleThreshold How far the camera can turn without a sort
+        */
+        void setSortInterval(unsigned int interval, Real distanceThreshold = 0,
+                             const Radian& angleThreshold = Radian{0});
+        [[nodiscard]] auto getSortInterval() const noexcept -> unsigned int { return mSortInterval; }
+        [[nodiscard]] auto getSortDistanceThreshold() const noexcept -> Real { return mSortDistanceThreshold; }
+        [[nodiscard]] auto getSortAngleThreshold() const noexcept -> const Radian& { return mSortAngleThreshold; }
+
+        /** Sets whether the sort keys are quantized to 16 bits. (default: off)
+        @remarks
+            Halves the work of sorting large sets which changed order a lot, at the cost of
+            billboards closer than 1/65535th of the depth range of the set keeping their order.
+        */
+        void setSortKeysQuantized(bool quantized) { mSorter.setQuantized(quantized); }
+        [[nodiscard]] auto getSortKeysQuantized() const noexcept -> bool { return mSorter.getQuantized(); }
+
+        /** Sets whether sorting runs on a worker thread of the WorkQueue. (default: off)
+        @remarks
+            The depths are taken when a sort is due and sorted while the vertices are
+            written in the current order; the result is applied before the next update.
+            The order is therefore always one update behind, which is usually not
+            noticeable. If billboards were created or removed in between, the result is
+            discarded and the next sort due starts over.
+        */
+        void setSortAsync(bool async);
+        [[nodiscard]] auto getSortAsync() const noexcept -> bool { return mSortAsync; }
+
         /** Adjusts the size of the pool of billboards available in this set.
         @remarks
             See the BillboardSet::setAutoextend method for full details of the billboard pool. This method adjusts
@@ -793,6 +864,40 @@ class VertexData;
         /** Returns whether point rendering is enabled. */
         auto isPointRenderingEnabled() const noexcept -> bool { return mPointRendering; }
 
+        /// Custom parameters set for the vertex shader in instanced rendering, see setInstancedRenderingEnabled
+        enum InstancedParam : size_t
+        {
+            /// Billboard x axis; w is 1 if texture coordinates are rotated, 0 if vertices are
+            INSTANCED_PARAM_AXIS_X = 0,
+            /// Billboard y axis
+            INSTANCED_PARAM_AXIS_Y = 1,
+            /// Parametric left, right, top & bottom offsets of the origin
+            INSTANCED_PARAM_OFFSETS = 2
+        };
+
+        /** Set whether or not the BillboardSet will expand its billboards in the
+            vertex shader rather than on the CPU.
+
+            Instead of 4 vertices per billboard, only one instance entry is uploaded
+            and drawn over a shared quad, which has the corner in texture coordinate 0.
+            The instance entry holds:
+            - the position (POSITION) and colour (DIFFUSE)
+            - width, height and rotation in radians (TEXTURE_COORDINATES 1)
+            - the texture coordinate rect as left, top, right, bottom (TEXTURE_COORDINATES 2)
+            The billboard axes and origin offsets are passed as custom parameters,
+            see InstancedParam. The RTSS generates the matching vertex shader with
+            `transform_stage billboard` in the `rtshader_system` block of the pass.
+
+            Billboards are only instanced when their axes are shared by the whole set,
+            so the BillboardType::ORIENTED_SELF and BillboardType::PERPENDICULAR_SELF types,
+            accurate facing and point rendering keep generating quads on the CPU.
+            It needs Capabilities::VERTEX_BUFFER_INSTANCE_DATA, it is left disabled otherwise.
+        */
+        void setInstancedRenderingEnabled(bool enabled);
+
+        /** Returns whether instanced rendering is enabled. */
+        [[nodiscard]] auto isInstancedRenderingEnabled() const noexcept -> bool { return mInstancedRendering; }
+
         /// Override to return specific type flag
         auto getTypeFlags() const noexcept -> QueryTypeMask override;
 
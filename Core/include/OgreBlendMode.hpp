@@ -288,6 +288,8 @@ namespace Ogre {
             return !(sourceFactor == SceneBlendFactor::ONE && destFactor == SceneBlendFactor::ZERO &&
                      sourceFactorAlpha == SceneBlendFactor::ONE && destFactorAlpha == SceneBlendFactor::ZERO);
         }
+
+        [[nodiscard]] auto operator==(const ColourBlendState&) const -> bool = default;
     };
     /** @} */
     /** @} */
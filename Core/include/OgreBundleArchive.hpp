@@ -0,0 +1,138 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+module;
+
+#include <cstddef>
+
+export module Ogre.Core:BundleArchive;
+
+export import :ArchiveFactory;
+export import :Platform;
+export import :Prerequisites;
+
+export import <string>;
+export import <utility>;
+export import <vector>;
+
+export
+namespace Ogre {
+class Archive;
+
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Resources
+    *  @{
+    */
+
+    /** Specialisation to allow reading of files from a prebuilt bundle.
+
+        A bundle is a single file written by BundleWriter, usually offline with
+        the OgreBundleTool. It starts with an index holding a hash table of the
+        entry names, so it is opened without parsing a directory and entries are
+        located in constant time. Each payload starts at an aligned offset and is
+        either stored or deflate compressed. The file is memory mapped, stored
+        entries are returned as views of the mapping.
+
+        The index can also hold resource declarations, which
+        ResourceGroupManager::addResourceLocation declares without inspecting
+        the files, see Archive::getResourceDeclarations.
+    */
+    class BundleArchiveFactory : public ArchiveFactory
+    {
+    public:
+        ~BundleArchiveFactory() override = default;
+        /// @copydoc FactoryObj::getType
+        [[nodiscard]] auto getType() const noexcept -> std::string_view override;
+
+        using ArchiveFactory::createInstance;
+
+        auto createInstance( std::string_view name, bool readOnly ) -> Archive * override;
+    };
+
+    /** Builds a bundle to be read with BundleArchiveFactory.
+    @remarks
+        Files are only read when write() is called, so whole archives can be
+        added without holding their contents in memory.
+    */
+    class BundleWriter
+    {
+    public:
+        /// Default alignment of the payloads
+        static constexpr size_t DEFAULT_ALIGNMENT = 64 * 1024;
+
+        /** Adds a single file.
+        @param name The name of the entry in the bundle
+        @param stream The contents
+        @param compress Whether to deflate the contents; they are stored if
+            compression does not make them smaller
+        */
+        void addFile(std::string_view name, const DataStreamPtr& stream, bool compress = false);
+
+        /** Adds all files and directories of an archive.
+        @param archive The archive, which must stay loaded until write() is called
+        @param compress Whether to deflate the files
+        */
+        void addArchive(const Archive* archive, bool compress = false);
+
+        /** Records a resource declaration in the index.
+        @see ResourceGroupManager::declareResource
+        */
+        void declareResource(std::string_view name, std::string_view resourceType);
+
+        /** Sets the alignment of the payloads.
+        @remarks
+            Must be a power of two. Large alignments let payloads be mapped or
+            read in whole pages, at the cost of padding between small files.
+        */
+        void setAlignment(size_t alignment);
+        [[nodiscard]] auto getAlignment() const noexcept -> size_t { return mAlignment; }
+
+        /** Writes the bundle.
+        @param path The file to create
+        */
+        void write(std::string_view path) const;
+
+    private:
+        struct Source
+        {
+            std::string name;
+            const Archive* archive;
+            DataStreamPtr stream;
+            bool compress;
+            bool directory;
+        };
+
+        std::vector<Source> mSources;
+        std::vector<std::pair<std::string, std::string>> mDeclarations;
+        size_t mAlignment{DEFAULT_ALIGNMENT};
+    };
+    /** @} */
+    /** @} */
+
+}
@@ -422,6 +422,8 @@ class Viewport;
 
         /// @copydoc Frustum::isVisible(const AxisAlignedBox&, FrustumPlane*) const
         auto isVisible(const AxisAlignedBox& bound, FrustumPlane* culledBy = nullptr) const -> bool override;
+        /// @copydoc Frustum::isVisible(const AxisAlignedBoxBatch&, uint8*) const
+        void isVisible(const AxisAlignedBoxBatch& bounds, uint8* visible) const override;
         /// @copydoc Frustum::isVisible(const Sphere&, FrustumPlane*) const
         auto isVisible(const Sphere& bound, FrustumPlane* culledBy = nullptr) const -> bool override;
         /// @copydoc Frustum::isVisible(const Vector3&, FrustumPlane*) const
@@ -0,0 +1,115 @@
+// This file is part of the OGRE project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at https://www.ogre3d.org/licensing.
+module;
+
+#include <cstddef>
+
+export module Ogre.Core:CategoryAllocators;
+
+export import :MemoryAllocatorConfig;
+export import :Platform;
+
+export import <array>;
+export import <atomic>;
+export import <mutex>;
+export import <vector>;
+
+export
+namespace Ogre
+{
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup General
+    *  @{
+    */
+
+    /** Pools of small blocks with a cache per thread.
+    @remarks
+        Meant for categories with many small, short lived objects, like the nodes and
+        movables of SceneCtlAllocatedObject and SceneObjAllocatedObject or the key frames
+        of AnimationAlloc. Sizes up to MAX_SIZE are rounded up to a multiple of
+        GRANULARITY and served from a free list of that size. Each thread takes blocks in
+        batches from the shared lists and keeps the ones it frees, up to a limit, so most
+        allocations neither lock nor leave the thread. Larger or over aligned requests use
+        the global operator new.
+    @par
+        The memory of the pools is only released when the allocator is destroyed, which
+        must happen after all its allocations were freed and no thread uses it anymore.
+    */
+    class SmallObjectAllocator : public CategoryAllocator
+    {
+    public:
+        static constexpr size_t GRANULARITY = 16;
+        static constexpr size_t MAX_SIZE = 512;
+
+        /// @param chunkSize Size of the blocks of memory the pools are carved from
+        explicit SmallObjectAllocator(size_t chunkSize = 64 * 1024);
+        ~SmallObjectAllocator() override;
+
+        auto allocate(size_t size, size_t alignment) -> void* override;
+        void deallocate(void* ptr, size_t size, size_t alignment) noexcept override;
+
+        /// Gets the bytes of the chunks allocated for the pools
+        [[nodiscard]] auto getReservedBytes() const -> size_t;
+
+    private:
+        struct FreeBlock
+        {
+            FreeBlock* next;
+        };
+        struct ThreadCache;
+
+        static constexpr size_t SIZE_CLASSES = MAX_SIZE / GRANULARITY;
+        /// blocks moved between a thread and the shared lists at once
+        static constexpr uint32 BATCH = 32;
+
+        auto threadCache() -> ThreadCache*;
+        /// takes a batch of blocks off the shared list, carving new ones if needed
+        auto refill(size_t sizeClass, uint32& count) -> FreeBlock*;
+        void release(size_t sizeClass, FreeBlock* first, FreeBlock* last);
+
+        mutable std::mutex mMutex;
+        std::array<FreeBlock*, SIZE_CLASSES> mFree{};
+        std::vector<void*> mChunks;
+        /// the caches of the threads, detached when the allocator is destroyed
+        std::vector<ThreadCache*> mThreadCaches;
+        uint8* mChunk{nullptr};
+        size_t mChunkLeft{0};
+        size_t mChunkSize;
+        /// tells the thread caches of different allocators apart
+        uint64 mId;
+    };
+
+    /** Bump allocator, freeing is a no-op until reset.
+    @remarks
+        Meant for data which lives no longer than a frame, like the temporaries of culling
+        and the render queue, so binding a category to it is only safe if all its objects
+        are destroyed before reset. When the buffer is exhausted, the global operator new
+        is used.
+    */
+    class LinearAllocator : public CategoryAllocator
+    {
+    public:
+        explicit LinearAllocator(size_t capacity);
+        ~LinearAllocator() override;
+
+        auto allocate(size_t size, size_t alignment) -> void* override;
+        void deallocate(void* ptr, size_t size, size_t alignment) noexcept override;
+
+        /// Makes the whole buffer available again, must not race with allocate
+        void reset() { mUsed.store(0, std::memory_order_relaxed); }
+
+        /// Gets the bytes used since the last reset
+        [[nodiscard]] auto getUsed() const -> size_t { return mUsed.load(std::memory_order_relaxed); }
+        [[nodiscard]] auto getCapacity() const noexcept -> size_t { return mCapacity; }
+
+    private:
+        uint8* mBuffer;
+        size_t mCapacity;
+        std::atomic<size_t> mUsed{0};
+    };
+    /** @} */
+    /** @} */
+}
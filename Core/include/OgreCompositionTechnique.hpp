@@ -39,7 +39,9 @@ export import :Platform;
 export import :Prerequisites;
 export import :Texture;
 
+export import <map>;
 export import <memory>;
+export import <string_view>;
 export import <vector>;
 
 export
@@ -151,6 +153,31 @@ namespace Ogre {
         /** Get output (final) target pass
          */
         [[nodiscard]] auto getOutputTargetPass() const noexcept -> CompositionTargetPass * { return mOutputTarget.get(); }
+
+        /// Range of target passes using a texture, see computeTextureLifetimes
+        struct TextureLifetime
+        {
+            /// Index of the first target pass reading or writing the texture
+            size_t firstUse;
+            /// Index of the last target pass reading or writing the texture
+            size_t lastUse;
+            /// The contents are needed outside of the range, so the texture can not be shared
+            bool persistent{false};
+        };
+        using TextureLifetimes = std::map<std::string_view, TextureLifetime>;
+
+        /** Computes the lifetime of each texture during one execution of this technique.
+        @remarks
+            Target passes are numbered in execution order, the output target pass being
+            getNumTargetPasses(). A texture is marked persistent if its previous contents
+            may be observed: it is read before being written, its first write does not
+            cover it completely, or a material references it directly. Custom and compute
+            passes may access any texture, so they mark all of them persistent.
+        @par
+            Textures not used by any target pass are not listed. The keys refer to the
+            names stored in the passes and stay valid until these are modified.
+        */
+        [[nodiscard]] auto computeTextureLifetimes() const -> TextureLifetimes;
         
         /** Determine if this technique is supported on the current rendering device. 
         @param allowTextureDegradation True to accept a reduction in texture depth
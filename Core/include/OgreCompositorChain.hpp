@@ -126,6 +126,41 @@ class SceneManager;
         */
         void setCompositorEnabled(size_t position, bool state);
 
+        /** Sets the fraction of the viewport size rendered to the textures sized relative to it.
+        @remarks
+            The textures keep their size, only the viewports of their render targets shrink to
+            the top left part of them. Quads sampling such textures read the same part, so a
+            quad rendering to the output of the chain upscales the result. Changing the scale
+            thus does not recreate any resources.
+        @par
+            Applies to local and chain scope textures whose definition has neither a width nor
+            a height. Compute passes operate on the whole texture.
+        @param scale between 0 and 1
+        */
+        void setResolutionScale(Real scale);
+        /// Gets the fraction of the viewport size rendered to, see setResolutionScale
+        [[nodiscard]] auto getResolutionScale() const noexcept -> Real { return mResolutionScale; }
+
+        /** Chooses the resolution scale each frame to keep the GPU frame time at a target.
+        @remarks
+            The GPU frame time is taken from Profiler::getGPUFrameTime, so the profiler must be
+            enabled with GPU timing. The scale follows the timings slowly, see
+            _computeResolutionScale, and never goes below minScale.
+        @param targetMilliseconds the GPU time to aim for, 0 to stop adjusting the scale
+        @param minScale the lowest resolution scale to use
+        */
+        void setDynamicResolution(Real targetMilliseconds, Real minScale = 0.5f);
+        /// Gets the GPU frame time the resolution scale is adjusted to, 0 if none
+        [[nodiscard]] auto getDynamicResolutionTarget() const noexcept -> Real { return mTargetFrameTime; }
+
+        /** The resolution scale following the given one, to reach targetFrameTime.
+        @remarks
+            The GPU time is taken to be proportional to the rendered pixel count. Only a part
+            of the step is taken each time, and changes below 1% are ignored, so noisy timings
+            do not make the scale oscillate.
+        */
+        static auto _computeResolutionScale(Real scale, Real frameTime, Real targetFrameTime, Real minScale) -> Real;
+
         void preRenderTargetUpdate(const RenderTargetEvent& evt) override;
         void postRenderTargetUpdate(const RenderTargetEvent& evt) override;
         void preViewportUpdate(const RenderTargetViewportEvent& evt) override;
@@ -157,6 +192,16 @@ class SceneManager;
         */
         void _compile();
 
+        /** Remove the operations that do not contribute to output.
+        @remarks
+            An operation is needed if it is flagged keepAlive, if a needed operation samples a
+            texture it renders to, or if it precedes a needed operation that flags readsAnything.
+            Operations without writes are never removed.
+        @return the count of removed operations
+        */
+        static auto _cullUnusedOperations(CompositorInstance::CompiledState& ops,
+                                          const CompositorInstance::TargetOperation& output) -> size_t;
+
         /** Get the previous instance in this chain to the one specified. 
         */
         auto getPreviousInstance(CompositorInstance* curr, bool activeOnly = true) -> CompositorInstance*;
@@ -182,6 +227,14 @@ class SceneManager;
 
         String mOriginalSceneScheme;
 
+        /// See setResolutionScale
+        Real mResolutionScale{1};
+        /// Scale the viewports of the textures were last set to, 0 if they need to be set
+        Real mAppliedResolutionScale{0};
+        /// See setDynamicResolution
+        Real mTargetFrameTime{0};
+        Real mMinResolutionScale{0.5f};
+
         /// Compiled state (updated with _compile)
         CompositorInstance::CompiledState mCompiledState;
         CompositorInstance::TargetOperation mOutputOperation;
@@ -39,11 +39,13 @@ export import :MemoryAllocatorConfig;
 export import :Platform;
 export import :Prerequisites;
 export import :RenderQueue;
+export import :Resource;
 export import :SharedPtr;
 
 export import <algorithm>;
 export import <bitset>;
 export import <map>;
+export import <set>;
 export import <string>;
 export import <utility>;
 export import <vector>;
@@ -187,6 +189,15 @@ class SceneManager;
 
             String cameraOverride;
             int alignCameraToFace;
+
+            /// Handles of the textures sampled by the passes, see CompositorManager::setUnusedTargetCulling
+            std::vector<ResourceHandle> reads;
+            /// Handles of the textures rendered to
+            std::vector<ResourceHandle> writes;
+            /// The passes may sample textures not listed in reads, e.g. through the materials of the scene
+            bool readsAnything{false};
+            /// The result is visible outside of the chain, so the operation is never culled
+            bool keepAlive{false};
         };
         using CompiledState = std::vector<TargetOperation>;
         
@@ -304,6 +315,11 @@ class SceneManager;
         */
         void notifyResized();
 
+        /** Shrinks the viewports of the textures sized relative to the viewport of the chain.
+        @see CompositorChain::setResolutionScale
+        */
+        void _setResolutionScale(Real scale);
+
         /** Get Chain that this instance is part of
         */
         auto getChain() -> CompositorChain *;
@@ -358,6 +374,10 @@ class SceneManager;
             in case we switch back. 
         */
         ReserveTextureMap mReserveTextures;
+        /** Local textures which share the texture of another definition, these are not
+            removed from the TextureManager when freed. See CompositorManager::setTransientTextureAliasing
+        */
+        std::set<std::string_view> mAliasedTextures;
 
         /// Vector of listeners.
         using Listeners = std::vector<Listener *>;
@@ -168,6 +168,40 @@ class Viewport;
         */
         void freePooledTextures(bool onlyIfUnreferenced = true);
 
+        /** Sets whether compositor instances share transient textures between definitions.
+        @remarks
+            When enabled, each instance computes the lifetimes of its texture definitions
+            using CompositionTechnique::computeTextureLifetimes. Local, non pooled
+            definitions whose lifetimes do not overlap and which have matching size,
+            format and render target options are then backed by the same texture, which
+            reduces the memory needed by long post processing chains.
+        @par
+            This is disabled by default, as application code may access compositor
+            textures by name outside of the composition, e.g. through
+            CompositorInstance::getTextureInstance, and would then see the contents of
+            another definition. Changes take effect when the resources are next created.
+        */
+        void setTransientTextureAliasing(bool enabled) { mTransientTextureAliasing = enabled; }
+        /// Gets whether compositor instances share transient textures, see setTransientTextureAliasing
+        [[nodiscard]] auto getTransientTextureAliasing() const noexcept -> bool { return mTransientTextureAliasing; }
+
+        /** Sets whether compositor chains skip target operations whose results are never used.
+        @remarks
+            When enabled, CompositorChain::_compile builds the dependency graph of the compiled
+            target operations from the textures each of them samples and renders to. Starting at
+            the final output, only the operations that contribute to it are kept, see
+            CompositorChain::_cullUnusedOperations.
+        @par
+            Render scene and custom passes may sample any texture rendered before them. Textures
+            with global scope, references to other compositors and "only initial" targets are
+            always rendered. This is disabled by default, as application code may access
+            compositor textures directly, e.g. to show them in an overlay. Changes take effect when
+            the chains are next compiled.
+        */
+        void setUnusedTargetCulling(bool enabled) { mUnusedTargetCulling = enabled; }
+        /// Gets whether compositor chains skip unused target operations, see setUnusedTargetCulling
+        [[nodiscard]] auto getUnusedTargetCulling() const noexcept -> bool { return mUnusedTargetCulling; }
+
         /** Register a compositor logic for listening in to expecting composition
             techniques.
         */
@@ -261,6 +295,9 @@ class Viewport;
         
         ChainTexturesByDef mChainTexturesByDef;
 
+        bool mTransientTextureAliasing{false};
+        bool mUnusedTargetCulling{false};
+
         auto isInputPreviousTarget(CompositorInstance* inst, std::string_view localName) -> bool;
         auto isInputPreviousTarget(CompositorInstance* inst, TexturePtr tex) -> bool;
         auto isInputToOutputTarget(CompositorInstance* inst, std::string_view localName) -> bool;
@@ -0,0 +1,169 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+module;
+
+#include <cstddef>
+
+export module Ogre.Core:CompressedNodeTrack;
+
+export import :Math;
+export import :MemoryAllocatorConfig;
+export import :Platform;
+export import :Prerequisites;
+export import :Quaternion;
+export import :Vector;
+
+export import <vector>;
+
+export
+namespace Ogre {
+class NodeAnimationTrack;
+
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Animation
+    *  @{
+    */
+    /** Compact, read only representation of the keyframes of a NodeAnimationTrack.
+    @remarks
+        Translation, rotation and scale are stored as separate curves, each with
+        its own key times, so a bone which only rotates does not pay for
+        translation and scale keys. For every curve
+        - keys which the interpolation of the remaining keys reproduces within
+          the tolerance are dropped,
+        - a curve whose keys all lie within the tolerance of the first one is
+          stored as a single constant key,
+        - vectors are quantised to 16 bits per component relative to the range
+          of the curve, and
+        - rotations are quantised to 48 bits by storing the three smallest
+          components, the largest one being rebuilt from the unit length.
+    @par
+        The error is measured on the decoded keys, quantisation included, against
+        every original keyframe. The components are stored in separate arrays and
+        decoded with one multiply-add each, so evaluating a track is a search of
+        the key times followed by straight arithmetic.
+    @par
+        Rotations are always interpolated linearly along the shortest path, and
+        translations and scales linearly, whatever the interpolation mode of the
+        Animation.
+    @see NodeAnimationTrack::compress, Skeleton::compressAllAnimations
+    */
+    class CompressedNodeTrack : public AnimationAlloc
+    {
+    public:
+        /// Largest allowed deviation from the original keyframes
+        struct Tolerance
+        {
+            /// Distance between translations
+            Real translate{0.001f};
+            /// Angle between rotations
+            Radian rotate{0.0005f};
+            /// Difference between scales, per axis
+            Real scale{0.001f};
+        };
+
+        /** Compresses the keyframes of a track.
+        @param track The track, with at least one keyframe
+        @param tolerance The largest error allowed
+        */
+        CompressedNodeTrack(const NodeAnimationTrack& track, const Tolerance& tolerance);
+
+        /** Evaluates the track.
+        @param timePos The time position, within the length of the animation
+        @param length The length of the animation, after the last key the track
+            interpolates towards the first one
+        @param translate Receives the translation
+        @param rotate Receives the rotation
+        @param scale Receives the scale
+        */
+        void evaluate(Real timePos, Real length, Vector3& translate, Quaternion& rotate, Vector3& scale) const;
+
+        /// Gets the sorted and unique key times of all curves
+        [[nodiscard]] auto getKeyTimes() const -> std::vector<Real>;
+
+        /// Gets the number of stored keys of all curves
+        [[nodiscard]] auto getNumKeys() const noexcept -> size_t
+        {
+            return mTranslate.times.size() + mRotate.times.size() + mScale.times.size();
+        }
+
+        /// Whether all curves are constant
+        [[nodiscard]] auto isConstant() const noexcept -> bool { return getNumKeys() == 3; }
+
+        /// Gets the memory used by the track in bytes
+        [[nodiscard]] auto getMemoryUsage() const -> size_t;
+
+        /// Packs a rotation as the three smallest components of the unit quaternion, 15 bits each
+        static void packRotation(const Quaternion& q, uint16 packed[3]);
+        /// Unpacks a rotation created by packRotation
+        static auto unpackRotation(const uint16 packed[3]) -> Quaternion;
+
+    private:
+        /// A translation or scale curve
+        struct VectorCurve
+        {
+            std::vector<Real> times;
+            /// Quantised components, base + value * step
+            std::vector<uint16> x, y, z;
+            Vector3 base{Vector3::ZERO};
+            Vector3 step{Vector3::ZERO};
+
+            [[nodiscard]] auto decode(size_t key) const -> Vector3
+            {
+                return {base.x + x[key] * step.x, base.y + y[key] * step.y, base.z + z[key] * step.z};
+            }
+        };
+
+        /// A rotation curve, see packRotation
+        struct RotationCurve
+        {
+            std::vector<Real> times;
+            /// The packed words of the keys, separately
+            std::vector<uint16> a, b, c;
+
+            [[nodiscard]] auto decode(size_t key) const -> Quaternion
+            {
+                uint16 packed[3] = {a[key], b[key], c[key]};
+                return unpackRotation(packed);
+            }
+        };
+
+        VectorCurve mTranslate;
+        RotationCurve mRotate;
+        VectorCurve mScale;
+
+        static void compressVectors(const std::vector<Real>& times, const std::vector<Vector3>& values,
+                                    Real tolerance, bool maxNorm, VectorCurve& curve);
+        static void compressRotations(const std::vector<Real>& times, const std::vector<Quaternion>& values,
+                                      Radian tolerance, RotationCurve& curve);
+    };
+    /** @} */
+    /** @} */
+
+}
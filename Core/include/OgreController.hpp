@@ -88,6 +88,17 @@ namespace Ogre {
         virtual ~ControllerFunction() = default;
 
         virtual auto calculate(T sourceValue) -> T = 0;
+
+        /** Whether the function sums up its inputs.
+        @remarks
+            Calculating such a function once with the sum of several inputs gives the value
+            calculating it with each of them in turn would, which Controller::_holdInput
+            relies on.
+        */
+        [[nodiscard]] virtual auto isInputAccumulated() const noexcept -> bool
+        {
+            return mDeltaInput;
+        }
     };
 
 
@@ -136,6 +147,12 @@ namespace Ogre {
         SharedPtr< ControllerFunction<T> > mFunc;
         /// Controller is enabled or not
         bool mEnabled;
+        /// Whether the owner of the destination applies held back input before using it
+        bool mDeferrable{false};
+        /// Whether mHeldInput is to be applied
+        bool mInputHeld{false};
+        /// Input held back by _holdInput
+        T mHeldInput{};
 
 
     public:
@@ -213,7 +230,46 @@ namespace Ogre {
         void update()
         {
             if(mEnabled)
+            {
+                _applyHeldInput();
                 mDest->setValue(mFunc->calculate(mSource->getValue()));
+            }
+        }
+
+        /** Sets whether the owner of the destination calls _applyHeldInput before using it.
+        @remarks
+            Only such controllers are held back by ControllerManager::setDeferTextureUpdates.
+        */
+        void _setDeferrable(bool deferrable)
+        {
+            mDeferrable = deferrable;
+        }
+        /// Whether the owner of the destination calls _applyHeldInput before using it
+        [[nodiscard]] auto _isDeferrable() const noexcept -> bool
+        {
+            return mDeferrable;
+        }
+        /** Reads the input of this update without passing it on to the destination.
+        @remarks
+            The input of a function that accumulates its inputs is added to the input held
+            back already, any other input replaces it, so the destination gets the value
+            update would have given it once _applyHeldInput is called.
+        */
+        void _holdInput()
+        {
+            if (!mEnabled)
+                return;
+            T input = mSource->getValue();
+            mHeldInput = mInputHeld && mFunc->isInputAccumulated() ? mHeldInput + input : input;
+            mInputHeld = true;
+        }
+        /// Passes the input held back by _holdInput on to the destination, if any
+        void _applyHeldInput()
+        {
+            if (!mInputHeld)
+                return;
+            mInputHeld = false;
+            mDest->setValue(mFunc->calculate(mHeldInput));
         }
 
     };
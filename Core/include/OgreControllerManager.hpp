@@ -76,6 +76,9 @@ template <typename T> class ControllerValue;
         /// Last frame number updated
         unsigned long mLastFrameNumber{0};
 
+        /// Hold back the input of controllers of texture units, see setDeferTextureUpdates
+        bool mDeferTextureUpdates{false};
+
     public:
         ControllerManager();
         ~ControllerManager();
@@ -98,6 +101,20 @@ template <typename T> class ControllerValue;
         */
         void updateAllControllers();
 
+        /** Sets whether the controllers of texture units are only evaluated when these are rendered.
+        @remarks
+            The animations, scrolls, rotations and wave transforms a TextureUnitState creates
+            then only read their input once per frame. They are evaluated with the input held
+            back when SceneManager::_setPass sets a pass of the unit, so the ones on materials
+            that are not visible cost little. The values that are rendered are the same, but
+            those read from a TextureUnitState lag behind while it is not rendered.
+        @par
+            Off by default.
+        */
+        void setDeferTextureUpdates(bool defer) { mDeferTextureUpdates = defer; }
+        /// Whether the controllers of texture units are evaluated when these are rendered
+        [[nodiscard]] auto getDeferTextureUpdates() const noexcept -> bool { return mDeferTextureUpdates; }
+
 
         /** Returns a ControllerValue which provides the time since the last frame as a control value source.
         @remarks
@@ -0,0 +1,168 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+module;
+
+#include <cstddef>
+
+export module Ogre.Core:ConvexPolytope;
+
+export import :AxisAlignedBox;
+export import :Frustum;
+export import :Plane;
+export import :Prerequisites;
+export import :Vector;
+
+export import <array>;
+export import <initializer_list>;
+
+export
+namespace Ogre
+{
+
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Math
+    *  @{
+    */
+    /** A convex body of fixed capacity, for clipping without allocations.
+    @remarks
+        Covers the operations of ConvexBody the focused shadow camera setups need: defining
+        the body by a frustum or box, clipping it by planes and extending it by a point. The
+        faces are convex polygons with their vertices in ccw order seen from the outside. The
+        vertices are held in structure-of-arrays form, so the distances of all of them to a
+        clipping plane are calculated at once with SIMD (see
+        OptimisedUtil::calculatePlaneDistances). Each operation writes its result into the
+        second of two storages, which are then swapped.
+    @par
+        Should a result not fit, the body is kept conservative: a clip is skipped, leaving the
+        body larger than it could be, and an extension falls back to the bounding box of the
+        body and the point. Neither happens for the bodies the shadow camera setups build.
+    */
+    class ConvexPolytope
+    {
+    public:
+        static constexpr size_t MAX_FACES = 64;
+        /// Vertices summed over all faces
+        static constexpr size_t MAX_VERTICES = 512;
+
+        /// Build the body from a frustum
+        void define(const Frustum& frustum);
+
+        /// Build the body from a finite box
+        void define(const AxisAlignedBox& aab);
+
+        /// Clips the body with a frustum, keeping the inside
+        void clip(const Frustum& frustum);
+
+        /// Clips the body with a box, keeping the inside; infinite boxes are ignored
+        void clip(const AxisAlignedBox& aab);
+
+        /** Clips the body by a plane, filling the hole with a new face
+        @param plane The plane to clip with
+        @param keepNegative Whether the part on the negative side of the plane is kept,
+            the positive one otherwise
+        */
+        void clip(const Plane& plane, bool keepNegative = true);
+
+        /// Extends the body to the convex hull of the body and a point
+        void extend(const Vector3& point);
+
+        /// Removes all faces
+        void reset();
+
+        [[nodiscard]] auto getFaceCount() const noexcept -> size_t { return current().numFaces; }
+
+        [[nodiscard]] auto getVertexCount(size_t face) const noexcept -> size_t
+        {
+            return current().faces[face].count;
+        }
+
+        [[nodiscard]] auto getVertex(size_t face, size_t vertex) const noexcept -> Vector3
+        {
+            const Storage& storage = current();
+            return storage.getVertex(storage.faces[face].first + vertex);
+        }
+
+        /// Returns the bounding box of the vertices, null for an empty body
+        [[nodiscard]] auto getAABB() const -> AxisAlignedBox;
+
+    private:
+        struct Face
+        {
+            uint16 first;
+            uint16 count;
+        };
+
+        struct Storage
+        {
+            std::array<float, MAX_VERTICES> x;
+            std::array<float, MAX_VERTICES> y;
+            std::array<float, MAX_VERTICES> z;
+            std::array<Face, MAX_FACES> faces;
+            size_t numVertices{0};
+            size_t numFaces{0};
+
+            [[nodiscard]] auto getVertex(size_t index) const noexcept -> Vector3
+            {
+                return {x[index], y[index], z[index]};
+            }
+
+            void clear() noexcept
+            {
+                numVertices = 0;
+                numFaces = 0;
+            }
+            /// Starts a face, returns false if there is no room for it
+            auto beginFace() noexcept -> bool;
+            /// Adds a vertex to the face begun last, skipping repetitions
+            auto addVertex(const Vector3& v) noexcept -> bool;
+            /// Ends the face begun last, dropping it if it has less than three vertices
+            void endFace() noexcept;
+            /// Adds a whole face
+            auto addFace(std::initializer_list<Vector3> vertices) noexcept -> bool;
+            /// Newell normal of a face, pointing outwards, not normalised
+            [[nodiscard]] auto getNormal(size_t face) const noexcept -> Vector3;
+        };
+
+        std::array<Storage, 2> mStorage;
+        size_t mCurrent{0};
+        /// Distances of the vertices to the current clipping plane
+        std::array<float, MAX_VERTICES> mDistances;
+
+        [[nodiscard]] auto current() const noexcept -> const Storage& { return mStorage[mCurrent]; }
+        [[nodiscard]] auto current() noexcept -> Storage& { return mStorage[mCurrent]; }
+        [[nodiscard]] auto next() noexcept -> Storage& { return mStorage[mCurrent ^ 1]; }
+
+        /// Makes the storage written by the last operation the current one
+        void swapStorage() noexcept { mCurrent ^= 1; }
+    };
+    /** @} */
+    /** @} */
+
+}
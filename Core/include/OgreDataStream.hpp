@@ -36,6 +36,7 @@ export import :Platform;
 export import :Prerequisites;
 export import :SharedPtr;
 
+export import <filesystem>;
 export import <istream>;
 export import <list>;
 export import <utility>;
@@ -373,6 +374,44 @@ namespace Ogre {
         void setFreeOnClose(bool free) { mFreeOnClose = free; }
     };
 
+    /** Read-only MemoryDataStream over a memory mapped file.
+    @remarks
+        Pages are brought in by the OS as they are accessed, without read calls and
+        without copying the file into a buffer first. Consumers handling a
+        MemoryDataStream specially can therefore parse the file in place.
+    @par
+        The mapping is private: writing through getPtr changes the memory of this
+        stream only, never the file. It is released when the stream is closed.
+    */
+    class MemoryMappedDataStream : public MemoryDataStream
+    {
+    private:
+        void* mMapping;
+        size_t mMappingSize;
+
+    public:
+        /** Maps a whole file.
+        @param name The name to give the stream
+        @param path The file to map
+        @return @c nullptr if the file could not be mapped
+        */
+        static auto open(std::string_view name, const std::filesystem::path& path)
+            -> SharedPtr<MemoryMappedDataStream>;
+
+        /** Takes ownership of an existing mapping.
+        @param name The name to give the stream
+        @param mapping The start of the mapping
+        @param size The size of the mapping in bytes
+        */
+        MemoryMappedDataStream(std::string_view name, void* mapping, size_t size);
+
+        ~MemoryMappedDataStream() override;
+
+        /** @copydoc DataStream::close
+        */
+        void close() override;
+    };
+
     /** Common subclass of DataStream for handling data from 
         std::basic_istream.
     */
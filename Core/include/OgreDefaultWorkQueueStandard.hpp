@@ -31,12 +31,12 @@ export module Ogre.Core:DefaultWorkQueueStandard;
 
 export import :Common;
 export import :Prerequisites;
+export import :TaskScheduler;
 export import :WorkQueue;
 
 export import <condition_variable>;
+export import <memory>;
 export import <mutex>;
-export import <thread>;
-export import <vector>;
 
 export
 namespace Ogre
@@ -45,6 +45,10 @@ namespace Ogre
     @remarks
         This default implementation of a work queue starts a thread pool and 
         provides queues to process requests. 
+    @par
+        The worker threads are those of a TaskScheduler: requests are handed to
+        them as tasks, while addTask, parallelFor and runTaskGraph use the
+        scheduler directly and do not go through the request queues at all.
     */
     class DefaultWorkQueue : public DefaultWorkQueueBase
     {
@@ -53,7 +57,11 @@ namespace Ogre
         DefaultWorkQueue(std::string_view name = BLANKSTRING);
         ~DefaultWorkQueue() override; 
 
-        /// Main function for each thread spawned.
+        /** Process requests until the queue is shut down.
+        @remarks
+            The worker threads of the queue do not run this, but it can be
+            used to have threads of your own help processing requests.
+        */
         void _threadMain() override;
 
         /// @copydoc WorkQueue::shutdown
@@ -62,6 +70,16 @@ namespace Ogre
         /// @copydoc WorkQueue::startup
         void startup(bool forceRestart = true) override;
 
+        /// @copydoc WorkQueue::addTask
+        void addTask(std::function<void()> task) override;
+        /// @copydoc WorkQueue::parallelFor
+        void parallelFor(size_t count, const std::function<void(size_t)>& func) override;
+        /// @copydoc WorkQueue::runTaskGraph
+        void runTaskGraph(TaskGraph& graph) override;
+
+        /// Gets the scheduler running the worker threads, @c nullptr unless started
+        [[nodiscard]] auto getTaskScheduler() const noexcept -> TaskScheduler* { return mScheduler.get(); }
+
     protected:
         /** To be called by a separate thread; will return immediately if there
             are items in the queue, or suspend the thread until new items are added
@@ -81,8 +99,7 @@ namespace Ogre
         std::condition_variable_any mInitSync;
 
         std::condition_variable_any mRequestCondition;
-        using WorkerThreadList = std::vector<std::thread *>;
-        WorkerThreadList mWorkers;
+        std::unique_ptr<TaskScheduler> mScheduler;
 
     };
 
@@ -38,6 +38,8 @@ export import :DataStream;
 export import :Prerequisites;
 export import :SharedPtr;
 
+export import <vector>;
+
 export
 namespace Ogre
 {
@@ -164,6 +166,12 @@ namespace Ogre
         You should avoid using this with already compressed archives.
         Also note that this cannot be used as a read / write stream, only a read-only
         or write-only stream.
+    @par
+        When reading, the decompressor state is saved at regular intervals (see
+        setRestartInterval), so seek() and skip() resume decompressing from the
+        nearest restart point before the target, rather than from the start of
+        the data. Small steps back are served from a bounded cache of the last
+        bytes read.
     */
     class DeflateStream : public DataStream
     {
@@ -180,7 +188,25 @@ namespace Ogre
         };
 
         using enum StreamType;
+
+        /// Default number of uncompressed bytes between read restart points
+        static constexpr size_t DEFAULT_RESTART_INTERVAL = 1024 * 1024;
     private:
+        /// Saved decompressor state, to resume reading from a position
+        struct RestartPoint
+        {
+            /// Uncompressed position
+            size_t pos;
+            /// Position in the compressed stream of the unconsumed input
+            size_t compressedPos;
+            /// Bytes of input read but not consumed
+            size_t availIn;
+            /// The remaining partial input length, see mAvailIn
+            size_t remainingIn;
+            /// The z_stream, followed by its internal state
+            std::vector<unsigned char> state;
+        };
+
         DataStreamPtr mCompressedStream;
         DataStreamPtr mTmpWriteStream;
         String mTempFileName;
@@ -188,6 +214,18 @@ namespace Ogre
         int mStatus;
         size_t mCurrentPos;
         size_t mAvailIn;
+        /// Initial position of mCompressedStream and initial mAvailIn, to restart reading
+        size_t mCompressedStart{0};
+        size_t mInitialAvailIn{0};
+        /// Size of the internal state allocated by the z_stream
+        size_t mStateSize{0};
+
+        std::vector<RestartPoint> mRestartPoints;
+        size_t mRestartInterval{DEFAULT_RESTART_INTERVAL};
+
+        /// Compress when writing instead of holding the data in a temporary file
+        bool mStreamingWrite{false};
+        bool mDeflating{false};
         
         /// Cache for read data in case skipping around
         StaticCache<16 * OGRE_STREAM_TEMP_SIZE> mReadCache;
@@ -201,6 +239,14 @@ namespace Ogre
         void init();
         void destroy();
         void compressFinal();
+        void openTempFile();
+        void beginDeflate();
+        void deflateData(const void* buf, size_t count, int flush);
+
+        void restartFromBeginning();
+        void addRestartPoint(size_t pos);
+        void restoreRestartPoint(const RestartPoint& point);
+        void seekRead(size_t pos);
 
         auto getAvailInForSinglePass() -> size_t;
     public:
@@ -244,6 +290,31 @@ namespace Ogre
             will actually be executed as passthroughs as a fallback. 
         */
         [[nodiscard]] auto isCompressedStreamValid() const noexcept -> bool { return mStreamType != Invalid; }
+
+        /** Sets the number of uncompressed bytes between read restart points.
+        @remarks
+            Each restart point keeps a copy of the decompressor state of about
+            44 KiB, so the interval trades memory for the cost of a seek, which
+            decompresses at most @c interval bytes beyond the last cached ones.
+            Restart points are recorded as the data is read for the first time.
+            0 disables them, seeking backwards then decompresses from the start.
+        */
+        void setRestartInterval(size_t interval);
+        /// Gets the number of uncompressed bytes between read restart points
+        [[nodiscard]] auto getRestartInterval() const noexcept -> size_t { return mRestartInterval; }
+
+        /** Sets whether written data is compressed right away.
+        @remarks
+            By default, written data is held in a temporary file and compressed on
+            close(), so that the writer is free to seek around, e.g. to patch in sizes.
+            A streaming stream compresses into the underlying stream as the data is
+            written, without any temporary file, but does not support seek() and skip().
+        @note
+            Must be called before the first write.
+        */
+        void setStreamingWrite(bool streaming);
+        /// Gets whether written data is compressed right away
+        [[nodiscard]] auto getStreamingWrite() const noexcept -> bool { return mStreamingWrite; }
         
         /** @copydoc DataStream::read
          */
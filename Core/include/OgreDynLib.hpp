@@ -56,6 +56,8 @@ namespace Ogre {
         String mName;
         /// Gets the last loading error
         auto dynlibError() -> String;
+        /// Gets the name of the file to open, with the platform extension
+        [[nodiscard]] auto getFileName() const -> String;
     public:
         /** Default constructor - used by DynLibManager.
             @warning
@@ -70,6 +72,13 @@ namespace Ogre {
         /** Load the library
         */
         void load();
+        /** Opens the library without logging or raising an error.
+        @remarks
+            Unlike load this may be called from any thread, which DynLibManager::preload
+            does to open several libraries at once.
+        @return Whether the library could be opened
+        */
+        auto open() noexcept -> bool;
         /** Unload the library
         */
         void unload();
@@ -93,6 +102,9 @@ namespace Ogre {
 
         /// Handle to the loaded library.
         DYNLIB_HANDLE mInst;
+    public:
+        /// Whether the library is open
+        [[nodiscard]] auto isLoaded() const noexcept -> bool { return mInst != nullptr; }
     };
     /** @} */
     /** @} */
@@ -30,8 +30,11 @@ export module Ogre.Core:DynLibManager;
 export import :MemoryAllocatorConfig;
 export import :Prerequisites;
 export import :Singleton;
+export import :StringVector;
 
+export import <functional>;
 export import <map>;
+export import <memory>;
 export import <string>;
 
 export
@@ -53,7 +56,7 @@ class DynLib;
     class DynLibManager: public Singleton<DynLibManager>, public DynLibAlloc
     {
     private:
-        using DynLibList = std::map<std::string_view, ::std::unique_ptr<DynLib>>;
+        using DynLibList = std::map<String, ::std::unique_ptr<DynLib>, std::less<>>;
         DynLibList mLibList;
     public:
         /** Default constructor.
@@ -77,6 +80,17 @@ class DynLib;
         */
         auto load(std::string_view filename) -> DynLib*;
 
+        /** Opens several libraries at once, ahead of loading them.
+        @remarks
+            The libraries that are not loaded yet are opened concurrently, so the time
+            the loader spends reading and relocating them overlaps. load then returns
+            them as already open. Libraries that could not be opened are left out, load
+            opens them again and reports the error once they are asked for.
+        @param filenames
+            The names of the libraries. The extension can be omitted.
+        */
+        void preload(const StringVector& filenames);
+
         /** Unloads the passed library.
         @param lib
             The library.
@@ -38,7 +38,7 @@ export import :RenderOperation;
 export import :Vector;
 
 export import <algorithm>;
-export import <map>;
+export import <unordered_map>;
 export import <utility>;
 export import <vector>;
 
@@ -243,15 +243,15 @@ namespace Ogre {
                 return a.indexSet < b.indexSet;
             }
         };
-        /** Comparator for unique vertex list */
-        struct vectorLess {
-            auto operator()(const Vector3& a, const Vector3& b) const -> bool
+        /** Hash for unique vertex list, treating -0 and +0 alike as operator== does */
+        struct vectorHash {
+            auto operator()(const Vector3& v) const -> size_t;
+        };
+        /** Hash for the edge map */
+        struct edgeHash {
+            auto operator()(const std::pair<size_t, size_t>& e) const -> size_t
             {
-                if (a.x < b.x) return true;
-                if (a.x > b.x) return false;
-                if (a.y < b.y) return true;
-                if (a.y > b.y) return false;
-                return a.z < b.z;
+                return e.first * 0x9E3779B97F4A7C15ull ^ e.second;
             }
         };
 
@@ -264,15 +264,21 @@ namespace Ogre {
         CommonVertexList mVertices;
         EdgeData* mEdgeData{nullptr};
         /// Map for identifying common vertices
-        using CommonVertexMap = std::map<Vector3, size_t, vectorLess>;
+        using CommonVertexMap = std::unordered_map<Vector3, size_t, vectorHash>;
         CommonVertexMap mCommonVertexMap;
         /** Edge map, used to connect edges. Note we allow many triangles on an edge,
         after connected an existing edge, we will remove it and never used again.
         */
-        using EdgeMap = std::multimap<std::pair<size_t, size_t>, std::pair<size_t, size_t>>;
+        using EdgeMap = std::unordered_multimap<std::pair<size_t, size_t>, std::pair<size_t, size_t>, edgeHash>;
         EdgeMap mEdgeMap;
+        /// Tightly packed positions of each vertex set, read once for all its index sets
+        std::vector<std::vector<float>> mPositions;
 
         void buildTrianglesEdges(const Geometry &geometry);
+        /// Reads the positions of a vertex set into mPositions
+        void readPositions(size_t vertexSet);
+        /// Computes the face normals of all triangles, several edge group blocks at once
+        void calculateFaceNormals();
 
         /// Finds an existing common vertex, or inserts a new one
         auto findOrCreateCommonVertex(const Vector3& vec, size_t vertexSet, 
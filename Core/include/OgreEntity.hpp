@@ -31,6 +31,7 @@ module;
 
 export module Ogre.Core:Entity;
 
+export import :AnimationState;
 export import :AxisAlignedBox;
 export import :Common;
 export import :HardwareBufferManager;
@@ -44,6 +45,7 @@ export import :Renderable;
 export import :Resource;
 export import :ResourceGroupManager;
 export import :ShadowCaster;
+export import :SkeletonPoseCache;
 export import :SharedPtr;
 export import :Vector;
 
@@ -63,6 +65,7 @@ class Light;
 class Node;
 class RenderQueue;
 class SkeletonInstance;
+class SkinnedVertexCache;
 struct Sphere;
 class SubEntity;
 class TagPoint;
@@ -114,6 +117,20 @@ class VertexData;
         using EntitySet = std::set<Entity *>;
         using SchemeHardwareAnimMap = std::vector<std::pair<unsigned short, bool>>;
         using SubEntityList = std::vector<SubEntity *>;
+
+        /// A reduced level of skeletal animation detail, see setAnimationLodLevels
+        struct AnimationLodLevel
+        {
+            /// The LOD value from which on the level is used, in the user units of the mesh LodStrategy
+            Real userValue{0};
+            /// The skeleton is evaluated once every this many frames
+            ushort updateInterval{1};
+            /** Per bone handle weights applied on top of the animation weights, like a
+                AnimationState::BoneBlendMask. Bones weighted 0 stay in their reset pose and
+                their tracks are skipped. Empty to animate all bones. */
+            AnimationState::BoneBlendMask boneMask;
+        };
+        using AnimationLodLevelList = std::vector<AnimationLodLevel>;
     private:
 
         /** Private constructor (instances cannot be created directly).
@@ -216,6 +233,8 @@ class VertexData;
 
         /// Number of hardware poses supported by materials.
         ushort mHardwarePoseCount;
+        /// Do the materials blend the poses of the shared geometry from the pose texture?
+        bool mHardwarePoseTexture;
         ushort mNumBoneMatrices;
         /// Cached bone matrices, including any world transform.
         Affine3 *mBoneWorldMatrices;
@@ -244,6 +263,12 @@ class VertexData;
         */
         auto cacheBoneMatrices() -> bool;
 
+        /** Applies the animation states and computes the bone matrices, or takes them
+            from the SceneManager's SkeletonPoseCache if another entity computed the pose. */
+        void evaluateBoneMatrices(const AnimationState::BoneBlendMask* boneMask, Affine3* matrices);
+        /// Scratch storage of evaluateBoneMatrices
+        SkeletonPoseCache::Key mPoseKey;
+
         /** Flag indicating whether hardware animation is supported by this entities materials
             data is saved per scehme number.
         */
@@ -264,6 +289,27 @@ class VertexData;
         /// Index of maximum detail LOD (NB lower index is higher detail).
         ushort mMaxMeshLodIndex;
 
+        /// See setAnimationLodLevels
+        AnimationLodLevelList mAnimationLodLevels;
+        /// The level values transformed by the mesh LodStrategy, with the full detail base value first
+        std::vector<Real> mAnimationLodValues;
+        /// The animation LOD calculated by _notifyCurrentCamera, 0 is full detail
+        ushort mAnimationLodIndex{0};
+        /// Frame of mAnimationLodIndex, the most detailed level wins among the cameras of a frame
+        unsigned long mAnimationLodFrame{0};
+        /// Frame in which the skeleton was last evaluated
+        unsigned long mAnimationLodEvaluatedFrame{0};
+        bool mAnimationLodInterpolation{false};
+        /// The bone matrices when the skeleton was last evaluated, and the ones evaluated then
+        std::vector<Affine3> mAnimationLodFromMatrices, mAnimationLodToMatrices;
+
+        /// See setSkinningCacheMaterialName, empty when disabled
+        String mSkinningCacheMaterialName;
+        /// GPU skinned copy of the shared geometry
+        std::unique_ptr<SkinnedVertexCache> mSkinnedVertexCache;
+        /// Whether the skinned vertex caches are bound in place of software skinning this frame
+        bool mSkinningCacheActive{false};
+
         /// LOD bias factor, not transformed.
         Real mMaterialLodFactor;
         /// LOD bias factor, transformed for optimisation when calculating adjusted LOD value.
@@ -318,10 +364,18 @@ class VertexData;
         void applyVertexAnimation(bool hardwareAnimation, bool stencilShadows);
         /// Initialise the hardware animation elements for given vertex data.
         auto initHardwareAnimationElements(VertexData* vdata, ushort numberOfElements, bool animateNormals) -> ushort;
+        /// Initialise the pose weights for hardware pose animation through the pose texture.
+        void initHardwarePoseWeights(VertexData* vdata, ushort target);
         /// Are software vertex animation temp buffers bound?
         auto tempVertexAnimBuffersBound() const -> bool;
         /// Are software skeleton animation temp buffers bound?
         auto tempSkelAnimBuffersBound(bool requestNormals) const -> bool;
+        /// Have the skinned vertex caches of all visible geometry been created?
+        auto skinnedVertexCachesBound() const -> bool;
+        /// Can the skinning cache be used with the current render system?
+        auto isSkinningCacheSupported() const -> bool;
+        /// Skin all visible geometry into its skinned vertex cache
+        void updateSkinnedVertexCaches();
 
     public:
         /// Contains the child objects (attached to bones) indexed by name.
@@ -332,6 +386,8 @@ class VertexData;
 
         /// Bounding box that 'contains' all the mesh of each child entity.
         mutable AxisAlignedBox mFullBoundingBox;  // note: this exists only so that getBoundingBox() can return an AAB by reference
+        /// Bounds used while the mesh is not loaded
+        AxisAlignedBox mProxyBounds;
 
         ShadowRenderableList mShadowRenderables;
 
@@ -428,6 +484,17 @@ class VertexData;
 
         auto getBoundingBox() const noexcept -> const AxisAlignedBox& override;
 
+        /** Sets the bounds of the Entity while its Mesh is not loaded.
+        @remarks
+            An Entity created before its Mesh finished loading in the background draws
+            nothing until it is initialised. Meanwhile it is culled, queried and contributes
+            to the bounds of its node with these bounds, e.g. taken from a level file,
+            instead of none. The default null box leaves it invisible.
+        @see SceneManager::createEntityInBackground
+        */
+        void setProxyBounds(const AxisAlignedBox& bounds);
+        [[nodiscard]] auto getProxyBounds() const noexcept -> const AxisAlignedBox& { return mProxyBounds; }
+
         /// Merge all the child object Bounds a return it.
         auto getChildObjectsBoundingBox() const -> AxisAlignedBox;
 
@@ -542,6 +609,59 @@ class VertexData;
         */
         void setMaterialLodBias(Real factor, ushort maxDetailIndex = 0, ushort minDetailIndex = 99);
 
+        /** Sets the levels of detail for the skeletal animation of this entity.
+        @remarks
+            The level is chosen along with the mesh LOD, using the LodStrategy of the mesh
+            and the mesh LOD bias, but independently of the mesh LOD levels. Below the first
+            level the skeleton is evaluated every frame. Crowds far from the camera can then
+            be evaluated every few frames, and only for a subset of their bones.
+        @par
+            If an entity is seen by several cameras in a frame, the most detailed level is used.
+            Entities sharing a skeleton instance are evaluated with the level of the one
+            which is updated first.
+        @param levels The levels, sorted by their userValue the same way as mesh LOD values.
+            Empty to always evaluate at full detail.
+        */
+        void setAnimationLodLevels(const AnimationLodLevelList& levels);
+        /** Gets the levels of detail for the skeletal animation, see setAnimationLodLevels. */
+        [[nodiscard]] auto getAnimationLodLevels() const noexcept -> const AnimationLodLevelList& { return mAnimationLodLevels; }
+        /** Gets the animation LOD calculated for the current frame.
+        @return 0 for full detail, otherwise 1 + the index into getAnimationLodLevels
+        */
+        [[nodiscard]] auto getCurrentAnimationLodIndex() const noexcept -> ushort { return mAnimationLodIndex; }
+
+        /** Sets whether the bone matrices are interpolated in the frames between skeleton evaluations.
+        @remarks
+            When enabled, each evaluation starts blending the bone matrices from those displayed
+            towards the new pose, which is reached when the next evaluation is due. The motion
+            stays smooth at the cost of lagging one update interval behind. Otherwise the bones
+            hold their pose until the next evaluation.
+        */
+        void setAnimationLodInterpolation(bool enabled) { mAnimationLodInterpolation = enabled; }
+        /** Gets whether the bone matrices are interpolated between skeleton evaluations. */
+        [[nodiscard]] auto getAnimationLodInterpolation() const noexcept -> bool { return mAnimationLodInterpolation; }
+
+        /** Sets a material which skins this entity once per frame on the GPU.
+        @remarks
+            Instead of blending the vertices in software, each frame the skeleton is
+            updated the bind pose is skinned through the given material into a buffer
+            by transform feedback, see SkinnedVertexCache for what the material has to
+            provide. All passes of the frame, shadow casters included, then draw that
+            buffer, so the materials of the entity must not skin themselves - with a
+            skinning material the entity is hardware animated and this setting is ignored.
+        @par
+            Falls back to software skinning whenever the positions are needed on the CPU,
+            i.e. for stencil shadows and software animation requests, for geometry which
+            is also vertex animated, and if the render system lacks
+            Capabilities::HWRENDER_TO_VERTEX_BUFFER.
+        @param materialName The skinning material, or an empty string to disable.
+        */
+        void setSkinningCacheMaterialName(std::string_view materialName);
+        /** Gets the material set by setSkinningCacheMaterialName, empty if disabled. */
+        [[nodiscard]] auto getSkinningCacheMaterialName() const noexcept -> const String& { return mSkinningCacheMaterialName; }
+        /** Whether the vertices drawn this frame were skinned through the skinning cache. */
+        [[nodiscard]] auto isSkinningCacheActive() const noexcept -> bool { return mSkinningCacheActive; }
+
         /** Sets whether the polygon mode of this entire entity may be
             overridden by the camera detail settings.
         */
@@ -618,7 +738,8 @@ class VertexData;
             it. Therefore, this method will only return true if all the materials
             assigned to this entity have vertex programs assigned, and all those
             vertex programs must support 'includes_morph_animation true' if using
-            morph animation, 'includes_pose_animation true' if using pose animation
+            morph animation, 'includes_pose_animation true' or
+            'includes_pose_texture_animation true' if using pose animation
             and 'includes_skeletal_animation true' if using skeletal animation.
 
             Also note the the function returns value according to the current active
@@ -731,6 +852,15 @@ class VertexData;
         */
         auto _isSkeletonAnimated() const -> bool;
 
+        /** Brings the bone matrices up to date for the current frame.
+        @remarks
+            Normally done while the entity is queued for rendering. Entities which do not
+            share their skeleton may be updated concurrently, once
+            Skeleton::_prepareAnimationState was called for their animations.
+        @return Whether the bone matrices were recomputed
+        */
+        auto _updateBoneMatrices() -> bool;
+
         /** Advanced method to get the temporarily blended skeletal vertex information
             for entities which are software skinned.
         @remarks
@@ -25,6 +25,10 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 THE SOFTWARE.
 -----------------------------------------------------------------------------
 */
+module;
+
+#include <cstddef>
+
 export module Ogre.Core:FileSystem;
 
 export import :ArchiveFactory;
@@ -69,6 +73,18 @@ class Archive;
 
         /// Get whether hidden files are ignored during filesystem enumeration.
         static auto getIgnoreHidden() noexcept -> bool;
+
+        /** Set the size from which files opened read-only are memory mapped.
+        @remarks
+            Such files are returned as MemoryMappedDataStream instead of being read
+            through a FileStreamDataStream. Mapping every small file costs more than
+            reading it, so the default is 64 KiB. Use @c std::numeric_limits<size_t>::max()
+            to disable memory mapping.
+        */
+        static void setMemoryMapThreshold(size_t bytes);
+
+        /// Get the size from which files opened read-only are memory mapped.
+        static auto getMemoryMapThreshold() noexcept -> size_t;
     };
 
     class APKFileSystemArchiveFactory : public ArchiveFactory
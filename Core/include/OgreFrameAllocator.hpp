@@ -0,0 +1,101 @@
+// This file is part of the OGRE project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at https://www.ogre3d.org/licensing.
+module;
+
+#include <cstddef>
+
+export module Ogre.Core:FrameAllocator;
+
+export import :Platform;
+
+export import <atomic>;
+export import <functional>;
+export import <map>;
+export import <memory_resource>;
+export import <mutex>;
+export import <string>;
+export import <vector>;
+
+export
+namespace Ogre
+{
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup General
+    *  @{
+    */
+
+    /** Linear scratch memory for data that lives no longer than a frame.
+    @remarks
+        Allocations bump an offset into a single buffer and deallocation does nothing, the
+        whole buffer is made available again by reset, which Root calls at the start of
+        every frame. Requests that do not fit take overflow blocks from the global heap,
+        reset then grows the buffer to the peak of the frame, so that after a few frames
+        the transient data of the engine costs no heap allocation at all.
+    @par
+        allocate may be called from several threads at once, reset must not race with it.
+        Being a std::pmr::memory_resource, it is used through the pmr containers below:
+        @code
+        FrameVector<uint32> indices{Root::getSingleton().getFrameAllocator()};
+        @endcode
+    */
+    class FrameAllocator : public std::pmr::memory_resource
+    {
+    public:
+        /// @param capacity Initial size of the buffer in bytes
+        explicit FrameAllocator(size_t capacity = 256 * 1024);
+        ~FrameAllocator() override;
+
+        FrameAllocator(const FrameAllocator&) = delete;
+        auto operator=(const FrameAllocator&) -> FrameAllocator& = delete;
+
+        /** Frees everything allocated since the last reset.
+        @remarks
+            Frees the overflow blocks and, if there were any, replaces the buffer by one
+            large enough for all allocations since the last reset.
+        */
+        void reset();
+
+        /// Gets the bytes allocated since the last reset, including overflow blocks
+        [[nodiscard]] auto getUsed() const -> size_t;
+        /// Gets the most bytes used between two resets
+        [[nodiscard]] auto getPeak() const noexcept -> size_t { return mPeak; }
+        /// Gets the size of the buffer
+        [[nodiscard]] auto getCapacity() const noexcept -> size_t { return mCapacity; }
+
+    protected:
+        auto do_allocate(size_t bytes, size_t alignment) -> void* override;
+        void do_deallocate(void* ptr, size_t bytes, size_t alignment) override;
+        [[nodiscard]] auto do_is_equal(const std::pmr::memory_resource& other) const noexcept -> bool override;
+
+    private:
+        struct Overflow
+        {
+            void* ptr;
+            size_t bytes;
+            size_t alignment;
+        };
+
+        uint8* mBuffer;
+        size_t mCapacity;
+        std::atomic<size_t> mUsed{0};
+        size_t mPeak{0};
+
+        std::mutex mOverflowMutex;
+        std::vector<Overflow> mOverflow;
+        std::atomic<size_t> mOverflowBytes{0};
+    };
+
+    /// A std::vector to be allocated from a FrameAllocator
+    template <typename T>
+    using FrameVector = std::pmr::vector<T>;
+    /// A std::map to be allocated from a FrameAllocator
+    template <typename K, typename V, typename P = std::less<>>
+    using FrameMap = std::pmr::map<K, V, P>;
+    /// A String to be allocated from a FrameAllocator
+    using FrameString = std::pmr::string;
+    /** @} */
+    /** @} */
+}
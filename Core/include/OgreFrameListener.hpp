@@ -129,6 +129,38 @@ namespace Ogre {
         virtual ~FrameListener() = default;
         
     };
+
+    /** A simulation step which runs concurrently with the rendering of the previous frame.
+        @remarks
+            The scene is not thread safe, so a simulation works on its own copy of the
+            state it advances and publishes it to the scene in apply(). Root calls, for
+            every frame:
+            -# apply(), on the main thread once the simulate() call of the last frame
+               completed, so that frame listeners and the rendering see its results
+            -# the FrameListener::frameStarted callbacks
+            -# simulate(), on a separate thread, while the render targets are updated
+            The results of a simulation step are therefore rendered one frame later,
+            in exchange for hiding the cost of updating and submitting the scene.
+        @see Root::setFrameSimulation
+    */
+    class FrameSimulation
+    {
+    public:
+        /** Advances the simulation by one frame.
+            @remarks
+                Called on a separate thread, this must not access the scene, resources or
+                the render system. Exceptions are rethrown on the main thread by the
+                next frame's Root::_fireFrameStarted.
+        */
+        virtual void simulate(const FrameEvent& evt) = 0;
+
+        /** Writes the results of the last simulate() call to the scene, e.g. as node
+            transforms. Called on the main thread while nothing is rendered.
+        */
+        virtual void apply() = 0;
+
+        virtual ~FrameSimulation() = default;
+    };
     /** @} */
     /** @} */
 }
@@ -55,6 +55,31 @@ struct Sphere;
     /** \addtogroup Scene
     *  @{
     */
+    /** A batch of bounding boxes stored as centre and half size arrays.
+    @remarks
+        This is the input of the batched Frustum::isVisible. Null boxes are stored so
+        that they are never visible and infinite boxes so that they always are.
+    */
+    struct AxisAlignedBoxBatch
+    {
+        /// Maximum number of boxes in a batch
+        static constexpr size_t CAPACITY = 64;
+
+        alignas(16) float centreX[CAPACITY];
+        alignas(16) float centreY[CAPACITY];
+        alignas(16) float centreZ[CAPACITY];
+        alignas(16) float halfSizeX[CAPACITY];
+        alignas(16) float halfSizeY[CAPACITY];
+        alignas(16) float halfSizeZ[CAPACITY];
+        /// Number of boxes in the batch
+        size_t size{0};
+
+        /// Appends a box, the batch must not be full
+        void push_back(const AxisAlignedBox& box);
+        [[nodiscard]] auto full() const noexcept -> bool { return size == CAPACITY; }
+        void clear() noexcept { size = 0; }
+    };
+
     /** Specifies orientation mode.
     */
     enum class OrientationMode : uint8
@@ -428,6 +453,17 @@ struct Sphere;
         */
         virtual auto isVisible(const AxisAlignedBox& bound, FrustumPlane* culledBy = nullptr) const -> bool;
 
+        /** Tests a batch of boxes against the Frustum.
+        @remarks
+            Gives the same results as testing each box individually, but uses the
+            SIMD kernels of OptimisedUtil to cull several boxes at once.
+        @param bounds
+            Bounding boxes to be checked (world space).
+        @param visible
+            Array of at least bounds.size entries, set to 1 for every visible box and 0 otherwise.
+        */
+        virtual void isVisible(const AxisAlignedBoxBatch& bounds, uint8* visible) const;
+
         /** Tests whether the given container is visible in the Frustum.
         @param bound
             Bounding sphere to be checked (world space).
@@ -0,0 +1,243 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+module;
+
+#include <cstddef>
+
+export module Ogre.Core:GpuParticleRenderer;
+
+export import :ColourValue;
+export import :Common;
+export import :FactoryObj;
+export import :Math;
+export import :ParticleSystemRenderer;
+export import :Prerequisites;
+export import :Renderable;
+export import :Vector;
+
+export import <memory>;
+export import <vector>;
+
+export
+namespace Ogre {
+class Camera;
+class Node;
+class Particle;
+class RenderQueue;
+class VertexData;
+class VertexDeclaration;
+
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Effects
+    *  @{
+    */
+
+    /** Specialisation of ParticleSystemRenderer which simulates the particles on the GPU.
+    @remarks
+        The state of up to max_particles particles is kept in a RenderToVertexBuffer, which
+        is rendered into itself every update through the simulation material (see
+        setSimulationMaterialName), i.e. advanced with transform feedback. The ParticleSystem
+        does not create any particles of its own with this renderer, see
+        ParticleSystemRenderer::_simulateParticles, so the CPU cost per frame does not depend
+        on the number of particles.
+    @par
+        Each particle is a point with the following layout:
+        - POSITION: position (float3)
+        - DIFFUSE: colour (float4)
+        - TEXCOORD0: direction, time to live
+        - TEXCOORD1: width, height, total time to live, unused
+        - TEXCOORD2: rotation, rotation speed, pending emissions, emitter index + 1
+        The buffer starts with one launcher point per emitter of the system, identified by
+        a non zero TEXCOORD2.w. The geometry program of the simulation material is the GPU
+        emitter program: it passes the launchers through and emits the new particles of
+        the update from them, advances all other particles and drops the expired ones.
+        These float4 uniforms are set if the programs declare them:
+        - particleTime: elapsed seconds, total simulated seconds
+        - particleSize: default width and height of the system
+        - emitterPosition[]: position, emission rate
+        - emitterDirection[]: direction, angle in radians
+        - emitterVelocity[]: min and max velocity, min and max time to live
+        - emitterColourStart[] and emitterColourEnd[]: the colour range
+        - affectorForce: force added to the direction per second
+        - affectorColourChange: colour added per second
+        - affectorScale: width and height added per second
+        - affectorRotation: min and max rotation speed in radians per second
+        The emitter arrays hold at most MAX_EMITTERS entries. Only the settings listed
+        above are taken from the emitters, and only the linear force, colour fader, scaler
+        and rotator effects of the settings of this class are supported; the affectors of
+        the system are ignored. The default simulation material in Media/Main implements
+        all of it for GLSL with geometry shaders.
+    @par
+        The particles are drawn as a point list with the material of the system, which
+        therefore needs point sprites or a program expanding the points. There is no
+        sorting, and the bounds are derived from the emitter settings; if particles are
+        kept in world space, moving the node leaves the older ones outside of them.
+    */
+    class GpuParticleRenderer : public ParticleSystemRenderer, public Renderable
+    {
+    public:
+        /// Maximum number of emitters of a system taken into account
+        static constexpr size_t MAX_EMITTERS = 8;
+
+        GpuParticleRenderer();
+        ~GpuParticleRenderer() override;
+
+        /** Sets the maximum number of particles simulated at once, 65536 by default.
+        @remarks
+            The quota of the ParticleSystem does not apply as it only limits CPU particles.
+        */
+        void setMaxParticles(size_t maxParticles);
+        [[nodiscard]] auto getMaxParticles() const noexcept -> size_t { return mMaxParticles; }
+
+        /// Sets the material advancing the particles, see the class description
+        void setSimulationMaterialName(std::string_view name);
+        [[nodiscard]] auto getSimulationMaterialName() const noexcept -> std::string_view { return mSimulationMaterialName; }
+
+        /// Sets the force added to the direction of all particles per second
+        void setForce(const Vector3& force) { mForce = force; }
+        [[nodiscard]] auto getForce() const noexcept -> const Vector3& { return mForce; }
+
+        /// Sets the colour added to all particles per second
+        void setColourChange(const ColourValue& change) { mColourChange = change; }
+        [[nodiscard]] auto getColourChange() const noexcept -> const ColourValue& { return mColourChange; }
+
+        /// Sets the amount added to width and height of all particles per second
+        void setScaleRate(Real rate) { mScaleRate = rate; }
+        [[nodiscard]] auto getScaleRate() const noexcept -> Real { return mScaleRate; }
+
+        /// Sets the range the rotation speed of new particles is picked from
+        void setRotationSpeedRange(const Radian& minSpeed, const Radian& maxSpeed)
+        {
+            mMinRotationSpeed = minSpeed;
+            mMaxRotationSpeed = maxSpeed;
+        }
+        [[nodiscard]] auto getMinRotationSpeed() const noexcept -> const Radian& { return mMinRotationSpeed; }
+        [[nodiscard]] auto getMaxRotationSpeed() const noexcept -> const Radian& { return mMaxRotationSpeed; }
+
+        /// @copydoc ParticleSystemRenderer::getType
+        [[nodiscard]] auto getType() const noexcept -> std::string_view override;
+        /// @copydoc ParticleSystemRenderer::_simulateParticles
+        auto _simulateParticles(ParticleSystem* system, Real timeElapsed, AxisAlignedBox& bounds) -> bool override;
+        /// @copydoc ParticleSystemRenderer::_updateRenderQueue
+        void _updateRenderQueue(RenderQueue* queue,
+            std::vector<Particle*>& currentParticles, bool cullIndividually) override;
+        /// @copydoc ParticleSystemRenderer::visitRenderables
+        void visitRenderables(Renderable::Visitor* visitor, bool debugRenderables = false) override;
+        void _setMaterial(MaterialPtr& mat) override { mMaterial = mat; }
+        /// @copydoc ParticleSystemRenderer::_notifyCurrentCamera
+        void _notifyCurrentCamera(Camera* cam) override {}
+        /// @copydoc ParticleSystemRenderer::_notifyParticleQuota
+        void _notifyParticleQuota(size_t quota) override {}
+        /// @copydoc ParticleSystemRenderer::_notifyAttached
+        void _notifyAttached(Node* parent, bool isTagPoint = false) override { mParentNode = parent; }
+        /// @copydoc ParticleSystemRenderer::_notifyDefaultDimensions
+        void _notifyDefaultDimensions(Real width, Real height) override { mDefaultSize = {width, height}; }
+        /// @copydoc ParticleSystemRenderer::setRenderQueueGroup
+        void setRenderQueueGroup(RenderQueueGroupID queueID) override { mRenderQueueID = queueID; }
+        /// @copydoc ParticleSystemRenderer::setRenderQueueGroupAndPriority
+        void setRenderQueueGroupAndPriority(RenderQueueGroupID queueID, ushort priority) override
+        {
+            mRenderQueueID = queueID;
+            mRenderQueuePriority = priority;
+        }
+        /// @copydoc ParticleSystemRenderer::setKeepParticlesInLocalSpace
+        void setKeepParticlesInLocalSpace(bool keepLocal) override { mLocalSpace = keepLocal; }
+        /// @copydoc ParticleSystemRenderer::_getSortMode
+        [[nodiscard]] auto _getSortMode() const -> SortMode override { return SortMode::Distance; }
+
+        /// @copydoc Renderable::getMaterial
+        [[nodiscard]] auto getMaterial() const noexcept -> const MaterialPtr& override { return mMaterial; }
+        /// @copydoc Renderable::getRenderOperation
+        void getRenderOperation(RenderOperation& op) override;
+        /// @copydoc Renderable::getWorldTransforms
+        void getWorldTransforms(Matrix4* xform) const override;
+        /// @copydoc Renderable::getSquaredViewDepth
+        auto getSquaredViewDepth(const Camera* cam) const -> Real override;
+        /// @copydoc Renderable::getLights
+        [[nodiscard]] auto getLights() const noexcept -> const LightList& override { return mLightList; }
+
+    private:
+        /// (Re)creates the simulation stage for the current emitters
+        void createSimulation();
+        /// Sets the uniforms of a program of the simulation material
+        void updateSimulationParameters(const GpuProgramParametersSharedPtr& params);
+        static void defineParticleLayout(VertexDeclaration* decl);
+
+        MaterialPtr mMaterial;
+        String mSimulationMaterialName;
+        size_t mMaxParticles{65536};
+
+        /// Affector settings
+        Vector3 mForce{Vector3::ZERO};
+        ColourValue mColourChange{0, 0, 0, 0};
+        Real mScaleRate{0};
+        Radian mMinRotationSpeed{0};
+        Radian mMaxRotationSpeed{0};
+
+        /// Emitter settings gathered by _simulateParticles, one entry per launcher
+        std::vector<Vector4> mEmitterPosition;
+        std::vector<Vector4> mEmitterDirection;
+        std::vector<Vector4> mEmitterVelocity;
+        std::vector<ColourValue> mEmitterColourStart;
+        std::vector<ColourValue> mEmitterColourEnd;
+
+        /// Time simulated by the system but not yet on the GPU
+        Real mPendingTime{0};
+        Real mTotalTime{0};
+        Vector2 mDefaultSize{100, 100};
+        bool mLocalSpace{false};
+        Node* mParentNode{nullptr};
+        SceneManager* mSceneManager{nullptr};
+        RenderQueueGroupID mRenderQueueID{RenderQueueGroupID::MAIN};
+        ushort mRenderQueuePriority{Renderable::DEFAULT_PRIORITY};
+        LightList mLightList;
+
+        /// One launcher point per emitter, the input of the first simulation step
+        std::unique_ptr<VertexData> mLauncherData;
+        std::unique_ptr<Renderable> mLauncherSource;
+        size_t mNumLaunchers{0};
+        RenderToVertexBufferSharedPtr mSimulation;
+        /// The simulated particles without the launchers, for drawing
+        std::unique_ptr<VertexData> mDrawData;
+    };
+
+    /** Factory class for GpuParticleRenderer */
+    class GpuParticleRendererFactory : public ParticleSystemRendererFactory
+    {
+    public:
+        /// @copydoc FactoryObj::getType
+        [[nodiscard]] auto getType() const noexcept -> std::string_view override;
+        /// @copydoc FactoryObj::createInstance
+        auto createInstance( std::string_view name ) -> ParticleSystemRenderer* override;
+    };
+    /** @} */
+    /** @} */
+
+} // namespace Ogre
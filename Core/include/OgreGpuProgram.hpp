@@ -85,6 +85,8 @@ struct GpuNamedConstants;
     bool mSkeletalAnimation{false};
     /// Does this (vertex) program include morph animation?
     bool mMorphAnimation{false};
+    /// Does this (vertex) program include pose animation through the pose texture?
+    bool mPoseTextureAnimation{false};
     /// Does this (vertex) program require support for vertex texture fetch?
     bool mVertexTextureFetch{false};
     /// Does this (geometry) program require adjacency information?
@@ -229,6 +231,17 @@ struct GpuNamedConstants;
     virtual void setPoseAnimationIncluded(ushort poseCount)
     { mPoseAnimation = poseCount; }
 
+    /** Sets whether a vertex program blends any number of poses from the pose texture.
+        @remarks
+        Instead of a vertex stream per pose, the program samples the offsets of all the poses
+        of its geometry from Mesh::getPoseTexture and weights them with the
+        GpuProgramParameters::AutoConstantType::ANIMATION_POSE_WEIGHTS array, so the number of
+        blended poses is not limited by the free texture coordinates. Implies
+        isPoseAnimationIncluded and requires vertex texture fetch.
+    */
+    virtual void setPoseTextureAnimationIncluded(bool included)
+    { mPoseTextureAnimation = included; }
+
     /** Returns whether a vertex program includes the required instructions
         to perform morph animation.
         @remarks
@@ -243,7 +256,11 @@ struct GpuNamedConstants;
         If this returns true, OGRE will not blend the geometry according to
         pose animation, it will expect the vertex program to do it.
     */
-    virtual auto isPoseAnimationIncluded() const noexcept -> bool { return mPoseAnimation > 0; }
+    virtual auto isPoseAnimationIncluded() const noexcept -> bool { return mPoseAnimation > 0 || isPoseTextureAnimationIncluded(); }
+    /** Returns whether a vertex program blends the poses from the pose texture, see
+        setPoseTextureAnimationIncluded.
+    */
+    virtual auto isPoseTextureAnimationIncluded() const noexcept -> bool { return mPoseTextureAnimation; }
     /** Returns the number of simultaneous poses the vertex program can
         blend, for use in pose animation.
     */
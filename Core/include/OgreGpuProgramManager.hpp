@@ -43,6 +43,7 @@ export import :ResourceManager;
 export import :SharedPtr;
 export import :Singleton;
 
+export import <filesystem>;
 export import <map>;
 export import <memory>;
 export import <set>;
@@ -105,12 +106,27 @@ namespace Ogre {
     protected:
 
         SharedParametersMap mSharedParametersMap;
-        std::map<uint32, Microcode> mMicrocodeCache;
+        mutable std::map<uint32, Microcode> mMicrocodeCache;
         bool mSaveMicrocodesToCache;
+        /// The file the cache is kept in, see setMicrocodeCacheFile
+        std::filesystem::path mMicrocodeCacheFile;
+        mutable bool mMicrocodeCacheFileOpened{false};
+        /// The file as it was opened, microcode is only taken from it when asked for
+        mutable MemoryDataStreamPtr mMicrocodeMapping;
+        /// Offset and size of the microcode of each program in mMicrocodeMapping
+        mutable std::map<uint32, std::pair<size_t, size_t>> mMappedMicrocodes;
+        /// Size of the valid part of the file, records are appended behind it
+        mutable size_t mMicrocodeCacheFileSize{0};
         bool mCacheDirty;           // When this is true the cache is 'dirty' and should be resaved to disk.
+        bool mLinkProgramsOnLoad{false};
             
         static auto addRenderSystemToName( std::string_view name ) -> String;
 
+        /// Opens the file set with setMicrocodeCacheFile when the cache is first used
+        void openMicrocodeCacheFile() const;
+        /// Appends a record to the cache file, a removal if @c microcode is @c nullptr
+        void appendMicrocodeToFile(uint32 id, const Microcode& microcode);
+
         /// Generic create method
         auto createImpl(std::string_view name, ResourceHandle handle,
             std::string_view group, bool isManual, ManualResourceLoader* loader,
@@ -252,6 +268,19 @@ namespace Ogre {
         */
         void setSaveMicrocodesToCache( bool val );
 
+        /** Get if passes start linking their programs when loaded, see setLinkProgramsOnLoad
+        */
+        auto getLinkProgramsOnLoad() const noexcept -> bool { return mLinkProgramsOnLoad; }
+        /** Set if passes start linking their programs when loaded
+        @remarks
+            Loading a Pass then calls RenderSystem::_prelinkGpuPrograms, so render systems
+            linking program combinations can start the work before the first draw, instead
+            of blocking the frame the pass first appears in.
+        @note
+            Only enable this if materials are loaded from the rendering thread.
+        */
+        void setLinkProgramsOnLoad(bool val) { mLinkProgramsOnLoad = val; }
+
         /** Returns true if the microcodecache changed during the run.
         */
         auto isCacheDirty() const noexcept -> bool;
@@ -291,6 +320,24 @@ namespace Ogre {
         @param stream The source stream
         */
         void loadMicrocodeCache( DataStreamPtr stream );
+
+        /** Keeps the microcode cache in a file, replacing saveMicrocodeCache and loadMicrocodeCache.
+        @remarks
+            The file is opened when the cache is first used, after the render system was
+            initialised. If it was written for another render system, device or driver version
+            it is started anew, as the driver would reject the binaries anyway. Otherwise it is
+            memory mapped and only indexed, the microcode of a program is taken from the mapping
+            when the program is linked.
+        @par
+            Microcode added to the cache is appended to the file right away, so every program is
+            compiled once after a driver update, not once per session, and nothing has to be
+            saved on shutdown. Records that were replaced stay in the file until it is started
+            anew.
+        @param path The file, an empty path keeps the cache in memory again
+        */
+        void setMicrocodeCacheFile(const std::filesystem::path& path);
+        /// The file set with setMicrocodeCacheFile
+        auto getMicrocodeCacheFile() const noexcept -> const std::filesystem::path& { return mMicrocodeCacheFile; }
         
         /** Add a new factory object for programs of a given language. */
         void addFactory(GpuProgramFactory* factory);
@@ -446,6 +446,52 @@ template <int dims, typename T> struct Vector;
     */
     using ConstantList = std::vector<uchar>;
 
+    /** Packed uniform buffer layout of a set of named constants.
+        @remarks
+        Places the constants as the members of a std140 or std430 uniform block and
+        records which bytes of the ConstantList go where, merging ranges which are
+        contiguous on both sides. Filling a mapped buffer is then a few memcpy calls,
+        without any name lookups or per constant calls.
+        @par
+        Members are laid out in the order of their physical index, which for
+        GpuSharedParameters is the order they were defined in. Samplers and
+        specialisation constants have no place in a buffer and are skipped.
+        A matrix @c matCxR is C columns of R components, copied in the order
+        they are stored in.
+    */
+    struct GpuConstantBufferLayout
+    {
+        /// Packing rules of the uniform block
+        enum class Packing : uint8
+        {
+            STD140,
+            STD430
+        };
+        /// A range of bytes copied from the constant list to the buffer
+        struct CopyEntry
+        {
+            uint32 srcOffset;
+            uint32 dstOffset;
+            uint32 size;
+
+            [[nodiscard]] auto operator==(const CopyEntry&) const noexcept -> bool = default;
+        };
+        using CopyList = std::vector<CopyEntry>;
+
+        /// Size of the packed buffer in bytes, a multiple of 16
+        size_t bufferSize{0};
+        /// Copies which fill the buffer, in increasing buffer offset
+        CopyList copies;
+
+        /// Lays out the given constants
+        static auto build(const GpuNamedConstants& constants, Packing packing) -> GpuConstantBufferLayout;
+
+        /// Packs the constants into a buffer of at least bufferSize bytes
+        void pack(const ConstantList& src, void* dst) const;
+        /// Unpacks the constants from a packed buffer
+        void unpack(const void* src, ConstantList& dst) const;
+    };
+
     /** A group of manually updated parameters that are shared between many parameter sets.
         @remarks
         Sometimes you want to set some common parameters across many otherwise
@@ -475,9 +521,17 @@ template <int dims, typename T> struct Vector;
         /// Optional rendersystem backed storage
         HardwareBufferPtr mHardwareBuffer;
 
+        /// Layout of the values in the rendersystem backed storage
+        mutable GpuConstantBufferLayout mBufferLayout;
+        /// Definitions version mBufferLayout was built for
+        mutable uint32 mBufferLayoutVersion{std::numeric_limits<uint32>::max()};
+
         /// Version number of the definitions in this buffer.
         uint32 mVersion{0};
 
+        /// Incremented whenever the values are modified.
+        uint32 mValuesVersion{0};
+
 		/// Accumulated offset used to calculate uniform location.
 		size_t mOffset{0};
 
@@ -507,6 +561,13 @@ template <int dims, typename T> struct Vector;
         */
         [[nodiscard]] auto getVersion() const noexcept -> uint32 { return mVersion; }
 
+        /** Get the version number of the values, which changes whenever the set is marked dirty.
+            @remarks
+            Unlike isDirty, this is not reset by _markClean, so every consumer can
+            track on its own whether it has seen the current values.
+        */
+        [[nodiscard]] auto getValuesVersion() const noexcept -> uint32 { return mValuesVersion; }
+
         /** Calculate the expected size of the shared parameter buffer based
             on constant definition data types.
         */
@@ -581,11 +642,17 @@ template <int dims, typename T> struct Vector;
         [[nodiscard]] auto getUnsignedIntPointer(size_t pos) const -> const uint* { return (const uint*)&mConstants[pos]; }
         /// Get a reference to the list of constants
         [[nodiscard]] auto getConstantList() const noexcept -> const ConstantList& { return mConstants; }
+        /** Get the std140 layout of the values in the rendersystem backed storage.
+            @remarks
+            Rebuilt whenever the definitions change. A HardwareBuffer set with
+            _setHardwareBuffer must hold at least GpuConstantBufferLayout::bufferSize bytes.
+        */
+        [[nodiscard]] auto getBufferLayout() const -> const GpuConstantBufferLayout&;
         /** Internal method that the RenderSystem might use to store optional data. */
         void _setHardwareBuffer(const HardwareBufferPtr& data) { mHardwareBuffer = data; }
         /** Internal method that the RenderSystem might use to store optional data. */
         [[nodiscard]] auto _getHardwareBuffer() const noexcept -> const HardwareBufferPtr& { return mHardwareBuffer; }
-        /// upload parameter data to GPU memory. Must have a HardwareBuffer
+        /// upload parameter data to GPU memory, packed according to getBufferLayout. Must have a HardwareBuffer
         void _upload() const;
         /// download data from GPU memory. Must have a writable HardwareBuffer
         void download();
@@ -614,6 +681,8 @@ template <int dims, typename T> struct Vector;
 
         /// Version of shared params we based the copydata on
         uint32 mCopyDataVersion;
+        /// Values version of the shared params last copied to the target
+        mutable uint32 mCopiedValuesVersion;
 
         void initCopyData();
 
@@ -625,6 +694,9 @@ template <int dims, typename T> struct Vector;
 
         /** Update the target parameters by copying the data from the shared
             parameters.
+            @remarks
+            Does nothing if the values did not change since the last copy, so the
+            parameters of every program sharing them are only updated once per change.
             @note This method  may not actually be called if the RenderSystem
             supports using shared parameters directly in their own shared buffer; in
             which case the values should not be copied out of the shared area
@@ -1210,6 +1282,14 @@ template <int dims, typename T> struct Vector;
             LIGHT_CUSTOM,
             /// Point params: size; constant, linear, quadratic attenuation
             POINT_PARAMS,
+            /** Provides the weights of all poses of the geometry for hardware pose animation
+                through the pose texture, see GpuProgram::setPoseTextureAnimationIncluded.
+
+                An array of float4 with the weight of pose row i of Mesh::getPoseTexture in
+                component i % 4 of element i / 4. This requires the array size in the
+                ’extra_params’ field, i.e. a quarter of the number of poses rounded up.
+            */
+            ANIMATION_POSE_WEIGHTS,
 
             UNKNOWN = 999
         };
@@ -1267,6 +1347,8 @@ template <int dims, typename T> struct Vector;
                 Used in case people used packed elements smaller than 4 (e.g. GLSL)
                 and bind an auto which is 4-element packed to it */
             uint8 elementCount;
+            /// AutoParamDataSource::getLastVersion when the value was last written, 0 if never
+            uint64 updatedVersion{0};
 
         AutoConstantEntry(AutoConstantType theType, size_t theIndex, uint32 theData,
                           GpuParamVariability theVariability, uint8 theElemCount = 4)
@@ -1313,6 +1395,8 @@ template <int dims, typename T> struct Vector;
         bool mIgnoreMissingParams{false};
         /// physical index for active pass iteration parameter real constant entry;
         size_t mActivePassIterationIndex;
+        /// The source the auto constants were last written from, see AutoConstantEntry::updatedVersion
+        const AutoParamDataSource* mLastAutoParamSource{nullptr};
 
         /// Return the variability for an auto constant
         static auto deriveVariability(AutoConstantType act) -> GpuParamVariability;
@@ -84,10 +84,12 @@ namespace Ogre
         GpuProgramPtr mProgram;
 
         /// Program parameters
-        GpuProgramParametersSharedPtr mParameters;
+        mutable GpuProgramParametersSharedPtr mParameters;
         
         /// Whether to recreate parameters next load
         bool mRecreateParams;
+        /// Whether mParameters may be shared with a copy, and so must be copied before handing it out
+        mutable bool mSharedParameters{false};
         GpuProgramType mType;
 
         void recreateParameters();
@@ -99,8 +101,14 @@ namespace Ogre
         */
         GpuProgramUsage(GpuProgramType gptype, Pass* parent);
 
-        /** Copy constructor */
-        GpuProgramUsage(const GpuProgramUsage& rhs, Pass* newparent);
+        /** Copy constructor
+        @param rhs The usage to copy
+        @param newparent The Pass this usage belongs to
+        @param shareParameters
+            Whether the copies share the parameters until getParameters is called on either of them,
+            which then makes its own copy. See Material::clone.
+        */
+        GpuProgramUsage(const GpuProgramUsage& rhs, Pass* newparent, bool shareParameters = false);
 
         ~GpuProgramUsage() override;
 
@@ -137,8 +145,16 @@ namespace Ogre
         */
         void setParameters(const GpuProgramParametersSharedPtr& params);
         /** Gets the parameters being used here. 
+        @remarks
+            If they are shared with a copy of this usage, this first makes a copy of them that only
+            this usage uses, as the caller may change them.
+        */
+        [[nodiscard]] auto getParameters() const -> const GpuProgramParametersSharedPtr&;
+        /** Gets the parameters without copying them when shared, for binding them to the RenderSystem.
+        @note
+            The automatic constants may be updated, the others must not be changed through this.
         */
-        [[nodiscard]] auto getParameters() const noexcept -> const GpuProgramParametersSharedPtr&;
+        [[nodiscard]] auto _getParameters() const -> const GpuProgramParametersSharedPtr&;
 
         /// Load this usage (and ensure program is loaded)
         void _load();
@@ -35,6 +35,8 @@ export module Ogre.Core:HardwareBuffer;
 export import :Exception;
 export import :Prerequisites;
 
+export import <atomic>;
+
 export
 namespace Ogre {
 
@@ -221,8 +223,49 @@ namespace Ogre {
             bool mShadowUpdated{false};
             bool mSuppressHardwareUpdate{false};
             bool mIsLocked{false};
+            /// @see setDiscardShadowBufferAfterUpload
+            bool mDiscardShadowAfterUpload{false};
+            bool mShadowBufferDiscarded{false};
             Usage mUsage;
-            
+
+            /// Bytes held by the shadow buffers of all hardware buffers
+            static inline std::atomic<size_t> msShadowBufferBytes{0};
+
+            /** Creates a system memory buffer of the size of this one, to shadow it.
+                Buffers supporting discardShadowBuffer have to implement this */
+            [[nodiscard]] virtual auto createShadowBufferImpl() const -> std::unique_ptr<HardwareBuffer> { return {}; }
+
+            /// Replaces the shadow buffer, keeping count of the shadow buffer bytes
+            void setShadowBuffer(std::unique_ptr<HardwareBuffer> shadowBuffer)
+            {
+                if (mShadowBuffer)
+                    msShadowBufferBytes -= mShadowBuffer->getSizeInBytes();
+                mShadowBuffer = std::move(shadowBuffer);
+                if (mShadowBuffer)
+                    msShadowBufferBytes += mShadowBuffer->getSizeInBytes();
+            }
+
+            /** Re-creates a discarded shadow buffer.
+            @param readBack Whether to fill it from the hardware buffer, unnecessary if it gets overwritten
+            */
+            void restoreShadowBuffer(bool readBack)
+            {
+                if (!mShadowBufferDiscarded)
+                    return;
+
+                std::unique_ptr<HardwareBuffer> shadowBuffer = createShadowBufferImpl();
+                OgreAssert(shadowBuffer, "This buffer cannot re-create its shadow buffer");
+                if (readBack)
+                {
+                    void* data = shadowBuffer->lock(0, mSizeInBytes, LockOptions::DISCARD);
+                    // without a shadow buffer, this reads from the hardware
+                    readData(0, mSizeInBytes, data);
+                    shadowBuffer->unlock();
+                }
+                setShadowBuffer(std::move(shadowBuffer));
+                mShadowBufferDiscarded = false;
+            }
+
             /// Internal implementation of lock()
             virtual auto lockImpl(size_t offset, size_t length, LockOptions options) -> void*
             {
@@ -247,7 +290,7 @@ namespace Ogre {
                     mUsage = HardwareBufferUsage::GPU_ONLY;
                 }
             }
-            virtual ~HardwareBuffer() = default;
+            virtual ~HardwareBuffer() { setShadowBuffer(nullptr); }
             /** Lock the buffer for (potentially) reading / writing.
             @param offset The byte offset from the start of the buffer to lock
             @param length The size of the area to lock, in bytes
@@ -259,6 +302,10 @@ namespace Ogre {
                 OgreAssert(!isLocked(), "Cannot lock this buffer: it is already locked");
                 OgreAssert((length + offset) <= mSizeInBytes, "Lock request out of bounds");
 
+                // overwriting all of it needs no read back
+                restoreShadowBuffer(!(offset == 0 && length == mSizeInBytes &&
+                                      (options == LockOptions::DISCARD || options == LockOptions::WRITE_ONLY)));
+
                 void* ret = nullptr;
                 if (mShadowBuffer)
                 {
@@ -306,6 +353,8 @@ namespace Ogre {
                     mShadowBuffer->unlock();
                     // Potentially update the 'real' buffer from the shadow buffer
                     _updateFromShadow();
+                    if (mDiscardShadowAfterUpload)
+                        discardShadowBuffer();
                 }
                 else
                 {
@@ -350,6 +399,9 @@ namespace Ogre {
                 }
 
                 mDelegate->writeData(offset, length, pSource, discardWholeBuffer);
+
+                if (mDiscardShadowAfterUpload)
+                    discardShadowBuffer();
             }
 
             /** Copy data from another buffer into this one.
@@ -413,7 +465,46 @@ namespace Ogre {
             /// Returns whether this buffer is held in system memory
             [[nodiscard]] auto isSystemMemory() const noexcept -> bool { return mSystemMemory; }
             /// Returns whether this buffer has a system memory shadow for quicker reading
-            [[nodiscard]] auto hasShadowBuffer() const -> bool { return mShadowBuffer || (mDelegate && mDelegate->hasShadowBuffer()); }
+            [[nodiscard]] auto hasShadowBuffer() const -> bool
+            {
+                return mShadowBuffer || mShadowBufferDiscarded || (mDelegate && mDelegate->hasShadowBuffer());
+            }
+
+            /** Releases the system memory of the shadow buffer, keeping the data on the hardware only.
+            @remarks
+                The next lock re-creates the shadow buffer, reading it back from the hardware unless
+                the lock overwrites the whole buffer, while readData and writeData access the hardware
+                buffer directly in the meantime. Does nothing while the buffer is locked or holds
+                changes not uploaded yet, e.g. due to suppressHardwareUpdate.
+            */
+            void discardShadowBuffer()
+            {
+                if (!mShadowBuffer || isLocked() || mShadowUpdated || mSuppressHardwareUpdate)
+                    return;
+                setShadowBuffer(nullptr);
+                mShadowBufferDiscarded = true;
+            }
+
+            /** Whether the shadow buffer was released by discardShadowBuffer and not re-created since */
+            [[nodiscard]] auto isShadowBufferDiscarded() const noexcept -> bool { return mShadowBufferDiscarded; }
+
+            /** Sets whether the shadow buffer is discarded after every lock and write.
+            @remarks
+                This keeps the system memory of buffers which are read rarely, e.g. static geometry
+                which is only read when building edge lists, to the duration of their locks, at the
+                cost of a read back from the hardware for every lock.
+                @see HardwareBufferManagerBase::setDiscardStaticShadowBuffers
+            */
+            void setDiscardShadowBufferAfterUpload(bool discard)
+            {
+                mDiscardShadowAfterUpload = discard;
+                if (discard)
+                    discardShadowBuffer();
+            }
+            [[nodiscard]] auto getDiscardShadowBufferAfterUpload() const noexcept -> bool { return mDiscardShadowAfterUpload; }
+
+            /// Gets the bytes held in system memory by the shadow buffers of all hardware buffers
+            [[nodiscard]] static auto getShadowBufferBytes() noexcept -> size_t { return msShadowBufferBytes; }
             /// Returns whether or not this buffer is currently locked.
             [[nodiscard]] auto isLocked() const noexcept -> bool { 
                 return mIsLocked || (mShadowBuffer && mShadowBuffer->isLocked());
@@ -194,6 +194,8 @@ class VertexDeclaration;
         static const size_t UNDER_USED_FRAME_THRESHOLD;
         /// Frame delay for BufferLicenseType::AUTOMATIC_RELEASE temporary buffers.
         static const size_t EXPIRED_DELAY_FRAME_THRESHOLD;
+        /// @see setDiscardStaticShadowBuffers
+        bool mDiscardStaticShadowBuffers{false};
 
         /// Creates a new buffer as a copy of the source, does not copy data.
         virtual auto makeBufferCopy(
@@ -277,6 +279,20 @@ class VertexDeclaration;
                                                       HardwareBufferUsage usage = HardwareBufferUsage::CPU_TO_GPU,
                                                       bool useShadowBuffer = false) -> HardwareBufferPtr;
 
+        /** Sets whether static buffers release their shadow buffer once its contents got uploaded.
+        @remarks
+            Applies to the vertex and index buffers created afterwards with a shadow buffer and
+            a usage without HardwareBufferUsage::CPU_ONLY, like the ones of most loaded meshes.
+            Their system memory copy only lives for the duration of a lock, and is read back
+            from the hardware buffer for any lock which does not overwrite the whole buffer.
+            @see HardwareBuffer::setDiscardShadowBufferAfterUpload
+        */
+        void setDiscardStaticShadowBuffers(bool discard) { mDiscardStaticShadowBuffers = discard; }
+        [[nodiscard]] auto getDiscardStaticShadowBuffers() const noexcept -> bool { return mDiscardStaticShadowBuffers; }
+
+        /** Gets the bytes currently held in system memory by the shadow buffers of all hardware buffers. */
+        [[nodiscard]] static auto getShadowBufferBytes() noexcept -> size_t { return HardwareBuffer::getShadowBufferBytes(); }
+
         /** Creates a new vertex declaration. */
         auto createVertexDeclaration() -> VertexDeclaration*;
         /** Destroys a vertex declaration. */
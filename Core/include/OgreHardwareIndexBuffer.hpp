@@ -58,6 +58,10 @@ namespace Ogre {
             uint8 mIndexSize;
             HardwareBufferManagerBase* mMgr;
             size_t mNumIndexes;
+
+        protected:
+            [[nodiscard]] auto createShadowBufferImpl() const -> std::unique_ptr<HardwareBuffer> override;
+
         public:
             /// Should be called by HardwareBufferManager
             HardwareIndexBuffer(HardwareBufferManagerBase* mgr, IndexType idxType, size_t numIndexes,
@@ -64,6 +64,9 @@ namespace Ogre {
             /// Checks if vertex instance data is supported by the render system
             virtual auto checkIfVertexInstanceDataIsSupported() -> bool;
 
+        protected:
+            [[nodiscard]] auto createShadowBufferImpl() const -> std::unique_ptr<HardwareBuffer> override;
+
         public:
             /// Should be called by HardwareBufferManager
             HardwareVertexBuffer(HardwareBufferManagerBase* mgr, size_t vertexSize, size_t numVertices,
@@ -164,6 +167,9 @@ namespace Ogre {
         SHORT4_NORM = 32,
         USHORT2_NORM = 33, /// unsigned shorts (normalized to 0..1)
         USHORT4_NORM = 34,
+        HALF2 = 35,  /// 16 bit floats
+        HALF4 = 36,
+        INT_10_10_10_2_NORM = 37,  /// signed 10 bit x, y, z and 2 bit w packed into 32 bits (normalized to -1..1)
         COLOUR = UBYTE4_NORM,  ///< @deprecated use UBYTE4_NORM
         COLOUR_ARGB = UBYTE4_NORM,  ///< @deprecated use UBYTE4_NORM
         COLOUR_ABGR = UBYTE4_NORM,  ///< @deprecated use VertexElementType::UBYTE4_NORM
@@ -0,0 +1,161 @@
+// This file is part of the OGRE project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at https://www.ogre3d.org/licensing.
+module;
+
+#include <cstddef>
+
+export module Ogre.Core:HiZBuffer;
+
+export import :CustomCompositionPass;
+export import :Matrix4;
+export import :Platform;
+export import :Prerequisites;
+export import :Vector;
+export import :VisibilityStage;
+
+export import <utility>;
+export import <vector>;
+
+export
+namespace Ogre {
+class Camera;
+class Pass;
+class RenderSystem;
+class SceneManager;
+class SceneNode;
+class Viewport;
+
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Scene
+    *  @{
+    */
+    /** A hierarchical depth buffer, built from the depth of the rendered frame and used for
+        occlusion culling in the next one.
+    @remarks
+        Register it with CompositorManager::registerCustomCompositionPass and run it as a
+        render_custom pass after the opaque objects were rendered, with the texture holding their
+        depth as input 0. Its w is read as the RTSS GBuffer writes it with
+        TargetLayout::NORMAL_VIEWDEPTH, the distance to the camera divided by the far clip
+        distance, and texels still cleared to 0 count as nothing rendered.
+    @par
+        Each level of the float texture returned by getTexture holds the largest distance of the
+        2x2 texels below it, level 0 those of the input, so every texel bounds the distance of all
+        surfaces it covers. It is rendered from the previous level of the same texture, which the
+        render system has to allow for distinct levels, as GL does.
+    @par
+        The GPU culled instancing reads it if given to InstanceManager::setGpuCullingHiZBuffer.
+        For the SceneManager a small level is copied to the CPU each frame, see setReadbackWidth,
+        and nodes are tested against it once the stage is added with
+        SceneManager::addVisibilityStage. Unlike OcclusionCulling this costs no query per node, and
+        unlike SoftwareOcclusionCulling every rendered object is an occluder, which suits dense
+        content like vegetation and debris.
+    @note
+        The depth is that of the previous frame, so objects which were hidden become visible a
+        frame late after they or their occluders moved. The copy to the CPU waits for the GPU to
+        finish the levels. An instance is meant for a single camera, the tests are skipped for the
+        other ones. Neither the stage nor the pass are owned by their managers, and have to be
+        removed from them before it is destroyed.
+    */
+    class HiZBuffer : public VisibilityStage, public CustomCompositionPass
+    {
+    public:
+        /// Statistics about the last culled frame
+        struct Stats
+        {
+            /// Number of nodes whose visibility was checked
+            size_t nodesTested{0};
+            /// Number of nodes skipped because they were occluded
+            size_t nodesCulled{0};
+        };
+
+        /** The state of the camera the buffer was built for, as the GPU culling programs receive it.
+        @remarks
+            A point projected by viewProj covers u = 0.5 + 0.5 * x / w, v = 0.5 - 0.5 * y / w of the
+            texture, rows from the top.
+        */
+        struct Frame
+        {
+            Matrix4 viewProj{Matrix4::IDENTITY};
+            /// World space position and far clip distance
+            Vector4 cameraPosition{Vector4::ZERO};
+            /// Width and height of level 0 and the number of levels
+            Vector4 size{Vector4::ZERO};
+        };
+
+        HiZBuffer();
+        ~HiZBuffer() override;
+
+        HiZBuffer(const HiZBuffer&) = delete;
+        auto operator=(const HiZBuffer&) -> HiZBuffer& = delete;
+
+        /** Sets the largest width of the level copied to the CPU, 64 by default.
+        @remarks
+            0 disables the copy, for the GPU culling alone.
+        */
+        void setReadbackWidth(uint32 width) { mMaxReadbackWidth = width; }
+        /** Gets the largest width of the level copied to the CPU. */
+        auto getReadbackWidth() const noexcept -> uint32 { return mMaxReadbackWidth; }
+
+        /** Gets the texture holding the levels, null until the pass was executed. */
+        auto getTexture() const noexcept -> const TexturePtr& { return mTexture; }
+
+        /** Gets the state of the camera the texture was built for. */
+        auto getFrame() const noexcept -> const Frame& { return mFrame; }
+
+        /** Gets the level copied to the CPU, row by row from the top.
+        @see getReadbackSize
+        */
+        auto getReadback() const noexcept -> const std::vector<float>& { return mReadback; }
+        /** Gets the width and height of the level copied to the CPU. */
+        auto getReadbackSize() const noexcept -> std::pair<uint32, uint32> { return {mReadbackWidth, mReadbackHeight}; }
+
+        /** Gets the statistics about the last culled frame. */
+        auto getStats() const noexcept -> const Stats& { return mStats; }
+
+        auto createOperation(CompositorInstance* instance, const CompositionPass* pass)
+            -> CompositorInstance::RenderSystemOperation* override;
+
+        /** Builds the levels from the depth of the camera and copies the small one to the CPU. */
+        void _build(SceneManager* sceneMgr, RenderSystem* rs, const TexturePtr& source, const Camera* cam);
+
+        /** Enables the tests if the buffer was built for this camera. */
+        void _beginFrame(const Camera* cam, SceneManager* sceneMgr) override;
+
+        /** Tests the screen rectangle of the bounds against the copied level.
+        @remarks
+            Always returns true outside of _beginFrame / _endFrame, without a copy, for infinite
+            bounds and bounds crossing the near plane of the camera the buffer was built for.
+        */
+        auto _isVisible(const SceneNode* node, const AxisAlignedBox& bounds) -> bool override;
+
+        void _endFrame(SceneManager* sceneMgr) override;
+
+        void _notifyCameraDestroyed(const Camera* cam) override;
+
+    private:
+        TexturePtr mTexture;
+        /// A viewport on each level of mTexture
+        std::vector<Viewport*> mLevelViewports;
+
+        Frame mFrame;
+        /// The camera mFrame and mReadback belong to
+        const Camera* mCamera{nullptr};
+
+        uint32 mMaxReadbackWidth{64};
+        uint32 mReadbackWidth{0};
+        uint32 mReadbackHeight{0};
+        std::vector<float> mReadback;
+
+        bool mActive{false};
+        Stats mStats;
+
+        void createTexture(uint32 width, uint32 height, std::string_view group);
+        void destroyTexture();
+    };
+    /** @} */
+    /** @} */
+
+}
@@ -36,6 +36,7 @@ export import :Prerequisites;
 export import :Resource;
 export import :SharedPtr;
 
+export import <map>;
 export import <utility>;
 export import <vector>;
 
@@ -151,8 +152,16 @@ struct GpuNamedConstants;
         /** Gets the entry point defined for this program. */
         auto getEntryPoint() const noexcept -> std::string_view { return mEntryPoint; }
 
-        /// Scan the source for \#include and replace with contents from OGRE resources
-        static auto _resolveIncludes(std::string_view source, Resource* resourceBeingLoaded, std::string_view fileName, bool supportsFilename = false) -> String;
+        /// Expanded include files by resource group and name, @see _resolveIncludes
+        using IncludeCache = std::map<String, String, std::less<>>;
+
+        /** Scan the source for \#include and replace with contents from OGRE resources
+        @param includeCache If given, the expansions of the include files are looked up there
+            before reading them and stored there afterwards. A cache must always be used with the
+            same supportsFilename and is not synchronised
+        */
+        static auto _resolveIncludes(std::string_view source, Resource* resourceBeingLoaded, std::string_view fileName,
+                                     bool supportsFilename = false, IncludeCache* includeCache = nullptr) -> String;
     };
     /** @} */
     /** @} */
@@ -0,0 +1,170 @@
+// This file is part of the OGRE project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at https://www.ogre3d.org/licensing.
+module;
+
+#include <cstddef>
+
+export module Ogre.Core:HitchMonitor;
+
+export import :MemoryAllocatorConfig;
+export import :Platform;
+export import :Prerequisites;
+export import :Profiler;
+export import :Singleton;
+
+export import <atomic>;
+export import <iosfwd>;
+export import <mutex>;
+export import <string>;
+export import <string_view>;
+export import <vector>;
+
+export
+namespace Ogre
+{
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup General
+    *  @{
+    */
+
+    /** Keeps a trace of the last frames and reports the frames taking too long.
+    @remarks
+        While enabled, the Profiler captures a trace, see Profiler::setTraceCapture, and Root
+        hands the events of every frame to the monitor, which keeps those of the last
+        getFrameHistory frames. Along with them it records the activities known to cause
+        hitches: resource loads, shader compilations, allocations of temporary vertex
+        buffers and the cleanups of HardwareBufferManager, with their names. When a frame,
+        measured from the end of the one before, takes longer than getThreshold, it logs
+        the activities of the frame and, if a report directory is set, writes the trace
+        of the kept frames to "hitch_<frame>.json" there, to be opened with Perfetto or
+        chrome://tracing.
+    @par
+        Meant to stay enabled in production builds, it costs the trace capture and a
+        lock per activity. Disabled by default.
+    */
+    class HitchMonitor : public Singleton<HitchMonitor>, public ProfilerAlloc
+    {
+    public:
+        enum class ActivityType : uint8
+        {
+            RESOURCE_LOAD,
+            SHADER_COMPILE,
+            BUFFER_ALLOCATION,
+            BUFFER_CLEANUP,
+            USER
+        };
+
+        /// Something done during a frame, see Scope
+        struct Activity
+        {
+            ActivityType type;
+            String name;
+            /// Nanoseconds since the capture started, like ProfileTraceEvent::start
+            uint64 start;
+            uint64 duration;
+        };
+
+        /// A frame kept by the monitor
+        struct Frame
+        {
+            unsigned long number{0};
+            /// Nanoseconds since the capture started, like ProfileTraceEvent::start
+            uint64 start{0};
+            uint64 duration{0};
+            std::vector<ProfileTraceEvent> events;
+            std::vector<Activity> activities;
+        };
+
+        /** Records an activity lasting as long as its scope, if the monitor is enabled */
+        class Scope
+        {
+        public:
+            Scope(ActivityType type, std::string_view name);
+            ~Scope();
+
+            Scope(const Scope&) = delete;
+            auto operator=(const Scope&) -> Scope& = delete;
+
+        private:
+            ActivityType mType;
+            std::string_view mName;
+            /// 0 unless recording
+            uint64 mStart{0};
+        };
+
+        HitchMonitor();
+        ~HitchMonitor();
+
+        /** Starts or stops monitoring.
+        @remarks
+            Enabling starts a trace capture of the Profiler, which is restored to its
+            former state when disabled again. While enabled, the capture only holds the
+            events of the current frame, the monitor takes the rest.
+        */
+        void setEnabled(bool enabled);
+        [[nodiscard]] auto isEnabled() const noexcept -> bool { return mEnabled.load(std::memory_order_relaxed); }
+
+        /// Sets the duration above which a frame is reported, 50 milliseconds by default
+        void setThreshold(uint64 microseconds) { mThreshold = microseconds; }
+        [[nodiscard]] auto getThreshold() const noexcept -> uint64 { return mThreshold; }
+
+        /// Sets the number of frames kept, the reported one included, 60 by default
+        void setFrameHistory(size_t frames);
+        [[nodiscard]] auto getFrameHistory() const noexcept -> size_t { return mFrames.size(); }
+
+        /// Sets the directory the reports are written to, none by default
+        void setReportDirectory(std::string_view directory) { mReportDirectory = directory; }
+        [[nodiscard]] auto getReportDirectory() const noexcept -> const String& { return mReportDirectory; }
+
+        /// Gets the number of frames reported since enabled
+        [[nodiscard]] auto getHitchCount() const noexcept -> size_t { return mHitchCount; }
+
+        /// Gets the kept frames, oldest first
+        [[nodiscard]] auto getFrames() const -> std::vector<const Frame*>;
+
+        /** Writes the kept frames in the Chrome trace event format.
+        @remarks
+            The profiles of every thread appear as in Profiler::exportTrace, the activities
+            on a track of their type and every frame as a span on a track of its own.
+        */
+        void writeReport(std::ostream& stream) const;
+
+        /** Records an activity of any thread, if enabled.
+        @param start,end Nanoseconds of the steady clock, see Scope
+        */
+        void _recordActivity(ActivityType type, std::string_view name, uint64 start, uint64 end);
+
+        /** Completes the current frame, called by Root at the end of every frame. */
+        void _frameEnded(unsigned long frameNumber);
+
+        /// @copydoc Singleton::getSingleton()
+        static auto getSingleton() noexcept -> HitchMonitor&;
+        /// @copydoc Singleton::getSingleton()
+        static auto getSingletonPtr() noexcept -> HitchMonitor*;
+
+    private:
+        void report(const Frame& frame);
+
+        std::atomic<bool> mEnabled{false};
+        bool mCapturedBefore{false};
+        uint64 mThreshold{50000};
+        String mReportDirectory;
+        size_t mHitchCount{0};
+
+        /// Steady clock nanoseconds at the start of the capture
+        uint64 mEpoch{0};
+        uint64 mLastFrameEnd{0};
+
+        /// Ring of the kept frames, mNextFrame is the oldest
+        std::vector<Frame> mFrames;
+        size_t mNextFrame{0};
+
+        std::mutex mActivityMutex;
+        std::vector<Activity> mPendingActivities;
+    };
+    /** @} */
+    /** @} */
+}
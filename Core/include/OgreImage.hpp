@@ -303,6 +303,7 @@ namespace Ogre {
         /** Utility method to combine 2 separate images into this one, with the first
         image source supplying the RGB channels, and the second image supplying the 
         alpha channel (as luminance or separate alpha). 
+        The two images are decoded concurrently on the WorkQueue of Root, if there is one.
         @param rgbFilename Filename of image supplying the RGB channels (any alpha is ignored)
         @param alphaFilename Filename of image supplying the alpha channel. If a luminance image the
             single channel is used directly, if an RGB image then the values are
@@ -316,6 +317,7 @@ namespace Ogre {
         /** Utility method to combine 2 separate images into this one, with the first
         image source supplying the RGB channels, and the second image supplying the 
         alpha channel (as luminance or separate alpha). 
+        The two streams are decoded concurrently, so they must not share a source.
         @param rgbStream Stream of image supplying the RGB channels (any alpha is ignored)
         @param alphaStream Stream of image supplying the alpha channel. If a luminance image the
             single channel is used directly, if an RGB image then the values are
@@ -359,8 +361,10 @@ namespace Ogre {
         /** Encode the image and return a stream to the data. 
             @param formatextension An extension to identify the image format
                 to encode into, e.g. "jpg" or "png"
+            @param compressionLevel Compression level of lossless formats like PNG, from 0 to 9,
+                lower being faster; -1 for the default of the codec
         */
-        auto encode(std::string_view formatextension) -> DataStreamPtr;
+        auto encode(std::string_view formatextension, int compressionLevel = -1) -> DataStreamPtr;
 
         /** Returns a pointer to the internal image buffer at the specified pixel location.
 
@@ -472,19 +476,58 @@ namespace Ogre {
         {
             NEAREST,
             LINEAR,
-            BILINEAR = LINEAR
+            BILINEAR = LINEAR,
+            /// Average of the covered source pixels, the classic mipmap filter
+            BOX,
+            /// Kaiser windowed sinc, keeps more detail than BOX when downsampling
+            KAISER
         };
         /** Scale a 1D, 2D or 3D image volume. 
             @param  src         PixelBox containing the source pointer, dimensions and format
             @param  dst         PixelBox containing the destination pointer, dimensions and format
             @param  filter      Which filter to use
+            @param  gammaCorrect Whether the BOX and KAISER filters operate on linear colour,
+                i.e. decode the sRGB encoded colour of src and encode the result. Alpha is
+                always filtered as is. Ignored by the other filters.
             @remarks    This function can do pixel format conversion in the process.
+                The rows of large images are resampled in parallel on the WorkQueue
+                of Root, if there is one.
             @note   dst and src can point to the same PixelBox object without any problem
         */
-        static void scale(const PixelBox &src, const PixelBox &dst, Filter filter = Filter::BILINEAR);
+        static void scale(const PixelBox &src, const PixelBox &dst, Filter filter = Filter::BILINEAR,
+                          bool gammaCorrect = false);
         
         /** Resize a 2D image, applying the appropriate filter. */
         void resize(ushort width, ushort height, Filter filter = Filter::BILINEAR);
+
+        /** Replaces the mipmaps of the image by a full chain down to 1x1 computed from the top level.
+            @param  gammaCorrect Whether to filter in linear space, for sRGB encoded images,
+                see scale
+            @param  filter      The filter to use, every level is computed from the previous one
+            @remarks
+                This is meant for offline processing and for formats the GPU cannot generate
+                mipmaps for. Compressed images are not supported and dynamic images must
+                have their own buffer.
+        */
+        void generateMipmaps(bool gammaCorrect = false, Filter filter = Filter::BOX);
+
+        /** Encodes all faces and mipmaps of the image in a block compressed format.
+            @param  format      One of DXT1, DXT3, DXT5, BC4_UNORM, BC5_UNORM, BC7_UNORM,
+                ETC1_RGB8, ETC2_RGB8 and ETC2_RGBA8
+            @remarks
+                The encoder is tuned for speed, so that images created at runtime can be
+                stored compressed on the GPU. Offline tools give better quality for assets.
+                Generate the mipmaps first, they can not be computed from compressed data.
+        */
+        auto compress(PixelFormat format) -> Image&;
+
+        /** Decodes all faces and mipmaps of a block compressed image to BYTE_RGBA.
+            @remarks
+                Supported are DXT1 - DXT5, BC4_UNORM, BC5_UNORM, BC7_UNORM, the ETC1 and ETC2
+                formats and the ASTC LDR formats. Textures use this for the formats the
+                RenderSystem can not sample, see TextureManager::setDecompressionCacheLocation.
+        */
+        auto decompress() -> Image&;
         
         /// Static function to calculate size in bytes from the number of mipmaps, faces and the dimensions
         static auto calculateSize(TextureMipmap mipmaps, uint32 faces, uint32 width, uint32 height, uint32 depth, PixelFormat format) -> size_t;
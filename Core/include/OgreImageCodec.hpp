@@ -68,6 +68,12 @@ namespace Ogre {
         void encodeToFile(::std::any const& input, std::string_view outFileName) const override;
 
         ~ImageCodec() override;
+
+        /** Encodes an image at a compression level.
+        @param image The image to encode
+        @param compressionLevel See ImageData::compressionLevel, ignored by codecs without levels
+        */
+        [[nodiscard]] auto encode(const Image& image, int compressionLevel) const -> DataStreamPtr;
         /** Codec return class for images. Has information about the size and the
             pixel format of the image. */
         struct ImageData
@@ -81,6 +87,9 @@ namespace Ogre {
             ImageFlags flags{0};
 
             PixelFormat format{PixelFormat::UNKNOWN};
+
+            /// Compression level requested from lossless encoders, from 0 to 9; -1 for their default
+            int compressionLevel{-1};
         };
         using CodecDataPtr = SharedPtr<ImageData>;
 
@@ -45,7 +45,9 @@ export import :SharedPtr;
 export import :Vector;
 
 export import <algorithm>;
+export import <atomic>;
 export import <memory>;
+export import <utility>;
 export import <vector>;
 
 export
@@ -162,6 +164,30 @@ class Technique;
         /// When true remove the memory of the IndexData we've created because no one else will
         bool mRemoveOwnIndexData{false};
 
+        /// Marks an unused entry of mInstanceSlots and mSlotInstances
+        static constexpr uint32 NO_SLOT = ~uint32{0};
+        /// @see setIncrementalStaticUpdates
+        bool mIncrementalStaticUpdates{ false };
+        /// Instances were created or removed since the last full static upload
+        bool mInstanceSetChanged{ true };
+        /// Per instance, set by _markInstanceDirty (one byte each so parallel updates don't race)
+        std::vector<uint8> mDirtyInstances;
+        std::atomic<bool> mHasDirtyInstances{ false };
+        /// Where each instance was written by the last full static upload, and the reverse
+        std::vector<uint32> mInstanceSlots;
+        std::vector<uint32> mSlotInstances;
+        /// [begin; end) slot ranges, scratch of collectDirtySlotRanges
+        std::vector<std::pair<size_t, size_t>> mDirtySlotRanges;
+
+        /// Forgets the slots of the last full static upload, before writing a new one
+        void resetInstanceSlots();
+        /// Records that the instance at the given index was written to the given slot
+        void assignInstanceSlot( size_t instanceIdx, size_t slot );
+        /** Collects the slots of the instances marked dirty into mDirtySlotRanges, sorted and merged.
+        @return False if a full upload is needed instead, i.e. the set of instances changed
+        */
+        auto collectDirtySlotRanges() -> bool;
+
         virtual void setupVertices( const SubMesh* baseSubMesh ) = 0;
         virtual void setupIndices( const SubMesh* baseSubMesh ) = 0;
         virtual void createAllInstancedEntities();
@@ -270,6 +296,9 @@ class Technique;
 
         auto inline getUsedEntityCount() const noexcept -> size_t { return mInstancedEntities.size() - mUnusedEntities.size();  }
 
+        /// Gets all instanced entities of the batch, see InstancedEntity::isInUse for those requested
+        auto getInstancedEntities() const noexcept -> const InstancedEntityVec& { return mInstancedEntities; }
+
         /** Fills the input vector with the instances that are currently being used or were requested.
             Used for defragmentation, @see InstanceManager::defragmentBatches.
             Ownership of instanced entities is transfered to outEntities. mInstancedEntities will be empty afterwards.
@@ -292,6 +321,17 @@ class Technique;
         void _defragmentBatch( bool optimizeCulling, InstancedEntityVec &usedEntities,
                                 CustomParamsVec &usedParams );
 
+        /** Moves an InstancedEntity in use to a free slot of another batch.
+            Used by the incremental defragmentation, @see InstanceManager::setIncrementalDefragmentation
+        @remarks
+            The entity swaps places with an unused entity of the target, together with its custom
+            params, so neither batch changes in size. Both only get their instance set marked as changed.
+        */
+        void _migrateInstancedEntity( InstancedEntity *instancedEntity, InstanceBatch *target );
+
+        /// All the InstancedEntities of this batch, in use or not, by instance ID
+        [[nodiscard]] auto _getInstancedEntities() const noexcept -> const InstancedEntityVec& { return mInstancedEntities; }
+
         /** Called by InstancedEntity(s) to tell us we need to update the bounds
             (we touch the SceneNode so the SceneManager aknowledges such change)
         */
@@ -316,6 +356,23 @@ class Technique;
         */
         virtual auto isStatic() const noexcept -> bool { return false; }
 
+        /** Sets whether static batches upload the instances which changed, instead of ignoring them.
+        @remarks
+            Static batches normally keep what setStaticAndUpdate uploaded. With this enabled, the
+            instances which moved or got new custom params since the last frame are rewritten in
+            place, as a few partial buffer updates covering only them, so a forest where a few trees
+            sway pays for those trees only. Creating or removing instances, or moving a previously
+            hidden instance, still triggers a full upload. Currently only InstanceBatchHW and
+            InstanceBatchHW_VTF (without bone matrix lookup) support it.
+            @see InstanceManager::BatchSettingId::INCREMENTAL_STATIC_UPDATES
+        */
+        void setIncrementalStaticUpdates( bool enabled );
+
+        [[nodiscard]] auto getIncrementalStaticUpdates() const noexcept -> bool { return mIncrementalStaticUpdates; }
+
+        /** Called by InstancedEntity(s) to tell us their data needs to be uploaded again */
+        void _markInstanceDirty( const InstancedEntity *instancedEntity );
+
         /** Returns a pointer to a new InstancedEntity ready to use
             Note it's actually preallocated, so no memory allocation happens at
             this point.
@@ -82,6 +82,10 @@ class SubMesh;
         auto checkSubMeshCompatibility( const SubMesh* baseSubMesh ) -> bool override;
 
         auto updateVertexBuffer( Camera *currentCamera ) -> size_t;
+        /// Writes the transforms and custom params of an instance, returns the end of the written data
+        auto writeInstanceData( size_t instanceIdx, float *pDest ) const -> float*;
+        /// Rewrites the slots of the instances which changed, see setIncrementalStaticUpdates
+        void updateDirtyInstances();
 
     public:
         InstanceBatchHW( InstanceManager *creator, MeshPtr &meshReference, const MaterialPtr &material,
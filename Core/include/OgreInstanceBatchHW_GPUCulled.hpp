@@ -0,0 +1,114 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+module;
+
+#include <cstddef>
+
+export module Ogre.Core:InstanceBatchHW_GPUCulled;
+
+export import :InstanceBatchHW;
+export import :Mesh;
+export import :Prerequisites;
+
+export import <memory>;
+
+export
+namespace Ogre
+{
+class InstanceManager;
+class RenderQueue;
+class Renderable;
+class SubMesh;
+class VertexData;
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Scene
+    *  @{
+    */
+
+    /** Like InstanceBatchHW, but culls the instances on the GPU.
+        @remarks
+            The transforms (and custom params) of all instances in the scene, each with its
+            bounding sphere, are uploaded once to a buffer which is only rewritten when an
+            instance moves, is added or removed. For each camera these are rendered as points
+            through the culling material (see InstanceManager::setGpuCullingMaterialName) into
+            a RenderToVertexBuffer; the material's program discards the instances outside the
+            frustum or the distance range of the batch and passes the others through. The
+            surviving instances are then drawn with the instance count captured by the
+            culling stage, so there is no per frame CPU work per instance.
+        @par
+            The culling program receives the instance data in the texture coordinates 0 to
+            2 + custom params and the world space bounding sphere (centre, radius) in the next
+            one, and must output the instance data unchanged in the same texture coordinates.
+            If it declares a float4 @c instanceDistanceRange uniform, it is set to the range
+            given by InstanceManager::setGpuCullingDistanceRange, used for LOD selection
+            across several managers.
+        @par
+            The render systems don't provide indirect draws, so the count written by the
+            culling stage is read back before the batch is drawn. Visibility changes of
+            single instances are picked up with their next transform change. Camera relative
+            rendering is not supported. In static mode this batch behaves like InstanceBatchHW.
+     */
+    class InstanceBatchHW_GPUCulled : public InstanceBatchHW
+    {
+        /// The per instance data of the whole batch, culling stage input
+        std::unique_ptr<VertexData> mCullingData;
+        /// Provides mCullingData to the culling stage
+        std::unique_ptr<Renderable> mCullingSource;
+        RenderToVertexBufferSharedPtr mCullingStage;
+        /// The instance buffer used in static mode
+        HardwareVertexBufferSharedPtr mInstanceBuffer;
+        unsigned short mInstanceSource{ 0 };
+        bool mInstanceDataDirty{ true };
+
+        void createCullingStage();
+        /// Writes all instances in the scene to mCullingData, returns their count
+        auto uploadInstanceData() -> size_t;
+        void updateCullingParameters();
+
+    public:
+        InstanceBatchHW_GPUCulled( InstanceManager *creator, MeshPtr &meshReference, const MaterialPtr &material,
+                                   size_t instancesPerBatch, const Mesh::IndexMap *indexToBoneMap,
+                                   std::string_view batchName );
+        ~InstanceBatchHW_GPUCulled() override;
+
+        /** @see InstanceBatch::calculateMaxNumInstances */
+        auto calculateMaxNumInstances( const SubMesh *baseSubMesh, InstanceManagerFlags flags ) const -> size_t override;
+
+        /** Overloaded to mark the uploaded instance data as outdated */
+        void _boundsDirty() override;
+
+        /** @see InstanceBatchHW::setStaticAndUpdate */
+        void setStaticAndUpdate( bool bStatic ) override;
+
+        /** Overloaded to cull the instances on the GPU */
+        void _updateRenderQueue( RenderQueue* queue ) override;
+    };
+
+}
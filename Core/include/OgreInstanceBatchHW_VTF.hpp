@@ -41,6 +41,7 @@ export
 namespace Ogre
 {
 class Camera;
+class InstancedEntity;
 class InstanceManager;
 class RenderQueue;
 class SubMesh;
@@ -99,6 +100,11 @@ class VertexData;
         */
         auto updateVertexTexture( Camera *currentCamera ) -> size_t;
 
+        /// Writes the transforms of an instance to the vertex texture at pDest
+        void writeInstanceTransforms( InstancedEntity *entity, float *pDest, bool useMatrixLookup );
+        /// Rewrites the texture rows of the instances which changed, see setIncrementalStaticUpdates
+        void updateDirtyInstances();
+
         auto matricesTogetherPerRow() const noexcept -> bool override { return true; }
     public:
         InstanceBatchHW_VTF( InstanceManager *creator, MeshPtr &meshReference, const MaterialPtr &material,
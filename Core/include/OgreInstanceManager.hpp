@@ -41,13 +41,16 @@ export import :RenderOperation;
 export import :SharedPtr;
 
 export import <algorithm>;
+export import <limits>;
 export import <map>;
+export import <mutex>;
 export import <string>;
 export import <vector>;
 
 export
 namespace Ogre
 {
+    class HiZBuffer;
     class InstancedEntity;
     class SceneManager;
     /** \addtogroup Core
@@ -80,6 +83,7 @@ namespace Ogre
             TextureVTF,             ///< Needs Vertex Texture Fetch & SM 3.0+ @ref InstanceBatchVTF
             HWInstancingBasic,      ///< Needs SM 3.0+ and HW instancing support @ref InstanceBatchHW
             HWInstancingVTF,        ///< Needs SM 3.0+, HW instancing support & VTF @ref InstanceBatchHW_VTF
+            HWInstancingGPUCulled,  ///< Needs SM 4.0+, HW instancing support & render to vertex buffer @ref InstanceBatchHW_GPUCulled
             InstancingTechniquesCount
         };
 
@@ -92,6 +96,9 @@ namespace Ogre
             CAST_SHADOWS        = 0,
             /// Makes each batch to display it's bounding box. Useful for debugging or profiling
             SHOW_BOUNDINGBOX,
+            /// Makes static batches upload the instances that changed instead of staying frozen.
+            /// Only HWInstancingBasic & HWInstancingVTF support it
+            INCREMENTAL_STATIC_UPDATES,
 
             NUM_SETTINGS
         };
@@ -109,6 +116,7 @@ namespace Ogre
                 using enum BatchSettingId;
                 setting[std::to_underlying(CAST_SHADOWS)]     = true;
                 setting[std::to_underlying(SHOW_BOUNDINGBOX)] = false;
+                setting[std::to_underlying(INCREMENTAL_STATIC_UPDATES)] = false;
             }
         };
 
@@ -123,6 +131,8 @@ namespace Ogre
         size_t                  mIdCount{ 0 };
 
         InstanceBatchVec        mDirtyBatches;
+        /// Batches may get dirty from a parallel scene graph update
+        std::mutex              mDirtyBatchesMutex;
 
         RenderOperation         mSharedRenderOperation;
 
@@ -137,6 +147,18 @@ namespace Ogre
         size_t                  mMaxLookupTableInstances{16};
         unsigned char           mNumCustomParams{ 0 };       //Number of custom params per instance.
 
+        /// @see setGpuCullingMaterialName
+        String                  mGpuCullingMaterialName;
+        Real                    mGpuCullingMinDistance{ 0 };
+        Real                    mGpuCullingMaxDistance{ std::numeric_limits<Real>::max() };
+        const HiZBuffer*        mGpuCullingHiZBuffer{ nullptr };
+
+        /// @see setIncrementalDefragmentation
+        size_t                  mDefragmentationBudget{ 0 };
+        bool                    mDefragmentationCulling{ false };
+        /// Dynamic batches in use of the material being defragmented, kept to avoid allocs every frame
+        InstanceBatchVec        mDefragmentationBatches;
+
         /** Finds a batch with at least one free instanced entity we can use.
             If none found, creates one.
         */
@@ -159,6 +181,10 @@ namespace Ogre
                                 InstanceBatch::CustomParamsVec &usedParams,
                                 ::std::vector<::std::unique_ptr<InstanceBatch>> &fragmentedBatches );
 
+        /** Picks the batch of mDefragmentationBatches with a free slot an entity migrates to
+            during the incremental defragmentation */
+        auto getDefragmentationTarget( const InstancedEntity *instancedEntity ) const -> InstanceBatch*;
+
         /** @see setSetting. This function helps it by setting the given parameter to all batches
             in container.
         */
@@ -204,7 +230,7 @@ namespace Ogre
             it will raise an exception. If the technique doesn't support custom params, it will
             raise an exception at the time of building the first InstanceBatch.
 
-            HWInstancingBasic:
+            HWInstancingBasic, HWInstancingGPUCulled:
                 * Each custom params adds an additional float4 TEXCOORD.
             HWInstancingVTF:
                 * Not implemented. (Recommendation: Implement this as an additional float4 VTF fetch)
@@ -219,10 +245,54 @@ namespace Ogre
         [[nodiscard]] auto getNumCustomParams() const
         noexcept -> unsigned char { return mNumCustomParams; }
 
+        /** Sets the material which culls the instances of the HWInstancingGPUCulled technique.
+        @remarks
+            Its first pass is rendered into a vertex buffer for each camera, see
+            InstanceBatchHW_GPUCulled for what the program receives and has to output.
+            Raises an exception if trying to change it after creating the first InstancedEntity.
+        */
+        void setGpuCullingMaterialName( std::string_view materialName );
+
+        [[nodiscard]] auto getGpuCullingMaterialName() const
+        noexcept -> const String& { return mGpuCullingMaterialName; }
+
+        /** Sets the camera distance range in which the culling material keeps instances.
+        @remarks
+            The range is passed to the culling program of the HWInstancingGPUCulled technique,
+            so managers of the LOD levels of a mesh can each draw the instances in their range.
+        @param minDistance Instances closer than this are culled
+        @param maxDistance Instances at or beyond this distance are culled
+        */
+        void setGpuCullingDistanceRange( Real minDistance, Real maxDistance );
+
+        [[nodiscard]] auto getGpuCullingMinDistance() const noexcept -> Real { return mGpuCullingMinDistance; }
+        [[nodiscard]] auto getGpuCullingMaxDistance() const noexcept -> Real { return mGpuCullingMaxDistance; }
+
+        /** Sets the hierarchical depth buffer the culling material tests the instances against.
+        @remarks
+            If the first pass of the culling material has a texture unit named @c hiZ, it is
+            given the texture of the buffer. Its vertex or geometry program receives the
+            HiZBuffer::Frame in the float4x4 @c hiZViewProj, and the float4 @c hiZCameraPosition
+            and @c hiZSize uniforms, where it declares them. Null, the default, leaves them unset.
+            The buffer is not owned by the manager.
+        */
+        void setGpuCullingHiZBuffer( const HiZBuffer* hiZBuffer ) { mGpuCullingHiZBuffer = hiZBuffer; }
+
+        [[nodiscard]] auto getGpuCullingHiZBuffer() const noexcept -> const HiZBuffer* { return mGpuCullingHiZBuffer; }
+
         /** @return Instancing technique this manager was created for. Can't be changed after creation */
         [[nodiscard]] auto getInstancingTechnique() const
         noexcept -> InstancingTechnique { return mInstancingTechnique; }
 
+        /// Gets the mesh the instances are made of
+        [[nodiscard]] auto getMesh() const noexcept -> const MeshPtr& { return mMeshReference; }
+        /// Gets the index of the submesh of getMesh the instances are made of
+        [[nodiscard]] auto getSubMeshIndex() const noexcept -> unsigned short { return mSubMeshIdx; }
+        /// Gets the instances per batch the manager was created with or set by setInstancesPerBatch
+        [[nodiscard]] auto getInstancesPerBatch() const noexcept -> size_t { return mInstancesPerBatch; }
+        /// Gets the flags the manager was created with
+        [[nodiscard]] auto getInstancingFlags() const noexcept -> InstanceManagerFlags { return mInstancingFlags; }
+
         /** Calculates the maximum (or the best amount, depending on flags) of instances
             per batch given the suggested size for the technique this manager was created for.
         @remarks
@@ -272,6 +342,32 @@ namespace Ogre
         */
         void defragmentBatches( bool optimizeCulling );
 
+        /** Sets up the incremental defragmentation, which spreads the work of defragmentBatches
+            over the frames.
+        @remarks
+            Every frame at most maxInstancesPerFrame InstancedEntities are migrated from the emptiest
+            dynamic batch of a material to the other batches of the material with free slots, and the
+            batch is removed once it got empty. A migration swaps the entity with an unused one of the
+            target batch, so only the two batches involved are marked as changed, nothing gets rebuilt
+            and the entities keep their address, scene node and custom params. It rests once the
+            instances of a material fill as few batches as they can.
+            Static batches are neither a source nor a target.
+        @param maxInstancesPerFrame How many entities may be migrated per frame, 0 disables the
+            incremental defragmentation, the default
+        @param optimizeCulling When true, an entity migrates to the batch whose bounds are closest to
+            it, keeping the batches spatially coherent for CPU culling. Otherwise it goes to the fullest one
+        */
+        void setIncrementalDefragmentation( size_t maxInstancesPerFrame, bool optimizeCulling = false );
+
+        [[nodiscard]] auto getIncrementalDefragmentationBudget() const noexcept -> size_t { return mDefragmentationBudget; }
+        [[nodiscard]] auto getIncrementalDefragmentationCulling() const noexcept -> bool { return mDefragmentationCulling; }
+
+        /** Migrates the instances of a frame, @see setIncrementalDefragmentation.
+            Called by SceneManager once per frame.
+        @return The number of InstancedEntities which were migrated
+        */
+        auto _updateIncrementalDefragmentation() -> size_t;
+
         /** Applies a setting for all batches using the same material
 
             If the material name hasn't been used, the settings are still stored
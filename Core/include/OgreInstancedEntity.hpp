@@ -40,6 +40,7 @@ export import :Platform;
 export import :Prerequisites;
 export import :Quaternion;
 export import :Renderable;
+export import :SkeletonPoseCache;
 export import :Vector;
 
 export import <algorithm>;
@@ -112,6 +113,8 @@ class SkeletonInstance;
 
         AnimationStateSet *mAnimationState{ nullptr };
         SkeletonInstance *mSkeletonInstance{ nullptr };
+        /// Scratch storage for the SkeletonPoseCache lookups of _updateAnimation
+        SkeletonPoseCache::Key mPoseKey;
         Affine3 *mBoneMatrices{nullptr};  //Local space
         Affine3 *mBoneWorldMatrices{nullptr}; //World space
         unsigned long mFrameAnimationLastUpdated;
@@ -455,6 +455,14 @@ struct Sphere;
         */
         auto _deriveShadowFarClipDistance() const -> Real;
 
+        /** Sets how much the shadow of this light matters compared to others, 1 by default.
+        @remarks
+            Scales the size of the tile of the light in the shadow atlas, see
+            SceneManager::setShadowAtlas, on top of its screen coverage.
+        */
+        void setShadowImportance(Real importance) { mShadowImportance = importance; }
+        [[nodiscard]] auto getShadowImportance() const noexcept -> Real { return mShadowImportance; }
+
         /// Set the camera which this light should be relative to, for camera-relative rendering
         void _setCameraRelative(Camera* cam);
 
@@ -542,6 +550,7 @@ struct Sphere;
         
         Real mShadowNearClipDist;
         Real mShadowFarClipDist;
+        Real mShadowImportance{1};
 
         Camera* mCameraToBeRelativeTo;
 
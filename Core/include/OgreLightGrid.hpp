@@ -0,0 +1,121 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+module;
+
+#include <cstddef>
+
+export module Ogre.Core:LightGrid;
+
+export import :AxisAlignedBox;
+export import :Common;
+export import :MemoryAllocatorConfig;
+export import :Platform;
+export import :Prerequisites;
+export import :Vector;
+
+export import <memory_resource>;
+export import <vector>;
+
+export
+namespace Ogre {
+class Sphere;
+
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Scene
+    *  @{
+    */
+    /** Uniform grid over the range spheres of a list of lights.
+    @remarks
+        Every light with a finite range is recorded in the cells its range sphere
+        overlaps, so the lights which may affect a sphere are found by looking at
+        the few cells the sphere overlaps instead of testing every light. Lights
+        without a position, or which would cover too many cells, are reported for
+        every query.
+    @par
+        The grid only narrows down the candidates, which are a superset of the lights
+        for which Light::isInLightRange holds. It refers to the lights by index into
+        the list it was built from, and must be rebuilt whenever that list or any of
+        the lights change.
+    */
+    class LightGrid : public SceneMgtAlloc
+    {
+    public:
+        /// Number of cells along each axis
+        static constexpr size_t RESOLUTION = 16;
+        /// Lights overlapping more cells than this are reported for every query
+        static constexpr size_t MAX_LIGHT_CELLS = 256;
+
+        /** Distributes the lights of the list over the cells
+        @param lights The lights to distribute
+        @param scratch Memory for the temporaries of the build, e.g. Root::getFrameAllocator
+        */
+        void build(const LightList& lights, std::pmr::memory_resource* scratch = std::pmr::get_default_resource());
+
+        /// Releases the grid
+        void clear();
+
+        /** Gets the lights whose range might intersect the sphere.
+        @param sphere The sphere to test, in world space
+        @param result Receives the indices of the lights in the list, in ascending order
+        @return false if the sphere covers so many cells that testing every light is cheaper,
+            in which case result is left empty
+        */
+        auto findCandidates(const Sphere& sphere, std::vector<uint32>& result) const -> bool;
+
+        /// Gets the number of lights in the list the grid was built from
+        [[nodiscard]] auto getNumLights() const noexcept -> size_t { return mNumLights; }
+
+    private:
+        /// Cell coordinates covered by a box, clamped to the grid
+        struct CellRange
+        {
+            size_t min[3], max[3];
+            [[nodiscard]] auto getNumCells() const noexcept -> size_t
+            {
+                return (max[0] - min[0] + 1) * (max[1] - min[1] + 1) * (max[2] - min[2] + 1);
+            }
+        };
+        auto getCellRange(const AxisAlignedBox& box, CellRange& range) const -> bool;
+
+        size_t mNumLights{0};
+        AxisAlignedBox mBounds;
+        Vector3 mInvCellSize;
+        /// Lights reported for every query
+        std::vector<uint32> mGlobalLights;
+        /// For each cell, the first entry in mCellLights, plus one entry for the end
+        std::vector<uint32> mCellStart;
+        std::vector<uint32> mCellLights;
+        /// Query scratch, the last query which reported each light
+        mutable std::vector<uint32> mLightStamp;
+        mutable uint32 mStamp{0};
+    };
+    /** @} */
+    /** @} */
+}
@@ -33,6 +33,7 @@ export import :Prerequisites;
 
 export import <algorithm>;
 export import <fstream>;
+export import <memory>;
 export import <string>;
 export import <vector>;
 
@@ -108,6 +109,13 @@ namespace Ogre {
 
         using mtLogListener = std::vector<LogListener *>;
         mtLogListener mListeners;
+
+        /// Queue and thread of the asynchronous mode, see setAsync
+        struct AsyncWriter;
+        ::std::unique_ptr<AsyncWriter> mAsync;
+
+        /// Writes a message to the debugger and the file, without flushing the file
+        void write(std::string_view message, LogMessageLevel lml, bool maskDebug, int64 timestamp);
     public:
 
         class Stream;
@@ -157,6 +165,32 @@ namespace Ogre {
         /** Gets the level of the log detail.
         */
         auto getMinLogLevel() const noexcept -> LogMessageLevel { return mLogLevel; }
+
+        /** Sets whether messages are written by a background thread.
+        @remarks
+            By default, logMessage writes the message to the debugger and the file and flushes
+            the file before it returns, which can stall the calling thread for milliseconds.
+            In the asynchronous mode, logMessage only applies the level and the listeners
+            and pushes the message to a lock free queue. A writer thread writes the queued
+            messages in batches and flushes the file once per batch.
+        @par
+            The writer collapses messages which repeat the previous one, e.g. a warning
+            logged every frame, into a single "last message repeated N times" line.
+        @par
+            Listeners are still called on the thread logging the message, so they can skip
+            it as before. Messages may reach the file some time after logMessage returned,
+            use flush to wait for them. Disabling it writes all queued messages first.
+            Disabled by default. Do not call it while other threads are logging to this Log.
+        */
+        void setAsync(bool async);
+        /// Gets whether messages are written by a background thread
+        [[nodiscard]] auto isAsync() const noexcept -> bool { return mAsync != nullptr; }
+
+        /** Blocks until all messages logged so far have been written.
+        @remarks
+            Only has an effect in the asynchronous mode, see setAsync.
+        */
+        void flush();
         /**
         @remarks
             Register a listener to this log
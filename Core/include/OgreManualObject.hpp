@@ -122,7 +122,7 @@ class SubMesh;
         If you do this, you should call setDynamic(true) before your first call 
         to begin(), and also consider using estimateVertexCount() / estimateIndexCount()
         if your geometry is going to be growing, to avoid buffer recreation during
-        growth.
+        growth. Geometry rebuilt every frame is best streamed, see setStreaming().
 
         @note like all OGRE geometry, triangles should be specified in 
         anti-clockwise winding order (whether you're doing it with just
@@ -207,6 +207,26 @@ class SubMesh;
         /** Gets whether this object is marked as dynamic */
         auto getDynamic() const noexcept -> bool { return !!(mBufferUsage & HardwareBuffer::DYNAMIC); }
 
+        /** Sets whether vertices are written straight into the vertex buffer of the section.
+        @remarks
+            Meant for geometry rebuilt every frame, like debug drawing, together with
+            setBufferUsage(HardwareBufferUsage::CPU_TO_GPU). The vertex buffer is locked
+            with HardwareBuffer::LockOptions::DISCARD by the first vertex, so the driver
+            hands out fresh memory while the GPU still reads the last frame, and the vertices
+            are written into it without any copy in between. The buffer is created with room
+            for estimateVertexCount() vertices, and when it runs out it is replaced by one
+            twice as large, which the vertices so far are copied to.
+        @par
+            The indices are still gathered in system memory, since their type is only known
+            by end(). That memory is kept from one section to the next, so once the buffers
+            are large enough updating a section with beginUpdate() allocates nothing.
+            Disabled by default.
+        */
+        void setStreaming(bool streaming) { mStreaming = streaming; }
+
+        /** Gets whether vertices are written straight into the vertex buffer of the section. */
+        auto getStreaming() const noexcept -> bool { return mStreaming; }
+
         /** Start the definition of an update to a part of the object.
         @remarks
             Using this method, you can update an existing section of the object
@@ -631,6 +651,8 @@ class SubMesh;
             void getRenderOperation(RenderOperation& op) override;
             /** @copydoc Renderable::getWorldTransforms */
             void getWorldTransforms(Matrix4* xform) const override;
+            /** @copydoc Renderable::getWorldTransformNode */
+            auto getWorldTransformNode() const noexcept -> const Node* override;
             /** @copydoc Renderable::getSquaredViewDepth */
             auto getSquaredViewDepth(const Ogre::Camera *) const -> Real override;
             /** @copydoc Renderable::getLights */
@@ -705,6 +727,12 @@ class SubMesh;
         bool mUseIdentityView{false};
         /// Keep declaration order or let the queue optimize it
         bool mKeepDeclarationOrder{false};
+        /// Whether to write vertices straight into the vertex buffer
+        bool mStreaming{false};
+        /// Lock of the vertex buffer vertices are streamed into
+        HardwareBufferLockGuard mStreamLock;
+        /// The first vertex of the locked range
+        size_t mStreamStart{0};
 
 
         /// Delete temp buffers and reset init counts
@@ -716,6 +744,8 @@ class SubMesh;
 
         /// Copy current temp vertex into buffer
         virtual void copyTempVertexToBuffer();
+        /// Where to write a vertex being streamed, growing the vertex buffer if needed
+        auto getStreamedVertex(size_t index) -> char*;
 
     private:
         void declareElement(VertexElementType t, VertexElementSemantic s);
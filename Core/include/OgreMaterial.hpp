@@ -163,6 +163,8 @@ class Technique;
         /** Assignment operator to allow easy copying between materials.
         */
         auto operator=( const Material& rhs ) -> Material&;
+        /// operator=, optionally sharing the GpuProgramParameters of the passes, see clone
+        auto _assign(const Material& rhs, bool shareParameters) -> Material&;
 
         /** Determines if the material has any transparency with the rest of the scene (derived from 
             whether any Techniques say they involve transparency).
@@ -275,8 +277,18 @@ class Technique;
             Optional name of the new group to assign the clone to;
             if you leave this blank, the clone will be assigned to the same
             group as this Material.
+        @param shareParameters
+            Whether the passes of the clone share the GpuProgramParameters with the ones of this
+            Material, instead of copying them. The first Pass::getGpuProgramParameters on either
+            side, which the caller may change the returned parameters through, then makes the copy.
+            Binding and updating the automatic constants does not. This keeps the many clones of a
+            Material that only differ in a few fixed function settings, or in nothing until much
+            later, from each holding all constants.
+        @note
+            For per object values of a shader, like a tint, Renderable::setCustomParameter
+            together with GpuProgramParameters::AutoConstantType::CUSTOM needs no clone at all.
         */
-        auto clone(std::string_view newName, std::string_view newGroup = BLANKSTRING) const -> MaterialPtr;
+        auto clone(std::string_view newName, std::string_view newGroup = BLANKSTRING, bool shareParameters = false) const -> MaterialPtr;
 
         // needed because of deprecated variant below
         auto clone(std::string_view newName, const char* newGroup) const -> MaterialPtr { return clone(newName, String(newGroup)); }
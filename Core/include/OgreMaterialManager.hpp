@@ -41,11 +41,12 @@ export import <string>;
 
 export
 namespace Ogre {
-
+class AbstractNode;
 class Material;
 class Renderable;
 class Technique;
 
+using AbstractNodePtr = SharedPtr<AbstractNode>;
 
     /** \addtogroup Core
     *  @{
@@ -153,6 +154,12 @@ class Technique;
         using ListenerMap = std::map<std::string_view, ListenerList>;
         ListenerMap mListenerMap;
 
+        /// Whether the materials of scripts are translated on their first lookup
+        bool mLazyLoading{false};
+        /// The not yet translated material scripts, name -> (group, syntax tree)
+        using DeferredMaterialMap = std::multimap<String, std::pair<String, AbstractNodePtr>, std::less<>>;
+        mutable DeferredMaterialMap mDeferredMaterials;
+
     public:
         /// Default material scheme
         static std::string_view const DEFAULT_SCHEME_NAME;
@@ -167,6 +174,36 @@ class Technique;
         /// @see ResourceManager::getResourceByName
         auto getByName(std::string_view name, std::string_view groupName = ResourceGroupManager::AUTODETECT_RESOURCE_GROUP_NAME) const -> MaterialPtr;
 
+        /** Gets a resource by name, translating a deferred material script first.
+        @see setLazyLoading
+        */
+        auto getResourceByName(std::string_view name, std::string_view groupName = RGN_DEFAULT) const -> ResourcePtr override;
+
+        /// Removes all materials, including the deferred ones
+        void removeAll() override;
+
+        /** Sets whether the materials of scripts are only translated when they are first looked up.
+        @remarks
+            ScriptCompiler then keeps the syntax trees of the top level materials of a script,
+            with imports, inheritance and variables already resolved, instead of translating them.
+            getResourceByName, and with it getByName, translates a material right before returning
+            it the first time. Until then the material is not part of its resource group, so it is
+            neither listed nor compiled when the group loads. This pays off for large libraries of
+            materials of which only a few are used at a time.
+        @note
+            The default value is false. Takes effect for scripts parsed afterwards. The translation
+            fires the ScriptCompilerListener events when the material is looked up, so the listener
+            must stay set until then.
+        */
+        void setLazyLoading(bool enabled) { mLazyLoading = enabled; }
+        /// Gets whether materials are translated on their first lookup, see setLazyLoading
+        [[nodiscard]] auto getLazyLoading() const noexcept -> bool { return mLazyLoading; }
+
+        /// Keeps the syntax tree of a material script for translating it on its first lookup
+        void _deferMaterial(std::string_view name, std::string_view group, const AbstractNodePtr& node);
+        /// Forgets the deferred materials of a group that is cleared
+        void _dropDeferredMaterials(std::string_view group);
+
         /// Get a default material that is always available even when no resources were loaded
         /// @param useLighting whether the material should be lit
         auto getDefaultMaterial(bool useLighting = true) -> MaterialPtr;
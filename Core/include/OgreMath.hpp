@@ -226,6 +226,36 @@ struct Sphere;
             virtual auto getRandomUnit() -> Real = 0;
        };
 
+       /** Axis aligned boxes as separate arrays of their bounds, to intersect many with a ray at once.
+       @remarks
+           The boxes must be finite, null and infinite boxes have no representation.
+       */
+       struct BoxArrays
+       {
+           const Real* minX;
+           const Real* minY;
+           const Real* minZ;
+           const Real* maxX;
+           const Real* maxY;
+           const Real* maxZ;
+       };
+
+       /** Triangles as separate arrays of their first vertex a and the edges b - a and c - a,
+           to intersect many with a ray at once.
+       */
+       struct TriangleArrays
+       {
+           const Real* ax;
+           const Real* ay;
+           const Real* az;
+           const Real* e1x;
+           const Real* e1y;
+           const Real* e1z;
+           const Real* e2x;
+           const Real* e2y;
+           const Real* e2z;
+       };
+
     private:
         /// Angle units used by the api
         static AngleUnit msAngleUnit;
@@ -631,6 +661,38 @@ struct Sphere;
             const Vector3& b, const Vector3& c,
             bool positiveSide = true, bool negativeSide = true) -> RayTestResult;
 
+        /** Ray / box intersection with many boxes at once, using SIMD where available.
+        @param ray
+            The ray.
+        @param boxes
+            The bounds of the boxes.
+        @param numBoxes
+            The number of boxes.
+        @param distances
+            Receives the distance along the ray to each box, like intersects(const Ray&, const AxisAlignedBox&),
+            or POS_INFINITY for the boxes missed.
+        */
+        static void intersects(const Ray& ray, const BoxArrays& boxes, size_t numBoxes, Real* distances);
+
+        /** Ray / triangle intersection with many triangles at once, using SIMD where available.
+        @param ray
+            The ray.
+        @param triangles
+            The vertices and edges of the triangles.
+        @param numTriangles
+            The number of triangles.
+        @param distances
+            Receives the distance along the ray to each triangle, like
+            intersects(const Ray&, const Vector3&, const Vector3&, const Vector3&, bool, bool),
+            or POS_INFINITY for the triangles missed.
+        @param positiveSide
+            Intersect with "positive side" of the triangles (as determined by vertex winding)
+        @param negativeSide
+            Intersect with "negative side" of the triangles (as determined by vertex winding)
+        */
+        static void intersects(const Ray& ray, const TriangleArrays& triangles, size_t numTriangles, Real* distances,
+            bool positiveSide = true, bool negativeSide = true);
+
         /** Sphere / box intersection test. */
         static auto intersects(const Sphere& sphere, const AxisAlignedBox& box) -> bool;
 
@@ -25,9 +25,17 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 THE SOFTWARE.
 -----------------------------------------------------------------------------
 */
+module;
+
+#include <cstddef>
+
 export module Ogre.Core:MemoryAllocatorConfig;
 
 export import :AlignedAllocator;
+export import :Platform;
+
+export import <new>;
+export import <string_view>;
 
 export
 namespace Ogre
@@ -79,11 +87,110 @@ namespace Ogre
 export
 namespace Ogre
 {
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup General
+    *  @{
+    */
+
+    /** Allocator a MemoryCategory can be bound to, see MemoryTracker::setAllocator.
+    @remarks
+        Must be thread safe and outlive all its allocations. The sizes and alignments
+        passed to deallocate are the ones passed to allocate.
+    */
+    class CategoryAllocator
+    {
+    public:
+        virtual ~CategoryAllocator() = default;
+
+        virtual auto allocate(size_t size, size_t alignment) -> void* = 0;
+        virtual void deallocate(void* ptr, size_t size, size_t alignment) noexcept = 0;
+    };
+
+    /** Counts the memory of the objects derived from AllocatedObject, per MemoryCategory.
+    @remarks
+        Every class deriving from one of the per-class allocators, e.g. NodeAlloc or
+        VertexDataAlloc, allocates through here, so the categories can be watched to find
+        the subsystem which grows in a long running session. Memory the objects allocate
+        themselves, like the contents of their containers, is not counted.
+    @par
+        While the Profiler is enabled, Root publishes the statistics of every category as
+        the counters "Memory/<category>/liveBytes" and "Memory/<category>/peakBytes", and
+        the allocations and bytes of the last frame as "Memory/<category>/allocations" and
+        "Memory/<category>/allocatedBytes".
+    */
+    class MemoryTracker
+    {
+    public:
+        struct Stats
+        {
+            /// Bytes currently allocated
+            size_t liveBytes{0};
+            /// Maximum of liveBytes since the start or the last resetPeaks
+            size_t peakBytes{0};
+            /// Number of allocations so far
+            uint64 allocations{0};
+            /// Bytes allocated so far, including the ones already freed
+            uint64 allocatedBytes{0};
+        };
+
+        /// Allocates memory and counts it in category
+        static auto allocate(size_t size, MemoryCategory category) -> void*;
+        /// @overload
+        static auto allocate(size_t size, std::align_val_t alignment, MemoryCategory category) -> void*;
+        /// Frees memory of allocate, size must be the allocated one
+        static void deallocate(void* ptr, size_t size, MemoryCategory category) noexcept;
+        /// @overload
+        static void deallocate(void* ptr, size_t size, std::align_val_t alignment, MemoryCategory category) noexcept;
+
+        /// Gets the statistics of a category
+        static auto getStats(MemoryCategory category) -> Stats;
+        /// Sets the peak of every category to its current live bytes
+        static void resetPeaks();
+        /// Gets the name of a category as used for the Profiler counters
+        static auto getCategoryName(MemoryCategory category) -> std::string_view;
+
+        /** Binds a category to an allocator, e.g. a SmallObjectAllocator.
+        @remarks
+            Only possible while nothing of the category is allocated, so objects are always
+            freed by the allocator which allocated them. So bind the categories at startup,
+            before creating the Root.
+        @param category The category
+        @param allocator The allocator or nullptr for the global operator new, the default
+        */
+        static void setAllocator(MemoryCategory category, CategoryAllocator* allocator);
+        /// Gets the allocator a category is bound to, nullptr for the global operator new
+        static auto getAllocator(MemoryCategory category) -> CategoryAllocator*;
+    };
+    /** @} */
+    /** @} */
+
     class AllocPolicy {};
     // this is a template, mainly so swig does not pick it up
+    /** Base class routing the allocations of the derived classes to MemoryTracker */
     template<MemoryCategory Category = MemoryCategory::GENERAL> class AllocatedObject
     {
         friend auto constexpr operator <=>(AllocatedObject, AllocatedObject) = default;
+    public:
+        static auto operator new(size_t size) -> void* { return MemoryTracker::allocate(size, Category); }
+        static auto operator new[](size_t size) -> void* { return MemoryTracker::allocate(size, Category); }
+        static auto operator new(size_t size, std::align_val_t alignment) -> void*
+        { return MemoryTracker::allocate(size, alignment, Category); }
+        static auto operator new[](size_t size, std::align_val_t alignment) -> void*
+        { return MemoryTracker::allocate(size, alignment, Category); }
+        /// placement new, hidden by the ones above otherwise
+        static auto operator new(size_t, void* ptr) noexcept -> void* { return ptr; }
+
+        static void operator delete(void* ptr, size_t size) noexcept
+        { MemoryTracker::deallocate(ptr, size, Category); }
+        static void operator delete[](void* ptr, size_t size) noexcept
+        { MemoryTracker::deallocate(ptr, size, Category); }
+        static void operator delete(void* ptr, size_t size, std::align_val_t alignment) noexcept
+        { MemoryTracker::deallocate(ptr, size, alignment, Category); }
+        static void operator delete[](void* ptr, size_t size, std::align_val_t alignment) noexcept
+        { MemoryTracker::deallocate(ptr, size, alignment, Category); }
+        static void operator delete(void*, void*) noexcept {}
     };
 
     // Useful shortcuts
@@ -97,14 +204,14 @@ namespace Ogre
     using RenderSysAllocPolicy = AllocPolicy;
 
     // Now define all the base classes for each allocation
-    using GeneralAllocatedObject = AllocatedObject<>;
-    using GeometryAllocatedObject = AllocatedObject<>;
-    using AnimationAllocatedObject = AllocatedObject<>;
-    using SceneCtlAllocatedObject = AllocatedObject<>;
-    using SceneObjAllocatedObject = AllocatedObject<>;
-    using ResourceAllocatedObject = AllocatedObject<>;
-    using ScriptingAllocatedObject = AllocatedObject<>;
-    using RenderSysAllocatedObject = AllocatedObject<>;
+    using GeneralAllocatedObject = AllocatedObject<MemoryCategory::GENERAL>;
+    using GeometryAllocatedObject = AllocatedObject<MemoryCategory::GEOMETRY>;
+    using AnimationAllocatedObject = AllocatedObject<MemoryCategory::ANIMATION>;
+    using SceneCtlAllocatedObject = AllocatedObject<MemoryCategory::SCENE_CONTROL>;
+    using SceneObjAllocatedObject = AllocatedObject<MemoryCategory::SCENE_OBJECTS>;
+    using ResourceAllocatedObject = AllocatedObject<MemoryCategory::RESOURCE>;
+    using ScriptingAllocatedObject = AllocatedObject<MemoryCategory::SCRIPTING>;
+    using RenderSysAllocatedObject = AllocatedObject<MemoryCategory::RENDERSYS>;
 
 
     // Per-class allocators defined here
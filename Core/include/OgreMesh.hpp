@@ -190,6 +190,7 @@ class VertexData;
         bool mPreparedForShadowVolumes{false};
         bool mEdgeListsBuilt{false};
         bool mAutoBuildEdgeLists{true};
+        std::unique_ptr<MeshTriangleBVH> mTriangleBVH;
 
         /// Storage of morph animations, lookup by name
         using AnimationList = std::map<std::string, Animation*, std::less<>>;
@@ -204,6 +205,8 @@ class VertexData;
         /// List of available poses for shared and dedicated geometryPoseList
         PoseList mPoseList;
         mutable bool mPosesIncludeNormals{false};
+        /// Textures holding all poses of a geometry, by pose target
+        std::map<ushort, TexturePtr> mPoseTextures;
 
 
         /** Loads the mesh from disk.  This call only performs IO, it
@@ -764,6 +767,17 @@ class VertexData;
         /** Returns whether this mesh has an attached edge list. */
         auto isEdgeListBuilt() const noexcept -> bool { return mEdgeListsBuilt; }
 
+        /** Return the triangle BVH of this mesh, building it if required.
+        @remarks
+            Used for precise ray queries, see RaySceneQuery::setPreciseMeshHits. Building reads
+            the vertex and index buffers, so they must be readable or shadowed. Freed when
+            the mesh is unloaded, call freeTriangleBVH after changing the geometry.
+        */
+        auto getTriangleBVH() -> const MeshTriangleBVH&;
+
+        /** Destroys the triangle BVH of this mesh, if it was built. */
+        void freeTriangleBVH();
+
         /** Prepare matrices for software indexed vertex blend.
         @remarks
             This function organise bone indexed matrices to blend indexed matrices,
@@ -803,6 +817,10 @@ class VertexData;
             as a hint for optimisation.
         @param blendNormals
             If @c true, normals are blended as well as positions.
+        @note
+            Large buffers are blended in vertex ranges spread over the Root's WorkQueue.
+            The buffers are locked on the calling thread, and the call returns once all
+            ranges are done.
         */
         static void softwareVertexBlend(const VertexData* sourceVertexData, 
             const VertexData* targetVertexData,
@@ -824,6 +842,9 @@ class VertexData;
             VertexData destination; assumed to have a separate position
             buffer already bound, and the number of vertices must agree with the
             number in start and end
+        @note
+            Like softwareVertexBlend, large buffers are processed in vertex ranges spread
+            over the Root's WorkQueue.
         */
         static void softwareVertexMorph(Real t, 
             const HardwareVertexBufferSharedPtr& b1, 
@@ -966,6 +987,36 @@ class VertexData;
         /** Get pose list. */
         auto getPoseList() const noexcept -> const PoseList&;
 
+        /** Fills an image with the offsets of all poses of one geometry.
+        @remarks
+            The image is PixelFormat::FLOAT32_RGBA with a texel per vertex and a row per pose of
+            the target, in the order of the pose list. If any of these poses includes normals, a
+            second block of rows holds the normal offsets in the same order, i.e. the pose normals
+            minus the original ones. Vertices a pose does not move are zero.
+        @param target
+            The target geometry index, as passed to createPose.
+        @param image
+            The image to fill.
+        */
+        void buildPoseImage(ushort target, Image& image);
+        /** Gets the texture holding all poses of one geometry, creating it on first use.
+        @remarks
+            This is the image of buildPoseImage, loaded without mipmaps as the texture
+            "<mesh name>/Poses<target>" in the resource group of the mesh. Unlike the vertex
+            streams of includes_pose_animation, any number of poses blend on the GPU through it:
+            a vertex program with GpuProgram::setPoseTextureAnimationIncluded fetches the texel of
+            its vertex index in row i, weights it by pose i of the
+            GpuProgramParameters::AutoConstantType::ANIMATION_POSE_WEIGHTS array and adds it to
+            the position, and likewise with row i + pose count for the normal. Reference the
+            texture by name from a texture unit of the material.
+        @par
+            The vertex count is limited by the maximum texture width of the render system. After
+            changing the poses, call releasePoseTextures to rebuild them.
+        */
+        auto getPoseTexture(ushort target) -> const TexturePtr&;
+        /** Destroys the textures of getPoseTexture. */
+        void releasePoseTextures();
+
         /** Get LOD strategy used by this mesh. */
         auto getLodStrategy() const -> const LodStrategy *;
 
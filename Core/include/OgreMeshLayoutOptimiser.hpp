@@ -0,0 +1,96 @@
+// This file is part of the OGRE project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at https://www.ogre3d.org/licensing.
+module;
+
+#include <cstddef>
+
+export module Ogre.Core:MeshLayoutOptimiser;
+
+export import :MemoryAllocatorConfig;
+export import :Platform;
+export import :Prerequisites;
+
+export
+namespace Ogre {
+class HardwareBufferManagerBase;
+class Mesh;
+class VertexData;
+class VertexDeclaration;
+
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Resources
+    *  @{
+    */
+    /** Reorganises the vertex buffers of meshes into streams by how they are used.
+    @remarks
+        Positions get a stream of their own, so depth only and shadow caster passes, whose
+        shaders read nothing else, fetch 12 bytes per vertex instead of the whole vertex.
+        Normals of meshes with a skeleton get a stream of their own too, as software skinning
+        rewrites them with the positions, and blend weights and indices share another. All
+        other attributes, which never change, are interleaved in a last stream.
+    @par
+        Hardware morph animation replaces the positions, and the normals if the animation has
+        any, with those of the key frames, so these are kept together as the key frames store
+        them. The buffers of the mesh must be readable.
+    */
+    class MeshLayoutOptimiser : public ProgMeshAlloc
+    {
+    public:
+        struct Options
+        {
+            /** Give positions a stream of their own.
+            @remarks
+                Otherwise the layout of VertexDeclaration::getAutoOrganisedDeclaration is used,
+                which interleaves positions with normals where animation allows it.
+            */
+            bool separatePositions{true};
+        };
+
+        /// Outcome of optimise()
+        struct Statistics
+        {
+            /// Number of VertexData whose layout was changed
+            size_t vertexDataChanged{0};
+            /// Number of vertex buffers before the reorganisation
+            size_t buffersBefore{0};
+            /// Number of vertex buffers after the reorganisation
+            size_t buffersAfter{0};
+        };
+
+        /** Reorganises the shared and dedicated vertex data of a mesh.
+        @remarks
+            The animation of the mesh, as of its skeleton and animations, decides which
+            attributes must stay together. The results are logged.
+        */
+        static auto optimise(Mesh* mesh, const Options& options = {}) -> Statistics;
+
+        /** Reorganises one VertexData.
+        @param vertexData The vertex data to reorganise
+        @param skeletalAnimation, vertexAnimation, vertexAnimationNormals
+            How the vertex data is animated, see VertexDeclaration::getAutoOrganisedDeclaration
+        @param options How to organise the streams
+        @param mgr The manager to create the new buffers with, the default one if @c nullptr
+        @return Whether the layout changed
+        */
+        static auto optimise(VertexData* vertexData, bool skeletalAnimation, bool vertexAnimation,
+                             bool vertexAnimationNormals, const Options& options = {},
+                             HardwareBufferManagerBase* mgr = nullptr) -> bool;
+
+        /** Gets the declaration optimise() reorganises a VertexData to.
+        @remarks
+            The caller owns the new declaration, which is created with @c mgr, the default
+            manager if @c nullptr.
+        */
+        [[nodiscard]] static auto getOptimisedDeclaration(const VertexDeclaration* declaration,
+                                                          bool skeletalAnimation, bool vertexAnimation,
+                                                          bool vertexAnimationNormals, const Options& options = {},
+                                                          HardwareBufferManagerBase* mgr = nullptr)
+            -> VertexDeclaration*;
+    };
+    /** @} */
+    /** @} */
+
+}
@@ -0,0 +1,110 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+module;
+
+#include <cstddef>
+
+export module Ogre.Core:MeshLodGenerator;
+
+export import :MemoryAllocatorConfig;
+export import :Platform;
+export import :Prerequisites;
+export import :Vector;
+
+export import <span>;
+export import <vector>;
+
+export
+namespace Ogre {
+class Mesh;
+
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Resources
+    *  @{
+    */
+    /** Generates LOD levels for meshes by simplifying their triangle lists.
+    @remarks
+        Simplification uses the quadric error metric of Garland and Heckbert.
+        Edges are collapsed onto one of their existing vertices, so every
+        generated level is index-only: it reuses the vertex data of the full
+        detail SubMesh and just adds a smaller IndexData. Vertices on open
+        borders, which includes texture and normal seams where vertices are
+        split, are never removed, so the outline of the mesh is preserved.
+    @par
+        Each level is simplified from the previous one and reordered with
+        MeshOptimiser::optimiseVertexCache. The SubMeshes are
+        processed in parallel using WorkQueue::parallelFor, while all hardware
+        buffer access happens on the calling thread.
+    @par
+        The generated levels are registered with the mesh LOD strategy, so
+        userValue is a distance for DistanceLodStrategy and a pixel count for
+        PixelCountLodStrategy, and must be ordered accordingly.
+    */
+    class MeshLodGenerator : public ProgMeshAlloc
+    {
+    public:
+        /// Parameters of one generated LOD level
+        struct LodLevel
+        {
+            /// Value passed to the mesh LOD strategy, see MeshLodUsage::userValue
+            Real userValue;
+            /// Fraction of the full detail triangles to remove, in [0, 1)
+            Real reduction;
+        };
+        using LodLevelList = std::vector<LodLevel>;
+
+        /** Replaces the LOD levels of a mesh by generated ones.
+        @remarks
+            Only triangle lists are simplified, the levels of other SubMeshes
+            reference a copy of their full detail indices. Any existing LOD
+            levels, including manual ones, are removed first. The edge list is
+            rebuilt if it was built before.
+        @param mesh The mesh, which must be loaded and have readable buffers
+        @param levels The levels to generate, not including the full detail one
+        */
+        static void generateLodLevels(Mesh* mesh, const LodLevelList& levels);
+
+        /** Simplifies a triangle list.
+        @remarks
+            The returned triangles only reference vertices of the input. Fewer
+            triangles than requested are only removed if the remaining ones
+            cannot be collapsed without flipping or touching a border.
+        @param positions The vertex positions
+        @param indices The triangle list to simplify
+        @param targetIndexCount The number of indices to reduce to
+        @return The simplified triangle list
+        */
+        static auto simplify(std::span<const Vector3> positions, std::span<const uint32> indices,
+                             size_t targetIndexCount) -> std::vector<uint32>;
+    };
+    /** @} */
+    /** @} */
+
+}
@@ -31,9 +31,14 @@ module;
 
 export module Ogre.Core:MeshManager;
 
+export import :Async;
 export import :Common;
 export import :HardwareBuffer;
 export import :HardwareVertexBuffer;
+export import :MeshLodGenerator;
+export import :MeshLayoutOptimiser;
+export import :MeshOptimiser;
+export import :MeshQuantiser;
 export import :PatchSurface;
 export import :Plane;
 export import :Prerequisites;
@@ -143,6 +148,15 @@ class SubMesh;
             HardwareBuffer::Usage indexBufferUsage = HardwareBuffer::STATIC_WRITE_ONLY,
             bool vertexBufferShadowed = false, bool indexBufferShadowed = false) -> MeshPtr;
 
+        /** Loads a mesh in the background, for a coroutine to await.
+            @copydetails ResourceManager::loadAsync
+        */
+        auto loadAsync(std::string_view filename, std::string_view groupName, CancellationToken token = {})
+            -> ResourceAwaiter<Mesh>
+        {
+            return {true, getResourceType(), filename, groupName, std::move(token)};
+        }
+
 
         /** Creates a new Mesh specifically for manual definition rather
             than loading from an object file. 
@@ -406,6 +420,59 @@ class SubMesh;
         */
         void setBoundsPaddingFactor(Real paddingFactor);
 
+        /** Sets the LOD levels to generate for meshes which are loaded without any.
+        @remarks
+            Applies to meshes loaded from now on, see MeshLodGenerator::generateLodLevels.
+            The buffers of those meshes must be readable, e.g. by using shadow buffers.
+            An empty list, the default, disables the generation.
+        */
+        void setAutoLodLevels(const MeshLodGenerator::LodLevelList& levels);
+
+        /** Gets the LOD levels generated for meshes which are loaded without any. */
+        auto getAutoLodLevels() const noexcept -> const MeshLodGenerator::LodLevelList& { return mAutoLodLevels; }
+
+        /** Sets whether meshes are optimised for rendering when they are loaded.
+        @remarks
+            Uses MeshOptimiser::optimise with the given options. The buffers of
+            the meshes must be readable, e.g. by using shadow buffers. Disabled
+            by default.
+        */
+        void setOptimiseMeshesOnLoad(bool enable, const MeshOptimiser::Options& options = {});
+
+        /** Gets whether meshes are optimised for rendering when they are loaded. */
+        auto getOptimiseMeshesOnLoad() const noexcept -> bool { return mOptimiseOnLoad; }
+
+        /** Gets the options meshes are optimised with when they are loaded. */
+        auto getOptimiseOptions() const noexcept -> const MeshOptimiser::Options& { return mOptimiseOptions; }
+
+        /** Sets whether the vertex data of meshes is quantised when they are loaded.
+        @remarks
+            Uses MeshQuantiser::quantise with the given options, after any
+            optimisation. The buffers of the meshes must be readable. Disabled
+            by default.
+        */
+        void setQuantiseMeshesOnLoad(bool enable, const MeshQuantiser::Options& options = {});
+
+        /** Gets whether the vertex data of meshes is quantised when they are loaded. */
+        auto getQuantiseMeshesOnLoad() const noexcept -> bool { return mQuantiseOnLoad; }
+
+        /** Gets the options vertex data is quantised with when meshes are loaded. */
+        auto getQuantiseOptions() const noexcept -> const MeshQuantiser::Options& { return mQuantiseOptions; }
+
+        /** Sets whether the vertex buffers of meshes are reorganised when they are loaded.
+        @remarks
+            Uses MeshLayoutOptimiser::optimise with the given options, after any
+            quantisation, so that depth and shadow passes fetch the positions only.
+            The buffers of the meshes must be readable. Disabled by default.
+        */
+        void setOptimiseVertexLayoutsOnLoad(bool enable, const MeshLayoutOptimiser::Options& options = {});
+
+        /** Gets whether the vertex buffers of meshes are reorganised when they are loaded. */
+        auto getOptimiseVertexLayoutsOnLoad() const noexcept -> bool { return mOptimiseLayoutsOnLoad; }
+
+        /** Gets the options vertex buffers are reorganised with when meshes are loaded. */
+        auto getVertexLayoutOptions() const noexcept -> const MeshLayoutOptimiser::Options& { return mLayoutOptions; }
+
         /** Sets the listener used to control mesh loading through the serializer.
         */
         void setListener(MeshSerializerListener *listener);
@@ -481,6 +548,21 @@ class SubMesh;
         //the factor by which the bounding box of an entity is padded   
         Real mBoundsPaddingFactor{0.01};
 
+        // LOD levels generated for meshes loaded without any
+        MeshLodGenerator::LodLevelList mAutoLodLevels;
+
+        // Whether and how meshes are optimised when loaded
+        bool mOptimiseOnLoad{false};
+        MeshOptimiser::Options mOptimiseOptions;
+
+        // Whether and how vertex data is quantised when loaded
+        bool mQuantiseOnLoad{false};
+        MeshQuantiser::Options mQuantiseOptions;
+
+        // Whether and how vertex buffers are reorganised when loaded
+        bool mOptimiseLayoutsOnLoad{false};
+        MeshLayoutOptimiser::Options mLayoutOptions;
+
         // The listener to pass to serializers
         MeshSerializerListener *mListener{nullptr};
 
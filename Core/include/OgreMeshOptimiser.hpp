@@ -0,0 +1,148 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+module;
+
+#include <cstddef>
+
+export module Ogre.Core:MeshOptimiser;
+
+export import :MemoryAllocatorConfig;
+export import :Platform;
+export import :Prerequisites;
+export import :Vector;
+
+export import <span>;
+export import <vector>;
+
+export
+namespace Ogre {
+class Mesh;
+
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Resources
+    *  @{
+    */
+    /** Reorders mesh data for faster rendering.
+    @remarks
+        The optimisation runs in up to three passes, each of which keeps the
+        rendered result unchanged:
+        - the triangles are ordered for the post transform vertex cache, using
+          the linear-speed algorithm of Tom Forsyth
+        - runs of triangles which start with a cold cache are sorted so that
+          clusters towards the outside of the mesh are drawn first, which
+          reduces overdraw at a bounded cost in cache efficiency
+        - the vertices are renumbered in the order they are first used, which
+          makes vertex fetches sequential. This touches every vertex buffer of
+          the VertexData, as well as poses, morph keyframes and bone assignments
+          referring to it.
+    @par
+        The quality of the vertex cache use is measured by the average cache miss
+        ratio (ACMR): the number of vertices transformed per triangle.
+    */
+    class MeshOptimiser : public ProgMeshAlloc
+    {
+    public:
+        /// Cache size used for the ACMR, matches VertexCacheProfiler
+        static constexpr size_t DEFAULT_CACHE_SIZE = 16;
+
+        /// Passes to run
+        struct Options
+        {
+            /// Reorder the triangles for the vertex cache
+            bool vertexCache{true};
+            /** Maximum factor by which sorting for overdraw may raise the ACMR.
+            @remarks
+                Values below 1 disable the overdraw pass.
+            */
+            Real overdrawThreshold{1.05};
+            /// Renumber the vertices in fetch order
+            bool vertexFetch{true};
+            /// Switch 32 bit index buffers to 16 bit when all indices fit
+            bool use16BitIndices{true};
+        };
+
+        /// Outcome of optimise()
+        struct Statistics
+        {
+            /// ACMR of all full detail triangle lists before the optimisation
+            Real acmrBefore{0};
+            /// ACMR of all full detail triangle lists after the optimisation
+            Real acmrAfter{0};
+            /// Number of index buffers which were switched to 16 bit
+            size_t convertedIndexBuffers{0};
+        };
+
+        /** Optimises all SubMeshes and LOD levels of a mesh.
+        @remarks
+            The buffers of the mesh must be readable. Only triangle lists are
+            reordered, but the indices of all other indexed SubMeshes follow the
+            vertex renumbering. Vertex data used by a SubMesh without indices is
+            not renumbered. The results are logged.
+        @note
+            Pose hardware buffers which were already created are not updated.
+        */
+        static auto optimise(Mesh* mesh, const Options& options = {}) -> Statistics;
+
+        /** Reorders a triangle list for the post transform vertex cache.
+        @param indices The triangle list, reordered in place
+        @param vertexCount The number of vertices referenced
+        */
+        static void optimiseVertexCache(std::span<uint32> indices, size_t vertexCount);
+
+        /** Sorts clusters of a cache optimised triangle list to reduce overdraw.
+        @param positions The vertex positions
+        @param indices The triangle list, reordered in place
+        @param threshold Maximum factor by which the ACMR may rise
+        @param cacheSize The cache size to evaluate the ACMR with
+        */
+        static void optimiseOverdraw(std::span<const Vector3> positions, std::span<uint32> indices,
+                                     Real threshold, size_t cacheSize = DEFAULT_CACHE_SIZE);
+
+        /** Builds a vertex renumbering in order of first use.
+        @remarks
+            Vertices which are not referenced are moved behind all others.
+        @param indexLists The index lists using the vertices, in draw order
+        @param vertexCount The number of vertices
+        @return The new index of each vertex
+        */
+        static auto buildVertexFetchRemap(std::span<const std::span<const uint32>> indexLists,
+                                          size_t vertexCount) -> std::vector<uint32>;
+
+        /** Gets the average cache miss ratio of a triangle list.
+        @param indices The triangle list
+        @param cacheSize Number of entries of the simulated FIFO cache
+        @return Transformed vertices per triangle, between 3 and about 0.5
+        */
+        static auto calculateACMR(std::span<const uint32> indices, size_t cacheSize = DEFAULT_CACHE_SIZE) -> Real;
+    };
+    /** @} */
+    /** @} */
+
+}
@@ -0,0 +1,118 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+module;
+
+#include <cstddef>
+
+export module Ogre.Core:MeshQuantiser;
+
+export import :HardwareVertexBuffer;
+export import :MemoryAllocatorConfig;
+export import :Platform;
+export import :Prerequisites;
+
+export
+namespace Ogre {
+class HardwareBufferManagerBase;
+class Mesh;
+class VertexData;
+
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Resources
+    *  @{
+    */
+    /** Stores mesh vertex attributes in compact formats.
+    @remarks
+        Normals, tangents and binormals are converted from floats to normalized
+        integers, and texture coordinates to half floats. The new formats are
+        decoded by the vertex fetch hardware, so shaders, the RTSS and the fixed
+        function pipeline all receive the same floats as before, without any
+        decode code. The VertexDeclaration is rewritten accordingly.
+    @par
+        Positions are kept as floats, since bounds, picking, edge lists and
+        software animation all read them on the CPU. For the same reason the
+        normals of meshes with a skeleton or vertex animation are kept as they
+        are. Quantise after building tangents, as that reads the texture
+        coordinates.
+    */
+    class MeshQuantiser : public ProgMeshAlloc
+    {
+    public:
+        /// Largest error allowed when converting texture coordinates to half floats
+        static constexpr float MAX_TEXCOORD_ERROR = 1.0f / 2048;
+
+        /// Formats to convert to
+        struct Options
+        {
+            /** Format for normals, tangents and binormals.
+            @remarks
+                VertexElementType::INT_10_10_10_2_NORM, VertexElementType::SHORT4_NORM
+                or VertexElementType::FLOAT3 to keep them unchanged.
+            */
+            VertexElementType normalType{VertexElementType::INT_10_10_10_2_NORM};
+            /** Store 2 and 4 component texture coordinates as half floats.
+            @remarks
+                Coordinate sets which would change by more than MAX_TEXCOORD_ERROR
+                are kept as floats.
+            */
+            bool halfTexCoords{true};
+        };
+
+        /// Outcome of quantise()
+        struct Statistics
+        {
+            /// Size of all vertex buffers before the conversion
+            size_t bytesBefore{0};
+            /// Size of all vertex buffers after the conversion
+            size_t bytesAfter{0};
+        };
+
+        /** Quantises the shared and dedicated vertex data of a mesh.
+        @remarks
+            The buffers of the mesh must be readable. The results are logged.
+        */
+        static auto quantise(Mesh* mesh, const Options& options = {}) -> Statistics;
+
+        /** Quantises one VertexData.
+        @param vertexData The vertex data to convert
+        @param options The formats to convert to
+        @param convertNormals Whether normals, tangents and binormals may be converted
+        @param mgr The manager to create the new buffers with, the default one if @c nullptr
+        */
+        static void quantise(VertexData* vertexData, const Options& options, bool convertNormals = true,
+                             HardwareBufferManagerBase* mgr = nullptr);
+
+        /// Packs a unit vector as VertexElementType::INT_10_10_10_2_NORM
+        static auto packInt1010102(float x, float y, float z, float w = 1) -> uint32;
+    };
+    /** @} */
+    /** @} */
+
+}
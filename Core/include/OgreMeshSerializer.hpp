@@ -47,6 +47,8 @@ namespace Ogre {
         /// Latest version available
         LATEST,
         
+        /// OGRE version v1.11+, vertex data aligned to 16 bytes in the file
+        _1_11,
         /// OGRE version v1.10+
         _1_10,
         /// OGRE version v1.8+
@@ -64,7 +64,7 @@ class VertexData;
     will remain to load the latest version.
 
      @note
-        This mesh format was used from Ogre v1.10.
+        This mesh format was used from Ogre v1.11.
 
     */
     class MeshSerializerImpl : public Serializer
@@ -197,11 +197,29 @@ class VertexData;
         virtual void enableValidation();
 
         ushort exportedLodCount; // Needed to limit exported Edge data, when exporting
+
+        /** Alignment of the vertex data within the file, 0 for none, at most 16.
+        @remarks
+            Vertex buffer data chunks then start with a byte giving the number
+            of padding bytes before the data, and are padded after the data to
+            a constant size. Files loaded into memory can then be uploaded
+            straight from their aligned vertex data.
+        */
+        size_t mVertexDataAlignment{16};
+    };
+
+    /** Class for providing backwards-compatibility for loading version 1.100 of the .mesh format.
+     This mesh format was used from Ogre v1.10, it is the same with unaligned vertex data.
+     */
+    class MeshSerializerImpl_v1_10 : public MeshSerializerImpl
+    {
+    public:
+        MeshSerializerImpl_v1_10();
     };
 
 
     /** Class for providing backwards-compatibility for loading version 1.8 of the .mesh format. 
-     This mesh format was used from Ogre v1.8.
+     This mesh format was used from Ogre v1.8, with unaligned vertex data.
      */
     class MeshSerializerImpl_v1_8 : public MeshSerializerImpl
     {
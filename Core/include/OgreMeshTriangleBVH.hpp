@@ -0,0 +1,92 @@
+// This file is part of the OGRE project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at https://www.ogre3d.org/licensing.
+module;
+
+#include <cstddef>
+
+export module Ogre.Core:MeshTriangleBVH;
+
+export import :Math;
+export import :MemoryAllocatorConfig;
+export import :Platform;
+export import :Prerequisites;
+
+export import <array>;
+export import <vector>;
+
+export
+namespace Ogre
+{
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Math
+    *  @{
+    */
+
+    /** A bounding volume hierarchy of the triangles of a Mesh, to intersect rays with them precisely.
+    @remarks
+        Built by Mesh::getTriangleBVH from the vertex and index data of every SubMesh, so the
+        buffers must be readable, see Mesh::setVertexBufferPolicy and Mesh::setIndexBufferPolicy.
+        Triangle lists, strips and fans are included, other operation types are ignored. The mesh
+        is taken as it is stored: the highest LOD, without skeletal, morph or pose animation.
+    @par
+        The triangles of each leaf are stored as Math::TriangleArrays, so a leaf is tested with a
+        single call of the SIMD implementation of Math::intersects.
+    */
+    class MeshTriangleBVH : public GeometryAllocatedObject
+    {
+    public:
+        /// The number of triangles a leaf holds at most
+        static constexpr size_t MAX_LEAF_TRIANGLES = 16;
+
+        /// The nearest triangle hit by a ray
+        struct Hit
+        {
+            bool hit{false};
+            /// Along the ray, in units of the length of its direction
+            Real distance{Math::POS_INFINITY};
+            /// Index of the SubMesh
+            size_t subMesh{0};
+            /// Index of the triangle in the render operation of the SubMesh
+            size_t triangle{0};
+        };
+
+        /** Builds the hierarchy, reading the buffers of the mesh */
+        explicit MeshTriangleBVH(const Mesh& mesh);
+
+        /** Finds the nearest triangle hit by a ray.
+        @param ray
+            The ray, in the space of the mesh.
+        @param positiveSide, negativeSide
+            Which sides of the triangles to intersect, see Math::intersects.
+        */
+        [[nodiscard]] auto intersects(const Ray& ray, bool positiveSide = true, bool negativeSide = true) const -> Hit;
+
+        [[nodiscard]] auto getTriangleCount() const noexcept -> size_t { return mTriangleIndices.size(); }
+        [[nodiscard]] auto getNodeCount() const noexcept -> size_t { return mNodes.size(); }
+
+    private:
+        struct Node
+        {
+            std::array<Real, 3> min;
+            std::array<Real, 3> max;
+            /// The first triangle of a leaf, or the first of the two children of an inner node
+            uint32 first;
+            /// The number of triangles of a leaf, 0 for inner nodes
+            uint32 count;
+        };
+
+        void build(uint32 node, uint32 begin, uint32 end, std::vector<uint32>& order,
+                   const std::vector<Vector3>& vertices);
+
+        std::vector<Node> mNodes;
+        /// a, b - a and c - a of the triangles in the order of the leaves, see Math::TriangleArrays
+        std::array<std::vector<Real>, 9> mTriangles;
+        std::vector<uint32> mSubMeshes;
+        std::vector<uint32> mTriangleIndices;
+    };
+    /** @} */
+    /** @} */
+}
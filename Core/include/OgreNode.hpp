@@ -25,6 +25,10 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 THE SOFTWARE.
 -----------------------------------------------------------------------------
 */
+module;
+
+#include <cstddef>
+
 export module Ogre.Core:Node;
 
 export import :Math;
@@ -38,8 +42,11 @@ export import :String;
 export import :Vector;
 
 export import <algorithm>;
+export import <atomic>;
+export import <mutex>;
 export import <set>;
 export import <string_view>;
+export import <utility>;
 export import <vector>;
 
 export
@@ -105,6 +112,26 @@ class Camera;
             virtual void nodeDetached(const Node*) {}
         };
 
+        /** Nodes whose needUpdate call is queued, @see queueNeedUpdate.
+        @remarks
+            Nodes may be queued from several threads at once, the queue is drained by
+            the thread which updates the scene.
+        */
+        class QueuedUpdates
+        {
+        public:
+            /// Queues the node, unless it is already queued
+            void push(Node* n);
+            /// Removes the node, if it is queued here
+            void remove(Node* n);
+            /// Calls needUpdate on all queued nodes and empties the queue
+            void process();
+
+        private:
+            std::mutex mMutex;
+            std::vector<Node*> mNodes;
+        };
+
     protected:
         /// Pointer to parent node
         Node* mParent;
@@ -123,8 +150,6 @@ class Camera;
         bool mNeedChildUpdate : 1;
         /// Flag indicating that parent has been notified about update request
         bool mParentNotified : 1;
-        /// Flag indicating that the node has been queued for update
-        bool mQueuedForUpdate : 1;
         /// Stores whether this node inherits orientation from it's parent
         bool mInheritOrientation : 1;
         /// Stores whether this node inherits scale from it's parent
@@ -135,6 +160,8 @@ class Camera;
         Quaternion mOrientation;
         /// Stores the position/translation of the node relative to its parent.
         Vector3 mPosition;
+        /// mPosition in double precision, see setPositionDouble
+        Vector3d mPositionDouble{0.0, 0.0, 0.0};
         /// Stores the scaling factor applied to this node
         Vector3 mScale;
 
@@ -162,6 +189,9 @@ class Camera;
         */
         mutable Vector3 mDerivedPosition;
 
+        /// mDerivedPosition in double precision, see _getDerivedPositionDouble
+        mutable Vector3d mDerivedPositionDouble{0.0, 0.0, 0.0};
+
         /** Cached combined scale.
         @par
             This member is the position derived by combining the
@@ -186,7 +216,16 @@ class Camera;
             general sequence of updateFromParent (e.g. raising events)
         */
         virtual void updateFromParentImpl() const;
+
+        /** Called whenever the derived transform has been recomputed.
+        @remarks
+            Unlike updateFromParentImpl this is also called when the derived transform
+            was computed outside of the node, e.g. by NodeTransformSoA.
+        */
+        virtual void derivedTransformUpdated() const {}
     private:
+        friend class NodeTransformSoA;
+
         /// The position to use as a base for keyframe animation
         Vector3 mInitialPosition;
         /// The orientation to use as a base for keyframe animation
@@ -197,9 +236,25 @@ class Camera;
         /** Node listener - only one allowed (no list) for size & performance reasons. */
         Listener* mListener;
 
-        using QueuedUpdates = std::vector<Node *>;
+        /// The queue this node is in, if its needUpdate call is queued
+        QueuedUpdates* mQueuedUpdates{nullptr};
+        /// The queue of the nodes which are not part of a scene
         static QueuedUpdates msQueuedUpdates;
 
+        /// Number of derived transform updates done by _update on the current thread
+        static thread_local size_t msThreadUpdateCount;
+        /// Number of nodes processed by _update on the current thread
+        static thread_local size_t msThreadVisitCount;
+
+        /// Incremented whenever a node is attached to or detached from a parent
+        static std::atomic<uint64> msHierarchyVersion;
+
+        /** The queue of the scene this node belongs to, @see queueNeedUpdate.
+        @remarks
+            Nodes which are not part of a scene use a queue shared by all of them.
+        */
+        virtual auto getQueuedUpdates() -> QueuedUpdates* { return &msQueuedUpdates; }
+
         /** Internal method for creating a new child node - must be overridden per subclass. */
         virtual auto createChildImpl() -> Node* = 0;
 
@@ -271,6 +326,19 @@ class Camera;
         */
         auto getPosition() const noexcept -> const Vector3 & { return mPosition; }
 
+        /** Sets the position of the node relative to it's parent in double precision.
+        @remarks
+            For large worlds, where single precision positions far from the origin make
+            objects jitter. The node keeps the double precision position and derives a
+            double precision world position from it, see _getDerivedPositionDouble, which
+            SceneManager::setLargeWorldRendering renders relative to the camera. setPosition
+            and translate keep it too, getPosition returns it rounded to single precision.
+        */
+        void setPositionDouble(const Vector3d& pos);
+
+        /** Gets the position of the node relative to it's parent in double precision. */
+        auto getPositionDouble() const noexcept -> const Vector3d& { return mPositionDouble; }
+
         /** Sets the scaling factor applied to this node.
         @remarks
             Scaling factors, unlike other transforms, are not always inherited by child nodes.
@@ -526,6 +594,15 @@ class Camera;
         */
         auto _getDerivedPosition() const -> const Vector3 &;
 
+        /** Gets the position of the node as derived from all parents, in double precision.
+        @remarks
+            Exact for positions set with setPositionDouble on nodes whose ancestors have
+            neither orientation nor scale, like the children of the root node; the offsets
+            below rotated or scaled parents are single precision. Not kept by NodeTransformSoA,
+            which derives in single precision.
+        */
+        auto _getDerivedPositionDouble() const -> const Vector3d &;
+
         /** Gets the scaling factor of the node as derived from all parents.
         */
         auto _getDerivedScale() const -> const Vector3 &;
@@ -555,6 +632,52 @@ class Camera;
         */
         virtual void _update(bool updateChildren, bool parentHasChanged);
 
+        /// A child to be updated along with the parentHasChanged flag it has to be passed
+        using PendingChildUpdate = std::pair<Node*, bool>;
+
+        /** Internal method to update this Node only, leaving the update of the children to the caller.
+        @note
+            Does the same as _update(true, parentHasChanged), except that instead of recursing
+            into the children, the children which would have been updated are appended to
+            @c children. The caller has to call _update(true, flag) on each of them.
+            This is used to distribute the scene graph update over several threads.
+        */
+        void _updateSelf(bool parentHasChanged, std::vector<PendingChildUpdate>& children);
+
+        /** Number of derived transforms recomputed by _update on the calling thread so far.
+        @remarks
+            This is a running counter; take the difference of two readings to
+            get the number of nodes updated in between.
+        */
+        static auto _getThreadUpdateCount() noexcept -> size_t { return msThreadUpdateCount; }
+
+        /** Returns the number of nodes processed by _update on the calling thread.
+        @remarks
+            Counts every node the update recursion passed through, including those which
+            were only visited to reach a dirty descendant. See _getThreadUpdateCount.
+        */
+        static auto _getThreadVisitCount() noexcept -> size_t { return msThreadVisitCount; }
+
+        /** Returns whether this node or any node below it is waiting for an update.
+        @remarks
+            needUpdate marks the node itself and registers it with its parents through
+            requestUpdate, so every ancestor of a dirty node knows it has a dirty
+            descendant. Nodes which return false here and whose parent has not changed
+            can be skipped by _update together with their whole subtree.
+        */
+        auto _isUpdatePending() const noexcept -> bool
+        {
+            return mNeedParentUpdate || mNeedChildUpdate || !mChildrenToUpdate.empty();
+        }
+
+        /** Returns a counter which changes every time any node is attached to or detached from a parent.
+        @remarks
+            Allows caches of the hierarchy layout, such as NodeTransformSoA, to detect
+            whether they need to be rebuilt. The counter is shared by all scenes, so a
+            change in one scene also invalidates the caches of the others.
+        */
+        static auto _getHierarchyVersion() noexcept -> uint64 { return msHierarchyVersion.load(std::memory_order_relaxed); }
+
         /** Sets a listener for this Node.
         @remarks
             Note for size and performance reasons only one listener per node is
@@ -641,9 +764,12 @@ class Camera;
             response to a Node::Listener hook, because the graph is already being 
             updated, and update flag changes cannot be made reliably in that context. 
             Call this method if you need to queue a needUpdate call in this case.
+        @par
+            The node goes into the queue of its SceneManager, which processes it on the
+            thread updating the scene graph, so it may be queued from any thread.
         */
         static void queueNeedUpdate(Node* n);
-        /** Process queued 'needUpdate' calls. */
+        /** Process queued 'needUpdate' calls of the nodes which are not part of a scene. */
         static void processQueuedUpdates();
     };
     /** @} */
@@ -0,0 +1,153 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+module;
+
+#include <cstddef>
+
+export module Ogre.Core:NodeTransformSoA;
+
+export import :MemoryAllocatorConfig;
+export import :Platform;
+export import :Prerequisites;
+
+export import <utility>;
+export import <vector>;
+
+export
+namespace Ogre {
+class Node;
+
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Scene
+    *  @{
+    */
+    /** Packed structure-of-arrays mirror of a node hierarchy's transforms.
+    @remarks
+        The hierarchy below a root node is flattened breadth first, so that every
+        depth level occupies one contiguous range and parents always precede their
+        children. Local and derived transforms are held component-wise in SIMD
+        aligned arrays, each level being padded to a multiple of BLOCK_SIZE lanes.
+        This lets the derived transforms be computed BLOCK_SIZE nodes at a time
+        with loops the compiler can vectorise, instead of walking the tree and
+        calling Node::_updateFromParent per node.
+    @par
+        The Node objects remain the authoritative storage: update() gathers the
+        local transforms, recomputes every derived transform below the root and
+        scatters the results back, raising the same notifications as
+        Node::_updateFromParent. The public Node API is unaffected. The layout
+        must be rebuilt with build() whenever the hierarchy changes, which can be
+        detected using Node::_getHierarchyVersion.
+    @note
+        Nodes which override Node::updateFromParentImpl with a different transform
+        combination (e.g. TagPoint) are not supported. The derived positions are single
+        precision, so Node::_getDerivedPositionDouble is too.
+    */
+    class NodeTransformSoA : public NodeAlloc
+    {
+    public:
+        /// Number of nodes processed together; each level is padded to a multiple of this
+        static constexpr size_t BLOCK_SIZE = 8;
+        /// Alignment in bytes of the component arrays
+        static constexpr size_t ALIGNMENT = BLOCK_SIZE * sizeof(Real);
+
+        /** Flattens the hierarchy below the given node.
+        @param root Root of the hierarchy. If it has a parent, the parent's derived
+            transform is used as the base of the hierarchy.
+        */
+        void build(Node* root);
+
+        /// Releases the packed layout
+        void clear();
+
+        /** Recomputes the derived transforms of all packed nodes.
+        @remarks
+            Does nothing if no node below the root has a pending update.
+        @return The number of nodes which were updated
+        */
+        auto update() -> size_t;
+
+        /// Gets the root node of the packed hierarchy
+        [[nodiscard]] auto getRoot() const noexcept -> Node* { return mRoot; }
+        /// Gets the Node::_getHierarchyVersion value at the time build() was called
+        [[nodiscard]] auto getHierarchyVersion() const noexcept -> uint64 { return mHierarchyVersion; }
+        /// Gets the number of packed nodes, not counting padding
+        [[nodiscard]] auto getNumNodes() const noexcept -> size_t { return mNumNodes; }
+        /// Gets the number of depth levels
+        [[nodiscard]] auto getNumLevels() const noexcept -> size_t { return mLevels.empty() ? 0 : mLevels.size() - 1; }
+        /** Gets the [begin, end) slot range of the given level.
+        @remarks
+            Slots may hold @c nullptr padding entries, see getNode.
+        */
+        [[nodiscard]] auto getLevelRange(size_t level) const -> std::pair<size_t, size_t>
+        {
+            return {mLevels[level], mLevels[level + 1]};
+        }
+        /// Gets the node stored in the given slot, @c nullptr for padding
+        [[nodiscard]] auto getNode(size_t slot) const -> Node* { return mNodes[slot]; }
+
+    private:
+        using RealArray = aligned_vector<Real, ALIGNMENT>;
+
+        /// One transform, component-wise
+        struct TransformArrays
+        {
+            RealArray posX, posY, posZ;
+            RealArray rotW, rotX, rotY, rotZ;
+            RealArray sclX, sclY, sclZ;
+
+            void resize(size_t size);
+        };
+
+        Node* mRoot{nullptr};
+        uint64 mHierarchyVersion{0};
+        size_t mNumNodes{0};
+
+        /// Nodes in hierarchy order, @c nullptr for padding
+        std::vector<Node*> mNodes;
+        /// For each slot, the slot of the parent; the root uses itself
+        std::vector<uint32> mParents;
+        /// Slot ranges of the levels, one entry more than there are levels
+        std::vector<size_t> mLevels;
+        /// Per slot inheritance flags
+        std::vector<uint8> mInheritOrientation, mInheritScale;
+
+        TransformArrays mLocal;
+        TransformArrays mDerived;
+        /// Parent derived transforms for the level being processed
+        TransformArrays mParentDerived;
+
+        void gatherLocal();
+        void computeLevel(size_t begin, size_t end);
+        void scatterDerived();
+    };
+    /** @} */
+    /** @} */
+
+}
@@ -0,0 +1,178 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+module;
+
+#include <cstddef>
+
+export module Ogre.Core:OcclusionCulling;
+
+export import :AxisAlignedBox;
+export import :MemoryAllocatorConfig;
+export import :Platform;
+export import :Prerequisites;
+export import :SharedPtr;
+export import :Vector;
+export import :VisibilityStage;
+
+export import <algorithm>;
+export import <map>;
+export import <memory>;
+export import <unordered_map>;
+export import <vector>;
+
+export
+namespace Ogre {
+class Camera;
+class HardwareOcclusionQuery;
+class RenderSystem;
+class SceneManager;
+class SceneNode;
+
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Scene
+    *  @{
+    */
+    /** Coherent hardware occlusion culling of scene nodes.
+    @remarks
+        Follows the idea of coherent hierarchical culling (CHC++): the visibility of a node
+        rarely changes from one frame to the next, so the result of the previous frame is
+        used instead of waiting for the GPU. After the scene was rendered the bounding boxes
+        of the nodes that need a new test are drawn with HardwareOcclusionQuery objects
+        around them, and the results are consumed in a later frame as soon as they are
+        available, so the pipeline never stalls.
+    @par
+        Nodes found occluded are skipped together with their subtree and tested again every
+        frame. Visible nodes are assumed to stay visible for a number of frames before they
+        are tested again, with the first test spread randomly over that interval so that the
+        queries of a scene which just became visible are not all issued in the same frame.
+    @par
+        The state is kept per camera. Nodes which were occluded and become visible appear
+        with the latency of one query, which is the price for never waiting on the GPU.
+    @note
+        Only active if the render system has the Capabilities::HWOCCLUSION capability.
+    */
+    class OcclusionCulling : public VisibilityStage
+    {
+    public:
+        /// Statistics about the last culled frame
+        struct Stats
+        {
+            /// Number of nodes whose visibility was checked
+            size_t nodesTested{0};
+            /// Number of nodes skipped because they were occluded
+            size_t nodesOccluded{0};
+            /// Number of queries issued after rendering
+            size_t queriesIssued{0};
+            /// Number of nodes whose query result was not available yet
+            size_t queriesPending{0};
+        };
+
+        OcclusionCulling();
+        ~OcclusionCulling() override;
+
+        OcclusionCulling(const OcclusionCulling&) = delete;
+        auto operator=(const OcclusionCulling&) -> OcclusionCulling& = delete;
+
+        /** Sets the number of frames a visible node is assumed to stay visible before it is tested again. */
+        void setVisiblePersistence(uint32 frames) { mVisiblePersistence = std::max<uint32>(frames, 1); }
+        /** Gets the number of frames a visible node is assumed to stay visible. */
+        auto getVisiblePersistence() const noexcept -> uint32 { return mVisiblePersistence; }
+
+        /** Sets the number of samples above which a node counts as visible. */
+        void setVisibilityThreshold(uint32 samples) { mVisibilityThreshold = samples; }
+        /** Gets the number of samples above which a node counts as visible. */
+        auto getVisibilityThreshold() const noexcept -> uint32 { return mVisibilityThreshold; }
+
+        /** Gets the statistics about the last culled frame. */
+        auto getStats() const noexcept -> const Stats& { return mStats; }
+
+        /** Starts culling for the given camera.
+        @remarks
+            Does nothing unless the destination render system of the SceneManager supports
+            hardware occlusion queries.
+        */
+        void _beginFrame(const Camera* cam, SceneManager* sceneMgr) override;
+
+        /** Tests whether the content within the bounds of the node may be visible.
+        @remarks
+            Always returns true outside of _beginFrame / _endFrame.
+        */
+        auto _isVisible(const SceneNode* node, const AxisAlignedBox& bounds) -> bool override;
+
+        /** Issues the queries requested by _isVisible. */
+        void _endFrame(SceneManager* sceneMgr) override;
+
+        void _notifyNodeDestroyed(const SceneNode* node) override;
+        void _notifyAllNodesDestroyed() override;
+        void _notifyCameraDestroyed(const Camera* cam) override;
+
+    private:
+        class BoundingBoxRenderable;
+
+        struct NodeState
+        {
+            HardwareOcclusionQuery* query{nullptr};
+            /// The frame the visible node should be tested again
+            unsigned long nextQueryFrame{0};
+            bool visible{true};
+            /// Whether the query result was not consumed yet
+            bool pending{false};
+        };
+        using NodeStateMap = std::unordered_map<const SceneNode*, NodeState>;
+
+        struct PendingQuery
+        {
+            NodeState* state;
+            AxisAlignedBox bounds;
+        };
+
+        std::map<const Camera*, NodeStateMap> mCameraStates;
+        /// State of the camera being culled, @c nullptr if not active
+        NodeStateMap* mCurrentStates{nullptr};
+        std::vector<PendingQuery> mQueryList;
+        std::vector<HardwareOcclusionQuery*> mFreeQueries;
+        RenderSystem* mRenderSystem{nullptr};
+        std::unique_ptr<BoundingBoxRenderable> mBoundingBox;
+
+        Vector3 mCameraPosition{Vector3::ZERO};
+        /// Distance of the near plane corners from the camera
+        Real mNearRadius{0};
+        unsigned long mFrame{0};
+        uint32 mVisiblePersistence{8};
+        uint32 mVisibilityThreshold{0};
+        Stats mStats;
+
+        void releaseState(NodeState& state);
+        void destroyQueries();
+    };
+    /** @} */
+    /** @} */
+
+}
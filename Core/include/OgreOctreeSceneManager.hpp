@@ -0,0 +1,329 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+module;
+
+#include <cstddef>
+
+export module Ogre.Core:OctreeSceneManager;
+
+export import :AxisAlignedBox;
+export import :MemoryAllocatorConfig;
+export import :Platform;
+export import :Prerequisites;
+export import :SceneManager;
+export import :SceneNode;
+export import :SceneQuery;
+
+export import <array>;
+export import <memory>;
+export import <mutex>;
+export import <vector>;
+
+export
+namespace Ogre {
+class Camera;
+class OctreeSceneNode;
+struct VisibleObjectsBoundsInfo;
+
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Scene
+    *  @{
+    */
+    /** Loose octree over the bounds of scene nodes.
+    @remarks
+        Every octant owns its cell of space, but accepts nodes reaching up to half a cell
+        beyond it, i.e. its loose bounds are twice the size of the cell. A node therefore
+        always lives in exactly one octant, chosen by the centre and the size of its bounds,
+        and moving it only ever relocates that single entry.
+    @par
+        Nodes are indexed by the bounds of the objects attached to them, see
+        OctreeSceneNode::getQueryBounds. Nodes which are infinite or outside of the world
+        bounds of the octree are kept in the root octant, which is always traversed.
+    */
+    class LooseOctree : public SceneMgtAlloc
+    {
+    public:
+        struct Octant
+        {
+            /// The region of space owned by this octant
+            AxisAlignedBox cellBounds;
+            /// The region any node stored here lies within, twice the size of the cell
+            AxisAlignedBox looseBounds;
+            /// Parent octant, @c nullptr for the root
+            Octant* parent{nullptr};
+            /// Number of nodes stored in this octant and all octants below
+            size_t numNodes{0};
+            /// Nodes stored in this octant
+            std::vector<OctreeSceneNode*> nodes;
+            /// Child octants, created on demand
+            std::array<std::unique_ptr<Octant>, 8> children;
+        };
+
+        /** Constructor.
+        @param worldBounds The region to subdivide. It is extended to a cube.
+        @param maxDepth The maximum number of subdivisions below the root octant.
+        */
+        LooseOctree(const AxisAlignedBox& worldBounds, uint16 maxDepth);
+        ~LooseOctree();
+
+        LooseOctree(const LooseOctree&) = delete;
+        auto operator=(const LooseOctree&) -> LooseOctree& = delete;
+
+        /** Inserts the node, or relocates it if its bounds changed. */
+        void update(OctreeSceneNode* node);
+        /** Removes the node, if it is stored. */
+        void remove(OctreeSceneNode* node);
+        /** Removes all nodes. */
+        void clear();
+
+        /** Visits the stored nodes.
+        @param octantTest Called with the loose bounds of every non-empty octant below the
+            root, the octant and its children are skipped unless it returns true.
+        @param visitor Called for every node in the visited octants, the walk stops as
+            soon as it returns false.
+        @return false if the walk was stopped by the visitor
+        */
+        template <typename OctantTest, typename NodeVisitor>
+        auto walk(OctantTest&& octantTest, NodeVisitor&& visitor) const -> bool
+        {
+            return walkOctant(*mRoot, octantTest, visitor);
+        }
+
+        /// Gets the cubic region subdivided by this octree
+        [[nodiscard]] auto getWorldBounds() const noexcept -> const AxisAlignedBox& { return mRoot->cellBounds; }
+        /// Gets the maximum number of subdivisions
+        [[nodiscard]] auto getMaxDepth() const noexcept -> uint16 { return mMaxDepth; }
+        /// Gets the number of stored nodes
+        [[nodiscard]] auto getNumNodes() const noexcept -> size_t { return mRoot->numNodes; }
+        /// Gets the root octant
+        [[nodiscard]] auto getRoot() const noexcept -> const Octant& { return *mRoot; }
+
+    private:
+        std::unique_ptr<Octant> mRoot;
+        uint16 mMaxDepth;
+
+        auto findOctant(const AxisAlignedBox& bounds) -> Octant*;
+        static void detachNodes(Octant& octant);
+
+        template <typename OctantTest, typename NodeVisitor>
+        static auto walkOctant(const Octant& octant, OctantTest& octantTest, NodeVisitor& visitor) -> bool
+        {
+            for (auto node : octant.nodes)
+            {
+                if (!visitor(node))
+                    return false;
+            }
+
+            for (const auto& child : octant.children)
+            {
+                if (child && child->numNodes && octantTest(child->looseBounds))
+                {
+                    if (!walkOctant(*child, octantTest, visitor))
+                        return false;
+                }
+            }
+            return true;
+        }
+    };
+
+    /** SceneNode which is indexed in the LooseOctree of an OctreeSceneManager. */
+    class OctreeSceneNode : public SceneNode
+    {
+    public:
+        OctreeSceneNode(SceneManager* creator);
+        OctreeSceneNode(SceneManager* creator, std::string_view name);
+        ~OctreeSceneNode() override;
+
+        /** Recomputes the world bounds and schedules the octree update if they changed. */
+        void _updateBounds() override;
+
+        /** Gets the world bounds of the objects attached to this node, not including children.
+        @remarks
+            This is what the octree indexes, as the bounds of whole subtrees would end up
+            near the root for any larger hierarchy.
+        */
+        [[nodiscard]] auto getObjectBounds() const noexcept -> const AxisAlignedBox& { return mObjectBounds; }
+
+        /** Gets the bounds the node is indexed by in the octree.
+        @remarks
+            Encloses the world bounding boxes and spheres of the attached objects,
+            including the objects attached to their bones, so every scene query can
+            reject whole octants based on them.
+        */
+        [[nodiscard]] auto getQueryBounds() const noexcept -> const AxisAlignedBox& { return mQueryBounds; }
+
+        /// Gets the octant the node is stored in, @c nullptr if it is not indexed
+        [[nodiscard]] auto getOctant() const noexcept -> LooseOctree::Octant* { return mOctant; }
+
+    protected:
+        /** See SceneNode, removes the subtree from the octree once it leaves the scene graph. */
+        void setParent(Node* parent) override;
+
+    private:
+        friend class LooseOctree;
+        friend class OctreeSceneManager;
+
+        /// World bounds of the attached objects
+        AxisAlignedBox mObjectBounds;
+        /// Bounds used for the octree, see getQueryBounds
+        AxisAlignedBox mQueryBounds;
+        /// Octant the node is stored in
+        LooseOctree::Octant* mOctant{nullptr};
+        /// Index within LooseOctree::Octant::nodes
+        size_t mOctantIndex{0};
+        /// Whether the node is waiting in the update queue of the creator
+        bool mOctreeUpdateQueued{false};
+    };
+
+    /** SceneManager which culls through a LooseOctree.
+    @remarks
+        The scene graph is updated exactly as by the default SceneManager. Afterwards,
+        every node whose attached objects moved is relocated in the octree, so static
+        parts of the scene cost nothing. Visibility is then determined by descending
+        only into octants intersecting the camera frustum, which makes culling scale
+        with the visible part of the scene instead of with the total number of nodes.
+    */
+    class OctreeSceneManager : public SceneManager
+    {
+    public:
+        OctreeSceneManager(std::string_view name);
+        ~OctreeSceneManager() override;
+
+        auto getTypeName() const noexcept -> std::string_view override;
+
+        auto createAABBQuery(const AxisAlignedBox& box, QueryTypeMask mask = QueryTypeMask{0xFFFFFFFF}) -> AxisAlignedBoxSceneQuery* override;
+        auto createSphereQuery(const Sphere& sphere, QueryTypeMask mask = QueryTypeMask{0xFFFFFFFF}) -> SphereSceneQuery* override;
+        auto createRayQuery(const Ray& ray, QueryTypeMask mask = QueryTypeMask{0xFFFFFFFF}) -> ::std::unique_ptr<RaySceneQuery> override;
+        auto createRayBatchQuery(const std::vector<Ray>& rays, QueryTypeMask mask = QueryTypeMask{0xFFFFFFFF}) -> ::std::unique_ptr<RayBatchSceneQuery> override;
+
+        void _updateSceneGraph(Camera* cam) override;
+        void _findVisibleObjects(Camera* cam, VisibleObjectsBoundsInfo* visibleBounds, bool onlyShadowCasters) override;
+
+        /** Resizes the octree, reindexing all nodes.
+        @param worldBounds The region to subdivide, nodes outside end up in the root octant.
+        @param maxDepth The maximum number of subdivisions.
+        */
+        void setOctreeBounds(const AxisAlignedBox& worldBounds, uint16 maxDepth);
+
+        /// Gets the octree holding the nodes of this scene
+        [[nodiscard]] auto getOctree() const noexcept -> const LooseOctree& { return *mOctree; }
+
+        /// Gets the number of octants visited by the last _findVisibleObjects call
+        [[nodiscard]] auto getNumVisitedOctants() const noexcept -> size_t { return mNumVisitedOctants; }
+
+        /** Queues the node for relocation in the octree.
+        @remarks
+            Called by OctreeSceneNode::_updateBounds, which may run on worker threads.
+        */
+        void _queueOctreeUpdate(OctreeSceneNode* node);
+        /** Removes the node from the octree and the update queue. */
+        void _removeOctreeNode(OctreeSceneNode* node);
+
+    protected:
+        auto createSceneNodeImpl() -> SceneNode* override;
+        auto createSceneNodeImpl(std::string_view name) -> SceneNode* override;
+
+    private:
+        std::unique_ptr<LooseOctree> mOctree;
+        /// Nodes whose object bounds changed during the scene graph update
+        std::vector<OctreeSceneNode*> mOctreeUpdateQueue;
+        std::mutex mOctreeUpdateMutex;
+        size_t mNumVisitedOctants{0};
+
+        void processOctreeUpdates();
+    };
+
+    /** AxisAlignedBoxSceneQuery which only visits the octants overlapping the box.
+    @remarks
+        Returns the same objects as DefaultAxisAlignedBoxSceneQuery, in a different order.
+    */
+    class OctreeAxisAlignedBoxSceneQuery : public AxisAlignedBoxSceneQuery
+    {
+    public:
+        OctreeAxisAlignedBoxSceneQuery(OctreeSceneManager* creator);
+        void execute(SceneQueryListener* listener) override;
+    };
+
+    /** SphereSceneQuery which only visits the octants overlapping the sphere.
+    @remarks
+        Returns the same objects as DefaultSphereSceneQuery, in a different order.
+    */
+    class OctreeSphereSceneQuery : public SphereSceneQuery
+    {
+    public:
+        OctreeSphereSceneQuery(OctreeSceneManager* creator);
+        void execute(SceneQueryListener* listener) override;
+    };
+
+    /** RaySceneQuery which only visits the octants along the ray.
+    @remarks
+        Returns the same objects as DefaultRaySceneQuery, in a different order
+        unless sorting by distance.
+    */
+    class OctreeRaySceneQuery : public RaySceneQuery
+    {
+    public:
+        OctreeRaySceneQuery(OctreeSceneManager* creator);
+        void execute(RaySceneQueryListener* listener) override;
+    };
+
+    /** RayBatchSceneQuery which traverses the octree once for all rays.
+    @remarks
+        Every octant is only tested against the rays which hit its parent, so
+        coherent rays share most of the traversal.
+    */
+    class OctreeRayBatchSceneQuery : public RayBatchSceneQuery
+    {
+    public:
+        OctreeRayBatchSceneQuery(OctreeSceneManager* creator);
+        void execute(RayBatchSceneQueryListener* listener) override;
+
+    private:
+        /// Rays still alive per depth of the traversal
+        std::vector<std::vector<uint32>> mActiveRays;
+
+        auto executeOctant(const LooseOctree::Octant& octant, size_t depth,
+                           RayBatchSceneQueryListener* listener) -> bool;
+    };
+
+    /// Factory for OctreeSceneManager
+    class OctreeSceneManagerFactory : public SceneManagerFactory
+    {
+    protected:
+        void initMetaData() const override;
+    public:
+        /// Factory type name
+        static std::string_view const FACTORY_TYPE_NAME;
+        auto createInstance(std::string_view instanceName) -> SceneManager* override;
+    };
+    /** @} */
+    /** @} */
+
+}
@@ -27,14 +27,19 @@ THE SOFTWARE.
 */
 module;
 
+#include <cmath>
 #include <cstddef>
 
 export module Ogre.Core:OptimisedUtil;
 
 export import :EdgeListBuilder;
+export import :Math;
 export import :Platform;
 export import :Prerequisites;
 
+export import <array>;
+export import <limits>;
+
 export
 namespace Ogre {
 struct Affine3;
@@ -70,6 +75,45 @@ struct Affine3;
         // Destructor
         virtual ~OptimisedUtil() = default;
 
+        /// Number of terms of the polynomial evaluated by the SIMD implementations of slerpQuaternions
+        static constexpr size_t SLERP_TERMS = 16;
+
+        /** Coefficients of the polynomial approximating sin(t * angle) / sin(angle) from cos(angle).
+        @remarks
+            See D. Eberly, "A Fast and Accurate Algorithm for Computing SLERP". With
+            c = cos(angle) in [0, 1], the value is t * (1 + b_1 * (1 + b_2 * (... (1 + b_n)))), where
+            b_i = (u_i * t^2 - v_i) * (c - 1), u_i = 1 / (i * (2i + 1)) and v_i = i / (2i + 1).
+            Scaling the last coefficients by 1.92 corrects for the truncation, keeping the error
+            below 1e-7 with SLERP_TERMS terms.
+        */
+        static constexpr std::array<float, SLERP_TERMS> SLERP_U = []
+        {
+            std::array<float, SLERP_TERMS> u{};
+            for (size_t i = 1; i <= SLERP_TERMS; ++i)
+                u[i - 1] = float(1.0 / (i * (2.0 * i + 1)));
+            u.back() *= 1.92f;
+            return u;
+        }();
+        /// @copydoc SLERP_U
+        static constexpr std::array<float, SLERP_TERMS> SLERP_V = []
+        {
+            std::array<float, SLERP_TERMS> v{};
+            for (size_t i = 1; i <= SLERP_TERMS; ++i)
+                v[i - 1] = float(i / (2.0 * i + 1));
+            v.back() *= 1.92f;
+            return v;
+        }();
+
+        /** 1 / d, or the largest finite value of the sign of d for 0.
+        @remarks
+            Slab tests of rays parallel to an axis get 0 rather than NaN from 0 * infinity that way,
+            for origins on a bound.
+        */
+        static auto _slabInverse(Real d) noexcept -> Real
+        {
+            return d != 0 ? 1 / d : std::copysign(std::numeric_limits<Real>::max(), d);
+        }
+
         /** Gets the implementation of this class.
         @note
             Don't cache the pointer returned by this function, it'll change due
@@ -77,6 +121,12 @@ struct Affine3;
         */
         static auto getImplementation() noexcept -> OptimisedUtil* { return msImplementation; }
 
+        /** Gets the portable implementation, which the SIMD ones must agree with.
+        @note
+            Meant for testing, use getImplementation otherwise.
+        */
+        static auto _getGeneralImplementation() -> OptimisedUtil*;
+
         /** Performs software vertex skinning.
         @param srcPosPtr Pointer to source position buffer.
         @param destPosPtr Pointer to destination position buffer.
@@ -150,6 +200,123 @@ struct Affine3;
             Affine3* dstMatrices,
             size_t numMatrices) = 0;
 
+        /** Multiplies matrices pairwise, dstMatrices[i] = lhsMatrices[i] * rhsMatrices[i].
+        @param lhsMatrices, rhsMatrices The operands.
+        @param dstMatrices The results, may be either of the operand arrays.
+        @param numMatrices Number of matrices in each array. No alignment requirement.
+        */
+        virtual void multiplyMatrices(
+            const Matrix4* lhsMatrices,
+            const Matrix4* rhsMatrices,
+            Matrix4* dstMatrices,
+            size_t numMatrices) = 0;
+
+        /** Multiplies affine matrices pairwise, dstMatrices[i] = lhsMatrices[i] * rhsMatrices[i].
+        @param lhsMatrices, rhsMatrices The operands.
+        @param dstMatrices The results, may be either of the operand arrays.
+        @param numMatrices Number of matrices in each array. No alignment requirement.
+        */
+        virtual void multiplyAffineMatrices(
+            const Affine3* lhsMatrices,
+            const Affine3* rhsMatrices,
+            Affine3* dstMatrices,
+            size_t numMatrices) = 0;
+
+        /** Inverts affine matrices, matching Affine3::inverse.
+        @param srcMatrices The matrices to invert.
+        @param dstMatrices The inverses, may be srcMatrices.
+        @param numMatrices Number of matrices. No alignment requirement.
+        */
+        virtual void inverseAffineMatrices(
+            const Affine3* srcMatrices,
+            Affine3* dstMatrices,
+            size_t numMatrices) = 0;
+
+        /** Transforms points by an affine matrix, matching Affine3 * Vector3.
+        @param matrix The transform.
+        @param srcPoints The points to transform.
+        @param dstPoints The transformed points, may be srcPoints.
+        @param numPoints Number of points. No alignment requirement.
+        */
+        virtual void transformPoints(
+            const Affine3& matrix,
+            const Vector3* srcPoints,
+            Vector3* dstPoints,
+            size_t numPoints) = 0;
+
+        /** Transforms directions by the linear part of an affine matrix, matching
+            Affine3::linear() * Vector3, e.g. no translation and no normalisation.
+        @param matrix The transform.
+        @param srcDirections The directions to transform.
+        @param dstDirections The transformed directions, may be srcDirections.
+        @param numDirections Number of directions. No alignment requirement.
+        */
+        virtual void transformDirections(
+            const Affine3& matrix,
+            const Vector3* srcDirections,
+            Vector3* dstDirections,
+            size_t numDirections) = 0;
+
+        /** Interpolates quaternions pairwise, like Quaternion::Slerp.
+        @remarks
+            The SIMD implementations evaluate the interpolation with a polynomial instead
+            of trigonometric functions, which stays within a few units in the last place
+            of Quaternion::Slerp for unit quaternions.
+        @param from, to The quaternions to interpolate between, of unit length.
+        @param t The interpolation parameter of every pair.
+        @param dst The results, may be either of the source arrays.
+        @param numQuaternions Number of quaternions in each array. No alignment requirement.
+        @param shortestPath Whether to interpolate along the shortest path, see Quaternion::Slerp.
+        */
+        virtual void slerpQuaternions(
+            const Quaternion* from, const Quaternion* to,
+            const float* t,
+            Quaternion* dst,
+            size_t numQuaternions,
+            bool shortestPath) = 0;
+
+        /** Interpolates quaternions pairwise linearly and normalises the results, like Quaternion::nlerp.
+        @param from, to The quaternions to interpolate between.
+        @param t The interpolation parameter of every pair.
+        @param dst The results, may be either of the source arrays.
+        @param numQuaternions Number of quaternions in each array. No alignment requirement.
+        @param shortestPath Whether to interpolate along the shortest path, see Quaternion::nlerp.
+        */
+        virtual void nlerpQuaternions(
+            const Quaternion* from, const Quaternion* to,
+            const float* t,
+            Quaternion* dst,
+            size_t numQuaternions,
+            bool shortestPath) = 0;
+
+        /** Intersects a ray with many axis aligned boxes, see Math::intersects(const Ray&, const Math::BoxArrays&, size_t, Real*).
+        @param ray The ray.
+        @param boxes The bounds of the boxes, in separate arrays. No alignment requirement.
+        @param distances Receives the distance to each box, or Math::POS_INFINITY if missed.
+        @param numBoxes Number of boxes.
+        */
+        virtual void intersectRayBoxes(
+            const Ray& ray,
+            const Math::BoxArrays& boxes,
+            Real* distances,
+            size_t numBoxes) = 0;
+
+        /** Intersects a ray with many triangles, see Math::intersects(const Ray&, const Math::TriangleArrays&, size_t, Real*, bool, bool).
+        @param ray The ray.
+        @param triangles The first vertices and edges of the triangles, in separate arrays. No alignment requirement.
+        @param distances Receives the distance to each triangle, or Math::POS_INFINITY if missed.
+        @param numTriangles Number of triangles.
+        @param positiveSide, negativeSide Which sides of the triangles to intersect, as determined by
+            vertex winding.
+        */
+        virtual void intersectRayTriangles(
+            const Ray& ray,
+            const Math::TriangleArrays& triangles,
+            Real* distances,
+            size_t numTriangles,
+            bool positiveSide,
+            bool negativeSide) = 0;
+
         /** Calculate the face normals for the triangles based on position
             information.
         @param positions Pointer to position information, which packed in
@@ -209,6 +376,98 @@ struct Affine3;
             const float* srcPositions,
             float* destPositions,
             size_t numVertices) = 0;
+
+        /** Tests boxes against a set of planes, as used by frustum culling.
+        @remarks
+            A box is visible unless it lies entirely on the negative side of one of
+            the planes, matching Plane::getSide(const Vector3&, const Vector3&).
+        @param planes The planes, packed as (normal.x, normal.y, normal.z, d).
+        @param numPlanes Number of planes.
+        @param centreX, centreY, centreZ Arrays of box centres.
+        @param halfSizeX, halfSizeY, halfSizeZ Arrays of box half sizes.
+        @param visible Array to store the results, 1 if the box is visible, 0 otherwise.
+        @param numBoxes Number of boxes to test. No alignment requirement for any
+            of the arrays, but loss performance for unaligned data.
+        */
+        virtual void cullBoxes(
+            const float* planes, size_t numPlanes,
+            const float* centreX, const float* centreY, const float* centreZ,
+            const float* halfSizeX, const float* halfSizeY, const float* halfSizeZ,
+            uint8* visible,
+            size_t numBoxes) = 0;
+
+        /** Advances positions by their velocities, as used by particle motion.
+        @remarks
+            Computes pos += vel * timeElapsed for each element, where positions and
+            velocities are held in structure-of-arrays form.
+        @param posX, posY, posZ Arrays of positions to update.
+        @param velX, velY, velZ Arrays of velocities.
+        @param timeElapsed Time step to scale the velocities with.
+        @param count Number of elements in each array. No alignment requirement for
+            any of the arrays, but loss performance for unaligned data.
+        */
+        virtual
+        void integrateArrays(
+            float* posX, float* posY, float* posZ,
+            const float* velX, const float* velY, const float* velZ,
+            float timeElapsed,
+            size_t count) = 0;
+
+        /** Calculates the signed distances of points to a plane, as used by convex clipping.
+        @param plane The plane, packed as (normal.x, normal.y, normal.z, d).
+        @param posX, posY, posZ Arrays of the points.
+        @param distances Array to store the distances, normal . point + d.
+        @param count Number of points. No alignment requirement for any of the
+            arrays, but loss performance for unaligned data.
+        */
+        virtual void calculatePlaneDistances(
+            const float* plane,
+            const float* posX, const float* posY, const float* posZ,
+            float* distances,
+            size_t count) = 0;
+
+        /// Value of a shuffleChannels entry clearing the destination channel
+        static constexpr uint8 SHUFFLE_ZERO = 0x80;
+        /// Value of a shuffleChannels entry setting the destination channel to 255
+        static constexpr uint8 SHUFFLE_ONE = 0xFF;
+
+        /** Rearranges the 8 bit channels of pixels, as used by pixel format conversions.
+        @remarks
+            Byte c of each destination pixel is byte shuffle[c] of the source pixel, or
+            0 for #SHUFFLE_ZERO and 255 for #SHUFFLE_ONE. This covers swizzles like RGB to
+            BGRA as well as expanding luminance.
+        @param src Source pixels, srcBytes each.
+        @param srcBytes, dstBytes Size of the pixels, 1 to 4 bytes.
+        @param dst Destination pixels, dstBytes each, not overlapping the source.
+        @param shuffle dstBytes entries.
+        @param numPixels Number of pixels to convert. No alignment requirement.
+        */
+        virtual void shuffleChannels(
+            const uint8* src, size_t srcBytes,
+            uint8* dst, size_t dstBytes,
+            const uint8* shuffle,
+            size_t numPixels) = 0;
+
+        /** Converts 8 bit unsigned normalised values to floats, matching Bitwise::fixedToFloat.
+        @param count Number of values. No alignment requirement.
+        */
+        virtual void convertUnormToFloat(const uint8* src, float* dst, size_t count) = 0;
+
+        /** Converts floats to 8 bit unsigned normalised values, matching Bitwise::floatToFixed.
+        @param count Number of values. No alignment requirement.
+        */
+        virtual void convertFloatToUnorm(const float* src, uint8* dst, size_t count) = 0;
+
+        /** Converts half floats to floats, matching Bitwise::halfToFloat.
+        @param count Number of values. No alignment requirement.
+        */
+        virtual void convertHalfToFloat(const uint16* src, float* dst, size_t count) = 0;
+
+        /** Converts floats to half floats, matching Bitwise::floatToHalf, i.e. rounding
+            towards zero.
+        @param count Number of values. No alignment requirement.
+        */
+        virtual void convertFloatToHalf(const float* src, uint16* dst, size_t count) = 0;
     };
 
     /** Returns raw offseted of the given pointer.
@@ -31,6 +31,8 @@ export import :ColourValue;
 export import :Prerequisites;
 export import :Vector;
 
+export import <vector>;
+
 export
 namespace Ogre {
 
@@ -104,6 +106,32 @@ namespace Ogre {
 
         [[nodiscard]] auto getRotation() const noexcept -> const Radian& { return mRotation; }
     };
+
+    /** Structure-of-arrays copy of the active particles of a ParticleSystem.
+    @remarks
+        Element i of every array corresponds to the i-th entry of
+        ParticleSystem::_getActiveParticles(). Batched affectors work on these arrays
+        instead of the individual Particle objects, so their loops can run several
+        particles per SIMD instruction.
+    @par
+        Colours are held as floats in the range [0, 1], rotations in radians.
+    */
+    struct ParticleArrays
+    {
+        /// Number of particles held in each array
+        size_t count{0};
+        std::vector<float> positionX, positionY, positionZ;
+        std::vector<float> directionX, directionY, directionZ;
+        std::vector<float> colourR, colourG, colourB, colourA;
+        std::vector<float> width, height;
+        std::vector<float> timeToLive, totalTimeToLive;
+        std::vector<float> rotation, rotationSpeed;
+
+        /// Copies the state of the given particles into the arrays
+        void gather(const std::vector<Particle*>& particles);
+        /// Writes the arrays back to the given particles, which must be the ones gathered
+        void scatter(const std::vector<Particle*>& particles) const;
+    };
     /** @} */
     /** @} */
 }
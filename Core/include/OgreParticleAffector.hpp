@@ -27,6 +27,7 @@ THE SOFTWARE.
 */
 export module Ogre.Core:ParticleAffector;
 
+export import :Particle;
 export import :Prerequisites;
 export import :String;
 export import :StringInterface;
@@ -108,6 +109,42 @@ namespace Ogre {
         */
         virtual void _affectParticles(ParticleSystem* pSystem, Real timeElapsed) = 0;
 
+        /** Whether this affector implements _affectParticleArrays.
+        @remarks
+            The ParticleSystem runs batched affectors on a ParticleArrays copy of its active
+            particles and only writes the arrays back to the Particle objects before a
+            non-batched affector, or once motion has been applied. Consecutive batched
+            affectors therefore never touch the Particle objects.
+        */
+        [[nodiscard]] virtual auto isBatched() const noexcept -> bool { return false; }
+
+        /** Batched version of _affectParticles, called instead of it if isBatched() is true.
+        @remarks
+            Large systems split their particles into chunks (see
+            ParticleSystem::setParallelChunkSize) and call this for several chunks at once
+            from different threads. It must therefore only touch the elements in
+            [begin, end) and must not modify the affector itself.
+        @param
+            pSystem Pointer to the ParticleSystem to affect.
+        @param
+            particles The active particles of pSystem in structure-of-arrays form. Only the
+            values may be changed, particles cannot be added or removed here.
+        @param
+            begin, end The range of particles to affect.
+        @param
+            timeElapsed The number of seconds which have elapsed since the last call.
+        */
+        virtual void _affectParticleArrays(ParticleSystem* pSystem, ParticleArrays& particles,
+                                           size_t begin, size_t end, Real timeElapsed)
+                {
+                    /* by default do nothing */
+                    (void)pSystem;
+                    (void)particles;
+                    (void)begin;
+                    (void)end;
+                    (void)timeElapsed;
+                }
+
         /** Returns the name of the type of affector. 
         @remarks
             This property is useful for determining the type of affector procedurally so another
@@ -25,6 +25,10 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 THE SOFTWARE.
 -----------------------------------------------------------------------------
 */
+module;
+
+#include <cstddef>
+
 export module Ogre.Core:ParticleEmitter;
 
 export import :ColourValue;
@@ -137,6 +141,11 @@ namespace Ogre {
         // NB. That doesn't imply that the emitter itself emits other emitters (that could or could not be the case)
         bool mEmitted;
 
+        /// Indexes resolved by the ParticleSystem, see _setEmittedEmitterPools
+        size_t mEmittedEmitterPool{NO_POOL};
+        size_t mPool{NO_POOL};
+        size_t mActiveIndex{0};
+
         // NB Method below here are to help out people implementing emitters by providing the
         // most commonly used approaches as piecemeal methods
 
@@ -518,6 +527,28 @@ namespace Ogre {
         /** Set the indication (true/false) to indicate that the emitter is emitted by another emitter */
         virtual void setEmitted(bool emitted);
 
+        /// Value of the pool indexes of an emitter not taking part in emitted emitters
+        static constexpr size_t NO_POOL = ~size_t{0};
+
+        /** Sets the emitted emitter pools of the ParticleSystem of this emitter (internal use).
+        @param emittedEmitterPool The pool of the emitters this one emits, resolved from
+            getEmittedEmitter, NO_POOL if it emits visual particles or the name is unknown.
+        @param pool The pool this emitter is part of if it is an emitted emitter, NO_POOL otherwise.
+        */
+        void _setEmittedEmitterPools(size_t emittedEmitterPool, size_t pool)
+        {
+            mEmittedEmitterPool = emittedEmitterPool;
+            mPool = pool;
+        }
+        /** Gets the pool of the emitters this one emits (internal use). */
+        [[nodiscard]] auto _getEmittedEmitterPool() const noexcept -> size_t { return mEmittedEmitterPool; }
+        /** Gets the pool this emitter is part of (internal use). */
+        [[nodiscard]] auto _getPool() const noexcept -> size_t { return mPool; }
+        /** Sets the position of this emitter among the active emitted emitters of the system (internal use). */
+        void _setActiveIndex(size_t index) { mActiveIndex = index; }
+        /** Gets the position of this emitter among the active emitted emitters of the system (internal use). */
+        [[nodiscard]] auto _getActiveIndex() const noexcept -> size_t { return mActiveIndex; }
+
 
     };
     /** @} */
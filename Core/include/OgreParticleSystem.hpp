@@ -35,6 +35,7 @@ export import :AxisAlignedBox;
 export import :MovableObject;
 export import :Platform;
 export import :Prerequisites;
+export import :RadixSort;
 export import :Renderable;
 export import :ResourceGroupManager;
 export import :SharedPtr;
@@ -42,6 +43,7 @@ export import :StringInterface;
 export import :Vector;
 
 export import <algorithm>;
+export import <limits>;
 export import <list>;
 export import <map>;
 export import <memory>;
@@ -51,6 +53,7 @@ export import <vector>;
 export
 namespace Ogre {
     class Camera;
+    class LodStrategy;
     class Node;
     class Particle;
     class ParticleAffector;
@@ -83,6 +86,20 @@ namespace Ogre {
     class ParticleSystem : public StringInterface, public MovableObject
     {
     public:
+        /// A reduced level of detail of the particle system, see setLodLevels
+        struct LodLevel
+        {
+            /// The LOD value from which on the level is used, in the user units of the LodStrategy
+            Real userValue{0};
+            /// Factor applied to the emission rate of all emitters
+            Real emissionRateScale{1};
+            /// Iteration interval used instead of getIterationInterval, 0 to keep it
+            Real iterationInterval{0};
+            /// Number of active particles above which no more are emitted, 0 for the particle quota
+            size_t quota{0};
+        };
+        using LodLevelList = std::vector<LodLevel>;
+
         /// Default constructor required for STL creation in manager
         ParticleSystem();
         /** Creates a particle system with no emitters or affectors.
@@ -286,6 +303,19 @@ namespace Ogre {
         */
         void _update(Real timeElapsed);
 
+        /** Prepares updating this system on another thread, concurrently with other systems.
+        @remarks
+            Does the parts of _update which touch state shared with other objects up front,
+            i.e. creating the renderer and emitted emitters and updating the transform of
+            the parent node, and defers notifying the parent node of the new bounds to
+            _endConcurrentUpdate. Both are called on the main thread by
+            ParticleSystemManager::_updateQueuedSystems.
+        */
+        void _beginConcurrentUpdate();
+
+        /** Completes an update started with _beginConcurrentUpdate. */
+        void _endConcurrentUpdate();
+
         /** Returns all active particles in this system.
         @remarks
             This method is designed to be used by people providing new ParticleAffector subclasses,
@@ -399,6 +429,72 @@ namespace Ogre {
         */
         static auto getDefaultNonVisibleUpdateTimeout() noexcept -> Real { return msDefaultNonvisibleTimeout; }
 
+        /** Sets the LodStrategy choosing the level of detail, see setLodLevels.
+        @remarks
+            The levels are transformed anew. The default is the default strategy of the
+            LodStrategyManager at the time the system is created.
+        */
+        void setLodStrategy(LodStrategy* strategy);
+        /** Gets the LodStrategy choosing the level of detail. */
+        [[nodiscard]] auto getLodStrategy() const noexcept -> LodStrategy* { return mLodStrategy; }
+
+        /** Sets the levels of detail of this particle system.
+        @remarks
+            The level is chosen by the LodStrategy whenever a camera sees the system, and
+            applied from the next update on. Below the first level the system runs at full
+            detail. A level reduces the emission rate, updates the system at a coarser
+            iteration interval and stops emission above a lower number of active particles,
+            so that distant or small effects cost less. The emission is scaled with the
+            fractions carried over, so that low rates do not drop to zero.
+        @par
+            If the system is seen by several cameras in a frame, the most detailed level is
+            used. Systems not seen keep their last level.
+        @param levels The levels, sorted by their userValue the same way as mesh LOD values.
+            Empty to always run at full detail.
+        */
+        void setLodLevels(const LodLevelList& levels);
+        /** Gets the levels of detail, see setLodLevels. */
+        [[nodiscard]] auto getLodLevels() const noexcept -> const LodLevelList& { return mLodLevels; }
+        /** Gets the level of detail calculated for the current frame.
+        @return 0 for full detail, otherwise 1 + the index into getLodLevels
+        */
+        [[nodiscard]] auto getCurrentLodIndex() const noexcept -> ushort { return mLodIndex; }
+
+        /** Sets how important this system is, for the particle budget of the ParticleSystemManager.
+        @remarks
+            See ParticleSystemManager::setParticleBudget. Systems with a higher priority are
+            served first, at equal priority the ones closer to the camera. The default is 0.
+        */
+        void setBudgetPriority(Real priority) { mBudgetPriority = priority; }
+        /** Gets how important this system is for the particle budget. */
+        [[nodiscard]] auto getBudgetPriority() const noexcept -> Real { return mBudgetPriority; }
+
+        /** Gets the number of active particles above which no more are emitted.
+        @remarks
+            This is the particle quota, lowered by the current level of detail and the
+            share of the particle budget.
+        */
+        [[nodiscard]] auto getEffectiveParticleQuota() const -> size_t;
+
+        /** Sets the share of the particle budget of this system (internal use). */
+        void _setBudgetQuota(size_t quota) { mBudgetQuota = quota; }
+        /** Gets the share of the particle budget of this system (internal use). */
+        [[nodiscard]] auto _getBudgetQuota() const noexcept -> size_t { return mBudgetQuota; }
+        /** Gets the squared distance to the closest camera which saw the system in the
+            last frame, or the maximum of Real if none did (internal use). */
+        [[nodiscard]] auto _getSquaredCameraDistance() const -> Real;
+
+        /** Sets the number of particles above which the work of a single system is split.
+        @remarks
+            Batched affectors (see ParticleAffector::isBatched), motion and the bounds of
+            systems with more active particles than this run in chunks of this size on the
+            WorkQueue of Root. 0 disables splitting. The default is 4096.
+        */
+        static void setParallelChunkSize(size_t size) { msParallelChunkSize = size; }
+
+        /** Gets the number of particles above which the work of a single system is split. */
+        static auto getParallelChunkSize() noexcept -> size_t { return msParallelChunkSize; }
+
         auto getMovableType() const noexcept -> std::string_view override;
 
         /** Sets the default dimensions of the particles in this set.
@@ -471,6 +567,21 @@ namespace Ogre {
         /// Gets whether particles are sorted relative to the camera.
         auto getSortingEnabled() const noexcept -> bool { return mSorted; }
 
+        /** Sets how often the particles are sorted, if sorting is enabled.
+        @remarks
+            See BillboardSet::setSortInterval. Particles emitted in between are drawn on
+            top until the next sort.
+        */
+        void setSortInterval(unsigned int interval, Real distanceThreshold = 0,
+                             const Radian& angleThreshold = Radian{0});
+        [[nodiscard]] auto getSortInterval() const noexcept -> unsigned int { return mSortInterval; }
+        [[nodiscard]] auto getSortDistanceThreshold() const noexcept -> Real { return mSortDistanceThreshold; }
+        [[nodiscard]] auto getSortAngleThreshold() const noexcept -> const Radian& { return mSortAngleThreshold; }
+
+        /// Sets whether the sort keys are quantized to 16 bits, see BillboardSet::setSortKeysQuantized
+        void setSortKeysQuantized(bool quantized) { mSorter.setQuantized(quantized); }
+        [[nodiscard]] auto getSortKeysQuantized() const noexcept -> bool { return mSorter.getQuantized(); }
+
         /** Set the (initial) bounds of the particle system manually. 
         @remarks
             If you can, set the bounds of a particle system up-front and 
@@ -586,6 +697,22 @@ namespace Ogre {
         Real mTimeSinceLastVisible;
         /// Last frame in which known to be visible
         unsigned long mLastVisibleFrame;
+        /// See setLodStrategy and setLodLevels
+        LodStrategy* mLodStrategy{nullptr};
+        LodLevelList mLodLevels;
+        /// Base value of mLodStrategy followed by the transformed user values of mLodLevels
+        std::vector<Real> mLodValues;
+        ushort mLodIndex{0};
+        /// Frame of mLodIndex, the most detailed level wins among the cameras of a frame
+        unsigned long mLodFrame{0};
+        /// Squared distance to the closest camera of mLodFrame
+        Real mLodCameraDistance{std::numeric_limits<Real>::max()};
+        /// Fractions of emissions left over by LodLevel::emissionRateScale, per emission request
+        std::vector<Real> mLodEmissionRemainders;
+        std::vector<Real> mLodEmittedEmissionRemainders;
+        /// See setBudgetPriority and _setBudgetQuota
+        Real mBudgetPriority{0};
+        size_t mBudgetQuota{std::numeric_limits<size_t>::max()};
         /// Controller for time update
         Controller<Real>* mTimeController;
         /// Indication whether the emitted emitter pool (= pool with particle emitters that are emitted) is initialised
@@ -624,6 +751,17 @@ namespace Ogre {
         */
         ParticlePool mActiveParticles;
 
+        /// Sorts mActiveParticles, kept to benefit from the order of the last sort
+        CoherentSort<ParticlePool, Particle*> mSorter;
+        unsigned int mSortInterval{1};
+        Real mSortDistanceThreshold{0};
+        Radian mSortAngleThreshold{0};
+        /// State of the last sort, to tell whether the next one is due
+        bool mSortDone{false};
+        unsigned long mLastSortFrame{0};
+        Vector3 mLastSortCamPos;
+        Vector3 mLastSortCamDir;
+
         /** Free particle queue.
             @remarks
                 This contains a list of the particles free for use as new instances
@@ -641,33 +779,52 @@ namespace Ogre {
         */
         std::vector<::std::unique_ptr<Particle>> mParticlePool;
 
-        using FreeEmittedEmitterList = std::list<ParticleEmitter *>;
-        using ActiveEmittedEmitterList = std::list<ParticleEmitter *>;
-        using EmittedEmitterList = std::vector<ParticleEmitter *>;
-        using FreeEmittedEmitterMap = std::map<std::string_view, FreeEmittedEmitterList>;
-        using EmittedEmitterPool = std::map<std::string_view, EmittedEmitterList>;
+        /** Structure-of-arrays copy of mActiveParticles used by batched affectors.
+            @remarks
+                Only valid while mParticleArraysCurrent is set, which is between the first
+                batched affector of an update and the next non-batched affector or the
+                end of _applyMotion.
+        */
+        ParticleArrays mParticleArrays;
+        bool mParticleArraysCurrent{false};
+
+        /// Emission requests of mEmitters and mActiveEmittedEmitters, kept to avoid reallocation
+        std::vector<unsigned> mRequestedEmissions;
+        std::vector<unsigned> mRequestedEmittedEmissions;
+
+        /// Between _beginConcurrentUpdate and _endConcurrentUpdate
+        bool mConcurrentUpdate{false};
+        /// The parent node needs to be told about changed bounds in _endConcurrentUpdate
+        bool mNodeUpdatePending{false};
 
         /** Pool of emitted emitters for use and reuse in the active emitted emitter list.
         @remarks
-            The emitters in this pool act as particles and as emitters. The pool is a map containing lists 
-            of emitters, identified by their name.
-        @par
-            The emitters in this pool are cloned using emitters that are kept in the main emitter list
-            of the ParticleSystem.
+            The emitters in a pool act as particles and as emitters. They are cloned from one
+            emitter of the main emitter list of the ParticleSystem, whose name other emitters
+            give as their emitted emitter. The names are resolved to pool indexes once, when
+            the pools are set up, see ParticleEmitter::_setEmittedEmitterPools.
         */
-        EmittedEmitterPool mEmittedEmitterPool;
+        struct EmittedEmitterPool
+        {
+            /// The emitter of the main list the pool is cloned from
+            ParticleEmitter* source;
+            /// All emitters of the pool
+            std::vector<ParticleEmitter*> emitters;
+            /// The emitters free for use, with room for all of them
+            std::vector<ParticleEmitter*> free;
+        };
+        using EmittedEmitterPoolList = std::vector<EmittedEmitterPool>;
+        using ActiveEmittedEmitterList = std::vector<ParticleEmitter *>;
 
-        /** Free emitted emitter list.
-            @remarks
-                This contains a list of the emitters free for use as new instances as required by the set.
-        */
-        FreeEmittedEmitterMap mFreeEmittedEmitters;
+        /// The pools of emitted emitters, one per emitter of the main list which is emitted
+        EmittedEmitterPoolList mEmittedEmitterPools;
 
         /** Active emitted emitter list.
             @remarks
-                This is a linked list of pointers to emitters in the emitted emitter pool.
                 Emitters that are used are stored (their pointers) in both the list with active particles and in 
-                the list with active emitted emitters.        */
+                the list with active emitted emitters. Their position in here is kept by the emitter, see
+                ParticleEmitter::_getActiveIndex, so that they are removed by swapping with the last one.
+        */
         ActiveEmittedEmitterList mActiveEmittedEmitters;
 
         using ParticleEmitterList = std::vector<ParticleEmitter *>;
@@ -700,6 +857,8 @@ namespace Ogre {
         static Real msDefaultIterationInterval;
         /// Default nonvisible update timeout
         static Real msDefaultNonvisibleTimeout;
+        /// Particles per chunk of work split over the WorkQueue
+        static size_t msParallelChunkSize;
 
         /** Internal method used to expire dead particles. */
         void _expire(Real timeElapsed);
@@ -707,6 +866,9 @@ namespace Ogre {
         /** Spawn new particles based on free quota and emitter requirements. */
         void _triggerEmitters(Real timeElapsed);
 
+        /** Gets the level of detail currently applied, nullptr for full detail. */
+        [[nodiscard]] auto getCurrentLodLevel() const -> const LodLevel*;
+
         /** Helper function that actually performs the emission of particles
         */
         void _executeTriggerEmitters(ParticleEmitter* emitter, unsigned requested, Real timeElapsed);
@@ -717,6 +879,9 @@ namespace Ogre {
         /** Applies the effects of affectors. */
         void _triggerAffectors(Real timeElapsed);
 
+        /** Tells the parent node and the renderer that mAABB changed. */
+        void notifyBoundsChanged();
+
         /** Sort the particles in the system **/
         void _sortParticles(Camera* cam);
 
@@ -750,25 +915,26 @@ namespace Ogre {
         */
         void initialiseEmittedEmitterPool();
 
-        /** Add  emitters from the pool to the free emitted emitter queue. */
-        void addFreeEmittedEmitters();
-
         /** Removes all emitted emitters from this system.  */
         void removeAllEmittedEmitters();
 
-        /** Find the list with free emitted emitters.
-            @param name The name that identifies the list with free emitted emitters.
+        /** Find the pool of the emitted emitters cloned from an emitter.
+            @param name The name of the emitter of the main list the pool is cloned from.
+            @return The index into mEmittedEmitterPools, ParticleEmitter::NO_POOL if there is none.
         */
-        auto findFreeEmittedEmitter (std::string_view name) -> FreeEmittedEmitterList*;
+        [[nodiscard]] auto findEmittedEmitterPool(std::string_view name) const -> size_t;
+
+        /** Takes a free emitter of a pool and adds it to the active particles, nullptr if there is none. */
+        auto activateEmittedEmitter(size_t pool) -> Particle*;
 
-        /** Removes an emitter from the active emitted emitter list.
+        /** Removes an emitter from the active emitted emitter list and returns it to its pool.
             @remarks
                 The emitter will not be destroyed!
             @param emitter Pointer to a particle emitter.
         */
-        void removeFromActiveEmittedEmitters (ParticleEmitter* emitter);
+        void releaseEmittedEmitter(ParticleEmitter* emitter);
 
-        /** Moves all emitted emitters from the active list to the free list
+        /** Moves all emitted emitters from the active list to the free lists of their pools
             @remarks
                 The active emitted emitter list will not be cleared and still keeps references to the emitters!
         */
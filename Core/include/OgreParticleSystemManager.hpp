@@ -43,6 +43,8 @@ export import :StringVector;
 export import <map>;
 export import <memory>;
 export import <string>;
+export import <utility>;
+export import <vector>;
 
 export
 namespace Ogre {
@@ -92,8 +94,8 @@ class ParticleSystemRenderer;
         friend class ParticleSystemFactory;
     public:
         using ParticleTemplateMap = std::map<std::string_view, ParticleSystem *>;
-        using ParticleAffectorFactoryMap = std::map<std::string_view, ParticleAffectorFactory *>;
-        using ParticleEmitterFactoryMap = std::map<std::string_view, ParticleEmitterFactory *>;
+        using ParticleAffectorFactoryMap = std::map<String, ParticleAffectorFactory *, std::less<>>;
+        using ParticleEmitterFactoryMap = std::map<String, ParticleEmitterFactory *, std::less<>>;
         using ParticleSystemRendererFactoryMap = std::map<std::string_view, ParticleSystemRendererFactory *>;
     private:
         /// Templates based on scripts
@@ -113,6 +115,19 @@ class ParticleSystemRenderer;
         // Factory instance
         ::std::unique_ptr<ParticleSystemFactory> mFactory;
 
+        /// Whether _update calls are collected and run at once by _updateQueuedSystems
+        bool mParallelUpdates{false};
+        /// Systems and elapsed times collected while mParallelUpdates is set
+        std::vector<std::pair<ParticleSystem*, Real>> mQueuedUpdates;
+
+        /// See setParticleBudget
+        size_t mParticleBudget{0};
+        /// Systems updated in the current frame while mParticleBudget is set
+        std::vector<ParticleSystem*> mBudgetedSystems;
+
+        /// Shares mParticleBudget out among mBudgetedSystems and clears them
+        void applyParticleBudget();
+
         /// Internal implementation of createSystem
         auto createSystemImpl(std::string_view name, size_t quota, 
             std::string_view resourceGroup) -> ParticleSystem*;
@@ -337,6 +352,56 @@ class ParticleSystemRenderer;
                 mSystemTemplates.begin(), mSystemTemplates.end()};
         } 
 
+        /** Sets whether independent particle systems are updated concurrently.
+        @remarks
+            If enabled, the frame time controllers of the systems no longer update them one
+            after the other but queue them, and SceneManager runs all queued updates at once
+            on the WorkQueue of Root right after updating the controllers. Independently of
+            this, large systems split their own work, see ParticleSystem::setParallelChunkSize.
+        @note
+            Emitters, affectors and renderers of different systems then run at the same time,
+            so they must not share state that is modified during the update. The ones coming
+            with OGRE do not. Disabled by default.
+        */
+        void setParallelUpdatesEnabled(bool enabled) { mParallelUpdates = enabled; }
+
+        /** Gets whether independent particle systems are updated concurrently. */
+        [[nodiscard]] auto getParallelUpdatesEnabled() const noexcept -> bool { return mParallelUpdates; }
+
+        /** Sets the maximum number of particles of all systems together.
+        @remarks
+            Once per frame, after the updates, the budget is shared out among the systems
+            updated in the frame: by descending ParticleSystem::setBudgetPriority, then by
+            ascending distance to the cameras which saw them in the last frame, the ones not
+            seen coming last. Each system may hold as many particles as the budget left by the
+            active particles of the ones before it, up to its own quota, and stops emitting
+            above that in the next frame. The least important systems are thus degraded first,
+            and the number of particles updated stays bounded however many effects are
+            triggered at once.
+        @par
+            Particles already alive are not removed, so the budget may be exceeded until they
+            expire, and by the emissions of one frame.
+        @param budget The number of particles, 0 for no budget, which is the default.
+        */
+        void setParticleBudget(size_t budget) { mParticleBudget = budget; }
+        /** Gets the maximum number of particles of all systems together. */
+        [[nodiscard]] auto getParticleBudget() const noexcept -> size_t { return mParticleBudget; }
+
+        /** Lets a system updated in this frame take part in the particle budget (internal use). */
+        void _addToBudget(ParticleSystem* system);
+
+        /** Queues an update of a system for _updateQueuedSystems (internal use). */
+        void _queueUpdate(ParticleSystem* system, Real timeElapsed);
+
+        /** Removes all queued updates of a system, e.g. because it is being destroyed (internal use). */
+        void _removeQueuedUpdates(ParticleSystem* system);
+
+        /** Runs all queued updates, concurrently if possible, and clears the queue (internal use).
+        @remarks
+            Also shares out the particle budget, see setParticleBudget.
+        */
+        void _updateQueuedSystems();
+
         /** Get an instance of ParticleSystemFactory (internal use). */
         auto _getFactory() noexcept -> ParticleSystemFactory* { return mFactory.get(); }
         
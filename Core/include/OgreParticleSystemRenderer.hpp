@@ -69,6 +69,21 @@ namespace Ogre {
         virtual void _updateRenderQueue(RenderQueue* queue, 
             std::vector<Particle*>& currentParticles, bool cullIndividually) = 0;
 
+        /** Lets the renderer simulate the particles of a system itself.
+        @remarks
+            Called by ParticleSystem::_update instead of updating its own particles. Renderers
+            keeping and advancing the particle state on their own, like GpuParticleRenderer,
+            return true, in which case the system neither emits, affects nor moves any
+            particles. Like _update, this may run concurrently for different systems.
+        @param system The system being updated.
+        @param timeElapsed The time since the last update, scaled by the speed factor.
+        @param bounds To be set to the bounds of the simulated particles, in local space.
+        */
+        virtual auto _simulateParticles(ParticleSystem* system, Real timeElapsed, AxisAlignedBox& bounds) -> bool
+        {
+            return false;
+        }
+
         /** Sets the material this renderer must use; called by ParticleSystem. */
         virtual void _setMaterial(MaterialPtr& mat) = 0;
         /** Delegated to by ParticleSystem::_notifyCurrentCamera */
@@ -45,7 +45,9 @@ export import :UserObjectBindings;
 export import :Vector;
 
 export import <algorithm>;
+export import <atomic>;
 export import <memory>;
+export import <mutex>;
 export import <set>;
 export import <vector>;
 
@@ -148,6 +150,33 @@ namespace Ogre {
         };
 
         using TextureUnitStates = std::vector<TextureUnitState *>;
+
+        /** The fixed render state of the pass, resolved into the values handed to the RenderSystem.
+        @remarks
+            Programs and texture units are not part of it, as their contents can change
+            without the pass being touched.
+        */
+        struct CompiledState
+        {
+            ColourBlendState blendState;
+            float lineWidth{1};
+            Real pointMinSize{0};
+            Real pointMaxSize{0};
+            bool pointAttenuation{false};
+            bool pointSprites{false};
+            bool lighting{true};
+            bool depthCheck{true};
+            bool depthWrite{true};
+            bool alphaToCoverage{false};
+            CompareFunction depthFunction{CompareFunction::LESS_EQUAL};
+            CompareFunction alphaRejectFunction{CompareFunction::ALWAYS_PASS};
+            unsigned char alphaRejectValue{0};
+            float depthBiasConstant{0};
+            float depthBiasSlopeScale{0};
+            CullingMode cullingMode{CullingMode::CLOCKWISE};
+            ShadeOptions shading{ShadeOptions::GOURAUD};
+            size_t numTextureUnits{0};
+        };
     private:
         Technique* mParent;
         String mName; /// Optional name for the pass
@@ -163,6 +192,11 @@ namespace Ogre {
         //-------------------------------------------------------------------------
         ColourBlendState mBlendState;
 
+        /// See _getCompiledState
+        mutable CompiledState mCompiledState;
+        mutable bool mCompiledStateDirty{true};
+        void _compileState() const;
+
         /// Needs to be dirtied when next loaded
         bool mHashDirtyQueued : 1;
         // Depth buffer settings
@@ -182,6 +216,8 @@ namespace Ogre {
         /// Normalisation
         bool mNormaliseNormals : 1;
         bool mPolygonModeOverrideable : 1;
+        /// May runs of identical renderables be drawn instanced?
+        bool mAutoInstancing : 1;
         bool mFogOverride : 1;
         /// Is this pass queued for deletion?
         bool mQueuedForDeletion : 1;
@@ -272,18 +308,25 @@ namespace Ogre {
         static PassSet msDirtyHashList;
         /// The place where passes go to die
         static PassSet msPassGraveyard;
+        /// Guards the two lists above, which the queues of all SceneManagers share
+        static std::mutex msPassListMutex;
         /// The Pass hash functor
-        static HashFunc* msHashFunc;
+        static std::atomic<HashFunc*> msHashFunc;
     public:
         /// Default constructor
         Pass(Technique* parent, unsigned short index);
-        /// Copy constructor
-        Pass(Technique* parent, unsigned short index, const Pass& oth );
+        /** Copy constructor
+        @param shareParameters Whether to share the GpuProgramParameters with oth until either changes them,
+            see Material::clone
+        */
+        Pass(Technique* parent, unsigned short index, const Pass& oth, bool shareParameters = false);
 
         ~Pass();
 
         /// Operator = overload
         auto operator=(const Pass& oth) -> Pass&;
+        /// operator=, optionally sharing the GpuProgramParameters, see Material::clone
+        auto _assign(const Pass& oth, bool shareParameters) -> Pass&;
 
         auto calculateSize() const -> size_t;
 
@@ -437,7 +480,7 @@ namespace Ogre {
             to their vertex normals for diffuse and specular light, and globally for ambient and
             emissive.
         */
-        void setLightingEnabled(bool enabled) { mLightingEnabled = enabled; }
+        void setLightingEnabled(bool enabled) { mLightingEnabled = enabled; mCompiledStateDirty = true; }
 
         /** Returns whether or not dynamic lighting is enabled.
          */
@@ -450,7 +493,7 @@ namespace Ogre {
          * This property determines what width is used to render lines.
          * @note some drivers only support a value of 1.0 here
          */
-        void setLineWidth(float width) { mLineWidth = width; }
+        void setLineWidth(float width) { mLineWidth = width; mCompiledStateDirty = true; }
         auto getLineWidth() const noexcept -> float { return mLineWidth; }
 
         /// @name Point Sprites
@@ -486,7 +529,7 @@ namespace Ogre {
             only need to use point oriented billboards which are all of the same size. You can also
             use it for any other point list render.
         */
-        void setPointSpritesEnabled(bool enabled) { mPointSpritesEnabled = enabled; }
+        void setPointSpritesEnabled(bool enabled) { mPointSpritesEnabled = enabled; mCompiledStateDirty = true; }
 
         /** Returns whether point sprites are enabled when rendering a
             point list.
@@ -762,7 +805,7 @@ namespace Ogre {
             Also see setDepthFunction for more advanced depth check configuration.
             @see Ogre::CompareFunction
         */
-        void setDepthCheckEnabled(bool enabled) {  mDepthCheck = enabled; }
+        void setDepthCheckEnabled(bool enabled) { mDepthCheck = enabled; mCompiledStateDirty = true; }
 
         /** Returns whether or not this pass renders with depth-buffer checking on or not.
         */
@@ -778,7 +821,7 @@ namespace Ogre {
             normally be on but can be turned off when rendering static backgrounds or when rendering a collection
             of transparent objects at the end of a scene so that they overlap each other correctly.
         */
-        void setDepthWriteEnabled(bool enabled) { mDepthWrite = enabled; }
+        void setDepthWriteEnabled(bool enabled) { mDepthWrite = enabled; mCompiledStateDirty = true; }
 
         /** Returns whether or not this pass renders with depth-buffer writing on or not.
         */
@@ -790,7 +833,7 @@ namespace Ogre {
             value of the pixel to be written and the current contents of the buffer. This comparison is
             normally Ogre::CompareFunction::LESS_EQUAL.
         */
-        void setDepthFunction( CompareFunction func ) {  mDepthFunc = func; }
+        void setDepthFunction( CompareFunction func ) { mDepthFunc = func; mCompiledStateDirty = true; }
         /** Returns the function used to compare depth values when depth checking is on.
             @see
             setDepthFunction
@@ -850,7 +893,7 @@ namespace Ogre {
             You may wish to use the Ogre::CullingMode::NONE option for mesh data that you cull yourself where the vertex
             winding is uncertain or for creating 2-sided passes.
         */
-        void setCullingMode( CullingMode mode ) { mCullMode = mode; }
+        void setCullingMode( CullingMode mode ) { mCullMode = mode; mCompiledStateDirty = true; }
 
         /** Returns the culling mode for geometry rendered with this pass. See setCullingMode for more information.
          */
@@ -887,7 +930,7 @@ namespace Ogre {
             vertex. Whether these values are interpolated across the face (and how) depends on this
             setting. The default shading method is Ogre::ShadeOptions::GOURAUD.
         */
-        void setShadingMode( ShadeOptions mode ) { mShadeOptions = mode; }
+        void setShadingMode( ShadeOptions mode ) { mShadeOptions = mode; mCompiledStateDirty = true; }
 
         /** Returns the type of light shading to be used.
          */
@@ -916,6 +959,20 @@ namespace Ogre {
         */
         auto getPolygonModeOverrideable() const noexcept -> bool { return mPolygonModeOverrideable; }
 
+        /** Sets whether consecutive renderables sharing this pass and their geometry may be
+            drawn with a single instanced draw call, see SceneManager::setAutoInstancing.
+        @remarks
+            The vertex program of the pass must then read the world matrix of the instance
+            from three float4 texture coordinates starting at the index given to
+            SceneManager::setAutoInstancing, as the world matrix parameter is identity for
+            instanced draws. The RTSS generates such a program with
+            @c transform_stage @c instanced. The default is false.
+        */
+        void setAutoInstancing(bool enabled) { mAutoInstancing = enabled; }
+
+        /** Gets whether renderables using this pass may be drawn instanced. */
+        auto getAutoInstancing() const noexcept -> bool { return mAutoInstancing; }
+
         /// @name Fogging
         /// @{
         /** Sets the fogging mode applied to this pass.
@@ -1000,11 +1057,11 @@ namespace Ogre {
 
         /** Sets the alpha reject function. @see setAlphaRejectSettings for more information.
          */
-        void setAlphaRejectFunction(CompareFunction func) { mAlphaRejectFunc = func; }
+        void setAlphaRejectFunction(CompareFunction func) { mAlphaRejectFunc = func; mCompiledStateDirty = true; }
 
         /** Gets the alpha reject value. @see setAlphaRejectSettings for more information.
          */
-        void setAlphaRejectValue(unsigned char val) { mAlphaRejectVal = val; }
+        void setAlphaRejectValue(unsigned char val) { mAlphaRejectVal = val; mCompiledStateDirty = true; }
 
         /** Gets the alpha reject function. @see setAlphaRejectSettings for more information.
          */
@@ -1023,7 +1080,7 @@ namespace Ogre {
             The common use for alpha to coverage is foliage rendering and chain-link fence style
             textures.
         */
-        void setAlphaToCoverageEnabled(bool enabled) { mAlphaToCoverageEnabled = enabled; }
+        void setAlphaToCoverageEnabled(bool enabled) { mAlphaToCoverageEnabled = enabled; mCompiledStateDirty = true; }
 
         /** Gets whether to use alpha to coverage (A2C) when blending alpha rejected values.
          */
@@ -1278,18 +1335,20 @@ namespace Ogre {
 
         /** Gets the Gpu program parameters used by this pass. */
         auto getGpuProgramParameters(GpuProgramType type) const -> const GpuProgramParametersSharedPtr&;
+        /// Gets the parameters for binding them, without copying shared ones, see GpuProgramUsage::_getParameters
+        auto _getGpuProgramParameters(GpuProgramType type) const -> const GpuProgramParametersSharedPtr&;
         /// @overload
-        auto getVertexProgramParameters() const -> GpuProgramParametersSharedPtr;
+        auto getVertexProgramParameters() const -> const GpuProgramParametersSharedPtr&;
         /// @overload
-        auto getFragmentProgramParameters() const -> GpuProgramParametersSharedPtr;
+        auto getFragmentProgramParameters() const -> const GpuProgramParametersSharedPtr&;
         /// @overload
-        auto getGeometryProgramParameters() const -> GpuProgramParametersSharedPtr;
+        auto getGeometryProgramParameters() const -> const GpuProgramParametersSharedPtr&;
         /// @overload
-        auto getTessellationHullProgramParameters() const -> GpuProgramParametersSharedPtr;
+        auto getTessellationHullProgramParameters() const -> const GpuProgramParametersSharedPtr&;
         /// @overload
-        auto getTessellationDomainProgramParameters() const -> GpuProgramParametersSharedPtr;
+        auto getTessellationDomainProgramParameters() const -> const GpuProgramParametersSharedPtr&;
         /// @overload
-        auto getComputeProgramParameters() const -> GpuProgramParametersSharedPtr;
+        auto getComputeProgramParameters() const -> const GpuProgramParametersSharedPtr&;
         /// @}
 
         /** Splits this Pass to one which can be handled in the number of
@@ -1338,6 +1397,18 @@ namespace Ogre {
         /** Tells the pass that it needs recompilation. */
         void _notifyNeedsRecompile();
 
+        /** Gets the compiled render state of this pass.
+        @remarks
+            It is compiled when the pass is loaded and again on the first use after any
+            of the settings it holds, or the hash, was changed.
+        */
+        auto _getCompiledState() const -> const CompiledState&
+        {
+            if (mCompiledStateDirty)
+                _compileState();
+            return mCompiledState;
+        }
+
         /** Update automatic parameters.
             @param source The source of the parameters
             @param variabilityMask A mask of GpuParamVariability which identifies which autos will need updating
@@ -1369,6 +1440,11 @@ namespace Ogre {
          */
         static auto getPassGraveyard() noexcept -> const PassSet&
         { return msPassGraveyard; }
+        /** Gets the mutex to hold while reading the dirty hash list or the graveyard.
+        @remarks
+            Materials may be modified while the SceneManagers are updated on other threads.
+        */
+        static auto _getPassListMutex() noexcept -> std::mutex& { return msPassListMutex; }
         /** Static method to reset the list of passes which need their hash
             values recalculated.
             @remarks
@@ -1536,11 +1612,11 @@ namespace Ogre {
             of this method. The default is MIN_GPU_PROGRAM_CHANGE.
             @see HashFunc
         */
-        static void setHashFunction(HashFunc* hashFunc) { msHashFunc = hashFunc; }
+        static void setHashFunction(HashFunc* hashFunc) { msHashFunc.store(hashFunc, std::memory_order_relaxed); }
 
         /** Get the hash function used for all passes.
          */
-        static auto getHashFunction() noexcept -> HashFunc* { return msHashFunc; }
+        static auto getHashFunction() noexcept -> HashFunc* { return msHashFunc.load(std::memory_order_relaxed); }
 
         /** Get the builtin hash function.
          */
@@ -76,6 +76,11 @@ namespace Ogre {
             FPU             = 1 << 12,
             PRO             = 1 << 13,
             HTT             = 1 << 14,
+            AVX             = 1 << 15,
+            AVX2            = 1 << 16,
+            FMA             = 1 << 17,
+            AVX512F         = 1 << 18,
+            NEON            = 1 << 19,
 
             NONE            = 0
         };
@@ -236,6 +236,8 @@ class TextureUnitState;
         }
 
         auto calculate(Real source) -> Real override;
+        /// The time since the last update is added to the time of the sequence
+        [[nodiscard]] auto isInputAccumulated() const noexcept -> bool override { return true; }
 
         /** Set the time value manually. */
         void setTime(Real timeVal);
@@ -147,6 +147,7 @@ namespace Ogre {
     class Mesh;
     class MeshSerializer;
     class MeshManager;
+    class MeshTriangleBVH;
     class MovableObject;
     class MovablePlane;
     class Node;
@@ -241,6 +242,7 @@ namespace Ogre {
     using Vector2 = Vector<2, Real>;
     using Vector2i = Vector<2, int>;
     using Vector3 = Vector<3, Real>;
+    using Vector3d = Vector<3, double>;
     using Vector3f = Vector<3, float>;
     using Vector3i = Vector<3, int>;
     using Vector4 = Vector<4, Real>;
@@ -45,9 +45,15 @@ export import :Prerequisites;
 export import :Singleton;
 
 export import <algorithm>;
+export import <atomic>;
+export import <iosfwd>;
 export import <map>;
+export import <memory>;
+export import <mutex>;
 export import <set>;
 export import <string>;
+export import <string_view>;
+export import <thread>;
 export import <vector>;
 
 export
@@ -195,6 +201,24 @@ namespace Ogre {
         uint            hierarchicalLvl{0};
     };
 
+    /// Named values reported along with the profiles, see Profiler::setCounter
+    using ProfileCounterMap = std::map<String, uint64, std::less<>>;
+
+    /// A Profile captured for a trace, see Profiler::setTraceCapture
+    struct ProfileTraceEvent
+    {
+        /// The name the Profile was created with
+        std::string_view name;
+        /// Nanoseconds since the capture started
+        uint64 start;
+        /// Nanoseconds between the beginning and the end
+        uint64 duration;
+        /// 0 for the thread which created the Profiler, then in the order the threads were first seen
+        uint32 thread;
+        /// The number of enclosing profiles on the same thread
+        uint32 depth;
+    };
+
     /** ProfileSessionListener should be used to visualize profile results.
         Concrete impl. could be done using Overlay's but its not limited to 
         them you can also create a custom listener which sends the profile
@@ -219,6 +243,9 @@ namespace Ogre {
         
         /// Here we get the real profiling information which we can use 
         virtual void displayResults(const ProfileInstance& instance, ulong maxTotalFrameClocks) {};
+
+        /// Here we get the counters, displayed as often as the profiling information
+        virtual void displayCounters(const ProfileCounterMap& counters) {};
     };
 
     /** The profiler allows you to measure the performance of your code
@@ -227,7 +254,9 @@ namespace Ogre {
             outside of its scope (i.e. the main game loop). For most cases, use the macro
             OgreProfile(name) and braces to limit the scope. You must enable the Profile
             before you can used it with setEnabled(true). If you want to disable profiling
-            in Ogre, simply set the macro OGRE_PROFILING to 0.
+            in Ogre, simply set the macro OGRE_PROFILING to 0. Profiles on other threads
+            than the one which created the Profiler only take part in traces, see
+            setTraceCapture.
         @author Amit Mathew (amitmathew (at) yahoo (dot) com)
         @todo resolve artificial cap on number of profiles displayed
         @todo fix display ordering of profiles not called every frame
@@ -292,6 +321,25 @@ namespace Ogre {
              */
             void markGPUEvent(std::string_view event);
 
+            /** Sets whether GPU events are timed.
+            @remarks
+                Enables RenderSystem::setProfileEventTiming while the profiler is enabled.
+                The GPU timings are added below a "GPU" profile at the root, nested like
+                the GPU events, and are processed along with the CPU profiles. As the GPU
+                lags behind, they describe a frame some frames before the current one.
+                Disabled by default, as timing every GPU event has a small cost.
+            */
+            void setGPUTiming(bool enabled);
+            /** Gets whether GPU events are timed */
+            [[nodiscard]] auto getGPUTiming() const noexcept -> bool { return mGPUTiming; }
+
+            /** Gets the GPU time of the events which completed during the last frame, in milliseconds.
+            @remarks
+                The sum of the outermost timed GPU events, 0 if no timings became available.
+                Requires GPU timing, see setGPUTiming.
+            */
+            [[nodiscard]] auto getGPUFrameTime() const noexcept -> Real { return mGPUFrameTime; }
+
             /** Sets whether this profiler is enabled. Only takes effect after the
                 the frame has ended.
                 @remarks When this is called the first time with the parameter true,
@@ -373,6 +421,79 @@ namespace Ogre {
             */
             void removeListener(ProfileSessionListener* listener);
 
+            /** Sets the value of a named counter.
+            @remarks
+                Counters describe the work done per frame, e.g. the number of draw calls, and
+                are passed to ProfileSessionListener::displayCounters whenever the profile
+                results are displayed. Root publishes the SceneManager::RenderLoopStats and
+                RenderSystem::RenderStats this way while the profiler is enabled, along with
+                the CPU time of the frame up to the buffer swap as "Frame/cpuMicroseconds", the
+                bytes taken from Root::getFrameAllocator as "Frame/scratchBytes" and
+                the MemoryTracker statistics as "Memory/<category>/...". A counter
+                keeps its value until it is set again or the profiler is reset.
+            */
+            void setCounter(std::string_view name, uint64 value);
+
+            /** Gets all counters set so far */
+            [[nodiscard]] auto getCounters() const noexcept -> const ProfileCounterMap& { return mCounters; }
+
+            /** Sets whether every Profile is captured as an event for a trace, see exportTrace.
+            @remarks
+                Unlike the profile hierarchy, which is only built on the thread that created the
+                Profiler, the profiles of all threads are captured, each as its name, its thread and
+                the times it began and ended. A thread writes these to a lock free ring buffer of its
+                own, without looking anything up, and _collectTrace pairs them at the end of the
+                frame. This costs some tens of nanoseconds per Profile, regardless of setEnabled, so
+                a capture may be taken from a release build. The profile group mask applies.
+            @par
+                Enabling starts a new capture. Names are referenced rather than copied, so they must
+                outlive the capture, as string literals do. Profiles not fitting in the ring buffer
+                of their thread, or beyond getTraceCapacity, are dropped, see getTraceDroppedEvents.
+            */
+            void setTraceCapture(bool enabled);
+            /** Gets whether profiles are captured as events for a trace */
+            [[nodiscard]] auto getTraceCapture() const noexcept -> bool { return mTraceCapture.load(std::memory_order_relaxed); }
+
+            /** Sets the number of events kept by a capture, 1 << 20 by default */
+            void setTraceCapacity(size_t events) { mTraceCapacity = events; }
+            /** Gets the number of events kept by a capture */
+            [[nodiscard]] auto getTraceCapacity() const noexcept -> size_t { return mTraceCapacity; }
+
+            /** Gets the events captured up to the last _collectTrace, ordered by their end per thread */
+            [[nodiscard]] auto getTraceEvents() const noexcept -> const std::vector<ProfileTraceEvent>& { return mTraceEvents; }
+            /** Gets the number of profiles of the capture which were dropped */
+            [[nodiscard]] auto getTraceDroppedEvents() const noexcept -> size_t { return mTraceDropped; }
+
+            /** Writes the captured events in the Chrome trace event format.
+            @remarks
+                The JSON can be opened with Perfetto and chrome://tracing. Collects the events
+                recorded since the last frame first.
+            */
+            void exportTrace(std::ostream& stream);
+
+            /** Moves the events collected so far to events, replacing its contents.
+            @remarks
+                The capture continues, later events are collected anew. Used by HitchMonitor
+                to keep the events per frame.
+            */
+            void _takeTraceEvents(std::vector<ProfileTraceEvent>& events);
+            /** Gets the nanoseconds since the capture started, the time base of the events */
+            [[nodiscard]] auto _getTraceTime() const -> uint64;
+
+            /** Pairs the events the threads recorded since the last call.
+            @remarks
+                Called by Root at the end of every frame. Profiles still running are completed
+                by a later call.
+            */
+            void _collectTrace();
+
+            /** Records the beginning of a Profile on the calling thread, if capturing.
+            @return whether _traceEnd must be called when the profile ends
+            */
+            auto _traceBegin(std::string_view profileName, ProfileGroupMask groupID) -> bool;
+            /** Records the end of a Profile whose beginning was recorded. */
+            void _traceEnd(std::string_view profileName);
+
             /// @copydoc Singleton::getSingleton()
             static auto getSingleton() noexcept -> Profiler&;
             /// @copydoc Singleton::getSingleton()
@@ -401,6 +522,12 @@ namespace Ogre {
             /** Handles a change of the profiler's enabled state*/
             void changeEnableState();
 
+            /** Enables event timing on the render system if both the profiler and
+                GPU timing are enabled */
+            void updateGPUTiming();
+            /** Adds the GPU timings which became available to the GPU profile */
+            void processGPUTimings();
+
             // lol. Uses typedef; put's original container type in name.
             using DisabledProfileMap = std::set<std::string_view>;
             using ProfileChildren = ProfileInstance::ProfileChildren;
@@ -412,6 +539,8 @@ namespace Ogre {
             /// Holds the names of disabled profiles
             DisabledProfileMap mDisabledProfiles;
 
+            ProfileCounterMap mCounters;
+
             /// Whether the GUI elements have been initialized
             bool mInitialized{false};
 
@@ -431,6 +560,11 @@ namespace Ogre {
             /// Whether this profiler is enabled
             bool mEnabled{true};
 
+            /// Whether GPU events are timed, see setGPUTiming
+            bool mGPUTiming{false};
+            /// GPU time of the last frame in milliseconds, see getGPUFrameTime
+            Real mGPUFrameTime{0};
+
             /// Keeps track of the new enabled/disabled state that the user has requested
             /// which will be applied after the frame ends
             bool mNewEnableState{true};
@@ -445,6 +579,27 @@ namespace Ogre {
             long double mAverageFrameClocks{0};
             bool mResetExtents{false};
 
+            /// The thread building the profile hierarchy
+            std::thread::id mThread;
+
+            /// The events recorded by one thread, see setTraceCapture
+            struct ThreadTrace;
+            std::vector<std::unique_ptr<ThreadTrace>> mThreadTraces;
+            /// Guards mThreadTraces and the collected events
+            std::mutex mTraceMutex;
+            std::atomic<bool> mTraceCapture{false};
+            /// Tells the ring buffers cached by the threads from those of an earlier Profiler
+            uint64 mTraceGeneration;
+            uint64 mTraceStart{0};
+            size_t mTraceCapacity{1 << 20};
+            std::vector<ProfileTraceEvent> mTraceEvents;
+            size_t mTraceDropped{0};
+            static thread_local ThreadTrace* msThreadTrace;
+            static thread_local uint64 msThreadTraceGeneration;
+
+            /// The ring buffer of the calling thread, created on first use
+            auto threadTrace() -> ThreadTrace*;
+
     }; // end class
 
     /** An individual profile that will be processed by the Profiler
@@ -464,15 +619,25 @@ namespace Ogre {
         Profile(std::string_view profileName, ProfileGroupMask groupID = ProfileGroupMask::USER_DEFAULT)
             : mName(profileName), mGroupID(groupID)
         {
-            Profiler::getSingleton().beginProfile(profileName, groupID);
+            Profiler& profiler = Profiler::getSingleton();
+            mTraced = profiler._traceBegin(profileName, groupID);
+            profiler.beginProfile(profileName, groupID);
+        }
+        ~Profile()
+        {
+            Profiler& profiler = Profiler::getSingleton();
+            profiler.endProfile(mName, mGroupID);
+            if (mTraced)
+                profiler._traceEnd(mName);
         }
-        ~Profile() { Profiler::getSingleton().endProfile(mName, mGroupID); }
 
     private:
-        /// The name of this profile
-        String mName;
+        /// The name of this profile, which the Profiler references as well
+        std::string_view mName;
         /// The group ID
         ProfileGroupMask mGroupID;
+        /// Whether the beginning was captured for a trace
+        bool mTraced;
     };
     /** @} */
     /** @} */
@@ -25,8 +25,19 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 THE SOFTWARE.
 -----------------------------------------------------------------------------
 */
+module;
+
+#include <cstdint>
+
 export module Ogre.Core:RadixSort;
 
+export import :WorkQueue;
+
+export import <algorithm>;
+export import <bit>;
+export import <iterator>;
+export import <type_traits>;
+export import <utility>;
 export import <vector>;
 
 export
@@ -38,6 +49,151 @@ namespace Ogre {
     /** \addtogroup General
     *  @{
     */
+    /** Sorts entries by their unsigned key member, one byte at a time from the least significant.
+    @remarks
+        The core shared by RadixSort and CoherentSort, which map their values to the keys.
+        Passes over bytes which all keys share are skipped. The sort is stable, and the
+        scratch storage is kept from one sort to the next.
+    @par
+        Given a work queue, large ranges are split into chunks. For each byte, the chunks are
+        counted in parallel, the prefix sum of the counts is taken ordered by byte value, then
+        chunk, and the chunks are scattered in parallel, each writing its entries of a byte
+        value after those of the chunks before it, which keeps the sort stable.
+    */
+    template <class TEntry>
+    class RadixSortPasses
+    {
+    public:
+        using KeyType = std::remove_cvref_t<decltype(std::declval<TEntry&>().key)>;
+        static_assert(std::is_unsigned_v<KeyType>, "radix sort keys must be unsigned integers");
+
+        /// Default of the minimum number of entries sorted in parallel, see setWorkQueue
+        static constexpr size_t DEFAULT_PARALLEL_THRESHOLD = 32768;
+
+        /** Sets a queue on which large ranges are sorted in parallel, none by default.
+        @remarks
+            Below the threshold, the cost of the tasks outweighs the gain.
+        @param queue The queue to use, @c nullptr to always sort on the calling thread
+        @param threshold The minimum number of entries to sort in parallel
+        */
+        void setWorkQueue(WorkQueue* queue, size_t threshold = DEFAULT_PARALLEL_THRESHOLD)
+        {
+            mWorkQueue = queue;
+            mParallelThreshold = threshold;
+        }
+        [[nodiscard]] auto getWorkQueue() const noexcept -> WorkQueue* { return mWorkQueue; }
+        [[nodiscard]] auto getParallelThreshold() const noexcept -> size_t { return mParallelThreshold; }
+
+        /** Sorts the entries by the lowest bytes of their keys
+        @param entries The entries to sort, swapped with the scratch storage on the way
+        @param numPasses The number of bytes to sort by, at most the size of the keys
+        */
+        void sort(std::vector<TEntry>& entries, int numPasses = NUM_BYTES)
+        {
+            if (entries.size() < 2)
+                return;
+            mScratch.resize(entries.size());
+            if (mWorkQueue && entries.size() >= mParallelThreshold)
+                sortParallel(entries, numPasses);
+            else
+                sortSerial(entries, numPasses);
+        }
+
+        /// Frees the scratch storage, which is otherwise kept for the next sort
+        void releaseStorage()
+        {
+            std::vector<TEntry>{}.swap(mScratch);
+            std::vector<size_t>{}.swap(mChunkCounters);
+        }
+
+    private:
+        static constexpr int NUM_BYTES = sizeof(KeyType);
+        /// Fewest entries per chunk when sorting in parallel
+        static constexpr size_t MIN_CHUNK_SIZE = 8192;
+        /// Most chunks when sorting in parallel, bounding the size of the counters
+        static constexpr size_t MAX_CHUNKS = 64;
+
+        std::vector<TEntry> mScratch;
+        /// Counters of the values of each byte of the keys (histograms), when sorting serially
+        size_t mCounters[NUM_BYTES][256];
+        /// Counters of the values of the current byte per chunk, when sorting in parallel
+        std::vector<size_t> mChunkCounters;
+        WorkQueue* mWorkQueue{nullptr};
+        size_t mParallelThreshold{DEFAULT_PARALLEL_THRESHOLD};
+
+        static auto getByte(KeyType key, int byteIndex) -> size_t
+        {
+            return (key >> (byteIndex * 8)) & 0xFF;
+        }
+
+        void sortSerial(std::vector<TEntry>& entries, int numPasses)
+        {
+            for (int p = 0; p < numPasses; ++p)
+                std::ranges::fill(mCounters[p], 0);
+            // the counts of each byte do not change with the order, so all are done at once
+            for (auto const& entry : entries)
+                for (int p = 0; p < numPasses; ++p)
+                    ++mCounters[p][getByte(entry.key, p)];
+
+            for (int p = 0; p < numPasses; ++p)
+            {
+                auto& offsets = mCounters[p];
+                // nothing to do if all keys share this byte
+                if (std::ranges::find(offsets, entries.size()) != std::end(offsets))
+                    continue;
+
+                // Basically this just leaves gaps for duplicate entries to fill
+                size_t total = 0;
+                for (auto& offset : offsets)
+                    total += ::std::exchange(offset, total);
+
+                for (auto const& entry : entries)
+                    mScratch[offsets[getByte(entry.key, p)]++] = entry;
+                entries.swap(mScratch);
+            }
+        }
+
+        void sortParallel(std::vector<TEntry>& entries, int numPasses)
+        {
+            size_t const size = entries.size();
+            size_t const numChunks = std::clamp<size_t>(size / MIN_CHUNK_SIZE, 1, MAX_CHUNKS);
+            size_t const chunkSize = (size + numChunks - 1) / numChunks;
+            mChunkCounters.resize(numChunks * 256);
+
+            for (int p = 0; p < numPasses; ++p)
+            {
+                mWorkQueue->parallelFor(numChunks, [&](size_t chunk)
+                {
+                    size_t* counters = &mChunkCounters[chunk * 256];
+                    std::fill_n(counters, 256, 0);
+                    for (size_t i = chunk * chunkSize, last = std::min(size, i + chunkSize); i < last; ++i)
+                        ++counters[getByte(entries[i].key, p)];
+                });
+
+                // nothing to do if all keys share this byte
+                size_t firstCount = 0;
+                for (size_t byte = 0; firstCount == 0; ++byte)
+                    for (size_t chunk = 0; chunk < numChunks; ++chunk)
+                        firstCount += mChunkCounters[chunk * 256 + byte];
+                if (firstCount == size)
+                    continue;
+
+                size_t total = 0;
+                for (size_t byte = 0; byte < 256; ++byte)
+                    for (size_t chunk = 0; chunk < numChunks; ++chunk)
+                        total += ::std::exchange(mChunkCounters[chunk * 256 + byte], total);
+
+                mWorkQueue->parallelFor(numChunks, [&](size_t chunk)
+                {
+                    size_t* offsets = &mChunkCounters[chunk * 256];
+                    for (size_t i = chunk * chunkSize, last = std::min(size, i + chunkSize); i < last; ++i)
+                        mScratch[offsets[getByte(entries[i].key, p)]++] = entries[i];
+                });
+                entries.swap(mScratch);
+            }
+        }
+    };
+
     /** Class for performing a radix sort (fast comparison-less sort based on 
         byte value) on various standard STL containers. 
     @remarks
@@ -77,158 +233,85 @@ namespace Ogre {
     @endcode
         You should try to reuse RadixSort instances, since repeated allocation of the 
         internal storage is then avoided.
+    @par
+        Passes over bytes which all keys share are skipped, so e.g. 64 bit keys
+        packing a few distinct values in their upper half cost little more than 32
+        bit ones. Large ranges can be sorted in parallel, see setWorkQueue.
     @note
         Radix sorting is often associated with just unsigned integer values. Our
         implementation can handle both unsigned and signed integers, as well as
-        floats (which are often not supported by other radix sorters). doubles
-        are not supported; you will need to implement your functor object to convert
-        to float if you wish to use this sort routine.
+        floats and doubles (which are often not supported by other radix sorters),
+        of 8, 16, 32 or 64 bits. The values are mapped at compile time to unsigned
+        keys of the same size, which the passes work on.
     */
     template <class TContainer, class TContainerValueType, typename TCompValueType>
     class RadixSort
     {
     public:
         using ContainerIter = typename TContainer::iterator;
+
     protected:
-        /// Alpha-pass counters of values (histogram)
-        /// 4 of them so we can radix sort a maximum of a 32bit value
-        int mCounters[4][256];
-        /// Beta-pass offsets 
-        int mOffsets[256];
-        /// Sort area size
-        int mSortSize;
-        /// Number of passes for this type
-        int mNumPasses;
+        /// Unsigned integer of the size of the value, ordering like it once mapped by toKey
+        using KeyType = std::conditional_t<sizeof(TCompValueType) == 1, ::std::uint8_t,
+                        std::conditional_t<sizeof(TCompValueType) == 2, ::std::uint16_t,
+                        std::conditional_t<sizeof(TCompValueType) == 4, ::std::uint32_t, ::std::uint64_t>>>;
+        static_assert(sizeof(KeyType) == sizeof(TCompValueType), "values must have 8, 16, 32 or 64 bits");
+
+        static constexpr KeyType SIGN_BIT = KeyType(KeyType(1) << (sizeof(KeyType) * 8 - 1));
 
         struct SortEntry
         {
-            TCompValueType key;
+            KeyType key;
             ContainerIter iter;
         };
         /// Temp sort storage
-        using SortVector = typename std::vector<SortEntry>;
-        SortVector mSortArea1;
-        SortVector mSortArea2;
-        SortVector* mSrc;
-        SortVector* mDest;
+        std::vector<SortEntry> mSortArea;
+        RadixSortPasses<SortEntry> mPasses;
         TContainer mTmpContainer; // initial copy
 
-
-        void sortPass(int byteIndex)
-        {
-            // Calculate offsets
-            // Basically this just leaves gaps for duplicate entries to fill
-            mOffsets[0] = 0;
-            for (int i = 1; i < 256; ++i)
-            {
-                mOffsets[i] = mOffsets[i-1] + mCounters[byteIndex][i-1];
-            }
-
-            // Sort pass
-            for (int i = 0; i < mSortSize; ++i)
-            {
-                unsigned char byteVal = getByte(byteIndex, (*mSrc)[i].key);
-                (*mDest)[mOffsets[byteVal]++] = (*mSrc)[i];
-            }
-
-        }
-        template <typename T>
-        void finalPass(int byteIndex, T val)
+        /** Maps a value to a key which orders the same as an unsigned integer.
+        @remarks
+            Signed integers get their sign bit flipped. Positive floats get it set, while negative
+            ones get all their bits flipped, so that these come first and in reverse.
+        */
+        static auto toKey(TCompValueType val) -> KeyType
         {
-            // default is to do normal pass
-            sortPass(byteIndex);
+            auto bits = std::bit_cast<KeyType>(val);
+            if constexpr (std::is_floating_point_v<TCompValueType>)
+                return (bits & SIGN_BIT) ? KeyType(~bits) : KeyType(bits | SIGN_BIT);
+            else if constexpr (std::is_signed_v<TCompValueType>)
+                return KeyType(bits ^ SIGN_BIT);
+            else
+                return bits;
         }
-        
-        // special case signed int
-        void finalPass(int byteIndex, int val)
-        {
-            int numNeg = 0;
-            // all negative values are in entries 128+ in most significant byte
-            for (int i = 128; i < 256; ++i)
-            {
-                numNeg += mCounters[byteIndex][i];
-            }
-            // Calculate offsets - positive ones start at the number of negatives
-            // do positive numbers
-            mOffsets[0] = numNeg;
-            for (int i = 1; i < 128; ++i)
-            {
-                mOffsets[i] = mOffsets[i-1] + mCounters[byteIndex][i-1];
-            }
-            // Do negative numbers (must start at zero)
-            // No need to invert ordering, already correct (-1 is highest number)
-            mOffsets[128] = 0;
-            for (int i = 129; i < 256; ++i)
-            {
-                mOffsets[i] = mOffsets[i-1] + mCounters[byteIndex][i-1];
-            }
 
-            // Sort pass
-            for (int i = 0; i < mSortSize; ++i)
-            {
-                unsigned char byteVal = getByte(byteIndex, (*mSrc)[i].key);
-                (*mDest)[mOffsets[byteVal]++] = (*mSrc)[i];
-            }
-        }
-        
+    public:
 
-        // special case float
-        void finalPass(int byteIndex, float val)
-        {
-            // floats need to be special cased since negative numbers will come
-            // after positives (high bit = sign) and will be in reverse order
-            // (no ones-complement of the +ve value)
-            int numNeg = 0;
-            // all negative values are in entries 128+ in most significant byte
-            for (int i = 128; i < 256; ++i)
-            {
-                numNeg += mCounters[byteIndex][i];
-            }
-            // Calculate offsets - positive ones start at the number of negatives
-            // do positive numbers normally
-            mOffsets[0] = numNeg;
-            for (int i = 1; i < 128; ++i)
-            {
-                mOffsets[i] = mOffsets[i-1] + mCounters[byteIndex][i-1];
-            }
-            // Do negative numbers (must start at zero)
-            // Also need to invert ordering
-            // In order to preserve the stability of the sort (essential since
-            // we rely on previous bytes already being sorted) we have to count
-            // backwards in our offsets from 
-            mOffsets[255] = mCounters[byteIndex][255];
-            for (int i = 254; i > 127; --i)
-            {
-                mOffsets[i] = mOffsets[i+1] + mCounters[byteIndex][i];
-            }
+        RadixSort() = default;
+        ~RadixSort() = default;
 
-            // Sort pass
-            for (int i = 0; i < mSortSize; ++i)
-            {
-                unsigned char byteVal = getByte(byteIndex, (*mSrc)[i].key);
-                if (byteVal > 127)
-                {
-                    // -ve; pre-decrement since offsets set to count
-                    (*mDest)[--mOffsets[byteVal]] = (*mSrc)[i];
-                }
-                else
-                {
-                    // +ve
-                    (*mDest)[mOffsets[byteVal]++] = (*mSrc)[i];
-                }
-            }
+        /** Sets a queue on which large ranges are sorted in parallel, none by default.
+        @remarks
+            Ranges of at least threshold items are split into chunks which are counted and
+            scattered by parallel tasks of the queue, see RadixSortPasses. The functor is
+            still only called on the calling thread.
+        */
+        void setWorkQueue(WorkQueue* queue,
+                          size_t threshold = RadixSortPasses<SortEntry>::DEFAULT_PARALLEL_THRESHOLD)
+        {
+            mPasses.setWorkQueue(queue, threshold);
         }
+        [[nodiscard]] auto getWorkQueue() const noexcept -> WorkQueue* { return mPasses.getWorkQueue(); }
+        [[nodiscard]] auto getParallelThreshold() const noexcept -> size_t { return mPasses.getParallelThreshold(); }
 
-        inline auto getByte(int byteIndex, TCompValueType val) -> unsigned char
+        /// Frees the internal storage, which is otherwise kept for the next sort
+        void releaseStorage()
         {
-            return ((unsigned char*)(&val))[byteIndex];
+            std::vector<SortEntry>{}.swap(mSortArea);
+            mPasses.releaseStorage();
+            mTmpContainer = TContainer{};
         }
 
-    public:
-
-        RadixSort() = default;
-        ~RadixSort() = default;
-
         /** Main sort function
         @param container A container of the type you declared when declaring
         @param func A functor which returns the value for comparison when given
@@ -243,80 +326,194 @@ namespace Ogre {
         template <class TFunction>
         void sort(ContainerIter dbegin, ContainerIter dend, TFunction func)
         {
-            // Set up the sort areas
-            mSortSize = static_cast<int>(std::distance(dbegin, dend));
+            // Set up the sort area, keeping its capacity from previous sorts
+            auto const size = static_cast<size_t>(std::distance(dbegin, dend));
 
-            if (mSortSize == 0)
+            if (size == 0)
                 return;
 
-            mSortArea1.resize(mSortSize);
-            mSortArea2.resize(mSortSize);
+            mSortArea.resize(size);
 
             // Copy data now (we need constant iterators for sorting)
             mTmpContainer.assign(::std::make_move_iterator(dbegin), ::std::make_move_iterator(dend));
 
-            mNumPasses = sizeof(TCompValueType);
-
-            // Counter pass
-            // Initialise the counts
-            for (auto p = 0; p < mNumPasses; ++p)
-                memset(mCounters[p], 0, sizeof(int) * 256);
-
-            // Perform alpha pass to count
             auto i = mTmpContainer.begin();
-            TCompValueType prevValue = func.operator()(*i); 
+            KeyType prevKey = 0;
             bool needsSorting = false;
-            for (int u = 0; i != mTmpContainer.end(); ++i, ++u)
+            for (size_t u = 0; i != mTmpContainer.end(); ++i, ++u)
             {
-                // get sort value
-                TCompValueType val = func.operator()(*i);
+                KeyType key = toKey(func.operator()(*i));
                 // cheap check to see if needs sorting (temporal coherence)
-                if (!needsSorting && val < prevValue)
-                    needsSorting = true;
+                needsSorting |= key < prevKey;
+                mSortArea[u] = SortEntry{key, i};
+                prevKey = key;
+            }
 
-                // Create a sort entry
-                mSortArea1[u].key = val;
-                mSortArea1[u].iter = i;
+            // early exit if already sorted, the values still have to go back
+            if (!needsSorting)
+            {
+                ::std::move(mTmpContainer.begin(), mTmpContainer.end(), dbegin);
+                return;
+            }
 
-                // increase counters
-                for (auto p = 0; p < mNumPasses; ++p)
-                {
-                    unsigned char byteVal = getByte(p, val);
-                    mCounters[p][byteVal]++;
-                }
+            mPasses.sort(mSortArea);
 
-                prevValue = val;
+            // Copy everything back
+            auto it = dbegin;
+            for (auto const& entry : mSortArea)
+                *it++ = ::std::move(*entry.iter);
+        }
 
-            }
+    };
 
-            // early exit if already sorted
-            if (!needsSorting)
-                return;
+    /** Sorts a range by a float key, making use of the order left by the previous sort.
+    @remarks
+        Meant for depth sorting, where the order changes little from one frame to the
+        next. The keys are first sorted with an insertion sort, which is linear on nearly
+        sorted data; should that take more than a few moves per item, it is abandoned for
+        a radix sort. Unlike RadixSort, the sorter should be kept per sorted range, since
+        the coherence is between the calls for the same items.
+    @par
+        The keys can be quantized to 16 bits (see setQuantized), which halves the number
+        of radix passes. Items closer than 1/65535th of the key range then compare equal
+        and, as the sort is stable, keep their previous order.
+    @par
+        sort does everything at once. computeKeys, sortKeys and applyOrder split it up;
+        sortKeys only touches the internal storage, so it may run on another thread while
+        the range is used elsewhere, as long as applyOrder is called with the same items
+        afterwards.
+    */
+    template <class TContainer, class TContainerValueType>
+    class CoherentSort
+    {
+    public:
+        using ContainerIter = typename TContainer::iterator;
+
+        /// Sets whether the keys are quantized to 16 bits, off by default
+        void setQuantized(bool quantized) { mQuantized = quantized; }
+        [[nodiscard]] auto getQuantized() const noexcept -> bool { return mQuantized; }
+
+        /// Sets a queue on which the radix sort of large ranges runs in parallel, see RadixSortPasses
+        void setWorkQueue(WorkQueue* queue,
+                          size_t threshold = RadixSortPasses<SortEntry>::DEFAULT_PARALLEL_THRESHOLD)
+        {
+            mPasses.setWorkQueue(queue, threshold);
+        }
+        [[nodiscard]] auto getWorkQueue() const noexcept -> WorkQueue* { return mPasses.getWorkQueue(); }
 
+        /** Sorts a range ascending by the values func returns for its items
+        @param dbegin, dend The range to sort
+        @param func A functor returning the float to sort by when given a container value
+        */
+        template <class TFunction>
+        void sort(ContainerIter dbegin, ContainerIter dend, TFunction func)
+        {
+            computeKeys(dbegin, dend, func);
+            sortKeys();
+            applyOrder(dbegin, dend);
+        }
 
-            // Sort passes
-            mSrc = &mSortArea1;
-            mDest = &mSortArea2;
-            auto p = 0;
-            for (; p < mNumPasses - 1; ++p)
+        /// Evaluates func for each item of the range, the first step of sort
+        template <class TFunction>
+        void computeKeys(ContainerIter dbegin, ContainerIter dend, TFunction func)
+        {
+            mEntries.resize(std::distance(dbegin, dend));
+            ::std::uint32_t index = 0;
+            for (auto it = dbegin; it != dend; ++it, ++index)
+                mEntries[index] = SortEntry{ func.operator()(*it), 0, index };
+            mOrderChanged = false;
+        }
+
+        /// Sorts the computed keys, the second step of sort
+        void sortKeys()
+        {
+            mOrderChanged = false;
+            if (mEntries.size() < 2)
+                return;
+
+            if (mQuantized)
             {
-                sortPass(p);
-                // flip src/dst
-                SortVector* tmp = mSrc;
-                mSrc = mDest;
-                mDest = tmp;
+                auto [minIt, maxIt] = std::ranges::minmax_element(mEntries, {}, &SortEntry::value);
+                float minValue = minIt->value;
+                float range = maxIt->value - minValue;
+                float scale = range > 0 ? 65535.0f / range : 0.0f;
+                for (auto& entry : mEntries)
+                    entry.key = static_cast<::std::uint32_t>((entry.value - minValue) * scale);
+            }
+            else
+            {
+                // flip the float bits so they compare like unsigned integers
+                for (auto& entry : mEntries)
+                {
+                    auto bits = std::bit_cast<::std::uint32_t>(entry.value);
+                    entry.key = (bits & 0x80000000u) ? ~bits : bits | 0x80000000u;
+                }
             }
-            // Final pass may differ, make polymorphic
-            finalPass(p, prevValue);
 
-            // Copy everything back
-            int c = 0;
-            for (auto it = dbegin; it != dend; ++it, ++c)
+            if (!insertionSort(mEntries.size() * 4 + 16))
+                radixSort(mQuantized ? 2 : 4);
+        }
+
+        /// Rearranges the range in the sorted order, the last step of sort
+        void applyOrder(ContainerIter dbegin, ContainerIter dend)
+        {
+            if (!mOrderChanged || static_cast<size_t>(std::distance(dbegin, dend)) != mEntries.size())
+                return;
+
+            mTmpContainer.assign(::std::make_move_iterator(dbegin), ::std::make_move_iterator(dend));
+            auto it = dbegin;
+            for (auto const& entry : mEntries)
+                *it++ = ::std::move(mTmpContainer[entry.index]);
+            mTmpContainer.clear();
+            mOrderChanged = false;
+        }
+
+    private:
+        struct SortEntry
+        {
+            float value;
+            ::std::uint32_t key;
+            ::std::uint32_t index;
+        };
+
+        /// Returns false if more than maxMoves moves were needed, leaving the entries unsorted
+        auto insertionSort(size_t maxMoves) -> bool
+        {
+            size_t moves = 0;
+            for (size_t i = 1; i < mEntries.size(); ++i)
             {
-                *it = ::std::move(*((*mDest)[c].iter));
+                SortEntry entry = mEntries[i];
+                size_t j = i;
+                for (; j > 0 && mEntries[j - 1].key > entry.key; --j)
+                {
+                    mEntries[j] = mEntries[j - 1];
+                    if (++moves > maxMoves)
+                    {
+                        mEntries[j - 1] = entry;
+                        mOrderChanged = true;
+                        return false;
+                    }
+                }
+                if (j != i)
+                {
+                    mEntries[j] = entry;
+                    mOrderChanged = true;
+                }
             }
+            return true;
+        }
+
+        void radixSort(int numPasses)
+        {
+            mPasses.sort(mEntries, numPasses);
+            mOrderChanged = true;
         }
 
+        std::vector<SortEntry> mEntries;
+        RadixSortPasses<SortEntry> mPasses;
+        TContainer mTmpContainer;
+        bool mQuantized{false};
+        bool mOrderChanged{false};
     };
 
     /** @} */
@@ -148,6 +148,19 @@ class Technique;
             virtual auto renderableQueued(Renderable* rend, RenderQueueGroupID groupID,
                 ushort priority, Technique** ppTech, RenderQueue* pQueue) -> bool = 0;
         };
+
+        /** Counters of the work done to fill the queue since it was last cleared. */
+        struct Stats
+        {
+            /// Number of scene nodes rejected by the camera or a visibility stage
+            size_t nodesCulled{0};
+            /// Number of objects which were asked to queue their renderables
+            size_t objectsVisible{0};
+            /// Number of objects reached but skipped, e.g. being hidden or no shadow casters
+            size_t objectsRejected{0};
+            /// Number of renderables added
+            size_t renderablesQueued{0};
+        };
     private:
         RenderQueueGroupMap mGroups;
         /// The current default queue group
@@ -158,8 +171,12 @@ class Technique;
         bool mSplitPassesByLightingType{false};
         bool mSplitNoShadowPasses{false};
         bool mShadowCastersCannotBeReceivers{false};
+        bool mSortKeyGrouping{false};
+        bool mRetainSortOrder{false};
 
         RenderableListener* mRenderableListener{nullptr};
+
+        Stats mStats;
     public:
         RenderQueue();
         virtual ~RenderQueue();
@@ -293,6 +310,30 @@ class Technique;
         */
         [[nodiscard]] auto getShadowCastersCannotBeReceivers() const noexcept -> bool;
 
+        /** Sets whether the solids are grouped by pass using packed 64 bit sort keys
+            instead of a map per collection.
+        @remarks
+            Empties the queue when changed, so set it between frames. See
+            QueuedRenderableCollection::setSortKeyGrouping for the details.
+        */
+        void setSortKeyGrouping(bool enabled);
+
+        /** Gets whether the solids are grouped by pass using packed sort keys. */
+        [[nodiscard]] auto getSortKeyGrouping() const noexcept -> bool { return mSortKeyGrouping; }
+
+        /** Sets whether the depth sorted collections, e.g. the transparents, keep their
+            order between frames and are re-sorted incrementally.
+        @remarks
+            Worthwhile when most of the visible set stays the same from one frame to the
+            next. The order is retained per collection, so rendering the queue for several
+            cameras per frame reduces the benefit. See
+            QueuedRenderableCollection::setRetainSortOrder for the details.
+        */
+        void setRetainSortOrder(bool enabled);
+
+        /** Gets whether the depth sorted collections keep their order between frames. */
+        [[nodiscard]] auto getRetainSortOrder() const noexcept -> bool { return mRetainSortOrder; }
+
         /** Set a renderable listener on the queue.
         @remarks
             There can only be a single renderable listener on the queue, since
@@ -305,8 +346,26 @@ class Technique;
         { return mRenderableListener; }
 
         /** Merge render queue.
+        @remarks
+            The statistics of the other queue are added to those of this one.
         */
         void merge( const RenderQueue* rhs );
+
+        /** Gets the counters of the work done since the queue was last cleared. */
+        [[nodiscard]] auto getStats() const noexcept -> const Stats& { return mStats; }
+
+        /** Records scene nodes failing the visibility tests, for the statistics. */
+        void _notifyNodesCulled(size_t count) { mStats.nodesCulled += count; }
+
+        /** Empties this queue completely and copies the configuration of another one.
+        @remarks
+            Prepares a staging queue collecting renderables on behalf of the given queue,
+            e.g. on another thread, to be merged into it afterwards. The settings, the
+            shadow flags and the organisation modes of the queue groups are copied, and
+            the priority groups are destroyed so no Pass is referenced any more. Unlike
+            clear this only affects this queue.
+        */
+        void _resetStaging(const RenderQueue* target);
         /** Utility method to perform the standard actions associated with 
             getting a visible object to add itself to the queue. This is 
             a replacement for SceneManager implementations of the associated
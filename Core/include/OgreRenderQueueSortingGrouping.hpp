@@ -129,7 +129,11 @@ namespace Ogre {
             /** Sort ascending camera distance 
                 Note value overlaps with descending since both use same sort
             */
-            SORT_ASCENDING = 6
+            SORT_ASCENDING = 6,
+            /** Group by pass hash, then sort front to back by quantised camera distance
+                Trades some pass changes for less overdraw, see acceptVisitor
+            */
+            PASS_GROUP_FRONT_TO_BACK = 8
         };
 
         friend auto constexpr operator not(OrganisationMode value) -> bool
@@ -187,17 +191,49 @@ namespace Ogre {
         /** Map of pass to renderable lists, this is a grouping by pass. */
         using PassGroupRenderableMap = std::map<Pass *, RenderableList, PassGroupLess>;
 
+        /// A renderable queued for sort key grouping
+        struct SortKeyedRenderable
+        {
+            /// Pass hash in the upper 32 bits, pass and view depth below, see setSortKeyGrouping
+            /// and OrganisationMode::PASS_GROUP_FRONT_TO_BACK
+            uint64 key;
+            Renderable* renderable;
+            Pass* pass;
+        };
+        using SortKeyedRenderableList = std::vector<SortKeyedRenderable>;
+
         /// Bitmask of the organisation modes requested
         OrganisationMode mOrganisationMode{0};
+        /// See setSortKeyGrouping
+        bool mSortKeyGrouping{false};
+        /// See setRetainSortOrder
+        bool mRetainSortOrder{false};
 
         /// Grouped 
         PassGroupRenderableMap mGrouped;
+        /// Grouped by sorting on a packed key, replaces mGrouped if mSortKeyGrouping is set
+        SortKeyedRenderableList mSortKeyed;
+        /// One pass group of mSortKeyed or mFrontToBack, as handed to the visitor
+        mutable RenderableList mSortKeyedGroup;
+        /// Sorted by pass hash, then by quantised depth, for OrganisationMode::PASS_GROUP_FRONT_TO_BACK
+        SortKeyedRenderableList mFrontToBack;
         /// Sorted descending (can iterate backwards to get ascending)
         RenderablePassList mSortedDescending;
+        /// mSortedDescending as of the last sort, if mRetainSortOrder is set
+        RenderablePassList mPreviousSortedDescending;
+
+        /** Sorts mSortedDescending starting from the previous order.
+        @return false if the order has changed too much for an insertion sort to pay off
+        */
+        auto sortRetained(const Camera* cam) -> bool;
 
         /// Internal visitor implementation
         void acceptVisitorGrouped(QueuedRenderableVisitor* visitor) const;
         /// Internal visitor implementation
+        void acceptVisitorFrontToBack(QueuedRenderableVisitor* visitor) const;
+        /// Visits every run of the same pass in a sorted list as one group
+        void acceptVisitorPassRuns(QueuedRenderableVisitor* visitor, const SortKeyedRenderableList& list) const;
+        /// Internal visitor implementation
         void acceptVisitorDescending(QueuedRenderableVisitor* visitor) const;
         /// Internal visitor implementation
         void acceptVisitorAscending(QueuedRenderableVisitor* visitor) const;
@@ -235,6 +271,37 @@ namespace Ogre {
             mOrganisationMode |= om;
         }
 
+        /** Sets whether grouping by pass is done by sorting packed keys rather than with a map.
+        @remarks
+            Every renderable is stored once in a flat list and sort() orders it by a 64 bit
+            key holding the pass hash, i.e. the pass and its texture and program state, the
+            index of the pass among those queued, and the quantised view depth. This avoids
+            the tree nodes and pointer chasing of the map, visits every pass once, also when
+            passes share a hash, and orders the renderables of a pass front to back. You can
+            only do this when the collection is empty.
+        */
+        void setSortKeyGrouping(bool enabled) { mSortKeyGrouping = enabled; }
+        /** Gets whether grouping by pass is done by sorting packed keys. */
+        [[nodiscard]] auto getSortKeyGrouping() const noexcept -> bool { return mSortKeyGrouping; }
+
+        /** Sets whether the depth sorted order is kept from one sort to the next.
+        @remarks
+            The visible set and the camera usually change little between frames, so the
+            renderables are first put in the order they had after the previous sort, with
+            new ones at the end, and then re-sorted by an insertion sort, which is close to
+            linear on nearly sorted data. If too many renderables have to move, it falls
+            back to the regular sort. Renderables which are no longer queued simply drop
+            out of the retained order.
+        */
+        void setRetainSortOrder(bool enabled)
+        {
+            mRetainSortOrder = enabled;
+            if (!enabled)
+                mPreviousSortedDescending.clear();
+        }
+        /** Gets whether the depth sorted order is kept from one sort to the next. */
+        [[nodiscard]] auto getRetainSortOrder() const noexcept -> bool { return mRetainSortOrder; }
+
         /// Add a renderable to the collection using a given pass
         void addRenderable(Pass* pass, Renderable* rend);
         
@@ -248,6 +315,15 @@ namespace Ogre {
         @param om The organisation mode which you want to iterate over.
             Note that this must have been included in an addOrganisationMode
             call before any renderables were added.
+        @remarks
+            If the mode was not requested, another one is used in its place, preferring
+            a grouping by pass. This lets OrganisationMode::PASS_GROUP_FRONT_TO_BACK
+            replace OrganisationMode::PASS_GROUP for a RenderQueueGroup: the state
+            buckets defined by the pass hash are visited in order, and within a bucket
+            the renderables go front to back in steps of under 1% of their distance,
+            renderables of the same pass and step being visited together. Depth tested
+            opaque geometry is then mostly drawn near to far, so early depth rejection
+            can discard the hidden fragments.
         */
         void acceptVisitor(QueuedRenderableVisitor* visitor, OrganisationMode om) const;
 
@@ -402,6 +478,16 @@ namespace Ogre {
             mShadowCastersNotReceivers = ind;
         }
 
+        /** Sets whether the collections group by pass using packed sort keys.
+        @see QueuedRenderableCollection::setSortKeyGrouping
+        */
+        void setSortKeyGrouping(bool enabled);
+
+        /** Sets whether the collections keep their depth sorted order between frames.
+        @see QueuedRenderableCollection::setRetainSortOrder
+        */
+        void setRetainSortOrder(bool enabled);
+
         /** Merge group of renderables. 
         */
         void merge( const RenderPriorityGroup* rhs );
@@ -431,8 +517,14 @@ namespace Ogre {
         PriorityMap mPriorityGroups;
         /// Whether shadows are enabled for this queue
         bool mShadowsEnabled{true};
+        /// Whether the solids of this queue take part in the depth pre-pass
+        bool mDepthPrePassEnabled{true};
         /// Bitmask of the organisation modes requested (for new priority groups)
         QueuedRenderableCollection::OrganisationMode mOrganisationMode{0};
+        /// Whether the priority groups group by pass using packed sort keys
+        bool mSortKeyGrouping{false};
+        /// Whether the priority groups keep their depth sorted order between frames
+        bool mRetainSortOrder{false};
 
 
     public:
@@ -466,6 +558,8 @@ namespace Ogre {
                     pPriorityGrp->resetOrganisationModes();
                     pPriorityGrp->addOrganisationMode(mOrganisationMode);
                 }
+                pPriorityGrp->setSortKeyGrouping(mSortKeyGrouping);
+                pPriorityGrp->setRetainSortOrder(mRetainSortOrder);
 
                 mPriorityGroups.emplace(priority, pPriorityGrp);
             }
@@ -516,6 +610,15 @@ namespace Ogre {
         /** Are shadows enabled for this queue? */
         [[nodiscard]] auto getShadowsEnabled() const noexcept -> bool { return mShadowsEnabled; }
 
+        /** Sets whether the solids of this queue are rendered to the depth buffer first, when
+            the SceneManager does a depth pre-pass.
+        @see SceneManager::setDepthPrePass
+        */
+        void setDepthPrePassEnabled(bool enabled) { mDepthPrePassEnabled = enabled; }
+
+        /** Are the solids of this queue rendered to the depth buffer first? */
+        [[nodiscard]] auto getDepthPrePassEnabled() const noexcept -> bool { return mDepthPrePassEnabled; }
+
         /** Sets whether or not the queue will split passes by their lighting type,
         ie ambient, per-light and decal. 
         */
@@ -582,6 +685,41 @@ namespace Ogre {
             }
         }
 
+        /** Sets whether the solids are grouped by pass using packed sort keys.
+        @remarks
+            You can only do this when the group is empty, ie after clearing the 
+            queue.
+        @see QueuedRenderableCollection::setSortKeyGrouping
+        */
+        void setSortKeyGrouping(bool enabled)
+        {
+            mSortKeyGrouping = enabled;
+            for (auto & mPriorityGroup : mPriorityGroups)
+            {
+                mPriorityGroup.second->setSortKeyGrouping(enabled);
+            }
+        }
+        /** Gets whether the solids are grouped by pass using packed sort keys. */
+        [[nodiscard]] auto getSortKeyGrouping() const noexcept -> bool { return mSortKeyGrouping; }
+
+        /** Sets whether the depth sorted collections keep their order between frames.
+        @see QueuedRenderableCollection::setRetainSortOrder
+        */
+        void setRetainSortOrder(bool enabled)
+        {
+            mRetainSortOrder = enabled;
+            for (auto & mPriorityGroup : mPriorityGroups)
+            {
+                mPriorityGroup.second->setRetainSortOrder(enabled);
+            }
+        }
+        /** Gets whether the depth sorted collections keep their order between frames. */
+        [[nodiscard]] auto getRetainSortOrder() const noexcept -> bool { return mRetainSortOrder; }
+
+        /** Gets the sorting / grouping modes requested with addOrganisationMode, none for the default. */
+        [[nodiscard]] auto getOrganisationMode() const noexcept -> QueuedRenderableCollection::OrganisationMode
+        { return mOrganisationMode; }
+
         /** Setthe  sorting / grouping mode for the solids in this group to the default.
         @remarks
             You can only do this when the group is empty, ie after clearing the 
@@ -620,6 +758,8 @@ namespace Ogre {
                         pDstPriorityGrp->resetOrganisationModes();
                         pDstPriorityGrp->addOrganisationMode(mOrganisationMode);
                     }
+                    pDstPriorityGrp->setSortKeyGrouping(mSortKeyGrouping);
+                    pDstPriorityGrp->setRetainSortOrder(mRetainSortOrder);
 
                     mPriorityGroups.emplace(priority, pDstPriorityGrp);
                 }
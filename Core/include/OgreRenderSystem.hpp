@@ -49,8 +49,10 @@ export import :StringVector;
 export import :Vector;
 
 export import <algorithm>;
+export import <filesystem>;
 export import <list>;
 export import <map>;
+export import <span>;
 export import <string>;
 export import <vector>;
 
@@ -300,6 +302,19 @@ class VertexDeclaration;
         */
         void useCustomRenderSystemCapabilities(RenderSystemCapabilities* capabilities);
 
+        /** Keeps the capabilities probed from the device in a file, to take them from there on later starts.
+        @remarks
+            The file is written on the first start and whenever it was written for another
+            device. On later starts it is only validated against the render system, vendor,
+            device and driver version, which are known before probing the capabilities. Must
+            be set before the render system is initialised. Off by default.
+        @par
+            Only render systems that support it read the file, currently GL.
+        */
+        void setCapabilitiesCacheFile(const std::filesystem::path& path) { mCapabilitiesCacheFile = path; }
+        /// The file set with setCapabilitiesCacheFile
+        auto getCapabilitiesCacheFile() const noexcept -> const std::filesystem::path& { return mCapabilitiesCacheFile; }
+
         /** Restart the renderer (normally following a change in settings).
         */
         void reinitialise();
@@ -457,10 +472,14 @@ class VertexDeclaration;
          reverse depth buffer so that the depth buffer precision is greater further away.
          This enables the OGRE_REVERSED_Z preprocessor define for shaders.
 
+         It is requested with the "Reversed Z-Buffer" config option of the render system, and
+         only enabled if the hardware supports it. The projection matrices and depth functions
+         of the materials stay as they are, the render system maps them.
+
          @retval true If reverse Z-buffer is enabled.
          @retval false If reverse Z-buffer is disabled (default).
 
-         @see setReverseDepthBuffer
+         @see setConfigOption
          */
         [[nodiscard]] auto isReverseDepthBufferEnabled() const noexcept -> bool;
 
@@ -704,6 +723,33 @@ class VertexDeclaration;
         /** Reports the number of vertices passed to the renderer since the last _beginGeometryCount call. */
         [[nodiscard]] virtual auto _getVertexCount() const -> unsigned int;
 
+        /** Counters of the work submitted to the RenderSystem in the current frame. */
+        struct RenderStats
+        {
+            /// Number of draw calls, counting every pass iteration
+            size_t drawCalls{0};
+            /// Number of texture units set up via _setTextureUnitSettings
+            size_t textureBinds{0};
+            /// Number of GPU programs bound
+            size_t programBinds{0};
+            /// Number of transfers into hardware buffers
+            size_t bufferUploads{0};
+            /// Number of bytes transferred into hardware buffers
+            size_t bytesUploaded{0};
+        };
+
+        /** Gets the counters of the current frame.
+        @remarks
+            Unlike the geometry counts, these are not reset per viewport but accumulated
+            until Root advances the frame number, like SceneManager::getRenderLoopStats.
+            Buffer uploads are only counted by render systems reporting them through
+            _notifyBufferUpload.
+        */
+        [[nodiscard]] auto getRenderStats() const noexcept -> const RenderStats& { return mRenderStats; }
+
+        /** Records a transfer into a hardware buffer in the frame statistics. */
+        void _notifyBufferUpload(size_t bytes);
+
         /** Converts a uniform projection matrix to suitable for this render system.
         @remarks
         Because different APIs have different requirements (some incompatible) for the
@@ -756,6 +802,20 @@ class VertexDeclaration;
         */
         virtual void _render(const RenderOperation& op);
 
+        /** Render several operations which share the render state with one another.
+        @remarks
+            Render systems with Capabilities::MULTI_DRAW submit operations which also
+            share the vertex data, the index buffer and the operation type with a single
+            draw call, counted as one batch. The default implementation calls _render for
+            each operation. Like _render, this can only be called between _beginScene and
+            _endScene.
+        @par
+            With Capabilities::MULTI_DRAW, the SceneManager passes the consecutive renderables
+            of a pass group sharing all state here, see SceneManager::findMultiDrawRun.
+        @param ops The operations, all drawn with the state set for the first one
+        */
+        virtual void _renderMultiple(std::span<const RenderOperation* const> ops);
+
         virtual void _dispatchCompute(const Vector3i& workgroupDim) {}
 
         /** Gets the capabilities of the render system. */
@@ -777,6 +837,14 @@ class VertexDeclaration;
         */
         [[nodiscard]] auto _getDefaultViewportMaterialScheme() const -> std::string_view ;
 
+        /** Prepares the combination of GPU programs used by a pass ahead of its first draw.
+        @remarks
+            Render systems which link the programs of a pass into one program object, like GL
+            with GLSL, link the combination here instead of when it is first bound, which
+            would cause a hitch. The programs must be loaded. The default does nothing.
+        */
+        virtual void _prelinkGpuPrograms(const Pass* pass) {}
+
         /** Binds a given GpuProgram (but not the parameters). 
         @remarks Only one GpuProgram of each type can be bound at once, binding another
         one will simply replace the existing one.
@@ -820,7 +888,11 @@ class VertexDeclaration;
         */
         void _notifyCameraRemoved(const Camera* cam);
 
-        /** Internal method for updating all render targets attached to this rendering system. */
+        /** Internal method for updating all render targets attached to this rendering system.
+        @remarks
+            The viewports of all targets are first handed to the SceneManagers culling them
+            at once, see SceneManager::setParallelViewportCulling.
+        */
         virtual void _updateAllRenderTargets(bool swapBuffers = true);
         /** Internal method for swapping all the buffers on all render targets,
         if _updateAllRenderTargets was called with a 'false' parameter. */
@@ -1022,6 +1094,36 @@ class VertexDeclaration;
         */
         virtual void unregisterThread() {}
 
+        /** Waits until the GPU completed the work issued by a registered thread.
+        @remarks
+            Resources created or filled on a background thread must not be used
+            by other threads before the GPU is done with them. DefaultWorkQueue calls
+            this on its workers after every request, before handing the response to
+            the main thread, so the main thread never has to wait. Does nothing when
+            called from a thread which is not registered.
+        @see RenderSystem::registerThread
+        */
+        virtual void _finishThreadWork() {}
+
+        /** Sets how many frames the CPU may queue up ahead of the GPU.
+        @remarks
+            Once the buffers are swapped, _swapAllRenderTargetBuffers waits until no more than
+            this many frames are pending on the GPU. Fewer frames in flight lower the latency
+            between input and display, at the price of the CPU idling while the GPU catches up.
+            The default of 0 leaves the queueing to the driver. Does nothing on RenderSystems
+            without frame fences.
+        */
+        void setMaxFramesInFlight(uint32 frames) { mMaxFramesInFlight = frames; }
+        /// Gets the number of frames the CPU may queue ahead, see setMaxFramesInFlight
+        [[nodiscard]] auto getMaxFramesInFlight() const noexcept -> uint32 { return mMaxFramesInFlight; }
+
+        /** Waits until no more than @p frames swapped frames are pending on the GPU.
+        @remarks
+            Calling this with 0 before sampling the input of a frame makes sure the input is
+            displayed by the very next frame. Does nothing on RenderSystems without frame fences.
+        */
+        virtual void _waitForFramesInFlight(uint32 frames) {}
+
         /**
         * This marks the beginning of an event for GPU profiling.
         */
@@ -1038,6 +1140,37 @@ class VertexDeclaration;
         */
         virtual void markProfileEvent( std::string_view event ) = 0;
 
+        /// GPU time taken by a profile event, see setProfileEventTiming
+        struct ProfileEventTiming
+        {
+            /// Name passed to beginProfileEvent
+            String name;
+            /// Number of enclosing profile events
+            uint32 depth;
+            /// GPU time between beginProfileEvent and endProfileEvent in nanoseconds
+            uint64 nanoseconds;
+        };
+        using ProfileEventTimings = std::vector<ProfileEventTiming>;
+
+        /** Sets whether profile events are timed on the GPU.
+        @remarks
+            When enabled and supported by the render system, beginProfileEvent and
+            endProfileEvent also record GPU timestamps. The GPU lags behind, so the
+            timings become available some frames later and are collected with
+            _getProfileEventTimings. Profiler::setGPUTiming manages this.
+        */
+        virtual void setProfileEventTiming(bool enabled) { mProfileEventTiming = enabled; }
+        /// Gets whether profile events are timed on the GPU, see setProfileEventTiming
+        [[nodiscard]] auto getProfileEventTiming() const noexcept -> bool { return mProfileEventTiming; }
+
+        /** Appends the timings of the profile events which completed on the GPU.
+        @remarks
+            Every event is reported once, in the order the events began, so an event
+            is always reported before the events nested in it. Render systems without
+            GPU timers report nothing.
+        */
+        virtual void _getProfileEventTimings(ProfileEventTimings& timings) {}
+
         /** Gets a custom (maybe platform-specific) attribute.
         @remarks This is a nasty way of satisfying any API's need to see platform-specific details.
         @param name The name of the attribute.
@@ -1090,11 +1223,25 @@ class VertexDeclaration;
         size_t mFaceCount{0};
         size_t mVertexCount{0};
 
+        RenderStats mRenderStats;
+        unsigned long mRenderStatsFrame{0};
+        /// Gets the counters, resetting them if a new frame has started
+        auto currentRenderStats() -> RenderStats&;
+
         /// Saved manual colour blends
         ColourValue mManualBlendColours[OGRE_MAX_TEXTURE_LAYERS][2];
 
         bool mInvertVertexWinding{false};
         bool mIsReverseDepthBufferEnabled{false};
+        bool mProfileEventTiming{false};
+        /// See setMaxFramesInFlight
+        uint32 mMaxFramesInFlight{0};
+
+        /// The viewports updated by _updateAllRenderTargets, in order
+        std::vector<Viewport*> mGatheredViewports;
+        std::vector<SceneManager*> mGatheredSceneManagers;
+        /// Lets the SceneManagers cull the cameras of all viewports before any is rendered
+        void gatherViewports();
 
         /// Texture units from this upwards are disabled
         size_t mDisabledTexUnitsFrom{0};
@@ -1150,6 +1297,16 @@ class VertexDeclaration;
         ::std::unique_ptr<RenderSystemCapabilities> mRealCapabilities{nullptr};
         RenderSystemCapabilities* mCurrentCapabilities{nullptr};
         bool mUseCustomCapabilities{false};
+        std::filesystem::path mCapabilitiesCacheFile;
+
+        /** The capabilities from the file set with setCapabilitiesCacheFile
+        @param vendor, deviceName, driverVersion What the cached capabilities must have been probed from
+        @return @c nullptr if there is no file or it is for another device or driver
+        */
+        auto loadCachedCapabilities(GPUVendor vendor, std::string_view deviceName,
+                                    const DriverVersion& driverVersion) const -> RenderSystemCapabilities*;
+        /// Writes capabilities to the file set with setCapabilitiesCacheFile, if any
+        void saveCachedCapabilities(const RenderSystemCapabilities* caps) const;
 
         /// @deprecated only needed for fixed function APIs
         virtual void setClipPlanesImpl(const PlaneList& clipPlanes) {}
@@ -184,6 +184,8 @@ namespace Ogre
         VERTEX_BUFFER_INSTANCE_DATA = OGRE_CAPS_VALUE(CapabilitiesCategory::COMMON_2, 16),
         /// Supports hardware tessellation hull programs
         TESSELLATION_HULL_PROGRAM = OGRE_CAPS_VALUE(CapabilitiesCategory::COMMON_2, 17),
+        /// Supports drawing several index ranges of the same vertex arrays in one call
+        MULTI_DRAW = OGRE_CAPS_VALUE(CapabilitiesCategory::COMMON_2, 18),
 
         // ***** DirectX specific caps *****
         /// Is DirectX feature "per stage constants" supported
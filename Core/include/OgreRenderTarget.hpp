@@ -38,6 +38,8 @@ export import :Platform;
 export import :Prerequisites;
 
 export import <algorithm>;
+export import <functional>;
+export import <future>;
 export import <map>;
 export import <vector>;
 
@@ -327,6 +329,34 @@ struct Box;
         */
         virtual void copyContentsToMemory(const Box& src, const PixelBox &dst, FrameBuffer buffer = FrameBuffer::AUTO) = 0;
 
+        /// Identifies a readback started with startContentsReadback
+        using ReadbackTicket = uint32;
+
+        /** Starts copying the current contents of the render target into memory.
+        @remarks
+            Unlike copyContentsToMemory, this does not have to wait for the GPU to finish
+            rendering. Complete the copy with finishContentsReadback, ideally after having
+            issued the next frame, so that reading back frame N overlaps rendering N+1.
+            Every started readback must be finished. The default implementation copies
+            synchronously into a temporary buffer.
+        @param src The region to read
+        @param format The format to read the data in, see suggestPixelFormat
+        @param buffer The buffer to read from
+        @return Ticket to pass to finishContentsReadback
+        */
+        virtual auto startContentsReadback(const Box& src, PixelFormat format, FrameBuffer buffer = FrameBuffer::AUTO)
+            -> ReadbackTicket;
+
+        /** Completes a readback started with startContentsReadback.
+        @remarks
+            Blocks if the GPU has not finished the copy yet.
+        @param ticket The ticket returned by startContentsReadback
+        @param dst Where to store the data, with the dimensions of the region read
+        @param bottomUp Store the rows bottom-up. This saves flipping them on render
+            systems which deliver them in this order, like GL.
+        */
+        virtual void finishContentsReadback(ReadbackTicket ticket, const PixelBox& dst, bool bottomUp = false);
+
         /** Suggests a pixel format to use for extracting the data in this target,
             when calling copyContentsToMemory.
         */
@@ -339,6 +369,44 @@ struct Box;
             @return the name of the file used.*/
         virtual auto writeContentsToTimestampedFile(std::string_view filenamePrefix, std::string_view filenameSuffix) -> String;
 
+        /// Receives the encoded contents of a capture, on the thread which encoded them
+        using CaptureCallback = std::function<void(const DataStreamPtr& encoded)>;
+
+        /** Encodes the current contents of the render target without stalling the frame.
+        @remarks
+            The contents are read back with startContentsReadback. The readback is finished in
+            the next update of this target, once the next frame has been issued, and the image
+            is encoded on the WorkQueue of Root, or right away if there is none. Call
+            flushCaptures before destroying the target to complete the pending captures.
+        @param format Extension of the codec to encode with, e.g. "png" or the faster "qoi",
+            or "raw" for the bare pixels in suggestPixelFormat, top row first
+        @param compressionLevel See Image::encode
+        @param callback Called with the encoded data once done
+        @return Future of the encoded data, holding the exception if the capture failed
+        */
+        auto encodeContentsAsync(std::string_view format, int compressionLevel = -1, CaptureCallback callback = {})
+            -> std::future<DataStreamPtr>;
+
+        /** Writes the current contents of the render target to the named file, like
+            writeContentsToFile, but without stalling the frame, see encodeContentsAsync.
+        @return Future of the encoded data, ready once the file has been written
+        */
+        auto writeContentsToFileAsync(std::string_view filename, int compressionLevel = -1)
+            -> std::future<DataStreamPtr>;
+
+        /** Writes the current contents of the render target to the (PREFIX)(time-stamp)(SUFFIX) file,
+            like writeContentsToTimestampedFile, but without stalling the frame, see encodeContentsAsync.
+        @return the name of the file used
+        */
+        auto writeContentsToTimestampedFileAsync(std::string_view filenamePrefix, std::string_view filenameSuffix,
+                                                 int compressionLevel = -1) -> String;
+
+        /** Finishes the readbacks of all pending captures, waiting for the GPU, and starts encoding them. */
+        void flushCaptures();
+
+        /// Gets the number of captures whose readback has not been finished yet
+        [[nodiscard]] auto getNumPendingCaptures() const noexcept -> size_t { return mPendingCaptures.size(); }
+
         [[nodiscard]] virtual auto requiresTextureFlipping() const -> bool = 0;
 
         /** Utility method to notify a render target that a camera has been removed,
@@ -481,6 +549,34 @@ struct Box;
 
         using RenderTargetListenerList = std::vector<RenderTargetListener *>;
         RenderTargetListenerList mListeners;
+
+        /// Data of a readback completed synchronously by the default startContentsReadback
+        struct PendingReadback
+        {
+            std::vector<uchar> data;
+            PixelBox box;
+        };
+        std::map<ReadbackTicket, PendingReadback> mPendingReadbacks;
+        ReadbackTicket mLastReadbackTicket{0};
+
+        /// A capture of encodeContentsAsync waiting for its readback
+        struct PendingCapture
+        {
+            ReadbackTicket ticket;
+            uint32 width;
+            uint32 height;
+            PixelFormat pixelFormat;
+            String format;
+            int compressionLevel;
+            CaptureCallback callback;
+            std::shared_ptr<std::promise<DataStreamPtr>> promise;
+        };
+        std::vector<PendingCapture> mPendingCaptures;
+
+        /// Finishes the readbacks of the first count pending captures and queues their encoding
+        void finishCaptures(size_t count);
+        /// Gets the name of a file with the current time stamp
+        auto getTimestampedFilename(std::string_view filenamePrefix, std::string_view filenameSuffix) const -> String;
     
 
         /// internal method for firing events
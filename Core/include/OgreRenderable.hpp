@@ -138,6 +138,12 @@ namespace Ogre {
         @note
             Internal Ogre never supports non-affine matrix for world transform matrix/matrices,
             the behavior is undefined if returns non-affine matrix here.
+        @par
+            With SceneManager::setParallelRenderPreparation this is called concurrently from the
+            WorkQueue threads for all renderables of a queued collection, which may share a node,
+            an entity or a skeleton. It must only read what the scene graph update and
+            MovableObject::_updateRenderQueue already derived, so do not evaluate bones, skeletons
+            or other caches lazily in here.
         */
         virtual void getWorldTransforms(Matrix4* xform) const = 0;
 
@@ -151,6 +157,14 @@ namespace Ogre {
         */
         [[nodiscard]] virtual auto getNumWorldTransforms() const noexcept -> unsigned short { return 1; }
 
+        /** Gets the node the world transforms are placed by, if any.
+        @remarks
+            Large world rendering takes the double precision position of the node to make the
+            world transforms relative to the camera, see SceneManager::setLargeWorldRendering.
+            Renderables without one are made relative in single precision.
+        */
+        [[nodiscard]] virtual auto getWorldTransformNode() const noexcept -> const Node* { return nullptr; }
+
         /** Sets whether or not to use an 'identity' projection.
         @remarks
             Usually Renderable objects will use a projection matrix as determined
@@ -167,6 +167,8 @@ class ResourceManager;
         bool mIsManual;
         /// The size of the resource in bytes
         size_t mSize;
+        /// Frame number of the last touch(), see Root::getNextFrameNumber
+        unsigned long mLastUsedFrame{0};
         /// Origin of this resource (e.g. script name) - optional
         String mOrigin;
         /// Optional manual loader; if provided, data is loaded from here instead of a file
@@ -322,6 +324,16 @@ class ResourceManager;
         */
         virtual void touch();
 
+        /** Gets the frame number in which this resource was last touched.
+        @remarks
+            Used by ResourceManager to page out the least recently used resources
+            first when over its memory budget.
+        */
+        auto getLastUsedFrame() const noexcept -> unsigned long { return mLastUsedFrame; }
+
+        /// @copydoc getLastUsedFrame
+        void _notifyUsed(unsigned long frame) { mLastUsedFrame = frame; }
+
         /** Gets resource name.
         */
         auto getName() const noexcept -> std::string_view { return mName; }
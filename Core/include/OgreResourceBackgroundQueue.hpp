@@ -35,6 +35,9 @@ export import :Resource;
 export import :Singleton;
 export import :WorkQueue;
 
+export import <any>;
+export import <deque>;
+export import <map>;
 export import <set>;
 
 export
@@ -79,6 +82,11 @@ namespace Ogre {
         performed, and once finished the ticket will be marked as complete. 
         You can check the status of tickets by calling isProcessComplete() 
         from your queueing thread. 
+    @par
+        To let urgent requests overtake others, limit the number of requests
+        handed to the WorkQueue at once with setMaxRequestsInFlight. The other
+        requests then wait here, ordered by their RequestPriority, and may be
+        cancelled with abortRequest before they start.
     */
     class ResourceBackgroundQueue : public Singleton<ResourceBackgroundQueue>, public ResourceAlloc, 
         public WorkQueue::RequestHandler, public WorkQueue::ResponseHandler
@@ -107,6 +115,23 @@ namespace Ogre {
 
         };
 
+        /** Scheduling parameters of a request.
+        @remarks
+            Of the requests waiting to be dispatched, those whose deadline has
+            been reached go first, earliest deadline first, then the others by
+            descending priority, then in the order they were queued. Frames are
+            counted by Root::getNextFrameNumber.
+        */
+        struct RequestPriority
+        {
+            /// Higher priorities are dispatched first, e.g. the negated distance to the camera
+            Real priority{0};
+            /// Frame by which the request should be dispatched, 0 for none
+            unsigned long deadline{0};
+            /// Frame after which the request is cancelled if it is still waiting, 0 for never
+            unsigned long expiry{0};
+        };
+
     private:
 
         uint16 mWorkQueueChannel{0};
@@ -114,7 +139,39 @@ namespace Ogre {
         using OutstandingRequestSet = std::set<BackgroundProcessTicket>;   
         OutstandingRequestSet mOutstandingRequestSet;
 
+        /// A request waiting to be dispatched
+        struct PendingRequest
+        {
+            RequestPriority priority;
+            /// The ResourceRequest
+            ::std::any request;
+        };
+        /// A finished request waiting for the completion budget
+        struct Completion
+        {
+            bool succeeded;
+            /// The ResourceResponse
+            ::std::any response;
+        };
+        /// Waiting requests by ticket, so in the order they were queued
+        std::map<BackgroundProcessTicket, PendingRequest> mPendingRequests;
+        /// Tickets of the requests in the WorkQueue by their request id
+        std::map<WorkQueue::RequestID, BackgroundProcessTicket> mDispatchedRequests;
+        std::deque<Completion> mCompletions;
+        BackgroundProcessTicket mNextTicket{0};
+        RequestPriority mRequestPriority;
+        size_t mMaxRequestsInFlight{0};
+        unsigned long mCompletionBudget{0};
+        unsigned long mBudgetFrame{0};
+        unsigned long mBudgetUsedMicros{0};
+
         auto addRequest(ResourceRequest& req) -> BackgroundProcessTicket;
+        /// Hands waiting requests to the WorkQueue while the in flight limit allows
+        void dispatchRequests();
+        /// Completes deferred requests within the budget of the current frame
+        void processCompletions();
+        /// Fires the listeners of a finished request
+        void completeRequest(const Completion& completion);
 
     public:
         ResourceBackgroundQueue();
@@ -273,9 +330,59 @@ namespace Ogre {
         virtual auto isProcessComplete(BackgroundProcessTicket ticket) -> bool;
 
         /** Aborts background process.
+        @remarks
+            Requests which are still waiting are dropped immediately, without
+            notifying their listener, and so are finished requests waiting for
+            the completion budget. The listener of a request being processed is
+            not notified either.
         */
         void abortRequest( BackgroundProcessTicket ticket );
 
+        /** Sets the priority of requests queued from now on.
+        @remarks
+            Only matters for requests which have to wait, see
+            setMaxRequestsInFlight.
+        */
+        void setRequestPriority(const RequestPriority& priority) { mRequestPriority = priority; }
+        /// Gets the priority of requests queued from now on
+        [[nodiscard]] auto getRequestPriority() const noexcept -> const RequestPriority& { return mRequestPriority; }
+
+        /** Changes the priority of a waiting request, e.g. as the camera moves.
+        @return false if the request is no longer waiting
+        */
+        auto updateRequestPriority(BackgroundProcessTicket ticket, const RequestPriority& priority) -> bool;
+
+        /** Sets how many requests are handed to the WorkQueue at once.
+        @remarks
+            Further requests wait in this class, where they are ordered by
+            priority and can still be cancelled. 0, the default, hands every
+            request over as it is queued.
+        */
+        void setMaxRequestsInFlight(size_t count);
+        /// Gets how many requests are handed to the WorkQueue at once, 0 for no limit
+        [[nodiscard]] auto getMaxRequestsInFlight() const noexcept -> size_t { return mMaxRequestsInFlight; }
+
+        /** Sets the main thread time per frame spent completing requests.
+        @remarks
+            Completing a request fires the Resource listeners and
+            Listener::operationCompleted. Once the budget of a frame is used up,
+            further requests are completed in later frames, at least one per frame.
+            0, the default, completes requests as their responses arrive.
+        @param ms The budget in milliseconds
+        */
+        void setCompletionBudget(unsigned long ms) { mCompletionBudget = ms; }
+        /// Gets the main thread time per frame spent completing requests
+        [[nodiscard]] auto getCompletionBudget() const noexcept -> unsigned long { return mCompletionBudget; }
+
+        /// Gets the number of requests waiting to be dispatched
+        [[nodiscard]] auto getNumPendingRequests() const noexcept -> size_t { return mPendingRequests.size(); }
+
+        /** Cancels expired requests, dispatches waiting ones and completes
+            deferred ones.
+        @note Called automatically by Root at the end of each frame.
+        */
+        void _update();
+
         /// Implementation for WorkQueue::RequestHandler
         auto canHandleRequest(const WorkQueue::Request* req, const WorkQueue* srcQ) -> bool override;
         /// Implementation for WorkQueue::RequestHandler
@@ -42,8 +42,10 @@ export import :SharedPtr;
 export import :Singleton;
 export import :StringVector;
 
+export import <atomic>;
 export import <list>;
 export import <map>;
+export import <mutex>;
 export import <string>;
 export import <utility>;
 export import <vector>;
@@ -285,8 +287,12 @@ namespace Ogre {
 
         ResourceLoadingListener *mLoadingListener{nullptr};
 
-        /// Resource index entry, resourcename->location 
-        using ResourceLocationIndex = std::map<std::string, Archive*, std::less<>>;
+        bool mParallelPreparation{false};
+        /// Whether _notifyResourceCreated only records the resource, see prepareResourcesParallel
+        std::atomic<bool> mDeferCreatedResources{false};
+        /// Resources created while preparing in parallel, added to their groups on the calling thread
+        mutable std::vector<ResourcePtr> mDeferredCreatedResources;
+        mutable std::mutex mDeferredCreatedResourcesMutex;
 
         /// List of resources which can be loaded / unloaded
         using LoadUnloadResourceList = std::list<ResourcePtr>;
@@ -307,8 +313,6 @@ namespace Ogre {
             Status groupStatus;
             /// List of possible locations to search
             LocationList locationList;
-            /// Index of resource names to locations, built for speedy access (case sensitive archives)
-            ResourceLocationIndex resourceIndexCaseSensitive;
 
             /// Pre-declared resources, ready to be created
             ResourceDeclarationList resourceDeclarations;
@@ -320,15 +324,79 @@ namespace Ogre {
             uint32 customStageCount;
             // in global pool flag - if true the resource will be loaded even a different   group was requested in the load method as a parameter.
             bool inGlobalPool;
-
-            void addToIndex(std::string_view filename, Archive* arch);
-            void removeFromIndex(std::string_view filename, Archive* arch);
-            void removeFromIndex(Archive* arch);
-
         };
         /// Map from resource group names to groups
         using ResourceGroupMap = std::map<std::string, ResourceGroup*, std::less<>>;
         ResourceGroupMap mResourceGroupMap;
+        /** Guards mResourceGroupMap and the loadResourceOrderMap of the groups, so resources
+            may be created and removed on several threads at once. Recursive, as creating the
+            declared resources of a group notifies about them while holding it.
+        */
+        mutable std::recursive_mutex mResourceGroupsMutex;
+
+        /** Open addressing hash table from resource names to the groups and
+            archives holding them.
+        @remarks
+            Shared by all groups, so finding a name in any group is a single
+            lookup. Within a group the location added first keeps the name.
+        */
+        class ResourceNameIndex
+        {
+        public:
+            struct Location
+            {
+                ResourceGroup* group;
+                Archive* archive;
+            };
+            using Locations = std::vector<Location>;
+
+            /// Adds a name, unless the group already has it
+            void add(std::string_view name, ResourceGroup* group, Archive* arch);
+            /// Removes a name of an archive in a group
+            void remove(std::string_view name, ResourceGroup* group, Archive* arch);
+            /// Removes all names of an archive in a group, or of the whole group if arch is @c nullptr
+            void remove(const ResourceGroup* group, const Archive* arch);
+            /// Gets the locations of a name, @c nullptr if there are none
+            [[nodiscard]] auto find(std::string_view name) const -> const Locations*;
+            /// Gets the archive holding a name in a group
+            [[nodiscard]] auto find(std::string_view name, const ResourceGroup* group) const -> Archive*;
+
+            /// Calls func(name, location) for every location of every name
+            template<typename Func> void forEach(Func func) const
+            {
+                for (auto const& slot : mSlots)
+                    for (auto const& location : slot.locations)
+                        func(std::string_view{slot.name}, location);
+            }
+
+        private:
+            /// An unused slot has no locations
+            struct Slot
+            {
+                std::string name;
+                uint32 hash{0};
+                Locations locations;
+            };
+            /// A power of two in size, at most half full
+            std::vector<Slot> mSlots;
+            size_t mSize{0};
+
+            /// Gets the slot holding the name, or the free slot ending its probe sequence
+            [[nodiscard]] auto findSlot(std::string_view name, uint32 hash) const -> size_t;
+            void grow();
+            void eraseSlot(size_t slot);
+        };
+        ResourceNameIndex mResourceIndex;
+
+        /// File list of a location, read by loadResourceIndex
+        struct CachedLocation
+        {
+            bool recursive;
+            int64 modifiedTime;
+            StringVector names;
+        };
+        /// Cached file lists by location type and name
+        std::map<std::string, CachedLocation, std::less<>> mCachedLocations;
 
         /// Group name for world resources
         String mWorldGroupName;
@@ -383,6 +451,15 @@ namespace Ogre {
         void fireResourceCreated(const ResourcePtr& resource) const;
         /// Internal event firing method
         void fireResourceRemove(const ResourcePtr& resource) const;
+        /** Prepares the resources of a group concurrently through WorkQueue::parallelFor.
+        @remarks
+            Resources are processed one loading order at a time, and resources created
+            by cascade-preparation are picked up in further batches. The groups are only
+            changed and resourceCreated is only fired on the calling thread, in between batches.
+        */
+        void prepareResourcesParallel(ResourceGroup* grp);
+        /// Adds the resources created during prepareResourcesParallel to their groups
+        void mergeDeferredCreatedResources();
         /** Internal modification time retrieval */
         auto resourceModifiedTime(ResourceGroup* group, std::string_view filename) const -> std::filesystem::file_time_type;
 
@@ -400,7 +477,7 @@ namespace Ogre {
             bool throwOnFailure = true) const -> DataStreamPtr;
 
         /// Stored current group - optimisation for when bulk loading a group
-        ResourceGroup* mCurrentGroup{nullptr};
+        std::atomic<ResourceGroup*> mCurrentGroup{nullptr};
     public:
         ResourceGroupManager();
         virtual ~ResourceGroupManager();
@@ -446,6 +523,7 @@ namespace Ogre {
             When this method is called, this class will callback any ResourceGroupListener
             which have been registered to update them on progress. 
         @param name The name of the resource group to prepare.
+        @see setParallelPreparation
         */
         void prepareResourceGroup(std::string_view name);
 
@@ -460,9 +538,29 @@ namespace Ogre {
             When this method is called, this class will callback any ResourceGroupListeners
             which have been registered to update them on progress. 
         @param name The name of the resource group to load.
+        @see setParallelPreparation
         */
         void loadResourceGroup(std::string_view name);
 
+        /** Sets whether prepareResourceGroup and loadResourceGroup prepare the resources
+            of the group concurrently.
+        @remarks
+            Preparing is mostly file I/O and decoding (e.g. Mesh parsing and Image::load),
+            so spreading it over the worker threads of the Root WorkQueue cuts down the
+            time a group takes to load considerably. loadResourceGroup then performs the
+            GPU side load of the already prepared resources serially on the calling thread.
+        @par
+            Resource types must support preparing on another thread, as is required for
+            background loading with ResourceBackgroundQueue anyway. Listeners are still
+            called on the calling thread and receive the same events, but the per resource
+            prepare events only follow once all resources have been prepared. Groups using
+            AUTODETECT_RESOURCE_GROUP_NAME are always prepared serially, as preparing
+            moves their resources to other groups.
+        */
+        void setParallelPreparation(bool parallel) { mParallelPreparation = parallel; }
+        /// Gets whether resource groups are prepared concurrently, see setParallelPreparation
+        [[nodiscard]] auto getParallelPreparation() const noexcept -> bool { return mParallelPreparation; }
+
         /** Unloads a resource group.
 
             This method unloads all the resources that have been declared as
@@ -538,6 +636,9 @@ namespace Ogre {
         /** Adds a location to the list of searchable locations for a
             Resource type.
 
+            Resources the archive declares up front, see
+            Archive::getResourceDeclarations, are declared in the group.
+
             @param
                 name The name of the location, e.g. './data' or
                 '/compressed/gamedata.zip'
@@ -564,6 +665,25 @@ namespace Ogre {
         /** Removes a resource location from the search path. */ 
         void removeResourceLocation(std::string_view name, 
             std::string_view resGroup = DEFAULT_RESOURCE_GROUP_NAME);
+
+        /** Saves the file lists of all resource locations.
+        @remarks
+            Pass the file to loadResourceIndex on later runs, so addResourceLocation
+            takes the names of unchanged archives from it instead of listing them.
+            An archive counts as unchanged while its type, the recursive option and
+            the modification time it reports for its root stay the same. For
+            FileSystem locations that is the time of the directory itself, which
+            does not change when files in sub directories are added or removed.
+        @param path The file to write
+        */
+        void saveResourceIndex(std::string_view path) const;
+        /** Loads file lists written by saveResourceIndex.
+        @remarks
+            Only affects resource locations added afterwards.
+        @param path The file to read
+        @return Whether the file could be read
+        */
+        auto loadResourceIndex(std::string_view path) -> bool;
         /** Verify if a resource location exists for the given group. */ 
         [[nodiscard]] auto resourceLocationExists(std::string_view name, 
             std::string_view resGroup = DEFAULT_RESOURCE_GROUP_NAME) const -> bool;
@@ -31,6 +31,7 @@ module;
 
 export module Ogre.Core:ResourceManager;
 
+export import :Async;
 export import :Common;
 export import :IteratorWrapper;
 export import :MemoryAllocatorConfig;
@@ -44,9 +45,12 @@ export import :StringVector;
 export import <atomic>;
 export import <list>;
 export import <map>;
+export import <mutex>;
+export import <shared_mutex>;
 export import <string>;
 export import <unordered_map>;
 export import <utility>;
+export import <vector>;
 
 export
 namespace Ogre {
@@ -102,6 +106,12 @@ namespace Ogre {
     *  @{
     */
     /** Defines a generic resource handler.
+    @remarks
+        The lookups by name and handle take a shared lock on the resource maps and the
+        creation, addition and removal of resources an exclusive one, so the SceneManagers
+        updated on different threads can look up and create resources at the same time.
+        createOrRetrieve is serialised, so concurrent calls for the same name return the
+        same resource. Loading goes through the atomic loading state of each resource.
     @see @ref Resource-Management
     */
     class ResourceManager : public ScriptLoader, public ResourceAlloc
@@ -153,6 +163,10 @@ namespace Ogre {
                 budget, it will temporarily unload a resource to make room for the new one. This unloading
                 is not permanent and the Resource is not destroyed; it simply needs to be reloaded when
                 next used.
+            @par
+                Resources are paged out least recently used first, see Resource::getLastUsedFrame.
+                Resources which were used in the current or the previous frame are kept, even if
+                that means staying over budget, as they would have to be reloaded right away.
         */
         void setMemoryBudget(size_t bytes);
 
@@ -383,6 +397,30 @@ namespace Ogre {
             ManualResourceLoader* loader = nullptr, const NameValuePairList* loadParams = nullptr,
             bool backgroundThread = false) -> ResourcePtr;
 
+        /** Loads a resource through the ResourceBackgroundQueue, for a coroutine to await.
+        @remarks
+            The coroutine continues on the main thread once the resource is loaded, see
+            ResourceRequestAwaiter:
+            @code
+            auto streamIn(CancellationToken token) -> Async<>
+            {
+                MeshPtr mesh = co_await MeshManager::getSingleton().loadAsync("knot.mesh", RGN_DEFAULT, token);
+                if (mesh)
+                    ...
+            }
+            @endcode
+        @param name The name of the %Resource
+        @param group The resource group to which this resource will belong
+        @param token Cancels the request, yielding @c nullptr
+        */
+        auto loadAsync(std::string_view name, std::string_view group, CancellationToken token = {})
+            -> ResourceAwaiter<Resource>;
+        /** Prepares a resource through the ResourceBackgroundQueue, for a coroutine to await.
+        @copydetails ResourceManager::loadAsync
+        */
+        auto prepareAsync(std::string_view name, std::string_view group, CancellationToken token = {})
+            -> ResourceAwaiter<Resource>;
+
         auto getScriptPatterns() const noexcept -> const StringVector& override { return mScriptPatterns; }
         void parseScript(DataStreamPtr& stream, std::string_view groupName) override;
         auto getLoadingOrder() const noexcept -> Real override { return mLoadOrder; }
@@ -463,6 +501,21 @@ namespace Ogre {
         */
         void checkUsage();
 
+        /** Copies the resources of the global pool which satisfy a predicate, under a shared lock.
+        @remarks
+            The predicate runs with the lock held, so it may compare use counts, but must not
+            call into this manager.
+        */
+        template <typename Predicate>
+        auto collectResources(Predicate predicate) const -> std::vector<ResourcePtr>
+        {
+            std::vector<ResourcePtr> result;
+            std::shared_lock lock{mResourcesMutex};
+            for (auto const& [key, res] : mResources)
+                if (predicate(res))
+                    result.push_back(res);
+            return result;
+        }
 
     public:
         using ResourceMap = std::unordered_map<std::string, ResourcePtr, StringHash, std::equal_to<>>;
@@ -472,6 +525,10 @@ namespace Ogre {
         ResourceHandleMap mResourcesByHandle;
         ResourceMap mResources;
         ResourceWithGroupMap mResourcesWithGroup;
+        /// Guards the three maps above
+        mutable std::shared_mutex mResourcesMutex;
+        /// Serialises createOrRetrieve, recursive as creating a resource may create others
+        std::recursive_mutex mCreateMutex;
         size_t mMemoryBudget; /// In bytes
         std::atomic<ResourceHandle> mNextHandle;
         std::atomic<size_t> mMemoryUsage; /// In bytes
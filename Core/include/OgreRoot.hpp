@@ -28,6 +28,7 @@ THE SOFTWARE.
 export module Ogre.Core:Root;
 
 export import :Common;
+export import :FrameAllocator;
 export import :IteratorWrapper;
 export import :MemoryAllocatorConfig;
 export import :Platform;
@@ -37,7 +38,9 @@ export import :SceneManagerEnumerator;
 export import :Singleton;
 
 export import <algorithm>;
+export import <array>;
 export import <deque>;
+export import <future>;
 export import <map>;
 export import <memory>;
 export import <set>;
@@ -64,7 +67,9 @@ class DynLib;
 class DynLibManager;
 class ExternalTextureSourceManager;
 class FrameListener;
+class FrameSimulation;
 class GpuProgramManager;
+class HitchMonitor;
 class LodStrategyManager;
 class LogManager;
 class MaterialManager;
@@ -82,7 +87,9 @@ class ResourceBackgroundQueue;
 class SceneManager;
 class SceneManagerFactory;
 class ScriptCompilerManager;
+class ShaderTelemetry;
 class SkeletonManager;
+class StartupProfiler;
 class TextureManager;
 class Timer;
 class WorkQueue;
@@ -123,6 +130,7 @@ struct SceneManagerMetaData;
         bool mFirstTimePostWindowInit;
 
         // ordered in reverse destruction sequence
+        std::unique_ptr<StartupProfiler> mStartupProfiler;
         std::unique_ptr<LogManager> mLogManager;
 
         std::unique_ptr<ScriptCompilerManager> mCompilerManager;
@@ -137,6 +145,7 @@ struct SceneManagerMetaData;
         std::unique_ptr<MeshManager> mMeshManager;
         std::unique_ptr<SkeletonManager> mSkeletonManager;
 
+        std::unique_ptr<ArchiveFactory> mBundleArchiveFactory;
         std::unique_ptr<ArchiveFactory> mFileSystemArchiveFactory;
         std::unique_ptr<ArchiveFactory> mEmbeddedZipArchiveFactory;
         std::unique_ptr<ArchiveFactory> mZipArchiveFactory;
@@ -155,6 +164,8 @@ struct SceneManagerMetaData;
         std::unique_ptr<ParticleSystemManager> mParticleManager;
         std::unique_ptr<LodStrategyManager> mLodStrategyManager;
         std::unique_ptr<Profiler> mProfiler;
+        std::unique_ptr<HitchMonitor> mHitchMonitor;
+        std::unique_ptr<ShaderTelemetry> mShaderTelemetry;
 
         std::unique_ptr<ExternalTextureSourceManager> mExternalTextureSourceManager;
         std::unique_ptr<CompositorManager> mCompositorManager;
@@ -168,6 +179,12 @@ struct SceneManagerMetaData;
         RenderWindow* mAutoWindow;
 
         unsigned long mNextFrame{0};
+        /// Time the current frame was started at, for the Frame/cpuMicroseconds counter
+        uint64 mFrameStartMicroseconds{0};
+        /// MemoryTracker statistics at the last publishRenderStats, for the per frame counters
+        std::array<MemoryTracker::Stats, size_t(MemoryCategory::COUNT)> mLastMemoryStats;
+        /// Scratch memory of the current frame, reset in _fireFrameStarted
+        FrameAllocator mFrameAllocator;
         Real mFrameSmoothingTime{0.0f};
         bool mRemoveQueueStructuresOnClear{false};
         Real mDefaultMinPixelSize{0};
@@ -211,6 +228,9 @@ struct SceneManagerMetaData;
         /// Internal method for one-time tasks after first window creation
         void oneTimePostWindowInit();
 
+        /// Passes the statistics of the frame just rendered to the Profiler, if enabled
+        void publishRenderStats();
+
         /** Set of registered frame listeners */
         std::set<FrameListener*> mFrameListeners;
 
@@ -219,6 +239,10 @@ struct SceneManagerMetaData;
         std::set<FrameListener*> mAddedFrameListeners;
         void _syncAddedRemovedFrameListeners();
 
+        FrameSimulation* mFrameSimulation{nullptr};
+        /// The simulate() call running alongside the current frame
+        std::future<void> mPendingSimulation;
+
         /** Indicates the type of event to be considered by calculateEventTime(). */
         enum class FrameEventTimeType {
             ANY = 0,
@@ -477,6 +501,18 @@ struct SceneManagerMetaData;
         */
         void removeFrameListener(FrameListener* oldListener);
 
+        /** Sets a simulation to run in parallel with the rendering, see FrameSimulation
+            @remarks
+                This pipelines the frames: while frame N is culled and submitted to the GPU,
+                a separate thread computes the state frame N + 1 will show. A pending step
+                of the previous simulation is waited for, but not applied.
+            @param simulation The simulation, @c nullptr to render without one. It must
+                stay alive until it was replaced or Root was shut down.
+        */
+        void setFrameSimulation(FrameSimulation* simulation);
+        /** Gets the simulation running in parallel with the rendering */
+        [[nodiscard]] auto getFrameSimulation() const noexcept -> FrameSimulation* { return mFrameSimulation; }
+
         /** Queues the end of rendering.
             @remarks
                 This method will do nothing unless startRendering() has
@@ -909,6 +945,14 @@ struct SceneManagerMetaData;
         */
         [[nodiscard]] auto getWorkQueue() const noexcept -> WorkQueue* { return mWorkQueue.get(); }
 
+        /** Gets the scratch memory for data that does not outlive the current frame.
+        @remarks
+            Everything allocated from it is released at once when the next frame starts,
+            after the FrameSimulation of this frame completed, see FrameAllocator.
+            Use it through FrameVector, FrameMap and FrameString.
+        */
+        auto getFrameAllocator() noexcept -> FrameAllocator* { return &mFrameAllocator; }
+
         /** Replace the current work queue with an alternative. 
             You can use this method to replace the internal implementation of
             WorkQueue with  your own, e.g. to externalise the processing of 
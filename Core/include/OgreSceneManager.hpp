@@ -36,18 +36,24 @@ export module Ogre.Core:SceneManager;
 export import :AnimationState;
 export import :AutoParamDataSource;
 export import :AxisAlignedBox;
+export import :BlendMode;
 export import :ColourValue;
 export import :Common;
 export import :DepthBuffer;
+export import :Exception;
 export import :InstanceManager;
 export import :IteratorWrapper;
 export import :Light;
+export import :LightGrid;
 export import :LodListener;
 export import :ManualObject;
 export import :Matrix4;
 export import :MemoryAllocatorConfig;
 export import :NameGenerator;
 export import :Node;
+export import :NodeTransformSoA;
+export import :OcclusionCulling;
+export import :Pass;
 export import :PixelFormat;
 export import :Plane;
 export import :PlaneBoundedVolume;
@@ -61,17 +67,24 @@ export import :ResourceGroupManager;
 export import :SceneQuery;
 export import :ShadowCaster;
 export import :SharedPtr;
+export import :SkeletonPoseCache;
+export import :String;
 export import :StringVector;
 export import :TextureUnitState;
 export import :Vector;
+export import :VisibilityStage;
 
 export import <algorithm>;
 export import <array>;
 export import <map>;
 export import <memory>;
+export import <mutex>;
 export import <set>;
+export import <span>;
 export import <string>;
 export import <string_view>;
+export import <unordered_map>;
+export import <utility>;
 export import <vector>;
 
 export
@@ -157,6 +170,8 @@ namespace Ogre {
         void reset();
         void merge(const AxisAlignedBox& boxBounds, const Sphere& sphereBounds, 
             const Camera* cam, bool receiver=true);
+        /** Merge the bounds gathered separately, e.g. on another thread. */
+        void merge(const VisibleObjectsBoundsInfo& rhs);
         /** Merge an object that is not being rendered because it's not a shadow caster, 
             but is a shadow receiver so should be included in the range.
         */
@@ -273,7 +288,18 @@ namespace Ogre {
         Multiple SceneManager instances can exist at one time, each one with 
         a distinct scene. Which SceneManager is used to render a scene is
         dependent on the Camera, which will always call back the SceneManager
-        which created it to render the scene. 
+        which created it to render the scene.
+
+        Distinct SceneManagers share no mutable state in their updates: the scratch
+        space of the light lists and the queue sorting is per thread, the queued node
+        updates are per SceneManager, the dirty pass hashes are locked, the resource
+        managers take a readers/writer lock and the ResourceGroupManager locks its
+        groups and their resource lists, so e.g. the scene graphs, animations and scene
+        queries of several scenes can be updated, and resources created, on different
+        threads at once. A single SceneManager is not thread safe, the operations on
+        a whole resource group such as loading or clearing it must not run concurrently
+        with the creation of resources in it, and rendering, which goes through the one
+        RenderSystem, as well as Root::renderOneFrame stay on the render thread.
      */
     class SceneManager : public SceneMgtAlloc
     {
@@ -396,6 +422,15 @@ namespace Ogre {
                         { (void)source; }
         };
 
+        /// World transforms of a queued renderable resolved ahead of rendering, see setParallelRenderPreparation
+        struct PreparedRenderable
+        {
+            const Renderable* renderable;
+            /// Index of the first transform in mPreparedMatrices
+            uint32 firstMatrix;
+            uint16 numMatrices;
+        };
+
         /** Inner helper class to implement the visitor pattern for rendering objects
             in a queue. 
         */
@@ -421,6 +456,10 @@ namespace Ogre {
             const LightList* manualLightList;
             /// Scissoring if requested?
             bool scissoring;
+            /// Prepared renderables of the collection being rendered in visiting order, if any
+            const PreparedRenderable* prepared{nullptr};
+            /// Position of the next renderable visited in prepared
+            size_t preparedCursor{0};
 
             /** Render a set of objects
 
@@ -434,10 +473,13 @@ namespace Ogre {
         };
         /// Allow visitor helper to access protected methods
         friend class SceneMgrQueuedRenderableVisitor;
+        /// Reads the static geometry and instance managers and reserves the node list
+        friend class SceneSerializer;
 
-        using CameraList = std::map<std::string, Camera*, std::less<>>;
+        /// Hashed by name, so these are iterated in no particular order
+        using CameraList = std::unordered_map<std::string, Camera*, StringHash, std::equal_to<>>;
         using AnimationList = std::map<std::string_view, Animation *>;
-        using MovableObjectMap = std::map<std::string, MovableObject*, std::less<>>;
+        using MovableObjectMap = std::unordered_map<std::string, MovableObject*, StringHash, std::equal_to<>>;
     protected:
 
         /// Subclasses can override this to ensure their specialised SceneNode is used.
@@ -448,6 +490,9 @@ namespace Ogre {
         /// Instance name
         String mName;
 
+        /// Declared before any node, so it outlives them
+        Node::QueuedUpdates mQueuedNodeUpdates;
+
         /// Queue of objects for rendering
         std::unique_ptr<RenderQueue> mRenderQueue;
 
@@ -477,7 +522,7 @@ namespace Ogre {
         SceneNodeList mSceneNodes;
 
         /// additional map to speed up lookup by name
-        std::map<std::string_view, SceneNode*> mNamedNodes;
+        std::unordered_map<std::string_view, SceneNode*> mNamedNodes;
 
         /// Camera in progress
         Camera* mCameraInProgress{nullptr};
@@ -586,6 +631,19 @@ namespace Ogre {
         bool mFlipCullingOnNegativeScale{true};
         CullingMode mPassCullingMode;
 
+        /// What the render system was last set to by _setPass, see setPassStateFiltering
+        Pass::CompiledState mLastPassState;
+        /// Whether mLastPassState matches the render system
+        bool mLastPassStateValid{false};
+        bool mPassStateFiltering{false};
+
+        /// See setDepthPrePass
+        bool mDepthPrePass{false};
+        /// Whether the solids of a group are rendered after its depth pre-pass
+        bool mDepthPrePassActive{false};
+        /// The passes of the group whose depth the pre-pass wrote for all their renderables
+        std::set<const Pass*> mDepthPrePassPasses;
+
     protected:
 
         /** Visible objects bounding box list.
@@ -616,13 +674,18 @@ namespace Ogre {
         LightInfoList mCachedLightInfos;
         LightInfoList mTestLightInfos; // potentially new list
         ulong mLightsDirtyCounter{0};
+        /// Spatial index of mLightsAffectingFrustum for _populateLightList
+        LightGrid mLightGrid;
+        /// mLightsDirtyCounter and frame number when mLightGrid was built
+        ulong mLightGridDirtyCounter{0};
+        unsigned long mLightGridFrame{0};
 
         /// Simple structure to hold MovableObject map and a mutex to go with it.
         struct MovableObjectCollection
         {
                     MovableObjectMap map;
         };
-        using MovableObjectCollectionMap = std::map<std::string_view, ::std::unique_ptr<MovableObjectCollection>>;
+        using MovableObjectCollectionMap = std::unordered_map<std::string_view, ::std::unique_ptr<MovableObjectCollection>>;
         MovableObjectCollectionMap mMovableObjectCollectionMap;
         NameGenerator mMovableNameGenerator;
         /** Gets the movable object collection for the given type name.
@@ -687,7 +750,10 @@ namespace Ogre {
 
             Rectangle2D* mFullScreenQuad{nullptr};
 
+            /// The texture sampled for each shadow texture index, see ShadowCameraSetup::getAtlasTileCount
             ShadowTextureList mShadowTextures;
+            /// The textures created for each shadow texture index
+            ShadowTextureList mOwnShadowTextures;
 
             bool mShadowAdditiveLightClip{false};
             bool mDebugShadows{false};
@@ -706,6 +772,14 @@ namespace Ogre {
 
             ShadowTextureConfigList mShadowTextureConfigList;
 
+            /// See SceneManager::setShadowTextureCompositor
+            String mShadowTextureCompositor;
+            /// Adds mShadowTextureCompositor to a viewport of a shadow texture, unless already there
+            void addShadowTextureCompositor(Viewport* vp);
+            /// Removes mShadowTextureCompositor from all viewports of the shadow textures
+            void removeShadowTextureCompositor();
+            void setShadowTextureCompositor(std::string_view name);
+
             /// Array defining shadow count per light type.
             size_t mShadowTextureCountPerType[3];
 
@@ -717,6 +791,120 @@ namespace Ogre {
             /// Internal method for creating shadow textures (texture-based shadows)
             void ensureShadowTexturesCreated();
             void prepareShadowTextures(Camera* cam, Viewport* vp, const LightList* lightList);
+            /** Lays out the viewports of a shadow texture as a grid of tiles, 1 for a single
+                viewport covering it, and returns the viewport of each tile */
+            auto setShadowTextureTiles(RenderTarget* target, size_t tiles) -> const std::vector<Viewport*>&;
+            /// As above, with the left, top, width and height of each tile
+            auto setShadowTextureTiles(RenderTarget* target, std::span<const Vector4> tiles)
+                -> const std::vector<Viewport*>&;
+            /// Left, top, width and height of the viewport of the camera of a shadow texture index
+            [[nodiscard]] auto getShadowTextureTile(size_t shadowIndex) const -> Vector4;
+            /// Viewports and rectangles of the last setShadowTextureTiles call, kept to avoid reallocation
+            std::vector<Viewport*> mShadowTextureTileViewports;
+            std::vector<Vector4> mShadowTileRects;
+
+            /// How a tile of a shadow texture is rendered by updateShadowTexture
+            enum class ShadowTileUpdate
+            {
+                /// keep the contents and the camera of the last update
+                SKIP,
+                /// all casters, without caching
+                FULL,
+                /// the static casters into the cached layer, then the other casters on top
+                STATIC,
+                /// the cached layer, then the other casters on top
+                DYNAMIC
+            };
+            /// What was rendered into a shadow texture index, see SceneManager::setShadowStaticCasterMask
+            struct ShadowTextureCache
+            {
+                const Light* light{nullptr};
+                const Camera* camera{nullptr};
+                Affine3 view;
+                Matrix4 projection;
+                Vector4 tile;
+                ulong revision{0};
+                unsigned long updateFrame{0};
+                bool staticLayerValid{false};
+                /// The static casters of the texture of this index, valid at the first index of an atlas
+                TexturePtr staticLayer;
+            };
+            std::vector<ShadowTextureCache> mShadowTextureCaches;
+            QueryTypeMask mShadowStaticCasterMask{};
+            ulong mShadowCacheRevision{0};
+            /// Whether casters are blended with MIN, i.e. rendered on top of a cached layer
+            bool mShadowCasterMinBlend{false};
+            /// Culls the casters of a light which can't shadow the view, see SceneManager::setShadowCasterCulling
+            struct ShadowCasterCulling
+            {
+                const Camera* camera{nullptr};
+                bool lightInFrustum{false};
+                PlaneBoundedVolumeList frustumVolumes;
+                /// Visible receivers extruded towards the light, no planes if unknown
+                PlaneBoundedVolume receiverVolume;
+
+                /// Prepares the culling for the shadows of light in the view of cam
+                void prepare(const SceneManager* sm, const Light* light, const Camera* cam, bool byReceivers);
+                /// Tests whether anything within bounds can cast a shadow into the view
+                [[nodiscard]] auto isVisible(const AxisAlignedBox& bounds) const -> bool;
+            };
+            bool mShadowCasterCulling{false};
+            bool mShadowCasterCullingByReceivers{true};
+            /// One per light of the current update, reserved so that the tiles can point to them
+            std::vector<ShadowCasterCulling> mCasterCullings;
+            /// The culling of the tile being culled on this thread, if any
+            static thread_local const ShadowCasterCulling* msActiveCasterCulling;
+
+            /// A tile passed to updateShadowTexture
+            struct ShadowTile
+            {
+                Viewport* view{nullptr};
+                ShadowTileUpdate update{ShadowTileUpdate::SKIP};
+                /// The visibility mask of all casters of the light
+                QueryTypeMask casterMask{};
+                const ShadowCasterCulling* culling{nullptr};
+            };
+            std::vector<ShadowTile> mShadowTiles;
+            /// The tiles of a shadow texture within mShadowTiles, when all are rendered after culling them at once
+            struct ShadowTextureTiles
+            {
+                TexturePtr texture;
+                size_t first;
+                size_t tileStart;
+                size_t tileCount;
+            };
+            std::vector<ShadowTextureTiles> mShadowTextureTiles;
+            /** Culls the full tiles of mShadowTiles and the camera cam at once,
+                see SceneManager::setParallelShadowTextureCulling */
+            void gatherShadowTiles(Camera* cam, Viewport* vp);
+
+            /** Sets up the camera of a shadow texture index for an iteration of light, and
+                returns how its tile needs to be rendered */
+            auto prepareShadowTile(Camera* cam, Viewport* vp, Light* light, ShadowCameraSetup* cameraSetup,
+                size_t shadowIndex, size_t iteration, Viewport* shadowView, unsigned long frame) -> ShadowTileUpdate;
+            /** Renders the tiles of a shadow texture, the first of them being the
+                shadow texture index first */
+            void updateShadowTexture(const TexturePtr& shadowTex, size_t first, std::span<const ShadowTile> tiles);
+
+            /// See SceneManager::setShadowAtlas
+            bool mShadowAtlas{false};
+            uint16 mShadowAtlasMinTileSize{64};
+            /// Shadow texture index and priority of a light iteration in the atlas
+            struct ShadowAtlasTile
+            {
+                Light* light;
+                size_t iteration;
+                size_t index;
+                Real priority;
+                uint8 level{0};
+            };
+            std::vector<ShadowAtlasTile> mShadowAtlasTiles;
+            /// Packs and renders the shadows of all lights into shadow texture 0
+            void prepareShadowAtlas(Camera* cam, Viewport* vp, const LightList* lightList, unsigned long frame);
+            /** Places the tiles of mShadowAtlasTiles, 1/2^level of the atlas wide, into mShadowTileRects
+                along a Z-order curve, largest first, so that tiles of at most maxLevel which fit
+                into the atlas by area never overlap */
+            void packShadowAtlas(uint8 maxLevel);
             /// Internal method for destroying shadow textures (texture-based shadows)
             void destroyShadowTextures();
 
@@ -1010,6 +1198,8 @@ namespace Ogre {
         using InstanceManagerVec = std::vector<InstanceManager *>;
         InstanceManagerVec mDirtyInstanceManagers;
         InstanceManagerVec mDirtyInstanceMgrsTmp;
+        /// InstancedEntities may report dirty batches from a parallel scene graph update
+        std::mutex mDirtyInstanceManagersMutex;
 
         /** Updates all instance managaers with dirty instance batches. @see _addDirtyInstanceManager */
         void updateDirtyInstanceManagers();
@@ -1044,6 +1234,22 @@ namespace Ogre {
         void renderBasicQueueGroupObjects(RenderQueueGroup* pGroup,
             QueuedRenderableCollection::OrganisationMode om);
 
+        /** Render the depth of the opaque objects of a group, see setDepthPrePass
+        @remarks
+            Sorts the priority groups of the group, and records the passes whose depth was
+            written in mDepthPrePassPasses.
+        */
+        void renderDepthPrePass(RenderQueueGroup* pGroup, QueuedRenderableCollection::OrganisationMode om);
+
+        /** Whether the depth only pass of the pre-pass writes the same depth as this pass */
+        static auto isDepthPrePassCompatible(const Pass* pass) -> bool;
+
+        /** Whether the depth only pass of the pre-pass places the renderable as its own programs do */
+        static auto isDepthPrePassCompatible(Renderable* rend) -> bool;
+
+        /** Sorts a priority group for the camera in progress, timing it for the RenderLoopStats */
+        void sortPriorityGroup(RenderPriorityGroup* group);
+
         /** Update the state of the global render queue splitting based on a shadow
         option change. */
         void updateRenderQueueSplitOptions();
@@ -1070,6 +1276,7 @@ namespace Ogre {
 
         /// Whether to use camera-relative rendering
         bool mCameraRelativeRendering{false};
+        bool mLargeWorldRendering{false};
         Affine3 mCachedViewMatrix;
 
         /// Last light sets
@@ -1186,7 +1393,30 @@ namespace Ogre {
         */
         auto getCameraRelativeRendering() const noexcept -> bool { return mCameraRelativeRendering; }
 
-        /** Returns a const version of the camera list.
+        /** Set whether camera-relative rendering uses the double precision positions of the nodes.
+        @remarks
+            Instead of the OGRE_DOUBLE_PRECISION build noted at setCameraRelativeRendering,
+            place the objects far from the origin with Node::setPositionDouble. The world
+            matrices are then made relative to the camera from the double precision positions of
+            their nodes and the camera, see Node::_getDerivedPositionDouble, and only rounded to
+            single precision once small. With setParallelRenderPreparation, that is done in bulk
+            when preparing the render queue. Bounds, culling and lights stay single precision,
+            which does not show as jitter. Renderables placed by a node, see
+            Renderable::getWorldTransformNode, are made relative so; others as before.
+        @par
+            Enabling it enables camera-relative rendering. Disabled by default.
+        */
+        void setLargeWorldRendering(bool enabled)
+        {
+            mLargeWorldRendering = enabled;
+            if (enabled)
+                mCameraRelativeRendering = true;
+        }
+
+        /** Get whether camera-relative rendering uses the double precision positions of the nodes. */
+        auto getLargeWorldRendering() const noexcept -> bool { return mLargeWorldRendering; }
+
+        /** Returns a const version of the camera list, in no particular order.
         */
         auto getCameras() const noexcept -> const CameraList& { return mCameras; }
         /// @}
@@ -1292,6 +1522,10 @@ namespace Ogre {
             The number of items in the list may exceed the maximum number of lights supported
             by the renderer, but the extraneous ones will never be used. In fact the limit will
             be imposed by Pass::getMaxSimultaneousLights.
+        @par
+            With many lights affecting the frustum, the candidates are looked up in a LightGrid
+            built from that list once per frame, or when it changes, rather than testing every
+            light. The result is the same.
         @param position The position at which to evaluate the list of lights
         @param radius The bounding radius to test
         @param destList List to be populated with ordered set of lights; will be cleared by
@@ -1419,6 +1653,24 @@ namespace Ogre {
         */
         auto createEntity(std::string_view entityName, const MeshPtr& pMesh ) -> Entity*;
 
+        /** Create an Entity without waiting for its mesh to load.
+            @remarks
+                If the Mesh is not loaded yet it is marked as background loaded and queued through
+                ResourceBackgroundQueue::load, and the Entity is returned at once, uninitialised.
+                Until the Mesh is loaded the Entity draws nothing and uses the proxy bounds, see
+                Entity::setProxyBounds. Once loaded, the geometry, skeleton and animation states
+                are built on the main thread by Entity::loadingComplete and the bounds of its node
+                are updated. Methods needing the Mesh, e.g. getSubEntity or getAnimationState,
+                have to wait for Entity::isInitialised.
+            @param entityName The name to be given to the entity (must be unique).
+            @param meshName The name of the Mesh it is to be based on.
+            @param groupName The resource name where the mesh lives
+            @param proxyBounds The bounds used until the Mesh is loaded, none by default
+        */
+        auto createEntityInBackground(std::string_view entityName, std::string_view meshName,
+                                      std::string_view groupName = ResourceGroupManager::AUTODETECT_RESOURCE_GROUP_NAME,
+                                      const AxisAlignedBox& proxyBounds = AxisAlignedBox::BOX_NULL) -> Entity*;
+
         /** Create an Entity (instance of a discrete mesh) with an autogenerated name.
             @param
                 meshName The name of the Mesh it is to be based on (e.g. 'knot.oof'). The
@@ -1804,6 +2056,11 @@ namespace Ogre {
         */
         virtual void _updateSceneGraph(Camera* cam);
 
+        /** The queued needUpdate calls of the nodes of this scene, @see Node::queueNeedUpdate.
+            They are processed by _updateSceneGraph.
+        */
+        auto _getQueuedNodeUpdates() noexcept -> Node::QueuedUpdates* { return &mQueuedNodeUpdates; }
+
         /** Internal method which parses the scene to find visible objects to render.
             @remarks
                 If you're implementing a custom scene manager, this is the most important method to
@@ -1817,6 +2074,14 @@ namespace Ogre {
         */
         virtual void _findVisibleObjects(Camera* cam, VisibleObjectsBoundsInfo* visibleBounds, bool onlyShadowCasters);
 
+        /** Internal method which queues the objects visible to a camera for rendering to a viewport.
+            @remarks
+                Called by _renderScene. Reuses the objects already found for this camera and
+                viewport settings in the frame, see setReuseVisibleObjects, or else those culled in
+                advance, see setParallelViewportCulling, before parsing the scene with _findVisibleObjects.
+        */
+        void _queueVisibleObjects(Camera* camera, Viewport* vp, VisibleObjectsBoundsInfo* visibleBounds);
+
         /** Internal method for issuing the render operation.*/
         void _issueRenderOp(Renderable* rend, const Pass* pass);
 
@@ -2517,6 +2782,18 @@ namespace Ogre {
         virtual auto
             createRayQuery(const Ray& ray, QueryTypeMask mask = QueryTypeMask{0xFFFFFFFF}) -> ::std::unique_ptr<RaySceneQuery>;
 
+        /** Creates a RayBatchSceneQuery for this scene manager.
+        @remarks
+            This method creates a new instance of a query object for this scene manager,
+            looking for objects which fall along any of several rays, in a single pass
+            over the scene. See SceneQuery and RayBatchSceneQuery for full details.
+        @param rays The rays to test, results are reported per ray index.
+        @param mask The query mask to apply to this query; can be used to filter out
+            certain objects; see SceneQuery for details.
+        */
+        virtual auto
+            createRayBatchQuery(const std::vector<Ray>& rays, QueryTypeMask mask = QueryTypeMask{0xFFFFFFFF}) -> ::std::unique_ptr<RayBatchSceneQuery>;
+
         /** Creates an IntersectionSceneQuery for this scene manager. 
         @remarks
             This method creates a new instance of a query object for locating
@@ -2826,6 +3103,78 @@ namespace Ogre {
         auto getShadowTextureCountPerLightType(Light::LightTypes type) const -> size_t
         {return mShadowRenderer.mShadowTextureCountPerType[std::to_underlying(type)]; }
 
+        /** Sets the visibility flags of static shadow casters, which enables caching of texture shadows.
+        @remarks
+            Objects with any of these flags (see MovableObject::setVisibilityFlags) are rendered
+            into a cached layer per shadow texture, which is only rendered again when the shadow
+            camera changes, i.e. the light or the area covered by the texture moved, or after
+            invalidateShadowCache. Every update copies the cached layer into the shadow texture
+            and renders just the other casters on top of it. Colour shadow textures are blended
+            with MIN, so they have to hold shadow colour on white or depth, and the textures have
+            to support HardwarePixelBuffer::blit. The default, 0, disables caching.
+        @note
+            Static casters are not tracked, call invalidateShadowCache after moving, adding or
+            removing any. Shadow textures shared with other scene managers, see
+            setShadowTextureConfig, must not be cached.
+        */
+        void setShadowStaticCasterMask(QueryTypeMask mask)
+        {
+            mShadowRenderer.mShadowStaticCasterMask = mask;
+            invalidateShadowCache();
+        }
+        [[nodiscard]] auto getShadowStaticCasterMask() const noexcept -> QueryTypeMask
+        { return mShadowRenderer.mShadowStaticCasterMask; }
+        /// Renders the static casters of all shadow textures again, see setShadowStaticCasterMask
+        void invalidateShadowCache() { ++mShadowRenderer.mShadowCacheRevision; }
+
+        /** Sets whether texture shadows are rendered with only the casters which can shadow the view.
+        @remarks
+            Shadow textures are rendered with the casters in the frustum of their shadow camera,
+            many of which may not shadow anything the camera sees. With culling, casters are skipped
+            unless their bounds intersect the view frustum extruded away from the light, see
+            Light::_getFrustumClipVolumes, and with byReceivers also the bounds of the visible
+            shadow receivers extruded towards the light. The test applies to the bounds of whole
+            scene node subtrees and of octants of the OctreeSceneManager, so most casters far off
+            screen are dropped at once. Off by default.
+        @note
+            The receiver bounds are those of the last frame the camera was rendered in, so receivers
+            coming into view are only shadowed from the next frame on.
+        */
+        void setShadowCasterCulling(bool enabled, bool byReceivers = true)
+        {
+            mShadowRenderer.mShadowCasterCulling = enabled;
+            mShadowRenderer.mShadowCasterCullingByReceivers = byReceivers;
+        }
+        [[nodiscard]] auto getShadowCasterCulling() const noexcept -> bool { return mShadowRenderer.mShadowCasterCulling; }
+        [[nodiscard]] auto getShadowCasterCullingByReceivers() const noexcept -> bool
+        { return mShadowRenderer.mShadowCasterCullingByReceivers; }
+
+        /** Sets whether all texture shadows are packed into a single shadow texture.
+        @remarks
+            Instead of one shadow texture per light iteration, see setShadowTextureCount, all
+            iterations of the shadow casting lights get a square tile of the texture of
+            setShadowTextureConfig index 0, which is rendered with a single bind of the target.
+            The side of a tile is the texture size divided by a power of two, picked from the
+            share of the screen the light may cover and Light::setShadowImportance, and the
+            tiles of the least important lights are shrunk down to minTileSize until all fit.
+            Directional lights and lights the camera is within count as covering the screen.
+            ShadowCameraSetup::getAtlasTileCount does not apply. The shadow texture count is
+            still the maximum number of tiles, and all shadow texture indices return the atlas.
+        @note
+            Receiver programs have to sample the texture with the texture_viewproj_matrix of
+            their index, which maps to its tile.
+        */
+        void setShadowAtlas(bool enabled, uint16 minTileSize = 64)
+        {
+            OgreAssert(minTileSize > 0, "the atlas tiles must not be empty");
+            mShadowRenderer.mShadowAtlas = enabled;
+            mShadowRenderer.mShadowAtlasMinTileSize = minTileSize;
+            mShadowRenderer.mShadowTextureConfigDirty = true;
+        }
+        [[nodiscard]] auto getShadowAtlas() const noexcept -> bool { return mShadowRenderer.mShadowAtlas; }
+        [[nodiscard]] auto getShadowAtlasMinTileSize() const noexcept -> uint16
+        { return mShadowRenderer.mShadowAtlasMinTileSize; }
+
         /** Sets the size and count of textures used in texture-based shadows. 
         @see setShadowTextureSize and setShadowTextureCount for details, this
             method just allows you to change both at once, which can save on
@@ -2952,6 +3301,26 @@ namespace Ogre {
         void setShadowTextureReceiverMaterial(const MaterialPtr& mat)
         { mShadowRenderer.setShadowTextureReceiverMaterial(mat); }
 
+        /** Sets a compositor applied to the viewports of all shadow textures, to filter the shadows.
+        @remarks
+            The compositor is added to the viewport of every shadow texture and of its tiles, so
+            that its output is what receivers sample, e.g. the shadow casters rendered with
+            'input previous' and blurred once per shadow texture with a separable filter. This is
+            the pre-filtering of exponential shadow maps: with the caster material
+            Ogre/ShadowCaster/ESM and the compositor Ogre/ShadowMap/BlurESM on a PixelFormat::FLOAT32_R
+            shadow texture, or Ogre/ShadowCaster/EVSM and Ogre/ShadowMap/BlurEVSM on
+            PixelFormat::FLOAT32_RGBA, receivers take a single tap instead of many PCF taps,
+            see the filter parameter of RTShader::IntegratedPSSM3.
+        @note
+            The scene pass of the compositor is rendered before the masks of cached shadow
+            textures are set up, so this does not go with setShadowStaticCasterMask.
+        @param name The compositor, empty for none which is the default
+        */
+        void setShadowTextureCompositor(std::string_view name)
+        { mShadowRenderer.setShadowTextureCompositor(name); }
+        [[nodiscard]] auto getShadowTextureCompositor() const noexcept -> std::string_view
+        { return mShadowRenderer.mShadowTextureCompositor; }
+
         /** Sets whether or not shadow casters should be rendered into shadow
             textures using their back faces rather than their front faces. 
         @remarks
@@ -3165,7 +3534,7 @@ namespace Ogre {
         auto getMovableObject(std::string_view name, std::string_view typeName) const -> MovableObject*;
         /** Returns whether a object instance with the given name exists. */
         auto hasMovableObject(std::string_view name, std::string_view typeName) const -> bool;
-        /** Get all MovableObect instances of a given type.
+        /** Get all MovableObect instances of a given type, in no particular order.
         @note
             The iterator returned from this method is not thread safe, do not use this
             if you are creating or deleting objects of this type in another thread.
@@ -3233,6 +3602,628 @@ namespace Ogre {
         */
         auto getFindVisibleObjects() noexcept -> bool { return mFindVisibleObjects; }
 
+        /** Statistics about the scene graph updates of the current frame.
+        @remarks
+            These are accumulated over all _updateSceneGraph calls within one frame,
+            i.e. there is one call per camera rendered.
+        */
+        struct SceneGraphUpdateStats
+        {
+            /// Number of nodes whose derived transform was recomputed
+            size_t nodesUpdated{0};
+            /** Number of nodes the update passed through, including unchanged ancestors of
+                updated nodes. Static branches are skipped and not counted */
+            size_t nodesVisited{0};
+            /// Number of subtrees that were distributed over the WorkQueue (0 if updated serially)
+            size_t subtreesDispatched{0};
+            /// Time spent in _updateSceneGraph, in microseconds
+            uint64 microseconds{0};
+        };
+
+        /** Sets whether the scene graph update should be distributed over the WorkQueue threads.
+        @remarks
+            The top of the hierarchy is expanded on the calling thread until there are enough
+            independent subtrees, which are then updated concurrently through
+            WorkQueue::parallelFor. The derived transforms and world bounds are exactly the same
+            as with the serial update.
+        @note
+            Node::Listener::nodeUpdated and MovableObject::Listener::objectMoved will be called
+            from worker threads in this mode, so they have to be thread safe. Nodes near the root
+            are updated via Node::_updateSelf and SceneNode::_updateBounds, hence SceneNode
+            subclasses must not rely on overriding _update.
+        */
+        void setParallelSceneGraphUpdate(bool enabled) { mParallelSceneGraphUpdate = enabled; }
+
+        /** Gets whether the scene graph update is distributed over the WorkQueue threads. */
+        auto getParallelSceneGraphUpdate() const noexcept -> bool { return mParallelSceneGraphUpdate; }
+
+        /** Sets whether the derived transforms should be computed in a packed structure-of-arrays layout.
+        @remarks
+            The whole scene graph is mirrored into a NodeTransformSoA, which is rebuilt whenever
+            nodes are attached or detached, and all derived transforms are recomputed several
+            nodes at a time as soon as any node has moved. The world bounds are then updated
+            bottom up. This trades the per node dirty tracking for vectorised arithmetic and
+            linear memory access, which pays off for large, mostly animated hierarchies.
+        @note
+            Takes precedence over setParallelSceneGraphUpdate. SceneNode subclasses must not
+            rely on overriding _update or updateFromParentImpl in this mode.
+        */
+        void setPackedTransformUpdate(bool enabled);
+
+        /** Gets whether the derived transforms are computed in a packed structure-of-arrays layout. */
+        auto getPackedTransformUpdate() const noexcept -> bool { return mPackedTransformUpdate; }
+
+        /** Gets the statistics about the scene graph updates of the current frame. */
+        auto getSceneGraphUpdateStats() const noexcept -> const SceneGraphUpdateStats& { return mSceneGraphUpdateStats; }
+
+        /** Statistics about the render state changes made by _setPass in the current frame. */
+        struct PassStateStats
+        {
+            /// Number of _setPass calls
+            size_t passesSet{0};
+            /// Number of fixed render state calls made on the RenderSystem
+            size_t stateCallsIssued{0};
+            /// Number of fixed render state calls skipped, as the value was already set
+            size_t stateCallsSkipped{0};
+        };
+
+        /** Sets whether _setPass should skip the render state calls which would not change anything.
+        @remarks
+            The blending, depth, alpha rejection, culling, shading, lighting, point and line
+            settings of every pass are compared to those last applied, and only the differing
+            ones are passed on to the RenderSystem. Programs and texture units are always bound,
+            since their contents can change without the pass changing.
+        @par
+            The SceneManager forgets the applied state when setting a viewport and around render
+            queue listener invocations. Code changing the same RenderSystem state directly while
+            the scene is rendered has to call _invalidatePassState afterwards.
+        */
+        void setPassStateFiltering(bool enabled)
+        {
+            mPassStateFiltering = enabled;
+            mLastPassStateValid = false;
+        }
+
+        /** Gets whether _setPass skips the render state calls which would not change anything. */
+        auto getPassStateFiltering() const noexcept -> bool { return mPassStateFiltering; }
+
+        /** Sets whether the opaque objects are first rendered to the depth buffer only.
+        @remarks
+            Each queue group rendered without shadows, or with integrated texture shadows, first
+            draws its solids with the Ogre/DepthPrePass material, whose pass writes no colour
+            and which the RTSS gives a program that only transforms the positions. The main pass
+            then tests their first pass with CompareFunction::EQUAL and without depth writes,
+            so its fragment program runs once for every pixel rather than once for every
+            overlapping surface. This pays off for scenes bound by expensive fragment programs,
+            at the cost of the vertex processing and draw calls done twice. Positions kept in a
+            separate vertex buffer, see MeshLayoutOptimiser, are all the pre-pass fetches.
+        @par
+            Only first passes which test and write the depth with CompareFunction::LESS_EQUAL,
+            are solid, opaque and not alpha tested, and whose vertex program neither animates
+            nor fetches textures take part. Passes of skinned, instanced or deformed renderables
+            are rendered the ordinary way. Vertex programs moving vertices otherwise are not
+            detected, the queue groups rendering them should disable the pre-pass, see
+            RenderQueueGroup::setDepthPrePassEnabled.
+        */
+        void setDepthPrePass(bool enabled) { mDepthPrePass = enabled; }
+
+        /** Gets whether the opaque objects are first rendered to the depth buffer only. */
+        auto getDepthPrePass() const noexcept -> bool { return mDepthPrePass; }
+
+        /** Gets the statistics about the render state changes of the current frame. */
+        auto getPassStateStats() const noexcept -> const PassStateStats& { return mPassStateStats; }
+
+        /** Makes the next _setPass apply the complete render state.
+        @see setPassStateFiltering
+        */
+        void _invalidatePassState() { mLastPassStateValid = false; }
+
+        /** Statistics about the render loop of the current frame.
+        @remarks
+            These are accumulated over all cameras rendered within one frame, including the
+            shadow texture cameras, and combine the scene graph, culling, sorting and pass
+            counters of the SceneManager. The work submitted to the GPU is counted by
+            RenderSystem::getRenderStats. Root publishes both as Profiler counters once the
+            render targets of a frame are updated, see Profiler::setCounter.
+        @par
+            The CPU time of the update, culling and submission stages leaves out the shadow
+            texture cameras, which are accounted to shadowMicroseconds as a whole. The
+            compositor time includes the scenes rendered by the passes of the chains.
+        */
+        struct RenderLoopStats
+        {
+            /// Number of nodes whose derived transform was recomputed
+            size_t nodesUpdated{0};
+            /// Number of scene nodes rejected by the culling
+            size_t nodesCulled{0};
+            /// Number of objects which were asked to queue their renderables
+            size_t objectsVisible{0};
+            /// Number of objects reached by the culling but skipped, e.g. being hidden
+            size_t objectsRejected{0};
+            /// Number of renderables added to the render queue
+            size_t renderablesQueued{0};
+            /// Time spent sorting the render queue, in microseconds
+            uint64 sortMicroseconds{0};
+            /// Number of _setPass calls
+            size_t passChanges{0};
+            /// Number of auto constants recomputed by GpuProgramParameters::_updateAutoParams
+            size_t autoConstantsUpdated{0};
+            /// Number of auto constants skipped, as none of their sources changed
+            size_t autoConstantsSkipped{0};
+            /// Time spent updating the controllers, animations and the scene graph, in microseconds
+            uint64 updateMicroseconds{0};
+            /// Time spent finding the lights and the objects visible to the cameras, in microseconds
+            uint64 cullMicroseconds{0};
+            /// Time spent rendering the queued objects, without the sorting, in microseconds
+            uint64 submitMicroseconds{0};
+            /// Time spent preparing the shadow textures, in microseconds
+            uint64 shadowMicroseconds{0};
+            /// Time spent rendering the intermediate targets of compositor chains, in microseconds
+            uint64 compositorMicroseconds{0};
+        };
+
+        /** Gets the statistics about the render loop of the current frame. */
+        auto getRenderLoopStats() const -> RenderLoopStats;
+
+        /** Publishes getRenderLoopStats as Profiler counters prefixed with the name of this SceneManager.
+        @remarks
+            Called by Root once per frame while the Profiler is enabled.
+        */
+        void _publishRenderLoopStats() const;
+
+        /** Adds to the compositorMicroseconds of the RenderLoopStats.
+        @remarks
+            Called by CompositorChain after rendering its intermediate targets.
+        */
+        void _notifyCompositorTime(uint64 microseconds);
+
+        /** Sets whether scene nodes hidden behind other geometry should be culled using
+            hardware occlusion queries.
+        @remarks
+            See OcclusionCulling for the details. Has no effect if the render system lacks
+            the Capabilities::HWOCCLUSION capability.
+        */
+        void setOcclusionCulling(bool enabled);
+
+        /** Gets whether hardware occlusion culling is enabled. */
+        auto getOcclusionCulling() const noexcept -> bool { return mOcclusionCulling != nullptr; }
+
+        /** Sets whether the visible objects should be gathered on the WorkQueue threads.
+        @remarks
+            The top of the scene graph is expanded on the calling thread until there are
+            enough branches to keep the threads busy. Every branch is then culled into a
+            staging RenderQueue of its own through WorkQueue::parallelFor, and the staging
+            queues are merged into the RenderQueue in scene graph order, so the queued
+            renderables and their order are the same as with the serial traversal.
+        @par
+            The serial traversal is used while visibility stages are active or a
+            RenderQueue::RenderableListener is set. LodListener notifications are serialised
+            but raised from the worker threads.
+        @note
+            MovableObject::_notifyCurrentCamera and MovableObject::_updateRenderQueue will be
+            called from worker threads in this mode, so objects sharing state, e.g. entities
+            sharing a skeleton instance, must not be spread over several branches. Scene
+            managers overriding _findVisibleObjects, like OctreeSceneManager, are unaffected.
+        */
+        void setParallelFindVisibleObjects(bool enabled) { mParallelFindVisibleObjects = enabled; }
+
+        /** Gets whether the visible objects are gathered on the WorkQueue threads. */
+        auto getParallelFindVisibleObjects() const noexcept -> bool { return mParallelFindVisibleObjects; }
+
+        /** Sets whether the per renderable work done before rendering a queued collection
+            should be distributed over the WorkQueue threads.
+        @remarks
+            Before a collection of the render queue is rendered, the world transforms of all
+            its renderables are fetched concurrently through WorkQueue::parallelFor,
+            including the camera relative adjustment, into one resolved list. Rendering then
+            hands these to the AutoParamDataSource instead of calling
+            Renderable::getWorldTransforms for every object. Small collections are rendered
+            as usual.
+        @par
+            Binding passes, updating GPU program parameters and issuing the draws still is
+            done in order on the calling thread, as the RenderSystem is not thread safe.
+        @note
+            Renderable::getWorldTransforms will be called from worker threads in this mode,
+            and must not be affected by RenderObjectListener callbacks. Custom renderables
+            which update their transforms or bone matrices lazily inside it are not safe.
+        */
+        void setParallelRenderPreparation(bool enabled) { mParallelRenderPreparation = enabled; }
+
+        /** Gets whether the per renderable work before rendering is distributed over the WorkQueue threads. */
+        auto getParallelRenderPreparation() const noexcept -> bool { return mParallelRenderPreparation; }
+
+        /** Sets whether the shadow cameras of texture shadows should be culled at once on the
+            WorkQueue threads, along with the camera the shadows are rendered for.
+        @remarks
+            All shadow cameras are set up first, then one traversal of the scene graph culls
+            them and the main camera through WorkQueue::parallelFor. Every task culls its
+            branch for each camera in turn, into a staging RenderQueue per camera, so no
+            object is processed by two threads at once. The shadow textures, and then the
+            main camera, are rendered in order from the merged queues. Shadow textures
+            rendered with a cached layer, see setShadowStaticCasterMask, are culled when
+            rendered as before, and so is the main camera with visibility stages or a
+            camera group.
+        @par
+            The scene graph is traversed even if _findVisibleObjects is overridden, e.g. by
+            OctreeSceneManager, and the visible objects are gathered before the listeners
+            of the shadow textures and SceneManager::Listener::preFindVisibleObjects run,
+            so these must not change what is visible. The ShadowTextureListener events
+            of all shadow cameras are raised before any shadow texture is rendered.
+        @note
+            As with setParallelFindVisibleObjects, objects are notified from worker threads.
+            Objects building geometry for the camera in _updateRenderQueue, like billboards,
+            keep the geometry of the last camera, the main one, for all cameras.
+        */
+        void setParallelShadowTextureCulling(bool enabled) { mParallelShadowTextureCulling = enabled; }
+
+        /** Gets whether the shadow cameras are culled at once on the WorkQueue threads. */
+        auto getParallelShadowTextureCulling() const noexcept -> bool { return mParallelShadowTextureCulling; }
+
+        /** Sets whether the cameras of all viewports should be culled at once on the WorkQueue
+            threads, before any render target is updated.
+        @remarks
+            Meant for several windows or viewports showing the scene from different points of view.
+            RenderSystem::_updateAllRenderTargets hands the viewports of all active, automatically
+            updated targets to _gatherViewports first. The scene is updated as for the first render
+            of the frame, then one traversal of the scene graph culls all their cameras through
+            WorkQueue::parallelFor, as described for setParallelShadowTextureCulling. The targets
+            are then updated in order of priority, and each viewport is rendered from its merged
+            queue, so all calls to the RenderSystem stay on the calling thread.
+        @par
+            Viewports with a compositor chain, or with another material scheme than the first one,
+            and cameras in a camera group or rendered with visibility stages or a
+            RenderQueue::RenderableListener, are culled when rendered as before. A camera shown in
+            several viewports is gathered for the first one only.
+        @note
+            As everything is culled before the first target is rendered, listeners of the render
+            targets and viewports, and SceneManager::Listener::preFindVisibleObjects, must not
+            change what is visible nor move the cameras. Objects building geometry for the camera
+            in _updateRenderQueue, like billboards, keep the geometry of the last camera culled.
+        */
+        void setParallelViewportCulling(bool enabled) { mParallelViewportCulling = enabled; }
+
+        /** Gets whether the cameras of all viewports are culled at once on the WorkQueue threads. */
+        auto getParallelViewportCulling() const noexcept -> bool { return mParallelViewportCulling; }
+
+        /** Culls the cameras of those viewports which show this scene, see setParallelViewportCulling.
+        @remarks
+            Called by RenderSystem::_updateAllRenderTargets, in the order the viewports are rendered.
+        */
+        void _gatherViewports(std::span<Viewport* const> viewports);
+
+        /** Sets whether the objects found visible for a camera are reused when it is rendered again in the frame.
+        @remarks
+            Compositors render the scene once per render_scene pass, mostly for the same camera,
+            e.g. a G-buffer pass followed by a forward pass for the transparent queues. With this
+            enabled, the render queue built for a camera is kept until the end of the frame. When
+            the camera is rendered again with the same view, projection, viewport size, visibility
+            mask, LOD bias, material scheme and shadow setting, the queue is copied instead of
+            culling the scene again. Each pass still renders only its range of queues, see
+            CompositionPass::setFirstRenderQueue.
+        @par
+            The scene graph is still updated for every render, but changes to the visible objects
+            made in between, e.g. by listeners, are not seen. Attaching, detaching or destroying a
+            movable object drops the kept queue, see _notifyVisibleObjectsChanged. Not used for
+            shadow textures, with visibility stages or with a RenderQueue::RenderableListener.
+        */
+        void setReuseVisibleObjects(bool enabled) { mReuseVisibleObjects = enabled; }
+
+        /** Gets whether the objects found visible for a camera are reused during the frame. */
+        auto getReuseVisibleObjects() const noexcept -> bool { return mReuseVisibleObjects; }
+
+        /** Internal method to drop the visible objects kept by setReuseVisibleObjects.
+        @remarks
+            The kept render queue points at the renderables of the objects, so this is called
+            whenever an object of this scene is attached, detached or destroyed.
+        */
+        void _notifyVisibleObjectsChanged() { mVisibleObjectsCache.camera = nullptr; }
+
+        /** Sets whether the skeletons of animated entities should be evaluated on the WorkQueue threads.
+        @remarks
+            After the scene graph update, the animation states of every visible, skeletally
+            animated Entity in the scene are applied and its bone matrices computed through
+            WorkQueue::parallelFor, one task per skeleton instance. Entities sharing a skeleton
+            are evaluated once. The animations are prepared on the calling thread first, so
+            the tasks only read shared data. Rendering then finds the bones up to date.
+        @note
+            Entities with objects attached to their bones are skipped and evaluated when
+            rendered, as usual. Skeletons of entities which end up culled are evaluated too.
+        */
+        void setParallelSkeletalAnimation(bool enabled) { mParallelSkeletalAnimation = enabled; }
+
+        /** Gets whether the skeletons of animated entities are evaluated on the WorkQueue threads. */
+        auto getParallelSkeletalAnimation() const noexcept -> bool { return mParallelSkeletalAnimation; }
+
+        /** Sets whether skeleton instances in the same pose share their bone matrices.
+        @remarks
+            Entities and instanced entities look their pose up in a SkeletonPoseCache before
+            evaluating their skeleton, so crowds playing the same animations at about the same
+            time evaluate each pose once per frame. The palettes are used for software and
+            hardware skinning, and by the instancing techniques alike.
+        @note
+            Entities with objects attached to their bones, bounds from the skeleton or the
+            skeleton displayed, and skeletons with manually controlled bones, always evaluate
+            on their own, as the other entities do not update their Bone nodes.
+        */
+        void setSkeletonPoseSharing(bool enabled);
+
+        /** Gets whether skeleton instances in the same pose share their bone matrices. */
+        auto getSkeletonPoseSharing() const noexcept -> bool { return mSkeletonPoseCache != nullptr; }
+
+        /** Gets the cache of shared skeleton poses, @c nullptr unless setSkeletonPoseSharing is enabled. */
+        auto getSkeletonPoseCache() const noexcept -> SkeletonPoseCache* { return mSkeletonPoseCache.get(); }
+
+        /** Sets whether consecutive renderables of a pass group sharing their geometry are
+            merged into one instanced draw call.
+        @remarks
+            Only passes with a vertex program which opted in with Pass::setAutoInstancing are
+            considered. Within such a pass, runs of renderables with a single world transform,
+            the same RenderOperation vertex and index data and the same lights are rendered
+            once: their world matrices are written to an instance buffer bound as the global
+            instance vertex buffer of the RenderSystem, while the world matrix parameter is
+            identity, like InstanceBatchHW does.
+        @par
+            Everything other than the world transform is taken from the first renderable of a
+            run, which includes Renderable::preRender and the RenderObjectListener callbacks.
+            Custom parameters read by the programs of the pass are the exception, a run ends
+            where they change, as it does at renderables whose RenderOperation does not allow
+            RenderOperation::useGlobalInstancingVertexBufferIsAvailable. Culling is not flipped for negatively scaled
+            instances. Runs are not formed while an application supplied
+            global instance vertex buffer is set, or if the RenderSystem lacks
+            Capabilities::VERTEX_BUFFER_INSTANCE_DATA.
+        @param enabled Whether to merge runs of renderables
+        @param texCoordIndex The texture coordinate index of the first of the three float4
+            rows of the instance world matrix, which the vertex programs must read
+        */
+        void setAutoInstancing(bool enabled, unsigned short texCoordIndex = 1);
+
+        /** Gets whether runs of renderables sharing their pass and geometry are drawn instanced. */
+        auto getAutoInstancing() const noexcept -> bool { return mAutoInstancing; }
+
+        /** Declares cameras which render the scene in the same frame from nearby places, e.g.
+            the eyes of a stereo pair or the six faces of a cube map, to share one culling pass.
+        @remarks
+            The first camera of the group rendered in a frame walks the scene graph, collecting
+            the nodes within the bounding box of all the frusta in the group. Every camera,
+            including the first, then only tests the collected nodes against its own frustum
+            before queueing their objects, in the same order as the regular traversal.
+        @par
+            The collected nodes are kept until the next frame or until nodes are attached or
+            detached, so the scene must not move while the group is being rendered. The
+            regular traversal is used while visibility stages are active. Scene managers
+            overriding _findVisibleObjects, like OctreeSceneManager, are unaffected.
+        @param cameras At least two cameras, none of which may be in another group already
+        */
+        void addCameraGroup(const std::vector<Camera*>& cameras);
+
+        /** Removes the camera group which contains the given camera, if any. */
+        void removeCameraGroup(const Camera* cam);
+
+        /** Gets the occlusion culling state, @c nullptr unless enabled. */
+        auto _getOcclusionCulling() const noexcept -> OcclusionCulling* { return mOcclusionCulling.get(); }
+
+        /** Adds a visibility test for the scene nodes in the frustum of the camera.
+        @remarks
+            The stages are run in the order they were added. The stage is not owned and
+            must be removed before it is destroyed.
+        */
+        void addVisibilityStage(VisibilityStage* stage);
+
+        /** Removes a stage added with addVisibilityStage. */
+        void removeVisibilityStage(VisibilityStage* stage);
+
+        /** Gets the registered visibility stages. */
+        auto getVisibilityStages() const noexcept -> const std::vector<VisibilityStage*>& { return mVisibilityStages; }
+
+        /** Tests the node with the visibility stages, called by _findVisibleObjects implementations.
+        @param node The node whose objects are about to be queued.
+        @param bounds World bounds of everything skipped if the node is rejected.
+        @return false if any stage rejected the node
+        */
+        auto _passesVisibilityStages(const SceneNode* node, const AxisAlignedBox& bounds) -> bool
+        {
+            if (!mVisibilityStagesActive)
+                return true;
+            for (auto stage : mVisibilityStages)
+            {
+                if (!stage->_isVisible(node, bounds))
+                    return false;
+            }
+            return true;
+        }
+
+        /** Tests bounds with the shadow caster culling, called by _findVisibleObjects implementations.
+        @return false if nothing within bounds can shadow the view, see setShadowCasterCulling
+        */
+        auto _passesShadowCasterCulling(const AxisAlignedBox& bounds) const -> bool
+        {
+            return !ShadowRenderer::msActiveCasterCulling || ShadowRenderer::msActiveCasterCulling->isVisible(bounds);
+        }
+
+    protected:
+        bool mParallelRenderPreparation{false};
+        bool mParallelShadowTextureCulling{false};
+        bool mParallelViewportCulling{false};
+        std::vector<PreparedRenderable> mPreparedRenderables;
+        std::vector<Affine3> mPreparedMatrices;
+        /// The entry of mPreparedRenderables for the renderable being rendered, if any
+        const PreparedRenderable* mCurrentPreparedRenderable{nullptr};
+        /** Resolves the world transforms of a collection into mPreparedRenderables.
+        @return false if the collection is not worth preparing
+        */
+        auto prepareRenderables(const QueuedRenderableCollection& objs,
+                                QueuedRenderableCollection::OrganisationMode om) -> bool;
+
+        bool mAutoInstancing{false};
+        unsigned short mAutoInstancingTexCoord{1};
+        /// World matrices of the run being drawn, see setAutoInstancing
+        HardwareVertexBufferSharedPtr mInstanceBuffer;
+        VertexDeclaration* mInstanceDeclaration{nullptr};
+        /// Number of instances of the next draw, 0 unless drawing a run
+        uint32 mCurrentNumInstances{0};
+        /** Gets how many renderables starting at rs[begin] can be drawn as one instanced run.
+        @return 1 if the renderable cannot be drawn instanced
+        */
+        auto findInstanceRun(const Pass* pass, const RenderableList& rs, size_t begin, bool compareLights) -> size_t;
+        /** Writes the world matrices of rs[begin, begin + count) into mInstanceBuffer
+        @param prepared The prepared entry of rs[begin], if any
+        */
+        void prepareInstances(const RenderableList& rs, size_t begin, size_t count, const PreparedRenderable* prepared);
+        void destroyInstanceBuffer();
+
+        /// Renderables submitted along with the one being rendered, see findMultiDrawRun
+        std::span<Renderable* const> mCurrentMultiDraw;
+        /// The operations of the run passed to RenderSystem::_renderMultiple, kept for their storage
+        std::vector<RenderOperation> mMultiDrawOps;
+        std::vector<const RenderOperation*> mMultiDrawOpPointers;
+        /** Gets how many renderables starting at rs[begin] share all render state, so that
+            they can be submitted with one RenderSystem::_renderMultiple call.
+        @remarks
+            They need the same world transform, lights, custom parameters, vertex data, index
+            buffer and operation type. Only done for render systems with Capabilities::MULTI_DRAW.
+        @return 1 if the renderable cannot be submitted along with the next ones
+        */
+        auto findMultiDrawRun(const Pass* pass, const RenderableList& rs, size_t begin, bool compareLights) -> size_t;
+
+        /// Cameras sharing one culling pass, see addCameraGroup
+        struct CameraGroup
+        {
+            std::vector<Camera*> cameras;
+            /// Nodes with objects within the frusta of the cameras, in scene graph order
+            std::vector<SceneNode*> nodes;
+            /// When the nodes were collected
+            unsigned long frameNumber{0};
+            uint64 hierarchyVersion{0};
+            bool valid{false};
+        };
+        std::vector<CameraGroup> mCameraGroups;
+
+        /// Gets the group the camera is in, @c nullptr if none
+        auto findCameraGroup(const Camera* cam) -> CameraGroup*;
+        /// _findVisibleObjects using the shared culling pass of the group
+        void findVisibleObjectsGrouped(CameraGroup& group, Camera* cam, VisibleObjectsBoundsInfo* visibleBounds);
+
+        bool mParallelSceneGraphUpdate{false};
+        SceneGraphUpdateStats mSceneGraphUpdateStats;
+        unsigned long mSceneGraphUpdateStatsFrame{0};
+        PassStateStats mPassStateStats;
+        unsigned long mPassStateStatsFrame{0};
+        /// The culling and sorting part of the RenderLoopStats, the rest is gathered on demand
+        RenderLoopStats mRenderLoopStats;
+        unsigned long mRenderLoopStatsFrame{0};
+        auto currentRenderLoopStats() -> RenderLoopStats&;
+        /// Scratch storage for the subtrees of the parallel scene graph update
+        std::vector<Node::PendingChildUpdate> mPendingNodeUpdates;
+        std::vector<Node::PendingChildUpdate> mPendingNodeUpdatesNext;
+        std::vector<SceneNode*> mExpandedSceneNodes;
+
+        bool mParallelSkeletalAnimation{false};
+        /// Scratch storage of updateSkeletalAnimationParallel, one entity per skeleton instance
+        std::vector<Entity*> mSkeletalAnimationTasks;
+        /// See setSkeletonPoseSharing
+        std::unique_ptr<SkeletonPoseCache> mSkeletonPoseCache;
+
+        bool mPackedTransformUpdate{false};
+        /// Packed mirror of the scene graph, see setPackedTransformUpdate
+        NodeTransformSoA mPackedTransforms;
+
+        /// See setOcclusionCulling
+        std::unique_ptr<OcclusionCulling> mOcclusionCulling;
+        /// See addVisibilityStage
+        std::vector<VisibilityStage*> mVisibilityStages;
+        /// Whether the stages were started for the camera being rendered
+        bool mVisibilityStagesActive{false};
+
+        bool mParallelFindVisibleObjects{false};
+        /// A branch of the scene graph culled on its own, see setParallelFindVisibleObjects
+        struct VisibleObjectsTask
+        {
+            SceneNode* node;
+            /// Whether only the objects of the node are queued, its children being tasks of their own
+            bool objectsOnly;
+        };
+        /// What a task gathered, merged in task order
+        struct VisibleObjectsStaging
+        {
+            std::unique_ptr<RenderQueue> queue;
+            VisibleObjectsBoundsInfo bounds;
+            std::vector<SceneNode*> drawnNodes;
+        };
+        std::vector<VisibleObjectsTask> mVisibleObjectsTasks;
+        std::vector<VisibleObjectsTask> mVisibleObjectsTasksNext;
+        std::vector<VisibleObjectsStaging> mVisibleObjectsStaging;
+        /// Serialises the LOD notifications of the parallel culling
+        std::mutex mLodEventMutex;
+
+        /// Updates the scene graph on the WorkQueue threads, see setParallelSceneGraphUpdate
+        void updateSceneGraphParallel();
+        /// Updates the scene graph through mPackedTransforms, see setPackedTransformUpdate
+        void updateSceneGraphPacked();
+        /// Evaluates the skeletons on the WorkQueue threads, see setParallelSkeletalAnimation
+        void updateSkeletalAnimationParallel();
+        /// Gathers the visible objects on the WorkQueue threads, see setParallelFindVisibleObjects
+        void findVisibleObjectsParallel(Camera* cam, VisibleObjectsBoundsInfo* visibleBounds, bool onlyShadowCasters);
+
+        /// A camera culled by gatherVisibleObjectsParallel, with the viewport of its visibility mask
+        struct GatheredCamera
+        {
+            Camera* camera;
+            Viewport* viewport;
+            const ShadowRenderer::ShadowCasterCulling* culling;
+            bool onlyShadowCasters;
+        };
+        /// Cameras culled in one traversal, and what was found for them
+        struct GatheredObjects
+        {
+            std::vector<GatheredCamera> cameras;
+            std::vector<VisibleObjectsTask> tasks;
+            /// Per task, one staging queue per camera
+            std::vector<VisibleObjectsStaging> staging;
+            unsigned long frame{0};
+        };
+        /// The shadow cameras, see setParallelShadowTextureCulling
+        GatheredObjects mGatheredShadowObjects;
+        /// The cameras of the viewports, see setParallelViewportCulling
+        GatheredObjects mGatheredViewportObjects;
+        /// The viewport whose visibility mask applies on this thread instead of the current one
+        static thread_local const Viewport* msCullingViewport;
+        /// Culls all cameras of gathered on the WorkQueue threads
+        void gatherVisibleObjectsParallel(GatheredObjects& gathered);
+        /** Queues what gatherVisibleObjectsParallel found for cam, once.
+        @return false if cam was not gathered
+        */
+        auto mergeGatheredObjects(GatheredObjects& gathered, const Camera* cam,
+                                  VisibleObjectsBoundsInfo* visibleBounds) -> bool;
+        /// What the first render of a frame updates before culling cam
+        void updateSceneForCamera(Camera* cam);
+
+        bool mReuseVisibleObjects{false};
+        /// The visible objects of the last camera rendered, see setReuseVisibleObjects
+        struct VisibleObjectsCache
+        {
+            const Camera* camera{nullptr};
+            unsigned long frame{0};
+            Affine3 view;
+            Matrix4 projection;
+            int width, height;
+            QueryTypeMask visibilityMask;
+            Real lodBias;
+            String materialScheme;
+            bool shadowsEnabled;
+            VisibleObjectsStaging staging;
+        };
+        VisibleObjectsCache mVisibleObjectsCache;
+        /// Whether the cache may be used and filled while rendering the current camera
+        [[nodiscard]] auto isVisibleObjectsCacheUsable() const -> bool;
+        /** Queues the cached visible objects if they were found for the same camera and settings.
+        @return false if the scene must be culled
+        */
+        auto mergeCachedVisibleObjects(const Camera* cam, const Viewport* vp, VisibleObjectsBoundsInfo* visibleBounds) -> bool;
+        /// Keeps the queued objects for the next render of cam in this frame
+        void cacheVisibleObjects(const Camera* cam, const Viewport* vp, const VisibleObjectsBoundsInfo& visibleBounds);
+
+    public:
+
         /** Set whether to automatically normalise normals on objects whenever they
             are scaled.
         @remarks
@@ -3379,7 +4370,14 @@ namespace Ogre {
         virtual void drawFrustum(const Frustum* frust) = 0;
     };
 
-    /** Default implementation of IntersectionSceneQuery. */
+    /** Default implementation of IntersectionSceneQuery.
+    @remarks
+        Uses a sort and sweep broadphase along the x axis. The order of the objects
+        along the axis is kept between executions, so it only has to be repaired
+        where objects moved past each other, which is close to linear for coherent
+        scenes. The pairs are reported in the same order as by a brute force
+        comparison of all objects.
+    */
     class DefaultIntersectionSceneQuery : 
         public IntersectionSceneQuery
     {
@@ -3388,6 +4386,27 @@ namespace Ogre {
         ~DefaultIntersectionSceneQuery() override;
 
         void execute(IntersectionSceneQueryListener* listener) override;
+
+    private:
+        struct SweepEntry
+        {
+            const AxisAlignedBox* box;
+            /// Index into mCandidates
+            uint32 index;
+        };
+
+        /// Objects passing the masks, in enumeration order
+        std::vector<MovableObject*> mCandidates;
+        std::unordered_map<MovableObject*, uint32> mCandidateIndices;
+        /// Finite candidates ordered by the minimum x of their bounds
+        std::vector<SweepEntry> mSweep;
+        /// Order of mSweep at the end of the previous execution
+        std::vector<MovableObject*> mSweepOrder;
+        /// Overlapping candidates, lower index first
+        std::vector<std::pair<uint32, uint32>> mPairs;
+
+        void gatherCandidates();
+        void sortSweep();
     };
 
     /** Default implementation of RaySceneQuery. */
@@ -3399,6 +4418,15 @@ namespace Ogre {
 
         void execute(RaySceneQueryListener* listener) override;
     };
+    /** Default implementation of RayBatchSceneQuery. */
+    class DefaultRayBatchSceneQuery : public RayBatchSceneQuery
+    {
+    public:
+        DefaultRayBatchSceneQuery(SceneManager* creator);
+        ~DefaultRayBatchSceneQuery() override;
+
+        void execute(RayBatchSceneQueryListener* listener) override;
+    };
     /** Default implementation of SphereSceneQuery. */
     class DefaultSphereSceneQuery : public SphereSceneQuery
     {
@@ -30,6 +30,7 @@ export module Ogre.Core:SceneManagerEnumerator;
 export import :Common;
 export import :IteratorWrapper;
 export import :MemoryAllocatorConfig;
+export import :OctreeSceneManager;
 export import :Prerequisites;
 export import :SceneManager;
 export import :Singleton;
@@ -107,6 +108,8 @@ class RenderSystem;
         MetaDataList mMetaDataList;
         /// Factory for default scene manager
         DefaultSceneManagerFactory mDefaultFactory;
+        /// Factory for the octree scene manager
+        OctreeSceneManagerFactory mOctreeFactory;
         /// Count of creations for auto-naming
         unsigned long mInstanceCreateCount{0};
         /// Currently assigned render system
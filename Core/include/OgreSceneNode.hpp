@@ -98,7 +98,7 @@ class SceneManager;
         /// World-Axis aligned bounding box, updated only through _update
         AxisAlignedBox mWorldAABB;
 
-        void updateFromParentImpl() const override;
+        void derivedTransformUpdated() const override;
 
         /** See Node */
         void setParent(Node* parent) override;
@@ -127,6 +127,19 @@ class SceneManager;
 
         /** See Node. */
         auto createChildImpl(std::string_view name) -> Node* override;
+
+        /** Overridden from Node to use the queue of the creator. */
+        auto getQueuedUpdates() -> QueuedUpdates* override;
+
+        /** _findVisibleObjects for a node already known to be visible, the children
+            are culled in batches.
+        @param drawnNodes If given, receives the nodes to pass to the DebugDrawer instead
+            of drawing them, so the traversal can run on several threads.
+        */
+        void addVisibleObjects(Camera* cam, RenderQueue* queue,
+            VisibleObjectsBoundsInfo* visibleBounds,
+            bool includeChildren, bool displayNodes, bool onlyShadowCasters,
+            std::vector<SceneNode*>* drawnNodes = nullptr);
     public:
         /** Constructor, only to be called by the creator SceneManager.
         @remarks
@@ -382,8 +382,13 @@ class SceneManager;
     {
     protected:
         Ray mRay;
+        /** Intersects the ray with an object, precisely if enabled for entities.
+        @see setPreciseMeshHits
+        */
+        [[nodiscard]] auto intersectsObject(MovableObject* obj) const -> RayTestResult;
     private:
         bool mSortByDistance;
+        bool mPreciseMeshHits{false};
         ushort mMaxResults;
         RaySceneQueryResult mResult;
 
@@ -418,6 +423,17 @@ class SceneManager;
         /** Gets the maximum number of results returned from the query (only relevant if 
         results are being sorted) */
         [[nodiscard]] virtual auto getMaxResults() const noexcept -> ushort;
+        /** Sets whether entities are hit by the triangles of their mesh rather than their bounds.
+        @remarks
+            Entities whose bounding box the ray intersects are then tested against the triangles
+            of their mesh, using Mesh::getTriangleBVH, and returned with the distance to the
+            nearest triangle hit, if any. Both sides of the triangles are hit. The BVH is built
+            from the mesh as stored, so skeletal and vertex animation are not taken into account.
+            Other objects are still tested against their bounds. Disabled by default.
+        */
+        void setPreciseMeshHits(bool precise) { mPreciseMeshHits = precise; }
+        /** Gets whether entities are hit by the triangles of their mesh. */
+        [[nodiscard]] auto getPreciseMeshHits() const noexcept -> bool { return mPreciseMeshHits; }
         /** Executes the query, returning the results back in one list.
         @remarks
             This method executes the scene query as configured, gathers the results
@@ -457,6 +473,75 @@ class SceneManager;
 
 
 
+    };
+
+    /** Alternative listener class for dealing with RayBatchSceneQuery.
+    @remarks
+        Like RaySceneQueryListener, but also identifies which of the rays was hit.
+    */
+    class RayBatchSceneQueryListener
+    {
+    public:
+        virtual ~RayBatchSceneQueryListener() = default;
+        /** Called when a movable object intersects one of the rays.
+        @remarks
+            As with SceneQueryListener, the implementor of this method should return 'true'
+            if further results are required, or 'false' to abandon any further results from
+            the current query.
+        @param rayIndex Index of the ray as passed to RayBatchSceneQuery::setRays
+        */
+        virtual auto queryResult(size_t rayIndex, MovableObject* obj, Real distance) -> bool = 0;
+    };
+
+    /// Results of a RayBatchSceneQuery, one RaySceneQueryResult per ray
+    using RayBatchSceneQueryResult = std::vector<RaySceneQueryResult>;
+
+    /** Specialises the SceneQuery class for querying along many rays at once.
+    @remarks
+        Answers the same question as one RaySceneQuery per ray, but visits the scene
+        only once for all of them, which pays off when issuing many rays per frame,
+        e.g. for picking or line of sight tests. World fragments are not supported.
+    */
+    class RayBatchSceneQuery : public SceneQuery, public RayBatchSceneQueryListener
+    {
+    protected:
+        std::vector<Ray> mRays;
+    private:
+        bool mSortByDistance{false};
+        ushort mMaxResults{0};
+        RayBatchSceneQueryResult mResult;
+
+    public:
+        RayBatchSceneQuery(SceneManager* mgr);
+        ~RayBatchSceneQuery() override;
+        /** Sets the rays which are to be used for this query. */
+        virtual void setRays(const std::vector<Ray>& rays);
+        /** Gets the rays which are to be used for this query. */
+        [[nodiscard]] virtual auto getRays() const noexcept -> const std::vector<Ray>&;
+        /** Sets whether the results of each ray will be sorted by distance, see RaySceneQuery::setSortByDistance. */
+        virtual void setSortByDistance(bool sort, ushort maxresults = 0);
+        /** Gets whether the results are sorted by distance. */
+        [[nodiscard]] virtual auto getSortByDistance() const noexcept -> bool;
+        /** Gets the maximum number of results returned per ray (only relevant if
+        results are being sorted) */
+        [[nodiscard]] virtual auto getMaxResults() const noexcept -> ushort;
+        /** Executes the query, returning the results of every ray in one structure.
+        @remarks
+            The results persist in this query object until the next query is
+            executed, or clearResults() is called.
+        */
+        virtual auto execute() -> RayBatchSceneQueryResult&;
+
+        /** Executes the query and returns each match through a listener interface. */
+        virtual void execute(RayBatchSceneQueryListener* listener) = 0;
+
+        /** Gets the results of the last query that was run using this object. */
+        virtual auto getLastResults() noexcept -> RayBatchSceneQueryResult&;
+        /** Clears the results of the last query execution. */
+        virtual void clearResults();
+
+        /** Self-callback in order to deal with execute which returns collection. */
+        auto queryResult(size_t rayIndex, MovableObject* obj, Real distance) -> bool override;
     };
 
     /** Alternative listener class for dealing with IntersectionSceneQuery.
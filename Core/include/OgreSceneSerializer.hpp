@@ -0,0 +1,113 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+module;
+
+#include <cstddef>
+
+export module Ogre.Core:SceneSerializer;
+
+export import :Prerequisites;
+
+export import <map>;
+export import <unordered_map>;
+export import <utility>;
+export import <vector>;
+
+export
+namespace Ogre
+{
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Scene
+    *  @{
+    */
+    /** Writes the content of a SceneManager into a binary snapshot, and reads it back.
+    @remarks
+        The snapshot holds the scene node hierarchy with the node names and transforms, the
+        Entity and Light objects with their settings and node, the StaticGeometry instances
+        with their queued submeshes, and the InstanceManager instances with their instanced
+        entities. Meshes and materials are referenced by name and group, so they have to be
+        available when importing.
+    @par
+        Importing into a scene built this way replaces thousands of calls driven by a text
+        format: the nodes are read in a flat list with the parents before their children and
+        are referenced by their index, so objects are attached without looking up a node by
+        name, meshes and materials are resolved once per name, and the node list of the scene
+        manager is reserved up front. Named nodes and objects still have their names checked
+        for uniqueness by the SceneManager; unnamed nodes are written unnamed.
+    @par
+        Other movable object types, like cameras or particle systems, as well as animation
+        states and user data are not part of the snapshot. The nodes the StaticGeometry regions
+        and the instance batches create for themselves are skipped, they are built again on
+        import.
+    */
+    class SceneSerializer
+    {
+    public:
+        /// Writes the scene of a SceneManager into a stream
+        void exportScene(SceneManager* sceneMgr, const DataStreamPtr& stream);
+        /// @overload
+        void exportScene(SceneManager* sceneMgr, std::string_view filename);
+
+        /** Reads a snapshot into a SceneManager.
+        @param stream The snapshot written by exportScene
+        @param sceneMgr The SceneManager to create the scene in
+        @param parent The node the top level nodes are created below, the root scene node by default
+        */
+        void importScene(const DataStreamPtr& stream, SceneManager* sceneMgr, SceneNode* parent = nullptr);
+
+    private:
+        static constexpr uint32 NO_NODE = ~0u;
+
+        /// Index of every exported node, while exporting
+        std::unordered_map<const Node*, uint32> mNodeIndices;
+        /// The nodes by index, while importing
+        std::vector<SceneNode*> mNodes;
+        /// Resolved once per name and group, while importing
+        std::map<std::pair<String, String>, MeshPtr> mMeshes;
+        std::map<std::pair<String, String>, MaterialPtr> mMaterials;
+
+        [[nodiscard]] auto getNodeIndex(const Node* node) const -> uint32;
+        [[nodiscard]] auto getNode(uint32 index) const -> SceneNode*;
+        auto getMesh(StreamSerialiser& stream) -> const MeshPtr&;
+        auto getMaterial(StreamSerialiser& stream) -> const MaterialPtr&;
+
+        void writeNodes(StreamSerialiser& stream, SceneManager* sceneMgr);
+        void writeObjects(StreamSerialiser& stream, SceneManager* sceneMgr);
+        void writeStaticGeometry(StreamSerialiser& stream, SceneManager* sceneMgr);
+        void writeInstancing(StreamSerialiser& stream, SceneManager* sceneMgr);
+
+        void readNodes(StreamSerialiser& stream, SceneManager* sceneMgr, SceneNode* parent);
+        void readObjects(StreamSerialiser& stream, SceneManager* sceneMgr);
+        void readStaticGeometry(StreamSerialiser& stream, SceneManager* sceneMgr);
+        void readInstancing(StreamSerialiser& stream, SceneManager* sceneMgr);
+    };
+    /** @} */
+    /** @} */
+}
@@ -234,6 +234,11 @@ class Material;
         auto compile(std::string_view str, std::string_view source, std::string_view group) -> bool;
         /// Compiles resources from the given concrete node list
         auto compile(const ConcreteNodeListPtr &nodes, std::string_view group) -> bool;
+        /** Translates a single top level object, which compile already resolved the imports,
+            variables and inheritance of. Used for the materials MaterialManager::setLazyLoading defers.
+        @return Whether the translation added no errors
+        */
+        auto _translate(const AbstractNodePtr &node, std::string_view group) -> bool;
         /// Adds the given error to the compiler's list of errors
         void addError(uint32 code, std::string_view file, int line, std::string_view msg = "");
         /// Sets the listener used by the compiler
@@ -419,6 +424,9 @@ class Material;
 
         // the specific compiler instance used
         ScriptCompiler mScriptCompiler;
+
+        // directory the parsed scripts are cached in, empty if disabled
+        String mCacheLocation;
     public:
         ScriptCompilerManager();
         ~ScriptCompilerManager() override = default;
@@ -450,12 +458,32 @@ class Material;
 		*/
 		auto registerCustomWordId(std::string_view word) -> uint32;
 
+        /** Sets a directory to keep the parsed scripts in, so unchanged ones skip tokenizing and parsing.
+        @remarks
+            The files in it are named by a hash of the script source and the cache format version,
+            and hold the ConcreteNode trees ScriptParser made of them. Loading one is a single read
+            and a linear walk over the buffer. Imports, variables and inheritance are still resolved,
+            and the objects translated, on every load, as they depend on the other scripts and on
+            the registered ScriptTranslatorManagers.
+        @note
+            Empty, the default, disables the cache. Stale files are never removed.
+        */
+        void setCacheLocation(std::string_view path) { mCacheLocation = path; }
+        /// Gets the directory parsed scripts are kept in, see setCacheLocation
+        [[nodiscard]] auto getCacheLocation() const noexcept -> std::string_view { return mCacheLocation; }
+
         /// Adds a script extension that can be handled (e.g. *.material, *.pu, etc.)
         void addScriptPattern(std::string_view pattern);
         /// @copydoc ScriptLoader::getScriptPatterns
         [[nodiscard]] auto getScriptPatterns() const noexcept -> const StringVector& override;
         /// @copydoc ScriptLoader::parseScript
         void parseScript(DataStreamPtr& stream, std::string_view groupName) override;
+        /// Tokenizes and parses the script, see setCacheLocation
+        [[nodiscard]] auto _prepareScript(DataStreamPtr& stream) const -> std::any override;
+        /// Compiles the nodes returned by _prepareScript
+        void _parsePreparedScript(DataStreamPtr& stream, std::string_view groupName, const std::any& prepared) override;
+        /// Translates a material that was deferred by MaterialManager::setLazyLoading
+        auto _translateDeferred(const AbstractNodePtr& node, std::string_view groupName) -> bool;
         /// @copydoc ScriptLoader::getLoadingOrder
         [[nodiscard]] auto getLoadingOrder() const -> Real override;
 
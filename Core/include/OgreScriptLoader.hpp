@@ -31,6 +31,8 @@ export import :DataStream;
 export import :Prerequisites;
 export import :StringVector;
 
+export import <any>;
+
 export
 namespace Ogre {
 
@@ -76,6 +78,26 @@ namespace Ogre {
         */
         virtual void parseScript(DataStreamPtr& stream, std::string_view groupName) = 0;
 
+        /** Does the part of parsing a script file which does not depend on the other scripts.
+
+            ResourceGroupManager calls this for all scripts of a group on the worker threads
+            of the WorkQueue first, and then _parsePreparedScript with the result for each of
+            them in loading order. Must be thread safe and leave stream at its start.
+        @param stream Data stream of the script, read from memory
+        @return State to continue with, empty to parse the script with parseScript
+        */
+        [[nodiscard]] virtual auto _prepareScript(DataStreamPtr& stream) const -> std::any { return {}; }
+
+        /** Parses a script file, continuing from what _prepareScript returned for it.
+        @param stream Data stream of the script
+        @param groupName See parseScript
+        @param prepared The non empty result of _prepareScript
+        */
+        virtual void _parsePreparedScript(DataStreamPtr& stream, std::string_view groupName, const std::any& prepared)
+        {
+            parseScript(stream, groupName);
+        }
+
         /** Gets the loading order for scripts of this type.
 
             There are dependencies between some kinds of scripts, and this value enumerates that.
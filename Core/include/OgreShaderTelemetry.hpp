@@ -0,0 +1,176 @@
+// This file is part of the OGRE project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at https://www.ogre3d.org/licensing.
+module;
+
+#include <cstddef>
+
+export module Ogre.Core:ShaderTelemetry;
+
+export import :MemoryAllocatorConfig;
+export import :Platform;
+export import :Prerequisites;
+export import :Singleton;
+
+export import <atomic>;
+export import <iosfwd>;
+export import <mutex>;
+export import <string>;
+export import <string_view>;
+export import <utility>;
+export import <vector>;
+
+export
+namespace Ogre
+{
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup General
+    *  @{
+    */
+
+    /** Records every shader generated, compiled and linked, to find what a run still creates on the fly.
+    @remarks
+        Every event comes with its duration, the frame it happened in, see Root::getNextFrameNumber,
+        and the material, resource group and scheme of the pass which caused it. Compiles and
+        links tell whether their binary came from the microcode cache, see
+        GpuProgramManager::setSaveMicrocodesToCache. The shader generation of the RTSS records
+        the variant it generates, so writeVariantManifest can list them for the pre-warming of
+        the next run, see RTShader::ShaderGenerator::warmUpVariants.
+    @par
+        The pass is that being loaded, see Pass::_load, or the last one set by
+        SceneManager::_setPass on the same thread. Recording costs a lock and a few strings
+        per event. Disabled by default.
+    */
+    class ShaderTelemetry : public Singleton<ShaderTelemetry>, public ProfilerAlloc
+    {
+    public:
+        enum class EventType : uint8
+        {
+            /// The programs of a technique were generated, by the RTSS
+            GENERATION,
+            /// A program was compiled
+            COMPILE,
+            /// The programs of a pass were linked, or issued to be linked
+            LINK
+        };
+
+        /// What a program was created for
+        struct Variant
+        {
+            String material;
+            String group;
+            /// The scheme of the source technique, for GENERATION only
+            String sourceScheme;
+            /// The scheme of the technique, which was generated for GENERATION
+            String scheme;
+            /// Whether the generated technique replaces programmable passes, for GENERATION only
+            bool overProgrammable{false};
+        };
+
+        struct Event
+        {
+            EventType type;
+            /** The program or, for LINK, the programs linked.
+            @remarks
+                The material for GENERATION, or "RTSS programs" for the programs of several
+                techniques created at once, which then has no variant.
+            */
+            String program;
+            Variant variant;
+            unsigned long frame;
+            uint64 microseconds;
+            /// Whether the microcode cache provided the binary
+            bool cacheHit;
+        };
+
+        /** Records an event lasting as long as its scope, if enabled */
+        class Scope
+        {
+        public:
+            /** Takes the variant from the current pass of the thread */
+            Scope(EventType type, std::string_view program);
+            ~Scope();
+
+            Scope(const Scope&) = delete;
+            auto operator=(const Scope&) -> Scope& = delete;
+
+            [[nodiscard]] auto isRecording() const noexcept -> bool { return mRecording; }
+
+            void setCacheHit(bool hit) { mEvent.cacheHit = hit; }
+            /// Replaces the variant taken from the current pass
+            void setVariant(Variant variant) { mEvent.variant = std::move(variant); }
+
+        private:
+            Event mEvent;
+            bool mRecording{false};
+            /// Microseconds of the steady clock
+            uint64 mStart{0};
+        };
+
+        /** Makes a pass the current one of the thread for its scope */
+        class PassScope
+        {
+        public:
+            explicit PassScope(const Pass* pass) : mPrevious(msCurrentPass) { msCurrentPass = pass; }
+            ~PassScope() { msCurrentPass = mPrevious; }
+
+            PassScope(const PassScope&) = delete;
+            auto operator=(const PassScope&) -> PassScope& = delete;
+
+        private:
+            const Pass* mPrevious;
+        };
+
+        ShaderTelemetry();
+        ~ShaderTelemetry();
+
+        void setEnabled(bool enabled) { mEnabled.store(enabled, std::memory_order_relaxed); }
+        [[nodiscard]] auto isEnabled() const noexcept -> bool { return mEnabled.load(std::memory_order_relaxed); }
+
+        /// Gets a copy of the events recorded so far, in the order they ended
+        [[nodiscard]] auto getEvents() const -> std::vector<Event>;
+
+        /// Forgets the events recorded so far
+        void clear();
+
+        /** Writes the events as lines of tab separated values, with a header line.
+        @remarks
+            The columns are the type, program, material, group, source scheme, scheme, frame,
+            microseconds and whether the cache was hit.
+        */
+        void writeEvents(std::ostream& stream) const;
+
+        /** Writes the variants generated, each once, in the manifest format of the RTSS.
+        @remarks
+            A line per variant: the material, group, source scheme, scheme and 0 or 1 for
+            overProgrammable, separated by tabs. RTShader::ShaderGenerator::warmUpVariants
+            reads it to generate them ahead of time.
+        */
+        void writeVariantManifest(std::ostream& stream) const;
+
+        /** Sets the current pass of the thread, see PassScope
+        @remarks
+            Called by SceneManager::_setPass, as the programs are linked when drawing.
+        */
+        static void _setCurrentPass(const Pass* pass) noexcept { msCurrentPass = pass; }
+
+        /// @copydoc Singleton::getSingleton()
+        static auto getSingleton() noexcept -> ShaderTelemetry&;
+        /// @copydoc Singleton::getSingleton()
+        static auto getSingletonPtr() noexcept -> ShaderTelemetry*;
+
+    private:
+        void record(Event event);
+
+        std::atomic<bool> mEnabled{false};
+
+        mutable std::mutex mMutex;
+        std::vector<Event> mEvents;
+
+        static thread_local const Pass* msCurrentPass;
+    };
+    /** @} */
+    /** @} */
+}
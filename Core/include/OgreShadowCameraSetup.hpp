@@ -80,6 +80,21 @@ class Viewport;
         /// Function to implement -- must set the shadow camera properties
         virtual void getShadowCamera (const SceneManager *sm, const Camera *cam, 
                                       const Viewport *vp, const Light *light, Camera *texCam, size_t iteration) const = 0;
+        /** Gets the number of iterations rendered as tiles into the texture of the first one.
+        @remarks
+            The SceneManager then renders this many consecutive shadow textures of a light
+            into viewports of the first texture, all at once, and the receivers sample the
+            tiles of it instead of the other textures. 1, the default, renders every
+            iteration into its own texture.
+        */
+        [[nodiscard]] virtual auto getAtlasTileCount() const -> size_t { return 1; }
+        /** Gets the number of frames between updates of the shadow texture of an iteration.
+        @remarks
+            In between, the texture and its camera are kept as they are, unless the texture
+            is used by another light or for another viewer camera. 1, the default, updates
+            every frame.
+        */
+        [[nodiscard]] virtual auto getUpdateInterval(size_t iteration) const -> size_t { return 1; }
         /// Need virtual destructor in case subclasses use it
         virtual ~ShadowCameraSetup() = default;
 
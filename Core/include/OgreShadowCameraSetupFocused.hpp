@@ -33,7 +33,7 @@ module;
 export module Ogre.Core:ShadowCameraSetupFocused;
 
 export import :AxisAlignedBox;
-export import :ConvexBody;
+export import :ConvexPolytope;
 export import :Light;
 export import :Matrix4;
 export import :Polygon;
@@ -77,7 +77,8 @@ class Viewport;
         SceneNode mLightFrustumCameraNode;
         std::unique_ptr<Camera> mLightFrustumCamera;
         // Persistent calculations to prevent reallocation
-        mutable ConvexBody mBodyB;
+        mutable ConvexPolytope mBodyB;
+        mutable ConvexPolytope mBodyLVS;
         /// Use tighter focus region?
         bool mUseAggressiveRegion;
     protected:
@@ -102,7 +103,7 @@ class Viewport;
 
         public:
             PointListBody();
-            PointListBody(const ConvexBody& body);
+            PointListBody(const ConvexPolytope& body);
             ~PointListBody();
 
             /** Merges a second PointListBody into this one.
@@ -113,7 +114,7 @@ class Viewport;
             @remarks
                 Inserts all vertices from a body into the point list with or without adding duplicate vertices.
             */
-            void build(const ConvexBody& body, bool filterDuplicates = true);
+            void build(const ConvexPolytope& body, bool filterDuplicates = true);
 
             /** Builds a PointListBody from a Body and includes all the space in a given direction.
             @remarks
@@ -124,7 +125,7 @@ class Viewport;
             @note
                 Body is not checked for correctness.
             */
-            void buildAndIncludeDirection(const ConvexBody& body, 
+            void buildAndIncludeDirection(const ConvexPolytope& body, 
                 Real extrudeDist, const Vector3& dir);
 
             /** Returns the bounding box representation.
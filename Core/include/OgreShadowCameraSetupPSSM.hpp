@@ -0,0 +1,169 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+module;
+
+#include <cstddef>
+
+export module Ogre.Core:ShadowCameraSetupPSSM;
+
+export import :Prerequisites;
+export import :SceneManager;
+export import :ShadowCameraSetupLiSPSM;
+
+export import <memory>;
+export import <vector>;
+
+export
+namespace Ogre
+{
+class Camera;
+class Light;
+class Viewport;
+
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Scene
+    *  @{
+    */
+    /** Parallel Split Shadow Map (PSSM) shadow camera setup.
+    @remarks
+        A PSSM shadow system uses multiple shadow maps per light and maps each texture
+        into a region of space, progressing away from the camera. As such it is most
+        appropriate for directional light setups. Iteration i of the light covers the
+        view distances from split point i to split point i + 1, so the number of shadow
+        textures per directional light has to be set to the number of splits, e.g. with
+        SceneManager::setShadowTextureCountPerLightType.
+    @par
+        With stable cascades, the default, the projection of a split is an orthographic
+        box of fixed size and orientation around the bounding sphere of the split, moved
+        in steps of whole texels only. The shadow edges therefore do not shimmer when the
+        camera moves or turns, at the cost of some resolution. The box reaches back to the
+        scene bounds along the light, but not sideways, so only casters which can shadow
+        the split are rendered into it. Otherwise, and for other than directional lights,
+        each split is focused with LiSPSM.
+    @par
+        With the atlas enabled, the default, all splits are rendered as tiles into the first
+        shadow texture of the light, see getAtlasTileCount, so the texture should be
+        sufficiently large. Receivers get the tile through the texture_viewproj_matrix
+        auto parameters; fixed function projective texturing does not know about tiles.
+    */
+    class PSSMShadowCameraSetup : public LiSPSMShadowCameraSetup
+    {
+    public:
+        using SplitPointList = std::vector<Real>;
+
+        /// @deprecated use create()
+        PSSMShadowCameraSetup();
+        ~PSSMShadowCameraSetup() override;
+
+        static auto create() -> ShadowCameraSetupPtr
+        {
+            return std::make_shared<PSSMShadowCameraSetup>();
+        }
+
+        /** Calculates the split points using the practical split scheme.
+        @remarks
+            The split points blend a logarithmic distribution, which fits the perspective
+            aliasing best, with a uniform one, which avoids tiny splits close to the camera.
+        @param splitCount The number of splits
+        @param nearDist The near plane to use for the first split
+        @param farDist The far plane to use for the last split
+        @param lambda Weight of the logarithmic distribution, between 0 (uniform) and 1
+        */
+        void calculateSplitPoints(size_t splitCount, Real nearDist, Real farDist, Real lambda = 0.95);
+
+        /** Manually configures the split points, with the near plane of the first split
+            first and the far plane of the last split last.
+        */
+        void setSplitPoints(const SplitPointList& newSplitPoints);
+        [[nodiscard]] auto getSplitPoints() const noexcept -> const SplitPointList& { return mSplitPoints; }
+        [[nodiscard]] auto getSplitCount() const noexcept -> size_t { return mSplitPoints.size() - 1; }
+
+        /** Sets the LiSPSM optimal adjust factor of one split, see
+            LiSPSMShadowCameraSetup::setOptimalAdjustFactor.
+        @remarks
+            Only used for splits which are not stable, 1 for all by default.
+        */
+        void setOptimalAdjustFactor(size_t splitIndex, Real factor);
+        /// Returns the optimal adjust factor of the split currently set up
+        [[nodiscard]] auto getOptimalAdjustFactor() const noexcept -> Real override;
+        [[nodiscard]] auto getOptimalAdjustFactor(size_t splitIndex) const -> Real;
+
+        /** Sets the distance by which neighbouring splits overlap, to hide the seams.
+        @remarks
+            Both ends of every split are moved outwards by this distance, 1 by default.
+        */
+        void setSplitPadding(Real pad) { mSplitPadding = pad; }
+        [[nodiscard]] auto getSplitPadding() const noexcept -> Real { return mSplitPadding; }
+
+        /// Sets whether the splits of directional lights use stable projections, see the class
+        void setStableCascades(bool stable) { mStableCascades = stable; }
+        [[nodiscard]] auto getStableCascades() const noexcept -> bool { return mStableCascades; }
+
+        /// Sets whether all splits are rendered into one texture, see the class
+        void setAtlasEnabled(bool enabled) { mAtlasEnabled = enabled; }
+        [[nodiscard]] auto getAtlasEnabled() const noexcept -> bool { return mAtlasEnabled; }
+
+        /// Returns the split count with the atlas enabled, 1 otherwise
+        [[nodiscard]] auto getAtlasTileCount() const -> size_t override
+        {
+            return mAtlasEnabled ? getSplitCount() : 1;
+        }
+
+        /** Sets the number of frames between updates of a split, 1 for all by default.
+        @remarks
+            Far splits cover large areas in few texels, so their shadows hardly change from
+            frame to frame. Splits with the same interval are updated in different frames.
+            A split lags behind the camera in between, so give it some padding.
+        */
+        void setUpdateInterval(size_t splitIndex, size_t frames);
+        /// @copydoc ShadowCameraSetup::getUpdateInterval
+        [[nodiscard]] auto getUpdateInterval(size_t iteration) const -> size_t override;
+
+        /// Returns a shadow camera covering the split given by iteration
+        void getShadowCamera(const SceneManager *sm, const Camera *cam,
+            const Viewport *vp, const Light *light, Camera *texCam, size_t iteration) const override;
+
+    private:
+        /// Sets up texCam as the stable projection of the given view distances
+        void getStableShadowCamera(const SceneManager *sm, const Camera *cam,
+            const Light *light, Camera *texCam, Real nearDist, Real farDist) const;
+
+        SplitPointList mSplitPoints;
+        std::vector<Real> mOptimalAdjustFactors;
+        std::vector<size_t> mUpdateIntervals;
+        mutable size_t mCurrentIteration{0};
+        Real mSplitPadding{1};
+        bool mStableCascades{true};
+        bool mAtlasEnabled{true};
+    };
+    /** @} */
+    /** @} */
+
+}
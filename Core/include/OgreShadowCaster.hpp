@@ -38,6 +38,7 @@ export import :Prerequisites;
 export import :RenderOperation;
 export import :Renderable;
 export import :SharedPtr;
+export import :Vector;
 
 export import <vector>;
 
@@ -242,7 +243,62 @@ class VertexData;
             size_t originalVertexCount, const Vector4& lightPos, Real extrudeDist);
         /** Get the distance to extrude for a point/spot light. */
         virtual auto getPointExtrusionDistance(const Light* l) const -> Real = 0;
+
+        /** Sets how many shadow volumes each caster keeps for reuse, 4 by default.
+        @remarks
+            The indexes of the shadow volume of a caster are kept per light, and copied into the
+            shadow index buffer instead of being generated again as long as the light position
+            in object space, the flags and the edge list did not change, i.e. neither the caster
+            nor the light moved. The volume used least recently is replaced by the one of another
+            light. 0 disables the caching.
+        */
+        static void setShadowVolumeCacheSize(size_t size) { msShadowVolumeCacheSize = size; }
+        static auto getShadowVolumeCacheSize() noexcept -> size_t { return msShadowVolumeCacheSize; }
+        /** Drops the cached shadow volumes of this caster, to be called whenever the geometry
+            changes without the edge list being rebuilt */
+        void invalidateShadowVolumeCache() { mShadowVolumeCache.clear(); }
     protected:
+        /// The indexes of a shadow volume and the light position they were generated for
+        struct ShadowVolume
+        {
+            Vector4 lightPos;
+            ShadowRenderableFlags flags{};
+            const EdgeData* edgeData{nullptr};
+            unsigned long lastUse{0};
+            std::vector<unsigned short> indexes;
+            /// Index count of each renderable, followed by the one of its light cap if separate
+            std::vector<size_t> indexCounts;
+        };
+        std::vector<ShadowVolume> mShadowVolumeCache;
+        unsigned long mShadowVolumeCacheUse{0};
+        /// Used by generateShadowVolume, to keep the allocation
+        ShadowVolume mShadowVolumeScratch;
+        static size_t msShadowVolumeCacheSize;
+
+        /** Updates the light facing of the edge data and generates the shadow volume, or reuses a
+            cached one, see setShadowVolumeCacheSize.
+        @param edgeData
+            The edge information to use.
+        @param lightPos
+            4D light position in object space, as passed to updateEdgeListLightFacing.
+        @param geometryChanged
+            Whether the vertices moved since the last update, e.g. by animation, so that
+            no cached volume is valid.
+        @see generateShadowVolume for the other parameters
+        */
+        void updateShadowVolume(EdgeData* edgeData, const Vector4& lightPos,
+            const HardwareIndexBufferSharedPtr& indexBuffer, size_t& indexBufferUsedSize,
+            const Light* light, ShadowRenderableList& shadowRenderables, ShadowRenderableFlags flags,
+            bool geometryChanged);
+        /** Generates the indexes of a shadow volume from the light facing of the edge data
+            into volume, see generateShadowVolume */
+        void buildShadowVolume(EdgeData* edgeData, const Light* light,
+            const ShadowRenderableList& shadowRenderables, ShadowRenderableFlags flags, ShadowVolume& volume);
+        /** Copies the indexes of volume into the index buffer and updates the shadow renderables
+            to use them, see generateShadowVolume */
+        static void writeShadowVolume(const ShadowVolume& volume, const HardwareIndexBufferSharedPtr& indexBuffer,
+            size_t& indexBufferUsedSize, ShadowRenderableList& shadowRenderables);
+
         /** Tells the caster to perform the tasks necessary to update the 
             edge data's light listing. Can be overridden if the subclass needs 
             to do additional things. 
@@ -86,6 +86,7 @@ class SceneManager;
 
         void setTransform( const Affine3& xform );
         void getWorldTransforms( Matrix4* xform ) const override;
+        auto getWorldTransformNode() const noexcept -> const Node* override { return mParentNode; }
 
 
         void _notifyCurrentCamera(Camera* cam) override;
@@ -33,14 +33,19 @@ export module Ogre.Core:Skeleton;
 
 export import :Animation;
 export import :IteratorWrapper;
+export import :NodeTransformSoA;
 export import :Platform;
 export import :Prerequisites;
+export import :Quaternion;
 export import :Resource;
 export import :SharedPtr;
 export import :StringVector;
+export import :Vector;
 
 export import <algorithm>;
+export import <atomic>;
 export import <map>;
+export import <mutex>;
 export import <set>;
 export import <string>;
 export import <string_view>;
@@ -267,8 +272,19 @@ auto constexpr inline OGRE_MAX_NUM_BONES = 256;
             animations do not have to sum to 1.0, because some animations may affect only subsets
             of the skeleton. If the weights exceed 1.0 for the same area of the skeleton, the 
             movement will just be exaggerated.
+        @param animSet The animations to apply
+        @param boneMask Optional per bone handle weights applied on top of those of the
+            animation states, e.g. to leave out bones at a low level of detail
         */
-        virtual void setAnimationState(const AnimationStateSet& animSet);
+        virtual void setAnimationState(const AnimationStateSet& animSet,
+            const AnimationState::BoneBlendMask* boneMask = nullptr);
+
+        /** Builds the lazily cached data of the animations enabled in the given set.
+        @remarks
+            Only recommended for use inside the engine. Afterwards setAnimationState may be
+            called on several skeleton instances of this skeleton from different threads.
+        */
+        void _prepareAnimationState(const AnimationStateSet& animSet);
 
 
         /** Initialise an animation set suitable for use with this skeleton. 
@@ -317,6 +333,40 @@ auto constexpr inline OGRE_MAX_NUM_BONES = 256;
         */
         virtual void optimiseAllAnimations(bool preservingIdentityNodeTracks = false);
 
+        /** Compresses the node tracks of all of this skeleton's animations.
+        @remarks
+            Applies any base keyframes and replaces the keyframes of every node
+            track by a CompressedNodeTrack, see NodeAnimationTrack::compress. Best
+            done after optimiseAllAnimations. The skeleton can not be exported
+            afterwards unless the tracks are decompressed again.
+        @param tolerance The largest error allowed
+        @return The number of bytes used by the compressed tracks
+        */
+        auto compressAllAnimations(const CompressedNodeTrack::Tolerance& tolerance = {}) -> size_t;
+
+        /** Sets whether prepare leaves the tracks of each animation to be read on first use.
+        @remarks
+            Has to be set before the skeleton is prepared, see
+            SkeletonSerializer::setDeferAnimationTracks. An animation reads its tracks when it is
+            first looked up by name or index, e.g. once its AnimationState is enabled, so clips
+            that are never played never create their keyframes. Off by default.
+        */
+        void setDeferAnimationTracks(bool defer) { mDeferAnimationTracks = defer; }
+        [[nodiscard]] auto getDeferAnimationTracks() const noexcept -> bool { return mDeferAnimationTracks; }
+
+        /** Keeps the serialised tracks of an animation until it is first used (internal use only).
+        @param anim An animation of this skeleton
+        @param tracks Its ANIMATION_TRACK chunks, see SkeletonSerializer::_importAnimationTracks
+        @param flipEndian Whether the file was of the other endianness
+        */
+        void _deferAnimationTracks(Animation* anim, const DataStreamPtr& tracks, bool flipEndian);
+
+        /// Reads the tracks of all animations still deferred
+        void loadDeferredAnimations();
+
+        /// Gets the number of animations whose tracks are not read yet
+        [[nodiscard]] auto getNumDeferredAnimations() const noexcept -> size_t { return mNumDeferredTracks; }
+
         /** Allows you to use the animations from another Skeleton object to animate
             this skeleton.
         @remarks
@@ -453,6 +503,41 @@ auto constexpr inline OGRE_MAX_NUM_BONES = 256;
         /// Storage of bones, indexed by bone handle
         BoneList mBoneList;
 
+        /// Local bone transforms blended from the animations, indexed by bone handle
+        struct LocalPose
+        {
+            std::vector<Vector3> position;
+            std::vector<Quaternion> orientation;
+            std::vector<Vector3> scale;
+        };
+        LocalPose mLocalPose;
+        /// The bone hierarchy below each root bone, flattened for _updateTransforms
+        std::vector<NodeTransformSoA> mPackedBones;
+        /// Node::_getHierarchyVersion when mPackedBones was built
+        uint64 mPackedBonesVersion{0};
+        /// Whether mPackedBones can replace the recursive bone update
+        bool mPackedBonesSupported{false};
+
+        /// The serialised tracks of an animation, read on first use
+        struct DeferredTracks
+        {
+            DataStreamPtr stream;
+            bool flipEndian;
+        };
+        mutable std::map<const Animation*, DeferredTracks> mDeferredTracks;
+        /// mDeferredTracks.size(), checked without locking
+        mutable std::atomic<size_t> mNumDeferredTracks{0};
+        mutable std::mutex mDeferredTracksMutex;
+        bool mDeferAnimationTracks{false};
+
+        /// Reads the tracks of the animation if they are deferred
+        void loadDeferredTracks(Animation* anim) const;
+
+        /** Rebuilds mPackedBones if the hierarchy changed.
+        @return Whether the packed update can be used, i.e. only Bones are attached to the bones
+        */
+        auto updatePackedBones() -> bool;
+
         /** Internal method which parses the bones to derive the root bone. 
         @remarks
             Must be const because called in getRootBone but mRootBone is mutable
@@ -101,6 +101,16 @@ namespace Ogre {
                     // Quaternion rotate            : Rotation to apply at this keyframe
                     // Vector3 translate            : Translation to apply at this keyframe
                     // Vector3 scale                : Scale to apply at this keyframe
+
+                ANIMATION_TRACK_KEYFRAMES = 0x4120,
+                // All keyframes of the track, replacing ANIMATION_TRACK_KEYFRAME from [Serializer_v2.00]
+
+                    // unsigned int numKeyFrames     : Number of keyframes
+                    // bool hasScale                 : Whether the scales follow
+                    // float times[numKeyFrames]     : The time positions, ascending (seconds)
+                    // float rotates[numKeyFrames*4] : Rotations, w x y z each
+                    // float translates[numKeyFrames*3] : Translations
+                    // float scales[numKeyFrames*3]  : [Optional] Scales
         ANIMATION_LINK         = 0x5000
         // Link to another skeleton, to re-use its animations
 
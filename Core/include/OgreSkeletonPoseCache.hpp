@@ -0,0 +1,135 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+module;
+
+#include <cstddef>
+
+export module Ogre.Core:SkeletonPoseCache;
+
+export import :AnimationState;
+export import :Matrix4;
+export import :MemoryAllocatorConfig;
+export import :Platform;
+export import :Prerequisites;
+
+export import <map>;
+export import <mutex>;
+export import <vector>;
+
+export
+namespace Ogre {
+class SkeletonInstance;
+
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Animation
+    *  @{
+    */
+    /** Shares evaluated bone matrix palettes between skeleton instances in the same pose.
+    @remarks
+        Crowds often play the same animations at about the same time on many instances
+        of one Skeleton. Each pose is identified by a key made of the master skeleton, the
+        resolved animations of the enabled states, and their time positions and weights
+        quantised by getTimeStep and getWeightStep. The first instance to evaluate a pose
+        stores its palette, which later instances with the same key copy instead of
+        evaluating the skeleton themselves.
+    @par
+        Poses are only kept for the frame they were stored in. The cache may be used from
+        several threads at once.
+    @note
+        Instances served from the cache do not update their Bone nodes, so poses are not
+        shared for skeletons with manually controlled bones, and users of the bones (TagPoints,
+        bounds from the skeleton) have to evaluate on their own.
+    */
+    class SkeletonPoseCache : public AnimationAlloc
+    {
+    public:
+        /// Identifies a pose, see makeKey
+        using Key = std::vector<uint64>;
+
+        /// Lookups of the current frame
+        struct Statistics
+        {
+            size_t hits{0};
+            size_t misses{0};
+        };
+
+        /** Sets the time positions treated as equal, in seconds.
+        @remarks
+            Larger steps share more poses, at the cost of up to a step of timing error.
+        */
+        void setTimeStep(Real step) { mTimeStep = step; }
+        [[nodiscard]] auto getTimeStep() const noexcept -> Real { return mTimeStep; }
+        /** Sets the weights (including blend mask weights) treated as equal. */
+        void setWeightStep(Real step) { mWeightStep = step; }
+        [[nodiscard]] auto getWeightStep() const noexcept -> Real { return mWeightStep; }
+
+        /** Builds the key of the pose the given states produce on a skeleton.
+        @param skeleton The skeleton instance to be animated
+        @param animSet The animation states to be applied
+        @param boneMask The additional bone weights passed to Skeleton::setAnimationState, if any
+        @param key Receives the key
+        @return Whether the pose can be shared at all
+        */
+        auto makeKey(const SkeletonInstance& skeleton, const AnimationStateSet& animSet,
+                     const AnimationState::BoneBlendMask* boneMask, Key& key) const -> bool;
+
+        /** Copies the palette of a pose stored in the current frame.
+        @return Whether the pose was found
+        */
+        auto find(const Key& key, Affine3* matrices, size_t count) -> bool;
+
+        /** Stores the palette of a pose for the current frame. */
+        void insert(const Key& key, const Affine3* matrices, size_t count);
+
+        /** Removes all poses. */
+        void clear();
+
+        /** Gets the number of poses stored in the current frame. */
+        [[nodiscard]] auto getNumPoses() const -> size_t;
+        /** Gets the lookups of the current frame. */
+        [[nodiscard]] auto getStatistics() const -> Statistics;
+
+    private:
+        Real mTimeStep{1.0f / 120};
+        Real mWeightStep{1.0f / 256};
+
+        mutable std::mutex mMutex;
+        /// Frame of the stored poses
+        unsigned long mFrame{0};
+        std::map<Key, std::vector<Affine3>> mPoses;
+        Statistics mStatistics;
+
+        /// Drops the poses of earlier frames, with mMutex held
+        void beginFrame();
+    };
+    /** @} */
+    /** @} */
+
+}
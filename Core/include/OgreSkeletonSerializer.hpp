@@ -51,6 +51,8 @@ class TransformKeyFrame;
         _1_0,
         /// OGRE version v1.8+
         _1_8,
+        /// The keyframes of a track in one block
+        _2_0,
         
         /// Latest version available
         Latest = 100
@@ -112,6 +114,24 @@ class TransformKeyFrame;
         */
         void importSkeleton(DataStreamPtr& stream, Skeleton* pDest);
 
+        /** Sets whether importSkeleton leaves the tracks of each animation to be read on first use.
+        @remarks
+            Only files of SkeletonVersion::_2_0 and later are deferred. The animations are created
+            with their length and base keyframe, while the serialised tracks are copied in one read
+            and handed to the Skeleton, which creates the keyframes when the animation is first
+            looked up, see Skeleton::setDeferAnimationTracks. Off by default.
+        */
+        void setDeferAnimationTracks(bool defer) { mDeferAnimationTracks = defer; }
+        [[nodiscard]] auto getDeferAnimationTracks() const noexcept -> bool { return mDeferAnimationTracks; }
+
+        /** Reads the tracks of an animation deferred by importSkeleton (internal use only).
+        @param stream The ANIMATION_TRACK chunks of the animation
+        @param flipEndian Whether the file was of the other endianness
+        @param anim The animation to create the tracks in
+        @param pSkel The skeleton of the bones
+        */
+        void _importAnimationTracks(const DataStreamPtr& stream, bool flipEndian, Animation* anim, Skeleton* pSkel);
+
         // TODO: provide Cal3D importer?
 
     private:
@@ -123,8 +143,9 @@ class TransformKeyFrame;
         void writeBone(const Skeleton* pSkel, const Bone* pBone);
         void writeBoneParent(const Skeleton* pSkel, unsigned short boneId, unsigned short parentId);
         void writeAnimation(const Skeleton* pSkel, const Animation* anim, SkeletonVersion ver);
-        void writeAnimationTrack(const Skeleton* pSkel, const NodeAnimationTrack* track);
+        void writeAnimationTrack(const Skeleton* pSkel, const NodeAnimationTrack* track, SkeletonVersion ver);
         void writeKeyFrame(const Skeleton* pSkel, const TransformKeyFrame* key);
+        void writeKeyFrames(const Skeleton* pSkel, const NodeAnimationTrack* track);
         void writeSkeletonAnimationLink(const Skeleton* pSkel, 
             const LinkedSkeletonAnimationSource& link);
 
@@ -135,21 +156,21 @@ class TransformKeyFrame;
         void readAnimation(DataStreamPtr& stream, Skeleton* pSkel);
         void readAnimationTrack(DataStreamPtr& stream, Animation* anim, Skeleton* pSkel);
         void readKeyFrame(DataStreamPtr& stream, NodeAnimationTrack* track, Skeleton* pSkel);
+        void readKeyFrames(const DataStreamPtr& stream, NodeAnimationTrack* track);
         void readSkeletonAnimationLink(DataStreamPtr& stream, Skeleton* pSkel);
 
         auto calcBoneSize(const Skeleton* pSkel, const Bone* pBone) -> size_t;
         auto calcBoneSizeWithoutScale(const Skeleton* pSkel, const Bone* pBone) -> size_t;
         auto calcBoneParentSize(const Skeleton* pSkel) -> size_t;
         auto calcAnimationSize(const Skeleton* pSkel, const Animation* pAnim, SkeletonVersion ver) -> size_t;
-        auto calcAnimationTrackSize(const Skeleton* pSkel, const NodeAnimationTrack* pTrack) -> size_t;
+        auto calcAnimationTrackSize(const Skeleton* pSkel, const NodeAnimationTrack* pTrack, SkeletonVersion ver) -> size_t;
+        auto calcKeyFramesSize(const NodeAnimationTrack* pTrack) -> size_t;
         auto calcKeyFrameSize(const Skeleton* pSkel, const TransformKeyFrame* pKey) -> size_t;
         auto calcKeyFrameSizeWithoutScale(const Skeleton* pSkel, const TransformKeyFrame* pKey) -> size_t;
         auto calcSkeletonAnimationLinkSize(const Skeleton* pSkel, 
             const LinkedSkeletonAnimationSource& link) -> size_t;
 
-
-
-
+        bool mDeferAnimationTracks{false};
     };
     /** @} */
     /** @} */
@@ -0,0 +1,130 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+module;
+
+#include <cstddef>
+
+export module Ogre.Core:SkinnedVertexCache;
+
+export import :Common;
+export import :MemoryAllocatorConfig;
+export import :Prerequisites;
+export import :Renderable;
+export import :SharedPtr;
+
+export import <memory>;
+export import <string_view>;
+export import <vector>;
+
+export
+namespace Ogre {
+struct Affine3;
+class Camera;
+struct Matrix4;
+class RenderOperation;
+class SceneManager;
+class VertexData;
+
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Animation
+    *  @{
+    */
+    /** Skins a set of vertices once per frame on the GPU and keeps the result.
+        @remarks
+            The source vertices are rendered as a point list through a skinning
+            material into a RenderToVertexBuffer, i.e. via transform feedback.
+            The skinned positions (and normals) are then bound, together with the
+            remaining elements of the source vertex data, in getVertexData so every
+            subsequent pass of the frame - shadow casters included - draws the cached
+            result with an ordinary, non-skinning material instead of repeating the
+            skinning work.
+        @par
+            The first pass of the skinning material must have a vertex program which
+            reads the bone matrices from the world_matrix_array_3x4 (or a dual
+            quaternion equivalent) auto constant, writes the object space skinned
+            position to the position output and, if the source has normals, the skinned
+            normal to the first texture coordinate output. Which blending method is
+            used is entirely up to that program.
+        @note
+            Requires a render system with Capabilities::HWRENDER_TO_VERTEX_BUFFER.
+    */
+    class SkinnedVertexCache : public Renderable, public AnimationAlloc
+    {
+    public:
+        /** Constructor.
+        @param sourceData The bind pose vertex data, must outlive this object.
+        @param blendIndexToBoneIndexMap Maps the blend indices of the source to the bones.
+        @param materialName The skinning material, see the class description.
+        */
+        SkinnedVertexCache(const VertexData* sourceData, const std::vector<unsigned short>& blendIndexToBoneIndexMap,
+                           std::string_view materialName);
+        ~SkinnedVertexCache() override;
+
+        /** Skins the source vertices with the given bone matrices into the cache.
+        @param boneMatrices Object space bone matrices, indexed by bone handle.
+        @param sceneMgr The scene manager used to set up the skinning pass.
+        */
+        void update(const Affine3* boneMatrices, SceneManager* sceneMgr);
+
+        /** The vertex data to bind in place of the source data, valid after the first update. */
+        [[nodiscard]] auto getVertexData() const noexcept -> VertexData* { return mVertexData.get(); }
+
+        /** Whether the skinned normals are cached as well. */
+        [[nodiscard]] auto getIncludesNormals() const noexcept -> bool { return mIncludesNormals; }
+
+        /** @copydoc Renderable::getMaterial */
+        auto getMaterial() const noexcept -> const MaterialPtr& override { return mMaterial; }
+        /** @copydoc Renderable::getRenderOperation */
+        void getRenderOperation(RenderOperation& op) override;
+        /** @copydoc Renderable::getWorldTransforms */
+        void getWorldTransforms(Matrix4* xform) const override;
+        /** @copydoc Renderable::getNumWorldTransforms */
+        auto getNumWorldTransforms() const noexcept -> unsigned short override;
+        /** @copydoc Renderable::getSquaredViewDepth */
+        auto getSquaredViewDepth(const Camera* cam) const -> Real override { return 0; }
+        /** @copydoc Renderable::getLights */
+        auto getLights() const noexcept -> const LightList& override { return mLightList; }
+
+    private:
+        const VertexData* mSourceData;
+        const std::vector<unsigned short>& mBlendIndexToBoneIndexMap;
+        /// Bone matrices of the update in progress
+        const Affine3* mBoneMatrices{nullptr};
+        MaterialPtr mMaterial;
+        RenderToVertexBufferSharedPtr mRenderToBuffer;
+        /// Source data with position and normal redirected to the skinned buffer
+        std::unique_ptr<VertexData> mVertexData;
+        unsigned short mSkinnedBufferSource;
+        bool mIncludesNormals;
+        LightList mLightList;
+    };
+    /** @} */
+    /** @} */
+}
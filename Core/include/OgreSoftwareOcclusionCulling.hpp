@@ -0,0 +1,175 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+module;
+
+#include <cstddef>
+
+export module Ogre.Core:SoftwareOcclusionCulling;
+
+export import :Matrix4;
+export import :Platform;
+export import :Prerequisites;
+export import :Vector;
+export import :VisibilityStage;
+
+export import <map>;
+export import <unordered_set>;
+export import <vector>;
+
+export
+namespace Ogre {
+class Camera;
+class Entity;
+class Mesh;
+class SceneManager;
+class SceneNode;
+
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Scene
+    *  @{
+    */
+    /** Occlusion culling of scene nodes against a depth buffer rasterized on the CPU.
+    @remarks
+        At the start of the frame the triangles of the registered occluders are rasterized
+        into a small depth buffer. The screen rectangle of the bounds of every node in the
+        frustum is then compared against it, and nodes completely behind the occluders are
+        skipped along with their subtree. Unlike OcclusionCulling the result is available
+        in the same frame and no GPU support is needed, but only the occluders hide other
+        objects, so they should be few, large and of low triangle count, e.g. the walls of
+        a building or simplified terrain.
+    @par
+        Register it with SceneManager::addVisibilityStage. The stage is not owned by the
+        SceneManager and has to be removed from it before it is destroyed.
+    @note
+        Occluders are rasterized in their bind pose, so skeletal or vertex animation is
+        ignored. Coverage is sampled at the pixel centres, so the edges of the occluders
+        may hide objects which are visible by less than a pixel of the depth buffer.
+    */
+    class SoftwareOcclusionCulling : public VisibilityStage
+    {
+    public:
+        /// Statistics about the last culled frame
+        struct Stats
+        {
+            /// Number of occluders inside the frustum
+            size_t occludersRasterized{0};
+            /// Number of triangles written to the depth buffer, after near plane clipping
+            size_t trianglesRasterized{0};
+            /// Number of nodes whose visibility was checked
+            size_t nodesTested{0};
+            /// Number of nodes skipped because they were occluded
+            size_t nodesCulled{0};
+            /// Time spent rasterizing the occluders
+            uint64 rasterizeMicroseconds{0};
+        };
+
+        SoftwareOcclusionCulling();
+        ~SoftwareOcclusionCulling() override;
+
+        SoftwareOcclusionCulling(const SoftwareOcclusionCulling&) = delete;
+        auto operator=(const SoftwareOcclusionCulling&) -> SoftwareOcclusionCulling& = delete;
+
+        /** Sets the size of the depth buffer in pixels, 256x128 by default. */
+        void setResolution(uint32 width, uint32 height);
+        /** Gets the width of the depth buffer. */
+        auto getWidth() const noexcept -> uint32 { return mWidth; }
+        /** Gets the height of the depth buffer. */
+        auto getHeight() const noexcept -> uint32 { return mHeight; }
+
+        /** Adds an entity whose mesh hides the objects behind it.
+        @remarks
+            The triangles of the mesh are read once and shared between all occluders using
+            it, so the vertex buffers must be readable. The entity has to be removed before
+            it is destroyed.
+        */
+        void addOccluder(Entity* ent);
+        /** Removes an occluder added with addOccluder. */
+        void removeOccluder(Entity* ent);
+        /** Removes all occluders. */
+        void removeAllOccluders();
+        /** Gets the registered occluders. */
+        auto getOccluders() const noexcept -> const std::vector<Entity*>& { return mOccluders; }
+
+        /** Gets the statistics about the last culled frame. */
+        auto getStats() const noexcept -> const Stats& { return mStats; }
+
+        /** Gets the depth buffer of the last frame, row by row from the top.
+        @remarks
+            Holds the normalised device depth of the closest occluder, or +FLT_MAX where
+            there is none.
+        */
+        auto getDepthBuffer() const noexcept -> const std::vector<float>& { return mDepth; }
+
+        /** Rasterizes the occluders inside the frustum of the camera. */
+        void _beginFrame(const Camera* cam, SceneManager* sceneMgr) override;
+
+        /** Tests the screen rectangle of the bounds against the depth buffer.
+        @remarks
+            Always returns true outside of _beginFrame / _endFrame, for infinite bounds,
+            bounds crossing the near plane and nodes carrying an occluder.
+        */
+        auto _isVisible(const SceneNode* node, const AxisAlignedBox& bounds) -> bool override;
+
+        void _endFrame(SceneManager* sceneMgr) override;
+
+        /** Removes all occluders, as their entities are destroyed with the nodes. */
+        void _notifyAllNodesDestroyed() override;
+
+    private:
+        /// Object space triangles of a mesh, three vertices per triangle
+        using TriangleList = std::vector<Vector3>;
+
+        std::vector<Entity*> mOccluders;
+        std::map<const Mesh*, TriangleList> mMeshTriangles;
+        /// Nodes carrying a visible occluder in the current frame
+        std::unordered_set<const SceneNode*> mOccluderNodes;
+
+        uint32 mWidth{256};
+        uint32 mHeight{128};
+        std::vector<float> mDepth;
+
+        Matrix4 mViewProj{Matrix4::IDENTITY};
+        bool mActive{false};
+        Stats mStats;
+
+        /// Clip space vertices of the occluder being rasterized
+        std::vector<Vector4> mClipVertices;
+
+        static auto buildTriangles(const Mesh* mesh) -> TriangleList;
+        void rasterizeOccluder(const Entity* ent, const TriangleList& triangles);
+        void rasterizeTriangle(const Vector4& a, const Vector4& b, const Vector4& c);
+        /// Rasterizes a triangle in screen space, x and y in pixels and z the depth
+        void rasterizeScreenTriangle(Vector3 a, Vector3 b, Vector3 c);
+        auto toScreen(const Vector4& clip) const -> Vector3;
+    };
+    /** @} */
+    /** @} */
+
+}
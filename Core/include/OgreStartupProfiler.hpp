@@ -0,0 +1,157 @@
+// This file is part of the OGRE project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at https://www.ogre3d.org/licensing.
+module;
+
+#include <cstddef>
+
+export module Ogre.Core:StartupProfiler;
+
+export import :MemoryAllocatorConfig;
+export import :Platform;
+export import :Prerequisites;
+export import :Singleton;
+
+export import <atomic>;
+export import <iosfwd>;
+export import <limits>;
+export import <mutex>;
+export import <string>;
+export import <string_view>;
+export import <thread>;
+export import <vector>;
+
+export
+namespace Ogre
+{
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup General
+    *  @{
+    */
+
+    /** Times the phases of the startup, from the construction of Root to the first frame.
+    @remarks
+        Root creates it first thing and records the loading of plugins, the initialisation
+        of the RenderSystem and its capabilities, every resource group initialised, every
+        script parsed, every shader compiled and every mesh loaded, on whichever thread.
+        Phases nest per thread. When the first frame starts, finish logs the duration of
+        the startup and its critical path: the chain of phases, back to back, that the
+        startup had to wait for, so moving anything else to other threads would not make
+        it shorter. The time between the leaf phases of the chain is attributed to the
+        phase enclosing it, as its own work.
+    @par
+        The phases stay available for tools, see getPhases and writeTrace. Recording
+        costs a lock per phase and stops with finish.
+    */
+    class StartupProfiler : public Singleton<StartupProfiler>, public ProfilerAlloc
+    {
+    public:
+        enum class PhaseType : uint8
+        {
+            PLUGIN_LOAD,
+            RENDER_SYSTEM_INIT,
+            CAPABILITIES,
+            RESOURCE_GROUP,
+            SCRIPT_PARSE,
+            SHADER_COMPILE,
+            MESH_LOAD,
+            OTHER
+        };
+
+        static constexpr size_t NO_PHASE = std::numeric_limits<size_t>::max();
+
+        struct Phase
+        {
+            PhaseType type;
+            String name;
+            /// 0 for the thread which created the StartupProfiler, then in the order the threads were first seen
+            uint32 thread;
+            /// The number of enclosing phases on the same thread
+            uint32 depth;
+            /// Index of the enclosing phase, or NO_PHASE
+            size_t parent;
+            /// Nanoseconds since the StartupProfiler was created
+            uint64 start;
+            /// 0 while running
+            uint64 duration;
+            bool hasChildren;
+        };
+
+        /// A span of the critical path
+        struct PathSpan
+        {
+            /// Index of the phase, or NO_PHASE for time outside of any phase
+            size_t phase;
+            uint64 start;
+            uint64 duration;
+            /// Whether the time lies between children of the phase rather than being a phase without any
+            bool self;
+        };
+
+        /** Records a phase lasting as long as its scope, while recording */
+        class Scope
+        {
+        public:
+            Scope(PhaseType type, std::string_view name);
+            ~Scope();
+
+            Scope(const Scope&) = delete;
+            auto operator=(const Scope&) -> Scope& = delete;
+
+        private:
+            StartupProfiler* mProfiler{nullptr};
+            size_t mPhase{NO_PHASE};
+        };
+
+        StartupProfiler();
+        ~StartupProfiler();
+
+        [[nodiscard]] auto isRecording() const noexcept -> bool { return mRecording.load(std::memory_order_relaxed); }
+
+        /** Stops recording and logs the report, called by Root when the first frame starts.
+        @remarks
+            Does nothing when called again. Phases still running are left out.
+        */
+        void finish();
+
+        /// Gets the nanoseconds from the creation to finish
+        [[nodiscard]] auto getDuration() const noexcept -> uint64 { return mDuration; }
+
+        /// Gets the recorded phases in the order they started, complete once finished
+        [[nodiscard]] auto getPhases() const noexcept -> const std::vector<Phase>& { return mPhases; }
+
+        /// Gets the critical path of the finished startup, in chronological order
+        [[nodiscard]] auto getCriticalPath() const -> std::vector<PathSpan>;
+
+        /** Writes the phases in the Chrome trace event format, the critical path on a track of its own */
+        void writeTrace(std::ostream& stream) const;
+
+        /// The name logged for the type
+        static auto getTypeName(PhaseType type) -> std::string_view;
+
+        /// @copydoc Singleton::getSingleton()
+        static auto getSingleton() noexcept -> StartupProfiler&;
+        /// @copydoc Singleton::getSingleton()
+        static auto getSingletonPtr() noexcept -> StartupProfiler*;
+
+    private:
+        auto beginPhase(PhaseType type, std::string_view name) -> size_t;
+        void endPhase(size_t phase);
+        auto now() const -> uint64;
+
+        std::atomic<bool> mRecording{true};
+        uint64 mEpoch;
+        uint64 mDuration{0};
+
+        std::mutex mMutex;
+        std::vector<Phase> mPhases;
+        std::vector<std::thread::id> mThreads;
+
+        /// The innermost running phase of the thread
+        static thread_local size_t msCurrentPhase;
+    };
+    /** @} */
+    /** @} */
+}
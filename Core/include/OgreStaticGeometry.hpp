@@ -36,6 +36,7 @@ export import :AxisAlignedBox;
 export import :Common;
 export import :IteratorWrapper;
 export import :Material;
+export import :Math;
 export import :MemoryAllocatorConfig;
 export import :Mesh;
 export import :MovableObject;
@@ -53,6 +54,7 @@ export import <iosfwd>;
 export import <list>;
 export import <map>;
 export import <memory>;
+export import <set>;
 export import <string>;
 export import <utility>;
 export import <vector>;
@@ -207,6 +209,8 @@ class Technique;
             Vector3 scale;
         };
         using QueuedGeometryList = std::vector<QueuedGeometry*>;
+        /// Source buffers locked for reading during a build, so worker threads can merge from them
+        using SourceLockMap = std::map<HardwareBuffer*, const uchar*>;
         
         // forward declarations
         class LODBucket;
@@ -231,6 +235,12 @@ class Technique;
             ::std::unique_ptr<IndexData> mIndexData;
             /// Maximum vertex indexable
             size_t mMaxVertexIndex;
+            /// Merged vertices of each buffer, between merge() and upload()
+            std::vector<std::vector<uchar>> mStagingVertices;
+            /// Merged indexes, between merge() and upload()
+            std::vector<uchar> mStagingIndexes;
+            /// Whether merge() ran since the last upload()
+            bool mMerged{false};
         public:
             GeometryBucket(MaterialBucket* parent, const VertexData* vData, const IndexData* iData);
             ~GeometryBucket() override = default;
@@ -252,7 +262,17 @@ class Technique;
             @return false if there is no room left in this bucket
             */
             auto assign(QueuedGeometry* qsm) -> bool;
-            /// Build
+            /// Locks the source buffers of the queued geometry which are not in sourceLocks yet
+            void lockSources(SourceLockMap& sourceLocks) const;
+            /** Transforms the queued geometry into system memory.
+            @remarks
+                This touches neither the hardware buffer managers nor any locks, so it may
+                be called from a worker thread, with all sources locked by lockSources().
+            */
+            void merge(const SourceLockMap& sourceLocks);
+            /// Copies the merged geometry into new hardware buffers
+            void upload(bool stencilShadows);
+            /// Build, merging first unless merge() was already called
             void build(bool stencilShadows);
             /// Dump contents for diagnostics
             void dump(std::ofstream& of) const;
@@ -406,6 +426,14 @@ class Technique;
             Camera *mCamera{nullptr};
             /// Cached squared view depth value to avoid recalculation by GeometryBucket
             Real mSquaredViewDepth{0};
+            /// Node of the region tree this region is built under, the root node if null
+            SceneNode* mTreeNode{nullptr};
+            /// Far-field region showing this one at a distance, if any
+            Region* mFarField{nullptr};
+            /// Whether this region merges the lowest LOD of the regions it replaces at a distance
+            bool mIsFarField{false};
+            /// Whether the far-field setup hides this region for the current camera
+            bool mFarFieldHidden{false};
 
         public:
             Region(StaticGeometry* parent, std::string_view name, SceneManager* mgr, 
@@ -415,8 +443,35 @@ class Technique;
             auto getParent() const noexcept -> StaticGeometry* { return mParent;}
             /// Assign a queued mesh to this region, read for final build
             void assign(QueuedSubMesh* qmesh);
+            /** Attaches the region to a node and distributes the queued meshes to LOD buckets.
+            @remarks
+                After this the geometry buckets are known and can be merged in parallel
+                before finishBuild() is called.
+            */
+            void prepare();
+            /// Builds the buckets set up by prepare()
+            void finishBuild(bool stencilShadows);
             /// Build this region
             void build(bool stencilShadows);
+            /// Releases the built geometry, keeping the queued meshes so it can be built again
+            void unload();
+            /// Whether the geometry of this region is currently built
+            auto isBuilt() const noexcept -> bool { return isAttached(); }
+            /// Sets the node of the region tree to build this region under
+            void _setTreeNode(SceneNode* node) { mTreeNode = node; }
+            /** Makes this region show only the lowest LOD of its meshes, replacing other regions
+                beyond the far-field distance, see StaticGeometry::setFarFieldDistance.
+            @note Must be called before anything is assigned.
+            */
+            void _setIsFarField() { mIsFarField = true; }
+            /// Whether this is a far-field region
+            auto isFarField() const noexcept -> bool { return mIsFarField; }
+            /// Lets farField replace this region at a distance and assigns it the meshes queued so far
+            void _setFarField(Region* farField);
+            /// Get the far-field region replacing this one at a distance, if any
+            auto getFarField() const noexcept -> Region* { return mFarField; }
+            /// Whether this far-field region is used instead of the regions it replaces for a camera
+            auto isFarFieldActive(const Camera* cam) const -> bool;
             /// Get the region ID of this region
             auto getID() const noexcept -> uint32 { return mRegionID; }
             /// Get the centre point of the region
@@ -489,6 +544,38 @@ class Technique;
             
         /// Map of regions
         RegionMap mRegionMap;
+        /// Whether build() was called since the last destroy()
+        bool mBuilt{false};
+        /// Regions which got new geometry since they were built
+        std::set<uint32> mDirtyRegions;
+        /// Distance within which streamed regions are built, 0 disables streaming
+        Real mStreamingLoadDistance{0.0f};
+        /// Distance beyond which streamed regions are released again
+        Real mStreamingUnloadDistance{0.0f};
+        /// Squared distance beyond which clusters of regions are replaced by their far-field region, 0 if disabled
+        Real mSquaredFarFieldDistance{0.0f};
+        /// Nodes of the region tree, parents before their children
+        std::vector<SceneNode*> mRegionTreeNodes;
+        /// Far-field regions of the clusters in the region tree
+        std::vector<Region*> mFarFieldRegions;
+        /// Far-field regions which got new geometry since they were built
+        std::set<Region*> mDirtyFarFields;
+
+        /** Groups the regions into a bounding volume hierarchy of scene nodes.
+        @remarks
+            The scene manager culls the nodes top down, so whole groups of
+            regions are rejected with a single test. Every cluster at the bottom
+            of the tree gets a far-field region if they are enabled.
+        */
+        void buildRegionTree(SceneNode* node, std::vector<Region*>::iterator first,
+                             std::vector<Region*>::iterator last);
+        /// Moves the dirty far-field regions to regions, releasing their geometry
+        void takeDirtyFarFields(std::vector<Region*>& regions);
+
+        /** Builds a set of regions, merging the geometry of all of them on the
+            WorkQueue's worker threads.
+        */
+        void buildRegions(const std::vector<Region*>& regions);
 
         /** Virtual method for getting a region most suitable for the
             passed in bounds. Can be overridden by subclasses.
@@ -577,7 +664,8 @@ class Technique;
             completely safely, and destroy the Entity before destroying 
             this StaticGeometry if you like. The Entity passed in is simply 
             used as a definition.
-        @note Must be called before 'build'.
+        @note If called after 'build', the entity is queued into the region it
+            belongs to, which is then rebuilt by the next rebuildDirtyRegions().
         @param ent The Entity to use as a definition (the Mesh and Materials 
             referenced will be recorded for the build call).
         @param position The world position at which to add this Entity
@@ -588,6 +676,23 @@ class Technique;
             const Quaternion& orientation = Quaternion::IDENTITY, 
             const Vector3& scale = Vector3::UNIT_SCALE);
 
+        /** Adds a single SubMesh to the static geometry.
+        @remarks
+            What addEntity does for each SubEntity, for callers that have no
+            Entity at hand, like SceneSerializer.
+        @param submesh The SubMesh to add, its Mesh has to stay loaded until the build
+        @param material The material to draw it with
+        @param position The world position at which to add the SubMesh
+        @param orientation The world orientation at which to add the SubMesh
+        @param scale The scale at which to add the SubMesh
+        */
+        virtual void addSubMesh(SubMesh* submesh, const MaterialPtr& material, const Vector3& position,
+            const Quaternion& orientation = Quaternion::IDENTITY,
+            const Vector3& scale = Vector3::UNIT_SCALE);
+
+        /// Gets the submeshes queued so far, in the order they were added
+        [[nodiscard]] auto getQueuedSubMeshes() const noexcept -> const QueuedSubMeshList& { return mQueuedSubMeshes; }
+
         /** Adds all the Entity objects attached to a SceneNode and all it's
             children to the static geometry.
         @remarks
@@ -602,7 +707,7 @@ class Technique;
             of rendering <i>both</i> the original objects and their new static
             versions! We don't do this for you incase you are preparing this 
             in advance and so don't want the originals detached yet. 
-        @note Must be called before 'build'.
+        @note If called after 'build', see addEntity.
         @param node Pointer to the node to use to provide a set of Entity 
             templates
         */
@@ -614,11 +719,64 @@ class Technique;
             options which have been set, this method constructs the batched 
             geometry structures required. The batches are added to the scene 
             and will be rendered unless you specifically hide them.
+        @par
+            The geometry of all regions is merged on the worker threads of the
+            Root's WorkQueue, the hardware buffers are created and filled on the
+            calling thread afterwards.
         @note
-            Once you have called this method, you can no longer add any more 
-            entities.
+            Entities added after this method are queued into their region and
+            picked up by rebuildDirtyRegions(), without rebuilding the others.
         */
         virtual void build();
+        /// Whether build() was called since the last destroy()
+        [[nodiscard]] auto isBuilt() const noexcept -> bool { return mBuilt; }
+        /** Rebuilds the regions which got new entities since they were built.
+        @remarks
+            Streamed regions which are currently released are left alone, they
+            include the new entities once they are built again.
+        */
+        void rebuildDirtyRegions();
+        /** Enables streaming of regions, see updateStreaming.
+        @remarks
+            With streaming enabled build() only distributes the entities to the
+            regions, their geometry is built by updateStreaming() once they get
+            close enough and released again when they get far away.
+        @param loadDistance Distance from the region bounds at which the region is built, 0 disables streaming
+        @param unloadDistance Distance at which built regions are released, should be larger than
+            loadDistance to avoid building and releasing regions on the boundary over and over
+        */
+        void setRegionStreamingDistances(Real loadDistance, Real unloadDistance);
+        [[nodiscard]] auto getRegionStreamingLoadDistance() const noexcept -> Real { return mStreamingLoadDistance; }
+        [[nodiscard]] auto getRegionStreamingUnloadDistance() const noexcept -> Real { return mStreamingUnloadDistance; }
+        /** Builds the streamed regions near a position and releases those far away.
+        @remarks
+            Usually called once per frame with the position of the camera, for example
+            from a FrameListener. All regions which need building are built together,
+            like build() does.
+        */
+        void updateStreaming(const Vector3& position);
+        /// Whether region streaming is enabled
+        [[nodiscard]] auto isRegionStreamingEnabled() const noexcept -> bool { return mStreamingLoadDistance > 0; }
+        /** Sets the distance at which clusters of regions are drawn as one merged far-field region.
+        @remarks
+            On build, neighbouring regions are grouped into clusters. For each cluster a
+            far-field region merges the lowest LOD of all its meshes. It is drawn instead of
+            the regions of the cluster once the cluster is further away from the LOD camera
+            than this distance, so distant parts of the world cost one batch per material
+            and cluster, at the price of the memory for the merged copy.
+        @par
+            Far-field regions are not streamed, so with streaming enabled the load distance
+            should not be smaller than this distance.
+        @note Must be called before 'build'.
+        @param dist Distance from the cluster bounds, the default 0 disables far-field regions
+        */
+        void setFarFieldDistance(Real dist) { mSquaredFarFieldDistance = dist * dist; }
+        /** Gets the distance at which clusters of regions are drawn as one far-field region. */
+        [[nodiscard]] auto getFarFieldDistance() const -> Real { return Math::Sqrt(mSquaredFarFieldDistance); }
+        /// Get the scene nodes of the region tree, parents before their children
+        [[nodiscard]] auto getRegionTreeNodes() const noexcept -> const std::vector<SceneNode*>& { return mRegionTreeNodes; }
+        /// Get the far-field regions of the region clusters
+        [[nodiscard]] auto getFarFieldRegions() const noexcept -> const std::vector<Region*>& { return mFarFieldRegions; }
 
         /** Destroys all the built geometry state (reverse of build). 
         @remarks
@@ -194,6 +194,9 @@ namespace Ogre {
             @return An updated string with the sub-string replaced
         */
         static auto replaceAll(std::string_view source, std::string_view replaceWhat, std::string_view replaceWithWhat) -> const String;
+
+        /** Escapes quotes, backslashes and control characters for a JSON string literal */
+        static auto escapeJson(std::string_view text) -> String;
     };
 
     struct StringHash : std::hash<std::string_view>
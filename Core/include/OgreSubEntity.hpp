@@ -50,6 +50,7 @@ class Camera;
 class Entity;
 struct Matrix4;
 class RenderOperation;
+class SkinnedVertexCache;
 class SubMesh;
 class Technique;
 class VertexData;
@@ -121,6 +122,8 @@ class VertexData;
         std::unique_ptr<VertexData> mSkelAnimVertexData;
         /// Quick lookup of buffers
         TempBlendedBufferInfo mTempSkelAnimInfo;
+        /// GPU skinned copy of the dedicated geometry, see Entity::setSkinningCacheMaterialName
+        std::unique_ptr<SkinnedVertexCache> mSkinnedVertexCache;
         /// Temp buffer details for software Vertex anim geometry
         TempBlendedBufferInfo mTempVertexAnimInfo;
         /// Vertex data details for software Vertex anim of shared geometry
@@ -133,6 +136,8 @@ class VertexData;
         mutable Real mCachedCameraDist;
         /// Number of hardware blended poses supported by material
         ushort mHardwarePoseCount;
+        /// Does the material blend the poses from the pose texture?
+        bool mHardwarePoseTexture;
         /// Have we applied any vertex animation to geometry?
         bool mVertexAnimationAppliedThisFrame;
         /// The camera for which the cached distance is valid
@@ -242,6 +247,7 @@ class VertexData;
 
         void getWorldTransforms(Matrix4* xform) const override;
         auto getNumWorldTransforms() const noexcept -> unsigned short override;
+        auto getWorldTransformNode() const noexcept -> const Node* override;
         auto getSquaredViewDepth(const Camera* cam) const -> Real override;
         auto getLights() const noexcept -> const LightList& override;
         auto getCastsShadows() const noexcept -> bool override;
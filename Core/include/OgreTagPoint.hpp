@@ -101,6 +101,10 @@ class Skeleton;
         /** Overridden from Node in order to include parent Entity transform. */
         void updateFromParentImpl() const override;
 
+    protected:
+        /** Overridden from Node to use the queue of the scene of the parent Entity. */
+        auto getQueuedUpdates() -> QueuedUpdates* override;
+
     private:
         bool mInheritParentEntityOrientation{true};
         bool mInheritParentEntityScale{true};
@@ -212,6 +212,15 @@ class VertexData;
         using VertexInfoArray = std::vector<VertexInfo>;
         VertexInfoArray mVertexArray;
 
+        /// A face of the index set being processed, with its tangent space
+        struct FaceInfo
+        {
+            size_t vertInd[3];
+            Vector3 tsU, tsV, norm;
+        };
+        /// Scratch storage of processFaces
+        std::vector<FaceInfo> mFaces;
+
         void extendBuffers(VertexSplits& splits);
         void insertTangents(Result& res,
             VertexElementSemantic targetSemantic, 
@@ -220,7 +229,7 @@ class VertexData;
         void populateVertexArray(unsigned short sourceTexCoordSet);
         void processFaces(Result& result);
         /// Calculate face tangent space, U and V are weighted by UV area, N is normalised
-        void calculateFaceTangentSpace(const size_t* vertInd, Vector3& tsU, Vector3& tsV, Vector3& tsN);
+        void calculateFaceTangentSpace(const size_t* vertInd, Vector3& tsU, Vector3& tsV, Vector3& tsN) const;
         auto calculateAngleWeight(size_t v0, size_t v1, size_t v2) -> Real;
         auto calculateParity(const Vector3& u, const Vector3& v, const Vector3& n) -> int;
         void addFaceTangentSpaceToVertices(size_t indexSet, size_t faceIndex, size_t *localVertInd, 
@@ -0,0 +1,255 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+module;
+
+#include <cstddef>
+
+export module Ogre.Core:TaskScheduler;
+
+export import :MemoryAllocatorConfig;
+export import :Platform;
+export import :Prerequisites;
+
+export import <atomic>;
+export import <condition_variable>;
+export import <deque>;
+export import <exception>;
+export import <functional>;
+export import <memory>;
+export import <mutex>;
+export import <thread>;
+export import <vector>;
+
+export
+namespace Ogre
+{
+    class WorkQueue;
+
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup General
+    *  @{
+    */
+
+    /** A set of tasks with dependencies between them.
+    @remarks
+        The graph is only a description; it is executed by TaskScheduler::run or
+        WorkQueue::runTaskGraph, which start every task as soon as all the tasks it
+        depends on have finished. A graph can be run as many times as required.
+    */
+    class TaskGraph : public UtilityAlloc
+    {
+    public:
+        /// Identifies a task within its graph
+        using TaskID = size_t;
+
+        /// Adds a task to the graph
+        auto addTask(std::function<void()> func) -> TaskID;
+
+        /** Makes a task wait for another one.
+        @param task The task which must wait
+        @param dependsOn The task which must have finished before task starts
+        */
+        void addDependency(TaskID task, TaskID dependsOn);
+
+        /// Gets the number of tasks in the graph
+        [[nodiscard]] auto getNumTasks() const noexcept -> size_t { return mTasks.size(); }
+
+        /// Removes all tasks
+        void clear() { mTasks.clear(); }
+
+        /** Gets the tasks in an order which satisfies all dependencies.
+        @remarks
+            Throws if the dependencies contain a cycle.
+        */
+        [[nodiscard]] auto getExecutionOrder() const -> std::vector<TaskID>;
+
+    private:
+        friend class TaskScheduler;
+        friend class WorkQueue;
+
+        struct Task
+        {
+            std::function<void()> func;
+            std::vector<TaskID> successors;
+            uint32 numDependencies{0};
+            /// Dependencies left while the graph is running
+            std::atomic<uint32> pending{0};
+
+            Task(std::function<void()> f) : func(std::move(f)) {}
+        };
+        /// a deque, so tasks never move while the graph is built
+        std::deque<Task> mTasks;
+    };
+
+    /** A pool of worker threads executing fine grained tasks by work stealing.
+    @remarks
+        Every worker owns a lock-free double ended queue. Tasks spawned by a worker
+        are pushed to and popped from the bottom of its own queue, so related work
+        stays on the same thread, while idle workers steal from the top of the queues
+        of the others. Only the thread which created the scheduler owns a queue
+        besides the workers; tasks scheduled from any other thread go through a
+        shared, locked queue.
+    @par
+        Threads waiting for tasks to finish (see run, parallelFor and wait) execute
+        pending tasks in the meantime instead of blocking. Workers which find no
+        work at all go to sleep until new tasks are scheduled.
+    @note
+        Tasks must not throw when scheduled with schedule(); exceptions thrown by the
+        tasks of run and parallelFor are rethrown by these once all tasks are done.
+    */
+    class TaskScheduler : public UtilityAlloc
+    {
+    public:
+        /// Called on every worker thread, e.g. to register it with the RenderSystem
+        using ThreadCallback = std::function<void()>;
+
+        /// Number of tasks each queue can hold; tasks that do not fit run immediately
+        static constexpr size_t QUEUE_CAPACITY = 4096;
+
+        /** Starts the worker threads.
+        @param numWorkers Number of threads to start; the calling thread is not counted
+        @param threadStarted Called by every worker before it takes any task
+        @param threadStopped Called by every worker before it exits
+        */
+        TaskScheduler(size_t numWorkers, ThreadCallback threadStarted = {}, ThreadCallback threadStopped = {});
+        /** Stops and joins the worker threads.
+        @remarks
+            Tasks which did not start by then are discarded.
+        */
+        ~TaskScheduler();
+
+        TaskScheduler(const TaskScheduler&) = delete;
+        auto operator=(const TaskScheduler&) -> TaskScheduler& = delete;
+
+        /// Gets the number of worker threads
+        [[nodiscard]] auto getNumWorkers() const noexcept -> size_t { return mWorkers.size(); }
+
+        /** Adds a task to be executed by any worker.
+        @param task The task
+        @param pending If given, decremented once the task has finished, see wait
+        */
+        void schedule(std::function<void()> task, std::atomic<size_t>* pending = nullptr);
+
+        /** Adds a long running task, e.g. loading a resource.
+        @remarks
+            Background tasks are only executed by the worker threads when they have
+            nothing else to do. Threads waiting in wait, run and parallelFor never
+            pick them up, so these do not get delayed by them.
+        */
+        void scheduleBackground(std::function<void()> task);
+
+        /** Executes pending tasks until the counter drops to zero.
+        @remarks
+            Pair with schedule, having incremented the counter once per task beforehand.
+        */
+        void wait(const std::atomic<size_t>& pending);
+
+        /** Executes a task graph and waits for all its tasks to finish.
+        @remarks
+            Throws if the dependencies contain a cycle.
+        */
+        void run(TaskGraph& graph);
+
+        /** Calls func(i) for every i in [0, count) and waits until all calls have returned.
+        @remarks
+            The range is split recursively, so idle workers can steal the upper halves
+            of the ranges being processed.
+        @param count The number of indices to process
+        @param func The function to call for each index, concurrently
+        @param grainSize The number of indices below which a range is not split any further,
+            0 to choose it depending on the number of workers
+        */
+        void parallelFor(size_t count, const std::function<void(size_t)>& func, size_t grainSize = 0);
+
+        /** Executes a single pending task, if there is any.
+        @return Whether a task was executed
+        */
+        auto _executeNextTask() -> bool;
+
+    private:
+        struct Job
+        {
+            std::function<void()> func;
+            std::atomic<size_t>* pending;
+        };
+
+        /// Chase-Lev work stealing deque, of fixed capacity
+        class JobQueue
+        {
+        public:
+            JobQueue();
+
+            /// Owner only; fails if the queue is full
+            auto push(Job* job) -> bool;
+            /// Owner only
+            auto pop() -> Job*;
+            /// Any thread
+            auto steal() -> Job*;
+
+            [[nodiscard]] auto empty() const -> bool;
+
+        private:
+            // on separate cache lines, as thieves only ever touch the top
+            alignas(64) std::atomic<int64> mTop{0};
+            alignas(64) std::atomic<int64> mBottom{0};
+            std::unique_ptr<std::atomic<Job*>[]> mJobs;
+        };
+
+        /// One queue per worker, the last one belongs to the creating thread
+        std::vector<std::unique_ptr<JobQueue>> mQueues;
+        std::vector<std::thread> mWorkers;
+        std::thread::id mOwnerThread;
+
+        /// Tasks from threads which do not own a queue
+        std::deque<Job*> mSharedQueue;
+        std::mutex mSharedQueueMutex;
+        std::atomic<size_t> mSharedQueueSize{0};
+
+        std::deque<Job*> mBackgroundQueue;
+        std::mutex mBackgroundQueueMutex;
+        std::atomic<size_t> mBackgroundQueueSize{0};
+
+        std::mutex mSleepMutex;
+        std::condition_variable mSleepCondition;
+        std::atomic<size_t> mNumSleeping{0};
+        std::atomic<bool> mShuttingDown{false};
+
+        void workerMain(size_t index, const ThreadCallback& threadStarted, const ThreadCallback& threadStopped);
+        /// Gets the queue owned by the calling thread, if any
+        auto getLocalQueue() -> JobQueue*;
+        auto findJob() -> Job*;
+        auto findBackgroundJob() -> Job*;
+        auto hasJobs() -> bool;
+        void execute(Job* job);
+        void wakeWorkers();
+    };
+    /** @} */
+    /** @} */
+}
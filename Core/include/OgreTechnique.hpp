@@ -225,6 +225,8 @@ class Material;
 
         /** Overloaded operator to copy on Technique to another. */
         auto operator=(const Technique& rhs) -> Technique&;
+        /// operator=, optionally sharing the GpuProgramParameters of the passes, see Material::clone
+        auto _assign(const Technique& rhs, bool shareParameters) -> Technique&;
 
         /// Gets the resource group of the ultimate parent Material
         [[nodiscard]] auto getResourceGroup() const noexcept -> std::string_view ;
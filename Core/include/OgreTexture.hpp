@@ -40,6 +40,7 @@ export import :Resource;
 export import :SharedPtr;
 
 export import <algorithm>;
+export import <atomic>;
 export import <string>;
 export import <vector>;
 
@@ -163,6 +164,57 @@ class ResourceManager;
         */
         auto getMipmapsHardwareGenerated() const noexcept -> bool { return mMipmapsHardwareGenerated; }
 
+        /** Sets whether the mipmaps stored in the image file are streamed in on demand.
+        @remarks
+            Applies to 2D and cubemap textures loaded from images with custom mipmaps,
+            e.g. DDS, KTX or KTX2 files. Loading uploads only the levels up to
+            MIP_STREAMING_INITIAL_SIZE, so the texture is usable right away. The finer levels
+            are requested through _requestScreenSize, by the entities using the texture, and
+            TextureManager::_updateMipStreaming fetches them from the archive on the WorkQueue
+            and uploads them within the residency budget, see
+            TextureManager::setMipStreamingBudget.
+        @par
+            The RenderSystem has to be able to restrict sampling to the uploaded levels,
+            otherwise all levels are uploaded right away.
+        @note
+            Must be called before any 'load' method. The default is taken from
+            TextureManager::setMipStreaming.
+        */
+        void setMipStreaming(bool enabled) { mMipStreaming = enabled; }
+        /// Gets whether the mipmaps are streamed in on demand, see setMipStreaming
+        auto getMipStreaming() const noexcept -> bool { return mMipStreaming; }
+        /// The most detailed mipmap level which can be sampled, not 0 while streaming in
+        auto getMostDetailedMip() const noexcept -> uint32 { return mResidentMip; }
+
+        /// Largest size of the levels a streamed texture is created with
+        static constexpr uint32 MIP_STREAMING_INITIAL_SIZE = 64;
+
+        /// Requests the mipmap level for rendering this frame, the most detailed request wins
+        void _requestMipLevel(uint32 mip);
+        /** Requests the mipmap level that maps about one texel to a pixel on an object
+            covering the given number of pixels across, assuming it is textured once.
+        */
+        void _requestScreenSize(Real pixels);
+        /// Whether streaming of the mipmaps is in progress, see setMipStreaming
+        auto _isMipStreamed() const noexcept -> bool { return mStreamingStartMip > 0; }
+        /// Gets the level and frame number of the last request
+        auto _getRequestedMip() const noexcept -> uint32 { return mRequestedMip; }
+        auto _getMipRequestFrame() const noexcept -> unsigned long { return mMipRequestFrame; }
+        /// Gets the least detailed level the texture falls back to
+        auto _getStreamingStartMip() const noexcept -> uint32 { return mStreamingStartMip; }
+        /// Bytes of the mipmap levels from mip on
+        auto _getMipChainSize(uint32 mip) const -> size_t;
+        /** Streams the levels from mip on in or drops the levels before it.
+        @remarks
+            Dropping is immediate. More detail is fetched on the WorkQueue and uploaded by
+            _updateMipStreaming, a fetch in flight is not interrupted.
+        */
+        void _streamMipLevel(uint32 mip);
+        /// Uploads the levels of a finished fetch
+        void _updateMipStreaming();
+        /// Whether levels are being fetched
+        auto _isMipFetchPending() const noexcept -> bool { return mMipFetchPending; }
+
         /** Returns the gamma adjustment factor applied to this texture on loading.
         */
         auto getGamma() const noexcept -> float { return mGamma; }
@@ -468,6 +520,19 @@ class ResourceManager;
         bool mMipmapsHardwareGenerated{false};
         bool mHwGamma{false};
 
+        /// Mip streaming state, see setMipStreaming
+        bool mMipStreaming{false};
+        /// The most detailed level uploaded
+        uint32 mResidentMip{0};
+        /// The level the texture was created with, 0 if it is not streamed
+        uint32 mStreamingStartMip{0};
+        uint32 mRequestedMip{0};
+        unsigned long mMipRequestFrame{0};
+        /// The level and images of the fetch in flight, the images belong to the worker until it is done
+        uint32 mFetchedMip{0};
+        std::vector<Image> mFetchedImages;
+        std::atomic<bool> mMipFetchPending{false};
+
         /// vector of images that should be loaded (cubemap/ texture array)
         std::vector<String> mLayerNames;
         String mFSAAHint;
@@ -485,7 +550,17 @@ class ResourceManager;
 
         TextureType mTextureType{TextureType::_2D};
 
-        void readImage(LoadedImages& imgs, std::string_view name, std::string_view ext, bool haveNPOT);
+        /// Decodes the named image into img, may be called from several threads at once
+        void readImage(Image& img, std::string_view name, bool haveNPOT);
+        /// Block compresses the images, see TextureManager::setRuntimeCompression
+        void applyRuntimeCompression(LoadedImages& images) const;
+        /// Uploads the mipmap levels [firstMip, lastMip] of the images, see _loadImages
+        void uploadMipLevels(const ConstImagePtrList& images, uint32 firstMip, uint32 lastMip);
+
+        /** Restricts sampling to the levels from mip on, see setMipStreaming
+        @return false if the RenderSystem can not do that, the default
+        */
+        virtual auto setMostDetailedMipImpl(uint32 mip) -> bool { return mip == 0; }
 
         void prepareImpl() override;
         void unprepareImpl() override;
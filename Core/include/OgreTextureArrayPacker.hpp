@@ -0,0 +1,136 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+module;
+
+#include <cstddef>
+
+export module Ogre.Core:TextureArrayPacker;
+
+export import :Material;
+export import :PixelFormat;
+export import :Prerequisites;
+
+export import <map>;
+export import <vector>;
+
+export
+namespace Ogre
+{
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Materials
+    *  @{
+    */
+    /** Merges materials which only differ in their textures into one material sampling texture arrays.
+    @remarks
+        Materials which tell apart only by the textures they reference cannot be drawn together,
+        neither by the instanced runs of SceneManager::setAutoInstancing nor without switching
+        textures between the draws. The packer groups the materials added to it which have a single
+        pass without GPU programs and the same pass and texture unit settings, and whose textures
+        per unit have the same size and pixel format. Each group gets one packed material, a
+        clone of its first member, in which every unit referencing different textures across the
+        group samples a TextureType::_2D_ARRAY texture with the textures as layers instead. The
+        layer of a member is its index in the group.
+    @par
+        The layer reaches the shaders as the custom parameter set here, see
+        Renderable::setCustomParameter, which apply() sets on the SubEntity objects it switches to
+        a packed material. The RTShader::TextureArrayLayer SubRenderState feeds it into the third
+        texture coordinate of the arrays, so the packed materials are meant for the
+        RTShader::ShaderGenerator. Instanced runs are split where the layers change.
+    @par
+        Packing is a load time step: add the materials, call pack() once, after which the
+        textures of the arrays are loaded from the files the source textures were loaded from,
+        and apply() the result to the entities.
+    */
+    class TextureArrayPacker
+    {
+    public:
+        /**
+        @param layerParameter index of the custom parameter holding the layer, in x
+        @param maxLayers most layers per array, starting another group when exceeded
+        */
+        explicit TextureArrayPacker(size_t layerParameter = 0, uint32 maxLayers = 256)
+            : mLayerParameter(layerParameter)
+            , mMaxLayers(maxLayers)
+        {}
+
+        /// Adds a material to be considered by pack(), those not fit for packing are ignored
+        void addMaterial(const MaterialPtr& material);
+
+        /** Groups the added materials and creates the packed materials
+        @return the number of materials replaced by a packed one
+        */
+        auto pack() -> size_t;
+
+        /// Gets the packed material replacing a material, @c nullptr if it is not packed
+        [[nodiscard]] auto getPackedMaterial(std::string_view name) const -> MaterialPtr;
+
+        /// Gets the layer of a packed material within its packed material
+        [[nodiscard]] auto getLayer(std::string_view name) const -> uint32;
+
+        /// Switches the SubEntity objects using a packed material to the packed one and sets their layer
+        void apply(Entity* entity) const;
+
+        [[nodiscard]] auto getLayerParameter() const noexcept -> size_t { return mLayerParameter; }
+        [[nodiscard]] auto getMaxLayers() const noexcept -> uint32 { return mMaxLayers; }
+
+    private:
+        /// Size and format of the texture of a unit
+        struct TextureInfo
+        {
+            uint32 width;
+            uint32 height;
+            PixelFormat format;
+
+            [[nodiscard]] auto operator==(const TextureInfo&) const -> bool = default;
+        };
+
+        struct Candidate
+        {
+            MaterialPtr material;
+            std::vector<TextureInfo> textures;
+        };
+
+        struct Packed
+        {
+            MaterialPtr material;
+            uint32 layer;
+        };
+
+        size_t mLayerParameter;
+        uint32 mMaxLayers;
+        std::vector<Candidate> mCandidates;
+        std::map<String, Packed, std::less<>> mPacked;
+
+        /// Whether the pass settings of two candidates allow sharing a material
+        [[nodiscard]] static auto isCompatible(const Candidate& a, const Candidate& b) -> bool;
+    };
+    /** @} */
+    /** @} */
+}
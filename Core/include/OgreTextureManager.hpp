@@ -46,6 +46,7 @@ export import :TextureUnitState;
 export import <map>;
 export import <memory>;
 export import <string>;
+export import <vector>;
 
 export
 namespace Ogre {
@@ -408,6 +409,80 @@ class Image;
             return mDefaultNumMipmaps;
         }
 
+        /** Sets whether the images of loaded textures are block compressed on the CPU.
+        @remarks
+            Uncompressed 8 bit per channel images are encoded in a format the RenderSystem
+            supports, while preparing the texture:
+            - R8 and RG8 as BC4 and BC5
+            - RGB images as DXT1, ETC2_RGB8 or ETC1_RGB8
+            - RGBA images as BC7, DXT5 or ETC2_RGBA8
+            The missing mipmaps are computed before, see Image::generateMipmaps. Textures
+            with a desired format and volume textures are left alone. This reduces the
+            memory use and sampling bandwidth of textures that are not shipped compressed
+            by 4 to 8 times, at the cost of quality and loading time.
+        @note
+            The default value is false. Takes effect for textures prepared afterwards.
+        */
+        void setRuntimeCompression(bool enabled) { mRuntimeCompression = enabled; }
+        /// Gets whether the images of loaded textures are block compressed, see setRuntimeCompression
+        [[nodiscard]] auto getRuntimeCompression() const noexcept -> bool { return mRuntimeCompression; }
+
+        /** Sets a directory to keep the images decoded for the RenderSystem in.
+        @remarks
+            Textures in block compressed formats the RenderSystem can not sample, e.g. ASTC or
+            ETC2 on desktop GPUs, are decoded to BYTE_RGBA on the CPU while preparing them, see
+            Image::decompress. With a cache location the decoded images are stored there, named
+            by a hash of the compressed data, and later loads read them instead of decoding
+            again. Runtime compression applies to the decoded images, see
+            setRuntimeCompression.
+        @note
+            Empty, the default, disables the cache. Stale files are never removed.
+        */
+        void setDecompressionCacheLocation(std::string_view path) { mDecompressionCacheLocation = path; }
+        /// Gets the directory decoded images are kept in, see setDecompressionCacheLocation
+        [[nodiscard]] auto getDecompressionCacheLocation() const noexcept -> std::string_view
+        {
+            return mDecompressionCacheLocation;
+        }
+
+        /** Sets whether textures start with their small mipmaps and stream in the others on demand.
+        @remarks
+            Textures loaded from images with a full mipmap chain first upload only the
+            levels of at most Texture::MIP_STREAMING_INITIAL_SIZE pixels, so they are
+            ready to render quickly. The entities using them request the level matching
+            their size on screen every frame, which is decoded in the background and
+            uploaded by _updateMipStreaming, and levels no longer requested are dropped
+            again when the budget is exceeded. Manual and volume textures are not streamed.
+        @note
+            The default value is false. Takes effect for textures created afterwards,
+            see Texture::setMipStreaming. Requires RenderSystem support, which only the GL
+            RenderSystem has currently.
+        */
+        void setMipStreaming(bool enabled) { mMipStreaming = enabled; }
+        /// Gets whether mipmaps of new textures are streamed in, see setMipStreaming
+        [[nodiscard]] auto getMipStreaming() const noexcept -> bool { return mMipStreaming; }
+
+        /** Sets the size in bytes the levels of streamed textures may take, 0 for no limit.
+        @remarks
+            If exceeded, the least recently requested textures drop back to the levels
+            they were loaded with and no more levels are streamed in. The GPU memory stays
+            allocated on RenderSystems that can not resize textures in place.
+        */
+        void setMipStreamingBudget(size_t bytes) { mMipStreamingBudget = bytes; }
+        [[nodiscard]] auto getMipStreamingBudget() const noexcept -> size_t { return mMipStreamingBudget; }
+        /// Gets the size of the levels of streamed textures in use, as of the last update
+        [[nodiscard]] auto getMipStreamingUsage() const noexcept -> size_t { return mMipStreamingUsage; }
+
+        /// Internal method called by Texture when it streams its mipmaps
+        void _notifyMipStreaming(ResourceHandle handle);
+        /// Whether any texture streams its mipmaps, i.e. requests are worth computing
+        [[nodiscard]] auto _isStreamingMipmaps() const noexcept -> bool { return !mStreamedTextures.empty(); }
+        /** Uploads the fetched mipmaps and starts fetching the requested ones within the budget.
+        @remarks
+            Called by Root at the end of every frame.
+        */
+        void _updateMipStreaming();
+
         /// Internal method to create a warning texture (bound when a texture unit is blank)
         auto _getWarningTexture() -> const TexturePtr&;
 
@@ -426,6 +501,12 @@ class Image;
         ushort mPreferredIntegerBitDepth{0};
         ushort mPreferredFloatBitDepth{0};
         TextureMipmap mDefaultNumMipmaps{TextureMipmap::UNLIMITED};
+        bool mRuntimeCompression{false};
+        String mDecompressionCacheLocation;
+        bool mMipStreaming{false};
+        size_t mMipStreamingBudget{0};
+        size_t mMipStreamingUsage{0};
+        std::vector<ResourceHandle> mStreamedTextures;
         TexturePtr mWarningTexture;
         SamplerPtr mDefaultSampler;
         std::map<std::string, SamplerPtr, std::less<>> mNamedSamplers;
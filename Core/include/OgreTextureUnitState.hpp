@@ -220,6 +220,12 @@ template <typename T> class Controller;
         }
         [[nodiscard]] auto getBorderColour() const noexcept -> const ColourValue& { return mBorderColour; }
 
+        /** Gets a hash of all settings, which render systems can use to tell apart samplers.
+        @remarks
+            Never 0, so that 0 can stand for an unknown sampler state.
+        */
+        [[nodiscard]] auto getHash() const -> uint32;
+
     protected:
         ColourValue mBorderColour;
         /// Texture anisotropy.
@@ -1042,6 +1048,11 @@ template <typename T> class Controller;
         */
         auto _getAnimController() const noexcept -> Controller<Real>* { return mAnimController; }
 
+        /** Passes the input its controllers held back on to this unit.
+        @see ControllerManager::setDeferTextureUpdates
+        */
+        void _applyHeldControllerInput();
+
         /// return a sampler local to this TUS instead of the shared global one
         auto _getLocalSampler() -> const SamplerPtr&;
 private:
@@ -48,6 +48,7 @@ namespace Ogre
     public:
         static auto clocksToMilliseconds(long double clocks) -> long double;
         static auto clocksToMicroseconds(long double clocks) -> long double;
+        static auto microsecondsToClocks(long double microseconds) -> long double;
 
         Timer();
 
@@ -131,6 +131,7 @@ class ResourceManager;
         auto isMorphAnimationIncluded() const noexcept -> bool override;
 
         auto isPoseAnimationIncluded() const noexcept -> bool override;
+        auto isPoseTextureAnimationIncluded() const noexcept -> bool override;
         auto getNumberOfPosesIncluded() const noexcept -> ushort override;
 
         auto isVertexTextureFetchRequired() const noexcept -> bool override;
@@ -122,6 +122,12 @@ class HardwareBufferManagerBase;
         HardwareAnimationDataList hwAnimationDataList;
         /// Number of hardware animation data items used
         size_t hwAnimDataItemsUsed;
+        /** Pose weights by Mesh pose index for hardware pose animation through a pose texture.
+        @remarks
+            When not empty, hardware pose tracks accumulate their influences here instead of
+            binding pose buffers to the elements in hwAnimationDataList, see Mesh::getPoseTexture.
+        */
+        std::vector<float> hwPoseWeights;
         
         /** Clones this vertex data, potentially including replicating any vertex buffers.
         @param copyData Whether to create new vertex buffers too or just reference the existing ones
@@ -0,0 +1,86 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+module;
+
+#include <cstddef>
+
+export module Ogre.Core:VisibilityStage;
+
+export import :MemoryAllocatorConfig;
+
+export
+namespace Ogre {
+struct AxisAlignedBox;
+class Camera;
+class SceneManager;
+class SceneNode;
+
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Scene
+    *  @{
+    */
+    /** A visibility test following frustum culling.
+    @remarks
+        Stages are registered with SceneManager::addVisibilityStage. While the visible
+        objects of a camera are gathered, every scene node with attached objects inside
+        the frustum is passed to the stages before its objects reach the RenderQueue. A
+        node rejected by any stage is skipped along with its subtree.
+    @par
+        The stages are only consulted for the main render stage, not when rendering
+        shadow textures.
+    */
+    class VisibilityStage : public SceneMgtAlloc
+    {
+    public:
+        virtual ~VisibilityStage() = default;
+
+        /** Called before the visible objects are gathered for the camera. */
+        virtual void _beginFrame(const Camera* cam, SceneManager* sceneMgr) = 0;
+
+        /** Tests whether the content within the bounds of the node may be visible.
+        @param node The node to test.
+        @param bounds World bounds of everything skipped if the node is rejected.
+        */
+        virtual auto _isVisible(const SceneNode* node, const AxisAlignedBox& bounds) -> bool = 0;
+
+        /** Called after the scene was rendered for the camera. */
+        virtual void _endFrame(SceneManager* sceneMgr) { (void)sceneMgr; }
+
+        /** Called before the node is destroyed. */
+        virtual void _notifyNodeDestroyed(const SceneNode* node) { (void)node; }
+        /** Called before all nodes are destroyed. */
+        virtual void _notifyAllNodesDestroyed() {}
+        /** Called before the camera is destroyed. */
+        virtual void _notifyCameraDestroyed(const Camera* cam) { (void)cam; }
+    };
+    /** @} */
+    /** @} */
+
+}
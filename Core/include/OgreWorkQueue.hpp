@@ -36,14 +36,18 @@ export import :MemoryAllocatorConfig;
 export import :Platform;
 export import :Prerequisites;
 export import :SharedPtr;
+export import :TaskScheduler;
 
 export import <algorithm>;
 export import <any>;
+export import <atomic>;
 export import <deque>;
+export import <functional>;
 export import <list>;
 export import <map>;
 export import <mutex>;
 export import <string>;
+export import <vector>;
 
 export
 namespace Ogre
@@ -141,6 +145,8 @@ namespace Ogre
             ::std::any mData;
             /// Any diagnostic messages
             std::string_view mMessages = "";
+            /// Link used while the response is queued for the main thread
+            Response* mNext{nullptr};
 
             /// Get the request that this is a response to (NB destruction destroys this)
             [[nodiscard]] auto getRequest() const noexcept -> const Request* { return mRequest.get(); }
@@ -282,6 +288,36 @@ namespace Ogre
         virtual auto addRequest(uint16 channel, uint16 requestType, ::std::any const& rData, uint8 retryCount = 0, 
             bool forceSynchronous = false, bool idleThread = false) -> RequestID = 0;
 
+        /** Add a new task to the queue.
+        @remarks
+            Tasks bypass the channel / handler machinery and produce no response; they
+            are simply executed by the next free worker thread.
+        @param task The task to be processed
+        */
+        virtual void addTask(std::function<void()> task) = 0;
+
+        /** Call func(i) for every i in [0, count) and wait until all calls have returned.
+        @remarks
+            The calling thread takes part in the work, so this is safe to use even if no
+            worker threads are running. The default implementation is serial; queues with
+            worker threads distribute the indices among them. func must therefore be safe
+            to call concurrently. An exception thrown by func is rethrown here once
+            all other indices have been processed.
+        @param count The number of indices to process
+        @param func The function to call for each index
+        */
+        virtual void parallelFor(size_t count, const std::function<void(size_t)>& func);
+
+        /** Execute all tasks of a graph and wait until they have finished.
+        @remarks
+            Like parallelFor, the calling thread takes part in the work. The default
+            implementation executes the tasks one after the other in dependency order;
+            queues with worker threads start every task as soon as its dependencies are
+            done. An exception thrown by a task is rethrown here once all other tasks have
+            been processed.
+        */
+        virtual void runTaskGraph(TaskGraph& graph);
+
         /** Abort a previously issued request.
         If the request is still waiting to be processed, it will be 
         removed from the queue.
@@ -385,7 +421,7 @@ namespace Ogre
         @param name Optional name, just helps to identify logging output
         */
         DefaultWorkQueueBase(std::string_view name = BLANKSTRING);
-        ~DefaultWorkQueueBase() override = default;
+        ~DefaultWorkQueueBase() override;
         /// Get the name of the work queue
         auto getName() const noexcept -> std::string_view ;
         /** Get the number of worker threads that this queue will start when 
@@ -446,6 +482,10 @@ namespace Ogre
         /// @copydoc WorkQueue::addRequest
         auto addRequest(uint16 channel, uint16 requestType, ::std::any const& rData, uint8 retryCount = 0, 
             bool forceSynchronous = false, bool idleThread = false) -> RequestID override;
+        /// @copydoc WorkQueue::addTask
+        void addTask(std::function<void()> task) override;
+        /// @copydoc WorkQueue::parallelFor
+        void parallelFor(size_t count, const std::function<void(size_t)>& func) override;
         /// @copydoc WorkQueue::abortRequest
         void abortRequest(RequestID id) override;
         /// @copydoc WorkQueue::abortPendingRequest
@@ -480,8 +520,11 @@ namespace Ogre
         using RequestQueue = std::deque<::std::unique_ptr<Request>>;
         using ResponseQueue = std::deque<::std::unique_ptr<Response>>;
         RequestQueue mRequestQueue; // Guarded by mRequestMutex
+        std::deque<std::function<void()>> mTaskQueue; // Guarded by mRequestMutex
         std::deque<Request *> mProcessQueue; // Guarded by mProcessMutex
         ResponseQueue mResponseQueue; // Guarded by mResponseMutex
+        /// Responses pushed by the workers without locking, newest first
+        std::atomic<Response*> mIncomingResponses{nullptr};
 
         /// Thread function
         struct WorkerFunc
@@ -546,9 +589,10 @@ namespace Ogre
         using RequestHandlerHolderPtr = SharedPtr<RequestHandlerHolder>;
 
         using RequestHandlerList = std::list<RequestHandlerHolderPtr>;
-        using ResponseHandlerList = std::list<ResponseHandler *>;
+        using ResponseHandlerList = std::vector<ResponseHandler *>;
         using RequestHandlerListByChannel = std::map<uint16, RequestHandlerList>;
-        using ResponseHandlerListByChannel = std::map<uint16, ResponseHandlerList>;
+        /// Indexed by channel, channels being numbered from 0
+        using ResponseHandlerListByChannel = std::vector<ResponseHandlerList>;
 
         RequestHandlerListByChannel mRequestHandlers;
         ResponseHandlerListByChannel mResponseHandlers;
@@ -571,6 +615,10 @@ namespace Ogre
         void processRequestResponse(Request* r, bool synchronous);
         auto processRequest(Request* r) -> Response*;
         void processResponse(Response* r);
+        /// Pushes a response for the main thread, callable from any thread
+        void queueResponse(Response* r);
+        /// Moves the incoming responses to mResponseQueue, mResponseMutex must be locked
+        void collectResponses();
         /// Notify workers about a new request. 
         virtual void notifyWorkers() = 0;
         /// Put a Request on the queue with a specific RequestID.
@@ -582,6 +630,8 @@ namespace Ogre
         
 
         auto processIdleRequests() -> bool;
+        /// Run the next queued task, if any. Returns whether a task was run.
+        auto processNextTask() -> bool;
     };
 
 
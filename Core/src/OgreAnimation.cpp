@@ -28,6 +28,7 @@ THE SOFTWARE.
 module;
 
 #include <cmath>
+#include <cstddef>
 
 module Ogre.Core;
 
@@ -309,12 +310,12 @@ namespace Ogre {
         return mName;
     }
     //---------------------------------------------------------------------
-    void Animation::apply(Real timePos, Real weight, Real scale)
+    void Animation::apply(Real timePos, Real weight, Real scale, uint* keyIndexHint)
     {
         _applyBaseKeyFrame();
 
         // Calculate time index for fast keyframe search
-        TimeIndex timeIndex = _getTimeIndex(timePos);
+        TimeIndex timeIndex = _getTimeIndex(timePos, keyIndexHint);
 
         for (auto & i : mNodeTrackList)
         {
@@ -345,12 +346,12 @@ namespace Ogre {
     }
     //---------------------------------------------------------------------
     void Animation::apply(Skeleton* skel, Real timePos, Real weight, 
-        Real scale)
+        Real scale, uint* keyIndexHint)
     {
         _applyBaseKeyFrame();
 
         // Calculate time index for fast keyframe search
-        TimeIndex timeIndex = _getTimeIndex(timePos);
+        TimeIndex timeIndex = _getTimeIndex(timePos, keyIndexHint);
 
         for (auto & i : mNodeTrackList)
         {
@@ -363,12 +364,12 @@ namespace Ogre {
     }
     //---------------------------------------------------------------------
     void Animation::apply(Skeleton* skel, Real timePos, float weight,
-      const AnimationState::BoneBlendMask* blendMask, Real scale)
+      const AnimationState::BoneBlendMask* blendMask, Real scale, uint* keyIndexHint)
     {
         _applyBaseKeyFrame();
 
         // Calculate time index for fast keyframe search
-      TimeIndex timeIndex = _getTimeIndex(timePos);
+      TimeIndex timeIndex = _getTimeIndex(timePos, keyIndexHint);
 
       for (auto & i : mNodeTrackList)
       {
@@ -379,12 +380,12 @@ namespace Ogre {
     }
     //---------------------------------------------------------------------
     void Animation::apply(Entity* entity, Real timePos, Real weight, 
-        bool software, bool hardware)
+        bool software, bool hardware, uint* keyIndexHint)
     {
         _applyBaseKeyFrame();
 
         // Calculate time index for fast keyframe search
-        TimeIndex timeIndex = _getTimeIndex(timePos);
+        TimeIndex timeIndex = _getTimeIndex(timePos, keyIndexHint);
 
         for (auto const& [handle, track] : mVertexTrackList)
         {
@@ -609,7 +610,7 @@ namespace Ogre {
 
     }
     //-----------------------------------------------------------------------
-    auto Animation::_getTimeIndex(Real timePos) const -> TimeIndex
+    auto Animation::_getTimeIndex(Real timePos, uint* keyIndexHint) const -> TimeIndex
     {
         // Uncomment following statement for work as previous
         //return timePos;
@@ -626,11 +627,27 @@ namespace Ogre {
         if( timePos > totalAnimationLength && totalAnimationLength > 0.0f )
             timePos = std::fmod( timePos, totalAnimationLength );
 
-        // Search for global index
-        auto it =
-            std::ranges::lower_bound(mKeyFrameTimes, timePos);
+        // Whether index is the lower bound of timePos
+        auto isLowerBound = [&](size_t index)
+        {
+            return index <= mKeyFrameTimes.size() &&
+                   (index == mKeyFrameTimes.size() || timePos <= mKeyFrameTimes[index]) &&
+                   (index == 0 || mKeyFrameTimes[index - 1] < timePos);
+        };
+
+        // Try the interval of the previous lookup and the one after it, before searching for global index
+        size_t index;
+        if (keyIndexHint && isLowerBound(*keyIndexHint))
+            index = *keyIndexHint;
+        else if (keyIndexHint && isLowerBound(*keyIndexHint + size_t(1)))
+            index = *keyIndexHint + 1;
+        else
+            index = std::distance(mKeyFrameTimes.begin(), std::ranges::lower_bound(mKeyFrameTimes, timePos));
 
-        return {timePos, static_cast<uint>(std::distance(mKeyFrameTimes.begin(), it))};
+        if (keyIndexHint)
+            *keyIndexHint = static_cast<uint>(index);
+
+        return {timePos, static_cast<uint>(index)};
     }
     //-----------------------------------------------------------------------
     void Animation::buildKeyFrameTimeList() const
@@ -745,6 +762,21 @@ namespace Ogre {
         
     }
     //-----------------------------------------------------------------------
+    void Animation::_prepareForApply()
+    {
+        _applyBaseKeyFrame();
+
+        if (mKeyFrameTimesDirty)
+        {
+            buildKeyFrameTimeList();
+        }
+
+        for (auto const& [key, track] : mNodeTrackList)
+        {
+            track->_prepareForApply();
+        }
+    }
+    //-----------------------------------------------------------------------
     void Animation::_notifyContainer(AnimationContainer* c)
     {
         mContainer = c;
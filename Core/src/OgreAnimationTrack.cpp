@@ -51,6 +51,8 @@ import <iterator>;
 import <list>;
 import <memory>;
 import <ranges>;
+import <span>;
+import <utility>;
 
 namespace Ogre {
 
@@ -78,6 +80,23 @@ namespace Ogre {
     //---------------------------------------------------------------------
     auto AnimationTrack::getKeyFramesAtTime(const TimeIndex& timeIndex, KeyFrame** keyFrame1, KeyFrame** keyFrame2,
         unsigned short* firstKeyIndex) const -> Real
+    {
+        size_t index1, index2;
+        Real t = getKeyFrameIndicesAtTime(timeIndex, &index1, &index2);
+
+        // Fill index of the first key
+        if (firstKeyIndex)
+        {
+            *firstKeyIndex = static_cast<unsigned short>(index1);
+        }
+
+        *keyFrame1 = mKeyFrames[index1];
+        *keyFrame2 = mKeyFrames[index2];
+        return t;
+    }
+    //---------------------------------------------------------------------
+    auto AnimationTrack::getKeyFrameIndicesAtTime(const TimeIndex& timeIndex, size_t* index1, size_t* index2) const
+        -> Real
     {
         // Parametric time
         // t1 = time of previous keyframe
@@ -87,12 +106,12 @@ namespace Ogre {
         Real timePos = timeIndex.getTimePos();
 
         // Find first keyframe after or on current time
-        KeyFrameList::const_iterator i;
+        size_t i;
         if (timeIndex.hasKeyIndex())
         {
             // Global keyframe index available, map to local keyframe index directly.
             assert(timeIndex.getKeyIndex() < mKeyFrameIndexMap.size());
-            i = mKeyFrames.begin() + mKeyFrameIndexMap[timeIndex.getKeyIndex()];
+            i = mKeyFrameIndexMap[timeIndex.getKeyIndex()];
         }
         else
         {
@@ -104,40 +123,32 @@ namespace Ogre {
                 timePos = std::fmod( timePos, totalAnimationLength );
 
             // No global keyframe index, need to search with local keyframes.
-            KeyFrame timeKey(nullptr, timePos);
-            i = std::ranges::lower_bound(mKeyFrames, &timeKey, KeyFrameTimeLess());
+            i = std::distance(mKeyFrameTimes.begin(), std::ranges::lower_bound(mKeyFrameTimes, timePos));
         }
 
-        if (i == mKeyFrames.end())
+        if (i == mKeyFrameTimes.size())
         {
             // There is no keyframe after this time, wrap back to first
-            *keyFrame2 = mKeyFrames.front();
-            t2 = mParent->getLength() + (*keyFrame2)->getTime();
+            *index2 = 0;
+            t2 = mParent->getLength() + mKeyFrameTimes.front();
 
             // Use last keyframe as previous keyframe
             --i;
         }
         else
         {
-            *keyFrame2 = *i;
-            t2 = (*keyFrame2)->getTime();
+            *index2 = i;
+            t2 = mKeyFrameTimes[i];
 
             // Find last keyframe before or on current time
-            if (i != mKeyFrames.begin() && timePos < (*i)->getTime())
+            if (i != 0 && timePos < mKeyFrameTimes[i])
             {
                 --i;
             }
         }
 
-        // Fill index of the first key
-        if (firstKeyIndex)
-        {
-            *firstKeyIndex = static_cast<unsigned short>(std::distance(mKeyFrames.begin(), i));
-        }
-
-        *keyFrame1 = *i;
-
-        t1 = (*keyFrame1)->getTime();
+        *index1 = i;
+        t1 = mKeyFrameTimes[i];
 
         if (t1 == t2)
         {
@@ -157,6 +168,7 @@ namespace Ogre {
         // Insert just before upper bound
         auto i =
             std::ranges::upper_bound(mKeyFrames, kf, KeyFrameTimeLess());
+        mKeyFrameTimes.insert(mKeyFrameTimes.begin() + std::distance(mKeyFrames.begin(), i), timePos);
         mKeyFrames.insert(i, kf);
 
         _keyFrameDataChanged();
@@ -166,6 +178,22 @@ namespace Ogre {
 
     }
     //---------------------------------------------------------------------
+    void AnimationTrack::appendKeyFrames(std::span<const Real> times)
+    {
+        if (times.empty())
+            return;
+        OgreAssert(std::ranges::is_sorted(times) && (mKeyFrameTimes.empty() || times.front() >= mKeyFrameTimes.back()),
+                   "appended keyframe times have to ascend");
+
+        mKeyFrames.reserve(mKeyFrames.size() + times.size());
+        mKeyFrameTimes.insert(mKeyFrameTimes.end(), times.begin(), times.end());
+        for (Real time : times)
+            mKeyFrames.push_back(createKeyFrameImpl(time));
+
+        _keyFrameDataChanged();
+        mParent->_keyFrameListChanged();
+    }
+    //---------------------------------------------------------------------
     void AnimationTrack::removeKeyFrame(unsigned short index)
     {
         // If you hit this assert, then the keyframe index is out of bounds
@@ -178,6 +206,7 @@ namespace Ogre {
         delete *i;
 
         mKeyFrames.erase(i);
+        mKeyFrameTimes.erase(mKeyFrameTimes.begin() + index);
 
         _keyFrameDataChanged();
         mParent->_keyFrameListChanged();
@@ -196,6 +225,7 @@ namespace Ogre {
         mParent->_keyFrameListChanged();
 
         mKeyFrames.clear();
+        mKeyFrameTimes.clear();
 
     }
     //---------------------------------------------------------------------
@@ -223,7 +253,7 @@ namespace Ogre {
         while (j <= keyFrameTimes.size())
         {
             mKeyFrameIndexMap[j] = static_cast<ushort>(i);
-            while (i < mKeyFrames.size() && mKeyFrames[i]->getTime() <= keyFrameTimes[j])
+            while (i < mKeyFrameTimes.size() && mKeyFrameTimes[i] <= keyFrameTimes[j])
                 ++i;
             ++j;
         }
@@ -238,6 +268,7 @@ namespace Ogre {
         {
             KeyFrame* clonekf = mKeyFrame->_clone(clone);
             clone->mKeyFrames.push_back(clonekf);
+            clone->mKeyFrameTimes.push_back(clonekf->getTime());
         }
     }
     //---------------------------------------------------------------------
@@ -370,21 +401,39 @@ namespace Ogre {
 
         auto* kret = static_cast<TransformKeyFrame*>(kf);
 
-        // Keyframe pointers
-        KeyFrame *kBase1, *kBase2;
-        TransformKeyFrame *k1, *k2;
-        unsigned short firstKeyIndex;
+        if (mCompressed)
+        {
+            Real timePos = timeIndex.getTimePos();
+            Real length = mParent->getLength();
+            if (timePos > length && length > 0.0f)
+                timePos = std::fmod(timePos, length);
+
+            Vector3 translate, scale;
+            Quaternion rotate;
+            mCompressed->evaluate(timePos, length, translate, rotate, scale);
+            kret->setTranslate(translate);
+            kret->setRotation(rotate);
+            kret->setScale(scale);
+            return;
+        }
 
-        Real t = this->getKeyFramesAtTime(timeIndex, &kBase1, &kBase2, &firstKeyIndex);
-        k1 = static_cast<TransformKeyFrame*>(kBase1);
-        k2 = static_cast<TransformKeyFrame*>(kBase2);
+        // Interpolate the packed copies, rather than chasing the keyframe pointers
+        if (mPackedBuildNeeded)
+        {
+            buildPackedKeyFrames();
+        }
+        const PackedKeyFrames& keys = mPackedKeyFrames;
+
+        size_t k1, k2;
+        Real t = getKeyFrameIndicesAtTime(timeIndex, &k1, &k2);
+        auto firstKeyIndex = static_cast<unsigned short>(k1);
 
         if (t == 0.0)
         {
             // Just use k1
-            kret->setRotation(k1->getRotation());
-            kret->setTranslate(k1->getTranslate());
-            kret->setScale(k1->getScale());
+            kret->setRotation(keys.rotate[k1]);
+            kret->setTranslate(keys.translate[k1]);
+            kret->setScale(keys.scale[k1]);
         }
         else
         {
@@ -402,22 +451,22 @@ namespace Ogre {
                 // Interpolate to nearest rotation if mUseShortestRotationPath set
                 if (rim == Animation::RotationInterpolationMode::LINEAR)
                 {
-                    kret->setRotation( Quaternion::nlerp(t, k1->getRotation(),
-                        k2->getRotation(), mUseShortestRotationPath) );
+                    kret->setRotation( Quaternion::nlerp(t, keys.rotate[k1],
+                        keys.rotate[k2], mUseShortestRotationPath) );
                 }
                 else //if (rim == Animation::RotationInterpolationMode::SPHERICAL)
                 {
-                    kret->setRotation( Quaternion::Slerp(t, k1->getRotation(),
-                        k2->getRotation(), mUseShortestRotationPath) );
+                    kret->setRotation( Quaternion::Slerp(t, keys.rotate[k1],
+                        keys.rotate[k2], mUseShortestRotationPath) );
                 }
 
                 // Translation
-                base = k1->getTranslate();
-                kret->setTranslate( base + ((k2->getTranslate() - base) * t) );
+                base = keys.translate[k1];
+                kret->setTranslate( base + ((keys.translate[k2] - base) * t) );
 
                 // Scale
-                base = k1->getScale();
-                kret->setScale( base + ((k2->getScale() - base) * t) );
+                base = keys.scale[k1];
+                kret->setScale( base + ((keys.scale[k2] - base) * t) );
                 break;
 
             case SPLINE:
@@ -465,15 +514,30 @@ namespace Ogre {
         Real scl)
     {
         // Nothing to do if no keyframes or zero weight or no node
-        if (mKeyFrames.empty() || !weight || !node)
+        if ((mKeyFrames.empty() && !mCompressed) || !weight || !node)
+            return;
+
+        Vector3 position = node->getPosition();
+        Quaternion orientation = node->getOrientation();
+        Vector3 scale = node->getScale();
+        applyToTransform(timeIndex, weight, scl, position, orientation, scale);
+        node->setPosition(position);
+        node->setOrientation(orientation);
+        node->setScale(scale);
+    }
+    //---------------------------------------------------------------------
+    void NodeAnimationTrack::applyToTransform(const TimeIndex& timeIndex, Real weight, Real scl,
+        Vector3& position, Quaternion& orientation, Vector3& nodeScale) const
+    {
+        // Nothing to do if no keyframes or zero weight
+        if ((mKeyFrames.empty() && !mCompressed) || !weight)
             return;
 
         TransformKeyFrame kf(nullptr, timeIndex.getTimePos());
         getInterpolatedKeyFrame(timeIndex, &kf);
 
         // add to existing. Weights are not relative, but treated as absolute multipliers for the animation
-        Vector3 translate = kf.getTranslate() * weight * scl;
-        node->translate(translate);
+        position += kf.getTranslate() * weight * scl;
 
         // interpolate between no-rotation and full rotation, to point 'weight', so 0 = no rotate, 1 = full
         Quaternion rotate;
@@ -487,7 +551,9 @@ namespace Ogre {
         {
             rotate = Quaternion::Slerp(weight, Quaternion::IDENTITY, kf.getRotation(), mUseShortestRotationPath);
         }
-        node->rotate(rotate);
+        // like a rotation in local space
+        orientation = orientation * rotate;
+        orientation.normalise();
 
         Vector3 scale = kf.getScale();
         // Not sure how to modify scale for cumulative anims... leave it alone
@@ -499,8 +565,7 @@ namespace Ogre {
             else if (weight != 1.0f)
                 scale = Vector3::UNIT_SCALE + (scale - Vector3::UNIT_SCALE) * weight;
         }
-        node->scale(scale);
-
+        nodeScale *= scale;
     }
     //---------------------------------------------------------------------
     void NodeAnimationTrack::buildInterpolationSplines() const
@@ -538,6 +603,27 @@ namespace Ogre {
 
         mSplineBuildNeeded = false;
     }
+    //---------------------------------------------------------------------
+    void NodeAnimationTrack::buildPackedKeyFrames() const
+    {
+        PackedKeyFrames& keys = mPackedKeyFrames;
+        keys.translate.clear();
+        keys.rotate.clear();
+        keys.scale.clear();
+        keys.translate.reserve(mKeyFrames.size());
+        keys.rotate.reserve(mKeyFrames.size());
+        keys.scale.reserve(mKeyFrames.size());
+
+        for (auto mKeyFrame : mKeyFrames)
+        {
+            auto* kf = static_cast<TransformKeyFrame*>(mKeyFrame);
+            keys.translate.push_back(kf->getTranslate());
+            keys.rotate.push_back(kf->getRotation());
+            keys.scale.push_back(kf->getScale());
+        }
+
+        mPackedBuildNeeded = false;
+    }
 
     //---------------------------------------------------------------------
     void NodeAnimationTrack::setUseShortestRotationPath(bool useShortestPath)
@@ -554,10 +640,24 @@ namespace Ogre {
     void NodeAnimationTrack::_keyFrameDataChanged() const
     {
         mSplineBuildNeeded = true;
+        mPackedBuildNeeded = true;
     }
     //---------------------------------------------------------------------
     auto NodeAnimationTrack::hasNonZeroKeyFrames() const noexcept -> bool
     {
+        if (mCompressed)
+        {
+            if (!mCompressed->isConstant())
+                return true;
+            Vector3 trans, scale;
+            Quaternion rotation;
+            mCompressed->evaluate(0, mParent->getLength(), trans, rotation, scale);
+            Real tolerance = 1e-3f;
+            return !trans.positionEquals(Vector3::ZERO, tolerance) ||
+                   !scale.positionEquals(Vector3::UNIT_SCALE, tolerance) ||
+                   !rotation.equals(Quaternion::IDENTITY, Radian{tolerance});
+        }
+
         for (auto const& i : mKeyFrames)
         {
             // look for keyframes which have any component which is non-zero
@@ -638,14 +738,74 @@ namespace Ogre {
     //--------------------------------------------------------------------------
     auto NodeAnimationTrack::createKeyFrameImpl(Real time) -> KeyFrame*
     {
+        OgreAssert(!mCompressed, "Track is compressed, decompress it first");
         return new TransformKeyFrame(this, time);
     }
     //--------------------------------------------------------------------------
+    void NodeAnimationTrack::compress(const CompressedNodeTrack::Tolerance& tolerance)
+    {
+        if (mKeyFrames.empty())
+            return;
+
+        mCompressed = ::std::make_unique<CompressedNodeTrack>(*this, tolerance);
+        removeAllKeyFrames();
+
+        // nothing left to interpolate
+        mPackedKeyFrames = {};
+        mSplines.reset();
+    }
+    //--------------------------------------------------------------------------
+    void NodeAnimationTrack::decompress()
+    {
+        if (!mCompressed)
+            return;
+
+        ::std::unique_ptr<CompressedNodeTrack> compressed = std::move(mCompressed);
+        for (Real time : compressed->getKeyTimes())
+        {
+            Vector3 translate, scale;
+            Quaternion rotate;
+            compressed->evaluate(time, mParent->getLength(), translate, rotate, scale);
+            TransformKeyFrame* kf = createNodeKeyFrame(time);
+            kf->setTranslate(translate);
+            kf->setRotation(rotate);
+            kf->setScale(scale);
+        }
+    }
+    //--------------------------------------------------------------------------
     auto NodeAnimationTrack::createNodeKeyFrame(Real timePos) -> TransformKeyFrame*
     {
         return static_cast<TransformKeyFrame*>(createKeyFrame(timePos));
     }
     //--------------------------------------------------------------------------
+    void NodeAnimationTrack::_appendKeyFrames(std::span<const Real> times, std::vector<Vector3> translates,
+                                              std::vector<Quaternion> rotates, std::vector<Vector3> scales)
+    {
+        OgreAssert(translates.size() == times.size() && rotates.size() == times.size() &&
+                   (scales.empty() || scales.size() == times.size()), "one transform per keyframe time");
+        if (scales.empty())
+            scales.assign(times.size(), Vector3::UNIT_SCALE);
+
+        size_t first = mKeyFrames.size();
+        appendKeyFrames(times);
+        for (size_t i = 0; i < times.size(); ++i)
+        {
+            auto* kf = static_cast<TransformKeyFrame*>(mKeyFrames[first + i]);
+            kf->setTranslate(translates[i]);
+            kf->setRotation(rotates[i]);
+            kf->setScale(scales[i]);
+        }
+
+        // the arrays already are what buildPackedKeyFrames would collect
+        if (first == 0)
+        {
+            mPackedKeyFrames.translate = std::move(translates);
+            mPackedKeyFrames.rotate = std::move(rotates);
+            mPackedKeyFrames.scale = std::move(scales);
+            mPackedBuildNeeded = false;
+        }
+    }
+    //--------------------------------------------------------------------------
     auto NodeAnimationTrack::getNodeKeyFrame(unsigned short index) const -> TransformKeyFrame*
     {
         return static_cast<TransformKeyFrame*>(getKeyFrame(index));
@@ -657,6 +817,8 @@ namespace Ogre {
             newParent->createNodeTrack(mHandle, mTargetNode);
         newTrack->mUseShortestRotationPath = mUseShortestRotationPath;
         populateClone(newTrack);
+        if (mCompressed)
+            newTrack->mCompressed = ::std::make_unique<CompressedNodeTrack>(*mCompressed);
         return newTrack;
     }
     //--------------------------------------------------------------------------
@@ -673,6 +835,17 @@ namespace Ogre {
         }
             
     }
+    //---------------------------------------------------------------------
+    void NodeAnimationTrack::_prepareForApply() const
+    {
+        if (mCompressed)
+            return;
+
+        if (mPackedBuildNeeded)
+            buildPackedKeyFrames();
+        if (mSplineBuildNeeded && mParent->getInterpolationMode() == Animation::InterpolationMode::SPLINE)
+            buildInterpolationSplines();
+    }
     //--------------------------------------------------------------------------
     VertexAnimationTrack::VertexAnimationTrack(Animation* parent,
         unsigned short handle, VertexAnimationType animType)
@@ -880,7 +1053,7 @@ namespace Ogre {
                 assert (poseList && p1.poseIndex < poseList->size());
                 Pose* pose = (*poseList)[p1.poseIndex];
                 // apply
-                applyPoseToVertexData(pose, data, influence);
+                applyPoseToVertexData(p1.poseIndex, pose, data, influence);
             }
             // Now deal with any poses in key 2 which are not in key 1
             for (auto p2 : poseList2)
@@ -904,16 +1077,23 @@ namespace Ogre {
                     assert (poseList && p2.poseIndex <= poseList->size());
                     const Pose* pose = (*poseList)[p2.poseIndex];
                     // apply
-                    applyPoseToVertexData(pose, data, influence);
+                    applyPoseToVertexData(p2.poseIndex, pose, data, influence);
                 }
             } // key 2 iteration
         } // morph or pose animation
     }
     //-----------------------------------------------------------------------------
-    void VertexAnimationTrack::applyPoseToVertexData(const Pose* pose,
+    void VertexAnimationTrack::applyPoseToVertexData(ushort poseIndex, const Pose* pose,
         VertexData* data, Real influence)
     {
-        if (mTargetMode == TargetMode::HARDWARE)
+        if (mTargetMode == TargetMode::HARDWARE && !data->hwPoseWeights.empty())
+        {
+            // Hardware through the pose texture, which holds every pose
+            // so influences just accumulate by pose index
+            if (poseIndex < data->hwPoseWeights.size())
+                data->hwPoseWeights[poseIndex] += float(influence);
+        }
+        else if (mTargetMode == TargetMode::HARDWARE)
         {
             // Hardware
             // If target mode is hardware, need to bind our pose buffer
@@ -0,0 +1,175 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+module;
+
+#include <cstddef>
+
+module Ogre.Core;
+
+import :Async;
+import :Exception;
+import :ResourceBackgroundQueue;
+import :ResourceGroupManager;
+import :ResourceManager;
+
+import <coroutine>;
+import <functional>;
+import <map>;
+import <utility>;
+import <vector>;
+
+namespace Ogre {
+    //-----------------------------------------------------------------------
+    void CancellationToken::cancel() const
+    {
+        if (mState->cancelled)
+            return;
+        mState->cancelled = true;
+
+        // the callbacks may remove themselves or destroy the other copies of the token
+        std::shared_ptr<State> state = mState;
+        std::vector<std::function<void()>> callbacks;
+        for (auto& [id, callback] : state->callbacks)
+            callbacks.push_back(std::move(callback));
+        state->callbacks.clear();
+        for (auto& callback : callbacks)
+            callback();
+    }
+    //-----------------------------------------------------------------------
+    auto CancellationToken::_addCallback(std::function<void()> callback) const -> CallbackID
+    {
+        CallbackID id = mState->nextID++;
+        if (mState->cancelled)
+            callback();
+        else
+            mState->callbacks.emplace(id, std::move(callback));
+        return id;
+    }
+    //-----------------------------------------------------------------------
+    void CancellationToken::_removeCallback(CallbackID id) const
+    {
+        mState->callbacks.erase(id);
+    }
+    //-----------------------------------------------------------------------
+    ResourceRequestAwaiter::ResourceRequestAwaiter(bool load, std::string_view type, std::string_view name,
+                                                   std::string_view group, CancellationToken token)
+        : mLoad(load)
+        , mType(type)
+        , mName(name)
+        , mGroup(group)
+        , mToken(std::move(token))
+    {
+    }
+    //-----------------------------------------------------------------------
+    ResourceRequestAwaiter::~ResourceRequestAwaiter()
+    {
+        if (mCancelCallback)
+            mToken._removeCallback(*mCancelCallback);
+        // the coroutine was destroyed while waiting
+        if (mState == State::QUEUEING || mState == State::WAITING)
+            ResourceBackgroundQueue::getSingleton().abortRequest(mTicket);
+    }
+    //-----------------------------------------------------------------------
+    auto ResourceRequestAwaiter::isComplete() const -> bool
+    {
+        ResourceManager* rm = ResourceGroupManager::getSingleton()._getResourceManager(mType);
+        ResourcePtr resource = rm->getResourceByName(mName, mGroup);
+        return resource && (resource->isLoaded() || (!mLoad && resource->isPrepared()));
+    }
+    //-----------------------------------------------------------------------
+    auto ResourceRequestAwaiter::await_ready() -> bool
+    {
+        if (mToken.isCancelled() || isComplete())
+        {
+            mState = State::DONE;
+            return true;
+        }
+        return false;
+    }
+    //-----------------------------------------------------------------------
+    auto ResourceRequestAwaiter::await_suspend(std::coroutine_handle<> awaiting) -> bool
+    {
+        mAwaiting = awaiting;
+        mState = State::QUEUEING;
+
+        ResourceBackgroundQueue& queue = ResourceBackgroundQueue::getSingleton();
+        mTicket = mLoad ? queue.load(mType, mName, mGroup, false, nullptr, nullptr, this)
+                        : queue.prepare(mType, mName, mGroup, false, nullptr, nullptr, this);
+        // completed while queueing, so continue without suspending
+        if (mState == State::DONE)
+            return false;
+
+        mCancelCallback = mToken._addCallback([this]()
+        {
+            mCancelCallback.reset();
+            ResourceBackgroundQueue::getSingleton().abortRequest(mTicket);
+            finish();
+        });
+        // the callback may have finished at once
+        if (mState == State::DONE)
+            return false;
+
+        mState = State::WAITING;
+        return true;
+    }
+    //-----------------------------------------------------------------------
+    auto ResourceRequestAwaiter::await_resume() -> ResourcePtr
+    {
+        if (mError)
+            OGRE_EXCEPT(ExceptionCodes::INTERNAL_ERROR, *mError, "ResourceRequestAwaiter::await_resume");
+        if (mToken.isCancelled() && !isComplete())
+            return {};
+
+        return ResourceGroupManager::getSingleton()._getResourceManager(mType)->getResourceByName(mName, mGroup);
+    }
+    //-----------------------------------------------------------------------
+    void ResourceRequestAwaiter::operationCompleted(BackgroundProcessTicket ticket, const BackgroundProcessResult& result)
+    {
+        // the ticket is not known yet if the queue completes the request at once
+        (void)ticket;
+        if (mState == State::DONE)
+            return;
+        if (result.error)
+            mError = String{result.message};
+        finish();
+    }
+    //-----------------------------------------------------------------------
+    void ResourceRequestAwaiter::finish()
+    {
+        bool suspended = mState == State::WAITING;
+        mState = State::DONE;
+        if (mCancelCallback)
+        {
+            mToken._removeCallback(*mCancelCallback);
+            mCancelCallback.reset();
+        }
+        // this awaiter may be destroyed from here on
+        if (suspended)
+            mAwaiting.resume();
+    }
+}
@@ -0,0 +1,250 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+module;
+
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#endif
+
+module Ogre.Core;
+
+import :AsyncFileReader;
+import :Exception;
+import :Platform;
+
+import <algorithm>;
+import <atomic>;
+import <filesystem>;
+import <limits>;
+import <vector>;
+
+namespace Ogre {
+
+    //-----------------------------------------------------------------------
+    AsyncFileReader::AsyncFileReader(uint32 queueDepth)
+        : mQueueDepth(std::max(queueDepth, 1u))
+    {
+        setupRing();
+    }
+    //-----------------------------------------------------------------------
+    AsyncFileReader::~AsyncFileReader()
+    {
+        // the kernel must be done with the buffers before they can be released
+        std::vector<Completion> discarded;
+        while (isAsynchronous() && mNumInFlight)
+            poll(discarded, true);
+        destroyRing();
+    }
+    //-----------------------------------------------------------------------
+    auto AsyncFileReader::setupRing() -> bool
+    {
+#ifdef __linux__
+        io_uring_params params{};
+        int fd = int(syscall(__NR_io_uring_setup, mQueueDepth, &params));
+        if (fd < 0)
+            return false;
+        mRingFd = fd;
+
+        mRingSize[0] = params.sq_off.array + params.sq_entries * sizeof(uint32);
+        mRingSize[1] = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        mRingSize[2] = params.sq_entries * sizeof(io_uring_sqe);
+        // newer kernels map both rings at once
+        bool singleMapping = params.features & IORING_FEAT_SINGLE_MMAP;
+        if (singleMapping)
+            mRingSize[0] = mRingSize[1] = std::max(mRingSize[0], mRingSize[1]);
+
+        auto map = [fd](size_t size, off_t offset) -> void*
+        {
+            void* mem = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, offset);
+            return mem == MAP_FAILED ? nullptr : mem;
+        };
+        mRingMemory[0] = map(mRingSize[0], IORING_OFF_SQ_RING);
+        if (singleMapping)
+            mRingSize[1] = 0;
+        else
+            mRingMemory[1] = map(mRingSize[1], IORING_OFF_CQ_RING);
+        mRingMemory[2] = map(mRingSize[2], IORING_OFF_SQES);
+
+        if (!mRingMemory[0] || (!singleMapping && !mRingMemory[1]) || !mRingMemory[2])
+        {
+            destroyRing();
+            return false;
+        }
+
+        auto sq = static_cast<char*>(mRingMemory[0]);
+        auto cq = static_cast<char*>(singleMapping ? mRingMemory[0] : mRingMemory[1]);
+        mSqHead = reinterpret_cast<uint32*>(sq + params.sq_off.head);
+        mSqTail = reinterpret_cast<uint32*>(sq + params.sq_off.tail);
+        mSqMask = reinterpret_cast<uint32*>(sq + params.sq_off.ring_mask);
+        mSqArray = reinterpret_cast<uint32*>(sq + params.sq_off.array);
+        mCqHead = reinterpret_cast<uint32*>(cq + params.cq_off.head);
+        mCqTail = reinterpret_cast<uint32*>(cq + params.cq_off.tail);
+        mCqMask = reinterpret_cast<uint32*>(cq + params.cq_off.ring_mask);
+        mCqes = cq + params.cq_off.cqes;
+        mSqes = mRingMemory[2];
+
+        // the kernel rounds the depth up to a power of two
+        mQueueDepth = params.sq_entries;
+        return true;
+#else
+        return false;
+#endif
+    }
+    //-----------------------------------------------------------------------
+    void AsyncFileReader::destroyRing()
+    {
+        for (int i = 0; i < 3; ++i)
+        {
+            if (mRingMemory[i] && mRingSize[i])
+                munmap(mRingMemory[i], mRingSize[i]);
+            mRingMemory[i] = nullptr;
+            mRingSize[i] = 0;
+        }
+        if (mRingFd >= 0)
+            ::close(mRingFd);
+        mRingFd = -1;
+    }
+    //-----------------------------------------------------------------------
+    auto AsyncFileReader::openFile(const std::filesystem::path& path) -> int
+    {
+        return ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    }
+    //-----------------------------------------------------------------------
+    void AsyncFileReader::closeFile(int file)
+    {
+        if (file >= 0)
+            ::close(file);
+    }
+    //-----------------------------------------------------------------------
+    void AsyncFileReader::read(int file, uint64 offset, void* buf, size_t count, uint64 userData)
+    {
+        OgreAssert(count <= std::numeric_limits<uint32>::max(), "read too large");
+
+        if (isAsynchronous())
+        {
+            mBacklog.push_back({file, offset, buf, uint32(count), userData});
+            submit(0);
+            return;
+        }
+
+        Completion completion{userData, 0, 0};
+        while (completion.bytesRead < count)
+        {
+            ssize_t n = pread(file, static_cast<char*>(buf) + completion.bytesRead,
+                              count - completion.bytesRead, off_t(offset + completion.bytesRead));
+            if (n < 0 && errno == EINTR)
+                continue;
+            if (n < 0)
+                completion.error = errno;
+            if (n <= 0)
+                break;
+            completion.bytesRead += size_t(n);
+        }
+        mCompleted.push_back(completion);
+    }
+    //-----------------------------------------------------------------------
+    void AsyncFileReader::submit(uint32 minComplete)
+    {
+#ifdef __linux__
+        // only this thread produces submissions, the kernel consumes them
+        uint32 tail = *mSqTail;
+        while (!mBacklog.empty() && mNumInFlight < mQueueDepth)
+        {
+            const Request& req = mBacklog.front();
+            uint32 index = tail & *mSqMask;
+
+            auto& sqe = static_cast<io_uring_sqe*>(mSqes)[index];
+            std::memset(&sqe, 0, sizeof(sqe));
+            sqe.opcode = IORING_OP_READ;
+            sqe.fd = req.file;
+            sqe.off = req.offset;
+            sqe.addr = reinterpret_cast<uintptr_t>(req.buf);
+            sqe.len = req.count;
+            sqe.user_data = req.userData;
+            mSqArray[index] = index;
+
+            ++tail;
+            ++mNumInFlight;
+            mBacklog.pop_front();
+        }
+        std::atomic_ref<uint32>(*mSqTail).store(tail, std::memory_order_release);
+
+        // includes any entries the kernel did not take on a previous call
+        uint32 toSubmit = tail - std::atomic_ref<uint32>(*mSqHead).load(std::memory_order_acquire);
+        if (!toSubmit && !minComplete)
+            return;
+
+        uint32 flags = minComplete ? IORING_ENTER_GETEVENTS : 0;
+        while (syscall(__NR_io_uring_enter, mRingFd, toSubmit, minComplete, flags, nullptr, 0) < 0 &&
+               errno == EINTR)
+            ;
+#endif
+    }
+    //-----------------------------------------------------------------------
+    auto AsyncFileReader::poll(std::vector<Completion>& completions, bool wait) -> size_t
+    {
+        size_t count = mCompleted.size();
+        completions.insert(completions.end(), mCompleted.begin(), mCompleted.end());
+        mCompleted.clear();
+
+#ifdef __linux__
+        if (!isAsynchronous())
+            return count;
+
+        uint32 head = *mCqHead;
+        if (wait && !count && mNumInFlight &&
+            head == std::atomic_ref<uint32>(*mCqTail).load(std::memory_order_acquire))
+            submit(1);
+
+        uint32 tail = std::atomic_ref<uint32>(*mCqTail).load(std::memory_order_acquire);
+        for (; head != tail; ++head)
+        {
+            const auto& cqe = static_cast<const io_uring_cqe*>(mCqes)[head & *mCqMask];
+            if (cqe.res < 0)
+                completions.push_back({cqe.user_data, 0, -cqe.res});
+            else
+                completions.push_back({cqe.user_data, size_t(cqe.res), 0});
+            --mNumInFlight;
+            ++count;
+        }
+        std::atomic_ref<uint32>(*mCqHead).store(head, std::memory_order_release);
+
+        // the completed reads made room for the waiting ones
+        if (!mBacklog.empty())
+            submit(0);
+#endif
+        return count;
+    }
+}
@@ -38,6 +38,7 @@ import :Controller;
 import :ControllerManager;
 import :Frustum;
 import :Math;
+import :Node;
 import :Pass;
 import :Platform;
 import :Quaternion;
@@ -51,9 +52,12 @@ import :Texture;
 import :TextureUnitState;
 import :Viewport;
 
+import <initializer_list>;
 import <limits>;
+import <span>;
 
 namespace Ogre {
+    uint64 AutoParamDataSource::msLastVersion = 0;
     //-----------------------------------------------------------------------------
     AutoParamDataSource::AutoParamDataSource()
         : 
@@ -72,9 +76,13 @@ namespace Ogre {
             mSpotlightViewProjMatrixDirty[i] = true;
             mSpotlightWorldViewProjMatrixDirty[i] = true;
             mCurrentTextureProjector[i] = nullptr;
+            mTextureProjectorTile[i] = Vector4{0, 0, 1, 1};
             mShadowCamDepthRangesDirty[i] = false;
         }
 
+        // a fresh version, so nothing is taken as up to date with this instance
+        for (auto source : {Source::CAMERA, Source::WORLD, Source::LIGHTS, Source::PASS, Source::OTHER})
+            markChanged(source);
     }
     //-----------------------------------------------------------------------------
 	auto AutoParamDataSource::getCurrentCamera() const noexcept -> const Camera*
@@ -97,6 +105,7 @@ namespace Ogre {
     //-----------------------------------------------------------------------------
     void AutoParamDataSource::setCurrentRenderable(const Renderable* rend)
     {
+        markChanged(Source::WORLD);
         mCurrentRenderable = rend;
         mWorldMatrixDirty = true;
         mViewMatrixDirty = true;
@@ -119,11 +128,18 @@ namespace Ogre {
 
     }
     //-----------------------------------------------------------------------------
-    void AutoParamDataSource::setCurrentCamera(const Camera* cam, bool useCameraRelative)
+    void AutoParamDataSource::setCurrentCamera(const Camera* cam, bool useCameraRelative, bool largeWorld)
     {
+        markChanged(Source::CAMERA);
         mCurrentCamera = cam;
         mCameraRelativeRendering = useCameraRelative;
+        mLargeWorldRendering = useCameraRelative && largeWorld;
         mCameraRelativePosition = cam->getDerivedPosition();
+        if (const Node* node = cam->getParentNode(); node && mLargeWorldRendering)
+            mCameraRelativePositionDouble = node->_getDerivedPositionDouble();
+        else
+            mCameraRelativePositionDouble = {mCameraRelativePosition.x, mCameraRelativePosition.y,
+                                             mCameraRelativePosition.z};
         mViewMatrixDirty = true;
         mProjMatrixDirty = true;
         mWorldViewMatrixDirty = true;
@@ -140,6 +156,7 @@ namespace Ogre {
     //-----------------------------------------------------------------------------
     void AutoParamDataSource::setCurrentLightList(const LightList* ll)
     {
+        markChanged(Source::LIGHTS);
         mCurrentLightList = ll;
         for(size_t i = 0; i < ll->size() && i < OGRE_MAX_SIMULTANEOUS_LIGHTS; ++i)
         {
@@ -240,17 +257,20 @@ namespace Ogre {
     //-----------------------------------------------------------------------------
     void AutoParamDataSource::setMainCamBoundsInfo(VisibleObjectsBoundsInfo* info)
     {
+        markChanged(Source::OTHER);
         mMainCamBoundsInfo = info;
         mSceneDepthRangeDirty = true;
     }
     //-----------------------------------------------------------------------------
     void AutoParamDataSource::setCurrentSceneManager(const SceneManager* sm)
     {
+        markChanged(Source::OTHER);
         mCurrentSceneManager = sm;
     }
     //-----------------------------------------------------------------------------
     void AutoParamDataSource::setWorldMatrices(const Affine3* m, size_t count)
     {
+        markChanged(Source::WORLD);
         mWorldMatrixArray = m;
         mWorldMatrixCount = count;
         mWorldMatrixDirty = false;
@@ -263,18 +283,35 @@ namespace Ogre {
             mWorldMatrixArray = mWorldMatrix;
             mCurrentRenderable->getWorldTransforms(reinterpret_cast<Matrix4*>(mWorldMatrix));
             mWorldMatrixCount = mCurrentRenderable->getNumWorldTransforms();
-            if (mCameraRelativeRendering && !mCurrentRenderable->getUseIdentityView())
-            {
-                for (size_t i = 0; i < mWorldMatrixCount; ++i)
-                {
-                    mWorldMatrix[i].setTrans(mWorldMatrix[i].getTrans() - mCameraRelativePosition);
-                }
-            }
+            makeCameraRelative(mCurrentRenderable, mWorldMatrix, mWorldMatrixCount);
             mWorldMatrixDirty = false;
         }
         return mWorldMatrixArray[0];
     }
     //-----------------------------------------------------------------------------
+    void AutoParamDataSource::makeCameraRelative(const Renderable* rend, Affine3* matrices, size_t count) const
+    {
+        if (!mCameraRelativeRendering || rend->getUseIdentityView())
+            return;
+
+        const Node* node = mLargeWorldRendering ? rend->getWorldTransformNode() : nullptr;
+        if (!node)
+        {
+            for (size_t i = 0; i < count; ++i)
+                matrices[i].setTrans(matrices[i].getTrans() - mCameraRelativePosition);
+            return;
+        }
+
+        // the node relative to the camera in double precision, only rounded once it is small
+        const Vector3d& position = node->_getDerivedPositionDouble();
+        Vector3 nodeRelative{Real(position[0] - mCameraRelativePositionDouble[0]),
+                             Real(position[1] - mCameraRelativePositionDouble[1]),
+                             Real(position[2] - mCameraRelativePositionDouble[2])};
+        const Vector3& nodePosition = node->_getDerivedPosition();
+        for (size_t i = 0; i < count; ++i)
+            matrices[i].setTrans(matrices[i].getTrans() - nodePosition + nodeRelative);
+    }
+    //-----------------------------------------------------------------------------
     auto AutoParamDataSource::getWorldMatrixCount() const -> size_t
     {
         // trigger derivation
@@ -335,20 +372,25 @@ namespace Ogre {
             {
                 mProjectionMatrix = mCurrentCamera->getProjectionMatrixWithRSDepth();
             }
-            if (mCurrentRenderTarget && mCurrentRenderTarget->requiresTextureFlipping())
-            {
-                // Because we're not using setProjectionMatrix, this needs to be done here
-                // Invert transformed y
-                mProjectionMatrix[1][0] = -mProjectionMatrix[1][0];
-                mProjectionMatrix[1][1] = -mProjectionMatrix[1][1];
-                mProjectionMatrix[1][2] = -mProjectionMatrix[1][2];
-                mProjectionMatrix[1][3] = -mProjectionMatrix[1][3];
-            }
+            applyTextureFlipping(mProjectionMatrix);
             mProjMatrixDirty = false;
         }
         return mProjectionMatrix;
     }
     //-----------------------------------------------------------------------------
+    void AutoParamDataSource::applyTextureFlipping(Matrix4& proj) const
+    {
+        if (mCurrentRenderTarget && mCurrentRenderTarget->requiresTextureFlipping())
+        {
+            // Because we're not using setProjectionMatrix, this needs to be done here
+            // Invert transformed y
+            proj[1][0] = -proj[1][0];
+            proj[1][1] = -proj[1][1];
+            proj[1][2] = -proj[1][2];
+            proj[1][3] = -proj[1][3];
+        }
+    }
+    //-----------------------------------------------------------------------------
     auto AutoParamDataSource::getWorldViewMatrix() const noexcept -> const Affine3&
     {
         if (mWorldViewMatrixDirty)
@@ -419,6 +461,31 @@ namespace Ogre {
         return mInverseTransposeWorldViewMatrix;
     }
     //-----------------------------------------------------------------------------
+    void AutoParamDataSource::computeDerivedMatrices(std::span<const Affine3> worldMatrices,
+                                                     std::span<DerivedMatrices> out) const
+    {
+        OgreAssert(out.size() >= worldMatrices.size(), "Not enough room for the derived matrices");
+
+        Affine3 view = mCurrentCamera->getViewMatrix(true);
+        Matrix4 proj = mCurrentCamera->getProjectionMatrixWithRSDepth();
+        applyTextureFlipping(proj);
+        if (mCameraRelativeRendering)
+        {
+            // moving the world by the camera position instead of the view, see getWorldMatrix
+            view.setTrans(Vector3::ZERO);
+            view = view * Affine3::getTrans(-mCameraRelativePosition);
+        }
+
+        // no branches in the loop, so the matrix products can be vectorised
+        for (size_t i = 0; i < worldMatrices.size(); ++i)
+        {
+            DerivedMatrices& d = out[i];
+            d.worldView = view * worldMatrices[i];
+            d.worldViewProj = proj * d.worldView;
+            d.inverseTransposeWorldView = d.worldView.inverse().transpose();
+        }
+    }
+    //-----------------------------------------------------------------------------
     auto AutoParamDataSource::getCameraPosition() const noexcept -> const Vector4&
     {
         if(mCameraPositionDirty)
@@ -506,6 +573,7 @@ namespace Ogre {
     //-----------------------------------------------------------------------------
     void AutoParamDataSource::setAmbientLightColour(const ColourValue& ambient)
     {
+        markChanged(Source::OTHER);
         mAmbientLight = ambient;
     }
     //---------------------------------------------------------------------
@@ -527,6 +595,7 @@ namespace Ogre {
     //-----------------------------------------------------------------------------
     void AutoParamDataSource::setCurrentPass(const Pass* pass)
     {
+        markChanged(Source::PASS);
         mCurrentPass = pass;
     }
     //-----------------------------------------------------------------------------
@@ -611,6 +680,7 @@ namespace Ogre {
     void AutoParamDataSource::setFog(FogMode mode, const ColourValue& colour,
         Real expDensity, Real linearStart, Real linearEnd)
     {
+        markChanged(Source::OTHER);
         (void)mode; // ignored
         mFogColour = colour;
         mFogParams[0] = expDensity;
@@ -631,6 +701,7 @@ namespace Ogre {
 
     void AutoParamDataSource::setPointParameters(bool attenuation, const Vector4f& params)
     {
+        markChanged(Source::OTHER);
         mPointParams = params;
         if(attenuation)
             mPointParams[0] *= getViewportHeight();
@@ -643,9 +714,16 @@ namespace Ogre {
     //-----------------------------------------------------------------------------
     void AutoParamDataSource::setTextureProjector(const Frustum* frust, size_t index = 0)
     {
+        setTextureProjector(frust, index, Vector4{0, 0, 1, 1});
+    }
+    //-----------------------------------------------------------------------------
+    void AutoParamDataSource::setTextureProjector(const Frustum* frust, size_t index, const Vector4& tile)
+    {
+        markChanged(Source::OTHER);
         if (index < OGRE_MAX_SIMULTANEOUS_LIGHTS)
         {
             mCurrentTextureProjector[index] = frust;
+            mTextureProjectorTile[index] = tile;
             mTextureViewProjMatrixDirty[index] = true;
             mTextureWorldViewProjMatrixDirty[index] = true;
             mShadowCamDepthRangesDirty[index] = true;
@@ -678,6 +756,17 @@ namespace Ogre {
                         mCurrentTextureProjector[index]->getProjectionMatrixWithRSDepth() * 
                         mCurrentTextureProjector[index]->getViewMatrix();
                 }
+                const Vector4& tile = mTextureProjectorTile[index];
+                if (tile != Vector4{0, 0, 1, 1})
+                {
+                    // map to the part of the texture the projector renders to
+                    Matrix4 toTile = Matrix4::IDENTITY;
+                    toTile[0][0] = tile.z;
+                    toTile[0][3] = tile.x;
+                    toTile[1][1] = tile.w;
+                    toTile[1][3] = tile.y;
+                    mTextureViewProjMatrix[index] = toTile * mTextureViewProjMatrix[index];
+                }
                 mTextureViewProjMatrixDirty[index] = false;
             }
             return mTextureViewProjMatrix[index];
@@ -798,6 +887,7 @@ namespace Ogre {
     //-----------------------------------------------------------------------------
     void AutoParamDataSource::setCurrentRenderTarget(const RenderTarget* target)
     {
+        markChanged(Source::OTHER);
         mCurrentRenderTarget = target;
     }
     //-----------------------------------------------------------------------------
@@ -808,16 +898,19 @@ namespace Ogre {
     //-----------------------------------------------------------------------------
     void AutoParamDataSource::setCurrentViewport(const Viewport* viewport)
     {
+        markChanged(Source::OTHER);
         mCurrentViewport = viewport;
     }
     //-----------------------------------------------------------------------------
     void AutoParamDataSource::setShadowDirLightExtrusionDistance(Real dist)
     {
+        markChanged(Source::OTHER);
         mDirLightExtrusionDistance = dist;
     }
     //-----------------------------------------------------------------------------
     void AutoParamDataSource::setShadowPointLightExtrusionDistance(Real dist)
     {
+        markChanged(Source::OTHER);
         mPointLightExtrusionDistance = dist;
     }
     //-----------------------------------------------------------------------------
@@ -1048,11 +1141,13 @@ namespace Ogre {
     //-----------------------------------------------------------------------------
     void AutoParamDataSource::setPassNumber(const int passNumber)
     {
+        markChanged(Source::PASS);
         mPassNumber = passNumber;
     }
     //-----------------------------------------------------------------------------
     void AutoParamDataSource::incPassNumber()
     {
+        markChanged(Source::PASS);
         ++mPassNumber;
     }
     //-----------------------------------------------------------------------------
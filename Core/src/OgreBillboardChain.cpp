@@ -115,6 +115,8 @@ namespace Ogre {
         // Allocate enough space for everything
         mChainElementList.resize(mChainCount * mMaxElementsPerChain);
         mVertexData->vertexCount = mChainElementList.size() * 2;
+        mElementDirty.assign(mChainElementList.size(), false);
+        mDirtyElements.clear();
 
         // Configure chains
         mChainSegmentList.resize(mChainCount);
@@ -147,7 +149,13 @@ namespace Ogre {
 
             if (mUseTexCoords)
             {
-                decl->addElement(0, offset, VertexElementType::FLOAT2, VertexElementSemantic::TEXTURE_COORDINATES);
+                offset += decl->addElement(0, offset, VertexElementType::FLOAT2, VertexElementSemantic::TEXTURE_COORDINATES).getSize();
+            }
+
+            if (mIncrementalUpdates)
+            {
+                // tangent and signed half width, for the expansion in the vertex program
+                decl->addElement(0, offset, VertexElementType::FLOAT4, VertexElementSemantic::TEXTURE_COORDINATES, 1);
             }
 
             if (!mUseTexCoords && !mUseVertexColour)
@@ -167,12 +175,14 @@ namespace Ogre {
         setupVertexDeclaration();
         if (mBuffersNeedRecreating)
         {
-            // Create the vertex buffer (always dynamic due to the camera adjust)
+            // Create the vertex buffer (always dynamic due to the camera adjust),
+            // incremental updates keep the contents between the writes
             HardwareVertexBufferSharedPtr pBuffer =
                 HardwareBufferManager::getSingleton().createVertexBuffer(
                 mVertexData->vertexDeclaration->getVertexSize(0),
                 mVertexData->vertexCount,
-                HardwareBuffer::DYNAMIC_WRITE_ONLY_DISCARDABLE);
+                mIncrementalUpdates ? HardwareBuffer::DYNAMIC_WRITE_ONLY
+                                    : HardwareBuffer::DYNAMIC_WRITE_ONLY_DISCARDABLE);
 
             // (re)Bind the buffer
             // Any existing buffer will lose its reference count and be destroyed
@@ -237,6 +247,35 @@ namespace Ogre {
         mBuffersNeedRecreating = mIndexContentDirty = mVertexContentDirty = true;
     }
     //-----------------------------------------------------------------------
+    void BillboardChain::setIncrementalUpdatesEnabled(bool enabled)
+    {
+        mIncrementalUpdates = enabled;
+        mVertexDeclDirty = mBuffersNeedRecreating = true;
+        mIndexContentDirty = mVertexContentDirty = true;
+    }
+    //-----------------------------------------------------------------------
+    void BillboardChain::markElementDirty(size_t chainIndex, size_t element)
+    {
+        // a full update is pending anyway
+        if (!mIncrementalUpdates || mVertexContentDirty)
+        {
+            mVertexContentDirty = true;
+            return;
+        }
+
+        size_t start = mChainSegmentList[chainIndex].start;
+        size_t prev = element == 0 ? mMaxElementsPerChain - 1 : element - 1;
+        size_t next = element + 1 == mMaxElementsPerChain ? 0 : element + 1;
+        for (size_t e : {prev, element, next})
+        {
+            if (!mElementDirty[start + e])
+            {
+                mElementDirty[start + e] = true;
+                mDirtyElements.push_back(start + e);
+            }
+        }
+    }
+    //-----------------------------------------------------------------------
     void BillboardChain::addChainElement(size_t chainIndex,
         const BillboardChain::Element& dtls)
     {
@@ -268,13 +307,16 @@ namespace Ogre {
                     seg.tail = mMaxElementsPerChain - 1;
                 else
                     --seg.tail;
+                // the new tail gets a new tangent
+                markElementDirty(chainIndex, seg.tail);
             }
         }
 
         // Set the details
         mChainElementList[seg.start + seg.head] = dtls;
 
-        mVertexContentDirty = true;
+        // the previous head gets a new tangent too
+        markElementDirty(chainIndex, seg.head);
         mIndexContentDirty = true;
         mBoundsDirty = true;
         // tell parent node to update bounds
@@ -304,8 +346,9 @@ namespace Ogre {
             --seg.tail;
         }
 
-        // we removed an entry so indexes need updating
-        mVertexContentDirty = true;
+        // we removed an entry so indexes need updating, the new tail gets a new tangent
+        if (seg.tail != SEGMENT_EMPTY)
+            markElementDirty(chainIndex, seg.tail);
         mIndexContentDirty = true;
         mBoundsDirty = true;
         // tell parent node to update bounds
@@ -359,7 +402,7 @@ namespace Ogre {
 
         mChainElementList[idx] = dtls;
 
-        mVertexContentDirty = true;
+        markElementDirty(chainIndex, idx - seg.start);
         mBoundsDirty = true;
         // tell parent node to update bounds
         if (mParentNode)
@@ -446,141 +489,199 @@ namespace Ogre {
         }
     }
     //-----------------------------------------------------------------------
+    void BillboardChain::writeElementVertices(const ChainSegment& seg, size_t e, const Vector3& eyePos,
+                                              float* pFloat)
+    {
+        const Element& elem = mChainElementList[e + seg.start];
+
+        // Get index of next item
+        size_t nexte = e + 1;
+        if (nexte == mMaxElementsPerChain)
+            nexte = 0;
+        size_t laste = e == 0 ? mMaxElementsPerChain - 1 : e - 1;
+
+        Vector3 chainTangent;
+        if (e == seg.head)
+        {
+            // No laste, use next item
+            chainTangent = mChainElementList[nexte + seg.start].position - elem.position;
+        }
+        else if (e == seg.tail)
+        {
+            // No nexte, use only last item
+            chainTangent = elem.position - mChainElementList[laste + seg.start].position;
+        }
+        else
+        {
+            // A mid position, use tangent across both prev and next
+            chainTangent = mChainElementList[nexte + seg.start].position - mChainElementList[laste + seg.start].position;
+
+        }
+
+        Vector3 pos0 = elem.position;
+        Vector3 pos1 = elem.position;
+        Vector4 expansion{0, 0, 0, 0};
+        if (mIncrementalUpdates && mFaceCamera)
+        {
+            // the vertex program does the camera dependent part
+            expansion = Vector4{chainTangent.x, chainTangent.y, chainTangent.z, elem.width * 0.5f};
+        }
+        else
+        {
+            Vector3 vP1ToEye;
+
+            if( mFaceCamera )
+                vP1ToEye = eyePos - elem.position;
+            else
+                vP1ToEye = elem.orientation * mNormalBase;
+
+            Vector3 vPerpendicular = chainTangent.crossProduct(vP1ToEye);
+            vPerpendicular.normalise();
+            vPerpendicular *= (elem.width * 0.5f);
+
+            pos0 = elem.position - vPerpendicular;
+            pos1 = elem.position + vPerpendicular;
+        }
+
+        RGBA col = elem.colour.getAsBYTE();
+        for (int side = 0; side < 2; ++side)
+        {
+            const Vector3& pos = side == 0 ? pos0 : pos1;
+            *pFloat++ = pos.x;
+            *pFloat++ = pos.y;
+            *pFloat++ = pos.z;
+
+            if (mUseVertexColour)
+            {
+                memcpy(pFloat++, &col, sizeof(RGBA));
+            }
+
+            if (mUseTexCoords)
+            {
+                if (mTexCoordDir == TexCoordDirection::U)
+                {
+                    *pFloat++ = elem.texCoord;
+                    *pFloat++ = mOtherTexCoordRange[side];
+                }
+                else
+                {
+                    *pFloat++ = mOtherTexCoordRange[side];
+                    *pFloat++ = elem.texCoord;
+                }
+            }
+
+            if (mIncrementalUpdates)
+            {
+                *pFloat++ = expansion.x;
+                *pFloat++ = expansion.y;
+                *pFloat++ = expansion.z;
+                *pFloat++ = side == 0 ? -expansion.w : expansion.w;
+            }
+        }
+    }
+    //-----------------------------------------------------------------------
     void BillboardChain::updateVertexBuffer(Camera* cam)
     {
         setupBuffers();
-        
+
+        HardwareVertexBufferSharedPtr pBuffer =
+            mVertexData->vertexBufferBinding->getBuffer(0);
+        size_t elementSize = pBuffer->getVertexSize() * 2;
+
+        if (mIncrementalUpdates && !mVertexContentDirty)
+        {
+            // the contents do not depend on the camera, only write what changed
+            if (mDirtyElements.empty())
+                return;
+
+            std::ranges::sort(mDirtyElements);
+            std::vector<float> scratch;
+            for (size_t i = 0; i < mDirtyElements.size();)
+            {
+                // find the run of adjacent live elements in the same segment
+                size_t first = mDirtyElements[i];
+                const ChainSegment& seg = mChainSegmentList[first / mMaxElementsPerChain];
+                auto isLive = [&](size_t slot) -> bool
+                {
+                    if (seg.head == SEGMENT_EMPTY || seg.head == seg.tail)
+                        return false;
+                    size_t e = slot - seg.start;
+                    size_t fromHead = (e + mMaxElementsPerChain - seg.head) % mMaxElementsPerChain;
+                    size_t toTail = (seg.tail + mMaxElementsPerChain - seg.head) % mMaxElementsPerChain;
+                    return fromHead <= toTail;
+                };
+
+                size_t last = first;
+                while (i + 1 < mDirtyElements.size() && mDirtyElements[i + 1] == last + 1 &&
+                       mDirtyElements[i + 1] < seg.start + mMaxElementsPerChain)
+                    last = mDirtyElements[++i];
+                ++i;
+
+                for (size_t slot = first; slot <= last;)
+                {
+                    if (!isLive(slot))
+                    {
+                        ++slot;
+                        continue;
+                    }
+                    size_t runStart = slot;
+                    while (slot <= last && isLive(slot))
+                        ++slot;
+
+                    scratch.resize((slot - runStart) * elementSize / sizeof(float));
+                    auto* pFloat = scratch.data();
+                    for (size_t e = runStart; e < slot; ++e, pFloat += elementSize / sizeof(float))
+                        writeElementVertices(seg, e - seg.start, Vector3::ZERO, pFloat);
+                    pBuffer->writeData(runStart * elementSize, (slot - runStart) * elementSize, scratch.data());
+                }
+            }
+
+            for (size_t slot : mDirtyElements)
+                mElementDirty[slot] = false;
+            mDirtyElements.clear();
+            return;
+        }
+
         // The contents of the vertex buffer are correct if they are not dirty
         // and the camera used to build the vertex buffer is still the current 
         // camera.
         if (!mVertexContentDirty && mVertexCameraUsed == cam)
             return;
 
-        HardwareVertexBufferSharedPtr pBuffer =
-            mVertexData->vertexBufferBinding->getBuffer(0);
         HardwareBufferLockGuard vertexLock(pBuffer, HardwareBuffer::LockOptions::DISCARD);
 
         const Vector3& camPos = cam->getDerivedPosition();
         Vector3 eyePos = mParentNode->convertWorldToLocalPosition(camPos);
 
-        Vector3 chainTangent;
         for (auto & seg : mChainSegmentList)
         {
             // Skip 0 or 1 element segment counts
             if (seg.head != SEGMENT_EMPTY && seg.head != seg.tail)
             {
-                size_t laste = seg.head;
                 for (size_t e = seg.head; ; ++e) // until break
                 {
                     // Wrap forwards
                     if (e == mMaxElementsPerChain)
                         e = 0;
 
-                    Element& elem = mChainElementList[e + seg.start];
                     assert (((e + seg.start) * 2) < 65536 && "Too many elements!");
-                    auto baseIdx = static_cast<uint16>((e + seg.start) * 2);
 
                     // Determine base pointer to vertex #1
                     auto* pFloat = reinterpret_cast<float*>(
-                        static_cast<char*>(vertexLock.pData) +
-                            pBuffer->getVertexSize() * baseIdx);
-
-                    // Get index of next item
-                    size_t nexte = e + 1;
-                    if (nexte == mMaxElementsPerChain)
-                        nexte = 0;
-
-                    if (e == seg.head)
-                    {
-                        // No laste, use next item
-                        chainTangent = mChainElementList[nexte + seg.start].position - elem.position;
-                    }
-                    else if (e == seg.tail)
-                    {
-                        // No nexte, use only last item
-                        chainTangent = elem.position - mChainElementList[laste + seg.start].position;
-                    }
-                    else
-                    {
-                        // A mid position, use tangent across both prev and next
-                        chainTangent = mChainElementList[nexte + seg.start].position - mChainElementList[laste + seg.start].position;
-
-                    }
-
-                    Vector3 vP1ToEye;
-
-                    if( mFaceCamera )
-                        vP1ToEye = eyePos - elem.position;
-                    else
-                        vP1ToEye = elem.orientation * mNormalBase;
-
-                    Vector3 vPerpendicular = chainTangent.crossProduct(vP1ToEye);
-                    vPerpendicular.normalise();
-                    vPerpendicular *= (elem.width * 0.5f);
-
-                    Vector3 pos0 = elem.position - vPerpendicular;
-                    Vector3 pos1 = elem.position + vPerpendicular;
-
-                    // pos1
-                    *pFloat++ = pos0.x;
-                    *pFloat++ = pos0.y;
-                    *pFloat++ = pos0.z;
-
-                    if (mUseVertexColour)
-                    {
-                        RGBA col = elem.colour.getAsBYTE();
-                        memcpy(pFloat++, &col, sizeof(RGBA));
-                    }
-
-                    if (mUseTexCoords)
-                    {
-                        if (mTexCoordDir == TexCoordDirection::U)
-                        {
-                            *pFloat++ = elem.texCoord;
-                            *pFloat++ = mOtherTexCoordRange[0];
-                        }
-                        else
-                        {
-                            *pFloat++ = mOtherTexCoordRange[0];
-                            *pFloat++ = elem.texCoord;
-                        }
-                    }
-
-                    // pos2
-                    *pFloat++ = pos1.x;
-                    *pFloat++ = pos1.y;
-                    *pFloat++ = pos1.z;
-
-                    if (mUseVertexColour)
-                    {
-                        RGBA col = elem.colour.getAsBYTE();
-                        memcpy(pFloat++, &col, sizeof(RGBA));
-                    }
-
-                    if (mUseTexCoords)
-                    {
-                        if (mTexCoordDir == TexCoordDirection::U)
-                        {
-                            *pFloat++ = elem.texCoord;
-                            *pFloat++ = mOtherTexCoordRange[1];
-                        }
-                        else
-                        {
-                            *pFloat++ = mOtherTexCoordRange[1];
-                            *pFloat++ = elem.texCoord;
-                        }
-                    }
+                        static_cast<char*>(vertexLock.pData) + elementSize * (e + seg.start));
+                    writeElementVertices(seg, e, eyePos, pFloat);
 
                     if (e == seg.tail)
                         break; // last one
 
-                    laste = e;
-
                 } // element
             } // segment valid?
 
         } // each segment
 
+        for (size_t slot : mDirtyElements)
+            mElementDirty[slot] = false;
+        mDirtyElements.clear();
         mVertexCameraUsed = cam;
         mVertexContentDirty = false;
     }
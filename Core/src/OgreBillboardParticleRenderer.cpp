@@ -82,6 +82,13 @@ namespace Ogre {
         auto doGet(const void* target) const -> String override;
         void doSet(void* target, std::string_view val) override;
     };
+    /** Command object for instanced rendering (see ParamCommand).*/
+    class CmdInstancedRendering : public ParamCommand
+    {
+    public:
+        auto doGet(const void* target) const -> String override;
+        void doSet(void* target, std::string_view val) override;
+    };
     /** Command object for accurate facing(see ParamCommand).*/
     class CmdAccurateFacing : public ParamCommand
     {
@@ -95,6 +102,7 @@ namespace Ogre {
     static CmdCommonDirection msCommonDirectionCmd;
     static CmdCommonUpVector msCommonUpVectorCmd;
     static CmdPointRendering msPointRenderingCmd;
+    static CmdInstancedRendering msInstancedRenderingCmd;
     static CmdAccurateFacing msAccurateFacingCmd;
 
     static class CmdStacksAndSlices : public ParamCommand
@@ -164,6 +172,14 @@ namespace Ogre {
                 "Possible values are 'true' or 'false'.",
                 ParameterType::BOOL),
                 &msPointRenderingCmd);
+            dict->addParameter(ParameterDef("instanced_rendering",
+                "Set whether or not particles will be expanded from one instance "
+                "entry each in the vertex shader rather than generating quads on "
+                "the CPU. Needs a vertex shader, e.g. 'transform_stage billboard' "
+                "for the RTSS, and is not used for the _self billboard types or "
+                "accurate facing. Possible values are 'true' or 'false'.",
+                ParameterType::BOOL),
+                &msInstancedRenderingCmd);
             dict->addParameter(ParameterDef("accurate_facing",
                 "Set whether or not particles will be oriented to the camera "
                 "based on the relative position to the camera rather than just "
@@ -433,6 +449,17 @@ namespace Ogre {
             StringConverter::parseBool(val));
     }
     //-----------------------------------------------------------------------
+    auto CmdInstancedRendering::doGet(const void* target) const -> String
+    {
+        return StringConverter::toString(
+            static_cast<const BillboardParticleRenderer*>(target)->isInstancedRenderingEnabled() );
+    }
+    void CmdInstancedRendering::doSet(void* target, std::string_view val)
+    {
+        static_cast<BillboardParticleRenderer*>(target)->setInstancedRenderingEnabled(
+            StringConverter::parseBool(val));
+    }
+    //-----------------------------------------------------------------------
     auto CmdAccurateFacing::doGet(const void* target) const -> String
     {
         return StringConverter::toString(
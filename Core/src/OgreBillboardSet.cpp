@@ -57,8 +57,10 @@ import :SceneNode;
 import :Sphere;
 import :StringConverter;
 import :VertexIndexData;
+import :WorkQueue;
 
 import <algorithm>;
+import <future>;
 import <iterator>;
 import <map>;
 import <memory>;
@@ -129,6 +131,10 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     BillboardSet::~BillboardSet()
     {
+        // a running sort still uses the sorter
+        if (mSortTask.valid())
+            mSortTask.wait();
+
         // Delete shared buffers
         _destroyBuffers();
     }
@@ -151,6 +157,7 @@ namespace Ogre {
 
         // Get a new billboard
         Billboard* newBill = mBillboardPool[mActiveBillboards++].get();
+        ++mPoolGeneration;
         newBill->setPosition(position);
         newBill->setColour(colour);
         newBill->mDirection = Vector3::ZERO;
@@ -176,6 +183,7 @@ namespace Ogre {
     void BillboardSet::clear()
     {
         mActiveBillboards = 0;
+        ++mPoolGeneration;
     }
 
     //-----------------------------------------------------------------------
@@ -190,6 +198,7 @@ namespace Ogre {
     {
         assert(index < mActiveBillboards && "Billboard isn't in the active list.");
         std::swap(mBillboardPool[index], mBillboardPool[--mActiveBillboards]);
+        ++mPoolGeneration;
     }
 
     //-----------------------------------------------------------------------
@@ -219,20 +228,81 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     void BillboardSet::_sortBillboards( Camera* cam)
     {
-        static RadixSort<BillboardPool, ::std::unique_ptr<Billboard>, float> mRadixSorter;
+        // apply what the previous update left running
+        finishSort();
+
+        Vector3 camDir = mCamQ * Vector3::NEGATIVE_UNIT_Z;
+        unsigned long frame = Root::getSingleton().getNextFrameNumber();
+        if (mSortDone)
+        {
+            bool intervalPassed = mSortInterval > 0 && frame - mLastSortFrame >= mSortInterval;
+            bool cameraMoved =
+                mCamPos.squaredDistance(mLastSortCamPos) > mSortDistanceThreshold * mSortDistanceThreshold ||
+                camDir.angleBetween(mLastSortCamDir) > mSortAngleThreshold;
+            if (!intervalPassed && !cameraMoved)
+                return;
+        }
+        mSortDone = true;
+        mLastSortFrame = frame;
+        mLastSortCamPos = mCamPos;
+        mLastSortCamDir = camDir;
 
+        auto first = mBillboardPool.begin();
+        auto last = first + mActiveBillboards;
         using enum SortMode;
         switch (_getSortMode())
         {
         case Direction:
-            mRadixSorter.sort(mBillboardPool.begin(), mBillboardPool.begin() + mActiveBillboards,
-                              SortByDirectionFunctor{-mCamDir});
+            mSorter.computeKeys(first, last, SortByDirectionFunctor{-camDir});
             break;
         case Distance:
-            mRadixSorter.sort(mBillboardPool.begin(), mBillboardPool.begin() + mActiveBillboards,
-                              SortByDistanceFunctor{mCamPos});
+            mSorter.computeKeys(first, last, SortByDistanceFunctor{mCamPos});
             break;
         }
+
+        WorkQueue* workQueue = Root::getSingleton().getWorkQueue();
+        // large sets sort in parallel, unless the sort is a task of the queue itself
+        mSorter.setWorkQueue(mSortAsync ? nullptr : workQueue);
+        if (mSortAsync && workQueue)
+        {
+            auto task = std::make_shared<std::packaged_task<void()>>([this] { mSorter.sortKeys(); });
+            mSortTask = task->get_future();
+            mSortGeneration = mPoolGeneration;
+            workQueue->addTask([task] { (*task)(); });
+            return;
+        }
+
+        mSorter.sortKeys();
+        mSorter.applyOrder(first, last);
+    }
+    //-----------------------------------------------------------------------
+    void BillboardSet::finishSort()
+    {
+        if (!mSortTask.valid())
+            return;
+
+        mSortTask.get();
+        if (mSortGeneration == mPoolGeneration)
+            mSorter.applyOrder(mBillboardPool.begin(), mBillboardPool.begin() + mActiveBillboards);
+        else
+            // the billboards changed meanwhile, sort them again right away
+            mSortDone = false;
+    }
+    //-----------------------------------------------------------------------
+    void BillboardSet::setSortInterval(unsigned int interval, Real distanceThreshold,
+                                       const Radian& angleThreshold)
+    {
+        mSortInterval = interval;
+        mSortDistanceThreshold = distanceThreshold;
+        mSortAngleThreshold = angleThreshold;
+        mSortDone = false;
+    }
+    //-----------------------------------------------------------------------
+    void BillboardSet::setSortAsync(bool async)
+    {
+        if (!async)
+            finishSort();
+        mSortAsync = async;
     }
     auto BillboardSet::SortByDirectionFunctor::operator()(Billboard const* bill) const noexcept -> float
     {
@@ -303,7 +373,10 @@ namespace Ogre {
            use hardware TnL if it is available.
         */
 
-        // create vertex and index buffers if they haven't already been
+        // create vertex and index buffers if they haven't already been, or if the
+        // billboard setup changed between instanced and CPU generated quads
+        if (mBuffersCreated && mBuffersInstanced != canRenderInstanced())
+            _destroyBuffers();
         if(!mBuffersCreated)
             _createBuffers();
 
@@ -329,6 +402,15 @@ namespace Ogre {
                     mDefaultWidth, mDefaultHeight, mCamX, mCamY, mVOffset);
 
             }
+
+            // The vertex shader does the rest
+            if (mBuffersInstanced)
+            {
+                setCustomParameter(INSTANCED_PARAM_AXIS_X,
+                    Vector4{mCamX.x, mCamX.y, mCamX.z, mRotationType == BillboardRotationType::TEXCOORD ? 1.0f : 0.0f});
+                setCustomParameter(INSTANCED_PARAM_AXIS_Y, Vector4{mCamY.x, mCamY.y, mCamY.z, 0.0f});
+                setCustomParameter(INSTANCED_PARAM_OFFSETS, Vector4{mLeftOff, mRightOff, mTopOff, mBottomOff});
+            }
         }
 
         // Init num visible
@@ -341,9 +423,10 @@ namespace Ogre {
             numBillboards = std::min(mPoolSize, numBillboards);
 
             size_t billboardSize;
-            if (mPointRendering)
+            if (mPointRendering || mBuffersInstanced)
             {
                 // just one vertex per billboard (this also excludes texcoords)
+                // or one instance entry
                 billboardSize = mMainBuf->getVertexSize();
             }
             else
@@ -382,6 +465,12 @@ namespace Ogre {
             return;
         }
 
+        if (mBuffersInstanced)
+        {
+            genInstanceData(bb);
+            return;
+        }
+
         if ((mBillboardType == BillboardType::ORIENTED_SELF || mBillboardType == BillboardType::PERPENDICULAR_SELF ||
              (mAccurateFacing && mBillboardType != BillboardType::PERPENDICULAR_COMMON)))
         {
@@ -506,7 +595,20 @@ namespace Ogre {
         op.vertexData = mVertexData.get();
         op.vertexData->vertexStart = 0;
 
-        if (mPointRendering)
+        if (mBuffersInstanced)
+        {
+            // one shared quad per billboard
+            op.operationType = RenderOperation::OperationType::TRIANGLE_LIST;
+            op.useIndexes = true;
+            op.useGlobalInstancingVertexBufferIsAvailable = false;
+            op.vertexData->vertexCount = 4;
+
+            op.indexData = mIndexData.get();
+            op.indexData->indexCount = 6;
+            op.indexData->indexStart = 0;
+            op.numberOfInstances = mNumVisibleBillboards;
+        }
+        else if (mPointRendering)
         {
             op.operationType = RenderOperation::OperationType::POINT_LIST;
             op.useIndexes = false;
@@ -584,6 +686,14 @@ namespace Ogre {
                 "expect.");
         }
 
+        mBuffersInstanced = canRenderInstanced();
+        if (mBuffersInstanced)
+        {
+            _createInstancedBuffers();
+            mBuffersCreated = true;
+            return;
+        }
+
         mVertexData = std::make_unique<VertexData>();
         if (mPointRendering)
             mVertexData->vertexCount = mPoolSize;
@@ -662,6 +772,63 @@ namespace Ogre {
         mBuffersCreated = true;
     }
     //-----------------------------------------------------------------------
+    auto BillboardSet::canRenderInstanced() const noexcept -> bool
+    {
+        // same condition as for generating the axes up-front in beginBillboards
+        return mInstancedRendering && !mPointRendering &&
+            mBillboardType != BillboardType::ORIENTED_SELF &&
+            mBillboardType != BillboardType::PERPENDICULAR_SELF &&
+            !(mAccurateFacing && mBillboardType != BillboardType::PERPENDICULAR_COMMON);
+    }
+    //-----------------------------------------------------------------------
+    void BillboardSet::_createInstancedBuffers()
+    {
+        /* Shared quad ( 4 corners as texture coords in 0..1 )
+           instances   ( position, colour, width / height / rotation, texcoord rect per billboard )
+        */
+        mVertexData = std::make_unique<VertexData>();
+        mVertexData->vertexCount = 4;
+        mVertexData->vertexStart = 0;
+
+        VertexDeclaration* decl = mVertexData->vertexDeclaration;
+        VertexBufferBinding* binding = mVertexData->vertexBufferBinding;
+
+        decl->addElement(0, 0, VertexElementType::FLOAT2, VertexElementSemantic::TEXTURE_COORDINATES, 0);
+
+        size_t offset = 0;
+        offset += decl->addElement(1, offset, VertexElementType::FLOAT3, VertexElementSemantic::POSITION).getSize();
+        offset += decl->addElement(1, offset, VertexElementType::UBYTE4_NORM, VertexElementSemantic::DIFFUSE).getSize();
+        offset += decl->addElement(1, offset, VertexElementType::FLOAT3, VertexElementSemantic::TEXTURE_COORDINATES, 1).getSize();
+        decl->addElement(1, offset, VertexElementType::FLOAT4, VertexElementSemantic::TEXTURE_COORDINATES, 2);
+
+        // Same layout as the quads, see _createBuffers
+        static const float corners[] = { 0, 0,  1, 0,  0, 1,  1, 1 };
+        HardwareVertexBufferSharedPtr quadBuf =
+            HardwareBufferManager::getSingleton().createVertexBuffer(
+                decl->getVertexSize(0), 4, HardwareBuffer::STATIC_WRITE_ONLY);
+        quadBuf->writeData(0, sizeof(corners), corners, true);
+        binding->setBinding(0, quadBuf);
+
+        mMainBuf =
+            HardwareBufferManager::getSingleton().createVertexBuffer(
+                decl->getVertexSize(1),
+                mPoolSize,
+                mAutoUpdate ? HardwareBuffer::DYNAMIC_WRITE_ONLY_DISCARDABLE :
+                HardwareBuffer::STATIC_WRITE_ONLY);
+        mMainBuf->setIsInstanceData(true);
+        mMainBuf->setInstanceDataStepRate(1);
+        binding->setBinding(1, mMainBuf);
+
+        mIndexData = std::make_unique<IndexData>();
+        mIndexData->indexStart = 0;
+        mIndexData->indexCount = 6;
+        mIndexData->indexBuffer = HardwareBufferManager::getSingleton().
+            createIndexBuffer(HardwareIndexBuffer::IndexType::_16BIT, 6,
+                HardwareBuffer::STATIC_WRITE_ONLY);
+        static const ushort indexes[] = { 0, 2, 1, 1, 2, 3 };
+        mIndexData->indexBuffer->writeData(0, sizeof(indexes), indexes, true);
+    }
+    //-----------------------------------------------------------------------
     void BillboardSet::_destroyBuffers()
     {
         mVertexData.reset();
@@ -869,6 +1036,30 @@ namespace Ogre {
         memcpy(mLockPtr++, &colour, sizeof(RGBA));
         // No texture coords in point rendering
     }
+    void BillboardSet::genInstanceData(const Billboard& bb)
+    {
+        RGBA colour = bb.mColour;
+
+        assert( bb.mUseTexcoordRect || bb.mTexcoordIndex < mTextureCoords.size() );
+        const Ogre::FloatRect & r =
+            bb.mUseTexcoordRect ? bb.mTexcoordRect : mTextureCoords[bb.mTexcoordIndex];
+
+        // position
+        *mLockPtr++ = bb.mPosition.x;
+        *mLockPtr++ = bb.mPosition.y;
+        *mLockPtr++ = bb.mPosition.z;
+        // Colour
+        memcpy(mLockPtr++, &colour, sizeof(RGBA));
+        // Dimensions & rotation
+        *mLockPtr++ = bb.mOwnDimensions ? bb.mWidth : mDefaultWidth;
+        *mLockPtr++ = bb.mOwnDimensions ? bb.mHeight : mDefaultHeight;
+        *mLockPtr++ = bb.mRotation.valueRadians();
+        // Texture coords
+        *mLockPtr++ = r.left;
+        *mLockPtr++ = r.top;
+        *mLockPtr++ = r.right;
+        *mLockPtr++ = r.bottom;
+    }
     void BillboardSet::genQuadVertices(const Vector3* const offsets, const Billboard& bb)
     {
         RGBA colour = bb.mColour;
@@ -1145,6 +1336,20 @@ namespace Ogre {
         }
     }
 
+    //-----------------------------------------------------------------------
+    void BillboardSet::setInstancedRenderingEnabled(bool enabled)
+    {
+        // Override instanced rendering if not supported
+        RenderSystem* rs = Root::getSingleton().getRenderSystem();
+        if (enabled && (!rs || !rs->getCapabilities()->hasCapability(Capabilities::VERTEX_BUFFER_INSTANCE_DATA)))
+        {
+            enabled = false;
+        }
+
+        // the buffers follow in beginBillboards
+        mInstancedRendering = enabled;
+    }
+
     //-----------------------------------------------------------------------
     void BillboardSet::setAutoUpdate(bool autoUpdate)
     {
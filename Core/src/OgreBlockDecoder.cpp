@@ -0,0 +1,1267 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+module;
+
+#include <cstddef>
+
+module Ogre.Core;
+
+import :BlockDecoder;
+import :Exception;
+import :PixelFormat;
+import :Platform;
+import :Root;
+import :WorkQueue;
+
+import <algorithm>;
+import <array>;
+import <utility>;
+
+namespace Ogre {
+    namespace
+    {
+        /// Texels of a block up to 12x12, RGBA, row by row
+        using BlockTexels = std::array<std::array<uint8, 4>, 144>;
+
+        auto clampByte(int v) -> uint8 { return static_cast<uint8>(std::clamp(v, 0, 255)); }
+
+        auto readBigEndian64(const uchar* src) -> uint64
+        {
+            uint64 v = 0;
+            for (int i = 0; i < 8; ++i)
+                v = v << 8 | src[i];
+            return v;
+        }
+
+        /// count bits from bit pos on, least significant first
+        auto readBits(const uchar* src, uint32 pos, uint32 count) -> uint32
+        {
+            uint32 v = 0;
+            for (uint32 i = 0; i < count; ++i, ++pos)
+                v |= uint32(src[pos >> 3] >> (pos & 7) & 1) << i;
+            return v;
+        }
+
+        //-----------------------------------------------------------------------
+        // BC1 - BC5
+        //-----------------------------------------------------------------------
+        void unpack565(uint32 c, int* rgb)
+        {
+            int r = c >> 11, g = c >> 5 & 63, b = c & 31;
+            rgb[0] = r << 3 | r >> 2;
+            rgb[1] = g << 2 | g >> 4;
+            rgb[2] = b << 3 | b >> 2;
+        }
+
+        /// BC1 colour block, hasAlpha enables the 3 colour mode with transparent black
+        void decodeColourBlock(const uchar* src, bool hasAlpha, BlockTexels& px)
+        {
+            uint32 c0 = src[0] | src[1] << 8, c1 = src[2] | src[3] << 8;
+            int palette[4][4];
+            unpack565(c0, palette[0]);
+            unpack565(c1, palette[1]);
+
+            bool fourColours = c0 > c1 || !hasAlpha;
+            for (int c = 0; c < 3; ++c)
+            {
+                if (fourColours)
+                {
+                    palette[2][c] = (2 * palette[0][c] + palette[1][c] + 1) / 3;
+                    palette[3][c] = (palette[0][c] + 2 * palette[1][c] + 1) / 3;
+                }
+                else
+                {
+                    palette[2][c] = (palette[0][c] + palette[1][c] + 1) / 2;
+                    palette[3][c] = 0;
+                }
+            }
+            palette[0][3] = palette[1][3] = palette[2][3] = 255;
+            palette[3][3] = fourColours ? 255 : 0;
+
+            uint32 indices = src[4] | src[5] << 8 | src[6] << 16 | uint32(src[7]) << 24;
+            for (int i = 0; i < 16; ++i)
+            {
+                const int* col = palette[indices >> (2 * i) & 3];
+                px[i] = {uint8(col[0]), uint8(col[1]), uint8(col[2]), uint8(col[3])};
+            }
+        }
+
+        /// BC2 alpha, 4 bits per pixel
+        void decodeExplicitAlphaBlock(const uchar* src, BlockTexels& px)
+        {
+            for (int i = 0; i < 16; ++i)
+                px[i][3] = uint8((src[i / 2] >> (4 * (i % 2)) & 0xF) * 17);
+        }
+
+        /// BC4 block into the given channel, also the alpha of BC3 and the channels of BC5
+        void decodeChannelBlock(const uchar* src, int channel, BlockTexels& px)
+        {
+            int a0 = src[0], a1 = src[1];
+            int values[8] = {a0, a1};
+            if (a0 > a1)
+            {
+                for (int i = 1; i < 7; ++i)
+                    values[i + 1] = ((7 - i) * a0 + i * a1 + 3) / 7;
+            }
+            else
+            {
+                for (int i = 1; i < 5; ++i)
+                    values[i + 1] = ((5 - i) * a0 + i * a1 + 2) / 5;
+                values[6] = 0;
+                values[7] = 255;
+            }
+
+            uint64 indices = 0;
+            for (int i = 0; i < 6; ++i)
+                indices |= uint64(src[2 + i]) << (8 * i);
+            for (int i = 0; i < 16; ++i)
+                px[i][channel] = uint8(values[indices >> (3 * i) & 7]);
+        }
+
+        //-----------------------------------------------------------------------
+        // BC7
+        //-----------------------------------------------------------------------
+        struct BC7Mode
+        {
+            uint8 subsets, partitionBits, rotationBits, indexSelectionBits;
+            uint8 colourBits, alphaBits, endpointPBits, sharedPBits, indexBits, indexBits2;
+        };
+        constexpr BC7Mode BC7_MODES[8] = {
+            {3, 4, 0, 0, 4, 0, 1, 0, 3, 0}, {2, 6, 0, 0, 6, 0, 0, 1, 3, 0}, {3, 6, 0, 0, 5, 0, 0, 0, 2, 0},
+            {2, 6, 0, 0, 7, 0, 1, 0, 2, 0}, {1, 0, 2, 1, 5, 6, 0, 0, 2, 3}, {1, 0, 2, 0, 7, 8, 0, 0, 2, 2},
+            {1, 0, 0, 0, 7, 7, 1, 0, 4, 0}, {2, 6, 0, 0, 5, 5, 1, 0, 2, 0}};
+
+        /// The pixels of the second subset of the two subset partitions
+        constexpr uint16 BC7_PARTITIONS2[64] = {
+            0xCCCC, 0x8888, 0xEEEE, 0xECC8, 0xC880, 0xFEEC, 0xFEC8, 0xEC80, 0xC800, 0xFFEC, 0xFE80,
+            0xE800, 0xFFE8, 0xFF00, 0xFFF0, 0xF000, 0xF710, 0x008E, 0x7100, 0x08CE, 0x008C, 0x7310,
+            0x3100, 0x8CCE, 0x088C, 0x3110, 0x6666, 0x366C, 0x17E8, 0x0FF0, 0x718E, 0x399C, 0xAAAA,
+            0xF0F0, 0x5A5A, 0x33CC, 0x3C3C, 0x55AA, 0x9696, 0xA55A, 0x73CE, 0x13C8, 0x324C, 0x3BDC,
+            0x6996, 0xC33C, 0x9966, 0x0660, 0x0272, 0x04E4, 0x4E40, 0x2720, 0xC936, 0x936C, 0x39C6,
+            0x639C, 0x9336, 0x9CC6, 0x817E, 0xE718, 0xCCF0, 0x0FCC, 0x7744, 0xEE22};
+
+        constexpr uint8 BC7_PARTITIONS3[64][16] = {
+            {0, 0, 1, 1, 0, 0, 1, 1, 0, 2, 2, 1, 2, 2, 2, 2}, {0, 0, 0, 1, 0, 0, 1, 1, 2, 2, 1, 1, 2, 2, 2, 1},
+            {0, 0, 0, 0, 2, 0, 0, 1, 2, 2, 1, 1, 2, 2, 1, 1}, {0, 2, 2, 2, 0, 0, 2, 2, 0, 0, 1, 1, 0, 1, 1, 1},
+            {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 2, 2, 1, 1, 2, 2}, {0, 0, 1, 1, 0, 0, 1, 1, 0, 0, 2, 2, 0, 0, 2, 2},
+            {0, 0, 2, 2, 0, 0, 2, 2, 1, 1, 1, 1, 1, 1, 1, 1}, {0, 0, 1, 1, 0, 0, 1, 1, 2, 2, 1, 1, 2, 2, 1, 1},
+            {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2}, {0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 2, 2, 2, 2},
+            {0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 2, 2, 2, 2}, {0, 0, 1, 2, 0, 0, 1, 2, 0, 0, 1, 2, 0, 0, 1, 2},
+            {0, 1, 1, 2, 0, 1, 1, 2, 0, 1, 1, 2, 0, 1, 1, 2}, {0, 1, 2, 2, 0, 1, 2, 2, 0, 1, 2, 2, 0, 1, 2, 2},
+            {0, 0, 1, 1, 0, 1, 1, 2, 1, 1, 2, 2, 1, 2, 2, 2}, {0, 0, 1, 1, 2, 0, 0, 1, 2, 2, 0, 0, 2, 2, 2, 0},
+            {0, 0, 0, 1, 0, 0, 1, 1, 0, 1, 1, 2, 1, 1, 2, 2}, {0, 1, 1, 1, 0, 0, 1, 1, 2, 0, 0, 1, 2, 2, 0, 0},
+            {0, 0, 0, 0, 1, 1, 2, 2, 1, 1, 2, 2, 1, 1, 2, 2}, {0, 0, 2, 2, 0, 0, 2, 2, 0, 0, 2, 2, 1, 1, 1, 1},
+            {0, 1, 1, 1, 0, 1, 1, 1, 0, 2, 2, 2, 0, 2, 2, 2}, {0, 0, 0, 1, 0, 0, 0, 1, 2, 2, 2, 1, 2, 2, 2, 1},
+            {0, 0, 0, 0, 0, 0, 1, 1, 0, 1, 2, 2, 0, 1, 2, 2}, {0, 0, 0, 0, 1, 1, 0, 0, 2, 2, 1, 0, 2, 2, 1, 0},
+            {0, 1, 2, 2, 0, 1, 2, 2, 0, 0, 1, 1, 0, 0, 0, 0}, {0, 0, 1, 2, 0, 0, 1, 2, 1, 1, 2, 2, 2, 2, 2, 2},
+            {0, 1, 1, 0, 1, 2, 2, 1, 1, 2, 2, 1, 0, 1, 1, 0}, {0, 0, 0, 0, 0, 1, 1, 0, 1, 2, 2, 1, 1, 2, 2, 1},
+            {0, 0, 2, 2, 1, 1, 0, 2, 1, 1, 0, 2, 0, 0, 2, 2}, {0, 1, 1, 0, 0, 1, 1, 0, 2, 0, 0, 2, 2, 2, 2, 2},
+            {0, 0, 1, 1, 0, 1, 2, 2, 0, 1, 2, 2, 0, 0, 1, 1}, {0, 0, 0, 0, 2, 0, 0, 0, 2, 2, 1, 1, 2, 2, 2, 1},
+            {0, 0, 0, 0, 0, 0, 0, 2, 1, 1, 2, 2, 1, 2, 2, 2}, {0, 2, 2, 2, 0, 0, 2, 2, 0, 0, 1, 2, 0, 0, 1, 1},
+            {0, 0, 1, 1, 0, 0, 1, 2, 0, 0, 2, 2, 0, 2, 2, 2}, {0, 1, 2, 0, 0, 1, 2, 0, 0, 1, 2, 0, 0, 1, 2, 0},
+            {0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 0, 0, 0, 0}, {0, 1, 2, 0, 1, 2, 0, 1, 2, 0, 1, 2, 0, 1, 2, 0},
+            {0, 1, 2, 0, 2, 0, 1, 2, 1, 2, 0, 1, 0, 1, 2, 0}, {0, 0, 1, 1, 2, 2, 0, 0, 1, 1, 2, 2, 0, 0, 1, 1},
+            {0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 0, 0, 0, 0, 1, 1}, {0, 1, 0, 1, 0, 1, 0, 1, 2, 2, 2, 2, 2, 2, 2, 2},
+            {0, 0, 0, 0, 0, 0, 0, 0, 2, 1, 2, 1, 2, 1, 2, 1}, {0, 0, 2, 2, 1, 1, 2, 2, 0, 0, 2, 2, 1, 1, 2, 2},
+            {0, 0, 2, 2, 0, 0, 1, 1, 0, 0, 2, 2, 0, 0, 1, 1}, {0, 2, 2, 0, 1, 2, 2, 1, 0, 2, 2, 0, 1, 2, 2, 1},
+            {0, 1, 0, 1, 2, 2, 2, 2, 2, 2, 2, 2, 0, 1, 0, 1}, {0, 0, 0, 0, 2, 1, 2, 1, 2, 1, 2, 1, 2, 1, 2, 1},
+            {0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 2, 2, 2, 2}, {0, 2, 2, 2, 0, 1, 1, 1, 0, 2, 2, 2, 0, 1, 1, 1},
+            {0, 0, 0, 2, 1, 1, 1, 2, 0, 0, 0, 2, 1, 1, 1, 2}, {0, 0, 0, 0, 2, 1, 1, 2, 2, 1, 1, 2, 2, 1, 1, 2},
+            {0, 2, 2, 2, 0, 1, 1, 1, 0, 1, 1, 1, 0, 2, 2, 2}, {0, 0, 0, 2, 1, 1, 1, 2, 1, 1, 1, 2, 0, 0, 0, 2},
+            {0, 1, 1, 0, 0, 1, 1, 0, 0, 1, 1, 0, 2, 2, 2, 2}, {0, 0, 0, 0, 0, 0, 0, 0, 2, 1, 1, 2, 2, 1, 1, 2},
+            {0, 1, 1, 0, 0, 1, 1, 0, 2, 2, 2, 2, 2, 2, 2, 2}, {0, 0, 2, 2, 0, 0, 1, 1, 0, 0, 1, 1, 0, 0, 2, 2},
+            {0, 0, 2, 2, 1, 1, 2, 2, 1, 1, 2, 2, 0, 0, 2, 2}, {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2, 1, 1, 2},
+            {0, 0, 0, 2, 0, 0, 0, 1, 0, 0, 0, 2, 0, 0, 0, 1}, {0, 2, 2, 2, 1, 2, 2, 2, 0, 2, 2, 2, 1, 2, 2, 2},
+            {0, 1, 0, 1, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2}, {0, 1, 1, 1, 2, 0, 1, 1, 2, 2, 0, 1, 2, 2, 2, 0}};
+
+        /// Anchor pixel of the second subset of the two subset partitions
+        constexpr uint8 BC7_ANCHORS2[64] = {
+            15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 2,  8,  2,  2,  8,
+            8,  15, 2,  8,  2,  2,  8,  8,  2,  2,  15, 15, 6,  8,  2,  8,  15, 15, 2,  8,  2,  2,
+            2,  15, 15, 6,  6,  2,  6,  8,  15, 15, 2,  2,  15, 15, 15, 15, 15, 2,  2,  15};
+        /// Anchor pixels of the second and third subset of the three subset partitions
+        constexpr uint8 BC7_ANCHORS3[2][64] = {
+            {3,  3,  15, 15, 8,  3,  15, 15, 8,  8,  6,  6,  6,  5,  3,  3,  3,  3,  8,  15, 3,  3,
+             6,  10, 5,  8,  8,  6,  8,  5,  15, 15, 8,  15, 3,  5,  6,  10, 8,  15, 15, 3,  15, 5,
+             15, 15, 15, 15, 3,  15, 5,  5,  5,  8,  5,  10, 5,  10, 8,  13, 15, 12, 3,  3},
+            {15, 8,  8,  3,  15, 15, 3,  8,  15, 15, 15, 15, 15, 15, 15, 8,  15, 8,  15, 3,  15, 8,
+             15, 8,  3,  15, 6,  10, 15, 15, 10, 8,  15, 3,  15, 10, 10, 8,  9,  10, 6,  15, 8,  15,
+             3,  6,  6,  8,  15, 3,  15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 3,  15, 15, 8}};
+
+        constexpr uint8 BC7_WEIGHTS2[4] = {0, 21, 43, 64};
+        constexpr uint8 BC7_WEIGHTS3[8] = {0, 9, 18, 27, 37, 46, 55, 64};
+        constexpr uint8 BC7_WEIGHTS4[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+        auto getBC7Weight(uint32 bits, uint32 index) -> int
+        {
+            return bits == 2 ? BC7_WEIGHTS2[index] : bits == 3 ? BC7_WEIGHTS3[index] : BC7_WEIGHTS4[index];
+        }
+
+        void decodeBC7Block(const uchar* src, BlockTexels& px)
+        {
+            uint32 mode = 0;
+            while (mode < 8 && !(src[0] >> mode & 1))
+                ++mode;
+            // reserved, transparent black
+            if (mode == 8)
+            {
+                std::fill_n(px.begin(), 16, std::array<uint8, 4>{});
+                return;
+            }
+
+            const BC7Mode& m = BC7_MODES[mode];
+            uint32 pos = mode + 1;
+            auto read = [&](uint32 count)
+            {
+                uint32 v = readBits(src, pos, count);
+                pos += count;
+                return v;
+            };
+
+            uint32 partition = read(m.partitionBits);
+            uint32 rotation = read(m.rotationBits);
+            uint32 indexSelection = read(m.indexSelectionBits);
+
+            // endpoints by channel, subset and endpoint
+            int endpoints[3][2][4];
+            for (int c = 0; c < 4; ++c)
+            {
+                uint32 bits = c < 3 ? m.colourBits : m.alphaBits;
+                for (int s = 0; s < m.subsets; ++s)
+                    for (int e = 0; e < 2; ++e)
+                        endpoints[s][e][c] = bits ? int(read(bits)) : 255;
+            }
+
+            int pBits[3][2] = {};
+            for (int s = 0; s < m.subsets; ++s)
+            {
+                if (m.endpointPBits)
+                {
+                    pBits[s][0] = read(1);
+                    pBits[s][1] = read(1);
+                }
+                else if (m.sharedPBits)
+                    pBits[s][0] = pBits[s][1] = read(1);
+            }
+
+            bool hasPBits = m.endpointPBits || m.sharedPBits;
+            for (int s = 0; s < m.subsets; ++s)
+            {
+                for (int e = 0; e < 2; ++e)
+                {
+                    for (int c = 0; c < 4; ++c)
+                    {
+                        uint32 bits = c < 3 ? m.colourBits : m.alphaBits;
+                        if (!bits)
+                            continue;
+                        int v = endpoints[s][e][c];
+                        if (hasPBits)
+                        {
+                            v = v << 1 | pBits[s][e];
+                            ++bits;
+                        }
+                        v <<= 8 - bits;
+                        endpoints[s][e][c] = v | v >> bits;
+                    }
+                }
+            }
+
+            auto subsetOf = [&](uint32 i) -> int
+            {
+                if (m.subsets == 2)
+                    return BC7_PARTITIONS2[partition] >> i & 1;
+                if (m.subsets == 3)
+                    return BC7_PARTITIONS3[partition][i];
+                return 0;
+            };
+            auto isAnchor = [&](uint32 i)
+            {
+                if (i == 0)
+                    return true;
+                if (m.subsets == 2)
+                    return i == BC7_ANCHORS2[partition];
+                if (m.subsets == 3)
+                    return i == BC7_ANCHORS3[0][partition] || i == BC7_ANCHORS3[1][partition];
+                return false;
+            };
+
+            uint32 indices[16], indices2[16] = {};
+            for (uint32 i = 0; i < 16; ++i)
+                indices[i] = read(m.indexBits - (isAnchor(i) ? 1 : 0));
+            if (m.indexBits2)
+            {
+                for (uint32 i = 0; i < 16; ++i)
+                    indices2[i] = read(m.indexBits2 - (i == 0 ? 1 : 0));
+            }
+
+            for (uint32 i = 0; i < 16; ++i)
+            {
+                int s = subsetOf(i);
+                int colourWeight = getBC7Weight(m.indexBits, indices[i]);
+                int alphaWeight = colourWeight;
+                if (m.indexBits2)
+                {
+                    alphaWeight = getBC7Weight(m.indexBits2, indices2[i]);
+                    if (indexSelection)
+                        std::swap(colourWeight, alphaWeight);
+                }
+
+                for (int c = 0; c < 4; ++c)
+                {
+                    int w = c < 3 ? colourWeight : alphaWeight;
+                    px[i][c] = uint8(((64 - w) * endpoints[s][0][c] + w * endpoints[s][1][c] + 32) >> 6);
+                }
+                if (rotation)
+                    std::swap(px[i][3], px[i][rotation - 1]);
+            }
+        }
+
+        //-----------------------------------------------------------------------
+        // ETC1, ETC2 and EAC
+        //-----------------------------------------------------------------------
+        constexpr int ETC_MODIFIERS[8][2] = {{2, 8},   {5, 17},  {9, 29},  {13, 42},
+                                             {18, 60}, {24, 80}, {33, 106}, {47, 183}};
+        constexpr int ETC_DISTANCES[8] = {3, 6, 11, 16, 23, 32, 41, 64};
+        constexpr int EAC_MODIFIERS[16][8] = {
+            {-3, -6, -9, -15, 2, 5, 8, 14}, {-3, -7, -10, -13, 2, 6, 9, 12}, {-2, -5, -8, -13, 1, 4, 7, 12},
+            {-2, -4, -6, -13, 1, 3, 5, 12}, {-3, -6, -8, -12, 2, 5, 7, 11}, {-3, -7, -9, -11, 2, 6, 8, 10},
+            {-4, -7, -8, -11, 3, 6, 7, 10}, {-3, -5, -8, -11, 2, 4, 7, 10}, {-2, -6, -8, -10, 1, 5, 7, 9},
+            {-2, -5, -8, -10, 1, 4, 7, 9},  {-2, -4, -8, -10, 1, 3, 7, 9},  {-2, -5, -7, -10, 1, 4, 6, 9},
+            {-3, -4, -7, -10, 2, 3, 6, 9},  {-1, -2, -3, -10, 0, 1, 2, 9},  {-4, -6, -8, -9, 3, 5, 7, 8},
+            {-3, -5, -7, -9, 2, 4, 6, 8}};
+
+        auto extend4(uint32 v) -> int { return int(v << 4 | v); }
+        auto extend5(uint32 v) -> int { return int(v << 3 | v >> 2); }
+        auto extend6(uint32 v) -> int { return int(v << 2 | v >> 4); }
+        auto extend7(uint32 v) -> int { return int(v << 1 | v >> 6); }
+
+        /** ETC1 or ETC2 colour block.
+        @param etc2 Enables the T, H and planar modes, which are invalid differential blocks in ETC1
+        @param punchThrough ETC2_RGB8A1, where the differential bit tells whether the block is opaque
+        */
+        void decodeETCBlock(const uchar* src, bool etc2, bool punchThrough, BlockTexels& px)
+        {
+            uint64 v = readBigEndian64(src);
+            bool diff = v >> 33 & 1;
+            bool opaque = !punchThrough || diff;
+            if (punchThrough)
+                diff = true;
+
+            // pixel indices are stored column by column
+            auto pixelIndex = [&](int x, int y)
+            {
+                int j = x * 4 + y;
+                return int((v >> (16 + j) & 1) << 1 | (v >> j & 1));
+            };
+            auto setPixel = [&](int x, int y, const int* rgb)
+            {
+                px[y * 4 + x] = {clampByte(rgb[0]), clampByte(rgb[1]), clampByte(rgb[2]), 255};
+            };
+            auto setPaintColours = [&](const int (&paint)[4][3])
+            {
+                for (int y = 0; y < 4; ++y)
+                {
+                    for (int x = 0; x < 4; ++x)
+                    {
+                        int idx = pixelIndex(x, y);
+                        if (!opaque && idx == 2)
+                            px[y * 4 + x] = {0, 0, 0, 0};
+                        else
+                            setPixel(x, y, paint[idx]);
+                    }
+                }
+            };
+
+            int base[2][3];
+            if (diff)
+            {
+                int r = v >> 59 & 31, g = v >> 51 & 31, b = v >> 43 & 31;
+                auto delta = [&](int shift) { return int(v >> shift & 3) - int(v >> shift & 4); };
+                int dr = delta(56), dg = delta(48), db = delta(40);
+
+                if (etc2 && (r + dr < 0 || r + dr > 31))
+                {
+                    // T mode
+                    int c1[3] = {extend4(uint32(v >> 57 & 0xC | v >> 56 & 0x3)), extend4(uint32(v >> 52 & 0xF)),
+                                 extend4(uint32(v >> 48 & 0xF))};
+                    int c2[3] = {extend4(uint32(v >> 44 & 0xF)), extend4(uint32(v >> 40 & 0xF)),
+                                 extend4(uint32(v >> 36 & 0xF))};
+                    int d = ETC_DISTANCES[v >> 33 & 0x6 | v >> 32 & 0x1];
+                    int paint[4][3];
+                    for (int c = 0; c < 3; ++c)
+                    {
+                        paint[0][c] = c1[c];
+                        paint[1][c] = c2[c] + d;
+                        paint[2][c] = c2[c];
+                        paint[3][c] = c2[c] - d;
+                    }
+                    setPaintColours(paint);
+                    return;
+                }
+                if (etc2 && (g + dg < 0 || g + dg > 31))
+                {
+                    // H mode
+                    int c1[3] = {extend4(uint32(v >> 59 & 0xF)), extend4(uint32(v >> 55 & 0xE | v >> 52 & 0x1)),
+                                 extend4(uint32(v >> 48 & 0x8 | v >> 47 & 0x7))};
+                    int c2[3] = {extend4(uint32(v >> 43 & 0xF)), extend4(uint32(v >> 39 & 0xF)),
+                                 extend4(uint32(v >> 35 & 0xF))};
+                    int order = (c1[0] << 16 | c1[1] << 8 | c1[2]) >= (c2[0] << 16 | c2[1] << 8 | c2[2]);
+                    int d = ETC_DISTANCES[v >> 32 & 0x4 | v >> 31 & 0x2 | order];
+                    int paint[4][3];
+                    for (int c = 0; c < 3; ++c)
+                    {
+                        paint[0][c] = c1[c] + d;
+                        paint[1][c] = c1[c] - d;
+                        paint[2][c] = c2[c] + d;
+                        paint[3][c] = c2[c] - d;
+                    }
+                    setPaintColours(paint);
+                    return;
+                }
+                if (etc2 && (b + db < 0 || b + db > 31))
+                {
+                    // planar mode, origin, horizontal and vertical colour
+                    int o[3] = {extend6(uint32(v >> 57 & 0x3F)), extend7(uint32(v >> 50 & 0x40 | v >> 49 & 0x3F)),
+                                extend6(uint32(v >> 43 & 0x20 | v >> 40 & 0x18 | v >> 39 & 0x7))};
+                    int h[3] = {extend6(uint32(v >> 33 & 0x3E | v >> 32 & 0x1)), extend7(uint32(v >> 25 & 0x7F)),
+                                extend6(uint32(v >> 19 & 0x3F))};
+                    int w[3] = {extend6(uint32(v >> 13 & 0x3F)), extend7(uint32(v >> 6 & 0x7F)),
+                                extend6(uint32(v & 0x3F))};
+                    for (int y = 0; y < 4; ++y)
+                    {
+                        for (int x = 0; x < 4; ++x)
+                        {
+                            int rgb[3];
+                            for (int c = 0; c < 3; ++c)
+                                rgb[c] = (x * (h[c] - o[c]) + y * (w[c] - o[c]) + 4 * o[c] + 2) >> 2;
+                            setPixel(x, y, rgb);
+                        }
+                    }
+                    return;
+                }
+
+                int c1[3] = {r, g, b}, d[3] = {dr, dg, db};
+                for (int c = 0; c < 3; ++c)
+                {
+                    base[0][c] = extend5(uint32(c1[c]));
+                    base[1][c] = extend5(uint32(c1[c] + d[c]));
+                }
+            }
+            else
+            {
+                for (int c = 0; c < 3; ++c)
+                {
+                    base[0][c] = extend4(uint32(v >> (60 - 8 * c) & 0xF));
+                    base[1][c] = extend4(uint32(v >> (56 - 8 * c) & 0xF));
+                }
+            }
+
+            // individual and differential mode, two sub-blocks of 2x4 or 4x2 pixels
+            bool flip = v >> 32 & 1;
+            const int* tables[2] = {ETC_MODIFIERS[v >> 37 & 7], ETC_MODIFIERS[v >> 34 & 7]};
+            for (int y = 0; y < 4; ++y)
+            {
+                for (int x = 0; x < 4; ++x)
+                {
+                    int sub = flip ? y >= 2 : x >= 2;
+                    int idx = pixelIndex(x, y);
+                    if (!opaque && idx == 2)
+                    {
+                        px[y * 4 + x] = {0, 0, 0, 0};
+                        continue;
+                    }
+                    int modifier = tables[sub][idx & 1];
+                    if (idx & 2)
+                        modifier = -modifier;
+                    // the small modifier is replaced by 0 in non opaque blocks
+                    if (!opaque && idx == 0)
+                        modifier = 0;
+                    int rgb[3] = {base[sub][0] + modifier, base[sub][1] + modifier, base[sub][2] + modifier};
+                    setPixel(x, y, rgb);
+                }
+            }
+        }
+
+        /// EAC alpha of ETC2_RGBA8
+        void decodeEACBlock(const uchar* src, BlockTexels& px)
+        {
+            uint64 v = readBigEndian64(src);
+            int base = int(v >> 56), multiplier = int(v >> 52 & 15);
+            const int* modifiers = EAC_MODIFIERS[v >> 48 & 15];
+            for (int x = 0; x < 4; ++x)
+            {
+                for (int y = 0; y < 4; ++y)
+                {
+                    int j = x * 4 + y;
+                    px[y * 4 + x][3] = clampByte(base + modifiers[v >> (45 - 3 * j) & 7] * multiplier);
+                }
+            }
+        }
+
+        //-----------------------------------------------------------------------
+        // ASTC
+        //-----------------------------------------------------------------------
+        /// Number of values of the integer sequence encoding ranges
+        constexpr uint16 ASTC_RANGES[21] = {2, 3, 4, 5, 6, 8, 10, 12, 16, 20, 24, 32,
+                                            40, 48, 64, 80, 96, 128, 160, 192, 256};
+        /// Lowest range the colour endpoints may be encoded with
+        constexpr int ASTC_MIN_COLOUR_RANGE = 4;
+
+        /// Splits a range in its bits and trit or quint
+        struct ASTCRange
+        {
+            uint32 bits;
+            bool trit, quint;
+        };
+        auto getASTCRange(int range) -> ASTCRange
+        {
+            uint32 n = ASTC_RANGES[range];
+            bool trit = n % 3 == 0, quint = n % 5 == 0;
+            n /= trit ? 3 : quint ? 5 : 1;
+            uint32 bits = 0;
+            while (n > 1u << bits)
+                ++bits;
+            return {bits, trit, quint};
+        }
+
+        auto getISEBitCount(uint32 count, int range) -> uint32
+        {
+            ASTCRange r = getASTCRange(range);
+            uint32 bits = count * r.bits;
+            if (r.trit)
+                bits += (8 * count + 4) / 5;
+            if (r.quint)
+                bits += (7 * count + 2) / 3;
+            return bits;
+        }
+
+        /// A decoded value of an integer sequence, the trit or quint and the bits below it
+        struct ISEValue
+        {
+            uint32 tq, bits;
+        };
+
+        /// Decodes count values of the integer sequence starting at bit pos
+        void decodeISE(const uchar* src, uint32 pos, uint32 count, int range, ISEValue* out)
+        {
+            ASTCRange r = getASTCRange(range);
+            uint32 end = pos + getISEBitCount(count, range);
+            // the last block may be cut short, its missing bits are 0
+            auto read = [&](uint32 bits)
+            {
+                uint32 v = 0;
+                for (uint32 i = 0; i < bits; ++i, ++pos)
+                {
+                    if (pos < end)
+                        v |= readBits(src, pos, 1) << i;
+                }
+                return v;
+            };
+
+            if (r.trit)
+            {
+                static constexpr uint32 TRIT_BITS[5] = {2, 2, 1, 2, 1};
+                for (uint32 first = 0; first < count; first += 5)
+                {
+                    uint32 m[5], t = 0, shift = 0;
+                    for (int i = 0; i < 5; ++i)
+                    {
+                        m[i] = read(r.bits);
+                        t |= read(TRIT_BITS[i]) << shift;
+                        shift += TRIT_BITS[i];
+                    }
+
+                    uint32 trits[5], c;
+                    if ((t >> 2 & 7) == 7)
+                    {
+                        c = (t >> 5 & 7) << 2 | (t & 3);
+                        trits[4] = trits[3] = 2;
+                    }
+                    else
+                    {
+                        c = t & 0x1F;
+                        if ((t >> 5 & 3) == 3)
+                        {
+                            trits[4] = 2;
+                            trits[3] = t >> 7 & 1;
+                        }
+                        else
+                        {
+                            trits[4] = t >> 7 & 1;
+                            trits[3] = t >> 5 & 3;
+                        }
+                    }
+                    if ((c & 3) == 3)
+                    {
+                        trits[2] = 2;
+                        trits[1] = c >> 4 & 1;
+                        trits[0] = (c >> 3 & 1) << 1 | (c >> 2 & 1 & ~(c >> 3) & 1);
+                    }
+                    else if ((c >> 2 & 3) == 3)
+                    {
+                        trits[2] = trits[1] = 2;
+                        trits[0] = c & 3;
+                    }
+                    else
+                    {
+                        trits[2] = c >> 4 & 1;
+                        trits[1] = c >> 2 & 3;
+                        trits[0] = (c >> 1 & 1) << 1 | (c & 1 & ~(c >> 1) & 1);
+                    }
+
+                    for (uint32 i = 0; i < 5 && first + i < count; ++i)
+                        out[first + i] = {trits[i], m[i]};
+                }
+            }
+            else if (r.quint)
+            {
+                static constexpr uint32 QUINT_BITS[3] = {3, 2, 2};
+                for (uint32 first = 0; first < count; first += 3)
+                {
+                    uint32 m[3], q = 0, shift = 0;
+                    for (int i = 0; i < 3; ++i)
+                    {
+                        m[i] = read(r.bits);
+                        q |= read(QUINT_BITS[i]) << shift;
+                        shift += QUINT_BITS[i];
+                    }
+
+                    uint32 quints[3];
+                    if ((q >> 1 & 3) == 3 && (q >> 5 & 3) == 0)
+                    {
+                        uint32 q0 = q & 1;
+                        quints[2] = q0 << 2 | ((q >> 4 & 1) & ~q0 & 1) << 1 | ((q >> 3 & 1) & ~q0 & 1);
+                        quints[1] = quints[0] = 4;
+                    }
+                    else
+                    {
+                        uint32 c;
+                        if ((q >> 1 & 3) == 3)
+                        {
+                            quints[2] = 4;
+                            c = (q >> 3 & 3) << 3 | (~q >> 5 & 3) << 1 | (q & 1);
+                        }
+                        else
+                        {
+                            quints[2] = q >> 5 & 3;
+                            c = q & 0x1F;
+                        }
+                        if ((c & 7) == 5)
+                        {
+                            quints[1] = 4;
+                            quints[0] = c >> 3 & 3;
+                        }
+                        else
+                        {
+                            quints[1] = c >> 3 & 3;
+                            quints[0] = c & 7;
+                        }
+                    }
+
+                    for (uint32 i = 0; i < 3 && first + i < count; ++i)
+                        out[first + i] = {quints[i], m[i]};
+                }
+            }
+            else
+            {
+                for (uint32 i = 0; i < count; ++i)
+                    out[i] = {0, read(r.bits)};
+            }
+        }
+
+        /// Bits of 1 to 8 bits value v repeated to fill 8 (or fewer) bits
+        auto replicateBits(uint32 v, uint32 bits, uint32 targetBits) -> uint32
+        {
+            uint32 result = 0;
+            for (int shift = int(targetBits) - int(bits); shift > -int(bits); shift -= int(bits))
+                result |= shift >= 0 ? v << shift : v >> -shift;
+            return result & ((1u << targetBits) - 1);
+        }
+
+        /// Colour endpoint value in [0, 255]
+        auto unquantiseColour(const ISEValue& value, int range) -> int
+        {
+            ASTCRange r = getASTCRange(range);
+            if (!r.trit && !r.quint)
+                return int(replicateBits(value.bits, r.bits, 8));
+
+            uint32 a = (value.bits & 1) ? 0x1FF : 0;
+            uint32 hi = value.bits >> 1, b = 0, c = 0;
+            if (r.trit)
+            {
+                switch (r.bits)
+                {
+                case 1: c = 204; break;
+                case 2: b = hi * 0x116; c = 93; break;
+                case 3: b = hi << 7 | hi << 2 | hi; c = 44; break;
+                case 4: b = hi << 6 | hi; c = 22; break;
+                case 5: b = hi << 5 | hi >> 2; c = 11; break;
+                default: b = hi << 4 | hi >> 4; c = 5; break;
+                }
+            }
+            else
+            {
+                switch (r.bits)
+                {
+                case 1: c = 113; break;
+                case 2: b = hi * 0x10C; c = 54; break;
+                case 3: b = hi << 7 | hi << 1 | hi >> 1; c = 26; break;
+                case 4: b = hi << 6 | hi >> 1; c = 13; break;
+                default: b = hi << 5 | hi >> 3; c = 6; break;
+                }
+            }
+            uint32 t = (value.tq * c + b) ^ a;
+            return int((a & 0x80) | t >> 2);
+        }
+
+        /// Weight in [0, 64]
+        auto unquantiseWeight(const ISEValue& value, int range) -> int
+        {
+            ASTCRange r = getASTCRange(range);
+            uint32 t;
+            if (!r.trit && !r.quint)
+                t = replicateBits(value.bits, r.bits, 6);
+            else if (r.bits == 0)
+                t = r.trit ? (value.tq * 63 + 1) / 2 : (value.tq * 63 + 2) / 4;
+            else
+            {
+                uint32 a = (value.bits & 1) ? 0x7F : 0;
+                uint32 hi = value.bits >> 1, b = 0, c;
+                if (r.trit)
+                {
+                    c = r.bits == 1 ? 50 : r.bits == 2 ? 23 : 11;
+                    if (r.bits == 2)
+                        b = hi * 0x45;
+                    else if (r.bits == 3)
+                        b = hi << 5 | hi;
+                }
+                else
+                {
+                    c = r.bits == 1 ? 28 : 13;
+                    if (r.bits == 2)
+                        b = hi * 0x42;
+                }
+                t = (a & 0x20) | ((value.tq * c + b) ^ a) >> 2;
+            }
+            return int(t > 32 ? t + 1 : t);
+        }
+
+        void bitTransferSigned(int& a, int& b)
+        {
+            b >>= 1;
+            b |= a & 0x80;
+            a >>= 1;
+            a &= 0x3F;
+            if (a & 0x20)
+                a -= 0x40;
+        }
+
+        void blueContract(int (&e)[4])
+        {
+            e[0] = (e[0] + e[2]) >> 1;
+            e[1] = (e[1] + e[2]) >> 1;
+        }
+
+        /// The LDR colour endpoint modes, false for the HDR ones
+        auto decodeEndpoints(uint32 mode, int* v, int (&e0)[4], int (&e1)[4]) -> bool
+        {
+            auto set = [](int (&e)[4], int r, int g, int b, int a)
+            {
+                e[0] = r;
+                e[1] = g;
+                e[2] = b;
+                e[3] = a;
+            };
+            switch (mode)
+            {
+            case 0:
+                set(e0, v[0], v[0], v[0], 255);
+                set(e1, v[1], v[1], v[1], 255);
+                break;
+            case 1:
+            {
+                int l0 = v[0] >> 2 | (v[1] & 0xC0), l1 = std::min(l0 + (v[1] & 0x3F), 255);
+                set(e0, l0, l0, l0, 255);
+                set(e1, l1, l1, l1, 255);
+                break;
+            }
+            case 4:
+                set(e0, v[0], v[0], v[0], v[2]);
+                set(e1, v[1], v[1], v[1], v[3]);
+                break;
+            case 5:
+                bitTransferSigned(v[1], v[0]);
+                bitTransferSigned(v[3], v[2]);
+                set(e0, v[0], v[0], v[0], v[2]);
+                set(e1, v[0] + v[1], v[0] + v[1], v[0] + v[1], v[2] + v[3]);
+                break;
+            case 6:
+                set(e0, v[0] * v[3] >> 8, v[1] * v[3] >> 8, v[2] * v[3] >> 8, 255);
+                set(e1, v[0], v[1], v[2], 255);
+                break;
+            case 8:
+            case 12:
+            {
+                int a0 = mode == 12 ? v[6] : 255, a1 = mode == 12 ? v[7] : 255;
+                if (v[1] + v[3] + v[5] >= v[0] + v[2] + v[4])
+                {
+                    set(e0, v[0], v[2], v[4], a0);
+                    set(e1, v[1], v[3], v[5], a1);
+                }
+                else
+                {
+                    set(e0, v[1], v[3], v[5], a1);
+                    set(e1, v[0], v[2], v[4], a0);
+                    blueContract(e0);
+                    blueContract(e1);
+                }
+                break;
+            }
+            case 9:
+            case 13:
+            {
+                bitTransferSigned(v[1], v[0]);
+                bitTransferSigned(v[3], v[2]);
+                bitTransferSigned(v[5], v[4]);
+                int a0 = 255, a1 = 255;
+                if (mode == 13)
+                {
+                    bitTransferSigned(v[7], v[6]);
+                    a0 = v[6];
+                    a1 = v[6] + v[7];
+                }
+                if (v[1] + v[3] + v[5] >= 0)
+                {
+                    set(e0, v[0], v[2], v[4], a0);
+                    set(e1, v[0] + v[1], v[2] + v[3], v[4] + v[5], a1);
+                }
+                else
+                {
+                    set(e0, v[0] + v[1], v[2] + v[3], v[4] + v[5], a1);
+                    set(e1, v[0], v[2], v[4], a0);
+                    blueContract(e0);
+                    blueContract(e1);
+                }
+                break;
+            }
+            case 10:
+                set(e0, v[0] * v[3] >> 8, v[1] * v[3] >> 8, v[2] * v[3] >> 8, v[4]);
+                set(e1, v[0], v[1], v[2], v[5]);
+                break;
+            default:
+                return false;
+            }
+
+            for (int c = 0; c < 4; ++c)
+            {
+                e0[c] = std::clamp(e0[c], 0, 255);
+                e1[c] = std::clamp(e1[c], 0, 255);
+            }
+            return true;
+        }
+
+        auto hashPartitionSeed(uint32 p) -> uint32
+        {
+            p ^= p >> 15;
+            p -= p << 17;
+            p += p << 7;
+            p += p << 4;
+            p ^= p >> 5;
+            p += p << 16;
+            p ^= p >> 7;
+            p ^= p >> 3;
+            p ^= p << 6;
+            p ^= p >> 17;
+            return p;
+        }
+
+        /// The partition of a texel, as computed by the reference decoder
+        auto selectPartition(uint32 seed, uint32 x, uint32 y, uint32 partitions, bool smallBlock) -> uint32
+        {
+            if (smallBlock)
+            {
+                x <<= 1;
+                y <<= 1;
+            }
+            seed += (partitions - 1) * 1024;
+            uint32 rnum = hashPartitionSeed(seed);
+
+            uint32 seeds[8];
+            for (int i = 0; i < 8; ++i)
+            {
+                seeds[i] = rnum >> (4 * i) & 0xF;
+                seeds[i] *= seeds[i];
+            }
+
+            uint32 sh1, sh2;
+            if (seed & 1)
+            {
+                sh1 = (seed & 2) ? 4 : 5;
+                sh2 = partitions == 3 ? 6 : 5;
+            }
+            else
+            {
+                sh1 = partitions == 3 ? 6 : 5;
+                sh2 = (seed & 2) ? 4 : 5;
+            }
+            for (int i = 0; i < 8; ++i)
+                seeds[i] >>= (i % 2) ? sh2 : sh1;
+
+            // z is always 0 for 2D blocks, so the seeds of the third dimension drop out
+            uint32 a = (seeds[0] * x + seeds[1] * y + (rnum >> 14)) & 0x3F;
+            uint32 b = (seeds[2] * x + seeds[3] * y + (rnum >> 10)) & 0x3F;
+            uint32 c = partitions < 3 ? 0 : (seeds[4] * x + seeds[5] * y + (rnum >> 6)) & 0x3F;
+            uint32 d = partitions < 4 ? 0 : (seeds[6] * x + seeds[7] * y + (rnum >> 2)) & 0x3F;
+
+            if (a >= b && a >= c && a >= d)
+                return 0;
+            if (b >= c && b >= d)
+                return 1;
+            if (c >= d)
+                return 2;
+            return 3;
+        }
+
+        /// Size of the weight grid of a 2D block mode, false for reserved modes
+        auto decodeBlockMode(uint32 mode, uint32& gridWidth, uint32& gridHeight, bool& dualPlane, int& range) -> bool
+        {
+            uint32 r = mode >> 4 & 1, h = mode >> 9 & 1, d = mode >> 10 & 1, a = mode >> 5 & 3;
+            if (mode & 3)
+            {
+                r |= (mode & 3) << 1;
+                uint32 b = mode >> 7 & 3;
+                switch (mode >> 2 & 3)
+                {
+                case 0: gridWidth = b + 4; gridHeight = a + 2; break;
+                case 1: gridWidth = b + 8; gridHeight = a + 2; break;
+                case 2: gridWidth = a + 2; gridHeight = b + 8; break;
+                default:
+                    b &= 1;
+                    if (mode & 0x100)
+                    {
+                        gridWidth = b + 2;
+                        gridHeight = a + 2;
+                    }
+                    else
+                    {
+                        gridWidth = a + 2;
+                        gridHeight = b + 6;
+                    }
+                    break;
+                }
+            }
+            else
+            {
+                r |= (mode >> 2 & 3) << 1;
+                if ((mode >> 2 & 3) == 0)
+                    return false;
+                uint32 b = mode >> 9 & 3;
+                switch (mode >> 7 & 3)
+                {
+                case 0: gridWidth = 12; gridHeight = a + 2; break;
+                case 1: gridWidth = a + 2; gridHeight = 12; break;
+                case 2:
+                    gridWidth = a + 6;
+                    gridHeight = b + 6;
+                    d = h = 0;
+                    break;
+                default:
+                    if (a > 1)
+                        return false;
+                    gridWidth = a ? 10 : 6;
+                    gridHeight = a ? 6 : 10;
+                    break;
+                }
+            }
+            dualPlane = d;
+            range = int(r) - 2 + 6 * int(h);
+            return true;
+        }
+
+        void decodeASTCBlock(const uchar* src, uint32 blockWidth, uint32 blockHeight, BlockTexels& px)
+        {
+            uint32 numTexels = blockWidth * blockHeight;
+            auto fill = [&](uint8 r, uint8 g, uint8 b, uint8 a) { std::fill_n(px.begin(), numTexels, std::array{r, g, b, a}); };
+            // reserved and HDR content decodes to the error colour
+            auto error = [&]() { fill(255, 0, 255, 255); };
+
+            uint32 blockMode = readBits(src, 0, 11);
+            if ((blockMode & 0x1FF) == 0x1FC)
+            {
+                // void extent, a constant colour of 16 bit UNORM values
+                if (blockMode & 0x200)
+                    return error();
+                return fill(src[9], src[11], src[13], src[15]);
+            }
+
+            uint32 gridWidth, gridHeight;
+            bool dualPlane;
+            int weightRange;
+            if (!decodeBlockMode(blockMode, gridWidth, gridHeight, dualPlane, weightRange))
+                return error();
+
+            uint32 partitions = readBits(src, 11, 2) + 1;
+            uint32 numWeights = gridWidth * gridHeight * (dualPlane ? 2 : 1);
+            uint32 weightBits = getISEBitCount(numWeights, weightRange);
+            if (gridWidth > blockWidth || gridHeight > blockHeight || numWeights > 64 || weightBits < 24 ||
+                weightBits > 96 || (dualPlane && partitions == 4))
+                return error();
+
+            uint32 belowWeights = 128 - weightBits;
+            uint32 colourModes[4], colourStart, seed = 0;
+            if (partitions == 1)
+            {
+                colourModes[0] = readBits(src, 13, 4);
+                colourStart = 17;
+            }
+            else
+            {
+                seed = readBits(src, 13, 10);
+                colourStart = 29;
+                uint32 encoded = readBits(src, 23, 6);
+                if ((encoded & 3) == 0)
+                    std::fill_n(colourModes, partitions, encoded >> 2);
+                else
+                {
+                    // the modes of the partitions differ, their remaining bits are below the weights
+                    uint32 extraBits = 3 * partitions - 4;
+                    belowWeights -= extraBits;
+                    encoded |= readBits(src, belowWeights, extraBits) << 6;
+                    uint32 baseClass = (encoded & 3) - 1;
+                    for (uint32 i = 0; i < partitions; ++i)
+                    {
+                        colourModes[i] = ((encoded >> (2 + i) & 1) + baseClass) << 2;
+                        colourModes[i] |= encoded >> (2 + partitions + 2 * i) & 3;
+                    }
+                }
+            }
+
+            uint32 planeChannel = 4;
+            if (dualPlane)
+            {
+                belowWeights -= 2;
+                planeChannel = readBits(src, belowWeights, 2);
+            }
+
+            uint32 numColourValues = 0;
+            for (uint32 i = 0; i < partitions; ++i)
+                numColourValues += ((colourModes[i] >> 2) + 1) * 2;
+            if (numColourValues > 18 || belowWeights <= colourStart)
+                return error();
+
+            // the colour endpoints use the finest range that fits in between
+            int colourRange = 20;
+            while (colourRange >= 0 && getISEBitCount(numColourValues, colourRange) > belowWeights - colourStart)
+                --colourRange;
+            if (colourRange < ASTC_MIN_COLOUR_RANGE)
+                return error();
+
+            ISEValue values[64];
+            decodeISE(src, colourStart, numColourValues, colourRange, values);
+            int colourValues[18];
+            for (uint32 i = 0; i < numColourValues; ++i)
+                colourValues[i] = unquantiseColour(values[i], colourRange);
+
+            int endpoints[4][2][4];
+            for (uint32 i = 0, first = 0; i < partitions; ++i)
+            {
+                if (!decodeEndpoints(colourModes[i], colourValues + first, endpoints[i][0], endpoints[i][1]))
+                    return error();
+                first += ((colourModes[i] >> 2) + 1) * 2;
+            }
+
+            // the weights are stored from the top of the block down, with reversed bits
+            uchar reversed[16];
+            for (int i = 0; i < 16; ++i)
+            {
+                uint8 b = src[15 - i];
+                b = uint8((b & 0xF0) >> 4 | (b & 0x0F) << 4);
+                b = uint8((b & 0xCC) >> 2 | (b & 0x33) << 2);
+                reversed[i] = uint8((b & 0xAA) >> 1 | (b & 0x55) << 1);
+            }
+            decodeISE(reversed, 0, numWeights, weightRange, values);
+            // padded, as infill reads the row after the last one with a factor of 0
+            int weights[2 * (64 + 13)] = {};
+            for (uint32 i = 0; i < numWeights; ++i)
+                weights[i] = unquantiseWeight(values[i], weightRange);
+
+            uint32 numPlanes = dualPlane ? 2 : 1;
+            uint32 ds = (1024 + blockWidth / 2) / (blockWidth - 1), dt = (1024 + blockHeight / 2) / (blockHeight - 1);
+            for (uint32 y = 0; y < blockHeight; ++y)
+            {
+                for (uint32 x = 0; x < blockWidth; ++x)
+                {
+                    // bilinear infill of the weight grid
+                    uint32 gs = (ds * x * (gridWidth - 1) + 32) >> 6, gt = (dt * y * (gridHeight - 1) + 32) >> 6;
+                    uint32 js = gs >> 4, fs = gs & 0xF, jt = gt >> 4, ft = gt & 0xF;
+                    uint32 w11 = (fs * ft + 8) >> 4, w10 = ft - w11, w01 = fs - w11, w00 = 16 - fs - ft + w11;
+                    uint32 v0 = js + jt * gridWidth;
+
+                    int planeWeights[2];
+                    for (uint32 p = 0; p < numPlanes; ++p)
+                    {
+                        auto w = [&](uint32 idx) { return weights[idx * numPlanes + p]; };
+                        planeWeights[p] = int(w(v0) * w00 + w(v0 + 1) * w01 + w(v0 + gridWidth) * w10 +
+                                              w(v0 + gridWidth + 1) * w11 + 8) >> 4;
+                    }
+
+                    uint32 partition = partitions > 1 ? selectPartition(seed, x, y, partitions, numTexels < 31) : 0;
+                    const auto& e = endpoints[partition];
+                    auto& texel = px[y * blockWidth + x];
+                    for (uint32 c = 0; c < 4; ++c)
+                    {
+                        int w = planeWeights[c == planeChannel ? 1 : 0];
+                        int c0 = e[0][c] << 8 | e[0][c], c1 = e[1][c] << 8 | e[1][c];
+                        texel[c] = uint8(((c0 * (64 - w) + c1 * w + 32) >> 6) >> 8);
+                    }
+                }
+            }
+        }
+
+        void getBlockSize(PixelFormat format, uint32& width, uint32& height)
+        {
+            using enum PixelFormat;
+            static constexpr uint8 ASTC_SIZES[][2] = {{4, 4},  {5, 4},  {5, 5},  {6, 5},   {6, 6},   {8, 5},  {8, 6},
+                                                       {8, 8},  {10, 5}, {10, 6}, {10, 8}, {10, 10}, {12, 10}, {12, 12}};
+            width = height = 4;
+            if (format >= ASTC_RGBA_4X4_LDR && format <= ASTC_RGBA_12X12_LDR)
+            {
+                const auto& size = ASTC_SIZES[std::to_underlying(format) - std::to_underlying(ASTC_RGBA_4X4_LDR)];
+                width = size[0];
+                height = size[1];
+            }
+        }
+    }
+    //-----------------------------------------------------------------------
+    auto BlockDecoder::isSupported(PixelFormat format) -> bool
+    {
+        using enum PixelFormat;
+        switch (format)
+        {
+        case DXT1:
+        case DXT2:
+        case DXT3:
+        case DXT4:
+        case DXT5:
+        case BC4_UNORM:
+        case BC5_UNORM:
+        case BC7_UNORM:
+        case ETC1_RGB8:
+        case ETC2_RGB8:
+        case ETC2_RGBA8:
+        case ETC2_RGB8A1:
+            return true;
+        default:
+            return format >= ASTC_RGBA_4X4_LDR && format <= ASTC_RGBA_12X12_LDR;
+        }
+    }
+    //-----------------------------------------------------------------------
+    void BlockDecoder::decode(const PixelBox& src, uchar* dst)
+    {
+        PixelFormat format = src.format;
+        OgreAssert(isSupported(format), "format not supported by the block decoder");
+
+        uint32 blockWidth, blockHeight;
+        getBlockSize(format, blockWidth, blockHeight);
+        uint32 width = src.getWidth(), height = src.getHeight();
+        uint32 blocksX = (width + blockWidth - 1) / blockWidth, blocksY = (height + blockHeight - 1) / blockHeight;
+        size_t blockSize = PixelUtil::getMemorySize(blockWidth, blockHeight, 1, format);
+
+        auto decodeBlockRow = [&](size_t row)
+        {
+            auto z = uint32(row / blocksY), top = uint32(row % blocksY) * blockHeight;
+            uint32 numRows = std::min(height - top, blockHeight);
+
+            const uchar* in = static_cast<const uchar*>(src.data) + row * blocksX * blockSize;
+            for (uint32 bx = 0; bx < blocksX; ++bx, in += blockSize)
+            {
+                BlockTexels px;
+                using enum PixelFormat;
+                switch (format)
+                {
+                case DXT1:
+                    decodeColourBlock(in, true, px);
+                    break;
+                case DXT2:
+                case DXT3:
+                    decodeColourBlock(in + 8, false, px);
+                    decodeExplicitAlphaBlock(in, px);
+                    break;
+                case DXT4:
+                case DXT5:
+                    decodeColourBlock(in + 8, false, px);
+                    decodeChannelBlock(in, 3, px);
+                    break;
+                case BC4_UNORM:
+                case BC5_UNORM:
+                    std::fill_n(px.begin(), 16, std::array<uint8, 4>{0, 0, 0, 255});
+                    decodeChannelBlock(in, 0, px);
+                    if (format == BC5_UNORM)
+                        decodeChannelBlock(in + 8, 1, px);
+                    break;
+                case BC7_UNORM:
+                    decodeBC7Block(in, px);
+                    break;
+                case ETC1_RGB8:
+                    decodeETCBlock(in, false, false, px);
+                    break;
+                case ETC2_RGB8:
+                case ETC2_RGB8A1:
+                    decodeETCBlock(in, true, format == ETC2_RGB8A1, px);
+                    break;
+                case ETC2_RGBA8:
+                    decodeETCBlock(in + 8, true, false, px);
+                    decodeEACBlock(in, px);
+                    break;
+                default:
+                    decodeASTCBlock(in, blockWidth, blockHeight, px);
+                    break;
+                }
+
+                // copy the part within the image
+                uint32 left = bx * blockWidth, numColumns = std::min(width - left, blockWidth);
+                for (uint32 y = 0; y < numRows; ++y)
+                {
+                    uchar* out = dst + ((size_t(z) * height + top + y) * width + left) * 4;
+                    for (uint32 x = 0; x < numColumns; ++x)
+                        std::copy_n(px[y * blockWidth + x].begin(), 4, out + x * 4);
+                }
+            }
+        };
+
+        size_t numBlockRows = size_t(blocksY) * src.getDepth();
+        Root* root = Root::getSingletonPtr();
+        if (root && root->getWorkQueue())
+        {
+            root->getWorkQueue()->parallelFor(numBlockRows, decodeBlockRow);
+            return;
+        }
+        for (size_t row = 0; row < numBlockRows; ++row)
+            decodeBlockRow(row);
+    }
+}
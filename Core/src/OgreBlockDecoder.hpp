@@ -0,0 +1,72 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+module;
+
+#include <cstddef>
+
+module Ogre.Core:BlockDecoder;
+
+import :PixelFormat;
+import :Platform;
+import :Prerequisites;
+
+namespace Ogre {
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Image
+    *  @{
+    */
+
+    /** CPU decoder for block compressed formats, the counterpart of BlockEncoder.
+    @remarks
+        Used when the RenderSystem can not sample a format the assets are shipped in.
+        Supported are
+        - DXT1 - DXT5, BC4_UNORM and BC5_UNORM, the latter two as red and red-green
+        - BC7_UNORM, all modes
+        - ETC1_RGB8, ETC2_RGB8, ETC2_RGBA8 and ETC2_RGB8A1, including the T, H and planar modes
+        - the ASTC LDR formats. HDR blocks decode to magenta, like invalid ones.
+    */
+    class BlockDecoder
+    {
+    public:
+        /// Whether format can be decoded
+        static auto isSupported(PixelFormat format) -> bool;
+
+        /** Decodes a 1D, 2D or 3D image volume to BYTE_RGBA.
+        @remarks
+            The block rows are decoded in parallel on the WorkQueue of Root, if there is one.
+        @param src The compressed data, the whole volume of the PixelBox
+        @param dst Buffer of src.getWidth() * src.getHeight() * src.getDepth() * 4 bytes
+        */
+        static void decode(const PixelBox& src, uchar* dst);
+    };
+    /** @} */
+    /** @} */
+
+} // namespace Ogre
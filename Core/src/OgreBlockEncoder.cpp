@@ -0,0 +1,708 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+module Ogre.Core;
+
+import :BlockEncoder;
+import :Exception;
+import :PixelFormat;
+import :Platform;
+import :Root;
+import :WorkQueue;
+
+import <algorithm>;
+import <array>;
+import <cmath>;
+import <limits>;
+import <vector>;
+
+namespace Ogre {
+    namespace
+    {
+        /// 16 pixels of a block, RGBA, row by row
+        using BlockPixels = std::array<std::array<uint8, 4>, 16>;
+
+        auto clampByte(int v) -> uint8 { return static_cast<uint8>(std::clamp(v, 0, 255)); }
+
+        /// Principal axis of the rgb (or rgba) values of the given pixels, power iteration on the covariance
+        template<int N>
+        void principalAxis(const BlockPixels& px, const bool* used, float (&mean)[N], float (&axis)[N])
+        {
+            float count = 0;
+            std::fill_n(mean, N, 0.0f);
+            for (int i = 0; i < 16; ++i)
+            {
+                if (!used[i])
+                    continue;
+                for (int c = 0; c < N; ++c)
+                    mean[c] += px[i][c];
+                count += 1;
+            }
+            for (int c = 0; c < N; ++c)
+                mean[c] /= std::max(count, 1.0f);
+
+            float cov[N][N] = {};
+            for (int i = 0; i < 16; ++i)
+            {
+                if (!used[i])
+                    continue;
+                for (int r = 0; r < N; ++r)
+                    for (int c = 0; c < N; ++c)
+                        cov[r][c] += (px[i][r] - mean[r]) * (px[i][c] - mean[c]);
+            }
+
+            // start from the covariance of the channel varying most, never orthogonal to the principal axis
+            int widest = 0;
+            for (int c = 1; c < N; ++c)
+                if (cov[c][c] > cov[widest][widest])
+                    widest = c;
+            std::copy_n(cov[widest], N, axis);
+            for (int iter = 0; iter < 8; ++iter)
+            {
+                float next[N] = {};
+                for (int r = 0; r < N; ++r)
+                    for (int c = 0; c < N; ++c)
+                        next[r] += cov[r][c] * axis[c];
+                float len = 0;
+                for (int c = 0; c < N; ++c)
+                    len = std::max(len, std::abs(next[c]));
+                // flat block, any axis will do
+                if (len < 1e-6f)
+                    return;
+                for (int c = 0; c < N; ++c)
+                    axis[c] = next[c] / len;
+            }
+        }
+
+        /// Endpoints spanning the projection of the pixels on the principal axis
+        template<int N>
+        void fitEndpoints(const BlockPixels& px, const bool* used, float (&e0)[N], float (&e1)[N])
+        {
+            float mean[N], axis[N];
+            principalAxis<N>(px, used, mean, axis);
+
+            float lenSq = 0;
+            for (int c = 0; c < N; ++c)
+                lenSq += axis[c] * axis[c];
+            if (lenSq < 1e-6f)
+            {
+                std::copy_n(mean, N, e0);
+                std::copy_n(mean, N, e1);
+                return;
+            }
+
+            float tMin = 0, tMax = 0;
+            for (int i = 0; i < 16; ++i)
+            {
+                if (!used[i])
+                    continue;
+                float t = 0;
+                for (int c = 0; c < N; ++c)
+                    t += (px[i][c] - mean[c]) * axis[c];
+                t /= lenSq;
+                tMin = std::min(tMin, t);
+                tMax = std::max(tMax, t);
+            }
+            for (int c = 0; c < N; ++c)
+            {
+                e0[c] = std::clamp(mean[c] + axis[c] * tMax, 0.0f, 255.0f);
+                e1[c] = std::clamp(mean[c] + axis[c] * tMin, 0.0f, 255.0f);
+            }
+        }
+
+        //---------------------------------------------------------------------
+        // BC1 - BC3 colour
+        //---------------------------------------------------------------------
+        auto packRGB565(const float (&c)[3]) -> uint16
+        {
+            auto r = static_cast<uint16>(std::lround(c[0] * 31 / 255));
+            auto g = static_cast<uint16>(std::lround(c[1] * 63 / 255));
+            auto b = static_cast<uint16>(std::lround(c[2] * 31 / 255));
+            return static_cast<uint16>(r << 11 | g << 5 | b);
+        }
+
+        void unpackRGB565(uint16 v, int (&c)[3])
+        {
+            int r = v >> 11, g = (v >> 5) & 63, b = v & 31;
+            c[0] = r << 3 | r >> 2;
+            c[1] = g << 2 | g >> 4;
+            c[2] = b << 3 | b >> 2;
+        }
+
+        /// Picks the palette entries for the endpoints, returns the squared error
+        auto selectColourIndices(const BlockPixels& px, const bool* transparent, uint16 c0, uint16 c1,
+                                 uint32& indices) -> int
+        {
+            int palette[4][3];
+            unpackRGB565(c0, palette[0]);
+            unpackRGB565(c1, palette[1]);
+            bool fourColours = c0 > c1;
+            for (int c = 0; c < 3; ++c)
+            {
+                if (fourColours)
+                {
+                    palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+                    palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+                }
+                else
+                {
+                    palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+                    palette[3][c] = 0;
+                }
+            }
+
+            int error = 0;
+            indices = 0;
+            for (int i = 0; i < 16; ++i)
+            {
+                if (transparent[i])
+                {
+                    indices |= 3u << (2 * i);
+                    continue;
+                }
+                int best = 0, bestError = std::numeric_limits<int>::max();
+                for (int p = 0; p < (fourColours ? 4 : 3); ++p)
+                {
+                    int e = 0;
+                    for (int c = 0; c < 3; ++c)
+                        e += (px[i][c] - palette[p][c]) * (px[i][c] - palette[p][c]);
+                    if (e < bestError)
+                    {
+                        best = p;
+                        bestError = e;
+                    }
+                }
+                indices |= uint32(best) << (2 * i);
+                error += bestError;
+            }
+            return error;
+        }
+
+        /// Least squares endpoints for the given 4 colour indices
+        auto refineColourEndpoints(const BlockPixels& px, uint32 indices, float (&e0)[3], float (&e1)[3]) -> bool
+        {
+            static constexpr float weights[4] = {1, 0, 2.0f / 3, 1.0f / 3};
+            float aa = 0, bb = 0, ab = 0, ap[3] = {}, bp[3] = {};
+            for (int i = 0; i < 16; ++i)
+            {
+                float a = weights[(indices >> (2 * i)) & 3], b = 1 - a;
+                aa += a * a;
+                bb += b * b;
+                ab += a * b;
+                for (int c = 0; c < 3; ++c)
+                {
+                    ap[c] += a * px[i][c];
+                    bp[c] += b * px[i][c];
+                }
+            }
+            float det = aa * bb - ab * ab;
+            if (std::abs(det) < 1e-6f)
+                return false;
+            for (int c = 0; c < 3; ++c)
+            {
+                e0[c] = std::clamp((bb * ap[c] - ab * bp[c]) / det, 0.0f, 255.0f);
+                e1[c] = std::clamp((aa * bp[c] - ab * ap[c]) / det, 0.0f, 255.0f);
+            }
+            return true;
+        }
+
+        /** Encodes the colour part of a BC1 - BC3 block.
+        @param allowTransparent Whether pixels with alpha below 128 are encoded as
+            transparent using the 3 colour mode of BC1
+        */
+        void encodeColourBlock(const BlockPixels& px, bool allowTransparent, uint8* dst)
+        {
+            bool transparent[16], opaque[16];
+            bool anyTransparent = false, anyOpaque = false;
+            for (int i = 0; i < 16; ++i)
+            {
+                transparent[i] = allowTransparent && px[i][3] < 128;
+                opaque[i] = !transparent[i];
+                anyTransparent |= transparent[i];
+                anyOpaque |= opaque[i];
+            }
+
+            uint16 c0 = 0, c1 = 0;
+            uint32 indices = 0xFFFFFFFF;
+            if (anyOpaque)
+            {
+                float e0[3], e1[3];
+                fitEndpoints<3>(px, opaque, e0, e1);
+                c0 = packRGB565(e0);
+                c1 = packRGB565(e1);
+
+                if (anyTransparent)
+                {
+                    // the 3 colour mode is selected by c0 <= c1
+                    if (c0 > c1)
+                        std::swap(c0, c1);
+                    selectColourIndices(px, transparent, c0, c1, indices);
+                }
+                else
+                {
+                    if (c0 < c1)
+                        std::swap(c0, c1);
+                    int error = selectColourIndices(px, transparent, c0, c1, indices);
+                    // a single colour, index 0 is right in both modes
+                    if (c0 == c1)
+                        indices = 0;
+                    else if (refineColourEndpoints(px, indices, e0, e1))
+                    {
+                        uint16 r0 = packRGB565(e0), r1 = packRGB565(e1);
+                        if (r0 < r1)
+                            std::swap(r0, r1);
+                        uint32 refined;
+                        if (r0 != r1 && selectColourIndices(px, transparent, r0, r1, refined) < error)
+                        {
+                            c0 = r0;
+                            c1 = r1;
+                            indices = refined;
+                        }
+                    }
+                }
+            }
+
+            dst[0] = uint8(c0);
+            dst[1] = uint8(c0 >> 8);
+            dst[2] = uint8(c1);
+            dst[3] = uint8(c1 >> 8);
+            for (int i = 0; i < 4; ++i)
+                dst[4 + i] = uint8(indices >> (8 * i));
+        }
+
+        //---------------------------------------------------------------------
+        // BC3 - BC5 channel
+        //---------------------------------------------------------------------
+        /// Encodes one channel like the alpha of BC3, using the 8 value mode
+        void encodeChannelBlock(const BlockPixels& px, int channel, uint8* dst)
+        {
+            int lo = 255, hi = 0;
+            for (const auto& p : px)
+            {
+                lo = std::min<int>(lo, p[channel]);
+                hi = std::max<int>(hi, p[channel]);
+            }
+
+            uint64 bits = 0;
+            if (hi > lo)
+            {
+                // palette entry i sits at (i - 1) / 7 between hi and lo, 0 and 1 are the endpoints
+                static constexpr int order[8] = {1, 7, 6, 5, 4, 3, 2, 0};
+                for (int i = 0; i < 16; ++i)
+                {
+                    int step = int(std::lround(float(px[i][channel] - lo) * 7 / float(hi - lo)));
+                    bits |= uint64(order[step]) << (3 * i);
+                }
+            }
+
+            dst[0] = uint8(hi);
+            dst[1] = uint8(lo);
+            for (int i = 0; i < 6; ++i)
+                dst[2 + i] = uint8(bits >> (8 * i));
+        }
+
+        /// Encodes the alpha of BC2, 4 bit per pixel
+        void encodeExplicitAlphaBlock(const BlockPixels& px, uint8* dst)
+        {
+            for (int i = 0; i < 8; ++i)
+            {
+                int a0 = (px[2 * i][3] * 15 + 127) / 255, a1 = (px[2 * i + 1][3] * 15 + 127) / 255;
+                dst[i] = uint8(a0 | a1 << 4);
+            }
+        }
+
+        //---------------------------------------------------------------------
+        // BC7
+        //---------------------------------------------------------------------
+        /// Writes the bits of a BC7 block from the least significant one on
+        class BitWriter
+        {
+        public:
+            explicit BitWriter(uint8* dst) : mDst(dst) { std::fill_n(dst, 16, uint8(0)); }
+            void write(uint32 value, int count)
+            {
+                for (int i = 0; i < count; ++i, ++mPos)
+                    mDst[mPos / 8] |= uint8(((value >> i) & 1) << (mPos % 8));
+            }
+        private:
+            uint8* mDst;
+            int mPos{0};
+        };
+
+        /// Quantises an rgba endpoint to 7 bits per channel plus a shared p-bit
+        void quantiseBC7Endpoint(const float (&e)[4], int (&q)[4], int& pbit)
+        {
+            int bestError = std::numeric_limits<int>::max();
+            for (int p = 0; p < 2; ++p)
+            {
+                int candidate[4], error = 0;
+                for (int c = 0; c < 4; ++c)
+                {
+                    candidate[c] = std::clamp(int(std::lround((e[c] - p) / 2)), 0, 127);
+                    int v = candidate[c] << 1 | p;
+                    error += int((v - e[c]) * (v - e[c]));
+                }
+                if (error < bestError)
+                {
+                    bestError = error;
+                    pbit = p;
+                    std::copy_n(candidate, 4, q);
+                }
+            }
+        }
+
+        /// Encodes a BC7 block in mode 6, one subset with 7.7.7.7 endpoints and 4 bit indices
+        void encodeBC7Block(const BlockPixels& px, uint8* dst)
+        {
+            static constexpr int weights[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+            static constexpr bool all[16] = {true, true, true, true, true, true, true, true,
+                                             true, true, true, true, true, true, true, true};
+
+            float e0[4], e1[4];
+            fitEndpoints<4>(px, all, e0, e1);
+
+            int q[2][4], pbit[2];
+            quantiseBC7Endpoint(e0, q[0], pbit[0]);
+            quantiseBC7Endpoint(e1, q[1], pbit[1]);
+
+            int palette[16][4];
+            for (int c = 0; c < 4; ++c)
+            {
+                int lo = q[0][c] << 1 | pbit[0], hi = q[1][c] << 1 | pbit[1];
+                for (int w = 0; w < 16; ++w)
+                    palette[w][c] = ((64 - weights[w]) * lo + weights[w] * hi + 32) >> 6;
+            }
+
+            int indices[16];
+            for (int i = 0; i < 16; ++i)
+            {
+                int bestError = std::numeric_limits<int>::max();
+                for (int w = 0; w < 16; ++w)
+                {
+                    int e = 0;
+                    for (int c = 0; c < 4; ++c)
+                        e += (px[i][c] - palette[w][c]) * (px[i][c] - palette[w][c]);
+                    if (e < bestError)
+                    {
+                        bestError = e;
+                        indices[i] = w;
+                    }
+                }
+            }
+
+            // the most significant bit of the first index is implied to be 0
+            if (indices[0] & 8)
+            {
+                std::swap(q[0], q[1]);
+                std::swap(pbit[0], pbit[1]);
+                for (int& i : indices)
+                    i = 15 - i;
+            }
+
+            BitWriter bits(dst);
+            bits.write(1 << 6, 7);
+            for (int c = 0; c < 4; ++c)
+            {
+                bits.write(q[0][c], 7);
+                bits.write(q[1][c], 7);
+            }
+            bits.write(pbit[0], 1);
+            bits.write(pbit[1], 1);
+            bits.write(indices[0], 3);
+            for (int i = 1; i < 16; ++i)
+                bits.write(indices[i], 4);
+        }
+
+        //---------------------------------------------------------------------
+        // ETC1 / ETC2
+        //---------------------------------------------------------------------
+        constexpr int ETC_MODIFIERS[8][2] = {{2, 8}, {5, 17}, {9, 29}, {13, 42},
+                                             {18, 60}, {24, 80}, {33, 106}, {47, 183}};
+
+        /// Finds the best modifier table for a half block, returns the squared error
+        auto fitETCSubBlock(const BlockPixels& px, const int (&pixels)[8], const int (&base)[3],
+                            int& table, uint32& indices) -> int
+        {
+            int bestError = std::numeric_limits<int>::max();
+            for (int t = 0; t < 8; ++t)
+            {
+                const int modifiers[4] = {ETC_MODIFIERS[t][0], ETC_MODIFIERS[t][1], -ETC_MODIFIERS[t][0],
+                                          -ETC_MODIFIERS[t][1]};
+                int error = 0;
+                uint32 tableIndices = 0;
+                for (int i : pixels)
+                {
+                    int best = 0, bestPixel = std::numeric_limits<int>::max();
+                    for (int m = 0; m < 4; ++m)
+                    {
+                        int e = 0;
+                        for (int c = 0; c < 3; ++c)
+                        {
+                            int d = px[i][c] - clampByte(base[c] + modifiers[m]);
+                            e += d * d;
+                        }
+                        if (e < bestPixel)
+                        {
+                            best = m;
+                            bestPixel = e;
+                        }
+                    }
+                    error += bestPixel;
+                    // pixels are numbered by column, the lsb and msb planes are 16 bits apart
+                    int j = (i % 4) * 4 + i / 4;
+                    tableIndices |= uint32(best & 1) << j | uint32(best >> 1) << (16 + j);
+                }
+                if (error < bestError)
+                {
+                    bestError = error;
+                    table = t;
+                    indices = tableIndices;
+                }
+            }
+            return bestError;
+        }
+
+        /// Encodes an ETC1 block with individual or differential colours, which is valid ETC2 as well
+        void encodeETCBlock(const BlockPixels& px, uint8* dst)
+        {
+            uint64 bestBlock = 0;
+            int bestError = std::numeric_limits<int>::max();
+            for (int flip = 0; flip < 2; ++flip)
+            {
+                // flipped blocks are split into top and bottom half, else into left and right
+                int pixels[2][8], count[2] = {};
+                float average[2][3] = {};
+                for (int i = 0; i < 16; ++i)
+                {
+                    int half = flip ? i / 8 : (i % 4) / 2;
+                    pixels[half][count[half]++] = i;
+                    for (int c = 0; c < 3; ++c)
+                        average[half][c] += px[i][c] / 8.0f;
+                }
+
+                for (int differential = 0; differential < 2; ++differential)
+                {
+                    int bits = differential ? 5 : 4, maxValue = (1 << bits) - 1;
+                    int q[2][3], base[2][3];
+                    bool valid = true;
+                    for (int h = 0; h < 2; ++h)
+                    {
+                        for (int c = 0; c < 3; ++c)
+                        {
+                            q[h][c] = int(std::lround(average[h][c] * maxValue / 255));
+                            base[h][c] = differential ? q[h][c] << 3 | q[h][c] >> 2 : q[h][c] << 4 | q[h][c];
+                            if (differential)
+                                valid &= q[1][c] - q[0][c] >= -4 && q[1][c] - q[0][c] <= 3;
+                        }
+                    }
+                    // in ETC2 an out of range difference selects another mode
+                    if (!valid)
+                        continue;
+
+                    int table[2];
+                    uint32 indices[2];
+                    int error = fitETCSubBlock(px, pixels[0], base[0], table[0], indices[0]) +
+                                fitETCSubBlock(px, pixels[1], base[1], table[1], indices[1]);
+                    if (error >= bestError)
+                        continue;
+
+                    uint64 block = 0;
+                    for (int c = 0; c < 3; ++c)
+                    {
+                        int shift = 59 - 8 * c;
+                        if (differential)
+                            block |= uint64(q[0][c]) << shift | uint64((q[1][c] - q[0][c]) & 7) << (shift - 3);
+                        else
+                            block |= uint64(q[0][c]) << (shift + 1) | uint64(q[1][c]) << (shift - 3);
+                    }
+                    block |= uint64(table[0]) << 37 | uint64(table[1]) << 34 | uint64(differential) << 33 |
+                             uint64(flip) << 32 | (indices[0] | indices[1]);
+                    bestBlock = block;
+                    bestError = error;
+                }
+            }
+
+            for (int i = 0; i < 8; ++i)
+                dst[i] = uint8(bestBlock >> (56 - 8 * i));
+        }
+
+        constexpr int EAC_MODIFIERS[16][8] = {
+            {-3, -6, -9, -15, 2, 5, 8, 14}, {-3, -7, -10, -13, 2, 6, 9, 12}, {-2, -5, -8, -13, 1, 4, 7, 12},
+            {-2, -4, -6, -13, 1, 3, 5, 12}, {-3, -6, -8, -12, 2, 5, 7, 11}, {-3, -7, -9, -11, 2, 6, 8, 10},
+            {-4, -7, -8, -11, 3, 6, 7, 10}, {-3, -5, -8, -11, 2, 4, 7, 10}, {-2, -6, -8, -10, 1, 5, 7, 9},
+            {-2, -5, -8, -10, 1, 4, 7, 9},  {-2, -4, -8, -10, 1, 3, 7, 9},  {-2, -5, -7, -10, 1, 4, 6, 9},
+            {-3, -4, -7, -10, 2, 3, 6, 9},  {-1, -2, -3, -10, 0, 1, 2, 9},  {-4, -6, -8, -9, 3, 5, 7, 8},
+            {-3, -5, -7, -9, 2, 4, 6, 8}};
+
+        /// Encodes the alpha of an ETC2 RGBA8 block
+        void encodeEACBlock(const BlockPixels& px, uint8* dst)
+        {
+            int lo = 255, hi = 0;
+            for (const auto& p : px)
+            {
+                lo = std::min<int>(lo, p[3]);
+                hi = std::max<int>(hi, p[3]);
+            }
+
+            uint64 bestBlock = 0;
+            int bestError = std::numeric_limits<int>::max();
+            for (int t = 0; t < 16 && bestError > 0; ++t)
+            {
+                const int* modifiers = EAC_MODIFIERS[t];
+                int span = modifiers[7] - modifiers[3];
+                int mult = std::clamp(int(std::lround(float(hi - lo) / span)), 1, 15);
+                for (int m = std::max(mult - 1, 1); m <= std::min(mult + 1, 15); ++m)
+                {
+                    int base = clampByte(int(std::lround((hi + lo) / 2.0f - (modifiers[7] + modifiers[3]) * m / 2.0f)));
+                    int error = 0;
+                    uint64 indices = 0;
+                    for (int i = 0; i < 16; ++i)
+                    {
+                        int best = 0, bestPixel = std::numeric_limits<int>::max();
+                        for (int k = 0; k < 8; ++k)
+                        {
+                            int d = px[i][3] - clampByte(base + modifiers[k] * m);
+                            if (d * d < bestPixel)
+                            {
+                                best = k;
+                                bestPixel = d * d;
+                            }
+                        }
+                        error += bestPixel;
+                        int j = (i % 4) * 4 + i / 4;
+                        indices |= uint64(best) << (45 - 3 * j);
+                    }
+                    if (error < bestError)
+                    {
+                        bestError = error;
+                        bestBlock = uint64(base) << 56 | uint64(m) << 52 | uint64(t) << 48 | indices;
+                    }
+                }
+            }
+
+            for (int i = 0; i < 8; ++i)
+                dst[i] = uint8(bestBlock >> (56 - 8 * i));
+        }
+    }
+    //-----------------------------------------------------------------------
+    auto BlockEncoder::isSupported(PixelFormat format) -> bool
+    {
+        using enum PixelFormat;
+        switch (format)
+        {
+        case DXT1:
+        case DXT3:
+        case DXT5:
+        case BC4_UNORM:
+        case BC5_UNORM:
+        case BC7_UNORM:
+        case ETC1_RGB8:
+        case ETC2_RGB8:
+        case ETC2_RGBA8:
+            return true;
+        default:
+            return false;
+        }
+    }
+    //-----------------------------------------------------------------------
+    void BlockEncoder::encode(const PixelBox& src, PixelFormat format, uchar* dst)
+    {
+        OgreAssert(isSupported(format), "format not supported by the block encoder");
+
+        uint32 width = src.getWidth(), height = src.getHeight();
+        uint32 blocksX = (width + 3) / 4, blocksY = (height + 3) / 4;
+        size_t blockSize = PixelUtil::getMemorySize(4, 4, 1, format);
+
+        auto encodeBlockRow = [&](size_t row)
+        {
+            auto z = uint32(row / blocksY), top = uint32(row % blocksY) * 4;
+            uint32 numRows = std::min(height - top, 4u);
+
+            // the pixels of the block row as rgba bytes
+            std::vector<uint8> rgba(size_t(width) * numRows * 4);
+            PixelBox rows(width, numRows, 1, PixelFormat::BYTE_RGBA, rgba.data());
+            PixelUtil::bulkPixelConversion(
+                src.getSubVolume(Box{src.left, src.top + top, src.right, src.top + top + numRows,
+                                     src.front + z, src.front + z + 1}),
+                rows);
+
+            uchar* out = dst + row * blocksX * blockSize;
+            for (uint32 bx = 0; bx < blocksX; ++bx, out += blockSize)
+            {
+                BlockPixels px;
+                for (uint32 i = 0; i < 16; ++i)
+                {
+                    uint32 x = std::min(bx * 4 + i % 4, width - 1), y = std::min(i / 4, numRows - 1);
+                    std::copy_n(&rgba[(size_t(y) * width + x) * 4], 4, px[i].begin());
+                }
+
+                using enum PixelFormat;
+                switch (format)
+                {
+                case DXT1:
+                    encodeColourBlock(px, true, out);
+                    break;
+                case DXT3:
+                    encodeExplicitAlphaBlock(px, out);
+                    encodeColourBlock(px, false, out + 8);
+                    break;
+                case DXT5:
+                    encodeChannelBlock(px, 3, out);
+                    encodeColourBlock(px, false, out + 8);
+                    break;
+                case BC4_UNORM:
+                    encodeChannelBlock(px, 0, out);
+                    break;
+                case BC5_UNORM:
+                    encodeChannelBlock(px, 0, out);
+                    encodeChannelBlock(px, 1, out + 8);
+                    break;
+                case BC7_UNORM:
+                    encodeBC7Block(px, out);
+                    break;
+                case ETC2_RGBA8:
+                    encodeEACBlock(px, out);
+                    encodeETCBlock(px, out + 8);
+                    break;
+                default:
+                    encodeETCBlock(px, out);
+                    break;
+                }
+            }
+        };
+
+        size_t numBlockRows = size_t(blocksY) * src.getDepth();
+        Root* root = Root::getSingletonPtr();
+        if (root && root->getWorkQueue())
+        {
+            root->getWorkQueue()->parallelFor(numBlockRows, encodeBlockRow);
+            return;
+        }
+        for (size_t row = 0; row < numBlockRows; ++row)
+            encodeBlockRow(row);
+    }
+}
@@ -0,0 +1,78 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+module;
+
+#include <cstddef>
+
+module Ogre.Core:BlockEncoder;
+
+import :PixelFormat;
+import :Platform;
+import :Prerequisites;
+
+namespace Ogre {
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Image
+    *  @{
+    */
+
+    /** CPU encoder for the 4x4 block compressed formats.
+    @remarks
+        The encoder aims at speed rather than the best possible quality: the endpoints of
+        a block are fitted along the principal axis of its colours, with one least squares
+        refinement for BC1 - BC3. BC7 blocks are always written in mode 6, ETC2 blocks in
+        the ETC1 compatible individual and differential modes. Supported are
+        - DXT1, the 3 colour mode is used for blocks with pixels of alpha below 0.5
+        - DXT3 and DXT5
+        - BC4_UNORM and BC5_UNORM, the red and the red and green channel
+        - BC7_UNORM
+        - ETC1_RGB8, ETC2_RGB8 and ETC2_RGBA8
+    */
+    class BlockEncoder
+    {
+    public:
+        /// Whether format can be encoded
+        static auto isSupported(PixelFormat format) -> bool;
+
+        /** Encodes a 1D, 2D or 3D image volume.
+        @remarks
+            Blocks extending past the volume repeat its edge pixels. The block rows are
+            encoded in parallel on the WorkQueue of Root, if there is one.
+        @param src The pixels to encode, in any format PixelUtil::bulkPixelConversion can read
+        @param format The block compressed format to write
+        @param dst Buffer of PixelUtil::getMemorySize(src.getWidth(), src.getHeight(),
+            src.getDepth(), format) bytes
+        */
+        static void encode(const PixelBox& src, PixelFormat format, uchar* dst);
+    };
+    /** @} */
+    /** @} */
+
+} // namespace Ogre
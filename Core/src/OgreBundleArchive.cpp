@@ -0,0 +1,568 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+module;
+
+#include <cstddef>
+#include <cstring>
+// NOLINTBEGIN
+#define MINIZ_HEADER_FILE_ONLY
+#include <miniz.h>
+
+module Ogre.Core;
+
+import :Archive;
+import :BundleArchive;
+import :Common;
+import :DataStream;
+import :Exception;
+import :FileSystem;
+import :Platform;
+import :Prerequisites;
+import :SharedPtr;
+import :String;
+import :StringVector;
+
+import <algorithm>;
+import <bit>;
+import <filesystem>;
+import <format>;
+import <fstream>;
+import <ios>;
+import <memory>;
+import <string>;
+import <utility>;
+import <vector>;
+
+// NOLINTEND
+namespace Ogre {
+namespace {
+    /* A bundle holds, in host byte order: the BundleHeader, the entries sorted by
+       name, the hash table of entry indices, the declarations and the string table.
+       The payloads follow, each starting at a multiple of the alignment. */
+    constexpr uint32 BUNDLE_MAGIC = 0x444E424F; // "OBND"
+    constexpr uint32 BUNDLE_VERSION = 1;
+    constexpr uint32 EMPTY_BUCKET = ~uint32(0);
+
+    constexpr uint16 METHOD_STORED = 0;
+    constexpr uint16 METHOD_DEFLATED = MZ_DEFLATED;
+    constexpr uint16 FLAG_DIRECTORY = 1;
+
+    struct BundleHeader
+    {
+        uint32 magic;
+        uint32 version;
+        uint32 numEntries;
+        /// Size of the hash table, a power of two larger than numEntries
+        uint32 numBuckets;
+        uint32 numDeclarations;
+        uint32 alignment;
+        uint64 entriesOffset;
+        uint64 bucketsOffset;
+        uint64 declarationsOffset;
+        uint64 stringsOffset;
+        uint64 stringsSize;
+    };
+
+    struct BundleEntry
+    {
+        uint64 offset;
+        uint64 size;
+        uint64 compressedSize;
+        uint32 nameOffset;
+        uint32 nameLength;
+        uint32 hash;
+        uint16 method;
+        uint16 flags;
+    };
+
+    struct BundleDeclaration
+    {
+        uint32 nameOffset;
+        uint32 nameLength;
+        uint32 typeOffset;
+        uint32 typeLength;
+    };
+
+    auto hashName(std::string_view name) -> uint32
+    {
+        return FastHash(name.data(), name.size());
+    }
+
+    auto alignOffset(uint64 offset, uint64 alignment) -> uint64
+    {
+        return (offset + alignment - 1) & ~(alignment - 1);
+    }
+
+    /// Read-only view of an entry stored uncompressed, keeping the bundle data alive
+    class BundleEntryView : public MemoryDataStream
+    {
+        MemoryDataStreamPtr mBundleData;
+    public:
+        BundleEntryView(std::string_view name, MemoryDataStreamPtr bundleData, uchar* data, size_t size)
+            : MemoryDataStream(name, data, size, false, true), mBundleData(std::move(bundleData))
+        {
+        }
+    };
+
+    /** Archive over a bundle written by BundleWriter.
+    @remarks
+        Loading only maps the file and validates the header, the index is used
+        where it lies. Nothing is modified after loading, so entries can be
+        opened from many threads at once.
+    */
+    class BundleArchive : public Archive
+    {
+    protected:
+        MemoryDataStreamPtr mBuffer;
+        const BundleHeader* mHeader{nullptr};
+        const BundleEntry* mEntries{nullptr};
+        const uint32* mBuckets{nullptr};
+        const BundleDeclaration* mDeclarations{nullptr};
+        const char* mStrings{nullptr};
+
+        [[nodiscard]] auto getString(uint32 offset, uint32 length) const -> std::string_view;
+        [[nodiscard]] auto findEntry(std::string_view name) const -> const BundleEntry*;
+        [[nodiscard]] auto getFileInfo(const BundleEntry& entry) const -> FileInfo;
+        /// Gets the files or directories matching the pattern, all of them if it is empty
+        [[nodiscard]] auto findEntries(std::string_view pattern, bool recursive, bool dirs) const -> FileInfoList;
+    public:
+        BundleArchive(std::string_view name, std::string_view archType) : Archive(name, archType) {}
+        ~BundleArchive() override;
+        /// @copydoc Archive::isCaseSensitive
+        [[nodiscard]] auto isCaseSensitive() const noexcept -> bool override { return true; }
+
+        /// @copydoc Archive::load
+        void load() override;
+        /// @copydoc Archive::unload
+        void unload() override;
+
+        /// @copydoc Archive::open
+        [[nodiscard]] auto open(std::string_view filename, bool readOnly = true) const -> DataStreamPtr override;
+
+        /// @copydoc Archive::list
+        [[nodiscard]] auto list(bool recursive = true, bool dirs = false) const -> StringVectorPtr override;
+
+        /// @copydoc Archive::listFileInfo
+        [[nodiscard]] auto listFileInfo(bool recursive = true, bool dirs = false) const -> FileInfoListPtr override;
+
+        /// @copydoc Archive::find
+        [[nodiscard]] auto find(std::string_view pattern, bool recursive = true,
+            bool dirs = false) const -> StringVectorPtr override;
+
+        /// @copydoc Archive::findFileInfo
+        [[nodiscard]] auto findFileInfo(std::string_view pattern, bool recursive = true,
+            bool dirs = false) const -> FileInfoListPtr override;
+
+        /// @copydoc Archive::exists
+        [[nodiscard]] auto exists(std::string_view filename) const -> bool override;
+
+        /// @copydoc Archive::getModifiedTime
+        [[nodiscard]] auto getModifiedTime(std::string_view filename) const -> std::filesystem::file_time_type override;
+
+        /// @copydoc Archive::getResourceDeclarations
+        [[nodiscard]] auto getResourceDeclarations() const -> ArchiveResourceDeclarationList override;
+    };
+}
+    //-----------------------------------------------------------------------
+    BundleArchive::~BundleArchive()
+    {
+        unload();
+    }
+    //-----------------------------------------------------------------------
+    void BundleArchive::load()
+    {
+        if (mHeader)
+            return;
+
+        mBuffer = MemoryMappedDataStream::open(mName, mName);
+        if (!mBuffer)
+            mBuffer = std::make_shared<MemoryDataStream>(_openFileStream(mName, std::ios::binary));
+
+        const uchar* data = mBuffer->getPtr();
+        uint64 size = mBuffer->size();
+        auto fits = [size](uint64 offset, uint64 bytes) { return offset <= size && bytes <= size - offset; };
+
+        auto header = reinterpret_cast<const BundleHeader*>(data);
+        if (size < sizeof(BundleHeader) || header->magic != BUNDLE_MAGIC || header->version != BUNDLE_VERSION ||
+            !std::has_single_bit(header->numBuckets) || header->numBuckets <= header->numEntries ||
+            !fits(header->entriesOffset, uint64(header->numEntries) * sizeof(BundleEntry)) ||
+            !fits(header->bucketsOffset, uint64(header->numBuckets) * sizeof(uint32)) ||
+            !fits(header->declarationsOffset, uint64(header->numDeclarations) * sizeof(BundleDeclaration)) ||
+            !fits(header->stringsOffset, header->stringsSize))
+        {
+            mBuffer.reset();
+            OGRE_EXCEPT(ExceptionCodes::INVALIDPARAMS, ::std::format("{} is not a valid bundle", mName));
+        }
+
+        mHeader = header;
+        mEntries = reinterpret_cast<const BundleEntry*>(data + header->entriesOffset);
+        mBuckets = reinterpret_cast<const uint32*>(data + header->bucketsOffset);
+        mDeclarations = reinterpret_cast<const BundleDeclaration*>(data + header->declarationsOffset);
+        mStrings = reinterpret_cast<const char*>(data + header->stringsOffset);
+    }
+    //-----------------------------------------------------------------------
+    void BundleArchive::unload()
+    {
+        mHeader = nullptr;
+        mEntries = nullptr;
+        mBuckets = nullptr;
+        mDeclarations = nullptr;
+        mStrings = nullptr;
+        mBuffer.reset();
+    }
+    //-----------------------------------------------------------------------
+    auto BundleArchive::getString(uint32 offset, uint32 length) const -> std::string_view
+    {
+        if (uint64(offset) + length > mHeader->stringsSize)
+            return {};
+        return {mStrings + offset, length};
+    }
+    //-----------------------------------------------------------------------
+    auto BundleArchive::findEntry(std::string_view name) const -> const BundleEntry*
+    {
+        uint32 hash = hashName(name);
+        uint32 mask = mHeader->numBuckets - 1;
+
+        // linear probing, the table always has an empty bucket
+        for (uint32 i = 0, bucket = hash & mask; i < mHeader->numBuckets; ++i, bucket = (bucket + 1) & mask)
+        {
+            uint32 index = mBuckets[bucket];
+            if (index >= mHeader->numEntries)
+                break;
+
+            const BundleEntry& entry = mEntries[index];
+            if (entry.hash == hash && getString(entry.nameOffset, entry.nameLength) == name)
+                return &entry;
+        }
+        return nullptr;
+    }
+    //-----------------------------------------------------------------------
+    auto BundleArchive::getFileInfo(const BundleEntry& entry) const -> FileInfo
+    {
+        FileInfo info;
+        info.archive = this;
+        info.filename = getString(entry.nameOffset, entry.nameLength);
+
+        std::string_view basename, path;
+        StringUtil::splitFilename(info.filename, basename, path);
+        info.basename = basename;
+        info.path = path;
+
+        info.uncompressedSize = entry.size;
+        // like zip archives, directories are marked by their compressed size
+        info.compressedSize = (entry.flags & FLAG_DIRECTORY) ? size_t(-1) : entry.compressedSize;
+        return info;
+    }
+    //-----------------------------------------------------------------------
+    auto BundleArchive::findEntries(std::string_view pattern, bool recursive, bool dirs) const -> FileInfoList
+    {
+        // If pattern contains a directory name, do a full match
+        bool full_match = (pattern.find ('/') != String::npos) ||
+                          (pattern.find ('\\') != String::npos);
+        bool wildCard = pattern.find('*') != String::npos;
+
+        FileInfoList ret;
+        for (uint32 i = 0; i < mHeader->numEntries; ++i)
+        {
+            const BundleEntry& entry = mEntries[i];
+            if (dirs != bool(entry.flags & FLAG_DIRECTORY))
+                continue;
+
+            FileInfo info = getFileInfo(entry);
+            if (pattern.empty() ? (recursive || info.path.empty())
+                                : ((recursive || full_match || wildCard) &&
+                                   StringUtil::match(full_match ? info.filename : info.basename, pattern, false)))
+                ret.push_back(std::move(info));
+        }
+        return ret;
+    }
+    //-----------------------------------------------------------------------
+    auto BundleArchive::open(std::string_view filename, bool readOnly) const -> DataStreamPtr
+    {
+        const BundleEntry* entry = findEntry(filename);
+        if (!entry || (entry->flags & FLAG_DIRECTORY))
+        {
+            OGRE_EXCEPT(ExceptionCodes::FILE_NOT_FOUND, ::std::format("could not open {}", filename));
+        }
+
+        if (entry->offset > mBuffer->size() || entry->compressedSize > mBuffer->size() - entry->offset)
+        {
+            OGRE_EXCEPT(ExceptionCodes::INVALIDPARAMS, ::std::format("{} is truncated in {}", filename, mName));
+        }
+
+        uchar* data = mBuffer->getPtr() + entry->offset;
+        auto size = size_t(entry->size);
+
+        if (entry->method == METHOD_STORED)
+        {
+            if (readOnly)
+                return std::make_shared<BundleEntryView>(filename, mBuffer, data, size);
+
+            auto ret = std::make_shared<MemoryDataStream>(filename, size);
+            memcpy(ret->getPtr(), data, size);
+            return ret;
+        }
+
+        if (entry->method != METHOD_DEFLATED)
+        {
+            OGRE_EXCEPT(ExceptionCodes::NOT_IMPLEMENTED,
+                        ::std::format("unsupported compression method {} for {}", entry->method, filename));
+        }
+
+        auto ret = std::make_shared<MemoryDataStream>(filename, size);
+        if (size && tinfl_decompress_mem_to_mem(ret->getPtr(), size, data, entry->compressedSize, 0) != size)
+            OGRE_EXCEPT(ExceptionCodes::FILE_NOT_FOUND, ::std::format("could not read {}", filename));
+
+        return ret;
+    }
+    //-----------------------------------------------------------------------
+    auto BundleArchive::list(bool recursive, bool dirs) const -> StringVectorPtr
+    {
+        StringVectorPtr ret = StringVectorPtr(new StringVector());
+        for (auto& i : findEntries("", recursive, dirs))
+            ret->emplace_back(std::move(i.filename));
+        return ret;
+    }
+    //-----------------------------------------------------------------------
+    auto BundleArchive::listFileInfo(bool recursive, bool dirs) const -> FileInfoListPtr
+    {
+        return FileInfoListPtr(new FileInfoList(findEntries("", recursive, dirs)));
+    }
+    //-----------------------------------------------------------------------
+    auto BundleArchive::find(std::string_view pattern, bool recursive, bool dirs) const -> StringVectorPtr
+    {
+        StringVectorPtr ret = StringVectorPtr(new StringVector());
+        if (pattern.empty())
+            return ret;
+
+        for (auto& i : findEntries(pattern, recursive, dirs))
+            ret->emplace_back(std::move(i.filename));
+        return ret;
+    }
+    //-----------------------------------------------------------------------
+    auto BundleArchive::findFileInfo(std::string_view pattern, bool recursive, bool dirs) const -> FileInfoListPtr
+    {
+        if (pattern.empty())
+            return FileInfoListPtr(new FileInfoList());
+        return FileInfoListPtr(new FileInfoList(findEntries(pattern, recursive, dirs)));
+    }
+    //-----------------------------------------------------------------------
+    auto BundleArchive::exists(std::string_view filename) const -> bool
+    {
+        return findEntry(filename) != nullptr;
+    }
+    //-----------------------------------------------------------------------
+    auto BundleArchive::getModifiedTime(std::string_view filename) const -> std::filesystem::file_time_type
+    {
+        // entries have no time of their own
+        std::error_code ec{};
+        auto const lastWriteTime = std::filesystem::last_write_time(mName, ec);
+        return ec ? std::filesystem::file_time_type{} : lastWriteTime;
+    }
+    //-----------------------------------------------------------------------
+    auto BundleArchive::getResourceDeclarations() const -> ArchiveResourceDeclarationList
+    {
+        ArchiveResourceDeclarationList ret;
+        for (uint32 i = 0; i < mHeader->numDeclarations; ++i)
+        {
+            const BundleDeclaration& dcl = mDeclarations[i];
+            ret.push_back({std::string{getString(dcl.nameOffset, dcl.nameLength)},
+                           std::string{getString(dcl.typeOffset, dcl.typeLength)}});
+        }
+        return ret;
+    }
+    //-----------------------------------------------------------------------
+    //  BundleArchiveFactory
+    //-----------------------------------------------------------------------
+    auto BundleArchiveFactory::createInstance( std::string_view name, bool readOnly ) -> Archive *
+    {
+        if(!readOnly)
+            return nullptr;
+
+        return new BundleArchive(name, getType());
+    }
+    //-----------------------------------------------------------------------
+    auto BundleArchiveFactory::getType() const noexcept -> std::string_view
+    {
+        static std::string_view const constexpr name = "Bundle";
+        return name;
+    }
+    //-----------------------------------------------------------------------
+    //  BundleWriter
+    //-----------------------------------------------------------------------
+    void BundleWriter::addFile(std::string_view name, const DataStreamPtr& stream, bool compress)
+    {
+        mSources.push_back({std::string{name}, nullptr, stream, compress, false});
+    }
+    //-----------------------------------------------------------------------
+    void BundleWriter::addArchive(const Archive* archive, bool compress)
+    {
+        for (auto const& name : *archive->list(true, true))
+            mSources.push_back({name, archive, nullptr, false, true});
+        for (auto const& name : *archive->list(true, false))
+            mSources.push_back({name, archive, nullptr, compress, false});
+    }
+    //-----------------------------------------------------------------------
+    void BundleWriter::declareResource(std::string_view name, std::string_view resourceType)
+    {
+        mDeclarations.emplace_back(name, resourceType);
+    }
+    //-----------------------------------------------------------------------
+    void BundleWriter::setAlignment(size_t alignment)
+    {
+        OgreAssert(std::has_single_bit(alignment) && alignment <= (size_t(1) << 30),
+                   "alignment must be a power of two");
+        mAlignment = alignment;
+    }
+    //-----------------------------------------------------------------------
+    void BundleWriter::write(std::string_view path) const
+    {
+        std::vector<const Source*> sources;
+        for (auto const& source : mSources)
+            sources.push_back(&source);
+        std::ranges::sort(sources, {}, &Source::name);
+
+        auto duplicate = std::ranges::adjacent_find(sources, {}, &Source::name);
+        if (duplicate != sources.end())
+        {
+            OGRE_EXCEPT(ExceptionCodes::DUPLICATE_ITEM, ::std::format("{} was added twice", (*duplicate)->name));
+        }
+
+        BundleHeader header{};
+        header.magic = BUNDLE_MAGIC;
+        header.version = BUNDLE_VERSION;
+        header.numEntries = uint32(sources.size());
+        header.numBuckets = std::bit_ceil(header.numEntries * 2 + 1);
+        header.numDeclarations = uint32(mDeclarations.size());
+        header.alignment = uint32(mAlignment);
+        header.entriesOffset = sizeof(BundleHeader);
+        header.bucketsOffset = header.entriesOffset + header.numEntries * sizeof(BundleEntry);
+        header.declarationsOffset = alignOffset(header.bucketsOffset + header.numBuckets * sizeof(uint32), 8);
+        header.stringsOffset = header.declarationsOffset + header.numDeclarations * sizeof(BundleDeclaration);
+
+        std::string strings;
+        auto addString = [&strings](std::string_view str)
+        {
+            auto offset = uint32(strings.size());
+            strings += str;
+            return offset;
+        };
+
+        std::vector<BundleEntry> entries(sources.size());
+        std::vector<uint32> buckets(header.numBuckets, EMPTY_BUCKET);
+        for (uint32 i = 0; i < header.numEntries; ++i)
+        {
+            BundleEntry& entry = entries[i];
+            entry.nameOffset = addString(sources[i]->name);
+            entry.nameLength = uint32(sources[i]->name.size());
+            entry.hash = hashName(sources[i]->name);
+            entry.flags = sources[i]->directory ? FLAG_DIRECTORY : 0;
+
+            uint32 bucket = entry.hash & (header.numBuckets - 1);
+            while (buckets[bucket] != EMPTY_BUCKET)
+                bucket = (bucket + 1) & (header.numBuckets - 1);
+            buckets[bucket] = i;
+        }
+
+        std::vector<BundleDeclaration> declarations;
+        for (auto const& [name, type] : mDeclarations)
+        {
+            BundleDeclaration& dcl = declarations.emplace_back();
+            dcl.nameOffset = addString(name);
+            dcl.nameLength = uint32(name.size());
+            dcl.typeOffset = addString(type);
+            dcl.typeLength = uint32(type.size());
+        }
+        header.stringsSize = strings.size();
+
+        std::ofstream out(std::string{path}, std::ios::binary | std::ios::trunc);
+        if (!out)
+        {
+            OGRE_EXCEPT(ExceptionCodes::CANNOT_WRITE_TO_FILE, ::std::format("could not create {}", path));
+        }
+
+        // the payloads first, the index is written once their locations are known
+        uint64 pos = 0;
+        uint64 end = header.stringsOffset + header.stringsSize;
+        std::vector<uchar> data;
+        for (uint32 i = 0; i < header.numEntries; ++i)
+        {
+            const Source& source = *sources[i];
+            if (source.directory)
+                continue;
+
+            DataStreamPtr stream = source.archive ? source.archive->open(source.name) : source.stream;
+            data.resize(stream->size());
+            data.resize(stream->read(data.data(), data.size()));
+
+            const void* payload = data.data();
+            size_t payloadSize = data.size();
+            void* compressed = nullptr;
+            BundleEntry& entry = entries[i];
+            entry.method = METHOD_STORED;
+            if (source.compress && !data.empty())
+            {
+                size_t compressedSize = 0;
+                compressed = tdefl_compress_mem_to_heap(data.data(), data.size(), &compressedSize,
+                                                        TDEFL_DEFAULT_MAX_PROBES);
+                if (compressed && compressedSize < data.size())
+                {
+                    payload = compressed;
+                    payloadSize = compressedSize;
+                    entry.method = METHOD_DEFLATED;
+                }
+            }
+
+            entry.offset = alignOffset(end, mAlignment);
+            entry.size = data.size();
+            entry.compressedSize = payloadSize;
+
+            for (; pos < entry.offset; ++pos)
+                out.put(0);
+            out.write(static_cast<const char*>(payload), std::streamsize(payloadSize));
+            pos += payloadSize;
+            end = pos;
+            mz_free(compressed);
+        }
+
+        out.seekp(0);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(entries.data()), std::streamsize(entries.size() * sizeof(BundleEntry)));
+        out.write(reinterpret_cast<const char*>(buckets.data()), std::streamsize(buckets.size() * sizeof(uint32)));
+        for (pos = header.bucketsOffset + buckets.size() * sizeof(uint32); pos < header.declarationsOffset; ++pos)
+            out.put(0);
+        out.write(reinterpret_cast<const char*>(declarations.data()),
+                  std::streamsize(declarations.size() * sizeof(BundleDeclaration)));
+        out.write(strings.data(), std::streamsize(strings.size()));
+
+        if (!out)
+        {
+            OGRE_EXCEPT(ExceptionCodes::CANNOT_WRITE_TO_FILE, ::std::format("could not write {}", path));
+        }
+    }
+}
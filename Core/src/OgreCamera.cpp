@@ -559,6 +559,18 @@ namespace Ogre {
         }
     }
     //-----------------------------------------------------------------------
+    void Camera::isVisible(const AxisAlignedBoxBatch& bounds, uint8* visible) const
+    {
+        if (mCullFrustum)
+        {
+            mCullFrustum->isVisible(bounds, visible);
+        }
+        else
+        {
+            Frustum::isVisible(bounds, visible);
+        }
+    }
+    //-----------------------------------------------------------------------
     auto Camera::isVisible(const Sphere& bound, FrustumPlane* culledBy) const -> bool
     {
         if (mCullFrustum)
@@ -0,0 +1,260 @@
+// This file is part of the OGRE project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at https://www.ogre3d.org/licensing.
+module;
+
+#include <cstddef>
+
+module Ogre.Core;
+
+import :CategoryAllocators;
+import :Exception;
+import :MemoryAllocatorConfig;
+import :Platform;
+
+import <algorithm>;
+import <atomic>;
+import <memory>;
+import <mutex>;
+import <new>;
+import <vector>;
+
+namespace Ogre {
+
+namespace {
+    std::atomic<uint64> nextAllocatorId{1};
+    // set when the caches of the thread are gone, trivial so it outlives them
+    thread_local bool threadCachesDestroyed = false;
+
+    /// alignment of the chunks and of the buffer of LinearAllocator
+    constexpr size_t CHUNK_ALIGNMENT = 64;
+}
+
+    /// the free blocks a thread keeps of one allocator
+    struct SmallObjectAllocator::ThreadCache
+    {
+        SmallObjectAllocator* owner{nullptr};
+        uint64 id{0};
+        std::array<FreeBlock*, SIZE_CLASSES> lists{};
+        std::array<uint32, SIZE_CLASSES> counts{};
+
+        ~ThreadCache()
+        {
+            if (!owner)
+                return;
+
+            {
+                std::scoped_lock lock{owner->mMutex};
+                std::erase(owner->mThreadCaches, this);
+            }
+            for (size_t i = 0; i < SIZE_CLASSES; ++i)
+            {
+                if (!lists[i])
+                    continue;
+                FreeBlock* last = lists[i];
+                while (last->next)
+                    last = last->next;
+                owner->release(i, lists[i], last);
+            }
+        }
+    };
+    //---------------------------------------------------------------------
+    SmallObjectAllocator::SmallObjectAllocator(size_t chunkSize)
+        : mChunkSize(chunkSize), mId(nextAllocatorId.fetch_add(1, std::memory_order_relaxed))
+    {
+        OgreAssert(chunkSize >= MAX_SIZE, "chunkSize must hold a block of MAX_SIZE");
+    }
+    //---------------------------------------------------------------------
+    SmallObjectAllocator::~SmallObjectAllocator()
+    {
+        // the cached blocks are in the chunks freed below
+        for (ThreadCache* cache : mThreadCaches)
+            cache->owner = nullptr;
+
+        for (void* chunk : mChunks)
+            ::operator delete(chunk, mChunkSize, std::align_val_t{CHUNK_ALIGNMENT});
+    }
+    //---------------------------------------------------------------------
+    auto SmallObjectAllocator::threadCache() -> ThreadCache*
+    {
+        struct Caches
+        {
+            std::vector<std::unique_ptr<ThreadCache>> caches;
+            ~Caches()
+            {
+                caches.clear();
+                threadCachesDestroyed = true;
+            }
+        };
+
+        // objects freed by destructors of other thread locals go to the shared lists
+        if (threadCachesDestroyed)
+            return nullptr;
+
+        static thread_local Caches caches;
+        for (auto& cache : caches.caches)
+        {
+            if (cache->id == mId)
+                return cache.get();
+        }
+
+        // drop the caches of destroyed allocators
+        std::erase_if(caches.caches, [](const auto& cache) { return !cache->owner; });
+
+        auto& cache = caches.caches.emplace_back(::std::make_unique<ThreadCache>());
+        cache->owner = this;
+        cache->id = mId;
+        std::scoped_lock lock{mMutex};
+        mThreadCaches.push_back(cache.get());
+        return cache.get();
+    }
+    //---------------------------------------------------------------------
+    auto SmallObjectAllocator::refill(size_t sizeClass, uint32& count) -> FreeBlock*
+    {
+        std::scoped_lock lock{mMutex};
+
+        if (FreeBlock* first = mFree[sizeClass])
+        {
+            FreeBlock* last = first;
+            uint32 taken = 1;
+            for (; taken < count && last->next; ++taken)
+                last = last->next;
+            mFree[sizeClass] = last->next;
+            last->next = nullptr;
+            count = taken;
+            return first;
+        }
+
+        const size_t blockSize = (sizeClass + 1) * GRANULARITY;
+        FreeBlock* list = nullptr;
+        uint32 carved = 0;
+        for (; carved < count; ++carved)
+        {
+            if (mChunkLeft < blockSize)
+            {
+                // the rest of the chunk is wasted, it is less than a block
+                if (carved > 0)
+                    break;
+                mChunk = static_cast<uint8*>(::operator new(mChunkSize, std::align_val_t{CHUNK_ALIGNMENT}));
+                mChunks.push_back(mChunk);
+                mChunkLeft = mChunkSize;
+            }
+            list = new (mChunk) FreeBlock{list};
+            mChunk += blockSize;
+            mChunkLeft -= blockSize;
+        }
+        count = carved;
+        return list;
+    }
+    //---------------------------------------------------------------------
+    void SmallObjectAllocator::release(size_t sizeClass, FreeBlock* first, FreeBlock* last)
+    {
+        std::scoped_lock lock{mMutex};
+        last->next = mFree[sizeClass];
+        mFree[sizeClass] = first;
+    }
+    //---------------------------------------------------------------------
+    auto SmallObjectAllocator::allocate(size_t size, size_t alignment) -> void*
+    {
+        if (size > MAX_SIZE || alignment > GRANULARITY)
+            return ::operator new(size, std::align_val_t{alignment});
+
+        const size_t sizeClass = (std::max<size_t>(size, 1) - 1) / GRANULARITY;
+
+        ThreadCache* cache = threadCache();
+        if (!cache)
+        {
+            uint32 count = 1;
+            return refill(sizeClass, count);
+        }
+
+        FreeBlock*& list = cache->lists[sizeClass];
+        if (!list)
+        {
+            uint32 count = BATCH;
+            list = refill(sizeClass, count);
+            cache->counts[sizeClass] = count;
+        }
+
+        FreeBlock* block = list;
+        list = block->next;
+        --cache->counts[sizeClass];
+        return block;
+    }
+    //---------------------------------------------------------------------
+    void SmallObjectAllocator::deallocate(void* ptr, size_t size, size_t alignment) noexcept
+    {
+        if (size > MAX_SIZE || alignment > GRANULARITY)
+        {
+            ::operator delete(ptr, size, std::align_val_t{alignment});
+            return;
+        }
+
+        const size_t sizeClass = (std::max<size_t>(size, 1) - 1) / GRANULARITY;
+        auto block = new (ptr) FreeBlock{nullptr};
+
+        ThreadCache* cache = threadCache();
+        if (!cache)
+        {
+            release(sizeClass, block, block);
+            return;
+        }
+
+        block->next = cache->lists[sizeClass];
+        cache->lists[sizeClass] = block;
+
+        // give a batch back, so blocks freed by another thread than the allocating one are reused
+        if (++cache->counts[sizeClass] > 2 * BATCH)
+        {
+            FreeBlock* last = block;
+            for (uint32 i = 1; i < BATCH; ++i)
+                last = last->next;
+            cache->lists[sizeClass] = last->next;
+            cache->counts[sizeClass] -= BATCH;
+            release(sizeClass, block, last);
+        }
+    }
+    //---------------------------------------------------------------------
+    auto SmallObjectAllocator::getReservedBytes() const -> size_t
+    {
+        std::scoped_lock lock{mMutex};
+        return mChunks.size() * mChunkSize;
+    }
+    //---------------------------------------------------------------------
+    LinearAllocator::LinearAllocator(size_t capacity)
+        : mBuffer(static_cast<uint8*>(::operator new(capacity, std::align_val_t{CHUNK_ALIGNMENT}))),
+          mCapacity(capacity)
+    {
+    }
+    //---------------------------------------------------------------------
+    LinearAllocator::~LinearAllocator()
+    {
+        ::operator delete(mBuffer, mCapacity, std::align_val_t{CHUNK_ALIGNMENT});
+    }
+    //---------------------------------------------------------------------
+    auto LinearAllocator::allocate(size_t size, size_t alignment) -> void*
+    {
+        if (alignment <= CHUNK_ALIGNMENT)
+        {
+            size_t used = mUsed.load(std::memory_order_relaxed);
+            for (;;)
+            {
+                size_t offset = (used + alignment - 1) & ~(alignment - 1);
+                if (offset + size > mCapacity)
+                    break;
+                if (mUsed.compare_exchange_weak(used, offset + size, std::memory_order_relaxed))
+                    return mBuffer + offset;
+            }
+        }
+
+        return ::operator new(size, std::align_val_t{alignment});
+    }
+    //---------------------------------------------------------------------
+    void LinearAllocator::deallocate(void* ptr, size_t size, size_t alignment) noexcept
+    {
+        auto bytes = static_cast<uint8*>(ptr);
+        if (bytes >= mBuffer && bytes < mBuffer + mCapacity)
+            return;
+        ::operator delete(ptr, size, std::align_val_t{alignment});
+    }
+}
@@ -31,15 +31,24 @@ module;
 
 module Ogre.Core;
 
+import :CompositionPass;
 import :CompositionTargetPass;
 import :CompositionTechnique;
+import :Compositor;
 import :Exception;
+import :Material;
+import :Pass;
 import :RenderSystem;
 import :RenderSystemCapabilities;
 import :Root;
+import :Technique;
 import :TextureManager;
+import :TextureUnitState;
 
+import <map>;
+import <set>;
 import <string>;
+import <string_view>;
 
 namespace Ogre {
 CompositionTechnique::CompositionTechnique(Compositor *parent):
@@ -204,5 +213,91 @@ void CompositionTechnique::setSchemeName(std::string_view schemeName)
 {
     mSchemeName = schemeName;
 }
+//---------------------------------------------------------------------
+auto CompositionTechnique::computeTextureLifetimes() const -> TextureLifetimes
+{
+    TextureLifetimes lifetimes;
+    std::set<std::string_view> written;
+    bool accessesAnything = false;
+
+    auto use = [&](std::string_view name, size_t index) -> TextureLifetime&
+    {
+        auto& lifetime = lifetimes.try_emplace(name, TextureLifetime{index, index}).first->second;
+        lifetime.lastUse = index;
+        return lifetime;
+    };
+
+    // whether the target pass replaces every texel before anything reads them
+    auto overwritesCompletely = [](const CompositionTargetPass* tp)
+    {
+        if (tp->getInputMode() == CompositionTargetPass::InputMode::PREVIOUS)
+            return true;
+        if (tp->getPasses().empty())
+            return false;
+
+        const CompositionPass* first = tp->getPasses().front();
+        switch (first->getType())
+        {
+        case CompositionPass::PassType::CLEAR:
+            return !!(first->getClearBuffers() & FrameBufferType::COLOUR);
+        case CompositionPass::PassType::RENDERQUAD:
+            return first->getMaterial() && !first->getMaterial()->isTransparent();
+        default:
+            return false;
+        }
+    };
+
+    size_t numTargetPasses = mTargetPasses.size();
+    for (size_t index = 0; index <= numTargetPasses; ++index)
+    {
+        const CompositionTargetPass* tp = index < numTargetPasses ? mTargetPasses[index] : mOutputTarget.get();
+
+        // inputs are read before the output of the same target pass is written
+        for (const CompositionPass* pass : tp->getPasses())
+        {
+            if (pass->getType() == CompositionPass::PassType::RENDERCUSTOM ||
+                pass->getType() == CompositionPass::PassType::COMPUTE)
+                accessesAnything = true;
+
+            for (size_t i = 0; i < pass->getNumInputs(); ++i)
+            {
+                std::string_view name = pass->getInput(i).name;
+                if (name.empty())
+                    continue;
+                auto& lifetime = use(name, index);
+                if (!written.contains(name))
+                    lifetime.persistent = true;
+            }
+
+            const MaterialPtr& mat = pass->getMaterial();
+            if (!mat)
+                continue;
+            for (const Technique* t : mat->getTechniques())
+                for (const Pass* p : t->getPasses())
+                    for (const TextureUnitState* tus : p->getTextureUnitStates())
+                    {
+                        if (tus->getContentType() == TextureUnitState::ContentType::COMPOSITOR && mParent &&
+                            tus->getReferencedCompositorName() == mParent->getName())
+                            use(tus->getReferencedTextureName(), index).persistent = true;
+                    }
+        }
+
+        if (index == numTargetPasses)
+            break;
+
+        std::string_view output = tp->getOutputName();
+        auto& lifetime = use(output, index);
+        if (written.insert(output).second && !overwritesCompletely(tp))
+            lifetime.persistent = true;
+    }
+
+    if (accessesAnything)
+    {
+        for (auto& [name, lifetime] : lifetimes)
+            lifetime.persistent = true;
+    }
+
+    return lifetimes;
+}
 
 }
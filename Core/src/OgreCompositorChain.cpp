@@ -39,23 +39,29 @@ import :Compositor;
 import :CompositorChain;
 import :CompositorInstance;
 import :CompositorManager;
+import :Exception;
 import :MaterialManager;
 import :Math;
+import :Profiler;
 import :Quaternion;
 import :RenderQueue;
 import :RenderSystem;
 import :RenderTarget;
+import :Resource;
 import :ResourceGroupManager;
 import :Root;
 import :SceneManager;
 import :SceneNode;
 import :SharedPtr;
 import :String;
+import :Timer;
 import :Vector;
 
 import <algorithm>;
+import <cmath>;
 import <iterator>;
 import <ranges>;
+import <set>;
 import <string>;
 import <utility>;
 
@@ -300,6 +306,22 @@ void CompositorChain::preRenderTargetUpdate(const RenderTargetEvent& evt)
         return;
     }
 
+    if (mTargetFrameTime > 0)
+    {
+        if (Real gpuTime = Profiler::getSingleton().getGPUFrameTime(); gpuTime > 0)
+            mResolutionScale = _computeResolutionScale(mResolutionScale, gpuTime, mTargetFrameTime, mMinResolutionScale);
+    }
+
+    if (mResolutionScale != mAppliedResolutionScale)
+    {
+        mAppliedResolutionScale = mResolutionScale;
+        for (auto inst : mInstances)
+        {
+            if (inst->getEnabled())
+                inst->_setResolutionScale(mResolutionScale);
+        }
+    }
+
 
     /// Update dependent render targets; this is done in the preRenderTarget 
     /// and not the preViewportUpdate for a reason: at this time, the
@@ -307,11 +329,15 @@ void CompositorChain::preRenderTargetUpdate(const RenderTargetEvent& evt)
     /// ( RenderSystem::setViewport(...) ) if it would have been, the rendering
     /// order would be screwed up and problems would arise with copying rendertextures.
     Camera *cam = mViewport->getCamera();
-    if (cam)
+    SceneManager* sceneMgr = cam ? cam->getSceneManager() : nullptr;
+    if (sceneMgr)
     {
-        cam->getSceneManager()->_setActiveCompositorChain(this);
+        sceneMgr->_setActiveCompositorChain(this);
     }
 
+    Timer* timer = Root::getSingleton().getTimer();
+    uint64 startTime = timer->getMicroseconds();
+
     /// Iterate over compiled state
     for(auto& op : mCompiledState)
     {
@@ -333,11 +359,16 @@ void CompositorChain::preRenderTargetUpdate(const RenderTargetEvent& evt)
             cam->getParentSceneNode()->setOrientation(getCubemapRotation(op.alignCameraToFace));
         }
 
-        /// Setup and render
+        /// Setup and render, as a GPU event so the profiler can time the pass
+        Profiler::getSingleton().beginGPUEvent(op.target->getName());
         preTargetOperation(op, vp, cam);
         op.target->update();
         postTargetOperation(op, vp, cam);
+        Profiler::getSingleton().endGPUEvent(op.target->getName());
     }
+
+    if (sceneMgr)
+        sceneMgr->_notifyCompositorTime(timer->getMicroseconds() - startTime);
 }
 //-----------------------------------------------------------------------
 void CompositorChain::postRenderTargetUpdate(const RenderTargetEvent& evt)
@@ -355,6 +386,9 @@ void CompositorChain::preViewportUpdate(const RenderTargetViewportEvent& evt)
     if(evt.source != mViewport || !mAnyCompositorsEnabled)
         return;
 
+    // the output operation is timed as well, for setDynamicResolution
+    Profiler::getSingleton().beginGPUEvent(mViewport->getTarget()->getName());
+
     // set original scene details from viewport
     CompositionPass* pass = mOriginalScene->getTechnique()->getOutputTargetPass()->getPasses()[0];
     CompositionTargetPass* passParent = pass->getParent();
@@ -439,6 +473,8 @@ void CompositorChain::postViewportUpdate(const RenderTargetViewportEvent& evt)
 
     Camera *cam = mViewport->getCamera();
     postTargetOperation(mOutputOperation, mViewport, cam);
+
+    Profiler::getSingleton().endGPUEvent(mViewport->getTarget()->getName());
 }
 //-----------------------------------------------------------------------
 void CompositorChain::viewportCameraChanged(Viewport* viewport)
@@ -519,6 +555,12 @@ void CompositorChain::_compile()
     mOutputOperation.renderSystemOperations.clear();
     lastComposition->_compileOutputOperation(mOutputOperation);
 
+    if (CompositorManager::getSingleton().getUnusedTargetCulling())
+        _cullUnusedOperations(mCompiledState, mOutputOperation);
+
+    /// The render targets may have been recreated at full size
+    mAppliedResolutionScale = 0;
+
     // Deal with viewport settings
     if (compositorsEnabled != mAnyCompositorsEnabled)
     {
@@ -621,6 +663,65 @@ void CompositorChain::RQListener::flushUpTo(Ogre::RenderQueueGroupID id)
     }
 }
 //-----------------------------------------------------------------------
+void CompositorChain::setResolutionScale(Real scale)
+{
+    OgreAssert(scale > 0 && scale <= 1, "scale must be in (0, 1]");
+    mResolutionScale = scale;
+}
+//-----------------------------------------------------------------------
+void CompositorChain::setDynamicResolution(Real targetMilliseconds, Real minScale)
+{
+    OgreAssert(minScale > 0 && minScale <= 1, "minScale must be in (0, 1]");
+    mTargetFrameTime = targetMilliseconds;
+    mMinResolutionScale = minScale;
+    mResolutionScale = std::max(mResolutionScale, minScale);
+}
+//-----------------------------------------------------------------------
+auto CompositorChain::_computeResolutionScale(Real scale, Real frameTime, Real targetFrameTime, Real minScale) -> Real
+{
+    // the pixel count goes with the square of the scale
+    Real desired = scale * std::sqrt(targetFrameTime / frameTime);
+    Real next = std::clamp(scale + (desired - scale) * 0.25f, minScale, Real(1));
+    return std::abs(next - scale) < 0.01f ? scale : next;
+}
+//-----------------------------------------------------------------------
+auto CompositorChain::_cullUnusedOperations(CompositorInstance::CompiledState& ops,
+                                            const CompositorInstance::TargetOperation& output) -> size_t
+{
+    std::vector<bool> needed(ops.size(), false);
+    std::set<ResourceHandle> sampled{output.reads.begin(), output.reads.end()};
+    // operations before this index may be observed by one that samples anything
+    size_t observedBefore = output.readsAnything ? ops.size() : 0;
+
+    // a needed operation can make an earlier or, through feedback, a later one needed
+    for (bool changed = true; changed;)
+    {
+        changed = false;
+        for (size_t i = ops.size(); i-- > 0;)
+        {
+            const auto& op = ops[i];
+            if (needed[i] || !(op.keepAlive || op.writes.empty() || i < observedBefore ||
+                               std::ranges::any_of(op.writes, [&](ResourceHandle h) { return sampled.contains(h); })))
+                continue;
+
+            needed[i] = changed = true;
+            sampled.insert(op.reads.begin(), op.reads.end());
+            if (op.readsAnything)
+                observedBefore = std::max(observedBefore, i);
+        }
+    }
+
+    size_t culled = 0;
+    for (size_t i = ops.size(); i-- > 0;)
+    {
+        if (needed[i])
+            continue;
+        ops.erase(ops.begin() + i);
+        culled++;
+    }
+    return culled;
+}
+//-----------------------------------------------------------------------
 auto CompositorChain::getPreviousInstance(CompositorInstance* curr, bool activeOnly) -> CompositorInstance*
 {
     bool found = false;
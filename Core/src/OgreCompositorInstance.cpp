@@ -68,9 +68,41 @@ import :Vector;
 import :Viewport;
 
 import <algorithm>;
+import <set>;
 import <utility>;
+import <vector>;
 
 namespace Ogre {
+namespace {
+    /// A texture created for transient definitions, with the target passes it is in use
+    struct TransientTexture
+    {
+        const CompositionTechnique::TextureDefinition* def;
+        uint32 width, height;
+        uint fsaa;
+        String fsaaHint;
+        bool hwGamma;
+        TexturePtr texture;
+        std::vector<CompositionTechnique::TextureLifetime> uses;
+
+        [[nodiscard]] auto isCompatible(const CompositionTechnique::TextureDefinition* other, uint32 w, uint32 h,
+                                        uint aa, std::string_view aaHint, bool srgb) const -> bool
+        {
+            // both must be recreated on the same resizes
+            bool derivedSize = def->width == 0 || def->height == 0;
+            bool otherDerivedSize = other->width == 0 || other->height == 0;
+            return derivedSize == otherDerivedSize && def->type == other->type &&
+                   def->formatList[0] == other->formatList[0] && def->depthBufferId == other->depthBufferId &&
+                   width == w && height == h && fsaa == aa && fsaaHint == aaHint && hwGamma == srgb;
+        }
+
+        [[nodiscard]] auto isFreeDuring(const CompositionTechnique::TextureLifetime& lifetime) const -> bool
+        {
+            return std::ranges::all_of(uses, [&](const CompositionTechnique::TextureLifetime& use)
+                                       { return use.lastUse < lifetime.firstUse || lifetime.lastUse < use.firstUse; });
+        }
+    };
+}
 CompositorInstance::CompositorInstance(CompositionTechnique *technique,
     CompositorChain *chain):
     mCompositor(technique->getParent()), mTechnique(technique), mChain(chain)
@@ -198,6 +230,8 @@ public:
     uint32 pass_id;
 
     bool mQuadCornerModified{false}, mQuadFarCorners{false}, mQuadFarCornersViewSpace{false};
+    /// Samples textures affected by CompositorChain::setResolutionScale
+    bool mScaledInputs{false};
     FloatRect mQuad;
 
     void setQuadCorners(const FloatRect& quad)
@@ -242,6 +276,11 @@ public:
             }
         }
 
+        // Sample the part of the inputs that was rendered to
+        Real uvScale = mScaledInputs ? instance->getChain()->getResolutionScale() : 1;
+        if (uvScale != 1)
+            rect->setUVs(Vector2::ZERO, Vector2{0, uvScale}, Vector2{uvScale, 0}, Vector2{uvScale, uvScale});
+
         // Queue passes from mat
         for (auto i : technique->getPasses())
         {
@@ -251,6 +290,9 @@ public:
                 false // don't allow replacement of shadow passes
                 );
         }
+
+        if (uvScale != 1)
+            rect->setDefaultUVs();
     }
 };
 
@@ -328,6 +370,12 @@ public:
     }
 };
 
+/// Whether CompositorChain::setResolutionScale applies to the textures of def
+static auto isResolutionScaled(const CompositionTechnique::TextureDefinition* def) -> bool
+{
+    return def->width == 0 && def->height == 0 && def->scope != CompositionTechnique::TextureScope::GLOBAL;
+}
+
 void CompositorInstance::collectPasses(TargetOperation &finalState, const CompositionTargetPass *target)
 {
     /// Here, passes are converted into render target operations
@@ -396,6 +444,8 @@ void CompositorInstance::collectPasses(TargetOperation &finalState, const Compos
             finalState.alignCameraToFace = pass->getAlignCameraToFace() ? target->getOutputSlice() : -1;
 
             finalState.findVisibleObjects = true;
+            // the scene materials may sample any compositor texture
+            finalState.readsAnything = true;
 
             break;
         }
@@ -422,6 +472,31 @@ void CompositorInstance::collectPasses(TargetOperation &finalState, const Compos
                 break;
             }
             srctech = srcmat->getBestTechnique(0);
+            /// Record the sampled textures for the dependency graph of the chain
+            for(size_t x=0; x<pass->getNumInputs(); ++x)
+            {
+                const CompositionPass::InputTex& inp = pass->getInput(x);
+                if(!inp.name.empty())
+                    finalState.reads.push_back(getSourceForTex(inp.name, inp.mrtIndex)->getHandle());
+            }
+            for (auto srcpass : srctech->getPasses())
+            {
+                for (auto tus : srcpass->getTextureUnitStates())
+                {
+                    if (tus->getContentType() != TextureUnitState::ContentType::COMPOSITOR)
+                        continue;
+                    CompositorInstance* refInst = mChain->getCompositor(tus->getReferencedCompositorName());
+                    const TexturePtr* refTex = refInst ? &refInst->getTextureInstance(tus->getReferencedTextureName(),
+                                                                                      tus->getReferencedMRTIndex()) : nullptr;
+                    if (refTex && *refTex)
+                        finalState.reads.push_back((*refTex)->getHandle());
+                    else
+                        finalState.readsAnything = true;
+                }
+            }
+            /// Compute programs may write to any texture bound as image
+            if (isCompute)
+                finalState.keepAlive = true;
             /// Create local material
             MaterialPtr localMat = createLocalMaterial(srcmat->getName());
             /// Copy and adapt passes from source material
@@ -471,6 +546,15 @@ void CompositorInstance::collectPasses(TargetOperation &finalState, const Compos
             else
             {
                 auto rsQuadOperation = new RSQuadOperation(this, pass->getIdentifier(), localMat);
+                for(size_t x=0; x<pass->getNumInputs(); ++x)
+                {
+                    const CompositionPass::InputTex& inp = pass->getInput(x);
+                    auto def = inp.name.empty() ? nullptr : mTechnique->getTextureDefinition(inp.name);
+                    if (def && !def->refCompName.empty())
+                        def = resolveTexReference(def);
+                    if (def && isResolutionScaled(def))
+                        rsQuadOperation->mScaledInputs = true;
+                }
                 FloatRect quad;
                 if (pass->getQuadCorners(quad))
                     rsQuadOperation->setQuadCorners(quad);
@@ -483,6 +567,9 @@ void CompositorInstance::collectPasses(TargetOperation &finalState, const Compos
         case RENDERCUSTOM:
 		
 			finalState.currentQueueGroupID = pass->getFirstRenderQueue();
+            /// The dependencies of custom passes are unknown
+            finalState.readsAnything = true;
+            finalState.keepAlive = true;
 		
             RenderSystemOperation* customOperation = CompositorManager::getSingleton().
                 getCustomCompositionPass(pass->getCustomType())->createOperation(this, pass);
@@ -507,6 +594,17 @@ void CompositorInstance::_compileTargetOperations(CompiledState &compiledState)
         ts.lodBias = target->getLodBias();
         ts.shadowsEnabled = target->getShadowsEnabled();
         ts.materialScheme = target->getMaterialScheme();
+        /// Record the rendered textures for the dependency graph of the chain
+        if (auto def = mTechnique->getTextureDefinition(target->getOutputName()))
+        {
+            ts.keepAlive = ts.onlyInitial || !def->refCompName.empty() ||
+                           def->scope == CompositionTechnique::TextureScope::GLOBAL;
+            for (size_t atch = 0; atch < std::max<size_t>(def->formatList.size(), 1); ++atch)
+            {
+                if (const TexturePtr& tex = getTextureInstance(def->name, atch))
+                    ts.writes.push_back(tex->getHandle());
+            }
+        }
         /// Check for input mode previous
         if(target->getInputMode() == CompositionTargetPass::InputMode::PREVIOUS)
         {
@@ -645,6 +743,33 @@ void CompositorInstance::notifyResized()
     mChain->_markDirty();
 }
 //-----------------------------------------------------------------------
+void CompositorInstance::_setResolutionScale(Real scale)
+{
+    auto scaleViewport = [scale](RenderTarget* rt)
+    {
+        if (rt && rt->getNumViewports() != 0)
+            rt->getViewport(0)->setDimensions(0, 0, scale, scale);
+    };
+
+    for (auto def : mTechnique->getTextureDefinitions())
+    {
+        if (!def->refCompName.empty() || !isResolutionScaled(def))
+            continue;
+
+        if (auto mrt = mLocalMRTs.find(def->name); mrt != mLocalMRTs.end())
+        {
+            scaleViewport(mrt->second);
+            continue;
+        }
+
+        auto tex = mLocalTextures.find(def->name);
+        if (tex == mLocalTextures.end() || !tex->second)
+            continue;
+        for (uint32 face = 0; face < tex->second->getNumFaces(); ++face)
+            scaleViewport(tex->second->getBuffer(face)->getRenderTarget());
+    }
+}
+//-----------------------------------------------------------------------
 void CompositorInstance::createResources(bool forResizeOnly)
 {
     static size_t constinit dummyCounter = 0;
@@ -654,6 +779,13 @@ void CompositorInstance::createResources(bool forResizeOnly)
     /// are composited.
     CompositorManager::UniqueTextureSet assignedTextures;
 
+    /// Local textures that are only used during some target passes can share
+    /// memory with each other, see CompositorManager::setTransientTextureAliasing
+    CompositionTechnique::TextureLifetimes lifetimes;
+    if (CompositorManager::getSingleton().getTransientTextureAliasing())
+        lifetimes = mTechnique->computeTextureLifetimes();
+    std::vector<TransientTexture> transients;
+
     for (auto def : mTechnique->getTextureDefinitions())
     {
         if (!def->refCompName.empty()) {
@@ -781,6 +913,25 @@ void CompositorInstance::createResources(bool forResizeOnly)
                 
                 hwGamma = hwGamma && !PixelUtil::isFloatingPoint(def->formatList[0]);
 
+                auto lifetime = lifetimes.find(def->name);
+                bool transient = lifetime != lifetimes.end() && !lifetime->second.persistent && !def->pooled &&
+                                 def->scope == CompositionTechnique::TextureScope::LOCAL;
+                if (transient)
+                {
+                    auto alias = std::ranges::find_if(
+                        transients, [&](const TransientTexture& t)
+                        { return t.isCompatible(def, width, height, fsaa, fsaaHint, hwGamma) &&
+                                 t.isFreeDuring(lifetime->second); });
+                    if (alias != transients.end())
+                    {
+                        // the render targets were already set up for the first user
+                        alias->uses.push_back(lifetime->second);
+                        mLocalTextures[def->name] = alias->texture;
+                        mAliasedTextures.insert(def->name);
+                        continue;
+                    }
+                }
+
                 TexturePtr tex;
                 if (def->pooled)
                 {
@@ -798,6 +949,8 @@ void CompositorInstance::createResources(bool forResizeOnly)
                 }
 
                 mLocalTextures[def->name] = tex;
+                if (transient)
+                    transients.push_back({def, width, height, fsaa, fsaaHint, hwGamma, tex, {lifetime->second}});
 
                 for(size_t i = 0; i < tex->getNumFaces(); i++)
                     setupRenderTarget(tex->getBuffer(i)->getRenderTarget(), def->depthBufferId);
@@ -956,7 +1109,9 @@ void CompositorInstance::freeResources(bool forResizeOnly, bool clearReserveText
                 auto i = mLocalTextures.find(texName);
                 if (i != mLocalTextures.end())
                 {
-                    if (!def->pooled && def->scope != CompositionTechnique::TextureScope::GLOBAL)
+                    // aliases share a texture owned by another definition
+                    bool aliased = mAliasedTextures.erase(texName) != 0;
+                    if (!aliased && !def->pooled && def->scope != CompositionTechnique::TextureScope::GLOBAL)
                     {
                         // remove myself from central only if not pooled and not global
                         TextureManager::getSingleton().remove(i->second);
@@ -0,0 +1,318 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+module;
+
+#include <cstddef>
+
+module Ogre.Core;
+
+import :AnimationTrack;
+import :CompressedNodeTrack;
+import :Exception;
+import :KeyFrame;
+import :Math;
+import :Quaternion;
+import :Vector;
+
+import <algorithm>;
+import <cmath>;
+import <vector>;
+
+namespace Ogre {
+
+    namespace {
+        /// Same search as AnimationTrack::getKeyFrameIndicesAtTime
+        auto locateKeys(const std::vector<Real>& times, Real timePos, Real length, size_t& key1, size_t& key2)
+            -> Real
+        {
+            size_t i = std::distance(times.begin(), std::ranges::lower_bound(times, timePos));
+            Real t2;
+            if (i == times.size())
+            {
+                // wrap back to the first key
+                key2 = 0;
+                t2 = length + times.front();
+                --i;
+            }
+            else
+            {
+                key2 = i;
+                t2 = times[i];
+                if (i != 0 && timePos < times[i])
+                    --i;
+            }
+            key1 = i;
+            Real t1 = times[i];
+            return t1 == t2 ? 0 : (timePos - t1) / (t2 - t1);
+        }
+
+        /** Indices of the keys to keep, so that interpolating them reproduces all keys.
+        @param fits Whether the keys strictly between the two given ones can be dropped
+        */
+        template <typename Fits>
+        auto reduceKeys(size_t count, Fits fits) -> std::vector<size_t>
+        {
+            // the first and last keys are kept, the wrap around interpolates between them
+            std::vector<size_t> kept{0};
+            for (size_t i = 0; i + 1 < count;)
+            {
+                size_t j = i + 1;
+                while (j + 1 < count && fits(i, j + 1))
+                    ++j;
+                kept.push_back(j);
+                i = j;
+            }
+            return kept;
+        }
+
+        auto quantise(Real value, Real base, Real step) -> uint16
+        {
+            return step > 0 ? static_cast<uint16>(std::lround(std::clamp((value - base) / step, Real(0), Real(65535))))
+                            : 0;
+        }
+
+        auto angleBetween(const Quaternion& a, const Quaternion& b) -> Real
+        {
+            return 2 * std::acos(std::min(std::abs(a.Dot(b)), Real(1)));
+        }
+    }
+    //-----------------------------------------------------------------------
+    CompressedNodeTrack::CompressedNodeTrack(const NodeAnimationTrack& track, const Tolerance& tolerance)
+    {
+        size_t count = track.getNumKeyFrames();
+        OgreAssert(count > 0, "Track has no keyframes");
+
+        std::vector<Real> times(count);
+        std::vector<Vector3> translates(count), scales(count);
+        std::vector<Quaternion> rotates(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            auto* kf = static_cast<const TransformKeyFrame*>(track.getKeyFrame(i));
+            times[i] = kf->getTime();
+            translates[i] = kf->getTranslate();
+            rotates[i] = kf->getRotation();
+            scales[i] = kf->getScale();
+        }
+
+        compressVectors(times, translates, tolerance.translate, false, mTranslate);
+        compressRotations(times, rotates, tolerance.rotate, mRotate);
+        compressVectors(times, scales, tolerance.scale, true, mScale);
+    }
+    //-----------------------------------------------------------------------
+    void CompressedNodeTrack::compressVectors(const std::vector<Real>& times, const std::vector<Vector3>& values,
+                                              Real tolerance, bool maxNorm, VectorCurve& curve)
+    {
+        auto error = [maxNorm](const Vector3& a, const Vector3& b) -> Real
+        {
+            Vector3 d = a - b;
+            return maxNorm ? std::max({std::abs(d.x), std::abs(d.y), std::abs(d.z)}) : d.length();
+        };
+
+        if (std::ranges::all_of(values, [&](const Vector3& v) { return error(v, values.front()) <= tolerance; }))
+        {
+            // constant, stored exactly
+            curve.times = {times.front()};
+            curve.x = curve.y = curve.z = {0};
+            curve.base = values.front();
+            curve.step = Vector3::ZERO;
+            return;
+        }
+
+        Vector3 minimum = values.front(), maximum = values.front();
+        for (const Vector3& v : values)
+        {
+            minimum.makeFloor(v);
+            maximum.makeCeil(v);
+        }
+
+        // quantise all keys first, so the reduction sees the decoded values
+        VectorCurve all;
+        all.base = minimum;
+        all.step = (maximum - minimum) / 65535;
+        std::vector<Vector3> decoded;
+        for (size_t i = 0; i < values.size(); ++i)
+        {
+            all.x.push_back(quantise(values[i].x, all.base.x, all.step.x));
+            all.y.push_back(quantise(values[i].y, all.base.y, all.step.y));
+            all.z.push_back(quantise(values[i].z, all.base.z, all.step.z));
+            decoded.push_back(all.decode(i));
+        }
+
+        auto fits = [&](size_t first, size_t last)
+        {
+            Real span = times[last] - times[first];
+            if (span <= 0)
+                return false;
+            for (size_t k = first + 1; k < last; ++k)
+            {
+                Real t = (times[k] - times[first]) / span;
+                if (error(decoded[first] + (decoded[last] - decoded[first]) * t, values[k]) > tolerance)
+                    return false;
+            }
+            return true;
+        };
+
+        curve.base = all.base;
+        curve.step = all.step;
+        for (size_t k : reduceKeys(values.size(), fits))
+        {
+            curve.times.push_back(times[k]);
+            curve.x.push_back(all.x[k]);
+            curve.y.push_back(all.y[k]);
+            curve.z.push_back(all.z[k]);
+        }
+    }
+    //-----------------------------------------------------------------------
+    void CompressedNodeTrack::compressRotations(const std::vector<Real>& times, const std::vector<Quaternion>& values,
+                                                Radian tolerance, RotationCurve& curve)
+    {
+        Real maxAngle = tolerance.valueRadians();
+        auto append = [](RotationCurve& c, const uint16 packed[3])
+        {
+            c.a.push_back(packed[0]);
+            c.b.push_back(packed[1]);
+            c.c.push_back(packed[2]);
+        };
+
+        uint16 packed[3];
+        if (std::ranges::all_of(values, [&](const Quaternion& q) { return angleBetween(q, values.front()) <= maxAngle; }))
+        {
+            curve.times = {times.front()};
+            packRotation(values.front(), packed);
+            append(curve, packed);
+            return;
+        }
+
+        RotationCurve all;
+        std::vector<Quaternion> decoded;
+        for (size_t i = 0; i < values.size(); ++i)
+        {
+            packRotation(values[i], packed);
+            append(all, packed);
+            decoded.push_back(all.decode(i));
+        }
+
+        auto fits = [&](size_t first, size_t last)
+        {
+            Real span = times[last] - times[first];
+            if (span <= 0)
+                return false;
+            for (size_t k = first + 1; k < last; ++k)
+            {
+                Real t = (times[k] - times[first]) / span;
+                if (angleBetween(Quaternion::nlerp(t, decoded[first], decoded[last], true), values[k]) > maxAngle)
+                    return false;
+            }
+            return true;
+        };
+
+        for (size_t k : reduceKeys(values.size(), fits))
+        {
+            curve.times.push_back(times[k]);
+            curve.a.push_back(all.a[k]);
+            curve.b.push_back(all.b[k]);
+            curve.c.push_back(all.c[k]);
+        }
+    }
+    //-----------------------------------------------------------------------
+    void CompressedNodeTrack::evaluate(Real timePos, Real length, Vector3& translate, Quaternion& rotate,
+                                       Vector3& scale) const
+    {
+        size_t key1, key2;
+        Real t = locateKeys(mTranslate.times, timePos, length, key1, key2);
+        Vector3 base = mTranslate.decode(key1);
+        translate = t == 0 ? base : base + (mTranslate.decode(key2) - base) * t;
+
+        t = locateKeys(mRotate.times, timePos, length, key1, key2);
+        rotate = t == 0 ? mRotate.decode(key1) : Quaternion::nlerp(t, mRotate.decode(key1), mRotate.decode(key2), true);
+
+        t = locateKeys(mScale.times, timePos, length, key1, key2);
+        base = mScale.decode(key1);
+        scale = t == 0 ? base : base + (mScale.decode(key2) - base) * t;
+    }
+    //-----------------------------------------------------------------------
+    auto CompressedNodeTrack::getKeyTimes() const -> std::vector<Real>
+    {
+        std::vector<Real> times;
+        for (const auto* curveTimes : {&mTranslate.times, &mRotate.times, &mScale.times})
+            times.insert(times.end(), curveTimes->begin(), curveTimes->end());
+        std::ranges::sort(times);
+        times.erase(std::ranges::unique(times).begin(), times.end());
+        return times;
+    }
+    //-----------------------------------------------------------------------
+    auto CompressedNodeTrack::getMemoryUsage() const -> size_t
+    {
+        // times and three 16 bit words per key
+        return sizeof(*this) + getNumKeys() * (sizeof(Real) + 3 * sizeof(uint16));
+    }
+    //-----------------------------------------------------------------------
+    void CompressedNodeTrack::packRotation(const Quaternion& q, uint16 packed[3])
+    {
+        Quaternion n = q;
+        n.normalise();
+        Real c[4] = {n.w, n.x, n.y, n.z};
+
+        size_t largest = 0;
+        for (size_t i = 1; i < 4; ++i)
+            if (std::abs(c[i]) > std::abs(c[largest]))
+                largest = i;
+        // q and -q are the same rotation, make the dropped component positive
+        Real sign = c[largest] < 0 ? -1 : 1;
+
+        // the other components are within +-1/sqrt(2)
+        uint16 values[3];
+        for (size_t i = 0, k = 0; i < 4; ++i)
+        {
+            if (i == largest)
+                continue;
+            Real v = std::clamp(c[i] * sign * Math::Sqrt(2), Real(-1), Real(1));
+            values[k++] = static_cast<uint16>(std::lround((v + 1) * 0.5f * 0x7FFF));
+        }
+        packed[0] = static_cast<uint16>(values[0] | ((largest & 1) << 15));
+        packed[1] = static_cast<uint16>(values[1] | ((largest >> 1) << 15));
+        packed[2] = values[2];
+    }
+    //-----------------------------------------------------------------------
+    auto CompressedNodeTrack::unpackRotation(const uint16 packed[3]) -> Quaternion
+    {
+        size_t largest = (packed[0] >> 15) | ((packed[1] >> 15) << 1);
+        Real c[4];
+        Real sum = 0;
+        for (size_t i = 0, k = 0; i < 4; ++i)
+        {
+            if (i == largest)
+                continue;
+            Real v = (Real(packed[k++] & 0x7FFF) / 0x7FFF * 2 - 1) / Math::Sqrt(2);
+            c[i] = v;
+            sum += v * v;
+        }
+        c[largest] = std::sqrt(std::max(Real(1) - sum, Real(0)));
+        return {c[0], c[1], c[2], c[3]};
+    }
+}
@@ -85,7 +85,10 @@ namespace Ogre {
         {
             for (auto mController : mControllers)
             {
-                mController->update();
+                if (mDeferTextureUpdates && mController->_isDeferrable())
+                    mController->_holdInput();
+                else
+                    mController->update();
             }
             mLastFrameNumber = thisFrameNumber;
         }
@@ -0,0 +1,376 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+module;
+
+#include <cstddef>
+
+module Ogre.Core;
+
+import :AxisAlignedBox;
+import :ConvexPolytope;
+import :Frustum;
+import :OptimisedUtil;
+import :Plane;
+import :Vector;
+
+import <algorithm>;
+import <array>;
+import <initializer_list>;
+import <utility>;
+
+namespace Ogre
+{
+    //-----------------------------------------------------------------------
+    auto ConvexPolytope::Storage::beginFace() noexcept -> bool
+    {
+        if (numFaces == MAX_FACES)
+            return false;
+        faces[numFaces] = Face{static_cast<uint16>(numVertices), 0};
+        return true;
+    }
+    //-----------------------------------------------------------------------
+    auto ConvexPolytope::Storage::addVertex(const Vector3& v) noexcept -> bool
+    {
+        Face& face = faces[numFaces];
+        if (face.count > 0 && getVertex(numVertices - 1).positionEquals(v))
+            return true;
+        if (numVertices == MAX_VERTICES)
+            return false;
+
+        x[numVertices] = v.x;
+        y[numVertices] = v.y;
+        z[numVertices] = v.z;
+        ++numVertices;
+        ++face.count;
+        return true;
+    }
+    //-----------------------------------------------------------------------
+    void ConvexPolytope::Storage::endFace() noexcept
+    {
+        Face& face = faces[numFaces];
+        // the last vertex may repeat the first
+        if (face.count > 1 && getVertex(face.first).positionEquals(getVertex(numVertices - 1)))
+        {
+            --face.count;
+            --numVertices;
+        }
+
+        if (face.count < 3)
+            numVertices = face.first;
+        else
+            ++numFaces;
+    }
+    //-----------------------------------------------------------------------
+    auto ConvexPolytope::Storage::addFace(std::initializer_list<Vector3> vertices) noexcept -> bool
+    {
+        if (!beginFace())
+            return false;
+        for (const Vector3& v : vertices)
+            if (!addVertex(v))
+                return false;
+        endFace();
+        return true;
+    }
+    //-----------------------------------------------------------------------
+    auto ConvexPolytope::Storage::getNormal(size_t face) const noexcept -> Vector3
+    {
+        // used method: Newell, over all vertices as the faces may be slightly bent
+        Vector3 normal{0, 0, 0};
+        const Face& f = faces[face];
+        for (size_t i = 0; i < f.count; ++i)
+        {
+            Vector3 a = getVertex(f.first + i);
+            Vector3 b = getVertex(f.first + (i + 1) % f.count);
+            normal.x += (a.y - b.y) * (a.z + b.z);
+            normal.y += (a.z - b.z) * (a.x + b.x);
+            normal.z += (a.x - b.x) * (a.y + b.y);
+        }
+        return normal;
+    }
+    //-----------------------------------------------------------------------
+    void ConvexPolytope::define(const Frustum& frustum)
+    {
+        // ordering of the points:
+        // near (0-3), far (4-7); each (top-right, top-left, bottom-left, bottom-right)
+        const Vector3* pts = frustum.getWorldSpaceCorners();
+
+        Storage& storage = current();
+        storage.clear();
+        // near, far, left, right, bottom, top; all ccw, see ConvexBody::define
+        storage.addFace({pts[0], pts[1], pts[2], pts[3]});
+        storage.addFace({pts[5], pts[4], pts[7], pts[6]});
+        storage.addFace({pts[5], pts[6], pts[2], pts[1]});
+        storage.addFace({pts[4], pts[0], pts[3], pts[7]});
+        storage.addFace({pts[6], pts[7], pts[3], pts[2]});
+        storage.addFace({pts[4], pts[5], pts[1], pts[0]});
+    }
+    //-----------------------------------------------------------------------
+    void ConvexPolytope::define(const AxisAlignedBox& aab)
+    {
+        // ordering of the AAB points:
+        //      1-----2
+        //     /|    /|
+        //    / |   / |
+        //   5-----4  |
+        //   |  0--|--3
+        //   | /   | /
+        //   |/    |/
+        //   6-----7
+        const AxisAlignedBox::Corners pts = aab.getAllCorners();
+
+        Storage& storage = current();
+        storage.clear();
+        // far, right, near, left, bottom, top; all ccw
+        storage.addFace({pts[0], pts[1], pts[2], pts[3]});
+        storage.addFace({pts[3], pts[2], pts[4], pts[7]});
+        storage.addFace({pts[7], pts[4], pts[5], pts[6]});
+        storage.addFace({pts[6], pts[5], pts[1], pts[0]});
+        storage.addFace({pts[0], pts[3], pts[7], pts[6]});
+        storage.addFace({pts[4], pts[2], pts[1], pts[5]});
+    }
+    //-----------------------------------------------------------------------
+    void ConvexPolytope::clip(const Frustum& frustum)
+    {
+        // frustum planes face inwards, so the positive side is kept
+        for (unsigned short i = 0; i < 6; ++i)
+            clip(frustum.getFrustumPlane(i), false);
+    }
+    //-----------------------------------------------------------------------
+    void ConvexPolytope::clip(const AxisAlignedBox& aab)
+    {
+        if (!aab.isFinite())
+            return;
+
+        const Vector3& min = aab.getMinimum();
+        const Vector3& max = aab.getMaximum();
+        clip(Plane::Redefine(Vector3::UNIT_Z, max));
+        clip(Plane::Redefine(Vector3::NEGATIVE_UNIT_Z, min));
+        clip(Plane::Redefine(Vector3::NEGATIVE_UNIT_X, min));
+        clip(Plane::Redefine(Vector3::UNIT_X, max));
+        clip(Plane::Redefine(Vector3::NEGATIVE_UNIT_Y, min));
+        clip(Plane::Redefine(Vector3::UNIT_Y, max));
+    }
+    //-----------------------------------------------------------------------
+    void ConvexPolytope::clip(const Plane& plane, bool keepNegative)
+    {
+        Storage& src = current();
+        if (src.numFaces == 0)
+            return;
+
+        // the clipped side is the positive one of the packed plane
+        float sign = keepNegative ? 1.0f : -1.0f;
+        const float packedPlane[4] = {sign * plane.normal.x, sign * plane.normal.y, sign * plane.normal.z,
+                                      sign * plane.d};
+        OptimisedUtil::getImplementation()->calculatePlaneDistances(
+            packedPlane, src.x.data(), src.y.data(), src.z.data(), mDistances.data(), src.numVertices);
+
+        auto [minIt, maxIt] = std::minmax_element(mDistances.begin(), mDistances.begin() + src.numVertices);
+        if (*maxIt <= 0)
+            return;
+        if (*minIt > 0)
+        {
+            src.clear();
+            return;
+        }
+
+        // the edges of the hole left by the clipped faces, each running from where a face
+        // enters the kept side to where the next one does
+        std::array<std::pair<Vector3, Vector3>, MAX_FACES> holeEdges;
+        size_t numHoleEdges = 0;
+
+        // Sutherland-Hodgman for every face; a result which does not fit leaves the body unclipped
+        Storage& dst = next();
+        dst.clear();
+        for (size_t f = 0; f < src.numFaces; ++f)
+        {
+            const Face& face = src.faces[f];
+            if (!dst.beginFace())
+                return;
+
+            Vector3 entry{}, exit{};
+            bool hasEntry = false, hasExit = false;
+            for (size_t i = 0; i < face.count; ++i)
+            {
+                size_t a = face.first + i;
+                size_t b = face.first + (i + 1) % face.count;
+                bool insideA = mDistances[a] <= 0;
+                bool insideB = mDistances[b] <= 0;
+
+                if (insideA && !dst.addVertex(src.getVertex(a)))
+                    return;
+                if (insideA == insideB)
+                    continue;
+
+                // interpolate from the inside vertex, so that the face on the other side of
+                // the edge gets exactly the same point
+                size_t in = insideA ? a : b;
+                size_t out = insideA ? b : a;
+                float t = mDistances[in] / (mDistances[in] - mDistances[out]);
+                Vector3 point = src.getVertex(in) + (src.getVertex(out) - src.getVertex(in)) * t;
+                if (!dst.addVertex(point))
+                    return;
+                (insideA ? exit : entry) = point;
+                (insideA ? hasExit : hasEntry) = true;
+            }
+            dst.endFace();
+
+            if (hasEntry && hasExit && !entry.positionEquals(exit))
+                holeEdges[numHoleEdges++] = {exit, entry};
+        }
+
+        // close the hole, chaining the edges
+        if (numHoleEdges >= 3)
+        {
+            if (!dst.beginFace())
+                return;
+
+            const Vector3 start = holeEdges[0].first;
+            Vector3 last = holeEdges[0].second;
+            holeEdges[0] = holeEdges[--numHoleEdges];
+            if (!dst.addVertex(start))
+                return;
+            while (!last.positionEquals(start))
+            {
+                if (!dst.addVertex(last))
+                    return;
+                auto it = std::find_if(holeEdges.begin(), holeEdges.begin() + numHoleEdges,
+                                       [&last](const auto& edge) { return edge.first.positionEquals(last); });
+                // degenerated
+                if (it == holeEdges.begin() + numHoleEdges)
+                    break;
+                last = it->second;
+                *it = holeEdges[--numHoleEdges];
+            }
+
+            size_t capFace = dst.numFaces;
+            dst.endFace();
+            // the edges were chained one way or the other, the new face has to face the plane normal
+            if (dst.numFaces > capFace &&
+                dst.getNormal(capFace).dotProduct(Vector3{packedPlane[0], packedPlane[1], packedPlane[2]}) < 0)
+            {
+                const Face& cap = dst.faces[capFace];
+                std::reverse(dst.x.begin() + cap.first, dst.x.begin() + cap.first + cap.count);
+                std::reverse(dst.y.begin() + cap.first, dst.y.begin() + cap.first + cap.count);
+                std::reverse(dst.z.begin() + cap.first, dst.z.begin() + cap.first + cap.count);
+            }
+        }
+
+        swapStorage();
+    }
+    //-----------------------------------------------------------------------
+    void ConvexPolytope::extend(const Vector3& point)
+    {
+        // Drop all faces facing the point. The edges of the dropped faces which no other
+        // dropped face shares form triangles with the point.
+        const Storage& src = current();
+        if (src.numFaces == 0)
+            return;
+
+        std::array<bool, MAX_FACES> facing;
+        bool anyFacing = false;
+        for (size_t f = 0; f < src.numFaces; ++f)
+        {
+            facing[f] = src.getNormal(f).dotProduct(point - src.getVertex(src.faces[f].first)) >= 0;
+            anyFacing |= facing[f];
+        }
+        // the point lies inside
+        if (!anyFacing)
+            return;
+
+        auto hasEdge = [&src, &facing](const Vector3& a, const Vector3& b)
+        {
+            for (size_t f = 0; f < src.numFaces; ++f)
+            {
+                if (!facing[f])
+                    continue;
+                const Face& face = src.faces[f];
+                for (size_t i = 0; i < face.count; ++i)
+                {
+                    if (src.getVertex(face.first + i).positionEquals(a) &&
+                        src.getVertex(face.first + (i + 1) % face.count).positionEquals(b))
+                        return true;
+                }
+            }
+            return false;
+        };
+
+        Storage& dst = next();
+        dst.clear();
+        bool fits = true;
+        for (size_t f = 0; f < src.numFaces && fits; ++f)
+        {
+            const Face& face = src.faces[f];
+            if (!facing[f])
+            {
+                fits = dst.beginFace();
+                for (size_t i = 0; i < face.count && fits; ++i)
+                    fits = dst.addVertex(src.getVertex(face.first + i));
+                if (fits)
+                    dst.endFace();
+                continue;
+            }
+
+            for (size_t i = 0; i < face.count && fits; ++i)
+            {
+                Vector3 a = src.getVertex(face.first + i);
+                Vector3 b = src.getVertex(face.first + (i + 1) % face.count);
+                // ccw like the dropped face
+                if (!hasEdge(b, a))
+                    fits = dst.addFace({a, b, point});
+            }
+        }
+
+        if (!fits)
+        {
+            AxisAlignedBox box = getAABB();
+            box.merge(point);
+            define(box);
+            return;
+        }
+        swapStorage();
+    }
+    //-----------------------------------------------------------------------
+    void ConvexPolytope::reset()
+    {
+        current().clear();
+    }
+    //-----------------------------------------------------------------------
+    auto ConvexPolytope::getAABB() const -> AxisAlignedBox
+    {
+        const Storage& storage = current();
+        if (storage.numVertices == 0)
+            return AxisAlignedBox::BOX_NULL;
+
+        auto [minX, maxX] = std::minmax_element(storage.x.begin(), storage.x.begin() + storage.numVertices);
+        auto [minY, maxY] = std::minmax_element(storage.y.begin(), storage.y.begin() + storage.numVertices);
+        auto [minZ, maxZ] = std::minmax_element(storage.z.begin(), storage.z.begin() + storage.numVertices);
+        AxisAlignedBox box;
+        box.setExtents(Vector3{*minX, *minY, *minZ}, Vector3{*maxX, *maxY, *maxZ});
+        return box;
+    }
+}
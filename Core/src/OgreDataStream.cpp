@@ -30,6 +30,10 @@ module;
 #include <cassert>
 #include <cstdio>
 #include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 module Ogre.Core;
 
@@ -42,7 +46,9 @@ import :SharedPtr;
 import :String;
 
 import <algorithm>;
+import <filesystem>;
 import <fstream>;
+import <memory>;
 import <string>;
 
 namespace Ogre {
@@ -485,6 +491,55 @@ namespace Ogre {
     }
     //-----------------------------------------------------------------------
     //-----------------------------------------------------------------------
+    auto MemoryMappedDataStream::open(std::string_view name, const std::filesystem::path& path)
+        -> SharedPtr<MemoryMappedDataStream>
+    {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            return nullptr;
+
+        // read the file right away where possible, as streams are usually opened
+        // while preparing a resource on a background thread and parsed later on
+        int flags = MAP_PRIVATE;
+#ifdef MAP_POPULATE
+        flags |= MAP_POPULATE;
+#endif
+
+        struct stat st;
+        void* mapping = MAP_FAILED;
+        // empty files can not be mapped
+        if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0)
+            mapping = mmap(nullptr, st.st_size, PROT_READ | PROT_WRITE, flags, fd, 0);
+        // the mapping keeps the file referenced
+        ::close(fd);
+
+        if (mapping == MAP_FAILED)
+            return nullptr;
+
+        return std::make_shared<MemoryMappedDataStream>(name, mapping, size_t(st.st_size));
+    }
+    //-----------------------------------------------------------------------
+    MemoryMappedDataStream::MemoryMappedDataStream(std::string_view name, void* mapping, size_t size)
+        : MemoryDataStream(name, mapping, size, false, true), mMapping(mapping), mMappingSize(size)
+    {
+    }
+    //-----------------------------------------------------------------------
+    MemoryMappedDataStream::~MemoryMappedDataStream()
+    {
+        close();
+    }
+    //-----------------------------------------------------------------------
+    void MemoryMappedDataStream::close()
+    {
+        MemoryDataStream::close();
+        if (mMapping)
+        {
+            munmap(mMapping, mMappingSize);
+            mMapping = nullptr;
+        }
+    }
+    //-----------------------------------------------------------------------
+    //-----------------------------------------------------------------------
     FileStreamDataStream::FileStreamDataStream(std::ifstream* s, bool freeOnClose)
         : DataStream(), mInStream(s), mFStreamRO(s), mFStream(nullptr), mFreeOnClose(freeOnClose)
     {
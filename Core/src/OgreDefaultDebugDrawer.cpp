@@ -59,6 +59,7 @@ void DefaultDebugDrawer::beginLines()
             p->setVertexColourTracking(TrackVertexColourEnum::AMBIENT);
         }
         mLines.setBufferUsage(HardwareBufferUsage::CPU_TO_GPU);
+        mLines.setStreaming(true);
         mLines.begin(mat, RenderOperation::OperationType::LINE_LIST);
     }
     else if (mLines.getCurrentVertexCount() == 0)
@@ -114,6 +115,7 @@ void DefaultDebugDrawer::drawAxes(const Affine3& pose, float size)
         }
 
         mAxes.setBufferUsage(HardwareBufferUsage::CPU_TO_GPU);
+        mAxes.setStreaming(true);
         mAxes.begin(mat);
     }
     else if (mAxes.getCurrentVertexCount() == 0)
@@ -29,6 +29,7 @@ module Ogre.Core;
 
 import :AxisAlignedBox;
 import :MovableObject;
+import :Platform;
 import :PlaneBoundedVolume;
 import :Prerequisites;
 import :Ray;
@@ -37,6 +38,7 @@ import :SceneManager;
 import :SceneQuery;
 import :Sphere;
 
+import <algorithm>;
 import <map>;
 import <set>;
 import <utility>;
@@ -54,75 +56,118 @@ namespace Ogre {
     DefaultIntersectionSceneQuery::~DefaultIntersectionSceneQuery()
     = default;
     //---------------------------------------------------------------------
-    void DefaultIntersectionSceneQuery::execute(IntersectionSceneQueryListener* listener)
+    void DefaultIntersectionSceneQuery::gatherCandidates()
     {
+        mCandidates.clear();
+        mCandidateIndices.clear();
+
         // Iterate over all movable types
-        const auto& factories = Root::getSingleton().getMovableObjectFactories();
-        auto factIt = factories.begin();
-        while(factIt != factories.end())
+        for(const auto& factIt : Root::getSingleton().getMovableObjectFactories())
         {
-            const auto& objsA = mParentSceneMgr->getMovableObjects((factIt++)->first);
-            auto objItA = objsA.begin();
-            while (objItA != objsA.end())
+            for (const auto& [key, a] : mParentSceneMgr->getMovableObjects(factIt.first))
             {
-                MovableObject* a = (objItA++)->second;
                 // skip entire section if type doesn't match
                 if (!(a->getTypeFlags() & mQueryTypeMask))
                     break;
 
-                // Skip if a does not pass the mask
-                if (!(a->getQueryFlags() & mQueryMask) || !a->isInScene())
+                if (!std::to_underlying(a->getQueryFlags() & mQueryMask) || !a->isInScene())
                     continue;
 
-                // Check against later objects in the same group
-                auto objItB = objItA;
-                while (objItB != objsA.end())
-                {
-                    MovableObject* b = (objItB++)->second;
+                mCandidateIndices.emplace(a, static_cast<uint32>(mCandidates.size()));
+                mCandidates.push_back(a);
+            }
+        }
+    }
+    //---------------------------------------------------------------------
+    void DefaultIntersectionSceneQuery::sortSweep()
+    {
+        auto minX = [](const SweepEntry& e) { return e.box->getMinimum().x; };
+        auto less = [&](const SweepEntry& l, const SweepEntry& r) { return minX(l) < minX(r); };
 
-                    // Apply mask to b (both must pass)
-                    if (std::to_underlying(b->getQueryFlags() & mQueryMask) && b->isInScene())
-                    {
-                        const AxisAlignedBox& box1 = a->getWorldBoundingBox();
-                        const AxisAlignedBox& box2 = b->getWorldBoundingBox();
+        // start from the order of the last execution, new objects are sorted separately
+        std::vector<uint8> inSweep(mCandidates.size(), 0);
+        mSweep.clear();
+        for (auto* o : mSweepOrder)
+        {
+            auto it = mCandidateIndices.find(o);
+            if (it == mCandidateIndices.end() || inSweep[it->second])
+                continue;
+            const AxisAlignedBox& box = o->getWorldBoundingBox();
+            if (!box.isFinite())
+                continue;
+            inSweep[it->second] = 1;
+            mSweep.push_back({&box, it->second});
+        }
+        size_t numRetained = mSweep.size();
 
-                        if (box1.intersects(box2))
-                        {
-                            if (!listener->queryResult(a, b)) return;
-                        }
-                    }
-                }
-                // Check  against later groups
-                auto factItLater = factIt;
-                while (factItLater != factories.end())
-                {
-                    for (const auto& [key, c] :
-                         mParentSceneMgr->getMovableObjects((factItLater++)->first))
-                    {
-                        // skip entire section if type doesn't match
-                        if (!(c->getTypeFlags() & mQueryTypeMask))
-                            break;
+        for (uint32 i = 0; i < mCandidates.size(); ++i)
+        {
+            const AxisAlignedBox& box = mCandidates[i]->getWorldBoundingBox();
+            if (!inSweep[i] && box.isFinite())
+                mSweep.push_back({&box, i});
+        }
 
-                        // Apply mask to c (both must pass)
-                        if (std::to_underlying(c->getQueryFlags() & mQueryMask) && c->isInScene())
-                        {
-                            const AxisAlignedBox& box1 = a->getWorldBoundingBox();
-                            const AxisAlignedBox& box2 = c->getWorldBoundingBox();
+        // insertion sort is linear for a nearly sorted sequence, give up if it is not
+        size_t moves = 0, maxMoves = 4 * numRetained + 64;
+        for (size_t i = 1; i < numRetained && moves <= maxMoves; ++i)
+        {
+            SweepEntry e = mSweep[i];
+            size_t j = i;
+            for (; j > 0 && less(e, mSweep[j - 1]); --j)
+                mSweep[j] = mSweep[j - 1];
+            mSweep[j] = e;
+            moves += i - j;
+        }
+        if (moves > maxMoves)
+            std::sort(mSweep.begin(), mSweep.begin() + numRetained, less);
 
-                            if (box1.intersects(box2))
-                            {
-                                if (!listener->queryResult(a, c)) return;
-                            }
-                        }
-                    }
+        std::sort(mSweep.begin() + numRetained, mSweep.end(), less);
+        std::inplace_merge(mSweep.begin(), mSweep.begin() + numRetained, mSweep.end(), less);
 
-                }
+        mSweepOrder.clear();
+        for (const auto& e : mSweep)
+            mSweepOrder.push_back(mCandidates[e.index]);
+    }
+    //---------------------------------------------------------------------
+    void DefaultIntersectionSceneQuery::execute(IntersectionSceneQueryListener* listener)
+    {
+        gatherCandidates();
+        sortSweep();
 
-            }
+        mPairs.clear();
+        auto addPair = [this](uint32 a, uint32 b) { mPairs.emplace_back(std::min(a, b), std::max(a, b)); };
 
+        // finite boxes can only overlap while their x ranges do
+        for (size_t i = 0; i < mSweep.size(); ++i)
+        {
+            const AxisAlignedBox& box1 = *mSweep[i].box;
+            for (size_t j = i + 1; j < mSweep.size() && mSweep[j].box->getMinimum().x <= box1.getMaximum().x; ++j)
+            {
+                if (box1.intersects(*mSweep[j].box))
+                    addPair(mSweep[i].index, mSweep[j].index);
+            }
+        }
 
+        // infinite boxes overlap everything but null boxes
+        for (uint32 a = 0; a < mCandidates.size(); ++a)
+        {
+            if (!mCandidates[a]->getWorldBoundingBox().isInfinite())
+                continue;
+            for (uint32 b = 0; b < mCandidates.size(); ++b)
+            {
+                const AxisAlignedBox& box2 = mCandidates[b]->getWorldBoundingBox();
+                if (b == a || box2.isNull() || (box2.isInfinite() && b < a))
+                    continue;
+                addPair(a, b);
+            }
         }
 
+        // report in the order of a pairwise comparison of the candidates
+        std::sort(mPairs.begin(), mPairs.end());
+        for (auto [a, b] : mPairs)
+        {
+            if (!listener->queryResult(mCandidates[a], mCandidates[b])) return;
+        }
     }
     //---------------------------------------------------------------------
     DefaultAxisAlignedBoxSceneQuery::
@@ -185,8 +230,8 @@ namespace Ogre {
 
                 if (std::to_underlying(a->getQueryFlags() & mQueryMask) && a->isInScene())
                 {
-                    // Do ray / box test
-                    std::pair<bool, Real> result = mRay.intersects(a->getWorldBoundingBox());
+                    // Do ray / box test, or against the mesh if precise
+                    std::pair<bool, Real> result = intersectsObject(a);
 
                     if (result.first)
                     {
@@ -198,6 +243,43 @@ namespace Ogre {
 
     }
     //---------------------------------------------------------------------
+    DefaultRayBatchSceneQuery::
+    DefaultRayBatchSceneQuery(SceneManager* creator) : RayBatchSceneQuery(creator)
+    {
+        // No world geometry results supported
+        mSupportedWorldFragments.insert(SceneQuery::WorldFragmentType::NONE);
+    }
+    //---------------------------------------------------------------------
+    DefaultRayBatchSceneQuery::~DefaultRayBatchSceneQuery()
+    = default;
+    //---------------------------------------------------------------------
+    void DefaultRayBatchSceneQuery::execute(RayBatchSceneQueryListener* listener)
+    {
+        // One pass over the objects, each tested against all rays
+        for(const auto& factIt : Root::getSingleton().getMovableObjectFactories())
+        {
+            for (const auto& [key, a] : mParentSceneMgr->getMovableObjects(factIt.first))
+            {
+                // skip whole group if type doesn't match
+                if (!(a->getTypeFlags() & mQueryTypeMask))
+                    break;
+
+                if (!std::to_underlying(a->getQueryFlags() & mQueryMask) || !a->isInScene())
+                    continue;
+
+                const AxisAlignedBox& box = a->getWorldBoundingBox();
+                for (size_t i = 0; i < mRays.size(); ++i)
+                {
+                    std::pair<bool, Real> result = mRays[i].intersects(box);
+                    if (result.first)
+                    {
+                        if (!listener->queryResult(i, a, result.second)) return;
+                    }
+                }
+            }
+        }
+    }
+    //---------------------------------------------------------------------
     DefaultSphereSceneQuery::
     DefaultSphereSceneQuery(SceneManager* creator) : SphereSceneQuery(creator)
     {
@@ -38,12 +38,15 @@ import :LogManager;
 import :Prerequisites;
 import :RenderSystem;
 import :Root;
+import :TaskScheduler;
 import :WorkQueue;
 
 import <condition_variable>;
+import <functional>;
+import <memory>;
 import <mutex>;
 import <thread>;
-import <vector>;
+import <utility>;
 
 namespace Ogre
 {
@@ -70,8 +73,6 @@ namespace Ogre
 
         mShuttingDown = false;
 
-        mWorkerFunc = new WorkerFunc{this};
-
         LogManager::getSingleton().stream() <<
             "DefaultWorkQueue('" << mName << "') initialising on thread " <<
             std::this_thread::get_id()
@@ -80,12 +81,44 @@ namespace Ogre
         if (mWorkerRenderSystemAccess)
             Root::getSingleton().getRenderSystem()->preExtraThreadsStarted();
 
+        auto threadStarted = [this]()
+        {
+            LogManager::getSingleton().stream() <<
+                "DefaultWorkQueue('" << getName() << "') - thread "
+                << std::this_thread::get_id() << " starting.";
+
+            // Initialise the thread for RS if necessary
+            if (mWorkerRenderSystemAccess)
+            {
+                Root::getSingleton().getRenderSystem()->registerThread();
+                notifyThreadRegistered();
+            }
+        };
+        auto threadStopped = [this]()
+        {
+            if (mWorkerRenderSystemAccess)
+                Root::getSingleton().getRenderSystem()->unregisterThread();
+
+            LogManager::getSingleton().stream() <<
+                "DefaultWorkQueue('" << getName() << "') - thread "
+                << std::this_thread::get_id() << " stopped.";
+        };
+
         mNumThreadsRegisteredWithRS = 0;
-        for (size_t i = 0; i < mWorkerThreadCount; ++i)
+        mScheduler = std::make_unique<TaskScheduler>(mWorkerThreadCount, threadStarted, threadStopped);
+
+        // pick up what was queued before startup
+        size_t queued = 0;
+        {
+            std::unique_lock<std::recursive_mutex> ogrenameLock(mRequestMutex);
+            queued = mRequestQueue.size() + mTaskQueue.size();
+        }
         {
-            auto* t = new std::thread(*mWorkerFunc);
-            mWorkers.push_back(t);
+            std::unique_lock<std::recursive_mutex> ogrenameLock(mIdleMutex);
+            queued += !mIdleRequestQueue.empty();
         }
+        for (size_t i = 0; i < queued; ++i)
+            notifyWorkers();
 
         if (mWorkerRenderSystemAccess)
         {
@@ -126,32 +159,63 @@ namespace Ogre
         // wake all threads (they should check shutting down as first thing after wait)
         mRequestCondition.notify_all();
 
-        // all our threads should have been woken now, so join
-        for (auto & mWorker : mWorkers)
-        {
-            mWorker->join();
-            delete mWorker;
-        }
-        mWorkers.clear();
-
-        delete mWorkerFunc;
-        mWorkerFunc = nullptr;
+        // joins the workers; requests which were not picked up by then stay aborted
+        mScheduler.reset();
+        // helpers of a finished parallelFor may still be queued, they have nothing left to do
+        mTaskQueue.clear();
 
         mIsRunning = false;
     }
     //---------------------------------------------------------------------
     void DefaultWorkQueue::notifyWorkers()
     {
-        // wake up waiting thread
+        // every notification stands for one request, the task picks whichever is next
+        if (mScheduler)
+            mScheduler->scheduleBackground([this]() { _processNextRequest(); });
+
+        // wake up threads helping through _threadMain
         mRequestCondition.notify_one();
     }
+    //---------------------------------------------------------------------
+    void DefaultWorkQueue::addTask(std::function<void()> task)
+    {
+        if (!mScheduler || mShuttingDown)
+        {
+            DefaultWorkQueueBase::addTask(std::move(task));
+            return;
+        }
+
+        mScheduler->schedule(std::move(task));
+    }
+    //---------------------------------------------------------------------
+    void DefaultWorkQueue::parallelFor(size_t count, const std::function<void(size_t)>& func)
+    {
+        if (!mScheduler || mShuttingDown || mWorkerThreadCount == 0 || count < 2)
+        {
+            WorkQueue::parallelFor(count, func);
+            return;
+        }
+
+        mScheduler->parallelFor(count, func);
+    }
+    //---------------------------------------------------------------------
+    void DefaultWorkQueue::runTaskGraph(TaskGraph& graph)
+    {
+        if (!mScheduler || mShuttingDown || mWorkerThreadCount == 0)
+        {
+            WorkQueue::runTaskGraph(graph);
+            return;
+        }
+
+        mScheduler->run(graph);
+    }
 
     //---------------------------------------------------------------------
     void DefaultWorkQueue::waitForNextRequest()
     {
         // Lock; note that wait will free the lock
         std::unique_lock<std::recursive_mutex> queueLock(mRequestMutex);
-        if (mRequestQueue.empty())
+        if (mRequestQueue.empty() && mTaskQueue.empty())
         {
             // frees lock and suspends the thread
             mRequestCondition.wait(queueLock);
@@ -164,28 +228,12 @@ namespace Ogre
     //---------------------------------------------------------------------
     void DefaultWorkQueue::_threadMain()
     {
-        // default worker thread
-        LogManager::getSingleton().stream() << 
-            "DefaultWorkQueue('" << getName() << "')::WorkerFunc - thread " 
-            << std::this_thread::get_id() << " starting.";
-
-        // Initialise the thread for RS if necessary
-        if (mWorkerRenderSystemAccess)
-        {
-            Root::getSingleton().getRenderSystem()->registerThread();
-            notifyThreadRegistered();
-        }
-
         // Spin forever until we're told to shut down
         while (!isShuttingDown())
         {
             waitForNextRequest();
             _processNextRequest();
         }
-
-        LogManager::getSingleton().stream() << 
-            "DefaultWorkQueue('" << getName() << "')::WorkerFunc - thread " 
-            << std::this_thread::get_id() << " stopped.";
     }
 
 }
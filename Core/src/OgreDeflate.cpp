@@ -38,14 +38,21 @@ import :Deflate;
 import :Exception;
 import :FileSystem;
 
+import <algorithm>;
+import <cstring>;
 import <fstream>;
+import <iterator>;
 import <utility>;
+import <vector>;
 
 namespace Ogre
 {
     // memory implementations
     static auto OgreZalloc(void* opaque, size_t items, size_t size) -> void*
     {
+        // the only allocation is the internal state, remember its size to save it
+        if (opaque)
+            *static_cast<size_t*>(opaque) = items * size;
         return (void*)new char[items * size];
     }
     static void OgreZfree(void* opaque, void* address)
@@ -113,11 +120,15 @@ namespace Ogre
         mZStream = new z_stream[1];
         mZStream->zalloc = OgreZalloc;
         mZStream->zfree = OgreZfree;
+        mZStream->opaque = &mStateSize;
         
         if (getAccessMode() == std::to_underlying(READ))
         {
             mTmp = new unsigned char[OGRE_DEFLATE_TMP_SIZE];
             size_t restorePoint = mCompressedStream->tell();
+            mCompressedStart = restorePoint;
+            mInitialAvailIn = mAvailIn;
+            mStatus = Z_OK;
             // read early chunk
             mZStream->next_in = mTmp;
             mZStream->avail_in = static_cast<uint>(mCompressedStream->read(mTmp, getAvailInForSinglePass()));
@@ -153,23 +164,34 @@ namespace Ogre
                 mCompressedStream->seek(restorePoint);
             }               
         }
-        else 
+        // when writing, the temporary file is opened on first use, unless streaming
+    }
+    //---------------------------------------------------------------------
+    void DeflateStream::openTempFile()
+    {
+        if(mTempFileName.empty())
         {
-            if(mTempFileName.empty())
-            {
-                // Write to temp file
-
-                char tmpname[] = "/tmp/ogreXXXXXX";
-                if (mkstemp(tmpname) == -1)
-                    OGRE_EXCEPT(ExceptionCodes::INTERNAL_ERROR, "Temporary file name generation failed.", "DeflateStream::init");
+            // Write to temp file
 
-                mTempFileName = tmpname;
-            }
+            char tmpname[] = "/tmp/ogreXXXXXX";
+            if (mkstemp(tmpname) == -1)
+                OGRE_EXCEPT(ExceptionCodes::INTERNAL_ERROR, "Temporary file name generation failed.", "DeflateStream::init");
 
-            mTmpWriteStream = _openFileStream(mTempFileName, std::ios::binary | std::ios::out);
-            
+            mTempFileName = tmpname;
         }
 
+        mTmpWriteStream = _openFileStream(mTempFileName, std::ios::binary | std::ios::out);
+    }
+    //---------------------------------------------------------------------
+    void DeflateStream::setRestartInterval(size_t interval)
+    {
+        mRestartInterval = interval;
+    }
+    //---------------------------------------------------------------------
+    void DeflateStream::setStreamingWrite(bool streaming)
+    {
+        OgreAssert(!mTmpWriteStream && !mDeflating, "Must be set before writing");
+        mStreamingWrite = streaming;
     }
     //---------------------------------------------------------------------
     void DeflateStream::destroy()
@@ -181,6 +203,7 @@ namespace Ogre
         mZStream = nullptr;
         delete[] mTmp;
         mTmp = nullptr;
+        mRestartPoints.clear();
     }
     //---------------------------------------------------------------------
     DeflateStream::~DeflateStream()
@@ -197,7 +220,7 @@ namespace Ogre
         
         if (getAccessMode() &  std::to_underlying(WRITE))
         {
-            return mTmpWriteStream->read(buf, count);
+            return mTmpWriteStream ? mTmpWriteStream->read(buf, count) : 0;
         }
         else 
         {
@@ -208,10 +231,16 @@ namespace Ogre
             
             size_t newReadUncompressed = 0;
 
-            if (cachereads < count)
+            while (cachereads + newReadUncompressed < count && mStatus == Z_OK)
             {
-                mZStream->avail_out = static_cast<uint>(count - cachereads);
-                mZStream->next_out = (Bytef*)buf + cachereads;
+                // stop at the next restart point, to save the state there
+                size_t pos = mCurrentPos + cachereads + newReadUncompressed;
+                size_t piece = count - cachereads - newReadUncompressed;
+                if (mRestartInterval)
+                    piece = std::min(piece, mRestartInterval - pos % mRestartInterval);
+
+                mZStream->avail_out = static_cast<uint>(piece);
+                mZStream->next_out = (Bytef*)buf + cachereads + newReadUncompressed;
                 
                 while (mZStream->avail_out)
                 {
@@ -222,35 +251,38 @@ namespace Ogre
                         mZStream->next_in = mTmp;
                     }
                     
-                    if (mZStream->avail_in || mZStream->avail_out)
+                    int availpre = mZStream->avail_out;
+                    mStatus = inflate(mZStream, Z_SYNC_FLUSH);
+                    size_t readUncompressed = availpre - mZStream->avail_out;
+                    newReadUncompressed += readUncompressed;
+                    if (mStatus != Z_OK)
                     {
-                        int availpre = mZStream->avail_out;
-                        mStatus = inflate(mZStream, Z_SYNC_FLUSH);
-                        size_t readUncompressed = availpre - mZStream->avail_out;
-                        newReadUncompressed += readUncompressed;
-                        if (mStatus != Z_OK)
+                        // End of data, or error
+                        if (mStatus != Z_STREAM_END)
+                        {
+                            mCompressedStream->seek(restorePoint);
+                            OGRE_EXCEPT(ExceptionCodes::INVALID_STATE, "Error in compressed stream");
+                        }
+                        else 
                         {
-                            // End of data, or error
-                            if (mStatus != Z_STREAM_END)
-                            {
-                                mCompressedStream->seek(restorePoint);
-                                OGRE_EXCEPT(ExceptionCodes::INVALID_STATE, "Error in compressed stream");
-                            }
-                            else 
-                            {
-                                // back up the stream so that it can be used from the end onwards                                                   
-                                long unusedCompressed = mZStream->avail_in;
-                                mCompressedStream->skip(-unusedCompressed);
-                            }
-
-                            break;
+                            // back up the stream so that it can be used from the end onwards                                                   
+                            long unusedCompressed = mZStream->avail_in;
+                            mCompressedStream->skip(-unusedCompressed);
                         }
+
+                        break;
                     }
                 }
+
+                pos = mCurrentPos + cachereads + newReadUncompressed;
+                if (mRestartInterval && mStatus == Z_OK && pos % mRestartInterval == 0 &&
+                    (mRestartPoints.empty() || mRestartPoints.back().pos < pos))
+                    addRestartPoint(pos);
+            }
             
-                // Cache the last bytes read not from cache
+            // Cache the last bytes read not from cache
+            if (newReadUncompressed)
                 mReadCache.cacheData((char*)buf + cachereads, newReadUncompressed);
-            }
             
             mCurrentPos += newReadUncompressed + cachereads;
             
@@ -263,13 +295,76 @@ namespace Ogre
         if ((getAccessMode() & std::to_underlying(WRITE)) == 0)
             OGRE_EXCEPT(ExceptionCodes::INVALIDPARAMS,
                         "Not a writable stream", "DeflateStream::write");
-        
+
+        if (mStreamingWrite)
+        {
+            deflateData(buf, count, Z_NO_FLUSH);
+            mCurrentPos += count;
+            return count;
+        }
+
+        if (!mTmpWriteStream)
+            openTempFile();
         return mTmpWriteStream->write(buf, count);
     }
     //---------------------------------------------------------------------
+    void DeflateStream::beginDeflate()
+    {
+        int windowBits = (mStreamType == Deflate) ? -MAX_WBITS : (mStreamType == GZip) ? 16 + MAX_WBITS : MAX_WBITS;
+        if (deflateInit2(mZStream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, windowBits, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+        {
+            destroy();
+            OGRE_EXCEPT(ExceptionCodes::INVALID_STATE, 
+                        "Error initialising deflate compressed stream!",
+                        "DeflateStream::init");
+        }
+        mDeflating = true;
+    }
+    //---------------------------------------------------------------------
+    void DeflateStream::deflateData(const void* buf, size_t count, int flush)
+    {
+        if (!mDeflating)
+            beginDeflate();
+
+        int ret;
+        char out[OGRE_DEFLATE_TMP_SIZE];
+
+        mZStream->avail_in = (uInt)count;
+        mZStream->next_in = (const Bytef*)buf;
+
+        /* run deflate() on input until output buffer not full, finish
+         compression if all of source has been read in */
+        do 
+        {
+            mZStream->avail_out = OGRE_DEFLATE_TMP_SIZE;
+            mZStream->next_out = (Bytef*)out;
+            ret = deflate(mZStream, flush);    /* no bad return value */
+            assert(ret != Z_STREAM_ERROR);  /* state not clobbered */
+            size_t compressed = OGRE_DEFLATE_TMP_SIZE - mZStream->avail_out;
+            mCompressedStream->write(out, compressed);
+        } while (mZStream->avail_out == 0);
+        assert(mZStream->avail_in == 0);     /* all input will be used */
+        assert(flush != Z_FINISH || ret == Z_STREAM_END);        /* stream will be complete */
+        (void)ret;
+
+        if (flush == Z_FINISH)
+        {
+            deflateEnd(mZStream);
+            mDeflating = false;
+        }
+    }
+    //---------------------------------------------------------------------
     void DeflateStream::compressFinal()
     {
+        if (mStreamingWrite)
+        {
+            deflateData(nullptr, 0, Z_FINISH);
+            return;
+        }
+
         // Close temp stream
+        if (!mTmpWriteStream)
+            openTempFile();
         mTmpWriteStream->close();
         mTmpWriteStream.reset();
         
@@ -278,18 +373,10 @@ namespace Ogre
         // around while writing (e.g. to update size blocks) which is not
         // possible when compressing on the fly
         
-        int ret, flush;
+        int flush;
         char in[OGRE_DEFLATE_TMP_SIZE];
-        char out[OGRE_DEFLATE_TMP_SIZE];
         
-        int windowBits = (mStreamType == Deflate) ? -MAX_WBITS : (mStreamType == GZip) ? 16 + MAX_WBITS : MAX_WBITS;
-        if (deflateInit2(mZStream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, windowBits, 8, Z_DEFAULT_STRATEGY) != Z_OK)
-        {
-            destroy();
-            OGRE_EXCEPT(ExceptionCodes::INVALID_STATE, 
-                        "Error initialising deflate compressed stream!",
-                        "DeflateStream::init");
-        }
+        beginDeflate();
         
         std::ifstream inFile;
         inFile.open(mTempFileName.c_str(), std::ios::in | std::ios::binary);
@@ -297,41 +384,101 @@ namespace Ogre
         do 
         {
             inFile.read(in, OGRE_DEFLATE_TMP_SIZE);
-            mZStream->avail_in = (uInt)inFile.gcount();
             if (inFile.bad()) 
             {
                 deflateEnd(mZStream);
+                mDeflating = false;
                 OGRE_EXCEPT(ExceptionCodes::INVALID_STATE, 
                             "Error reading temp uncompressed stream!",
                             "DeflateStream::init");
             }
             flush = inFile.eof() ? Z_FINISH : Z_NO_FLUSH;
-            mZStream->next_in = (Bytef*)in;
-            
-            /* run deflate() on input until output buffer not full, finish
-             compression if all of source has been read in */
-            do 
-            {
-                mZStream->avail_out = OGRE_DEFLATE_TMP_SIZE;
-                mZStream->next_out = (Bytef*)out;
-                ret = deflate(mZStream, flush);    /* no bad return value */
-                assert(ret != Z_STREAM_ERROR);  /* state not clobbered */
-                size_t compressed = OGRE_DEFLATE_TMP_SIZE - mZStream->avail_out;
-                mCompressedStream->write(out, compressed);
-            } while (mZStream->avail_out == 0);
-            assert(mZStream->avail_in == 0);     /* all input will be used */
+            deflateData(in, (size_t)inFile.gcount(), flush);
             
             /* done when last data in file processed */
         } while (flush != Z_FINISH);
-        assert(ret == Z_STREAM_END);        /* stream will be complete */
-                (void)ret;
-        deflateEnd(mZStream);
 
         inFile.close();
         remove(mTempFileName.c_str());
                         
     }
     //---------------------------------------------------------------------
+    void DeflateStream::restartFromBeginning()
+    {
+        mCurrentPos = 0;
+        mAvailIn = mInitialAvailIn;
+        mZStream->next_in = mTmp;
+        mCompressedStream->seek(mCompressedStart);
+        mZStream->avail_in = static_cast<uint>(mCompressedStream->read(mTmp, getAvailInForSinglePass()));
+        inflateReset(mZStream);
+        mStatus = Z_OK;
+        mReadCache.clear();
+    }
+    //---------------------------------------------------------------------
+    void DeflateStream::addRestartPoint(size_t pos)
+    {
+        RestartPoint point;
+        point.pos = pos;
+        point.availIn = mZStream->avail_in;
+        point.compressedPos = mCompressedStream->tell() - mZStream->avail_in;
+        point.remainingIn = mAvailIn;
+
+        // the state holds no pointers, so a plain copy can be restored later on
+        auto stream = reinterpret_cast<const unsigned char*>(mZStream);
+        auto state = static_cast<const unsigned char*>(static_cast<const void*>(mZStream->state));
+        point.state.reserve(sizeof(z_stream) + mStateSize);
+        point.state.assign(stream, stream + sizeof(z_stream));
+        point.state.insert(point.state.end(), state, state + mStateSize);
+
+        mRestartPoints.push_back(std::move(point));
+    }
+    //---------------------------------------------------------------------
+    void DeflateStream::restoreRestartPoint(const RestartPoint& point)
+    {
+        auto state = mZStream->state;
+        std::memcpy(mZStream, point.state.data(), sizeof(z_stream));
+        std::memcpy(static_cast<void*>(state), point.state.data() + sizeof(z_stream), mStateSize);
+        mZStream->state = state;
+
+        // reload the input which was not consumed yet
+        mCompressedStream->seek(point.compressedPos);
+        mZStream->avail_in = static_cast<uint>(mCompressedStream->read(mTmp, point.availIn));
+        mZStream->next_in = mTmp;
+        mAvailIn = point.remainingIn;
+
+        mCurrentPos = point.pos;
+        mStatus = Z_OK;
+        mReadCache.clear();
+    }
+    //---------------------------------------------------------------------
+    void DeflateStream::seekRead(size_t pos)
+    {
+        // where the decompressor is, the cache holds the bytes before it
+        size_t inflated = mCurrentPos + mReadCache.avail();
+
+        // the cache is cleared if it does not contain the position
+        if (pos < mCurrentPos ? mReadCache.rewind(mCurrentPos - pos) : mReadCache.ff(pos - mCurrentPos))
+        {
+            mCurrentPos = pos;
+            return;
+        }
+        mCurrentPos = inflated;
+
+        auto point = std::ranges::upper_bound(mRestartPoints, pos, {}, &RestartPoint::pos);
+        if (point != mRestartPoints.begin() && (pos < inflated || std::prev(point)->pos > inflated))
+            restoreRestartPoint(*std::prev(point));
+        else if (pos < inflated)
+            restartFromBeginning();
+
+        // decompress up to the position
+        char discard[OGRE_DEFLATE_TMP_SIZE];
+        while (mCurrentPos < pos)
+        {
+            if (!read(discard, std::min(pos - mCurrentPos, sizeof(discard))))
+                break;
+        }
+    }
+    //---------------------------------------------------------------------
     void DeflateStream::skip(long count)
     {
         if (mStreamType == Invalid)
@@ -342,32 +489,18 @@ namespace Ogre
         
         if (getAccessMode() & std::to_underlying(WRITE))
         {
+            if (mStreamingWrite)
+                OGRE_EXCEPT(ExceptionCodes::INVALID_CALL, "Can not skip in a streaming deflate stream",
+                            "DeflateStream::skip");
+            if (!mTmpWriteStream)
+                openTempFile();
             mTmpWriteStream->skip(count);
         }
         else 
         {
-            if (count > 0)
-            {
-                if (!mReadCache.ff(count))
-                {
-                    OGRE_EXCEPT(ExceptionCodes::INVALID_STATE, 
-                                "You can only skip within the cache range in a deflate stream.",
-                                "DeflateStream::skip");
-                }
-            }
-            else if (count < 0)
-            {
-                if (!mReadCache.rewind((size_t)(-count)))
-                {
-                    OGRE_EXCEPT(ExceptionCodes::INVALID_STATE, 
-                                "You can only skip within the cache range in a deflate stream.",
-                                "DeflateStream::skip");
-                }
-            }
-        }       
-        mCurrentPos = static_cast<size_t>(static_cast<long>(mCurrentPos) + count);
-        
-        
+            OgreAssert(count >= 0 || size_t(-count) <= mCurrentPos, "Skipping before the start of the stream");
+            seekRead(static_cast<size_t>(static_cast<long>(mCurrentPos) + count));
+        }
     }
     //---------------------------------------------------------------------
     void DeflateStream::seek( size_t pos )
@@ -379,24 +512,21 @@ namespace Ogre
         }
         if (getAccessMode() & std::to_underlying(WRITE))
         {
+            if (mStreamingWrite)
+                OGRE_EXCEPT(ExceptionCodes::INVALID_CALL, "Can not seek in a streaming deflate stream",
+                            "DeflateStream::seek");
+            if (!mTmpWriteStream)
+                openTempFile();
             mTmpWriteStream->seek(pos);
         }
+        else if (pos == 0)
+        {
+            restartFromBeginning();
+        }
         else
         {
-            if (pos == 0)
-            {
-                mCurrentPos = 0;
-                mZStream->next_in = mTmp;
-                mCompressedStream->seek(0);
-                mZStream->avail_in = static_cast<uint>(mCompressedStream->read(mTmp, getAvailInForSinglePass()));
-                inflateReset(mZStream);
-                mReadCache.clear();
-            }
-            else 
-            {
-                skip(pos - tell());
-            }
-        }       
+            seekRead(pos);
+        }
     }
     //---------------------------------------------------------------------
     auto DeflateStream::tell() const -> size_t
@@ -407,7 +537,7 @@ namespace Ogre
         }
         else if(getAccessMode() & std::to_underlying(WRITE))
         {
-            return mTmpWriteStream->tell();
+            return mTmpWriteStream ? mTmpWriteStream->tell() : mCurrentPos;
         }
         else
         {
@@ -419,13 +549,13 @@ namespace Ogre
     auto DeflateStream::eof() const -> bool
     {
         if (getAccessMode() & std::to_underlying(WRITE))
-            return mTmpWriteStream->eof();
+            return mTmpWriteStream ? mTmpWriteStream->eof() : true;
         else 
         {
             if (mStreamType == Invalid)
                 return mCompressedStream->eof();
             else
-                return mCompressedStream->eof() && mStatus == Z_STREAM_END;
+                return mCompressedStream->eof() && mStatus == Z_STREAM_END && !mReadCache.avail();
         }
     }
     //---------------------------------------------------------------------
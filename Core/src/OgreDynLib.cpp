@@ -59,7 +59,7 @@ namespace Ogre {
     = default;
 
     //-----------------------------------------------------------------------
-    void DynLib::load()
+    auto DynLib::getFileName() const -> String
     {
         String name = mName;
 
@@ -68,13 +68,25 @@ namespace Ogre {
         {
             name += std::format(".so.{}.{}", /*OGRE_VERSION_MAJOR*/13, /*OGRE_VERSION_MINOR*/3);
         }
+        return name;
+    }
+
+    //-----------------------------------------------------------------------
+    auto DynLib::open() noexcept -> bool
+    {
+        mInst = (DYNLIB_HANDLE)DYNLIB_LOAD( getFileName().c_str() );
+        return mInst != nullptr;
+    }
+
+    //-----------------------------------------------------------------------
+    void DynLib::load()
+    {
+        String name = getFileName();
 
         // Log library load
         LogManager::getSingleton().logMessage(::std::format("Loading library {}", name));
 
-        mInst = (DYNLIB_HANDLE)DYNLIB_LOAD( name.c_str() );
-
-        if( !mInst )
+        if( !open() )
             OGRE_EXCEPT(
                 ExceptionCodes::INTERNAL_ERROR, 
                 ::std::format("Could not load dynamic library {}"
@@ -28,13 +28,20 @@ THE SOFTWARE.
 module;
 
 #include <cassert>
+#include <cstddef>
 
 module Ogre.Core;
 
 import :DynLib;
 import :DynLibManager;
+import :LogManager;
+import :StartupProfiler;
 
+import <algorithm>;
+import <format>;
+import <future>;
 import <utility>;
+import <vector>;
 
 namespace Ogre
 {
@@ -62,12 +69,46 @@ namespace Ogre
         }
         else
         {
-            auto* pLib = (mLibList[filename] = ::std::make_unique<DynLib>(filename)).get();
+            StartupProfiler::Scope phase{StartupProfiler::PhaseType::PLUGIN_LOAD, filename};
+            auto* pLib = mLibList.emplace(filename, ::std::make_unique<DynLib>(filename)).first->second.get();
             pLib->load();
             return pLib;
         }
     }
     //-----------------------------------------------------------------------
+    void DynLibManager::preload(const StringVector& filenames)
+    {
+        std::vector<::std::unique_ptr<DynLib>> libs;
+        for (const String& filename : filenames)
+        {
+            if (!mLibList.contains(filename) &&
+                std::ranges::none_of(libs, [&](const auto& lib) { return lib->getName() == filename; }))
+                libs.push_back(::std::make_unique<DynLib>(filename));
+        }
+        // nothing to overlap
+        if (libs.size() < 2)
+            return;
+
+        StartupProfiler::Scope phase{StartupProfiler::PhaseType::PLUGIN_LOAD, "preload"};
+        // the log is not thread safe, so the libraries are announced up front
+        for (const auto& lib : libs)
+            LogManager::getSingleton().logMessage(::std::format("Opening library {}", lib->getName()));
+
+        std::vector<std::future<bool>> opened;
+        opened.reserve(libs.size());
+        for (const auto& lib : libs)
+            opened.push_back(std::async(std::launch::async, [pLib = lib.get()] { return pLib->open(); }));
+
+        for (size_t i = 0; i < libs.size(); ++i)
+        {
+            if (opened[i].get())
+            {
+                String name{libs[i]->getName()};
+                mLibList.emplace(std::move(name), std::move(libs[i]));
+            }
+        }
+    }
+    //-----------------------------------------------------------------------
     void DynLibManager::unload(DynLib* lib)
     {
         lib->unload();
@@ -175,7 +175,8 @@ namespace Ogre {
             if (PKM_MAGIC == fileType)
                 return {"pkm"};
 
-            if (KTX_MAGIC == fileType)
+            // KTX2 files start alike, see KTX2Codec
+            if (KTX_MAGIC == fileType && (maxbytes < 7 || memcmp(magicNumberPtr + 4, " 11", 3) == 0))
                 return {"ktx"};
         }
 
@@ -39,14 +39,18 @@ import :HardwareVertexBuffer;
 import :Log;
 import :Math;
 import :OptimisedUtil;
+import :Root;
 import :SharedPtr;
 import :StringConverter;
 import :VertexIndexData;
 
 import <algorithm>;
+import <bit>;
 import <format>;
 import <memory>;
 import <string>;
+import <unordered_map>;
+import <vector>;
 
 namespace Ogre {
 
@@ -192,11 +196,16 @@ namespace Ogre {
         }
 
         // Build triangles and edge list
+        mPositions.resize(mVertexDataList.size());
+        mCommonVertexMap.reserve(mVertexDataList.empty() ? 0 : mVertexDataList.front()->vertexCount);
         for (auto & i : mGeometryList)
         {
             buildTrianglesEdges(i);
         }
 
+        // face normals in one go, rather than per triangle
+        calculateFaceNormals();
+
         // Allocate memory for light facing calculate
         mEdgeData->triangleLightFacings.resize(mEdgeData->triangles.size());
 
@@ -232,14 +241,10 @@ namespace Ogre {
         // The edge group now we are dealing with.
         EdgeData::EdgeGroup& eg = mEdgeData->edgeGroups[vertexSet];
 
-        // locate position element & the buffer to go with it
-        const VertexData* vertexData = mVertexDataList[vertexSet];
-        const VertexElement* posElem = vertexData->vertexDeclaration->findElementBySemantic(VertexElementSemantic::POSITION);
-        HardwareVertexBufferSharedPtr vbuf = 
-            vertexData->vertexBufferBinding->getBuffer(posElem->getSource());
-        // lock the buffer for reading
-        HardwareBufferLockGuard vertexLock(vbuf, HardwareBuffer::LockOptions::READ_ONLY);
-        auto* pBaseVertex = static_cast<unsigned char*>(vertexLock.pData);
+        // the positions of the vertex set, shared by all its index sets
+        if (mPositions[vertexSet].empty())
+            readPositions(vertexSet);
+        const float* positions = mPositions[vertexSet].data();
 
         // Get the indexes ready for reading
         bool idx32bit = (indexData->indexBuffer->getType() == HardwareIndexBuffer::IndexType::_32BIT);
@@ -260,7 +265,8 @@ namespace Ogre {
         }
         // Pre-reserve memory for less thrashing
         mEdgeData->triangles.reserve(triangleIndex + iterations);
-        mEdgeData->triangleFaceNormals.reserve(triangleIndex + iterations);
+        mCommonVertexMap.reserve(mCommonVertexMap.size() + iterations / 2);
+        mEdgeMap.reserve(mEdgeMap.size() + iterations * 3 / 2);
         for (size_t t = 0; t < iterations; ++t)
         {
             EdgeData::Triangle tri;
@@ -308,12 +314,8 @@ namespace Ogre {
                 tri.vertIndex[i] = index[i];
 
                 // Retrieve the vertex position
-                unsigned char* pVertex = pBaseVertex + (index[i] * vbuf->getVertexSize());
-                float* pFloat;
-                posElem->baseVertexPointerToElement(pVertex, &pFloat);
-                v[i].x = *pFloat++;
-                v[i].y = *pFloat++;
-                v[i].z = *pFloat++;
+                const float* pFloat = positions + index[i] * 3;
+                v[i] = {pFloat[0], pFloat[1], pFloat[2]};
                 // find this vertex in the existing vertex map, or create it
                 tri.sharedVertIndex[i] = 
                     findOrCreateCommonVertex(v[i], vertexSet, indexSet, index[i]);
@@ -324,11 +326,7 @@ namespace Ogre {
                 tri.sharedVertIndex[1] != tri.sharedVertIndex[2] &&
                 tri.sharedVertIndex[2] != tri.sharedVertIndex[0])
             {
-                // Calculate triangle normal (NB will require recalculation for 
-                // skeletally animated meshes)
-                mEdgeData->triangleFaceNormals.push_back(
-                    Math::calculateFaceNormalWithoutNormalize(v[0], v[1], v[2]));
-                // Add triangle to list
+                // Add triangle to list, its normal is calculated later on
                 mEdgeData->triangles.push_back(tri);
                 // Connect or create edges from common list
                 connectOrCreateEdge(vertexSet, triangleIndex, 
@@ -349,6 +347,67 @@ namespace Ogre {
         eg.triCount = triangleIndex - eg.triStart;
     }
     //---------------------------------------------------------------------
+    void EdgeListBuilder::readPositions(size_t vertexSet)
+    {
+        // locate position element & the buffer to go with it
+        const VertexData* vertexData = mVertexDataList[vertexSet];
+        const VertexElement* posElem = vertexData->vertexDeclaration->findElementBySemantic(VertexElementSemantic::POSITION);
+        HardwareVertexBufferSharedPtr vbuf = 
+            vertexData->vertexBufferBinding->getBuffer(posElem->getSource());
+        // lock the buffer for reading
+        HardwareBufferLockGuard vertexLock(vbuf, HardwareBuffer::LockOptions::READ_ONLY);
+        auto* pBaseVertex = static_cast<unsigned char*>(vertexLock.pData);
+
+        std::vector<float>& positions = mPositions[vertexSet];
+        positions.resize(vbuf->getNumVertices() * 3);
+        for (size_t j = 0; j < vbuf->getNumVertices(); ++j, pBaseVertex += vbuf->getVertexSize())
+        {
+            float* pFloat;
+            posElem->baseVertexPointerToElement(pBaseVertex, &pFloat);
+            std::copy_n(pFloat, 3, &positions[j * 3]);
+        }
+    }
+    //---------------------------------------------------------------------
+    void EdgeListBuilder::calculateFaceNormals()
+    {
+        // enough triangles per block to be worth a task
+        static const size_t constexpr BLOCK_SIZE = 4096;
+
+        // Calculate triangle normals (NB will require recalculation for
+        // skeletally animated meshes)
+        mEdgeData->triangleFaceNormals.resize(mEdgeData->triangles.size());
+
+        struct Block
+        {
+            size_t vertexSet;
+            size_t triStart;
+            size_t triCount;
+        };
+        std::vector<Block> blocks;
+        for (const auto& eg : mEdgeData->edgeGroups)
+        {
+            for (size_t start = 0; start < eg.triCount; start += BLOCK_SIZE)
+                blocks.push_back({eg.vertexSet, eg.triStart + start, std::min(BLOCK_SIZE, eg.triCount - start)});
+        }
+
+        auto calculateBlock = [this, &blocks](size_t b)
+        {
+            const Block& block = blocks[b];
+            OptimisedUtil::getImplementation()->calculateFaceNormals(
+                mPositions[block.vertexSet].data(),
+                &mEdgeData->triangles[block.triStart],
+                &mEdgeData->triangleFaceNormals[block.triStart],
+                block.triCount);
+        };
+
+        Root* root = Root::getSingletonPtr();
+        if (blocks.size() > 1 && root && root->getWorkQueue())
+            root->getWorkQueue()->parallelFor(blocks.size(), calculateBlock);
+        else
+            for (size_t b = 0; b < blocks.size(); ++b)
+                calculateBlock(b);
+    }
+    //---------------------------------------------------------------------
     void EdgeListBuilder::connectOrCreateEdge(size_t vertexSet, size_t triangleIndex, 
         size_t vertIndex0, size_t vertIndex1, size_t sharedVertIndex0, 
         size_t sharedVertIndex1)
@@ -385,12 +444,20 @@ namespace Ogre {
         }
     }
     //---------------------------------------------------------------------
+    auto EdgeListBuilder::vectorHash::operator()(const Vector3& v) const -> size_t
+    {
+        // adding +0 turns -0 into +0
+        auto x = std::bit_cast<uint32>(float(v.x) + 0.0f);
+        auto y = std::bit_cast<uint32>(float(v.y) + 0.0f);
+        auto z = std::bit_cast<uint32>(float(v.z) + 0.0f);
+        return (size_t(x) * 73856093u) ^ (size_t(y) * 19349663u) ^ (size_t(z) * 83492791u);
+    }
+    //---------------------------------------------------------------------
     auto EdgeListBuilder::findOrCreateCommonVertex(const Vector3& vec, 
         size_t vertexSet, size_t indexSet, size_t originalIndex) -> size_t
     {
         // Because the algorithm doesn't care about manifold or not, we just identifying
         // the common vertex by EXACT same position.
-        // Hint: We can use quantize method for welding almost same position vertex fastest.
         std::pair<CommonVertexMap::iterator, bool> inserted = mCommonVertexMap.emplace(vec, mVertices.size());
         if (!inserted.second)
         {
@@ -28,6 +28,7 @@ Copyright (c) 2000-2014 Torus Knot Software Ltd
 module;
 
 #include <cassert>
+#include <cmath>
 #include <cstring>
 
 module Ogre.Core;
@@ -59,18 +60,27 @@ import :MeshManager;
 import :Node;
 import :OptimisedUtil;
 import :Pass;
+import :PixelCountLodStrategy;
 import :RenderOperation;
 import :RenderQueue;
+import :RenderSystem;
+import :RenderSystemCapabilities;
+import :ResourceBackgroundQueue;
 import :Root;
 import :SceneManager;
 import :SceneNode;
 import :Skeleton;
 import :SkeletonInstance;
+import :SkeletonPoseCache;
+import :SkinnedVertexCache;
 import :StringConverter;
 import :SubEntity;
 import :SubMesh;
 import :TagPoint;
 import :Technique;
+import :Texture;
+import :TextureManager;
+import :TextureUnitState;
 import :VertexIndexData;
 
 import <algorithm>;
@@ -96,6 +106,7 @@ namespace Ogre {
           mVertexProgramInUse(false),
           mInitialised(false),
           mHardwarePoseCount(0),
+          mHardwarePoseTexture(false),
           mNumBoneMatrices(0),
           mBoneWorldMatrices(nullptr),
           mBoneMatrices(nullptr),
@@ -301,6 +312,7 @@ namespace Ogre {
         mSkelAnimVertexData.reset();
         mSoftwareVertexAnimVertexData.reset();
         mHardwareVertexAnimVertexData.reset();
+        mSkinnedVertexCache.reset();
 
         mInitialised = false;
     }
@@ -415,6 +427,18 @@ namespace Ogre {
             // Change LOD index
             mMeshLodIndex = evt.newLodIndex;
 
+            // Animation LOD, the most detailed one of the frame's cameras
+            if (!mAnimationLodValues.empty())
+            {
+                ushort animationLodIndex = meshStrategy->getIndex(biasedMeshLodValue, mAnimationLodValues);
+                unsigned long frameNumber = Root::getSingleton().getNextFrameNumber();
+                if (mAnimationLodFrame != frameNumber)
+                    mAnimationLodIndex = animationLodIndex;
+                else
+                    mAnimationLodIndex = std::min(mAnimationLodIndex, animationLodIndex);
+                mAnimationLodFrame = frameNumber;
+            }
+
             // Now do material LOD
             lodValue *= mMaterialLodFactorTransformed;
 
@@ -457,6 +481,27 @@ namespace Ogre {
                 i->_invalidateCameraCache ();
             }
 
+            // Request the mipmaps matching the size on screen, i.e. assume the textures cover the entity once
+            if (TextureManager::getSingleton()._isStreamingMipmaps() && cam->getViewport())
+            {
+                Real area = std::abs(AbsolutePixelCountLodStrategy::getSingleton().getValue(this, cam));
+                Real pixels = 2 * std::sqrt(area / Math::PI);
+                for (auto i : mSubEntityList)
+                {
+                    Technique* tech = i->getTechnique();
+                    if (!tech || !i->isVisible())
+                        continue;
+                    for (auto pass : tech->getPasses())
+                    {
+                        for (auto tus : pass->getTextureUnitStates())
+                        {
+                            const TexturePtr& tex = tus->_getTexturePtr();
+                            if (tex && tex->_isMipStreamed())
+                                tex->_requestScreenSize(pixels);
+                        }
+                    }
+                }
+            }
 
         }
         // Notify any child objects
@@ -555,12 +600,19 @@ namespace Ogre {
         }
         else
         {
-            mFullBoundingBox.setNull();
+            mFullBoundingBox = mProxyBounds;
         }
 
         return mFullBoundingBox;
     }
     //-----------------------------------------------------------------------
+    void Entity::setProxyBounds(const AxisAlignedBox& bounds)
+    {
+        mProxyBounds = bounds;
+        if (mParentNode && !mMesh->isLoaded())
+            getParentSceneNode()->needUpdate();
+    }
+    //-----------------------------------------------------------------------
     auto Entity::getChildObjectsBoundingBox() const -> AxisAlignedBox
     {
         AxisAlignedBox aa_box;
@@ -791,6 +843,57 @@ namespace Ogre {
         return true;
     }
     //-----------------------------------------------------------------------
+    auto Entity::skinnedVertexCachesBound() const -> bool
+    {
+        if (mSkelAnimVertexData && !mSkinnedVertexCache)
+            return false;
+        for (auto sub : mSubEntityList)
+        {
+            if (sub->isVisible() && sub->mSkelAnimVertexData && !sub->mSkinnedVertexCache)
+                return false;
+        }
+        return true;
+    }
+    //-----------------------------------------------------------------------
+    auto Entity::isSkinningCacheSupported() const -> bool
+    {
+        RenderSystem* rs = Root::getSingleton().getRenderSystem();
+        return rs && rs->getCapabilities() &&
+               rs->getCapabilities()->hasCapability(Capabilities::HWRENDER_TO_VERTEX_BUFFER);
+    }
+    //-----------------------------------------------------------------------
+    void Entity::updateSkinnedVertexCaches()
+    {
+        if (mSkelAnimVertexData)
+        {
+            if (!mSkinnedVertexCache)
+                mSkinnedVertexCache = std::make_unique<SkinnedVertexCache>(
+                    mMesh->sharedVertexData, mMesh->sharedBlendIndexToBoneIndexMap, mSkinningCacheMaterialName);
+            mSkinnedVertexCache->update(mBoneMatrices, mManager);
+        }
+        for (auto se : mSubEntityList)
+        {
+            if (se->isVisible() && se->mSkelAnimVertexData)
+            {
+                if (!se->mSkinnedVertexCache)
+                    se->mSkinnedVertexCache = std::make_unique<SkinnedVertexCache>(
+                        se->mSubMesh->vertexData.get(), se->mSubMesh->blendIndexToBoneIndexMap,
+                        mSkinningCacheMaterialName);
+                se->mSkinnedVertexCache->update(mBoneMatrices, mManager);
+            }
+        }
+    }
+    //-----------------------------------------------------------------------
+    void Entity::setSkinningCacheMaterialName(std::string_view materialName)
+    {
+        mSkinningCacheMaterialName = materialName;
+        // the caches are created with the material on their next update
+        mSkinnedVertexCache.reset();
+        for (auto se : mSubEntityList)
+            se->mSkinnedVertexCache.reset();
+        mSkinningCacheActive = false;
+    }
+    //-----------------------------------------------------------------------
     void Entity::updateAnimation()
     {
         // Do nothing if not initialised yet
@@ -809,6 +912,12 @@ namespace Ogre {
         // Blend normals in s/w only if we're not using h/w animation,
         // since shadows only require positions
         bool blendNormals = !hwAnimation || forcedNormals;
+        // Skin once per frame on the GPU rather than in s/w, unless the CPU needs the result
+        bool skinningCache = !mSkinningCacheMaterialName.empty() && hasSkeleton() && softwareAnimation &&
+                             !hwAnimation && !stencilShadows && !forcedSwAnimation && !hasVertexAnimation() &&
+                             isSkinningCacheSupported();
+        bool skinningCacheStarted = skinningCache && (!mSkinningCacheActive || !skinnedVertexCachesBound());
+        mSkinningCacheActive = skinningCache;
         // Animation dirty if animation state modified or manual bones modified
         bool animationDirty =
             (mFrameAnimationLastUpdated != mAnimationState->getDirtyFrameNumber()) ||
@@ -820,9 +929,9 @@ namespace Ogre {
         // We only do these tasks if animation is dirty
         // Or, if we're using a skeleton and manual bones have been moved
         // Or, if we're using software animation and temp buffers are unbound
-        if (animationDirty ||
+        if (animationDirty || skinningCacheStarted ||
             (softwareAnimation && hasVertexAnimation() && !tempVertexAnimBuffersBound()) ||
-            (softwareAnimation && hasSkeleton() && !tempSkelAnimBuffersBound(blendNormals)))
+            (softwareAnimation && !skinningCache && hasSkeleton() && !tempSkelAnimBuffersBound(blendNormals)))
         {
             if (hasVertexAnimation())
             {
@@ -861,8 +970,12 @@ namespace Ogre {
             {
                 cacheBoneMatrices();
 
+                if (skinningCache)
+                {
+                    updateSkinnedVertexCaches();
+                }
                 // Software blend?
-                if (softwareAnimation)
+                else if (softwareAnimation)
                 {
                     const Affine3* blendMatrices[256];
 
@@ -973,11 +1086,22 @@ namespace Ogre {
         }
         // reset used count
         vdata->hwAnimDataItemsUsed = 0;
+        // bind the pose buffers rather than weighting the pose texture
+        vdata->hwPoseWeights.clear();
                 
         return elemsSupported;
 
     }
     //-----------------------------------------------------------------------
+    void Entity::initHardwarePoseWeights(VertexData* vdata, ushort target)
+    {
+        // first use, make sure the poses are on the GPU
+        if (vdata->hwPoseWeights.empty())
+            mMesh->getPoseTexture(target);
+        // the pose tracks accumulate into these afresh every frame
+        vdata->hwPoseWeights.assign(mMesh->getPoseCount(), 0.0f);
+    }
+    //-----------------------------------------------------------------------
     void Entity::applyVertexAnimation(bool hardwareAnimation, bool stencilShadows)
     {
         const MeshPtr& msh = getMesh();
@@ -986,7 +1110,12 @@ namespace Ogre {
         // make sure we have enough hardware animation elements to play with
         if (hardwareAnimation)
         {
-            if (mHardwareVertexAnimVertexData
+            if (mHardwareVertexAnimVertexData && mHardwarePoseTexture
+                && msh->getSharedVertexDataAnimationType() == VertexAnimationType::POSE)
+            {
+                initHardwarePoseWeights(mHardwareVertexAnimVertexData.get(), 0);
+            }
+            else if (mHardwareVertexAnimVertexData
                 && msh->getSharedVertexDataAnimationType() != VertexAnimationType::NONE)
             {
                 ushort supportedCount =
@@ -1007,9 +1136,16 @@ namespace Ogre {
                 }
                     
 }
-            for (auto sub : mSubEntityList)
+            for (ushort target = 1; auto sub : mSubEntityList)
             {
-                if (sub->getSubMesh()->getVertexAnimationType() != VertexAnimationType::NONE &&
+                // the pose target of the dedicated geometry
+                ushort subTarget = target++;
+                if (sub->getSubMesh()->getVertexAnimationType() == VertexAnimationType::POSE &&
+                    !sub->getSubMesh()->useSharedVertices && sub->mHardwarePoseTexture)
+                {
+                    initHardwarePoseWeights(sub->_getHardwareVertexAnimVertexData(), subTarget);
+                }
+                else if (sub->getSubMesh()->getVertexAnimationType() != VertexAnimationType::NONE &&
                     !sub->getSubMesh()->useSharedVertices)
                 {
                     ushort supportedCount = initHardwareAnimationElements(
@@ -1079,7 +1215,7 @@ namespace Ogre {
             if (anim)
             {
                 anim->apply(this, state->getTimePosition(), state->getWeight(),
-                    swAnim, hardwareAnimation);
+                    swAnim, hardwareAnimation, state->_getKeyIndexHint());
             }
         }
         // Deal with cases where no animation applied
@@ -1329,6 +1465,11 @@ namespace Ogre {
             (mAnimationState->hasEnabledAnimationState() || getSkeleton()->hasManualBones());
     }
     //-----------------------------------------------------------------------
+    auto Entity::_updateBoneMatrices() -> bool
+    {
+        return hasSkeleton() && cacheBoneMatrices();
+    }
+    //-----------------------------------------------------------------------
     auto Entity::_getSkelAnimVertexData() const -> VertexData*
     {
         assert (mSkelAnimVertexData && "Not software skinned or has no shared vertex data!");
@@ -1361,19 +1502,85 @@ namespace Ogre {
     {
         Root& root = Root::getSingleton();
         unsigned long currentFrameNumber = root.getNextFrameNumber();
-        if ((*mFrameBonesLastUpdated != currentFrameNumber) ||
-            (hasSkeleton() && getSkeleton()->getManualBonesDirty()))
+        bool manualBonesDirty = hasSkeleton() && getSkeleton()->getManualBonesDirty();
+        if ((*mFrameBonesLastUpdated != currentFrameNumber) || manualBonesDirty)
         {
+            const AnimationLodLevel* lod = nullptr;
+            if (mAnimationLodIndex > 0 && mAnimationLodIndex <= mAnimationLodLevels.size())
+                lod = &mAnimationLodLevels[mAnimationLodIndex - 1];
+
+            // throttled, unless the application moved bones by hand
+            unsigned long framesSinceEvaluated = currentFrameNumber - mAnimationLodEvaluatedFrame;
+            bool evaluatedBefore = *mFrameBonesLastUpdated != std::numeric_limits<unsigned long>::max();
+            if (lod && evaluatedBefore && !manualBonesDirty && framesSinceEvaluated < lod->updateInterval)
+            {
+                *mFrameBonesLastUpdated = currentFrameNumber;
+                if (!mAnimationLodInterpolation || mAnimationLodToMatrices.size() != mNumBoneMatrices)
+                    return false;
+
+                Real t = Real(framesSinceEvaluated) / lod->updateInterval;
+                for (size_t b = 0; b < mNumBoneMatrices; ++b)
+                {
+                    const Affine3& from = mAnimationLodFromMatrices[b];
+                    const Affine3& to = mAnimationLodToMatrices[b];
+                    for (size_t r = 0; r < 3; ++r)
+                        for (size_t c = 0; c < 4; ++c)
+                            mBoneMatrices[b][r][c] = from[r][c] + (to[r][c] - from[r][c]) * t;
+                }
+                return true;
+            }
+
+            // blend on from the pose reached now, towards the one about to be evaluated
+            bool interpolate = lod && mAnimationLodInterpolation;
+            bool hasPose = mAnimationLodToMatrices.size() == mNumBoneMatrices;
+            if (interpolate)
+            {
+                if (hasPose)
+                    mAnimationLodFromMatrices.swap(mAnimationLodToMatrices);
+                mAnimationLodToMatrices.resize(mNumBoneMatrices);
+            }
+            else
+            {
+                mAnimationLodToMatrices.clear();
+            }
+            Affine3* matrices = interpolate ? mAnimationLodToMatrices.data() : mBoneMatrices;
+
             if ((!mSkipAnimStateUpdates) && (*mFrameBonesLastUpdated != currentFrameNumber))
-                mSkeletonInstance->setAnimationState(*mAnimationState);
-            mSkeletonInstance->_getBoneMatrices(mBoneMatrices);
+                evaluateBoneMatrices(lod && !lod->boneMask.empty() ? &lod->boneMask : nullptr, matrices);
+            else
+                mSkeletonInstance->_getBoneMatrices(matrices);
+
+            if (interpolate)
+            {
+                if (!hasPose)
+                    mAnimationLodFromMatrices = mAnimationLodToMatrices;
+                std::ranges::copy(mAnimationLodFromMatrices, mBoneMatrices);
+            }
             *mFrameBonesLastUpdated  = currentFrameNumber;
+            mAnimationLodEvaluatedFrame = currentFrameNumber;
 
             return true;
         }
         return false;
     }
     //-----------------------------------------------------------------------
+    void Entity::evaluateBoneMatrices(const AnimationState::BoneBlendMask* boneMask, Affine3* matrices)
+    {
+        // objects on the bones, skeleton bounds and display need the bone nodes animated
+        SkeletonPoseCache* cache = mManager ? mManager->getSkeletonPoseCache() : nullptr;
+        if (cache && (!mChildObjectList.empty() || mUpdateBoundingBoxFromSkeleton || mDisplaySkeleton ||
+                      !cache->makeKey(*mSkeletonInstance, *mAnimationState, boneMask, mPoseKey)))
+            cache = nullptr;
+
+        if (cache && cache->find(mPoseKey, matrices, mNumBoneMatrices))
+            return;
+
+        mSkeletonInstance->setAnimationState(*mAnimationState, boneMask);
+        mSkeletonInstance->_getBoneMatrices(matrices);
+        if (cache)
+            cache->insert(mPoseKey, matrices, mNumBoneMatrices);
+    }
+    //-----------------------------------------------------------------------
     void Entity::setDisplaySkeleton(bool display)
     {
         mDisplaySkeleton = display;
@@ -1413,6 +1620,25 @@ namespace Ogre {
         mMinMaterialLodIndex = minDetailIndex;
     }
     //-----------------------------------------------------------------------
+    void Entity::setAnimationLodLevels(const AnimationLodLevelList& levels)
+    {
+        const LodStrategy* strategy = mMesh->getLodStrategy();
+
+        mAnimationLodValues.clear();
+        if (!levels.empty())
+        {
+            mAnimationLodValues.push_back(strategy->getBaseValue());
+            for (const auto& level : levels)
+            {
+                OgreAssert(level.updateInterval > 0, "updateInterval must be at least 1");
+                mAnimationLodValues.push_back(strategy->transformUserValue(level.userValue));
+            }
+            strategy->assertSorted(mAnimationLodValues);
+        }
+        mAnimationLodLevels = levels;
+        mAnimationLodIndex = 0;
+    }
+    //-----------------------------------------------------------------------
     void Entity::buildSubEntityList(MeshPtr& mesh, SubEntityList* sublist)
     {
         // Create SubEntities
@@ -1560,6 +1786,8 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     auto Entity::getBoundingRadius() const -> Real
     {
+        if (!mMesh->isLoaded() && mProxyBounds.isFinite())
+            return Math::boundingRadiusFromAABB(mProxyBounds);
         return mMesh->getBoundingSphereRadius();
     }
     //-----------------------------------------------------------------------
@@ -1568,6 +1796,7 @@ namespace Ogre {
         mSkelAnimVertexData.reset();
         mSoftwareVertexAnimVertexData.reset();
         mHardwareVertexAnimVertexData.reset();
+        mSkinnedVertexCache.reset();
 
         if (hasVertexAnimation())
         {
@@ -1696,9 +1925,12 @@ namespace Ogre {
         // init
         bool hasHardwareAnimation = false;
         bool firstPass = true;
+        bool sharedPoseSeen = false;
+        mHardwarePoseTexture = false;
 
         for (auto sub : mSubEntityList)
         {
+            sub->mHardwarePoseTexture = false;
             const MaterialPtr& m = sub->getMaterial();
             // Make sure it's loaded
             m->load();
@@ -1771,6 +2003,15 @@ namespace Ogre {
                 }
                 else if (animType == VertexAnimationType::POSE)
                 {
+                    // All materials of a geometry must blend the pose texture for us to use it
+                    bool poseTexture = p->getVertexProgram()->isPoseTextureAnimationIncluded();
+                    if (!sub->getSubMesh()->useSharedVertices)
+                        sub->mHardwarePoseTexture = poseTexture;
+                    else
+                    {
+                        mHardwarePoseTexture = (mHardwarePoseTexture || !sharedPoseSeen) && poseTexture;
+                        sharedPoseSeen = true;
+                    }
                     // All materials must support pose animation for us to consider using
                     // hardware animation - if one fails we use software
                     if (firstPass)
@@ -1828,6 +2069,7 @@ namespace Ogre {
         {
             // force reinitialise
             _initialise(true);
+            invalidateShadowVolumeCache();
         }
 
         // Potentially delegate to LOD entity
@@ -1977,11 +2219,8 @@ namespace Ogre {
 
             ++egi;
         }
-        // Calc triangle light facing
-        updateEdgeListLightFacing(edgeList, lightPos);
-
-        // Generate indexes and update renderables
-        generateShadowVolume(edgeList, indexBuffer, indexBufferUsedSize, light, mShadowRenderables, flags);
+        // Calc triangle light facing and generate indexes, unless cached, and update renderables
+        updateShadowVolume(edgeList, lightPos, indexBuffer, indexBufferUsedSize, light, mShadowRenderables, flags, hasAnimation);
 
         return mShadowRenderables;
     }
@@ -2237,7 +2476,7 @@ namespace Ogre {
         case SOFTWARE_MORPH:
             return mSoftwareVertexAnimVertexData.get();
         case SOFTWARE_SKELETAL:
-            return mSkelAnimVertexData.get();
+            return mSkinningCacheActive && mSkinnedVertexCache ? mSkinnedVertexCache->getVertexData() : mSkelAnimVertexData.get();
         };
         // keep compiler happy
         return mMesh->sharedVertexData;
@@ -2333,8 +2572,26 @@ namespace Ogre {
                 groupName = ni->second;
             }
 
+            ni = params->find("backgroundLoad");
+            bool backgroundLoad = ni != params->end() && StringConverter::parseBool(ni->second);
+
             ni = params->find("mesh");
-            if (ni != params->end())
+            if (ni != params->end() && backgroundLoad)
+            {
+                // Get mesh, loaded in the background below if required
+                pMesh = static_pointer_cast<Mesh>(MeshManager::getSingleton().createOrRetrieve(
+                    ni->second, groupName, false, nullptr, nullptr, HardwareBuffer::STATIC_WRITE_ONLY).first);
+                if (!pMesh->isLoaded())
+                {
+                    pMesh->setBackgroundLoaded(true);
+                    // the entity listens for the mesh before the load is queued
+                    auto* entity = new Entity(name, pMesh);
+                    ResourceBackgroundQueue::getSingleton().load(
+                        MeshManager::getSingleton().getResourceType(), pMesh->getName(), pMesh->getGroup());
+                    return entity;
+                }
+            }
+            else if (ni != params->end())
             {
                 // Get mesh (load if required)
                 pMesh = MeshManager::getSingleton().load(
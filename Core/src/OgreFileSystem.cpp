@@ -113,6 +113,7 @@ namespace {
     };
 
     bool gIgnoreHidden = true;
+    size_t gMemoryMapThreshold = 64 * 1024;
 }
 
     //-----------------------------------------------------------------------
@@ -254,6 +255,14 @@ namespace {
         if (ec != std::error_code{})
             st_size = 0;
 
+        auto const& streamname = name.empty() ? full_path : name;
+        if (!(mode & std::ios::out) && ec == std::error_code{} && st_size >= gMemoryMapThreshold)
+        {
+            // falls back to reading the file if it can not be mapped
+            if (auto mapped = MemoryMappedDataStream::open(streamname.native(), full_path))
+                return mapped;
+        }
+
         std::istream* baseStream = nullptr;
         std::ifstream* roStream = nullptr;
         std::fstream* rwStream = nullptr;
@@ -286,7 +295,6 @@ namespace {
 
         /// Construct return stream, tell it to delete on destroy
         FileStreamDataStream* stream = nullptr;
-        auto const& streamname = name.empty() ? full_path : name;
         if (rwStream)
         {
             // use the writeable stream
@@ -463,4 +471,14 @@ namespace {
     {
         return gIgnoreHidden;
     }
+
+    void FileSystemArchiveFactory::setMemoryMapThreshold(size_t bytes)
+    {
+        gMemoryMapThreshold = bytes;
+    }
+
+    auto FileSystemArchiveFactory::getMemoryMapThreshold() noexcept -> size_t
+    {
+        return gMemoryMapThreshold;
+    }
 }
@@ -0,0 +1,98 @@
+// This file is part of the OGRE project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at https://www.ogre3d.org/licensing.
+module;
+
+#include <cstddef>
+
+module Ogre.Core;
+
+import :FrameAllocator;
+import :Platform;
+
+import <algorithm>;
+import <atomic>;
+import <memory_resource>;
+import <mutex>;
+import <new>;
+import <vector>;
+
+namespace Ogre {
+
+namespace {
+    /// alignment of the buffer, larger requests take overflow blocks
+    constexpr size_t BUFFER_ALIGNMENT = 64;
+}
+    //---------------------------------------------------------------------
+    FrameAllocator::FrameAllocator(size_t capacity)
+        : mBuffer(static_cast<uint8*>(::operator new(capacity, std::align_val_t{BUFFER_ALIGNMENT}))),
+          mCapacity(capacity)
+    {
+    }
+    //---------------------------------------------------------------------
+    FrameAllocator::~FrameAllocator()
+    {
+        for (const Overflow& o : mOverflow)
+            ::operator delete(o.ptr, o.bytes, std::align_val_t{o.alignment});
+        ::operator delete(mBuffer, mCapacity, std::align_val_t{BUFFER_ALIGNMENT});
+    }
+    //---------------------------------------------------------------------
+    void FrameAllocator::reset()
+    {
+        size_t used = getUsed();
+        mPeak = std::max(mPeak, used);
+
+        if (!mOverflow.empty())
+        {
+            for (const Overflow& o : mOverflow)
+                ::operator delete(o.ptr, o.bytes, std::align_val_t{o.alignment});
+            mOverflow.clear();
+
+            // room for the whole last frame and some more, rounded to the alignment
+            size_t capacity = (used + used / 2 + BUFFER_ALIGNMENT - 1) & ~(BUFFER_ALIGNMENT - 1);
+            ::operator delete(mBuffer, mCapacity, std::align_val_t{BUFFER_ALIGNMENT});
+            mBuffer = static_cast<uint8*>(::operator new(capacity, std::align_val_t{BUFFER_ALIGNMENT}));
+            mCapacity = capacity;
+        }
+
+        mUsed.store(0, std::memory_order_relaxed);
+        mOverflowBytes.store(0, std::memory_order_relaxed);
+    }
+    //---------------------------------------------------------------------
+    auto FrameAllocator::getUsed() const -> size_t
+    {
+        return mUsed.load(std::memory_order_relaxed) + mOverflowBytes.load(std::memory_order_relaxed);
+    }
+    //---------------------------------------------------------------------
+    auto FrameAllocator::do_allocate(size_t bytes, size_t alignment) -> void*
+    {
+        if (alignment <= BUFFER_ALIGNMENT)
+        {
+            size_t used = mUsed.load(std::memory_order_relaxed);
+            for (;;)
+            {
+                size_t offset = (used + alignment - 1) & ~(alignment - 1);
+                if (offset + bytes > mCapacity)
+                    break;
+                if (mUsed.compare_exchange_weak(used, offset + bytes, std::memory_order_relaxed))
+                    return mBuffer + offset;
+            }
+        }
+
+        void* ptr = ::operator new(bytes, std::align_val_t{alignment});
+        std::lock_guard lock{mOverflowMutex};
+        mOverflow.push_back({ptr, bytes, alignment});
+        mOverflowBytes.fetch_add(bytes, std::memory_order_relaxed);
+        return ptr;
+    }
+    //---------------------------------------------------------------------
+    void FrameAllocator::do_deallocate(void*, size_t, size_t)
+    {
+        // everything is freed at once by reset
+    }
+    //---------------------------------------------------------------------
+    auto FrameAllocator::do_is_equal(const std::pmr::memory_resource& other) const noexcept -> bool
+    {
+        return this == &other;
+    }
+}
@@ -37,6 +37,7 @@ import :Matrix4;
 import :MovableObject;
 import :MovablePlane;
 import :Node;
+import :OptimisedUtil;
 import :Plane;
 import :PlaneBoundedVolume;
 import :Platform;
@@ -50,6 +51,7 @@ import :Sphere;
 import :Vector;
 
 import <algorithm>;
+import <limits>;
 
 namespace Ogre {
 
@@ -229,6 +231,60 @@ namespace Ogre {
 
         return true;
     }
+    //-----------------------------------------------------------------------
+    void Frustum::isVisible(const AxisAlignedBoxBatch& bounds, uint8* visible) const
+    {
+        // Make any pending updates to the calculated frustum planes
+        updateFrustumPlanes();
+
+        alignas(16) float planes[6][4];
+        size_t numPlanes = 0;
+        for (int plane = 0; plane < 6; ++plane)
+        {
+            // Skip far plane if infinite view frustum
+            if (plane == std::to_underlying(FrustumPlane::FAR) && mFarDist == 0)
+                continue;
+
+            const Plane& p = mFrustumPlanes[plane];
+            planes[numPlanes][0] = p.normal.x;
+            planes[numPlanes][1] = p.normal.y;
+            planes[numPlanes][2] = p.normal.z;
+            planes[numPlanes][3] = p.d;
+            ++numPlanes;
+        }
+
+        OptimisedUtil::getImplementation()->cullBoxes(
+            planes[0], numPlanes,
+            bounds.centreX, bounds.centreY, bounds.centreZ,
+            bounds.halfSizeX, bounds.halfSizeY, bounds.halfSizeZ,
+            visible, bounds.size);
+    }
+    //-----------------------------------------------------------------------
+    void AxisAlignedBoxBatch::push_back(const AxisAlignedBox& box)
+    {
+        OgreAssert(!full(), "AxisAlignedBoxBatch is full");
+
+        Vector3 centre = Vector3::ZERO, halfSize;
+        if (box.isNull())
+            // fails every plane
+            halfSize = Vector3::UNIT_SCALE * -std::numeric_limits<float>::max();
+        else if (box.isInfinite())
+            // passes every plane
+            halfSize = Vector3::UNIT_SCALE * std::numeric_limits<float>::max();
+        else
+        {
+            centre = box.getCenter();
+            halfSize = box.getHalfSize();
+        }
+
+        centreX[size] = centre.x;
+        centreY[size] = centre.y;
+        centreZ[size] = centre.z;
+        halfSizeX[size] = halfSize.x;
+        halfSizeY[size] = halfSize.y;
+        halfSizeZ[size] = halfSize.z;
+        ++size;
+    }
 
     //-----------------------------------------------------------------------
     auto Frustum::isVisible(const Vector3& vert, FrustumPlane* culledBy) const -> bool
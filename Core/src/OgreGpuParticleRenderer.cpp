@@ -0,0 +1,455 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+module;
+
+#include <cstddef>
+
+module Ogre.Core;
+
+import :AxisAlignedBox;
+import :Exception;
+import :GpuParticleRenderer;
+import :GpuProgramParams;
+import :HardwareBuffer;
+import :HardwareBufferManager;
+import :HardwareVertexBuffer;
+import :Material;
+import :MaterialManager;
+import :Math;
+import :Matrix4;
+import :Node;
+import :ParticleEmitter;
+import :ParticleSystem;
+import :Pass;
+import :RenderOperation;
+import :RenderQueue;
+import :RenderSystem;
+import :RenderSystemCapabilities;
+import :RenderToVertexBuffer;
+import :Root;
+import :StringConverter;
+import :StringInterface;
+import :Technique;
+import :VertexIndexData;
+
+import <algorithm>;
+import <format>;
+import <memory>;
+import <string>;
+import <vector>;
+
+namespace Ogre {
+    static std::string_view const constexpr rendererTypeName = "gpu";
+
+namespace
+{
+    /// Feeds the launchers to the first step of the simulation
+    class LauncherSource : public Renderable
+    {
+        VertexData* mVertexData;
+        MaterialPtr mMaterial;
+        LightList mLightList;
+
+    public:
+        LauncherSource( VertexData* vertexData, const MaterialPtr& material )
+            : mVertexData( vertexData ), mMaterial( material ) {}
+
+        auto getMaterial() const noexcept -> const MaterialPtr& override { return mMaterial; }
+        void getRenderOperation( RenderOperation& op ) override
+        {
+            op.operationType = RenderOperation::OperationType::POINT_LIST;
+            op.useIndexes = false;
+            op.indexData = nullptr;
+            op.vertexData = mVertexData;
+        }
+        void getWorldTransforms( Matrix4* xform ) const override { *xform = Matrix4::IDENTITY; }
+        auto getSquaredViewDepth( const Camera* cam ) const -> Real override { return 0; }
+        auto getLights() const noexcept -> const LightList& override { return mLightList; }
+    };
+
+    static class CmdMaxParticles : public ParamCommand
+    {
+    public:
+        auto doGet(const void* target) const -> String override
+        {
+            return StringConverter::toString(static_cast<const GpuParticleRenderer*>(target)->getMaxParticles());
+        }
+        void doSet(void* target, std::string_view val) override
+        {
+            static_cast<GpuParticleRenderer*>(target)->setMaxParticles(StringConverter::parseSizeT(val));
+        }
+    } msMaxParticlesCmd;
+
+    static class CmdSimulationMaterial : public ParamCommand
+    {
+    public:
+        auto doGet(const void* target) const -> String override
+        {
+            return String{static_cast<const GpuParticleRenderer*>(target)->getSimulationMaterialName()};
+        }
+        void doSet(void* target, std::string_view val) override
+        {
+            static_cast<GpuParticleRenderer*>(target)->setSimulationMaterialName(val);
+        }
+    } msSimulationMaterialCmd;
+
+    static class CmdForceVector : public ParamCommand
+    {
+    public:
+        auto doGet(const void* target) const -> String override
+        {
+            return StringConverter::toString(static_cast<const GpuParticleRenderer*>(target)->getForce());
+        }
+        void doSet(void* target, std::string_view val) override
+        {
+            static_cast<GpuParticleRenderer*>(target)->setForce(StringConverter::parseVector3(val));
+        }
+    } msForceVectorCmd;
+
+    static class CmdColourChange : public ParamCommand
+    {
+    public:
+        auto doGet(const void* target) const -> String override
+        {
+            return StringConverter::toString(static_cast<const GpuParticleRenderer*>(target)->getColourChange());
+        }
+        void doSet(void* target, std::string_view val) override
+        {
+            static_cast<GpuParticleRenderer*>(target)->setColourChange(StringConverter::parseColourValue(val));
+        }
+    } msColourChangeCmd;
+
+    static class CmdScaleRate : public ParamCommand
+    {
+    public:
+        auto doGet(const void* target) const -> String override
+        {
+            return StringConverter::toString(static_cast<const GpuParticleRenderer*>(target)->getScaleRate());
+        }
+        void doSet(void* target, std::string_view val) override
+        {
+            static_cast<GpuParticleRenderer*>(target)->setScaleRate(StringConverter::parseReal(val));
+        }
+    } msScaleRateCmd;
+
+    static class CmdRotationSpeedStart : public ParamCommand
+    {
+    public:
+        auto doGet(const void* target) const -> String override
+        {
+            return StringConverter::toString(static_cast<const GpuParticleRenderer*>(target)->getMinRotationSpeed());
+        }
+        void doSet(void* target, std::string_view val) override
+        {
+            auto renderer = static_cast<GpuParticleRenderer*>(target);
+            renderer->setRotationSpeedRange(StringConverter::parseAngle(val), renderer->getMaxRotationSpeed());
+        }
+    } msRotationSpeedStartCmd;
+
+    static class CmdRotationSpeedEnd : public ParamCommand
+    {
+    public:
+        auto doGet(const void* target) const -> String override
+        {
+            return StringConverter::toString(static_cast<const GpuParticleRenderer*>(target)->getMaxRotationSpeed());
+        }
+        void doSet(void* target, std::string_view val) override
+        {
+            auto renderer = static_cast<GpuParticleRenderer*>(target);
+            renderer->setRotationSpeedRange(renderer->getMinRotationSpeed(), StringConverter::parseAngle(val));
+        }
+    } msRotationSpeedEndCmd;
+}
+    //-----------------------------------------------------------------------
+    GpuParticleRenderer::GpuParticleRenderer() : mSimulationMaterialName{"Ogre/GpuParticles/Simulation"}
+    {
+        if (createParamDictionary("GpuParticleRenderer"))
+        {
+            ParamDictionary* dict = getParamDictionary();
+            dict->addParameter(ParameterDef("max_particles",
+                "The maximum number of particles simulated at once.",
+                ParameterType::UNSIGNED_INT),
+                &msMaxParticlesCmd);
+            dict->addParameter(ParameterDef("simulation_material",
+                "The material advancing the particles through transform feedback.",
+                ParameterType::STRING),
+                &msSimulationMaterialCmd);
+            dict->addParameter(ParameterDef("force_vector",
+                "The force added to the direction of all particles per second.",
+                ParameterType::VECTOR3),
+                &msForceVectorCmd);
+            dict->addParameter(ParameterDef("colour_change",
+                "The colour added to all particles per second.",
+                ParameterType::COLOURVALUE),
+                &msColourChangeCmd);
+            dict->addParameter(ParameterDef("scale_rate",
+                "The amount added to the width and height of all particles per second.",
+                ParameterType::REAL),
+                &msScaleRateCmd);
+            dict->addParameter(ParameterDef("rotation_speed_range_start",
+                "The minimum rotation speed of new particles, per second.",
+                ParameterType::REAL),
+                &msRotationSpeedStartCmd);
+            dict->addParameter(ParameterDef("rotation_speed_range_end",
+                "The maximum rotation speed of new particles, per second.",
+                ParameterType::REAL),
+                &msRotationSpeedEndCmd);
+        }
+    }
+    //-----------------------------------------------------------------------
+    GpuParticleRenderer::~GpuParticleRenderer() = default;
+    //-----------------------------------------------------------------------
+    auto GpuParticleRenderer::getType() const noexcept -> std::string_view
+    {
+        return rendererTypeName;
+    }
+    //-----------------------------------------------------------------------
+    void GpuParticleRenderer::setMaxParticles(size_t maxParticles)
+    {
+        mMaxParticles = maxParticles;
+        mSimulation.reset();
+    }
+    //-----------------------------------------------------------------------
+    void GpuParticleRenderer::setSimulationMaterialName(std::string_view name)
+    {
+        mSimulationMaterialName = name;
+        mSimulation.reset();
+    }
+    //-----------------------------------------------------------------------
+    void GpuParticleRenderer::defineParticleLayout(VertexDeclaration* decl)
+    {
+        using enum VertexElementSemantic;
+        decl->addElement(0, decl->getVertexSize(0), VertexElementType::FLOAT3, POSITION);
+        decl->addElement(0, decl->getVertexSize(0), VertexElementType::FLOAT4, DIFFUSE);
+        for (unsigned short i = 0; i < 3; ++i)
+            decl->addElement(0, decl->getVertexSize(0), VertexElementType::FLOAT4, TEXTURE_COORDINATES, i);
+    }
+    //-----------------------------------------------------------------------
+    auto GpuParticleRenderer::_simulateParticles(ParticleSystem* system, Real timeElapsed,
+                                                 AxisAlignedBox& bounds) -> bool
+    {
+        mSceneManager = system->_getManager();
+        mPendingTime += timeElapsed;
+        mTotalTime += timeElapsed;
+
+        mEmitterPosition.clear();
+        mEmitterDirection.clear();
+        mEmitterVelocity.clear();
+        mEmitterColourStart.clear();
+        mEmitterColourEnd.clear();
+
+        // The furthest a particle gets from its emitter without the initial velocity
+        Real forceLength = mForce.length();
+        Real maxSize = std::max(mDefaultSize.x, mDefaultSize.y);
+
+        bounds.setNull();
+        for (unsigned short i = 0; i < system->getNumEmitters() && mEmitterPosition.size() < MAX_EMITTERS; ++i)
+        {
+            ParticleEmitter* emitter = system->getEmitter(i);
+            if (emitter->isEmitted())
+                continue;
+
+            // The uniforms are in the space the particles are kept in
+            Vector3 position = emitter->getPosition();
+            Vector3 direction = emitter->getDirection();
+            if (!mLocalSpace && mParentNode)
+            {
+                position = mParentNode->convertLocalToWorldPosition(position);
+                direction = mParentNode->convertLocalToWorldDirection(direction, false);
+            }
+
+            Real rate = emitter->getEnabled() ? emitter->getEmissionRate() : 0;
+            mEmitterPosition.emplace_back(position.x, position.y, position.z, rate);
+            mEmitterDirection.emplace_back(direction.x, direction.y, direction.z, emitter->getAngle().valueRadians());
+            mEmitterVelocity.emplace_back(emitter->getMinParticleVelocity(), emitter->getMaxParticleVelocity(),
+                                          emitter->getMinTimeToLive(), emitter->getMaxTimeToLive());
+            mEmitterColourStart.push_back(emitter->getColourRangeStart());
+            mEmitterColourEnd.push_back(emitter->getColourRangeEnd());
+
+            Real ttl = emitter->getMaxTimeToLive();
+            Real reach = emitter->getMaxParticleVelocity() * ttl + 0.5f * forceLength * ttl * ttl +
+                         0.5f * (maxSize + std::max<Real>(mScaleRate, 0) * ttl);
+            Vector3 localPosition = emitter->getPosition();
+            bounds.merge(AxisAlignedBox{localPosition - reach, localPosition + reach});
+        }
+
+        return true;
+    }
+    //-----------------------------------------------------------------------
+    void GpuParticleRenderer::createSimulation()
+    {
+        const RenderSystemCapabilities* caps = Root::getSingleton().getRenderSystem()->getCapabilities();
+        if (!caps->hasCapability(Capabilities::HWRENDER_TO_VERTEX_BUFFER))
+        {
+            OGRE_EXCEPT(ExceptionCodes::RENDERINGAPI_ERROR,
+                        "GpuParticleRenderer requires render to vertex buffer support",
+                        "GpuParticleRenderer::createSimulation");
+        }
+
+        MaterialPtr simulationMaterial = MaterialManager::getSingleton().getByName(mSimulationMaterialName);
+        if (!simulationMaterial)
+        {
+            OGRE_EXCEPT(ExceptionCodes::ITEM_NOT_FOUND,
+                        ::std::format("Could not find particle simulation material '{}'", mSimulationMaterialName),
+                        "GpuParticleRenderer::createSimulation");
+        }
+        simulationMaterial->load();
+
+        // Only the last component tells launchers apart, everything else starts at zero
+        mNumLaunchers = mEmitterPosition.size();
+        mLauncherData = std::make_unique<VertexData>();
+        VertexDeclaration* decl = mLauncherData->vertexDeclaration;
+        defineParticleLayout(decl);
+        size_t vertexFloats = decl->getVertexSize(0) / sizeof(float);
+        std::vector<float> launchers(vertexFloats * mNumLaunchers, 0.0f);
+        for (size_t i = 0; i < mNumLaunchers; ++i)
+            launchers[(i + 1) * vertexFloats - 1] = static_cast<float>(i + 1);
+
+        HardwareVertexBufferSharedPtr buffer = HardwareBufferManager::getSingleton().createVertexBuffer(
+            decl->getVertexSize(0), mNumLaunchers, HardwareBuffer::STATIC_WRITE_ONLY);
+        buffer->writeData(0, buffer->getSizeInBytes(), launchers.data(), true);
+        mLauncherData->vertexBufferBinding->setBinding(0, buffer);
+        mLauncherData->vertexCount = mNumLaunchers;
+        mLauncherSource = std::make_unique<LauncherSource>(mLauncherData.get(), simulationMaterial);
+
+        mSimulation = HardwareBufferManager::getSingleton().createRenderToVertexBuffer();
+        defineParticleLayout(mSimulation->getVertexDeclaration());
+        mSimulation->setOperationType(RenderOperation::OperationType::POINT_LIST);
+        mSimulation->setMaxVertexCount(static_cast<unsigned int>(mMaxParticles + mNumLaunchers));
+        mSimulation->setResetsEveryUpdate(false);
+        mSimulation->setSourceRenderable(mLauncherSource.get());
+        mSimulation->setRenderToBufferMaterialName(simulationMaterial->getName());
+
+        mDrawData = std::make_unique<VertexData>();
+        defineParticleLayout(mDrawData->vertexDeclaration);
+        mDrawData->vertexCount = 0;
+    }
+    //-----------------------------------------------------------------------
+    void GpuParticleRenderer::updateSimulationParameters(const GpuProgramParametersSharedPtr& params)
+    {
+        auto setIfDeclared = [&params](std::string_view name, const float* val, size_t count)
+        {
+            if (params->_findNamedConstantDefinition(name))
+                params->setNamedConstant(name, val, count);
+        };
+
+        Vector4 time{mPendingTime, mTotalTime, 0, 0};
+        Vector4 size{mDefaultSize.x, mDefaultSize.y, 0, 0};
+        Vector4 force{mForce.x, mForce.y, mForce.z, 0};
+        Vector4 scale{mScaleRate, mScaleRate, 0, 0};
+        Vector4 rotation{mMinRotationSpeed.valueRadians(), mMaxRotationSpeed.valueRadians(), 0, 0};
+        setIfDeclared("particleTime", time.ptr(), 1);
+        setIfDeclared("particleSize", size.ptr(), 1);
+        setIfDeclared("affectorForce", force.ptr(), 1);
+        setIfDeclared("affectorColourChange", mColourChange.ptr(), 1);
+        setIfDeclared("affectorScale", scale.ptr(), 1);
+        setIfDeclared("affectorRotation", rotation.ptr(), 1);
+
+        setIfDeclared("emitterPosition", mEmitterPosition[0].ptr(), mNumLaunchers);
+        setIfDeclared("emitterDirection", mEmitterDirection[0].ptr(), mNumLaunchers);
+        setIfDeclared("emitterVelocity", mEmitterVelocity[0].ptr(), mNumLaunchers);
+        setIfDeclared("emitterColourStart", mEmitterColourStart[0].ptr(), mNumLaunchers);
+        setIfDeclared("emitterColourEnd", mEmitterColourEnd[0].ptr(), mNumLaunchers);
+    }
+    //-----------------------------------------------------------------------
+    void GpuParticleRenderer::_updateRenderQueue(RenderQueue* queue,
+        std::vector<Particle*>& currentParticles, bool cullIndividually)
+    {
+        if (!mSceneManager || mEmitterPosition.empty())
+            return;
+
+        // Emitters added or removed change the launchers, which restarts the effect
+        if (!mSimulation || mNumLaunchers != mEmitterPosition.size())
+            createSimulation();
+
+        // Once per update, not per camera
+        if (mPendingTime > 0)
+        {
+            Pass* pass = mSimulation->getRenderToBufferMaterial()->getBestTechnique()->getPass(0);
+            if (pass->hasVertexProgram())
+                updateSimulationParameters(pass->getVertexProgramParameters());
+            if (pass->hasGeometryProgram())
+                updateSimulationParameters(pass->getGeometryProgramParameters());
+
+            mSimulation->update(mSceneManager);
+            mPendingTime = 0;
+        }
+
+        RenderOperation simulatedOp;
+        mSimulation->getRenderOperation(simulatedOp);
+        size_t numVertices = simulatedOp.vertexData->vertexCount;
+        if (numVertices <= mNumLaunchers)
+            return;
+
+        // The launchers stay in front of the buffer, the particles follow
+        mDrawData->vertexBufferBinding->setBinding(0, simulatedOp.vertexData->vertexBufferBinding->getBuffer(0));
+        mDrawData->vertexStart = mNumLaunchers;
+        mDrawData->vertexCount = numVertices - mNumLaunchers;
+        queue->addRenderable(this, mRenderQueueID, mRenderQueuePriority);
+    }
+    //-----------------------------------------------------------------------
+    void GpuParticleRenderer::visitRenderables(Renderable::Visitor* visitor, bool debugRenderables)
+    {
+        visitor->visit(this, 0, false);
+    }
+    //-----------------------------------------------------------------------
+    void GpuParticleRenderer::getRenderOperation(RenderOperation& op)
+    {
+        op.operationType = RenderOperation::OperationType::POINT_LIST;
+        op.useIndexes = false;
+        op.indexData = nullptr;
+        op.vertexData = mDrawData.get();
+    }
+    //-----------------------------------------------------------------------
+    void GpuParticleRenderer::getWorldTransforms(Matrix4* xform) const
+    {
+        // particles in world space were transformed when emitted
+        if (mLocalSpace && mParentNode)
+            *xform = mParentNode->_getFullTransform();
+        else
+            *xform = Matrix4::IDENTITY;
+    }
+    //-----------------------------------------------------------------------
+    auto GpuParticleRenderer::getSquaredViewDepth(const Camera* cam) const -> Real
+    {
+        return mParentNode ? mParentNode->getSquaredViewDepth(cam) : 0;
+    }
+    //-----------------------------------------------------------------------
+    //-----------------------------------------------------------------------
+    //-----------------------------------------------------------------------
+    auto GpuParticleRendererFactory::getType() const noexcept -> std::string_view
+    {
+        return rendererTypeName;
+    }
+    //-----------------------------------------------------------------------
+    auto GpuParticleRendererFactory::createInstance(
+        std::string_view name ) -> ParticleSystemRenderer*
+    {
+        return new GpuParticleRenderer();
+    }
+}
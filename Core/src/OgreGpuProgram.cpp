@@ -33,12 +33,15 @@ import :Exception;
 import :GpuProgram;
 import :GpuProgramManager;
 import :GpuProgramParams;
+import :HitchMonitor;
 import :Log;
 import :LogManager;
 import :RenderSystem;
 import :RenderSystemCapabilities;
 import :ResourceGroupManager;
 import :Root;
+import :ShaderTelemetry;
+import :StartupProfiler;
 import :StringConverter;
 import :StringInterface;
 
@@ -82,6 +85,12 @@ namespace Ogre
         auto doGet(const void* target) const -> String override;
         void doSet(void* target, std::string_view val) override;
     };
+    class CmdPoseTexture : public ParamCommand
+    {
+    public:
+        auto doGet(const void* target) const -> String override;
+        void doSet(void* target, std::string_view val) override;
+    };
     class CmdVTF : public ParamCommand
     {
     public:
@@ -106,6 +115,7 @@ namespace Ogre
     static CmdSkeletal msSkeletalCmd;
     static CmdMorph msMorphCmd;
     static CmdPose msPoseCmd;
+    static CmdPoseTexture msPoseTextureCmd;
     static CmdVTF msVTFCmd;
     static CmdManualNamedConstsFile msManNamedConstsFileCmd;
     static CmdAdjacency msAdjacencyCmd;
@@ -204,6 +214,9 @@ namespace Ogre
         if(mCompileError)
             return;
 
+        HitchMonitor::Scope activity{HitchMonitor::ActivityType::SHADER_COMPILE, mName};
+        StartupProfiler::Scope phase{StartupProfiler::PhaseType::SHADER_COMPILE, mName};
+        ShaderTelemetry::Scope telemetry{ShaderTelemetry::EventType::COMPILE, mName};
         // Call polymorphic load
         try 
         {
@@ -419,6 +432,10 @@ namespace Ogre
             ParameterDef("includes_pose_animation", 
                          "The number of poses this vertex program supports for pose animation", ParameterType::INT),
             &msPoseCmd);
+        dict->addParameter(
+            ParameterDef("includes_pose_texture_animation",
+                         "Whether this vertex program blends all poses from the pose texture", ParameterType::BOOL),
+            &msPoseTextureCmd);
         dict->addParameter(
             ParameterDef("uses_vertex_texture_fetch", 
                          "Whether this vertex program requires vertex texture fetch support.", ParameterType::BOOL), 
@@ -520,6 +537,17 @@ namespace Ogre
         t->setPoseAnimationIncluded((ushort)StringConverter::parseUnsignedInt(val));
     }
     //-----------------------------------------------------------------------
+    auto CmdPoseTexture::doGet(const void* target) const -> String
+    {
+        const auto* t = static_cast<const GpuProgram*>(target);
+        return StringConverter::toString(t->isPoseTextureAnimationIncluded());
+    }
+    void CmdPoseTexture::doSet(void* target, std::string_view val)
+    {
+        auto* t = static_cast<GpuProgram*>(target);
+        t->setPoseTextureAnimationIncluded(StringConverter::parseBool(val));
+    }
+    //-----------------------------------------------------------------------
     auto CmdVTF::doGet(const void* target) const -> String
     {
         const auto* t = static_cast<const GpuProgram*>(target);
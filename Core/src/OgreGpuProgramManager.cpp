@@ -28,6 +28,7 @@ THE SOFTWARE.
 module;
 
 #include <cassert>
+#include <cstring>
 
 module Ogre.Core;
 
@@ -42,12 +43,27 @@ import :Root;
 import :StreamSerialiser;
 import :UnifiedHighLevelGpuProgram;
 
+import <array>;
+import <filesystem>;
+import <format>;
+import <fstream>;
 import <memory>;
 import <utility>;
 
 namespace Ogre {
 namespace {
     uint32 CACHE_CHUNK_ID = StreamSerialiser::makeIdentifier("OGPC"); // Ogre Gpu Program cache
+    uint32 CACHE_FILE_ID = StreamSerialiser::makeIdentifier("OGPF"); // Ogre Gpu Program cache file
+    uint32 CACHE_FILE_VERSION = 1;
+
+    /// Identifies the drivers accepting the same program binaries
+    auto getMicrocodeSignature() -> String
+    {
+        RenderSystem* rs = Root::getSingleton().getRenderSystem();
+        const RenderSystemCapabilities* caps = rs->getCapabilities();
+        return ::std::format("{}|{}|{}|{}", rs->getName(), RenderSystemCapabilities::vendorToString(caps->getVendor()),
+                             caps->getDeviceName(), caps->getDriverVersion().toString());
+    }
 
     String sNullLang = "null";
     class NullProgram : public GpuProgram
@@ -331,12 +347,23 @@ namespace {
     //---------------------------------------------------------------------
     auto GpuProgramManager::isMicrocodeAvailableInCache( uint32 id ) const -> bool
     {
-        return mMicrocodeCache.find(id) != mMicrocodeCache.end();
+        openMicrocodeCacheFile();
+        return mMicrocodeCache.contains(id) || mMappedMicrocodes.contains(id);
     }
     //---------------------------------------------------------------------
     auto GpuProgramManager::getMicrocodeFromCache( uint32 id ) const -> const GpuProgramManager::Microcode &
     {
-        return mMicrocodeCache.find(id)->second;
+        openMicrocodeCacheFile();
+        auto it = mMicrocodeCache.find(id);
+        if (it == mMicrocodeCache.end())
+        {
+            // copied out of the mapping, which is dropped when the file changes
+            auto [offset, size] = mMappedMicrocodes.find(id)->second;
+            Microcode microcode = createMicrocode(size);
+            memcpy(microcode->getPtr(), mMicrocodeMapping->getPtr() + offset, size);
+            it = mMicrocodeCache.emplace(id, microcode).first;
+        }
+        return it->second;
     }
     //---------------------------------------------------------------------
     auto GpuProgramManager::createMicrocode( size_t size ) const -> GpuProgramManager::Microcode
@@ -346,6 +373,7 @@ namespace {
     //---------------------------------------------------------------------
     void GpuProgramManager::addMicrocodeToCache( uint32 id, const GpuProgramManager::Microcode & microcode )
     {   
+        openMicrocodeCacheFile();
         auto foundIter = mMicrocodeCache.find(id);
         if ( foundIter == mMicrocodeCache.end() )
         {
@@ -356,12 +384,19 @@ namespace {
         else
         {
             foundIter->second = microcode;
+        }
 
-        }       
+        // replaces the record of the file, if any, when the file is opened next
+        if (!mMicrocodeCacheFile.empty())
+            appendMicrocodeToFile(id, microcode);
     }
     //---------------------------------------------------------------------
     void GpuProgramManager::removeMicrocodeFromCache( uint32 id )
     {
+        openMicrocodeCacheFile();
+        if ((mMappedMicrocodes.erase(id) > 0 || mMicrocodeCache.contains(id)) && !mMicrocodeCacheFile.empty())
+            appendMicrocodeToFile(id, nullptr);
+
         auto foundIter = mMicrocodeCache.find(id);
 
         if (foundIter != mMicrocodeCache.end())
@@ -456,6 +491,97 @@ namespace {
         
     }
     //---------------------------------------------------------------------
+    void GpuProgramManager::setMicrocodeCacheFile(const std::filesystem::path& path)
+    {
+        mMicrocodeCacheFile = path;
+        mMicrocodeCacheFileOpened = false;
+        mMicrocodeMapping.reset();
+        mMappedMicrocodes.clear();
+        mMicrocodeCacheFileSize = 0;
+    }
+    //---------------------------------------------------------------------
+    void GpuProgramManager::openMicrocodeCacheFile() const
+    {
+        if (mMicrocodeCacheFileOpened || mMicrocodeCacheFile.empty())
+            return;
+        mMicrocodeCacheFileOpened = true;
+
+        // identifier, version, length of the signature and the signature, then the records
+        String signature = getMicrocodeSignature();
+        std::array<uint32, 3> header{CACHE_FILE_ID, CACHE_FILE_VERSION, static_cast<uint32>(signature.size())};
+        size_t headerSize = sizeof(header) + signature.size();
+
+        String name = mMicrocodeCacheFile.string();
+        mMicrocodeMapping = MemoryMappedDataStream::open(name, mMicrocodeCacheFile);
+        const uchar* data = mMicrocodeMapping ? mMicrocodeMapping->getPtr() : nullptr;
+        size_t fileSize = mMicrocodeMapping ? mMicrocodeMapping->size() : 0;
+        if (fileSize < headerSize || memcmp(data, header.data(), sizeof(header)) != 0 ||
+            memcmp(data + sizeof(header), signature.data(), signature.size()) != 0)
+        {
+            if (mMicrocodeMapping)
+                LogManager::getSingleton().logMessage(
+                    ::std::format("Microcode cache {} is for another driver, starting anew", name));
+            mMicrocodeMapping.reset();
+
+            std::ofstream file(mMicrocodeCacheFile, std::ios::binary | std::ios::trunc);
+            file.write(reinterpret_cast<const char*>(header.data()), sizeof(header));
+            file.write(signature.data(), signature.size());
+            if (!file)
+                LogManager::getSingleton().logWarning(::std::format("Cannot write microcode cache {}", name));
+            mMicrocodeCacheFileSize = file ? headerSize : 0;
+            return;
+        }
+
+        // a program recorded again replaces its older record, one cut off by a crash ends the file
+        size_t offset = headerSize;
+        while (fileSize - offset >= 2 * sizeof(uint32))
+        {
+            std::array<uint32, 2> record;
+            memcpy(record.data(), data + offset, sizeof(record));
+            size_t dataOffset = offset + sizeof(record);
+            if (record[1] > fileSize - dataOffset)
+                break;
+
+            // an empty record removes the program
+            if (record[1] > 0)
+                mMappedMicrocodes[record[0]] = {dataOffset, record[1]};
+            else
+                mMappedMicrocodes.erase(record[0]);
+            offset = dataOffset + record[1];
+        }
+        mMicrocodeCacheFileSize = offset;
+
+        LogManager::getSingleton().logMessage(
+            ::std::format("Microcode cache {}: {} programs", name, mMappedMicrocodes.size()));
+    }
+    //---------------------------------------------------------------------
+    void GpuProgramManager::appendMicrocodeToFile(uint32 id, const Microcode& microcode)
+    {
+        // the file could not be written
+        if (mMicrocodeCacheFileSize == 0)
+            return;
+
+        // drop the part of a record that was cut off
+        std::error_code ec;
+        if (std::filesystem::file_size(mMicrocodeCacheFile, ec) != mMicrocodeCacheFileSize && !ec)
+            std::filesystem::resize_file(mMicrocodeCacheFile, mMicrocodeCacheFileSize, ec);
+
+        std::array<uint32, 2> record{id, microcode ? static_cast<uint32>(microcode->size()) : 0};
+        std::ofstream file(mMicrocodeCacheFile, std::ios::binary | std::ios::app);
+        file.write(reinterpret_cast<const char*>(record.data()), sizeof(record));
+        if (microcode)
+            file.write(reinterpret_cast<const char*>(microcode->getPtr()), record[1]);
+        file.flush();
+        if (!file)
+        {
+            LogManager::getSingleton().logWarning(
+                ::std::format("Cannot write microcode cache {}", mMicrocodeCacheFile.string()));
+            mMicrocodeCacheFileSize = 0;
+            return;
+        }
+        mMicrocodeCacheFileSize += sizeof(record) + record[1];
+    }
+    //---------------------------------------------------------------------
     //---------------------------------------------------------------------------
     void GpuProgramManager::addFactory(GpuProgramFactory* factory)
     {
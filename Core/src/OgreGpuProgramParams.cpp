@@ -28,6 +28,7 @@ Copyright (c) 2000-2014 Torus Knot Software Ltd
 module;
 
 #include <cassert>
+#include <cstring>
 
 module Ogre.Core;
 
@@ -52,6 +53,8 @@ import :String;
 import :StringConverter;
 import :Vector;
 
+import <algorithm>;
+import <initializer_list>;
 import <ios>;
 import <iterator>;
 import <memory>;
@@ -210,6 +213,7 @@ namespace Ogre
         AutoConstantDefinition{AutoConstantType::LOD_CAMERA_POSITION_OBJECT_SPACE, "lod_camera_position_object_space", 3, ElementType::REAL, ACDataType::NONE},
         AutoConstantDefinition{AutoConstantType::LIGHT_CUSTOM, "light_custom", 4, ElementType::REAL, ACDataType::INT},
         AutoConstantDefinition{AutoConstantType::POINT_PARAMS, "point_params", 4, ElementType::REAL, ACDataType::NONE},
+        AutoConstantDefinition{AutoConstantType::ANIMATION_POSE_WEIGHTS, "animation_pose_weights", 4, ElementType::REAL, ACDataType::INT},
     };
 
     //---------------------------------------------------------------------
@@ -329,6 +333,84 @@ namespace Ogre
 
     }
 
+    //---------------------------------------------------------------------
+    //  GpuConstantBufferLayout methods
+    //---------------------------------------------------------------------
+    auto GpuConstantBufferLayout::build(const GpuNamedConstants& constants, Packing packing) -> GpuConstantBufferLayout
+    {
+        auto alignUp = [](size_t v, size_t a) { return (v + a - 1) / a * a; };
+
+        // array elements are aliased by "name[0]" entries, keep each definition once
+        std::vector<const GpuConstantDefinition*> defs;
+        for (const auto& [name, def] : constants.map)
+        {
+            if (def.isSampler() || def.isSpecialization() || def.constType == GpuConstantType::UNKNOWN)
+                continue;
+            defs.push_back(&def);
+        }
+        std::ranges::sort(defs, {}, &GpuConstantDefinition::physicalIndex);
+        auto dup = std::ranges::unique(defs, {}, &GpuConstantDefinition::physicalIndex);
+        defs.erase(dup.begin(), dup.end());
+
+        GpuConstantBufferLayout layout;
+        size_t offset = 0;
+        for (auto def : defs)
+        {
+            size_t componentSize = def->isDouble() ? 8 : 4;
+            uint32 typeIndex = std::to_underlying(def->constType) % 0x10;
+            // a vector is a matrix with one column
+            uint32 columns = 1, rows = typeIndex;
+            if (typeIndex >= 5)
+            {
+                columns = (typeIndex - 5) / 3 + 2;
+                rows = (typeIndex - 5) % 3 + 2;
+            }
+
+            // vec3 is aligned like vec4
+            size_t columnAlign = (rows == 3 ? 4 : rows) * componentSize;
+            bool isArray = columns > 1 || def->arraySize > 1;
+            if (packing == Packing::STD140 && isArray)
+                columnAlign = alignUp(columnAlign, 16);
+            size_t elementStride = columns * columnAlign;
+            // elementSize may include padding added for the program
+            size_t srcColumnStride = def->elementSize / columns * componentSize;
+            size_t srcElementStride = def->elementSize * componentSize;
+
+            offset = alignUp(offset, columnAlign);
+            for (size_t e = 0; e < def->arraySize; ++e)
+            {
+                for (size_t c = 0; c < columns; ++c)
+                {
+                    auto src = uint32(def->physicalIndex + e * srcElementStride + c * srcColumnStride);
+                    auto dst = uint32(offset + e * elementStride + c * columnAlign);
+                    auto size = uint32(rows * componentSize);
+
+                    auto& copies = layout.copies;
+                    if (!copies.empty() && copies.back().srcOffset + copies.back().size == src &&
+                        copies.back().dstOffset + copies.back().size == dst)
+                        copies.back().size += size;
+                    else
+                        copies.push_back({src, dst, size});
+                }
+            }
+            offset += def->arraySize * elementStride;
+        }
+        layout.bufferSize = alignUp(offset, 16);
+        return layout;
+    }
+    //---------------------------------------------------------------------
+    void GpuConstantBufferLayout::pack(const ConstantList& src, void* dst) const
+    {
+        for (const auto& c : copies)
+            memcpy(static_cast<uchar*>(dst) + c.dstOffset, src.data() + c.srcOffset, c.size);
+    }
+    //---------------------------------------------------------------------
+    void GpuConstantBufferLayout::unpack(const void* src, ConstantList& dst) const
+    {
+        for (const auto& c : copies)
+            memcpy(dst.data() + c.srcOffset, static_cast<const uchar*>(src) + c.dstOffset, c.size);
+    }
+
     //-----------------------------------------------------------------------------
     //      GpuSharedParameters Methods
     //-----------------------------------------------------------------------------
@@ -421,12 +503,27 @@ namespace Ogre
         if (!mDirty)
             return;
 
-        mHardwareBuffer->writeData(0, mConstants.size(), mConstants.data());
+        const auto& layout = getBufferLayout();
+        OgreAssert(mHardwareBuffer->getSizeInBytes() >= layout.bufferSize, "HardwareBuffer too small for the layout");
+        HardwareBufferLockGuard lock{mHardwareBuffer, 0, layout.bufferSize, HardwareBuffer::LockOptions::DISCARD};
+        layout.pack(mConstants, lock.pData);
     }
     void GpuSharedParameters::download()
     {
         OgreAssert(mHardwareBuffer, "not backed by a HardwareBuffer");
-        mHardwareBuffer->readData(0, mConstants.size(), mConstants.data());
+        const auto& layout = getBufferLayout();
+        HardwareBufferLockGuard lock{mHardwareBuffer, 0, layout.bufferSize, HardwareBuffer::LockOptions::READ_ONLY};
+        layout.unpack(lock.pData, mConstants);
+    }
+    //---------------------------------------------------------------------
+    auto GpuSharedParameters::getBufferLayout() const -> const GpuConstantBufferLayout&
+    {
+        if (mBufferLayoutVersion != mVersion)
+        {
+            mBufferLayout = GpuConstantBufferLayout::build(mNamedConstants, GpuConstantBufferLayout::Packing::STD140);
+            mBufferLayoutVersion = mVersion;
+        }
+        return mBufferLayout;
     }
     //---------------------------------------------------------------------
     void GpuSharedParameters::removeAllConstantDefinitions()
@@ -435,6 +532,8 @@ namespace Ogre
         mNamedConstants.map.clear();
         mNamedConstants.bufferSize = 0;
         mConstants.clear();
+
+        ++mVersion;
     }
 
     //---------------------------------------------------------------------
@@ -536,6 +635,7 @@ namespace Ogre
     void GpuSharedParameters::_markDirty()
     {
         mDirty = true;
+        ++mValuesVersion;
     }
     
 
@@ -577,6 +677,8 @@ namespace Ogre
         }
 
         mCopyDataVersion = mSharedParams->getVersion();
+        // the new entries have not been copied yet
+        mCopiedValuesVersion = mSharedParams->getValuesVersion() - 1;
     }
     //---------------------------------------------------------------------
     void GpuSharedParametersUsage::_copySharedParamsToTargetParams() const
@@ -585,6 +687,10 @@ namespace Ogre
         if (mCopyDataVersion != mSharedParams->getVersion())
             const_cast<GpuSharedParametersUsage*>(this)->initCopyData();
 
+        if (mCopiedValuesVersion == mSharedParams->getValuesVersion())
+            return;
+        mCopiedValuesVersion = mSharedParams->getValuesVersion();
+
         // force const call to get*Pointer
         const GpuSharedParameters* sharedParams = mSharedParams.get();
 
@@ -769,6 +875,7 @@ namespace Ogre
         mTransposeMatrices = oth.mTransposeMatrices;
         mIgnoreMissingParams  = oth.mIgnoreMissingParams;
         mActivePassIterationIndex = oth.mActivePassIterationIndex;
+        mLastAutoParamSource = oth.mLastAutoParamSource;
 
         return *this;
     }
@@ -1118,6 +1225,7 @@ namespace Ogre
         case LOD_CAMERA_POSITION_OBJECT_SPACE:
         case CUSTOM:
         case ANIMATION_PARAMETRIC:
+        case ANIMATION_POSE_WEIGHTS:
 
             return GpuParamVariability::PER_OBJECT;
 
@@ -1509,6 +1617,104 @@ namespace Ogre
     }
     //-----------------------------------------------------------------------------
 
+    //-----------------------------------------------------------------------------
+    namespace {
+        using Source = AutoParamDataSource::Source;
+        constexpr auto sourceBit(Source source) -> uint8 { return 1 << std::to_underlying(source); }
+        constexpr uint8 ALL_SOURCES = 0x1F;
+
+        /** The AutoParamDataSource inputs of an auto constant, as bits of sourceBit.
+            0 for constants which change without any setter being called, e.g. the time.
+        */
+        auto deriveSources(GpuProgramParameters::AutoConstantType act) -> uint8
+        {
+            using enum GpuProgramParameters::AutoConstantType;
+            switch(act)
+            {
+            case SURFACE_AMBIENT_COLOUR:
+            case SURFACE_DIFFUSE_COLOUR:
+            case SURFACE_SPECULAR_COLOUR:
+            case SURFACE_EMISSIVE_COLOUR:
+            case SURFACE_SHININESS:
+            case SURFACE_ALPHA_REJECTION_VALUE:
+            case PASS_NUMBER:
+                return sourceBit(Source::PASS);
+
+            case CAMERA_POSITION:
+            case CAMERA_RELATIVE_POSITION:
+            case VIEW_DIRECTION:
+            case VIEW_SIDE_VECTOR:
+            case VIEW_UP_VECTOR:
+            case FOV:
+            case NEAR_CLIP_DISTANCE:
+            case FAR_CLIP_DISTANCE:
+                return sourceBit(Source::CAMERA);
+
+            // camera relative rendering moves the world matrices
+            case WORLD_MATRIX:
+            case INVERSE_WORLD_MATRIX:
+            case TRANSPOSE_WORLD_MATRIX:
+            case INVERSE_TRANSPOSE_WORLD_MATRIX:
+            case WORLD_MATRIX_ARRAY_3x4:
+            case WORLD_MATRIX_ARRAY:
+            case WORLD_DUALQUATERNION_ARRAY_2x4:
+            case WORLD_SCALE_SHEAR_MATRIX_ARRAY_3x4:
+                return sourceBit(Source::CAMERA) | sourceBit(Source::WORLD);
+
+            // renderables may use an identity view or projection, and render targets
+            // may flip the projection
+            case VIEW_MATRIX:
+            case INVERSE_VIEW_MATRIX:
+            case TRANSPOSE_VIEW_MATRIX:
+            case INVERSE_TRANSPOSE_VIEW_MATRIX:
+            case PROJECTION_MATRIX:
+            case INVERSE_PROJECTION_MATRIX:
+            case TRANSPOSE_PROJECTION_MATRIX:
+            case INVERSE_TRANSPOSE_PROJECTION_MATRIX:
+            case VIEWPROJ_MATRIX:
+            case INVERSE_VIEWPROJ_MATRIX:
+            case TRANSPOSE_VIEWPROJ_MATRIX:
+            case INVERSE_TRANSPOSE_VIEWPROJ_MATRIX:
+            case WORLDVIEW_MATRIX:
+            case INVERSE_WORLDVIEW_MATRIX:
+            case TRANSPOSE_WORLDVIEW_MATRIX:
+            case INVERSE_TRANSPOSE_WORLDVIEW_MATRIX:
+            case NORMAL_MATRIX:
+            case WORLDVIEWPROJ_MATRIX:
+            case INVERSE_WORLDVIEWPROJ_MATRIX:
+            case TRANSPOSE_WORLDVIEWPROJ_MATRIX:
+            case INVERSE_TRANSPOSE_WORLDVIEWPROJ_MATRIX:
+            case CAMERA_POSITION_OBJECT_SPACE:
+                return sourceBit(Source::CAMERA) | sourceBit(Source::WORLD) | sourceBit(Source::OTHER);
+
+            case TIME:
+            case TIME_0_X:
+            case COSTIME_0_X:
+            case SINTIME_0_X:
+            case TANTIME_0_X:
+            case TIME_0_X_PACKED:
+            case TIME_0_1:
+            case COSTIME_0_1:
+            case SINTIME_0_1:
+            case TANTIME_0_1:
+            case TIME_0_1_PACKED:
+            case TIME_0_2PI:
+            case COSTIME_0_2PI:
+            case SINTIME_0_2PI:
+            case TANTIME_0_2PI:
+            case TIME_0_2PI_PACKED:
+            case FRAME_TIME:
+            case FPS:
+            case CUSTOM:
+            case LIGHT_CUSTOM:
+            case PASS_ITERATION_NUMBER:
+                return 0;
+
+            default:
+                return ALL_SOURCES;
+            }
+        }
+    }
     //-----------------------------------------------------------------------------
     void GpuProgramParameters::_updateAutoParams(const AutoParamDataSource* source, GpuParamVariability mask)
     {
@@ -1529,12 +1735,43 @@ namespace Ogre
 
         mActivePassIterationIndex = std::numeric_limits<size_t>::max();
 
+        // versions of different sources cannot be compared
+        if (source != mLastAutoParamSource)
+        {
+            for (auto& autoConstant : mAutoConstants)
+                autoConstant.updatedVersion = 0;
+            mLastAutoParamSource = source;
+        }
+
+        uint64 sourceVersions[5];
+        for (auto s : {Source::CAMERA, Source::WORLD, Source::LIGHTS, Source::PASS, Source::OTHER})
+            sourceVersions[std::to_underlying(s)] = source->getSourceVersion(s);
+        uint64 lastVersion = AutoParamDataSource::getLastVersion();
+        size_t updated = 0, skipped = 0;
+
         // Autoconstant index is not a physical index
         for (auto & mAutoConstant : mAutoConstants)
         {
             // Only update needed slots
             if (!!(mAutoConstant.variability & mask))
             {
+                // Skip values whose sources did not change since they were written
+                if (uint8 sources = deriveSources(mAutoConstant.paramType); sources && mAutoConstant.updatedVersion)
+                {
+                    uint64 changedVersion = 0;
+                    for (size_t s = 0; s < 5; ++s)
+                    {
+                        if (sources & (1 << s))
+                            changedVersion = std::max(changedVersion, sourceVersions[s]);
+                    }
+                    if (changedVersion <= mAutoConstant.updatedVersion)
+                    {
+                        ++skipped;
+                        continue;
+                    }
+                }
+                mAutoConstant.updatedVersion = lastVersion;
+                ++updated;
 
                 using enum AutoConstantType;
                 switch(mAutoConstant.paramType)
@@ -1953,6 +2190,7 @@ namespace Ogre
 
                 case CUSTOM:
                 case ANIMATION_PARAMETRIC:
+                case ANIMATION_POSE_WEIGHTS:
                     source->getCurrentRenderable()->_updateCustomGpuParameter(mAutoConstant, this);
                     break;
                 case LIGHT_CUSTOM:
@@ -2169,6 +2407,7 @@ namespace Ogre
             }
         }
 
+        source->_notifyAutoConstantUpdates(updated, skipped);
     }
     //---------------------------------------------------------------------------
     static auto withArrayOffset(const GpuConstantDefinition* def, std::string_view name) -> size_t
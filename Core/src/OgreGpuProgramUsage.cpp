@@ -45,14 +45,17 @@ namespace Ogre
     {
     }
     //-----------------------------------------------------------------------------
-    GpuProgramUsage::GpuProgramUsage(const GpuProgramUsage& oth, Pass* parent)
+    GpuProgramUsage::GpuProgramUsage(const GpuProgramUsage& oth, Pass* parent, bool shareParameters)
         : mParent(parent)
         , mProgram(oth.mProgram)
         // nfz: parameters should be copied not just use a shared ptr to the original
-        , mParameters(new GpuProgramParameters(*oth.mParameters))
+        , mParameters(shareParameters ? oth.mParameters : GpuProgramParametersSharedPtr(new GpuProgramParameters(*oth.mParameters)))
         , mRecreateParams(false)
         , mType(oth.mType)
     {
+        // copied on write, by whichever of the two hands them out first
+        if (shareParameters)
+            mSharedParameters = oth.mSharedParameters = true;
     }
     //---------------------------------------------------------------------
     GpuProgramUsage::~GpuProgramUsage()
@@ -91,9 +94,25 @@ namespace Ogre
     void GpuProgramUsage::setParameters(const GpuProgramParametersSharedPtr& params)
     {
         mParameters = params;
+        mSharedParameters = false;
     }
     //-----------------------------------------------------------------------------
-    auto GpuProgramUsage::getParameters() const noexcept -> const GpuProgramParametersSharedPtr&
+    auto GpuProgramUsage::getParameters() const -> const GpuProgramParametersSharedPtr&
+    {
+        const auto& params = _getParameters();
+
+        if (mSharedParameters)
+        {
+            // the last one holding them can keep them
+            if (params.use_count() > 1)
+                mParameters = std::make_shared<GpuProgramParameters>(*params);
+            mSharedParameters = false;
+        }
+
+        return mParameters;
+    }
+    //-----------------------------------------------------------------------------
+    auto GpuProgramUsage::_getParameters() const -> const GpuProgramParametersSharedPtr&
     {
         if (!mParameters)
         {
@@ -188,6 +207,7 @@ namespace Ogre
             mParameters->copyMatchingNamedConstantsFrom(*savedParams.get());
 
         mRecreateParams = false;
+        mSharedParameters = false;
 
     }
 
@@ -36,6 +36,7 @@ import :Exception;
 import :HardwareBuffer;
 import :HardwareBufferManager;
 import :HardwareVertexBuffer;
+import :HitchMonitor;
 import :Log;
 import :LogManager;
 import :Prerequisites;
@@ -176,6 +177,7 @@ namespace Ogre {
             mFreeTempVertexBufferMap.find(sourceBuffer.get());
         if (i == mFreeTempVertexBufferMap.end())
         {
+            HitchMonitor::Scope activity{HitchMonitor::ActivityType::BUFFER_ALLOCATION, "vertex buffer copy"};
             // copy buffer, use shadow buffer and make dynamic
             vbuf = makeBufferCopy(
                 sourceBuffer,
@@ -234,6 +236,7 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     void HardwareBufferManagerBase::_freeUnusedBufferCopies()
     {
+        HitchMonitor::Scope activity{HitchMonitor::ActivityType::BUFFER_CLEANUP, "_freeUnusedBufferCopies"};
         size_t numFreed = 0;
 
         // Free unused temporary buffers
@@ -29,6 +29,7 @@ module Ogre.Core;
 
 import :DefaultHardwareBufferManager;
 import :Exception;
+import :HardwareBufferManager;
 import :HardwareIndexBuffer;
 import :RenderSystem;
 import :RenderSystemCapabilities;
@@ -62,7 +63,9 @@ namespace Ogre {
         // Create a shadow buffer if required
         if (useShadowBuffer)
         {
-            mShadowBuffer = std::make_unique<DefaultHardwareBuffer>(mSizeInBytes);
+            setShadowBuffer(createShadowBufferImpl());
+            if (mMgr && mMgr->getDiscardStaticShadowBuffers() && not(mUsage bitand HardwareBufferUsage::CPU_ONLY))
+                mDiscardShadowAfterUpload = true;
         }
     }
 
@@ -77,5 +80,10 @@ namespace Ogre {
     //-----------------------------------------------------------------------------
     HardwareIndexBuffer::~HardwareIndexBuffer()
     = default;
+    //-----------------------------------------------------------------------------
+    auto HardwareIndexBuffer::createShadowBufferImpl() const -> std::unique_ptr<HardwareBuffer>
+    {
+        return std::make_unique<DefaultHardwareBuffer>(mSizeInBytes);
+    }
 
 }
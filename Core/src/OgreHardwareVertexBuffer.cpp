@@ -64,7 +64,9 @@ namespace Ogre {
         // Create a shadow buffer if required
         if (useShadowBuffer)
         {
-            mShadowBuffer = std::make_unique<DefaultHardwareBuffer>(mSizeInBytes);
+            setShadowBuffer(createShadowBufferImpl());
+            if (mMgr && mMgr->getDiscardStaticShadowBuffers() && not(mUsage bitand HardwareBufferUsage::CPU_ONLY))
+                mDiscardShadowAfterUpload = true;
         }
 
     }
@@ -84,6 +86,11 @@ namespace Ogre {
         }
     }
     //-----------------------------------------------------------------------------
+    auto HardwareVertexBuffer::createShadowBufferImpl() const -> std::unique_ptr<HardwareBuffer>
+    {
+        return std::make_unique<DefaultHardwareBuffer>(mSizeInBytes);
+    }
+    //-----------------------------------------------------------------------------
     auto HardwareVertexBuffer::checkIfVertexInstanceDataIsSupported() -> bool
     {
         // Use the current render system
@@ -167,6 +174,7 @@ namespace Ogre {
         case SHORT2_NORM:
         case USHORT2:
         case USHORT2_NORM:
+        case HALF2:
             return sizeof( short ) * 2;
         case SHORT3:
         case USHORT3:
@@ -175,6 +183,7 @@ namespace Ogre {
         case SHORT4_NORM:
         case USHORT4:
         case USHORT4_NORM:
+        case HALF4:
             return sizeof( short ) * 4;
         case INT1:
         case UINT1:
@@ -194,6 +203,8 @@ namespace Ogre {
         case UBYTE4_NORM:
         case _DETAIL_SWAP_RB:
             return sizeof(char)*4;
+        case INT_10_10_10_2_NORM:
+            return sizeof(uint32);
         }
         return 0;
     }
@@ -218,6 +229,7 @@ namespace Ogre {
         case UINT2:
         case INT2:
         case DOUBLE2:
+        case HALF2:
             return 2;
         case FLOAT3:
         case SHORT3:
@@ -239,6 +251,8 @@ namespace Ogre {
         case BYTE4_NORM:
         case UBYTE4_NORM:
         case _DETAIL_SWAP_RB:
+        case HALF4:
+        case INT_10_10_10_2_NORM:
             return 4;
         }
         OGRE_EXCEPT(ExceptionCodes::INVALIDPARAMS, "Invalid type", 
@@ -290,10 +304,18 @@ namespace Ogre {
             }
             return USHORT4_NORM;
 
+        case HALF2:
+            if ( count <= 2 )
+            {
+                return HALF2;
+            }
+            return HALF4;
+
         case BYTE4:
         case BYTE4_NORM:
         case UBYTE4:
         case UBYTE4_NORM:
+        case INT_10_10_10_2_NORM:
             return baseType;
 
         default:
@@ -369,6 +391,11 @@ namespace Ogre {
             case UBYTE4_NORM:
             case _DETAIL_SWAP_RB:
                 return UBYTE4_NORM;
+            case HALF2:
+            case HALF4:
+                return HALF2;
+            case INT_10_10_10_2_NORM:
+                return INT_10_10_10_2_NORM;
         };
         // To keep compiler happy
         return FLOAT1;
@@ -0,0 +1,258 @@
+// This file is part of the OGRE project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at https://www.ogre3d.org/licensing.
+module;
+
+#include <cstddef>
+
+module Ogre.Core;
+
+import :AxisAlignedBox;
+import :Camera;
+import :CompositionPass;
+import :CompositorChain;
+import :CompositorInstance;
+import :CompositorManager;
+import :DepthBuffer;
+import :Exception;
+import :GpuProgramParams;
+import :HardwarePixelBuffer;
+import :HiZBuffer;
+import :Image;
+import :Material;
+import :MaterialManager;
+import :Math;
+import :Pass;
+import :PixelFormat;
+import :RenderSystem;
+import :RenderTarget;
+import :RenderTexture;
+import :SceneManager;
+import :Technique;
+import :Texture;
+import :TextureManager;
+import :TextureUnitState;
+import :Viewport;
+
+import <algorithm>;
+import <cmath>;
+import <format>;
+import <limits>;
+import <string>;
+import <utility>;
+import <vector>;
+
+namespace Ogre {
+
+    namespace {
+        /// Builds the HiZBuffer from the input of a render_custom pass
+        class HiZBuildOperation : public CompositorInstance::RenderSystemOperation
+        {
+        public:
+            HiZBuildOperation(HiZBuffer* owner, CompositorInstance* instance, const CompositionPass* pass)
+                : mOwner(owner), mInstance(instance)
+            {
+                OgreAssert(pass->getNumInputs() > 0, "HiZBuffer pass without depth input");
+                const CompositionPass::InputTex& input = pass->getInput(0);
+                mInputName = input.name;
+                mInputMRTIndex = input.mrtIndex;
+            }
+
+            void execute(SceneManager* sm, RenderSystem* rs) override
+            {
+                const TexturePtr& source = mInstance->getTextureInstance(mInputName, mInputMRTIndex);
+                OgreAssert(source, "HiZBuffer pass input not found");
+                mOwner->_build(sm, rs, source, mInstance->getChain()->getViewport()->getCamera());
+            }
+
+        private:
+            HiZBuffer* mOwner;
+            CompositorInstance* mInstance;
+            String mInputName;
+            size_t mInputMRTIndex;
+        };
+    }
+    //-----------------------------------------------------------------------
+    HiZBuffer::HiZBuffer() = default;
+    //-----------------------------------------------------------------------
+    HiZBuffer::~HiZBuffer()
+    {
+        destroyTexture();
+    }
+    //-----------------------------------------------------------------------
+    auto HiZBuffer::createOperation(CompositorInstance* instance, const CompositionPass* pass)
+        -> CompositorInstance::RenderSystemOperation*
+    {
+        return new HiZBuildOperation(this, instance, pass);
+    }
+    //-----------------------------------------------------------------------
+    void HiZBuffer::createTexture(uint32 width, uint32 height, std::string_view group)
+    {
+        destroyTexture();
+
+        // down to 1x1, each level the floor of half the one before
+        auto levels = static_cast<uint32>(std::floor(std::log2(std::max(width, height)))) + 1;
+        mTexture = TextureManager::getSingleton().createManual(
+            std::format("Ogre/HiZBuffer/{}", static_cast<const void*>(this)), group, TextureType::_2D, width, height,
+            static_cast<TextureMipmap>(levels - 1), PixelFormat::FLOAT32_R, TextureUsage::RENDERTARGET);
+
+        for (uint32 level = 0; level < levels; ++level)
+        {
+            RenderTexture* rt = mTexture->getBuffer(0, static_cast<TextureMipmap>(level))->getRenderTarget();
+            rt->setAutoUpdated(false);
+            rt->setDepthBufferPool(DepthBuffer::PoolId::NO_DEPTH);
+            Viewport* vp = rt->addViewport(nullptr);
+            vp->setClearEveryFrame(false);
+            vp->setOverlaysEnabled(false);
+            mLevelViewports.push_back(vp);
+        }
+        mFrame.size = {Real(width), Real(height), Real(levels), 0};
+    }
+    //-----------------------------------------------------------------------
+    void HiZBuffer::destroyTexture()
+    {
+        mLevelViewports.clear();
+        if (mTexture)
+            TextureManager::getSingleton().remove(mTexture);
+        mTexture.reset();
+        mReadback.clear();
+        mReadbackWidth = mReadbackHeight = 0;
+        mCamera = nullptr;
+    }
+    //-----------------------------------------------------------------------
+    void HiZBuffer::_build(SceneManager* sceneMgr, RenderSystem* rs, const TexturePtr& source, const Camera* cam)
+    {
+        uint32 width = std::max(source->getWidth() / 2, 1u);
+        uint32 height = std::max(source->getHeight() / 2, 1u);
+        if (!mTexture || mTexture->getWidth() != width || mTexture->getHeight() != height)
+            createTexture(width, height, source->getGroup());
+
+        MaterialPtr material = MaterialManager::getSingleton().getByName("Ogre/HiZ/Reduce");
+        OgreAssert(material, "Ogre/HiZ/Reduce material not found");
+        material->load();
+        Pass* pass = material->getBestTechnique()->getPass(0);
+        TextureUnitState* tus = pass->getTextureUnitState(0);
+        const GpuProgramParametersSharedPtr& params = pass->getFragmentProgramParameters();
+
+        Viewport* previousViewport = rs->_getViewport();
+        uint32 sourceWidth = source->getWidth(), sourceHeight = source->getHeight();
+        for (uint32 level = 0; level < mLevelViewports.size(); ++level)
+        {
+            rs->_setViewport(mLevelViewports[level]);
+            tus->_setTexturePtr(level == 0 ? source : mTexture);
+            params->setNamedConstant("sourceSize", Vector4{Real(sourceWidth), Real(sourceHeight),
+                                                           Real(level == 0 ? 0 : level - 1), Real(level == 0)});
+            sceneMgr->_injectRenderWithPass(pass, CompositorManager::getSingleton()._getTexturedRectangle2D(), false);
+
+            sourceWidth = std::max(sourceWidth / 2, 1u);
+            sourceHeight = std::max(sourceHeight / 2, 1u);
+        }
+        tus->_setTexturePtr(nullptr);
+        rs->_setViewport(previousViewport);
+
+        mCamera = cam;
+        mFrame.viewProj = cam->getProjectionMatrix() * cam->getViewMatrix();
+        const Vector3& position = cam->getDerivedPosition();
+        mFrame.cameraPosition = {position.x, position.y, position.z, cam->getFarClipDistance()};
+
+        if (mMaxReadbackWidth == 0)
+        {
+            mReadback.clear();
+            mReadbackWidth = mReadbackHeight = 0;
+            return;
+        }
+
+        // the first level narrow enough
+        uint32 level = 0;
+        mReadbackWidth = width;
+        mReadbackHeight = height;
+        while (mReadbackWidth > mMaxReadbackWidth && level + 1 < mLevelViewports.size())
+        {
+            ++level;
+            mReadbackWidth = std::max(mReadbackWidth / 2, 1u);
+            mReadbackHeight = std::max(mReadbackHeight / 2, 1u);
+        }
+        mReadback.resize(size_t(mReadbackWidth) * mReadbackHeight);
+        mTexture->getBuffer(0, static_cast<TextureMipmap>(level))
+            ->blitToMemory(PixelBox{mReadbackWidth, mReadbackHeight, 1, PixelFormat::FLOAT32_R, mReadback.data()});
+    }
+    //-----------------------------------------------------------------------
+    void HiZBuffer::_beginFrame(const Camera* cam, SceneManager* sceneMgr)
+    {
+        (void)sceneMgr;
+        mStats = {};
+        // the distances are relative to the far clip distance
+        mActive = cam == mCamera && !mReadback.empty() && mFrame.cameraPosition.w > 0;
+    }
+    //-----------------------------------------------------------------------
+    auto HiZBuffer::_isVisible(const SceneNode* node, const AxisAlignedBox& bounds) -> bool
+    {
+        (void)node;
+        if (!mActive)
+            return true;
+
+        ++mStats.nodesTested;
+        if (!bounds.isFinite())
+            return true;
+
+        // screen rectangle of the bounds as seen by the camera of the buffer
+        Real minX = std::numeric_limits<Real>::max(), maxX = -minX;
+        Real minY = minX, maxY = maxX;
+        for (const Vector3& corner : bounds.getAllCorners())
+        {
+            Vector4 clip = mFrame.viewProj * Vector4{corner.x, corner.y, corner.z, 1};
+            // crossing the near plane, the box surrounds the camera
+            if (clip.z + clip.w <= 0)
+                return true;
+
+            Real invW = 1 / clip.w;
+            Real x = (clip.x * invW * 0.5f + 0.5f) * Real(mReadbackWidth);
+            Real y = (0.5f - clip.y * invW * 0.5f) * Real(mReadbackHeight);
+            minX = std::min(minX, x); maxX = std::max(maxX, x);
+            minY = std::min(minY, y); maxY = std::max(maxY, y);
+        }
+
+        auto x0 = int32(std::max(std::floor(minX), Real(0)));
+        auto x1 = int32(std::min(std::floor(maxX), Real(mReadbackWidth) - 1));
+        auto y0 = int32(std::max(std::floor(minY), Real(0)));
+        auto y1 = int32(std::min(std::floor(maxY), Real(mReadbackHeight) - 1));
+        // the frustum culling decides about bounds off the screen
+        if (x0 > x1 || y0 > y1)
+            return true;
+
+        // the closest any point of the bounds can be, in the units of the buffer
+        Vector3 position{mFrame.cameraPosition.x, mFrame.cameraPosition.y, mFrame.cameraPosition.z};
+        Vector3 closest = position;
+        closest.makeCeil(bounds.getMinimum());
+        closest.makeFloor(bounds.getMaximum());
+        Real distance = position.distance(closest) / mFrame.cameraPosition.w;
+
+        for (int32 y = y0; y <= y1; ++y)
+        {
+            const float* row = &mReadback[size_t(y) * mReadbackWidth];
+            for (int32 x = x0; x <= x1; ++x)
+            {
+                if (row[x] >= distance)
+                    return true;
+            }
+        }
+
+        ++mStats.nodesCulled;
+        return false;
+    }
+    //-----------------------------------------------------------------------
+    void HiZBuffer::_endFrame(SceneManager* sceneMgr)
+    {
+        (void)sceneMgr;
+        mActive = false;
+    }
+    //-----------------------------------------------------------------------
+    void HiZBuffer::_notifyCameraDestroyed(const Camera* cam)
+    {
+        if (cam == mCamera)
+        {
+            mCamera = nullptr;
+            mActive = false;
+        }
+    }
+}
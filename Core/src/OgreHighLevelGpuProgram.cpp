@@ -277,7 +277,8 @@ namespace Ogre
     }
 
     //-----------------------------------------------------------------------
-    auto HighLevelGpuProgram::_resolveIncludes(std::string_view inSource, Resource* resourceBeingLoaded, std::string_view fileName, bool supportsFilename) -> String
+    auto HighLevelGpuProgram::_resolveIncludes(std::string_view inSource, Resource* resourceBeingLoaded, std::string_view fileName,
+                                               bool supportsFilename, IncludeCache* includeCache) -> String
     {
         String outSource;
         // output will be at least this big
@@ -353,10 +354,6 @@ namespace Ogre
             // extract filename
             String filename(inSource.substr(startIt+1, endIt-startIt-1));
 
-            // open included file
-            DataStreamPtr resource = ResourceGroupManager::getSingleton().
-                openResource(filename, resourceBeingLoaded->getGroup(), resourceBeingLoaded);
-
             // replace entire include directive line
             // copy up to just before include
             if (newLineBefore != String::npos && newLineBefore >= startMarker)
@@ -371,8 +368,29 @@ namespace Ogre
             // Add #line to the start of the included file to correct the line count)
             outSource.append(::std::format("#line 1 {}\n", incLineFilename));
 
-            // recurse into include
-            outSource.append(_resolveIncludes(resource->getAsString(), resourceBeingLoaded, filename, supportsFilename));
+            // recurse into include, unless it was expanded before
+            String cacheKey;
+            IncludeCache::const_iterator cached;
+            if (includeCache)
+            {
+                cacheKey = std::format("{}:{}", resourceBeingLoaded->getGroup(), filename);
+                cached = includeCache->find(cacheKey);
+            }
+            if (includeCache && cached != includeCache->end())
+            {
+                outSource.append(cached->second);
+            }
+            else
+            {
+                // open included file
+                DataStreamPtr resource = ResourceGroupManager::getSingleton().
+                    openResource(filename, resourceBeingLoaded->getGroup(), resourceBeingLoaded);
+                String expanded =
+                    _resolveIncludes(resource->getAsString(), resourceBeingLoaded, filename, supportsFilename, includeCache);
+                outSource.append(expanded);
+                if (includeCache)
+                    includeCache->emplace(std::move(cacheKey), std::move(expanded));
+            }
 
             // Add #line to the end of the included file to correct the line count.
             // +1 as #line specifies the number of the following line
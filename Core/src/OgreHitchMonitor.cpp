@@ -0,0 +1,277 @@
+// This file is part of the OGRE project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at https://www.ogre3d.org/licensing.
+module;
+
+#include <cassert>
+#include <cstddef>
+
+module Ogre.Core;
+
+import :Exception;
+import :HitchMonitor;
+import :Log;
+import :LogManager;
+import :Platform;
+import :Profiler;
+import :Singleton;
+import :String;
+
+import <algorithm>;
+import <chrono>;
+import <filesystem>;
+import <format>;
+import <fstream>;
+import <mutex>;
+import <ostream>;
+import <string>;
+import <string_view>;
+import <vector>;
+
+namespace Ogre {
+
+namespace {
+    /// the clock of the Profiler trace
+    auto steadyNanoseconds() -> uint64
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    auto getTypeName(HitchMonitor::ActivityType type) -> std::string_view
+    {
+        using enum HitchMonitor::ActivityType;
+        switch (type)
+        {
+        case RESOURCE_LOAD:
+            return "Resource load";
+        case SHADER_COMPILE:
+            return "Shader compilation";
+        case BUFFER_ALLOCATION:
+            return "Buffer allocation";
+        case BUFFER_CLEANUP:
+            return "Buffer cleanup";
+        case USER:
+            break;
+        }
+        return "User";
+    }
+
+    /// activities of the frame listed in the log at most
+    constexpr size_t MAX_LOGGED_ACTIVITIES = 16;
+}
+    //---------------------------------------------------------------------
+    template<> HitchMonitor* Singleton<HitchMonitor>::msSingleton = nullptr;
+    auto HitchMonitor::getSingletonPtr() noexcept -> HitchMonitor*
+    {
+        return msSingleton;
+    }
+    auto HitchMonitor::getSingleton() noexcept -> HitchMonitor&
+    {
+        assert( msSingleton );  return ( *msSingleton );
+    }
+    //---------------------------------------------------------------------
+    HitchMonitor::Scope::Scope(ActivityType type, std::string_view name)
+        : mType(type), mName(name)
+    {
+        HitchMonitor* monitor = getSingletonPtr();
+        if (monitor && monitor->isEnabled())
+            mStart = steadyNanoseconds();
+    }
+    //---------------------------------------------------------------------
+    HitchMonitor::Scope::~Scope()
+    {
+        if (!mStart)
+            return;
+        if (HitchMonitor* monitor = getSingletonPtr())
+            monitor->_recordActivity(mType, mName, mStart, steadyNanoseconds());
+    }
+    //---------------------------------------------------------------------
+    HitchMonitor::HitchMonitor() : mFrames(60) {}
+    //---------------------------------------------------------------------
+    HitchMonitor::~HitchMonitor()
+    {
+        setEnabled(false);
+    }
+    //---------------------------------------------------------------------
+    void HitchMonitor::setEnabled(bool enabled)
+    {
+        if (enabled == isEnabled())
+            return;
+
+        Profiler& profiler = Profiler::getSingleton();
+        if (enabled)
+        {
+            mCapturedBefore = profiler.getTraceCapture();
+            // a new capture, so the events start along with the first frame
+            profiler.setTraceCapture(false);
+            profiler.setTraceCapture(true);
+            mEpoch = steadyNanoseconds() - profiler._getTraceTime();
+            mLastFrameEnd = 0;
+
+            for (Frame& frame : mFrames)
+            {
+                frame.duration = 0;
+                frame.events.clear();
+                frame.activities.clear();
+            }
+            mNextFrame = 0;
+            mHitchCount = 0;
+
+            std::lock_guard lock{mActivityMutex};
+            mPendingActivities.clear();
+        }
+        else
+        {
+            profiler.setTraceCapture(mCapturedBefore);
+        }
+
+        mEnabled.store(enabled, std::memory_order_release);
+    }
+    //---------------------------------------------------------------------
+    void HitchMonitor::setFrameHistory(size_t frames)
+    {
+        OgreAssert(frames > 0, "at least the reported frame must be kept");
+        // keep the most recent frames, oldest first
+        std::ranges::rotate(mFrames, mFrames.begin() + mNextFrame);
+        if (frames < mFrames.size())
+            mFrames.erase(mFrames.begin(), mFrames.end() - frames);
+        else
+            mFrames.insert(mFrames.begin(), frames - mFrames.size(), Frame{});
+        mNextFrame = 0;
+    }
+    //---------------------------------------------------------------------
+    auto HitchMonitor::getFrames() const -> std::vector<const Frame*>
+    {
+        std::vector<const Frame*> frames;
+        for (size_t i = 0; i < mFrames.size(); ++i)
+        {
+            const Frame& frame = mFrames[(mNextFrame + i) % mFrames.size()];
+            if (frame.duration)
+                frames.push_back(&frame);
+        }
+        return frames;
+    }
+    //---------------------------------------------------------------------
+    void HitchMonitor::_recordActivity(ActivityType type, std::string_view name, uint64 start, uint64 end)
+    {
+        // mEpoch is set before enabling
+        if (!mEnabled.load(std::memory_order_acquire) || start < mEpoch)
+            return;
+
+        std::lock_guard lock{mActivityMutex};
+        mPendingActivities.push_back({type, String{name}, start - mEpoch, end - start});
+    }
+    //---------------------------------------------------------------------
+    void HitchMonitor::_frameEnded(unsigned long frameNumber)
+    {
+        if (!isEnabled())
+            return;
+
+        // reuse the storage of the oldest frame
+        Frame& frame = mFrames[mNextFrame];
+        mNextFrame = (mNextFrame + 1) % mFrames.size();
+
+        uint64 now = steadyNanoseconds() - mEpoch;
+        frame.number = frameNumber;
+        frame.start = mLastFrameEnd;
+        frame.duration = std::max<uint64>(now - mLastFrameEnd, 1);
+        mLastFrameEnd = now;
+
+        Profiler::getSingleton()._takeTraceEvents(frame.events);
+        {
+            std::lock_guard lock{mActivityMutex};
+            frame.activities.clear();
+            frame.activities.swap(mPendingActivities);
+        }
+
+        if (frame.duration > mThreshold * 1000)
+            report(frame);
+    }
+    //---------------------------------------------------------------------
+    void HitchMonitor::report(const Frame& frame)
+    {
+        ++mHitchCount;
+
+        Log::Stream stream = LogManager::getSingleton().stream(LogMessageLevel::Warning);
+        stream << std::format("HitchMonitor: frame {} took {:.1f} ms, {} profiles and {} activities",
+                              frame.number, frame.duration / 1e6, frame.events.size(), frame.activities.size());
+
+        // the longest activities first
+        std::vector<const Activity*> activities;
+        for (const Activity& activity : frame.activities)
+            activities.push_back(&activity);
+        std::ranges::sort(activities, std::ranges::greater{}, &Activity::duration);
+        for (size_t i = 0; i < std::min(activities.size(), MAX_LOGGED_ACTIVITIES); ++i)
+        {
+            stream << std::format("\n  {} '{}': {:.2f} ms", getTypeName(activities[i]->type), activities[i]->name,
+                                  activities[i]->duration / 1e6);
+        }
+        if (activities.size() > MAX_LOGGED_ACTIVITIES)
+            stream << std::format("\n  and {} more", activities.size() - MAX_LOGGED_ACTIVITIES);
+
+        if (mReportDirectory.empty())
+            return;
+
+        auto path = std::filesystem::path{mReportDirectory} / std::format("hitch_{}.json", frame.number);
+        std::ofstream file{path};
+        if (!file)
+        {
+            stream << "\n  failed to write " << path.string();
+            return;
+        }
+        writeReport(file);
+        stream << "\n  trace written to " << path.string();
+    }
+    //---------------------------------------------------------------------
+    void HitchMonitor::writeReport(std::ostream& stream) const
+    {
+        std::vector<const Frame*> frames = getFrames();
+
+        uint32 threads = 1;
+        for (const Frame* frame : frames)
+            for (const ProfileTraceEvent& event : frame->events)
+                threads = std::max(threads, event.thread + 1);
+
+        // the profiles by thread in the first process, the frames and activities in the second
+        stream << "{\"traceEvents\":[\n";
+        stream << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"Profiles\"}},\n"
+                  "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":2,\"args\":{\"name\":\"Frames\"}},\n"
+                  "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":2,\"tid\":0,\"args\":{\"name\":\"Frames\"}}";
+        for (uint32 i = 0; i < threads; ++i)
+        {
+            stream << std::format(",\n{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":{},"
+                                  "\"args\":{{\"name\":\"{}\"}}}}",
+                                  i, i == 0 ? String("Main") : std::format("Thread {}", i));
+        }
+        for (auto type = uint8(ActivityType::RESOURCE_LOAD); type <= uint8(ActivityType::USER); ++type)
+        {
+            stream << std::format(",\n{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":2,\"tid\":{},"
+                                  "\"args\":{{\"name\":\"{}\"}}}}",
+                                  type + 1, getTypeName(ActivityType(type)));
+        }
+
+        for (const Frame* frame : frames)
+        {
+            stream << std::format(",\n{{\"name\":\"Frame {}\",\"cat\":\"Frame\",\"ph\":\"X\",\"ts\":{:.3f},"
+                                  "\"dur\":{:.3f},\"pid\":2,\"tid\":0}}",
+                                  frame->number, frame->start / 1000.0, frame->duration / 1000.0);
+            for (const ProfileTraceEvent& event : frame->events)
+            {
+                stream << std::format(",\n{{\"name\":\"{}\",\"cat\":\"Ogre\",\"ph\":\"X\",\"ts\":{:.3f},"
+                                      "\"dur\":{:.3f},\"pid\":1,\"tid\":{}}}",
+                                      StringUtil::escapeJson(event.name), event.start / 1000.0, event.duration / 1000.0,
+                                      event.thread);
+            }
+            for (const Activity& activity : frame->activities)
+            {
+                stream << std::format(",\n{{\"name\":\"{}\",\"cat\":\"{}\",\"ph\":\"X\",\"ts\":{:.3f},"
+                                      "\"dur\":{:.3f},\"pid\":2,\"tid\":{}}}",
+                                      StringUtil::escapeJson(activity.name), getTypeName(activity.type),
+                                      activity.start / 1000.0, activity.duration / 1000.0,
+                                      uint8(activity.type) + 1);
+            }
+        }
+        stream << "\n],\"displayTimeUnit\":\"ns\"}\n";
+    }
+}
@@ -32,6 +32,9 @@ module;
 
 module Ogre.Core;
 
+import :Bitwise;
+import :BlockDecoder;
+import :BlockEncoder;
 import :Codec;
 import :DataStream;
 import :Exception;
@@ -40,11 +43,14 @@ import :ImageCodec;
 import :ImageResampler;
 import :Math;
 import :ResourceGroupManager;
+import :Root;
 import :SharedPtr;
 import :String;
+import :WorkQueue;
 
 import <algorithm>;
 import <any>;
+import <format>;
 import <memory>;
 import <span>;
 
@@ -73,18 +79,21 @@ namespace Ogre {
 
     auto ImageCodec::encode(::std::any const& input) const -> DataStreamPtr
     {
-        auto* src = any_cast<Image*>(input);
-
+        return encode(*any_cast<Image*>(input), -1);
+    }
+    auto ImageCodec::encode(const Image& image, int compressionLevel) const -> DataStreamPtr
+    {
         auto imgData = std::make_shared<ImageCodec::ImageData>();
-        imgData->format = src->getFormat();
-        imgData->height = src->getHeight();
-        imgData->width = src->getWidth();
-        imgData->depth = src->getDepth();
-        imgData->size = src->getSize();
-        imgData->num_mipmaps = src->getNumMipmaps();
+        imgData->format = image.getFormat();
+        imgData->height = image.getHeight();
+        imgData->width = image.getWidth();
+        imgData->depth = image.getDepth();
+        imgData->size = image.getSize();
+        imgData->num_mipmaps = image.getNumMipmaps();
+        imgData->compressionLevel = compressionLevel;
 
         // Wrap memory, be sure not to delete when stream destroyed
-        auto wrapper = std::make_shared<MemoryDataStream>(src->getData(), src->getSize(), false);
+        auto wrapper = std::make_shared<MemoryDataStream>(const_cast<uchar*>(image.getData()), image.getSize(), false);
         return encode(wrapper, imgData);
     }
     void ImageCodec::encodeToFile(::std::any const& input, std::string_view outFileName) const
@@ -334,11 +343,17 @@ namespace Ogre {
         Codec::getCodec(ext)->encodeToFile(this, filename);
     }
     //---------------------------------------------------------------------
-    auto Image::encode(std::string_view formatextension) -> DataStreamPtr
+    auto Image::encode(std::string_view formatextension, int compressionLevel) -> DataStreamPtr
     {
         OgreAssert(mBuffer, "No image data loaded");
         // getCodec throws when no codec is found
-        return Codec::getCodec(formatextension)->encode(this);
+        Codec* codec = Codec::getCodec(formatextension);
+        if (compressionLevel < 0)
+            return codec->encode(this);
+
+        auto* imageCodec = dynamic_cast<ImageCodec*>(codec);
+        OgreAssert(imageCodec, "not an image codec");
+        return imageCodec->encode(*this, compressionLevel);
     }
     //-----------------------------------------------------------------------------
     auto Image::load(const DataStreamPtr& stream, std::string_view type ) -> Image &
@@ -500,7 +515,130 @@ namespace Ogre {
         Image::scale(temp.getPixelBox(), getPixelBox(), filter);
     }
     //-----------------------------------------------------------------------
-    void Image::scale(const PixelBox &src, const PixelBox &scaled, Filter filter) 
+    void Image::generateMipmaps(bool gammaCorrect, Filter filter)
+    {
+        OgreAssert(mBuffer, "No image data loaded");
+        OgreAssert(mAutoDelete, "generating mipmaps of dynamic images is not supported");
+        OgreAssert(!PixelUtil::isCompressed(mFormat), "compressed formats are not supported");
+
+        auto numMips = static_cast<TextureMipmap>(Bitwise::mostSignificantBitSet(std::max({mWidth, mHeight, mDepth})));
+        uint32 numFaces = getNumFaces();
+
+        // reassign buffer to temp image, make sure auto-delete is true
+        Image temp;
+        temp.loadDynamicImage(mBuffer, mWidth, mHeight, mDepth, mFormat, true, numFaces, mNumMipmaps);
+
+        // do not delete[] mBuffer!  temp will destroy it
+        mBuffer = nullptr;
+        create(mFormat, mWidth, mHeight, mDepth, numFaces, numMips);
+
+        for (uint32 face = 0; face < numFaces; ++face)
+        {
+            PixelUtil::bulkPixelConversion(temp.getPixelBox(face), getPixelBox(face));
+            for (uint32 mip = 1; mip <= std::to_underlying(numMips); ++mip)
+            {
+                Image::scale(getPixelBox(face, static_cast<TextureMipmap>(mip - 1)),
+                             getPixelBox(face, static_cast<TextureMipmap>(mip)), filter, gammaCorrect);
+            }
+        }
+    }
+    //-----------------------------------------------------------------------
+    auto Image::compress(PixelFormat format) -> Image&
+    {
+        OgreAssert(mBuffer, "No image data loaded");
+        OgreAssert(!PixelUtil::isCompressed(mFormat), "the image is compressed already");
+        if (!BlockEncoder::isSupported(format))
+            OGRE_EXCEPT(ExceptionCodes::INVALIDPARAMS,
+                        ::std::format("Encoding {} is not supported", PixelUtil::getFormatName(format)));
+
+        uint32 numFaces = getNumFaces();
+
+        // hand the buffer over to temp, it deletes the buffer if we own it
+        Image temp;
+        temp.loadDynamicImage(mBuffer, mWidth, mHeight, mDepth, mFormat, mAutoDelete, numFaces, mNumMipmaps);
+
+        mBuffer = nullptr;
+        create(format, mWidth, mHeight, mDepth, numFaces, mNumMipmaps);
+
+        for (uint32 face = 0; face < numFaces; ++face)
+        {
+            for (uint8 mip = 0; mip <= std::to_underlying(mNumMipmaps); ++mip)
+            {
+                auto mipmap = static_cast<TextureMipmap>(mip);
+                BlockEncoder::encode(temp.getPixelBox(face, mipmap), format,
+                                     static_cast<uchar*>(getPixelBox(face, mipmap).data));
+            }
+        }
+        return *this;
+    }
+    //-----------------------------------------------------------------------
+    auto Image::decompress() -> Image&
+    {
+        OgreAssert(mBuffer, "No image data loaded");
+        if (!BlockDecoder::isSupported(mFormat))
+            OGRE_EXCEPT(ExceptionCodes::INVALIDPARAMS,
+                        ::std::format("Decoding {} is not supported", PixelUtil::getFormatName(mFormat)));
+
+        uint32 numFaces = getNumFaces();
+
+        // hand the buffer over to temp, it deletes the buffer if we own it
+        Image temp;
+        temp.loadDynamicImage(mBuffer, mWidth, mHeight, mDepth, mFormat, mAutoDelete, numFaces, mNumMipmaps);
+
+        mBuffer = nullptr;
+        create(PixelFormat::BYTE_RGBA, mWidth, mHeight, mDepth, numFaces, mNumMipmaps);
+
+        for (uint32 face = 0; face < numFaces; ++face)
+        {
+            for (uint8 mip = 0; mip <= std::to_underlying(mNumMipmaps); ++mip)
+            {
+                auto mipmap = static_cast<TextureMipmap>(mip);
+                BlockDecoder::decode(temp.getPixelBox(face, mipmap), static_cast<uchar*>(getPixelBox(face, mipmap).data));
+            }
+        }
+        return *this;
+    }
+    //-----------------------------------------------------------------------
+    namespace
+    {
+        /// Destination pixels per WorkQueue task when resampling
+        constexpr size_t RESAMPLE_PIXELS_PER_TASK = 16384;
+
+        /** Calls func(firstRow, lastRow) for bands covering the rows of all slices of dst.
+        @remarks
+            The bands are spread over the WorkQueue when dst is larger than
+            RESAMPLE_PIXELS_PER_TASK.
+        */
+        template<typename Func>
+        void forEachRowBand(const PixelBox& dst, const Func& func)
+        {
+            size_t numRows = size_t(dst.getHeight()) * dst.getDepth();
+            size_t rowsPerTask = std::max<size_t>(1, RESAMPLE_PIXELS_PER_TASK / dst.getWidth());
+            Root* root = Root::getSingletonPtr();
+            if (numRows > rowsPerTask && root && root->getWorkQueue())
+            {
+                size_t numTasks = (numRows + rowsPerTask - 1) / rowsPerTask;
+                root->getWorkQueue()->parallelFor(numTasks, [&](size_t task)
+                {
+                    size_t firstRow = task * rowsPerTask;
+                    func(firstRow, std::min(firstRow + rowsPerTask, numRows));
+                });
+            }
+            else
+            {
+                func(0, numRows);
+            }
+        }
+
+        using Resampler = void (*)(const PixelBox& src, const PixelBox& dst, size_t firstRow, size_t lastRow);
+
+        void resample(Resampler resampler, const PixelBox& src, const PixelBox& dst)
+        {
+            forEachRowBand(dst, [&](size_t firstRow, size_t lastRow) { resampler(src, dst, firstRow, lastRow); });
+        }
+    }
+    //-----------------------------------------------------------------------
+    void Image::scale(const PixelBox &src, const PixelBox &scaled, Filter filter, bool gammaCorrect) 
     {
         assert(PixelUtil::isAccessible(src.format));
         assert(PixelUtil::isAccessible(scaled.format));
@@ -521,14 +659,14 @@ namespace Ogre {
             // super-optimized: no conversion
             switch (PixelUtil::getNumElemBytes(src.format)) 
             {
-            case 1: NearestResampler<1>::scale(src, temp); break;
-            case 2: NearestResampler<2>::scale(src, temp); break;
-            case 3: NearestResampler<3>::scale(src, temp); break;
-            case 4: NearestResampler<4>::scale(src, temp); break;
-            case 6: NearestResampler<6>::scale(src, temp); break;
-            case 8: NearestResampler<8>::scale(src, temp); break;
-            case 12: NearestResampler<12>::scale(src, temp); break;
-            case 16: NearestResampler<16>::scale(src, temp); break;
+            case 1: resample(&NearestResampler<1>::scale, src, temp); break;
+            case 2: resample(&NearestResampler<2>::scale, src, temp); break;
+            case 3: resample(&NearestResampler<3>::scale, src, temp); break;
+            case 4: resample(&NearestResampler<4>::scale, src, temp); break;
+            case 6: resample(&NearestResampler<6>::scale, src, temp); break;
+            case 8: resample(&NearestResampler<8>::scale, src, temp); break;
+            case 12: resample(&NearestResampler<12>::scale, src, temp); break;
+            case 16: resample(&NearestResampler<16>::scale, src, temp); break;
             default:
                 // never reached
                 assert(false);
@@ -558,10 +696,10 @@ namespace Ogre {
                 // super-optimized: byte-oriented math, no conversion
                 switch (PixelUtil::getNumElemBytes(src.format)) 
                 {
-                case 1: LinearResampler_Byte<1>::scale(src, temp); break;
-                case 2: LinearResampler_Byte<2>::scale(src, temp); break;
-                case 3: LinearResampler_Byte<3>::scale(src, temp); break;
-                case 4: LinearResampler_Byte<4>::scale(src, temp); break;
+                case 1: resample(&LinearResampler_Byte<1>::scale, src, temp); break;
+                case 2: resample(&LinearResampler_Byte<2>::scale, src, temp); break;
+                case 3: resample(&LinearResampler_Byte<3>::scale, src, temp); break;
+                case 4: resample(&LinearResampler_Byte<4>::scale, src, temp); break;
                 default:
                     // never reached
                     assert(false);
@@ -577,13 +715,24 @@ namespace Ogre {
                 if (scaled.format == FLOAT32_RGB || scaled.format == FLOAT32_RGBA)
                 {
                     // float32 to float32, avoid unpack/repack overhead
-                    LinearResampler_Float32::scale(src, scaled);
+                    resample(&LinearResampler_Float32::scale, src, scaled);
                     break;
                 }
                 // else, fall through
             default:
                 // non-optimized: floating-point math, performs conversion but always works
-                LinearResampler::scale(src, scaled);
+                resample(&LinearResampler::scale, src, scaled);
+            }
+            break;
+
+        case BOX:
+        case KAISER:
+            {
+                FilteredResampler resampler(src, scaled,
+                    filter == BOX ? &FilteredResampler::box : &FilteredResampler::kaiser,
+                    filter == BOX ? FilteredResampler::BOX_SUPPORT : FilteredResampler::KAISER_SUPPORT,
+                    gammaCorrect);
+                forEachRowBand(scaled, resampler);
             }
             break;
         }
@@ -667,13 +816,30 @@ namespace Ogre {
         return size;
     }
     //---------------------------------------------------------------------
+    namespace
+    {
+        /// runs both decodes on the work queue, if there is one
+        template <typename A, typename B>
+        void loadConcurrently(const A& first, const B& second)
+        {
+            Root* root = Root::getSingletonPtr();
+            if (root && root->getWorkQueue())
+            {
+                root->getWorkQueue()->parallelFor(2, [&](size_t i) { i == 0 ? first() : second(); });
+                return;
+            }
+            first();
+            second();
+        }
+    }
+    //---------------------------------------------------------------------
     auto Image::loadTwoImagesAsRGBA(std::string_view rgbFilename, std::string_view alphaFilename,
         std::string_view groupName, PixelFormat fmt) -> Image &
     {
         Image rgb, alpha;
 
-        rgb.load(rgbFilename, groupName);
-        alpha.load(alphaFilename, groupName);
+        loadConcurrently([&] { rgb.load(rgbFilename, groupName); },
+                         [&] { alpha.load(alphaFilename, groupName); });
 
         return combineTwoImagesAsRGBA(rgb, alpha, fmt);
 
@@ -685,8 +851,8 @@ namespace Ogre {
     {
         Image rgb, alpha;
 
-        rgb.load(rgbStream, rgbType);
-        alpha.load(alphaStream, alphaType);
+        loadConcurrently([&] { rgb.load(rgbStream, rgbType); },
+                         [&] { alpha.load(alphaStream, alphaType); });
 
         return combineTwoImagesAsRGBA(rgb, alpha, fmt);
 
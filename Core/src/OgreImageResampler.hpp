@@ -27,9 +27,12 @@ THE SOFTWARE.
 */
 module Ogre.Core:ImageResampler;
 
+import :Math;
 import :PixelFormat;
 
 import <algorithm>;
+import <cmath>;
+import <vector>;
 
 // this file is inlined into OgreImage.cpp!
 // do not include anywhere else.
@@ -53,12 +56,12 @@ namespace Ogre {
 // templated on bytes-per-pixel to allow compiler optimizations, such
 // as simplifying memcpy() and replacing multiplies with bitshifts
 template<unsigned int elemsize> struct NearestResampler {
-    static void scale(const PixelBox& src, const PixelBox& dst) {
+    static void scale(const PixelBox& src, const PixelBox& dst, size_t firstRow, size_t lastRow) {
         // assert(src.format == dst.format);
 
-        // srcdata stays at beginning, pdst is a moving pointer
+        // srcdata and dstdata stay at beginning, pdst is a moving pointer
         auto* srcdata = (uchar*)src.getTopLeftFrontPixelPtr();
-        auto* pdst = (uchar*)dst.getTopLeftFrontPixelPtr();
+        auto* dstdata = (uchar*)dst.getTopLeftFrontPixelPtr();
 
         // sx_48,sy_48,sz_48 represent current position in source
         // using 16/48-bit fixed precision, incremented by steps
@@ -66,26 +69,25 @@ template<unsigned int elemsize> struct NearestResampler {
         uint64 stepy = ((uint64)src.getHeight() << 48) / dst.getHeight();
         uint64 stepz = ((uint64)src.getDepth() << 48) / dst.getDepth();
 
-        // note: ((stepz>>1) - 1) is an extra half-step increment to adjust
-        // for the center of the destination pixel, not the top-left corner
-        uint64 sz_48 = (stepz >> 1) - 1;
-        for (size_t z = dst.front; z < dst.back; z++, sz_48 += stepz) {
+        for (size_t row = firstRow; row < lastRow; row++) {
+            size_t z = row / dst.getHeight();
+            size_t y = row % dst.getHeight();
+
+            // note: ((stepz>>1) - 1) is an extra half-step increment to adjust
+            // for the center of the destination pixel, not the top-left corner
+            uint64 sz_48 = (stepz >> 1) - 1 + z * stepz;
             size_t srczoff = (size_t)(sz_48 >> 48) * src.slicePitch;
-            
-            uint64 sy_48 = (stepy >> 1) - 1;
-            for (size_t y = dst.top; y < dst.bottom; y++, sy_48 += stepy) {
-                size_t srcyoff = (size_t)(sy_48 >> 48) * src.rowPitch;
-            
-                uint64 sx_48 = (stepx >> 1) - 1;
-                for (size_t x = dst.left; x < dst.right; x++, sx_48 += stepx) {
-                    uchar* psrc = srcdata +
-                        elemsize*((size_t)(sx_48 >> 48) + srcyoff + srczoff);
-                    memcpy(pdst, psrc, elemsize);
-                    pdst += elemsize;
-                }
-                pdst += elemsize*dst.getRowSkip();
+            uint64 sy_48 = (stepy >> 1) - 1 + y * stepy;
+            size_t srcyoff = (size_t)(sy_48 >> 48) * src.rowPitch;
+
+            uchar* pdst = dstdata + elemsize*(y * dst.rowPitch + z * dst.slicePitch);
+            uint64 sx_48 = (stepx >> 1) - 1;
+            for (size_t x = dst.left; x < dst.right; x++, sx_48 += stepx) {
+                uchar* psrc = srcdata +
+                    elemsize*((size_t)(sx_48 >> 48) + srcyoff + srczoff);
+                memcpy(pdst, psrc, elemsize);
+                pdst += elemsize;
             }
-            pdst += elemsize*dst.getSliceSkip();
         }
     }
 };
@@ -93,13 +95,13 @@ template<unsigned int elemsize> struct NearestResampler {
 
 // default floating-point linear resampler, does format conversion
 struct LinearResampler {
-    static void scale(const PixelBox& src, const PixelBox& dst) {
+    static void scale(const PixelBox& src, const PixelBox& dst, size_t firstRow, size_t lastRow) {
         size_t srcelemsize = PixelUtil::getNumElemBytes(src.format);
         size_t dstelemsize = PixelUtil::getNumElemBytes(dst.format);
 
-        // srcdata stays at beginning, pdst is a moving pointer
+        // srcdata and dstdata stay at beginning, pdst is a moving pointer
         auto* srcdata = (uchar*)src.getTopLeftFrontPixelPtr();
-        auto* pdst = (uchar*)dst.getTopLeftFrontPixelPtr();
+        auto* dstdata = (uchar*)dst.getTopLeftFrontPixelPtr();
         
         // sx_48,sy_48,sz_48 represent current position in source
         // using 16/48-bit fixed precision, incremented by steps
@@ -107,10 +109,15 @@ struct LinearResampler {
         uint64 stepy = ((uint64)src.getHeight() << 48) / dst.getHeight();
         uint64 stepz = ((uint64)src.getDepth() << 48) / dst.getDepth();
         
-        // note: ((stepz>>1) - 1) is an extra half-step increment to adjust
-        // for the center of the destination pixel, not the top-left corner
-        uint64 sz_48 = (stepz >> 1) - 1;
-        for (size_t z = dst.front; z < dst.back; z++, sz_48+=stepz) {
+        for (size_t row = firstRow; row < lastRow; row++) {
+            size_t z = row / dst.getHeight();
+            size_t y = row % dst.getHeight();
+
+            // note: ((stepz>>1) - 1) is an extra half-step increment to adjust
+            // for the center of the destination pixel, not the top-left corner
+            uint64 sz_48 = (stepz >> 1) - 1 + z * stepz;
+            uint64 sy_48 = (stepy >> 1) - 1 + y * stepy;
+
             // temp is 16/16 bit fixed precision, used to adjust a source
             // coordinate (x, y, or z) backwards by half a pixel so that the
             // integer bits represent the first sample (eg, sx1) and the
@@ -122,51 +129,47 @@ struct LinearResampler {
             uint32 sz2 = std::min(sz1+1,src.getDepth()-1);// src z, sample #2
             float szf = (temp & 0xFFFF) / 65536.f; // weight of sample #2
 
-            uint64 sy_48 = (stepy >> 1) - 1;
-            for (size_t y = dst.top; y < dst.bottom; y++, sy_48+=stepy) {
-                temp = static_cast<unsigned int>(sy_48 >> 32);
+            temp = static_cast<unsigned int>(sy_48 >> 32);
+            temp = (temp > 0x8000)? temp - 0x8000 : 0;
+            uint32 sy1 = temp >> 16;                    // src y #1
+            uint32 sy2 = std::min(sy1+1,src.getHeight()-1);// src y #2
+            float syf = (temp & 0xFFFF) / 65536.f; // weight of #2
+            
+            uchar* pdst = dstdata + dstelemsize*(y * dst.rowPitch + z * dst.slicePitch);
+            uint64 sx_48 = (stepx >> 1) - 1;
+            for (size_t x = dst.left; x < dst.right; x++, sx_48+=stepx) {
+                temp = static_cast<unsigned int>(sx_48 >> 32);
                 temp = (temp > 0x8000)? temp - 0x8000 : 0;
-                uint32 sy1 = temp >> 16;                    // src y #1
-                uint32 sy2 = std::min(sy1+1,src.getHeight()-1);// src y #2
-                float syf = (temp & 0xFFFF) / 65536.f; // weight of #2
-                
-                uint64 sx_48 = (stepx >> 1) - 1;
-                for (size_t x = dst.left; x < dst.right; x++, sx_48+=stepx) {
-                    temp = static_cast<unsigned int>(sx_48 >> 32);
-                    temp = (temp > 0x8000)? temp - 0x8000 : 0;
-                    uint32 sx1 = temp >> 16;                    // src x #1
-                    uint32 sx2 = std::min(sx1+1,src.getWidth()-1);// src x #2
-                    float sxf = (temp & 0xFFFF) / 65536.f; // weight of #2
-                
-                    ColourValue x1y1z1, x2y1z1, x1y2z1, x2y2z1;
-                    ColourValue x1y1z2, x2y1z2, x1y2z2, x2y2z2;
+                uint32 sx1 = temp >> 16;                    // src x #1
+                uint32 sx2 = std::min(sx1+1,src.getWidth()-1);// src x #2
+                float sxf = (temp & 0xFFFF) / 65536.f; // weight of #2
+            
+                ColourValue x1y1z1, x2y1z1, x1y2z1, x2y2z1;
+                ColourValue x1y1z2, x2y1z2, x1y2z2, x2y2z2;
 
 #define UNPACK(dst,x,y,z) PixelUtil::unpackColour(&dst, src.format, \
     srcdata + srcelemsize*((x)+(y)*src.rowPitch+(z)*src.slicePitch))
 
-                    UNPACK(x1y1z1,sx1,sy1,sz1); UNPACK(x2y1z1,sx2,sy1,sz1);
-                    UNPACK(x1y2z1,sx1,sy2,sz1); UNPACK(x2y2z1,sx2,sy2,sz1);
-                    UNPACK(x1y1z2,sx1,sy1,sz2); UNPACK(x2y1z2,sx2,sy1,sz2);
-                    UNPACK(x1y2z2,sx1,sy2,sz2); UNPACK(x2y2z2,sx2,sy2,sz2);
+                UNPACK(x1y1z1,sx1,sy1,sz1); UNPACK(x2y1z1,sx2,sy1,sz1);
+                UNPACK(x1y2z1,sx1,sy2,sz1); UNPACK(x2y2z1,sx2,sy2,sz1);
+                UNPACK(x1y1z2,sx1,sy1,sz2); UNPACK(x2y1z2,sx2,sy1,sz2);
+                UNPACK(x1y2z2,sx1,sy2,sz2); UNPACK(x2y2z2,sx2,sy2,sz2);
 #undef UNPACK
 
-                    ColourValue accum =
-                        x1y1z1 * ((1.0f - sxf)*(1.0f - syf)*(1.0f - szf)) +
-                        x2y1z1 * (        sxf *(1.0f - syf)*(1.0f - szf)) +
-                        x1y2z1 * ((1.0f - sxf)*        syf *(1.0f - szf)) +
-                        x2y2z1 * (        sxf *        syf *(1.0f - szf)) +
-                        x1y1z2 * ((1.0f - sxf)*(1.0f - syf)*        szf ) +
-                        x2y1z2 * (        sxf *(1.0f - syf)*        szf ) +
-                        x1y2z2 * ((1.0f - sxf)*        syf *        szf ) +
-                        x2y2z2 * (        sxf *        syf *        szf );
+                ColourValue accum =
+                    x1y1z1 * ((1.0f - sxf)*(1.0f - syf)*(1.0f - szf)) +
+                    x2y1z1 * (        sxf *(1.0f - syf)*(1.0f - szf)) +
+                    x1y2z1 * ((1.0f - sxf)*        syf *(1.0f - szf)) +
+                    x2y2z1 * (        sxf *        syf *(1.0f - szf)) +
+                    x1y1z2 * ((1.0f - sxf)*(1.0f - syf)*        szf ) +
+                    x2y1z2 * (        sxf *(1.0f - syf)*        szf ) +
+                    x1y2z2 * ((1.0f - sxf)*        syf *        szf ) +
+                    x2y2z2 * (        sxf *        syf *        szf );
 
-                    PixelUtil::packColour(accum, dst.format, pdst);
+                PixelUtil::packColour(accum, dst.format, pdst);
 
-                    pdst += dstelemsize;
-                }
-                pdst += dstelemsize*dst.getRowSkip();
+                pdst += dstelemsize;
             }
-            pdst += dstelemsize*dst.getSliceSkip();
         }
     }
 };
@@ -175,15 +178,15 @@ struct LinearResampler {
 // float32 linear resampler, converts FLOAT32_RGB/FLOAT32_RGBA only.
 // avoids overhead of pixel unpack/repack function calls
 struct LinearResampler_Float32 {
-    static void scale(const PixelBox& src, const PixelBox& dst) {
+    static void scale(const PixelBox& src, const PixelBox& dst, size_t firstRow, size_t lastRow) {
         size_t srcchannels = PixelUtil::getNumElemBytes(src.format) / sizeof(float);
         size_t dstchannels = PixelUtil::getNumElemBytes(dst.format) / sizeof(float);
         // assert(srcchannels == 3 || srcchannels == 4);
         // assert(dstchannels == 3 || dstchannels == 4);
 
-        // srcdata stays at beginning, pdst is a moving pointer
+        // srcdata and dstdata stay at beginning, pdst is a moving pointer
         auto* srcdata = (float*)src.getTopLeftFrontPixelPtr();
-        auto* pdst = (float*)dst.getTopLeftFrontPixelPtr();
+        auto* dstdata = (float*)dst.getTopLeftFrontPixelPtr();
         
         // sx_48,sy_48,sz_48 represent current position in source
         // using 16/48-bit fixed precision, incremented by steps
@@ -191,10 +194,15 @@ struct LinearResampler_Float32 {
         uint64 stepy = ((uint64)src.getHeight() << 48) / dst.getHeight();
         uint64 stepz = ((uint64)src.getDepth() << 48) / dst.getDepth();
         
-        // note: ((stepz>>1) - 1) is an extra half-step increment to adjust
-        // for the center of the destination pixel, not the top-left corner
-        uint64 sz_48 = (stepz >> 1) - 1;
-        for (size_t z = dst.front; z < dst.back; z++, sz_48+=stepz) {
+        for (size_t row = firstRow; row < lastRow; row++) {
+            size_t z = row / dst.getHeight();
+            size_t y = row % dst.getHeight();
+
+            // note: ((stepz>>1) - 1) is an extra half-step increment to adjust
+            // for the center of the destination pixel, not the top-left corner
+            uint64 sz_48 = (stepz >> 1) - 1 + z * stepz;
+            uint64 sy_48 = (stepy >> 1) - 1 + y * stepy;
+
             // temp is 16/16 bit fixed precision, used to adjust a source
             // coordinate (x, y, or z) backwards by half a pixel so that the
             // integer bits represent the first sample (eg, sx1) and the
@@ -206,24 +214,23 @@ struct LinearResampler_Float32 {
             uint32 sz2 = std::min(sz1+1,src.getDepth()-1);// src z, sample #2
             float szf = (temp & 0xFFFF) / 65536.f; // weight of sample #2
 
-            uint64 sy_48 = (stepy >> 1) - 1;
-            for (size_t y = dst.top; y < dst.bottom; y++, sy_48+=stepy) {
-                temp = static_cast<unsigned int>(sy_48 >> 32);
+            temp = static_cast<unsigned int>(sy_48 >> 32);
+            temp = (temp > 0x8000)? temp - 0x8000 : 0;
+            uint32 sy1 = temp >> 16;                    // src y #1
+            uint32 sy2 = std::min(sy1+1,src.getHeight()-1);// src y #2
+            float syf = (temp & 0xFFFF) / 65536.f; // weight of #2
+            
+            float* pdst = dstdata + dstchannels*(y * dst.rowPitch + z * dst.slicePitch);
+            uint64 sx_48 = (stepx >> 1) - 1;
+            for (size_t x = dst.left; x < dst.right; x++, sx_48+=stepx) {
+                temp = static_cast<unsigned int>(sx_48 >> 32);
                 temp = (temp > 0x8000)? temp - 0x8000 : 0;
-                uint32 sy1 = temp >> 16;                    // src y #1
-                uint32 sy2 = std::min(sy1+1,src.getHeight()-1);// src y #2
-                float syf = (temp & 0xFFFF) / 65536.f; // weight of #2
+                uint32 sx1 = temp >> 16;                    // src x #1
+                uint32 sx2 = std::min(sx1+1,src.getWidth()-1);// src x #2
+                float sxf = (temp & 0xFFFF) / 65536.f; // weight of #2
                 
-                uint64 sx_48 = (stepx >> 1) - 1;
-                for (size_t x = dst.left; x < dst.right; x++, sx_48+=stepx) {
-                    temp = static_cast<unsigned int>(sx_48 >> 32);
-                    temp = (temp > 0x8000)? temp - 0x8000 : 0;
-                    uint32 sx1 = temp >> 16;                    // src x #1
-                    uint32 sx2 = std::min(sx1+1,src.getWidth()-1);// src x #2
-                    float sxf = (temp & 0xFFFF) / 65536.f; // weight of #2
-                    
-                    // process R,G,B,A simultaneously for cache coherence?
-                    float accum[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+                // process R,G,B,A simultaneously for cache coherence?
+                float accum[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
 
 #define ACCUM3(x,y,z,factor) \
     { float f = factor; \
@@ -237,39 +244,36 @@ struct LinearResampler_Float32 {
     accum[0]+=srcdata[off+0]*f; accum[1]+=srcdata[off+1]*f; \
     accum[2]+=srcdata[off+2]*f; accum[3]+=srcdata[off+3]*f; }
 
-                    if (srcchannels == 3 || dstchannels == 3) {
-                        // RGB, no alpha
-                        ACCUM3(sx1,sy1,sz1,(1.0f-sxf)*(1.0f-syf)*(1.0f-szf));
-                        ACCUM3(sx2,sy1,sz1,      sxf *(1.0f-syf)*(1.0f-szf));
-                        ACCUM3(sx1,sy2,sz1,(1.0f-sxf)*      syf *(1.0f-szf));
-                        ACCUM3(sx2,sy2,sz1,      sxf *      syf *(1.0f-szf));
-                        ACCUM3(sx1,sy1,sz2,(1.0f-sxf)*(1.0f-syf)*      szf );
-                        ACCUM3(sx2,sy1,sz2,      sxf *(1.0f-syf)*      szf );
-                        ACCUM3(sx1,sy2,sz2,(1.0f-sxf)*      syf *      szf );
-                        ACCUM3(sx2,sy2,sz2,      sxf *      syf *      szf );
-                        accum[3] = 1.0f;
-                    } else {
-                        // RGBA
-                        ACCUM4(sx1,sy1,sz1,(1.0f-sxf)*(1.0f-syf)*(1.0f-szf));
-                        ACCUM4(sx2,sy1,sz1,      sxf *(1.0f-syf)*(1.0f-szf));
-                        ACCUM4(sx1,sy2,sz1,(1.0f-sxf)*      syf *(1.0f-szf));
-                        ACCUM4(sx2,sy2,sz1,      sxf *      syf *(1.0f-szf));
-                        ACCUM4(sx1,sy1,sz2,(1.0f-sxf)*(1.0f-syf)*      szf );
-                        ACCUM4(sx2,sy1,sz2,      sxf *(1.0f-syf)*      szf );
-                        ACCUM4(sx1,sy2,sz2,(1.0f-sxf)*      syf *      szf );
-                        ACCUM4(sx2,sy2,sz2,      sxf *      syf *      szf );
-                    }
+                if (srcchannels == 3 || dstchannels == 3) {
+                    // RGB, no alpha
+                    ACCUM3(sx1,sy1,sz1,(1.0f-sxf)*(1.0f-syf)*(1.0f-szf));
+                    ACCUM3(sx2,sy1,sz1,      sxf *(1.0f-syf)*(1.0f-szf));
+                    ACCUM3(sx1,sy2,sz1,(1.0f-sxf)*      syf *(1.0f-szf));
+                    ACCUM3(sx2,sy2,sz1,      sxf *      syf *(1.0f-szf));
+                    ACCUM3(sx1,sy1,sz2,(1.0f-sxf)*(1.0f-syf)*      szf );
+                    ACCUM3(sx2,sy1,sz2,      sxf *(1.0f-syf)*      szf );
+                    ACCUM3(sx1,sy2,sz2,(1.0f-sxf)*      syf *      szf );
+                    ACCUM3(sx2,sy2,sz2,      sxf *      syf *      szf );
+                    accum[3] = 1.0f;
+                } else {
+                    // RGBA
+                    ACCUM4(sx1,sy1,sz1,(1.0f-sxf)*(1.0f-syf)*(1.0f-szf));
+                    ACCUM4(sx2,sy1,sz1,      sxf *(1.0f-syf)*(1.0f-szf));
+                    ACCUM4(sx1,sy2,sz1,(1.0f-sxf)*      syf *(1.0f-szf));
+                    ACCUM4(sx2,sy2,sz1,      sxf *      syf *(1.0f-szf));
+                    ACCUM4(sx1,sy1,sz2,(1.0f-sxf)*(1.0f-syf)*      szf );
+                    ACCUM4(sx2,sy1,sz2,      sxf *(1.0f-syf)*      szf );
+                    ACCUM4(sx1,sy2,sz2,(1.0f-sxf)*      syf *      szf );
+                    ACCUM4(sx2,sy2,sz2,      sxf *      syf *      szf );
+                }
 
-                    memcpy(pdst, accum, sizeof(float)*dstchannels);
+                memcpy(pdst, accum, sizeof(float)*dstchannels);
 
 #undef ACCUM3
 #undef ACCUM4
 
-                    pdst += dstchannels;
-                }
-                pdst += dstchannels*dst.getRowSkip();
+                pdst += dstchannels;
             }
-            pdst += dstchannels*dst.getSliceSkip();
         }
     }
 };
@@ -282,26 +286,27 @@ struct LinearResampler_Float32 {
 // templated on bytes-per-pixel to allow compiler optimizations, such
 // as unrolling loops and replacing multiplies with bitshifts
 template<unsigned int channels> struct LinearResampler_Byte {
-    static void scale(const PixelBox& src, const PixelBox& dst) {
+    static void scale(const PixelBox& src, const PixelBox& dst, size_t firstRow, size_t lastRow) {
         // assert(src.format == dst.format);
 
         // only optimized for 2D
         if (src.getDepth() > 1 || dst.getDepth() > 1) {
-            LinearResampler::scale(src, dst);
+            LinearResampler::scale(src, dst, firstRow, lastRow);
             return;
         }
 
-        // srcdata stays at beginning of slice, pdst is a moving pointer
+        // srcdata and dstdata stay at beginning of slice, pdst is a moving pointer
         auto* srcdata = (uchar*)src.getTopLeftFrontPixelPtr();
-        auto* pdst = (uchar*)dst.getTopLeftFrontPixelPtr();
+        auto* dstdata = (uchar*)dst.getTopLeftFrontPixelPtr();
 
         // sx_48,sy_48 represent current position in source
         // using 16/48-bit fixed precision, incremented by steps
         uint64 stepx = ((uint64)src.getWidth() << 48) / dst.getWidth();
         uint64 stepy = ((uint64)src.getHeight() << 48) / dst.getHeight();
         
-        uint64 sy_48 = (stepy >> 1) - 1;
-        for (size_t y = dst.top; y < dst.bottom; y++, sy_48+=stepy) {
+        for (size_t y = firstRow; y < lastRow; y++) {
+            uint64 sy_48 = (stepy >> 1) - 1 + y * stepy;
+            uchar* pdst = dstdata + channels * y * dst.rowPitch;
             // bottom 28 bits of temp are 16/12 bit fixed precision, used to
             // adjust a source coordinate backwards by half a pixel so that the
             // integer bits represent the first sample (eg, sx1) and the
@@ -334,10 +339,231 @@ template<unsigned int channels> struct LinearResampler_Byte {
                     *pdst++ = static_cast<uchar>((accum + 0x800000) >> 24);
                 }
             }
-            pdst += channels*dst.getRowSkip();
         }
     }
 };
+
+
+// separable filtering resampler for Image::Filter::BOX and KAISER, does format
+// conversion. Source rows are unpacked to FLOAT32_RGBA by bulkPixelConversion,
+// which has vectorised paths for the common formats, and filtered by plain
+// float loops over whole rows, which the compiler vectorises. The instance
+// holds the filter weights; operator() processes a range of destination rows
+// and may be called concurrently for disjoint ranges.
+class FilteredResampler {
+public:
+    using Kernel = float (*)(float x);
+
+    /// Box filter, averages the covered source pixels
+    static auto box(float x) -> float { return x >= -0.5f && x < 0.5f ? 1.0f : 0.0f; }
+    static constexpr float BOX_SUPPORT = 0.5f;
+
+    /// Kaiser windowed sinc, width 3 and alpha 4
+    static auto kaiser(float x) -> float {
+        if (std::abs(x) >= KAISER_SUPPORT)
+            return 0.0f;
+        float sinc = x == 0.0f ? 1.0f : std::sin(Math::PI * x) / (Math::PI * x);
+        float t = x / KAISER_SUPPORT;
+        return sinc * besselI0(4.0f * std::sqrt(1.0f - t * t)) / besselI0(4.0f);
+    }
+    static constexpr float KAISER_SUPPORT = 3.0f;
+
+    FilteredResampler(const PixelBox& src, const PixelBox& dst, Kernel kernel, float support, bool gammaCorrect)
+        : mSrc(src), mDst(dst), mGammaCorrect(gammaCorrect) {
+        mX.setup(src.getWidth(), dst.getWidth(), kernel, support);
+        mY.setup(src.getHeight(), dst.getHeight(), kernel, support);
+        mZ.setup(src.getDepth(), dst.getDepth(), kernel, support);
+    }
+
+    void operator()(size_t firstRow, size_t lastRow) const {
+        const uint32 dstWidth = mDst.getWidth();
+        const uint32 dstHeight = mDst.getHeight();
+        const size_t dstRowFloats = size_t(dstWidth) * 4;
+
+        std::vector<float> srcRow(size_t(mSrc.getWidth()) * 4);
+        std::vector<float> filtered; // horizontally filtered source rows
+        std::vector<float> accum; // destination rows
+
+        // the range is processed slice by slice
+        for (size_t row = firstRow; row < lastRow;) {
+            auto z = uint32(row / dstHeight);
+            auto y0 = uint32(row % dstHeight);
+            auto y1 = uint32(std::min<size_t>(dstHeight, y0 + (lastRow - row)));
+
+            // source rows contributing to the destination rows
+            uint32 sy0 = mY.first[y0], sy1 = 0;
+            for (uint32 y = y0; y < y1; y++) {
+                sy0 = std::min(sy0, mY.first[y]);
+                sy1 = std::max(sy1, mY.first[y] + mY.taps);
+            }
+
+            filtered.resize((sy1 - sy0) * dstRowFloats);
+            accum.assign((y1 - y0) * dstRowFloats, 0.0f);
+            for (uint32 k = 0; k < mZ.taps; k++) {
+                float wz = mZ.weights[z * mZ.taps + k];
+                if (wz == 0.0f)
+                    continue;
+                uint32 sz = mZ.first[z] + k;
+
+                for (uint32 sy = sy0; sy < sy1; sy++) {
+                    unpackRow(sy, sz, srcRow.data());
+                    filterRow(srcRow.data(), &filtered[(sy - sy0) * dstRowFloats]);
+                }
+
+                for (uint32 y = y0; y < y1; y++) {
+                    float* out = &accum[(y - y0) * dstRowFloats];
+                    for (uint32 t = 0; t < mY.taps; t++) {
+                        float w = wz * mY.weights[y * mY.taps + t];
+                        if (w == 0.0f)
+                            continue;
+                        const float* in = &filtered[(mY.first[y] + t - sy0) * dstRowFloats];
+                        for (size_t i = 0; i < dstRowFloats; i++)
+                            out[i] += w * in[i];
+                    }
+                }
+            }
+
+            packRows(accum.data(), z, y0, y1);
+            row += y1 - y0;
+        }
+    }
+
+private:
+    /// Weights of the source pixels contributing to each destination coordinate along one axis
+    struct Axis {
+        /// Number of weights per destination coordinate
+        uint32 taps{0};
+        /// First contributing source coordinate per destination coordinate
+        std::vector<uint32> first;
+        std::vector<float> weights;
+
+        void setup(uint32 srcSize, uint32 dstSize, Kernel kernel, float support) {
+            const float ratio = float(srcSize) / float(dstSize);
+            // the filter is widened when downsampling, so it covers all source pixels
+            const float scale = std::max(ratio, 1.0f);
+            const float radius = support * scale;
+            const int last = int(srcSize) - 1;
+
+            std::vector<std::vector<float>> contributions(dstSize);
+            first.resize(dstSize);
+            taps = 1;
+            for (uint32 i = 0; i < dstSize; i++) {
+                float centre = (float(i) + 0.5f) * ratio - 0.5f;
+                int lo = int(std::ceil(centre - radius));
+                int hi = int(std::floor(centre + radius));
+                int clampedLo = std::clamp(lo, 0, last);
+
+                // the edge pixels are repeated, the taps outside of the source fold onto them
+                std::vector<float>& w = contributions[i];
+                w.assign(std::clamp(hi, 0, last) - clampedLo + 1, 0.0f);
+                float total = 0.0f;
+                for (int j = lo; j <= hi; j++) {
+                    float weight = kernel((float(j) - centre) / scale);
+                    w[std::clamp(j, 0, last) - clampedLo] += weight;
+                    total += weight;
+                }
+
+                if (total == 0.0f) {
+                    // narrower than a pixel, use the nearest one
+                    w.assign(1, 1.0f);
+                    clampedLo = std::clamp(int(std::floor(centre + 0.5f)), 0, last);
+                } else {
+                    for (float& weight : w)
+                        weight /= total;
+                }
+
+                // drop zero weights at both ends, like the half open box
+                size_t begin = 0, end = w.size();
+                while (end - begin > 1 && w[begin] == 0.0f)
+                    begin++;
+                while (end - begin > 1 && w[end - 1] == 0.0f)
+                    end--;
+                w = std::vector<float>(w.begin() + begin, w.begin() + end);
+                first[i] = clampedLo + uint32(begin);
+                taps = std::max(taps, uint32(w.size()));
+            }
+
+            weights.assign(size_t(dstSize) * taps, 0.0f);
+            for (uint32 i = 0; i < dstSize; i++) {
+                // keep all taps inside the source
+                uint32 offset = 0;
+                if (first[i] + taps > srcSize) {
+                    offset = first[i] + taps - srcSize;
+                    first[i] -= offset;
+                }
+                std::copy(contributions[i].begin(), contributions[i].end(), &weights[i * taps + offset]);
+            }
+        }
+    };
+
+    static auto besselI0(float x) -> float {
+        // power series of the modified Bessel function of the first kind
+        double sum = 1.0, term = 1.0, halfX = x / 2.0;
+        for (int k = 1; term > 1e-10 * sum; k++) {
+            term *= (halfX / k) * (halfX / k);
+            sum += term;
+        }
+        return float(sum);
+    }
+
+    static auto srgbToLinear(float c) -> float {
+        return c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+    }
+
+    static auto linearToSrgb(float c) -> float {
+        c = std::clamp(c, 0.0f, 1.0f);
+        return c <= 0.0031308f ? c * 12.92f : 1.055f * std::pow(c, 1.0f / 2.4f) - 0.055f;
+    }
+
+    void unpackRow(uint32 sy, uint32 sz, float* row) const {
+        Box box{mSrc.left, mSrc.top + sy, mSrc.right, mSrc.top + sy + 1, mSrc.front + sz, mSrc.front + sz + 1};
+        PixelUtil::bulkPixelConversion(mSrc.getSubVolume(box),
+            PixelBox(mSrc.getWidth(), 1, 1, PixelFormat::FLOAT32_RGBA, row));
+
+        // alpha is coverage, not colour, and stays as is
+        if (mGammaCorrect) {
+            for (uint32 x = 0; x < mSrc.getWidth(); x++)
+                for (int c = 0; c < 3; c++)
+                    row[x * 4 + c] = srgbToLinear(row[x * 4 + c]);
+        }
+    }
+
+    void filterRow(const float* in, float* out) const {
+        for (uint32 x = 0; x < mDst.getWidth(); x++) {
+            float r = 0.0f, g = 0.0f, b = 0.0f, a = 0.0f;
+            const float* w = &mX.weights[x * mX.taps];
+            const float* p = &in[mX.first[x] * 4];
+            for (uint32 t = 0; t < mX.taps; t++, p += 4) {
+                r += w[t] * p[0];
+                g += w[t] * p[1];
+                b += w[t] * p[2];
+                a += w[t] * p[3];
+            }
+            out[x * 4 + 0] = r;
+            out[x * 4 + 1] = g;
+            out[x * 4 + 2] = b;
+            out[x * 4 + 3] = a;
+        }
+    }
+
+    void packRows(float* rows, uint32 z, uint32 y0, uint32 y1) const {
+        const uint32 dstWidth = mDst.getWidth();
+        if (mGammaCorrect) {
+            for (size_t p = 0; p < size_t(dstWidth) * (y1 - y0); p++)
+                for (int c = 0; c < 3; c++)
+                    rows[p * 4 + c] = linearToSrgb(rows[p * 4 + c]);
+        }
+
+        Box box{mDst.left, mDst.top + y0, mDst.right, mDst.top + y1, mDst.front + z, mDst.front + z + 1};
+        PixelUtil::bulkPixelConversion(PixelBox(dstWidth, y1 - y0, 1, PixelFormat::FLOAT32_RGBA, rows),
+            mDst.getSubVolume(box));
+    }
+
+    PixelBox mSrc;
+    PixelBox mDst;
+    Axis mX, mY, mZ;
+    bool mGammaCorrect;
+};
 /** @} */
 /** @} */
 
@@ -49,6 +49,8 @@ import :SubMesh;
 import :VertexIndexData;
 
 import <algorithm>;
+import <atomic>;
+import <initializer_list>;
 import <iterator>;
 import <limits>;
 import <memory>;
@@ -123,7 +125,8 @@ namespace Ogre
         OgreAssert(baseSubMesh->operationType == RenderOperation::OperationType::TRIANGLE_LIST,
                    "Only meshes with OperationType::TRIANGLE_LIST are supported");
 
-        if( !mCustomParams.empty() && mCreator->getInstancingTechnique() != InstanceManager::HWInstancingBasic )
+        if( !mCustomParams.empty() && mCreator->getInstancingTechnique() != InstanceManager::HWInstancingBasic &&
+            mCreator->getInstancingTechnique() != InstanceManager::HWInstancingGPUCulled )
         {
             //Implementing this for ShaderBased is impossible. All other variants can be.
             OGRE_EXCEPT(ExceptionCodes::INVALIDPARAMS, "Custom parameters not supported for this "
@@ -252,6 +255,8 @@ namespace Ogre
             mUnusedEntities.pop_back();
 
             retVal->setInUse(true);
+            mInstanceSetChanged = true;
+            _boundsDirty();
         }
 
         return retVal;
@@ -268,6 +273,8 @@ namespace Ogre
 
         instancedEntity->setInUse(false);
         instancedEntity->stopSharingTransform();
+        mInstanceSetChanged = true;
+        _boundsDirty();
 
         //Put it back into the queue
         mUnusedEntities.push_back( instancedEntity );
@@ -398,6 +405,7 @@ namespace Ogre
 
         //Reassign instance IDs and tell we're the new parent
         uint32 instanceId = 0;
+        mInstanceSetChanged = true;
 
         for(auto& ent : mInstancedEntities)
         {
@@ -423,6 +431,41 @@ namespace Ogre
             _boundsDirty();
     }
     //-----------------------------------------------------------------------
+    void InstanceBatch::_migrateInstancedEntity( InstancedEntity *instancedEntity, InstanceBatch *target )
+    {
+        OgreAssert(instancedEntity->mBatchOwner == this,
+                   "Trying to migrate an InstancedEntity created with a different InstanceBatch");
+        OgreAssert(instancedEntity->isInUse(), "Trying to migrate an InstancedEntity that is removed");
+        OgreAssert(target != this && !target->isBatchFull() && target->mCreator == mCreator,
+                   "Trying to migrate an InstancedEntity to a batch without a free slot");
+
+        //The unused entity of the target takes the place of the migrated one here
+        InstancedEntity *unused = target->mUnusedEntities.back();
+        target->mUnusedEntities.pop_back();
+        mUnusedEntities.push_back( unused );
+
+        const uint16 slot = instancedEntity->mInstanceId;
+        const uint16 targetSlot = unused->mInstanceId;
+        std::swap( mInstancedEntities[slot], target->mInstancedEntities[targetSlot] );
+
+        instancedEntity->mInstanceId = targetSlot;
+        instancedEntity->mBatchOwner = target;
+        unused->mInstanceId = slot;
+        unused->mBatchOwner = this;
+
+        const size_t numParams = mCreator->getNumCustomParams();
+        std::swap_ranges( mCustomParams.begin() + slot * numParams,
+                          mCustomParams.begin() + (slot + 1) * numParams,
+                          target->mCustomParams.begin() + targetSlot * numParams );
+
+        for( InstanceBatch *batch : { this, target } )
+        {
+            batch->mInstanceSetChanged = true;
+            batch->_markTransformSharingDirty();
+            batch->_boundsDirty();
+        }
+    }
+    //-----------------------------------------------------------------------
     void InstanceBatch::_boundsDirty()
     {
         if( mCreator && !mBoundsDirty ) 
@@ -430,6 +473,78 @@ namespace Ogre
         mBoundsDirty = true;
     }
     //-----------------------------------------------------------------------
+    void InstanceBatch::setIncrementalStaticUpdates( bool enabled )
+    {
+        mIncrementalStaticUpdates = enabled;
+        //The slots are only known after the next full upload
+        mInstanceSetChanged = true;
+    }
+    //-----------------------------------------------------------------------
+    void InstanceBatch::_markInstanceDirty( const InstancedEntity *instancedEntity )
+    {
+        if( mIncrementalStaticUpdates && instancedEntity->mInstanceId < mDirtyInstances.size() )
+        {
+            mDirtyInstances[instancedEntity->mInstanceId] = 1;
+            mHasDirtyInstances.store( true, std::memory_order_relaxed );
+        }
+    }
+    //-----------------------------------------------------------------------
+    void InstanceBatch::resetInstanceSlots()
+    {
+        mInstanceSlots.assign( mInstancedEntities.size(), NO_SLOT );
+        mSlotInstances.clear();
+        mDirtyInstances.assign( mInstancedEntities.size(), 0 );
+        mHasDirtyInstances.store( false, std::memory_order_relaxed );
+        mInstanceSetChanged = false;
+    }
+    //-----------------------------------------------------------------------
+    void InstanceBatch::assignInstanceSlot( size_t instanceIdx, size_t slot )
+    {
+        mInstanceSlots[instanceIdx] = static_cast<uint32>( slot );
+        if( mSlotInstances.size() <= slot )
+            mSlotInstances.resize( slot + 1, NO_SLOT );
+        mSlotInstances[slot] = static_cast<uint32>( instanceIdx );
+    }
+    //-----------------------------------------------------------------------
+    auto InstanceBatch::collectDirtySlotRanges() -> bool
+    {
+        mDirtySlotRanges.clear();
+        mHasDirtyInstances.store( false, std::memory_order_relaxed );
+        if( mInstanceSetChanged || mInstanceSlots.size() != mInstancedEntities.size() )
+            return false;
+
+        for( size_t i=0; i<mDirtyInstances.size(); ++i )
+        {
+            if( !mDirtyInstances[i] )
+                continue;
+            mDirtyInstances[i] = 0;
+
+            const size_t slot = mInstanceSlots[i];
+            if( slot == NO_SLOT )
+            {
+                //Wasn't uploaded because it wasn't in the scene, may be now
+                if( mInstancedEntities[i]->findVisible( nullptr ) )
+                    return false;
+                continue;
+            }
+            mDirtySlotRanges.emplace_back( slot, slot + 1 );
+        }
+
+        //Merge adjacent slots, so neighbours are written with a single update
+        std::ranges::sort( mDirtySlotRanges );
+        size_t numRanges = 0;
+        for( const auto& range : mDirtySlotRanges )
+        {
+            if( numRanges && mDirtySlotRanges[numRanges-1].second >= range.first )
+                mDirtySlotRanges[numRanges-1].second = std::max( mDirtySlotRanges[numRanges-1].second, range.second );
+            else
+                mDirtySlotRanges[numRanges++] = range;
+        }
+        mDirtySlotRanges.resize( numRanges );
+
+        return true;
+    }
+    //-----------------------------------------------------------------------
     auto InstanceBatch::getMovableType() const noexcept -> std::string_view
     {
         static std::string_view const constexpr sType = "InstanceBatch";
@@ -591,6 +706,8 @@ namespace Ogre
                                          const Vector4 &newParam )
     {
         mCustomParams[instancedEntity->mInstanceId * mCreator->getNumCustomParams() + idx] = newParam;
+        _markInstanceDirty( instancedEntity );
+        _boundsDirty();
     }
     //-----------------------------------------------------------------------
     auto InstanceBatch::_getCustomParam( InstancedEntity *instancedEntity, unsigned char idx ) -> const Vector4&
@@ -46,6 +46,7 @@ import :StringConverter;
 import :SubMesh;
 import :VertexIndexData;
 
+import <atomic>;
 import <memory>;
 import <string>;
 import <vector>;
@@ -194,6 +195,29 @@ namespace Ogre
         return InstanceBatch::checkSubMeshCompatibility( baseSubMesh );
     }
     //-----------------------------------------------------------------------
+    auto InstanceBatchHW::writeInstanceData( size_t instanceIdx, float *pDest ) const -> float*
+    {
+        const size_t floatsWritten = mInstancedEntities[instanceIdx]->getTransforms3x4( (Matrix3x4f*)pDest );
+
+        if( mManager->getCameraRelativeRendering() )
+            makeMatrixCameraRelative3x4( (Matrix3x4f*)pDest, floatsWritten / 12 );
+
+        pDest += floatsWritten;
+
+        //Write custom parameters, if any
+        unsigned char numCustomParams   = mCreator->getNumCustomParams();
+        size_t customParamIdx           = instanceIdx * numCustomParams;
+        for( unsigned char i=0; i<numCustomParams; ++i )
+        {
+            *pDest++ = mCustomParams[customParamIdx+i].x;
+            *pDest++ = mCustomParams[customParamIdx+i].y;
+            *pDest++ = mCustomParams[customParamIdx+i].z;
+            *pDest++ = mCustomParams[customParamIdx+i].w;
+        }
+
+        return pDest;
+    }
+    //-----------------------------------------------------------------------
     auto InstanceBatchHW::updateVertexBuffer( Camera *currentCamera ) -> size_t
     {
         size_t retVal = 0;
@@ -204,44 +228,56 @@ namespace Ogre
         HardwareBufferLockGuard vertexLock(binding->getBuffer(bufferIdx), HardwareBuffer::LockOptions::DISCARD);
         auto *pDest = static_cast<float*>(vertexLock.pData);
 
-        unsigned char numCustomParams           = mCreator->getNumCustomParams();
-        size_t customParamIdx                   = 0;
+        //Without culling this is the full upload of a static batch, remember where everyone went
+        if( !currentCamera )
+            resetInstanceSlots();
 
-        for (auto const& itor : mInstancedEntities)
+        for( size_t i=0; i<mInstancedEntities.size(); ++i )
         {
             //Cull on an individual basis, the less entities are visible, the less instances we draw.
             //No need to use null matrices at all!
-            if( itor->findVisible( currentCamera ) )
+            if( mInstancedEntities[i]->findVisible( currentCamera ) )
             {
-                const size_t floatsWritten = itor->getTransforms3x4( (Matrix3x4f*)pDest );
-
-                if( mManager->getCameraRelativeRendering() )
-                    makeMatrixCameraRelative3x4( (Matrix3x4f*)pDest, floatsWritten / 12 );
-
-                pDest += floatsWritten;
-
-                //Write custom parameters, if any
-                for( unsigned char i=0; i<numCustomParams; ++i )
-                {
-                    *pDest++ = mCustomParams[customParamIdx+i].x;
-                    *pDest++ = mCustomParams[customParamIdx+i].y;
-                    *pDest++ = mCustomParams[customParamIdx+i].z;
-                    *pDest++ = mCustomParams[customParamIdx+i].w;
-                }
+                if( !currentCamera )
+                    assignInstanceSlot( i, retVal );
 
+                pDest = writeInstanceData( i, pDest );
                 ++retVal;
             }
-
-            customParamIdx += numCustomParams;
         }
 
         return retVal;
     }
     //-----------------------------------------------------------------------
+    void InstanceBatchHW::updateDirtyInstances()
+    {
+        if( !collectDirtySlotRanges() )
+        {
+            mRenderOperation.numberOfInstances = updateVertexBuffer( nullptr );
+            return;
+        }
+
+        VertexBufferBinding* binding = mRenderOperation.vertexData->vertexBufferBinding;
+        const HardwareVertexBufferSharedPtr &vertexBuffer = binding->getBuffer( ushort(binding->getBufferCount()-1) );
+        const size_t instanceSize = vertexBuffer->getVertexSize();
+
+        std::vector<float> scratch;
+        for( const auto& [begin, end] : mDirtySlotRanges )
+        {
+            //Only the changed instances go to the GPU, the rest of the buffer is left untouched
+            scratch.resize( (end - begin) * instanceSize / sizeof(float) );
+            float *pDest = scratch.data();
+            for( size_t slot=begin; slot<end; ++slot )
+                pDest = writeInstanceData( mSlotInstances[slot], pDest );
+
+            vertexBuffer->writeData( begin * instanceSize, (end - begin) * instanceSize, scratch.data() );
+        }
+    }
+    //-----------------------------------------------------------------------
     void InstanceBatchHW::_boundsDirty()
     {
         //Don't update if we're static, but still mark we're dirty
-        if( !mBoundsDirty && !mKeepStatic )
+        if( !mBoundsDirty && (!mKeepStatic || mIncrementalStaticUpdates) )
             mCreator->_addDirtyBatch( this );
         mBoundsDirty = true;
     }
@@ -288,7 +324,11 @@ namespace Ogre
                        "Camera-relative rendering is incompatible with Instancing's static batches. "
                        "Disable at least one of them");
 
-            //Don't update when we're static
+            //Don't update when we're static, unless asked to keep up with the changed instances
+            if( mIncrementalStaticUpdates &&
+                (mInstanceSetChanged || mHasDirtyInstances.load( std::memory_order_relaxed )) )
+                updateDirtyInstances();
+
             if( mRenderOperation.numberOfInstances )
                 queue->addRenderable( this, mRenderQueueID, mRenderQueuePriority );
         }
@@ -0,0 +1,301 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+module;
+
+#include <cstddef>
+
+module Ogre.Core;
+
+import :Exception;
+import :GpuProgramParams;
+import :HardwareBuffer;
+import :HardwareBufferManager;
+import :HardwareVertexBuffer;
+import :HiZBuffer;
+import :InstanceBatchHW_GPUCulled;
+import :InstanceManager;
+import :InstancedEntity;
+import :Material;
+import :MaterialManager;
+import :Matrix4;
+import :Pass;
+import :RenderOperation;
+import :RenderQueue;
+import :RenderSystem;
+import :RenderSystemCapabilities;
+import :RenderToVertexBuffer;
+import :Renderable;
+import :Root;
+import :SceneManager;
+import :SubMesh;
+import :Technique;
+import :TextureUnitState;
+import :Vector;
+import :VertexIndexData;
+
+import <memory>;
+import <string>;
+import <vector>;
+
+namespace Ogre
+{
+namespace
+{
+    /// Feeds the instance data of a batch as points to its culling stage
+    class CullingSource : public Renderable
+    {
+        VertexData* mVertexData;
+        MaterialPtr mMaterial;
+        LightList mLightList;
+
+    public:
+        CullingSource( VertexData* vertexData, const MaterialPtr& material )
+            : mVertexData( vertexData ), mMaterial( material ) {}
+
+        auto getMaterial() const noexcept -> const MaterialPtr& override { return mMaterial; }
+        void getRenderOperation( RenderOperation& op ) override
+        {
+            op.operationType = RenderOperation::OperationType::POINT_LIST;
+            op.useIndexes = false;
+            op.indexData = nullptr;
+            op.vertexData = mVertexData;
+        }
+        void getWorldTransforms( Matrix4* xform ) const override { *xform = Matrix4::IDENTITY; }
+        auto getSquaredViewDepth( const Camera* cam ) const -> Real override { return 0; }
+        auto getLights() const noexcept -> const LightList& override { return mLightList; }
+    };
+}
+    InstanceBatchHW_GPUCulled::InstanceBatchHW_GPUCulled( InstanceManager *creator, MeshPtr &meshReference,
+                                                          const MaterialPtr &material, size_t instancesPerBatch,
+                                                          const Mesh::IndexMap *indexToBoneMap,
+                                                          std::string_view batchName ) :
+                InstanceBatchHW( creator, meshReference, material, instancesPerBatch,
+                                 indexToBoneMap, batchName )
+    {
+    }
+
+    InstanceBatchHW_GPUCulled::~InstanceBatchHW_GPUCulled()
+    = default;
+
+    //-----------------------------------------------------------------------
+    auto InstanceBatchHW_GPUCulled::calculateMaxNumInstances( const SubMesh *baseSubMesh,
+                                                              InstanceManagerFlags flags ) const -> size_t
+    {
+        const RenderSystemCapabilities *capabilities = Root::getSingleton().getRenderSystem()->getCapabilities();
+        if( !capabilities->hasCapability( Capabilities::HWRENDER_TO_VERTEX_BUFFER ) )
+            return 0;
+
+        return InstanceBatchHW::calculateMaxNumInstances( baseSubMesh, flags );
+    }
+    //-----------------------------------------------------------------------
+    void InstanceBatchHW_GPUCulled::createCullingStage()
+    {
+        MaterialPtr cullingMaterial = MaterialManager::getSingleton().getByName(
+                                                mCreator->getGpuCullingMaterialName(), mMeshReference->getGroup() );
+        if( !cullingMaterial )
+        {
+            OGRE_EXCEPT(ExceptionCodes::ITEM_NOT_FOUND, ::std::format("Could not find GPU culling material '{}'. "
+                                                        "See InstanceManager::setGpuCullingMaterialName",
+                                                        mCreator->getGpuCullingMaterialName()),
+                        "InstanceBatchHW_GPUCulled::createCullingStage");
+        }
+
+        //The per instance data is in the last source, see InstanceBatchHW::setupVertices
+        VertexData *thisVertexData = mRenderOperation.vertexData;
+        mInstanceSource = thisVertexData->vertexDeclaration->getMaxSource();
+        mInstanceBuffer = thisVertexData->vertexBufferBinding->getBuffer( mInstanceSource );
+        const size_t instanceSize = thisVertexData->vertexDeclaration->getVertexSize( mInstanceSource );
+        const auto numRows = static_cast<unsigned short>(
+                                thisVertexData->vertexDeclaration->findElementsBySource( mInstanceSource ).size() );
+
+        //Input: the instance rows followed by the world bounding sphere
+        mCullingData = std::make_unique<VertexData>();
+        mCullingData->vertexCount = 0;
+        VertexDeclaration *cullDecl = mCullingData->vertexDeclaration;
+        for( unsigned short i=0; i<=numRows; ++i )
+        {
+            cullDecl->addElement( 0, cullDecl->getVertexSize( 0 ), VertexElementType::FLOAT4,
+                                  VertexElementSemantic::TEXTURE_COORDINATES, i );
+        }
+        mCullingData->vertexBufferBinding->setBinding( 0,
+                                        HardwareBufferManager::getSingleton().createVertexBuffer(
+                                        cullDecl->getVertexSize( 0 ), mInstancesPerBatch,
+                                        HardwareBuffer::DYNAMIC_WRITE_ONLY_DISCARDABLE ) );
+        mCullingSource = std::make_unique<CullingSource>( mCullingData.get(), cullingMaterial );
+
+        //Output: the rows of the surviving instances, laid out like the instance buffer
+        mCullingStage = HardwareBufferManager::getSingleton().createRenderToVertexBuffer();
+        VertexDeclaration *outDecl = mCullingStage->getVertexDeclaration();
+        for( unsigned short i=0; i<numRows; ++i )
+        {
+            outDecl->addElement( 0, outDecl->getVertexSize( 0 ), VertexElementType::FLOAT4,
+                                 VertexElementSemantic::TEXTURE_COORDINATES, i );
+        }
+        OgreAssert( outDecl->getVertexSize( 0 ) == instanceSize, "unexpected instance data layout" );
+        mCullingStage->setOperationType( RenderOperation::OperationType::POINT_LIST );
+        mCullingStage->setMaxVertexCount( static_cast<unsigned int>( mInstancesPerBatch ) );
+        mCullingStage->setResetsEveryUpdate( true );
+        mCullingStage->setSourceRenderable( mCullingSource.get() );
+        mCullingStage->setRenderToBufferMaterialName( cullingMaterial->getName() );
+    }
+    //-----------------------------------------------------------------------
+    auto InstanceBatchHW_GPUCulled::uploadInstanceData() -> size_t
+    {
+        size_t retVal = 0;
+
+        HardwareBufferLockGuard vertexLock( mCullingData->vertexBufferBinding->getBuffer( 0 ),
+                                            HardwareBuffer::LockOptions::DISCARD );
+        auto *pDest = static_cast<float*>(vertexLock.pData);
+
+        unsigned char numCustomParams           = mCreator->getNumCustomParams();
+        size_t customParamIdx                   = 0;
+
+        for (auto const& itor : mInstancedEntities)
+        {
+            //No camera, the culling is done by the GPU
+            if( itor->findVisible( nullptr ) )
+            {
+                pDest += itor->getTransforms3x4( (Matrix3x4f*)pDest );
+
+                for( unsigned char i=0; i<numCustomParams; ++i )
+                {
+                    *pDest++ = mCustomParams[customParamIdx+i].x;
+                    *pDest++ = mCustomParams[customParamIdx+i].y;
+                    *pDest++ = mCustomParams[customParamIdx+i].z;
+                    *pDest++ = mCustomParams[customParamIdx+i].w;
+                }
+
+                const Vector3 &centre = itor->_getDerivedPosition();
+                *pDest++ = centre.x;
+                *pDest++ = centre.y;
+                *pDest++ = centre.z;
+                *pDest++ = itor->getBoundingRadius() * itor->getMaxScaleCoef();
+
+                ++retVal;
+            }
+
+            customParamIdx += numCustomParams;
+        }
+
+        return retVal;
+    }
+    //-----------------------------------------------------------------------
+    void InstanceBatchHW_GPUCulled::updateCullingParameters()
+    {
+        Pass *pass = mCullingStage->getRenderToBufferMaterial()->getBestTechnique()->getPass( 0 );
+        const Vector4 distanceRange{ mCreator->getGpuCullingMinDistance(), mCreator->getGpuCullingMaxDistance(),
+                                     0, 0 };
+
+        //The depth of the frame the buffer was built for, if any
+        const HiZBuffer *hiZBuffer = mCreator->getGpuCullingHiZBuffer();
+        if( hiZBuffer && !hiZBuffer->getTexture() )
+            hiZBuffer = nullptr;
+        if( hiZBuffer )
+        {
+            if( TextureUnitState *tus = pass->getTextureUnitState( "hiZ" ) )
+                tus->_setTexturePtr( hiZBuffer->getTexture() );
+        }
+
+        auto setParameters = [&]( const GpuProgramParametersSharedPtr &params )
+        {
+            if( params->_findNamedConstantDefinition( "instanceDistanceRange" ) )
+                params->setNamedConstant( "instanceDistanceRange", distanceRange );
+            if( !hiZBuffer )
+                return;
+
+            const HiZBuffer::Frame &frame = hiZBuffer->getFrame();
+            if( params->_findNamedConstantDefinition( "hiZViewProj" ) )
+                params->setNamedConstant( "hiZViewProj", frame.viewProj );
+            if( params->_findNamedConstantDefinition( "hiZCameraPosition" ) )
+                params->setNamedConstant( "hiZCameraPosition", frame.cameraPosition );
+            if( params->_findNamedConstantDefinition( "hiZSize" ) )
+                params->setNamedConstant( "hiZSize", frame.size );
+        };
+
+        if( pass->hasVertexProgram() )
+            setParameters( pass->getVertexProgramParameters() );
+        if( pass->hasGeometryProgram() )
+            setParameters( pass->getGeometryProgramParameters() );
+    }
+    //-----------------------------------------------------------------------
+    void InstanceBatchHW_GPUCulled::_boundsDirty()
+    {
+        mInstanceDataDirty = true;
+        InstanceBatchHW::_boundsDirty();
+    }
+    //-----------------------------------------------------------------------
+    void InstanceBatchHW_GPUCulled::setStaticAndUpdate( bool bStatic )
+    {
+        //Static batches write to their own instance buffer again
+        if( bStatic && mInstanceBuffer )
+            mRenderOperation.vertexData->vertexBufferBinding->setBinding( mInstanceSource, mInstanceBuffer );
+
+        InstanceBatchHW::setStaticAndUpdate( bStatic );
+    }
+    //-----------------------------------------------------------------------
+    void InstanceBatchHW_GPUCulled::_updateRenderQueue( RenderQueue* queue )
+    {
+        if( isStatic() )
+        {
+            InstanceBatchHW::_updateRenderQueue( queue );
+            return;
+        }
+
+        OgreAssert(!mManager->getCameraRelativeRendering(),
+                   "Camera-relative rendering is incompatible with GPU culled instancing");
+
+        if( !mCullingStage )
+            createCullingStage();
+
+        if( mInstanceDataDirty )
+        {
+            mCullingData->vertexCount = uploadInstanceData();
+            mInstanceDataDirty = false;
+        }
+
+        mRenderOperation.numberOfInstances = 0;
+        if( !mCullingData->vertexCount )
+            return;
+
+        //Cull for the current camera, its matrices are already set in the auto params
+        updateCullingParameters();
+        mCullingStage->update( mManager );
+
+        RenderOperation culledOp;
+        mCullingStage->getRenderOperation( culledOp );
+        if( (mRenderOperation.numberOfInstances = culledOp.vertexData->vertexCount) )
+        {
+            const HardwareVertexBufferSharedPtr &culledBuffer =
+                                                culledOp.vertexData->vertexBufferBinding->getBuffer( 0 );
+            culledBuffer->setIsInstanceData( true );
+            culledBuffer->setInstanceDataStepRate( 1 );
+            mRenderOperation.vertexData->vertexBufferBinding->setBinding( mInstanceSource, culledBuffer );
+            queue->addRenderable( this, mRenderQueueID, mRenderQueuePriority );
+        }
+    }
+}
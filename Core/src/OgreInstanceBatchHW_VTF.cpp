@@ -53,6 +53,7 @@ import :Vector;
 import :VertexIndexData;
 
 import <algorithm>;
+import <atomic>;
 import <map>;
 import <memory>;
 import <string>;
@@ -451,13 +452,11 @@ namespace Ogre
         size_t instanceCount = mInstancedEntities.size();
         size_t updatedInstances = 0;
 
-        Matrix3x4f* transforms = nullptr;
-        //If using dual quaternions, write 3x4 matrices to a temporary buffer, then convert to dual quaternions
-        if(mUseBoneDualQuaternions)
-        {
-            transforms = (Matrix3x4f*)mTempTransformsArray3x4.get();
-        }
-        
+        //Without culling this is the full upload of a static batch, remember where everyone went
+        const bool assignSlots = !currentCamera && !useMatrixLookup;
+        if( assignSlots )
+            resetInstanceSlots();
+
         for(size_t i = 0 ; i < instanceCount ; ++i)
         {
             InstancedEntity* entity = mInstancedEntities[i].get();
@@ -476,23 +475,10 @@ namespace Ogre
                 float* pDest = pSource + floatPerEntity * textureLookupPosition + 
                     (size_t)(textureLookupPosition / entitiesPerPadding) * mWidthFloatsPadding;
 
-                if(!mUseBoneDualQuaternions)
-                {
-                    transforms = (Matrix3x4f*)pDest;
-                }
-                
-                if( mMeshReference->hasSkeleton() )
-                    mDirtyAnimation |= entity->_updateAnimation();
+                if( assignSlots )
+                    assignInstanceSlot( i, textureLookupPosition );
 
-                size_t floatsWritten = entity->getTransforms3x4( transforms );
-
-                if( !useMatrixLookup && mManager->getCameraRelativeRendering() )
-                    makeMatrixCameraRelative3x4( transforms, floatsWritten / 12 );
-
-                if(mUseBoneDualQuaternions)
-                {
-                    convert3x4MatricesToDualQuaternions(transforms, floatsWritten / 12, pDest);
-                }
+                writeInstanceTransforms( entity, pDest, useMatrixLookup );
 
                 if (useMatrixLookup)
                 {
@@ -515,10 +501,73 @@ namespace Ogre
         return renderedInstances;
     }
     //-----------------------------------------------------------------------
+    void InstanceBatchHW_VTF::writeInstanceTransforms( InstancedEntity *entity, float *pDest, bool useMatrixLookup )
+    {
+        //If using dual quaternions, write 3x4 matrices to a temporary buffer, then convert to dual quaternions
+        Matrix3x4f* transforms = mUseBoneDualQuaternions ? (Matrix3x4f*)mTempTransformsArray3x4.get() :
+                                                           (Matrix3x4f*)pDest;
+
+        if( mMeshReference->hasSkeleton() )
+            mDirtyAnimation |= entity->_updateAnimation();
+
+        size_t floatsWritten = entity->getTransforms3x4( transforms );
+
+        if( !useMatrixLookup && mManager->getCameraRelativeRendering() )
+            makeMatrixCameraRelative3x4( transforms, floatsWritten / 12 );
+
+        if(mUseBoneDualQuaternions)
+        {
+            convert3x4MatricesToDualQuaternions(transforms, floatsWritten / 12, pDest);
+        }
+    }
+    //-----------------------------------------------------------------------
+    void InstanceBatchHW_VTF::updateDirtyInstances()
+    {
+        //Shared transforms are looked up through the instance buffer, just do it all again
+        if( useBoneMatrixLookup() || !collectDirtySlotRanges() )
+        {
+            mRenderOperation.numberOfInstances = updateVertexTexture( nullptr );
+            return;
+        }
+
+        //Each texture row holds a whole number of instances (see the padding in BaseInstanceBatchVTF),
+        //so rewrite all instances of the rows the changed ones are in, and nothing else
+        const HardwarePixelBufferSharedPtr &pixelBuffer = mMatrixTexture->getBuffer();
+        const size_t floatPerEntity = mMatricesPerInstance * mRowLength * 4;
+        const size_t entitiesPerRow = (mMatrixTexture->getWidth() * 4) / floatPerEntity;
+        const size_t numSlots = mSlotInstances.size();
+
+        size_t lastRowEnd = 0;
+        for( const auto& [begin, end] : mDirtySlotRanges )
+        {
+            const size_t rowBegin = std::max( begin / entitiesPerRow, lastRowEnd );
+            const size_t rowEnd = (end - 1) / entitiesPerRow + 1;
+            if( rowBegin >= rowEnd )
+                continue;
+
+            const PixelBox &pixelBox = pixelBuffer->lock( Box{ 0, static_cast<uint32>( rowBegin ),
+                                                               mMatrixTexture->getWidth(),
+                                                               static_cast<uint32>( rowEnd ) },
+                                                          HardwareBuffer::LockOptions::WRITE_ONLY );
+            auto *pRows = reinterpret_cast<float*>( pixelBox.getTopLeftFrontPixelPtr() );
+            const size_t rowFloats = pixelBox.rowPitch * 4;
+
+            for( size_t slot = rowBegin * entitiesPerRow; slot < std::min( rowEnd * entitiesPerRow, numSlots ); ++slot )
+            {
+                float *pDest = pRows + (slot / entitiesPerRow - rowBegin) * rowFloats +
+                               (slot % entitiesPerRow) * floatPerEntity;
+                writeInstanceTransforms( mInstancedEntities[mSlotInstances[slot]].get(), pDest, false );
+            }
+
+            pixelBuffer->unlock();
+            lastRowEnd = rowEnd;
+        }
+    }
+    //-----------------------------------------------------------------------
     void InstanceBatchHW_VTF::_boundsDirty()
     {
         //Don't update if we're static, but still mark we're dirty
-        if( !mBoundsDirty && !mKeepStatic && mCreator)
+        if( !mBoundsDirty && (!mKeepStatic || mIncrementalStaticUpdates) && mCreator)
             mCreator->_addDirtyBatch( this );
         mBoundsDirty = true;
     }
@@ -554,7 +603,11 @@ namespace Ogre
                        "Camera-relative rendering is incompatible with Instancing's static batches. "
                        "Disable at least one of them");
 
-            //Don't update when we're static
+            //Don't update when we're static, unless asked to keep up with the changed instances
+            if( mIncrementalStaticUpdates &&
+                (mInstanceSetChanged || mHasDirtyInstances.load( std::memory_order_relaxed )) )
+                updateDirtyInstances();
+
             if( mRenderOperation.numberOfInstances )
                 queue->addRenderable( this, mRenderQueueID, mRenderQueuePriority );
         }
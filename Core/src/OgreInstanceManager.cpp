@@ -39,6 +39,7 @@ import :HardwareIndexBuffer;
 import :HardwareVertexBuffer;
 import :InstanceBatch;
 import :InstanceBatchHW;
+import :InstanceBatchHW_GPUCulled;
 import :InstanceBatchHW_VTF;
 import :InstanceBatchShader;
 import :InstanceBatchVTF;
@@ -56,6 +57,7 @@ import :VertexIndexData;
 
 import <algorithm>;
 import <memory>;
+import <mutex>;
 import <utility>;
 
 namespace Ogre
@@ -101,6 +103,19 @@ namespace Ogre
         mNumCustomParams = numCustomParams;
     }
     //----------------------------------------------------------------------
+    void InstanceManager::setGpuCullingMaterialName( std::string_view materialName )
+    {
+        OgreAssert(mInstanceBatches.empty(), "can only be changed before building the batch");
+        mGpuCullingMaterialName = materialName;
+    }
+    //----------------------------------------------------------------------
+    void InstanceManager::setGpuCullingDistanceRange( Real minDistance, Real maxDistance )
+    {
+        OgreAssert(minDistance <= maxDistance, "invalid distance range");
+        mGpuCullingMinDistance = minDistance;
+        mGpuCullingMaxDistance = maxDistance;
+    }
+    //----------------------------------------------------------------------
     auto InstanceManager::getMaxOrBestNumInstancesPerBatch( std::string_view materialName, size_t suggestedSize,
                                                                 InstanceManagerFlags flags ) -> size_t
     {
@@ -130,6 +145,10 @@ namespace Ogre
             batch = new InstanceBatchHW( this, mMeshReference, mat, suggestedSize,
                                                     nullptr, ::std::format("{}/TempBatch", mName) );
             break;
+        case HWInstancingGPUCulled:
+            batch = new InstanceBatchHW_GPUCulled( this, mMeshReference, mat, suggestedSize,
+                                                    nullptr, ::std::format("{}/TempBatch", mName) );
+            break;
         case HWInstancingVTF:
             batch = new InstanceBatchHW_VTF( this, mMeshReference, mat, suggestedSize,
                                                     nullptr, ::std::format("{}/TempBatch", mName) );
@@ -211,6 +230,10 @@ namespace Ogre
             batch = ::std::make_unique<InstanceBatchHW>( this, mMeshReference, mat, mInstancesPerBatch,
                                                     &idxMap, ::std::format("{}/InstanceBatch_{}", mName, mIdCount++));
             break;
+        case HWInstancingGPUCulled:
+            batch = ::std::make_unique<InstanceBatchHW_GPUCulled>( this, mMeshReference, mat, mInstancesPerBatch,
+                                                    &idxMap, ::std::format("{}/InstanceBatch_{}", mName, mIdCount++));
+            break;
         case HWInstancingVTF:
             batch = ::std::make_unique<InstanceBatchHW_VTF>( this, mMeshReference, mat, mInstancesPerBatch,
                                                     &idxMap, ::std::format("{}/InstanceBatch_{}", mName, mIdCount++));
@@ -252,6 +275,7 @@ namespace Ogre
 
         const BatchSettings &batchSettings = mBatchSettings[materialName];
         batch->setCastShadows( batchSettings.setting[std::to_underlying(CAST_SHADOWS)] );
+        batch->setIncrementalStaticUpdates( batchSettings.setting[std::to_underlying(INCREMENTAL_STATIC_UPDATES)] );
 
         //Batches need to be part of a scene node so that their renderable can be rendered
         SceneNode *sceneNode = mSceneManager->getRootSceneNode()->createChildSceneNode();
@@ -371,6 +395,100 @@ namespace Ogre
         }
     }
     //-----------------------------------------------------------------------
+    void InstanceManager::setIncrementalDefragmentation( size_t maxInstancesPerFrame, bool optimizeCulling )
+    {
+        mDefragmentationBudget = maxInstancesPerFrame;
+        mDefragmentationCulling = optimizeCulling;
+    }
+    //-----------------------------------------------------------------------
+    auto InstanceManager::getDefragmentationTarget( const InstancedEntity *instancedEntity ) const -> InstanceBatch*
+    {
+        InstanceBatch *retVal = nullptr;
+        Real bestDistance = std::numeric_limits<Real>::max();
+        size_t mostUsed = 0;
+
+        for( InstanceBatch *batch : mDefragmentationBatches )
+        {
+            if( batch->isBatchFull() )
+                continue;
+
+            if( mDefragmentationCulling )
+            {
+                //The bounds may be a frame old, which is fine for picking a neighbourhood
+                const AxisAlignedBox &bounds = batch->getBoundingBox();
+                Real distance = bounds.isFinite() ? bounds.squaredDistance( instancedEntity->_getDerivedPosition() )
+                                                  : std::numeric_limits<Real>::max();
+                if( !retVal || distance < bestDistance )
+                {
+                    retVal = batch;
+                    bestDistance = distance;
+                }
+            }
+            else if( !retVal || batch->getUsedEntityCount() > mostUsed )
+            {
+                retVal = batch;
+                mostUsed = batch->getUsedEntityCount();
+            }
+        }
+
+        return retVal;
+    }
+    //-----------------------------------------------------------------------
+    auto InstanceManager::_updateIncrementalDefragmentation() -> size_t
+    {
+        size_t budget = mDefragmentationBudget;
+
+        for( auto& [materialName, batches] : mInstanceBatches )
+        {
+            if( budget == 0 )
+                break;
+
+            mDefragmentationBatches.clear();
+            size_t usedCount = 0;
+            for( auto const& batch : batches )
+            {
+                if( !batch->isStatic() && !batch->isBatchUnused() )
+                {
+                    mDefragmentationBatches.push_back( batch.get() );
+                    usedCount += batch->getUsedEntityCount();
+                }
+            }
+
+            //Nothing to gain when the instances can't be packed into fewer batches
+            const size_t minBatchCount = (usedCount + mInstancesPerBatch - 1) / mInstancesPerBatch;
+            if( mDefragmentationBatches.size() <= minBatchCount )
+                continue;
+
+            //Empty the emptiest batch. The others have enough free slots to take all of its
+            //entities, as there are more batches than needed
+            auto source = std::ranges::min_element( mDefragmentationBatches, {}, &InstanceBatch::getUsedEntityCount );
+            InstanceBatch *sourceBatch = *source;
+            *source = mDefragmentationBatches.back();
+            mDefragmentationBatches.pop_back();
+
+            const InstanceBatch::InstancedEntityVec &entities = sourceBatch->_getInstancedEntities();
+            for( size_t i = 0; i < entities.size() && budget > 0; ++i )
+            {
+                //A migrated slot gets an unused entity, so going on with the next one is safe
+                InstancedEntity *instancedEntity = entities[i].get();
+                if( !instancedEntity->isInUse() )
+                    continue;
+
+                sourceBatch->_migrateInstancedEntity( instancedEntity, getDefragmentationTarget( instancedEntity ) );
+                --budget;
+            }
+
+            if( sourceBatch->isBatchUnused() )
+            {
+                //Do this now to avoid any dangling pointer inside mDirtyBatches
+                _updateDirtyBatches();
+                std::erase_if( batches, [sourceBatch]( auto const& batch ) { return batch.get() == sourceBatch; } );
+            }
+        }
+
+        return mDefragmentationBudget - budget;
+    }
+    //-----------------------------------------------------------------------
     void InstanceManager::setSetting( BatchSettingId id, bool value, std::string_view materialName )
     {
         assert( id < NUM_SETTINGS );
@@ -426,6 +544,9 @@ namespace Ogre
             case SHOW_BOUNDINGBOX:
                 itor->getParentSceneNode()->showBoundingBox( value );
                 break;
+            case INCREMENTAL_STATIC_UPDATES:
+                itor->setIncrementalStaticUpdates( value );
+                break;
             default:
                 break;
             }
@@ -445,6 +566,7 @@ namespace Ogre
     //-----------------------------------------------------------------------
     void InstanceManager::_addDirtyBatch( InstanceBatch *dirtyBatch )
     {
+        std::unique_lock<std::mutex> dirtyLock( mDirtyBatchesMutex );
         if( mDirtyBatches.empty() )
             mSceneManager->_addDirtyInstanceManager( this );
 
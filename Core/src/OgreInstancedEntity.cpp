@@ -37,8 +37,10 @@ import :Math;
 import :Mesh;
 import :NameGenerator;
 import :OptimisedUtil;
+import :SceneManager;
 import :SharedPtr;
 import :SkeletonInstance;
+import :SkeletonPoseCache;
 import :Sphere;
 import :StringConverter;
 
@@ -410,8 +412,18 @@ namespace Ogre
 
             if( animationDirty || (mNeedAnimTransformUpdate &&  mBatchOwner->useBoneWorldMatrices()))
             {
-                mSkeletonInstance->setAnimationState( *mAnimationState );
-                mSkeletonInstance->_getBoneMatrices( mBoneMatrices );
+                // share the palette with other instances in the same pose, see SceneManager::setSkeletonPoseSharing
+                SceneManager* sceneMgr = mBatchOwner->_getManager();
+                SkeletonPoseCache* cache = sceneMgr ? sceneMgr->getSkeletonPoseCache() : nullptr;
+                size_t numBones = mSkeletonInstance->getNumBones();
+                bool keyed = cache && cache->makeKey(*mSkeletonInstance, *mAnimationState, nullptr, mPoseKey);
+                if (!keyed || !cache->find(mPoseKey, mBoneMatrices, numBones))
+                {
+                    mSkeletonInstance->setAnimationState( *mAnimationState );
+                    mSkeletonInstance->_getBoneMatrices( mBoneMatrices );
+                    if (keyed)
+                        cache->insert(mPoseKey, mBoneMatrices, numBones);
+                }
 
                 // Cache last parent transform for next frame use too.
                 if (mBatchOwner->useBoneWorldMatrices())
@@ -438,6 +450,7 @@ namespace Ogre
     {
         mNeedTransformUpdate = true;
         mNeedAnimTransformUpdate = true; 
+        mBatchOwner->_markInstanceDirty(this);
         mBatchOwner->_boundsDirty();
     }
 
@@ -0,0 +1,332 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+module;
+
+#include <cstddef>
+#include <cstring>
+// NOLINTBEGIN
+#define MINIZ_HEADER_FILE_ONLY
+#include <miniz.h>
+// NOLINTEND
+
+module Ogre.Core;
+
+import :Codec;
+import :DataStream;
+import :Exception;
+import :Image;
+import :KTX2Codec;
+import :LogManager;
+import :PixelFormat;
+import :Platform;
+import :SharedPtr;
+
+import <algorithm>;
+import <format>;
+import <vector>;
+
+namespace Ogre {
+    namespace
+    {
+        const uint8 KTX2_IDENTIFIER[12] = {0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A};
+
+        struct KTX2Header
+        {
+            uint8 identifier[12];
+            uint32 vkFormat;
+            uint32 typeSize;
+            uint32 pixelWidth;
+            uint32 pixelHeight;
+            uint32 pixelDepth;
+            uint32 layerCount;
+            uint32 faceCount;
+            uint32 levelCount;
+            uint32 supercompressionScheme;
+            uint32 dfdByteOffset;
+            uint32 dfdByteLength;
+            uint32 kvdByteOffset;
+            uint32 kvdByteLength;
+            uint64 sgdByteOffset;
+            uint64 sgdByteLength;
+        };
+        static_assert(sizeof(KTX2Header) == 80);
+
+        struct KTX2Level
+        {
+            uint64 byteOffset;
+            uint64 byteLength;
+            uint64 uncompressedByteLength;
+        };
+
+        enum
+        {
+            SUPERCOMPRESSION_NONE = 0,
+            SUPERCOMPRESSION_BASISLZ = 1,
+            SUPERCOMPRESSION_ZSTD = 2,
+            SUPERCOMPRESSION_ZLIB = 3
+        };
+
+        auto convertVkFormat(uint32 vkFormat) -> PixelFormat
+        {
+            using enum PixelFormat;
+            switch (vkFormat)
+            {
+            case 9: // VK_FORMAT_R8_UNORM
+                return R8;
+            case 16: // VK_FORMAT_R8G8_UNORM
+                return RG8;
+            case 23: // VK_FORMAT_R8G8B8_UNORM
+            case 29: // VK_FORMAT_R8G8B8_SRGB
+                return BYTE_RGB;
+            case 37: // VK_FORMAT_R8G8B8A8_UNORM
+            case 43: // VK_FORMAT_R8G8B8A8_SRGB
+                return BYTE_RGBA;
+            case 44: // VK_FORMAT_B8G8R8A8_UNORM
+            case 50: // VK_FORMAT_B8G8R8A8_SRGB
+                return BYTE_BGRA;
+            case 76: // VK_FORMAT_R16_SFLOAT
+                return FLOAT16_R;
+            case 97: // VK_FORMAT_R16G16B16A16_SFLOAT
+                return FLOAT16_RGBA;
+            case 100: // VK_FORMAT_R32_SFLOAT
+                return FLOAT32_R;
+            case 109: // VK_FORMAT_R32G32B32A32_SFLOAT
+                return FLOAT32_RGBA;
+            case 131: // VK_FORMAT_BC1_RGB_UNORM_BLOCK
+            case 132: // VK_FORMAT_BC1_RGB_SRGB_BLOCK
+            case 133: // VK_FORMAT_BC1_RGBA_UNORM_BLOCK
+            case 134: // VK_FORMAT_BC1_RGBA_SRGB_BLOCK
+                return DXT1;
+            case 135: // VK_FORMAT_BC2_UNORM_BLOCK
+            case 136: // VK_FORMAT_BC2_SRGB_BLOCK
+                return DXT3;
+            case 137: // VK_FORMAT_BC3_UNORM_BLOCK
+            case 138: // VK_FORMAT_BC3_SRGB_BLOCK
+                return DXT5;
+            case 139: // VK_FORMAT_BC4_UNORM_BLOCK
+                return BC4_UNORM;
+            case 140: // VK_FORMAT_BC4_SNORM_BLOCK
+                return BC4_SNORM;
+            case 141: // VK_FORMAT_BC5_UNORM_BLOCK
+                return BC5_UNORM;
+            case 142: // VK_FORMAT_BC5_SNORM_BLOCK
+                return BC5_SNORM;
+            case 143: // VK_FORMAT_BC6H_UFLOAT_BLOCK
+                return BC6H_UF16;
+            case 144: // VK_FORMAT_BC6H_SFLOAT_BLOCK
+                return BC6H_SF16;
+            case 145: // VK_FORMAT_BC7_UNORM_BLOCK
+            case 146: // VK_FORMAT_BC7_SRGB_BLOCK
+                return BC7_UNORM;
+            case 147: // VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK
+            case 148: // VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK
+                return ETC2_RGB8;
+            case 149: // VK_FORMAT_ETC2_R8G8B8A1_UNORM_BLOCK
+            case 150: // VK_FORMAT_ETC2_R8G8B8A1_SRGB_BLOCK
+                return ETC2_RGB8A1;
+            case 151: // VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK
+            case 152: // VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK
+                return ETC2_RGBA8;
+            case 157: // VK_FORMAT_ASTC_4x4_UNORM_BLOCK
+            case 158:
+                return ASTC_RGBA_4X4_LDR;
+            case 159: // VK_FORMAT_ASTC_5x4_UNORM_BLOCK
+            case 160:
+                return ASTC_RGBA_5X4_LDR;
+            case 161: // VK_FORMAT_ASTC_5x5_UNORM_BLOCK
+            case 162:
+                return ASTC_RGBA_5X5_LDR;
+            case 163: // VK_FORMAT_ASTC_6x5_UNORM_BLOCK
+            case 164:
+                return ASTC_RGBA_6X5_LDR;
+            case 165: // VK_FORMAT_ASTC_6x6_UNORM_BLOCK
+            case 166:
+                return ASTC_RGBA_6X6_LDR;
+            case 167: // VK_FORMAT_ASTC_8x5_UNORM_BLOCK
+            case 168:
+                return ASTC_RGBA_8X5_LDR;
+            case 169: // VK_FORMAT_ASTC_8x6_UNORM_BLOCK
+            case 170:
+                return ASTC_RGBA_8X6_LDR;
+            case 171: // VK_FORMAT_ASTC_8x8_UNORM_BLOCK
+            case 172:
+                return ASTC_RGBA_8X8_LDR;
+            case 173: // VK_FORMAT_ASTC_10x5_UNORM_BLOCK
+            case 174:
+                return ASTC_RGBA_10X5_LDR;
+            case 175: // VK_FORMAT_ASTC_10x6_UNORM_BLOCK
+            case 176:
+                return ASTC_RGBA_10X6_LDR;
+            case 177: // VK_FORMAT_ASTC_10x8_UNORM_BLOCK
+            case 178:
+                return ASTC_RGBA_10X8_LDR;
+            case 179: // VK_FORMAT_ASTC_10x10_UNORM_BLOCK
+            case 180:
+                return ASTC_RGBA_10X10_LDR;
+            case 181: // VK_FORMAT_ASTC_12x10_UNORM_BLOCK
+            case 182:
+                return ASTC_RGBA_12X10_LDR;
+            case 183: // VK_FORMAT_ASTC_12x12_UNORM_BLOCK
+            case 184:
+                return ASTC_RGBA_12X12_LDR;
+            default:
+                return UNKNOWN;
+            }
+        }
+    }
+    //---------------------------------------------------------------------
+    KTX2Codec* KTX2Codec::msInstance = nullptr;
+    //---------------------------------------------------------------------
+    void KTX2Codec::startup()
+    {
+        if (!msInstance)
+        {
+            msInstance = new KTX2Codec();
+            Codec::registerCodec(msInstance);
+        }
+
+        LogManager::getSingleton().logMessage(LogMessageLevel::Normal, "KTX2 codec registering");
+    }
+    //---------------------------------------------------------------------
+    void KTX2Codec::shutdown()
+    {
+        if (msInstance)
+        {
+            Codec::unregisterCodec(msInstance);
+            delete msInstance;
+            msInstance = nullptr;
+        }
+    }
+    //---------------------------------------------------------------------
+    auto KTX2Codec::getType() const -> std::string_view
+    {
+        return "ktx2";
+    }
+    //---------------------------------------------------------------------
+    auto KTX2Codec::magicNumberToFileExt(const char *magicNumberPtr, size_t maxbytes) const -> std::string_view
+    {
+        if (maxbytes >= sizeof(KTX2_IDENTIFIER) && memcmp(magicNumberPtr, KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER)) == 0)
+            return "ktx2";
+
+        return BLANKSTRING;
+    }
+    //---------------------------------------------------------------------
+    auto KTX2Codec::decode(const DataStreamPtr& stream) const -> DecodeResult
+    {
+        KTX2Header header;
+        if (stream->read(&header, sizeof(KTX2Header)) != sizeof(KTX2Header) ||
+            memcmp(header.identifier, KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER)) != 0)
+            OGRE_EXCEPT(ExceptionCodes::INVALIDPARAMS, "This is not a KTX2 file", stream->getName());
+
+        if (header.vkFormat == 0 || header.supercompressionScheme == SUPERCOMPRESSION_BASISLZ)
+            OGRE_EXCEPT(ExceptionCodes::NOT_IMPLEMENTED, "Basis Universal payloads are not supported",
+                        stream->getName());
+        if (header.supercompressionScheme != SUPERCOMPRESSION_NONE && header.supercompressionScheme != SUPERCOMPRESSION_ZLIB)
+            OGRE_EXCEPT(ExceptionCodes::NOT_IMPLEMENTED,
+                        ::std::format("Supercompression scheme {} is not supported", header.supercompressionScheme),
+                        stream->getName());
+
+        PixelFormat format = convertVkFormat(header.vkFormat);
+        if (format == PixelFormat::UNKNOWN)
+            OGRE_EXCEPT(ExceptionCodes::NOT_IMPLEMENTED, ::std::format("VkFormat {} is not supported", header.vkFormat),
+                        stream->getName());
+
+        uint32 numFaces = header.faceCount;
+        uint32 numLayers = std::max(header.layerCount, 1u);
+        if (numFaces != 1 && numFaces != 6)
+            OGRE_EXCEPT(ExceptionCodes::INVALIDPARAMS, "Invalid number of faces", stream->getName());
+        if (numLayers > 1 && (numFaces == 6 || header.pixelDepth > 1))
+            OGRE_EXCEPT(ExceptionCodes::NOT_IMPLEMENTED, "Cubemap and volume arrays are not supported",
+                        stream->getName());
+
+        // a level count of 0 asks for generated mipmaps
+        std::vector<KTX2Level> levels(std::max(header.levelCount, 1u));
+        stream->read(levels.data(), levels.size() * sizeof(KTX2Level));
+        // Image halves the slices of every mipmap, which are the layers here
+        uint32 numLevels = numLayers > 1 ? 1 : uint32(levels.size());
+
+        auto *imgData = new ImageData();
+        imgData->width = header.pixelWidth;
+        imgData->height = std::max(header.pixelHeight, 1u);
+        // array layers are stored as slices
+        imgData->depth = std::max(header.pixelDepth, 1u) * numLayers;
+        imgData->num_mipmaps = static_cast<TextureMipmap>(numLevels - 1);
+        imgData->format = format;
+        if (PixelUtil::isCompressed(format))
+            imgData->flags |= ImageFlags::COMPRESSED;
+        if (header.pixelDepth > 1)
+            imgData->flags |= ImageFlags::_3D_TEXTURE;
+        if (numFaces == 6)
+            imgData->flags |= ImageFlags::CUBEMAP;
+        imgData->size = Image::calculateSize(imgData->num_mipmaps, numFaces, imgData->width, imgData->height,
+                                             imgData->depth, format);
+
+        MemoryDataStreamPtr output(new MemoryDataStream(imgData->size));
+        uchar* destPtr = output->getPtr();
+        size_t faceSize = imgData->size / numFaces;
+
+        // the faces are the outer loop in Image, the levels in KTX2
+        std::vector<uchar> compressed, level;
+        size_t mipOffset = 0;
+        uint32 width = imgData->width, height = imgData->height, depth = imgData->depth;
+        for (uint32 mip = 0; mip < numLevels; ++mip)
+        {
+            size_t imageSize = PixelUtil::getMemorySize(width, height, depth, format);
+            level.resize(imageSize * numFaces);
+            if (levels[mip].uncompressedByteLength != level.size() && header.supercompressionScheme != SUPERCOMPRESSION_NONE)
+                OGRE_EXCEPT(ExceptionCodes::INVALIDPARAMS, "Unexpected size of a mipmap", stream->getName());
+
+            stream->seek(levels[mip].byteOffset);
+            if (header.supercompressionScheme == SUPERCOMPRESSION_ZLIB)
+            {
+                compressed.resize(levels[mip].byteLength);
+                stream->read(compressed.data(), compressed.size());
+                if (tinfl_decompress_mem_to_mem(level.data(), level.size(), compressed.data(), compressed.size(),
+                                                TINFL_FLAG_PARSE_ZLIB_HEADER) != level.size())
+                    OGRE_EXCEPT(ExceptionCodes::INVALIDPARAMS, "Corrupt zlib data", stream->getName());
+            }
+            else if (stream->read(level.data(), level.size()) != level.size())
+            {
+                OGRE_EXCEPT(ExceptionCodes::INVALIDPARAMS, "Unexpected end of file", stream->getName());
+            }
+
+            for (uint32 face = 0; face < numFaces; ++face)
+                memcpy(destPtr + faceSize * face + mipOffset, level.data() + imageSize * face, imageSize);
+
+            mipOffset += imageSize;
+            width = std::max(width / 2, 1u);
+            height = std::max(height / 2, 1u);
+            depth = std::max(depth / 2, 1u);
+        }
+
+        DecodeResult ret;
+        ret.first = output;
+        ret.second = CodecDataPtr(imgData);
+        return ret;
+    }
+}
@@ -0,0 +1,76 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+module;
+
+#include <cstddef>
+
+module Ogre.Core:KTX2Codec;
+
+import :ImageCodec;
+import :Prerequisites;
+
+namespace Ogre {
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Image
+    *  @{
+    */
+
+    /** Codec loading KTX2 (Khronos Texture 2.0) images.
+    @remarks
+        Supported are the uncompressed 8 bit, half and float formats as well as the BCn, ETC2
+        and ASTC block formats, with mipmaps, cubemaps and array layers (as depth), optionally
+        supercompressed with zlib. Zstd and BasisLZ supercompression and the Basis Universal
+        payloads can not be read.
+    @par
+        Images shipped uncompressed, and therefore the same on every platform, can be block
+        compressed to a format the GPU supports while the texture is prepared, see
+        TextureManager::setRuntimeCompression.
+    */
+    class KTX2Codec : public ImageCodec
+    {
+    public:
+        using ImageCodec::decode;
+        [[nodiscard]] auto decode(const DataStreamPtr& input) const -> DecodeResult override;
+        auto magicNumberToFileExt(const char *magicNumberPtr, size_t maxbytes) const -> std::string_view override;
+        [[nodiscard]] auto getType() const -> std::string_view override;
+
+        /// Static method to startup and register the KTX2 codec
+        static void startup();
+        /// Static method to shutdown and unregister the KTX2 codec
+        static void shutdown();
+
+    private:
+        /// Single registered codec instance
+        static KTX2Codec* msInstance;
+    };
+    /** @} */
+    /** @} */
+
+} // namespace
@@ -0,0 +1,179 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+module;
+
+#include <cstddef>
+
+module Ogre.Core;
+
+import :AxisAlignedBox;
+import :Light;
+import :LightGrid;
+import :Node;
+import :Sphere;
+import :Vector;
+
+import <algorithm>;
+import <memory_resource>;
+import <vector>;
+
+namespace Ogre {
+
+    namespace {
+        auto rangeBox(const Vector3& centre, Real radius) -> AxisAlignedBox
+        {
+            Vector3 extent{radius, radius, radius};
+            return {AxisAlignedBox::Extent::Finite, centre - extent, centre + extent};
+        }
+    }
+    //-----------------------------------------------------------------------
+    void LightGrid::build(const LightList& lights, std::pmr::memory_resource* scratch)
+    {
+        clear();
+        mNumLights = lights.size();
+        mLightStamp.assign(mNumLights, 0);
+
+        for (Light* l : lights)
+        {
+            if (l->getType() != Light::LightTypes::DIRECTIONAL)
+                mBounds.merge(rangeBox(l->getParentNode()->_getDerivedPosition(), l->getAttenuationRange()));
+        }
+        if (mBounds.isFinite())
+        {
+            Vector3 size = mBounds.getSize();
+            for (size_t i = 0; i < 3; ++i)
+                mInvCellSize[i] = size[i] > 0 ? Real(RESOLUTION) / size[i] : 0;
+        }
+
+        // count, then fill, the entries of every cell
+        std::pmr::vector<CellRange> ranges(mNumLights, scratch);
+        mCellStart.assign(RESOLUTION * RESOLUTION * RESOLUTION + 1, 0);
+        for (uint32 i = 0; i < mNumLights; ++i)
+        {
+            Light* l = lights[i];
+            CellRange& r = ranges[i];
+            if (l->getType() == Light::LightTypes::DIRECTIONAL ||
+                !getCellRange(rangeBox(l->getParentNode()->_getDerivedPosition(), l->getAttenuationRange()), r) ||
+                r.getNumCells() > MAX_LIGHT_CELLS)
+            {
+                mGlobalLights.push_back(i);
+                r.max[0] = 0;
+                r.min[0] = 1;
+                continue;
+            }
+
+            for (size_t z = r.min[2]; z <= r.max[2]; ++z)
+                for (size_t y = r.min[1]; y <= r.max[1]; ++y)
+                    for (size_t x = r.min[0]; x <= r.max[0]; ++x)
+                        ++mCellStart[(z * RESOLUTION + y) * RESOLUTION + x + 1];
+        }
+        for (size_t c = 1; c < mCellStart.size(); ++c)
+            mCellStart[c] += mCellStart[c - 1];
+
+        mCellLights.resize(mCellStart.back());
+        std::pmr::vector<uint32> fill(mCellStart.begin(), mCellStart.end() - 1, scratch);
+        for (uint32 i = 0; i < mNumLights; ++i)
+        {
+            const CellRange& r = ranges[i];
+            if (r.min[0] > r.max[0])
+                continue;
+            for (size_t z = r.min[2]; z <= r.max[2]; ++z)
+                for (size_t y = r.min[1]; y <= r.max[1]; ++y)
+                    for (size_t x = r.min[0]; x <= r.max[0]; ++x)
+                        mCellLights[fill[(z * RESOLUTION + y) * RESOLUTION + x]++] = i;
+        }
+    }
+    //-----------------------------------------------------------------------
+    void LightGrid::clear()
+    {
+        mNumLights = 0;
+        mBounds.setNull();
+        mInvCellSize = Vector3::ZERO;
+        mGlobalLights.clear();
+        mCellStart.clear();
+        mCellLights.clear();
+        mLightStamp.clear();
+        mStamp = 0;
+    }
+    //-----------------------------------------------------------------------
+    auto LightGrid::getCellRange(const AxisAlignedBox& box, CellRange& range) const -> bool
+    {
+        if (!box.isFinite() || !mBounds.isFinite() || !mBounds.intersects(box))
+            return false;
+
+        for (size_t i = 0; i < 3; ++i)
+        {
+            auto cell = [&](Real v)
+            {
+                Real c = (v - mBounds.getMinimum()[i]) * mInvCellSize[i];
+                return std::min<size_t>(static_cast<size_t>(std::max<Real>(c, 0)), RESOLUTION - 1);
+            };
+            range.min[i] = cell(box.getMinimum()[i]);
+            range.max[i] = cell(box.getMaximum()[i]);
+        }
+        return true;
+    }
+    //-----------------------------------------------------------------------
+    auto LightGrid::findCandidates(const Sphere& sphere, std::vector<uint32>& result) const -> bool
+    {
+        result.clear();
+
+        CellRange r;
+        bool inGrid = getCellRange(rangeBox(sphere.getCenter(), sphere.getRadius()), r);
+        if (inGrid && r.getNumCells() > mNumLights)
+            return false;
+
+        result = mGlobalLights;
+        if (inGrid)
+        {
+            // a light spanning several of the cells is only reported once
+            if (++mStamp == 0)
+            {
+                std::ranges::fill(mLightStamp, 0);
+                mStamp = 1;
+            }
+            for (size_t z = r.min[2]; z <= r.max[2]; ++z)
+                for (size_t y = r.min[1]; y <= r.max[1]; ++y)
+                    for (size_t x = r.min[0]; x <= r.max[0]; ++x)
+                    {
+                        size_t cell = (z * RESOLUTION + y) * RESOLUTION + x;
+                        for (uint32 e = mCellStart[cell]; e < mCellStart[cell + 1]; ++e)
+                        {
+                            uint32 light = mCellLights[e];
+                            if (mLightStamp[light] != mStamp)
+                            {
+                                mLightStamp[light] = mStamp;
+                                result.push_back(light);
+                            }
+                        }
+                    }
+        }
+        std::ranges::sort(result);
+        return true;
+    }
+}
@@ -37,9 +37,13 @@ import :Prerequisites;
 import :StringConverter;
 
 import <algorithm>;
+import <atomic>;
+import <format>;
 import <iomanip>;
 import <iostream>;
+import <memory>;
 import <string>;
+import <thread>;
 import <vector>;
 
 // LogMessageLevel + LoggingLevel > OGRE_LOG_THRESHOLD = message logged
@@ -55,6 +59,169 @@ namespace {
 
 namespace Ogre
 {
+    /** Multiple producer single consumer queue of messages and the thread writing them.
+
+        The queue is an intrusive linked list, producers exchange the head and link the
+        previous one to their message, the writer follows the links from the tail. So
+        logging never takes a lock, but a message is only visible to the writer once
+        its producer linked it.
+    */
+    struct Log::AsyncWriter
+    {
+        struct Message
+        {
+            std::atomic<Message*> next{nullptr};
+            String text;
+            LogMessageLevel lml{LogMessageLevel::Normal};
+            bool maskDebug{false};
+            int64 time{0};
+            /// the last message, tells the writer to exit
+            bool stop{false};
+        };
+
+        Log* mLog;
+        // the stub keeps the list non empty, so producers never touch the tail
+        Message mStub;
+        std::atomic<Message*> mHead{&mStub};
+        Message* mTail{&mStub};
+
+        /// number of messages pushed and written so far, the writer waits on the former
+        std::atomic<uint64> mQueued{0};
+        std::atomic<uint64> mWritten{0};
+
+        // the previous message and how often it was repeated since it was written
+        String mLast;
+        LogMessageLevel mLastLevel{LogMessageLevel::Normal};
+        bool mLastMaskDebug{false};
+        size_t mRepeats{0};
+
+        std::thread mThread;
+
+        explicit AsyncWriter(Log* log) : mLog(log), mThread([this] { run(); }) {}
+
+        ~AsyncWriter()
+        {
+            auto stop = new Message;
+            stop->stop = true;
+            push(stop);
+            mThread.join();
+        }
+
+        void link(Message* message)
+        {
+            Message* prev = mHead.exchange(message, std::memory_order_acq_rel);
+            prev->next.store(message, std::memory_order_release);
+        }
+
+        void push(Message* message)
+        {
+            link(message);
+            mQueued.fetch_add(1, std::memory_order_release);
+            mQueued.notify_one();
+        }
+
+        /// the oldest linked message, nullptr if there is none
+        auto pop() -> Message*
+        {
+            Message* tail = mTail;
+            Message* next = tail->next.load(std::memory_order_acquire);
+            if (tail == &mStub)
+            {
+                if (!next)
+                    return nullptr;
+                mTail = tail = next;
+                next = next->next.load(std::memory_order_acquire);
+            }
+
+            if (next)
+            {
+                mTail = next;
+                return tail;
+            }
+
+            // tail is the last message, unless another one is being linked
+            if (tail != mHead.load(std::memory_order_acquire))
+                return nullptr;
+
+            // put the stub behind it, so tail can be handed out
+            mStub.next.store(nullptr, std::memory_order_relaxed);
+            link(&mStub);
+
+            next = tail->next.load(std::memory_order_acquire);
+            if (!next)
+                return nullptr;
+            mTail = next;
+            return tail;
+        }
+
+        void writeRepeats()
+        {
+            if (mRepeats == 0)
+                return;
+            mLog->write(std::format("Last message repeated {} times", mRepeats), mLastLevel, mLastMaskDebug,
+                        int64(time(nullptr)));
+            mRepeats = 0;
+        }
+
+        void write(const Message& message)
+        {
+            if (message.text == mLast && message.lml == mLastLevel)
+            {
+                ++mRepeats;
+                return;
+            }
+
+            writeRepeats();
+            mLog->write(message.text, message.lml, message.maskDebug, message.time);
+            mLast = message.text;
+            mLastLevel = message.lml;
+            mLastMaskDebug = message.maskDebug;
+        }
+
+        void run()
+        {
+            uint64 written = 0;
+            for (bool stop = false; !stop;)
+            {
+                uint64 queued = mQueued.load(std::memory_order_acquire);
+
+                // a message may be counted before it is linked, so wait for all of them
+                while (written < queued)
+                {
+                    Message* message = pop();
+                    if (!message)
+                    {
+                        std::this_thread::yield();
+                        continue;
+                    }
+
+                    stop = stop || message->stop;
+                    if (!message->stop)
+                        write(*message);
+                    delete message;
+                    ++written;
+                }
+
+                // one flush per batch
+                writeRepeats();
+                if (!mLog->mSuppressFile)
+                    mLog->mLog.flush();
+
+                mWritten.store(written, std::memory_order_release);
+                mWritten.notify_all();
+
+                if (!stop)
+                    mQueued.wait(queued, std::memory_order_acquire);
+            }
+        }
+
+        void flush()
+        {
+            uint64 queued = mQueued.load(std::memory_order_acquire);
+            for (uint64 written; (written = mWritten.load(std::memory_order_acquire)) < queued;)
+                mWritten.wait(written, std::memory_order_acquire);
+        }
+    };
     //-----------------------------------------------------------------------
     Log::Log( std::string_view name, bool debuggerOutput, bool suppressFile ) : 
          mDebugOut(debuggerOutput),
@@ -79,6 +246,9 @@ namespace Ogre
     //-----------------------------------------------------------------------
     Log::~Log()
     {
+        // write the queued messages
+        mAsync.reset();
+
         if (!mSuppressFile)
         {
             mLog.close();
@@ -88,55 +258,88 @@ namespace Ogre
     //-----------------------------------------------------------------------
     void Log::logMessage( std::string_view message, LogMessageLevel lml, bool maskDebug )
     {
-        if (lml >= mLogLevel)
+        if (lml < mLogLevel)
+            return;
+
+        bool skipThisMessage = false;
+        for(auto & mListener : mListeners)
+            mListener->messageLogged( message, lml, maskDebug, mLogName, skipThisMessage);
+
+        if (skipThisMessage)
+            return;
+
+        if (mAsync)
         {
-            bool skipThisMessage = false;
-            for(auto & mListener : mListeners)
-                mListener->messageLogged( message, lml, maskDebug, mLogName, skipThisMessage);
-            
-            if (!skipThisMessage)
-            {
-                if (mDebugOut && !maskDebug)
-                {
-                    std::ostream& os = int(lml) >= int(LogMessageLevel::Warning) ? std::cerr : std::cout;
+            auto queued = new AsyncWriter::Message;
+            queued->text = message;
+            queued->lml = lml;
+            queued->maskDebug = maskDebug;
+            queued->time = int64(time(nullptr));
+            mAsync->push(queued);
+            return;
+        }
 
-                    if(mTermHasColours) {
-                        if(lml == LogMessageLevel::Warning)
-                            os << YELLOW;
-                        if(lml == LogMessageLevel::Critical)
-                            os << RED;
-                    }
+        write(message, lml, maskDebug, int64(time(nullptr)));
 
-                    os << message;
+        // Flush stream to ensure it is written (incase of a crash, we need log to be up to date)
+        if (!mSuppressFile)
+            mLog.flush();
+    }
+    //-----------------------------------------------------------------------
+    void Log::write(std::string_view message, LogMessageLevel lml, bool maskDebug, int64 timestamp)
+    {
+        if (mDebugOut && !maskDebug)
+        {
+            std::ostream& os = int(lml) >= int(LogMessageLevel::Warning) ? std::cerr : std::cout;
 
-                    if(mTermHasColours) {
-                        os << RESET;
-                    }
+            if(mTermHasColours) {
+                if(lml == LogMessageLevel::Warning)
+                    os << YELLOW;
+                if(lml == LogMessageLevel::Critical)
+                    os << RED;
+            }
 
-                    os << std::endl;
-                }
+            os << message;
 
-                // Write time into log
-                if (!mSuppressFile)
-                {
-                    if (mTimeStamp)
-                    {
-                        struct tm *pTime;
-                        time_t ctTime; time(&ctTime);
-                        pTime = localtime( &ctTime );
-                        mLog << std::setw(2) << std::setfill('0') << pTime->tm_hour
-                            << ":" << std::setw(2) << std::setfill('0') << pTime->tm_min
-                            << ":" << std::setw(2) << std::setfill('0') << pTime->tm_sec
-                            << ": ";
-                    }
-                    mLog << message << std::endl;
+            if(mTermHasColours) {
+                os << RESET;
+            }
 
-                    // Flush stcmdream to ensure it is written (incase of a crash, we need log to be up to date)
-                    mLog.flush();
-                }
+            os << std::endl;
+        }
+
+        // Write time into log
+        if (!mSuppressFile)
+        {
+            if (mTimeStamp)
+            {
+                auto ctTime = time_t(timestamp);
+                struct tm *pTime = localtime( &ctTime );
+                mLog << std::setw(2) << std::setfill('0') << pTime->tm_hour
+                    << ":" << std::setw(2) << std::setfill('0') << pTime->tm_min
+                    << ":" << std::setw(2) << std::setfill('0') << pTime->tm_sec
+                    << ": ";
             }
+            mLog << message << '\n';
         }
     }
+    //-----------------------------------------------------------------------
+    void Log::setAsync(bool async)
+    {
+        if (async == isAsync())
+            return;
+
+        if (async)
+            mAsync = ::std::make_unique<AsyncWriter>(this);
+        else
+            mAsync.reset();
+    }
+    //-----------------------------------------------------------------------
+    void Log::flush()
+    {
+        if (mAsync)
+            mAsync->flush();
+    }
     
     //-----------------------------------------------------------------------
     void Log::setTimeStampEnabled(bool timeStamp)
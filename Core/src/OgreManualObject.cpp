@@ -94,6 +94,7 @@ ManualObject::ManualObject(std::string_view name)
     //-----------------------------------------------------------------------------
     void ManualObject::clear()
     {
+        mStreamLock.unlock();
         resetTempAreas();
         for (auto & i : mSectionList)
         {
@@ -105,6 +106,7 @@ ManualObject::ManualObject(std::string_view name)
         delete mEdgeList;
         mEdgeList = nullptr;
         mAnyIndexed = false;
+        invalidateShadowVolumeCache();
 
         clearShadowRenderableList(mShadowRenderables);
     }
@@ -297,10 +299,16 @@ ManualObject::ManualObject(std::string_view name)
                 oldDcl->getAutoOrganisedDeclaration(false, false, false);
             HardwareBufferManager::getSingleton().destroyVertexDeclaration(oldDcl);
         }
-        resizeTempVertexBufferIfNeeded(++rop->vertexData->vertexCount);
+        char* pBase;
+        if (mStreaming)
+            pBase = getStreamedVertex(rop->vertexData->vertexCount++);
+        else
+        {
+            resizeTempVertexBufferIfNeeded(++rop->vertexData->vertexCount);
 
-        // get base pointer
-        char* pBase = mTempVertexBuffer + (mDeclSize * (rop->vertexData->vertexCount-1));
+            // get base pointer
+            pBase = mTempVertexBuffer + (mDeclSize * (rop->vertexData->vertexCount-1));
+        }
         const VertexDeclaration::VertexElementList& elemList =
             rop->vertexData->vertexDeclaration->getElements();
         for (const auto & elem : elemList)
@@ -362,6 +370,42 @@ ManualObject::ManualObject(std::string_view name)
 
     }
     //-----------------------------------------------------------------------------
+    auto ManualObject::getStreamedVertex(size_t index) -> char*
+    {
+        VertexBufferBinding* binding = mCurrentSection->getRenderOperation()->vertexData->vertexBufferBinding;
+        if (!mStreamLock.pBuf)
+        {
+            // first vertex, make sure the buffer holds the estimate
+            HardwareVertexBufferSharedPtr vbuf;
+            if (binding->isBufferBound(0))
+                vbuf = binding->getBuffer(0);
+            if (!vbuf || vbuf->getNumVertices() < mEstVertexCount)
+            {
+                vbuf = HardwareBufferManager::getSingleton().createVertexBuffer(
+                    mDeclSize, std::max<size_t>(mEstVertexCount, TEMP_INITIAL_SIZE), mBufferUsage);
+                binding->setBinding(0, vbuf);
+            }
+            mStreamLock.lock(vbuf.get(), HardwareBuffer::LockOptions::DISCARD);
+            mStreamStart = 0;
+        }
+
+        HardwareVertexBufferSharedPtr vbuf = binding->getBuffer(0);
+        if (index >= vbuf->getNumVertices())
+        {
+            // out of room, carry on in a buffer twice as large
+            size_t written = vbuf->getNumVertices();
+            mStreamLock.unlock();
+            HardwareVertexBufferSharedPtr newBuf =
+                HardwareBufferManager::getSingleton().createVertexBuffer(mDeclSize, written * 2, mBufferUsage);
+            newBuf->copyData(*vbuf, 0, 0, written * mDeclSize, true);
+            binding->setBinding(0, newBuf);
+            mStreamLock.lock(newBuf.get(), written * mDeclSize, written * mDeclSize,
+                             HardwareBuffer::LockOptions::NO_OVERWRITE);
+            mStreamStart = written;
+        }
+        return static_cast<char*>(mStreamLock.pData) + (index - mStreamStart) * mDeclSize;
+    }
+    //-----------------------------------------------------------------------------
     auto ManualObject::end() -> ManualObject::ManualObjectSection*
     {
         OgreAssert(mCurrentSection, "You cannot call end() until after you call begin()");
@@ -370,6 +414,9 @@ ManualObject::ManualObject(std::string_view name)
             // bake current vertex
             copyTempVertexToBuffer();
         }
+        // streamed vertices are in their buffer already
+        bool streamed = mStreamLock.pBuf != nullptr;
+        mStreamLock.unlock();
 
         // pointer that will be returned
         ManualObjectSection* result = nullptr;
@@ -403,7 +450,7 @@ ManualObject::ManualObject(std::string_view name)
             // Bake the real buffers
             HardwareVertexBufferSharedPtr vbuf;
             // Check buffer sizes
-            bool vbufNeedsCreating = true;
+            bool vbufNeedsCreating = !streamed;
             bool ibufNeedsCreating = rop->useIndexes;
             // Work out if we require 16 or 32-bit index buffers
             HardwareIndexBuffer::IndexType indexType = mCurrentSection->get32BitIndices()?  
@@ -442,9 +489,10 @@ ManualObject::ManualObject(std::string_view name)
                     indexType, indexCount, mBufferUsage);
             }
             // Write vertex data
-            vbuf->writeData(
-                0, rop->vertexData->vertexCount * vbuf->getVertexSize(), 
-                mTempVertexBuffer, true);
+            if (!streamed)
+                vbuf->writeData(
+                    0, rop->vertexData->vertexCount * vbuf->getVertexSize(), 
+                    mTempVertexBuffer, true);
             // Write index data
             if(rop->useIndexes)
             {
@@ -475,7 +523,9 @@ ManualObject::ManualObject(std::string_view name)
         } // empty section check
 
         mCurrentSection = nullptr;
-        resetTempAreas();
+        // streaming keeps them for the next update
+        if (!mStreaming)
+            resetTempAreas();
 
         // Tell parent if present
         if (mParentNode)
@@ -670,11 +720,8 @@ ManualObject::ManualObject(std::string_view name)
             ++egi;
             ++seci;
         }
-        // Calc triangle light facing
-        updateEdgeListLightFacing(edgeList, lightPos);
-
-        // Generate indexes and update renderables
-        generateShadowVolume(edgeList, indexBuffer, indexBufferUsedSize, light, mShadowRenderables, flags);
+        // Calc triangle light facing and generate indexes, unless cached, and update renderables
+        updateShadowVolume(edgeList, lightPos, indexBuffer, indexBufferUsedSize, light, mShadowRenderables, flags, false);
 
         return mShadowRenderables;
     }
@@ -757,6 +804,11 @@ ManualObject::ManualObject(std::string_view name)
         xform[0] = mParent->_getParentNodeFullTransform();
     }
     //-----------------------------------------------------------------------------
+    auto ManualObject::ManualObjectSection::getWorldTransformNode() const noexcept -> const Node*
+    {
+        return mParent->getParentNode();
+    }
+    //-----------------------------------------------------------------------------
     auto ManualObject::ManualObjectSection::getSquaredViewDepth(const Ogre::Camera *cam) const -> Real
     {
         Node* n = mParent->getParentNode();
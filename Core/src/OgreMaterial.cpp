@@ -88,6 +88,11 @@ namespace Ogre {
     }
     //-----------------------------------------------------------------------
     auto Material::operator=(const Material& rhs) -> Material&
+    {
+        return _assign(rhs, false);
+    }
+    //-----------------------------------------------------------------------
+    auto Material::_assign(const Material& rhs, bool shareParameters) -> Material&
     {
         Resource::operator=(rhs);
         mReceiveShadows = rhs.mReceiveShadows;
@@ -98,7 +103,7 @@ namespace Ogre {
         for (auto mTechnique : rhs.mTechniques)
         {
             Technique* t = this->createTechnique();
-            *t = *mTechnique;
+            t->_assign(*mTechnique, shareParameters);
             if (mTechnique->isSupported())
             {
                 insertSupportedTechnique(t);
@@ -176,7 +181,7 @@ namespace Ogre {
         return memSize;
     }
     //-----------------------------------------------------------------------
-    auto Material::clone(std::string_view newName, std::string_view newGroup) const -> MaterialPtr
+    auto Material::clone(std::string_view newName, std::string_view newGroup, bool shareParameters) const -> MaterialPtr
     {
         MaterialPtr newMat =
             MaterialManager::getSingleton().create(newName, newGroup.empty() ? std::string_view{mGroup} : newGroup);
@@ -187,7 +192,7 @@ namespace Ogre {
         // Keep handle (see below, copy overrides everything)
         ResourceHandle newHandle = newMat->getHandle();
         // Assign values from this
-        *newMat = *this;
+        newMat->_assign(*this, shareParameters);
         // Restore new group if required, will have been overridden by operator
         if (!newGroup.empty())
         {
@@ -40,12 +40,14 @@ import :Pass;
 import :Prerequisites;
 import :Resource;
 import :ResourceGroupManager;
+import :ScriptCompiler;
 import :SharedPtr;
 import :Singleton;
 import :Technique;
 import :TextureManager;
 import :TextureUnitState;
 
+import <algorithm>;
 import <list>;
 import <map>;
 import <memory>;
@@ -115,6 +117,59 @@ namespace Ogre {
         return static_pointer_cast<Material>(getResourceByName(name, groupName));
     }
 
+    auto MaterialManager::getResourceByName(std::string_view name, std::string_view groupName) const -> ResourcePtr
+    {
+        if(ResourcePtr res = ResourceManager::getResourceByName(name, groupName))
+            return res;
+
+        auto& rgm = ResourceGroupManager::getSingleton();
+        bool isGlobal = rgm.isResourceGroupInGlobalPool(groupName);
+        auto [first, last] = mDeferredMaterials.equal_range(name);
+        auto it = std::ranges::find_if(first, last, [&](const auto& entry)
+        {
+            std::string_view group = entry.second.first;
+            return groupName == ResourceGroupManager::AUTODETECT_RESOURCE_GROUP_NAME || group == groupName ||
+                   (isGlobal && rgm.isResourceGroupInGlobalPool(group));
+        });
+        if(it == last)
+            return {};
+
+        // erase first, so a script that refers to itself does not recurse
+        auto [group, node] = std::move(it->second);
+        mDeferredMaterials.erase(it);
+        ScriptCompilerManager::getSingleton()._translateDeferred(node, group);
+
+        return ResourceManager::getResourceByName(name, group);
+    }
+    //-----------------------------------------------------------------------
+    void MaterialManager::removeAll()
+    {
+        mDeferredMaterials.clear();
+        ResourceManager::removeAll();
+    }
+    //-----------------------------------------------------------------------
+    void MaterialManager::_deferMaterial(std::string_view name, std::string_view group, const AbstractNodePtr& node)
+    {
+        if(ResourceManager::getResourceByName(name, group))
+        {
+            // translate right away, so the duplicate is reported like without lazy loading
+            ScriptCompilerManager::getSingleton()._translateDeferred(node, group);
+            return;
+        }
+
+        auto [first, last] = mDeferredMaterials.equal_range(name);
+        auto it = std::ranges::find_if(first, last, [&](const auto& entry) { return entry.second.first == group; });
+        if(it != last)
+            it->second.second = node;
+        else
+            mDeferredMaterials.emplace(name, std::pair{String{group}, node});
+    }
+    //-----------------------------------------------------------------------
+    void MaterialManager::_dropDeferredMaterials(std::string_view group)
+    {
+        std::erase_if(mDeferredMaterials, [&](const auto& entry) { return entry.second.first == group; });
+    }
+    //-----------------------------------------------------------------------
     auto MaterialManager::getDefaultMaterial(bool useLighting) -> MaterialPtr {
         MaterialPtr ret = getByName(useLighting ? "BaseWhite" : "BaseWhiteNoLighting",
                                     ResourceGroupManager::INTERNAL_RESOURCE_GROUP_NAME);
@@ -1825,6 +1825,8 @@ namespace Ogre
                             paramstr.clear();
                         if ((name == "includes_pose_animation") && (paramstr == "0"))
                             paramstr.clear();
+                        if ((name == "includes_pose_texture_animation") && (paramstr == "false"))
+                            paramstr.clear();
                         if ((name == "uses_vertex_texture_fetch") && (paramstr == "false"))
                             paramstr.clear();
 
@@ -37,6 +37,7 @@ import :Frustum;
 import :Math;
 import :Matrix3;
 import :Matrix4;
+import :OptimisedUtil;
 import :Plane;
 import :Prerequisites;
 import :Quaternion;
@@ -634,6 +635,18 @@ namespace Ogre
         return {true, t};
     }
     //-----------------------------------------------------------------------
+    void Math::intersects(const Ray& ray, const BoxArrays& boxes, size_t numBoxes, Real* distances)
+    {
+        OptimisedUtil::getImplementation()->intersectRayBoxes(ray, boxes, distances, numBoxes);
+    }
+    //-----------------------------------------------------------------------
+    void Math::intersects(const Ray& ray, const TriangleArrays& triangles, size_t numTriangles, Real* distances,
+                          bool positiveSide, bool negativeSide)
+    {
+        OptimisedUtil::getImplementation()->intersectRayTriangles(
+            ray, triangles, distances, numTriangles, positiveSide, negativeSide);
+    }
+    //-----------------------------------------------------------------------
     auto Math::intersects(const Sphere& sphere, const AxisAlignedBox& box) -> bool
     {
         if (box.isNull()) return false;
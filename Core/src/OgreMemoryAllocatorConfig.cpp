@@ -0,0 +1,150 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+module;
+
+#include <cstddef>
+
+module Ogre.Core;
+
+import :Exception;
+import :MemoryAllocatorConfig;
+import :Platform;
+
+import <array>;
+import <atomic>;
+import <new>;
+import <string_view>;
+import <utility>;
+
+namespace Ogre {
+
+namespace {
+    /// on their own cache line, as the categories are updated by different threads
+    struct alignas(64) CategoryCounters
+    {
+        std::atomic<size_t> live{0};
+        std::atomic<size_t> peak{0};
+        std::atomic<uint64> allocations{0};
+        std::atomic<uint64> allocatedBytes{0};
+        std::atomic<CategoryAllocator*> allocator{nullptr};
+    };
+
+    // constant initialised, objects may be allocated during static initialisation
+    constinit std::array<CategoryCounters, std::to_underlying(MemoryCategory::COUNT)> counters;
+
+    void recordAllocation(size_t size, MemoryCategory category)
+    {
+        auto& c = counters[std::to_underlying(category)];
+        size_t live = c.live.fetch_add(size, std::memory_order_relaxed) + size;
+        size_t peak = c.peak.load(std::memory_order_relaxed);
+        while (live > peak && !c.peak.compare_exchange_weak(peak, live, std::memory_order_relaxed))
+            ;
+        c.allocations.fetch_add(1, std::memory_order_relaxed);
+        c.allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    }
+
+    void recordDeallocation(size_t size, MemoryCategory category)
+    {
+        counters[std::to_underlying(category)].live.fetch_sub(size, std::memory_order_relaxed);
+    }
+}
+    //---------------------------------------------------------------------
+    auto MemoryTracker::allocate(size_t size, MemoryCategory category) -> void*
+    {
+        CategoryAllocator* allocator = counters[std::to_underlying(category)].allocator.load(std::memory_order_relaxed);
+        void* ptr = allocator ? allocator->allocate(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__) : ::operator new(size);
+        recordAllocation(size, category);
+        return ptr;
+    }
+    //---------------------------------------------------------------------
+    auto MemoryTracker::allocate(size_t size, std::align_val_t alignment, MemoryCategory category) -> void*
+    {
+        CategoryAllocator* allocator = counters[std::to_underlying(category)].allocator.load(std::memory_order_relaxed);
+        void* ptr = allocator ? allocator->allocate(size, size_t(alignment)) : ::operator new(size, alignment);
+        recordAllocation(size, category);
+        return ptr;
+    }
+    //---------------------------------------------------------------------
+    void MemoryTracker::deallocate(void* ptr, size_t size, MemoryCategory category) noexcept
+    {
+        if (!ptr)
+            return;
+        recordDeallocation(size, category);
+        CategoryAllocator* allocator = counters[std::to_underlying(category)].allocator.load(std::memory_order_relaxed);
+        if (allocator)
+            allocator->deallocate(ptr, size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+        else
+            ::operator delete(ptr, size);
+    }
+    //---------------------------------------------------------------------
+    void MemoryTracker::deallocate(void* ptr, size_t size, std::align_val_t alignment, MemoryCategory category) noexcept
+    {
+        if (!ptr)
+            return;
+        recordDeallocation(size, category);
+        CategoryAllocator* allocator = counters[std::to_underlying(category)].allocator.load(std::memory_order_relaxed);
+        if (allocator)
+            allocator->deallocate(ptr, size, size_t(alignment));
+        else
+            ::operator delete(ptr, size, alignment);
+    }
+    //---------------------------------------------------------------------
+    auto MemoryTracker::getStats(MemoryCategory category) -> Stats
+    {
+        const auto& c = counters[std::to_underlying(category)];
+        return {c.live.load(std::memory_order_relaxed), c.peak.load(std::memory_order_relaxed),
+                c.allocations.load(std::memory_order_relaxed), c.allocatedBytes.load(std::memory_order_relaxed)};
+    }
+    //---------------------------------------------------------------------
+    void MemoryTracker::resetPeaks()
+    {
+        for (auto& c : counters)
+            c.peak.store(c.live.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+    //---------------------------------------------------------------------
+    auto MemoryTracker::getCategoryName(MemoryCategory category) -> std::string_view
+    {
+        static constexpr std::array<std::string_view, std::to_underlying(MemoryCategory::COUNT)> names{
+            "General", "Geometry", "Animation", "SceneControl", "SceneObjects", "Resource", "Scripting",
+            "RenderSystem"};
+        return names[std::to_underlying(category)];
+    }
+    //---------------------------------------------------------------------
+    void MemoryTracker::setAllocator(MemoryCategory category, CategoryAllocator* allocator)
+    {
+        auto& c = counters[std::to_underlying(category)];
+        OgreAssert(c.live.load(std::memory_order_relaxed) == 0,
+                   "the category must not have live allocations when changing its allocator");
+        c.allocator.store(allocator, std::memory_order_relaxed);
+    }
+    //---------------------------------------------------------------------
+    auto MemoryTracker::getAllocator(MemoryCategory category) -> CategoryAllocator*
+    {
+        return counters[std::to_underlying(category)].allocator.load(std::memory_order_relaxed);
+    }
+}
@@ -48,6 +48,7 @@ import :HardwareBuffer;
 import :HardwareBufferManager;
 import :HardwareIndexBuffer;
 import :HardwareVertexBuffer;
+import :Image;
 import :LodStrategy;
 import :LodStrategyManager;
 import :Log;
@@ -55,8 +56,14 @@ import :LogManager;
 import :Math;
 import :Matrix4;
 import :Mesh;
+import :MeshLayoutOptimiser;
+import :MeshLodGenerator;
+import :MeshOptimiser;
+import :MeshQuantiser;
 import :MeshManager;
+import :MeshTriangleBVH;
 import :OptimisedUtil;
+import :PixelFormat;
 import :Platform;
 import :Pose;
 import :Prerequisites;
@@ -64,16 +71,21 @@ import :RenderOperation;
 import :Resource;
 import :ResourceGroupManager;
 import :ResourceManager;
+import :Root;
 import :SharedPtr;
 import :Skeleton;
 import :SkeletonManager;
+import :StartupProfiler;
 import :String;
 import :StringConverter;
 import :SubMesh;
 import :TangentSpaceCalc;
+import :Texture;
+import :TextureManager;
 import :Vector;
 import :VertexBoneAssignment;
 import :VertexIndexData;
+import :WorkQueue;
 
 import <algorithm>;
 import <format>;
@@ -91,6 +103,35 @@ import <utility>;
 import <vector>;
 
 namespace Ogre {
+namespace {
+    /// Vertices per task of the software animation routines
+    constexpr size_t SOFTWARE_ANIMATION_BLOCK_SIZE = 2048;
+
+    /** Calls func(begin, count) for consecutive vertex ranges covering numVertices.
+    @remarks
+        The ranges are spread over the WorkQueue when there is more than one. Only
+        the raw blending is run like this, the buffers are locked by the caller, so
+        no buffer is ever touched from more than one thread.
+    */
+    template<typename Func>
+    void forEachVertexRange(size_t numVertices, const Func& func)
+    {
+        size_t numBlocks = (numVertices + SOFTWARE_ANIMATION_BLOCK_SIZE - 1) / SOFTWARE_ANIMATION_BLOCK_SIZE;
+        Root* root = Root::getSingletonPtr();
+        if (numBlocks > 1 && root && root->getWorkQueue())
+        {
+            root->getWorkQueue()->parallelFor(numBlocks, [&](size_t block)
+            {
+                size_t begin = block * SOFTWARE_ANIMATION_BLOCK_SIZE;
+                func(begin, std::min(SOFTWARE_ANIMATION_BLOCK_SIZE, numVertices - begin));
+            });
+        }
+        else
+        {
+            func(0, numVertices);
+        }
+    }
+}
     //-----------------------------------------------------------------------
     Mesh::Mesh(ResourceManager* creator, std::string_view name, ResourceHandle handle,
         std::string_view group, bool isManual, ManualResourceLoader* loader)
@@ -205,6 +246,18 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     void Mesh::postLoadImpl()
     {
+        // Generate LOD levels if the file had none, optimise, quantise and reorganise, before edge lists get built
+        MeshManager& meshManager = MeshManager::getSingleton();
+        const auto& autoLodLevels = meshManager.getAutoLodLevels();
+        if (!mIsManual && mNumLods == 1 && !autoLodLevels.empty())
+            MeshLodGenerator::generateLodLevels(this, autoLodLevels);
+        if (!mIsManual && meshManager.getOptimiseMeshesOnLoad())
+            MeshOptimiser::optimise(this, meshManager.getOptimiseOptions());
+        if (!mIsManual && meshManager.getQuantiseMeshesOnLoad())
+            MeshQuantiser::quantise(this, meshManager.getQuantiseOptions());
+        if (!mIsManual && meshManager.getOptimiseVertexLayoutsOnLoad())
+            MeshLayoutOptimiser::optimise(this, meshManager.getVertexLayoutOptions());
+
         // Prepare for shadow volumes?
         if (MeshManager::getSingleton().getPrepareAllMeshesForShadowVolumes())
         {
@@ -231,6 +284,7 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     void Mesh::prepareImpl()
     {
+        StartupProfiler::Scope phase{StartupProfiler::PhaseType::MESH_LOAD, mName};
         // Load from specified 'name'
         if (getCreator()->getVerbose())
             LogManager::getSingleton().logMessage(::std::format("Mesh: Loading {}.", mName));
@@ -239,8 +293,9 @@ namespace Ogre {
             ResourceGroupManager::getSingleton().openResource(
                 mName, mGroup, this);
  
-        // fully prebuffer into host RAM
-        mFreshFromDisk = DataStreamPtr(new MemoryDataStream(mName,mFreshFromDisk));
+        // fully prebuffer into host RAM, unless it is there already (e.g. memory mapped)
+        if (!dynamic_cast<MemoryDataStream*>(mFreshFromDisk.get()))
+            mFreshFromDisk = DataStreamPtr(new MemoryDataStream(mName,mFreshFromDisk));
     }
     //-----------------------------------------------------------------------
     void Mesh::unprepareImpl()
@@ -249,6 +304,7 @@ namespace Ogre {
     }
     void Mesh::loadImpl()
     {
+        StartupProfiler::Scope phase{StartupProfiler::PhaseType::MESH_LOAD, mName};
         // If the only copy is local on the stack, it will be cleaned
         // up reliably in case of exceptions, etc
         DataStreamPtr data(mFreshFromDisk);
@@ -287,6 +343,7 @@ namespace Ogre {
         mSubMeshNameMap.clear();
 
         freeEdgeList();
+        freeTriangleBVH();
 
         // Removes all LOD data
         removeLodLevels();
@@ -1806,6 +1863,19 @@ namespace Ogre {
         return getLodLevel(lodIndex).edgeData;
     }
     //---------------------------------------------------------------------
+    auto Mesh::getTriangleBVH() -> const MeshTriangleBVH&
+    {
+        // Build on demand
+        if (!mTriangleBVH)
+            mTriangleBVH = std::make_unique<MeshTriangleBVH>(*this);
+        return *mTriangleBVH;
+    }
+    //---------------------------------------------------------------------
+    void Mesh::freeTriangleBVH()
+    {
+        mTriangleBVH.reset();
+    }
+    //---------------------------------------------------------------------
     void Mesh::prepareMatricesForVertexBlend(const Affine3** blendMatrices,
         const Affine3* boneMatrices, const IndexMap& indexMap)
     {
@@ -1930,16 +2000,21 @@ namespace Ogre {
             destElemNorm->baseVertexPointerToElement(destNormBuf != destPosBuf ? destNormLock.pData : destPosLock.pData, &pDestNorm);
         }
 
-        OptimisedUtil::getImplementation()->softwareVertexSkinning(
-            pSrcPos, pDestPos,
-            pSrcNorm, pDestNorm,
-            pBlendWeight, pBlendIdx,
-            blendMatrices,
-            srcPosStride, destPosStride,
-            srcNormStride, destNormStride,
-            blendWeightStride, blendIdxStride,
-            numWeightsPerVertex,
-            targetVertexData->vertexCount);
+        forEachVertexRange(targetVertexData->vertexCount, [&](size_t begin, size_t count)
+        {
+            OptimisedUtil::getImplementation()->softwareVertexSkinning(
+                rawOffsetPointer(pSrcPos, begin * srcPosStride), rawOffsetPointer(pDestPos, begin * destPosStride),
+                includeNormals ? rawOffsetPointer(pSrcNorm, begin * srcNormStride) : nullptr,
+                includeNormals ? rawOffsetPointer(pDestNorm, begin * destNormStride) : nullptr,
+                rawOffsetPointer(pBlendWeight, begin * blendWeightStride),
+                rawOffsetPointer(pBlendIdx, begin * blendIdxStride),
+                blendMatrices,
+                srcPosStride, destPosStride,
+                srcNormStride, destNormStride,
+                blendWeightStride, blendIdxStride,
+                numWeightsPerVertex,
+                count);
+        });
     }
     //---------------------------------------------------------------------
     void Mesh::softwareVertexMorph(Real t,
@@ -1984,11 +2059,18 @@ namespace Ogre {
         HardwareBufferLockGuard destLock(destBuf, HardwareBuffer::LockOptions::DISCARD);
         auto* pdst = static_cast<float*>(destLock.pData);
 
-        OptimisedUtil::getImplementation()->softwareVertexMorph(
-            t, pb1, pb2, pdst,
-            b1->getVertexSize(), b2->getVertexSize(), destBuf->getVertexSize(),
-            targetVertexData->vertexCount,
-            morphNormals);
+        size_t b1VertexSize = b1->getVertexSize(), b2VertexSize = b2->getVertexSize();
+        size_t dstVertexSize = destBuf->getVertexSize();
+        forEachVertexRange(targetVertexData->vertexCount, [&](size_t begin, size_t count)
+        {
+            OptimisedUtil::getImplementation()->softwareVertexMorph(
+                t,
+                rawOffsetPointer(pb1, begin * b1VertexSize), rawOffsetPointer(pb2, begin * b2VertexSize),
+                rawOffsetPointer(pdst, begin * dstVertexSize),
+                b1VertexSize, b2VertexSize, dstVertexSize,
+                count,
+                morphNormals);
+        });
     }
     //---------------------------------------------------------------------
     void Mesh::softwareVertexPoseBlend(Real weight,
@@ -2327,6 +2409,7 @@ namespace Ogre {
         std::advance(i, index);
         delete *i;
         mPoseList.erase(i);
+        releasePoseTextures();
 
     }
     //---------------------------------------------------------------------
@@ -2338,6 +2421,7 @@ namespace Ogre {
             {
                 delete *i;
                 mPoseList.erase(i);
+                releasePoseTextures();
                 return;
             }
         }
@@ -2355,6 +2439,99 @@ namespace Ogre {
             delete i;
         }
         mPoseList.clear();
+        releasePoseTextures();
+    }
+    //---------------------------------------------------------------------
+    void Mesh::buildPoseImage(ushort target, Image& image)
+    {
+        const VertexData* vertexData = getVertexDataByTrackHandle(target);
+        OgreAssert(vertexData, "The pose target has no vertex data");
+
+        std::vector<const Pose*> poses;
+        bool normals = false;
+        for (const Pose* pose : mPoseList)
+        {
+            if (pose->getTarget() != target)
+                continue;
+            poses.push_back(pose);
+            normals = normals || pose->getIncludesNormals();
+        }
+        OgreAssert(!poses.empty(), "The pose target has no poses");
+
+        auto width = uint32(vertexData->vertexCount);
+        auto rows = uint32(poses.size() * (normals ? 2 : 1));
+        image.create(PixelFormat::FLOAT32_RGBA, width, rows);
+        std::span texels{image.getData<float>(), size_t(width) * rows * 4};
+        std::ranges::fill(texels, 0.0f);
+
+        for (size_t row = 0; row < poses.size(); ++row)
+        {
+            for (auto const& [index, offset] : poses[row]->getVertexOffsets())
+            {
+                float* texel = &texels[(row * width + index) * 4];
+                texel[0] = float(offset.x);
+                texel[1] = float(offset.y);
+                texel[2] = float(offset.z);
+            }
+        }
+        if (!normals)
+            return;
+
+        // the normals of the poses are absolute, the offsets are relative to the original ones
+        const VertexElement* normElem =
+            vertexData->vertexDeclaration->findElementBySemantic(VertexElementSemantic::NORMAL);
+        OgreAssert(normElem && normElem->getType() == VertexElementType::FLOAT3,
+                   "Pose normals require FLOAT3 normals in the geometry");
+        const HardwareVertexBufferSharedPtr& normBuf = vertexData->vertexBufferBinding->getBuffer(normElem->getSource());
+        HardwareBufferLockGuard normLock(normBuf, HardwareBuffer::LockOptions::READ_ONLY);
+        for (size_t row = 0; row < poses.size(); ++row)
+        {
+            for (auto const& [index, normal] : poses[row]->getNormals())
+            {
+                float* original;
+                normElem->baseVertexPointerToElement(
+                    static_cast<unsigned char*>(normLock.pData) + index * normBuf->getVertexSize(), &original);
+                float* texel = &texels[((poses.size() + row) * width + index) * 4];
+                texel[0] = float(normal.x) - original[0];
+                texel[1] = float(normal.y) - original[1];
+                texel[2] = float(normal.z) - original[2];
+            }
+        }
+    }
+    //---------------------------------------------------------------------
+    auto Mesh::getPoseTexture(ushort target) -> const TexturePtr&
+    {
+        TexturePtr& texture = mPoseTextures[target];
+        if (texture)
+            return texture;
+
+        // a texture unit referencing the texture may have created it already
+        auto& textureMgr = TextureManager::getSingleton();
+        String name = std::format("{}/Poses{}", mName, target);
+        texture = textureMgr.getByName(name, mGroup);
+        if (!texture)
+            texture = textureMgr.create(name, mGroup, true);
+        if (!texture->isLoaded())
+        {
+            Image image;
+            buildPoseImage(target, image);
+            texture->setTextureType(TextureType::_2D);
+            texture->setNumMipmaps(TextureMipmap{});
+            texture->setFormat(PixelFormat::FLOAT32_RGBA);
+            texture->loadImage(image);
+        }
+        return texture;
+    }
+    //---------------------------------------------------------------------
+    void Mesh::releasePoseTextures()
+    {
+        if (auto* textureMgr = TextureManager::getSingletonPtr())
+        {
+            for (auto const& [target, texture] : mPoseTextures)
+                if (texture)
+                    textureMgr->remove(texture);
+        }
+        mPoseTextures.clear();
     }
 
     //-----------------------------------------------------------------------------
@@ -0,0 +1,173 @@
+// This file is part of the OGRE project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at https://www.ogre3d.org/licensing.
+module;
+
+#include <cstddef>
+
+module Ogre.Core;
+
+import :AnimationTrack;
+import :HardwareBufferManager;
+import :HardwareVertexBuffer;
+import :LogManager;
+import :Mesh;
+import :MeshLayoutOptimiser;
+import :SubMesh;
+import :VertexIndexData;
+
+import <array>;
+import <format>;
+
+namespace Ogre {
+
+namespace {
+    /// The streams elements are grouped in, in the order of their sources
+    enum Stream : unsigned short
+    {
+        POSITIONS,
+        SKINNED_NORMALS,
+        BLENDING,
+        STATIC_ATTRIBUTES,
+        STREAM_COUNT
+    };
+
+    /// Whether every element of a declaration is in the same place in the other
+    auto isSameLayout(const VertexDeclaration* declaration, const VertexDeclaration* other) -> bool
+    {
+        for (const VertexElement& elem : declaration->getElements())
+        {
+            const VertexElement* otherElem = other->findElementBySemantic(elem.getSemantic(), elem.getIndex());
+            if (!otherElem || otherElem->getSource() != elem.getSource() || otherElem->getOffset() != elem.getOffset())
+                return false;
+        }
+        return true;
+    }
+}
+    //-----------------------------------------------------------------------
+    auto MeshLayoutOptimiser::getOptimisedDeclaration(const VertexDeclaration* declaration, bool skeletalAnimation,
+                                                      bool vertexAnimation, bool vertexAnimationNormals,
+                                                      const Options& options, HardwareBufferManagerBase* mgr)
+        -> VertexDeclaration*
+    {
+        VertexDeclaration* newDecl = declaration->clone(mgr);
+        if (!options.separatePositions)
+        {
+            // taken over element by element, the auto organised declaration comes from the default manager
+            VertexDeclaration* autoDecl =
+                declaration->getAutoOrganisedDeclaration(skeletalAnimation, vertexAnimation, vertexAnimationNormals);
+            newDecl->removeAllElements();
+            for (const VertexElement& elem : autoDecl->getElements())
+                newDecl->addElement(elem.getSource(), elem.getOffset(), elem.getType(), elem.getSemantic(),
+                                    elem.getIndex());
+            HardwareBufferManager::getSingleton().destroyVertexDeclaration(autoDecl);
+            return newDecl;
+        }
+
+        // in the order of their semantics, positions first
+        const VertexDeclaration::VertexElementList& elems = newDecl->getElements();
+        for (unsigned short c = 0;
+             const VertexElement& elem : elems)
+        {
+            newDecl->modifyElement(c, 0, 0, elem.getType(), elem.getSemantic(), elem.getIndex());
+            ++c;
+        }
+        newDecl->sort();
+
+        // morph key frames replace the positions and normals of one buffer together
+        bool morphNormals = vertexAnimation && vertexAnimationNormals;
+        auto streamOf = [&](const VertexElement& elem) -> Stream
+        {
+            using enum VertexElementSemantic;
+            switch (elem.getSemantic())
+            {
+            case POSITION:
+                return POSITIONS;
+            case NORMAL:
+                return morphNormals ? POSITIONS : skeletalAnimation ? SKINNED_NORMALS : STATIC_ATTRIBUTES;
+            case BLEND_WEIGHTS:
+            case BLEND_INDICES:
+                return BLENDING;
+            default:
+                return STATIC_ATTRIBUTES;
+            }
+        };
+
+        // the streams in use get contiguous sources
+        std::array<unsigned short, STREAM_COUNT> sources{};
+        std::array<bool, STREAM_COUNT> used{};
+        for (const VertexElement& elem : elems)
+            used[streamOf(elem)] = true;
+        for (unsigned short stream = 0, source = 0; stream < STREAM_COUNT; ++stream)
+            if (used[stream])
+                sources[stream] = source++;
+
+        std::array<size_t, STREAM_COUNT> offsets{};
+        for (unsigned short c = 0;
+             const VertexElement& elem : elems)
+        {
+            Stream stream = streamOf(elem);
+            newDecl->modifyElement(c, sources[stream], offsets[stream], elem.getType(), elem.getSemantic(),
+                                   elem.getIndex());
+            offsets[stream] += elem.getSize();
+            ++c;
+        }
+        newDecl->sort();
+        return newDecl;
+    }
+    //-----------------------------------------------------------------------
+    auto MeshLayoutOptimiser::optimise(VertexData* vertexData, bool skeletalAnimation, bool vertexAnimation,
+                                       bool vertexAnimationNormals, const Options& options,
+                                       HardwareBufferManagerBase* mgr) -> bool
+    {
+        if (!vertexData || vertexData->vertexCount == 0)
+            return false;
+
+        VertexDeclaration* newDecl = getOptimisedDeclaration(vertexData->vertexDeclaration, skeletalAnimation,
+                                                             vertexAnimation, vertexAnimationNormals, options, mgr);
+        if (isSameLayout(vertexData->vertexDeclaration, newDecl))
+        {
+            HardwareBufferManagerBase* pManager = mgr ? mgr : HardwareBufferManager::getSingletonPtr();
+            pManager->destroyVertexDeclaration(newDecl);
+            return false;
+        }
+
+        vertexData->reorganiseBuffers(newDecl, mgr);
+        return true;
+    }
+    //-----------------------------------------------------------------------
+    auto MeshLayoutOptimiser::optimise(Mesh* mesh, const Options& options) -> Statistics
+    {
+        bool skeletal = mesh->hasSkeleton();
+        HardwareBufferManagerBase* mgr = mesh->getHardwareBufferManager();
+
+        Statistics stats;
+        auto optimiseData = [&](VertexData* data, VertexAnimationType animationType, bool animationNormals)
+        {
+            stats.buffersBefore += data->vertexBufferBinding->getBufferCount();
+            if (optimise(data, skeletal, animationType != VertexAnimationType::NONE, animationNormals, options, mgr))
+                ++stats.vertexDataChanged;
+            stats.buffersAfter += data->vertexBufferBinding->getBufferCount();
+        };
+
+        if (mesh->sharedVertexData)
+        {
+            // determines whether the animation includes normals too
+            VertexAnimationType animationType = mesh->getSharedVertexDataAnimationType();
+            optimiseData(mesh->sharedVertexData, animationType, mesh->getSharedVertexDataAnimationIncludesNormals());
+        }
+        for (SubMesh* sub : mesh->getSubMeshes())
+        {
+            if (!sub->useSharedVertices && sub->vertexData)
+            {
+                VertexAnimationType animationType = sub->getVertexAnimationType();
+                optimiseData(sub->vertexData.get(), animationType, sub->getVertexAnimationIncludesNormals());
+            }
+        }
+
+        LogManager::getSingleton().logMessage(::std::format("Mesh: Reorganised {} vertex data of {}, {} -> {} streams",
+                                                            stats.vertexDataChanged, mesh->getName(),
+                                                            stats.buffersBefore, stats.buffersAfter));
+        return stats;
+    }
+}
@@ -0,0 +1,465 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+module;
+
+#include <cstddef>
+
+module Ogre.Core;
+
+import :Exception;
+import :HardwareBuffer;
+import :HardwareBufferManager;
+import :HardwareIndexBuffer;
+import :HardwareVertexBuffer;
+import :LodStrategy;
+import :Mesh;
+import :MeshLodGenerator;
+import :MeshOptimiser;
+import :Root;
+import :SubMesh;
+import :Vector;
+import :VertexIndexData;
+import :WorkQueue;
+
+import <algorithm>;
+import <format>;
+import <iterator>;
+import <numeric>;
+import <span>;
+import <vector>;
+
+namespace Ogre {
+
+    namespace {
+        /// Symmetric 4x4 matrix measuring the squared distance to a set of planes
+        struct Quadric
+        {
+            double a00{0}, a01{0}, a02{0}, a03{0};
+            double a11{0}, a12{0}, a13{0};
+            double a22{0}, a23{0};
+            double a33{0};
+
+            void addPlane(const Vector3& n, double d, double weight)
+            {
+                double x = n.x, y = n.y, z = n.z;
+                a00 += weight * x * x; a01 += weight * x * y; a02 += weight * x * z; a03 += weight * x * d;
+                a11 += weight * y * y; a12 += weight * y * z; a13 += weight * y * d;
+                a22 += weight * z * z; a23 += weight * z * d;
+                a33 += weight * d * d;
+            }
+
+            auto operator+=(const Quadric& q) -> Quadric&
+            {
+                a00 += q.a00; a01 += q.a01; a02 += q.a02; a03 += q.a03;
+                a11 += q.a11; a12 += q.a12; a13 += q.a13;
+                a22 += q.a22; a23 += q.a23;
+                a33 += q.a33;
+                return *this;
+            }
+
+            [[nodiscard]] auto evaluate(const Vector3& p) const -> double
+            {
+                double x = p.x, y = p.y, z = p.z;
+                return a00 * x * x + 2 * a01 * x * y + 2 * a02 * x * z + 2 * a03 * x
+                     + a11 * y * y + 2 * a12 * y * z + 2 * a13 * y
+                     + a22 * z * z + 2 * a23 * z
+                     + a33;
+            }
+        };
+
+        /// Moving vertex 'from' onto vertex 'to'
+        struct Collapse
+        {
+            uint32 from;
+            uint32 to;
+            double cost;
+        };
+
+        auto triangleNormal(const Vector3& p0, const Vector3& p1, const Vector3& p2) -> Vector3
+        {
+            return (p1 - p0).crossProduct(p2 - p0);
+        }
+
+        /// Flags vertices on open or non-manifold edges, these must stay in place
+        auto findBorderVertices(std::span<const uint32> indices, size_t vertexCount) -> std::vector<uint8>
+        {
+            std::vector<uint64> edges;
+            edges.reserve(indices.size());
+            for (size_t i = 0; i < indices.size(); i += 3)
+            {
+                for (size_t k = 0; k < 3; ++k)
+                {
+                    uint64 a = indices[i + k], b = indices[i + (k + 1) % 3];
+                    edges.push_back(a < b ? (a << 32) | b : (b << 32) | a);
+                }
+            }
+            std::ranges::sort(edges);
+
+            std::vector<uint8> border(vertexCount, 0);
+            for (size_t i = 0; i < edges.size();)
+            {
+                size_t j = i + 1;
+                while (j < edges.size() && edges[j] == edges[i])
+                    ++j;
+                if (j - i != 2)
+                {
+                    border[edges[i] >> 32] = 1;
+                    border[edges[i] & 0xFFFFFFFF] = 1;
+                }
+                i = j;
+            }
+            return border;
+        }
+
+        auto readPositions(const VertexData* vertexData) -> std::vector<Vector3>
+        {
+            const VertexElement* elemPos =
+                vertexData->vertexDeclaration->findElementBySemantic(VertexElementSemantic::POSITION);
+            if (!elemPos)
+                OGRE_EXCEPT(ExceptionCodes::INVALIDPARAMS, "Vertex data has no positions",
+                            "MeshLodGenerator::generateLodLevels");
+
+            HardwareVertexBufferSharedPtr vbuf = vertexData->vertexBufferBinding->getBuffer(elemPos->getSource());
+            HardwareBufferLockGuard vertexLock(vbuf, HardwareBuffer::LockOptions::READ_ONLY);
+            size_t vSize = vbuf->getVertexSize();
+            auto* vertex = static_cast<unsigned char*>(vertexLock.pData) + vertexData->vertexStart * vSize;
+
+            std::vector<Vector3> positions(vertexData->vertexCount);
+            for (auto& p : positions)
+            {
+                float* pFloat;
+                elemPos->baseVertexPointerToElement(vertex, &pFloat);
+                p = {pFloat[0], pFloat[1], pFloat[2]};
+                vertex += vSize;
+            }
+            return positions;
+        }
+
+        auto readIndices(const IndexData* indexData) -> std::vector<uint32>
+        {
+            std::vector<uint32> indices(indexData->indexCount);
+            if (indices.empty())
+                return indices;
+
+            const HardwareIndexBufferSharedPtr& ibuf = indexData->indexBuffer;
+            HardwareBufferLockGuard indexLock(ibuf, indexData->indexStart * ibuf->getIndexSize(),
+                                              indexData->indexCount * ibuf->getIndexSize(),
+                                              HardwareBuffer::LockOptions::READ_ONLY);
+            if (ibuf->getType() == HardwareIndexBuffer::IndexType::_32BIT)
+                std::ranges::copy_n(static_cast<const uint32*>(indexLock.pData), indices.size(), indices.begin());
+            else
+                std::ranges::copy_n(static_cast<const uint16*>(indexLock.pData), indices.size(), indices.begin());
+            return indices;
+        }
+
+        auto createIndexData(Mesh* mesh, const IndexData* source, const std::vector<uint32>& indices) -> IndexData*
+        {
+            auto* indexData = new IndexData();
+            indexData->indexCount = indices.size();
+            if (indices.empty())
+                return indexData;
+
+            const HardwareIndexBufferSharedPtr& src = source->indexBuffer;
+            HardwareIndexBuffer::IndexType type = src->getType();
+            indexData->indexBuffer = mesh->getHardwareBufferManager()->createIndexBuffer(
+                type, indices.size(), src->getUsage(), src->hasShadowBuffer());
+
+            if (type == HardwareIndexBuffer::IndexType::_32BIT)
+            {
+                indexData->indexBuffer->writeData(0, indexData->indexBuffer->getSizeInBytes(), indices.data(), true);
+            }
+            else
+            {
+                std::vector<uint16> indices16{indices.begin(), indices.end()};
+                indexData->indexBuffer->writeData(0, indexData->indexBuffer->getSizeInBytes(), indices16.data(), true);
+            }
+            return indexData;
+        }
+    }
+    //-----------------------------------------------------------------------
+    auto MeshLodGenerator::simplify(std::span<const Vector3> positions, std::span<const uint32> indices,
+                                    size_t targetIndexCount) -> std::vector<uint32>
+    {
+        size_t vertexCount = positions.size();
+        std::vector<uint32> result{indices.begin(), indices.end() - indices.size() % 3};
+        if (result.size() <= targetIndexCount)
+            return result;
+
+        // area weighted plane quadrics of the original surface
+        std::vector<Quadric> quadrics(vertexCount);
+        for (size_t i = 0; i < result.size(); i += 3)
+        {
+            const Vector3& p0 = positions[result[i]];
+            Vector3 n = triangleNormal(p0, positions[result[i + 1]], positions[result[i + 2]]);
+            Real area = n.normalise();
+            if (area == 0)
+                continue;
+            double d = -n.dotProduct(p0);
+            for (size_t k = 0; k < 3; ++k)
+                quadrics[result[i + k]].addPlane(n, d, area * 0.5);
+        }
+
+        std::vector<uint8> border = findBorderVertices(result, vertexCount);
+
+        std::vector<uint32> offsets, adjacency, remap(vertexCount);
+        std::vector<uint32> fromNeighbours, toNeighbours, shared;
+        std::vector<Collapse> collapses;
+        std::vector<uint8> touched;
+
+        auto gatherNeighbours = [&](uint32 v, std::vector<uint32>& out)
+        {
+            out.clear();
+            for (uint32 a = offsets[v]; a < offsets[v + 1]; ++a)
+            {
+                const uint32* tri = &result[adjacency[a] * 3];
+                for (size_t k = 0; k < 3; ++k)
+                    if (tri[k] != v)
+                        out.push_back(tri[k]);
+            }
+            std::ranges::sort(out);
+            out.erase(std::unique(out.begin(), out.end()), out.end());
+        };
+
+        while (result.size() > targetIndexCount)
+        {
+            size_t triangleCount = result.size() / 3;
+
+            // vertex to triangle adjacency of the current triangles
+            offsets.assign(vertexCount + 1, 0);
+            for (uint32 v : result)
+                ++offsets[v + 1];
+            std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+            adjacency.resize(result.size());
+            std::vector<uint32> cursor{offsets.begin(), offsets.end() - 1};
+            for (size_t i = 0; i < result.size(); ++i)
+                adjacency[cursor[result[i]]++] = static_cast<uint32>(i / 3);
+
+            // every interior edge shows up once in ascending order
+            collapses.clear();
+            for (size_t i = 0; i < result.size(); i += 3)
+            {
+                for (size_t k = 0; k < 3; ++k)
+                {
+                    uint32 a = result[i + k], b = result[i + (k + 1) % 3];
+                    if (a > b || (border[a] && border[b]))
+                        continue;
+                    Quadric q = quadrics[a];
+                    q += quadrics[b];
+                    if (!border[a])
+                        collapses.push_back({a, b, q.evaluate(positions[b])});
+                    if (!border[b])
+                        collapses.push_back({b, a, q.evaluate(positions[a])});
+                }
+            }
+            std::ranges::sort(collapses, [](const Collapse& l, const Collapse& r)
+            {
+                return l.cost != r.cost ? l.cost < r.cost : (l.from != r.from ? l.from < r.from : l.to < r.to);
+            });
+
+            // only take a part of the triangles per pass, so the cheapest collapses win
+            size_t toRemove = (result.size() - targetIndexCount + 2) / 3;
+            size_t passLimit = std::min(toRemove, std::max<size_t>(triangleCount / 8, 1));
+            size_t removed = 0;
+            touched.assign(vertexCount, 0);
+            std::iota(remap.begin(), remap.end(), 0);
+
+            for (const Collapse& c : collapses)
+            {
+                if (touched[c.from] || touched[c.to])
+                    continue;
+
+                // reject collapses which flip a remaining triangle
+                size_t collapsedTriangles = 0;
+                bool flips = false;
+                for (uint32 a = offsets[c.from]; a < offsets[c.from + 1] && !flips; ++a)
+                {
+                    const uint32* tri = &result[adjacency[a] * 3];
+                    if (tri[0] == c.to || tri[1] == c.to || tri[2] == c.to)
+                    {
+                        ++collapsedTriangles;
+                        continue;
+                    }
+                    Vector3 before = triangleNormal(positions[tri[0]], positions[tri[1]], positions[tri[2]]);
+                    Vector3 after = triangleNormal(positions[tri[0] == c.from ? c.to : tri[0]],
+                                                   positions[tri[1] == c.from ? c.to : tri[1]],
+                                                   positions[tri[2] == c.from ? c.to : tri[2]]);
+                    flips = !before.isZeroLength() && before.dotProduct(after) <= 0;
+                }
+                if (flips)
+                    continue;
+
+                // link condition, keeps the surface manifold
+                gatherNeighbours(c.from, fromNeighbours);
+                gatherNeighbours(c.to, toNeighbours);
+                shared.clear();
+                std::ranges::set_intersection(fromNeighbours, toNeighbours, std::back_inserter(shared));
+                if (shared.size() != collapsedTriangles)
+                    continue;
+
+                remap[c.from] = c.to;
+                quadrics[c.to] += quadrics[c.from];
+                // freeze the neighbourhood, the tests above rely on it being unchanged
+                for (uint32 v : fromNeighbours)
+                    touched[v] = 1;
+                touched[c.from] = 1;
+
+                removed += collapsedTriangles;
+                if (removed >= passLimit)
+                    break;
+            }
+
+            if (removed == 0)
+                break;
+
+            size_t out = 0;
+            for (size_t i = 0; i < result.size(); i += 3)
+            {
+                uint32 a = remap[result[i]], b = remap[result[i + 1]], c = remap[result[i + 2]];
+                if (a == b || b == c || a == c)
+                    continue;
+                result[out++] = a;
+                result[out++] = b;
+                result[out++] = c;
+            }
+            result.resize(out);
+        }
+
+        return result;
+    }
+    //-----------------------------------------------------------------------
+    void MeshLodGenerator::generateLodLevels(Mesh* mesh, const LodLevelList& levels)
+    {
+        bool edgeListWasBuilt = mesh->isEdgeListBuilt();
+        if (edgeListWasBuilt)
+            mesh->freeEdgeList();
+        mesh->removeLodLevels();
+
+        if (levels.empty())
+        {
+            if (edgeListWasBuilt)
+                mesh->buildEdgeList();
+            return;
+        }
+
+        const LodStrategy* strategy = mesh->getLodStrategy();
+        Mesh::LodValueList values;
+        for (const LodLevel& level : levels)
+            values.push_back(strategy->transformUserValue(level.userValue));
+        if (!strategy->isSorted(values))
+            OGRE_EXCEPT(ExceptionCodes::INVALIDPARAMS,
+                        ::std::format("LOD levels are not ordered for the {} strategy of {}",
+                                      strategy->getName(), mesh->getName()),
+                        "MeshLodGenerator::generateLodLevels");
+
+        struct SubMeshJob
+        {
+            std::span<const Vector3> positions;
+            std::vector<Vector3> ownPositions;
+            std::vector<uint32> indices;
+            std::vector<std::vector<uint32>> lods;
+            bool simplify{false};
+        };
+
+        // read back on this thread, the buffers may not be accessed from workers
+        std::vector<Vector3> sharedPositions;
+        if (mesh->sharedVertexData)
+            sharedPositions = readPositions(mesh->sharedVertexData);
+
+        const Mesh::SubMeshList& subMeshes = mesh->getSubMeshes();
+        std::vector<SubMeshJob> jobs(subMeshes.size());
+        for (size_t i = 0; i < jobs.size(); ++i)
+        {
+            SubMesh* sub = subMeshes[i];
+            SubMeshJob& job = jobs[i];
+            if (sub->operationType != RenderOperation::OperationType::TRIANGLE_LIST || !sub->indexData->indexBuffer)
+                continue;
+
+            if (sub->useSharedVertices)
+                job.positions = sharedPositions;
+            else
+            {
+                job.ownPositions = readPositions(sub->vertexData.get());
+                job.positions = job.ownPositions;
+            }
+            job.indices = readIndices(sub->indexData.get());
+            job.simplify = std::ranges::all_of(job.indices, [&](uint32 v) { return v < job.positions.size(); });
+        }
+
+        auto simplifyJob = [&](size_t i)
+        {
+            SubMeshJob& job = jobs[i];
+            if (!job.simplify)
+                return;
+
+            size_t triangleCount = job.indices.size() / 3;
+            std::span<const uint32> previous = job.indices;
+            job.lods.resize(levels.size());
+            for (size_t l = 0; l < levels.size(); ++l)
+            {
+                Real keep = 1 - std::clamp<Real>(levels[l].reduction, 0, 1);
+                size_t target = static_cast<size_t>(triangleCount * keep) * 3;
+                job.lods[l] = simplify(job.positions, previous, target);
+                MeshOptimiser::optimiseVertexCache(job.lods[l], job.positions.size());
+                previous = job.lods[l];
+            }
+        };
+
+        Root* root = Root::getSingletonPtr();
+        if (root && root->getWorkQueue())
+            root->getWorkQueue()->parallelFor(jobs.size(), simplifyJob);
+        else
+            for (size_t i = 0; i < jobs.size(); ++i)
+                simplifyJob(i);
+
+        auto numLevels = static_cast<ushort>(levels.size() + 1);
+        mesh->_setLodInfo(numLevels);
+        for (ushort l = 1; l < numLevels; ++l)
+        {
+            MeshLodUsage usage;
+            usage.userValue = levels[l - 1].userValue;
+            usage.value = values[l - 1];
+            usage.edgeData = nullptr;
+            mesh->_setLodUsage(l, usage);
+        }
+
+        for (size_t i = 0; i < jobs.size(); ++i)
+        {
+            SubMesh* sub = subMeshes[i];
+            for (ushort l = 1; l < numLevels; ++l)
+            {
+                IndexData* lodData = jobs[i].simplify
+                    ? createIndexData(mesh, sub->indexData.get(), jobs[i].lods[l - 1])
+                    : sub->indexData->clone(true, mesh->getHardwareBufferManager());
+                mesh->_setSubMeshLodFaceList(static_cast<ushort>(i), l, lodData);
+            }
+        }
+
+        if (edgeListWasBuilt)
+            mesh->buildEdgeList();
+    }
+}
@@ -944,6 +944,29 @@ namespace Ogre
         mBoundsPaddingFactor = paddingFactor;
     }
     //-----------------------------------------------------------------------
+    void MeshManager::setAutoLodLevels(const MeshLodGenerator::LodLevelList& levels)
+    {
+        mAutoLodLevels = levels;
+    }
+    //-----------------------------------------------------------------------
+    void MeshManager::setOptimiseMeshesOnLoad(bool enable, const MeshOptimiser::Options& options)
+    {
+        mOptimiseOnLoad = enable;
+        mOptimiseOptions = options;
+    }
+    //-----------------------------------------------------------------------
+    void MeshManager::setQuantiseMeshesOnLoad(bool enable, const MeshQuantiser::Options& options)
+    {
+        mQuantiseOnLoad = enable;
+        mQuantiseOptions = options;
+    }
+    //-----------------------------------------------------------------------
+    void MeshManager::setOptimiseVertexLayoutsOnLoad(bool enable, const MeshLayoutOptimiser::Options& options)
+    {
+        mOptimiseLayoutsOnLoad = enable;
+        mLayoutOptions = options;
+    }
+    //-----------------------------------------------------------------------
     auto MeshManager::createImpl(std::string_view name, ResourceHandle handle, 
         std::string_view group, bool isManual, ManualResourceLoader* loader, 
         const NameValuePairList* createParams) -> Resource*
@@ -0,0 +1,606 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+module;
+
+#include <cstddef>
+
+module Ogre.Core;
+
+import :Animation;
+import :Exception;
+import :AnimationTrack;
+import :HardwareBuffer;
+import :HardwareBufferManager;
+import :HardwareIndexBuffer;
+import :HardwareVertexBuffer;
+import :KeyFrame;
+import :LogManager;
+import :Mesh;
+import :MeshOptimiser;
+import :Pose;
+import :RenderOperation;
+import :SubMesh;
+import :Vector;
+import :VertexBoneAssignment;
+import :VertexIndexData;
+
+import <algorithm>;
+import <cmath>;
+import <format>;
+import <limits>;
+import <map>;
+import <span>;
+import <vector>;
+
+namespace Ogre {
+
+    namespace {
+        // Forsyth's scoring parameters
+        constexpr size_t FORSYTH_CACHE_SIZE = 32;
+        constexpr float CACHE_DECAY_POWER = 1.5f;
+        constexpr float LAST_TRI_SCORE = 0.75f;
+        constexpr float VALENCE_BOOST_SCALE = 2.0f;
+
+        constexpr uint32 UNUSED = std::numeric_limits<uint32>::max();
+
+        auto forsythScore(int cachePosition, uint32 remainingTriangles) -> float
+        {
+            if (remainingTriangles == 0)
+                return -1;
+
+            float score = 0;
+            if (cachePosition >= 0)
+            {
+                // the vertices of the last triangle are all equally good
+                if (cachePosition < 3)
+                    score = LAST_TRI_SCORE;
+                else
+                    score = std::pow(1 - float(cachePosition - 3) / (FORSYTH_CACHE_SIZE - 3), CACHE_DECAY_POWER);
+            }
+            // favour finishing off vertices with few triangles left
+            return score + VALENCE_BOOST_SCALE / std::sqrt(float(remainingTriangles));
+        }
+
+        /// FIFO post transform cache, as found in hardware
+        class FifoCache
+        {
+        public:
+            FifoCache(size_t vertexCount, size_t size) : mStamps(vertexCount, 0), mSize(size) {}
+
+            /// Returns whether the vertex missed the cache
+            auto access(uint32 v) -> bool
+            {
+                // stamps count misses, so entries older than mSize misses were evicted
+                if (mStamps[v] != 0 && mTime - mStamps[v] < mSize)
+                    return false;
+                mStamps[v] = ++mTime;
+                return true;
+            }
+
+            void reset() { mTime += mSize; }
+
+        private:
+            std::vector<size_t> mStamps;
+            size_t mSize;
+            size_t mTime{0};
+        };
+
+        auto maxIndex(std::span<const uint32> indices) -> size_t
+        {
+            return indices.empty() ? 0 : *std::ranges::max_element(indices) + 1;
+        }
+
+        auto countCacheMisses(std::span<const uint32> indices, size_t cacheSize) -> size_t
+        {
+            FifoCache cache{maxIndex(indices), cacheSize};
+            size_t misses = 0;
+            for (size_t i = 0; i < indices.size() - indices.size() % 3; ++i)
+                misses += cache.access(indices[i]);
+            return misses;
+        }
+
+        struct IndexList
+        {
+            IndexData* indexData;
+            std::vector<uint32> indices;
+            bool triangles;
+        };
+
+        /// The index lists using one VertexData
+        struct VertexDataUsers
+        {
+            VertexData* vertexData;
+            /// Pose and vertex track target, 0 for shared and 1 + the SubMesh index otherwise
+            ushort target;
+            std::vector<IndexList*> lists;
+            /// Whether a SubMesh draws without indices, its vertex order must be kept
+            bool unindexed{false};
+        };
+
+        auto readIndices(const IndexData* indexData) -> std::vector<uint32>
+        {
+            std::vector<uint32> indices(indexData->indexCount);
+            if (indices.empty())
+                return indices;
+
+            const HardwareIndexBufferSharedPtr& ibuf = indexData->indexBuffer;
+            size_t offset = indexData->indexStart * ibuf->getIndexSize();
+            if (ibuf->getType() == HardwareIndexBuffer::IndexType::_32BIT)
+            {
+                ibuf->readData(offset, indices.size() * sizeof(uint32), indices.data());
+            }
+            else
+            {
+                std::vector<uint16> indices16(indices.size());
+                ibuf->readData(offset, indices16.size() * sizeof(uint16), indices16.data());
+                std::ranges::copy(indices16, indices.begin());
+            }
+            return indices;
+        }
+
+        /// Puts the indices into a new buffer, returns whether it was switched to 16 bit
+        auto writeIndices(Mesh* mesh, IndexData* indexData, const std::vector<uint32>& indices,
+                          bool use16BitIndices) -> bool
+        {
+            const HardwareIndexBufferSharedPtr& src = indexData->indexBuffer;
+            HardwareIndexBuffer::IndexType type = src->getType();
+            bool converted = false;
+            if (type == HardwareIndexBuffer::IndexType::_32BIT && use16BitIndices &&
+                maxIndex(indices) <= std::numeric_limits<uint16>::max() + size_t(1))
+            {
+                type = HardwareIndexBuffer::IndexType::_16BIT;
+                converted = true;
+            }
+
+            HardwareIndexBufferSharedPtr ibuf = mesh->getHardwareBufferManager()->createIndexBuffer(
+                type, indices.size(), src->getUsage(), src->hasShadowBuffer());
+            if (type == HardwareIndexBuffer::IndexType::_32BIT)
+            {
+                ibuf->writeData(0, ibuf->getSizeInBytes(), indices.data(), true);
+            }
+            else
+            {
+                std::vector<uint16> indices16{indices.begin(), indices.end()};
+                ibuf->writeData(0, ibuf->getSizeInBytes(), indices16.data(), true);
+            }
+
+            indexData->indexBuffer = ibuf;
+            indexData->indexStart = 0;
+            return converted;
+        }
+
+        auto readPositions(const VertexData* vertexData) -> std::vector<Vector3>
+        {
+            std::vector<Vector3> positions(vertexData->vertexCount, Vector3::ZERO);
+            const VertexElement* elemPos =
+                vertexData->vertexDeclaration->findElementBySemantic(VertexElementSemantic::POSITION);
+            if (!elemPos || positions.empty())
+                return positions;
+
+            HardwareVertexBufferSharedPtr vbuf = vertexData->vertexBufferBinding->getBuffer(elemPos->getSource());
+            HardwareBufferLockGuard vertexLock(vbuf, HardwareBuffer::LockOptions::READ_ONLY);
+            size_t vSize = vbuf->getVertexSize();
+            auto* vertex = static_cast<unsigned char*>(vertexLock.pData) + vertexData->vertexStart * vSize;
+            for (auto& p : positions)
+            {
+                float* pFloat;
+                elemPos->baseVertexPointerToElement(vertex, &pFloat);
+                p = {pFloat[0], pFloat[1], pFloat[2]};
+                vertex += vSize;
+            }
+            return positions;
+        }
+
+        /// Moves vertex i of the buffer range to remap[i]
+        void remapVertexBuffer(HardwareVertexBuffer* vbuf, size_t start, const std::vector<uint32>& remap)
+        {
+            OgreAssert(start + remap.size() <= vbuf->getNumVertices(), "Vertex buffer is too small");
+            size_t vSize = vbuf->getVertexSize();
+            size_t count = remap.size();
+            std::vector<unsigned char> source(count * vSize), dest(count * vSize);
+            vbuf->readData(start * vSize, source.size(), source.data());
+            for (size_t v = 0; v < count; ++v)
+                std::copy_n(&source[v * vSize], vSize, &dest[remap[v] * vSize]);
+            vbuf->writeData(start * vSize, dest.size(), dest.data());
+        }
+
+        template <typename Map>
+        void remapKeys(Map& map, const std::vector<uint32>& remap)
+        {
+            Map remapped;
+            for (const auto& [index, value] : map)
+                remapped.emplace(index < remap.size() ? remap[index] : index, value);
+            map = std::move(remapped);
+        }
+
+        void remapVertexData(Mesh* mesh, const VertexDataUsers& users, const std::vector<uint32>& remap)
+        {
+            for (const auto& [source, vbuf] : users.vertexData->vertexBufferBinding->getBindings())
+                remapVertexBuffer(vbuf.get(), users.vertexData->vertexStart, remap);
+
+            for (Pose* pose : mesh->getPoseList())
+            {
+                if (pose->getTarget() != users.target)
+                    continue;
+                remapKeys(pose->_getVertexOffsets(), remap);
+                remapKeys(pose->_getNormals(), remap);
+            }
+
+            for (ushort a = 0; a < mesh->getNumAnimations(); ++a)
+            {
+                for (const auto& [handle, track] : mesh->getAnimation(a)->_getVertexTrackList())
+                {
+                    if (handle != users.target || track->getAnimationType() != VertexAnimationType::MORPH)
+                        continue;
+                    for (size_t k = 0; k < track->getNumKeyFrames(); ++k)
+                    {
+                        auto* keyFrame = track->getVertexMorphKeyFrame(static_cast<ushort>(k));
+                        if (keyFrame->getVertexBuffer())
+                            remapVertexBuffer(keyFrame->getVertexBuffer().get(), 0, remap);
+                    }
+                }
+            }
+
+            auto remapAssignments = [&](auto assignments, auto& owner)
+            {
+                owner.clearBoneAssignments();
+                for (auto [index, assignment] : assignments)
+                {
+                    assignment.vertexIndex = static_cast<uint32>(remap[assignment.vertexIndex]);
+                    owner.addBoneAssignment(assignment);
+                }
+            };
+            if (users.target == 0)
+            {
+                if (!mesh->getBoneAssignments().empty())
+                    remapAssignments(mesh->getBoneAssignments(), *mesh);
+            }
+            else
+            {
+                SubMesh* sub = mesh->getSubMeshes()[users.target - 1];
+                if (!sub->getBoneAssignments().empty())
+                    remapAssignments(sub->getBoneAssignments(), *sub);
+            }
+        }
+    }
+    //-----------------------------------------------------------------------
+    void MeshOptimiser::optimiseVertexCache(std::span<uint32> indices, size_t vertexCount)
+    {
+        size_t triangleCount = indices.size() / 3;
+        if (triangleCount < 2)
+            return;
+
+        // live triangles of each vertex, the first remaining[v] entries of its range
+        std::vector<uint32> offsets(vertexCount + 1, 0), adjacency(triangleCount * 3), remaining(vertexCount, 0);
+        for (size_t i = 0; i < triangleCount * 3; ++i)
+            ++remaining[indices[i]];
+        for (size_t v = 0; v < vertexCount; ++v)
+            offsets[v + 1] = offsets[v] + remaining[v];
+        std::vector<uint32> cursor{offsets.begin(), offsets.end() - 1};
+        for (size_t i = 0; i < triangleCount * 3; ++i)
+            adjacency[cursor[indices[i]]++] = static_cast<uint32>(i / 3);
+
+        std::vector<int> cachePosition(vertexCount, -1);
+        std::vector<float> vertexScore(vertexCount);
+        for (size_t v = 0; v < vertexCount; ++v)
+            vertexScore[v] = forsythScore(-1, remaining[v]);
+
+        std::vector<float> triangleScore(triangleCount);
+        for (size_t t = 0; t < triangleCount; ++t)
+            triangleScore[t] = vertexScore[indices[t * 3]] + vertexScore[indices[t * 3 + 1]] + vertexScore[indices[t * 3 + 2]];
+
+        std::vector<uint8> emitted(triangleCount, 0);
+        std::vector<uint32> result, cache, newCache;
+        result.reserve(triangleCount * 3);
+        cache.reserve(FORSYTH_CACHE_SIZE + 3);
+        newCache.reserve(FORSYTH_CACHE_SIZE + 3);
+
+        size_t inputCursor = 0;
+        size_t best = 0;
+        bool haveBest = false;
+        for (size_t n = 0; n < triangleCount; ++n)
+        {
+            if (!haveBest)
+            {
+                // nothing connected to the cache, continue with the next triangle of the input
+                while (emitted[inputCursor])
+                    ++inputCursor;
+                best = inputCursor;
+            }
+
+            emitted[best] = 1;
+            const uint32* tri = &indices[best * 3];
+            result.insert(result.end(), tri, tri + 3);
+
+            newCache.clear();
+            for (size_t k = 0; k < 3; ++k)
+            {
+                uint32 v = tri[k];
+                // drop the triangle from the live list of the vertex
+                uint32* live = &adjacency[offsets[v]];
+                auto it = std::find(live, live + remaining[v], static_cast<uint32>(best));
+                std::swap(*it, live[--remaining[v]]);
+                newCache.push_back(v);
+            }
+            for (uint32 v : cache)
+                if (v != tri[0] && v != tri[1] && v != tri[2])
+                    newCache.push_back(v);
+
+            for (size_t i = 0; i < newCache.size(); ++i)
+            {
+                uint32 v = newCache[i];
+                cachePosition[v] = i < FORSYTH_CACHE_SIZE ? static_cast<int>(i) : -1;
+                vertexScore[v] = forsythScore(cachePosition[v], remaining[v]);
+            }
+
+            // rescore the triangles around the touched vertices and pick the best one
+            haveBest = false;
+            float bestScore = 0;
+            for (uint32 v : newCache)
+            {
+                for (uint32 a = offsets[v]; a < offsets[v] + remaining[v]; ++a)
+                {
+                    uint32 t = adjacency[a];
+                    float score = vertexScore[indices[t * 3]] + vertexScore[indices[t * 3 + 1]] +
+                                  vertexScore[indices[t * 3 + 2]];
+                    triangleScore[t] = score;
+                    if (!haveBest || score > bestScore)
+                    {
+                        best = t;
+                        bestScore = score;
+                        haveBest = true;
+                    }
+                }
+            }
+
+            if (newCache.size() > FORSYTH_CACHE_SIZE)
+                newCache.resize(FORSYTH_CACHE_SIZE);
+            std::swap(cache, newCache);
+        }
+
+        std::ranges::copy(result, indices.begin());
+    }
+    //-----------------------------------------------------------------------
+    void MeshOptimiser::optimiseOverdraw(std::span<const Vector3> positions, std::span<uint32> indices,
+                                         Real threshold, size_t cacheSize)
+    {
+        size_t triangleCount = indices.size() / 3;
+        if (triangleCount < 2 || threshold < 1)
+            return;
+
+        // split into clusters, each starting with a cold cache and ending as soon
+        // as it uses the cache about as well as the whole list
+        Real targetACMR = calculateACMR(indices, cacheSize) * threshold;
+        std::vector<size_t> clusters{0};
+        FifoCache cache{positions.size(), cacheSize};
+        size_t clusterMisses = 0;
+        for (size_t t = 0; t < triangleCount; ++t)
+        {
+            size_t misses = cache.access(indices[t * 3]) + cache.access(indices[t * 3 + 1]) +
+                            cache.access(indices[t * 3 + 2]);
+            // the cache was flushed anyway, a free boundary
+            if (misses == 3 && t > clusters.back())
+            {
+                clusters.push_back(t);
+                clusterMisses = 0;
+            }
+            clusterMisses += misses;
+
+            if (t + 1 < triangleCount && Real(clusterMisses) / Real(t + 1 - clusters.back()) <= targetACMR)
+            {
+                clusters.push_back(t + 1);
+                clusterMisses = 0;
+                cache.reset();
+            }
+        }
+        clusters.push_back(triangleCount);
+
+        // draw the clusters facing away from the centre first
+        struct Cluster
+        {
+            size_t begin, end;
+            Real sortKey;
+        };
+        std::vector<Cluster> sorted;
+        std::vector<Vector3> centroids(clusters.size() - 1, Vector3::ZERO), normals(clusters.size() - 1, Vector3::ZERO);
+        std::vector<Real> areas(clusters.size() - 1, 0);
+        Vector3 meshCentroid = Vector3::ZERO;
+        Real meshArea = 0;
+        for (size_t c = 0; c + 1 < clusters.size(); ++c)
+        {
+            for (size_t t = clusters[c]; t < clusters[c + 1]; ++t)
+            {
+                const Vector3& p0 = positions[indices[t * 3]];
+                const Vector3& p1 = positions[indices[t * 3 + 1]];
+                const Vector3& p2 = positions[indices[t * 3 + 2]];
+                Vector3 normal = (p1 - p0).crossProduct(p2 - p0);
+                Real area = normal.length();
+                normals[c] += normal;
+                centroids[c] += (p0 + p1 + p2) * (area / 3);
+                areas[c] += area;
+            }
+            meshCentroid += centroids[c];
+            meshArea += areas[c];
+        }
+        if (meshArea > 0)
+            meshCentroid /= meshArea;
+
+        for (size_t c = 0; c + 1 < clusters.size(); ++c)
+        {
+            Real sortKey = 0;
+            if (areas[c] > 0 && !normals[c].isZeroLength())
+                sortKey = (centroids[c] / areas[c] - meshCentroid).dotProduct(normals[c].normalisedCopy());
+            sorted.push_back({clusters[c], clusters[c + 1], sortKey});
+        }
+        std::ranges::stable_sort(sorted, [](const Cluster& l, const Cluster& r) { return l.sortKey > r.sortKey; });
+
+        std::vector<uint32> result;
+        result.reserve(triangleCount * 3);
+        for (const Cluster& c : sorted)
+            result.insert(result.end(), indices.begin() + c.begin * 3, indices.begin() + c.end * 3);
+        std::ranges::copy(result, indices.begin());
+    }
+    //-----------------------------------------------------------------------
+    auto MeshOptimiser::buildVertexFetchRemap(std::span<const std::span<const uint32>> indexLists,
+                                              size_t vertexCount) -> std::vector<uint32>
+    {
+        std::vector<uint32> remap(vertexCount, UNUSED);
+        uint32 next = 0;
+        for (auto indices : indexLists)
+            for (uint32 v : indices)
+                if (v < vertexCount && remap[v] == UNUSED)
+                    remap[v] = next++;
+        for (auto& v : remap)
+            if (v == UNUSED)
+                v = next++;
+        return remap;
+    }
+    //-----------------------------------------------------------------------
+    auto MeshOptimiser::calculateACMR(std::span<const uint32> indices, size_t cacheSize) -> Real
+    {
+        size_t triangleCount = indices.size() / 3;
+        if (triangleCount == 0)
+            return 0;
+
+        return Real(countCacheMisses(indices, cacheSize)) / Real(triangleCount);
+    }
+    //-----------------------------------------------------------------------
+    auto MeshOptimiser::optimise(Mesh* mesh, const Options& options) -> Statistics
+    {
+        Statistics stats;
+        const Mesh::SubMeshList& subMeshes = mesh->getSubMeshes();
+
+        // gather the index lists per vertex data, full detail first so it decides the fetch order
+        std::vector<IndexList> lists;
+        std::vector<VertexDataUsers> users;
+        users.push_back({mesh->sharedVertexData, 0});
+        for (size_t i = 0; i < subMeshes.size(); ++i)
+            users.push_back({subMeshes[i]->useSharedVertices ? nullptr : subMeshes[i]->vertexData.get(),
+                             static_cast<ushort>(i + 1)});
+
+        size_t listCount = 0;
+        for (SubMesh* sub : subMeshes)
+            listCount += 1 + sub->mLodFaceList.size();
+        lists.reserve(listCount);
+
+        for (size_t level = 0; level < mesh->getNumLodLevels(); ++level)
+        {
+            for (size_t i = 0; i < subMeshes.size(); ++i)
+            {
+                SubMesh* sub = subMeshes[i];
+                VertexDataUsers& user = users[sub->useSharedVertices ? 0 : i + 1];
+                IndexData* indexData = level == 0 ? sub->indexData.get()
+                    : level - 1 < sub->mLodFaceList.size() ? sub->mLodFaceList[level - 1] : nullptr;
+                if (!indexData)
+                    continue;
+                if (indexData->indexCount == 0 || !indexData->indexBuffer)
+                {
+                    user.unindexed = user.unindexed || level == 0;
+                    continue;
+                }
+
+                bool triangles = sub->operationType == RenderOperation::OperationType::TRIANGLE_LIST;
+                lists.push_back({indexData, readIndices(indexData), triangles});
+                user.lists.push_back(&lists.back());
+            }
+        }
+
+        auto measure = [&]
+        {
+            size_t misses = 0, triangleCount = 0;
+            for (size_t i = 0; i < subMeshes.size(); ++i)
+            {
+                for (const IndexList* list : users[subMeshes[i]->useSharedVertices ? 0 : i + 1].lists)
+                {
+                    if (list->indexData != subMeshes[i]->indexData.get() || !list->triangles)
+                        continue;
+                    misses += countCacheMisses(list->indices, DEFAULT_CACHE_SIZE);
+                    triangleCount += list->indices.size() / 3;
+                }
+            }
+            return triangleCount ? Real(misses) / Real(triangleCount) : Real(0);
+        };
+        stats.acmrBefore = measure();
+
+        bool edgeListWasBuilt = mesh->isEdgeListBuilt();
+        if (edgeListWasBuilt)
+            mesh->freeEdgeList();
+
+        for (VertexDataUsers& user : users)
+        {
+            if (!user.vertexData || user.lists.empty())
+                continue;
+
+            size_t vertexCount = user.vertexData->vertexCount;
+            std::vector<Vector3> positions;
+            if (options.overdrawThreshold >= 1)
+                positions = readPositions(user.vertexData);
+
+            bool inRange = true;
+            for (IndexList* list : user.lists)
+            {
+                if (maxIndex(list->indices) > vertexCount)
+                {
+                    inRange = false;
+                    continue;
+                }
+                if (!list->triangles)
+                    continue;
+                if (options.vertexCache)
+                    optimiseVertexCache(list->indices, vertexCount);
+                if (options.overdrawThreshold >= 1)
+                    optimiseOverdraw(positions, list->indices, options.overdrawThreshold);
+            }
+
+            if (options.vertexFetch && !user.unindexed && inRange)
+            {
+                std::vector<std::span<const uint32>> spans;
+                for (const IndexList* list : user.lists)
+                    spans.emplace_back(list->indices);
+                std::vector<uint32> remap = buildVertexFetchRemap(spans, vertexCount);
+
+                for (IndexList* list : user.lists)
+                    for (auto& v : list->indices)
+                        v = remap[v];
+                remapVertexData(mesh, user, remap);
+            }
+        }
+
+        for (const IndexList& list : lists)
+            stats.convertedIndexBuffers += writeIndices(mesh, list.indexData, list.indices, options.use16BitIndices);
+
+        if (edgeListWasBuilt)
+            mesh->buildEdgeList();
+
+        stats.acmrAfter = measure();
+        LogManager::getSingleton().logMessage(
+            ::std::format("Mesh: Optimised {}, ACMR {:.3f} -> {:.3f}, {} index buffers switched to 16 bit",
+                          mesh->getName(), stats.acmrBefore, stats.acmrAfter, stats.convertedIndexBuffers));
+        return stats;
+    }
+}
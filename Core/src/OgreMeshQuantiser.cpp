@@ -0,0 +1,241 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+module;
+
+#include <cstddef>
+#include <cstring>
+
+module Ogre.Core;
+
+import :Bitwise;
+import :HardwareBuffer;
+import :HardwareBufferManager;
+import :HardwareVertexBuffer;
+import :LogManager;
+import :Mesh;
+import :MeshQuantiser;
+import :SubMesh;
+import :VertexIndexData;
+
+import <algorithm>;
+import <cmath>;
+import <format>;
+import <vector>;
+
+namespace Ogre {
+
+    namespace {
+        auto packSnorm(float value, float scale) -> int
+        {
+            return static_cast<int>(std::lround(std::clamp(value, -1.0f, 1.0f) * scale));
+        }
+
+        /// Whether a float texture coordinate set survives the conversion to half floats
+        auto isHalfPrecise(const VertexElement& elem, const unsigned char* data, size_t vertexSize, size_t vertexCount) -> bool
+        {
+            unsigned short count = VertexElement::getTypeCount(elem.getType());
+            for (size_t v = 0; v < vertexCount; ++v)
+            {
+                float values[4];
+                std::memcpy(values, data + v * vertexSize + elem.getOffset(), count * sizeof(float));
+                for (unsigned short c = 0; c < count; ++c)
+                {
+                    if (!(std::abs(Bitwise::halfToFloat(Bitwise::floatToHalf(values[c])) - values[c]) <=
+                          MeshQuantiser::MAX_TEXCOORD_ERROR))
+                        return false;
+                }
+            }
+            return true;
+        }
+
+        auto quantisedType(const VertexElement& elem, const MeshQuantiser::Options& options, bool convertNormals,
+                           const unsigned char* data, size_t vertexSize, size_t vertexCount) -> VertexElementType
+        {
+            using enum VertexElementType;
+            VertexElementType type = elem.getType();
+            switch (elem.getSemantic())
+            {
+            case VertexElementSemantic::NORMAL:
+            case VertexElementSemantic::BINORMAL:
+            case VertexElementSemantic::TANGENT:
+                // tangents may carry the handedness in w
+                if (convertNormals && options.normalType != FLOAT3 &&
+                    (type == FLOAT3 || (type == FLOAT4 && elem.getSemantic() == VertexElementSemantic::TANGENT)))
+                    return options.normalType;
+                break;
+            case VertexElementSemantic::TEXTURE_COORDINATES:
+                if (options.halfTexCoords && (type == FLOAT2 || type == FLOAT4) &&
+                    isHalfPrecise(elem, data, vertexSize, vertexCount))
+                    return type == FLOAT2 ? HALF2 : HALF4;
+                break;
+            default:
+                break;
+            }
+            return type;
+        }
+
+        void convertElement(const float* src, unsigned short srcCount, VertexElementType dstType, unsigned char* dst)
+        {
+            float w = srcCount == 4 ? src[3] : 1.0f;
+            switch (dstType)
+            {
+            case VertexElementType::INT_10_10_10_2_NORM:
+            {
+                uint32 packed = MeshQuantiser::packInt1010102(src[0], src[1], src[2], w);
+                std::memcpy(dst, &packed, sizeof(packed));
+                break;
+            }
+            case VertexElementType::SHORT4_NORM:
+            {
+                int16 packed[4] = {static_cast<int16>(packSnorm(src[0], 32767)), static_cast<int16>(packSnorm(src[1], 32767)),
+                                   static_cast<int16>(packSnorm(src[2], 32767)), static_cast<int16>(packSnorm(w, 32767))};
+                std::memcpy(dst, packed, sizeof(packed));
+                break;
+            }
+            case VertexElementType::HALF2:
+            case VertexElementType::HALF4:
+            {
+                uint16 packed[4];
+                for (unsigned short c = 0; c < srcCount; ++c)
+                    packed[c] = Bitwise::floatToHalf(src[c]);
+                std::memcpy(dst, packed, srcCount * sizeof(uint16));
+                break;
+            }
+            default:
+                OGRE_EXCEPT(ExceptionCodes::INVALIDPARAMS, "Unsupported quantised vertex element type",
+                            "MeshQuantiser::quantise");
+            }
+        }
+
+        auto vertexBufferBytes(const VertexData* vertexData) -> size_t
+        {
+            size_t bytes = 0;
+            if (vertexData)
+                for (const auto& [source, vbuf] : vertexData->vertexBufferBinding->getBindings())
+                    bytes += vbuf->getSizeInBytes();
+            return bytes;
+        }
+    }
+    //-----------------------------------------------------------------------
+    auto MeshQuantiser::packInt1010102(float x, float y, float z, float w) -> uint32
+    {
+        return (uint32(packSnorm(x, 511)) & 0x3FF) | ((uint32(packSnorm(y, 511)) & 0x3FF) << 10) |
+               ((uint32(packSnorm(z, 511)) & 0x3FF) << 20) | ((uint32(packSnorm(w, 1)) & 0x3) << 30);
+    }
+    //-----------------------------------------------------------------------
+    void MeshQuantiser::quantise(VertexData* vertexData, const Options& options, bool convertNormals,
+                                 HardwareBufferManagerBase* mgr)
+    {
+        HardwareBufferManagerBase* pManager = mgr ? mgr : HardwareBufferManager::getSingletonPtr();
+        VertexDeclaration* decl = vertexData->vertexDeclaration;
+        // a snapshot, the declaration is modified below
+        std::vector<VertexElement> elements{decl->getElements().begin(), decl->getElements().end()};
+
+        for (const auto& [source, vbuf] : vertexData->vertexBufferBinding->getBindings())
+        {
+            size_t vertexSize = vbuf->getVertexSize();
+            size_t vertexCount = vbuf->getNumVertices();
+            std::vector<unsigned char> data(vbuf->getSizeInBytes());
+            vbuf->readData(0, data.size(), data.data());
+
+            // the elements of this buffer in memory order, with their new types
+            std::vector<unsigned short> order;
+            for (unsigned short i = 0; i < elements.size(); ++i)
+                if (elements[i].getSource() == source)
+                    order.push_back(i);
+            std::ranges::sort(order, {}, [&](unsigned short i) { return elements[i].getOffset(); });
+
+            std::vector<VertexElementType> types(elements.size());
+            std::vector<size_t> offsets(elements.size());
+            bool changed = false;
+            size_t newVertexSize = 0;
+            for (unsigned short i : order)
+            {
+                types[i] = quantisedType(elements[i], options, convertNormals, data.data(), vertexSize, vertexCount);
+                changed = changed || types[i] != elements[i].getType();
+                offsets[i] = newVertexSize;
+                newVertexSize += VertexElement::getTypeSize(types[i]);
+            }
+            if (!changed)
+                continue;
+
+            std::vector<unsigned char> converted(newVertexSize * vertexCount);
+            for (size_t v = 0; v < vertexCount; ++v)
+            {
+                const unsigned char* src = data.data() + v * vertexSize;
+                unsigned char* dst = converted.data() + v * newVertexSize;
+                for (unsigned short i : order)
+                {
+                    const VertexElement& elem = elements[i];
+                    if (types[i] == elem.getType())
+                    {
+                        std::memcpy(dst + offsets[i], src + elem.getOffset(), elem.getSize());
+                        continue;
+                    }
+                    float values[4];
+                    unsigned short count = VertexElement::getTypeCount(elem.getType());
+                    std::memcpy(values, src + elem.getOffset(), count * sizeof(float));
+                    convertElement(values, count, types[i], dst + offsets[i]);
+                }
+            }
+
+            HardwareVertexBufferSharedPtr newBuffer = pManager->createVertexBuffer(
+                newVertexSize, vertexCount, vbuf->getUsage(), vbuf->hasShadowBuffer());
+            newBuffer->writeData(0, converted.size(), converted.data(), true);
+            vertexData->vertexBufferBinding->setBinding(source, newBuffer);
+
+            for (unsigned short i : order)
+                decl->modifyElement(i, source, offsets[i], types[i], elements[i].getSemantic(), elements[i].getIndex());
+        }
+    }
+    //-----------------------------------------------------------------------
+    auto MeshQuantiser::quantise(Mesh* mesh, const Options& options) -> Statistics
+    {
+        // software animation works on float normals
+        bool convertNormals = !mesh->hasSkeleton() && !mesh->hasVertexAnimation() && mesh->getPoseCount() == 0;
+
+        std::vector<VertexData*> vertexData;
+        if (mesh->sharedVertexData)
+            vertexData.push_back(mesh->sharedVertexData);
+        for (SubMesh* sub : mesh->getSubMeshes())
+            if (!sub->useSharedVertices && sub->vertexData)
+                vertexData.push_back(sub->vertexData.get());
+
+        Statistics stats;
+        for (VertexData* data : vertexData)
+        {
+            stats.bytesBefore += vertexBufferBytes(data);
+            quantise(data, options, convertNormals, mesh->getHardwareBufferManager());
+            stats.bytesAfter += vertexBufferBytes(data);
+        }
+
+        LogManager::getSingleton().logMessage(::std::format("Mesh: Quantised {}, vertex buffers {} -> {} bytes",
+                                                            mesh->getName(), stats.bytesBefore, stats.bytesAfter));
+        return stats;
+    }
+}
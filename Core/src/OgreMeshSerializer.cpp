@@ -56,11 +56,15 @@ namespace Ogre {
         
         // Note MUST be added in reverse order so latest is first in the list
 
+        mVersionData.push_back(::std::make_unique<MeshVersionData>(
+            MeshVersion::_1_11, "[MeshSerializer_v1.110]",
+            ::std::make_unique<MeshSerializerImpl>()));
+
         // This one is a little ugly, 1.10 is used for version 1.1 legacy meshes.
         // So bump up to 1.100
         mVersionData.push_back(::std::make_unique<MeshVersionData>(
             MeshVersion::_1_10, "[MeshSerializer_v1.100]",
-            ::std::make_unique<MeshSerializerImpl>()));
+            ::std::make_unique<MeshSerializerImpl_v1_10>()));
 
         mVersionData.push_back(::std::make_unique<MeshVersionData>(
             MeshVersion::_1_8, "[MeshSerializer_v1.8]",
@@ -180,8 +184,8 @@ namespace Ogre {
         
         // Call implementation
         impl->importMesh(stream, pDest, mListener);
-        // Warn on old version of mesh
-        if (ver != mVersionData[0]->versionString)
+        // Warn on old version of mesh, v1.100 only lacks the alignment and is fine
+        if (ver != mVersionData[0]->versionString && ver != mVersionData[1]->versionString)
         {
             LogManager::getSingleton().logWarning(
                 ::std::format("{} uses an old format {}; upgrade with the OgreMeshUpgrader tool",
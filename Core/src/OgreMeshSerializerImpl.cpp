@@ -75,11 +75,13 @@ namespace Ogre {
 
     /// stream overhead = ID + size
     const long MSTREAM_OVERHEAD_SIZE = sizeof(uint16) + sizeof(uint32);
+    /// padding around aligned vertex data, enough for any mVertexDataAlignment
+    const char ZERO_PADDING[16] = {};
     //---------------------------------------------------------------------
     MeshSerializerImpl::MeshSerializerImpl()
     {
         // Version number
-        mVersion = "[MeshSerializer_v1.100]";
+        mVersion = "[MeshSerializer_v1.110]";
     }
     //---------------------------------------------------------------------
     MeshSerializerImpl::~MeshSerializerImpl()
@@ -474,10 +476,18 @@ namespace Ogre {
                 pushInnerChunk(mStream);
                 {
                     // Data
-                    size = MSTREAM_OVERHEAD_SIZE + vbufSizeInBytes;
+                    size = MSTREAM_OVERHEAD_SIZE + vbufSizeInBytes + mVertexDataAlignment;
                     writeChunkHeader(std::to_underlying(MeshChunkID::GEOMETRY_VERTEX_BUFFER_DATA), size);
                     HardwareBufferLockGuard vbufLock(vbuf, HardwareBuffer::LockOptions::READ_ONLY);
 
+                    uint8 padding = 0;
+                    if (mVertexDataAlignment)
+                    {
+                        padding = uint8((mVertexDataAlignment - (mStream->tell() + 1) % mVertexDataAlignment) % mVertexDataAlignment);
+                        writeData(&padding, 1, 1);
+                        writeData(ZERO_PADDING, 1, padding);
+                    }
+
                     if (mFlipEndian)
                     {
                         // endian conversion
@@ -496,6 +506,10 @@ namespace Ogre {
                     {
                         writeData(vbufLock.pData, vbuf->getVertexSize(), vertexData->vertexCount);
                     }
+
+                    // keep the chunk size independent of the position
+                    if (mVertexDataAlignment)
+                        writeData(ZERO_PADDING, 1, mVertexDataAlignment - 1 - padding);
                 }
                 popInnerChunk(mStream);
             }
@@ -656,7 +670,7 @@ namespace Ogre {
         size += MSTREAM_OVERHEAD_SIZE + elemList.size() * (MSTREAM_OVERHEAD_SIZE + sizeof(unsigned short)* 5);
         
         // Buffers and bindings
-        size += bindings.size() * ((MSTREAM_OVERHEAD_SIZE * 2) + (sizeof(unsigned short)* 2));
+        size += bindings.size() * ((MSTREAM_OVERHEAD_SIZE * 2) + (sizeof(unsigned short)* 2) + mVertexDataAlignment);
 
         // Buffer data
         for (auto const& [key, vbuf] : bindings)
@@ -807,6 +821,13 @@ namespace Ogre {
                 "MeshSerializerImpl::readGeometryVertexBuffer");
         }
 
+        uint8 padding = 0;
+        if (mVertexDataAlignment)
+        {
+            stream->read(&padding, 1);
+            stream->skip(padding);
+        }
+
         // Create / populate vertex buffer
         HardwareVertexBufferSharedPtr vbuf;
         vbuf = pMesh->getHardwareBufferManager()->createVertexBuffer(
@@ -814,15 +835,30 @@ namespace Ogre {
             dest->vertexCount,
             pMesh->mVertexBufferUsage,
             pMesh->mVertexBufferShadowBuffer);
-        HardwareBufferLockGuard vbufLock(vbuf, HardwareBuffer::LockOptions::DISCARD);
-        stream->read(vbufLock.pData, dest->vertexCount * vertexSize);
+        size_t size = dest->vertexCount * vertexSize;
 
-        // endian conversion for OSX
-        flipFromLittleEndian(
-            vbufLock.pData,
-            dest->vertexCount,
-            vertexSize,
-            dest->vertexDeclaration->findElementsBySource(bindIndex));
+        auto memStream = dynamic_cast<MemoryDataStream*>(stream.get());
+        if (memStream && !mFlipEndian && size <= memStream->size() - memStream->tell())
+        {
+            // upload straight from the file data, which the buffer may do without locking
+            vbuf->writeData(0, size, memStream->getCurrentPtr(), true);
+            stream->skip(long(size));
+        }
+        else
+        {
+            HardwareBufferLockGuard vbufLock(vbuf, HardwareBuffer::LockOptions::DISCARD);
+            stream->read(vbufLock.pData, size);
+
+            // endian conversion for OSX
+            flipFromLittleEndian(
+                vbufLock.pData,
+                dest->vertexCount,
+                vertexSize,
+                dest->vertexDeclaration->findElementsBySource(bindIndex));
+        }
+
+        if (mVertexDataAlignment)
+            stream->skip(long(mVertexDataAlignment - 1 - padding));
 
         // Set binding
         dest->vertexBufferBinding->setBinding(bindIndex, vbuf);
@@ -1600,8 +1636,12 @@ namespace Ogre {
                         typeSize = sizeof(int);
                         break;
                     case UINT1:
+                    case INT_10_10_10_2_NORM:
                         typeSize = sizeof(unsigned int);
                         break;
+                    case HALF2:
+                        typeSize = sizeof(uint16);
+                        break;
                     case UBYTE4_NORM:
                     case UBYTE4:
                         typeSize = 0; // NO FLIPPING
@@ -1609,8 +1649,9 @@ namespace Ogre {
                     default:
                         assert(false); // Should never happen
                 };
+				// packed types are a single chunk
 				Bitwise::bswapChunks(pElem, typeSize,
-                    VertexElement::getTypeCount(elem.getType()));
+                    typeSize ? elem.getSize() / typeSize : 0);
 
             }
 
@@ -2634,10 +2675,19 @@ namespace Ogre {
     //---------------------------------------------------------------------
     //---------------------------------------------------------------------
     //---------------------------------------------------------------------
+    MeshSerializerImpl_v1_10::MeshSerializerImpl_v1_10()
+    {
+        // Version number
+        mVersion = "[MeshSerializer_v1.100]";
+        mVertexDataAlignment = 0;
+    }
+    //---------------------------------------------------------------------
+    //---------------------------------------------------------------------
     MeshSerializerImpl_v1_8::MeshSerializerImpl_v1_8()
     {
         // Version number
         mVersion = "[MeshSerializer_v1.8]";
+        mVertexDataAlignment = 0;
     }
     //---------------------------------------------------------------------
     MeshSerializerImpl_v1_8::~MeshSerializerImpl_v1_8()
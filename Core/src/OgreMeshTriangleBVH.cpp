@@ -0,0 +1,274 @@
+// This file is part of the OGRE project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at https://www.ogre3d.org/licensing.
+module;
+
+#include <cstddef>
+
+module Ogre.Core;
+
+import :HardwareBuffer;
+import :HardwareIndexBuffer;
+import :HardwareVertexBuffer;
+import :Math;
+import :Mesh;
+import :MeshTriangleBVH;
+import :OptimisedUtil;
+import :Platform;
+import :Ray;
+import :RenderOperation;
+import :SubMesh;
+import :Vector;
+import :VertexIndexData;
+
+import <algorithm>;
+import <array>;
+import <utility>;
+import <vector>;
+
+namespace Ogre {
+
+namespace {
+    /// Distance along the ray to the box of a node, or POS_INFINITY if missed
+    auto intersectsBox(const Vector3& origin, const Vector3& inverse, const std::array<Real, 3>& min,
+                       const std::array<Real, 3>& max) -> Real
+    {
+        Real tNear = 0;
+        Real tFar = Math::POS_INFINITY;
+        for (size_t axis = 0; axis < 3; ++axis)
+        {
+            Real t1 = (min[axis] - origin[axis]) * inverse[axis];
+            Real t2 = (max[axis] - origin[axis]) * inverse[axis];
+            tNear = std::max(tNear, std::min(t1, t2));
+            tFar = std::min(tFar, std::max(t1, t2));
+        }
+        return tNear <= tFar ? tNear : Math::POS_INFINITY;
+    }
+}
+    //---------------------------------------------------------------------
+    MeshTriangleBVH::MeshTriangleBVH(const Mesh& mesh)
+    {
+        std::vector<Vector3> vertices;
+        for (uint32 subIndex = 0; subIndex < mesh.getNumSubMeshes(); ++subIndex)
+        {
+            const SubMesh* sub = mesh.getSubMesh(subIndex);
+            const VertexData* vertexData = sub->useSharedVertices ? mesh.sharedVertexData : sub->vertexData.get();
+            const IndexData* indexData = sub->indexData.get();
+            if (!vertexData)
+                continue;
+
+            bool indexed = indexData && indexData->indexCount > 0;
+            size_t count = indexed ? indexData->indexCount : vertexData->vertexCount;
+            size_t iterations;
+
+            using enum RenderOperation::OperationType;
+            switch (sub->operationType)
+            {
+            case TRIANGLE_LIST:
+                iterations = count / 3;
+                break;
+            case TRIANGLE_FAN:
+            case TRIANGLE_STRIP:
+                iterations = count < 2 ? 0 : count - 2;
+                break;
+            default:
+                continue; // nothing a ray could hit
+            };
+
+            // locate position element & the buffer to go with it
+            const VertexElement* posElem =
+                vertexData->vertexDeclaration->findElementBySemantic(VertexElementSemantic::POSITION);
+            if (!posElem || iterations == 0)
+                continue;
+            HardwareVertexBufferSharedPtr vbuf = vertexData->vertexBufferBinding->getBuffer(posElem->getSource());
+            HardwareBufferLockGuard vertexLock(vbuf, HardwareBuffer::LockOptions::READ_ONLY);
+            auto* pBaseVertex = static_cast<unsigned char*>(vertexLock.pData) +
+                vertexData->vertexStart * vbuf->getVertexSize();
+
+            HardwareBufferLockGuard indexLock;
+            bool idx32bit = false;
+            if (indexed)
+            {
+                idx32bit = indexData->indexBuffer->getType() == HardwareIndexBuffer::IndexType::_32BIT;
+                indexLock.lock(indexData->indexBuffer.get(), HardwareBuffer::LockOptions::READ_ONLY);
+            }
+            auto* p16Idx = static_cast<unsigned short*>(indexLock.pData) + (indexed ? indexData->indexStart : 0);
+            auto* p32Idx = static_cast<unsigned int*>(indexLock.pData) + (indexed ? indexData->indexStart : 0);
+
+            auto position = [&](size_t i) -> Vector3
+            {
+                size_t vertex = !indexed ? i : idx32bit ? p32Idx[i] : p16Idx[i];
+                float* pFloat;
+                posElem->baseVertexPointerToElement(pBaseVertex + vertex * vbuf->getVertexSize(), &pFloat);
+                return {pFloat[0], pFloat[1], pFloat[2]};
+            };
+
+            vertices.reserve(vertices.size() + iterations * 3);
+            for (size_t t = 0; t < iterations; ++t)
+            {
+                switch (sub->operationType)
+                {
+                case TRIANGLE_LIST:
+                    vertices.push_back(position(t * 3));
+                    vertices.push_back(position(t * 3 + 1));
+                    vertices.push_back(position(t * 3 + 2));
+                    break;
+                case TRIANGLE_FAN:
+                    vertices.push_back(position(0));
+                    vertices.push_back(position(t + 1));
+                    vertices.push_back(position(t + 2));
+                    break;
+                default:
+                    // every other triangle of a strip is wound the other way round
+                    vertices.push_back(position(t));
+                    vertices.push_back(position(t % 2 ? t + 2 : t + 1));
+                    vertices.push_back(position(t % 2 ? t + 1 : t + 2));
+                    break;
+                }
+                mSubMeshes.push_back(subIndex);
+                mTriangleIndices.push_back(static_cast<uint32>(t));
+            }
+        }
+
+        auto numTriangles = static_cast<uint32>(mTriangleIndices.size());
+        if (numTriangles == 0)
+            return;
+
+        std::vector<uint32> order(numTriangles);
+        for (uint32 i = 0; i < numTriangles; ++i)
+            order[i] = i;
+        mNodes.push_back({});
+        build(0, 0, numTriangles, order, vertices);
+
+        // the triangles in the order of the leaves
+        for (auto& array : mTriangles)
+            array.resize(numTriangles);
+        std::vector<uint32> subMeshes(numTriangles), triangleIndices(numTriangles);
+        for (uint32 i = 0; i < numTriangles; ++i)
+        {
+            const Vector3& a = vertices[order[i] * 3];
+            Vector3 e1 = vertices[order[i] * 3 + 1] - a;
+            Vector3 e2 = vertices[order[i] * 3 + 2] - a;
+            for (size_t axis = 0; axis < 3; ++axis)
+            {
+                mTriangles[axis][i] = a[axis];
+                mTriangles[3 + axis][i] = e1[axis];
+                mTriangles[6 + axis][i] = e2[axis];
+            }
+            subMeshes[i] = mSubMeshes[order[i]];
+            triangleIndices[i] = mTriangleIndices[order[i]];
+        }
+        mSubMeshes.swap(subMeshes);
+        mTriangleIndices.swap(triangleIndices);
+    }
+    //---------------------------------------------------------------------
+    void MeshTriangleBVH::build(uint32 node, uint32 begin, uint32 end, std::vector<uint32>& order,
+                                const std::vector<Vector3>& vertices)
+    {
+        Vector3 min{Math::POS_INFINITY}, max{Math::NEG_INFINITY};
+        Vector3 centroidMin{Math::POS_INFINITY}, centroidMax{Math::NEG_INFINITY};
+        for (uint32 i = begin; i < end; ++i)
+        {
+            const Vector3* v = &vertices[order[i] * 3];
+            for (size_t corner = 0; corner < 3; ++corner)
+            {
+                min.makeFloor(v[corner]);
+                max.makeCeil(v[corner]);
+            }
+            Vector3 centroid = (v[0] + v[1] + v[2]) / 3;
+            centroidMin.makeFloor(centroid);
+            centroidMax.makeCeil(centroid);
+        }
+        mNodes[node].min = {min.x, min.y, min.z};
+        mNodes[node].max = {max.x, max.y, max.z};
+
+        if (end - begin <= MAX_LEAF_TRIANGLES)
+        {
+            mNodes[node].first = begin;
+            mNodes[node].count = end - begin;
+            return;
+        }
+
+        // halve the triangles along the longest extent of their centroids
+        Vector3 extent = centroidMax - centroidMin;
+        size_t axis = extent.x >= extent.y && extent.x >= extent.z ? 0 : extent.y >= extent.z ? 1 : 2;
+        uint32 middle = begin + (end - begin) / 2;
+        std::nth_element(order.begin() + begin, order.begin() + middle, order.begin() + end,
+                         [&](uint32 l, uint32 r)
+                         {
+                             const Vector3* a = &vertices[l * 3];
+                             const Vector3* b = &vertices[r * 3];
+                             return a[0][axis] + a[1][axis] + a[2][axis] < b[0][axis] + b[1][axis] + b[2][axis];
+                         });
+
+        auto left = static_cast<uint32>(mNodes.size());
+        mNodes[node].first = left;
+        mNodes[node].count = 0;
+        mNodes.resize(mNodes.size() + 2);
+        build(left, begin, middle, order, vertices);
+        build(left + 1, middle, end, order, vertices);
+    }
+    //---------------------------------------------------------------------
+    auto MeshTriangleBVH::intersects(const Ray& ray, bool positiveSide, bool negativeSide) const -> Hit
+    {
+        Hit hit;
+        if (mNodes.empty())
+            return hit;
+
+        const Vector3& origin = ray.getOrigin();
+        const Vector3& direction = ray.getDirection();
+        Vector3 inverse{OptimisedUtil::_slabInverse(direction.x), OptimisedUtil::_slabInverse(direction.y),
+                        OptimisedUtil::_slabInverse(direction.z)};
+
+        // nodes to visit with the distance to their box, the nearest on top; the depth is
+        // logarithmic as the triangles are halved at every level
+        std::array<std::pair<uint32, Real>, 64> stack;
+        size_t stackSize = 0;
+        Real rootDistance = intersectsBox(origin, inverse, mNodes[0].min, mNodes[0].max);
+        if (rootDistance < Math::POS_INFINITY)
+            stack[stackSize++] = {0, rootDistance};
+
+        std::array<Real, MAX_LEAF_TRIANGLES> distances;
+        while (stackSize > 0)
+        {
+            auto [index, boxDistance] = stack[--stackSize];
+            if (boxDistance > hit.distance)
+                continue;
+
+            const Node& node = mNodes[index];
+            if (node.count > 0)
+            {
+                Math::TriangleArrays triangles{
+                    &mTriangles[0][node.first], &mTriangles[1][node.first], &mTriangles[2][node.first],
+                    &mTriangles[3][node.first], &mTriangles[4][node.first], &mTriangles[5][node.first],
+                    &mTriangles[6][node.first], &mTriangles[7][node.first], &mTriangles[8][node.first]};
+                Math::intersects(ray, triangles, node.count, distances.data(), positiveSide, negativeSide);
+                for (uint32 i = 0; i < node.count; ++i)
+                {
+                    if (distances[i] < hit.distance)
+                    {
+                        hit.hit = true;
+                        hit.distance = distances[i];
+                        hit.subMesh = mSubMeshes[node.first + i];
+                        hit.triangle = mTriangleIndices[node.first + i];
+                    }
+                }
+                continue;
+            }
+
+            Real near = intersectsBox(origin, inverse, mNodes[node.first].min, mNodes[node.first].max);
+            Real far = intersectsBox(origin, inverse, mNodes[node.first + 1].min, mNodes[node.first + 1].max);
+            uint32 nearChild = node.first, farChild = node.first + 1;
+            if (far < near)
+            {
+                std::swap(near, far);
+                std::swap(nearChild, farChild);
+            }
+            if (far < hit.distance)
+                stack[stackSize++] = {farChild, far};
+            if (near < hit.distance)
+                stack[stackSize++] = {nearChild, near};
+        }
+        return hit;
+    }
+}
@@ -134,6 +134,10 @@ namespace Ogre {
         mParentNode = parent;
         mParentIsTagPoint = isTagPoint;
 
+        // the renderables may be queued for reuse by the scene
+        if (mManager && different)
+            mManager->_notifyVisibleObjectsChanged();
+
         // Mark light list being dirty, simply decrease
         // counter by one for minimise overhead
         --mLightListUpdated;
@@ -44,8 +44,10 @@ import :Quaternion;
 import :Vector;
 
 import <algorithm>;
+import <atomic>;
 import <format>;
 import <memory>;
+import <mutex>;
 import <set>;
 import <string>;
 import <string_view>;
@@ -54,7 +56,15 @@ import <vector>;
 
 namespace Ogre {
 
+namespace {
+    auto toDouble(const Vector3& v) -> Vector3d { return {v.x, v.y, v.z}; }
+    auto toReal(const Vector3d& v) -> Vector3 { return {Real(v[0]), Real(v[1]), Real(v[2])}; }
+}
+
     Node::QueuedUpdates Node::msQueuedUpdates;
+    thread_local size_t Node::msThreadUpdateCount = 0;
+    thread_local size_t Node::msThreadVisitCount = 0;
+    std::atomic<uint64> Node::msHierarchyVersion = 0;
     //-----------------------------------------------------------------------
     Node::Node() : Node(BLANKSTRING) {}
     //-----------------------------------------------------------------------
@@ -64,7 +74,6 @@ namespace Ogre {
         mNeedParentUpdate(false),
         mNeedChildUpdate(false),
         mParentNotified(false),
-        mQueuedForUpdate(false),
         mInheritOrientation(true),
         mInheritScale(true),
         mCachedTransformOutOfDate(true),
@@ -95,26 +104,16 @@ namespace Ogre {
         if(mParent)
             mParent->removeChild(this);
 
-        if (mQueuedForUpdate)
-        {
-            // Erase from queued updates
-            auto it =
-                std::ranges::find(msQueuedUpdates, this);
-            assert(it != msQueuedUpdates.end());
-            if (it != msQueuedUpdates.end())
-            {
-                // Optimised algorithm to erase an element from unordered vector.
-                *it = msQueuedUpdates.back();
-                msQueuedUpdates.pop_back();
-            }
-        }
-
+        if (mQueuedUpdates)
+            mQueuedUpdates->remove(this);
     }
 
     //-----------------------------------------------------------------------
     void Node::setParent(Node* parent)
     {
         bool different = (parent != mParent);
+        if (different)
+            msHierarchyVersion.fetch_add(1, std::memory_order_relaxed);
 
         mParent = parent;
         // Request update from parent
@@ -153,11 +152,18 @@ namespace Ogre {
         // always clear information about parent notification
         mParentNotified = false;
 
+        // Nothing in this subtree has moved
+        if (!parentHasChanged && !_isUpdatePending())
+            return;
+
+        ++msThreadVisitCount;
+
         // See if we should process everyone
         if (mNeedParentUpdate || parentHasChanged)
         {
             // Update transforms from parent
             _updateFromParent();
+            ++msThreadUpdateCount;
         }
 
         if(updateChildren)
@@ -184,9 +190,37 @@ namespace Ogre {
         }
     }
     //-----------------------------------------------------------------------
+    void Node::_updateSelf(bool parentHasChanged, std::vector<PendingChildUpdate>& children)
+    {
+        // same as _update, but hand the children to the caller
+        mParentNotified = false;
+        ++msThreadVisitCount;
+
+        if (mNeedParentUpdate || parentHasChanged)
+        {
+            _updateFromParent();
+            ++msThreadUpdateCount;
+        }
+
+        if (mNeedChildUpdate || parentHasChanged)
+        {
+            for (auto child : mChildren)
+                children.emplace_back(child, true);
+        }
+        else
+        {
+            for (auto child : mChildrenToUpdate)
+                children.emplace_back(child, false);
+        }
+
+        mChildrenToUpdate.clear();
+        mNeedChildUpdate = false;
+    }
+    //-----------------------------------------------------------------------
     void Node::_updateFromParent() const
     {
         updateFromParentImpl();
+        derivedTransformUpdated();
 
         // Call listener (note, this method only called if there's something to do)
         if (mListener)
@@ -228,17 +262,21 @@ namespace Ogre {
                 mDerivedScale = mScale;
             }
 
-            // Change position vector based on parent's orientation & scale
-            mDerivedPosition = parentOrientation * (parentScale * mPosition);
+            // Change position vector based on parent's orientation & scale, exact if neither applies
+            Vector3d offset = parentOrientation == Quaternion::IDENTITY && parentScale == Vector3::UNIT_SCALE
+                ? mPositionDouble
+                : toDouble(parentOrientation * (parentScale * mPosition));
 
             // Add altered position vector to parents
-            mDerivedPosition += mParent->_getDerivedPosition();
+            mDerivedPositionDouble = mParent->_getDerivedPositionDouble() + offset;
+            mDerivedPosition = toReal(mDerivedPositionDouble);
         }
         else
         {
             // Root node, no parent
             mDerivedOrientation = mOrientation;
             mDerivedPosition = mPosition;
+            mDerivedPositionDouble = mPositionDouble;
             mDerivedScale = mScale;
         }
 
@@ -351,6 +389,15 @@ namespace Ogre {
     {
         assert(!pos.isNaN() && "Invalid vector supplied as parameter");
         mPosition = pos;
+        mPositionDouble = toDouble(pos);
+        needUpdate();
+    }
+    //-----------------------------------------------------------------------
+    void Node::setPositionDouble(const Vector3d& pos)
+    {
+        assert(!toReal(pos).isNaN() && "Invalid vector supplied as parameter");
+        mPositionDouble = pos;
+        mPosition = toReal(pos);
         needUpdate();
     }
 
@@ -366,27 +413,31 @@ namespace Ogre {
     void Node::translate(const Vector3& d, TransformSpace relativeTo)
     {
         using enum TransformSpace;
+        Vector3 delta;
         switch(relativeTo)
         {
         case LOCAL:
             // position is relative to parent so transform downwards
-            mPosition += mOrientation * d;
+            delta = mOrientation * d;
             break;
         case WORLD:
             // position is relative to parent so transform upwards
             if (mParent)
             {
-                mPosition += mParent->convertWorldToLocalDirection(d, true);
+                delta = mParent->convertWorldToLocalDirection(d, true);
             }
             else
             {
-                mPosition += d;
+                delta = d;
             }
             break;
         case PARENT:
-            mPosition += d;
+            delta = d;
             break;
         }
+        // accumulated in double precision, see setPositionDouble
+        mPositionDouble += toDouble(delta);
+        mPosition = toReal(mPositionDouble);
         needUpdate();
 
     }
@@ -452,6 +503,15 @@ namespace Ogre {
         return mDerivedPosition;
     }
     //-----------------------------------------------------------------------
+    auto Node::_getDerivedPositionDouble() const -> const Vector3d &
+    {
+        if (mNeedParentUpdate)
+        {
+            _updateFromParent();
+        }
+        return mDerivedPositionDouble;
+    }
+    //-----------------------------------------------------------------------
     auto Node::_getDerivedScale() const -> const Vector3 &
     {
         if (mNeedParentUpdate)
@@ -575,6 +635,7 @@ namespace Ogre {
     void Node::resetToInitialState()
     {
         mPosition = mInitialPosition;
+        mPositionDouble = toDouble(mInitialPosition);
         mOrientation = mInitialOrientation;
         mScale = mInitialScale;
 
@@ -686,23 +747,49 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     void Node::queueNeedUpdate(Node* n)
     {
+        n->getQueuedUpdates()->push(n);
+    }
+    //-----------------------------------------------------------------------
+    void Node::processQueuedUpdates()
+    {
+        msQueuedUpdates.process();
+    }
+    //-----------------------------------------------------------------------
+    void Node::QueuedUpdates::push(Node* n)
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
         // Don't queue the node more than once
-        if (!n->mQueuedForUpdate)
+        if (!n->mQueuedUpdates)
         {
-            n->mQueuedForUpdate = true;
-            msQueuedUpdates.push_back(n);
+            n->mQueuedUpdates = this;
+            mNodes.push_back(n);
         }
     }
     //-----------------------------------------------------------------------
-    void Node::processQueuedUpdates()
+    void Node::QueuedUpdates::remove(Node* n)
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        auto it = std::ranges::find(mNodes, n);
+        assert(it != mNodes.end());
+        if (it != mNodes.end())
+        {
+            // Optimised algorithm to erase an element from unordered vector.
+            *it = mNodes.back();
+            mNodes.pop_back();
+        }
+        n->mQueuedUpdates = nullptr;
+    }
+    //-----------------------------------------------------------------------
+    void Node::QueuedUpdates::process()
     {
-        for (auto n : msQueuedUpdates)
+        std::unique_lock<std::mutex> lock(mMutex);
+        for (auto n : mNodes)
         {
             // Update, and force parent update since chances are we've ended
             // up with some mixed state in there due to re-entrancy
-            n->mQueuedForUpdate = false;
+            n->mQueuedUpdates = nullptr;
             n->needUpdate(true);
         }
-        msQueuedUpdates.clear();
+        mNodes.clear();
     }
 }
@@ -0,0 +1,275 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+module;
+
+#include <cstddef>
+
+module Ogre.Core;
+
+import :Node;
+import :NodeTransformSoA;
+import :Platform;
+import :Quaternion;
+import :Vector;
+
+import <algorithm>;
+import <initializer_list>;
+import <utility>;
+import <vector>;
+
+namespace Ogre {
+
+    namespace {
+        auto paddedSize(size_t size) -> size_t
+        {
+            return (size + NodeTransformSoA::BLOCK_SIZE - 1) & ~(NodeTransformSoA::BLOCK_SIZE - 1);
+        }
+    }
+    //-----------------------------------------------------------------------
+    void NodeTransformSoA::TransformArrays::resize(size_t size)
+    {
+        for (auto* a : {&posX, &posY, &posZ, &rotW, &rotX, &rotY, &rotZ, &sclX, &sclY, &sclZ})
+            a->resize(size);
+    }
+    //-----------------------------------------------------------------------
+    void NodeTransformSoA::build(Node* root)
+    {
+        clear();
+        if (!root)
+            return;
+
+        mRoot = root;
+        mHierarchyVersion = Node::_getHierarchyVersion();
+
+        mNodes.push_back(root);
+        mParents.push_back(0);
+        mLevels.push_back(0);
+
+        size_t levelBegin = 0;
+        while (levelBegin < mNodes.size())
+        {
+            // pad the level, so every block of the next one starts aligned
+            size_t levelEnd = paddedSize(mNodes.size());
+            mNodes.resize(levelEnd, nullptr);
+            mParents.resize(levelEnd, 0);
+            mLevels.push_back(levelEnd);
+
+            for (size_t i = levelBegin; i < levelEnd; ++i)
+            {
+                if (!mNodes[i])
+                    continue;
+                for (auto child : mNodes[i]->getChildren())
+                {
+                    mNodes.push_back(child);
+                    mParents.push_back(static_cast<uint32>(i));
+                }
+            }
+            levelBegin = levelEnd;
+        }
+
+        for (auto n : mNodes)
+            mNumNodes += n != nullptr;
+
+        mInheritOrientation.resize(mNodes.size());
+        mInheritScale.resize(mNodes.size());
+        mLocal.resize(mNodes.size());
+        mDerived.resize(mNodes.size());
+    }
+    //-----------------------------------------------------------------------
+    void NodeTransformSoA::clear()
+    {
+        mRoot = nullptr;
+        mHierarchyVersion = 0;
+        mNumNodes = 0;
+        mNodes.clear();
+        mParents.clear();
+        mLevels.clear();
+        mInheritOrientation.clear();
+        mInheritScale.clear();
+        mLocal.resize(0);
+        mDerived.resize(0);
+        mParentDerived.resize(0);
+    }
+    //-----------------------------------------------------------------------
+    auto NodeTransformSoA::update() -> size_t
+    {
+        if (!mRoot ||
+            !(mRoot->mNeedParentUpdate || mRoot->mNeedChildUpdate || !mRoot->mChildrenToUpdate.empty()))
+            return 0;
+
+        gatherLocal();
+
+        // the base of the hierarchy, identity unless packing a subtree
+        Quaternion baseOrientation = Quaternion::IDENTITY;
+        Vector3 basePosition = Vector3::ZERO;
+        Vector3 baseScale = Vector3::UNIT_SCALE;
+        if (Node* parent = mRoot->getParent())
+        {
+            baseOrientation = parent->_getDerivedOrientation();
+            basePosition = parent->_getDerivedPosition();
+            baseScale = parent->_getDerivedScale();
+        }
+
+        size_t maxLevelSize = 0;
+        for (size_t l = 0; l < getNumLevels(); ++l)
+            maxLevelSize = std::max(maxLevelSize, mLevels[l + 1] - mLevels[l]);
+        mParentDerived.resize(maxLevelSize);
+
+        for (size_t l = 0; l < getNumLevels(); ++l)
+        {
+            size_t begin = mLevels[l], end = mLevels[l + 1];
+            auto& p = mParentDerived;
+            if (l == 0)
+            {
+                for (size_t i = 0; i < end; ++i)
+                {
+                    p.posX[i] = basePosition.x; p.posY[i] = basePosition.y; p.posZ[i] = basePosition.z;
+                    p.rotW[i] = baseOrientation.w; p.rotX[i] = baseOrientation.x;
+                    p.rotY[i] = baseOrientation.y; p.rotZ[i] = baseOrientation.z;
+                    p.sclX[i] = baseScale.x; p.sclY[i] = baseScale.y; p.sclZ[i] = baseScale.z;
+                }
+            }
+            else
+            {
+                // gather the parents, so the level can be processed as straight arrays
+                const auto& d = mDerived;
+                for (size_t i = begin; i < end; ++i)
+                {
+                    size_t j = i - begin, s = mParents[i];
+                    p.posX[j] = d.posX[s]; p.posY[j] = d.posY[s]; p.posZ[j] = d.posZ[s];
+                    p.rotW[j] = d.rotW[s]; p.rotX[j] = d.rotX[s]; p.rotY[j] = d.rotY[s]; p.rotZ[j] = d.rotZ[s];
+                    p.sclX[j] = d.sclX[s]; p.sclY[j] = d.sclY[s]; p.sclZ[j] = d.sclZ[s];
+                }
+            }
+            computeLevel(begin, end);
+        }
+
+        scatterDerived();
+        return mNumNodes;
+    }
+    //-----------------------------------------------------------------------
+    void NodeTransformSoA::gatherLocal()
+    {
+        for (size_t i = 0; i < mNodes.size(); ++i)
+        {
+            const Node* n = mNodes[i];
+            if (!n)
+            {
+                // padding lanes compute an identity transform
+                mLocal.posX[i] = 0; mLocal.posY[i] = 0; mLocal.posZ[i] = 0;
+                mLocal.rotW[i] = 1; mLocal.rotX[i] = 0; mLocal.rotY[i] = 0; mLocal.rotZ[i] = 0;
+                mLocal.sclX[i] = 1; mLocal.sclY[i] = 1; mLocal.sclZ[i] = 1;
+                mInheritOrientation[i] = 1;
+                mInheritScale[i] = 1;
+                continue;
+            }
+
+            mLocal.posX[i] = n->mPosition.x; mLocal.posY[i] = n->mPosition.y; mLocal.posZ[i] = n->mPosition.z;
+            mLocal.rotW[i] = n->mOrientation.w; mLocal.rotX[i] = n->mOrientation.x;
+            mLocal.rotY[i] = n->mOrientation.y; mLocal.rotZ[i] = n->mOrientation.z;
+            mLocal.sclX[i] = n->mScale.x; mLocal.sclY[i] = n->mScale.y; mLocal.sclZ[i] = n->mScale.z;
+            mInheritOrientation[i] = n->mInheritOrientation;
+            mInheritScale[i] = n->mInheritScale;
+        }
+    }
+    //-----------------------------------------------------------------------
+    void NodeTransformSoA::computeLevel(size_t begin, size_t end)
+    {
+        // Same combination as Node::updateFromParentImpl, BLOCK_SIZE lanes at a time.
+        // The lane loop has a constant trip count and no branches, so it is vectorised.
+        const auto& l = mLocal;
+        const auto& p = mParentDerived;
+        auto& d = mDerived;
+
+        for (size_t block = begin; block < end; block += BLOCK_SIZE)
+        {
+            for (size_t lane = 0; lane < BLOCK_SIZE; ++lane)
+            {
+                size_t i = block + lane, j = i - begin;
+
+                // orientation
+                Real pw = p.rotW[j], px = p.rotX[j], py = p.rotY[j], pz = p.rotZ[j];
+                Real lw = l.rotW[i], lx = l.rotX[i], ly = l.rotY[i], lz = l.rotZ[i];
+                Real qw = pw * lw - px * lx - py * ly - pz * lz;
+                Real qx = pw * lx + px * lw + py * lz - pz * ly;
+                Real qy = pw * ly + py * lw + pz * lx - px * lz;
+                Real qz = pw * lz + pz * lw + px * ly - py * lx;
+                bool inheritOrientation = mInheritOrientation[i];
+                d.rotW[i] = inheritOrientation ? qw : lw;
+                d.rotX[i] = inheritOrientation ? qx : lx;
+                d.rotY[i] = inheritOrientation ? qy : ly;
+                d.rotZ[i] = inheritOrientation ? qz : lz;
+
+                // scale
+                Real psx = p.sclX[j], psy = p.sclY[j], psz = p.sclZ[j];
+                bool inheritScale = mInheritScale[i];
+                d.sclX[i] = inheritScale ? psx * l.sclX[i] : l.sclX[i];
+                d.sclY[i] = inheritScale ? psy * l.sclY[i] : l.sclY[i];
+                d.sclZ[i] = inheritScale ? psz * l.sclZ[i] : l.sclZ[i];
+
+                // position, parentOrientation * (parentScale * position) + parentPosition
+                Real vx = psx * l.posX[i], vy = psy * l.posY[i], vz = psz * l.posZ[i];
+                Real uvx = py * vz - pz * vy, uvy = pz * vx - px * vz, uvz = px * vy - py * vx;
+                Real uuvx = py * uvz - pz * uvy, uuvy = pz * uvx - px * uvz, uuvz = px * uvy - py * uvx;
+                Real w2 = 2.0f * pw;
+                d.posX[i] = vx + uvx * w2 + uuvx * 2.0f + p.posX[j];
+                d.posY[i] = vy + uvy * w2 + uuvy * 2.0f + p.posY[j];
+                d.posZ[i] = vz + uvz * w2 + uuvz * 2.0f + p.posZ[j];
+            }
+        }
+    }
+    //-----------------------------------------------------------------------
+    void NodeTransformSoA::scatterDerived()
+    {
+        const auto& d = mDerived;
+        for (size_t i = 0; i < mNodes.size(); ++i)
+        {
+            Node* n = mNodes[i];
+            if (!n)
+                continue;
+
+            n->mDerivedPosition = {d.posX[i], d.posY[i], d.posZ[i]};
+            // derived in single precision only
+            n->mDerivedPositionDouble = {d.posX[i], d.posY[i], d.posZ[i]};
+            n->mDerivedOrientation = {d.rotW[i], d.rotX[i], d.rotY[i], d.rotZ[i]};
+            n->mDerivedScale = {d.sclX[i], d.sclY[i], d.sclZ[i]};
+            n->mCachedTransformOutOfDate = true;
+            n->mNeedParentUpdate = false;
+
+            // like a full _update(true, true) pass
+            n->mParentNotified = false;
+            n->mNeedChildUpdate = false;
+            n->mChildrenToUpdate.clear();
+
+            n->derivedTransformUpdated();
+            if (n->mListener)
+                n->mListener->nodeUpdated(n);
+            ++Node::msThreadUpdateCount;
+        }
+    }
+}
@@ -0,0 +1,309 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+module;
+
+#include <cstddef>
+
+module Ogre.Core;
+
+import :AxisAlignedBox;
+import :Camera;
+import :Common;
+import :HardwareBuffer;
+import :HardwareBufferManager;
+import :HardwareOcclusionQuery;
+import :HardwareVertexBuffer;
+import :Material;
+import :MaterialManager;
+import :Matrix4;
+import :OcclusionCulling;
+import :Pass;
+import :Quaternion;
+import :RenderOperation;
+import :RenderSystem;
+import :RenderSystemCapabilities;
+import :ResourceGroupManager;
+import :Root;
+import :SceneManager;
+import :SimpleRenderable;
+import :Sphere;
+import :Technique;
+import :Vector;
+import :VertexIndexData;
+
+import <algorithm>;
+import <functional>;
+import <map>;
+import <memory>;
+import <unordered_map>;
+import <vector>;
+
+namespace Ogre {
+    /// Unit cube rendered for the occlusion queries, scaled to the tested bounds
+    class OcclusionCulling::BoundingBoxRenderable : public SimpleRenderable
+    {
+    public:
+        BoundingBoxRenderable()
+        {
+            // one triangle strip covering all six faces
+            static const float positions[] = {
+                -1,  1,  1,    1,  1,  1,   -1, -1,  1,    1, -1,  1,
+                 1, -1, -1,    1,  1,  1,    1,  1, -1,   -1,  1,  1,
+                -1,  1, -1,   -1, -1,  1,   -1, -1, -1,    1, -1, -1,
+                -1,  1, -1,    1,  1, -1};
+
+            mRenderOp.vertexData = new VertexData();
+            mRenderOp.vertexData->vertexCount = 14;
+            mRenderOp.vertexData->vertexStart = 0;
+            mRenderOp.operationType = RenderOperation::OperationType::TRIANGLE_STRIP;
+            mRenderOp.useIndexes = false;
+            mRenderOp.useGlobalInstancingVertexBufferIsAvailable = false;
+            // a wireframe camera must not change how many samples pass
+            setPolygonModeOverrideable(false);
+
+            VertexDeclaration* decl = mRenderOp.vertexData->vertexDeclaration;
+            decl->addElement(0, 0, VertexElementType::FLOAT3, VertexElementSemantic::POSITION);
+
+            auto vbuf = HardwareBufferManager::getSingleton().createVertexBuffer(
+                decl->getVertexSize(0), mRenderOp.vertexData->vertexCount, HardwareBuffer::STATIC_WRITE_ONLY);
+            vbuf->writeData(0, vbuf->getSizeInBytes(), positions, true);
+            mRenderOp.vertexData->vertexBufferBinding->setBinding(0, vbuf);
+
+            const char* matName = "Ogre/OcclusionQueryBox";
+            auto mat = MaterialManager::getSingleton().getByName(matName, RGN_INTERNAL);
+            if (!mat)
+            {
+                // only touch the depth buffer, without changing it
+                mat = MaterialManager::getSingleton().create(matName, RGN_INTERNAL);
+                Pass* p = mat->getTechnique(0)->getPass(0);
+                p->setLightingEnabled(false);
+                p->setColourWriteEnabled(false);
+                p->setDepthWriteEnabled(false);
+                p->setCullingMode(CullingMode::NONE);
+            }
+            mat->load();
+            mMaterial = mat;
+        }
+
+        ~BoundingBoxRenderable() override
+        {
+            delete mRenderOp.vertexData;
+        }
+
+        void setBounds(const AxisAlignedBox& bounds)
+        {
+            mWorldTransform.makeTransform(bounds.getCenter(), bounds.getHalfSize(), Quaternion::IDENTITY);
+        }
+
+        void getWorldTransforms(Matrix4* xform) const override { *xform = mWorldTransform; }
+
+        auto getSquaredViewDepth(const Camera* cam) const -> Real override
+        { (void)cam; return 0; }
+
+        auto getBoundingRadius() const noexcept -> Real override { return 0; }
+
+    private:
+        Matrix4 mWorldTransform{Matrix4::IDENTITY};
+    };
+    //-----------------------------------------------------------------------
+    OcclusionCulling::OcclusionCulling() = default;
+    //-----------------------------------------------------------------------
+    OcclusionCulling::~OcclusionCulling()
+    {
+        destroyQueries();
+    }
+    //-----------------------------------------------------------------------
+    void OcclusionCulling::_beginFrame(const Camera* cam, SceneManager* sceneMgr)
+    {
+        mCurrentStates = nullptr;
+        mQueryList.clear();
+        RenderSystem* renderSystem = sceneMgr->getDestinationRenderSystem();
+        if (!renderSystem || !renderSystem->getCapabilities() ||
+            !renderSystem->getCapabilities()->hasCapability(Capabilities::HWOCCLUSION))
+            return;
+
+        // queries can only be reused with the render system which created them
+        if (mRenderSystem != renderSystem)
+        {
+            destroyQueries();
+            mRenderSystem = renderSystem;
+        }
+
+        mCurrentStates = &mCameraStates[cam];
+        mCameraPosition = cam->getDerivedPosition();
+        mNearRadius = (cam->getWorldSpaceCorners()[0] - mCameraPosition).length();
+        mFrame = Root::getSingleton().getNextFrameNumber();
+        mStats = {};
+    }
+    //-----------------------------------------------------------------------
+    auto OcclusionCulling::_isVisible(const SceneNode* node, const AxisAlignedBox& bounds) -> bool
+    {
+        if (!mCurrentStates)
+            return true;
+
+        ++mStats.nodesTested;
+        NodeState& state = (*mCurrentStates)[node];
+
+        // consume the result of an earlier frame, without waiting for it
+        if (state.pending)
+        {
+            if (state.query->isStillOutstanding())
+            {
+                ++mStats.queriesPending;
+            }
+            else
+            {
+                unsigned int samples = 0;
+                state.query->pullOcclusionQuery(&samples);
+                state.pending = false;
+
+                bool wasVisible = state.visible;
+                state.visible = samples > mVisibilityThreshold;
+
+                // spread the tests of nodes which just became visible over the interval
+                unsigned long delay = mVisiblePersistence;
+                if (!wasVisible)
+                    delay = 1 + std::hash<const SceneNode*>{}(node) % mVisiblePersistence;
+                state.nextQueryFrame = mFrame + delay;
+            }
+        }
+
+        // the near plane would clip the box of a node containing the camera
+        if (bounds.isInfinite() || bounds.intersects(Sphere{mCameraPosition, mNearRadius}))
+        {
+            state.visible = true;
+            return true;
+        }
+
+        if (!state.pending && (!state.visible || mFrame >= state.nextQueryFrame))
+            mQueryList.push_back({&state, bounds});
+
+        if (!state.visible)
+            ++mStats.nodesOccluded;
+        return state.visible;
+    }
+    //-----------------------------------------------------------------------
+    void OcclusionCulling::_endFrame(SceneManager* sceneMgr)
+    {
+        if (!mCurrentStates)
+            return;
+
+        if (!mQueryList.empty())
+        {
+            if (!mBoundingBox)
+                mBoundingBox = std::make_unique<BoundingBoxRenderable>();
+            Pass* pass = mBoundingBox->getMaterial()->getTechnique(0)->getPass(0);
+
+            for (auto& pending : mQueryList)
+            {
+                NodeState& state = *pending.state;
+                if (!state.query)
+                {
+                    if (mFreeQueries.empty())
+                    {
+                        state.query = mRenderSystem->createHardwareOcclusionQuery();
+                    }
+                    else
+                    {
+                        state.query = mFreeQueries.back();
+                        mFreeQueries.pop_back();
+                    }
+                }
+
+                mBoundingBox->setBounds(pending.bounds);
+                state.query->beginOcclusionQuery();
+                sceneMgr->_injectRenderWithPass(pass, mBoundingBox.get(), false);
+                state.query->endOcclusionQuery();
+                state.pending = true;
+            }
+            mStats.queriesIssued = mQueryList.size();
+        }
+
+        mQueryList.clear();
+        mCurrentStates = nullptr;
+    }
+    //-----------------------------------------------------------------------
+    void OcclusionCulling::_notifyNodeDestroyed(const SceneNode* node)
+    {
+        for (auto& [cam, states] : mCameraStates)
+        {
+            auto it = states.find(node);
+            if (it == states.end())
+                continue;
+            releaseState(it->second);
+            states.erase(it);
+        }
+    }
+    //-----------------------------------------------------------------------
+    void OcclusionCulling::_notifyAllNodesDestroyed()
+    {
+        for (auto& [cam, states] : mCameraStates)
+        {
+            for (auto& [node, state] : states)
+                releaseState(state);
+        }
+        mCameraStates.clear();
+        mCurrentStates = nullptr;
+        mQueryList.clear();
+    }
+    //-----------------------------------------------------------------------
+    void OcclusionCulling::_notifyCameraDestroyed(const Camera* cam)
+    {
+        auto it = mCameraStates.find(cam);
+        if (it == mCameraStates.end())
+            return;
+
+        for (auto& [node, state] : it->second)
+            releaseState(state);
+        if (mCurrentStates == &it->second)
+        {
+            mCurrentStates = nullptr;
+            mQueryList.clear();
+        }
+        mCameraStates.erase(it);
+    }
+    //-----------------------------------------------------------------------
+    void OcclusionCulling::releaseState(NodeState& state)
+    {
+        if (state.query)
+            mFreeQueries.push_back(state.query);
+        state.query = nullptr;
+        state.pending = false;
+    }
+    //-----------------------------------------------------------------------
+    void OcclusionCulling::destroyQueries()
+    {
+        _notifyAllNodesDestroyed();
+        if (mRenderSystem)
+        {
+            for (auto query : mFreeQueries)
+                mRenderSystem->destroyHardwareOcclusionQuery(query);
+        }
+        mFreeQueries.clear();
+    }
+}
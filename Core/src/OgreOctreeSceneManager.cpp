@@ -0,0 +1,609 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+module;
+
+#include <cstddef>
+
+module Ogre.Core;
+
+import :AxisAlignedBox;
+import :Camera;
+import :Common;
+import :Entity;
+import :Exception;
+import :Frustum;
+import :MovableObject;
+import :OctreeSceneManager;
+import :Ray;
+import :RenderQueue;
+import :SceneManager;
+import :SceneNode;
+import :SceneQuery;
+import :Sphere;
+import :Vector;
+
+import <algorithm>;
+import <initializer_list>;
+import <memory>;
+import <mutex>;
+import <string_view>;
+import <utility>;
+import <vector>;
+
+namespace Ogre {
+    namespace {
+        /// Visits the objects attached to the node and to the bones of its entities
+        template <typename Func>
+        auto forEachQueryObject(const OctreeSceneNode* node, Func&& func) -> bool
+        {
+            for (auto o : node->getAttachedObjects())
+            {
+                if (!func(o))
+                    return false;
+
+                if (o->getMovableType() == EntityFactory::FACTORY_TYPE_NAME)
+                {
+                    for (auto child : static_cast<Entity*>(o)->getAttachedObjects())
+                    {
+                        if (!func(child))
+                            return false;
+                    }
+                }
+            }
+            return true;
+        }
+
+        auto boundsOf(const Sphere& sphere) -> AxisAlignedBox
+        {
+            Vector3 radius = Vector3::UNIT_SCALE * sphere.getRadius();
+            return {AxisAlignedBox::Extent::Finite, sphere.getCenter() - radius, sphere.getCenter() + radius};
+        }
+    }
+    //-----------------------------------------------------------------------
+    LooseOctree::LooseOctree(const AxisAlignedBox& worldBounds, uint16 maxDepth)
+        : mRoot(std::make_unique<Octant>())
+        , mMaxDepth(maxDepth)
+    {
+        OgreAssert(worldBounds.isFinite(), "octree bounds must be finite");
+
+        // cubic cells keep the size test a single comparison
+        Vector3 centre = worldBounds.getCenter();
+        Vector3 extents = worldBounds.getHalfSize();
+        Vector3 halfSize = Vector3::UNIT_SCALE * std::max({extents.x, extents.y, extents.z});
+        mRoot->cellBounds.setExtents(centre - halfSize, centre + halfSize);
+        mRoot->looseBounds.setExtents(centre - halfSize * 2, centre + halfSize * 2);
+    }
+    //-----------------------------------------------------------------------
+    LooseOctree::~LooseOctree()
+    {
+        detachNodes(*mRoot);
+    }
+    //-----------------------------------------------------------------------
+    void LooseOctree::detachNodes(Octant& octant)
+    {
+        for (auto node : octant.nodes)
+            node->mOctant = nullptr;
+        octant.nodes.clear();
+        octant.numNodes = 0;
+
+        for (auto& child : octant.children)
+        {
+            if (child)
+                detachNodes(*child);
+        }
+    }
+    //-----------------------------------------------------------------------
+    void LooseOctree::clear()
+    {
+        detachNodes(*mRoot);
+        for (auto& child : mRoot->children)
+            child.reset();
+    }
+    //-----------------------------------------------------------------------
+    auto LooseOctree::findOctant(const AxisAlignedBox& bounds) -> Octant*
+    {
+        Octant* octant = mRoot.get();
+        if (!bounds.isFinite() || !octant->cellBounds.contains(bounds.getCenter()))
+            return octant;
+
+        Vector3 centre = bounds.getCenter();
+        Vector3 halfSize = bounds.getHalfSize();
+        Real extent = std::max({halfSize.x, halfSize.y, halfSize.z});
+
+        for (uint16 depth = 0; depth < mMaxDepth; ++depth)
+        {
+            // The loose bounds of a child reach half a child cell beyond it, so the
+            // node fits as long as it isn't larger than that
+            Real childHalfSize = octant->cellBounds.getHalfSize().x * 0.5f;
+            if (extent > childHalfSize)
+                break;
+
+            Vector3 cellCentre = octant->cellBounds.getCenter();
+            size_t index = (centre.x >= cellCentre.x ? 1 : 0) |
+                           (centre.y >= cellCentre.y ? 2 : 0) |
+                           (centre.z >= cellCentre.z ? 4 : 0);
+
+            auto& child = octant->children[index];
+            if (!child)
+            {
+                child = std::make_unique<Octant>();
+                child->parent = octant;
+
+                Vector3 childCentre = cellCentre;
+                childCentre.x += (index & 1) ? childHalfSize : -childHalfSize;
+                childCentre.y += (index & 2) ? childHalfSize : -childHalfSize;
+                childCentre.z += (index & 4) ? childHalfSize : -childHalfSize;
+                Vector3 half = Vector3::UNIT_SCALE * childHalfSize;
+                child->cellBounds.setExtents(childCentre - half, childCentre + half);
+                child->looseBounds.setExtents(childCentre - half * 2, childCentre + half * 2);
+            }
+            octant = child.get();
+        }
+
+        return octant;
+    }
+    //-----------------------------------------------------------------------
+    void LooseOctree::update(OctreeSceneNode* node)
+    {
+        Octant* octant = findOctant(node->getQueryBounds());
+        if (octant == node->mOctant)
+            return;
+
+        remove(node);
+
+        node->mOctant = octant;
+        node->mOctantIndex = octant->nodes.size();
+        octant->nodes.push_back(node);
+        for (Octant* o = octant; o; o = o->parent)
+            ++o->numNodes;
+    }
+    //-----------------------------------------------------------------------
+    void LooseOctree::remove(OctreeSceneNode* node)
+    {
+        Octant* octant = node->mOctant;
+        if (!octant)
+            return;
+
+        // Optimised algorithm to erase an element from unordered vector.
+        OctreeSceneNode* last = octant->nodes.back();
+        octant->nodes[node->mOctantIndex] = last;
+        last->mOctantIndex = node->mOctantIndex;
+        octant->nodes.pop_back();
+
+        for (Octant* o = octant; o; o = o->parent)
+            --o->numNodes;
+
+        node->mOctant = nullptr;
+    }
+    //-----------------------------------------------------------------------
+    //-----------------------------------------------------------------------
+    OctreeSceneNode::OctreeSceneNode(SceneManager* creator) : OctreeSceneNode(creator, BLANKSTRING)
+    {
+    }
+    //-----------------------------------------------------------------------
+    OctreeSceneNode::OctreeSceneNode(SceneManager* creator, std::string_view name)
+        : SceneNode(creator, name)
+    {
+    }
+    //-----------------------------------------------------------------------
+    OctreeSceneNode::~OctreeSceneNode()
+    {
+        if (mOctant || mOctreeUpdateQueued)
+            static_cast<OctreeSceneManager*>(mCreator)->_removeOctreeNode(this);
+    }
+    //-----------------------------------------------------------------------
+    void OctreeSceneNode::_updateBounds()
+    {
+        mObjectBounds.setNull();
+        AxisAlignedBox queryBounds;
+        forEachQueryObject(this, [&](MovableObject* o)
+        {
+            // objects attached to bones are within the bounds of their entity
+            if (o->getParentNode() == this)
+                mObjectBounds.merge(o->getWorldBoundingBox(true));
+            queryBounds.merge(o->getWorldBoundingBox(true));
+            queryBounds.merge(boundsOf(o->getWorldBoundingSphere(true)));
+            return true;
+        });
+
+        mWorldAABB = mObjectBounds;
+        for (auto child : getChildren())
+            mWorldAABB.merge(static_cast<SceneNode*>(child)->_getWorldAABB());
+
+        bool changed = !(queryBounds == mQueryBounds);
+        mQueryBounds = queryBounds;
+
+        // empty nodes have nothing to cull, keep them out of the octree
+        bool indexed = mOctant != nullptr;
+        bool wanted = mIsInSceneGraph && !mQueryBounds.isNull();
+        if (indexed != wanted || (indexed && changed))
+            static_cast<OctreeSceneManager*>(mCreator)->_queueOctreeUpdate(this);
+    }
+    //-----------------------------------------------------------------------
+    void OctreeSceneNode::setParent(Node* parent)
+    {
+        SceneNode::setParent(parent);
+
+        if (mIsInSceneGraph)
+            return;
+
+        // the whole subtree left the scene graph
+        std::vector<Node*> nodes{this};
+        while (!nodes.empty())
+        {
+            auto* n = static_cast<OctreeSceneNode*>(nodes.back());
+            nodes.pop_back();
+            if (n->mOctant || n->mOctreeUpdateQueued)
+                static_cast<OctreeSceneManager*>(mCreator)->_removeOctreeNode(n);
+            nodes.insert(nodes.end(), n->getChildren().begin(), n->getChildren().end());
+        }
+    }
+    //-----------------------------------------------------------------------
+    //-----------------------------------------------------------------------
+    OctreeSceneManager::OctreeSceneManager(std::string_view name)
+        : SceneManager(name)
+        , mOctree(std::make_unique<LooseOctree>(
+              AxisAlignedBox{AxisAlignedBox::Extent::Finite, Vector3{-10000, -10000, -10000}, Vector3{10000, 10000, 10000}}, 8))
+    {
+    }
+    //-----------------------------------------------------------------------
+    OctreeSceneManager::~OctreeSceneManager()
+    {
+        // The nodes are destroyed by the SceneManager destructor, after the octree
+        // is gone, so make sure they don't try to reach it
+        mOctree->clear();
+        for (auto node : mOctreeUpdateQueue)
+            node->mOctreeUpdateQueued = false;
+        mOctreeUpdateQueue.clear();
+    }
+    //-----------------------------------------------------------------------
+    auto OctreeSceneManager::getTypeName() const noexcept -> std::string_view
+    {
+        return OctreeSceneManagerFactory::FACTORY_TYPE_NAME;
+    }
+    //-----------------------------------------------------------------------
+    auto OctreeSceneManager::createSceneNodeImpl() -> SceneNode*
+    {
+        return new OctreeSceneNode(this);
+    }
+    //-----------------------------------------------------------------------
+    auto OctreeSceneManager::createSceneNodeImpl(std::string_view name) -> SceneNode*
+    {
+        return new OctreeSceneNode(this, name);
+    }
+    //-----------------------------------------------------------------------
+    void OctreeSceneManager::setOctreeBounds(const AxisAlignedBox& worldBounds, uint16 maxDepth)
+    {
+        // collect the indexed nodes before the octants go away
+        std::vector<OctreeSceneNode*> nodes;
+        nodes.reserve(mOctree->getNumNodes());
+        mOctree->walk([](const AxisAlignedBox&) { return true; },
+                      [&nodes](OctreeSceneNode* n) { nodes.push_back(n); return true; });
+
+        mOctree = std::make_unique<LooseOctree>(worldBounds, maxDepth);
+        for (auto n : nodes)
+            mOctree->update(n);
+    }
+    //-----------------------------------------------------------------------
+    void OctreeSceneManager::_queueOctreeUpdate(OctreeSceneNode* node)
+    {
+        std::unique_lock<std::mutex> lock(mOctreeUpdateMutex);
+        if (!node->mOctreeUpdateQueued)
+        {
+            node->mOctreeUpdateQueued = true;
+            mOctreeUpdateQueue.push_back(node);
+        }
+    }
+    //-----------------------------------------------------------------------
+    void OctreeSceneManager::_removeOctreeNode(OctreeSceneNode* node)
+    {
+        mOctree->remove(node);
+
+        if (node->mOctreeUpdateQueued)
+        {
+            std::unique_lock<std::mutex> lock(mOctreeUpdateMutex);
+            std::erase(mOctreeUpdateQueue, node);
+            node->mOctreeUpdateQueued = false;
+        }
+    }
+    //-----------------------------------------------------------------------
+    void OctreeSceneManager::processOctreeUpdates()
+    {
+        for (auto node : mOctreeUpdateQueue)
+        {
+            node->mOctreeUpdateQueued = false;
+            if (node->isInSceneGraph() && !node->getQueryBounds().isNull())
+                mOctree->update(node);
+            else
+                mOctree->remove(node);
+        }
+        mOctreeUpdateQueue.clear();
+    }
+    //-----------------------------------------------------------------------
+    void OctreeSceneManager::_updateSceneGraph(Camera* cam)
+    {
+        SceneManager::_updateSceneGraph(cam);
+        processOctreeUpdates();
+    }
+    //-----------------------------------------------------------------------
+    void OctreeSceneManager::_findVisibleObjects(
+        Camera* cam, VisibleObjectsBoundsInfo* visibleBounds, bool onlyShadowCasters)
+    {
+        RenderQueue* queue = getRenderQueue();
+        DebugDrawer* debugDrawer = getDebugDrawer();
+
+        // the nodes of the visited octants are culled in batches
+        AxisAlignedBoxBatch batch;
+        OctreeSceneNode* batchNodes[AxisAlignedBoxBatch::CAPACITY];
+        uint8 visible[AxisAlignedBoxBatch::CAPACITY];
+        auto flushBatch = [&]()
+        {
+            cam->isVisible(batch, visible);
+            for (size_t i = 0; i < batch.size; ++i)
+            {
+                if (!visible[i] || !_passesVisibilityStages(batchNodes[i], batchNodes[i]->getObjectBounds()) ||
+                    !_passesShadowCasterCulling(batchNodes[i]->getObjectBounds()))
+                {
+                    queue->_notifyNodesCulled(1);
+                    continue;
+                }
+
+                for (auto mo : batchNodes[i]->getAttachedObjects())
+                    queue->processVisibleObject(mo, cam, onlyShadowCasters, visibleBounds);
+
+                if (debugDrawer)
+                    debugDrawer->drawSceneNode(batchNodes[i]);
+            }
+            batch.clear();
+        };
+
+        mNumVisitedOctants = 1;
+        mOctree->walk(
+            [this, cam](const AxisAlignedBox& looseBounds)
+            {
+                if (!cam->isVisible(looseBounds) || !_passesShadowCasterCulling(looseBounds))
+                    return false;
+                ++mNumVisitedOctants;
+                return true;
+            },
+            [&](OctreeSceneNode* node)
+            {
+                batchNodes[batch.size] = node;
+                batch.push_back(node->getObjectBounds());
+                if (batch.full())
+                    flushBatch();
+                return true;
+            });
+        flushBatch();
+    }
+    //-----------------------------------------------------------------------
+    auto OctreeSceneManager::createAABBQuery(const AxisAlignedBox& box, QueryTypeMask mask) -> AxisAlignedBoxSceneQuery*
+    {
+        auto* q = new OctreeAxisAlignedBoxSceneQuery(this);
+        q->setBox(box);
+        q->setQueryMask(mask);
+        return q;
+    }
+    //-----------------------------------------------------------------------
+    auto OctreeSceneManager::createSphereQuery(const Sphere& sphere, QueryTypeMask mask) -> SphereSceneQuery*
+    {
+        auto* q = new OctreeSphereSceneQuery(this);
+        q->setSphere(sphere);
+        q->setQueryMask(mask);
+        return q;
+    }
+    //-----------------------------------------------------------------------
+    auto OctreeSceneManager::createRayQuery(const Ray& ray, QueryTypeMask mask) -> ::std::unique_ptr<RaySceneQuery>
+    {
+        ::std::unique_ptr<RaySceneQuery> q{new OctreeRaySceneQuery(this)};
+        q->setRay(ray);
+        q->setQueryMask(mask);
+        return q;
+    }
+    //-----------------------------------------------------------------------
+    auto OctreeSceneManager::createRayBatchQuery(const std::vector<Ray>& rays, QueryTypeMask mask)
+        -> ::std::unique_ptr<RayBatchSceneQuery>
+    {
+        ::std::unique_ptr<RayBatchSceneQuery> q{new OctreeRayBatchSceneQuery(this)};
+        q->setRays(rays);
+        q->setQueryMask(mask);
+        return q;
+    }
+    //-----------------------------------------------------------------------
+    OctreeAxisAlignedBoxSceneQuery::OctreeAxisAlignedBoxSceneQuery(OctreeSceneManager* creator)
+        : AxisAlignedBoxSceneQuery(creator)
+    {
+        // No world geometry results supported
+        mSupportedWorldFragments.insert(SceneQuery::WorldFragmentType::NONE);
+    }
+    //-----------------------------------------------------------------------
+    void OctreeAxisAlignedBoxSceneQuery::execute(SceneQueryListener* listener)
+    {
+        auto& octree = static_cast<OctreeSceneManager*>(mParentSceneMgr)->getOctree();
+        octree.walk(
+            [this](const AxisAlignedBox& looseBounds) { return mAABB.intersects(looseBounds); },
+            [&](OctreeSceneNode* node)
+            {
+                if (!mAABB.intersects(node->getQueryBounds()))
+                    return true;
+
+                return forEachQueryObject(node, [&](MovableObject* a)
+                {
+                    if (!(a->getTypeFlags() & mQueryTypeMask) ||
+                        !std::to_underlying(a->getQueryFlags() & mQueryMask) || !a->isInScene())
+                        return true;
+
+                    if (mAABB.intersects(a->getWorldBoundingBox()))
+                        return listener->queryResult(a);
+                    return true;
+                });
+            });
+    }
+    //-----------------------------------------------------------------------
+    OctreeSphereSceneQuery::OctreeSphereSceneQuery(OctreeSceneManager* creator)
+        : SphereSceneQuery(creator)
+    {
+        // No world geometry results supported
+        mSupportedWorldFragments.insert(SceneQuery::WorldFragmentType::NONE);
+    }
+    //-----------------------------------------------------------------------
+    void OctreeSphereSceneQuery::execute(SceneQueryListener* listener)
+    {
+        auto& octree = static_cast<OctreeSceneManager*>(mParentSceneMgr)->getOctree();
+        octree.walk(
+            [this](const AxisAlignedBox& looseBounds) { return looseBounds.intersects(mSphere); },
+            [&](OctreeSceneNode* node)
+            {
+                if (!node->getQueryBounds().intersects(mSphere))
+                    return true;
+
+                return forEachQueryObject(node, [&](MovableObject* a)
+                {
+                    if (!(a->getTypeFlags() & mQueryTypeMask) ||
+                        !std::to_underlying(a->getQueryFlags() & mQueryMask) || !a->isInScene())
+                        return true;
+
+                    if (mSphere.intersects(a->getWorldBoundingSphere()))
+                        return listener->queryResult(a);
+                    return true;
+                });
+            });
+    }
+    //-----------------------------------------------------------------------
+    OctreeRaySceneQuery::OctreeRaySceneQuery(OctreeSceneManager* creator)
+        : RaySceneQuery(creator)
+    {
+        // No world geometry results supported
+        mSupportedWorldFragments.insert(SceneQuery::WorldFragmentType::NONE);
+    }
+    //-----------------------------------------------------------------------
+    void OctreeRaySceneQuery::execute(RaySceneQueryListener* listener)
+    {
+        auto& octree = static_cast<OctreeSceneManager*>(mParentSceneMgr)->getOctree();
+        octree.walk(
+            [this](const AxisAlignedBox& looseBounds) { return mRay.intersects(looseBounds).first; },
+            [&](OctreeSceneNode* node)
+            {
+                if (!mRay.intersects(node->getQueryBounds()).first)
+                    return true;
+
+                return forEachQueryObject(node, [&](MovableObject* a)
+                {
+                    if (!(a->getTypeFlags() & mQueryTypeMask) ||
+                        !std::to_underlying(a->getQueryFlags() & mQueryMask) || !a->isInScene())
+                        return true;
+
+                    std::pair<bool, Real> result = intersectsObject(a);
+                    if (result.first)
+                        return listener->queryResult(a, result.second);
+                    return true;
+                });
+            });
+    }
+    //-----------------------------------------------------------------------
+    OctreeRayBatchSceneQuery::OctreeRayBatchSceneQuery(OctreeSceneManager* creator)
+        : RayBatchSceneQuery(creator)
+    {
+        // No world geometry results supported
+        mSupportedWorldFragments.insert(SceneQuery::WorldFragmentType::NONE);
+    }
+    //-----------------------------------------------------------------------
+    void OctreeRayBatchSceneQuery::execute(RayBatchSceneQueryListener* listener)
+    {
+        auto& octree = static_cast<OctreeSceneManager*>(mParentSceneMgr)->getOctree();
+
+        // the root octant is always visited, with every ray
+        mActiveRays.resize(octree.getMaxDepth() + 1);
+        mActiveRays[0].clear();
+        for (size_t i = 0; i < mRays.size(); ++i)
+            mActiveRays[0].push_back(static_cast<uint32>(i));
+
+        executeOctant(octree.getRoot(), 0, listener);
+    }
+    //-----------------------------------------------------------------------
+    auto OctreeRayBatchSceneQuery::executeOctant(const LooseOctree::Octant& octant, size_t depth,
+                                                 RayBatchSceneQueryListener* listener) -> bool
+    {
+        const auto& rays = mActiveRays[depth];
+        for (auto node : octant.nodes)
+        {
+            for (auto i : rays)
+            {
+                if (!mRays[i].intersects(node->getQueryBounds()).first)
+                    continue;
+
+                bool proceed = forEachQueryObject(node, [&](MovableObject* a)
+                {
+                    if (!(a->getTypeFlags() & mQueryTypeMask) ||
+                        !std::to_underlying(a->getQueryFlags() & mQueryMask) || !a->isInScene())
+                        return true;
+
+                    std::pair<bool, Real> result = mRays[i].intersects(a->getWorldBoundingBox());
+                    if (result.first)
+                        return listener->queryResult(i, a, result.second);
+                    return true;
+                });
+                if (!proceed)
+                    return false;
+            }
+        }
+
+        for (const auto& child : octant.children)
+        {
+            if (!child || !child->numNodes)
+                continue;
+
+            // only the rays hitting this octant can hit the child
+            auto& childRays = mActiveRays[depth + 1];
+            childRays.clear();
+            for (auto i : rays)
+            {
+                if (mRays[i].intersects(child->looseBounds).first)
+                    childRays.push_back(i);
+            }
+
+            if (!childRays.empty() && !executeOctant(*child, depth + 1, listener))
+                return false;
+        }
+        return true;
+    }
+    //-----------------------------------------------------------------------
+    std::string_view const constinit OctreeSceneManagerFactory::FACTORY_TYPE_NAME = "OctreeSceneManager";
+    //-----------------------------------------------------------------------
+    void OctreeSceneManagerFactory::initMetaData() const
+    {
+        mMetaData.typeName = FACTORY_TYPE_NAME;
+        mMetaData.worldGeometrySupported = false;
+    }
+    //-----------------------------------------------------------------------
+    auto OctreeSceneManagerFactory::createInstance(
+        std::string_view instanceName) -> SceneManager*
+    {
+        return new OctreeSceneManager(instanceName);
+    }
+}
@@ -36,8 +36,16 @@ namespace Ogre {
     // External functions
     extern auto _getOptimisedUtilGeneral() -> OptimisedUtil*;
 
+#if defined(__i386__) || defined(__x86_64__)
     extern auto _getOptimisedUtilSSE() -> OptimisedUtil*;
 
+    extern auto _getOptimisedUtilAVX2() -> OptimisedUtil*;
+#endif
+
+#if defined(__ARM_NEON) && defined(__aarch64__)
+    extern auto _getOptimisedUtilNEON() -> OptimisedUtil*;
+#endif
+
 #ifdef __DO_PROFILE__
     //---------------------------------------------------------------------
     class OptimisedUtilProfiler : public OptimisedUtil
@@ -48,6 +56,7 @@ namespace Ogre {
         {
             IMPL_DEFAULT,
             IMPL_SSE,
+            IMPL_AVX2,
             IMPL_COUNT
         };
 
@@ -82,10 +91,22 @@ namespace Ogre {
         {
             mOptimisedUtils.push_back(_getOptimisedUtilGeneral());
 
+#if defined(__i386__) || defined(__x86_64__)
             //if (PlatformInformation::getCpuFeatures() & PlatformInformation::CpuFeatures::SSE)
             {
                 mOptimisedUtils.push_back(_getOptimisedUtilSSE());
             }
+
+            if (PlatformInformation::hasCpuFeature(PlatformInformation::CpuFeatures::AVX2) &&
+                PlatformInformation::hasCpuFeature(PlatformInformation::CpuFeatures::FMA))
+            {
+                mOptimisedUtils.push_back(_getOptimisedUtilAVX2());
+            }
+#endif
+
+#if defined(__ARM_NEON) && defined(__aarch64__)
+            mOptimisedUtils.push_back(_getOptimisedUtilNEON());
+#endif
         }
 
         virtual void softwareVertexSkinning(
@@ -185,6 +206,277 @@ namespace Ogre {
             ++index;    // So we can put break point here even if in release build
         }
 
+        /// @copydoc OptimisedUtil::multiplyMatrices
+        virtual void multiplyMatrices(
+            const Matrix4* lhsMatrices,
+            const Matrix4* rhsMatrices,
+            Matrix4* dstMatrices,
+            size_t numMatrices)
+        {
+            static ProfileItems results;
+            static size_t index;
+            index = Root::getSingleton().getNextFrameNumber() % mOptimisedUtils.size();
+            OptimisedUtil* impl = mOptimisedUtils[index];
+            ProfileItem& profile = results[index];
+
+            profile.begin();
+            impl->multiplyMatrices(
+                lhsMatrices,
+                rhsMatrices,
+                dstMatrices,
+                numMatrices);
+            profile.end();
+
+            LogManager::getSingleton().logMessage(std::format(
+                "OptimisedUtilProfiler: {} - impl {} = {} avg ticks\n", __FUNCTION__, index, profile.mAvgTicks));
+
+            // You can put break point here while running test application, to
+            // watch profile results.
+            ++index;    // So we can put break point here even if in release build
+        }
+
+        /// @copydoc OptimisedUtil::multiplyAffineMatrices
+        virtual void multiplyAffineMatrices(
+            const Affine3* lhsMatrices,
+            const Affine3* rhsMatrices,
+            Affine3* dstMatrices,
+            size_t numMatrices)
+        {
+            static ProfileItems results;
+            static size_t index;
+            index = Root::getSingleton().getNextFrameNumber() % mOptimisedUtils.size();
+            OptimisedUtil* impl = mOptimisedUtils[index];
+            ProfileItem& profile = results[index];
+
+            profile.begin();
+            impl->multiplyAffineMatrices(
+                lhsMatrices,
+                rhsMatrices,
+                dstMatrices,
+                numMatrices);
+            profile.end();
+
+            LogManager::getSingleton().logMessage(std::format(
+                "OptimisedUtilProfiler: {} - impl {} = {} avg ticks\n", __FUNCTION__, index, profile.mAvgTicks));
+
+            // You can put break point here while running test application, to
+            // watch profile results.
+            ++index;    // So we can put break point here even if in release build
+        }
+
+        /// @copydoc OptimisedUtil::inverseAffineMatrices
+        virtual void inverseAffineMatrices(
+            const Affine3* srcMatrices,
+            Affine3* dstMatrices,
+            size_t numMatrices)
+        {
+            static ProfileItems results;
+            static size_t index;
+            index = Root::getSingleton().getNextFrameNumber() % mOptimisedUtils.size();
+            OptimisedUtil* impl = mOptimisedUtils[index];
+            ProfileItem& profile = results[index];
+
+            profile.begin();
+            impl->inverseAffineMatrices(
+                srcMatrices,
+                dstMatrices,
+                numMatrices);
+            profile.end();
+
+            LogManager::getSingleton().logMessage(std::format(
+                "OptimisedUtilProfiler: {} - impl {} = {} avg ticks\n", __FUNCTION__, index, profile.mAvgTicks));
+
+            // You can put break point here while running test application, to
+            // watch profile results.
+            ++index;    // So we can put break point here even if in release build
+        }
+
+        /// @copydoc OptimisedUtil::transformPoints
+        virtual void transformPoints(
+            const Affine3& matrix,
+            const Vector3* srcPoints,
+            Vector3* dstPoints,
+            size_t numPoints)
+        {
+            static ProfileItems results;
+            static size_t index;
+            index = Root::getSingleton().getNextFrameNumber() % mOptimisedUtils.size();
+            OptimisedUtil* impl = mOptimisedUtils[index];
+            ProfileItem& profile = results[index];
+
+            profile.begin();
+            impl->transformPoints(
+                matrix,
+                srcPoints,
+                dstPoints,
+                numPoints);
+            profile.end();
+
+            LogManager::getSingleton().logMessage(std::format(
+                "OptimisedUtilProfiler: {} - impl {} = {} avg ticks\n", __FUNCTION__, index, profile.mAvgTicks));
+
+            // You can put break point here while running test application, to
+            // watch profile results.
+            ++index;    // So we can put break point here even if in release build
+        }
+
+        /// @copydoc OptimisedUtil::transformDirections
+        virtual void transformDirections(
+            const Affine3& matrix,
+            const Vector3* srcDirections,
+            Vector3* dstDirections,
+            size_t numDirections)
+        {
+            static ProfileItems results;
+            static size_t index;
+            index = Root::getSingleton().getNextFrameNumber() % mOptimisedUtils.size();
+            OptimisedUtil* impl = mOptimisedUtils[index];
+            ProfileItem& profile = results[index];
+
+            profile.begin();
+            impl->transformDirections(
+                matrix,
+                srcDirections,
+                dstDirections,
+                numDirections);
+            profile.end();
+
+            LogManager::getSingleton().logMessage(std::format(
+                "OptimisedUtilProfiler: {} - impl {} = {} avg ticks\n", __FUNCTION__, index, profile.mAvgTicks));
+
+            // You can put break point here while running test application, to
+            // watch profile results.
+            ++index;    // So we can put break point here even if in release build
+        }
+
+        /// @copydoc OptimisedUtil::slerpQuaternions
+        virtual void slerpQuaternions(
+            const Quaternion* from,
+            const Quaternion* to,
+            const float* t,
+            Quaternion* dst,
+            size_t numQuaternions,
+            bool shortestPath)
+        {
+            static ProfileItems results;
+            static size_t index;
+            index = Root::getSingleton().getNextFrameNumber() % mOptimisedUtils.size();
+            OptimisedUtil* impl = mOptimisedUtils[index];
+            ProfileItem& profile = results[index];
+
+            profile.begin();
+            impl->slerpQuaternions(
+                from,
+                to,
+                t,
+                dst,
+                numQuaternions,
+                shortestPath);
+            profile.end();
+
+            LogManager::getSingleton().logMessage(std::format(
+                "OptimisedUtilProfiler: {} - impl {} = {} avg ticks\n", __FUNCTION__, index, profile.mAvgTicks));
+
+            // You can put break point here while running test application, to
+            // watch profile results.
+            ++index;    // So we can put break point here even if in release build
+        }
+
+        /// @copydoc OptimisedUtil::nlerpQuaternions
+        virtual void nlerpQuaternions(
+            const Quaternion* from,
+            const Quaternion* to,
+            const float* t,
+            Quaternion* dst,
+            size_t numQuaternions,
+            bool shortestPath)
+        {
+            static ProfileItems results;
+            static size_t index;
+            index = Root::getSingleton().getNextFrameNumber() % mOptimisedUtils.size();
+            OptimisedUtil* impl = mOptimisedUtils[index];
+            ProfileItem& profile = results[index];
+
+            profile.begin();
+            impl->nlerpQuaternions(
+                from,
+                to,
+                t,
+                dst,
+                numQuaternions,
+                shortestPath);
+            profile.end();
+
+            LogManager::getSingleton().logMessage(std::format(
+                "OptimisedUtilProfiler: {} - impl {} = {} avg ticks\n", __FUNCTION__, index, profile.mAvgTicks));
+
+            // You can put break point here while running test application, to
+            // watch profile results.
+            ++index;    // So we can put break point here even if in release build
+        }
+
+        /// @copydoc OptimisedUtil::intersectRayBoxes
+        virtual void intersectRayBoxes(
+            const Ray& ray,
+            const Math::BoxArrays& boxes,
+            Real* distances,
+            size_t numBoxes)
+        {
+            static ProfileItems results;
+            static size_t index;
+            index = Root::getSingleton().getNextFrameNumber() % mOptimisedUtils.size();
+            OptimisedUtil* impl = mOptimisedUtils[index];
+            ProfileItem& profile = results[index];
+
+            profile.begin();
+            impl->intersectRayBoxes(
+                ray,
+                boxes,
+                distances,
+                numBoxes);
+            profile.end();
+
+            LogManager::getSingleton().logMessage(std::format(
+                "OptimisedUtilProfiler: {} - impl {} = {} avg ticks\n", __FUNCTION__, index, profile.mAvgTicks));
+
+            // You can put break point here while running test application, to
+            // watch profile results.
+            ++index;    // So we can put break point here even if in release build
+        }
+
+        /// @copydoc OptimisedUtil::intersectRayTriangles
+        virtual void intersectRayTriangles(
+            const Ray& ray,
+            const Math::TriangleArrays& triangles,
+            Real* distances,
+            size_t numTriangles,
+            bool positiveSide,
+            bool negativeSide)
+        {
+            static ProfileItems results;
+            static size_t index;
+            index = Root::getSingleton().getNextFrameNumber() % mOptimisedUtils.size();
+            OptimisedUtil* impl = mOptimisedUtils[index];
+            ProfileItem& profile = results[index];
+
+            profile.begin();
+            impl->intersectRayTriangles(
+                ray,
+                triangles,
+                distances,
+                numTriangles,
+                positiveSide,
+                negativeSide);
+            profile.end();
+
+            LogManager::getSingleton().logMessage(std::format(
+                "OptimisedUtilProfiler: {} - impl {} = {} avg ticks\n", __FUNCTION__, index, profile.mAvgTicks));
+
+            // You can put break point here while running test application, to
+            // watch profile results.
+            ++index;    // So we can put break point here even if in release build
+        }
+
         /// @copydoc OptimisedUtil::calculateFaceNormals
         virtual void calculateFaceNormals(
             const float *positions,
@@ -303,12 +595,212 @@ namespace Ogre {
             ++index;    // So we can put break point here even if in release build
         }
 
+        virtual void cullBoxes(
+            const float* planes, size_t numPlanes,
+            const float* centreX, const float* centreY, const float* centreZ,
+            const float* halfSizeX, const float* halfSizeY, const float* halfSizeZ,
+            uint8* visible,
+            size_t numBoxes)
+        {
+            static ProfileItems results;
+            static size_t index;
+            index = Root::getSingleton().getNextFrameNumber() % mOptimisedUtils.size();
+            OptimisedUtil* impl = mOptimisedUtils[index];
+            ProfileItem& profile = results[index];
+
+            profile.begin();
+            impl->cullBoxes(
+                planes, numPlanes,
+                centreX, centreY, centreZ,
+                halfSizeX, halfSizeY, halfSizeZ,
+                visible,
+                numBoxes);
+            profile.end();
+
+            LogManager::getSingleton().logMessage(std::format(
+                "OptimisedUtilProfiler: {} - impl {} = {} avg ticks\n", __FUNCTION__, index, profile.mAvgTicks));
+
+            // You can put break point here while running test application, to
+            // watch profile results.
+            ++index;    // So we can put break point here even if in release build
+        }
+
+        virtual void integrateArrays(
+            float* posX, float* posY, float* posZ,
+            const float* velX, const float* velY, const float* velZ,
+            float timeElapsed,
+            size_t count)
+        {
+            static ProfileItems results;
+            static size_t index;
+            index = Root::getSingleton().getNextFrameNumber() % mOptimisedUtils.size();
+            OptimisedUtil* impl = mOptimisedUtils[index];
+            ProfileItem& profile = results[index];
+
+            profile.begin();
+            impl->integrateArrays(
+                posX, posY, posZ,
+                velX, velY, velZ,
+                timeElapsed,
+                count);
+            profile.end();
+
+            LogManager::getSingleton().logMessage(std::format(
+                "OptimisedUtilProfiler: {} - impl {} = {} avg ticks\n", __FUNCTION__, index, profile.mAvgTicks));
+
+            // You can put break point here while running test application, to
+            // watch profile results.
+            ++index;    // So we can put break point here even if in release build
+        }
+
+        virtual void calculatePlaneDistances(
+            const float* plane,
+            const float* posX, const float* posY, const float* posZ,
+            float* distances,
+            size_t count)
+        {
+            static ProfileItems results;
+            static size_t index;
+            index = Root::getSingleton().getNextFrameNumber() % mOptimisedUtils.size();
+            OptimisedUtil* impl = mOptimisedUtils[index];
+            ProfileItem& profile = results[index];
+
+            profile.begin();
+            impl->calculatePlaneDistances(
+                plane,
+                posX, posY, posZ,
+                distances,
+                count);
+            profile.end();
+
+            LogManager::getSingleton().logMessage(std::format(
+                "OptimisedUtilProfiler: {} - impl {} = {} avg ticks\n", __FUNCTION__, index, profile.mAvgTicks));
+
+            // You can put break point here while running test application, to
+            // watch profile results.
+            ++index;    // So we can put break point here even if in release build
+        }
+
+        virtual void shuffleChannels(
+            const uint8* src, size_t srcBytes,
+            uint8* dst, size_t dstBytes,
+            const uint8* shuffle,
+            size_t numPixels)
+        {
+            static ProfileItems results;
+            static size_t index;
+            index = Root::getSingleton().getNextFrameNumber() % mOptimisedUtils.size();
+            OptimisedUtil* impl = mOptimisedUtils[index];
+            ProfileItem& profile = results[index];
+
+            profile.begin();
+            impl->shuffleChannels(
+                src, srcBytes,
+                dst, dstBytes,
+                shuffle,
+                numPixels);
+            profile.end();
+
+            LogManager::getSingleton().logMessage(std::format(
+                "OptimisedUtilProfiler: {} - impl {} = {} avg ticks\n", __FUNCTION__, index, profile.mAvgTicks));
+
+            // You can put break point here while running test application, to
+            // watch profile results.
+            ++index;    // So we can put break point here even if in release build
+        }
+
+        virtual void convertUnormToFloat(const uint8* src, float* dst, size_t count)
+        {
+            static ProfileItems results;
+            static size_t index;
+            index = Root::getSingleton().getNextFrameNumber() % mOptimisedUtils.size();
+            OptimisedUtil* impl = mOptimisedUtils[index];
+            ProfileItem& profile = results[index];
+
+            profile.begin();
+            impl->convertUnormToFloat(src, dst, count);
+            profile.end();
+
+            LogManager::getSingleton().logMessage(std::format(
+                "OptimisedUtilProfiler: {} - impl {} = {} avg ticks\n", __FUNCTION__, index, profile.mAvgTicks));
+
+            // You can put break point here while running test application, to
+            // watch profile results.
+            ++index;    // So we can put break point here even if in release build
+        }
+
+        virtual void convertFloatToUnorm(const float* src, uint8* dst, size_t count)
+        {
+            static ProfileItems results;
+            static size_t index;
+            index = Root::getSingleton().getNextFrameNumber() % mOptimisedUtils.size();
+            OptimisedUtil* impl = mOptimisedUtils[index];
+            ProfileItem& profile = results[index];
+
+            profile.begin();
+            impl->convertFloatToUnorm(src, dst, count);
+            profile.end();
+
+            LogManager::getSingleton().logMessage(std::format(
+                "OptimisedUtilProfiler: {} - impl {} = {} avg ticks\n", __FUNCTION__, index, profile.mAvgTicks));
+
+            // You can put break point here while running test application, to
+            // watch profile results.
+            ++index;    // So we can put break point here even if in release build
+        }
+
+        virtual void convertHalfToFloat(const uint16* src, float* dst, size_t count)
+        {
+            static ProfileItems results;
+            static size_t index;
+            index = Root::getSingleton().getNextFrameNumber() % mOptimisedUtils.size();
+            OptimisedUtil* impl = mOptimisedUtils[index];
+            ProfileItem& profile = results[index];
+
+            profile.begin();
+            impl->convertHalfToFloat(src, dst, count);
+            profile.end();
+
+            LogManager::getSingleton().logMessage(std::format(
+                "OptimisedUtilProfiler: {} - impl {} = {} avg ticks\n", __FUNCTION__, index, profile.mAvgTicks));
+
+            // You can put break point here while running test application, to
+            // watch profile results.
+            ++index;    // So we can put break point here even if in release build
+        }
+
+        virtual void convertFloatToHalf(const float* src, uint16* dst, size_t count)
+        {
+            static ProfileItems results;
+            static size_t index;
+            index = Root::getSingleton().getNextFrameNumber() % mOptimisedUtils.size();
+            OptimisedUtil* impl = mOptimisedUtils[index];
+            ProfileItem& profile = results[index];
+
+            profile.begin();
+            impl->convertFloatToHalf(src, dst, count);
+            profile.end();
+
+            LogManager::getSingleton().logMessage(std::format(
+                "OptimisedUtilProfiler: {} - impl {} = {} avg ticks\n", __FUNCTION__, index, profile.mAvgTicks));
+
+            // You can put break point here while running test application, to
+            // watch profile results.
+            ++index;    // So we can put break point here even if in release build
+        }
+
     };
 #endif // __DO_PROFILE__
 
     //---------------------------------------------------------------------
     OptimisedUtil* OptimisedUtil::msImplementation = OptimisedUtil::_detectImplementation();
 
+    //---------------------------------------------------------------------
+    auto OptimisedUtil::_getGeneralImplementation() -> OptimisedUtil*
+    {
+        return _getOptimisedUtilGeneral();
+    }
+
     //---------------------------------------------------------------------
     auto OptimisedUtil::_detectImplementation() -> OptimisedUtil*
     {
@@ -356,14 +848,28 @@ namespace Ogre {
 
 #else   // !__DO_PROFILE__
 
-        if ((PlatformInformation::getCpuFeatures() & PlatformInformation::CpuFeatures::SSE) != PlatformInformation::CpuFeatures{})
+#if defined(__ARM_NEON) && defined(__aarch64__)
+        if (PlatformInformation::hasCpuFeature(PlatformInformation::CpuFeatures::NEON))
         {
-            return _getOptimisedUtilSSE();
+            return _getOptimisedUtilNEON();
+        }
+#endif
+
+#if defined(__i386__) || defined(__x86_64__)
+        // AVX2 code relies on FMA as well, every CPU with AVX2 so far has both
+        if (PlatformInformation::hasCpuFeature(PlatformInformation::CpuFeatures::AVX2) &&
+            PlatformInformation::hasCpuFeature(PlatformInformation::CpuFeatures::FMA))
+        {
+            return _getOptimisedUtilAVX2();
         }
-        else
+
+        if ((PlatformInformation::getCpuFeatures() & PlatformInformation::CpuFeatures::SSE) != PlatformInformation::CpuFeatures{})
         {
-            return _getOptimisedUtilGeneral();
+            return _getOptimisedUtilSSE();
         }
+#endif
+
+        return _getOptimisedUtilGeneral();
 
 #endif  // __DO_PROFILE__
     }
@@ -0,0 +1,1363 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+module;
+
+#if defined(__i386__) || defined(__x86_64__)
+#include <immintrin.h>
+#endif
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+
+module Ogre.Core;
+
+#if defined(__i386__) || defined(__x86_64__)
+
+import :EdgeListBuilder;
+import :Math;
+import :Matrix4;
+import :OptimisedUtil;
+import :Platform;
+import :Prerequisites;
+import :Quaternion;
+import :Ray;
+import :Vector;
+
+import <algorithm>;
+
+//-------------------------------------------------------------------------
+//
+// The project is compiled for SSE only, so instead of raising the compiler
+// flags of this file, every routine using AVX2 or FMA instructions carries
+// its own target attribute. This way no AVX code can leak into inline
+// functions shared with other translation units, and the implementation is
+// only ever entered after OptimisedUtil detected AVX2 and FMA at run-time.
+//
+// Data is processed eight elements at a time in structure-of-arrays form
+// where the layout allows it (gathers for indexed or strided input), and
+// one element at a time with masked loads/stores of three floats otherwise.
+//
+//-------------------------------------------------------------------------
+#define OGRE_AVX2_TARGET __attribute__((target("avx2,fma")))
+
+namespace Ogre {
+
+//-------------------------------------------------------------------------
+// Local classes
+//-------------------------------------------------------------------------
+
+    /** AVX2 implementation of OptimisedUtil.
+    @note
+        Don't use this class directly, use OptimisedUtil instead.
+    */
+    class OptimisedUtilAVX2 : public OptimisedUtil
+    {
+    public:
+        /// @copydoc OptimisedUtil::softwareVertexSkinning
+        void softwareVertexSkinning(
+            const float *srcPosPtr, float *destPosPtr,
+            const float *srcNormPtr, float *destNormPtr,
+            const float *blendWeightPtr, const unsigned char* blendIndexPtr,
+            const Affine3* const* blendMatrices,
+            size_t srcPosStride, size_t destPosStride,
+            size_t srcNormStride, size_t destNormStride,
+            size_t blendWeightStride, size_t blendIndexStride,
+            size_t numWeightsPerVertex,
+            size_t numVertices) override;
+
+        /// @copydoc OptimisedUtil::softwareVertexMorph
+        void softwareVertexMorph(
+            Real t,
+            const float *srcPos1, const float *srcPos2,
+            float *dstPos,
+            size_t pos1VSize, size_t pos2VSize, size_t dstVSize,
+            size_t numVertices,
+            bool morphNormals) override;
+
+        /// @copydoc OptimisedUtil::concatenateAffineMatrices
+        void concatenateAffineMatrices(
+            const Affine3& baseMatrix,
+            const Affine3* srcMatrices,
+            Affine3* dstMatrices,
+            size_t numMatrices) override;
+
+        /// @copydoc OptimisedUtil::multiplyMatrices
+        void multiplyMatrices(
+            const Matrix4* lhsMatrices,
+            const Matrix4* rhsMatrices,
+            Matrix4* dstMatrices,
+            size_t numMatrices) override;
+
+        /// @copydoc OptimisedUtil::multiplyAffineMatrices
+        void multiplyAffineMatrices(
+            const Affine3* lhsMatrices,
+            const Affine3* rhsMatrices,
+            Affine3* dstMatrices,
+            size_t numMatrices) override;
+
+        /// @copydoc OptimisedUtil::inverseAffineMatrices
+        void inverseAffineMatrices(
+            const Affine3* srcMatrices,
+            Affine3* dstMatrices,
+            size_t numMatrices) override;
+
+        /// @copydoc OptimisedUtil::transformPoints
+        void transformPoints(
+            const Affine3& matrix,
+            const Vector3* srcPoints,
+            Vector3* dstPoints,
+            size_t numPoints) override;
+
+        /// @copydoc OptimisedUtil::transformDirections
+        void transformDirections(
+            const Affine3& matrix,
+            const Vector3* srcDirections,
+            Vector3* dstDirections,
+            size_t numDirections) override;
+
+        /// @copydoc OptimisedUtil::slerpQuaternions
+        void slerpQuaternions(
+            const Quaternion* from, const Quaternion* to,
+            const float* t,
+            Quaternion* dst,
+            size_t numQuaternions,
+            bool shortestPath) override;
+
+        /// @copydoc OptimisedUtil::nlerpQuaternions
+        void nlerpQuaternions(
+            const Quaternion* from, const Quaternion* to,
+            const float* t,
+            Quaternion* dst,
+            size_t numQuaternions,
+            bool shortestPath) override;
+
+        /// @copydoc OptimisedUtil::intersectRayBoxes
+        void intersectRayBoxes(
+            const Ray& ray,
+            const Math::BoxArrays& boxes,
+            Real* distances,
+            size_t numBoxes) override;
+
+        /// @copydoc OptimisedUtil::intersectRayTriangles
+        void intersectRayTriangles(
+            const Ray& ray,
+            const Math::TriangleArrays& triangles,
+            Real* distances,
+            size_t numTriangles,
+            bool positiveSide,
+            bool negativeSide) override;
+
+        /// @copydoc OptimisedUtil::calculateFaceNormals
+        void calculateFaceNormals(
+            const float *positions,
+            const EdgeData::Triangle *triangles,
+            Vector4 *faceNormals,
+            size_t numTriangles) override;
+
+        /// @copydoc OptimisedUtil::calculateLightFacing
+        void calculateLightFacing(
+            const Vector4& lightPos,
+            const Vector4* faceNormals,
+            char* lightFacings,
+            size_t numFaces) override;
+
+        /// @copydoc OptimisedUtil::extrudeVertices
+        void extrudeVertices(
+            const Vector4& lightPos,
+            Real extrudeDist,
+            const float* srcPositions,
+            float* destPositions,
+            size_t numVertices) override;
+
+        /// @copydoc OptimisedUtil::cullBoxes
+        void cullBoxes(
+            const float* planes, size_t numPlanes,
+            const float* centreX, const float* centreY, const float* centreZ,
+            const float* halfSizeX, const float* halfSizeY, const float* halfSizeZ,
+            uint8* visible,
+            size_t numBoxes) override;
+
+        /// @copydoc OptimisedUtil::integrateArrays
+        void integrateArrays(
+            float* posX, float* posY, float* posZ,
+            const float* velX, const float* velY, const float* velZ,
+            float timeElapsed,
+            size_t count) override;
+
+        /// @copydoc OptimisedUtil::calculatePlaneDistances
+        void calculatePlaneDistances(
+            const float* plane,
+            const float* posX, const float* posY, const float* posZ,
+            float* distances,
+            size_t count) override;
+
+        /// @copydoc OptimisedUtil::shuffleChannels
+        void shuffleChannels(
+            const uint8* src, size_t srcBytes,
+            uint8* dst, size_t dstBytes,
+            const uint8* shuffle,
+            size_t numPixels) override;
+
+        /// @copydoc OptimisedUtil::convertUnormToFloat
+        void convertUnormToFloat(const uint8* src, float* dst, size_t count) override;
+
+        /// @copydoc OptimisedUtil::convertFloatToUnorm
+        void convertFloatToUnorm(const float* src, uint8* dst, size_t count) override;
+
+        /// @copydoc OptimisedUtil::convertHalfToFloat
+        void convertHalfToFloat(const uint16* src, float* dst, size_t count) override;
+
+        /// @copydoc OptimisedUtil::convertFloatToHalf
+        void convertFloatToHalf(const float* src, uint16* dst, size_t count) override;
+    };
+
+//-------------------------------------------------------------------------
+// Local helpers
+//-------------------------------------------------------------------------
+namespace {
+    /// Lanes selected by load3/store3
+    OGRE_AVX2_TARGET inline auto _mask3() -> __m128i
+    {
+        return _mm_setr_epi32(-1, -1, -1, 0);
+    }
+
+    /// Loads three floats, the w component is zero. Never touches memory past the third float.
+    OGRE_AVX2_TARGET inline auto load3(const float* p) -> __m128
+    {
+        return _mm_maskload_ps(p, _mask3());
+    }
+
+    /// Stores the x, y, z components. Never touches memory past the third float.
+    OGRE_AVX2_TARGET inline void store3(float* p, __m128 v)
+    {
+        _mm_maskstore_ps(p, _mask3(), v);
+    }
+
+    /// Returns (r0.v, r1.v, r2.v, 0)
+    OGRE_AVX2_TARGET inline auto transformRows(__m128 r0, __m128 r1, __m128 r2, __m128 v) -> __m128
+    {
+        __m128 h01 = _mm_hadd_ps(_mm_mul_ps(r0, v), _mm_mul_ps(r1, v));
+        __m128 h2 = _mm_hadd_ps(_mm_mul_ps(r2, v), _mm_setzero_ps());
+        return _mm_hadd_ps(h01, h2);
+    }
+
+    /// Normalises the x, y, z components, zero length vectors are left unchanged like Vector3::normalise
+    OGRE_AVX2_TARGET inline auto normalise3(__m128 v) -> __m128
+    {
+        __m128 sqLength = _mm_dp_ps(v, v, 0x7F);
+        __m128 normalised = _mm_div_ps(v, _mm_sqrt_ps(sqLength));
+        return _mm_blendv_ps(v, normalised, _mm_cmpgt_ps(sqLength, _mm_setzero_ps()));
+    }
+
+    /// Linear interpolation a + t * (b - a)
+    OGRE_AVX2_TARGET inline auto lerp(__m128 t, __m128 a, __m128 b) -> __m128
+    {
+        return _mm_fmadd_ps(t, _mm_sub_ps(b, a), a);
+    }
+
+    /// Cross product of the x, y, z components, with a w component of a.w * b.w - b.w * a.w, so 0
+    OGRE_AVX2_TARGET inline auto cross3(__m128 a, __m128 b) -> __m128
+    {
+        __m128 aYZX = _mm_permute_ps(a, _MM_SHUFFLE(3,0,2,1));
+        __m128 bYZX = _mm_permute_ps(b, _MM_SHUFFLE(3,0,2,1));
+        __m128 c = _mm_fmsub_ps(a, bYZX, _mm_mul_ps(aYZX, b));
+        return _mm_permute_ps(c, _MM_SHUFFLE(3,0,2,1));
+    }
+
+    /// Loads the 128 bit rows p and p + 4 * stride into the halves of a register
+    OGRE_AVX2_TARGET inline auto loadHalves(const float* p, size_t stride) -> __m256
+    {
+        return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(p)), _mm_loadu_ps(p + 4 * stride), 1);
+    }
+
+    OGRE_AVX2_TARGET inline void storeHalves(float* p, size_t stride, __m256 v)
+    {
+        _mm_storeu_ps(p, _mm256_castps256_ps128(v));
+        _mm_storeu_ps(p + 4 * stride, _mm256_extractf128_ps(v, 1));
+    }
+
+    /** Transforms packed xyz vectors eight at a time, returns how many.
+    @remarks
+        Vectors 0 to 3 go to the low halves of the registers and 4 to 7 to the high ones,
+        where the shuffles of __MM_TRANSPOSE4x3_PS and __MM_TRANSPOSE3x4_PS apply per half.
+    */
+    template <bool translate>
+    OGRE_AVX2_TARGET inline auto transformVectors8(const Affine3& matrix, const float* pSrc, float* pDst,
+                                                   size_t numVectors) -> size_t
+    {
+        __m256 m[3][4];
+        for (size_t r = 0; r < 3; ++r)
+            for (size_t c = 0; c < 4; ++c)
+                m[r][c] = _mm256_set1_ps(c < 3 || translate ? matrix[r][c] : 0);
+
+        size_t numIterations = numVectors / 8;
+        for (size_t i = 0; i < numIterations; ++i)
+        {
+            __m256 v0 = loadHalves(pSrc + 0, 3);
+            __m256 v1 = loadHalves(pSrc + 4, 3);
+            __m256 v2 = loadHalves(pSrc + 8, 3);
+
+            // xyz rows to x, y and z of four vectors per half
+            __m256 t0 = _mm256_shuffle_ps(v0, v2, _MM_SHUFFLE(3,0,3,0));
+            __m256 t1 = _mm256_shuffle_ps(v0, v1, _MM_SHUFFLE(1,0,2,1));
+            __m256 t2 = _mm256_shuffle_ps(v1, v2, _MM_SHUFFLE(2,1,3,2));
+            __m256 x = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(2,0,1,0));
+            __m256 y = _mm256_shuffle_ps(t1, t2, _MM_SHUFFLE(3,1,2,0));
+            __m256 z = _mm256_shuffle_ps(t1, t0, _MM_SHUFFLE(3,2,3,1));
+
+            __m256 d[3];
+            for (size_t r = 0; r < 3; ++r)
+                d[r] = _mm256_fmadd_ps(m[r][0], x, _mm256_fmadd_ps(m[r][1], y, _mm256_fmadd_ps(m[r][2], z, m[r][3])));
+
+            // and back
+            t0 = _mm256_shuffle_ps(d[0], d[2], _MM_SHUFFLE(2,0,3,1));
+            t1 = _mm256_shuffle_ps(d[1], d[2], _MM_SHUFFLE(3,1,3,1));
+            t2 = _mm256_shuffle_ps(d[0], d[1], _MM_SHUFFLE(2,0,2,0));
+            storeHalves(pDst + 0, 3, _mm256_shuffle_ps(t2, t0, _MM_SHUFFLE(0,2,2,0)));
+            storeHalves(pDst + 4, 3, _mm256_shuffle_ps(t1, t2, _MM_SHUFFLE(3,1,2,0)));
+            storeHalves(pDst + 8, 3, _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(3,1,1,3)));
+            pSrc += 24;
+            pDst += 24;
+        }
+        return numIterations * 8;
+    }
+
+    /// Transposes the 4x4 matrix in each half
+    OGRE_AVX2_TARGET inline void transpose4x4(__m256& r0, __m256& r1, __m256& r2, __m256& r3)
+    {
+        __m256 t0 = _mm256_unpacklo_ps(r0, r1);
+        __m256 t1 = _mm256_unpacklo_ps(r2, r3);
+        __m256 t2 = _mm256_unpackhi_ps(r0, r1);
+        __m256 t3 = _mm256_unpackhi_ps(r2, r3);
+        r0 = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(1,0,1,0));
+        r1 = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(3,2,3,2));
+        r2 = _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(1,0,1,0));
+        r3 = _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(3,2,3,2));
+    }
+
+    /// Loads eight quaternions as their w, x, y and z components, in order
+    OGRE_AVX2_TARGET inline void loadQuaternions8(const Quaternion* q, __m256& w, __m256& x, __m256& y, __m256& z)
+    {
+        w = loadHalves(q[0].ptr(), 4);
+        x = loadHalves(q[1].ptr(), 4);
+        y = loadHalves(q[2].ptr(), 4);
+        z = loadHalves(q[3].ptr(), 4);
+        transpose4x4(w, x, y, z);
+    }
+
+    OGRE_AVX2_TARGET inline void storeQuaternions8(Quaternion* q, __m256 w, __m256 x, __m256 y, __m256 z)
+    {
+        transpose4x4(w, x, y, z);
+        storeHalves(q[0].ptr(), 4, w);
+        storeHalves(q[1].ptr(), 4, x);
+        storeHalves(q[2].ptr(), 4, y);
+        storeHalves(q[3].ptr(), 4, z);
+    }
+
+    /// sin(t * angle) / sin(angle) for cos(angle) - 1 in xm1, see OptimisedUtil::SLERP_U
+    OGRE_AVX2_TARGET inline auto slerpCoefficient(__m256 t, __m256 xm1) -> __m256
+    {
+        __m256 sqT = _mm256_mul_ps(t, t);
+        __m256 f = _mm256_set1_ps(1.0f);
+        for (size_t i = OptimisedUtil::SLERP_TERMS; i-- > 0;)
+        {
+            __m256 b = _mm256_mul_ps(_mm256_fmsub_ps(_mm256_set1_ps(OptimisedUtil::SLERP_U[i]), sqT,
+                                                     _mm256_set1_ps(OptimisedUtil::SLERP_V[i])), xm1);
+            f = _mm256_fmadd_ps(b, f, _mm256_set1_ps(1.0f));
+        }
+        return _mm256_mul_ps(t, f);
+    }
+}
+    //---------------------------------------------------------------------
+    //---------------------------------------------------------------------
+    //---------------------------------------------------------------------
+    OGRE_AVX2_TARGET
+    void OptimisedUtilAVX2::softwareVertexSkinning(
+        const float *pSrcPos, float *pDestPos,
+        const float *pSrcNorm, float *pDestNorm,
+        const float *pBlendWeight, const unsigned char* pBlendIndex,
+        const Affine3* const* blendMatrices,
+        size_t srcPosStride, size_t destPosStride,
+        size_t srcNormStride, size_t destNormStride,
+        size_t blendWeightStride, size_t blendIndexStride,
+        size_t numWeightsPerVertex,
+        size_t numVertices)
+    {
+        // Each vertex blends its matrices first, rows 0 and 1 in one register
+        // and row 2 in another, then transforms position and normal once.
+        const __m128 unitW = _mm_setr_ps(0, 0, 0, 1);
+
+        for (size_t vertIdx = 0; vertIdx < numVertices; ++vertIdx)
+        {
+            __m256 m01 = _mm256_setzero_ps();
+            __m128 m2 = _mm_setzero_ps();
+
+            for (size_t blendIdx = 0; blendIdx < numWeightsPerVertex; ++blendIdx)
+            {
+                // NB weights must be normalised!!
+                float weight = pBlendWeight[blendIdx];
+                if (weight)
+                {
+                    const float* mat = (*blendMatrices[pBlendIndex[blendIdx]])[0];
+                    __m256 w = _mm256_set1_ps(weight);
+                    m01 = _mm256_fmadd_ps(_mm256_loadu_ps(mat), w, m01);
+                    m2 = _mm_fmadd_ps(_mm_loadu_ps(mat + 8), _mm256_castps256_ps128(w), m2);
+                }
+            }
+
+            __m128 m0 = _mm256_castps256_ps128(m01);
+            __m128 m1 = _mm256_extractf128_ps(m01, 1);
+
+            // Blend position, use 3x4 matrix
+            __m128 pos = _mm_or_ps(load3(pSrcPos), unitW);
+            store3(pDestPos, transformRows(m0, m1, m2, pos));
+
+            if (pSrcNorm)
+            {
+                // Blend normal, assuming the 3x3 aspect of the matrix is orthogonal
+                // (no non-uniform scaling), so the inverse transpose is the matrix itself
+                __m128 norm = transformRows(m0, m1, m2, load3(pSrcNorm));
+                store3(pDestNorm, normalise3(norm));
+
+                advanceRawPointer(pSrcNorm, srcNormStride);
+                advanceRawPointer(pDestNorm, destNormStride);
+            }
+
+            advanceRawPointer(pSrcPos, srcPosStride);
+            advanceRawPointer(pDestPos, destPosStride);
+            advanceRawPointer(pBlendWeight, blendWeightStride);
+            advanceRawPointer(pBlendIndex, blendIndexStride);
+        }
+    }
+    //---------------------------------------------------------------------
+    OGRE_AVX2_TARGET
+    void OptimisedUtilAVX2::concatenateAffineMatrices(
+        const Affine3& baseMatrix,
+        const Affine3* pSrcMat,
+        Affine3* pDstMat,
+        size_t numMatrices)
+    {
+        // Broadcast the base coefficients once, rows 0 and 1 share a register
+        const float* b = baseMatrix[0];
+        __m256 b01[3];
+        __m128 b2[3];
+        for (int k = 0; k < 3; ++k)
+        {
+            b01[k] = _mm256_setr_m128(_mm_set1_ps(b[k]), _mm_set1_ps(b[4 + k]));
+            b2[k] = _mm_set1_ps(b[8 + k]);
+        }
+        // Base translation times the implicit (0, 0, 0, 1) last source row
+        const __m256 t01 = _mm256_setr_ps(0, 0, 0, b[3], 0, 0, 0, b[7]);
+        const __m128 t2 = _mm_setr_ps(0, 0, 0, b[11]);
+
+        for (size_t i = 0; i < numMatrices; ++i)
+        {
+            const float* s = (*pSrcMat)[0];
+            __m256 s0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(s + 0));
+            __m256 s1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(s + 4));
+            __m256 s2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(s + 8));
+
+            __m256 d01 = _mm256_fmadd_ps(b01[0], s0, _mm256_fmadd_ps(b01[1], s1, _mm256_fmadd_ps(b01[2], s2, t01)));
+            __m128 d2 = _mm_fmadd_ps(b2[0], _mm256_castps256_ps128(s0),
+                        _mm_fmadd_ps(b2[1], _mm256_castps256_ps128(s1),
+                        _mm_fmadd_ps(b2[2], _mm256_castps256_ps128(s2), t2)));
+
+            float* d = (*pDstMat)[0];
+            _mm256_storeu_ps(d, d01);
+            _mm_storeu_ps(d + 8, d2);
+
+            ++pSrcMat;
+            ++pDstMat;
+        }
+    }
+    //---------------------------------------------------------------------
+    OGRE_AVX2_TARGET
+    void OptimisedUtilAVX2::softwareVertexMorph(
+        Real t,
+        const float *pSrc1, const float *pSrc2,
+        float *pDst,
+        size_t pos1VSize, size_t pos2VSize, size_t dstVSize,
+        size_t numVertices,
+        bool morphNormals)
+    {
+        if (!morphNormals && pos1VSize == 3 * sizeof(float) && pos2VSize == 3 * sizeof(float) &&
+            dstVSize == 3 * sizeof(float))
+        {
+            // Packed positions, morph as one flat float array
+            const __m256 tv = _mm256_set1_ps(t);
+            size_t numFloats = numVertices * 3;
+            size_t i = 0;
+            for (; i + 8 <= numFloats; i += 8)
+            {
+                __m256 a = _mm256_loadu_ps(pSrc1 + i);
+                __m256 b = _mm256_loadu_ps(pSrc2 + i);
+                _mm256_storeu_ps(pDst + i, _mm256_fmadd_ps(tv, _mm256_sub_ps(b, a), a));
+            }
+            for (; i < numFloats; ++i)
+            {
+                pDst[i] = pSrc1[i] + t * (pSrc2[i] - pSrc1[i]);
+            }
+            return;
+        }
+
+        const __m128 tv = _mm_set1_ps(t);
+        for (size_t i = 0; i < numVertices; ++i)
+        {
+            store3(pDst, lerp(tv, load3(pSrc1), load3(pSrc2)));
+
+            if (morphNormals)
+            {
+                // normals must be in the same buffer as pos
+                // perform an nlerp
+                // we don't have enough information for a spherical interp
+                store3(pDst + 3, normalise3(lerp(tv, load3(pSrc1 + 3), load3(pSrc2 + 3))));
+            }
+
+            advanceRawPointer(pSrc1, pos1VSize);
+            advanceRawPointer(pSrc2, pos2VSize);
+            advanceRawPointer(pDst, dstVSize);
+        }
+    }
+    //---------------------------------------------------------------------
+    OGRE_AVX2_TARGET
+    void OptimisedUtilAVX2::calculateFaceNormals(
+        const float *positions,
+        const EdgeData::Triangle *triangles,
+        Vector4 *faceNormals,
+        size_t numTriangles)
+    {
+        const __m256 signMask = _mm256_set1_ps(-0.0f);
+        auto* pDest = reinterpret_cast<float*>(faceNormals);
+
+        size_t numIterations = numTriangles / 8;
+        for (size_t i = 0; i < numIterations; ++i)
+        {
+            alignas(32) int offsets[3][8];
+            for (int k = 0; k < 8; ++k)
+            {
+                offsets[0][k] = static_cast<int>(triangles[k].vertIndex[0] * 3);
+                offsets[1][k] = static_cast<int>(triangles[k].vertIndex[1] * 3);
+                offsets[2][k] = static_cast<int>(triangles[k].vertIndex[2] * 3);
+            }
+            triangles += 8;
+
+            // Gather the vertex positions of eight triangles, one triangle per lane
+            __m256 x[3], y[3], z[3];
+            for (int v = 0; v < 3; ++v)
+            {
+                __m256i o = _mm256_load_si256(reinterpret_cast<const __m256i*>(offsets[v]));
+                x[v] = _mm256_i32gather_ps(positions + 0, o, 4);
+                y[v] = _mm256_i32gather_ps(positions + 1, o, 4);
+                z[v] = _mm256_i32gather_ps(positions + 2, o, 4);
+            }
+
+            // normal = (v2 - v1) x (v3 - v1)
+            __m256 ax = _mm256_sub_ps(x[1], x[0]), ay = _mm256_sub_ps(y[1], y[0]), az = _mm256_sub_ps(z[1], z[0]);
+            __m256 bx = _mm256_sub_ps(x[2], x[0]), by = _mm256_sub_ps(y[2], y[0]), bz = _mm256_sub_ps(z[2], z[0]);
+            __m256 nx = _mm256_fmsub_ps(ay, bz, _mm256_mul_ps(az, by));
+            __m256 ny = _mm256_fmsub_ps(az, bx, _mm256_mul_ps(ax, bz));
+            __m256 nz = _mm256_fmsub_ps(ax, by, _mm256_mul_ps(ay, bx));
+
+            // distance = -(normal . v1)
+            __m256 nw = _mm256_fmadd_ps(nz, z[0], _mm256_fmadd_ps(ny, y[0], _mm256_mul_ps(nx, x[0])));
+            nw = _mm256_xor_ps(nw, signMask);
+
+            // Transpose to eight (x, y, z, w) vectors
+            __m256 t0 = _mm256_unpacklo_ps(nx, ny);                     // x0 y0 x1 y1 | x4 y4 x5 y5
+            __m256 t1 = _mm256_unpackhi_ps(nx, ny);                     // x2 y2 x3 y3 | x6 y6 x7 y7
+            __m256 t2 = _mm256_unpacklo_ps(nz, nw);                     // z0 w0 z1 w1 | z4 w4 z5 w5
+            __m256 t3 = _mm256_unpackhi_ps(nz, nw);                     // z2 w2 z3 w3 | z6 w6 z7 w7
+            __m256 f04 = _mm256_shuffle_ps(t0, t2, 0x44);               // face 0 | face 4
+            __m256 f15 = _mm256_shuffle_ps(t0, t2, 0xEE);               // face 1 | face 5
+            __m256 f26 = _mm256_shuffle_ps(t1, t3, 0x44);               // face 2 | face 6
+            __m256 f37 = _mm256_shuffle_ps(t1, t3, 0xEE);               // face 3 | face 7
+
+            _mm256_storeu_ps(pDest +  0, _mm256_permute2f128_ps(f04, f15, 0x20));
+            _mm256_storeu_ps(pDest +  8, _mm256_permute2f128_ps(f26, f37, 0x20));
+            _mm256_storeu_ps(pDest + 16, _mm256_permute2f128_ps(f04, f15, 0x31));
+            _mm256_storeu_ps(pDest + 24, _mm256_permute2f128_ps(f26, f37, 0x31));
+            pDest += 32;
+        }
+
+        // Leftover triangles
+        faceNormals = reinterpret_cast<Vector4*>(pDest);
+        for (size_t i = 0; i < numTriangles % 8; ++i)
+        {
+            const EdgeData::Triangle& t = *triangles++;
+            const float* v1 = positions + t.vertIndex[0] * 3;
+            const float* v2 = positions + t.vertIndex[1] * 3;
+            const float* v3 = positions + t.vertIndex[2] * 3;
+
+            *faceNormals++ = Math::calculateFaceNormalWithoutNormalize(
+                Vector3{v1[0], v1[1], v1[2]}, Vector3{v2[0], v2[1], v2[2]}, Vector3{v3[0], v3[1], v3[2]});
+        }
+    }
+    //---------------------------------------------------------------------
+    OGRE_AVX2_TARGET
+    void OptimisedUtilAVX2::calculateLightFacing(
+        const Vector4& lightPos,
+        const Vector4* faceNormals,
+        char* lightFacings,
+        size_t numFaces)
+    {
+        const __m256 light = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(lightPos.ptr()));
+        // Restores face order after the horizontal adds, see below
+        const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+        const auto* pSrc = reinterpret_cast<const float*>(faceNormals);
+
+        size_t numIterations = numFaces / 8;
+        for (size_t i = 0; i < numIterations; ++i)
+        {
+            // Two faces per register, one per 128-bit lane
+            __m256 m01 = _mm256_mul_ps(_mm256_loadu_ps(pSrc +  0), light);
+            __m256 m23 = _mm256_mul_ps(_mm256_loadu_ps(pSrc +  8), light);
+            __m256 m45 = _mm256_mul_ps(_mm256_loadu_ps(pSrc + 16), light);
+            __m256 m67 = _mm256_mul_ps(_mm256_loadu_ps(pSrc + 24), light);
+            pSrc += 32;
+
+            // Dot products ordered as 0 2 4 6 | 1 3 5 7
+            __m256 dots = _mm256_hadd_ps(_mm256_hadd_ps(m01, m23), _mm256_hadd_ps(m45, m67));
+            dots = _mm256_permutevar8x32_ps(dots, order);
+
+            int mask = _mm256_movemask_ps(_mm256_cmp_ps(dots, _mm256_setzero_ps(), _CMP_GT_OQ));
+            for (int k = 0; k < 8; ++k)
+                lightFacings[k] = (mask >> k) & 1;
+            lightFacings += 8;
+        }
+
+        // Leftover faces
+        faceNormals = reinterpret_cast<const Vector4*>(pSrc);
+        for (size_t i = 0; i < numFaces % 8; ++i)
+        {
+            *lightFacings++ = (lightPos.dotProduct(*faceNormals++) > 0);
+        }
+    }
+    //---------------------------------------------------------------------
+    OGRE_AVX2_TARGET
+    void OptimisedUtilAVX2::extrudeVertices(
+        const Vector4& lightPos,
+        Real extrudeDist,
+        const float* pSrcPos,
+        float* pDestPos,
+        size_t numVertices)
+    {
+        size_t numIterations = numVertices / 8;
+
+        if (lightPos.w == 0.0f)
+        {
+            // Directional light, extrusion is along light direction
+            Vector3 extrusionDir{-lightPos.x, -lightPos.y, -lightPos.z};
+            extrusionDir.normalise();
+            extrusionDir *= extrudeDist;
+
+            // Eight packed vertices are three registers, the offset repeats every three floats
+            const float ex = extrusionDir.x, ey = extrusionDir.y, ez = extrusionDir.z;
+            const __m256 dir0 = _mm256_setr_ps(ex, ey, ez, ex, ey, ez, ex, ey);
+            const __m256 dir1 = _mm256_setr_ps(ez, ex, ey, ez, ex, ey, ez, ex);
+            const __m256 dir2 = _mm256_setr_ps(ey, ez, ex, ey, ez, ex, ey, ez);
+
+            for (size_t i = 0; i < numIterations; ++i)
+            {
+                _mm256_storeu_ps(pDestPos +  0, _mm256_add_ps(_mm256_loadu_ps(pSrcPos +  0), dir0));
+                _mm256_storeu_ps(pDestPos +  8, _mm256_add_ps(_mm256_loadu_ps(pSrcPos +  8), dir1));
+                _mm256_storeu_ps(pDestPos + 16, _mm256_add_ps(_mm256_loadu_ps(pSrcPos + 16), dir2));
+                pSrcPos += 24;
+                pDestPos += 24;
+            }
+
+            for (size_t vert = 0; vert < numVertices % 8; ++vert)
+            {
+                *pDestPos++ = *pSrcPos++ + ex;
+                *pDestPos++ = *pSrcPos++ + ey;
+                *pDestPos++ = *pSrcPos++ + ez;
+            }
+        }
+        else
+        {
+            // Point light, calculate extrusionDir for every vertex
+            assert(lightPos.w == 1.0f);
+
+            const __m256i offsets = _mm256_setr_epi32(0, 3, 6, 9, 12, 15, 18, 21);
+            const __m256 lx = _mm256_set1_ps(lightPos.x);
+            const __m256 ly = _mm256_set1_ps(lightPos.y);
+            const __m256 lz = _mm256_set1_ps(lightPos.z);
+            const __m256 dist = _mm256_set1_ps(extrudeDist);
+            const __m256 zero = _mm256_setzero_ps();
+
+            for (size_t i = 0; i < numIterations; ++i)
+            {
+                __m256 px = _mm256_i32gather_ps(pSrcPos + 0, offsets, 4);
+                __m256 py = _mm256_i32gather_ps(pSrcPos + 1, offsets, 4);
+                __m256 pz = _mm256_i32gather_ps(pSrcPos + 2, offsets, 4);
+
+                __m256 dx = _mm256_sub_ps(px, lx), dy = _mm256_sub_ps(py, ly), dz = _mm256_sub_ps(pz, lz);
+                __m256 sqLength = _mm256_fmadd_ps(dz, dz, _mm256_fmadd_ps(dy, dy, _mm256_mul_ps(dx, dx)));
+                // zero length directions stay zero, like Vector3::normalise
+                __m256 scale = _mm256_div_ps(dist, _mm256_sqrt_ps(sqLength));
+                scale = _mm256_blendv_ps(zero, scale, _mm256_cmp_ps(sqLength, zero, _CMP_GT_OQ));
+
+                alignas(32) float result[3][8];
+                _mm256_store_ps(result[0], _mm256_fmadd_ps(dx, scale, px));
+                _mm256_store_ps(result[1], _mm256_fmadd_ps(dy, scale, py));
+                _mm256_store_ps(result[2], _mm256_fmadd_ps(dz, scale, pz));
+                for (int k = 0; k < 8; ++k)
+                {
+                    *pDestPos++ = result[0][k];
+                    *pDestPos++ = result[1][k];
+                    *pDestPos++ = result[2][k];
+                }
+                pSrcPos += 24;
+            }
+
+            for (size_t vert = 0; vert < numVertices % 8; ++vert)
+            {
+                Vector3 extrusionDir{
+                    pSrcPos[0] - lightPos.x,
+                    pSrcPos[1] - lightPos.y,
+                    pSrcPos[2] - lightPos.z};
+                extrusionDir.normalise();
+                extrusionDir *= extrudeDist;
+
+                *pDestPos++ = *pSrcPos++ + extrusionDir.x;
+                *pDestPos++ = *pSrcPos++ + extrusionDir.y;
+                *pDestPos++ = *pSrcPos++ + extrusionDir.z;
+            }
+        }
+    }
+    //---------------------------------------------------------------------
+    OGRE_AVX2_TARGET
+    void OptimisedUtilAVX2::cullBoxes(
+        const float* planes, size_t numPlanes,
+        const float* centreX, const float* centreY, const float* centreZ,
+        const float* halfSizeX, const float* halfSizeY, const float* halfSizeZ,
+        uint8* visible,
+        size_t numBoxes)
+    {
+        // Eight boxes per iteration, one box per lane. Each plane is broadcast,
+        // so the box data is read exactly once.
+        const __m256 signMask = _mm256_set1_ps(-0.0f);
+        size_t numIterations = numBoxes / 8;
+        for (size_t i = 0; i < numIterations; ++i)
+        {
+            __m256 cx = _mm256_loadu_ps(centreX), cy = _mm256_loadu_ps(centreY), cz = _mm256_loadu_ps(centreZ);
+            __m256 hx = _mm256_loadu_ps(halfSizeX), hy = _mm256_loadu_ps(halfSizeY), hz = _mm256_loadu_ps(halfSizeZ);
+
+            __m256 culled = _mm256_setzero_ps();
+            for (const float* plane = planes; plane != planes + numPlanes * 4; plane += 4)
+            {
+                __m256 nx = _mm256_broadcast_ss(plane + 0);
+                __m256 ny = _mm256_broadcast_ss(plane + 1);
+                __m256 nz = _mm256_broadcast_ss(plane + 2);
+                __m256 d = _mm256_broadcast_ss(plane + 3);
+
+                // dist = normal . centre + d
+                __m256 dist = _mm256_fmadd_ps(nz, cz, _mm256_fmadd_ps(ny, cy, _mm256_fmadd_ps(nx, cx, d)));
+
+                // maxAbsDist = |normal| . halfSize
+                __m256 maxAbsDist = _mm256_fmadd_ps(_mm256_andnot_ps(signMask, nz), hz,
+                                    _mm256_fmadd_ps(_mm256_andnot_ps(signMask, ny), hy,
+                                    _mm256_mul_ps(_mm256_andnot_ps(signMask, nx), hx)));
+
+                // culled if dist < -maxAbsDist
+                culled = _mm256_or_ps(culled, _mm256_cmp_ps(dist, _mm256_xor_ps(maxAbsDist, signMask), _CMP_LT_OQ));
+            }
+
+            int mask = _mm256_movemask_ps(culled);
+            for (int k = 0; k < 8; ++k)
+                visible[k] = !(mask & (1 << k));
+
+            centreX += 8; centreY += 8; centreZ += 8;
+            halfSizeX += 8; halfSizeY += 8; halfSizeZ += 8;
+            visible += 8;
+        }
+
+        // Leftover boxes
+        for (size_t i = 0; i < numBoxes % 8; ++i)
+        {
+            uint8 result = 1;
+            for (const float* plane = planes; plane != planes + numPlanes * 4; plane += 4)
+            {
+                float dist = plane[0] * centreX[i] + plane[1] * centreY[i] + plane[2] * centreZ[i] + plane[3];
+                float maxAbsDist = std::abs(plane[0]) * halfSizeX[i] +
+                                   std::abs(plane[1]) * halfSizeY[i] +
+                                   std::abs(plane[2]) * halfSizeZ[i];
+                if (dist < -maxAbsDist)
+                {
+                    result = 0;
+                    break;
+                }
+            }
+            visible[i] = result;
+        }
+    }
+    //---------------------------------------------------------------------
+    OGRE_AVX2_TARGET
+    void OptimisedUtilAVX2::integrateArrays(
+        float* posX, float* posY, float* posZ,
+        const float* velX, const float* velY, const float* velZ,
+        float timeElapsed,
+        size_t count)
+    {
+        const __m256 t = _mm256_set1_ps(timeElapsed);
+        size_t numIterations = count / 8;
+        for (size_t i = 0; i < numIterations; ++i)
+        {
+            _mm256_storeu_ps(posX, _mm256_fmadd_ps(_mm256_loadu_ps(velX), t, _mm256_loadu_ps(posX)));
+            _mm256_storeu_ps(posY, _mm256_fmadd_ps(_mm256_loadu_ps(velY), t, _mm256_loadu_ps(posY)));
+            _mm256_storeu_ps(posZ, _mm256_fmadd_ps(_mm256_loadu_ps(velZ), t, _mm256_loadu_ps(posZ)));
+
+            posX += 8; posY += 8; posZ += 8;
+            velX += 8; velY += 8; velZ += 8;
+        }
+
+        // Leftover elements
+        for (size_t i = 0; i < count % 8; ++i)
+        {
+            posX[i] += velX[i] * timeElapsed;
+            posY[i] += velY[i] * timeElapsed;
+            posZ[i] += velZ[i] * timeElapsed;
+        }
+    }
+    //---------------------------------------------------------------------
+    OGRE_AVX2_TARGET
+    void OptimisedUtilAVX2::calculatePlaneDistances(
+        const float* plane,
+        const float* posX, const float* posY, const float* posZ,
+        float* distances,
+        size_t count)
+    {
+        const __m256 nx = _mm256_broadcast_ss(plane + 0);
+        const __m256 ny = _mm256_broadcast_ss(plane + 1);
+        const __m256 nz = _mm256_broadcast_ss(plane + 2);
+        const __m256 d = _mm256_broadcast_ss(plane + 3);
+        size_t numIterations = count / 8;
+        for (size_t i = 0; i < numIterations; ++i)
+        {
+            __m256 dist = _mm256_fmadd_ps(nx, _mm256_loadu_ps(posX), d);
+            dist = _mm256_fmadd_ps(ny, _mm256_loadu_ps(posY), dist);
+            _mm256_storeu_ps(distances, _mm256_fmadd_ps(nz, _mm256_loadu_ps(posZ), dist));
+
+            posX += 8; posY += 8; posZ += 8;
+            distances += 8;
+        }
+
+        // Leftover points
+        for (size_t i = 0; i < count % 8; ++i)
+            distances[i] = plane[0] * posX[i] + plane[1] * posY[i] + plane[2] * posZ[i] + plane[3];
+    }
+    //---------------------------------------------------------------------
+    extern auto _getOptimisedUtilGeneral() -> OptimisedUtil*;
+    //---------------------------------------------------------------------
+    OGRE_AVX2_TARGET
+    void OptimisedUtilAVX2::shuffleChannels(
+        const uint8* src, size_t srcBytes,
+        uint8* dst, size_t dstBytes,
+        const uint8* shuffle,
+        size_t numPixels)
+    {
+        // Four pixels per 128 bit lane. Each lane loads and stores 16 bytes, the
+        // bytes written past the fourth pixel are overwritten by the next store.
+        size_t minBytes = std::min(srcBytes, dstBytes);
+        size_t minPixels = std::max<size_t>(8, 4 + (16 + minBytes - 1) / minBytes);
+
+        alignas(16) uint8 indices[16];
+        alignas(16) uint8 fill[16];
+        for (size_t j = 0; j < 16; ++j)
+        {
+            size_t p = j / dstBytes;
+            uint8 from = shuffle[j % dstBytes];
+            indices[j] = p >= 4 || from == SHUFFLE_ONE || from == SHUFFLE_ZERO ? 0x80 : uint8(p * srcBytes + from);
+            fill[j] = p < 4 && from == SHUFFLE_ONE ? 0xFF : 0;
+        }
+        __m256i mask = _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i*)indices));
+        __m256i ones = _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i*)fill));
+
+        for (; numPixels >= minPixels; numPixels -= 8)
+        {
+            __m256i pixels = _mm256_inserti128_si256(
+                _mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)src)),
+                _mm_loadu_si128((const __m128i*)(src + 4 * srcBytes)), 1);
+            __m256i result = _mm256_or_si256(_mm256_shuffle_epi8(pixels, mask), ones);
+            _mm_storeu_si128((__m128i*)dst, _mm256_castsi256_si128(result));
+            _mm_storeu_si128((__m128i*)(dst + 4 * dstBytes), _mm256_extracti128_si256(result, 1));
+
+            src += 8 * srcBytes;
+            dst += 8 * dstBytes;
+        }
+
+        _getOptimisedUtilGeneral()->shuffleChannels(src, srcBytes, dst, dstBytes, shuffle, numPixels);
+    }
+    //---------------------------------------------------------------------
+    OGRE_AVX2_TARGET
+    void OptimisedUtilAVX2::convertUnormToFloat(const uint8* src, float* dst, size_t count)
+    {
+        const __m256 scale = _mm256_set1_ps(255.0f);
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            // divide like Bitwise::fixedToFloat, multiplying by the reciprocal is not exact
+            __m256i v = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(src + i)));
+            _mm256_storeu_ps(dst + i, _mm256_div_ps(_mm256_cvtepi32_ps(v), scale));
+        }
+
+        _getOptimisedUtilGeneral()->convertUnormToFloat(src + i, dst + i, count - i);
+    }
+    //---------------------------------------------------------------------
+    OGRE_AVX2_TARGET
+    void OptimisedUtilAVX2::convertFloatToUnorm(const float* src, uint8* dst, size_t count)
+    {
+        const __m256 scale = _mm256_set1_ps(256.0f);
+        const __m256 zero = _mm256_setzero_ps();
+        const __m256 maximum = _mm256_set1_ps(255.0f);
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            // clamped and truncated like Bitwise::floatToFixed, NaN gives 0
+            __m256 f = _mm256_mul_ps(_mm256_loadu_ps(src + i), scale);
+            __m256i v = _mm256_cvttps_epi32(_mm256_min_ps(_mm256_max_ps(f, zero), maximum));
+            __m128i words = _mm_packus_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+            _mm_storel_epi64((__m128i*)(dst + i), _mm_packus_epi16(words, words));
+        }
+
+        _getOptimisedUtilGeneral()->convertFloatToUnorm(src + i, dst + i, count - i);
+    }
+    //---------------------------------------------------------------------
+    OGRE_AVX2_TARGET
+    void OptimisedUtilAVX2::convertHalfToFloat(const uint16* src, float* dst, size_t count)
+    {
+        // There is no run-time check for F16C, so this emulates Bitwise::halfToFloatI
+        const __m256i expMask = _mm256_set1_epi32(0x0f800000);
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            __m256i h = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(src + i)));
+            __m256i o = _mm256_slli_epi32(_mm256_and_si256(h, _mm256_set1_epi32(0x7fff)), 13);
+            __m256i e = _mm256_and_si256(o, expMask);
+            o = _mm256_add_epi32(o, _mm256_set1_epi32((127 - 15) << 23));
+            // infinity and NaN keep the maximum exponent
+            __m256i infNan = _mm256_cmpeq_epi32(e, expMask);
+            o = _mm256_add_epi32(o, _mm256_and_si256(infNan, _mm256_set1_epi32((128 - 16) << 23)));
+            // zero and denormals are renormalised by a float subtraction
+            __m256i denormal = _mm256_cmpeq_epi32(e, _mm256_setzero_si256());
+            __m256i renormalised = _mm256_castps_si256(_mm256_sub_ps(
+                _mm256_castsi256_ps(_mm256_add_epi32(o, _mm256_set1_epi32(1 << 23))),
+                _mm256_castsi256_ps(_mm256_set1_epi32(113 << 23))));
+            o = _mm256_blendv_epi8(o, renormalised, denormal);
+            o = _mm256_or_si256(o, _mm256_slli_epi32(_mm256_and_si256(h, _mm256_set1_epi32(0x8000)), 16));
+            _mm256_storeu_ps(dst + i, _mm256_castsi256_ps(o));
+        }
+
+        _getOptimisedUtilGeneral()->convertHalfToFloat(src + i, dst + i, count - i);
+    }
+    //---------------------------------------------------------------------
+    OGRE_AVX2_TARGET
+    void OptimisedUtilAVX2::convertFloatToHalf(const float* src, uint16* dst, size_t count)
+    {
+        // The cases of Bitwise::floatToHalfI by biased exponent, rounding towards zero
+        // unlike F16C
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            __m256 f = _mm256_loadu_ps(src + i);
+            __m256i v = _mm256_castps_si256(f);
+            __m256i absV = _mm256_and_si256(v, _mm256_set1_epi32(0x7fffffff));
+            __m256i exponent = _mm256_srli_epi32(absV, 23);
+            __m256i sign = _mm256_and_si256(_mm256_srli_epi32(v, 16), _mm256_set1_epi32(0x8000));
+            __m256i normal = _mm256_srli_epi32(_mm256_sub_epi32(absV, _mm256_set1_epi32((127 - 15) << 23)), 13);
+            __m256i denormal = _mm256_cvttps_epi32(
+                _mm256_mul_ps(_mm256_castsi256_ps(absV), _mm256_set1_ps(16777216.0f)));
+            __m256i mantissa = _mm256_and_si256(absV, _mm256_set1_epi32(0x007fffff));
+            __m256i m = _mm256_srli_epi32(mantissa, 13);
+            // a NaN whose payload is lost by the shift stays a NaN
+            __m256i lostNan = _mm256_andnot_si256(_mm256_cmpeq_epi32(mantissa, _mm256_setzero_si256()),
+                _mm256_cmpeq_epi32(m, _mm256_setzero_si256()));
+            __m256i infNan = _mm256_or_si256(_mm256_set1_epi32(0x7c00),
+                _mm256_or_si256(m, _mm256_and_si256(lostNan, _mm256_set1_epi32(1))));
+
+            __m256i r = _mm256_and_si256(_mm256_cmpgt_epi32(exponent, _mm256_set1_epi32(101)), denormal);
+            r = _mm256_blendv_epi8(r, normal, _mm256_cmpgt_epi32(exponent, _mm256_set1_epi32(112)));
+            r = _mm256_blendv_epi8(r, _mm256_set1_epi32(0x7c00), _mm256_cmpgt_epi32(exponent, _mm256_set1_epi32(142)));
+            r = _mm256_blendv_epi8(r, infNan, _mm256_cmpeq_epi32(exponent, _mm256_set1_epi32(255)));
+            // values flushed to zero drop the sign as well
+            r = _mm256_or_si256(r, _mm256_and_si256(sign, _mm256_cmpgt_epi32(exponent, _mm256_set1_epi32(101))));
+
+            __m128i halfs = _mm_packus_epi32(_mm256_castsi256_si128(r), _mm256_extracti128_si256(r, 1));
+            _mm_storeu_si128((__m128i*)(dst + i), halfs);
+        }
+
+        _getOptimisedUtilGeneral()->convertFloatToHalf(src + i, dst + i, count - i);
+    }
+    //---------------------------------------------------------------------
+    OGRE_AVX2_TARGET
+    void OptimisedUtilAVX2::multiplyMatrices(
+        const Matrix4* pLhsMat,
+        const Matrix4* pRhsMat,
+        Matrix4* pDstMat,
+        size_t numMatrices)
+    {
+        for (size_t i = 0; i < numMatrices; ++i)
+        {
+            // Two rows of the lhs per register, each rhs row in both halves. Everything
+            // is loaded before storing, the destination may be an operand.
+            const float* a = pLhsMat[i][0];
+            const float* b = pRhsMat[i][0];
+            __m256 a01 = _mm256_loadu_ps(a);
+            __m256 a23 = _mm256_loadu_ps(a + 8);
+            __m256 b0 = _mm256_broadcast_ps((const __m128*)(b));
+            __m256 b1 = _mm256_broadcast_ps((const __m128*)(b + 4));
+            __m256 b2 = _mm256_broadcast_ps((const __m128*)(b + 8));
+            __m256 b3 = _mm256_broadcast_ps((const __m128*)(b + 12));
+
+            __m256 c01 = _mm256_mul_ps(_mm256_permute_ps(a01, 0x00), b0);
+            __m256 c23 = _mm256_mul_ps(_mm256_permute_ps(a23, 0x00), b0);
+            c01 = _mm256_fmadd_ps(_mm256_permute_ps(a01, 0x55), b1, c01);
+            c23 = _mm256_fmadd_ps(_mm256_permute_ps(a23, 0x55), b1, c23);
+            c01 = _mm256_fmadd_ps(_mm256_permute_ps(a01, 0xAA), b2, c01);
+            c23 = _mm256_fmadd_ps(_mm256_permute_ps(a23, 0xAA), b2, c23);
+            c01 = _mm256_fmadd_ps(_mm256_permute_ps(a01, 0xFF), b3, c01);
+            c23 = _mm256_fmadd_ps(_mm256_permute_ps(a23, 0xFF), b3, c23);
+
+            float* c = pDstMat[i][0];
+            _mm256_storeu_ps(c, c01);
+            _mm256_storeu_ps(c + 8, c23);
+        }
+    }
+    //---------------------------------------------------------------------
+    OGRE_AVX2_TARGET
+    void OptimisedUtilAVX2::multiplyAffineMatrices(
+        const Affine3* pLhsMat,
+        const Affine3* pRhsMat,
+        Affine3* pDstMat,
+        size_t numMatrices)
+    {
+        // The implicit last row (0, 0, 0, 1) of the rhs adds the translation of the lhs
+        const __m128 unitW = _mm_setr_ps(0, 0, 0, 1);
+        const __m256 b3 = _mm256_setr_ps(0, 0, 0, 1, 0, 0, 0, 1);
+
+        for (size_t i = 0; i < numMatrices; ++i)
+        {
+            const float* a = pLhsMat[i][0];
+            const float* b = pRhsMat[i][0];
+            __m256 a01 = _mm256_loadu_ps(a);
+            __m128 a2 = _mm_loadu_ps(a + 8);
+            __m256 b0 = _mm256_broadcast_ps((const __m128*)(b));
+            __m256 b1 = _mm256_broadcast_ps((const __m128*)(b + 4));
+            __m256 b2 = _mm256_broadcast_ps((const __m128*)(b + 8));
+
+            __m256 c01 = _mm256_mul_ps(_mm256_permute_ps(a01, 0xFF), b3);
+            __m128 c2 = _mm_mul_ps(_mm_permute_ps(a2, 0xFF), unitW);
+            c01 = _mm256_fmadd_ps(_mm256_permute_ps(a01, 0x00), b0, c01);
+            c2 = _mm_fmadd_ps(_mm_permute_ps(a2, 0x00), _mm256_castps256_ps128(b0), c2);
+            c01 = _mm256_fmadd_ps(_mm256_permute_ps(a01, 0x55), b1, c01);
+            c2 = _mm_fmadd_ps(_mm_permute_ps(a2, 0x55), _mm256_castps256_ps128(b1), c2);
+            c01 = _mm256_fmadd_ps(_mm256_permute_ps(a01, 0xAA), b2, c01);
+            c2 = _mm_fmadd_ps(_mm_permute_ps(a2, 0xAA), _mm256_castps256_ps128(b2), c2);
+
+            float* c = pDstMat[i][0];
+            _mm256_storeu_ps(c, c01);
+            _mm_storeu_ps(c + 8, c2);
+            _mm_storeu_ps(c + 12, unitW);
+        }
+    }
+    //---------------------------------------------------------------------
+    OGRE_AVX2_TARGET
+    void OptimisedUtilAVX2::inverseAffineMatrices(
+        const Affine3* pSrcMat,
+        Affine3* pDstMat,
+        size_t numMatrices)
+    {
+        const __m128 unitW = _mm_setr_ps(0, 0, 0, 1);
+
+        for (size_t i = 0; i < numMatrices; ++i)
+        {
+            __m128 r0 = _mm_loadu_ps(pSrcMat[i][0]);
+            __m128 r1 = _mm_loadu_ps(pSrcMat[i][1]);
+            __m128 r2 = _mm_loadu_ps(pSrcMat[i][2]);
+
+            // The columns of the inverse of the linear part are the cross products of its
+            // rows divided by the determinant, their w components are 0
+            __m128 c0 = cross3(r1, r2);
+            __m128 c1 = cross3(r2, r0);
+            __m128 c2 = cross3(r0, r1);
+
+            __m128 invDet = _mm_div_ps(_mm_set1_ps(1.0f), _mm_dp_ps(r0, c0, 0x7F));
+            c0 = _mm_mul_ps(c0, invDet);
+            c1 = _mm_mul_ps(c1, invDet);
+            c2 = _mm_mul_ps(c2, invDet);
+
+            // The translation is the inverse applied to the negated translation
+            __m128 t = _mm_mul_ps(c0, _mm_permute_ps(r0, 0xFF));
+            t = _mm_fmadd_ps(c1, _mm_permute_ps(r1, 0xFF), t);
+            t = _mm_fmadd_ps(c2, _mm_permute_ps(r2, 0xFF), t);
+            t = _mm_sub_ps(_mm_setzero_ps(), t);
+
+            _MM_TRANSPOSE4_PS(c0, c1, c2, t);
+            _mm_storeu_ps(pDstMat[i][0], c0);
+            _mm_storeu_ps(pDstMat[i][1], c1);
+            _mm_storeu_ps(pDstMat[i][2], c2);
+            _mm_storeu_ps(pDstMat[i][3], unitW);
+        }
+    }
+    //---------------------------------------------------------------------
+    OGRE_AVX2_TARGET
+    void OptimisedUtilAVX2::transformPoints(
+        const Affine3& matrix,
+        const Vector3* srcPoints,
+        Vector3* dstPoints,
+        size_t numPoints)
+    {
+        size_t i = transformVectors8<true>(matrix, srcPoints->ptr(), dstPoints->ptr(), numPoints);
+        _getOptimisedUtilGeneral()->transformPoints(matrix, srcPoints + i, dstPoints + i, numPoints - i);
+    }
+    //---------------------------------------------------------------------
+    OGRE_AVX2_TARGET
+    void OptimisedUtilAVX2::transformDirections(
+        const Affine3& matrix,
+        const Vector3* srcDirections,
+        Vector3* dstDirections,
+        size_t numDirections)
+    {
+        size_t i = transformVectors8<false>(matrix, srcDirections->ptr(), dstDirections->ptr(), numDirections);
+        _getOptimisedUtilGeneral()->transformDirections(matrix, srcDirections + i, dstDirections + i, numDirections - i);
+    }
+    //---------------------------------------------------------------------
+    OGRE_AVX2_TARGET
+    void OptimisedUtilAVX2::slerpQuaternions(
+        const Quaternion* from, const Quaternion* to,
+        const float* t,
+        Quaternion* dst,
+        size_t numQuaternions,
+        bool shortestPath)
+    {
+        const __m256 signMask = _mm256_set1_ps(-0.0f);
+        const __m256 one = _mm256_set1_ps(1.0f);
+
+        size_t i = 0;
+        for (; i + 8 <= numQuaternions; i += 8)
+        {
+            __m256 pw, px, py, pz, qw, qx, qy, qz;
+            loadQuaternions8(from + i, pw, px, py, pz);
+            loadQuaternions8(to + i, qw, qx, qy, qz);
+            __m256 cos = _mm256_mul_ps(pw, qw);
+            cos = _mm256_fmadd_ps(px, qx, cos);
+            cos = _mm256_fmadd_ps(py, qy, cos);
+            cos = _mm256_fmadd_ps(pz, qz, cos);
+
+            if (shortestPath)
+            {
+                // Negate q where the cosine is negative
+                __m256 sign = _mm256_and_ps(cos, signMask);
+                cos = _mm256_xor_ps(cos, sign);
+                qw = _mm256_xor_ps(qw, sign);
+                qx = _mm256_xor_ps(qx, sign);
+                qy = _mm256_xor_ps(qy, sign);
+                qz = _mm256_xor_ps(qz, sign);
+            }
+            else if (_mm256_movemask_ps(_mm256_cmp_ps(cos, _mm256_setzero_ps(), _CMP_LT_OQ)))
+            {
+                // The polynomial only covers angles up to 90 degrees
+                _getOptimisedUtilGeneral()->slerpQuaternions(from + i, to + i, t + i, dst + i, 8, false);
+                continue;
+            }
+
+            __m256 tq = _mm256_loadu_ps(t + i);
+            __m256 xm1 = _mm256_sub_ps(cos, one);
+            __m256 cp = slerpCoefficient(_mm256_sub_ps(one, tq), xm1);
+            __m256 cq = slerpCoefficient(tq, xm1);
+
+            storeQuaternions8(dst + i,
+                              _mm256_fmadd_ps(cp, pw, _mm256_mul_ps(cq, qw)),
+                              _mm256_fmadd_ps(cp, px, _mm256_mul_ps(cq, qx)),
+                              _mm256_fmadd_ps(cp, py, _mm256_mul_ps(cq, qy)),
+                              _mm256_fmadd_ps(cp, pz, _mm256_mul_ps(cq, qz)));
+        }
+
+        _getOptimisedUtilGeneral()->slerpQuaternions(from + i, to + i, t + i, dst + i, numQuaternions - i, shortestPath);
+    }
+    //---------------------------------------------------------------------
+    OGRE_AVX2_TARGET
+    void OptimisedUtilAVX2::nlerpQuaternions(
+        const Quaternion* from, const Quaternion* to,
+        const float* t,
+        Quaternion* dst,
+        size_t numQuaternions,
+        bool shortestPath)
+    {
+        const __m256 signMask = _mm256_set1_ps(-0.0f);
+
+        size_t i = 0;
+        for (; i + 8 <= numQuaternions; i += 8)
+        {
+            __m256 pw, px, py, pz, qw, qx, qy, qz;
+            loadQuaternions8(from + i, pw, px, py, pz);
+            loadQuaternions8(to + i, qw, qx, qy, qz);
+
+            if (shortestPath)
+            {
+                __m256 cos = _mm256_mul_ps(pw, qw);
+                cos = _mm256_fmadd_ps(px, qx, cos);
+                cos = _mm256_fmadd_ps(py, qy, cos);
+                cos = _mm256_fmadd_ps(pz, qz, cos);
+                __m256 sign = _mm256_and_ps(cos, signMask);
+                qw = _mm256_xor_ps(qw, sign);
+                qx = _mm256_xor_ps(qx, sign);
+                qy = _mm256_xor_ps(qy, sign);
+                qz = _mm256_xor_ps(qz, sign);
+            }
+
+            __m256 tq = _mm256_loadu_ps(t + i);
+            __m256 w = _mm256_fmadd_ps(tq, _mm256_sub_ps(qw, pw), pw);
+            __m256 x = _mm256_fmadd_ps(tq, _mm256_sub_ps(qx, px), px);
+            __m256 y = _mm256_fmadd_ps(tq, _mm256_sub_ps(qy, py), py);
+            __m256 z = _mm256_fmadd_ps(tq, _mm256_sub_ps(qz, pz), pz);
+
+            __m256 sqLength = _mm256_mul_ps(w, w);
+            sqLength = _mm256_fmadd_ps(x, x, sqLength);
+            sqLength = _mm256_fmadd_ps(y, y, sqLength);
+            sqLength = _mm256_fmadd_ps(z, z, sqLength);
+            __m256 invLength = _mm256_div_ps(_mm256_set1_ps(1.0f), _mm256_sqrt_ps(sqLength));
+            storeQuaternions8(dst + i, _mm256_mul_ps(w, invLength), _mm256_mul_ps(x, invLength),
+                              _mm256_mul_ps(y, invLength), _mm256_mul_ps(z, invLength));
+        }
+
+        _getOptimisedUtilGeneral()->nlerpQuaternions(from + i, to + i, t + i, dst + i, numQuaternions - i, shortestPath);
+    }
+    //---------------------------------------------------------------------
+    OGRE_AVX2_TARGET
+    void OptimisedUtilAVX2::intersectRayBoxes(
+        const Ray& ray,
+        const Math::BoxArrays& boxes,
+        Real* distances,
+        size_t numBoxes)
+    {
+        const Vector3& origin = ray.getOrigin();
+        const Vector3& direction = ray.getDirection();
+        __m256 ix = _mm256_set1_ps(_slabInverse(direction.x));
+        __m256 iy = _mm256_set1_ps(_slabInverse(direction.y));
+        __m256 iz = _mm256_set1_ps(_slabInverse(direction.z));
+        __m256 ox = _mm256_set1_ps(origin.x), oy = _mm256_set1_ps(origin.y), oz = _mm256_set1_ps(origin.z);
+        const __m256 miss = _mm256_set1_ps(Math::POS_INFINITY);
+
+        size_t i = 0;
+        for (; i + 8 <= numBoxes; i += 8)
+        {
+            // Slabs of the three axes, the ray hits the box if they have a common part
+            __m256 tx1 = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(boxes.minX + i), ox), ix);
+            __m256 tx2 = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(boxes.maxX + i), ox), ix);
+            __m256 ty1 = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(boxes.minY + i), oy), iy);
+            __m256 ty2 = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(boxes.maxY + i), oy), iy);
+            __m256 tz1 = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(boxes.minZ + i), oz), iz);
+            __m256 tz2 = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(boxes.maxZ + i), oz), iz);
+
+            __m256 tNear = _mm256_max_ps(_mm256_max_ps(_mm256_min_ps(tx1, tx2), _mm256_min_ps(ty1, ty2)),
+                                         _mm256_max_ps(_mm256_min_ps(tz1, tz2), _mm256_setzero_ps()));
+            __m256 tFar = _mm256_min_ps(_mm256_min_ps(_mm256_max_ps(tx1, tx2), _mm256_max_ps(ty1, ty2)),
+                                        _mm256_max_ps(tz1, tz2));
+            _mm256_storeu_ps(distances + i, _mm256_blendv_ps(miss, tNear, _mm256_cmp_ps(tNear, tFar, _CMP_LE_OQ)));
+        }
+
+        _getOptimisedUtilGeneral()->intersectRayBoxes(
+            ray, {boxes.minX + i, boxes.minY + i, boxes.minZ + i, boxes.maxX + i, boxes.maxY + i, boxes.maxZ + i},
+            distances + i, numBoxes - i);
+    }
+    //---------------------------------------------------------------------
+    OGRE_AVX2_TARGET
+    void OptimisedUtilAVX2::intersectRayTriangles(
+        const Ray& ray,
+        const Math::TriangleArrays& triangles,
+        Real* distances,
+        size_t numTriangles,
+        bool positiveSide,
+        bool negativeSide)
+    {
+        // Math::intersects for eight triangles at once
+        const Vector3& origin = ray.getOrigin();
+        const Vector3& direction = ray.getDirection();
+        __m256 ox = _mm256_set1_ps(origin.x), oy = _mm256_set1_ps(origin.y), oz = _mm256_set1_ps(origin.z);
+        __m256 dx = _mm256_set1_ps(direction.x), dy = _mm256_set1_ps(direction.y), dz = _mm256_set1_ps(direction.z);
+        const __m256 epsilon = _mm256_set1_ps(positiveSide ? 1e-6f : Math::POS_INFINITY);
+        const __m256 negEpsilon = _mm256_set1_ps(negativeSide ? -1e-6f : Math::NEG_INFINITY);
+        const __m256 zero = _mm256_setzero_ps();
+        const __m256 one = _mm256_set1_ps(1.0f);
+        const __m256 miss = _mm256_set1_ps(Math::POS_INFINITY);
+
+        size_t i = 0;
+        for (; i + 8 <= numTriangles; i += 8)
+        {
+            __m256 e1x = _mm256_loadu_ps(triangles.e1x + i);
+            __m256 e1y = _mm256_loadu_ps(triangles.e1y + i);
+            __m256 e1z = _mm256_loadu_ps(triangles.e1z + i);
+            __m256 e2x = _mm256_loadu_ps(triangles.e2x + i);
+            __m256 e2y = _mm256_loadu_ps(triangles.e2y + i);
+            __m256 e2z = _mm256_loadu_ps(triangles.e2z + i);
+
+            // P = direction x E2
+            __m256 px = _mm256_fmsub_ps(dy, e2z, _mm256_mul_ps(dz, e2y));
+            __m256 py = _mm256_fmsub_ps(dz, e2x, _mm256_mul_ps(dx, e2z));
+            __m256 pz = _mm256_fmsub_ps(dx, e2y, _mm256_mul_ps(dy, e2x));
+            __m256 det = _mm256_fmadd_ps(e1x, px, _mm256_fmadd_ps(e1y, py, _mm256_mul_ps(e1z, pz)));
+            __m256 hit = _mm256_or_ps(_mm256_cmp_ps(det, epsilon, _CMP_GT_OQ), _mm256_cmp_ps(det, negEpsilon, _CMP_LT_OQ));
+            __m256 invDet = _mm256_div_ps(one, det);
+
+            // T = origin - a, Q = T x E1
+            __m256 tx = _mm256_sub_ps(ox, _mm256_loadu_ps(triangles.ax + i));
+            __m256 ty = _mm256_sub_ps(oy, _mm256_loadu_ps(triangles.ay + i));
+            __m256 tz = _mm256_sub_ps(oz, _mm256_loadu_ps(triangles.az + i));
+            __m256 u = _mm256_mul_ps(_mm256_fmadd_ps(tx, px, _mm256_fmadd_ps(ty, py, _mm256_mul_ps(tz, pz))), invDet);
+            __m256 qx = _mm256_fmsub_ps(ty, e1z, _mm256_mul_ps(tz, e1y));
+            __m256 qy = _mm256_fmsub_ps(tz, e1x, _mm256_mul_ps(tx, e1z));
+            __m256 qz = _mm256_fmsub_ps(tx, e1y, _mm256_mul_ps(ty, e1x));
+            __m256 v = _mm256_mul_ps(_mm256_fmadd_ps(dx, qx, _mm256_fmadd_ps(dy, qy, _mm256_mul_ps(dz, qz))), invDet);
+            __m256 t = _mm256_mul_ps(_mm256_fmadd_ps(e2x, qx, _mm256_fmadd_ps(e2y, qy, _mm256_mul_ps(e2z, qz))), invDet);
+
+            hit = _mm256_and_ps(hit, _mm256_and_ps(_mm256_cmp_ps(u, zero, _CMP_GE_OQ), _mm256_cmp_ps(v, zero, _CMP_GE_OQ)));
+            hit = _mm256_and_ps(hit, _mm256_and_ps(_mm256_cmp_ps(_mm256_add_ps(u, v), one, _CMP_LE_OQ),
+                                                   _mm256_cmp_ps(t, zero, _CMP_GE_OQ)));
+            _mm256_storeu_ps(distances + i, _mm256_blendv_ps(miss, t, hit));
+        }
+
+        _getOptimisedUtilGeneral()->intersectRayTriangles(
+            ray,
+            {triangles.ax + i, triangles.ay + i, triangles.az + i,
+             triangles.e1x + i, triangles.e1y + i, triangles.e1z + i,
+             triangles.e2x + i, triangles.e2y + i, triangles.e2z + i},
+            distances + i, numTriangles - i, positiveSide, negativeSide);
+    }
+    //---------------------------------------------------------------------
+    //---------------------------------------------------------------------
+    //---------------------------------------------------------------------
+    extern auto _getOptimisedUtilAVX2() -> OptimisedUtil*;
+    extern auto _getOptimisedUtilAVX2() -> OptimisedUtil*
+    {
+        static OptimisedUtilAVX2 msOptimisedUtilAVX2;
+        return &msOptimisedUtilAVX2;
+    }
+
+}
+
+#endif // defined(__i386__) || defined(__x86_64__)
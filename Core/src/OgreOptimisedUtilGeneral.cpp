@@ -32,13 +32,20 @@ module;
 
 module Ogre.Core;
 
+import :Bitwise;
 import :EdgeListBuilder;
 import :Math;
+import :Matrix3;
 import :Matrix4;
 import :OptimisedUtil;
+import :Platform;
 import :Prerequisites;
+import :Quaternion;
+import :Ray;
 import :Vector;
 
+import <algorithm>;
+
 namespace Ogre {
 
 //-------------------------------------------------------------------------
@@ -80,6 +87,72 @@ namespace Ogre {
             Affine3* dstMatrices,
             size_t numMatrices) override;
 
+        /// @copydoc OptimisedUtil::multiplyMatrices
+        void multiplyMatrices(
+            const Matrix4* lhsMatrices,
+            const Matrix4* rhsMatrices,
+            Matrix4* dstMatrices,
+            size_t numMatrices) override;
+
+        /// @copydoc OptimisedUtil::multiplyAffineMatrices
+        void multiplyAffineMatrices(
+            const Affine3* lhsMatrices,
+            const Affine3* rhsMatrices,
+            Affine3* dstMatrices,
+            size_t numMatrices) override;
+
+        /// @copydoc OptimisedUtil::inverseAffineMatrices
+        void inverseAffineMatrices(
+            const Affine3* srcMatrices,
+            Affine3* dstMatrices,
+            size_t numMatrices) override;
+
+        /// @copydoc OptimisedUtil::transformPoints
+        void transformPoints(
+            const Affine3& matrix,
+            const Vector3* srcPoints,
+            Vector3* dstPoints,
+            size_t numPoints) override;
+
+        /// @copydoc OptimisedUtil::transformDirections
+        void transformDirections(
+            const Affine3& matrix,
+            const Vector3* srcDirections,
+            Vector3* dstDirections,
+            size_t numDirections) override;
+
+        /// @copydoc OptimisedUtil::slerpQuaternions
+        void slerpQuaternions(
+            const Quaternion* from, const Quaternion* to,
+            const float* t,
+            Quaternion* dst,
+            size_t numQuaternions,
+            bool shortestPath) override;
+
+        /// @copydoc OptimisedUtil::nlerpQuaternions
+        void nlerpQuaternions(
+            const Quaternion* from, const Quaternion* to,
+            const float* t,
+            Quaternion* dst,
+            size_t numQuaternions,
+            bool shortestPath) override;
+
+        /// @copydoc OptimisedUtil::intersectRayBoxes
+        void intersectRayBoxes(
+            const Ray& ray,
+            const Math::BoxArrays& boxes,
+            Real* distances,
+            size_t numBoxes) override;
+
+        /// @copydoc OptimisedUtil::intersectRayTriangles
+        void intersectRayTriangles(
+            const Ray& ray,
+            const Math::TriangleArrays& triangles,
+            Real* distances,
+            size_t numTriangles,
+            bool positiveSide,
+            bool negativeSide) override;
+
         /// @copydoc OptimisedUtil::calculateFaceNormals
         void calculateFaceNormals(
             const float *positions,
@@ -101,6 +174,47 @@ namespace Ogre {
             const float* srcPositions,
             float* destPositions,
             size_t numVertices) override;
+
+        /// @copydoc OptimisedUtil::cullBoxes
+        void cullBoxes(
+            const float* planes, size_t numPlanes,
+            const float* centreX, const float* centreY, const float* centreZ,
+            const float* halfSizeX, const float* halfSizeY, const float* halfSizeZ,
+            uint8* visible,
+            size_t numBoxes) override;
+
+        /// @copydoc OptimisedUtil::integrateArrays
+        void integrateArrays(
+            float* posX, float* posY, float* posZ,
+            const float* velX, const float* velY, const float* velZ,
+            float timeElapsed,
+            size_t count) override;
+
+        /// @copydoc OptimisedUtil::calculatePlaneDistances
+        void calculatePlaneDistances(
+            const float* plane,
+            const float* posX, const float* posY, const float* posZ,
+            float* distances,
+            size_t count) override;
+
+        /// @copydoc OptimisedUtil::shuffleChannels
+        void shuffleChannels(
+            const uint8* src, size_t srcBytes,
+            uint8* dst, size_t dstBytes,
+            const uint8* shuffle,
+            size_t numPixels) override;
+
+        /// @copydoc OptimisedUtil::convertUnormToFloat
+        void convertUnormToFloat(const uint8* src, float* dst, size_t count) override;
+
+        /// @copydoc OptimisedUtil::convertFloatToUnorm
+        void convertFloatToUnorm(const float* src, uint8* dst, size_t count) override;
+
+        /// @copydoc OptimisedUtil::convertHalfToFloat
+        void convertHalfToFloat(const uint16* src, float* dst, size_t count) override;
+
+        /// @copydoc OptimisedUtil::convertFloatToHalf
+        void convertFloatToHalf(const float* src, uint16* dst, size_t count) override;
     };
     //---------------------------------------------------------------------
     //---------------------------------------------------------------------
@@ -243,6 +357,136 @@ namespace Ogre {
         }
     }
     //---------------------------------------------------------------------
+    void OptimisedUtilGeneral::multiplyMatrices(
+        const Matrix4* pLhsMat,
+        const Matrix4* pRhsMat,
+        Matrix4* pDstMat,
+        size_t numMatrices)
+    {
+        for (size_t i = 0; i < numMatrices; ++i)
+            pDstMat[i] = pLhsMat[i] * pRhsMat[i];
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilGeneral::multiplyAffineMatrices(
+        const Affine3* pLhsMat,
+        const Affine3* pRhsMat,
+        Affine3* pDstMat,
+        size_t numMatrices)
+    {
+        for (size_t i = 0; i < numMatrices; ++i)
+            pDstMat[i] = pLhsMat[i] * pRhsMat[i];
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilGeneral::inverseAffineMatrices(
+        const Affine3* pSrcMat,
+        Affine3* pDstMat,
+        size_t numMatrices)
+    {
+        for (size_t i = 0; i < numMatrices; ++i)
+            pDstMat[i] = pSrcMat[i].inverse();
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilGeneral::transformPoints(
+        const Affine3& matrix,
+        const Vector3* srcPoints,
+        Vector3* dstPoints,
+        size_t numPoints)
+    {
+        for (size_t i = 0; i < numPoints; ++i)
+            dstPoints[i] = matrix * srcPoints[i];
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilGeneral::transformDirections(
+        const Affine3& matrix,
+        const Vector3* srcDirections,
+        Vector3* dstDirections,
+        size_t numDirections)
+    {
+        Matrix3 linear = matrix.linear();
+        for (size_t i = 0; i < numDirections; ++i)
+            dstDirections[i] = linear * srcDirections[i];
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilGeneral::slerpQuaternions(
+        const Quaternion* from, const Quaternion* to,
+        const float* t,
+        Quaternion* dst,
+        size_t numQuaternions,
+        bool shortestPath)
+    {
+        for (size_t i = 0; i < numQuaternions; ++i)
+            dst[i] = Quaternion::Slerp(t[i], from[i], to[i], shortestPath);
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilGeneral::nlerpQuaternions(
+        const Quaternion* from, const Quaternion* to,
+        const float* t,
+        Quaternion* dst,
+        size_t numQuaternions,
+        bool shortestPath)
+    {
+        for (size_t i = 0; i < numQuaternions; ++i)
+            dst[i] = Quaternion::nlerp(t[i], from[i], to[i], shortestPath);
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilGeneral::intersectRayBoxes(
+        const Ray& ray,
+        const Math::BoxArrays& boxes,
+        Real* distances,
+        size_t numBoxes)
+    {
+        const Vector3& origin = ray.getOrigin();
+        const Vector3& direction = ray.getDirection();
+        Vector3 inverse{_slabInverse(direction.x), _slabInverse(direction.y), _slabInverse(direction.z)};
+
+        for (size_t i = 0; i < numBoxes; ++i)
+        {
+            // Slabs of the three axes, the ray hits the box if they have a common part
+            Real tx1 = (boxes.minX[i] - origin.x) * inverse.x, tx2 = (boxes.maxX[i] - origin.x) * inverse.x;
+            Real ty1 = (boxes.minY[i] - origin.y) * inverse.y, ty2 = (boxes.maxY[i] - origin.y) * inverse.y;
+            Real tz1 = (boxes.minZ[i] - origin.z) * inverse.z, tz2 = (boxes.maxZ[i] - origin.z) * inverse.z;
+
+            Real tNear = std::max({Real(0), std::min(tx1, tx2), std::min(ty1, ty2), std::min(tz1, tz2)});
+            Real tFar = std::min({std::max(tx1, tx2), std::max(ty1, ty2), std::max(tz1, tz2)});
+            distances[i] = tNear <= tFar ? tNear : Math::POS_INFINITY;
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilGeneral::intersectRayTriangles(
+        const Ray& ray,
+        const Math::TriangleArrays& triangles,
+        Real* distances,
+        size_t numTriangles,
+        bool positiveSide,
+        bool negativeSide)
+    {
+        // Same as Math::intersects for a single triangle
+        const Real EPSILON = 1e-6f;
+        const Vector3& origin = ray.getOrigin();
+        const Vector3& direction = ray.getDirection();
+
+        for (size_t i = 0; i < numTriangles; ++i)
+        {
+            distances[i] = Math::POS_INFINITY;
+
+            Vector3 E1{triangles.e1x[i], triangles.e1y[i], triangles.e1z[i]};
+            Vector3 E2{triangles.e2x[i], triangles.e2y[i], triangles.e2z[i]};
+            Vector3 P = direction.crossProduct(E2);
+            Real det = E1.dotProduct(P);
+            if ((!positiveSide || det <= EPSILON) && (!negativeSide || det >= -EPSILON))
+                continue;
+            Real invDet = 1.0f / det;
+
+            Vector3 T = origin - Vector3{triangles.ax[i], triangles.ay[i], triangles.az[i]};
+            Real u = T.dotProduct(P) * invDet;
+            Vector3 Q = T.crossProduct(E1);
+            Real v = direction.dotProduct(Q) * invDet;
+            Real t = E2.dotProduct(Q) * invDet;
+            if (u >= 0.0f && v >= 0.0f && u + v <= 1.0f && t >= 0.0f)
+                distances[i] = t;
+        }
+    }
+    //---------------------------------------------------------------------
     void OptimisedUtilGeneral::softwareVertexMorph(
         Real t,
         const float *pSrc1, const float *pSrc2,
@@ -374,6 +618,98 @@ namespace Ogre {
         }
     }
     //---------------------------------------------------------------------
+    void OptimisedUtilGeneral::cullBoxes(
+        const float* planes, size_t numPlanes,
+        const float* centreX, const float* centreY, const float* centreZ,
+        const float* halfSizeX, const float* halfSizeY, const float* halfSizeZ,
+        uint8* visible,
+        size_t numBoxes)
+    {
+        for (size_t i = 0; i < numBoxes; ++i)
+        {
+            uint8 result = 1;
+            for (const float* plane = planes; plane != planes + numPlanes * 4; plane += 4)
+            {
+                float dist = plane[0] * centreX[i] + plane[1] * centreY[i] + plane[2] * centreZ[i] + plane[3];
+                float maxAbsDist = Math::Abs(plane[0]) * halfSizeX[i] +
+                                   Math::Abs(plane[1]) * halfSizeY[i] +
+                                   Math::Abs(plane[2]) * halfSizeZ[i];
+                if (dist < -maxAbsDist)
+                {
+                    result = 0;
+                    break;
+                }
+            }
+            visible[i] = result;
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilGeneral::integrateArrays(
+        float* posX, float* posY, float* posZ,
+        const float* velX, const float* velY, const float* velZ,
+        float timeElapsed,
+        size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            posX[i] += velX[i] * timeElapsed;
+            posY[i] += velY[i] * timeElapsed;
+            posZ[i] += velZ[i] * timeElapsed;
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilGeneral::calculatePlaneDistances(
+        const float* plane,
+        const float* posX, const float* posY, const float* posZ,
+        float* distances,
+        size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+            distances[i] = plane[0] * posX[i] + plane[1] * posY[i] + plane[2] * posZ[i] + plane[3];
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilGeneral::shuffleChannels(
+        const uint8* src, size_t srcBytes,
+        uint8* dst, size_t dstBytes,
+        const uint8* shuffle,
+        size_t numPixels)
+    {
+        for (size_t i = 0; i < numPixels; ++i)
+        {
+            for (size_t c = 0; c < dstBytes; ++c)
+            {
+                uint8 from = shuffle[c];
+                dst[c] = from == SHUFFLE_ONE ? 255 : from == SHUFFLE_ZERO ? 0 : src[from];
+            }
+            src += srcBytes;
+            dst += dstBytes;
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilGeneral::convertUnormToFloat(const uint8* src, float* dst, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+            dst[i] = Bitwise::fixedToFloat(src[i], 8);
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilGeneral::convertFloatToUnorm(const float* src, uint8* dst, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+            dst[i] = static_cast<uint8>(Bitwise::floatToFixed(src[i], 8));
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilGeneral::convertHalfToFloat(const uint16* src, float* dst, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+            dst[i] = Bitwise::halfToFloat(src[i]);
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilGeneral::convertFloatToHalf(const float* src, uint16* dst, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+            dst[i] = Bitwise::floatToHalf(src[i]);
+    }
+    //---------------------------------------------------------------------
     //---------------------------------------------------------------------
     //---------------------------------------------------------------------
     extern auto _getOptimisedUtilGeneral() -> OptimisedUtil*;
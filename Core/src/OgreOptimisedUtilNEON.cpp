@@ -0,0 +1,1180 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+module;
+
+#if defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+
+module Ogre.Core;
+
+#if defined(__ARM_NEON) && defined(__aarch64__)
+
+import :EdgeListBuilder;
+import :Math;
+import :Matrix4;
+import :OptimisedUtil;
+import :Platform;
+import :Prerequisites;
+import :Quaternion;
+import :Ray;
+import :Vector;
+
+import <algorithm>;
+
+//-------------------------------------------------------------------------
+//
+// Advanced SIMD is part of the AArch64 base architecture, so unlike the x86
+// implementations this one needs neither special compiler flags nor run-time
+// detection. 32-bit ARM is not covered, as it lacks the vector division,
+// square root and across-lane additions used below.
+//
+// Packed xyz data is deinterleaved with vld3q/vst3q and processed four
+// vertices at a time; strided data is processed one vertex at a time.
+//
+//-------------------------------------------------------------------------
+
+namespace Ogre {
+
+//-------------------------------------------------------------------------
+// Local classes
+//-------------------------------------------------------------------------
+
+    /** NEON implementation of OptimisedUtil.
+    @note
+        Don't use this class directly, use OptimisedUtil instead.
+    */
+    class OptimisedUtilNEON : public OptimisedUtil
+    {
+    public:
+        /// @copydoc OptimisedUtil::softwareVertexSkinning
+        void softwareVertexSkinning(
+            const float *srcPosPtr, float *destPosPtr,
+            const float *srcNormPtr, float *destNormPtr,
+            const float *blendWeightPtr, const unsigned char* blendIndexPtr,
+            const Affine3* const* blendMatrices,
+            size_t srcPosStride, size_t destPosStride,
+            size_t srcNormStride, size_t destNormStride,
+            size_t blendWeightStride, size_t blendIndexStride,
+            size_t numWeightsPerVertex,
+            size_t numVertices) override;
+
+        /// @copydoc OptimisedUtil::softwareVertexMorph
+        void softwareVertexMorph(
+            Real t,
+            const float *srcPos1, const float *srcPos2,
+            float *dstPos,
+            size_t pos1VSize, size_t pos2VSize, size_t dstVSize,
+            size_t numVertices,
+            bool morphNormals) override;
+
+        /// @copydoc OptimisedUtil::concatenateAffineMatrices
+        void concatenateAffineMatrices(
+            const Affine3& baseMatrix,
+            const Affine3* srcMatrices,
+            Affine3* dstMatrices,
+            size_t numMatrices) override;
+
+        /// @copydoc OptimisedUtil::multiplyMatrices
+        void multiplyMatrices(
+            const Matrix4* lhsMatrices,
+            const Matrix4* rhsMatrices,
+            Matrix4* dstMatrices,
+            size_t numMatrices) override;
+
+        /// @copydoc OptimisedUtil::multiplyAffineMatrices
+        void multiplyAffineMatrices(
+            const Affine3* lhsMatrices,
+            const Affine3* rhsMatrices,
+            Affine3* dstMatrices,
+            size_t numMatrices) override;
+
+        /// @copydoc OptimisedUtil::inverseAffineMatrices
+        void inverseAffineMatrices(
+            const Affine3* srcMatrices,
+            Affine3* dstMatrices,
+            size_t numMatrices) override;
+
+        /// @copydoc OptimisedUtil::transformPoints
+        void transformPoints(
+            const Affine3& matrix,
+            const Vector3* srcPoints,
+            Vector3* dstPoints,
+            size_t numPoints) override;
+
+        /// @copydoc OptimisedUtil::transformDirections
+        void transformDirections(
+            const Affine3& matrix,
+            const Vector3* srcDirections,
+            Vector3* dstDirections,
+            size_t numDirections) override;
+
+        /// @copydoc OptimisedUtil::slerpQuaternions
+        void slerpQuaternions(
+            const Quaternion* from, const Quaternion* to,
+            const float* t,
+            Quaternion* dst,
+            size_t numQuaternions,
+            bool shortestPath) override;
+
+        /// @copydoc OptimisedUtil::nlerpQuaternions
+        void nlerpQuaternions(
+            const Quaternion* from, const Quaternion* to,
+            const float* t,
+            Quaternion* dst,
+            size_t numQuaternions,
+            bool shortestPath) override;
+
+        /// @copydoc OptimisedUtil::intersectRayBoxes
+        void intersectRayBoxes(
+            const Ray& ray,
+            const Math::BoxArrays& boxes,
+            Real* distances,
+            size_t numBoxes) override;
+
+        /// @copydoc OptimisedUtil::intersectRayTriangles
+        void intersectRayTriangles(
+            const Ray& ray,
+            const Math::TriangleArrays& triangles,
+            Real* distances,
+            size_t numTriangles,
+            bool positiveSide,
+            bool negativeSide) override;
+
+        /// @copydoc OptimisedUtil::calculateFaceNormals
+        void calculateFaceNormals(
+            const float *positions,
+            const EdgeData::Triangle *triangles,
+            Vector4 *faceNormals,
+            size_t numTriangles) override;
+
+        /// @copydoc OptimisedUtil::calculateLightFacing
+        void calculateLightFacing(
+            const Vector4& lightPos,
+            const Vector4* faceNormals,
+            char* lightFacings,
+            size_t numFaces) override;
+
+        /// @copydoc OptimisedUtil::extrudeVertices
+        void extrudeVertices(
+            const Vector4& lightPos,
+            Real extrudeDist,
+            const float* srcPositions,
+            float* destPositions,
+            size_t numVertices) override;
+
+        /// @copydoc OptimisedUtil::cullBoxes
+        void cullBoxes(
+            const float* planes, size_t numPlanes,
+            const float* centreX, const float* centreY, const float* centreZ,
+            const float* halfSizeX, const float* halfSizeY, const float* halfSizeZ,
+            uint8* visible,
+            size_t numBoxes) override;
+
+        /// @copydoc OptimisedUtil::integrateArrays
+        void integrateArrays(
+            float* posX, float* posY, float* posZ,
+            const float* velX, const float* velY, const float* velZ,
+            float timeElapsed,
+            size_t count) override;
+
+        /// @copydoc OptimisedUtil::calculatePlaneDistances
+        void calculatePlaneDistances(
+            const float* plane,
+            const float* posX, const float* posY, const float* posZ,
+            float* distances,
+            size_t count) override;
+
+        /// @copydoc OptimisedUtil::shuffleChannels
+        void shuffleChannels(
+            const uint8* src, size_t srcBytes,
+            uint8* dst, size_t dstBytes,
+            const uint8* shuffle,
+            size_t numPixels) override;
+
+        /// @copydoc OptimisedUtil::convertUnormToFloat
+        void convertUnormToFloat(const uint8* src, float* dst, size_t count) override;
+
+        /// @copydoc OptimisedUtil::convertFloatToUnorm
+        void convertFloatToUnorm(const float* src, uint8* dst, size_t count) override;
+
+        /// @copydoc OptimisedUtil::convertHalfToFloat
+        void convertHalfToFloat(const uint16* src, float* dst, size_t count) override;
+
+        /// @copydoc OptimisedUtil::convertFloatToHalf
+        void convertFloatToHalf(const float* src, uint16* dst, size_t count) override;
+    };
+
+//-------------------------------------------------------------------------
+// Local helpers
+//-------------------------------------------------------------------------
+namespace {
+    /// Loads three floats, the w component is zero. Never touches memory past the third float.
+    inline auto load3(const float* p) -> float32x4_t
+    {
+        return vcombine_f32(vld1_f32(p), vld1_lane_f32(p + 2, vdup_n_f32(0), 0));
+    }
+
+    /// Stores the x, y, z components. Never touches memory past the third float.
+    inline void store3(float* p, float32x4_t v)
+    {
+        vst1_f32(p, vget_low_f32(v));
+        vst1q_lane_f32(p + 2, v, 2);
+    }
+
+    /// Returns (r0.v, r1.v, r2.v, 0)
+    inline auto transformRows(float32x4_t r0, float32x4_t r1, float32x4_t r2, float32x4_t v) -> float32x4_t
+    {
+        float32x4_t p01 = vpaddq_f32(vmulq_f32(r0, v), vmulq_f32(r1, v));
+        float32x4_t p2 = vpaddq_f32(vmulq_f32(r2, v), vdupq_n_f32(0));
+        return vpaddq_f32(p01, p2);
+    }
+
+    /// Normalises the x, y, z components, zero length vectors are left unchanged like Vector3::normalise
+    inline auto normalise3(float32x4_t v) -> float32x4_t
+    {
+        float length = std::sqrt(vaddvq_f32(vmulq_f32(v, v)));
+        return length > 0.0f ? vmulq_n_f32(v, 1.0f / length) : v;
+    }
+
+    /// Linear interpolation a + t * (b - a)
+    inline auto lerp(float32x4_t t, float32x4_t a, float32x4_t b) -> float32x4_t
+    {
+        return vfmaq_f32(a, vsubq_f32(b, a), t);
+    }
+
+    /// Cross product of the x, y, z components, the w component is 0
+    inline auto cross3(float32x4_t a, float32x4_t b) -> float32x4_t
+    {
+        // (y, z, x, x)
+        auto yzx = [](float32x4_t v) { return vcopyq_laneq_f32(vextq_f32(v, v, 1), 2, v, 0); };
+        float32x4_t c = vfmsq_f32(vmulq_f32(a, yzx(b)), yzx(a), b);
+        return vsetq_lane_f32(0.0f, yzx(c), 3);
+    }
+
+    /// Negates the lanes of v where sign has its sign bit set
+    inline auto flipSign(float32x4_t v, uint32x4_t sign) -> float32x4_t
+    {
+        return vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(v), sign));
+    }
+
+    /// sin(t * angle) / sin(angle) for cos(angle) - 1 in xm1, see OptimisedUtil::SLERP_U
+    inline auto slerpCoefficient(float32x4_t t, float32x4_t xm1) -> float32x4_t
+    {
+        float32x4_t sqT = vmulq_f32(t, t);
+        float32x4_t f = vdupq_n_f32(1.0f);
+        for (size_t i = OptimisedUtil::SLERP_TERMS; i-- > 0;)
+        {
+            float32x4_t b = vmulq_f32(vfmaq_n_f32(vdupq_n_f32(-OptimisedUtil::SLERP_V[i]), sqT,
+                                                  OptimisedUtil::SLERP_U[i]), xm1);
+            f = vfmaq_f32(vdupq_n_f32(1.0f), b, f);
+        }
+        return vmulq_f32(t, f);
+    }
+}
+    //---------------------------------------------------------------------
+    //---------------------------------------------------------------------
+    //---------------------------------------------------------------------
+    void OptimisedUtilNEON::softwareVertexSkinning(
+        const float *pSrcPos, float *pDestPos,
+        const float *pSrcNorm, float *pDestNorm,
+        const float *pBlendWeight, const unsigned char* pBlendIndex,
+        const Affine3* const* blendMatrices,
+        size_t srcPosStride, size_t destPosStride,
+        size_t srcNormStride, size_t destNormStride,
+        size_t blendWeightStride, size_t blendIndexStride,
+        size_t numWeightsPerVertex,
+        size_t numVertices)
+    {
+        // Each vertex blends its matrices first, then transforms position and normal once
+        for (size_t vertIdx = 0; vertIdx < numVertices; ++vertIdx)
+        {
+            float32x4_t m0 = vdupq_n_f32(0), m1 = vdupq_n_f32(0), m2 = vdupq_n_f32(0);
+
+            for (size_t blendIdx = 0; blendIdx < numWeightsPerVertex; ++blendIdx)
+            {
+                // NB weights must be normalised!!
+                float weight = pBlendWeight[blendIdx];
+                if (weight)
+                {
+                    const float* mat = (*blendMatrices[pBlendIndex[blendIdx]])[0];
+                    m0 = vfmaq_n_f32(m0, vld1q_f32(mat + 0), weight);
+                    m1 = vfmaq_n_f32(m1, vld1q_f32(mat + 4), weight);
+                    m2 = vfmaq_n_f32(m2, vld1q_f32(mat + 8), weight);
+                }
+            }
+
+            // Blend position, use 3x4 matrix
+            float32x4_t pos = vsetq_lane_f32(1.0f, load3(pSrcPos), 3);
+            store3(pDestPos, transformRows(m0, m1, m2, pos));
+
+            if (pSrcNorm)
+            {
+                // Blend normal, assuming the 3x3 aspect of the matrix is orthogonal
+                // (no non-uniform scaling), so the inverse transpose is the matrix itself
+                float32x4_t norm = transformRows(m0, m1, m2, load3(pSrcNorm));
+                store3(pDestNorm, normalise3(norm));
+
+                advanceRawPointer(pSrcNorm, srcNormStride);
+                advanceRawPointer(pDestNorm, destNormStride);
+            }
+
+            advanceRawPointer(pSrcPos, srcPosStride);
+            advanceRawPointer(pDestPos, destPosStride);
+            advanceRawPointer(pBlendWeight, blendWeightStride);
+            advanceRawPointer(pBlendIndex, blendIndexStride);
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilNEON::concatenateAffineMatrices(
+        const Affine3& baseMatrix,
+        const Affine3* pSrcMat,
+        Affine3* pDstMat,
+        size_t numMatrices)
+    {
+        const float* b = baseMatrix[0];
+        // Base translation times the implicit (0, 0, 0, 1) last source row
+        const float32x4_t t0 = vsetq_lane_f32(b[3], vdupq_n_f32(0), 3);
+        const float32x4_t t1 = vsetq_lane_f32(b[7], vdupq_n_f32(0), 3);
+        const float32x4_t t2 = vsetq_lane_f32(b[11], vdupq_n_f32(0), 3);
+
+        for (size_t i = 0; i < numMatrices; ++i)
+        {
+            const float* s = (*pSrcMat)[0];
+            float32x4_t s0 = vld1q_f32(s + 0);
+            float32x4_t s1 = vld1q_f32(s + 4);
+            float32x4_t s2 = vld1q_f32(s + 8);
+
+            float* d = (*pDstMat)[0];
+            vst1q_f32(d + 0, vfmaq_n_f32(vfmaq_n_f32(vfmaq_n_f32(t0, s0, b[0]), s1, b[1]), s2, b[2]));
+            vst1q_f32(d + 4, vfmaq_n_f32(vfmaq_n_f32(vfmaq_n_f32(t1, s0, b[4]), s1, b[5]), s2, b[6]));
+            vst1q_f32(d + 8, vfmaq_n_f32(vfmaq_n_f32(vfmaq_n_f32(t2, s0, b[8]), s1, b[9]), s2, b[10]));
+
+            ++pSrcMat;
+            ++pDstMat;
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilNEON::softwareVertexMorph(
+        Real t,
+        const float *pSrc1, const float *pSrc2,
+        float *pDst,
+        size_t pos1VSize, size_t pos2VSize, size_t dstVSize,
+        size_t numVertices,
+        bool morphNormals)
+    {
+        const float32x4_t tv = vdupq_n_f32(t);
+
+        if (!morphNormals && pos1VSize == 3 * sizeof(float) && pos2VSize == 3 * sizeof(float) &&
+            dstVSize == 3 * sizeof(float))
+        {
+            // Packed positions, morph as one flat float array
+            size_t numFloats = numVertices * 3;
+            size_t i = 0;
+            for (; i + 4 <= numFloats; i += 4)
+            {
+                vst1q_f32(pDst + i, lerp(tv, vld1q_f32(pSrc1 + i), vld1q_f32(pSrc2 + i)));
+            }
+            for (; i < numFloats; ++i)
+            {
+                pDst[i] = pSrc1[i] + t * (pSrc2[i] - pSrc1[i]);
+            }
+            return;
+        }
+
+        for (size_t i = 0; i < numVertices; ++i)
+        {
+            store3(pDst, lerp(tv, load3(pSrc1), load3(pSrc2)));
+
+            if (morphNormals)
+            {
+                // normals must be in the same buffer as pos
+                // perform an nlerp
+                // we don't have enough information for a spherical interp
+                store3(pDst + 3, normalise3(lerp(tv, load3(pSrc1 + 3), load3(pSrc2 + 3))));
+            }
+
+            advanceRawPointer(pSrc1, pos1VSize);
+            advanceRawPointer(pSrc2, pos2VSize);
+            advanceRawPointer(pDst, dstVSize);
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilNEON::calculateFaceNormals(
+        const float *positions,
+        const EdgeData::Triangle *triangles,
+        Vector4 *faceNormals,
+        size_t numTriangles)
+    {
+        auto* pDest = reinterpret_cast<float*>(faceNormals);
+
+        size_t numIterations = numTriangles / 4;
+        for (size_t i = 0; i < numIterations; ++i)
+        {
+            // Gather the vertex positions of four triangles, one triangle per lane
+            alignas(16) float gathered[3][3][4];
+            for (int k = 0; k < 4; ++k)
+            {
+                for (int v = 0; v < 3; ++v)
+                {
+                    const float* p = positions + triangles[k].vertIndex[v] * 3;
+                    gathered[v][0][k] = p[0];
+                    gathered[v][1][k] = p[1];
+                    gathered[v][2][k] = p[2];
+                }
+            }
+            triangles += 4;
+
+            float32x4_t x1 = vld1q_f32(gathered[0][0]), y1 = vld1q_f32(gathered[0][1]), z1 = vld1q_f32(gathered[0][2]);
+            float32x4_t ax = vsubq_f32(vld1q_f32(gathered[1][0]), x1);
+            float32x4_t ay = vsubq_f32(vld1q_f32(gathered[1][1]), y1);
+            float32x4_t az = vsubq_f32(vld1q_f32(gathered[1][2]), z1);
+            float32x4_t bx = vsubq_f32(vld1q_f32(gathered[2][0]), x1);
+            float32x4_t by = vsubq_f32(vld1q_f32(gathered[2][1]), y1);
+            float32x4_t bz = vsubq_f32(vld1q_f32(gathered[2][2]), z1);
+
+            // normal = (v2 - v1) x (v3 - v1), distance = -(normal . v1)
+            float32x4x4_t n;
+            n.val[0] = vfmsq_f32(vmulq_f32(ay, bz), az, by);
+            n.val[1] = vfmsq_f32(vmulq_f32(az, bx), ax, bz);
+            n.val[2] = vfmsq_f32(vmulq_f32(ax, by), ay, bx);
+            n.val[3] = vnegq_f32(vfmaq_f32(vfmaq_f32(vmulq_f32(n.val[0], x1), n.val[1], y1), n.val[2], z1));
+
+            // Interleaves to four (x, y, z, w) vectors
+            vst4q_f32(pDest, n);
+            pDest += 16;
+        }
+
+        // Leftover triangles
+        faceNormals = reinterpret_cast<Vector4*>(pDest);
+        for (size_t i = 0; i < numTriangles % 4; ++i)
+        {
+            const EdgeData::Triangle& t = *triangles++;
+            const float* v1 = positions + t.vertIndex[0] * 3;
+            const float* v2 = positions + t.vertIndex[1] * 3;
+            const float* v3 = positions + t.vertIndex[2] * 3;
+
+            *faceNormals++ = Math::calculateFaceNormalWithoutNormalize(
+                Vector3{v1[0], v1[1], v1[2]}, Vector3{v2[0], v2[1], v2[2]}, Vector3{v3[0], v3[1], v3[2]});
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilNEON::calculateLightFacing(
+        const Vector4& lightPos,
+        const Vector4* faceNormals,
+        char* lightFacings,
+        size_t numFaces)
+    {
+        const float32x4_t zero = vdupq_n_f32(0);
+        const auto* pSrc = reinterpret_cast<const float*>(faceNormals);
+
+        auto facing = [&](const float* p) -> uint32x4_t
+        {
+            // Deinterleaves four face normals, one face per lane
+            float32x4x4_t n = vld4q_f32(p);
+            float32x4_t dot = vmulq_n_f32(n.val[0], lightPos.x);
+            dot = vfmaq_n_f32(dot, n.val[1], lightPos.y);
+            dot = vfmaq_n_f32(dot, n.val[2], lightPos.z);
+            dot = vfmaq_n_f32(dot, n.val[3], lightPos.w);
+            return vcgtq_f32(dot, zero);
+        };
+
+        size_t numIterations = numFaces / 8;
+        for (size_t i = 0; i < numIterations; ++i)
+        {
+            uint16x8_t f16 = vcombine_u16(vmovn_u32(facing(pSrc)), vmovn_u32(facing(pSrc + 16)));
+            uint8x8_t f8 = vand_u8(vmovn_u16(f16), vdup_n_u8(1));
+            vst1_u8(reinterpret_cast<uint8_t*>(lightFacings), f8);
+            pSrc += 32;
+            lightFacings += 8;
+        }
+
+        // Leftover faces
+        faceNormals = reinterpret_cast<const Vector4*>(pSrc);
+        for (size_t i = 0; i < numFaces % 8; ++i)
+        {
+            *lightFacings++ = (lightPos.dotProduct(*faceNormals++) > 0);
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilNEON::extrudeVertices(
+        const Vector4& lightPos,
+        Real extrudeDist,
+        const float* pSrcPos,
+        float* pDestPos,
+        size_t numVertices)
+    {
+        size_t numIterations = numVertices / 4;
+
+        if (lightPos.w == 0.0f)
+        {
+            // Directional light, extrusion is along light direction
+            Vector3 extrusionDir{-lightPos.x, -lightPos.y, -lightPos.z};
+            extrusionDir.normalise();
+            extrusionDir *= extrudeDist;
+
+            const float32x4_t ex = vdupq_n_f32(extrusionDir.x);
+            const float32x4_t ey = vdupq_n_f32(extrusionDir.y);
+            const float32x4_t ez = vdupq_n_f32(extrusionDir.z);
+
+            for (size_t i = 0; i < numIterations; ++i)
+            {
+                float32x4x3_t p = vld3q_f32(pSrcPos);
+                p.val[0] = vaddq_f32(p.val[0], ex);
+                p.val[1] = vaddq_f32(p.val[1], ey);
+                p.val[2] = vaddq_f32(p.val[2], ez);
+                vst3q_f32(pDestPos, p);
+                pSrcPos += 12;
+                pDestPos += 12;
+            }
+
+            for (size_t vert = 0; vert < numVertices % 4; ++vert)
+            {
+                *pDestPos++ = *pSrcPos++ + extrusionDir.x;
+                *pDestPos++ = *pSrcPos++ + extrusionDir.y;
+                *pDestPos++ = *pSrcPos++ + extrusionDir.z;
+            }
+        }
+        else
+        {
+            // Point light, calculate extrusionDir for every vertex
+            assert(lightPos.w == 1.0f);
+
+            const float32x4_t dist = vdupq_n_f32(extrudeDist);
+            const float32x4_t zero = vdupq_n_f32(0);
+
+            for (size_t i = 0; i < numIterations; ++i)
+            {
+                float32x4x3_t p = vld3q_f32(pSrcPos);
+                float32x4_t dx = vsubq_f32(p.val[0], vdupq_n_f32(lightPos.x));
+                float32x4_t dy = vsubq_f32(p.val[1], vdupq_n_f32(lightPos.y));
+                float32x4_t dz = vsubq_f32(p.val[2], vdupq_n_f32(lightPos.z));
+
+                float32x4_t sqLength = vfmaq_f32(vfmaq_f32(vmulq_f32(dx, dx), dy, dy), dz, dz);
+                // zero length directions stay zero, like Vector3::normalise
+                float32x4_t scale = vdivq_f32(dist, vsqrtq_f32(sqLength));
+                scale = vbslq_f32(vcgtq_f32(sqLength, zero), scale, zero);
+
+                p.val[0] = vfmaq_f32(p.val[0], dx, scale);
+                p.val[1] = vfmaq_f32(p.val[1], dy, scale);
+                p.val[2] = vfmaq_f32(p.val[2], dz, scale);
+                vst3q_f32(pDestPos, p);
+                pSrcPos += 12;
+                pDestPos += 12;
+            }
+
+            for (size_t vert = 0; vert < numVertices % 4; ++vert)
+            {
+                Vector3 extrusionDir{
+                    pSrcPos[0] - lightPos.x,
+                    pSrcPos[1] - lightPos.y,
+                    pSrcPos[2] - lightPos.z};
+                extrusionDir.normalise();
+                extrusionDir *= extrudeDist;
+
+                *pDestPos++ = *pSrcPos++ + extrusionDir.x;
+                *pDestPos++ = *pSrcPos++ + extrusionDir.y;
+                *pDestPos++ = *pSrcPos++ + extrusionDir.z;
+            }
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilNEON::cullBoxes(
+        const float* planes, size_t numPlanes,
+        const float* centreX, const float* centreY, const float* centreZ,
+        const float* halfSizeX, const float* halfSizeY, const float* halfSizeZ,
+        uint8* visible,
+        size_t numBoxes)
+    {
+        // Four boxes per iteration, one box per lane. Each plane is broadcast,
+        // so the box data is read exactly once.
+        size_t numIterations = numBoxes / 4;
+        for (size_t i = 0; i < numIterations; ++i)
+        {
+            float32x4_t cx = vld1q_f32(centreX), cy = vld1q_f32(centreY), cz = vld1q_f32(centreZ);
+            float32x4_t hx = vld1q_f32(halfSizeX), hy = vld1q_f32(halfSizeY), hz = vld1q_f32(halfSizeZ);
+
+            uint32x4_t culled = vdupq_n_u32(0);
+            for (const float* plane = planes; plane != planes + numPlanes * 4; plane += 4)
+            {
+                // dist = normal . centre + d
+                float32x4_t dist = vfmaq_n_f32(vdupq_n_f32(plane[3]), cx, plane[0]);
+                dist = vfmaq_n_f32(dist, cy, plane[1]);
+                dist = vfmaq_n_f32(dist, cz, plane[2]);
+
+                // maxAbsDist = |normal| . halfSize
+                float32x4_t maxAbsDist = vmulq_n_f32(hx, std::abs(plane[0]));
+                maxAbsDist = vfmaq_n_f32(maxAbsDist, hy, std::abs(plane[1]));
+                maxAbsDist = vfmaq_n_f32(maxAbsDist, hz, std::abs(plane[2]));
+
+                // culled if dist < -maxAbsDist
+                culled = vorrq_u32(culled, vcltq_f32(dist, vnegq_f32(maxAbsDist)));
+            }
+
+            visible[0] = !vgetq_lane_u32(culled, 0);
+            visible[1] = !vgetq_lane_u32(culled, 1);
+            visible[2] = !vgetq_lane_u32(culled, 2);
+            visible[3] = !vgetq_lane_u32(culled, 3);
+
+            centreX += 4; centreY += 4; centreZ += 4;
+            halfSizeX += 4; halfSizeY += 4; halfSizeZ += 4;
+            visible += 4;
+        }
+
+        // Leftover boxes
+        for (size_t i = 0; i < numBoxes % 4; ++i)
+        {
+            uint8 result = 1;
+            for (const float* plane = planes; plane != planes + numPlanes * 4; plane += 4)
+            {
+                float dist = plane[0] * centreX[i] + plane[1] * centreY[i] + plane[2] * centreZ[i] + plane[3];
+                float maxAbsDist = std::abs(plane[0]) * halfSizeX[i] +
+                                   std::abs(plane[1]) * halfSizeY[i] +
+                                   std::abs(plane[2]) * halfSizeZ[i];
+                if (dist < -maxAbsDist)
+                {
+                    result = 0;
+                    break;
+                }
+            }
+            visible[i] = result;
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilNEON::integrateArrays(
+        float* posX, float* posY, float* posZ,
+        const float* velX, const float* velY, const float* velZ,
+        float timeElapsed,
+        size_t count)
+    {
+        size_t numIterations = count / 4;
+        for (size_t i = 0; i < numIterations; ++i)
+        {
+            vst1q_f32(posX, vfmaq_n_f32(vld1q_f32(posX), vld1q_f32(velX), timeElapsed));
+            vst1q_f32(posY, vfmaq_n_f32(vld1q_f32(posY), vld1q_f32(velY), timeElapsed));
+            vst1q_f32(posZ, vfmaq_n_f32(vld1q_f32(posZ), vld1q_f32(velZ), timeElapsed));
+
+            posX += 4; posY += 4; posZ += 4;
+            velX += 4; velY += 4; velZ += 4;
+        }
+
+        // Leftover elements
+        for (size_t i = 0; i < count % 4; ++i)
+        {
+            posX[i] += velX[i] * timeElapsed;
+            posY[i] += velY[i] * timeElapsed;
+            posZ[i] += velZ[i] * timeElapsed;
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilNEON::calculatePlaneDistances(
+        const float* plane,
+        const float* posX, const float* posY, const float* posZ,
+        float* distances,
+        size_t count)
+    {
+        const float32x4_t d = vdupq_n_f32(plane[3]);
+        size_t numIterations = count / 4;
+        for (size_t i = 0; i < numIterations; ++i)
+        {
+            float32x4_t dist = vfmaq_n_f32(d, vld1q_f32(posX), plane[0]);
+            dist = vfmaq_n_f32(dist, vld1q_f32(posY), plane[1]);
+            vst1q_f32(distances, vfmaq_n_f32(dist, vld1q_f32(posZ), plane[2]));
+
+            posX += 4; posY += 4; posZ += 4;
+            distances += 4;
+        }
+
+        // Leftover points
+        for (size_t i = 0; i < count % 4; ++i)
+            distances[i] = plane[0] * posX[i] + plane[1] * posY[i] + plane[2] * posZ[i] + plane[3];
+    }
+    //---------------------------------------------------------------------
+    extern auto _getOptimisedUtilGeneral() -> OptimisedUtil*;
+    //---------------------------------------------------------------------
+    void OptimisedUtilNEON::shuffleChannels(
+        const uint8* src, size_t srcBytes,
+        uint8* dst, size_t dstBytes,
+        const uint8* shuffle,
+        size_t numPixels)
+    {
+        // Four pixels per iteration. Every iteration loads and stores 16 bytes, the
+        // bytes written past the fourth pixel are overwritten by the next store.
+        size_t minBytes = std::min(srcBytes, dstBytes);
+        size_t minPixels = std::max<size_t>(4, (16 + minBytes - 1) / minBytes);
+
+        uint8 indices[16];
+        uint8 fill[16];
+        for (size_t j = 0; j < 16; ++j)
+        {
+            size_t p = j / dstBytes;
+            uint8 from = shuffle[j % dstBytes];
+            // out of range indices select 0
+            indices[j] = p >= 4 || from == SHUFFLE_ONE || from == SHUFFLE_ZERO ? 0xFF : uint8(p * srcBytes + from);
+            fill[j] = p < 4 && from == SHUFFLE_ONE ? 0xFF : 0;
+        }
+        uint8x16_t mask = vld1q_u8(indices);
+        uint8x16_t ones = vld1q_u8(fill);
+
+        for (; numPixels >= minPixels; numPixels -= 4)
+        {
+            vst1q_u8(dst, vorrq_u8(vqtbl1q_u8(vld1q_u8(src), mask), ones));
+
+            src += 4 * srcBytes;
+            dst += 4 * dstBytes;
+        }
+
+        _getOptimisedUtilGeneral()->shuffleChannels(src, srcBytes, dst, dstBytes, shuffle, numPixels);
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilNEON::convertUnormToFloat(const uint8* src, float* dst, size_t count)
+    {
+        const float32x4_t scale = vdupq_n_f32(255.0f);
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            // divide like Bitwise::fixedToFloat, multiplying by the reciprocal is not exact
+            uint16x8_t v = vmovl_u8(vld1_u8(src + i));
+            vst1q_f32(dst + i, vdivq_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(v))), scale));
+            vst1q_f32(dst + i + 4, vdivq_f32(vcvtq_f32_u32(vmovl_high_u16(v)), scale));
+        }
+
+        _getOptimisedUtilGeneral()->convertUnormToFloat(src + i, dst + i, count - i);
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilNEON::convertFloatToUnorm(const float* src, uint8* dst, size_t count)
+    {
+        const float32x4_t zero = vdupq_n_f32(0.0f);
+        const float32x4_t maximum = vdupq_n_f32(255.0f);
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            // clamped and truncated like Bitwise::floatToFixed, vmaxnm turns NaN into 0
+            float32x4_t lo = vminq_f32(vmaxnmq_f32(vmulq_n_f32(vld1q_f32(src + i), 256.0f), zero), maximum);
+            float32x4_t hi = vminq_f32(vmaxnmq_f32(vmulq_n_f32(vld1q_f32(src + i + 4), 256.0f), zero), maximum);
+            uint16x8_t words = vcombine_u16(vmovn_u32(vcvtq_u32_f32(lo)), vmovn_u32(vcvtq_u32_f32(hi)));
+            vst1_u8(dst + i, vmovn_u16(words));
+        }
+
+        _getOptimisedUtilGeneral()->convertFloatToUnorm(src + i, dst + i, count - i);
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilNEON::convertHalfToFloat(const uint16* src, float* dst, size_t count)
+    {
+        // Emulates Bitwise::halfToFloatI, the native conversion would quieten signalling NaNs
+        const uint32x4_t expMask = vdupq_n_u32(0x0f800000);
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            uint32x4_t h = vmovl_u16(vld1_u16(src + i));
+            uint32x4_t o = vshlq_n_u32(vandq_u32(h, vdupq_n_u32(0x7fff)), 13);
+            uint32x4_t e = vandq_u32(o, expMask);
+            o = vaddq_u32(o, vdupq_n_u32((127 - 15) << 23));
+            // infinity and NaN keep the maximum exponent
+            o = vaddq_u32(o, vandq_u32(vceqq_u32(e, expMask), vdupq_n_u32((128 - 16) << 23)));
+            // zero and denormals are renormalised by a float subtraction
+            float32x4_t renormalised = vsubq_f32(vreinterpretq_f32_u32(vaddq_u32(o, vdupq_n_u32(1 << 23))),
+                vreinterpretq_f32_u32(vdupq_n_u32(113 << 23)));
+            o = vbslq_u32(vceqzq_u32(e), vreinterpretq_u32_f32(renormalised), o);
+            o = vorrq_u32(o, vshlq_n_u32(vandq_u32(h, vdupq_n_u32(0x8000)), 16));
+            vst1q_f32(dst + i, vreinterpretq_f32_u32(o));
+        }
+
+        _getOptimisedUtilGeneral()->convertHalfToFloat(src + i, dst + i, count - i);
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilNEON::convertFloatToHalf(const float* src, uint16* dst, size_t count)
+    {
+        // The cases of Bitwise::floatToHalfI by biased exponent; the native conversion
+        // rounds to nearest instead of towards zero
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            float32x4_t f = vld1q_f32(src + i);
+            uint32x4_t v = vreinterpretq_u32_f32(f);
+            uint32x4_t absV = vandq_u32(v, vdupq_n_u32(0x7fffffff));
+            uint32x4_t exponent = vshrq_n_u32(absV, 23);
+            uint32x4_t sign = vandq_u32(vshrq_n_u32(v, 16), vdupq_n_u32(0x8000));
+            uint32x4_t normal = vshrq_n_u32(vsubq_u32(absV, vdupq_n_u32((127 - 15) << 23)), 13);
+            uint32x4_t denormal = vcvtq_u32_f32(vmulq_n_f32(vreinterpretq_f32_u32(absV), 16777216.0f));
+            uint32x4_t mantissa = vandq_u32(absV, vdupq_n_u32(0x007fffff));
+            uint32x4_t m = vshrq_n_u32(mantissa, 13);
+            // a NaN whose payload is lost by the shift stays a NaN
+            uint32x4_t lostNan = vbicq_u32(vceqzq_u32(m), vceqzq_u32(mantissa));
+            uint32x4_t infNan = vorrq_u32(vdupq_n_u32(0x7c00), vorrq_u32(m, vandq_u32(lostNan, vdupq_n_u32(1))));
+
+            uint32x4_t notFlushed = vcgtq_u32(exponent, vdupq_n_u32(101));
+            uint32x4_t r = vandq_u32(notFlushed, denormal);
+            r = vbslq_u32(vcgtq_u32(exponent, vdupq_n_u32(112)), normal, r);
+            r = vbslq_u32(vcgtq_u32(exponent, vdupq_n_u32(142)), vdupq_n_u32(0x7c00), r);
+            r = vbslq_u32(vceqq_u32(exponent, vdupq_n_u32(255)), infNan, r);
+            // values flushed to zero drop the sign as well
+            r = vorrq_u32(r, vandq_u32(notFlushed, sign));
+            vst1_u16(dst + i, vmovn_u32(r));
+        }
+
+        _getOptimisedUtilGeneral()->convertFloatToHalf(src + i, dst + i, count - i);
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilNEON::multiplyMatrices(
+        const Matrix4* pLhsMat,
+        const Matrix4* pRhsMat,
+        Matrix4* pDstMat,
+        size_t numMatrices)
+    {
+        for (size_t i = 0; i < numMatrices; ++i)
+        {
+            // Everything is loaded before storing, the destination may be an operand
+            float32x4x4_t a = vld1q_f32_x4(pLhsMat[i][0]);
+            float32x4x4_t b = vld1q_f32_x4(pRhsMat[i][0]);
+
+            float32x4x4_t c;
+            for (size_t r = 0; r < 4; ++r)
+            {
+                float32x4_t row = vmulq_laneq_f32(b.val[0], a.val[r], 0);
+                row = vfmaq_laneq_f32(row, b.val[1], a.val[r], 1);
+                row = vfmaq_laneq_f32(row, b.val[2], a.val[r], 2);
+                c.val[r] = vfmaq_laneq_f32(row, b.val[3], a.val[r], 3);
+            }
+            vst1q_f32_x4(pDstMat[i][0], c);
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilNEON::multiplyAffineMatrices(
+        const Affine3* pLhsMat,
+        const Affine3* pRhsMat,
+        Affine3* pDstMat,
+        size_t numMatrices)
+    {
+        const float32x4_t unitW = vsetq_lane_f32(1.0f, vdupq_n_f32(0), 3);
+
+        for (size_t i = 0; i < numMatrices; ++i)
+        {
+            float32x4x3_t a = vld1q_f32_x3(pLhsMat[i][0]);
+            float32x4x3_t b = vld1q_f32_x3(pRhsMat[i][0]);
+
+            // The implicit last row (0, 0, 0, 1) of the rhs adds the translation of the lhs
+            float32x4x4_t c;
+            for (size_t r = 0; r < 3; ++r)
+            {
+                float32x4_t row = vmulq_laneq_f32(unitW, a.val[r], 3);
+                row = vfmaq_laneq_f32(row, b.val[0], a.val[r], 0);
+                row = vfmaq_laneq_f32(row, b.val[1], a.val[r], 1);
+                c.val[r] = vfmaq_laneq_f32(row, b.val[2], a.val[r], 2);
+            }
+            c.val[3] = unitW;
+            vst1q_f32_x4(pDstMat[i][0], c);
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilNEON::inverseAffineMatrices(
+        const Affine3* pSrcMat,
+        Affine3* pDstMat,
+        size_t numMatrices)
+    {
+        for (size_t i = 0; i < numMatrices; ++i)
+        {
+            float32x4x3_t r = vld1q_f32_x3(pSrcMat[i][0]);
+
+            // The columns of the inverse of the linear part are the cross products of its
+            // rows divided by the determinant
+            float32x4x4_t c;
+            c.val[0] = cross3(r.val[1], r.val[2]);
+            c.val[1] = cross3(r.val[2], r.val[0]);
+            c.val[2] = cross3(r.val[0], r.val[1]);
+
+            float invDet = 1.0f / vaddvq_f32(vmulq_f32(r.val[0], c.val[0]));
+            c.val[0] = vmulq_n_f32(c.val[0], invDet);
+            c.val[1] = vmulq_n_f32(c.val[1], invDet);
+            c.val[2] = vmulq_n_f32(c.val[2], invDet);
+
+            // The translation is the inverse applied to the negated translation
+            float32x4_t t = vmulq_laneq_f32(c.val[0], r.val[0], 3);
+            t = vfmaq_laneq_f32(t, c.val[1], r.val[1], 3);
+            t = vfmaq_laneq_f32(t, c.val[2], r.val[2], 3);
+            c.val[3] = vsetq_lane_f32(1.0f, vnegq_f32(t), 3);
+
+            // Interleaving the columns stores the rows, the w components of the columns
+            // give the last row (0, 0, 0, 1)
+            vst4q_f32(pDstMat[i][0], c);
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilNEON::transformPoints(
+        const Affine3& matrix,
+        const Vector3* srcPoints,
+        Vector3* dstPoints,
+        size_t numPoints)
+    {
+        const float* m = matrix[0];
+        const float* pSrc = srcPoints->ptr();
+        float* pDst = dstPoints->ptr();
+
+        size_t i = 0;
+        for (; i + 4 <= numPoints; i += 4)
+        {
+            float32x4x3_t v = vld3q_f32(pSrc);
+            float32x4x3_t d;
+            for (size_t r = 0; r < 3; ++r)
+            {
+                d.val[r] = vfmaq_n_f32(vdupq_n_f32(m[r * 4 + 3]), v.val[0], m[r * 4 + 0]);
+                d.val[r] = vfmaq_n_f32(d.val[r], v.val[1], m[r * 4 + 1]);
+                d.val[r] = vfmaq_n_f32(d.val[r], v.val[2], m[r * 4 + 2]);
+            }
+            vst3q_f32(pDst, d);
+            pSrc += 12;
+            pDst += 12;
+        }
+
+        _getOptimisedUtilGeneral()->transformPoints(matrix, srcPoints + i, dstPoints + i, numPoints - i);
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilNEON::transformDirections(
+        const Affine3& matrix,
+        const Vector3* srcDirections,
+        Vector3* dstDirections,
+        size_t numDirections)
+    {
+        const float* m = matrix[0];
+        const float* pSrc = srcDirections->ptr();
+        float* pDst = dstDirections->ptr();
+
+        size_t i = 0;
+        for (; i + 4 <= numDirections; i += 4)
+        {
+            float32x4x3_t v = vld3q_f32(pSrc);
+            float32x4x3_t d;
+            for (size_t r = 0; r < 3; ++r)
+            {
+                d.val[r] = vmulq_n_f32(v.val[0], m[r * 4 + 0]);
+                d.val[r] = vfmaq_n_f32(d.val[r], v.val[1], m[r * 4 + 1]);
+                d.val[r] = vfmaq_n_f32(d.val[r], v.val[2], m[r * 4 + 2]);
+            }
+            vst3q_f32(pDst, d);
+            pSrc += 12;
+            pDst += 12;
+        }
+
+        _getOptimisedUtilGeneral()->transformDirections(matrix, srcDirections + i, dstDirections + i, numDirections - i);
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilNEON::slerpQuaternions(
+        const Quaternion* from, const Quaternion* to,
+        const float* t,
+        Quaternion* dst,
+        size_t numQuaternions,
+        bool shortestPath)
+    {
+        const float32x4_t one = vdupq_n_f32(1.0f);
+
+        size_t i = 0;
+        for (; i + 4 <= numQuaternions; i += 4)
+        {
+            // Deinterleaved into w, x, y and z of four quaternions
+            float32x4x4_t p = vld4q_f32(from[i].ptr());
+            float32x4x4_t q = vld4q_f32(to[i].ptr());
+            float32x4_t cos = vmulq_f32(p.val[0], q.val[0]);
+            for (size_t c = 1; c < 4; ++c)
+                cos = vfmaq_f32(cos, p.val[c], q.val[c]);
+
+            if (shortestPath)
+            {
+                // Negate q where the cosine is negative
+                uint32x4_t sign = vandq_u32(vreinterpretq_u32_f32(cos), vdupq_n_u32(0x80000000));
+                cos = flipSign(cos, sign);
+                for (size_t c = 0; c < 4; ++c)
+                    q.val[c] = flipSign(q.val[c], sign);
+            }
+            else if (vmaxvq_u32(vcltzq_f32(cos)))
+            {
+                // The polynomial only covers angles up to 90 degrees
+                _getOptimisedUtilGeneral()->slerpQuaternions(from + i, to + i, t + i, dst + i, 4, false);
+                continue;
+            }
+
+            float32x4_t tq = vld1q_f32(t + i);
+            float32x4_t xm1 = vsubq_f32(cos, one);
+            float32x4_t cp = slerpCoefficient(vsubq_f32(one, tq), xm1);
+            float32x4_t cq = slerpCoefficient(tq, xm1);
+
+            float32x4x4_t d;
+            for (size_t c = 0; c < 4; ++c)
+                d.val[c] = vfmaq_f32(vmulq_f32(cq, q.val[c]), cp, p.val[c]);
+            vst4q_f32(dst[i].ptr(), d);
+        }
+
+        _getOptimisedUtilGeneral()->slerpQuaternions(from + i, to + i, t + i, dst + i, numQuaternions - i, shortestPath);
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilNEON::nlerpQuaternions(
+        const Quaternion* from, const Quaternion* to,
+        const float* t,
+        Quaternion* dst,
+        size_t numQuaternions,
+        bool shortestPath)
+    {
+        size_t i = 0;
+        for (; i + 4 <= numQuaternions; i += 4)
+        {
+            float32x4x4_t p = vld4q_f32(from[i].ptr());
+            float32x4x4_t q = vld4q_f32(to[i].ptr());
+
+            if (shortestPath)
+            {
+                float32x4_t cos = vmulq_f32(p.val[0], q.val[0]);
+                for (size_t c = 1; c < 4; ++c)
+                    cos = vfmaq_f32(cos, p.val[c], q.val[c]);
+                uint32x4_t sign = vandq_u32(vreinterpretq_u32_f32(cos), vdupq_n_u32(0x80000000));
+                for (size_t c = 0; c < 4; ++c)
+                    q.val[c] = flipSign(q.val[c], sign);
+            }
+
+            float32x4_t tq = vld1q_f32(t + i);
+            float32x4x4_t d;
+            for (size_t c = 0; c < 4; ++c)
+                d.val[c] = lerp(tq, p.val[c], q.val[c]);
+
+            float32x4_t sqLength = vmulq_f32(d.val[0], d.val[0]);
+            for (size_t c = 1; c < 4; ++c)
+                sqLength = vfmaq_f32(sqLength, d.val[c], d.val[c]);
+            float32x4_t invLength = vdivq_f32(vdupq_n_f32(1.0f), vsqrtq_f32(sqLength));
+            for (size_t c = 0; c < 4; ++c)
+                d.val[c] = vmulq_f32(d.val[c], invLength);
+            vst4q_f32(dst[i].ptr(), d);
+        }
+
+        _getOptimisedUtilGeneral()->nlerpQuaternions(from + i, to + i, t + i, dst + i, numQuaternions - i, shortestPath);
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilNEON::intersectRayBoxes(
+        const Ray& ray,
+        const Math::BoxArrays& boxes,
+        Real* distances,
+        size_t numBoxes)
+    {
+        const Vector3& origin = ray.getOrigin();
+        const Vector3& direction = ray.getDirection();
+        float ix = _slabInverse(direction.x), iy = _slabInverse(direction.y), iz = _slabInverse(direction.z);
+        const float32x4_t miss = vdupq_n_f32(Math::POS_INFINITY);
+
+        size_t i = 0;
+        for (; i + 4 <= numBoxes; i += 4)
+        {
+            // Slabs of the three axes, the ray hits the box if they have a common part
+            float32x4_t tx1 = vmulq_n_f32(vsubq_f32(vld1q_f32(boxes.minX + i), vdupq_n_f32(origin.x)), ix);
+            float32x4_t tx2 = vmulq_n_f32(vsubq_f32(vld1q_f32(boxes.maxX + i), vdupq_n_f32(origin.x)), ix);
+            float32x4_t ty1 = vmulq_n_f32(vsubq_f32(vld1q_f32(boxes.minY + i), vdupq_n_f32(origin.y)), iy);
+            float32x4_t ty2 = vmulq_n_f32(vsubq_f32(vld1q_f32(boxes.maxY + i), vdupq_n_f32(origin.y)), iy);
+            float32x4_t tz1 = vmulq_n_f32(vsubq_f32(vld1q_f32(boxes.minZ + i), vdupq_n_f32(origin.z)), iz);
+            float32x4_t tz2 = vmulq_n_f32(vsubq_f32(vld1q_f32(boxes.maxZ + i), vdupq_n_f32(origin.z)), iz);
+
+            float32x4_t tNear = vmaxq_f32(vmaxq_f32(vminq_f32(tx1, tx2), vminq_f32(ty1, ty2)),
+                                          vmaxq_f32(vminq_f32(tz1, tz2), vdupq_n_f32(0)));
+            float32x4_t tFar = vminq_f32(vminq_f32(vmaxq_f32(tx1, tx2), vmaxq_f32(ty1, ty2)), vmaxq_f32(tz1, tz2));
+            vst1q_f32(distances + i, vbslq_f32(vcleq_f32(tNear, tFar), tNear, miss));
+        }
+
+        _getOptimisedUtilGeneral()->intersectRayBoxes(
+            ray, {boxes.minX + i, boxes.minY + i, boxes.minZ + i, boxes.maxX + i, boxes.maxY + i, boxes.maxZ + i},
+            distances + i, numBoxes - i);
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilNEON::intersectRayTriangles(
+        const Ray& ray,
+        const Math::TriangleArrays& triangles,
+        Real* distances,
+        size_t numTriangles,
+        bool positiveSide,
+        bool negativeSide)
+    {
+        // Math::intersects for four triangles at once
+        const Vector3& o = ray.getOrigin();
+        const Vector3& d = ray.getDirection();
+        const float32x4_t epsilon = vdupq_n_f32(positiveSide ? 1e-6f : Math::POS_INFINITY);
+        const float32x4_t negEpsilon = vdupq_n_f32(negativeSide ? -1e-6f : Math::NEG_INFINITY);
+        const float32x4_t zero = vdupq_n_f32(0);
+        const float32x4_t one = vdupq_n_f32(1.0f);
+        const float32x4_t miss = vdupq_n_f32(Math::POS_INFINITY);
+
+        size_t i = 0;
+        for (; i + 4 <= numTriangles; i += 4)
+        {
+            float32x4_t e1x = vld1q_f32(triangles.e1x + i);
+            float32x4_t e1y = vld1q_f32(triangles.e1y + i);
+            float32x4_t e1z = vld1q_f32(triangles.e1z + i);
+            float32x4_t e2x = vld1q_f32(triangles.e2x + i);
+            float32x4_t e2y = vld1q_f32(triangles.e2y + i);
+            float32x4_t e2z = vld1q_f32(triangles.e2z + i);
+
+            // P = direction x E2
+            float32x4_t px = vfmsq_n_f32(vmulq_n_f32(e2z, d.y), e2y, d.z);
+            float32x4_t py = vfmsq_n_f32(vmulq_n_f32(e2x, d.z), e2z, d.x);
+            float32x4_t pz = vfmsq_n_f32(vmulq_n_f32(e2y, d.x), e2x, d.y);
+            float32x4_t det = vfmaq_f32(vfmaq_f32(vmulq_f32(e1x, px), e1y, py), e1z, pz);
+            uint32x4_t hit = vorrq_u32(vcgtq_f32(det, epsilon), vcltq_f32(det, negEpsilon));
+            float32x4_t invDet = vdivq_f32(one, det);
+
+            // T = origin - a, Q = T x E1
+            float32x4_t tx = vsubq_f32(vdupq_n_f32(o.x), vld1q_f32(triangles.ax + i));
+            float32x4_t ty = vsubq_f32(vdupq_n_f32(o.y), vld1q_f32(triangles.ay + i));
+            float32x4_t tz = vsubq_f32(vdupq_n_f32(o.z), vld1q_f32(triangles.az + i));
+            float32x4_t u = vmulq_f32(vfmaq_f32(vfmaq_f32(vmulq_f32(tx, px), ty, py), tz, pz), invDet);
+            float32x4_t qx = vfmsq_f32(vmulq_f32(ty, e1z), tz, e1y);
+            float32x4_t qy = vfmsq_f32(vmulq_f32(tz, e1x), tx, e1z);
+            float32x4_t qz = vfmsq_f32(vmulq_f32(tx, e1y), ty, e1x);
+            float32x4_t v = vmulq_f32(vfmaq_n_f32(vfmaq_n_f32(vmulq_n_f32(qx, d.x), qy, d.y), qz, d.z), invDet);
+            float32x4_t t = vmulq_f32(vfmaq_f32(vfmaq_f32(vmulq_f32(e2x, qx), e2y, qy), e2z, qz), invDet);
+
+            hit = vandq_u32(hit, vandq_u32(vcgeq_f32(u, zero), vcgeq_f32(v, zero)));
+            hit = vandq_u32(hit, vandq_u32(vcleq_f32(vaddq_f32(u, v), one), vcgeq_f32(t, zero)));
+            vst1q_f32(distances + i, vbslq_f32(hit, t, miss));
+        }
+
+        _getOptimisedUtilGeneral()->intersectRayTriangles(
+            ray,
+            {triangles.ax + i, triangles.ay + i, triangles.az + i,
+             triangles.e1x + i, triangles.e1y + i, triangles.e1z + i,
+             triangles.e2x + i, triangles.e2y + i, triangles.e2z + i},
+            distances + i, numTriangles - i, positiveSide, negativeSide);
+    }
+    //---------------------------------------------------------------------
+    //---------------------------------------------------------------------
+    //---------------------------------------------------------------------
+    extern auto _getOptimisedUtilNEON() -> OptimisedUtil*;
+    extern auto _getOptimisedUtilNEON() -> OptimisedUtil*
+    {
+        static OptimisedUtilNEON msOptimisedUtilNEON;
+        return &msOptimisedUtilNEON;
+    }
+
+}
+
+#endif // defined(__ARM_NEON) && defined(__aarch64__)
@@ -27,13 +27,21 @@ THE SOFTWARE.
 */
 module;
 
+#if defined(__i386__) || defined(__x86_64__)
 #include <mmintrin.h>
 #include <xmmintrin.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#endif
 #include <cassert>
+#include <cmath>
 #include <cstring>
 
 module Ogre.Core;
 
+#if defined(__i386__) || defined(__x86_64__)
+
 // Should keep this includes at latest to avoid potential "xmmintrin.h" included by
 // other header file on some platform for some reason.
 import :EdgeListBuilder;
@@ -43,6 +51,8 @@ import :OptimisedUtil;
 import :Platform;
 import :PlatformInformation;
 import :Prerequisites;
+import :Quaternion;
+import :Ray;
 import :Vector;
 
 import "OgreSIMDHelper.hpp";
@@ -120,6 +130,72 @@ namespace Ogre {
             Affine3* dstMatrices,
             size_t numMatrices) override;
 
+        /// @copydoc OptimisedUtil::multiplyMatrices
+        void multiplyMatrices(
+            const Matrix4* lhsMatrices,
+            const Matrix4* rhsMatrices,
+            Matrix4* dstMatrices,
+            size_t numMatrices) override;
+
+        /// @copydoc OptimisedUtil::multiplyAffineMatrices
+        void multiplyAffineMatrices(
+            const Affine3* lhsMatrices,
+            const Affine3* rhsMatrices,
+            Affine3* dstMatrices,
+            size_t numMatrices) override;
+
+        /// @copydoc OptimisedUtil::inverseAffineMatrices
+        void inverseAffineMatrices(
+            const Affine3* srcMatrices,
+            Affine3* dstMatrices,
+            size_t numMatrices) override;
+
+        /// @copydoc OptimisedUtil::transformPoints
+        void transformPoints(
+            const Affine3& matrix,
+            const Vector3* srcPoints,
+            Vector3* dstPoints,
+            size_t numPoints) override;
+
+        /// @copydoc OptimisedUtil::transformDirections
+        void transformDirections(
+            const Affine3& matrix,
+            const Vector3* srcDirections,
+            Vector3* dstDirections,
+            size_t numDirections) override;
+
+        /// @copydoc OptimisedUtil::slerpQuaternions
+        void slerpQuaternions(
+            const Quaternion* from, const Quaternion* to,
+            const float* t,
+            Quaternion* dst,
+            size_t numQuaternions,
+            bool shortestPath) override;
+
+        /// @copydoc OptimisedUtil::nlerpQuaternions
+        void nlerpQuaternions(
+            const Quaternion* from, const Quaternion* to,
+            const float* t,
+            Quaternion* dst,
+            size_t numQuaternions,
+            bool shortestPath) override;
+
+        /// @copydoc OptimisedUtil::intersectRayBoxes
+        void intersectRayBoxes(
+            const Ray& ray,
+            const Math::BoxArrays& boxes,
+            Real* distances,
+            size_t numBoxes) override;
+
+        /// @copydoc OptimisedUtil::intersectRayTriangles
+        void intersectRayTriangles(
+            const Ray& ray,
+            const Math::TriangleArrays& triangles,
+            Real* distances,
+            size_t numTriangles,
+            bool positiveSide,
+            bool negativeSide) override;
+
         /// @copydoc OptimisedUtil::calculateFaceNormals
         void calculateFaceNormals(
             const float *positions,
@@ -141,6 +217,47 @@ namespace Ogre {
             const float* srcPositions,
             float* destPositions,
             size_t numVertices) override;
+
+        /// @copydoc OptimisedUtil::cullBoxes
+        void cullBoxes(
+            const float* planes, size_t numPlanes,
+            const float* centreX, const float* centreY, const float* centreZ,
+            const float* halfSizeX, const float* halfSizeY, const float* halfSizeZ,
+            uint8* visible,
+            size_t numBoxes) override;
+
+        /// @copydoc OptimisedUtil::integrateArrays
+        void integrateArrays(
+            float* posX, float* posY, float* posZ,
+            const float* velX, const float* velY, const float* velZ,
+            float timeElapsed,
+            size_t count) override;
+
+        /// @copydoc OptimisedUtil::calculatePlaneDistances
+        void calculatePlaneDistances(
+            const float* plane,
+            const float* posX, const float* posY, const float* posZ,
+            float* distances,
+            size_t count) override;
+
+        /// @copydoc OptimisedUtil::shuffleChannels
+        void shuffleChannels(
+            const uint8* src, size_t srcBytes,
+            uint8* dst, size_t dstBytes,
+            const uint8* shuffle,
+            size_t numPixels) override;
+
+        /// @copydoc OptimisedUtil::convertUnormToFloat
+        void convertUnormToFloat(const uint8* src, float* dst, size_t count) override;
+
+        /// @copydoc OptimisedUtil::convertFloatToUnorm
+        void convertFloatToUnorm(const float* src, uint8* dst, size_t count) override;
+
+        /// @copydoc OptimisedUtil::convertHalfToFloat
+        void convertHalfToFloat(const uint16* src, float* dst, size_t count) override;
+
+        /// @copydoc OptimisedUtil::convertFloatToHalf
+        void convertFloatToHalf(const float* src, uint16* dst, size_t count) override;
     };
 
 //---------------------------------------------------------------------
@@ -1992,6 +2109,660 @@ namespace Ogre {
         }
     }
     //---------------------------------------------------------------------
+    void OptimisedUtilSSE::cullBoxes(
+        const float* planes, size_t numPlanes,
+        const float* centreX, const float* centreY, const float* centreZ,
+        const float* halfSizeX, const float* halfSizeY, const float* halfSizeZ,
+        uint8* visible,
+        size_t numBoxes)
+    {
+        // Four boxes per iteration, one box per lane. Each plane is broadcast,
+        // so the box data is read exactly once.
+        const __m128 signMask = _mm_set1_ps(-0.0f);
+        size_t numIterations = numBoxes / 4;
+        for (size_t i = 0; i < numIterations; ++i)
+        {
+            __m128 cx = _mm_loadu_ps(centreX), cy = _mm_loadu_ps(centreY), cz = _mm_loadu_ps(centreZ);
+            __m128 hx = _mm_loadu_ps(halfSizeX), hy = _mm_loadu_ps(halfSizeY), hz = _mm_loadu_ps(halfSizeZ);
+
+            __m128 culled = _mm_setzero_ps();
+            for (const float* plane = planes; plane != planes + numPlanes * 4; plane += 4)
+            {
+                __m128 nx = _mm_load_ps1(plane + 0);
+                __m128 ny = _mm_load_ps1(plane + 1);
+                __m128 nz = _mm_load_ps1(plane + 2);
+                __m128 d = _mm_load_ps1(plane + 3);
+
+                // dist = normal . centre + d
+                __m128 dist = __MM_DOT3x3_PS(nx, ny, nz, cx, cy, cz);
+                dist = _mm_add_ps(dist, d);
+
+                // maxAbsDist = |normal| . halfSize
+                __m128 maxAbsDist = __MM_DOT3x3_PS(
+                    _mm_andnot_ps(signMask, nx), _mm_andnot_ps(signMask, ny), _mm_andnot_ps(signMask, nz),
+                    hx, hy, hz);
+
+                // culled if dist < -maxAbsDist
+                culled = _mm_or_ps(culled, _mm_cmplt_ps(dist, _mm_xor_ps(maxAbsDist, signMask)));
+            }
+
+            int mask = _mm_movemask_ps(culled);
+            visible[0] = !(mask & 1);
+            visible[1] = !(mask & 2);
+            visible[2] = !(mask & 4);
+            visible[3] = !(mask & 8);
+
+            centreX += 4; centreY += 4; centreZ += 4;
+            halfSizeX += 4; halfSizeY += 4; halfSizeZ += 4;
+            visible += 4;
+        }
+
+        // Leftover boxes
+        for (size_t i = 0; i < numBoxes % 4; ++i)
+        {
+            uint8 result = 1;
+            for (const float* plane = planes; plane != planes + numPlanes * 4; plane += 4)
+            {
+                float dist = plane[0] * centreX[i] + plane[1] * centreY[i] + plane[2] * centreZ[i] + plane[3];
+                float maxAbsDist = std::abs(plane[0]) * halfSizeX[i] +
+                                   std::abs(plane[1]) * halfSizeY[i] +
+                                   std::abs(plane[2]) * halfSizeZ[i];
+                if (dist < -maxAbsDist)
+                {
+                    result = 0;
+                    break;
+                }
+            }
+            visible[i] = result;
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilSSE::integrateArrays(
+        float* posX, float* posY, float* posZ,
+        const float* velX, const float* velY, const float* velZ,
+        float timeElapsed,
+        size_t count)
+    {
+        const __m128 t = _mm_set1_ps(timeElapsed);
+        size_t numIterations = count / 4;
+        for (size_t i = 0; i < numIterations; ++i)
+        {
+            _mm_storeu_ps(posX, _mm_add_ps(_mm_loadu_ps(posX), _mm_mul_ps(_mm_loadu_ps(velX), t)));
+            _mm_storeu_ps(posY, _mm_add_ps(_mm_loadu_ps(posY), _mm_mul_ps(_mm_loadu_ps(velY), t)));
+            _mm_storeu_ps(posZ, _mm_add_ps(_mm_loadu_ps(posZ), _mm_mul_ps(_mm_loadu_ps(velZ), t)));
+
+            posX += 4; posY += 4; posZ += 4;
+            velX += 4; velY += 4; velZ += 4;
+        }
+
+        // Leftover elements
+        for (size_t i = 0; i < count % 4; ++i)
+        {
+            posX[i] += velX[i] * timeElapsed;
+            posY[i] += velY[i] * timeElapsed;
+            posZ[i] += velZ[i] * timeElapsed;
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilSSE::calculatePlaneDistances(
+        const float* plane,
+        const float* posX, const float* posY, const float* posZ,
+        float* distances,
+        size_t count)
+    {
+        const __m128 nx = _mm_load_ps1(plane + 0);
+        const __m128 ny = _mm_load_ps1(plane + 1);
+        const __m128 nz = _mm_load_ps1(plane + 2);
+        const __m128 d = _mm_load_ps1(plane + 3);
+        size_t numIterations = count / 4;
+        for (size_t i = 0; i < numIterations; ++i)
+        {
+            __m128 dist = __MM_DOT3x3_PS(nx, ny, nz, _mm_loadu_ps(posX), _mm_loadu_ps(posY), _mm_loadu_ps(posZ));
+            _mm_storeu_ps(distances, _mm_add_ps(dist, d));
+
+            posX += 4; posY += 4; posZ += 4;
+            distances += 4;
+        }
+
+        // Leftover points
+        for (size_t i = 0; i < count % 4; ++i)
+            distances[i] = plane[0] * posX[i] + plane[1] * posY[i] + plane[2] * posZ[i] + plane[3];
+    }
+    //---------------------------------------------------------------------
+    // The pixel conversions need SSE2 for the integer operations, which every
+    // x86-64 target has; the leftover elements, the byte shuffles (pshufb is
+    // SSSE3) and SSE only targets go through the general implementation.
+    extern auto _getOptimisedUtilGeneral() -> OptimisedUtil*;
+    //---------------------------------------------------------------------
+    void OptimisedUtilSSE::shuffleChannels(
+        const uint8* src, size_t srcBytes,
+        uint8* dst, size_t dstBytes,
+        const uint8* shuffle,
+        size_t numPixels)
+    {
+        _getOptimisedUtilGeneral()->shuffleChannels(src, srcBytes, dst, dstBytes, shuffle, numPixels);
+    }
+#ifdef __SSE2__
+    //---------------------------------------------------------------------
+    static inline auto halfToFloat4(__m128i h) -> __m128
+    {
+        // exponent and mantissa moved into place and rebiased, see Bitwise::halfToFloatI
+        __m128i o = _mm_slli_epi32(_mm_and_si128(h, _mm_set1_epi32(0x7fff)), 13);
+        __m128i e = _mm_and_si128(o, _mm_set1_epi32(0x0f800000));
+        o = _mm_add_epi32(o, _mm_set1_epi32((127 - 15) << 23));
+        // infinity and NaN keep the maximum exponent
+        __m128i infNan = _mm_cmpeq_epi32(e, _mm_set1_epi32(0x0f800000));
+        o = _mm_add_epi32(o, _mm_and_si128(infNan, _mm_set1_epi32((128 - 16) << 23)));
+        // zero and denormals are renormalised by a float subtraction
+        __m128i denormal = _mm_cmpeq_epi32(e, _mm_setzero_si128());
+        __m128i renormalised = _mm_castps_si128(_mm_sub_ps(
+            _mm_castsi128_ps(_mm_add_epi32(o, _mm_set1_epi32(1 << 23))), _mm_castsi128_ps(_mm_set1_epi32(113 << 23))));
+        o = _mm_or_si128(_mm_andnot_si128(denormal, o), _mm_and_si128(denormal, renormalised));
+        o = _mm_or_si128(o, _mm_slli_epi32(_mm_and_si128(h, _mm_set1_epi32(0x8000)), 16));
+        return _mm_castsi128_ps(o);
+    }
+    //---------------------------------------------------------------------
+    static inline auto selectBits(__m128i mask, __m128i a, __m128i b) -> __m128i
+    {
+        return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+    }
+    //---------------------------------------------------------------------
+    static inline auto floatToHalf4(__m128 f) -> __m128i
+    {
+        // the cases of Bitwise::floatToHalfI by biased exponent, truncating
+        __m128i i = _mm_castps_si128(f);
+        __m128i absI = _mm_and_si128(i, _mm_set1_epi32(0x7fffffff));
+        __m128i exponent = _mm_srli_epi32(absI, 23);
+        __m128i sign = _mm_and_si128(_mm_srli_epi32(i, 16), _mm_set1_epi32(0x8000));
+        __m128i normal = _mm_srli_epi32(_mm_sub_epi32(absI, _mm_set1_epi32((127 - 15) << 23)), 13);
+        __m128i denormal = _mm_cvttps_epi32(_mm_mul_ps(_mm_castsi128_ps(absI), _mm_set1_ps(16777216.0f)));
+        __m128i mantissa = _mm_and_si128(absI, _mm_set1_epi32(0x007fffff));
+        __m128i m = _mm_srli_epi32(mantissa, 13);
+        __m128i lostNan = _mm_andnot_si128(_mm_cmpeq_epi32(mantissa, _mm_setzero_si128()),
+            _mm_cmpeq_epi32(m, _mm_setzero_si128()));
+        __m128i infNan = _mm_or_si128(_mm_set1_epi32(0x7c00), _mm_or_si128(m, _mm_and_si128(lostNan, _mm_set1_epi32(1))));
+
+        __m128i r = _mm_and_si128(_mm_cmpgt_epi32(exponent, _mm_set1_epi32(101)), _mm_or_si128(denormal, sign));
+        r = selectBits(_mm_cmpgt_epi32(exponent, _mm_set1_epi32(112)), _mm_or_si128(normal, sign), r);
+        r = selectBits(_mm_cmpgt_epi32(exponent, _mm_set1_epi32(142)), _mm_or_si128(_mm_set1_epi32(0x7c00), sign), r);
+        r = selectBits(_mm_cmpeq_epi32(exponent, _mm_set1_epi32(255)), _mm_or_si128(infNan, sign), r);
+        return r;
+    }
+    //---------------------------------------------------------------------
+    static inline auto packUint16(__m128i lo, __m128i hi) -> __m128i
+    {
+        // there is no unsigned saturation from 32 bits before SSE4.1
+        const __m128i bias32 = _mm_set1_epi32(0x8000);
+        return _mm_add_epi16(_mm_packs_epi32(_mm_sub_epi32(lo, bias32), _mm_sub_epi32(hi, bias32)),
+            _mm_set1_epi16(short(0x8000)));
+    }
+#endif
+    //---------------------------------------------------------------------
+    void OptimisedUtilSSE::convertUnormToFloat(const uint8* src, float* dst, size_t count)
+    {
+        size_t i = 0;
+#ifdef __SSE2__
+        const __m128 scale = _mm_set1_ps(255.0f);
+        const __m128i zero = _mm_setzero_si128();
+        for (; i + 16 <= count; i += 16)
+        {
+            __m128i bytes = _mm_loadu_si128((const __m128i*)(src + i));
+            __m128i lo = _mm_unpacklo_epi8(bytes, zero);
+            __m128i hi = _mm_unpackhi_epi8(bytes, zero);
+            // divide like Bitwise::fixedToFloat, multiplying by the reciprocal is not exact
+            _mm_storeu_ps(dst + i, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(lo, zero)), scale));
+            _mm_storeu_ps(dst + i + 4, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(lo, zero)), scale));
+            _mm_storeu_ps(dst + i + 8, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(hi, zero)), scale));
+            _mm_storeu_ps(dst + i + 12, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(hi, zero)), scale));
+        }
+#endif
+        _getOptimisedUtilGeneral()->convertUnormToFloat(src + i, dst + i, count - i);
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilSSE::convertFloatToUnorm(const float* src, uint8* dst, size_t count)
+    {
+        size_t i = 0;
+#ifdef __SSE2__
+        const __m128 scale = _mm_set1_ps(256.0f);
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 maximum = _mm_set1_ps(255.0f);
+        for (; i + 16 <= count; i += 16)
+        {
+            __m128i v[4];
+            for (int j = 0; j < 4; ++j)
+            {
+                // clamped and truncated like Bitwise::floatToFixed
+                __m128 f = _mm_mul_ps(_mm_loadu_ps(src + i + 4 * j), scale);
+                v[j] = _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(f, zero), maximum));
+            }
+            __m128i words0 = _mm_packs_epi32(v[0], v[1]);
+            __m128i words1 = _mm_packs_epi32(v[2], v[3]);
+            _mm_storeu_si128((__m128i*)(dst + i), _mm_packus_epi16(words0, words1));
+        }
+#endif
+        _getOptimisedUtilGeneral()->convertFloatToUnorm(src + i, dst + i, count - i);
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilSSE::convertHalfToFloat(const uint16* src, float* dst, size_t count)
+    {
+        size_t i = 0;
+#ifdef __SSE2__
+        const __m128i zero = _mm_setzero_si128();
+        for (; i + 8 <= count; i += 8)
+        {
+            __m128i halfs = _mm_loadu_si128((const __m128i*)(src + i));
+            _mm_storeu_ps(dst + i, halfToFloat4(_mm_unpacklo_epi16(halfs, zero)));
+            _mm_storeu_ps(dst + i + 4, halfToFloat4(_mm_unpackhi_epi16(halfs, zero)));
+        }
+#endif
+        _getOptimisedUtilGeneral()->convertHalfToFloat(src + i, dst + i, count - i);
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilSSE::convertFloatToHalf(const float* src, uint16* dst, size_t count)
+    {
+        size_t i = 0;
+#ifdef __SSE2__
+        for (; i + 8 <= count; i += 8)
+        {
+            __m128i lo = floatToHalf4(_mm_loadu_ps(src + i));
+            __m128i hi = floatToHalf4(_mm_loadu_ps(src + i + 4));
+            _mm_storeu_si128((__m128i*)(dst + i), packUint16(lo, hi));
+        }
+#endif
+        _getOptimisedUtilGeneral()->convertFloatToHalf(src + i, dst + i, count - i);
+    }
+    //---------------------------------------------------------------------
+    /// Row of a matrix product, a0 * b0 + a1 * b1 + a2 * b2 + a3 * b3 with ai the elements of the lhs row a
+    static inline auto multiplyRow(__m128 a, __m128 b0, __m128 b1, __m128 b2, __m128 b3) -> __m128
+    {
+        return __MM_DOT4x4_PS(__MM_SELECT(a, 0), __MM_SELECT(a, 1), __MM_SELECT(a, 2), __MM_SELECT(a, 3),
+                              b0, b1, b2, b3);
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilSSE::multiplyMatrices(
+        const Matrix4* pLhsMat,
+        const Matrix4* pRhsMat,
+        Matrix4* pDstMat,
+        size_t numMatrices)
+    {
+        for (size_t i = 0; i < numMatrices; ++i)
+        {
+            // Everything is loaded before storing, the destination may be an operand
+            __m128 b0 = _mm_loadu_ps(pRhsMat[i][0]);
+            __m128 b1 = _mm_loadu_ps(pRhsMat[i][1]);
+            __m128 b2 = _mm_loadu_ps(pRhsMat[i][2]);
+            __m128 b3 = _mm_loadu_ps(pRhsMat[i][3]);
+            __m128 a0 = _mm_loadu_ps(pLhsMat[i][0]);
+            __m128 a1 = _mm_loadu_ps(pLhsMat[i][1]);
+            __m128 a2 = _mm_loadu_ps(pLhsMat[i][2]);
+            __m128 a3 = _mm_loadu_ps(pLhsMat[i][3]);
+
+            _mm_storeu_ps(pDstMat[i][0], multiplyRow(a0, b0, b1, b2, b3));
+            _mm_storeu_ps(pDstMat[i][1], multiplyRow(a1, b0, b1, b2, b3));
+            _mm_storeu_ps(pDstMat[i][2], multiplyRow(a2, b0, b1, b2, b3));
+            _mm_storeu_ps(pDstMat[i][3], multiplyRow(a3, b0, b1, b2, b3));
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilSSE::multiplyAffineMatrices(
+        const Affine3* pLhsMat,
+        const Affine3* pRhsMat,
+        Affine3* pDstMat,
+        size_t numMatrices)
+    {
+        // The implicit last row (0, 0, 0, 1) of the rhs adds the translation of the lhs
+        const __m128 b3 = _mm_setr_ps(0, 0, 0, 1);
+
+        for (size_t i = 0; i < numMatrices; ++i)
+        {
+            __m128 b0 = _mm_loadu_ps(pRhsMat[i][0]);
+            __m128 b1 = _mm_loadu_ps(pRhsMat[i][1]);
+            __m128 b2 = _mm_loadu_ps(pRhsMat[i][2]);
+            __m128 a0 = _mm_loadu_ps(pLhsMat[i][0]);
+            __m128 a1 = _mm_loadu_ps(pLhsMat[i][1]);
+            __m128 a2 = _mm_loadu_ps(pLhsMat[i][2]);
+
+            _mm_storeu_ps(pDstMat[i][0], multiplyRow(a0, b0, b1, b2, b3));
+            _mm_storeu_ps(pDstMat[i][1], multiplyRow(a1, b0, b1, b2, b3));
+            _mm_storeu_ps(pDstMat[i][2], multiplyRow(a2, b0, b1, b2, b3));
+            _mm_storeu_ps(pDstMat[i][3], b3);
+        }
+    }
+    //---------------------------------------------------------------------
+    /// Cross product of the x, y, z components, with a w component of a.w * b.w - b.w * a.w, so 0
+    static inline auto cross3(__m128 a, __m128 b) -> __m128
+    {
+        __m128 aYZX = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3,0,2,1));
+        __m128 bYZX = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3,0,2,1));
+        __m128 c = _mm_sub_ps(_mm_mul_ps(a, bYZX), _mm_mul_ps(aYZX, b));
+        return _mm_shuffle_ps(c, c, _MM_SHUFFLE(3,0,2,1));
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilSSE::inverseAffineMatrices(
+        const Affine3* pSrcMat,
+        Affine3* pDstMat,
+        size_t numMatrices)
+    {
+        const __m128 unitW = _mm_setr_ps(0, 0, 0, 1);
+
+        for (size_t i = 0; i < numMatrices; ++i)
+        {
+            __m128 r0 = _mm_loadu_ps(pSrcMat[i][0]);
+            __m128 r1 = _mm_loadu_ps(pSrcMat[i][1]);
+            __m128 r2 = _mm_loadu_ps(pSrcMat[i][2]);
+
+            // The columns of the inverse of the linear part are the cross products of its
+            // rows divided by the determinant, their w components are 0
+            __m128 c0 = cross3(r1, r2);
+            __m128 c1 = cross3(r2, r0);
+            __m128 c2 = cross3(r0, r1);
+
+            __m128 det = _mm_mul_ps(r0, c0);
+            det = _mm_add_ps(det, _mm_movehl_ps(det, det));
+            det = _mm_add_ss(det, _mm_shuffle_ps(det, det, _MM_SHUFFLE(1,1,1,1)));
+            __m128 invDet = _mm_div_ps(_mm_set1_ps(1.0f), __MM_SELECT(det, 0));
+            c0 = _mm_mul_ps(c0, invDet);
+            c1 = _mm_mul_ps(c1, invDet);
+            c2 = _mm_mul_ps(c2, invDet);
+
+            // The translation is the inverse applied to the negated translation
+            __m128 t = _mm_sub_ps(_mm_setzero_ps(), __MM_DOT3x3_PS(
+                c0, c1, c2, __MM_SELECT(r0, 3), __MM_SELECT(r1, 3), __MM_SELECT(r2, 3)));
+
+            __MM_TRANSPOSE4x4_PS(c0, c1, c2, t);
+            _mm_storeu_ps(pDstMat[i][0], c0);
+            _mm_storeu_ps(pDstMat[i][1], c1);
+            _mm_storeu_ps(pDstMat[i][2], c2);
+            _mm_storeu_ps(pDstMat[i][3], unitW);
+        }
+    }
+    //---------------------------------------------------------------------
+    /// Transforms packed xyz vectors four at a time, the rest by the general implementation
+    template <bool translate>
+    static inline auto transformVectors_SSE(
+        const Affine3& matrix,
+        const Vector3* srcVectors,
+        Vector3* dstVectors,
+        size_t numVectors) -> size_t
+    {
+        static_assert(sizeof(Vector3) == 3 * sizeof(float));
+        __m128 m00 = _mm_set1_ps(matrix[0][0]), m01 = _mm_set1_ps(matrix[0][1]), m02 = _mm_set1_ps(matrix[0][2]);
+        __m128 m10 = _mm_set1_ps(matrix[1][0]), m11 = _mm_set1_ps(matrix[1][1]), m12 = _mm_set1_ps(matrix[1][2]);
+        __m128 m20 = _mm_set1_ps(matrix[2][0]), m21 = _mm_set1_ps(matrix[2][1]), m22 = _mm_set1_ps(matrix[2][2]);
+        __m128 m03 = _mm_set1_ps(translate ? matrix[0][3] : 0);
+        __m128 m13 = _mm_set1_ps(translate ? matrix[1][3] : 0);
+        __m128 m23 = _mm_set1_ps(translate ? matrix[2][3] : 0);
+
+        const float* pSrc = srcVectors->ptr();
+        float* pDst = dstVectors->ptr();
+        size_t numIterations = numVectors / 4;
+        for (size_t i = 0; i < numIterations; ++i)
+        {
+            __m128 x = _mm_loadu_ps(pSrc + 0);
+            __m128 y = _mm_loadu_ps(pSrc + 4);
+            __m128 z = _mm_loadu_ps(pSrc + 8);
+            __MM_TRANSPOSE4x3_PS(x, y, z);
+
+            __m128 dx = __MM_DOT4x3_PS(m00, m01, m02, m03, x, y, z);
+            __m128 dy = __MM_DOT4x3_PS(m10, m11, m12, m13, x, y, z);
+            __m128 dz = __MM_DOT4x3_PS(m20, m21, m22, m23, x, y, z);
+            __MM_TRANSPOSE3x4_PS(dx, dy, dz);
+
+            _mm_storeu_ps(pDst + 0, dx);
+            _mm_storeu_ps(pDst + 4, dy);
+            _mm_storeu_ps(pDst + 8, dz);
+            pSrc += 12;
+            pDst += 12;
+        }
+        return numIterations * 4;
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilSSE::transformPoints(
+        const Affine3& matrix,
+        const Vector3* srcPoints,
+        Vector3* dstPoints,
+        size_t numPoints)
+    {
+        size_t i = transformVectors_SSE<true>(matrix, srcPoints, dstPoints, numPoints);
+        _getOptimisedUtilGeneral()->transformPoints(matrix, srcPoints + i, dstPoints + i, numPoints - i);
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilSSE::transformDirections(
+        const Affine3& matrix,
+        const Vector3* srcDirections,
+        Vector3* dstDirections,
+        size_t numDirections)
+    {
+        size_t i = transformVectors_SSE<false>(matrix, srcDirections, dstDirections, numDirections);
+        _getOptimisedUtilGeneral()->transformDirections(matrix, srcDirections + i, dstDirections + i, numDirections - i);
+    }
+    //---------------------------------------------------------------------
+    /// Loads four quaternions as their w, x, y and z components
+    static inline void loadQuaternions4(const Quaternion* q, __m128& w, __m128& x, __m128& y, __m128& z)
+    {
+        w = _mm_loadu_ps(q[0].ptr());
+        x = _mm_loadu_ps(q[1].ptr());
+        y = _mm_loadu_ps(q[2].ptr());
+        z = _mm_loadu_ps(q[3].ptr());
+        __MM_TRANSPOSE4x4_PS(w, x, y, z);
+    }
+    //---------------------------------------------------------------------
+    /// Stores four quaternions from their w, x, y and z components
+    static inline void storeQuaternions4(Quaternion* q, __m128 w, __m128 x, __m128 y, __m128 z)
+    {
+        __MM_TRANSPOSE4x4_PS(w, x, y, z);
+        _mm_storeu_ps(q[0].ptr(), w);
+        _mm_storeu_ps(q[1].ptr(), x);
+        _mm_storeu_ps(q[2].ptr(), y);
+        _mm_storeu_ps(q[3].ptr(), z);
+    }
+    //---------------------------------------------------------------------
+    /// sin(t * angle) / sin(angle) for cos(angle) - 1 in xm1, see OptimisedUtil::SLERP_U
+    static inline auto slerpCoefficient(__m128 t, __m128 xm1) -> __m128
+    {
+        __m128 sqrT = _mm_mul_ps(t, t);
+        __m128 f = _mm_set1_ps(1.0f);
+        for (size_t i = OptimisedUtil::SLERP_TERMS; i-- > 0;)
+        {
+            __m128 b = _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(_mm_set1_ps(OptimisedUtil::SLERP_U[i]), sqrT),
+                                             _mm_set1_ps(OptimisedUtil::SLERP_V[i])), xm1);
+            f = __MM_MADD_PS(b, f, _mm_set1_ps(1.0f));
+        }
+        return _mm_mul_ps(t, f);
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilSSE::slerpQuaternions(
+        const Quaternion* from, const Quaternion* to,
+        const float* t,
+        Quaternion* dst,
+        size_t numQuaternions,
+        bool shortestPath)
+    {
+        const __m128 signMask = _mm_set1_ps(-0.0f);
+        const __m128 one = _mm_set1_ps(1.0f);
+
+        size_t i = 0;
+        for (; i + 4 <= numQuaternions; i += 4)
+        {
+            __m128 pw, px, py, pz, qw, qx, qy, qz;
+            loadQuaternions4(from + i, pw, px, py, pz);
+            loadQuaternions4(to + i, qw, qx, qy, qz);
+            __m128 cos = __MM_DOT4x4_PS(pw, px, py, pz, qw, qx, qy, qz);
+
+            if (shortestPath)
+            {
+                // Negate q where the cosine is negative
+                __m128 sign = _mm_and_ps(cos, signMask);
+                cos = _mm_xor_ps(cos, sign);
+                qw = _mm_xor_ps(qw, sign);
+                qx = _mm_xor_ps(qx, sign);
+                qy = _mm_xor_ps(qy, sign);
+                qz = _mm_xor_ps(qz, sign);
+            }
+            else if (_mm_movemask_ps(_mm_cmplt_ps(cos, _mm_setzero_ps())))
+            {
+                // The polynomial only covers angles up to 90 degrees
+                _getOptimisedUtilGeneral()->slerpQuaternions(from + i, to + i, t + i, dst + i, 4, false);
+                continue;
+            }
+
+            __m128 tq = _mm_loadu_ps(t + i);
+            __m128 xm1 = _mm_sub_ps(cos, one);
+            __m128 cp = slerpCoefficient(_mm_sub_ps(one, tq), xm1);
+            __m128 cq = slerpCoefficient(tq, xm1);
+
+            storeQuaternions4(dst + i,
+                              _mm_add_ps(_mm_mul_ps(cp, pw), _mm_mul_ps(cq, qw)),
+                              _mm_add_ps(_mm_mul_ps(cp, px), _mm_mul_ps(cq, qx)),
+                              _mm_add_ps(_mm_mul_ps(cp, py), _mm_mul_ps(cq, qy)),
+                              _mm_add_ps(_mm_mul_ps(cp, pz), _mm_mul_ps(cq, qz)));
+        }
+
+        _getOptimisedUtilGeneral()->slerpQuaternions(from + i, to + i, t + i, dst + i, numQuaternions - i, shortestPath);
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilSSE::nlerpQuaternions(
+        const Quaternion* from, const Quaternion* to,
+        const float* t,
+        Quaternion* dst,
+        size_t numQuaternions,
+        bool shortestPath)
+    {
+        const __m128 signMask = _mm_set1_ps(-0.0f);
+
+        size_t i = 0;
+        for (; i + 4 <= numQuaternions; i += 4)
+        {
+            __m128 pw, px, py, pz, qw, qx, qy, qz;
+            loadQuaternions4(from + i, pw, px, py, pz);
+            loadQuaternions4(to + i, qw, qx, qy, qz);
+
+            if (shortestPath)
+            {
+                __m128 sign = _mm_and_ps(__MM_DOT4x4_PS(pw, px, py, pz, qw, qx, qy, qz), signMask);
+                qw = _mm_xor_ps(qw, sign);
+                qx = _mm_xor_ps(qx, sign);
+                qy = _mm_xor_ps(qy, sign);
+                qz = _mm_xor_ps(qz, sign);
+            }
+
+            __m128 tq = _mm_loadu_ps(t + i);
+            __m128 w = __MM_LERP_PS(tq, pw, qw);
+            __m128 x = __MM_LERP_PS(tq, px, qx);
+            __m128 y = __MM_LERP_PS(tq, py, qy);
+            __m128 z = __MM_LERP_PS(tq, pz, qz);
+
+            __m128 invLength = _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(__MM_DOT4x4_PS(w, x, y, z, w, x, y, z)));
+            storeQuaternions4(dst + i, _mm_mul_ps(w, invLength), _mm_mul_ps(x, invLength),
+                              _mm_mul_ps(y, invLength), _mm_mul_ps(z, invLength));
+        }
+
+        _getOptimisedUtilGeneral()->nlerpQuaternions(from + i, to + i, t + i, dst + i, numQuaternions - i, shortestPath);
+    }
+    //---------------------------------------------------------------------
+    /// The lanes of a where mask is set, of b elsewhere
+    static inline auto selectLanes(__m128 mask, __m128 a, __m128 b) -> __m128
+    {
+        return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilSSE::intersectRayBoxes(
+        const Ray& ray,
+        const Math::BoxArrays& boxes,
+        Real* distances,
+        size_t numBoxes)
+    {
+        const Vector3& origin = ray.getOrigin();
+        const Vector3& direction = ray.getDirection();
+        __m128 ox = _mm_set1_ps(origin.x), oy = _mm_set1_ps(origin.y), oz = _mm_set1_ps(origin.z);
+        __m128 ix = _mm_set1_ps(_slabInverse(direction.x));
+        __m128 iy = _mm_set1_ps(_slabInverse(direction.y));
+        __m128 iz = _mm_set1_ps(_slabInverse(direction.z));
+        const __m128 miss = _mm_set1_ps(Math::POS_INFINITY);
+
+        size_t i = 0;
+        for (; i + 4 <= numBoxes; i += 4)
+        {
+            // Slabs of the three axes, the ray hits the box if they have a common part
+            __m128 tx1 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(boxes.minX + i), ox), ix);
+            __m128 tx2 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(boxes.maxX + i), ox), ix);
+            __m128 ty1 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(boxes.minY + i), oy), iy);
+            __m128 ty2 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(boxes.maxY + i), oy), iy);
+            __m128 tz1 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(boxes.minZ + i), oz), iz);
+            __m128 tz2 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(boxes.maxZ + i), oz), iz);
+
+            __m128 tNear = _mm_max_ps(_mm_max_ps(_mm_min_ps(tx1, tx2), _mm_min_ps(ty1, ty2)),
+                                      _mm_max_ps(_mm_min_ps(tz1, tz2), _mm_setzero_ps()));
+            __m128 tFar = _mm_min_ps(_mm_min_ps(_mm_max_ps(tx1, tx2), _mm_max_ps(ty1, ty2)), _mm_max_ps(tz1, tz2));
+            _mm_storeu_ps(distances + i, selectLanes(_mm_cmple_ps(tNear, tFar), tNear, miss));
+        }
+
+        _getOptimisedUtilGeneral()->intersectRayBoxes(
+            ray, {boxes.minX + i, boxes.minY + i, boxes.minZ + i, boxes.maxX + i, boxes.maxY + i, boxes.maxZ + i},
+            distances + i, numBoxes - i);
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilSSE::intersectRayTriangles(
+        const Ray& ray,
+        const Math::TriangleArrays& triangles,
+        Real* distances,
+        size_t numTriangles,
+        bool positiveSide,
+        bool negativeSide)
+    {
+        // Math::intersects for four triangles at once
+        const Vector3& origin = ray.getOrigin();
+        const Vector3& direction = ray.getDirection();
+        __m128 ox = _mm_set1_ps(origin.x), oy = _mm_set1_ps(origin.y), oz = _mm_set1_ps(origin.z);
+        __m128 dx = _mm_set1_ps(direction.x), dy = _mm_set1_ps(direction.y), dz = _mm_set1_ps(direction.z);
+        const __m128 epsilon = _mm_set1_ps(positiveSide ? 1e-6f : Math::POS_INFINITY);
+        const __m128 negEpsilon = _mm_set1_ps(negativeSide ? -1e-6f : Math::NEG_INFINITY);
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 miss = _mm_set1_ps(Math::POS_INFINITY);
+
+        size_t i = 0;
+        for (; i + 4 <= numTriangles; i += 4)
+        {
+            __m128 e1x = _mm_loadu_ps(triangles.e1x + i);
+            __m128 e1y = _mm_loadu_ps(triangles.e1y + i);
+            __m128 e1z = _mm_loadu_ps(triangles.e1z + i);
+            __m128 e2x = _mm_loadu_ps(triangles.e2x + i);
+            __m128 e2y = _mm_loadu_ps(triangles.e2y + i);
+            __m128 e2z = _mm_loadu_ps(triangles.e2z + i);
+
+            // P = direction x E2
+            __m128 px = _mm_sub_ps(_mm_mul_ps(dy, e2z), _mm_mul_ps(dz, e2y));
+            __m128 py = _mm_sub_ps(_mm_mul_ps(dz, e2x), _mm_mul_ps(dx, e2z));
+            __m128 pz = _mm_sub_ps(_mm_mul_ps(dx, e2y), _mm_mul_ps(dy, e2x));
+            __m128 det = __MM_DOT3x3_PS(e1x, e1y, e1z, px, py, pz);
+            __m128 hit = _mm_or_ps(_mm_cmpgt_ps(det, epsilon), _mm_cmplt_ps(det, negEpsilon));
+            __m128 invDet = _mm_div_ps(one, det);
+
+            // T = origin - a, Q = T x E1
+            __m128 tx = _mm_sub_ps(ox, _mm_loadu_ps(triangles.ax + i));
+            __m128 ty = _mm_sub_ps(oy, _mm_loadu_ps(triangles.ay + i));
+            __m128 tz = _mm_sub_ps(oz, _mm_loadu_ps(triangles.az + i));
+            __m128 u = _mm_mul_ps(__MM_DOT3x3_PS(tx, ty, tz, px, py, pz), invDet);
+            __m128 qx = _mm_sub_ps(_mm_mul_ps(ty, e1z), _mm_mul_ps(tz, e1y));
+            __m128 qy = _mm_sub_ps(_mm_mul_ps(tz, e1x), _mm_mul_ps(tx, e1z));
+            __m128 qz = _mm_sub_ps(_mm_mul_ps(tx, e1y), _mm_mul_ps(ty, e1x));
+            __m128 v = _mm_mul_ps(__MM_DOT3x3_PS(dx, dy, dz, qx, qy, qz), invDet);
+            __m128 t = _mm_mul_ps(__MM_DOT3x3_PS(e2x, e2y, e2z, qx, qy, qz), invDet);
+
+            hit = _mm_and_ps(hit, _mm_and_ps(_mm_cmpge_ps(u, zero), _mm_cmpge_ps(v, zero)));
+            hit = _mm_and_ps(hit, _mm_and_ps(_mm_cmple_ps(_mm_add_ps(u, v), one), _mm_cmpge_ps(t, zero)));
+            _mm_storeu_ps(distances + i, selectLanes(hit, t, miss));
+        }
+
+        _getOptimisedUtilGeneral()->intersectRayTriangles(
+            ray,
+            {triangles.ax + i, triangles.ay + i, triangles.az + i,
+             triangles.e1x + i, triangles.e1y + i, triangles.e1z + i,
+             triangles.e2x + i, triangles.e2y + i, triangles.e2z + i},
+            distances + i, numTriangles - i, positiveSide, negativeSide);
+    }
+    //---------------------------------------------------------------------
     //---------------------------------------------------------------------
     //---------------------------------------------------------------------
     extern auto _getOptimisedUtilSSE() -> OptimisedUtil*;
@@ -2002,3 +2773,5 @@ namespace Ogre {
     }
 
 }
+
+#endif // defined(__i386__) || defined(__x86_64__)
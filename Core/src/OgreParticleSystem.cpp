@@ -36,12 +36,15 @@ import :Common;
 import :Controller;
 import :ControllerManager;
 import :Exception;
+import :LodStrategy;
+import :LodStrategyManager;
 import :LogManager;
 import :Material;
 import :MaterialManager;
 import :Math;
 import :Matrix4;
 import :Node;
+import :OptimisedUtil;
 import :Particle;
 import :ParticleAffector;
 import :ParticleAffectorFactory;
@@ -53,8 +56,10 @@ import :RadixSort;
 import :Root;
 import :SceneManager;
 import :StringConverter;
+import :WorkQueue;
 
 import <algorithm>;
+import <limits>;
 import <span>;
 import <utility>;
 
@@ -115,6 +120,27 @@ namespace Ogre {
         auto doGet(const void* target) const -> String override;
         void doSet(void* target, std::string_view val) override;
     };
+    /** Command object for the sort interval (see ParamCommand).*/
+    class CmdSortInterval : public ParamCommand
+    {
+    public:
+        auto doGet(const void* target) const -> String override;
+        void doSet(void* target, std::string_view val) override;
+    };
+    /** Command object for the sort distance threshold (see ParamCommand).*/
+    class CmdSortDistanceThreshold : public ParamCommand
+    {
+    public:
+        auto doGet(const void* target) const -> String override;
+        void doSet(void* target, std::string_view val) override;
+    };
+    /** Command object for quantized sort keys (see ParamCommand).*/
+    class CmdSortKeysQuantized : public ParamCommand
+    {
+    public:
+        auto doGet(const void* target) const -> String override;
+        void doSet(void* target, std::string_view val) override;
+    };
     /** Command object for local space (see ParamCommand).*/
     class CmdLocalSpace : public ParamCommand
     {
@@ -145,12 +171,44 @@ namespace Ogre {
     static CmdWidth msWidthCmd;
     static CmdRenderer msRendererCmd;
     static CmdSorted msSortedCmd;
+    static CmdSortInterval msSortIntervalCmd;
+    static CmdSortDistanceThreshold msSortDistanceThresholdCmd;
+    static CmdSortKeysQuantized msSortKeysQuantizedCmd;
     static CmdLocalSpace msLocalSpaceCmd;
     static CmdIterationInterval msIterationIntervalCmd;
     static CmdNonvisibleTimeout msNonvisibleTimeoutCmd;
 
     Real constinit ParticleSystem::msDefaultIterationInterval = 0;
     Real constinit ParticleSystem::msDefaultNonvisibleTimeout = 0;
+    size_t constinit ParticleSystem::msParallelChunkSize = 4096;
+
+    namespace
+    {
+        /** Calls func(begin, end) for consecutive particle ranges covering numParticles.
+        @remarks
+            The ranges are spread over the WorkQueue when the system is larger than
+            ParticleSystem::getParallelChunkSize.
+        */
+        template<typename Func>
+        void forEachParticleRange(size_t numParticles, const Func& func)
+        {
+            size_t chunkSize = ParticleSystem::getParallelChunkSize();
+            Root* root = Root::getSingletonPtr();
+            if (chunkSize && numParticles > chunkSize && root && root->getWorkQueue())
+            {
+                size_t numChunks = (numParticles + chunkSize - 1) / chunkSize;
+                root->getWorkQueue()->parallelFor(numChunks, [&](size_t chunk)
+                {
+                    size_t begin = chunk * chunkSize;
+                    func(begin, std::min(begin + chunkSize, numParticles));
+                });
+            }
+            else
+            {
+                func(0, numParticles);
+            }
+        }
+    }
 
     //-----------------------------------------------------------------------
     // Local class for updating based on time
@@ -163,7 +221,19 @@ namespace Ogre {
 
         [[nodiscard]] auto getValue() const noexcept -> Real override { return 0; } // N/A
 
-        void setValue(Real value) override { mTarget->_update(value); }
+        void setValue(Real value) override
+        {
+            ParticleSystemManager& mgr = ParticleSystemManager::getSingleton();
+            if (mgr.getParticleBudget() > 0)
+                mgr._addToBudget(mTarget);
+            else
+                mTarget->_setBudgetQuota(std::numeric_limits<size_t>::max());
+
+            if (mgr.getParallelUpdatesEnabled())
+                mgr._queueUpdate(mTarget, value);
+            else
+                mTarget->_update(value);
+        }
 
     };
     //-----------------------------------------------------------------------
@@ -194,6 +264,9 @@ namespace Ogre {
     {
         initParameters();
 
+        if (auto lodMgr = LodStrategyManager::getSingletonPtr())
+            mLodStrategy = lodMgr->getDefaultStrategy();
+
         // Default to billboard renderer
         setRenderer("billboard");
         mCastShadows = false;
@@ -232,6 +305,9 @@ namespace Ogre {
         setEmittedEmitterQuota( 3 );
         initParameters();
 
+        if (auto lodMgr = LodStrategyManager::getSingletonPtr())
+            mLodStrategy = lodMgr->getDefaultStrategy();
+
         // Default to billboard renderer
         setRenderer("billboard");
         mCastShadows = false;
@@ -245,6 +321,8 @@ namespace Ogre {
             ControllerManager::getSingleton().destroyController(mTimeController);
             mTimeController = nullptr;
         }
+        if (auto mgr = ParticleSystemManager::getSingletonPtr())
+            mgr->_removeQueuedUpdates(this);
 
         // Arrange for the deletion of emitters & affectors
         removeAllEmitters();
@@ -368,11 +446,16 @@ namespace Ogre {
         setDefaultDimensions(rhs.mDefaultWidth, rhs.mDefaultHeight);
         mCullIndividual = rhs.mCullIndividual;
         mSorted = rhs.mSorted;
+        setSortInterval(rhs.mSortInterval, rhs.mSortDistanceThreshold, rhs.mSortAngleThreshold);
+        setSortKeysQuantized(rhs.getSortKeysQuantized());
         mLocalSpace = rhs.mLocalSpace;
         mIterationInterval = rhs.mIterationInterval;
         mIterationIntervalSet = rhs.mIterationIntervalSet;
         mNonvisibleTimeout = rhs.mNonvisibleTimeout;
         mNonvisibleTimeoutSet = rhs.mNonvisibleTimeoutSet;
+        mLodStrategy = rhs.mLodStrategy;
+        setLodLevels(rhs.mLodLevels);
+        mBudgetPriority = rhs.mBudgetPriority;
         // last frame visible and time since last visible should be left default
 
         setRenderer(rhs.getRendererName());
@@ -418,9 +501,9 @@ namespace Ogre {
     {
         // Never shrink below size()
         size_t currSize = 0;
-        for (auto const& [key, value] : mEmittedEmitterPool)
+        for (auto const& pool : mEmittedEmitterPools)
         {
-            currSize += value.size();
+            currSize += pool.emitters.size();
         }
 
         if( currSize < size )
@@ -442,6 +525,58 @@ namespace Ogre {
         mIterationIntervalSet = true;
     }
     //-----------------------------------------------------------------------
+    void ParticleSystem::setLodStrategy(LodStrategy* strategy)
+    {
+        OgreAssert(strategy, "LodStrategy must not be null");
+        mLodStrategy = strategy;
+        setLodLevels(mLodLevels);
+    }
+    //-----------------------------------------------------------------------
+    void ParticleSystem::setLodLevels(const LodLevelList& levels)
+    {
+        if (!mLodStrategy)
+            mLodStrategy = LodStrategyManager::getSingleton().getDefaultStrategy();
+
+        mLodValues.clear();
+        if (!levels.empty())
+        {
+            mLodValues.push_back(mLodStrategy->getBaseValue());
+            for (const auto& level : levels)
+            {
+                OgreAssert(level.emissionRateScale >= 0, "emissionRateScale must not be negative");
+                mLodValues.push_back(mLodStrategy->transformUserValue(level.userValue));
+            }
+            mLodStrategy->assertSorted(mLodValues);
+        }
+        if (&levels != &mLodLevels)
+            mLodLevels = levels;
+        mLodIndex = 0;
+    }
+    //-----------------------------------------------------------------------
+    auto ParticleSystem::getCurrentLodLevel() const -> const LodLevel*
+    {
+        if (mLodIndex > 0 && mLodIndex <= mLodLevels.size())
+            return &mLodLevels[mLodIndex - 1];
+        return nullptr;
+    }
+    //-----------------------------------------------------------------------
+    auto ParticleSystem::getEffectiveParticleQuota() const -> size_t
+    {
+        size_t quota = std::min(mPoolSize, mBudgetQuota);
+        if (const LodLevel* lod = getCurrentLodLevel(); lod && lod->quota > 0)
+            quota = std::min(quota, lod->quota);
+        return quota;
+    }
+    //-----------------------------------------------------------------------
+    auto ParticleSystem::_getSquaredCameraDistance() const -> Real
+    {
+        // same ordering as the visibility check in _update
+        long frameDiff = Root::getSingleton().getNextFrameNumber() - mLodFrame;
+        if (frameDiff > 1 || frameDiff < 0)
+            return std::numeric_limits<Real>::max();
+        return mLodCameraDistance;
+    }
+    //-----------------------------------------------------------------------
     void ParticleSystem::_update(Real timeElapsed)
     {
         // Only update if attached to a node
@@ -476,8 +611,19 @@ namespace Ogre {
         // Initialise emitted emitters list if not done already
         initialiseEmittedEmitters();
 
+        // Renderers simulating the particles on their own replace everything below
+        AxisAlignedBox simulatedBounds;
+        if (mRenderer && mRenderer->_simulateParticles(this, timeElapsed, simulatedBounds))
+        {
+            setBounds(simulatedBounds);
+            notifyBoundsChanged();
+            return;
+        }
+
         Real iterationInterval = mIterationIntervalSet ? 
             mIterationInterval : msDefaultIterationInterval;
+        if (const LodLevel* lod = getCurrentLodLevel(); lod && lod->iterationInterval > 0)
+            iterationInterval = lod->iterationInterval;
         if (iterationInterval > 0)
         {
             mUpdateRemainTime += timeElapsed;
@@ -500,6 +646,10 @@ namespace Ogre {
         }
         else
         {
+            // Time left over by a coarser level of detail
+            timeElapsed += mUpdateRemainTime;
+            mUpdateRemainTime = 0;
+
             // Update existing particles
             _expire(timeElapsed);
             _triggerAffectors(timeElapsed);
@@ -518,6 +668,27 @@ namespace Ogre {
 
     }
     //-----------------------------------------------------------------------
+    void ParticleSystem::_beginConcurrentUpdate()
+    {
+        if (!mParentNode)
+            return;
+
+        configureRenderer();
+        initialiseEmittedEmitters();
+
+        // resolves the derived transform, which is only read from here on
+        mParentNode->_getFullTransform();
+        mConcurrentUpdate = true;
+    }
+    //-----------------------------------------------------------------------
+    void ParticleSystem::_endConcurrentUpdate()
+    {
+        mConcurrentUpdate = false;
+        if (mNodeUpdatePending && mParentNode)
+            mParentNode->needUpdate();
+        mNodeUpdatePending = false;
+    }
+    //-----------------------------------------------------------------------
     void ParticleSystem::_expire(Real timeElapsed)
     {
         Particle* pParticle;
@@ -540,13 +711,9 @@ namespace Ogre {
                 }
                 else
                 {
-                    // For now, it can only be an emitted emitter
+                    // For now, it can only be an emitted emitter, back to its pool
                     pParticleEmitter = static_cast<ParticleEmitter*>(*i);
-                    std::list<ParticleEmitter*>* fee = findFreeEmittedEmitter(pParticleEmitter->getName());
-                    fee->push_back(pParticleEmitter);
-
-                    // Also erase from mActiveEmittedEmitters
-                    removeFromActiveEmittedEmitters (pParticleEmitter);
+                    releaseEmittedEmitter(pParticleEmitter);
                 }
 
                 // And remove from mActiveParticles
@@ -566,8 +733,8 @@ namespace Ogre {
     void ParticleSystem::_triggerEmitters(Real timeElapsed)
     {
         // Add up requests for emission
-        static std::vector<unsigned> requested;
-        static std::vector<unsigned> emittedRequested;
+        std::vector<unsigned>& requested = mRequestedEmissions;
+        std::vector<unsigned>& emittedRequested = mRequestedEmittedEmissions;
 
         if( requested.size() != mEmitters.size() )
             requested.resize( mEmitters.size() );
@@ -581,6 +748,26 @@ namespace Ogre {
         emissionAllowed = mFreeParticles.size();
         totalRequested = 0;
 
+        // Level of detail and particle budget
+        if (size_t quota = getEffectiveParticleQuota(); quota < mPoolSize)
+            emissionAllowed = std::min(emissionAllowed,
+                quota > mActiveParticles.size() ? quota - mActiveParticles.size() : 0);
+
+        const LodLevel* lod = getCurrentLodLevel();
+        Real emissionScale = lod ? lod->emissionRateScale : 1;
+        mLodEmissionRemainders.resize(requested.size());
+        mLodEmittedEmissionRemainders.resize(emittedRequested.size());
+        // keeps the fractions, so that rates scaled below one per update still emit
+        auto scaleEmission = [emissionScale](unsigned count, Real& remainder) -> unsigned
+        {
+            if (emissionScale == 1)
+                return count;
+            remainder += count * emissionScale;
+            auto scaled = static_cast<unsigned>(remainder);
+            remainder -= scaled;
+            return scaled;
+        };
+
         // Count up total requested emissions for regular emitters (and exclude the ones that are used as
         // a template for emitted emitters)
         for (size_t i = 0;
@@ -588,7 +775,8 @@ namespace Ogre {
         {
             if (!itEmit->isEmitted())
             {
-                requested[i] = itEmit->_getEmissionCount(timeElapsed);
+                requested[i] = scaleEmission(itEmit->_getEmissionCount(timeElapsed),
+                                             mLodEmissionRemainders[i]);
                 totalRequested += requested[i];
             }
             ++i;
@@ -598,7 +786,8 @@ namespace Ogre {
         for (size_t  i=0;
             auto const& itActiveEmit : mActiveEmittedEmitters)
         {
-            emittedRequested[i] = itActiveEmit->_getEmissionCount(timeElapsed);
+            emittedRequested[i] = scaleEmission(itActiveEmit->_getEmissionCount(timeElapsed),
+                                                mLodEmittedEmissionRemainders[i]);
             totalRequested += emittedRequested[i];
             ++i;
         }
@@ -633,12 +822,10 @@ namespace Ogre {
             ++i;
         }
 
-        // Do the same with all active emitted emitters
-        for (size_t i = 0;
-             auto const& itActiveEmit : mActiveEmittedEmitters)
+        // Do the same with all active emitted emitters, but not with the ones activated by them
+        for (size_t i = 0; i < emittedEmitterCount; ++i)
         {
-            _executeTriggerEmitters (itActiveEmit, emittedRequested[i], timeElapsed);
-            ++i;
+            _executeTriggerEmitters (mActiveEmittedEmitters[i], emittedRequested[i], timeElapsed);
         }
     }
     //-----------------------------------------------------------------------
@@ -658,11 +845,10 @@ namespace Ogre {
             // Create a new particle & init using emitter
             // The particle is a visual particle if the emit_emitter property of the emitter isn't set 
             Particle* p = nullptr;
-            std::string_view emitterName = emitter->getEmittedEmitter();
-            if (emitterName.empty())
+            if (emitter->getEmittedEmitter().empty())
                 p = createParticle();
             else
-                p = createEmitterParticle(emitterName);
+                p = activateEmittedEmitter(emitter->_getEmittedEmitterPool());
 
             // Only continue if the particle was really created (not null)
             if (!p)
@@ -694,9 +880,29 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     void ParticleSystem::_applyMotion(Real timeElapsed)
     {
-        for (auto pParticle : mActiveParticles)
+        if (mParticleArraysCurrent)
         {
-            pParticle->mPosition += (pParticle->mDirection * timeElapsed);
+            // Batched affectors left the latest state in the arrays, so move them there
+            // and write everything back in one go
+            ParticleArrays& arrays = mParticleArrays;
+            forEachParticleRange(arrays.count, [&](size_t begin, size_t end)
+            {
+                OptimisedUtil::getImplementation()->integrateArrays(
+                    arrays.positionX.data() + begin, arrays.positionY.data() + begin,
+                    arrays.positionZ.data() + begin,
+                    arrays.directionX.data() + begin, arrays.directionY.data() + begin,
+                    arrays.directionZ.data() + begin,
+                    timeElapsed, end - begin);
+            });
+            arrays.scatter(mActiveParticles);
+            mParticleArraysCurrent = false;
+        }
+        else
+        {
+            for (auto pParticle : mActiveParticles)
+            {
+                pParticle->mPosition += (pParticle->mDirection * timeElapsed);
+            }
         }
 
         // Notify renderer
@@ -707,7 +913,28 @@ namespace Ogre {
     {
         for (auto a : mAffectors)
         {
-            a->_affectParticles(this, timeElapsed);
+            if (a->isBatched())
+            {
+                if (!mParticleArraysCurrent)
+                {
+                    mParticleArrays.gather(mActiveParticles);
+                    mParticleArraysCurrent = true;
+                }
+                forEachParticleRange(mParticleArrays.count, [&](size_t begin, size_t end)
+                {
+                    a->_affectParticleArrays(this, mParticleArrays, begin, end, timeElapsed);
+                });
+            }
+            else
+            {
+                // object based affectors need to see what the batched ones did
+                if (mParticleArraysCurrent)
+                {
+                    mParticleArrays.scatter(mActiveParticles);
+                    mParticleArraysCurrent = false;
+                }
+                a->_affectParticles(this, timeElapsed);
+            }
         }
     }
     //-----------------------------------------------------------------------
@@ -748,21 +975,29 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     auto ParticleSystem::createEmitterParticle(std::string_view emitterName) -> Particle*
     {
-        // Get the appropriate list and retrieve an emitter 
-        ParticleEmitter* p = nullptr;
-        std::list<ParticleEmitter*>* fee = findFreeEmittedEmitter(emitterName);
-        if (fee && !fee->empty())
-        {
-            p = fee->front();
-            p->mParticleType = Particle::ParticleType::Emitter;
-            fee->pop_front();
-            mActiveParticles.push_back(p);
+        return activateEmittedEmitter(findEmittedEmitterPool(emitterName));
+    }
+    //-----------------------------------------------------------------------
+    auto ParticleSystem::activateEmittedEmitter(size_t pool) -> Particle*
+    {
+        if (pool >= mEmittedEmitterPools.size())
+            return nullptr;
 
-            // Also add to mActiveEmittedEmitters. This is needed to traverse through all active emitters
-            // that are emitted. Don't use mActiveParticles for that (although they are added to
-            // mActiveParticles also), because it would take too long to traverse.
-            mActiveEmittedEmitters.push_back(p);
-        }
+        // Retrieve an emitter from the pool
+        std::vector<ParticleEmitter*>& freeEmitters = mEmittedEmitterPools[pool].free;
+        if (freeEmitters.empty())
+            return nullptr;
+
+        ParticleEmitter* p = freeEmitters.back();
+        freeEmitters.pop_back();
+        p->mParticleType = Particle::ParticleType::Emitter;
+        mActiveParticles.push_back(p);
+
+        // Also add to mActiveEmittedEmitters. This is needed to traverse through all active emitters
+        // that are emitted. Don't use mActiveParticles for that (although they are added to
+        // mActiveParticles also), because it would take too long to traverse.
+        p->_setActiveIndex(mActiveEmittedEmitters.size());
+        mActiveEmittedEmitters.push_back(p);
 
         return p;
     }
@@ -831,6 +1066,21 @@ namespace Ogre {
                 ParameterType::BOOL),
                 &msSortedCmd);
 
+            dict->addParameter(ParameterDef("sort_interval", 
+                "Sets the number of frames between two sorts, 0 to only sort when the camera moves.",
+                ParameterType::UNSIGNED_INT),
+                &msSortIntervalCmd);
+
+            dict->addParameter(ParameterDef("sort_distance_threshold", 
+                "Sets how far the camera can move between two sorts.",
+                ParameterType::REAL),
+                &msSortDistanceThresholdCmd);
+
+            dict->addParameter(ParameterDef("sort_keys_quantized", 
+                "Sets whether particles are sorted by 16 bit depths.",
+                ParameterType::BOOL),
+                &msSortKeysQuantizedCmd);
+
             dict->addParameter(ParameterDef("local_space", 
                 "Sets whether particles should be kept in local space rather than "
                 "emitted into world space. ",
@@ -881,11 +1131,38 @@ namespace Ogre {
                     max.x = max.y = max.z = Math::NEG_INFINITY;
                 }
                 Vector3 halfScale = Vector3::UNIT_SCALE * 0.5;
-                for (auto p : mActiveParticles)
+                auto growBounds = [&](size_t begin, size_t end, Vector3& boundsMin, Vector3& boundsMax)
+                {
+                    for (size_t i = begin; i < end; ++i)
+                    {
+                        const Particle* p = mActiveParticles[i];
+                        Vector3 padding = halfScale * std::max(p->mWidth, p->mHeight);
+                        boundsMin.makeFloor(p->mPosition - padding);
+                        boundsMax.makeCeil(p->mPosition + padding);
+                    }
+                };
+
+                size_t numParticles = mActiveParticles.size();
+                size_t chunkSize = msParallelChunkSize;
+                if (chunkSize && numParticles > chunkSize)
                 {
-                    Vector3 padding = halfScale * std::max(p->mWidth, p->mHeight);
-                    min.makeFloor(p->mPosition - padding);
-                    max.makeCeil(p->mPosition + padding);
+                    // every chunk grows its own box, which are merged afterwards
+                    std::vector<std::pair<Vector3, Vector3>> chunkBounds(
+                        (numParticles + chunkSize - 1) / chunkSize, {min, max});
+                    forEachParticleRange(numParticles, [&](size_t begin, size_t end)
+                    {
+                        auto& [chunkMin, chunkMax] = chunkBounds[begin / chunkSize];
+                        growBounds(begin, end, chunkMin, chunkMax);
+                    });
+                    for (auto const& [chunkMin, chunkMax] : chunkBounds)
+                    {
+                        min.makeFloor(chunkMin);
+                        max.makeCeil(chunkMax);
+                    }
+                }
+                else
+                {
+                    growBounds(0, numParticles, min, max);
                 }
                 mWorldAABB.setExtents(min, max);
             }
@@ -914,11 +1191,21 @@ namespace Ogre {
                     mAABB.merge(newAABB);
             }
 
+            notifyBoundsChanged();
+        }
+    }
+    //-----------------------------------------------------------------------
+    void ParticleSystem::notifyBoundsChanged()
+    {
+        // other systems may be updating at the same time, so leave the
+        // scene graph alone until they are done
+        if (mConcurrentUpdate)
+            mNodeUpdatePending = true;
+        else
             mParentNode->needUpdate();
 
-            if (mRenderer)
-                mRenderer->_notifyBoundingBox(mAABB);
-        }
+        if (mRenderer)
+            mRenderer->_notifyBoundingBox(mAABB);
     }
     //-----------------------------------------------------------------------
     void ParticleSystem::fastForward(Real time, Real interval)
@@ -994,9 +1281,30 @@ namespace Ogre {
         // Record visible
         if (isVisible())
         {           
-            mLastVisibleFrame = Root::getSingleton().getNextFrameNumber();
+            unsigned long frameNumber = Root::getSingleton().getNextFrameNumber();
+            mLastVisibleFrame = frameNumber;
             mTimeSinceLastVisible = 0.0f;
 
+            // Level of detail, the most detailed one and the closest camera win within a frame
+            if (mParentNode)
+            {
+                ushort lodIndex = 0;
+                if (!mLodValues.empty())
+                    lodIndex = mLodStrategy->getIndex(mLodStrategy->getValue(this, cam), mLodValues);
+                Real distance = mParentNode->getSquaredViewDepth(cam->getLodCamera());
+                if (mLodFrame != frameNumber)
+                {
+                    mLodIndex = lodIndex;
+                    mLodCameraDistance = distance;
+                }
+                else
+                {
+                    mLodIndex = std::min(mLodIndex, lodIndex);
+                    mLodCameraDistance = std::min(mLodCameraDistance, distance);
+                }
+                mLodFrame = frameNumber;
+            }
+
             if (mSorted)
             {
                 _sortParticles(cam);
@@ -1212,34 +1520,55 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     void ParticleSystem::_sortParticles(Camera* cam)
     {
-        static RadixSort<ParticlePool, Particle*, float> mRadixSorter;
         if (mRenderer)
         {
+            Vector3 camPos = cam->getDerivedPosition();
+            Vector3 camDir = cam->getDerivedDirection();
+            if (mLocalSpace)
+            {
+                // transform the camera into local space
+                camPos = mParentNode->convertWorldToLocalPosition(camPos);
+                camDir = mParentNode->convertWorldToLocalDirection(camDir, false);
+            }
+
+            unsigned long frame = Root::getSingleton().getNextFrameNumber();
+            if (mSortDone)
+            {
+                bool intervalPassed = mSortInterval > 0 && frame - mLastSortFrame >= mSortInterval;
+                bool cameraMoved =
+                    camPos.squaredDistance(mLastSortCamPos) > mSortDistanceThreshold * mSortDistanceThreshold ||
+                    camDir.angleBetween(mLastSortCamDir) > mSortAngleThreshold;
+                if (!intervalPassed && !cameraMoved)
+                    return;
+            }
+            mSortDone = true;
+            mLastSortFrame = frame;
+            mLastSortCamPos = camPos;
+            mLastSortCamDir = camDir;
+
             SortMode sortMode =
                 cam->getSortMode() == SortMode::Direction ? SortMode::Direction : mRenderer->_getSortMode();
 
+            mSorter.setWorkQueue(Root::getSingleton().getWorkQueue());
             if (sortMode == SortMode::Direction)
             {
-                Vector3 camDir = cam->getDerivedDirection();
-                if (mLocalSpace)
-                {
-                    // transform the camera direction into local space
-                    camDir = mParentNode->convertWorldToLocalDirection(camDir, false);
-                }
-                mRadixSorter.sort(mActiveParticles, SortByDirectionFunctor{- camDir});
+                mSorter.sort(mActiveParticles.begin(), mActiveParticles.end(), SortByDirectionFunctor{- camDir});
             }
             else if (sortMode == SortMode::Distance)
             {
-                Vector3 camPos = cam->getDerivedPosition();
-                if (mLocalSpace)
-                {
-                    // transform the camera position into local space
-                    camPos = mParentNode->convertWorldToLocalPosition(camPos);
-                }
-                mRadixSorter.sort(mActiveParticles, SortByDistanceFunctor{camPos});
+                mSorter.sort(mActiveParticles.begin(), mActiveParticles.end(), SortByDistanceFunctor{camPos});
             }
         }
     }
+    //-----------------------------------------------------------------------
+    void ParticleSystem::setSortInterval(unsigned int interval, Real distanceThreshold,
+                                         const Radian& angleThreshold)
+    {
+        mSortInterval = interval;
+        mSortDistanceThreshold = distanceThreshold;
+        mSortAngleThreshold = angleThreshold;
+        mSortDone = false;
+    }
     auto ParticleSystem::SortByDirectionFunctor::operator()(Particle* p) const -> float
     {
         return sortDir.dotProduct(p->mPosition);
@@ -1259,7 +1588,7 @@ namespace Ogre {
     {
         // Initialise the pool if needed
         size_t currSize = 0;
-        if (mEmittedEmitterPool.empty())
+        if (mEmittedEmitterPools.empty())
         {
             if (mEmittedEmitterPoolInitialised)
             {
@@ -1273,20 +1602,17 @@ namespace Ogre {
         }
         else
         {
-            for (auto const& [key, value] : mEmittedEmitterPool)
+            for (auto const& pool : mEmittedEmitterPools)
             {
-                currSize += value.size();
+                currSize += pool.emitters.size();
             }
         }
 
         size_t size = mEmittedEmitterPoolSize;
-        if( currSize < size && !mEmittedEmitterPool.empty())
+        if( currSize < size && !mEmittedEmitterPools.empty())
         {
-            // Increase the pool. Equally distribute over all vectors in the map
+            // Increase the pool. Equally distribute over all pools, the new emitters are free
             increaseEmittedEmitterPool(size);
-            
-            // Add new items to the free list
-            addFreeEmittedEmitters();
         }
     }
 
@@ -1296,24 +1622,31 @@ namespace Ogre {
         if (mEmittedEmitterPoolInitialised)
             return;
 
-        // Run through mEmitters and add keys to the pool
         for (ParticleEmitter* emitter : mEmitters)
-        {
-            // Determine the names of all emitters that are emitted
-            if (!emitter->getEmittedEmitter().empty())
-            {
-                // This one will be emitted, register its name and leave the vector empty!
-                mEmittedEmitterPool[emitter->getEmittedEmitter()];
-            }
-        }
+            emitter->_setEmittedEmitterPools(ParticleEmitter::NO_POOL, ParticleEmitter::NO_POOL);
 
-        // Determine whether the emitter itself will be emitted and set the 'mEmitted' attribute
+        // Run through mEmitters and create a pool for every emitter which is emitted, i.e. whose
+        // name is given as emitted emitter. The pools start empty.
         for (ParticleEmitter* emitter : mEmitters)
         {
-            if (mEmittedEmitterPool.find(emitter->getName()) != mEmittedEmitterPool.end())
+            std::string_view emittedName = emitter->getEmittedEmitter();
+            if (emittedName.empty())
+                continue;
+
+            size_t pool = findEmittedEmitterPool(emittedName);
+            if (pool == ParticleEmitter::NO_POOL)
             {
-                emitter->setEmitted(true);
+                auto source = std::ranges::find(mEmitters, emittedName, &ParticleEmitter::getName);
+                if (source == mEmitters.end())
+                    continue;
+
+                pool = mEmittedEmitterPools.size();
+                mEmittedEmitterPools.push_back({*source, {}, {}});
+
+                // The emitter itself will be emitted
+                (*source)->setEmitted(true);
             }
+            emitter->_setEmittedEmitterPools(pool, emitter->_getPool());
         }
 
         mEmittedEmitterPoolInitialised = true;
@@ -1322,122 +1655,88 @@ namespace Ogre {
     void ParticleSystem::increaseEmittedEmitterPool(size_t size)
     {
         // Don't proceed if the pool doesn't contain any keys of emitted emitters
-        if (mEmittedEmitterPool.empty())
-            return;
-
-        ParticleEmitter* clonedEmitter = nullptr;
-        size_t maxNumberOfEmitters = size / mEmittedEmitterPool.size(); // equally distribute the number for each emitted emitter list
-    
-        // Run through mEmittedEmitterPool and search for every key (=name) its corresponding emitter in mEmitters
-        for (auto& [name, e] : mEmittedEmitterPool)
-        {
-            // Search the correct emitter in the mEmitters vector
-            for (ParticleEmitter* emitter : mEmitters)
-            {
-                if (name == emitter->getName())
-                {
-                    // Found the right emitter, clone each emitter a number of times
-                    size_t oldSize = e.size();
-                    for (size_t t = oldSize; t < maxNumberOfEmitters; ++t)
-                    {
-                        clonedEmitter = ParticleSystemManager::getSingleton()._createEmitter(emitter->getType(), this);
-                        emitter->copyParametersTo(clonedEmitter);
-                        clonedEmitter->setEmitted(emitter->isEmitted()); // is always 'true' by the way, but just in case
-
-                        // Initially deactivate the emitted emitter if duration/repeat_delay are set
-                        if (clonedEmitter->getDuration() != 0.0f && clonedEmitter->getRepeatDelay() > 0.0f)
-                            clonedEmitter->setEnabled(false);
-
-                        // Add cloned emitters to the pool
-                        e.push_back(clonedEmitter);
-                    }
-                }
-            }
-        }
-    }
-    //-----------------------------------------------------------------------
-    void ParticleSystem::addFreeEmittedEmitters()
-    {
-        // Don't proceed if the EmittedEmitterPool is empty
-        if (mEmittedEmitterPool.empty())
+        if (mEmittedEmitterPools.empty())
             return;
 
-        // Copy all pooled emitters to the free list
-        std::list<ParticleEmitter*>* fee = nullptr;
+        size_t maxNumberOfEmitters = size / mEmittedEmitterPools.size(); // equally distribute the number for each emitted emitter list
 
-        // Run through the emittedEmitterPool map
-        for (auto const& [name, emittedEmitters] : mEmittedEmitterPool)
+        // Clone the source emitter of every pool a number of times
+        size_t totalSize = 0;
+        for (size_t i = 0; i < mEmittedEmitterPools.size(); ++i)
         {
-            fee = findFreeEmittedEmitter(name);
-
-            // If its not in the map, create an empty one
-            if (!fee)
+            EmittedEmitterPool& pool = mEmittedEmitterPools[i];
+            ParticleEmitter* emitter = pool.source;
+            pool.emitters.reserve(maxNumberOfEmitters);
+            pool.free.reserve(maxNumberOfEmitters);
+            for (size_t t = pool.emitters.size(); t < maxNumberOfEmitters; ++t)
             {
-                mFreeEmittedEmitters[name];
-                fee = findFreeEmittedEmitter(name);
-            }
-
-            // Check anyway if its ok now
-            if (!fee)
-                return; // forget it!
-
-            // Add all emitted emitters from the pool to the free list
-            for(ParticleEmitter* emitter : emittedEmitters)
-            {
-                fee->push_back(emitter);
+                ParticleEmitter* clonedEmitter = ParticleSystemManager::getSingleton()._createEmitter(emitter->getType(), this);
+                emitter->copyParametersTo(clonedEmitter);
+                clonedEmitter->setEmitted(emitter->isEmitted()); // is always 'true' by the way, but just in case
+                // Emits into the same pool as the source, and returns to this one
+                clonedEmitter->_setEmittedEmitterPools(emitter->_getEmittedEmitterPool(), i);
+
+                // Initially deactivate the emitted emitter if duration/repeat_delay are set
+                if (clonedEmitter->getDuration() != 0.0f && clonedEmitter->getRepeatDelay() > 0.0f)
+                    clonedEmitter->setEnabled(false);
+
+                // Add cloned emitters to the pool, free for use
+                pool.emitters.push_back(clonedEmitter);
+                pool.free.push_back(clonedEmitter);
             }
+            totalSize += pool.emitters.size();
         }
+
+        // None of the steady state lists needs to grow from here on
+        mActiveEmittedEmitters.reserve(totalSize);
     }
     //-----------------------------------------------------------------------
     void ParticleSystem::removeAllEmittedEmitters()
     {
-        for (auto& kv : mEmittedEmitterPool)
+        for (auto& pool : mEmittedEmitterPools)
         {
-            for (ParticleEmitter* emitter : kv.second)
+            for (ParticleEmitter* emitter : pool.emitters)
             {
                 ParticleSystemManager::getSingleton()._destroyEmitter(emitter);
             }
-            kv.second.clear();
         }
 
         // Don't leave any references behind
-        mEmittedEmitterPool.clear();
-        mFreeEmittedEmitters.clear();
+        mEmittedEmitterPools.clear();
         mActiveEmittedEmitters.clear();
     }
     //-----------------------------------------------------------------------
-    auto ParticleSystem::findFreeEmittedEmitter (std::string_view name) -> std::list<ParticleEmitter*>*
+    auto ParticleSystem::findEmittedEmitterPool(std::string_view name) const -> size_t
     {
-        auto it = mFreeEmittedEmitters.find (name);
-        if (it != mFreeEmittedEmitters.end())
+        for (size_t i = 0; i < mEmittedEmitterPools.size(); ++i)
         {
-            // Found it
-            return &it->second;
+            if (mEmittedEmitterPools[i].source->getName() == name)
+                return i;
         }
 
-        return nullptr;
+        return ParticleEmitter::NO_POOL;
     }
     //-----------------------------------------------------------------------
-    void ParticleSystem::removeFromActiveEmittedEmitters (ParticleEmitter* emitter)
+    void ParticleSystem::releaseEmittedEmitter(ParticleEmitter* emitter)
     {
         assert(emitter && "Emitter to be removed is 0!");
-        for (auto itActiveEmit = mActiveEmittedEmitters.begin(); itActiveEmit != mActiveEmittedEmitters.end(); ++itActiveEmit)
-        {
-            if (emitter == (*itActiveEmit))
-            {
-                mActiveEmittedEmitters.erase(itActiveEmit);
-                break;
-            }
-        }
+        size_t index = emitter->_getActiveIndex();
+        assert(index < mActiveEmittedEmitters.size() && mActiveEmittedEmitters[index] == emitter);
+
+        // Take the place of the removed one with the last one
+        ParticleEmitter* last = mActiveEmittedEmitters.back();
+        mActiveEmittedEmitters[index] = last;
+        last->_setActiveIndex(index);
+        mActiveEmittedEmitters.pop_back();
+
+        mEmittedEmitterPools[emitter->_getPool()].free.push_back(emitter);
     }
     //-----------------------------------------------------------------------
     void ParticleSystem::addActiveEmittedEmittersToFreeList ()
     {
-        for (auto & mActiveEmittedEmitter : mActiveEmittedEmitters)
+        for (auto activeEmitter : mActiveEmittedEmitters)
         {
-            std::list<ParticleEmitter*>* fee = findFreeEmittedEmitter (mActiveEmittedEmitter->getName());
-            if (fee)
-                fee->push_back(mActiveEmittedEmitter);
+            mEmittedEmitterPools[activeEmitter->_getPool()].free.push_back(activeEmitter);
         }
     }
     //-----------------------------------------------------------------------
@@ -1531,6 +1830,41 @@ namespace Ogre {
             StringConverter::parseBool(val));
     }
     //-----------------------------------------------------------------------
+    auto CmdSortInterval::doGet(const void* target) const -> String
+    {
+        return StringConverter::toString(
+            static_cast<const ParticleSystem*>(target)->getSortInterval());
+    }
+    void CmdSortInterval::doSet(void* target, std::string_view val)
+    {
+        auto system = static_cast<ParticleSystem*>(target);
+        system->setSortInterval(StringConverter::parseUnsignedInt(val),
+            system->getSortDistanceThreshold(), system->getSortAngleThreshold());
+    }
+    //-----------------------------------------------------------------------
+    auto CmdSortDistanceThreshold::doGet(const void* target) const -> String
+    {
+        return StringConverter::toString(
+            static_cast<const ParticleSystem*>(target)->getSortDistanceThreshold());
+    }
+    void CmdSortDistanceThreshold::doSet(void* target, std::string_view val)
+    {
+        auto system = static_cast<ParticleSystem*>(target);
+        system->setSortInterval(system->getSortInterval(),
+            StringConverter::parseReal(val), system->getSortAngleThreshold());
+    }
+    //-----------------------------------------------------------------------
+    auto CmdSortKeysQuantized::doGet(const void* target) const -> String
+    {
+        return StringConverter::toString(
+            static_cast<const ParticleSystem*>(target)->getSortKeysQuantized());
+    }
+    void CmdSortKeysQuantized::doSet(void* target, std::string_view val)
+    {
+        static_cast<ParticleSystem*>(target)->setSortKeysQuantized(
+            StringConverter::parseBool(val));
+    }
+    //-----------------------------------------------------------------------
     auto CmdLocalSpace::doGet(const void* target) const -> String
     {
         return StringConverter::toString(
@@ -1564,6 +1898,66 @@ namespace Ogre {
             StringConverter::parseReal(val));
     }
    //-----------------------------------------------------------------------
+    namespace
+    {
+        /// Rounds instead of truncating, so gather followed by scatter is lossless
+        auto packColourByte(float c) -> RGBA
+        {
+            return static_cast<RGBA>(Math::saturate(c) * 255.0f + 0.5f);
+        }
+    }
+    //-----------------------------------------------------------------------
+    void ParticleArrays::gather(const std::vector<Particle*>& particles)
+    {
+        count = particles.size();
+        for (auto array : {&positionX, &positionY, &positionZ, &directionX, &directionY, &directionZ,
+                           &colourR, &colourG, &colourB, &colourA, &width, &height,
+                           &timeToLive, &totalTimeToLive, &rotation, &rotationSpeed})
+            array->resize(count);
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            const Particle* p = particles[i];
+            positionX[i] = p->mPosition.x;
+            positionY[i] = p->mPosition.y;
+            positionZ[i] = p->mPosition.z;
+            directionX[i] = p->mDirection.x;
+            directionY[i] = p->mDirection.y;
+            directionZ[i] = p->mDirection.z;
+            // mColour is packed as ColourValue::getAsBYTE
+            RGBA colour = p->mColour;
+            colourR[i] = (colour & 0xFF) / 255.0f;
+            colourG[i] = ((colour >> 8) & 0xFF) / 255.0f;
+            colourB[i] = ((colour >> 16) & 0xFF) / 255.0f;
+            colourA[i] = (colour >> 24) / 255.0f;
+            width[i] = p->mWidth;
+            height[i] = p->mHeight;
+            timeToLive[i] = p->mTimeToLive;
+            totalTimeToLive[i] = p->mTotalTimeToLive;
+            rotation[i] = p->mRotation.valueRadians();
+            rotationSpeed[i] = p->mRotationSpeed.valueRadians();
+        }
+    }
+    //-----------------------------------------------------------------------
+    void ParticleArrays::scatter(const std::vector<Particle*>& particles) const
+    {
+        assert(particles.size() == count && "Particles changed since gather");
+        for (size_t i = 0; i < count; ++i)
+        {
+            Particle* p = particles[i];
+            p->mPosition = {positionX[i], positionY[i], positionZ[i]};
+            p->mDirection = {directionX[i], directionY[i], directionZ[i]};
+            p->mColour = packColourByte(colourR[i]) | packColourByte(colourG[i]) << 8 |
+                         packColourByte(colourB[i]) << 16 | packColourByte(colourA[i]) << 24;
+            p->mWidth = width[i];
+            p->mHeight = height[i];
+            p->mTimeToLive = timeToLive[i];
+            p->mTotalTimeToLive = totalTimeToLive[i];
+            p->mRotation = Radian{rotation[i]};
+            p->mRotationSpeed = Radian{rotationSpeed[i]};
+        }
+    }
+    //-----------------------------------------------------------------------
     ParticleAffector::~ParticleAffector() 
     = default;
     //-----------------------------------------------------------------------
@@ -36,6 +36,7 @@ import :BillboardParticleRenderer;
 import :Common;
 import :Exception;
 import :FactoryObj;
+import :GpuParticleRenderer;
 import :LogManager;
 import :ParticleAffector;
 import :ParticleAffectorFactory;
@@ -51,16 +52,20 @@ import :ScriptCompiler;
 import :Singleton;
 import :StringConverter;
 import :StringVector;
+import :WorkQueue;
 
+import <algorithm>;
 import <map>;
 import <string>;
 import <utility>;
+import <vector>;
 
 namespace Ogre {
 
     //-----------------------------------------------------------------------
     // Shortcut to set up billboard particle renderer
     BillboardParticleRendererFactory* mBillboardRendererFactory = nullptr;
+    GpuParticleRendererFactory* mGpuRendererFactory = nullptr;
     //-----------------------------------------------------------------------
     template<> ParticleSystemManager* Singleton<ParticleSystemManager>::msSingleton = nullptr;
     auto ParticleSystemManager::getSingletonPtr() noexcept -> ParticleSystemManager*
@@ -88,6 +93,11 @@ namespace Ogre {
             delete mBillboardRendererFactory;
             mBillboardRendererFactory = nullptr;
         }
+        if (mGpuRendererFactory)
+        {
+            delete mGpuRendererFactory;
+            mGpuRendererFactory = nullptr;
+        }
 
         if (mFactory)
         {
@@ -97,6 +107,84 @@ namespace Ogre {
 
     }
     //-----------------------------------------------------------------------
+    void ParticleSystemManager::_queueUpdate(ParticleSystem* system, Real timeElapsed)
+    {
+        mQueuedUpdates.emplace_back(system, timeElapsed);
+    }
+    //-----------------------------------------------------------------------
+    void ParticleSystemManager::_removeQueuedUpdates(ParticleSystem* system)
+    {
+        std::erase_if(mQueuedUpdates, [system](const auto& update) { return update.first == system; });
+        std::erase(mBudgetedSystems, system);
+    }
+    //-----------------------------------------------------------------------
+    void ParticleSystemManager::_addToBudget(ParticleSystem* system)
+    {
+        mBudgetedSystems.push_back(system);
+    }
+    //-----------------------------------------------------------------------
+    void ParticleSystemManager::applyParticleBudget()
+    {
+        // a system is updated once per frame, but may have been added by hand as well
+        std::ranges::sort(mBudgetedSystems);
+        mBudgetedSystems.erase(std::ranges::unique(mBudgetedSystems).begin(), mBudgetedSystems.end());
+
+        std::vector<std::pair<ParticleSystem*, Real>> order;
+        order.reserve(mBudgetedSystems.size());
+        for (auto system : mBudgetedSystems)
+            order.emplace_back(system, system->_getSquaredCameraDistance());
+        std::ranges::stable_sort(order, [](const auto& a, const auto& b)
+        {
+            if (a.first->getBudgetPriority() != b.first->getBudgetPriority())
+                return a.first->getBudgetPriority() > b.first->getBudgetPriority();
+            return a.second < b.second;
+        });
+
+        size_t remaining = mParticleBudget;
+        for (auto const& [system, distance] : order)
+        {
+            system->_setBudgetQuota(remaining);
+            remaining -= std::min(remaining, system->getNumParticles());
+        }
+        mBudgetedSystems.clear();
+    }
+    //-----------------------------------------------------------------------
+    void ParticleSystemManager::_updateQueuedSystems()
+    {
+        if (mQueuedUpdates.empty())
+        {
+            if (!mBudgetedSystems.empty())
+                applyParticleBudget();
+            return;
+        }
+
+        // Anything touching the scene graph or creating resources happens here,
+        // the updates themselves only change their own system
+        for (auto const& [system, timeElapsed] : mQueuedUpdates)
+            system->_beginConcurrentUpdate();
+
+        Root* root = Root::getSingletonPtr();
+        if (mQueuedUpdates.size() > 1 && root && root->getWorkQueue())
+        {
+            root->getWorkQueue()->parallelFor(mQueuedUpdates.size(), [this](size_t i)
+            {
+                mQueuedUpdates[i].first->_update(mQueuedUpdates[i].second);
+            });
+        }
+        else
+        {
+            for (auto const& [system, timeElapsed] : mQueuedUpdates)
+                system->_update(timeElapsed);
+        }
+
+        for (auto const& [system, timeElapsed] : mQueuedUpdates)
+            system->_endConcurrentUpdate();
+        mQueuedUpdates.clear();
+
+        if (!mBudgetedSystems.empty())
+            applyParticleBudget();
+    }
+    //-----------------------------------------------------------------------
     auto ParticleSystemManager::getScriptPatterns() const noexcept -> const StringVector&
     {
         return mScriptPatterns;
@@ -342,6 +430,8 @@ namespace Ogre {
         // Create Billboard renderer factory
         mBillboardRendererFactory = new BillboardParticleRendererFactory();
         addRendererFactory(mBillboardRendererFactory);
+        mGpuRendererFactory = new GpuParticleRendererFactory();
+        addRendererFactory(mGpuRendererFactory);
 
     }
     //-----------------------------------------------------------------------
@@ -38,6 +38,7 @@ import :Common;
 import :Config;
 import :Exception;
 import :GpuProgram;
+import :GpuProgramManager;
 import :GpuProgramParams;
 import :GpuProgramUsage;
 import :Light;
@@ -45,6 +46,9 @@ import :Material;
 import :Pass;
 import :Platform;
 import :Prerequisites;
+import :RenderSystem;
+import :Root;
+import :ShaderTelemetry;
 import :SharedPtr;
 import :String;
 import :Technique;
@@ -54,6 +58,7 @@ import :Vector;
 import <algorithm>;
 import <iterator>;
 import <memory>;
+import <mutex>;
 import <set>;
 import <string>;
 import <vector>;
@@ -107,8 +112,9 @@ namespace Ogre {
     //-----------------------------------------------------------------------------
     Pass::PassSet Pass::msDirtyHashList;
     Pass::PassSet Pass::msPassGraveyard;
+    std::mutex Pass::msPassListMutex;
 
-    Pass::HashFunc* Pass::msHashFunc = &sMinGpuProgramChangeHashFunc;
+    std::atomic<Pass::HashFunc*> Pass::msHashFunc = &sMinGpuProgramChangeHashFunc;
     //-----------------------------------------------------------------------------
     auto Pass::getBuiltinHashFunction(BuiltinHashFunction builtin) -> Pass::HashFunc*
     {
@@ -160,6 +166,7 @@ namespace Ogre {
         , mRunOnlyForOneLightType(false)
         , mNormaliseNormals(false)
         , mPolygonModeOverrideable(true)
+        , mAutoInstancing(false)
         , mFogOverride(false)
         , mQueuedForDeletion(false)
         , mLightScissoring(false)
@@ -200,10 +207,10 @@ namespace Ogre {
    }
 
     //-----------------------------------------------------------------------------
-    Pass::Pass(Technique *parent, unsigned short index, const Pass& oth)
+    Pass::Pass(Technique *parent, unsigned short index, const Pass& oth, bool shareParameters)
         : mParent(parent), mQueuedForDeletion(false), mIndex(index), mPassIterationCount(1)
     {
-        *this = oth;
+        _assign(oth, shareParameters);
         mParent = parent;
         mIndex = index;
         mQueuedForDeletion = false;
@@ -214,6 +221,11 @@ namespace Ogre {
     Pass::~Pass() = default; // ensure unique_ptr destructors are in cpp
     //-----------------------------------------------------------------------------
     auto Pass::operator=(const Pass& oth) -> Pass&
+    {
+        return _assign(oth, false);
+    }
+    //-----------------------------------------------------------------------------
+    auto Pass::_assign(const Pass& oth, bool shareParameters) -> Pass&
     {
         mName = oth.mName;
         mHash = oth.mHash;
@@ -259,6 +271,7 @@ namespace Ogre {
         mShadeOptions = oth.mShadeOptions;
         mPolygonMode = oth.mPolygonMode;
         mPolygonModeOverrideable = oth.mPolygonModeOverrideable;
+        mAutoInstancing = oth.mAutoInstancing;
         mPassIterationCount = oth.mPassIterationCount;
         mLineWidth = oth.mLineWidth;
         mPointAttenution = oth.mPointAttenution;
@@ -278,7 +291,7 @@ namespace Ogre {
             auto& programUsage = mProgramUsage[i];
             auto& othUsage = oth.mProgramUsage[i];
             if  (othUsage)
-                programUsage = std::make_unique<GpuProgramUsage>(*othUsage, this);
+                programUsage = std::make_unique<GpuProgramUsage>(*othUsage, this, shareParameters);
             else
                 programUsage.reset();
         }
@@ -325,11 +338,13 @@ namespace Ogre {
         mPointAttenution[1] = enabled ? constant : 1.0f;
         mPointAttenution[2] = enabled ? linear : 0.0f;
         mPointAttenution[3] = enabled ? quadratic : 0.0f;
+        mCompiledStateDirty = true;
     }
     //-----------------------------------------------------------------------
     void Pass::setPointMinSize(Real min)
     {
         mPointMinSize = min;
+        mCompiledStateDirty = true;
     }
     //-----------------------------------------------------------------------
     auto Pass::getPointMinSize() const -> Real
@@ -340,6 +355,7 @@ namespace Ogre {
     void Pass::setPointMaxSize(Real max)
     {
         mPointMaxSize = max;
+        mCompiledStateDirty = true;
     }
     //-----------------------------------------------------------------------
     auto Pass::getPointMaxSize() const -> Real
@@ -547,6 +563,7 @@ namespace Ogre {
         mBlendState.sourceFactorAlpha = sourceFactor;
         mBlendState.destFactor = destFactor;
         mBlendState.destFactorAlpha = destFactor;
+        mCompiledStateDirty = true;
     }
     //-----------------------------------------------------------------------
     void Pass::setSeparateSceneBlending( const SceneBlendFactor sourceFactor, const SceneBlendFactor destFactor, const SceneBlendFactor sourceFactorAlpha, const SceneBlendFactor destFactorAlpha )
@@ -555,18 +572,21 @@ namespace Ogre {
         mBlendState.destFactor = destFactor;
         mBlendState.sourceFactorAlpha = sourceFactorAlpha;
         mBlendState.destFactorAlpha = destFactorAlpha;
+        mCompiledStateDirty = true;
     }
     //-----------------------------------------------------------------------
     void Pass::setSceneBlendingOperation(SceneBlendOperation op)
     {
         mBlendState.operation = op;
         mBlendState.alphaOperation = op;
+        mCompiledStateDirty = true;
     }
     //-----------------------------------------------------------------------
     void Pass::setSeparateSceneBlendingOperation(SceneBlendOperation op, SceneBlendOperation alphaOp)
     {
         mBlendState.operation = op;
         mBlendState.alphaOperation = alphaOp;
+        mCompiledStateDirty = true;
     }
     //-----------------------------------------------------------------------
     auto Pass::isTransparent() const noexcept -> bool
@@ -591,6 +611,7 @@ namespace Ogre {
         mAlphaRejectFunc = func;
         mAlphaRejectVal = value;
         mAlphaToCoverageEnabled = alphaToCoverage;
+        mCompiledStateDirty = true;
     }
     //-----------------------------------------------------------------------
     void Pass::setColourWriteEnabled(bool enabled)
@@ -599,6 +620,7 @@ namespace Ogre {
         mBlendState.writeG = enabled;
         mBlendState.writeB = enabled;
         mBlendState.writeA = enabled;
+        mCompiledStateDirty = true;
     }
     //-----------------------------------------------------------------------
     auto Pass::getColourWriteEnabled() const noexcept -> bool
@@ -614,6 +636,7 @@ namespace Ogre {
         mBlendState.writeG = green;
         mBlendState.writeB = blue;
         mBlendState.writeA = alpha;
+        mCompiledStateDirty = true;
     }
     //-----------------------------------------------------------------------
     void Pass::getColourWriteEnabled(bool& red, bool& green, bool& blue, bool& alpha) const
@@ -659,6 +682,7 @@ namespace Ogre {
     {
        mDepthBiasConstant = constantBias;
        mDepthBiasSlopeScale = slopeScaleBias;
+        mCompiledStateDirty = true;
     }
     //-----------------------------------------------------------------------
     auto Pass::_split(unsigned short numUnits) -> Pass*
@@ -738,6 +762,7 @@ namespace Ogre {
     {
         // We assume the Technique only calls this when the material is being
         // loaded
+        ShaderTelemetry::PassScope telemetryPass{this};
 
         // Load each TextureUnitState
         for (auto & mTextureUnitState : mTextureUnitStates)
@@ -749,11 +774,19 @@ namespace Ogre {
         for (const auto& u : mProgramUsage)
             if(u) u->_load();
 
+        // start linking the program combination, so it is ready by the first draw
+        if (GpuProgramManager::getSingleton().getLinkProgramsOnLoad() && isProgrammable())
+        {
+            if (RenderSystem* rs = Root::getSingleton().getRenderSystem())
+                rs->_prelinkGpuPrograms(this);
+        }
+
         if (mHashDirtyQueued)
         {
             _dirtyHash();
         }
 
+        _compileState();
     }
     //-----------------------------------------------------------------------
     void Pass::_unload()
@@ -885,8 +918,15 @@ namespace Ogre {
         }
         return programUsage->getParameters();
     }
+    //-----------------------------------------------------------------------
+    auto Pass::_getGpuProgramParameters(GpuProgramType type) const -> const GpuProgramParametersSharedPtr&
+    {
+        const auto& programUsage = getProgramUsage(type);
+        OgreAssert(programUsage, "This pass does not have this program type assigned!");
+        return programUsage->_getParameters();
+    }
 
-    auto Pass::getVertexProgramParameters() const -> GpuProgramParametersSharedPtr
+    auto Pass::getVertexProgramParameters() const -> const GpuProgramParametersSharedPtr&
     {
         return getGpuProgramParameters(GpuProgramType::VERTEX_PROGRAM);
     }
@@ -918,27 +958,27 @@ namespace Ogre {
             return programUsage->getProgramName();
     }
     //-----------------------------------------------------------------------
-    auto Pass::getFragmentProgramParameters() const -> GpuProgramParametersSharedPtr
+    auto Pass::getFragmentProgramParameters() const -> const GpuProgramParametersSharedPtr&
     {
         return getGpuProgramParameters(GpuProgramType::FRAGMENT_PROGRAM);
     }
     //-----------------------------------------------------------------------
-    auto Pass::getGeometryProgramParameters() const -> GpuProgramParametersSharedPtr
+    auto Pass::getGeometryProgramParameters() const -> const GpuProgramParametersSharedPtr&
     {
         return getGpuProgramParameters(GpuProgramType::GEOMETRY_PROGRAM);
     }
     //-----------------------------------------------------------------------
-    auto Pass::getTessellationHullProgramParameters() const -> GpuProgramParametersSharedPtr
+    auto Pass::getTessellationHullProgramParameters() const -> const GpuProgramParametersSharedPtr&
     {
         return getGpuProgramParameters(GpuProgramType::HULL_PROGRAM);
     }
     //-----------------------------------------------------------------------
-    auto Pass::getTessellationDomainProgramParameters() const -> GpuProgramParametersSharedPtr
+    auto Pass::getTessellationDomainProgramParameters() const -> const GpuProgramParametersSharedPtr&
     {
         return getGpuProgramParameters(GpuProgramType::DOMAIN_PROGRAM);
     }
     //-----------------------------------------------------------------------
-    auto Pass::getComputeProgramParameters() const -> GpuProgramParametersSharedPtr
+    auto Pass::getComputeProgramParameters() const -> const GpuProgramParametersSharedPtr&
     {
         return getGpuProgramParameters(GpuProgramType::COMPUTE_PROGRAM);
     }
@@ -955,7 +995,7 @@ namespace Ogre {
             4     Pass index (i.e. max 16 passes!)
            28     Pass contents
        */
-        mHash = (*msHashFunc)(this);
+        mHash = (*getHashFunction())(this);
 
         // overwrite the 4 upper bits with pass index
         mHash = (uint32(mIndex) << 28) | (mHash >> 4);
@@ -963,6 +1003,8 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     void Pass::_dirtyHash()
     {
+        mCompiledStateDirty = true;
+
         if (mQueuedForDeletion)
             return;
 
@@ -970,6 +1012,7 @@ namespace Ogre {
         if (mat->isLoading() || mat->isLoaded())
         {
             // Mark this hash as for follow up
+            std::scoped_lock lock{msPassListMutex};
             msDirtyHashList.insert(this);
             mHashDirtyQueued = false;
         }
@@ -978,9 +1021,33 @@ namespace Ogre {
             mHashDirtyQueued = true;
         }
     }
+    //-----------------------------------------------------------------------
+    void Pass::_compileState() const
+    {
+        mCompiledState.blendState = mBlendState;
+        mCompiledState.lineWidth = mLineWidth;
+        mCompiledState.pointMinSize = mPointMinSize;
+        mCompiledState.pointMaxSize = mPointMaxSize;
+        mCompiledState.pointAttenuation = mPointAttenuationEnabled;
+        mCompiledState.pointSprites = mPointSpritesEnabled;
+        mCompiledState.lighting = mLightingEnabled;
+        mCompiledState.depthCheck = mDepthCheck;
+        mCompiledState.depthWrite = mDepthWrite;
+        mCompiledState.alphaToCoverage = mAlphaToCoverageEnabled;
+        mCompiledState.depthFunction = mDepthFunc;
+        mCompiledState.alphaRejectFunction = mAlphaRejectFunc;
+        mCompiledState.alphaRejectValue = mAlphaRejectVal;
+        mCompiledState.depthBiasConstant = mDepthBiasConstant;
+        mCompiledState.depthBiasSlopeScale = mDepthBiasSlopeScale;
+        mCompiledState.cullingMode = mCullMode;
+        mCompiledState.shading = mShadeOptions;
+        mCompiledState.numTextureUnits = mTextureUnitStates.size();
+        mCompiledStateDirty = false;
+    }
     //---------------------------------------------------------------------
     void Pass::clearDirtyHashList() 
     { 
+        std::scoped_lock lock{msPassListMutex};
         msDirtyHashList.clear(); 
     }
     //-----------------------------------------------------------------------
@@ -1014,25 +1081,27 @@ namespace Ogre {
             if (programUsage)
             {
                 // Update program auto params
-                programUsage->getParameters()->_updateAutoParams(source, mask);
+                programUsage->_getParameters()->_updateAutoParams(source, mask);
             }
         }
     }
     //-----------------------------------------------------------------------
     void Pass::processPendingPassUpdates()
     {
+        PassSet graveyard;
+        PassSet tempDirtyHashList;
+        {
+            std::scoped_lock lock{msPassListMutex};
+            graveyard.swap(msPassGraveyard);
+            // The dirty ones will have been removed from the groups above using the old hash now
+            tempDirtyHashList.swap(msDirtyHashList);
+        }
 
         // Delete items in the graveyard
-        for (auto i : msPassGraveyard)
+        for (auto i : graveyard)
         {
             delete i;
         }
-        msPassGraveyard.clear();
-
-        PassSet tempDirtyHashList;
-
-        // The dirty ones will have been removed from the groups above using the old hash now
-        tempDirtyHashList.swap(msDirtyHashList);
 
         for (auto p : tempDirtyHashList)
         {
@@ -1049,6 +1118,7 @@ namespace Ogre {
             u.reset();
 
         // remove from dirty list, if there
+        std::scoped_lock lock{msPassListMutex};
         msDirtyHashList.erase(this);
 
         msPassGraveyard.insert(this);
@@ -36,6 +36,7 @@ import :AlignedAllocator;
 import :Bitwise;
 import :Exception;
 import :Math;
+import :OptimisedUtil;
 import :PixelConversions;
 import :PixelFormat;
 import :PixelFormatDescriptions;
@@ -43,8 +44,10 @@ import :String;
 import :Vector;
 
 import <algorithm>;
+import <bit>;
 import <format>;
 import <string>;
+import <vector>;
 
 namespace {
 }
@@ -159,9 +162,11 @@ namespace Ogre {
                 // https://www.khronos.org/registry/OpenGL/extensions/OES/OES_compressed_ETC1_RGB8_texture.txt
                 case ETC1_RGB8:
                 case ETC2_RGB8:
-                case ETC2_RGBA8:
                 case ETC2_RGB8A1:
                     return ((width + 3) / 4) * ((height + 3) / 4) * 8;
+                // the EAC alpha block comes first
+                case ETC2_RGBA8:
+                    return ((width + 3) / 4) * ((height + 3) / 4) * 16;
 
                 case ATC_RGB:
                     return ((width + 3) / 4) * ((height + 3) / 4) * 8;
@@ -687,6 +692,203 @@ namespace Ogre {
         }
     }
     //-----------------------------------------------------------------------
+    namespace {
+    /** Where the R, G, B and A channels of a format are, in bytes for 8 bit unsigned
+        normalised formats and in elements for float formats.
+    @remarks
+        Channels derived from another one when unpacking, like G and B of luminance
+        formats, refer to it in a source layout and are absent in a destination layout.
+    */
+    struct ChannelLayout
+    {
+        static constexpr uint8 NONE = 0xFF;
+
+        uint8 offset[4]{NONE, NONE, NONE, NONE};
+        /// Bytes or elements per pixel
+        uint8 count{0};
+        /// For float formats, whether the elements are half floats
+        bool half{false};
+    };
+    //-----------------------------------------------------------------------
+    auto getUnormLayout(PixelFormat pf, bool isSource, ChannelLayout& layout) -> bool
+    {
+        using enum PixelFormatFlags;
+        const PixelFormatDescription &des = getDescriptionFor(pf);
+        const bool isLuminance = (des.flags & LUMINANCE) != PixelFormatFlags{};
+
+        if (pf == PixelFormat::BYTE_LA)
+        {
+            // not native endian, but unpacked byte by byte
+            layout.offset[0] = 0;
+            layout.offset[3] = 1;
+        }
+        else
+        {
+            if ((des.flags & NATIVEENDIAN) == PixelFormatFlags{} ||
+                (des.flags & (INTEGER | FLOAT | DEPTH | COMPRESSED)) != PixelFormatFlags{} ||
+                des.elemBytes > 4)
+                return false;
+
+            const unsigned char bits[4] = {des.rbits, des.gbits, des.bbits, des.abits};
+            const unsigned char shifts[4] = {des.rshift, des.gshift, des.bshift, des.ashift};
+            for (int k = 0; k < 4; ++k)
+            {
+                if (isLuminance && (k == 1 || k == 2))
+                    continue;
+                if (bits[k] == 0)
+                {
+                    // unpacking a missing colour channel does not give 0
+                    if (isSource && k < 3)
+                        return false;
+                    continue;
+                }
+                if (bits[k] != 8 || shifts[k] % 8 != 0)
+                    return false;
+
+                // 24 bit values are always read and written little endian, see Bitwise::intRead
+                uint8 byte = shifts[k] / 8;
+                if (std::endian::native == std::endian::big && des.elemBytes != 3)
+                    byte = des.elemBytes - 1 - byte;
+                layout.offset[k] = byte;
+            }
+        }
+
+        if (isLuminance && isSource)
+            layout.offset[1] = layout.offset[2] = layout.offset[0];
+        layout.count = des.elemBytes;
+        return true;
+    }
+    //-----------------------------------------------------------------------
+    auto getFloatLayout(PixelFormat pf, bool isSource, ChannelLayout& layout) -> bool
+    {
+        using enum PixelFormat;
+        const uint8 derived = isSource ? 0 : ChannelLayout::NONE;
+        switch (pf)
+        {
+        case FLOAT16_R:
+        case FLOAT32_R:
+            layout = {{0, derived, derived, ChannelLayout::NONE}, 1};
+            break;
+        case FLOAT16_GR:
+        case FLOAT32_GR:
+            layout = {{1, 0, uint8(isSource ? 1 : ChannelLayout::NONE), ChannelLayout::NONE}, 2};
+            break;
+        case FLOAT16_RGB:
+        case FLOAT32_RGB:
+            layout = {{0, 1, 2, ChannelLayout::NONE}, 3};
+            break;
+        case FLOAT16_RGBA:
+        case FLOAT32_RGBA:
+            layout = {{0, 1, 2, 3}, 4};
+            break;
+        default:
+            return false;
+        }
+        layout.half = pf == FLOAT16_R || pf == FLOAT16_GR || pf == FLOAT16_RGB || pf == FLOAT16_RGBA;
+        return true;
+    }
+    //-----------------------------------------------------------------------
+    /// Builds the OptimisedUtil::shuffleChannels table moving the channels of src to dst
+    void buildShuffle(const ChannelLayout& src, const ChannelLayout& dst, uint8* shuffle)
+    {
+        for (uint8 c = 0; c < dst.count; ++c)
+            shuffle[c] = OptimisedUtil::SHUFFLE_ZERO;
+
+        for (int k = 0; k < 4; ++k)
+        {
+            if (dst.offset[k] == ChannelLayout::NONE)
+                continue;
+            if (src.offset[k] != ChannelLayout::NONE)
+                shuffle[dst.offset[k]] = src.offset[k];
+            else if (k == 3)
+                shuffle[dst.offset[k]] = OptimisedUtil::SHUFFLE_ONE;
+        }
+    }
+    //-----------------------------------------------------------------------
+    /** Converts between 8 bit unsigned normalised formats, from and to floats and between
+        half floats and floats with the vectorised routines of OptimisedUtil.
+    @return
+        Whether the formats are supported, the results match unpackColour/packColour.
+    */
+    auto doSIMDConversion(const PixelBox &src, const PixelBox &dst) -> bool
+    {
+        ChannelLayout srcLayout, dstLayout;
+        const bool srcUnorm = getUnormLayout(src.format, true, srcLayout);
+        const bool dstUnorm = getUnormLayout(dst.format, false, dstLayout);
+        if ((!srcUnorm && !getFloatLayout(src.format, true, srcLayout)) ||
+            (!dstUnorm && !getFloatLayout(dst.format, false, dstLayout)))
+            return false;
+
+        enum class Conversion { SHUFFLE, UNORM_TO_FLOAT, FLOAT_TO_UNORM, HALF_TO_FLOAT, FLOAT_TO_HALF };
+        Conversion conversion;
+        if (srcUnorm && dstUnorm)
+            conversion = Conversion::SHUFFLE;
+        else if (srcUnorm)
+        {
+            if (dstLayout.half)
+                return false;
+            conversion = Conversion::UNORM_TO_FLOAT;
+        }
+        else if (dstUnorm)
+        {
+            if (srcLayout.half)
+                return false;
+            conversion = Conversion::FLOAT_TO_UNORM;
+        }
+        else
+        {
+            // the channels of the float formats only depend on their count
+            if (srcLayout.half == dstLayout.half || srcLayout.count != dstLayout.count)
+                return false;
+            conversion = srcLayout.half ? Conversion::HALF_TO_FLOAT : Conversion::FLOAT_TO_HALF;
+        }
+
+        uint8 shuffle[4];
+        buildShuffle(srcLayout, dstLayout, shuffle);
+
+        OptimisedUtil* util = OptimisedUtil::getImplementation();
+        const size_t srcPixelSize = PixelUtil::getNumElemBytes(src.format);
+        const size_t dstPixelSize = PixelUtil::getNumElemBytes(dst.format);
+        const size_t width = src.getWidth();
+        std::vector<uint8> temp;
+        if (conversion == Conversion::UNORM_TO_FLOAT || conversion == Conversion::FLOAT_TO_UNORM)
+            temp.resize(width * 4);
+
+        for (size_t z = 0; z < src.getDepth(); ++z)
+        {
+            for (size_t y = 0; y < src.getHeight(); ++y)
+            {
+                const uint8* srcptr = src.getTopLeftFrontPixelPtr() +
+                    (y * src.rowPitch + z * src.slicePitch) * srcPixelSize;
+                uint8* dstptr = dst.getTopLeftFrontPixelPtr() +
+                    (y * dst.rowPitch + z * dst.slicePitch) * dstPixelSize;
+
+                switch (conversion)
+                {
+                case Conversion::SHUFFLE:
+                    util->shuffleChannels(srcptr, srcPixelSize, dstptr, dstPixelSize, shuffle, width);
+                    break;
+                case Conversion::UNORM_TO_FLOAT:
+                    util->shuffleChannels(srcptr, srcPixelSize, temp.data(), dstLayout.count, shuffle, width);
+                    util->convertUnormToFloat(temp.data(), (float*)dstptr, width * dstLayout.count);
+                    break;
+                case Conversion::FLOAT_TO_UNORM:
+                    util->convertFloatToUnorm((const float*)srcptr, temp.data(), width * srcLayout.count);
+                    util->shuffleChannels(temp.data(), srcLayout.count, dstptr, dstPixelSize, shuffle, width);
+                    break;
+                case Conversion::HALF_TO_FLOAT:
+                    util->convertHalfToFloat((const uint16*)srcptr, (float*)dstptr, width * srcLayout.count);
+                    break;
+                case Conversion::FLOAT_TO_HALF:
+                    util->convertFloatToHalf((const float*)srcptr, (uint16*)dstptr, width * srcLayout.count);
+                    break;
+                }
+            }
+        }
+        return true;
+    }
+    }
+    //-----------------------------------------------------------------------
     /* Convert pixels from one format to another */
     void PixelUtil::bulkPixelConversion(const PixelBox &src, const PixelBox &dst)
     {
@@ -775,6 +977,10 @@ namespace Ogre {
             return;
         }
 
+        // Can it be done with the vectorised routines?
+        if(doSIMDConversion(src, dst))
+            return;
+
         // Is there a specialized, inlined, conversion?
         if(doOptimizedConversion(src, dst))
         {
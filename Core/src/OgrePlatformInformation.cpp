@@ -64,17 +64,25 @@ namespace Ogre {
     // Detect whether CPU supports CPUID instruction, returns non-zero if supported.
     static auto _isSupportCpuid() -> int
     {
+#if defined(__i386__) || defined(__x86_64__)
         return true;
+#else
+        return false;
+#endif
     }
 
     //---------------------------------------------------------------------
-    // Performs CPUID instruction with 'query', fill the results, and return value of eax.
-    static auto _performCpuid(int query, CpuidResult& result) -> uint
+    // Performs CPUID instruction with 'query' and 'subQuery', fill the results, and return value of eax.
+    static auto _performCpuid(int query, CpuidResult& result, int subQuery = 0) -> uint
     {
+#if defined(__i386__) || defined(__x86_64__)
         __asm__
         (
-            "cpuid": "=a" (result._eax), "=b" (result._ebx), "=c" (result._ecx), "=d" (result._edx) : "a" (query)
+            "cpuid": "=a" (result._eax), "=b" (result._ebx), "=c" (result._ecx), "=d" (result._edx) : "a" (query), "c" (subQuery)
         );
+#else
+        result = {};
+#endif
         return result._eax;
     }
 
@@ -86,6 +94,23 @@ namespace Ogre {
         return true;
     }
 
+    //---------------------------------------------------------------------
+    // Detect whether or not os saves the given register states on context switches,
+    // only valid once OSXSAVE is reported by CPUID.
+    static auto _checkOperatingSystemSupportXSave(uint stateMask) -> bool
+    {
+#if defined(__i386__) || defined(__x86_64__)
+        uint eax, edx;
+        __asm__
+        (
+            "xgetbv": "=a" (eax), "=d" (edx) : "c" (0)
+        );
+        return (eax & stateMask) == stateMask;
+#else
+        return false;
+#endif
+    }
+
     //---------------------------------------------------------------------
     // Compiler-independent routines
     //---------------------------------------------------------------------
@@ -95,6 +120,7 @@ namespace Ogre {
 
 #define CPUID_FUNC_VENDOR_ID                 0x0
 #define CPUID_FUNC_STANDARD_FEATURES         0x1
+#define CPUID_FUNC_STRUCTURED_FEATURES       0x7
 #define CPUID_FUNC_EXTENSION_QUERY           0x80000000
 #define CPUID_FUNC_EXTENDED_FEATURES         0x80000001
 #define CPUID_FUNC_ADVANCED_POWER_MANAGEMENT 0x80000007
@@ -110,6 +136,12 @@ namespace Ogre {
 #define CPUID_STD_SSE3              (1<<0)      // ECX[0]  - Bit 0 of standard function 1 indicate SSE3 supported
 #define CPUID_STD_SSE41             (1<<19)     // ECX[19] - Bit 0 of standard function 1 indicate SSE41 supported
 #define CPUID_STD_SSE42             (1<<20)     // ECX[20] - Bit 0 of standard function 1 indicate SSE42 supported
+#define CPUID_STD_FMA               (1<<12)     // ECX[12] - Bit 12 of standard function 1 indicate FMA3 supported
+#define CPUID_STD_OSXSAVE           (1<<27)     // ECX[27] - Bit 27 of standard function 1 indicate XGETBV enabled by the os
+#define CPUID_STD_AVX               (1<<28)     // ECX[28] - Bit 28 of standard function 1 indicate AVX supported
+
+#define CPUID_STRUCT_AVX2           (1<<5)      // EBX[5]  - Bit 5 of structured function 7 indicate AVX2 supported
+#define CPUID_STRUCT_AVX512F        (1<<16)     // EBX[16] - Bit 16 of structured function 7 indicate AVX-512 Foundation supported
 
 #define CPUID_FAMILY_ID_MASK        0x0F00      // EAX[11:8] - Bit 11 thru 8 contains family  processor id
 #define CPUID_EXT_FAMILY_ID_MASK    0x0F00000   // EAX[23:20] - Bit 23 thru 20 contains extended family processor id
@@ -226,9 +258,34 @@ namespace Ogre {
                             features |= PlatformInformation::CpuFeatures::INVARIANT_TSC;
                     }
                 }
+
+                // The AVX family uses the same bits for all vendors
+                const uint maxStandardFunctionSupport = _performCpuid(CPUID_FUNC_VENDOR_ID, result);
+                _performCpuid(CPUID_FUNC_STANDARD_FEATURES, result);
+                if ((result._ecx & CPUID_STD_OSXSAVE) && (result._ecx & CPUID_STD_AVX))
+                {
+                    features |= PlatformInformation::CpuFeatures::AVX;
+                    if (result._ecx & CPUID_STD_FMA)
+                        features |= PlatformInformation::CpuFeatures::FMA;
+
+                    if (maxStandardFunctionSupport >= CPUID_FUNC_STRUCTURED_FEATURES)
+                    {
+                        _performCpuid(CPUID_FUNC_STRUCTURED_FEATURES, result, 0);
+
+                        if (result._ebx & CPUID_STRUCT_AVX2)
+                            features |= PlatformInformation::CpuFeatures::AVX2;
+                        if (result._ebx & CPUID_STRUCT_AVX512F)
+                            features |= PlatformInformation::CpuFeatures::AVX512F;
+                    }
+                }
             }
         }
 
+#if defined(__ARM_NEON)
+        // Advanced SIMD is part of the base architecture wherever the compiler enables it
+        features |= PlatformInformation::CpuFeatures::NEON;
+#endif
+
         return features;
     }
     //---------------------------------------------------------------------
@@ -248,6 +305,23 @@ namespace Ogre {
             features &= ~sse_features;
         }
 
+        // The os must save the SSE and AVX registers (XCR0 bits 1 and 2), and for
+        // AVX-512 also the opmask and upper ZMM registers (XCR0 bits 5 to 7)
+        const auto avx_features =
+                PlatformInformation::CpuFeatures::AVX
+            | PlatformInformation::CpuFeatures::AVX2
+            | PlatformInformation::CpuFeatures::FMA
+            | PlatformInformation::CpuFeatures::AVX512F;
+
+        if (((features & avx_features) != PlatformInformation::CpuFeatures{}) && !_checkOperatingSystemSupportXSave(0x06))
+        {
+            features &= ~avx_features;
+        }
+        else if (((features & PlatformInformation::CpuFeatures::AVX512F) != PlatformInformation::CpuFeatures{}) && !_checkOperatingSystemSupportXSave(0xE6))
+        {
+            features &= ~PlatformInformation::CpuFeatures::AVX512F;
+        }
+
         return features;
     }
     //---------------------------------------------------------------------
@@ -320,7 +394,13 @@ namespace Ogre {
             }
         }
 
+#if defined(__aarch64__)
+        return "AArch64";
+#elif defined(__arm__)
+        return "ARM";
+#else
         return "X86";
+#endif
     }
 
     //---------------------------------------------------------------------
@@ -383,6 +463,19 @@ namespace Ogre {
                 ::std::format(" *          PRO: {}", hasCpuFeature(CpuFeatures::PRO)));
             pLog->logMessage(
                 ::std::format(" *           HT: {}", hasCpuFeature(CpuFeatures::HTT)));
+            pLog->logMessage(
+                ::std::format(" *          AVX: {}", hasCpuFeature(CpuFeatures::AVX)));
+            pLog->logMessage(
+                ::std::format(" *         AVX2: {}", hasCpuFeature(CpuFeatures::AVX2)));
+            pLog->logMessage(
+                ::std::format(" *          FMA: {}", hasCpuFeature(CpuFeatures::FMA)));
+            pLog->logMessage(
+                ::std::format(" *      AVX512F: {}", hasCpuFeature(CpuFeatures::AVX512F)));
+        }
+        else
+        {
+            pLog->logMessage(
+                ::std::format(" *         NEON: {}", hasCpuFeature(CpuFeatures::NEON)));
         }
 
         pLog->logMessage("-------------------------");
@@ -52,17 +52,75 @@ import :Profiler;
 import :RenderSystem;
 import :Root;
 import :Singleton;
+import :String;
 import :StringConverter;
 import :Timer;
 
 import <algorithm>;
+import <atomic>;
+import <chrono>;
+import <format>;
 import <map>;
+import <memory>;
+import <mutex>;
+import <ostream>;
 import <set>;
 import <string>;
+import <thread>;
 import <utility>;
 import <vector>;
 
 namespace Ogre {
+    namespace {
+        void resetFrame(ProfileInstance& instance)
+        {
+            instance.frame.frameClocks = 0;
+            instance.frame.calls = 0;
+            for (auto const& [key, child] : instance.children)
+                resetFrame(*child);
+        }
+
+        auto traceClock() -> uint64
+        {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+        std::atomic<uint64> gProfilerGeneration{0};
+    }
+
+    /// Written by its thread only, read by Profiler::_collectTrace
+    struct Profiler::ThreadTrace
+    {
+        static size_t constexpr CAPACITY = 1 << 14;
+
+        struct Event
+        {
+            std::string_view name;
+            uint64 time;
+            bool begin;
+        };
+
+        void push(std::string_view name, bool begin)
+        {
+            size_t next = head.load(std::memory_order_relaxed);
+            events[next & (CAPACITY - 1)] = {name, traceClock(), begin};
+            head.store(next + 1, std::memory_order_release);
+        }
+
+        std::unique_ptr<Event[]> events{std::make_unique<Event[]>(CAPACITY)};
+        std::atomic<size_t> head{0};
+        std::atomic<size_t> tail{0};
+        std::atomic<size_t> dropped{0};
+        /// Recorded beginnings not yet ended, room is kept for their ends
+        size_t open{0};
+        uint32 index;
+
+        /// The collected beginnings waiting for their ends
+        std::vector<Event> stack;
+    };
+    thread_local Profiler::ThreadTrace* Profiler::msThreadTrace = nullptr;
+    thread_local uint64 Profiler::msThreadTraceGeneration = 0;
     //-----------------------------------------------------------------------
     // PROFILE DEFINITIONS
     //-----------------------------------------------------------------------
@@ -83,9 +141,12 @@ namespace Ogre {
         : mCurrent(&mRoot)
         , 
          mRoot()
-         
+        , mThread(std::this_thread::get_id())
+        , mTraceGeneration(++gProfilerGeneration)
     {
         mRoot.hierarchicalLvl = 0 - 1;
+        // the thread of the hierarchy comes first in traces
+        threadTrace();
     }
     //-----------------------------------------------------------------------
     ProfileInstance::ProfileInstance()
@@ -163,6 +224,19 @@ namespace Ogre {
             mListener->changeEnableState(mNewEnableState);
 
         mEnabled = mNewEnableState;
+        updateGPUTiming();
+    }
+    //-----------------------------------------------------------------------
+    void Profiler::setGPUTiming(bool enabled)
+    {
+        mGPUTiming = enabled;
+        updateGPUTiming();
+    }
+    //-----------------------------------------------------------------------
+    void Profiler::updateGPUTiming()
+    {
+        if (auto root = Root::getSingletonPtr(); root && root->getRenderSystem())
+            root->getRenderSystem()->setProfileEventTiming(mEnabled && mGPUTiming);
     }
     //-----------------------------------------------------------------------
     void Profiler::disableProfile(std::string_view profileName)
@@ -178,6 +252,10 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     void Profiler::beginProfile(std::string_view profileName, ProfileGroupMask groupID)
     {
+        // the hierarchy is built for one thread
+        if (std::this_thread::get_id() != mThread)
+            return;
+
         // if the profiler is enabled
         if (!mEnabled)
             return;
@@ -237,6 +315,9 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     void Profiler::endProfile(std::string_view profileName, ProfileGroupMask groupID)
     {
+        if (std::this_thread::get_id() != mThread)
+            return;
+
         if(!mEnabled) 
         {
             // if the profiler received a request to be enabled or disabled
@@ -324,6 +405,8 @@ namespace Ogre {
             if(clocksElapsed > mMaxTotalFrameClocks)
                 mMaxTotalFrameClocks = clocksElapsed;
 
+            processGPUTimings();
+
             // we got all the information we need, so process the profiles
             // for this frame
             processFrameStats();
@@ -349,6 +432,67 @@ namespace Ogre {
         Root::getSingleton().getRenderSystem()->markProfileEvent(event);
     }
     //-----------------------------------------------------------------------
+    void Profiler::processGPUTimings()
+    {
+        mGPUFrameTime = 0;
+        auto root = Root::getSingletonPtr();
+        if (!mGPUTiming || !root || !root->getRenderSystem())
+            return;
+
+        // the render system may have been set after GPU timing was enabled
+        RenderSystem* rs = root->getRenderSystem();
+        rs->setProfileEventTiming(true);
+
+        RenderSystem::ProfileEventTimings timings;
+        rs->_getProfileEventTimings(timings);
+
+        auto& gpu = mRoot.children["GPU"];
+        if (!gpu)
+        {
+            gpu = ::std::make_unique<ProfileInstance>();
+            gpu->name = "GPU";
+            gpu->parent = &mRoot;
+            gpu->hierarchicalLvl = 0;
+        }
+
+        // only the timings which became available this frame count
+        resetFrame(*gpu);
+        gpu->frameNumber = mCurrentFrame;
+        gpu->frame.calls = timings.empty() ? 0 : 1;
+
+        // the events are ordered by their beginning, so parents come before their children
+        std::vector<ProfileInstance*> stack{gpu.get()};
+        for (const auto& timing : timings)
+        {
+            stack.resize(std::min<size_t>(stack.size(), timing.depth + 1));
+            ProfileInstance* parent = stack.back();
+
+            auto i = parent->children.find(timing.name);
+            if (i == parent->children.end())
+            {
+                auto instance = ::std::make_unique<ProfileInstance>();
+                instance->name = timing.name;
+                instance->parent = parent;
+                instance->hierarchicalLvl = parent->hierarchicalLvl + 1;
+                std::string_view key = instance->name;
+                i = parent->children.emplace(key, std::move(instance)).first;
+            }
+
+            ProfileInstance* instance = i->second.get();
+            auto clocks = static_cast<ulong>(Timer::microsecondsToClocks(timing.nanoseconds / 1000.0l));
+            instance->frame.frameClocks += clocks;
+            ++instance->frame.calls;
+            instance->frameNumber = mCurrentFrame;
+            if (parent == gpu.get())
+            {
+                gpu->frame.frameClocks += clocks;
+                mGPUFrameTime += Real(timing.nanoseconds / 1e6);
+            }
+
+            stack.push_back(instance);
+        }
+    }
+    //-----------------------------------------------------------------------
     void Profiler::processFrameStats(ProfileInstance* instance, ulong& maxFrameClocks)
     {
         // calculate what percentage of frame time this profile took
@@ -445,7 +589,10 @@ namespace Ogre {
             mRoot.frame.calls = 1;
 
             for(auto & mListener : mListeners)
+            {
                 mListener->displayResults(mRoot, mMaxTotalFrameClocks);
+                mListener->displayCounters(mCounters);
+            }
         }
         ++mCurrentFrame;
     }
@@ -508,6 +655,11 @@ namespace Ogre {
             it.second->logResults();
         }
 
+        for (const auto& [name, value] : mCounters)
+        {
+            LogManager::getSingleton().logMessage(::std::format("{} | {}", name, value));
+        }
+
         LogManager::getSingleton().logMessage("------------------------------------------------------------");
     }
 
@@ -559,6 +711,7 @@ namespace Ogre {
     {
         mRoot.reset();
         mMaxTotalFrameClocks = 0;
+        mCounters.clear();
     }
     //-----------------------------------------------------------------------
     void ProfileInstance::reset()
@@ -598,4 +751,141 @@ namespace Ogre {
             mListeners.erase(i);
     }
     //-----------------------------------------------------------------------
+    void Profiler::setCounter(std::string_view name, uint64 value)
+    {
+        auto it = mCounters.find(name);
+        if (it == mCounters.end())
+            mCounters.emplace(name, value);
+        else
+            it->second = value;
+    }
+    //-----------------------------------------------------------------------
+    auto Profiler::threadTrace() -> ThreadTrace*
+    {
+        if (msThreadTraceGeneration != mTraceGeneration)
+        {
+            std::lock_guard lock{mTraceMutex};
+            auto& trace = mThreadTraces.emplace_back(std::make_unique<ThreadTrace>());
+            trace->index = static_cast<uint32>(mThreadTraces.size() - 1);
+            msThreadTrace = trace.get();
+            msThreadTraceGeneration = mTraceGeneration;
+        }
+        return msThreadTrace;
+    }
+    //-----------------------------------------------------------------------
+    auto Profiler::_traceBegin(std::string_view profileName, ProfileGroupMask groupID) -> bool
+    {
+        if (!mTraceCapture.load(std::memory_order_relaxed) || (groupID & mProfileMask) == ProfileGroupMask{})
+            return false;
+
+        // this beginning, and the ends of all open profiles including this one
+        ThreadTrace* trace = threadTrace();
+        size_t used = trace->head.load(std::memory_order_relaxed) - trace->tail.load(std::memory_order_acquire);
+        if (used + trace->open + 2 > ThreadTrace::CAPACITY)
+        {
+            trace->dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        ++trace->open;
+        trace->push(profileName, true);
+        return true;
+    }
+    //-----------------------------------------------------------------------
+    void Profiler::_traceEnd(std::string_view profileName)
+    {
+        ThreadTrace* trace = threadTrace();
+        --trace->open;
+        trace->push(profileName, false);
+    }
+    //-----------------------------------------------------------------------
+    void Profiler::setTraceCapture(bool enabled)
+    {
+        if (enabled == getTraceCapture())
+            return;
+
+        if (enabled)
+        {
+            // what was recorded before belongs to no capture
+            _collectTrace();
+            std::lock_guard lock{mTraceMutex};
+            for (auto& trace : mThreadTraces)
+                trace->stack.clear();
+            mTraceEvents.clear();
+            mTraceDropped = 0;
+            mTraceStart = traceClock();
+        }
+
+        mTraceCapture.store(enabled, std::memory_order_relaxed);
+    }
+    //-----------------------------------------------------------------------
+    void Profiler::_collectTrace()
+    {
+        std::lock_guard lock{mTraceMutex};
+        for (auto& trace : mThreadTraces)
+        {
+            size_t tail = trace->tail.load(std::memory_order_relaxed);
+            size_t head = trace->head.load(std::memory_order_acquire);
+            for (; tail != head; ++tail)
+            {
+                const auto& event = trace->events[tail & (ThreadTrace::CAPACITY - 1)];
+                if (event.begin)
+                {
+                    trace->stack.push_back(event);
+                    continue;
+                }
+
+                // the beginning may have been recorded for an earlier capture
+                if (trace->stack.empty() || trace->stack.back().name.data() != event.name.data())
+                    continue;
+
+                const auto& begin = trace->stack.back();
+                if (mTraceEvents.size() < mTraceCapacity && begin.time >= mTraceStart)
+                    mTraceEvents.push_back({begin.name, begin.time - mTraceStart, event.time - begin.time,
+                                            trace->index, static_cast<uint32>(trace->stack.size() - 1)});
+                else
+                    ++mTraceDropped;
+                trace->stack.pop_back();
+            }
+            trace->tail.store(tail, std::memory_order_release);
+            mTraceDropped += trace->dropped.exchange(0, std::memory_order_relaxed);
+        }
+    }
+    //-----------------------------------------------------------------------
+    void Profiler::_takeTraceEvents(std::vector<ProfileTraceEvent>& events)
+    {
+        std::lock_guard lock{mTraceMutex};
+        events.clear();
+        events.swap(mTraceEvents);
+    }
+    //-----------------------------------------------------------------------
+    auto Profiler::_getTraceTime() const -> uint64
+    {
+        return traceClock() - mTraceStart;
+    }
+    //-----------------------------------------------------------------------
+    void Profiler::exportTrace(std::ostream& stream)
+    {
+        _collectTrace();
+
+        std::lock_guard lock{mTraceMutex};
+        stream << "{\"traceEvents\":[\n";
+        // the threads are named first, there always is the one of the Profiler
+        for (size_t i = 0; i < mThreadTraces.size(); ++i)
+        {
+            stream << std::format("{}{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":{},"
+                                  "\"args\":{{\"name\":\"{}\"}}}}",
+                                  i == 0 ? "" : ",\n", i, i == 0 ? String("Main") : std::format("Thread {}", i));
+        }
+
+        for (const auto& event : mTraceEvents)
+        {
+            stream << std::format(",\n{{\"name\":\"{}\",\"cat\":\"Ogre\",\"ph\":\"X\",\"ts\":{:.3f},"
+                                  "\"dur\":{:.3f},\"pid\":1,\"tid\":{}}}",
+                                  StringUtil::escapeJson(event.name), event.start / 1000.0, event.duration / 1000.0,
+                                  event.thread);
+        }
+        stream << "\n],\"displayTimeUnit\":\"ns\"}\n";
+    }
+    //-----------------------------------------------------------------------
 }
@@ -0,0 +1,334 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+module;
+
+#include <cstddef>
+#include <cstring>
+
+module Ogre.Core;
+
+import :Codec;
+import :DataStream;
+import :Exception;
+import :Image;
+import :LogManager;
+import :PixelFormat;
+import :Platform;
+import :QOICodec;
+import :SharedPtr;
+
+import <format>;
+import <fstream>;
+import <memory>;
+import <vector>;
+
+namespace Ogre {
+    namespace
+    {
+        const char QOI_MAGIC[4] = {'q', 'o', 'i', 'f'};
+        const size_t QOI_HEADER_SIZE = 14;
+        const uint8 QOI_PADDING[8] = {0, 0, 0, 0, 0, 0, 0, 1};
+
+        enum : uint8
+        {
+            QOI_OP_INDEX = 0x00,
+            QOI_OP_DIFF = 0x40,
+            QOI_OP_LUMA = 0x80,
+            QOI_OP_RUN = 0xc0,
+            QOI_OP_RGB = 0xfe,
+            QOI_OP_RGBA = 0xff,
+            QOI_MASK = 0xc0
+        };
+
+        struct Rgba
+        {
+            uint8 r, g, b, a;
+
+            auto operator==(const Rgba&) const -> bool = default;
+            [[nodiscard]] auto hash() const -> uint8 { return (r * 3 + g * 5 + b * 7 + a * 11) % 64; }
+        };
+
+        void writeBigEndian(uint8* dst, uint32 value)
+        {
+            dst[0] = uint8(value >> 24);
+            dst[1] = uint8(value >> 16);
+            dst[2] = uint8(value >> 8);
+            dst[3] = uint8(value);
+        }
+
+        auto readBigEndian(const uint8* src) -> uint32
+        {
+            return uint32(src[0]) << 24 | uint32(src[1]) << 16 | uint32(src[2]) << 8 | uint32(src[3]);
+        }
+
+        /// Encodes RGB or RGBA bytes
+        auto encodeQOI(const uint8* pixels, uint32 width, uint32 height, uint8 channels) -> std::vector<uint8>
+        {
+            size_t numPixels = size_t(width) * height;
+            std::vector<uint8> out(QOI_HEADER_SIZE + numPixels * (channels + 1) + sizeof(QOI_PADDING));
+            uint8* dst = out.data();
+
+            memcpy(dst, QOI_MAGIC, sizeof(QOI_MAGIC));
+            writeBigEndian(dst + 4, width);
+            writeBigEndian(dst + 8, height);
+            dst[12] = channels;
+            dst[13] = 0; // sRGB with linear alpha
+            dst += QOI_HEADER_SIZE;
+
+            Rgba index[64] = {};
+            Rgba prev{0, 0, 0, 255};
+            uint8 run = 0;
+            for (size_t i = 0; i < numPixels; ++i, pixels += channels)
+            {
+                Rgba px{pixels[0], pixels[1], pixels[2], channels == 4 ? pixels[3] : prev.a};
+                if (px == prev)
+                {
+                    if (++run == 62 || i + 1 == numPixels)
+                    {
+                        *dst++ = QOI_OP_RUN | (run - 1);
+                        run = 0;
+                    }
+                    continue;
+                }
+
+                if (run > 0)
+                {
+                    *dst++ = QOI_OP_RUN | (run - 1);
+                    run = 0;
+                }
+
+                uint8 hash = px.hash();
+                if (index[hash] == px)
+                {
+                    *dst++ = QOI_OP_INDEX | hash;
+                }
+                else
+                {
+                    index[hash] = px;
+                    if (px.a == prev.a)
+                    {
+                        auto dr = int8(px.r - prev.r);
+                        auto dg = int8(px.g - prev.g);
+                        auto db = int8(px.b - prev.b);
+                        int drg = dr - dg;
+                        int dbg = db - dg;
+
+                        if (dr > -3 && dr < 2 && dg > -3 && dg < 2 && db > -3 && db < 2)
+                        {
+                            *dst++ = QOI_OP_DIFF | (dr + 2) << 4 | (dg + 2) << 2 | (db + 2);
+                        }
+                        else if (drg > -9 && drg < 8 && dg > -33 && dg < 32 && dbg > -9 && dbg < 8)
+                        {
+                            *dst++ = QOI_OP_LUMA | (dg + 32);
+                            *dst++ = (drg + 8) << 4 | (dbg + 8);
+                        }
+                        else
+                        {
+                            *dst++ = QOI_OP_RGB;
+                            *dst++ = px.r;
+                            *dst++ = px.g;
+                            *dst++ = px.b;
+                        }
+                    }
+                    else
+                    {
+                        *dst++ = QOI_OP_RGBA;
+                        *dst++ = px.r;
+                        *dst++ = px.g;
+                        *dst++ = px.b;
+                        *dst++ = px.a;
+                    }
+                }
+                prev = px;
+            }
+
+            memcpy(dst, QOI_PADDING, sizeof(QOI_PADDING));
+            dst += sizeof(QOI_PADDING);
+            out.resize(dst - out.data());
+            return out;
+        }
+    }
+
+    QOICodec* QOICodec::msInstance = nullptr;
+    //---------------------------------------------------------------------
+    void QOICodec::startup()
+    {
+        if (!msInstance)
+        {
+            msInstance = new QOICodec();
+            Codec::registerCodec(msInstance);
+        }
+
+        LogManager::getSingleton().logMessage(LogMessageLevel::Normal, "QOI codec registering");
+    }
+    //---------------------------------------------------------------------
+    void QOICodec::shutdown()
+    {
+        if (msInstance)
+        {
+            Codec::unregisterCodec(msInstance);
+            delete msInstance;
+            msInstance = nullptr;
+        }
+    }
+    //---------------------------------------------------------------------
+    auto QOICodec::getType() const -> std::string_view
+    {
+        return "qoi";
+    }
+    //---------------------------------------------------------------------
+    auto QOICodec::magicNumberToFileExt(const char *magicNumberPtr, size_t maxbytes) const -> std::string_view
+    {
+        if (maxbytes >= sizeof(QOI_MAGIC) && memcmp(magicNumberPtr, QOI_MAGIC, sizeof(QOI_MAGIC)) == 0)
+            return "qoi";
+
+        return BLANKSTRING;
+    }
+    //---------------------------------------------------------------------
+    auto QOICodec::encode(const MemoryDataStreamPtr& input, const CodecDataPtr& pData) const -> DataStreamPtr
+    {
+        auto* imgData = static_cast<ImageData*>(pData.get());
+        PixelFormat format = imgData->format;
+        const uchar* pixels = input->getPtr();
+
+        // only the top level of 2D images, in the byte order of QOI
+        std::vector<uchar> converted;
+        if (format != PixelFormat::BYTE_RGBA && format != PixelFormat::BYTE_RGB)
+        {
+            format = PixelUtil::hasAlpha(format) ? PixelFormat::BYTE_RGBA : PixelFormat::BYTE_RGB;
+            converted.resize(PixelUtil::getMemorySize(imgData->width, imgData->height, 1, format));
+            PixelBox src(imgData->width, imgData->height, 1, imgData->format, const_cast<uchar*>(pixels));
+            PixelBox dst(imgData->width, imgData->height, 1, format, converted.data());
+            PixelUtil::bulkPixelConversion(src, dst);
+            pixels = converted.data();
+        }
+
+        auto encoded = encodeQOI(pixels, imgData->width, imgData->height,
+                                 uint8(PixelUtil::getNumElemBytes(format)));
+        auto output = std::make_shared<MemoryDataStream>(encoded.size());
+        memcpy(output->getPtr(), encoded.data(), encoded.size());
+        return output;
+    }
+    //---------------------------------------------------------------------
+    void QOICodec::encodeToFile(const MemoryDataStreamPtr& input, std::string_view outFileName,
+                                const CodecDataPtr& pData) const
+    {
+        auto data = static_pointer_cast<MemoryDataStream>(encode(input, pData));
+        std::ofstream f(String{outFileName}, std::ios::out | std::ios::binary);
+        if (!f.is_open())
+            OGRE_EXCEPT(ExceptionCodes::CANNOT_WRITE_TO_FILE, ::std::format("could not open file {}", outFileName));
+
+        f.write((char*)data->getPtr(), data->size());
+    }
+    //---------------------------------------------------------------------
+    auto QOICodec::decode(const DataStreamPtr& stream) const -> DecodeResult
+    {
+        MemoryDataStream source{stream};
+        const uint8* bytes = source.getPtr();
+        size_t size = source.size();
+        if (size < QOI_HEADER_SIZE + sizeof(QOI_PADDING) || memcmp(bytes, QOI_MAGIC, sizeof(QOI_MAGIC)) != 0)
+            OGRE_EXCEPT(ExceptionCodes::INVALIDPARAMS, "This is not a QOI file", stream->getName());
+
+        uint32 width = readBigEndian(bytes + 4);
+        uint32 height = readBigEndian(bytes + 8);
+        uint8 channels = bytes[12];
+        if (width == 0 || height == 0 || (channels != 3 && channels != 4) ||
+            height >= 400000000u / width)
+            OGRE_EXCEPT(ExceptionCodes::INVALIDPARAMS, "Invalid QOI header", stream->getName());
+
+        auto *imgData = new ImageData();
+        imgData->width = width;
+        imgData->height = height;
+        imgData->format = channels == 4 ? PixelFormat::BYTE_RGBA : PixelFormat::BYTE_RGB;
+        imgData->size = Image::calculateSize(TextureMipmap{}, 1, width, height, 1, imgData->format);
+
+        MemoryDataStreamPtr output(new MemoryDataStream(imgData->size));
+        uchar* dst = output->getPtr();
+
+        Rgba index[64] = {};
+        Rgba px{0, 0, 0, 255};
+        size_t pos = QOI_HEADER_SIZE;
+        size_t chunksEnd = size - sizeof(QOI_PADDING);
+        uint8 run = 0;
+        for (size_t i = 0, numPixels = size_t(width) * height; i < numPixels; ++i, dst += channels)
+        {
+            if (run > 0)
+            {
+                --run;
+            }
+            else if (pos < chunksEnd)
+            {
+                uint8 b1 = bytes[pos++];
+                if (b1 == QOI_OP_RGB || b1 == QOI_OP_RGBA)
+                {
+                    if (pos + (b1 == QOI_OP_RGBA ? 4 : 3) > chunksEnd)
+                        OGRE_EXCEPT(ExceptionCodes::INVALIDPARAMS, "Unexpected end of file", stream->getName());
+                    px.r = bytes[pos++];
+                    px.g = bytes[pos++];
+                    px.b = bytes[pos++];
+                    if (b1 == QOI_OP_RGBA)
+                        px.a = bytes[pos++];
+                }
+                else if ((b1 & QOI_MASK) == QOI_OP_INDEX)
+                {
+                    px = index[b1];
+                }
+                else if ((b1 & QOI_MASK) == QOI_OP_DIFF)
+                {
+                    px.r += ((b1 >> 4) & 0x03) - 2;
+                    px.g += ((b1 >> 2) & 0x03) - 2;
+                    px.b += (b1 & 0x03) - 2;
+                }
+                else if ((b1 & QOI_MASK) == QOI_OP_LUMA)
+                {
+                    uint8 b2 = bytes[pos++];
+                    int dg = (b1 & 0x3f) - 32;
+                    px.r += dg - 8 + ((b2 >> 4) & 0x0f);
+                    px.g += dg;
+                    px.b += dg - 8 + (b2 & 0x0f);
+                }
+                else
+                {
+                    run = b1 & 0x3f;
+                }
+                index[px.hash()] = px;
+            }
+
+            dst[0] = px.r;
+            dst[1] = px.g;
+            dst[2] = px.b;
+            if (channels == 4)
+                dst[3] = px.a;
+        }
+
+        DecodeResult ret;
+        ret.first = output;
+        ret.second = CodecDataPtr(imgData);
+        return ret;
+    }
+}
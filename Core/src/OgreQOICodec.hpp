@@ -0,0 +1,78 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+module;
+
+#include <cstddef>
+
+module Ogre.Core:QOICodec;
+
+import :ImageCodec;
+import :Prerequisites;
+
+namespace Ogre {
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Image
+    *  @{
+    */
+
+    /** Codec for QOI (Quite OK Image) images.
+    @remarks
+        QOI is a lossless format of 8 bit RGB and RGBA images, which encodes many times faster
+        than PNG at a slightly larger size. This makes it suitable for frame captures, see
+        RenderTarget::writeContentsToFileAsync. Images in other formats are converted to RGB,
+        or RGBA if they have alpha, on encoding.
+    */
+    class QOICodec : public ImageCodec
+    {
+    public:
+        using ImageCodec::decode;
+        using ImageCodec::encode;
+        using ImageCodec::encodeToFile;
+        [[nodiscard]] auto decode(const DataStreamPtr& input) const -> DecodeResult override;
+        [[nodiscard]] auto encode(const MemoryDataStreamPtr& input, const CodecDataPtr& pData) const
+            -> DataStreamPtr override;
+        void encodeToFile(const MemoryDataStreamPtr& input, std::string_view outFileName,
+                          const CodecDataPtr& pData) const override;
+        auto magicNumberToFileExt(const char *magicNumberPtr, size_t maxbytes) const -> std::string_view override;
+        [[nodiscard]] auto getType() const -> std::string_view override;
+
+        /// Static method to startup and register the QOI codec
+        static void startup();
+        /// Static method to shutdown and unregister the QOI codec
+        static void shutdown();
+
+    private:
+        /// Single registered codec instance
+        static QOICodec* msInstance;
+    };
+    /** @} */
+    /** @} */
+
+} // namespace
@@ -80,13 +80,14 @@ namespace Ogre {
 
         Technique* pTech;
 
-        // tell material it's been used
-        if (pRend->getMaterial())
-            pRend->getMaterial()->touch();
+        // tell material it's been used, borrowed as the renderable holds it for the frame
+        const MaterialPtr& material = pRend->getMaterial();
+        if (material)
+            material->touch();
 
         // Check material & technique supplied (the former since the default implementation
         // of getTechnique is based on it for backwards compatibility
-        if(!pRend->getMaterial() || !pRend->getTechnique())
+        if(!material || !pRend->getTechnique())
         {
             // Use default base white, with lighting only if vertices has normals
             RenderOperation op;
@@ -111,7 +112,7 @@ namespace Ogre {
         }
         
         pGroup->addRenderable(pRend, pTech, priority);
-
+        ++mStats.renderablesQueued;
     }
     //-----------------------------------------------------------------------
     void RenderQueue::clear(bool destroyPassMaps)
@@ -130,6 +131,8 @@ namespace Ogre {
             }
         }
 
+        mStats = Stats{};
+
         // Now trigger the pending pass updates
         Pass::processPendingPassUpdates();
 
@@ -178,6 +181,8 @@ namespace Ogre {
             // Insert new
             mGroups[std::to_underlying(groupID)] = std::make_unique<RenderQueueGroup>(mSplitPassesByLightingType, mSplitNoShadowPasses,
                                                         mShadowCastersCannotBeReceivers);
+            mGroups[std::to_underlying(groupID)]->setSortKeyGrouping(mSortKeyGrouping);
+            mGroups[std::to_underlying(groupID)]->setRetainSortOrder(mRetainSortOrder);
         }
 
         return mGroups[std::to_underlying(groupID)].get();
@@ -232,6 +237,34 @@ namespace Ogre {
         return mShadowCastersCannotBeReceivers;
     }
     //-----------------------------------------------------------------------
+    void RenderQueue::setSortKeyGrouping(bool enabled)
+    {
+        if (mSortKeyGrouping == enabled)
+            return;
+        mSortKeyGrouping = enabled;
+
+        // the collections may only switch while empty
+        for (auto & mGroup : mGroups)
+        {
+            if(mGroup)
+            {
+                mGroup->clear(true);
+                mGroup->setSortKeyGrouping(enabled);
+            }
+        }
+    }
+    //-----------------------------------------------------------------------
+    void RenderQueue::setRetainSortOrder(bool enabled)
+    {
+        mRetainSortOrder = enabled;
+
+        for (auto & mGroup : mGroups)
+        {
+            if(mGroup)
+                mGroup->setRetainSortOrder(enabled);
+        }
+    }
+    //-----------------------------------------------------------------------
     void RenderQueue::merge( const RenderQueue* rhs )
     {
         for (size_t i = 0; i < std::to_underlying(RenderQueueGroupID::COUNT); ++i)
@@ -242,6 +275,44 @@ namespace Ogre {
             RenderQueueGroup* pDstGroup = getQueueGroup( static_cast<RenderQueueGroupID>(i) );
             pDstGroup->merge( rhs->mGroups[i].get() );
         }
+
+        mStats.nodesCulled += rhs->mStats.nodesCulled;
+        mStats.objectsVisible += rhs->mStats.objectsVisible;
+        mStats.objectsRejected += rhs->mStats.objectsRejected;
+        mStats.renderablesQueued += rhs->mStats.renderablesQueued;
+    }
+    //---------------------------------------------------------------------
+    void RenderQueue::_resetStaging(const RenderQueue* target)
+    {
+        mSplitPassesByLightingType = target->mSplitPassesByLightingType;
+        mSplitNoShadowPasses = target->mSplitNoShadowPasses;
+        mShadowCastersCannotBeReceivers = target->mShadowCastersCannotBeReceivers;
+        mSortKeyGrouping = target->mSortKeyGrouping;
+        mDefaultQueueGroup = target->mDefaultQueueGroup;
+        mDefaultRenderablePriority = target->mDefaultRenderablePriority;
+        mRenderableListener = nullptr;
+        mStats = Stats{};
+
+        for (size_t i = 0; i < std::to_underlying(RenderQueueGroupID::COUNT); ++i)
+        {
+            if (!target->mGroups[i])
+            {
+                if (mGroups[i])
+                    mGroups[i]->clear(true);
+                continue;
+            }
+
+            const RenderQueueGroup* src = target->mGroups[i].get();
+            RenderQueueGroup* dst = getQueueGroup(static_cast<RenderQueueGroupID>(i));
+            dst->clear(true);
+            dst->setSplitPassesByLightingType(mSplitPassesByLightingType);
+            dst->setSplitNoShadowPasses(mSplitNoShadowPasses);
+            dst->setShadowCastersCannotBeReceivers(mShadowCastersCannotBeReceivers);
+            dst->setShadowsEnabled(src->getShadowsEnabled());
+            dst->setSortKeyGrouping(mSortKeyGrouping);
+            dst->resetOrganisationModes();
+            dst->addOrganisationMode(src->getOrganisationMode());
+        }
     }
 
     //---------------------------------------------------------------------
@@ -254,11 +325,17 @@ namespace Ogre {
         bool receiveShadows = getQueueGroup(mo->getRenderQueueGroup())->getShadowsEnabled() && mo->getReceivesShadows();
 
         if(onlyShadowCasters && !mo->getCastShadows() && !receiveShadows)
+        {
+            ++mStats.objectsRejected;
             return;
+        }
 
         mo->_notifyCurrentCamera(cam);
         if (!mo->isVisible())
+        {
+            ++mStats.objectsRejected;
             return;
+        }
 
         const auto& bbox = mo->getWorldBoundingBox(true);
         const auto& bsphere = mo->getWorldBoundingSphere(true);
@@ -266,6 +343,7 @@ namespace Ogre {
         if (!onlyShadowCasters || mo->getCastShadows())
         {
             mo->_updateRenderQueue(this);
+            ++mStats.objectsVisible;
             if (visibleBounds)
             {
                 visibleBounds->merge(bbox, bsphere, cam, receiveShadows);
@@ -274,6 +352,7 @@ namespace Ogre {
         // not shadow caster, receiver only?
         else if (receiveShadows)
         {
+            ++mStats.objectsRejected;
             visibleBounds->mergeNonRenderedButInFrustum(bbox, bsphere, cam);
         }
     }
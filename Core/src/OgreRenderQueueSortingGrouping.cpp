@@ -38,14 +38,28 @@ import :Math;
 import :RadixSort;
 import :RenderQueueSortingGrouping;
 import :Renderable;
+import :Root;
 import :Technique;
 
 import <algorithm>;
+import <bit>;
+import <functional>;
+import <mutex>;
 import <ranges>;
 import <set>;
+import <unordered_map>;
+import <vector>;
 
 namespace Ogre {
 namespace {
+    /// Lets a sorter use the work queue of the Root for large collections, if there is one
+    template <class TSorter>
+    void useRootWorkQueue(TSorter& sorter)
+    {
+        Root* root = Root::getSingletonPtr();
+        sorter.setWorkQueue(root ? root->getWorkQueue() : nullptr);
+    }
+
     /// Comparator to order objects by descending camera distance
     struct DistanceSortDescendingLess
     {
@@ -99,6 +113,23 @@ namespace {
             return static_cast<float>(- p.renderable->getSquaredViewDepth(camera));
         }
     };
+
+    /// Identity of a queued renderable, for looking up its retained position
+    struct RenderablePassHash
+    {
+        auto operator()(const RenderablePass& p) const noexcept -> size_t
+        {
+            return std::hash<const void*>{}(p.renderable) ^ (std::hash<const void*>{}(p.pass) << 1);
+        }
+    };
+
+    struct RenderablePassEqual
+    {
+        auto operator()(const RenderablePass& a, const RenderablePass& b) const noexcept -> bool
+        {
+            return a.renderable == b.renderable && a.pass == b.pass;
+        }
+    };
 }
     //-----------------------------------------------------------------------
     RenderPriorityGroup::RenderPriorityGroup(RenderQueueGroup* parent, 
@@ -269,6 +300,7 @@ namespace {
         // Delete queue groups which are using passes which are to be
         // deleted, we won't need these any more and they clutter up 
         // the list and can cause problems with future clones
+        std::scoped_lock lock{Pass::_getPassListMutex()};
 
         const Pass::PassSet& graveyardList = Pass::getPassGraveyard();
         for (auto gi : graveyardList)
@@ -312,6 +344,25 @@ namespace {
         mTransparents.sort(cam);
     }
     //-----------------------------------------------------------------------
+    void RenderPriorityGroup::setSortKeyGrouping(bool enabled)
+    {
+        mSolidsBasic.setSortKeyGrouping(enabled);
+        mSolidsDecal.setSortKeyGrouping(enabled);
+        mSolidsDiffuseSpecular.setSortKeyGrouping(enabled);
+        mSolidsNoShadowReceive.setSortKeyGrouping(enabled);
+        mTransparentsUnsorted.setSortKeyGrouping(enabled);
+    }
+    //-----------------------------------------------------------------------
+    void RenderPriorityGroup::setRetainSortOrder(bool enabled)
+    {
+        mSolidsBasic.setRetainSortOrder(enabled);
+        mSolidsDecal.setRetainSortOrder(enabled);
+        mSolidsDiffuseSpecular.setRetainSortOrder(enabled);
+        mSolidsNoShadowReceive.setRetainSortOrder(enabled);
+        mTransparentsUnsorted.setRetainSortOrder(enabled);
+        mTransparents.setRetainSortOrder(enabled);
+    }
+    //-----------------------------------------------------------------------
     void RenderPriorityGroup::merge( const RenderPriorityGroup* rhs )
     {
         mSolidsBasic.merge( rhs->mSolidsBasic );
@@ -337,6 +388,8 @@ namespace {
 
         // Clear sorted list
         mSortedDescending.clear();
+        mSortKeyed.clear();
+        mFrontToBack.clear();
     }
     //-----------------------------------------------------------------------
     void QueuedRenderableCollection::removePassGroup(Pass* p)
@@ -349,19 +402,24 @@ namespace {
             // erase from map
             mGrouped.erase(i);
         }
+
+        std::erase_if(mSortKeyed, [p](const SortKeyedRenderable& r) { return r.pass == p; });
+        std::erase_if(mFrontToBack, [p](const SortKeyedRenderable& r) { return r.pass == p; });
     }
     //-----------------------------------------------------------------------
     void QueuedRenderableCollection::sort(const Camera* cam)
     {
+        // per thread, as the queues of several SceneManagers may be sorted at once
         /// Radix sorter for accessing sort value 1 (Pass)
-        static RadixSort<RenderablePassList, RenderablePass, uint32> msRadixSorter1;
+        thread_local RadixSort<RenderablePassList, RenderablePass, uint32> msRadixSorter1;
         /// Radix sorter for sort value 2 (distance)
-        static RadixSort<RenderablePassList, RenderablePass, float> msRadixSorter2;
+        thread_local RadixSort<RenderablePassList, RenderablePass, float> msRadixSorter2;
 
         // ascending and descending sort both set bit 1
         // We always sort descending, because the only difference is in the
         // acceptVisitor method, where we iterate in reverse in ascending mode
-        if (!!(mOrganisationMode & OrganisationMode::SORT_DESCENDING))
+        if (!!(mOrganisationMode & OrganisationMode::SORT_DESCENDING) &&
+            !(mRetainSortOrder && sortRetained(cam)))
         {
             
             // We can either use a stable_sort and the 'less' implementation,
@@ -377,6 +435,8 @@ namespace {
             
             if (mSortedDescending.size() > 2000)
             {
+                useRootWorkQueue(msRadixSorter1);
+                useRootWorkQueue(msRadixSorter2);
                 // sort by pass
                 msRadixSorter1.sort(mSortedDescending, RadixSortFunctorPass());
                 // sort by depth
@@ -390,8 +450,106 @@ namespace {
             }
         }
 
+        if (mRetainSortOrder)
+            mPreviousSortedDescending = mSortedDescending;
+
         // Nothing needs to be done for pass groups, they auto-organise
+        if (!mSortKeyed.empty())
+        {
+            /// Radix sorter for the packed keys
+            thread_local RadixSort<SortKeyedRenderableList, SortKeyedRenderable, uint64> msRadixSorterKey;
+            /// Index of each pass in the order first queued, so passes sharing a hash stay apart
+            thread_local std::unordered_map<const Pass*, uint16> msPassIndex;
+
+            // The pass index below the hash keeps every pass in one run. The squared depth is
+            // never negative, so its upper 16 bits, sign, exponent and 7 mantissa bits, order
+            // like the value, quantised logarithmically.
+            msPassIndex.clear();
+            for (auto& r : mSortKeyed)
+            {
+                auto depth = static_cast<float>(r.renderable->getSquaredViewDepth(cam));
+                uint16 passIndex = msPassIndex.try_emplace(r.pass, static_cast<uint16>(msPassIndex.size())).first->second;
+                r.key = (uint64(r.pass->getHash()) << 32) | (uint64(passIndex) << 16) | (std::bit_cast<uint32>(depth) >> 16);
+            }
+            useRootWorkQueue(msRadixSorterKey);
+            msRadixSorterKey.sort(mSortKeyed, [](const SortKeyedRenderable& r) { return r.key; });
+        }
+
+        if (!mFrontToBack.empty())
+        {
+            thread_local RadixSort<SortKeyedRenderableList, SortKeyedRenderable, uint64> msRadixSorterFrontToBack;
+
+            // Keeping sign, exponent and the top 7 mantissa bits of the squared depth quantises
+            // it logarithmically. The lower 16 bits group the passes within each depth step.
+            for (auto& r : mFrontToBack)
+            {
+                auto depth = static_cast<float>(r.renderable->getSquaredViewDepth(cam));
+                auto passBits = static_cast<uint16>(std::hash<const void*>{}(r.pass));
+                r.key = (uint64(r.pass->getHash()) << 32) | ((std::bit_cast<uint32>(depth) >> 16) << 16) | passBits;
+            }
+            useRootWorkQueue(msRadixSorterFrontToBack);
+            msRadixSorterFrontToBack.sort(mFrontToBack, [](const SortKeyedRenderable& r) { return r.key; });
+        }
+    }
+    //-----------------------------------------------------------------------
+    auto QueuedRenderableCollection::sortRetained(const Camera* cam) -> bool
+    {
+        if (mPreviousSortedDescending.empty())
+            return false;
+
+        // scratch space kept per thread like the radix sorters of sort(), never shared between
+        // collections sorted at the same time. msReordered trades its storage with mSortedDescending.
+        /// Position of each entry in the previous order
+        thread_local std::unordered_map<RenderablePass, uint32, RenderablePassHash, RenderablePassEqual> msPreviousIndex;
+        /// For each previous position, one more than the index of the entry queued now
+        thread_local std::vector<uint32> msRetained;
+        /// Indices of the entries which were not queued before
+        thread_local std::vector<uint32> msAdded;
+        thread_local RenderablePassList msReordered;
+
+        msPreviousIndex.clear();
+        for (uint32 i = 0; i < mPreviousSortedDescending.size(); ++i)
+            msPreviousIndex.try_emplace(mPreviousSortedDescending[i], i);
+
+        msRetained.assign(mPreviousSortedDescending.size(), 0);
+        msAdded.clear();
+        for (uint32 i = 0; i < mSortedDescending.size(); ++i)
+        {
+            auto it = msPreviousIndex.find(mSortedDescending[i]);
+            if (it != msPreviousIndex.end() && msRetained[it->second] == 0)
+                msRetained[it->second] = i + 1;
+            else
+                msAdded.push_back(i);
+        }
 
+        // previous order first, dropping what is gone, then the new ones as queued
+        msReordered.clear();
+        for (auto i : msRetained)
+        {
+            if (i)
+                msReordered.push_back(mSortedDescending[i - 1]);
+        }
+        for (auto i : msAdded)
+            msReordered.push_back(mSortedDescending[i]);
+        std::swap(mSortedDescending, msReordered);
+
+        // Insertion sort, which is stable like the regular sort. Give up once it
+        // costs more than a few moves per entry, the data is not nearly sorted then.
+        DistanceSortDescendingLess less{cam};
+        size_t budget = 4 * mSortedDescending.size();
+        for (size_t i = 1; i < mSortedDescending.size(); ++i)
+        {
+            RenderablePass rp = mSortedDescending[i];
+            size_t j = i;
+            for (; j > 0 && less(rp, mSortedDescending[j - 1]); --j)
+                mSortedDescending[j] = mSortedDescending[j - 1];
+            mSortedDescending[j] = rp;
+
+            if (i - j > budget)
+                return false;
+            budget -= i - j;
+        }
+        return true;
     }
     //-----------------------------------------------------------------------
     void QueuedRenderableCollection::addRenderable(Pass* pass, Renderable* rend)
@@ -402,7 +560,12 @@ namespace {
             mSortedDescending.push_back(RenderablePass{rend, pass});
         }
 
-        if (!!(mOrganisationMode & OrganisationMode::PASS_GROUP))
+        if (!!(mOrganisationMode & OrganisationMode::PASS_GROUP) && mSortKeyGrouping)
+        {
+            // the key is only known once sorting with a camera
+            mSortKeyed.push_back(SortKeyedRenderable{0, rend, pass});
+        }
+        else if (!!(mOrganisationMode & OrganisationMode::PASS_GROUP))
         {
             // Optionally create new pass entry, build a new list
             // Note that this pass and list are never destroyed until the
@@ -414,7 +577,11 @@ namespace {
             i->second.push_back(rend);
             
         }
-        
+
+        if (!!(mOrganisationMode & OrganisationMode::PASS_GROUP_FRONT_TO_BACK))
+        {
+            mFrontToBack.push_back(SortKeyedRenderable{0, rend, pass});
+        }
     }
     //-----------------------------------------------------------------------
     void QueuedRenderableCollection::acceptVisitor(
@@ -426,6 +593,8 @@ namespace {
             // try to fall back
             if (!!(PASS_GROUP & mOrganisationMode))
                 om = PASS_GROUP;
+            else if (!!(PASS_GROUP_FRONT_TO_BACK & mOrganisationMode))
+                om = PASS_GROUP_FRONT_TO_BACK;
             else if (!!(SORT_ASCENDING & mOrganisationMode))
                 om = SORT_ASCENDING;
             else if (!!(SORT_DESCENDING & mOrganisationMode))
@@ -448,6 +617,9 @@ namespace {
         case SORT_ASCENDING:
             acceptVisitorAscending(visitor);
             break;
+        case PASS_GROUP_FRONT_TO_BACK:
+            acceptVisitorFrontToBack(visitor);
+            break;
         }
         
     }
@@ -463,6 +635,30 @@ namespace {
             visitor->visit(ipass.first, const_cast<RenderableList&>(ipass.second));
         } 
 
+        acceptVisitorPassRuns(visitor, mSortKeyed);
+    }
+    //-----------------------------------------------------------------------
+    void QueuedRenderableCollection::acceptVisitorFrontToBack(
+        QueuedRenderableVisitor* visitor) const
+    {
+        acceptVisitorPassRuns(visitor, mFrontToBack);
+    }
+    //-----------------------------------------------------------------------
+    void QueuedRenderableCollection::acceptVisitorPassRuns(
+        QueuedRenderableVisitor* visitor, const SortKeyedRenderableList& list) const
+    {
+        // Sorted by pass hash and pass, every run of the same pass is one group
+        for (size_t begin = 0; begin < list.size();)
+        {
+            Pass* pass = list[begin].pass;
+            mSortKeyedGroup.clear();
+            size_t end = begin;
+            for (; end < list.size() && list[end].pass == pass; ++end)
+                mSortKeyedGroup.push_back(list[end].renderable);
+
+            visitor->visit(pass, mSortKeyedGroup);
+            begin = end;
+        }
     }
     //-----------------------------------------------------------------------
     void QueuedRenderableCollection::acceptVisitorDescending(
@@ -489,6 +685,8 @@ namespace {
     void QueuedRenderableCollection::merge( const QueuedRenderableCollection& rhs )
     {
         mSortedDescending.insert( mSortedDescending.end(), rhs.mSortedDescending.begin(), rhs.mSortedDescending.end() );
+        mSortKeyed.insert( mSortKeyed.end(), rhs.mSortKeyed.begin(), rhs.mSortKeyed.end() );
+        mFrontToBack.insert( mFrontToBack.end(), rhs.mFrontToBack.begin(), rhs.mFrontToBack.end() );
 
         for(auto const& srcGroup : rhs.mGrouped)
         {
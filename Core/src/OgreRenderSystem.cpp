@@ -38,9 +38,11 @@ module Ogre.Core;
 //  we cannot know how to implement the behaviour without
 //  being aware of the 3D API. However there are a few
 //  simple functions which can have a base implementation
+import :Camera;
 import :Common;
 import :Config;
 import :ConfigOptionMap;
+import :DataStream;
 import :DepthBuffer;
 import :Exception;
 import :GpuProgram;
@@ -55,21 +57,29 @@ import :Prerequisites;
 import :RenderOperation;
 import :RenderSystem;
 import :RenderSystemCapabilities;
+import :RenderSystemCapabilitiesManager;
+import :RenderSystemCapabilitiesSerializer;
 import :RenderTarget;
+import :Root;
+import :SceneManager;
 import :SharedPtr;
+import :String;
 import :StringConverter;
 import :StringVector;
 import :TextureManager;
 import :TextureUnitState;
 import :Vector;
 import :VertexIndexData;
+import :Viewport;
 
 import <algorithm>;
+import <filesystem>;
 import <format>;
 import <istream>;
 import <list>;
 import <map>;
 import <memory>;
+import <span>;
 import <string>;
 import <utility>;
 import <vector>;
@@ -247,6 +257,8 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     void RenderSystem::_updateAllRenderTargets(bool swapBuffers)
     {
+        gatherViewports();
+
         // Update all in order of priority
         // This ensures render-to-texture targets get updated before render windows
         for (auto & mPrioritisedRenderTarget : mPrioritisedRenderTargets)
@@ -256,6 +268,32 @@ namespace Ogre {
         }
     }
     //-----------------------------------------------------------------------
+    void RenderSystem::gatherViewports()
+    {
+        mGatheredViewports.clear();
+        mGatheredSceneManagers.clear();
+        for (auto const& [priority, target] : mPrioritisedRenderTargets)
+        {
+            if (!target->isActive() || !target->isAutoUpdated())
+                continue;
+
+            for (unsigned short i = 0; i < target->getNumViewports(); ++i)
+            {
+                Viewport* vp = target->getViewport(i);
+                Camera* cam = vp->getCamera();
+                if (!vp->isAutoUpdated() || !cam || !cam->getSceneManager()->getParallelViewportCulling())
+                    continue;
+
+                mGatheredViewports.push_back(vp);
+                if (std::ranges::find(mGatheredSceneManagers, cam->getSceneManager()) == mGatheredSceneManagers.end())
+                    mGatheredSceneManagers.push_back(cam->getSceneManager());
+            }
+        }
+
+        for (auto sceneMgr : mGatheredSceneManagers)
+            sceneMgr->_gatherViewports(mGatheredViewports);
+    }
+    //-----------------------------------------------------------------------
     void RenderSystem::_swapAllRenderTargetBuffers()
     {
         // Update all in order of priority
@@ -303,6 +341,47 @@ namespace Ogre {
         mCurrentCapabilities = capabilities;
         mUseCustomCapabilities = true;
     }
+    //---------------------------------------------------------------------------------------------
+    auto RenderSystem::loadCachedCapabilities(GPUVendor vendor, std::string_view deviceName,
+                                              const DriverVersion& driverVersion) const -> RenderSystemCapabilities*
+    {
+        if (mCapabilitiesCacheFile.empty())
+            return nullptr;
+
+        DataStreamPtr stream = MemoryMappedDataStream::open(mCapabilitiesCacheFile.string(), mCapabilitiesCacheFile);
+        if (!stream)
+            return nullptr;
+        RenderSystemCapabilitiesSerializer serializer;
+        serializer.parseScript(stream);
+
+        const auto& parsed = RenderSystemCapabilitiesManager::getSingleton().getCapabilities();
+        auto it = parsed.find(::std::format("{} cache", getName()));
+        if (it == parsed.end())
+            return nullptr;
+
+        // the build number is not written, the device name is read back with single spaces
+        const RenderSystemCapabilities* cached = it->second.get();
+        const DriverVersion& version = cached->getDriverVersion();
+        if (cached->getRenderSystemName() != getName() || cached->getVendor() != vendor ||
+            StringUtil::split(cached->getDeviceName()) != StringUtil::split(deviceName) ||
+            version.major != driverVersion.major ||
+            version.minor != driverVersion.minor || version.release != driverVersion.release)
+        {
+            LogManager::getSingleton().logMessage(
+                ::std::format("Capabilities cache {} is for another device or driver", mCapabilitiesCacheFile.string()));
+            return nullptr;
+        }
+        return new RenderSystemCapabilities(*cached);
+    }
+    //---------------------------------------------------------------------------------------------
+    void RenderSystem::saveCachedCapabilities(const RenderSystemCapabilities* caps) const
+    {
+        if (mCapabilitiesCacheFile.empty())
+            return;
+
+        RenderSystemCapabilitiesSerializer serializer;
+        serializer.writeScript(caps, ::std::format("{} cache", getName()), mCapabilitiesCacheFile.string());
+    }
 
     //---------------------------------------------------------------------------------------------
     auto RenderSystem::_createRenderWindow(std::string_view name, unsigned int width,
@@ -418,6 +497,7 @@ namespace Ogre {
 
         // Bind texture (may be blank)
         _setTexture(texUnit, true, tex);
+        ++currentRenderStats().textureBinds;
 
         // Set texture coordinate set
         _setTextureCoordSet(texUnit, tl.getTextureCoordSet());
@@ -633,6 +713,24 @@ namespace Ogre {
         return static_cast< unsigned int >( mVertexCount );
     }
     //-----------------------------------------------------------------------
+    auto RenderSystem::currentRenderStats() -> RenderStats&
+    {
+        unsigned long frameNumber = Root::getSingleton().getNextFrameNumber();
+        if (frameNumber != mRenderStatsFrame)
+        {
+            mRenderStats = RenderStats{};
+            mRenderStatsFrame = frameNumber;
+        }
+        return mRenderStats;
+    }
+    //-----------------------------------------------------------------------
+    void RenderSystem::_notifyBufferUpload(size_t bytes)
+    {
+        RenderStats& stats = currentRenderStats();
+        ++stats.bufferUploads;
+        stats.bytesUploaded += bytes;
+    }
+    //-----------------------------------------------------------------------
     void RenderSystem::_render(const RenderOperation& op)
     {
         // Update stats
@@ -673,6 +771,7 @@ namespace Ogre {
 
         mVertexCount += op.vertexData->vertexCount * trueInstanceNum;
         mBatchCount += mCurrentPassIterationCount;
+        currentRenderStats().drawCalls += mCurrentPassIterationCount;
 
         // sort out clip planes
         // have to do it here in case of matrix issues
@@ -683,6 +782,12 @@ namespace Ogre {
         }
     }
     //-----------------------------------------------------------------------
+    void RenderSystem::_renderMultiple(std::span<const RenderOperation* const> ops)
+    {
+        for (auto op : ops)
+            _render(*op);
+    }
+    //-----------------------------------------------------------------------
     void RenderSystem::setInvertVertexWinding(bool invert)
     {
         mInvertVertexWinding = invert;
@@ -807,6 +912,8 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     void RenderSystem::bindGpuProgram(GpuProgram* prg)
     {
+        ++currentRenderStats().programBinds;
+
         using enum GpuProgramType;
         switch(prg->getType())
         {
@@ -162,6 +162,7 @@ namespace Ogre {
         pLog->logMessage(::std::format("   - Render to Vertex Buffer: {}", hasCapability(Capabilities::HWRENDER_TO_VERTEX_BUFFER)));;
         pLog->logMessage(::std::format("   - Instance Data: {}", hasCapability(Capabilities::VERTEX_BUFFER_INSTANCE_DATA)));;
         pLog->logMessage(::std::format("   - Primitive Restart: {}", hasCapability(Capabilities::PRIMITIVE_RESTART)));;
+        pLog->logMessage(::std::format("   - Multi draw: {}", hasCapability(Capabilities::MULTI_DRAW)));
         pLog->logMessage(::std::format(" * Vertex texture fetch: {}", hasCapability(Capabilities::VERTEX_TEXTURE_FETCH)));;
         if (hasCapability(Capabilities::VERTEX_TEXTURE_FETCH))
         {
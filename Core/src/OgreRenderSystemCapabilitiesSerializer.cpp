@@ -86,6 +86,7 @@ namespace Ogre
 
         file << endl;
         file << "\t" << "max_point_size " << StringConverter::toString(caps->getMaxPointSize()) << endl;
+        file << "\t" << "max_supported_anisotropy " << StringConverter::toString(caps->getMaxSupportedAnisotropy()) << endl;
 
         file << endl;
         file << "\t" << "non_pow2_textures_limited " << StringConverter::toString(caps->getNonPOW2TexturesLimited()) << endl;
@@ -318,6 +319,7 @@ namespace Ogre
         addKeywordType("compute_program_constant_int_count", SET_INT_METHOD);
         addKeywordType("compute_program_constant_bool_count", SET_INT_METHOD);
         addKeywordType("num_vertex_texture_units", SET_INT_METHOD);
+        addKeywordType("num_vertex_attributes", SET_INT_METHOD);
 
         // initialize int setters
         addSetIntMethod("num_texture_units", &RenderSystemCapabilities::setNumTextureUnits);
@@ -330,6 +332,7 @@ namespace Ogre
         addSetIntMethod("tessellation_domain_program_constant_float_count", &RenderSystemCapabilities::setTessellationDomainProgramConstantFloatCount);
         addSetIntMethod("compute_program_constant_float_count", &RenderSystemCapabilities::setComputeProgramConstantFloatCount);
         addSetIntMethod("num_vertex_texture_units", &RenderSystemCapabilities::setNumVertexTextureUnits);
+        addSetIntMethod("num_vertex_attributes", &RenderSystemCapabilities::setNumVertexAttributes);
 
         // initialize bool types
         addKeywordType("non_pow2_textures_limited", SET_BOOL_METHOD);
@@ -339,9 +342,11 @@ namespace Ogre
 
         // initialize Real types
         addKeywordType("max_point_size", SET_REAL_METHOD);
+        addKeywordType("max_supported_anisotropy", SET_REAL_METHOD);
 
         // initialize Real setters
         addSetRealMethod("max_point_size", &RenderSystemCapabilities::setMaxPointSize);
+        addSetRealMethod("max_supported_anisotropy", &RenderSystemCapabilities::setMaxSupportedAnisotropy);
 
         // there is no dispatch table for shader profiles, just the type
         addKeywordType("shader_profile", ADD_SHADER_PROFILE_STRING);
@@ -363,7 +368,7 @@ namespace Ogre
         addCapabilitiesMapping("texture_float", Capabilities::TEXTURE_FLOAT);
         addCapabilitiesMapping("non_power_of_2_textures", Capabilities::NON_POWER_OF_2_TEXTURES);
         addCapabilitiesMapping("texture_3d", Capabilities::TEXTURE_3D);
-        addCapabilitiesMapping("texture_2d_array", Capabilities::TEXTURE_3D);
+        addCapabilitiesMapping("texture_2d_array", Capabilities::TEXTURE_2D_ARRAY);
         addCapabilitiesMapping("texture_1d", Capabilities::TEXTURE_1D);
         addCapabilitiesMapping("point_sprites", Capabilities::POINT_SPRITES);
         addCapabilitiesMapping("wide_lines", Capabilities::WIDE_LINES);
@@ -382,6 +387,7 @@ namespace Ogre
         addCapabilitiesMapping("texture_compression_bc6h_bc7", Capabilities::TEXTURE_COMPRESSION_BC6H_BC7);
         addCapabilitiesMapping("texture_compression_astc", Capabilities::TEXTURE_COMPRESSION_ASTC);
         addCapabilitiesMapping("hwrender_to_vertex_buffer", Capabilities::HWRENDER_TO_VERTEX_BUFFER);
+        addCapabilitiesMapping("multi_draw", Capabilities::MULTI_DRAW);
 
         addCapabilitiesMapping("pbuffer", Capabilities::PBUFFER);
         addCapabilitiesMapping("perstageconstant", Capabilities::PERSTAGECONSTANT);
@@ -391,6 +397,19 @@ namespace Ogre
         addCapabilitiesMapping("debug", Capabilities::DEBUG);
         addCapabilitiesMapping("mapbuffer", Capabilities::MAPBUFFER);
         addCapabilitiesMapping("automipmap_compressed", Capabilities::AUTOMIPMAP_COMPRESSED);
+        addCapabilitiesMapping("alpha_to_coverage", Capabilities::ALPHA_TO_COVERAGE);
+        addCapabilitiesMapping("can_get_compiled_shader_buffer", Capabilities::CAN_GET_COMPILED_SHADER_BUFFER);
+        addCapabilitiesMapping("depth_clamp", Capabilities::DEPTH_CLAMP);
+        addCapabilitiesMapping("hwocclusion_asynchronous", Capabilities::HWOCCLUSION_ASYNCHRONOUS);
+        addCapabilitiesMapping("hwrender_to_texture_3d", Capabilities::HWRENDER_TO_TEXTURE_3D);
+        addCapabilitiesMapping("hw_gamma", Capabilities::HW_GAMMA);
+        addCapabilitiesMapping("mrt_different_bit_depths", Capabilities::MRT_DIFFERENT_BIT_DEPTHS);
+        addCapabilitiesMapping("primitive_restart", Capabilities::PRIMITIVE_RESTART);
+        addCapabilitiesMapping("read_back_as_texture", Capabilities::READ_BACK_AS_TEXTURE);
+        addCapabilitiesMapping("rtt_depthbuffer_resolution_lessequal", Capabilities::RTT_DEPTHBUFFER_RESOLUTION_LESSEQUAL);
+        addCapabilitiesMapping("rtt_main_depthbuffer_attachable", Capabilities::RTT_MAIN_DEPTHBUFFER_ATTACHABLE);
+        addCapabilitiesMapping("vertex_buffer_instance_data", Capabilities::VERTEX_BUFFER_INSTANCE_DATA);
+        addCapabilitiesMapping("wbuffer", Capabilities::WBUFFER);
     }
 
     void RenderSystemCapabilitiesSerializer::parseCapabilitiesLines(CapabilitiesLinesList& lines)
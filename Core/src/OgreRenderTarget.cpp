@@ -29,27 +29,40 @@ THE SOFTWARE.
 module;
 
 #include <cassert>
+#include <cstring>
 #include <ctime>
 
 module Ogre.Core;
 
+import :Common;
+import :DataStream;
 import :DepthBuffer;
 import :Exception;
 import :Image;
 import :Log;
 import :LogManager;
+import :PixelFormat;
 import :RenderTarget;
 import :RenderTargetListener;
 import :Root;
+import :SharedPtr;
+import :String;
 import :StringConverter;
 import :Timer;
 import :Viewport;
+import :WorkQueue;
 
 import <algorithm>;
+import <exception>;
+import <fstream>;
+import <future>;
 import <iomanip>;
+import <iterator>;
+import <memory>;
 import <ostream>;
 import <string>;
 import <utility>;
+import <vector>;
 
 namespace Ogre {
     RenderTarget::RenderTarget()
@@ -457,7 +470,8 @@ namespace Ogre {
         }
     }
     //-----------------------------------------------------------------------
-    auto RenderTarget::writeContentsToTimestampedFile(std::string_view filenamePrefix, std::string_view filenameSuffix) -> String
+    auto RenderTarget::getTimestampedFilename(std::string_view filenamePrefix, std::string_view filenameSuffix) const
+        -> String
     {
         struct tm *pTime;
         time_t ctTime; time(&ctTime);
@@ -468,7 +482,12 @@ namespace Ogre {
             << std::put_time(pTime, "%Y%m%d_%H%M%S")
             << std::setw(3) << std::setfill('0') << (mTimer->getMilliseconds() % 1000)
             << filenameSuffix;
-        String filename = oss.str();
+        return oss.str();
+    }
+    //-----------------------------------------------------------------------
+    auto RenderTarget::writeContentsToTimestampedFile(std::string_view filenamePrefix, std::string_view filenameSuffix) -> String
+    {
+        String filename = getTimestampedFilename(filenamePrefix, filenameSuffix);
         writeContentsToFile(filename);
         return filename;
 
@@ -484,6 +503,122 @@ namespace Ogre {
         img.save(filename);
     }
     //-----------------------------------------------------------------------
+    auto RenderTarget::encodeContentsAsync(std::string_view format, int compressionLevel, CaptureCallback callback)
+        -> std::future<DataStreamPtr>
+    {
+        PixelFormat pixelFormat = suggestPixelFormat();
+        auto promise = std::make_shared<std::promise<DataStreamPtr>>();
+        auto future = promise->get_future();
+        ReadbackTicket ticket = startContentsReadback(Box{0, 0, mWidth, mHeight}, pixelFormat);
+        mPendingCaptures.push_back({ticket, mWidth, mHeight, pixelFormat, String{format}, compressionLevel,
+                                    std::move(callback), std::move(promise)});
+        return future;
+    }
+    //-----------------------------------------------------------------------
+    auto RenderTarget::writeContentsToFileAsync(std::string_view filename, int compressionLevel)
+        -> std::future<DataStreamPtr>
+    {
+        std::string_view base, ext;
+        StringUtil::splitBaseFilename(filename, base, ext);
+
+        return encodeContentsAsync(ext, compressionLevel, [filename = String{filename}](const DataStreamPtr& encoded)
+        {
+            auto data = static_pointer_cast<MemoryDataStream>(encoded);
+            std::ofstream f(filename, std::ios::out | std::ios::binary);
+            if (!f.is_open())
+                OGRE_EXCEPT(ExceptionCodes::CANNOT_WRITE_TO_FILE, ::std::format("could not open file {}", filename));
+
+            f.write((const char*)data->getPtr(), data->size());
+        });
+    }
+    //-----------------------------------------------------------------------
+    auto RenderTarget::writeContentsToTimestampedFileAsync(std::string_view filenamePrefix,
+                                                           std::string_view filenameSuffix, int compressionLevel) -> String
+    {
+        String filename = getTimestampedFilename(filenamePrefix, filenameSuffix);
+        writeContentsToFileAsync(filename, compressionLevel);
+        return filename;
+    }
+    //-----------------------------------------------------------------------
+    void RenderTarget::flushCaptures()
+    {
+        finishCaptures(mPendingCaptures.size());
+    }
+    //-----------------------------------------------------------------------
+    void RenderTarget::finishCaptures(size_t count)
+    {
+        std::vector<PendingCapture> captures{std::make_move_iterator(mPendingCaptures.begin()),
+                                             std::make_move_iterator(mPendingCaptures.begin() + count)};
+        mPendingCaptures.erase(mPendingCaptures.begin(), mPendingCaptures.begin() + count);
+
+        for (auto& capture : captures)
+        {
+            auto image = std::make_shared<Image>(capture.pixelFormat, capture.width, capture.height);
+            try
+            {
+                finishContentsReadback(capture.ticket, image->getPixelBox());
+            }
+            catch (...)
+            {
+                capture.promise->set_exception(std::current_exception());
+                continue;
+            }
+
+            // the encoding takes far longer than the readback, so it is kept off the render thread
+            auto encode = [image, capture = std::move(capture)]
+            {
+                try
+                {
+                    DataStreamPtr encoded;
+                    if (capture.format == "raw")
+                    {
+                        auto raw = std::make_shared<MemoryDataStream>(image->getSize());
+                        memcpy(raw->getPtr(), image->getData(), image->getSize());
+                        encoded = raw;
+                    }
+                    else
+                    {
+                        encoded = image->encode(capture.format, capture.compressionLevel);
+                    }
+
+                    if (capture.callback)
+                        capture.callback(encoded);
+                    capture.promise->set_value(encoded);
+                }
+                catch (...)
+                {
+                    capture.promise->set_exception(std::current_exception());
+                }
+            };
+
+            if (WorkQueue* queue = Root::getSingleton().getWorkQueue())
+                queue->addTask(encode);
+            else
+                encode();
+        }
+    }
+    //-----------------------------------------------------------------------
+    auto RenderTarget::startContentsReadback(const Box& src, PixelFormat format, FrameBuffer buffer) -> ReadbackTicket
+    {
+        auto& readback = mPendingReadbacks[++mLastReadbackTicket];
+        readback.data.resize(PixelUtil::getMemorySize(src.getWidth(), src.getHeight(), 1, format));
+        readback.box = PixelBox(src.getWidth(), src.getHeight(), 1, format, readback.data.data());
+
+        copyContentsToMemory(src, readback.box, buffer);
+        return mLastReadbackTicket;
+    }
+    //-----------------------------------------------------------------------
+    void RenderTarget::finishContentsReadback(ReadbackTicket ticket, const PixelBox& dst, bool bottomUp)
+    {
+        auto it = mPendingReadbacks.find(ticket);
+        OgreAssert(it != mPendingReadbacks.end(), "Unknown readback ticket");
+
+        PixelUtil::bulkPixelConversion(it->second.box, dst);
+        if (bottomUp)
+            PixelUtil::bulkPixelVerticalFlip(dst);
+        mPendingReadbacks.erase(it);
+    }
+    //-----------------------------------------------------------------------
     void RenderTarget::_notifyCameraRemoved(const Camera* cam)
     {
         for (auto const& [key, v] : mViewportList)
@@ -519,9 +654,15 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     void RenderTarget::update(bool swap)
     {
+        // the readbacks of the captures started before are finished once this frame is issued
+        size_t numCaptures = mPendingCaptures.size();
+
         // call implementation
         updateImpl();
 
+        if (numCaptures > 0)
+            finishCaptures(numCaptures);
+
 
         if (swap)
         {
@@ -33,6 +33,7 @@ module;
 module Ogre.Core;
 
 import :Exception;
+import :HitchMonitor;
 import :Log;
 import :LogManager;
 import :Prerequisites;
@@ -106,6 +107,7 @@ namespace Ogre
             return;
         }
 
+        HitchMonitor::Scope activity{HitchMonitor::ActivityType::RESOURCE_LOAD, mName};
         // Scope lock for actual loading
         try
         {
@@ -37,9 +37,14 @@ import :ResourceGroupManager;
 import :ResourceManager;
 import :Root;
 import :SharedPtr;
+import :Timer;
 
+import <algorithm>;
 import <any>;
+import <iterator>;
+import <map>;
 import <utility>;
+import <vector>;
 
 namespace Ogre {
 
@@ -72,6 +77,7 @@ namespace Ogre {
     /** Encapsulates a queued request for the background queue */
     struct ResourceRequest
     {
+        BackgroundProcessTicket ticket;
         RequestType type;
         std::string_view resourceName;
         ResourceHandle resourceHandle;
@@ -89,6 +95,29 @@ namespace Ogre {
         ResourcePtr resource;
         ResourceRequest request;
     };
+
+    namespace {
+        /// Frees what a request owns, if it is dropped before it is handled
+        void releaseRequest(::std::any& data)
+        {
+            auto& req = any_cast<ResourceRequest&>(data);
+            delete req.loadParams;
+            req.loadParams = nullptr;
+        }
+
+        /// Whether a should be dispatched before b
+        auto isBefore(const ResourceBackgroundQueue::RequestPriority& a,
+                      const ResourceBackgroundQueue::RequestPriority& b, unsigned long frame) -> bool
+        {
+            bool aDue = a.deadline && a.deadline <= frame;
+            bool bDue = b.deadline && b.deadline <= frame;
+            if (aDue != bDue)
+                return aDue;
+            if (aDue)
+                return a.deadline < b.deadline;
+            return a.priority > b.priority;
+        }
+    }
     //------------------------------------------------------------------------
     ResourceBackgroundQueue::ResourceBackgroundQueue()  
     = default;
@@ -112,6 +141,15 @@ namespace Ogre {
         wq->abortRequestsByChannel(mWorkQueueChannel);
         wq->removeRequestHandler(mWorkQueueChannel, this);
         wq->removeResponseHandler(mWorkQueueChannel, this);
+
+        for (auto& [ticket, pending] : mPendingRequests)
+        {
+            releaseRequest(pending.request);
+            mOutstandingRequestSet.erase(ticket);
+        }
+        mPendingRequests.clear();
+        mDispatchedRequests.clear();
+        mCompletions.clear();
     }
     //------------------------------------------------------------------------
     auto ResourceBackgroundQueue::initialiseResourceGroup(
@@ -243,24 +281,138 @@ namespace Ogre {
     //------------------------------------------------------------------------
     void ResourceBackgroundQueue::abortRequest( BackgroundProcessTicket ticket )
     {
+        auto pending = mPendingRequests.find(ticket);
+        if (pending != mPendingRequests.end())
+        {
+            releaseRequest(pending->second.request);
+            mPendingRequests.erase(pending);
+            mOutstandingRequestSet.erase(ticket);
+            return;
+        }
+
         WorkQueue* queue = Root::getSingleton().getWorkQueue();
+        for (auto [requestID, dispatchedTicket] : mDispatchedRequests)
+        {
+            if (dispatchedTicket == ticket)
+            {
+                queue->abortRequest( requestID );
+                return;
+            }
+        }
+
+        // finished, but waiting for the completion budget; the listener must not be called anymore
+        auto completion = std::ranges::find_if(mCompletions, [ticket](const Completion& c)
+            { return any_cast<const ResourceResponse&>(c.response).request.ticket == ticket; });
+        if (completion != mCompletions.end())
+        {
+            mCompletions.erase(completion);
+            mOutstandingRequestSet.erase(ticket);
+        }
+    }
+    //------------------------------------------------------------------------
+    auto ResourceBackgroundQueue::updateRequestPriority(
+        BackgroundProcessTicket ticket, const RequestPriority& priority) -> bool
+    {
+        auto pending = mPendingRequests.find(ticket);
+        if (pending == mPendingRequests.end())
+            return false;
 
-        queue->abortRequest( ticket );
+        pending->second.priority = priority;
+        return true;
+    }
+    //------------------------------------------------------------------------
+    void ResourceBackgroundQueue::setMaxRequestsInFlight(size_t count)
+    {
+        mMaxRequestsInFlight = count;
+        dispatchRequests();
     }
     //------------------------------------------------------------------------
     auto ResourceBackgroundQueue::addRequest(ResourceRequest& req) -> BackgroundProcessTicket
+    {
+        req.ticket = ++mNextTicket;
+        mPendingRequests.emplace(req.ticket, PendingRequest{mRequestPriority, ::std::any(req)});
+        mOutstandingRequestSet.insert(req.ticket);
+
+        dispatchRequests();
+
+        return req.ticket;
+    }
+    //------------------------------------------------------------------------
+    void ResourceBackgroundQueue::dispatchRequests()
     {
         WorkQueue* queue = Root::getSingleton().getWorkQueue();
+        unsigned long frame = Root::getSingleton().getNextFrameNumber();
 
-        ::std::any data(req);
+        while (!mPendingRequests.empty() &&
+               (!mMaxRequestsInFlight || mDispatchedRequests.size() < mMaxRequestsInFlight))
+        {
+            // a linear search, as priorities are updated in place; later tickets only win on a better priority
+            auto next = mPendingRequests.begin();
+            for (auto it = std::next(next); it != mPendingRequests.end(); ++it)
+                if (isBefore(it->second.priority, next->second.priority, frame))
+                    next = it;
 
-        WorkQueue::RequestID requestID = 
-            queue->addRequest(mWorkQueueChannel, (uint16)req.type, data);
+            BackgroundProcessTicket ticket = next->first;
+            ::std::any data = std::move(next->second.request);
+            mPendingRequests.erase(next);
 
+            auto type = any_cast<const ResourceRequest&>(data).type;
+            WorkQueue::RequestID requestID = queue->addRequest(mWorkQueueChannel, (uint16)type, data);
+            if (requestID)
+                mDispatchedRequests.emplace(requestID, ticket);
+            else
+            {
+                // the queue does not accept requests
+                releaseRequest(data);
+                mOutstandingRequestSet.erase(ticket);
+            }
+        }
+    }
+    //------------------------------------------------------------------------
+    void ResourceBackgroundQueue::_update()
+    {
+        unsigned long frame = Root::getSingleton().getNextFrameNumber();
+        std::vector<std::pair<BackgroundProcessTicket, Listener*>> expired;
+        for (auto it = mPendingRequests.begin(); it != mPendingRequests.end();)
+        {
+            if (it->second.priority.expiry && it->second.priority.expiry < frame)
+            {
+                expired.emplace_back(it->first, any_cast<const ResourceRequest&>(it->second.request).listener);
+                releaseRequest(it->second.request);
+                mOutstandingRequestSet.erase(it->first);
+                it = mPendingRequests.erase(it);
+            }
+            else
+                ++it;
+        }
 
-        mOutstandingRequestSet.insert(requestID);
+        // notify once the queue is consistent, listeners may queue new requests
+        BackgroundProcessResult result{true, "Request expired before it was dispatched"};
+        for (auto [ticket, listener] : expired)
+            if (listener)
+                listener->operationCompleted(ticket, result);
 
-        return requestID;
+        dispatchRequests();
+        processCompletions();
+    }
+    //------------------------------------------------------------------------
+    void ResourceBackgroundQueue::processCompletions()
+    {
+        Root& root = Root::getSingleton();
+        if (root.getNextFrameNumber() != mBudgetFrame)
+        {
+            mBudgetFrame = root.getNextFrameNumber();
+            mBudgetUsedMicros = 0;
+        }
+
+        while (!mCompletions.empty() && (!mCompletionBudget || mBudgetUsedMicros < mCompletionBudget * 1000))
+        {
+            unsigned long start = root.getTimer()->getMicroseconds();
+            Completion completion = std::move(mCompletions.front());
+            mCompletions.pop_front();
+            completeRequest(completion);
+            mBudgetUsedMicros += root.getTimer()->getMicroseconds() - start;
+        }
     }
     //-----------------------------------------------------------------------
     auto ResourceBackgroundQueue::canHandleRequest(const WorkQueue::Request* req, const WorkQueue* srcQ) -> bool
@@ -368,20 +520,42 @@ namespace Ogre {
     //------------------------------------------------------------------------
     void ResourceBackgroundQueue::handleResponse(const WorkQueue::Response* res, const WorkQueue* srcQ)
     {
+        auto dispatched = mDispatchedRequests.find(res->getRequest()->getID());
+        if (dispatched == mDispatchedRequests.end())
+            return;
+
+        BackgroundProcessTicket ticket = dispatched->second;
+        mDispatchedRequests.erase(dispatched);
+        // a place in the WorkQueue is free
+        dispatchRequests();
+
         if( res->getRequest()->getAborted() )
         {
-            mOutstandingRequestSet.erase(res->getRequest()->getID());
+            mOutstandingRequestSet.erase(ticket);
             return ;
         }
 
-        auto resresp = any_cast<ResourceResponse>(res->getData());
+        mCompletions.push_back({res->succeeded(), res->getData()});
+        if (mCompletionBudget)
+            processCompletions();
+        else
+        {
+            Completion completion = std::move(mCompletions.back());
+            mCompletions.pop_back();
+            completeRequest(completion);
+        }
+    }
+    //------------------------------------------------------------------------
+    void ResourceBackgroundQueue::completeRequest(const Completion& completion)
+    {
+        auto resresp = any_cast<ResourceResponse>(completion.response);
 
         // Complete full loading in main thread if semithreading
         const ResourceRequest& req = resresp.request;
 
-        if (res->succeeded())
+        if (completion.succeeded)
         {
-            mOutstandingRequestSet.erase(res->getRequest()->getID());
+            mOutstandingRequestSet.erase(req.ticket);
 
             // Call resource listener
             if (resresp.resource) 
@@ -399,7 +573,7 @@ namespace Ogre {
         }
         // Call queue listener
         if (req.listener)
-            req.listener->operationCompleted(res->getRequest()->getID(), req.result);
+            req.listener->operationCompleted(req.ticket, req.result);
     }
     //------------------------------------------------------------------------
 
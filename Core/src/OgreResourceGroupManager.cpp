@@ -38,30 +38,59 @@ import :DataStream;
 import :Exception;
 import :Log;
 import :LogManager;
+import :MaterialManager;
 import :Platform;
 import :Prerequisites;
 import :Resource;
 import :ResourceGroupManager;
 import :ResourceManager;
+import :Root;
 import :ScriptLoader;
 import :SharedPtr;
 import :Singleton;
+import :StartupProfiler;
 import :String;
 import :StringVector;
+import :WorkQueue;
 
+import <algorithm>;
+import <any>;
+import <atomic>;
+import <charconv>;
 import <format>;
+import <fstream>;
 import <iterator>;
 import <list>;
 import <map>;
 import <memory>;
+import <mutex>;
 import <ostream>;
 import <ranges>;
+import <set>;
 import <string>;
 import <utility>;
 import <vector>;
 
 namespace Ogre {
 
+    namespace {
+        constexpr std::string_view RESOURCE_INDEX_HEADER = "OgreResourceIndex 1";
+
+        auto hashResourceName(std::string_view name) -> uint32
+        {
+            return FastHash(name.data(), name.size());
+        }
+
+        auto getLocationKey(const Archive* arch) -> std::string
+        {
+            return ::std::format("{}:{}", arch->getType(), arch->getName());
+        }
+
+        auto getLocationTime(const Archive* arch) -> int64
+        {
+            return static_cast<int64>(arch->getModifiedTime("").time_since_epoch().count());
+        }
+    }
     //-----------------------------------------------------------------------
     template<> ResourceGroupManager* Singleton<ResourceGroupManager>::msSingleton = nullptr;
     auto ResourceGroupManager::getSingletonPtr() noexcept -> ResourceGroupManager*
@@ -104,6 +133,7 @@ namespace Ogre {
     void ResourceGroupManager::createResourceGroup(std::string_view name, bool inGlobalPool)
     {
         LogManager::getSingleton().logMessage(::std::format("Creating resource group {}", name));
+        std::unique_lock<std::recursive_mutex> lock(mResourceGroupsMutex);
         if (getResourceGroup(name))
         {
             OGRE_EXCEPT(ExceptionCodes::DUPLICATE_ITEM, 
@@ -126,6 +156,7 @@ namespace Ogre {
 
         if (grp->groupStatus == ResourceGroup::Status::UNINITIALSED)
         {
+            StartupProfiler::Scope phase{StartupProfiler::PhaseType::RESOURCE_GROUP, name};
             // in the process of initialising
             grp->groupStatus = ResourceGroup::Status::INITIALISING;
             // Set current group
@@ -147,6 +178,7 @@ namespace Ogre {
         {
             if (grp->groupStatus == ResourceGroup::Status::UNINITIALSED)
             {
+                StartupProfiler::Scope phase{StartupProfiler::PhaseType::RESOURCE_GROUP, key};
                 // in the process of initialising
                 grp->groupStatus = ResourceGroup::Status::INITIALISING;
                 // Set current group
@@ -179,7 +211,11 @@ namespace Ogre {
 
         fireResourceGroupPrepareStarted(name, resourceCount);
 
-        // Now load for real
+        if (mParallelPreparation && name != AUTODETECT_RESOURCE_GROUP_NAME)
+            prepareResourcesParallel(grp);
+
+        // Now load for real, resources prepared above are skipped here
+        // but still need their events
         for (auto const& [key, value] : grp->loadResourceOrderMap)
         {
             size_t n = 0;
@@ -224,6 +260,57 @@ namespace Ogre {
         LogManager::getSingleton().logMessage(::std::format("Finished preparing resource group {}", name));
     }
     //-----------------------------------------------------------------------
+    void ResourceGroupManager::prepareResourcesParallel(ResourceGroup* grp)
+    {
+        auto root = Root::getSingletonPtr();
+        WorkQueue* queue = root ? root->getWorkQueue() : nullptr;
+        if (!queue)
+            return;
+
+        std::set<Resource*> processed;
+        for (auto const& [key, value] : grp->loadResourceOrderMap)
+        {
+            // cascade-prepared resources of the same order get appended, go on until there are no new ones
+            for (;;)
+            {
+                std::vector<ResourcePtr> batch;
+                for (const auto& res : value)
+                {
+                    if (processed.insert(res.get()).second)
+                        batch.push_back(res);
+                }
+                if (batch.empty())
+                    break;
+
+                // the lists we iterate must not grow under the workers
+                mDeferCreatedResources = true;
+                try
+                {
+                    queue->parallelFor(batch.size(), [&batch](size_t i) { batch[i]->prepare(); });
+                }
+                catch (...)
+                {
+                    mergeDeferredCreatedResources();
+                    throw;
+                }
+                mergeDeferredCreatedResources();
+            }
+        }
+    }
+    //-----------------------------------------------------------------------
+    void ResourceGroupManager::mergeDeferredCreatedResources()
+    {
+        mDeferCreatedResources = false;
+
+        std::vector<ResourcePtr> created;
+        {
+            std::unique_lock<std::mutex> lock(mDeferredCreatedResourcesMutex);
+            std::swap(created, mDeferredCreatedResources);
+        }
+        for (auto& res : created)
+            _notifyResourceCreated(res);
+    }
+    //-----------------------------------------------------------------------
     void ResourceGroupManager::loadResourceGroup(std::string_view name)
     {
         LogManager::getSingleton().stream() << "Loading resource group '" << name << "'";
@@ -241,6 +328,10 @@ namespace Ogre {
 
         fireResourceGroupLoadStarted(name, resourceCount);
 
+        // the CPU side work, the GPU side load below stays on this thread
+        if (mParallelPreparation && name != AUTODETECT_RESOURCE_GROUP_NAME)
+            prepareResourcesParallel(grp);
+
         // Now load for real
         for (auto const& [key, value] : grp->loadResourceOrderMap)
         {
@@ -375,7 +466,10 @@ namespace Ogre {
         unloadResourceGroup(name, false); // will throw an exception if name not valid
         dropGroupContents(grp);
         deleteGroup(grp);
-        mResourceGroupMap.erase(mResourceGroupMap.find(name));
+        {
+            std::unique_lock<std::recursive_mutex> lock(mResourceGroupsMutex);
+            mResourceGroupMap.erase(mResourceGroupMap.find(name));
+        }
         // reset current group
         mCurrentGroup = nullptr;
     }
@@ -422,7 +516,15 @@ namespace Ogre {
         // Add to location list
 
         ResourceLocation loc = {pArch, recursive};
-        StringVectorPtr vec = pArch->find("*", recursive);
+
+        // take the names from the cache if the archive is unchanged
+        StringVectorPtr vec;
+        auto cached = mCachedLocations.find(getLocationKey(pArch));
+        if (cached != mCachedLocations.end() && cached->second.recursive == recursive &&
+            cached->second.modifiedTime == getLocationTime(pArch))
+            vec = StringVectorPtr(new StringVector(cached->second.names));
+        else
+            vec = pArch->find("*", recursive);
 
         ResourceGroup* grp = getResourceGroup(resGroup);
         if (!grp)
@@ -435,7 +537,10 @@ namespace Ogre {
 
         // Index resources
         for(auto & it : *vec)
-            grp->addToIndex(it, pArch);
+            mResourceIndex.add(it, grp, pArch);
+
+        for (auto const& dcl : pArch->getResourceDeclarations())
+            declareResource(dcl.name, dcl.resourceType, resGroup);
         
         StringStream msg;
         msg << "Added resource location '" << name << "' of type '" << locType
@@ -457,7 +562,7 @@ namespace Ogre {
             Archive* pArch = li->archive;
             if (pArch->getName() == name)
             {
-                grp->removeFromIndex(pArch);
+                mResourceIndex.remove(grp, pArch);
                 grp->locationList.erase(li);
                 ArchiveManager::getSingleton().unload(pArch);
                 break;
@@ -609,7 +714,7 @@ namespace Ogre {
                 
                 // create it
                 DataStreamPtr ret = arch->create(filename);
-                grp->addToIndex(filename, arch);
+                mResourceIndex.add(filename, grp, arch);
 
 
                 return ret;
@@ -638,7 +743,7 @@ namespace Ogre {
                 if (arch->exists(filename))
                 {
                     arch->remove(filename);
-                    grp->removeFromIndex(filename, arch);
+                    mResourceIndex.remove(filename, grp, arch);
 
                     // only remove one file
                     break;
@@ -665,7 +770,7 @@ namespace Ogre {
                 for (auto & f : *matchingFiles)
                 {
                     arch->remove(f);
-                    grp->removeFromIndex(f, arch);
+                    mResourceIndex.remove(f, grp, arch);
 
                 }
             }
@@ -784,13 +889,60 @@ namespace Ogre {
         // Fire scripting event
         fireResourceGroupScriptingStarted(grp->name, scriptCount);
 
+        // Copy the scripts to memory and let the loaders lex and parse them on the worker threads
+        // first, large files are only opened when their turn is
+        struct PreparedScript
+        {
+            DataStreamPtr stream;
+            std::any prepared;
+        };
+        std::vector<std::vector<PreparedScript>> preparedScripts(scriptLoaderFileList.size());
+        std::vector<std::pair<ScriptLoader*, PreparedScript*>> batch;
+        auto root = Root::getSingletonPtr();
+        WorkQueue* queue = root ? root->getWorkQueue() : nullptr;
+        if (queue && scriptCount > 1)
+        {
+            for (size_t i = 0; i < scriptLoaderFileList.size(); ++i)
+            {
+                auto const& [su, item] = scriptLoaderFileList[i];
+                preparedScripts[i].resize(item.size());
+                for (size_t j = 0; j < item.size(); ++j)
+                {
+                    const FileInfo& fii = item[j];
+                    if (fii.uncompressedSize > 1024 * 1024)
+                        continue;
+                    DataStreamPtr stream = fii.archive->open(fii.filename);
+                    if (!stream || stream->size() > 1024 * 1024)
+                        continue;
+                    preparedScripts[i][j].stream.reset(new MemoryDataStream(stream->getName(), stream));
+                    batch.emplace_back(su, &preparedScripts[i][j]);
+                }
+            }
+
+            queue->parallelFor(batch.size(), [&batch](size_t i) {
+                auto [su, script] = batch[i];
+                StartupProfiler::Scope phase{StartupProfiler::PhaseType::SCRIPT_PARSE, script->stream->getName()};
+                try
+                {
+                    script->prepared = su->_prepareScript(script->stream);
+                }
+                catch (...)
+                {
+                    // parseScript reports it again, in order
+                    script->stream->seek(0);
+                }
+            });
+        }
+
         // Iterate over scripts and parse
         // Note we respect original ordering
-        for (auto const& [su, item] : scriptLoaderFileList)
+        for (size_t i = 0; i < scriptLoaderFileList.size(); ++i)
         {
+            auto const& [su, item] = scriptLoaderFileList[i];
             // Iterate over each item in the list
-            for (auto & fii : item)
+            for (size_t j = 0; j < item.size(); ++j)
             {
+                const FileInfo& fii = item[j];
                 bool skipScript = false;
                 fireScriptStarted(fii.filename, skipScript);
                 if(skipScript)
@@ -802,13 +954,19 @@ namespace Ogre {
                 {
                     LogManager::getSingleton().logMessage(
                         ::std::format("Parsing script {}", fii.filename));
-                    DataStreamPtr stream = fii.archive->open(fii.filename);
+                    StartupProfiler::Scope phase{StartupProfiler::PhaseType::SCRIPT_PARSE, fii.filename};
+                    PreparedScript script;
+                    if (!preparedScripts[i].empty())
+                        script = std::move(preparedScripts[i][j]);
+                    DataStreamPtr stream = script.stream ? script.stream : fii.archive->open(fii.filename);
                     if (stream)
                     {
                         if (mLoadingListener)
                             mLoadingListener->resourceStreamOpened(fii.filename, grp->name, nullptr, stream);
 
-                        if(fii.archive->getType() == "FileSystem" && stream->size() <= 1024 * 1024)
+                        if (script.prepared.has_value() && stream == script.stream)
+                            su->_parsePreparedScript(stream, grp->name, script.prepared);
+                        else if(fii.archive->getType() == "FileSystem" && stream->size() <= 1024 * 1024)
                         {
                             DataStreamPtr cachedCopy(new MemoryDataStream(stream->getName(), stream));
                             su->parseScript(cachedCopy, grp->name);
@@ -839,6 +997,7 @@ namespace Ogre {
             ResourcePtr res = mgr->createResource(dcl.resourceName, grp->name,
                 dcl.loader != nullptr, dcl.loader, &dcl.parameters);
             // Add resource to load list
+            std::unique_lock<std::recursive_mutex> lock(mResourceGroupsMutex);
             auto li = 
                 grp->loadResourceOrderMap.find(mgr->getLoadingOrder());
 
@@ -852,18 +1011,29 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     void ResourceGroupManager::_notifyResourceCreated(ResourcePtr& res) const
     {
-        if (mCurrentGroup && res->getGroup() == mCurrentGroup->name)
+        if (mDeferCreatedResources)
         {
-            // Use current group (batch loading)
-            addCreatedResource(res, *mCurrentGroup);
+            std::unique_lock<std::mutex> lock(mDeferredCreatedResourcesMutex);
+            mDeferredCreatedResources.push_back(res);
+            return;
         }
-        else
+
         {
-            // Find group
-            ResourceGroup* grp = getResourceGroup(res->getGroup());
-            if (grp)
+            std::unique_lock<std::recursive_mutex> lock(mResourceGroupsMutex);
+            ResourceGroup* currentGroup = mCurrentGroup;
+            if (currentGroup && res->getGroup() == currentGroup->name)
+            {
+                // Use current group (batch loading)
+                addCreatedResource(res, *currentGroup);
+            }
+            else
             {
-                addCreatedResource(res, *grp);
+                // Find group
+                ResourceGroup* grp = getResourceGroup(res->getGroup());
+                if (grp)
+                {
+                    addCreatedResource(res, *grp);
+                }
             }
         }
 
@@ -874,7 +1044,9 @@ namespace Ogre {
     {
         fireResourceRemove(res);
 
-        if (mCurrentGroup && res->getGroup() == mCurrentGroup->name)
+        std::unique_lock<std::recursive_mutex> lock(mResourceGroupsMutex);
+        ResourceGroup* currentGroup = mCurrentGroup;
+        if (currentGroup && res->getGroup() == currentGroup->name)
         {
             // Do nothing - we're batch unloading so list will be cleared
         }
@@ -910,6 +1082,7 @@ namespace Ogre {
         Resource* res) const
     {
         ResourcePtr resPtr;
+        std::unique_lock<std::recursive_mutex> lock(mResourceGroupsMutex);
     
         // find old entry
         ResourceGroup* grp = getResourceGroup(oldGroup);
@@ -944,6 +1117,7 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     void ResourceGroupManager::_notifyAllResourcesRemoved(ResourceManager* manager) const
     {
+        std::unique_lock<std::recursive_mutex> lock(mResourceGroupsMutex);
         // Iterate over all groups
         for (const auto & grpi : mResourceGroupMap)
         {
@@ -984,6 +1158,7 @@ namespace Ogre {
     auto ResourceGroupManager::getResourceGroup(std::string_view name,
                                                                                 bool throwOnFailure) const -> ResourceGroupManager::ResourceGroup*
     {
+        std::unique_lock<std::recursive_mutex> lock(mResourceGroupsMutex);
         auto i = mResourceGroupMap.find(name);
 
         if (i == mResourceGroupMap.end())
@@ -1029,6 +1204,9 @@ namespace Ogre {
             }
         }
         grp->loadResourceOrderMap.clear();
+        // and the material scripts that were not looked up yet
+        if (MaterialManager* materialManager = MaterialManager::getSingletonPtr())
+            materialManager->_dropDeferredMaterials(grp->name);
 
         if (groupSet)
         {
@@ -1040,6 +1218,7 @@ namespace Ogre {
     {
         // delete all the load list entries
         grp->loadResourceOrderMap.clear();
+        mResourceIndex.remove(grp, nullptr);
 
         // delete ResourceGroup
         delete grp;
@@ -1250,15 +1429,7 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     auto ResourceGroupManager::resourceExists(ResourceGroup* grp, std::string_view resourceName) const -> Archive*
     {
-        // Try indexes first
-        auto rit = grp->resourceIndexCaseSensitive.find(resourceName);
-        if (rit != grp->resourceIndexCaseSensitive.end())
-        {
-            // Found in the index
-            return rit->second;
-        }
-
-        return nullptr;
+        return mResourceIndex.find(resourceName, grp);
     }
     //-----------------------------------------------------------------------
     auto ResourceGroupManager::resourceModifiedTime(std::string_view groupName, std::string_view resourceName) const -> std::filesystem::file_time_type
@@ -1284,15 +1455,14 @@ namespace Ogre {
     {
         OgreAssert(!filename.empty(), "resourceName is empty string");
 
-            // Iterate over resource groups and find
-        for (const auto & i : mResourceGroupMap)
-        {
-            Archive* arch = resourceExists(i.second, filename);
-            if (arch)
-                return std::make_pair(arch, i.second);
-        }
-        // Not found
-        return {};
+        auto locations = mResourceIndex.find(filename);
+        if (!locations)
+            return {};
+
+        // the first group by name, as if searching the groups in turn
+        auto const& location = *std::ranges::min_element(
+            *locations, {}, [](const ResourceNameIndex::Location& l) -> std::string_view { return l.group->name; });
+        return std::make_pair(location.archive, location.group);
     }
     //-----------------------------------------------------------------------
     auto ResourceGroupManager::resourceExistsInAnyGroup(std::string_view filename) const -> bool
@@ -1383,36 +1553,190 @@ namespace Ogre {
         return mLoadingListener;
     }
     //---------------------------------------------------------------------
+    void ResourceGroupManager::saveResourceIndex(std::string_view path) const
+    {
+        std::map<std::pair<const ResourceGroup*, const Archive*>, StringVector> names;
+        mResourceIndex.forEach([&names](std::string_view name, const ResourceNameIndex::Location& location)
+                               { names[{location.group, location.archive}].emplace_back(name); });
+
+        std::ofstream out{std::string{path}};
+        if (!out)
+        {
+            OGRE_EXCEPT(ExceptionCodes::CANNOT_WRITE_TO_FILE, ::std::format("could not create {}", path),
+                "ResourceGroupManager::saveResourceIndex");
+        }
+
+        // a line per location, followed by its names
+        out << RESOURCE_INDEX_HEADER << '\n';
+        for (auto const& [groupName, grp] : mResourceGroupMap)
+        {
+            for (auto const& loc : grp->locationList)
+            {
+                auto const& list = names[{grp, loc.archive}];
+                out << ::std::format("{}\t{}\t{}\t{}\n", getLocationKey(loc.archive), int(loc.recursive),
+                                     getLocationTime(loc.archive), list.size());
+                for (auto const& name : list)
+                    out << name << '\n';
+            }
+        }
+
+        if (!out)
+        {
+            OGRE_EXCEPT(ExceptionCodes::CANNOT_WRITE_TO_FILE, ::std::format("could not write {}", path),
+                "ResourceGroupManager::saveResourceIndex");
+        }
+    }
     //---------------------------------------------------------------------
-    void ResourceGroupManager::ResourceGroup::addToIndex(std::string_view filename, Archive* arch)
+    auto ResourceGroupManager::loadResourceIndex(std::string_view path) -> bool
     {
-        // internal, assumes mutex lock has already been obtained
-        this->resourceIndexCaseSensitive.emplace(filename, arch);
+        std::ifstream in{std::string{path}};
+        std::string line;
+        if (!std::getline(in, line) || line != RESOURCE_INDEX_HEADER)
+            return false;
+
+        std::map<std::string, CachedLocation, std::less<>> locations;
+        while (std::getline(in, line))
+        {
+            // the key may contain tabs, so split the other fields off the end
+            std::string_view fields[4];
+            std::string_view rest = line;
+            for (size_t i = 3; i > 0; --i)
+            {
+                auto tab = rest.rfind('\t');
+                if (tab == std::string_view::npos)
+                    return false;
+                fields[i] = rest.substr(tab + 1);
+                rest = rest.substr(0, tab);
+            }
+            fields[0] = rest;
+
+            std::string key{fields[0]};
+            CachedLocation location{fields[1] == "1", 0, {}};
+            size_t count = 0;
+            std::from_chars(fields[2].data(), fields[2].data() + fields[2].size(), location.modifiedTime);
+            std::from_chars(fields[3].data(), fields[3].data() + fields[3].size(), count);
+
+            for (size_t i = 0; i < count && std::getline(in, line); ++i)
+                location.names.push_back(line);
+            if (location.names.size() != count)
+                return false;
+
+            locations.emplace(std::move(key), std::move(location));
+        }
+
+        for (auto& [key, location] : locations)
+            mCachedLocations.insert_or_assign(key, std::move(location));
+
+        LogManager::getSingleton().logMessage(
+            ::std::format("Loaded resource index {} with {} locations", path, locations.size()));
+        return true;
+    }
+    //---------------------------------------------------------------------
+    //  ResourceNameIndex
+    //---------------------------------------------------------------------
+    auto ResourceGroupManager::ResourceNameIndex::findSlot(std::string_view name, uint32 hash) const -> size_t
+    {
+        // linear probing, the table always has free slots
+        size_t mask = mSlots.size() - 1;
+        size_t slot = hash & mask;
+        while (!mSlots[slot].locations.empty() && (mSlots[slot].hash != hash || mSlots[slot].name != name))
+            slot = (slot + 1) & mask;
+        return slot;
     }
     //---------------------------------------------------------------------
-    void ResourceGroupManager::ResourceGroup::removeFromIndex(std::string_view filename, Archive* arch)
+    void ResourceGroupManager::ResourceNameIndex::grow()
     {
-        // internal, assumes mutex lock has already been obtained
-        auto i = this->resourceIndexCaseSensitive.find(filename);
-        if (i != this->resourceIndexCaseSensitive.end() && i->second == arch)
-            this->resourceIndexCaseSensitive.erase(i);
+        std::vector<Slot> slots(std::max<size_t>(16, mSlots.size() * 2));
+        std::swap(slots, mSlots);
+        for (auto& slot : slots)
+            if (!slot.locations.empty())
+                mSlots[findSlot(slot.name, slot.hash)] = std::move(slot);
     }
     //---------------------------------------------------------------------
-    void ResourceGroupManager::ResourceGroup::removeFromIndex(Archive* arch)
+    void ResourceGroupManager::ResourceNameIndex::eraseSlot(size_t slot)
     {
-        // Delete indexes
-        for (auto rit = this->resourceIndexCaseSensitive.begin(); rit != this->resourceIndexCaseSensitive.end();)
+        size_t mask = mSlots.size() - 1;
+        mSlots[slot] = Slot{};
+        --mSize;
+
+        // backward shift the entries whose probe sequence passes the hole
+        for (size_t next = (slot + 1) & mask; !mSlots[next].locations.empty(); next = (next + 1) & mask)
         {
-            if (rit->second == arch)
+            size_t home = mSlots[next].hash & mask;
+            if (((next - home) & mask) >= ((next - slot) & mask))
             {
-                auto del = rit++;
-                this->resourceIndexCaseSensitive.erase(del);
+                mSlots[slot] = std::move(mSlots[next]);
+                mSlots[next] = Slot{};
+                slot = next;
             }
-            else
+        }
+    }
+    //---------------------------------------------------------------------
+    void ResourceGroupManager::ResourceNameIndex::add(std::string_view name, ResourceGroup* group, Archive* arch)
+    {
+        if ((mSize + 1) * 2 > mSlots.size())
+            grow();
+
+        uint32 hash = hashResourceName(name);
+        Slot& slot = mSlots[findSlot(name, hash)];
+        if (slot.locations.empty())
+        {
+            slot.name = name;
+            slot.hash = hash;
+            ++mSize;
+        }
+        else if (std::ranges::find(slot.locations, group, &Location::group) != slot.locations.end())
+            return;
+
+        slot.locations.push_back({group, arch});
+    }
+    //---------------------------------------------------------------------
+    void ResourceGroupManager::ResourceNameIndex::remove(std::string_view name, ResourceGroup* group, Archive* arch)
+    {
+        if (mSlots.empty())
+            return;
+
+        size_t slot = findSlot(name, hashResourceName(name));
+        auto& locations = mSlots[slot].locations;
+        if (!locations.empty() &&
+            std::erase_if(locations, [&](const Location& l) { return l.group == group && l.archive == arch; }) &&
+            locations.empty())
+            eraseSlot(slot);
+    }
+    //---------------------------------------------------------------------
+    void ResourceGroupManager::ResourceNameIndex::remove(const ResourceGroup* group, const Archive* arch)
+    {
+        for (size_t slot = 0; slot < mSlots.size();)
+        {
+            auto& locations = mSlots[slot].locations;
+            if (!locations.empty() &&
+                std::erase_if(locations, [&](const Location& l)
+                              { return l.group == group && (!arch || l.archive == arch); }) &&
+                locations.empty())
             {
-                ++rit;
+                // a following entry may have been shifted into this slot
+                eraseSlot(slot);
+                continue;
             }
+            ++slot;
         }
+    }
+    //---------------------------------------------------------------------
+    auto ResourceGroupManager::ResourceNameIndex::find(std::string_view name) const -> const Locations*
+    {
+        if (mSlots.empty())
+            return nullptr;
 
+        const Slot& slot = mSlots[findSlot(name, hashResourceName(name))];
+        return slot.locations.empty() ? nullptr : &slot.locations;
+    }
+    //---------------------------------------------------------------------
+    auto ResourceGroupManager::ResourceNameIndex::find(std::string_view name, const ResourceGroup* group) const -> Archive*
+    {
+        if (auto locations = find(name))
+            for (auto const& l : *locations)
+                if (l.group == group)
+                    return l.archive;
+        return nullptr;
     }
 }
@@ -27,14 +27,20 @@ THE SOFTWARE.
 */
 module Ogre.Core;
 
+import :Async;
 import :Exception;
 import :ResourceManager;
+import :Root;
 import :ScriptCompiler;
 import :StringConverter;
 
+import <algorithm>;
 import <format>;
 import <limits>;
+import <mutex>;
+import <shared_mutex>;
 import <utility>;
+import <vector>;
 
 namespace Ogre {
 
@@ -81,6 +87,8 @@ namespace Ogre {
         bool isManual, ManualResourceLoader* loader, 
         const NameValuePairList* params) -> ResourceManager::ResourceCreateOrRetrieveResult
     {
+        // another thread must not create the same resource between the lookup and the creation
+        std::scoped_lock lock{mCreateMutex};
         ResourcePtr res = getResourceByName(name, group);
         bool created = false;
         if (!res)
@@ -113,23 +121,36 @@ namespace Ogre {
         return r;
     }
     //-----------------------------------------------------------------------
+    auto ResourceManager::loadAsync(std::string_view name, std::string_view group, CancellationToken token)
+        -> ResourceAwaiter<Resource>
+    {
+        return {true, mResourceType, name, group, std::move(token)};
+    }
+    //-----------------------------------------------------------------------
+    auto ResourceManager::prepareAsync(std::string_view name, std::string_view group, CancellationToken token)
+        -> ResourceAwaiter<Resource>
+    {
+        return {false, mResourceType, name, group, std::move(token)};
+    }
+    //-----------------------------------------------------------------------
     void ResourceManager::addImpl( ResourcePtr& res )
     {
-            std::pair<ResourceMap::iterator, bool> result;
-        if(ResourceGroupManager::getSingleton().isResourceGroupInGlobalPool(res->getGroup()))
-        {
-            result = mResources.emplace(res->getName(), res);
-        }
-        else
+        bool inGlobalPool = ResourceGroupManager::getSingleton().isResourceGroupInGlobalPool(res->getGroup());
+        auto insert = [&]() -> bool
         {
+            std::unique_lock lock{mResourcesMutex};
+            if (inGlobalPool)
+                return mResources.emplace(res->getName(), res).second;
+
             // we will create the group if it doesn't exists in our list
             auto resgroup = mResourcesWithGroup.emplace(res->getGroup(), ResourceMap()).first;
-            result = resgroup->second.emplace(res->getName(), res);
-        }
+            return resgroup->second.emplace(res->getName(), res).second;
+        };
+        bool inserted = insert();
 
-        // Attempt to resolve the collision
+        // Attempt to resolve the collision, without the lock as the listener may look up resources
         ResourceLoadingListener* listener = ResourceGroupManager::getSingleton().getLoadingListener();
-        if (!result.second && listener)
+        if (!inserted && listener)
         {
             if(listener->resourceCollision(res.get(), this) == false)
             {
@@ -139,18 +160,10 @@ namespace Ogre {
             }
 
             // Try to do the addition again, no seconds attempts to resolve collisions are allowed
-            if(ResourceGroupManager::getSingleton().isResourceGroupInGlobalPool(res->getGroup()))
-            {
-                result = mResources.emplace(res->getName(), res);
-            }
-            else
-            {
-                auto resgroup = mResourcesWithGroup.emplace(res->getGroup(), ResourceMap()).first;
-                result = resgroup->second.emplace(res->getName(), res);
-            }
+            inserted = insert();
         }
 
-        if (!result.second)
+        if (!inserted)
         {
             OGRE_EXCEPT(ExceptionCodes::DUPLICATE_ITEM,
                         ::std::format("{} with the name {} already exists.", getResourceType(), res->getName()),
@@ -158,6 +171,7 @@ namespace Ogre {
         }
 
         // Insert the handle
+        std::unique_lock lock{mResourcesMutex};
         std::pair<ResourceHandleMap::iterator, bool> resultHandle = mResourcesByHandle.emplace(res->getHandle(), res);
         if (!resultHandle.second)
         {
@@ -171,9 +185,12 @@ namespace Ogre {
     {
         OgreAssert(res, "attempting to remove nullptr");
 
-        if(ResourceGroupManager::getSingleton().isResourceGroupInGlobalPool(res->getGroup()))
+        // res may be one of the entries, and the last reference goes after unlocking
+        ResourcePtr keepAlive = res;
+        std::unique_lock lock{mResourcesMutex};
+        if(ResourceGroupManager::getSingleton().isResourceGroupInGlobalPool(keepAlive->getGroup()))
         {
-            auto nameIt = mResources.find(res->getName());
+            auto nameIt = mResources.find(keepAlive->getName());
             if (nameIt != mResources.end())
             {
                 mResources.erase(nameIt);
@@ -181,10 +198,10 @@ namespace Ogre {
         }
         else
         {
-            auto groupIt = mResourcesWithGroup.find(res->getGroup());
+            auto groupIt = mResourcesWithGroup.find(keepAlive->getGroup());
             if (groupIt != mResourcesWithGroup.end())
             {
-                auto nameIt = groupIt->second.find(res->getName());
+                auto nameIt = groupIt->second.find(keepAlive->getName());
                 if (nameIt != groupIt->second.end())
                 {
                     groupIt->second.erase(nameIt);
@@ -197,13 +214,14 @@ namespace Ogre {
             }
         }
 
-        auto handleIt = mResourcesByHandle.find(res->getHandle());
+        auto handleIt = mResourcesByHandle.find(keepAlive->getHandle());
         if (handleIt != mResourcesByHandle.end())
         {
             mResourcesByHandle.erase(handleIt);
         }
+        lock.unlock();
         // Tell resource group manager
-        ResourceGroupManager::getSingleton()._notifyResourceRemoved(res);
+        ResourceGroupManager::getSingleton()._notifyResourceRemoved(keepAlive);
     }
     //-----------------------------------------------------------------------
     void ResourceManager::setMemoryBudget( size_t bytes)
@@ -249,17 +267,16 @@ namespace Ogre {
         bool reloadableOnly = (flags & Resource::LoadingFlags::INCLUDE_NON_RELOADABLE) == Resource::LoadingFlags{};
         bool unreferencedOnly = (flags & Resource::LoadingFlags::ONLY_UNREFERENCED) != Resource::LoadingFlags{};
 
-        for (auto const& [key, res] : mResources)
+        // A use count of 3 means that only RGM and RM have references
+        // RGM has one (this one) and RM has 2 (by name and by handle)
+        auto candidates = collectResources([=](const ResourcePtr& res)
         {
-            // A use count of 3 means that only RGM and RM have references
-            // RGM has one (this one) and RM has 2 (by name and by handle)
-            if (!unreferencedOnly || res.use_count() == ResourceGroupManager::RESOURCE_SYSTEM_NUM_REFERENCE_COUNTS)
-            {
-                if (!reloadableOnly || res->isReloadable())
-                {
-                    res->unload();
-                }
-            }
+            return (!unreferencedOnly || res.use_count() == ResourceGroupManager::RESOURCE_SYSTEM_NUM_REFERENCE_COUNTS) &&
+                   (!reloadableOnly || res->isReloadable());
+        });
+        for (auto const& res : candidates)
+        {
+            res->unload();
         }
     }
     //-----------------------------------------------------------------------
@@ -268,17 +285,16 @@ namespace Ogre {
         bool reloadableOnly = (flags & Resource::LoadingFlags::INCLUDE_NON_RELOADABLE) == Resource::LoadingFlags{};
         bool unreferencedOnly = (flags & Resource::LoadingFlags::ONLY_UNREFERENCED) != Resource::LoadingFlags{};
 
-        for (auto const& [key, res] : mResources)
+        // A use count of 3 means that only RGM and RM have references
+        // RGM has one (this one) and RM has 2 (by name and by handle)
+        auto candidates = collectResources([=](const ResourcePtr& res)
         {
-            // A use count of 3 means that only RGM and RM have references
-            // RGM has one (this one) and RM has 2 (by name and by handle)
-            if (!unreferencedOnly || res.use_count() == ResourceGroupManager::RESOURCE_SYSTEM_NUM_REFERENCE_COUNTS)
-            {
-                if (!reloadableOnly || res->isReloadable())
-                {
-                    res->reload(flags);
-                }
-            }
+            return (!unreferencedOnly || res.use_count() == ResourceGroupManager::RESOURCE_SYSTEM_NUM_REFERENCE_COUNTS) &&
+                   (!reloadableOnly || res->isReloadable());
+        });
+        for (auto const& res : candidates)
+        {
+            res->reload(flags);
         }
     }
     //-----------------------------------------------------------------------
@@ -315,31 +331,32 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     void ResourceManager::removeAll()
     {
-        mResources.clear();
-        mResourcesWithGroup.clear();
-        mResourcesByHandle.clear();
+        // destroy the resources after unlocking
+        ResourceMap resources;
+        ResourceWithGroupMap resourcesWithGroup;
+        ResourceHandleMap resourcesByHandle;
+        {
+            std::unique_lock lock{mResourcesMutex};
+            mResources.swap(resources);
+            mResourcesWithGroup.swap(resourcesWithGroup);
+            mResourcesByHandle.swap(resourcesByHandle);
+        }
         // Notify resource group manager
         ResourceGroupManager::getSingleton()._notifyAllResourcesRemoved(this);
     }
     //-----------------------------------------------------------------------
     void ResourceManager::removeUnreferencedResources(bool reloadableOnly)
     {
-        for (auto i = mResources.begin(); i != mResources.end(); )
+        // A use count of 3 means that only RGM and RM have references
+        // RGM has one (this one) and RM has 2 (by name and by handle)
+        auto candidates = collectResources([=](const ResourcePtr& res)
         {
-            // A use count of 3 means that only RGM and RM have references
-            // RGM has one (this one) and RM has 2 (by name and by handle)
-            if (i->second.use_count() == ResourceGroupManager::RESOURCE_SYSTEM_NUM_REFERENCE_COUNTS)
-            {
-                Resource* res = (i++)->second.get();
-                if (!reloadableOnly || res->isReloadable())
-                {
-                    remove( res->getHandle() );
-                }
-            }
-            else
-            {
-                ++i;
-            }
+            return res.use_count() == ResourceGroupManager::RESOURCE_SYSTEM_NUM_REFERENCE_COUNTS &&
+                   (!reloadableOnly || res->isReloadable());
+        });
+        for (auto const& res : candidates)
+        {
+            remove(res->getHandle());
         }
     }
     //-----------------------------------------------------------------------
@@ -347,6 +364,7 @@ namespace Ogre {
     {
         // resource should be in global pool
         bool isGlobal = ResourceGroupManager::getSingleton().isResourceGroupInGlobalPool(groupName);
+        std::shared_lock lock{mResourcesMutex};
 
         if(isGlobal)
         {
@@ -390,6 +408,7 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     auto ResourceManager::getByHandle(ResourceHandle handle) const -> ResourcePtr
     {
+        std::shared_lock lock{mResourcesMutex};
         auto it = mResourcesByHandle.find(handle);
         return it == mResourcesByHandle.end() ? ResourcePtr() : it->second;
     }
@@ -402,30 +421,40 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     void ResourceManager::checkUsage()
     {
-        if (getMemoryUsage() > mMemoryBudget)
+        if (getMemoryUsage() <= mMemoryBudget)
+            return;
+
+        // A use count of 3 means that only RGM and RM have references
+        // RGM has one (this one) and RM has 2 (by name and by handle)
+        auto candidates = collectResources([](const ResourcePtr& res)
         {
-            // unload unreferenced resources until we are within our budget again
-            for (auto const& [key, res] : mResources)
-            {
-                if (getMemoryUsage() <= mMemoryBudget)
-                    break;
+            return res.use_count() == ResourceGroupManager::RESOURCE_SYSTEM_NUM_REFERENCE_COUNTS &&
+                   res->isReloadable() && res->isLoaded();
+        });
 
-                // A use count of 3 means that only RGM and RM have references
-                // RGM has one (this one) and RM has 2 (by name and by handle)
-                if (res.use_count() == ResourceGroupManager::RESOURCE_SYSTEM_NUM_REFERENCE_COUNTS)
-                {
-                    if (res->isReloadable())
-                    {
-                        res->unload();
-                    }
-                }
-            }
+        // unload unreferenced resources, least recently used first, until we are within our budget again
+        std::ranges::stable_sort(candidates, {}, &Resource::getLastUsedFrame);
+
+        auto root = Root::getSingletonPtr();
+        unsigned long frame = root ? root->getNextFrameNumber() : 0;
+        for (auto const& res : candidates)
+        {
+            if (getMemoryUsage() <= mMemoryBudget)
+                break;
+
+            // still in use, unloading would only make it reload
+            auto lastUsed = res->getLastUsedFrame();
+            if (lastUsed > 0 && lastUsed + 1 >= frame)
+                break;
+
+            res->unload();
         }
     }
     //-----------------------------------------------------------------------
     void ResourceManager::_notifyResourceTouched(Resource* res)
     {
-        // TODO
+        if (auto root = Root::getSingletonPtr())
+            res->_notifyUsed(root->getNextFrameNumber());
     }
     //-----------------------------------------------------------------------
     void ResourceManager::_notifyResourceLoaded(Resource* res)
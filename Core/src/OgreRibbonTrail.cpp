@@ -343,6 +343,7 @@ namespace Ogre
                 headElem.position = newPos;
                 done = true;
             }
+            markElementDirty(index, seg.head);
 
             // Is this segment full?
             if ((seg.tail + 1) % mMaxElementsPerChain == seg.head)
@@ -364,6 +365,7 @@ namespace Ogre
                     Real tailsize = mElemLength - diff.length();
                     taildiff *= tailsize / taillen;
                     tailElem.position = preTailElem.position + taildiff;
+                    markElementDirty(index, seg.tail);
                 }
 
             }
@@ -387,8 +389,11 @@ namespace Ogre
         for (size_t s = 0; s < mChainSegmentList.size(); ++s)
         {
             ChainSegment& seg = mChainSegmentList[s];
-            if (seg.head != SEGMENT_EMPTY && seg.head != seg.tail)
+            bool fading = mDeltaWidth[s] != 0 || mDeltaColour[s] != ColourValue::ZERO;
+            if (fading && seg.head != SEGMENT_EMPTY && seg.head != seg.tail)
             {
+                // every element changes
+                mVertexContentDirty = true;
                 
                 for(size_t e = seg.head + 1;; ++e) // until break
                 {
@@ -405,7 +410,6 @@ namespace Ogre
                 }
             }
         }
-        mVertexContentDirty = true;
     }
     //-----------------------------------------------------------------------
     void RibbonTrail::resetTrail(size_t index, const Node* node)
@@ -39,6 +39,7 @@ import :ArchiveManager;
 import :BillboardChain;
 import :BillboardSet;
 import :BuiltinMovableFactories;
+import :BundleArchive;
 import :Common;
 import :CompositorManager;
 import :ConfigDialog;
@@ -56,15 +57,19 @@ import :Exception;
 import :ExternalTextureSourceManager;
 import :FileSystem;
 import :FileSystemLayer;
+import :FrameAllocator;
 import :FrameListener;
 import :GpuProgramManager;
 import :HardwareBufferManager;
+import :HitchMonitor;
+import :KTX2Codec;
 import :Light;
 import :LodStrategyManager;
 import :LogManager;
 import :ManualObject;
 import :MaterialManager;
 import :Math;
+import :MemoryAllocatorConfig;
 import :MeshManager;
 import :MovableObject;
 import :ParticleSystemManager;
@@ -73,6 +78,7 @@ import :PlatformInformation;
 import :Plugin;
 import :Prerequisites;
 import :Profiler;
+import :QOICodec;
 import :RenderSystem;
 import :RenderSystemCapabilities;
 import :RenderSystemCapabilitiesManager;
@@ -85,11 +91,13 @@ import :Root;
 import :SceneManager;
 import :SceneManagerEnumerator;
 import :ScriptCompiler;
+import :ShaderTelemetry;
 import :ShadowTextureManager;
 import :ShadowVolumeExtrudeProgram;
 import :SharedPtr;
 import :Singleton;
 import :SkeletonManager;
+import :StartupProfiler;
 import :StaticGeometry;
 import :String;
 import :StringConverter;
@@ -103,6 +111,8 @@ import :Zip;
 import <algorithm>;
 import <deque>;
 import <format>;
+import <future>;
+import <iterator>;
 import <map>;
 import <memory>;
 import <ostream>;
@@ -136,6 +146,8 @@ namespace Ogre {
        
     {
         // superclass will do singleton checking
+        mStartupProfiler = std::make_unique<StartupProfiler>();
+        StartupProfiler::Scope phase{StartupProfiler::PhaseType::OTHER, "Root"};
 
         // Init
         mActiveRenderer = nullptr;
@@ -189,6 +201,8 @@ namespace Ogre {
 
         // Profiler
         mProfiler = std::make_unique<Profiler>();
+        mHitchMonitor = std::make_unique<HitchMonitor>();
+        mShaderTelemetry = std::make_unique<ShaderTelemetry>();
         Profiler::getSingleton().setTimer(mTimer.get());
 
         mFileSystemArchiveFactory = std::make_unique<FileSystemArchiveFactory>();
@@ -198,11 +212,15 @@ namespace Ogre {
         ArchiveManager::getSingleton().addArchiveFactory( mZipArchiveFactory.get() );
         mEmbeddedZipArchiveFactory = std::make_unique<EmbeddedZipArchiveFactory>();
         ArchiveManager::getSingleton().addArchiveFactory( mEmbeddedZipArchiveFactory.get() );
+        mBundleArchiveFactory = std::make_unique<BundleArchiveFactory>();
+        ArchiveManager::getSingleton().addArchiveFactory( mBundleArchiveFactory.get() );
 
         // Register image codecs
         DDSCodec::startup();
         ETCCodec::startup();
+        KTX2Codec::startup();
         ASTCCodec::startup();
+        QOICodec::startup();
 
         mGpuProgramManager = std::make_unique<GpuProgramManager>();
         mExternalTextureSourceManager = std::make_unique<ExternalTextureSourceManager>();
@@ -250,7 +268,9 @@ namespace Ogre {
 
         DDSCodec::shutdown();
         ETCCodec::shutdown();
+        KTX2Codec::shutdown();
         ASTCCodec::shutdown();
+        QOICodec::shutdown();
 
 		mCompositorManager.reset(); // needs rendersystem
         mParticleManager.reset(); // may use plugins
@@ -451,6 +471,7 @@ namespace Ogre {
     auto Root::initialise(bool autoCreateWindow, std::string_view windowTitle, std::string_view customCapabilitiesConfig) -> RenderWindow*
     {
         OgreAssert(mActiveRenderer, "Cannot initialise");
+        StartupProfiler::Scope phase{StartupProfiler::PhaseType::RENDER_SYSTEM_INIT, "Root::initialise"};
 
         if (!mControllerManager)
             mControllerManager = std::make_unique<ControllerManager>();
@@ -487,7 +508,11 @@ namespace Ogre {
 
 
         PlatformInformation::log(LogManager::getSingleton().getDefaultLog());
-        mActiveRenderer->_initialise();
+        {
+            StartupProfiler::Scope renderSystem{StartupProfiler::PhaseType::RENDER_SYSTEM_INIT,
+                                                mActiveRenderer->getName()};
+            mActiveRenderer->_initialise();
+        }
 
         // Initialise timer
         mTimer->reset();
@@ -584,6 +609,13 @@ namespace Ogre {
         mRemovedFrameListeners.insert(oldListener);
     }
     //-----------------------------------------------------------------------
+    void Root::setFrameSimulation(FrameSimulation* simulation)
+    {
+        if (mPendingSimulation.valid())
+            mPendingSimulation.get();
+        mFrameSimulation = simulation;
+    }
+    //-----------------------------------------------------------------------
     void Root::_syncAddedRemovedFrameListeners()
     {
         for (auto mRemovedFrameListener : mRemovedFrameListeners)
@@ -597,6 +629,20 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     auto Root::_fireFrameStarted(FrameEvent& evt) -> bool
     {
+        mFrameStartMicroseconds = mTimer->getMicroseconds();
+        if (mStartupProfiler->isRecording())
+            mStartupProfiler->finish();
+
+        // publish the state simulated during the last frame, rethrowing its errors
+        if (mPendingSimulation.valid())
+        {
+            mPendingSimulation.get();
+            mFrameSimulation->apply();
+        }
+
+        // nothing of the last frame is in flight anymore
+        mFrameAllocator.reset();
+
         _syncAddedRemovedFrameListeners();
 
         // Tell all listeners
@@ -609,6 +655,13 @@ namespace Ogre {
                 return false;
         }
 
+        // simulate the next frame while this one is rendered
+        if (mFrameSimulation)
+        {
+            mPendingSimulation = std::async(std::launch::async,
+                                            [simulation = mFrameSimulation, evt] { simulation->simulate(evt); });
+        }
+
         return true;
     }
     //-----------------------------------------------------------------------
@@ -655,6 +708,14 @@ namespace Ogre {
 
         // Tell the queue to process responses
         mWorkQueue->processResponses();
+        mResourceBackgroundQueue->_update();
+
+        // pair the profiles the threads recorded for a trace
+        mProfiler->_collectTrace();
+        mHitchMonitor->_frameEnded(mNextFrame - 1);
+
+        if (TextureManager::getSingletonPtr())
+            TextureManager::getSingleton()._updateMipStreaming();
 
         return ret;
     }
@@ -801,6 +862,11 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     void Root::shutdown()
     {
+        // the simulation must not outlive the frame it was started for
+        if (mPendingSimulation.valid())
+            mPendingSimulation.wait();
+        mPendingSimulation = {};
+
         if(mActiveRenderer)
             mActiveRenderer->_setViewport(nullptr);
 
@@ -875,7 +941,16 @@ namespace Ogre {
 
         for(auto & it : pluginList)
         {
-            loadPlugin(pluginDir + it);
+            it = pluginDir + it;
+        }
+
+        // the plugins are independent until they are started, so their libraries are
+        // opened at once, then started one after the other in the order of the file
+        DynLibManager::getSingleton().preload(pluginList);
+        for(auto & it : pluginList)
+        {
+            StartupProfiler::Scope phase{StartupProfiler::PhaseType::PLUGIN_LOAD, it};
+            loadPlugin(it);
         }
 
     }
@@ -976,6 +1051,7 @@ namespace Ogre {
                    "Cannot create window! Make sure to call Root::initialise before creating a window");
         OgreAssert(mActiveRenderer, "Cannot create window");
 
+        StartupProfiler::Scope phase{StartupProfiler::PhaseType::RENDER_SYSTEM_INIT, name};
         RenderWindow* ret;
         ret = mActiveRenderer->_createRenderWindow(name, width, height, fullScreen, miscParams);
 
@@ -1028,6 +1104,7 @@ namespace Ogre {
     void Root::installPlugin(Plugin* plugin)
     {
         LogManager::getSingleton().logMessage(::std::format("Installing plugin: {}", plugin->getName()));
+        StartupProfiler::Scope phase{StartupProfiler::PhaseType::PLUGIN_LOAD, plugin->getName()};
 
         mPlugins.push_back(plugin);
         plugin->install();
@@ -1059,11 +1136,42 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     void Root::loadPlugin(std::string_view pluginName)
     {
+        // Load plugin library
+        DynLib* lib = DynLibManager::getSingleton().load( pluginName );
+        // DynLibManager returns the existing entry if called 2+ times
+        if (std::ranges::find(mPluginLibs, lib) != mPluginLibs.end())
+            return;
+
+        #ifdef __GNUC__
+        __extension__
+        #endif
+        DLL_START_PLUGIN pFunc = reinterpret_cast<DLL_START_PLUGIN>(lib->getSymbol("dllStartPlugin"));
+        if (!pFunc)
+            OGRE_EXCEPT(ExceptionCodes::ITEM_NOT_FOUND,
+                        ::std::format("Cannot find symbol dllStartPlugin in library {}", pluginName),
+                        "Root::loadPlugin");
+
+        // Store for later unload
+        mPluginLibs.push_back(lib);
+        // This must call installPlugin
+        pFunc();
     }
     //-----------------------------------------------------------------------
     void Root::unloadPlugin(std::string_view pluginName)
     {
+        auto i = std::ranges::find(mPluginLibs, pluginName, &DynLib::getName);
+        if (i == mPluginLibs.end())
+            return;
 
+        #ifdef __GNUC__
+        __extension__
+        #endif
+        DLL_STOP_PLUGIN pFunc = reinterpret_cast<DLL_STOP_PLUGIN>((*i)->getSymbol("dllStopPlugin"));
+        // this will call uninstallPlugin
+        pFunc();
+        // Unload library & destroy
+        DynLibManager::getSingleton().unload(*i);
+        mPluginLibs.erase(i);
     }
     //-----------------------------------------------------------------------
     auto Root::getTimer() noexcept -> Timer*
@@ -1073,6 +1181,7 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     void Root::oneTimePostWindowInit()
     {
+        StartupProfiler::Scope phase{StartupProfiler::PhaseType::OTHER, "Root::oneTimePostWindowInit"};
         // log RenderSystem caps
         mActiveRenderer->getCapabilities()->log(LogManager::getSingleton().getDefaultLog());
 
@@ -1094,6 +1203,7 @@ namespace Ogre {
     {
         // update all targets but don't swap buffers
         mActiveRenderer->_updateAllRenderTargets(false);
+        publishRenderStats();
         // give client app opportunity to use queued GPU time
         bool ret = _fireFrameRenderingQueued();
         // block for final swap
@@ -1112,6 +1222,7 @@ namespace Ogre {
     {
         // update all targets but don't swap buffers
         mActiveRenderer->_updateAllRenderTargets(false);
+        publishRenderStats();
         // give client app opportunity to use queued GPU time
         bool ret = _fireFrameRenderingQueued(evt);
         // block for final swap
@@ -1126,6 +1237,45 @@ namespace Ogre {
         return ret;
     }
     //-----------------------------------------------------------------------
+    void Root::publishRenderStats()
+    {
+        // before the frame number advances, so the counters are those of this frame
+        if (!mProfiler->getEnabled())
+            return;
+
+        for (const auto & it : getSceneManagers())
+            it.second->_publishRenderLoopStats();
+
+        const RenderSystem::RenderStats& stats = mActiveRenderer->getRenderStats();
+        mProfiler->setCounter("RenderSystem/drawCalls", stats.drawCalls);
+        mProfiler->setCounter("RenderSystem/textureBinds", stats.textureBinds);
+        mProfiler->setCounter("RenderSystem/programBinds", stats.programBinds);
+        mProfiler->setCounter("RenderSystem/bufferUploads", stats.bufferUploads);
+        mProfiler->setCounter("RenderSystem/bytesUploaded", stats.bytesUploaded);
+        mProfiler->setCounter("Frame/cpuMicroseconds", mTimer->getMicroseconds() - mFrameStartMicroseconds);
+        mProfiler->setCounter("Frame/scratchBytes", mFrameAllocator.getUsed());
+
+        FrameString counter{&mFrameAllocator};
+        auto publish = [&](std::string_view category, std::string_view name, uint64 value)
+        {
+            counter.clear();
+            std::format_to(std::back_inserter(counter), "Memory/{}/{}", category, name);
+            mProfiler->setCounter(counter, value);
+        };
+        for (size_t i = 0; i < mLastMemoryStats.size(); ++i)
+        {
+            auto category = MemoryCategory(i);
+            MemoryTracker::Stats memory = MemoryTracker::getStats(category);
+            MemoryTracker::Stats& last = mLastMemoryStats[i];
+            std::string_view name = MemoryTracker::getCategoryName(category);
+            publish(name, "liveBytes", memory.liveBytes);
+            publish(name, "peakBytes", memory.peakBytes);
+            publish(name, "allocations", memory.allocations - last.allocations);
+            publish(name, "allocatedBytes", memory.allocatedBytes - last.allocatedBytes);
+            last = memory;
+        }
+    }
+    //-----------------------------------------------------------------------
     void Root::clearEventTimes()
     {
         // Clear event times
@@ -28,6 +28,8 @@ THE SOFTWARE.
 #ifndef OGRE_CORE_SIMDHELPER_H
 #define OGRE_CORE_SIMDHELPER_H
 
+#if defined(__i386__) || defined(__x86_64__)
+
 // Additional platform-dependent header files and declares.
 #include <xmmintrin.h>
 
@@ -219,4 +221,6 @@ namespace Ogre {
 
 }
 
+#endif // defined(__i386__) || defined(__x86_64__)
+
 #endif // OGRE_CORE_SIMDHELPER_H
@@ -45,11 +45,13 @@ import :ColourValue;
 import :Common;
 import :CompositorChain;
 import :CompositorInstance;
+import :CompositorManager;
 import :Config;
 import :ControllerManager;
 import :DefaultDebugDrawer;
 import :Entity;
 import :Exception;
+import :FrameAllocator;
 import :Frustum;
 import :GpuProgram;
 import :GpuProgramParams;
@@ -57,10 +59,12 @@ import :HardwareBuffer;
 import :HardwareBufferManager;
 import :HardwareIndexBuffer;
 import :HardwarePixelBuffer;
+import :HardwareVertexBuffer;
 import :InstanceBatch;
 import :InstanceManager;
 import :InstancedEntity;
 import :Light;
+import :LightGrid;
 import :LodListener;
 import :ManualObject;
 import :Material;
@@ -72,6 +76,8 @@ import :Mesh;
 import :MovableObject;
 import :NameGenerator;
 import :Node;
+import :NodeTransformSoA;
+import :OcclusionCulling;
 import :ParticleSystem;
 import :ParticleSystemManager;
 import :Pass;
@@ -79,6 +85,7 @@ import :Plane;
 import :PlaneBoundedVolume;
 import :Platform;
 import :Prerequisites;
+import :Profiler;
 import :Quaternion;
 import :Rectangle2D;
 import :RenderObjectListener;
@@ -96,31 +103,39 @@ import :Root;
 import :SceneManager;
 import :SceneNode;
 import :SceneQuery;
+import :ShaderTelemetry;
 import :SharedPtr;
+import :SkeletonPoseCache;
 import :Sphere;
 import :StaticGeometry;
 import :StringConverter;
 import :Technique;
 import :Texture;
 import :TextureUnitState;
+import :Timer;
 import :Vector;
 import :Viewport;
+import :WorkQueue;
 
 import <algorithm>;
+import <atomic>;
 import <format>;
 import <iterator>;
 import <limits>;
 import <list>;
 import <map>;
 import <memory>;
+import <mutex>;
 import <set>;
 import <string>;
 import <string_view>;
+import <thread>;
 import <utility>;
 import <vector>;
 
 namespace Ogre {
 static const std::string_view constexpr INVOCATION_SHADOWS = "SHADOWS";
+thread_local const Viewport* SceneManager::msCullingViewport = nullptr;
 //-----------------------------------------------------------------------
 SceneManager::SceneManager(std::string_view name) :
 mName(name),
@@ -160,6 +175,7 @@ SceneManager::~SceneManager()
     fireSceneManagerDestroyed();
     clearScene();
     destroyAllCameras();
+    destroyInstanceBuffer();
 }
 //-----------------------------------------------------------------------
 auto SceneManager::getRenderQueue() noexcept -> RenderQueue*
@@ -288,6 +304,14 @@ void SceneManager::destroyCamera(std::string_view name)
         if ( camLightIt != mShadowRenderer.mShadowCamLightMapping.end() )
             mShadowRenderer.mShadowCamLightMapping.erase( camLightIt );
 
+        for (auto stage : mVisibilityStages)
+            stage->_notifyCameraDestroyed(i->second);
+
+        if (mVisibleObjectsCache.camera == i->second)
+            mVisibleObjectsCache.camera = nullptr;
+
+        removeCameraGroup(i->second);
+
         // Notify render system
         if(mDestRenderSystem)
             mDestRenderSystem->_notifyCameraRemoved(i->second);
@@ -318,8 +342,9 @@ void SceneManager::destroyAllCameras()
             ++camIt;
         else 
         {
-            destroyCamera(camIt->second);
-            camIt = mCameras.begin(); // recreate iterator
+            // only the iterator of the destroyed camera is invalidated
+            Camera* cam = (camIt++)->second;
+            destroyCamera(cam);
         }
     }
 
@@ -371,8 +396,10 @@ auto SceneManager::lightLess::operator()(const Light* a, const Light* b) const -
 void SceneManager::_populateLightList(const Vector3& position, Real radius, 
                                       LightList& destList, QueryTypeMask lightMask)
 {
-    // Really basic trawl of the lights, then sort
-    // Subclasses could do something smarter
+    // below this, testing every light is as fast as the lookup
+    static const size_t constexpr MIN_GRID_LIGHTS = 16;
+    // per thread, as several SceneManagers may be updated at once
+    thread_local std::vector<uint32> msCandidates;
 
     // Pick up the lights that affecting frustum only, which should has been
     // cached, so better than take all lights in the scene into account.
@@ -385,21 +412,55 @@ void SceneManager::_populateLightList(const Vector3& position, Real radius,
     size_t lightIndex = 0;
     size_t numShadowTextures = isShadowTechniqueTextureBased() ? getShadowTextureConfigList().size() : 0;
 
-    for (Light* lt : candidateLights)
+    Sphere sphere{position, radius};
+    auto consider = [&](Light* lt)
     {
         // check whether or not this light is suppose to be taken into consideration for the current light mask set for this operation
         if(!(lt->getLightMask() & lightMask))
-            continue; //skip this light
+            return; //skip this light
 
         // Calc squared distance
         lt->_calcTempSquareDist(position);
 
         // only add in-range lights, but ensure texture shadow casters are there
         // note: in this case the first numShadowTextures canditate lights are casters
-        if (lightIndex++ < numShadowTextures || lt->isInLightRange(Sphere{position, radius}))
+        if (lightIndex++ < numShadowTextures || lt->isInLightRange(sphere))
         {
             destList.push_back(lt);
         }
+    };
+
+    bool useGrid = candidateLights.size() >= MIN_GRID_LIGHTS;
+    if (useGrid)
+    {
+        unsigned long frame = Root::getSingleton().getNextFrameNumber();
+        if (mLightGridDirtyCounter != mLightsDirtyCounter || mLightGridFrame != frame ||
+            mLightGrid.getNumLights() != candidateLights.size())
+        {
+            mLightGrid.build(candidateLights, Root::getSingleton().getFrameAllocator());
+            mLightGridDirtyCounter = mLightsDirtyCounter;
+            mLightGridFrame = frame;
+        }
+        useGrid = mLightGrid.findCandidates(sphere, msCandidates);
+    }
+
+    if (!useGrid)
+    {
+        for (Light* lt : candidateLights)
+            consider(lt);
+    }
+    else
+    {
+        // the shadow casters come first and are taken regardless of range
+        size_t i = 0;
+        for (; i < candidateLights.size() && lightIndex < numShadowTextures; ++i)
+            consider(candidateLights[i]);
+        // then the lights in range, in the same order as they are in the list
+        for (auto c : msCandidates)
+        {
+            if (c >= i)
+                consider(candidateLights[c]);
+        }
     }
 
     auto start = destList.begin();
@@ -471,6 +532,19 @@ auto SceneManager::createEntity(std::string_view entityName, const MeshPtr& pMes
     return createEntity(entityName, pMesh->getName(), pMesh->getGroup());
 }
 //---------------------------------------------------------------------
+auto SceneManager::createEntityInBackground(std::string_view entityName, std::string_view meshName,
+                                            std::string_view groupName, const AxisAlignedBox& proxyBounds) -> Entity*
+{
+    NameValuePairList params;
+    params["mesh"] = meshName;
+    params["resourceGroup"] = groupName;
+    params["backgroundLoad"] = "true";
+    auto* entity = static_cast<Entity*>(
+        createMovableObject(entityName, EntityFactory::FACTORY_TYPE_NAME, &params));
+    entity->setProxyBounds(proxyBounds);
+    return entity;
+}
+//---------------------------------------------------------------------
 auto SceneManager::createEntity(std::string_view meshName) -> Entity*
 {
     String name = mMovableNameGenerator.generate();
@@ -692,6 +766,7 @@ void SceneManager::destroyAllParticleSystems()
 //-----------------------------------------------------------------------
 void SceneManager::clearScene()
 {
+    _notifyVisibleObjectsChanged();
     mShadowRenderer.destroyShadowTextures();
     destroyAllStaticGeometry();
     destroyAllInstanceManagers();
@@ -701,6 +776,9 @@ void SceneManager::clearScene()
     getRootSceneNode()->removeAllChildren();
     getRootSceneNode()->detachAllObjects();
 
+    for (auto stage : mVisibilityStages)
+        stage->_notifyAllNodesDestroyed();
+
     // Delete all SceneNodes, except root that is
     for (auto & mSceneNode : mSceneNodes)
     {
@@ -802,6 +880,8 @@ void SceneManager::_destroySceneNode(SceneNodeList::iterator i)
     }
     if(!(*i)->getName().empty())
         mNamedNodes.erase((*i)->getName());
+    for (auto stage : mVisibilityStages)
+        stage->_notifyNodeDestroyed(*i);
     delete *i;
     if (std::next(i) != mSceneNodes.end())
     {
@@ -879,6 +959,37 @@ auto SceneManager::_setPass(const Pass* pass, bool evenIfSuppressed,
 
     // Tell params about current pass
     mAutoParamDataSource->setCurrentPass(pass);
+    // the programs are linked by the draw calls
+    ShaderTelemetry::_setCurrentPass(pass);
+
+    unsigned long frameNumber = Root::getSingleton().getNextFrameNumber();
+    if (frameNumber != mPassStateStatsFrame)
+    {
+        mPassStateStats = PassStateStats{};
+        mPassStateStatsFrame = frameNumber;
+    }
+    ++mPassStateStats.passesSet;
+
+    // When filtering, only issue the state calls whose values differ from the last pass.
+    // The state is unknown until this returns, e.g. if an exception is thrown
+    Pass::CompiledState state = pass->_getCompiledState();
+    // casters rendered on top of a cached shadow layer must not overwrite closer ones
+    if (mIlluminationStage == IlluminationRenderStage::RENDER_TO_TEXTURE && mShadowRenderer.mShadowCasterMinBlend)
+        state.blendState.operation = state.blendState.alphaOperation = SceneBlendOperation::MIN;
+    // the depth pre-pass wrote the depth, so only the visible fragments are shaded
+    if (mDepthPrePassActive && mDepthPrePassPasses.contains(pass))
+    {
+        state.depthWrite = false;
+        state.depthFunction = CompareFunction::EQUAL;
+    }
+    bool filter = mPassStateFiltering && mLastPassStateValid;
+    mLastPassStateValid = false;
+    auto changed = [&](bool differs) -> bool
+    {
+        bool issue = !filter || differs;
+        ++(issue ? mPassStateStats.stateCallsIssued : mPassStateStats.stateCallsSkipped);
+        return issue;
+    };
 
     GpuProgram* vprog = pass->hasVertexProgram() ? pass->getVertexProgram().get() : nullptr;
     GpuProgram* fprog = pass->hasFragmentProgram() ? pass->getFragmentProgram().get() : nullptr;
@@ -964,7 +1075,12 @@ auto SceneManager::_setPass(const Pass* pass, bool evenIfSuppressed,
     if (passSurfaceAndLightParams)
     {
         // Dynamic lighting enabled?
-        mDestRenderSystem->setLightingEnabled(pass->getLightingEnabled());
+        if (changed(state.lighting != mLastPassState.lighting))
+            mDestRenderSystem->setLightingEnabled(state.lighting);
+    }
+    else
+    {
+        state.lighting = mLastPassState.lighting;
     }
 
     // Using a fragment program?
@@ -1021,18 +1137,27 @@ auto SceneManager::_setPass(const Pass* pass, bool evenIfSuppressed,
     }
 
     // Set scene blending
-    mDestRenderSystem->setColourBlendState(pass->getBlendState());
+    if (changed(state.blendState != mLastPassState.blendState))
+        mDestRenderSystem->setColourBlendState(state.blendState);
 
     // Line width
     if (mDestRenderSystem->getCapabilities()->hasCapability(Capabilities::WIDE_LINES))
-        mDestRenderSystem->_setLineWidth(pass->getLineWidth());
+    {
+        if (changed(state.lineWidth != mLastPassState.lineWidth))
+            mDestRenderSystem->_setLineWidth(state.lineWidth);
+    }
 
     // Set point parameters
-    mDestRenderSystem->_setPointParameters(pass->isPointAttenuationEnabled(), pass->getPointMinSize(),
-                                           pass->getPointMaxSize());
+    if (changed(state.pointAttenuation != mLastPassState.pointAttenuation ||
+                state.pointMinSize != mLastPassState.pointMinSize ||
+                state.pointMaxSize != mLastPassState.pointMaxSize))
+        mDestRenderSystem->_setPointParameters(state.pointAttenuation, state.pointMinSize, state.pointMaxSize);
 
     if (mDestRenderSystem->getCapabilities()->hasCapability(Capabilities::POINT_SPRITES))
-        mDestRenderSystem->_setPointSpritesEnabled(pass->getPointSpritesEnabled());
+    {
+        if (changed(state.pointSprites != mLastPassState.pointSprites))
+            mDestRenderSystem->_setPointSpritesEnabled(state.pointSprites);
+    }
 
     mAutoParamDataSource->setPointParameters(pass->isPointAttenuationEnabled(), pass->getPointAttenuation());
 
@@ -1042,8 +1167,12 @@ auto SceneManager::_setPass(const Pass* pass, bool evenIfSuppressed,
     size_t startLightIndex = pass->getStartLight();
     size_t shadowTexUnitIndex = 0;
     size_t shadowTexIndex = mShadowRenderer.getShadowTexIndex(startLightIndex);
+    bool applyHeldControllerInput = ControllerManager::getSingleton().getDeferTextureUpdates();
     for (TextureUnitState* pTex : pass->getTextureUnitStates())
     {
+        if (applyHeldControllerInput)
+            pTex->_applyHeldControllerInput();
+
         if (!pass->getIteratePerLight() && isShadowTechniqueTextureBased() &&
             pTex->getContentType() == TextureUnitState::ContentType::SHADOW)
         {
@@ -1084,7 +1213,7 @@ auto SceneManager::_setPass(const Pass* pass, bool evenIfSuppressed,
                             ::std::format("Current CompositorChain does not contain compositor named {}", compName));
 
             auto texName = pTex->getReferencedTextureName();
-            TexturePtr refTex = refComp->getTextureInstance(texName, pTex->getReferencedMRTIndex());
+            const TexturePtr& refTex = refComp->getTextureInstance(texName, pTex->getReferencedMRTIndex());
 
             if (!refTex)
                 OGRE_EXCEPT(ExceptionCodes::INVALIDPARAMS,
@@ -1094,32 +1223,51 @@ auto SceneManager::_setPass(const Pass* pass, bool evenIfSuppressed,
         mDestRenderSystem->_setTextureUnitSettings(unit, *pTex);
         ++unit;
     }
-    // Disable remaining texture units
-    mDestRenderSystem->_disableTextureUnitsFrom(pass->getNumTextureUnitStates());
+    // Disable remaining texture units, nothing to do if the last pass used no more
+    if (changed(state.numTextureUnits < mLastPassState.numTextureUnits))
+        mDestRenderSystem->_disableTextureUnitsFrom(state.numTextureUnits);
 
     // Set up non-texture related material settings
     // Depth buffer settings
-    mDestRenderSystem->_setDepthBufferParams(pass->getDepthCheckEnabled(), pass->getDepthWriteEnabled(),
-                                             pass->getDepthFunction());
-    mDestRenderSystem->_setDepthBias(pass->getDepthBiasConstant(), pass->getDepthBiasSlopeScale());
+    if (changed(state.depthCheck != mLastPassState.depthCheck || state.depthWrite != mLastPassState.depthWrite ||
+                state.depthFunction != mLastPassState.depthFunction))
+        mDestRenderSystem->_setDepthBufferParams(state.depthCheck, state.depthWrite, state.depthFunction);
+
+    if (changed(state.depthBiasConstant != mLastPassState.depthBiasConstant ||
+                state.depthBiasSlopeScale != mLastPassState.depthBiasSlopeScale))
+        mDestRenderSystem->_setDepthBias(state.depthBiasConstant, state.depthBiasSlopeScale);
+
     // Alpha-reject settings
-    mDestRenderSystem->_setAlphaRejectSettings(pass->getAlphaRejectFunction(),
-                                               pass->getAlphaRejectValue(),
-                                               pass->isAlphaToCoverageEnabled());
+    if (changed(state.alphaRejectFunction != mLastPassState.alphaRejectFunction ||
+                state.alphaRejectValue != mLastPassState.alphaRejectValue ||
+                state.alphaToCoverage != mLastPassState.alphaToCoverage))
+        mDestRenderSystem->_setAlphaRejectSettings(state.alphaRejectFunction, state.alphaRejectValue,
+                                                   state.alphaToCoverage);
 
     // Culling mode
     if (isShadowTechniqueTextureBased() && mIlluminationStage == IlluminationRenderStage::RENDER_TO_TEXTURE &&
-        mShadowRenderer.mShadowCasterRenderBackFaces && pass->getCullingMode() == CullingMode::CLOCKWISE)
+        mShadowRenderer.mShadowCasterRenderBackFaces && state.cullingMode == CullingMode::CLOCKWISE)
     {
         // render back faces into shadow caster, can help with depth comparison
         mPassCullingMode = CullingMode::ANTICLOCKWISE;
     }
     else
     {
-        mPassCullingMode = pass->getCullingMode();
+        mPassCullingMode = state.cullingMode;
     }
-    mDestRenderSystem->_setCullingMode(mPassCullingMode);
-    mDestRenderSystem->setShadingType(pass->getShadingMode());
+    state.cullingMode = mPassCullingMode;
+    if (changed(state.cullingMode != mLastPassState.cullingMode))
+        mDestRenderSystem->_setCullingMode(state.cullingMode);
+
+    if (changed(state.shading != mLastPassState.shading))
+        mDestRenderSystem->setShadingType(state.shading);
+
+    mLastPassState = state;
+    // renderSingleObject changes the bias for every iteration, and the render system may derive
+    // further ones itself, so the next pass must set it again
+    if (pass->getIterationDepthBias() != 0.0f)
+        mLastPassState.depthBiasConstant = std::numeric_limits<float>::quiet_NaN();
+    mLastPassStateValid = true;
 
     mAutoParamDataSource->setPassNumber( pass->getIndex() );
     // mark global params as dirty
@@ -1162,6 +1310,8 @@ void SceneManager::_renderScene(Camera* camera, Viewport* vp, bool includeOverla
     Root::getSingleton()._setCurrentSceneManager(this);
     mActiveQueuedRenderableVisitor->targetSceneMgr = this;
     mAutoParamDataSource->setCurrentSceneManager(this);
+    // the passes set are only current until the scene is rendered
+    ShaderTelemetry::PassScope telemetryPass{nullptr};
 
     // preserve the previous scheme, in case this is a RTT update with an outer _renderScene pending
     MaterialManager& matMgr = MaterialManager::getSingleton();
@@ -1197,35 +1347,25 @@ void SceneManager::_renderScene(Camera* camera, Viewport* vp, bool includeOverla
 
     mCameraInProgress = camera;
 
+    // the shadow texture cameras are timed as a whole by prepareShadowTextures
+    Timer* timer = Root::getSingleton().getTimer();
+    bool const timeStages = mIlluminationStage != IlluminationRenderStage::RENDER_TO_TEXTURE;
+    uint64 stageStart = timer->getMicroseconds();
 
-    // Update controllers 
-    ControllerManager::getSingleton().updateAllControllers();
-
-    // Update the scene, only do this once per frame
-    unsigned long thisFrameNumber = Root::getSingleton().getNextFrameNumber();
-    if (thisFrameNumber != mLastFrameNumber)
-    {
-        // Update animations
-        _applySceneAnimations();
-        updateDirtyInstanceManagers();
-        mLastFrameNumber = thisFrameNumber;
-    }
+    updateSceneForCamera(camera);
 
-    // Update scene graph for this camera (can happen multiple times per frame)
+    if (timeStages)
     {
-        _updateSceneGraph(camera);
-
-        // Auto-track nodes
-        for (auto mAutoTrackingSceneNode : mAutoTrackingSceneNodes)
-        {
-            mAutoTrackingSceneNode->_autoTrack();
-        }
+        uint64 now = timer->getMicroseconds();
+        currentRenderLoopStats().updateMicroseconds += now - stageStart;
+        stageStart = now;
     }
 
     if (mIlluminationStage != IlluminationRenderStage::RENDER_TO_TEXTURE && mFindVisibleObjects)
     {
         // Locate any lights which could be affecting the frustum
         findLightsAffectingFrustum(camera);
+        currentRenderLoopStats().cullMicroseconds += timer->getMicroseconds() - stageStart;
 
         // Prepare shadow textures if texture shadow based shadowing
         // technique in use
@@ -1253,7 +1393,7 @@ void SceneManager::_renderScene(Camera* camera, Viewport* vp, bool includeOverla
     setViewport(vp);
 
     // Tell params about camera
-    mAutoParamDataSource->setCurrentCamera(camera, mCameraRelativeRendering);
+    mAutoParamDataSource->setCurrentCamera(camera, mCameraRelativeRendering, mLargeWorldRendering);
     // Set autoparams for finite dir light extrusion
     mAutoParamDataSource->setShadowDirLightExtrusionDistance(mShadowRenderer.mShadowDirLightExtrudeDist);
 
@@ -1274,6 +1414,8 @@ void SceneManager::_renderScene(Camera* camera, Viewport* vp, bool includeOverla
 
     if (mFindVisibleObjects)
     {
+        stageStart = timer->getMicroseconds();
+
         // Assemble an AAB on the fly which contains the scene elements visible
         // by the camera.
         auto camVisObjIt = mCamVisibleObjectsMap.find( camera );
@@ -1285,13 +1427,22 @@ void SceneManager::_renderScene(Camera* camera, Viewport* vp, bool includeOverla
         // reset the bounds
         camVisObjIt->second.reset();
 
-        // Parse the scene and tag visibles
-        firePreFindVisibleObjects(vp);
-        _findVisibleObjects(camera, &(camVisObjIt->second),
-            mIlluminationStage == IlluminationRenderStage::RENDER_TO_TEXTURE? true : false);
-        firePostFindVisibleObjects(vp);
+        // Occlusion tests only make sense with the depth buffer of the camera
+        mVisibilityStagesActive =
+            !mVisibilityStages.empty() && mIlluminationStage != IlluminationRenderStage::RENDER_TO_TEXTURE;
+        if (mVisibilityStagesActive)
+        {
+            for (auto stage : mVisibilityStages)
+                stage->_beginFrame(camera, this);
+        }
+
+        // Parse the scene and tag visibles, unless culled along with the shadow cameras
+        _queueVisibleObjects(camera, vp, &(camVisObjIt->second));
 
         mAutoParamDataSource->setMainCamBoundsInfo(&(camVisObjIt->second));
+
+        if (timeStages)
+            currentRenderLoopStats().cullMicroseconds += timer->getMicroseconds() - stageStart;
     }
 
     mDestRenderSystem->_beginGeometryCount();
@@ -1310,7 +1461,29 @@ void SceneManager::_renderScene(Camera* camera, Viewport* vp, bool includeOverla
 
     // Render scene content
     {
+        uint64 sortStart = currentRenderLoopStats().sortMicroseconds;
+        stageStart = timer->getMicroseconds();
         _renderVisibleObjects();
+        if (timeStages)
+        {
+            RenderLoopStats& stats = currentRenderLoopStats();
+            stats.submitMicroseconds += timer->getMicroseconds() - stageStart - (stats.sortMicroseconds - sortStart);
+        }
+    }
+
+    const RenderQueue::Stats& queueStats = getRenderQueue()->getStats();
+    RenderLoopStats& loopStats = currentRenderLoopStats();
+    loopStats.nodesCulled += queueStats.nodesCulled;
+    loopStats.objectsVisible += queueStats.objectsVisible;
+    loopStats.objectsRejected += queueStats.objectsRejected;
+    loopStats.renderablesQueued += queueStats.renderablesQueued;
+
+    // Let the stages use the depth buffer, e.g. for the tests of the next frames
+    if (mVisibilityStagesActive)
+    {
+        for (auto stage : mVisibilityStages)
+            stage->_endFrame(this);
+        mVisibilityStagesActive = false;
     }
 
     // End frame
@@ -1474,32 +1647,728 @@ void SceneManager::_setSkyDome(bool enable, std::string_view materialName, Real
                             orientation, xsegments, ysegments, ysegments_keep, groupName);
 }
 
+//-----------------------------------------------------------------------
+void SceneManager::updateSceneForCamera(Camera* cam)
+{
+    // Update controllers 
+    ControllerManager::getSingleton().updateAllControllers();
+    // Run the particle system updates the controllers queued
+    ParticleSystemManager::getSingleton()._updateQueuedSystems();
+
+    // Update the scene, only do this once per frame
+    unsigned long thisFrameNumber = Root::getSingleton().getNextFrameNumber();
+    if (thisFrameNumber != mLastFrameNumber)
+    {
+        // Update animations
+        _applySceneAnimations();
+        for (auto const& [name, instanceManager] : mInstanceManagerMap)
+            instanceManager->_updateIncrementalDefragmentation();
+        updateDirtyInstanceManagers();
+        mLastFrameNumber = thisFrameNumber;
+    }
+
+    // Update scene graph for this camera (can happen multiple times per frame)
+    {
+        _updateSceneGraph(cam);
+
+        // Auto-track nodes
+        for (auto mAutoTrackingSceneNode : mAutoTrackingSceneNodes)
+        {
+            mAutoTrackingSceneNode->_autoTrack();
+        }
+    }
+}
 //-----------------------------------------------------------------------
 void SceneManager::_updateSceneGraph(Camera* cam)
 {
     firePreUpdateSceneGraph(cam);
 
     // Process queued needUpdate calls 
+    mQueuedNodeUpdates.process();
     Node::processQueuedUpdates();
 
+    Timer* timer = Root::getSingleton().getTimer();
+    uint64 startTime = timer->getMicroseconds();
+
+    unsigned long frameNumber = Root::getSingleton().getNextFrameNumber();
+    if (frameNumber != mSceneGraphUpdateStatsFrame)
+    {
+        mSceneGraphUpdateStats = SceneGraphUpdateStats{};
+        mSceneGraphUpdateStatsFrame = frameNumber;
+    }
+
     // Cascade down the graph updating transforms & world bounds
     // In this implementation, just update from the root
     // Smarter SceneManager subclasses may choose to update only
     //   certain scene graph branches
-    getRootSceneNode()->_update(true, false);
+    if (mPackedTransformUpdate)
+    {
+        updateSceneGraphPacked();
+    }
+    else if (mParallelSceneGraphUpdate)
+    {
+        updateSceneGraphParallel();
+    }
+    else
+    {
+        size_t startCount = Node::_getThreadUpdateCount();
+        size_t startVisits = Node::_getThreadVisitCount();
+        getRootSceneNode()->_update(true, false);
+        mSceneGraphUpdateStats.nodesUpdated += Node::_getThreadUpdateCount() - startCount;
+        mSceneGraphUpdateStats.nodesVisited += Node::_getThreadVisitCount() - startVisits;
+    }
+
+    mSceneGraphUpdateStats.microseconds += timer->getMicroseconds() - startTime;
+
+    // skeletons need the final node transforms for their TagPoints and bounds
+    if (mParallelSkeletalAnimation)
+        updateSkeletalAnimationParallel();
 
     firePostUpdateSceneGraph(cam);
 }
 //-----------------------------------------------------------------------
+void SceneManager::setPackedTransformUpdate(bool enabled)
+{
+    mPackedTransformUpdate = enabled;
+    if (!enabled)
+        mPackedTransforms.clear();
+}
+//-----------------------------------------------------------------------
+void SceneManager::setOcclusionCulling(bool enabled)
+{
+    if (enabled && !mOcclusionCulling)
+    {
+        mOcclusionCulling = std::make_unique<OcclusionCulling>();
+        addVisibilityStage(mOcclusionCulling.get());
+    }
+    else if (!enabled && mOcclusionCulling)
+    {
+        removeVisibilityStage(mOcclusionCulling.get());
+        mOcclusionCulling.reset();
+    }
+}
+//-----------------------------------------------------------------------
+void SceneManager::addVisibilityStage(VisibilityStage* stage)
+{
+    OgreAssert(stage, "null stage");
+    OgreAssert(!mVisibilityStagesActive, "cannot add stages while culling");
+    if (std::find(mVisibilityStages.begin(), mVisibilityStages.end(), stage) == mVisibilityStages.end())
+        mVisibilityStages.push_back(stage);
+}
+//-----------------------------------------------------------------------
+void SceneManager::removeVisibilityStage(VisibilityStage* stage)
+{
+    OgreAssert(!mVisibilityStagesActive, "cannot remove stages while culling");
+    std::erase(mVisibilityStages, stage);
+}
+//-----------------------------------------------------------------------
+void SceneManager::updateSceneGraphPacked()
+{
+    SceneNode* root = getRootSceneNode();
+    if (mPackedTransforms.getRoot() != root ||
+        mPackedTransforms.getHierarchyVersion() != Node::_getHierarchyVersion())
+    {
+        mPackedTransforms.build(root);
+    }
+
+    size_t updated = mPackedTransforms.update();
+    if (updated == 0)
+        return;
+
+    mSceneGraphUpdateStats.nodesUpdated += updated;
+    mSceneGraphUpdateStats.nodesVisited += updated;
+
+    // children precede their parents when walking the levels backwards
+    for (size_t level = mPackedTransforms.getNumLevels(); level-- > 0;)
+    {
+        auto [begin, end] = mPackedTransforms.getLevelRange(level);
+        for (size_t slot = begin; slot < end; ++slot)
+        {
+            if (Node* node = mPackedTransforms.getNode(slot))
+                static_cast<SceneNode*>(node)->_updateBounds();
+        }
+    }
+}
+//-----------------------------------------------------------------------
+void SceneManager::updateSceneGraphParallel()
+{
+    // enough subtrees per thread to balance uneven branches
+    static const size_t constexpr SUBTREES_PER_THREAD = 8;
+    // don't expand too deep on the calling thread
+    static const int constexpr MAX_EXPANSION_DEPTH = 4;
+
+    WorkQueue* queue = Root::getSingleton().getWorkQueue();
+    size_t targetSubtrees = SUBTREES_PER_THREAD * std::max(1u, std::thread::hardware_concurrency());
+
+    // the whole scene is static
+    SceneNode* root = getRootSceneNode();
+    if (!root->_isUpdatePending())
+        return;
+
+    mPendingNodeUpdates.clear();
+    mExpandedSceneNodes.clear();
+    size_t startCount = Node::_getThreadUpdateCount();
+    size_t startVisits = Node::_getThreadVisitCount();
+
+    // Expand the top of the hierarchy breadth first on this thread. Every node expanded here
+    // gets its own transform updated and hands its children on to the next level
+    root->_updateSelf(false, mPendingNodeUpdates);
+    mExpandedSceneNodes.push_back(root);
+
+    for (int depth = 0; depth < MAX_EXPANSION_DEPTH && mPendingNodeUpdates.size() < targetSubtrees; ++depth)
+    {
+        mPendingNodeUpdatesNext.clear();
+        bool expanded = false;
+        for (auto [node, parentChanged] : mPendingNodeUpdates)
+        {
+            if (node->getChildren().empty())
+            {
+                mPendingNodeUpdatesNext.emplace_back(node, parentChanged);
+                continue;
+            }
+            node->_updateSelf(parentChanged, mPendingNodeUpdatesNext);
+            mExpandedSceneNodes.push_back(static_cast<SceneNode*>(node));
+            expanded = true;
+        }
+        std::swap(mPendingNodeUpdates, mPendingNodeUpdatesNext);
+
+        if (!expanded)
+            break;
+    }
+
+    mSceneGraphUpdateStats.nodesUpdated += Node::_getThreadUpdateCount() - startCount;
+    mSceneGraphUpdateStats.nodesVisited += Node::_getThreadVisitCount() - startVisits;
+
+    // the subtrees are disjoint, so they can be updated concurrently
+    std::atomic<size_t> workerUpdateCount{0}, workerVisitCount{0};
+    queue->parallelFor(mPendingNodeUpdates.size(), [this, &workerUpdateCount, &workerVisitCount](size_t i)
+    {
+        size_t startCount = Node::_getThreadUpdateCount();
+        size_t startVisits = Node::_getThreadVisitCount();
+        auto [node, parentChanged] = mPendingNodeUpdates[i];
+        node->_update(true, parentChanged);
+        workerUpdateCount += Node::_getThreadUpdateCount() - startCount;
+        workerVisitCount += Node::_getThreadVisitCount() - startVisits;
+    });
+    mSceneGraphUpdateStats.nodesUpdated += workerUpdateCount;
+    mSceneGraphUpdateStats.nodesVisited += workerVisitCount;
+    mSceneGraphUpdateStats.subtreesDispatched += mPendingNodeUpdates.size();
+
+    // Bounds of the expanded nodes depend on their children, so merge bottom up
+    for (auto it = mExpandedSceneNodes.rbegin(); it != mExpandedSceneNodes.rend(); ++it)
+        (*it)->_updateBounds();
+}
+//-----------------------------------------------------------------------
+void SceneManager::setSkeletonPoseSharing(bool enabled)
+{
+    if (!enabled)
+        mSkeletonPoseCache.reset();
+    else if (!mSkeletonPoseCache)
+        mSkeletonPoseCache = std::make_unique<SkeletonPoseCache>();
+}
+//-----------------------------------------------------------------------
+void SceneManager::updateSkeletalAnimationParallel()
+{
+    mSkeletalAnimationTasks.clear();
+    for (auto const& [name, object] : getMovableObjectCollection(EntityFactory::FACTORY_TYPE_NAME)->map)
+    {
+        auto entity = static_cast<Entity*>(object);
+        if (entity->isInScene() && entity->isVisible() && entity->_isSkeletonAnimated() &&
+            entity->getAttachedObjects().empty())
+            mSkeletalAnimationTasks.push_back(entity);
+    }
+
+    // entities sharing a skeleton instance share its evaluation
+    std::ranges::sort(mSkeletalAnimationTasks, {}, &Entity::getSkeleton);
+    auto [first, last] = std::ranges::unique(mSkeletalAnimationTasks, {}, &Entity::getSkeleton);
+    mSkeletalAnimationTasks.erase(first, last);
+    if (mSkeletalAnimationTasks.empty())
+        return;
+
+    // build the lazily cached animation data once, before the tasks read it
+    for (auto entity : mSkeletalAnimationTasks)
+        entity->getSkeleton()->_prepareAnimationState(*entity->getAllAnimationStates());
+
+    Root::getSingleton().getWorkQueue()->parallelFor(mSkeletalAnimationTasks.size(), [this](size_t i)
+    {
+        mSkeletalAnimationTasks[i]->_updateBoneMatrices();
+    });
+}
+//-----------------------------------------------------------------------
 void SceneManager::_findVisibleObjects(
     Camera* cam, VisibleObjectsBoundsInfo* visibleBounds, bool onlyShadowCasters)
 {
+    if (!mCameraGroups.empty() && !onlyShadowCasters && !mVisibilityStagesActive)
+    {
+        if (CameraGroup* group = findCameraGroup(cam))
+        {
+            findVisibleObjectsGrouped(*group, cam, visibleBounds);
+            return;
+        }
+    }
+
+    if (mParallelFindVisibleObjects && !mVisibilityStagesActive && !getRenderQueue()->getRenderableListener())
+    {
+        findVisibleObjectsParallel(cam, visibleBounds, onlyShadowCasters);
+        return;
+    }
+
     // Tell nodes to find, cascade down all nodes
     getRootSceneNode()->_findVisibleObjects(cam, getRenderQueue(), visibleBounds, true, 
         mDisplayNodes, onlyShadowCasters);
 
 }
 //-----------------------------------------------------------------------
+void SceneManager::addCameraGroup(const std::vector<Camera*>& cameras)
+{
+    OgreAssert(cameras.size() > 1, "A camera group needs at least two cameras");
+    for (auto cam : cameras)
+        OgreAssert(cam && !findCameraGroup(cam), "Camera is null or in a camera group already");
+
+    mCameraGroups.push_back(CameraGroup{cameras});
+}
+//-----------------------------------------------------------------------
+void SceneManager::removeCameraGroup(const Camera* cam)
+{
+    std::erase_if(mCameraGroups, [cam](const CameraGroup& group)
+                  { return std::ranges::find(group.cameras, cam) != group.cameras.end(); });
+}
+//-----------------------------------------------------------------------
+auto SceneManager::findCameraGroup(const Camera* cam) -> CameraGroup*
+{
+    for (auto& group : mCameraGroups)
+    {
+        if (std::ranges::find(group.cameras, cam) != group.cameras.end())
+            return &group;
+    }
+    return nullptr;
+}
+//-----------------------------------------------------------------------
+void SceneManager::findVisibleObjectsGrouped(CameraGroup& group, Camera* cam, VisibleObjectsBoundsInfo* visibleBounds)
+{
+    unsigned long frameNumber = Root::getSingleton().getNextFrameNumber();
+    if (!group.valid || group.frameNumber != frameNumber || group.hierarchyVersion != Node::_getHierarchyVersion())
+    {
+        // The volume all cameras of the group can see
+        AxisAlignedBox volume;
+        for (auto groupCam : group.cameras)
+        {
+            if (groupCam->getFarClipDistance() == 0)
+            {
+                volume.setInfinite();
+                break;
+            }
+            for (const auto& corner : groupCam->getWorldSpaceCorners())
+                volume.merge(corner);
+        }
+
+        // Depth first, so the objects are queued in the order of the regular traversal
+        group.nodes.clear();
+        mExpandedSceneNodes.clear();
+        mExpandedSceneNodes.push_back(getRootSceneNode());
+        while (!mExpandedSceneNodes.empty())
+        {
+            SceneNode* node = mExpandedSceneNodes.back();
+            mExpandedSceneNodes.pop_back();
+            if (!volume.intersects(node->_getWorldAABB()))
+                continue;
+
+            if (!node->getAttachedObjects().empty())
+                group.nodes.push_back(node);
+            const auto& children = node->getChildren();
+            for (auto it = children.rbegin(); it != children.rend(); ++it)
+                mExpandedSceneNodes.push_back(static_cast<SceneNode*>(*it));
+        }
+
+        group.frameNumber = frameNumber;
+        group.hierarchyVersion = Node::_getHierarchyVersion();
+        group.valid = true;
+    }
+
+    // A node's bounds contain those of its children, so testing each node on its own
+    // culls exactly like the hierarchical traversal
+    AxisAlignedBoxBatch batch;
+    uint8 visible[AxisAlignedBoxBatch::CAPACITY];
+    RenderQueue* queue = getRenderQueue();
+    for (size_t begin = 0; begin < group.nodes.size(); begin += AxisAlignedBoxBatch::CAPACITY)
+    {
+        size_t end = std::min(begin + AxisAlignedBoxBatch::CAPACITY, group.nodes.size());
+
+        batch.clear();
+        for (size_t i = begin; i < end; ++i)
+            batch.push_back(group.nodes[i]->_getWorldAABB());
+        cam->isVisible(batch, visible);
+
+        for (size_t i = begin; i < end; ++i)
+        {
+            if (!visible[i - begin])
+            {
+                queue->_notifyNodesCulled(1);
+                continue;
+            }
+
+            SceneNode* node = group.nodes[i];
+            for (auto mo : node->getAttachedObjects())
+                queue->processVisibleObject(mo, cam, false, visibleBounds);
+            if (mDebugDrawer)
+                mDebugDrawer->drawSceneNode(node);
+        }
+    }
+}
+//-----------------------------------------------------------------------
+void SceneManager::findVisibleObjectsParallel(
+    Camera* cam, VisibleObjectsBoundsInfo* visibleBounds, bool onlyShadowCasters)
+{
+    // enough branches per thread to balance uneven ones
+    static const size_t constexpr BRANCHES_PER_THREAD = 8;
+    // don't expand too deep on the calling thread
+    static const int constexpr MAX_EXPANSION_DEPTH = 4;
+
+    RenderQueue* queue = getRenderQueue();
+    SceneNode* root = getRootSceneNode();
+    if (!cam->isVisible(root->_getWorldAABB()))
+    {
+        queue->_notifyNodesCulled(1);
+        return;
+    }
+
+    WorkQueue* workQueue = Root::getSingleton().getWorkQueue();
+    size_t targetTasks = BRANCHES_PER_THREAD * std::max(1u, std::thread::hardware_concurrency());
+
+    // Expand the top of the hierarchy on this thread. The tasks stay in the order of the
+    // serial traversal, the objects of a node preceding the branches of its visible children
+    mVisibleObjectsTasks.clear();
+    mVisibleObjectsTasks.push_back({root, false});
+    for (int depth = 0; depth < MAX_EXPANSION_DEPTH && mVisibleObjectsTasks.size() < targetTasks; ++depth)
+    {
+        mVisibleObjectsTasksNext.clear();
+        bool expanded = false;
+        for (auto task : mVisibleObjectsTasks)
+        {
+            if (task.objectsOnly || task.node->getChildren().empty())
+            {
+                mVisibleObjectsTasksNext.push_back(task);
+                continue;
+            }
+
+            mVisibleObjectsTasksNext.push_back({task.node, true});
+            for (auto child : task.node->getChildren())
+            {
+                auto sceneChild = static_cast<SceneNode*>(child);
+                if (cam->isVisible(sceneChild->_getWorldAABB()))
+                    mVisibleObjectsTasksNext.push_back({sceneChild, false});
+                else
+                    queue->_notifyNodesCulled(1);
+            }
+            expanded = true;
+        }
+        std::swap(mVisibleObjectsTasks, mVisibleObjectsTasksNext);
+
+        if (!expanded)
+            break;
+    }
+
+    if (mVisibleObjectsStaging.size() < mVisibleObjectsTasks.size())
+        mVisibleObjectsStaging.resize(mVisibleObjectsTasks.size());
+    for (size_t i = 0; i < mVisibleObjectsTasks.size(); ++i)
+    {
+        auto& staging = mVisibleObjectsStaging[i];
+        if (!staging.queue)
+            staging.queue = std::make_unique<RenderQueue>();
+        staging.queue->_resetStaging(queue);
+        staging.bounds.reset();
+        staging.drawnNodes.clear();
+    }
+
+    // the branches are disjoint and every one has its own queue
+    workQueue->parallelFor(mVisibleObjectsTasks.size(), [&](size_t i)
+    {
+        auto [node, objectsOnly] = mVisibleObjectsTasks[i];
+        auto& staging = mVisibleObjectsStaging[i];
+        VisibleObjectsBoundsInfo* bounds = visibleBounds ? &staging.bounds : nullptr;
+        if (objectsOnly)
+        {
+            if (!_passesShadowCasterCulling(node->_getWorldAABB()))
+                return;
+            for (auto mo : node->getAttachedObjects())
+                staging.queue->processVisibleObject(mo, cam, onlyShadowCasters, bounds);
+            staging.drawnNodes.push_back(node);
+        }
+        else
+        {
+            node->addVisibleObjects(cam, staging.queue.get(), bounds, true, mDisplayNodes, onlyShadowCasters,
+                                    &staging.drawnNodes);
+        }
+    });
+
+    DebugDrawer* debugDrawer = getDebugDrawer();
+    for (size_t i = 0; i < mVisibleObjectsTasks.size(); ++i)
+    {
+        auto& staging = mVisibleObjectsStaging[i];
+        queue->merge(staging.queue.get());
+        // drop the pass groups, which are only kept up to date in the main queues
+        staging.queue->_resetStaging(queue);
+
+        if (visibleBounds)
+            visibleBounds->merge(staging.bounds);
+        if (debugDrawer)
+        {
+            for (auto node : staging.drawnNodes)
+                debugDrawer->drawSceneNode(node);
+        }
+    }
+}
+//-----------------------------------------------------------------------
+void SceneManager::gatherVisibleObjectsParallel(GatheredObjects& gathered)
+{
+    // fewer branches than for a single camera, every task culls each camera
+    static const size_t constexpr BRANCHES_PER_THREAD = 8;
+    static const int constexpr MAX_EXPANSION_DEPTH = 4;
+
+    auto& [cameras, tasks, stagings, frame] = gathered;
+    frame = Root::getSingleton().getNextFrameNumber();
+    size_t cameraCount = cameras.size();
+    if (cameraCount == 0)
+        return;
+
+    auto anyVisible = [&cameras](const AxisAlignedBox& bounds)
+    {
+        return std::ranges::any_of(cameras,
+            [&bounds](const GatheredCamera& camera) { return camera.camera->isVisible(bounds); });
+    };
+
+    // Expand the top of the hierarchy as seen by any camera, in the order of the serial traversal
+    SceneNode* root = getRootSceneNode();
+    size_t threads = std::max(1u, std::thread::hardware_concurrency());
+    size_t targetTasks = std::max(2 * threads, BRANCHES_PER_THREAD * threads / cameraCount);
+    tasks.clear();
+    if (anyVisible(root->_getWorldAABB()))
+        tasks.push_back({root, false});
+    for (int depth = 0; depth < MAX_EXPANSION_DEPTH && tasks.size() < targetTasks; ++depth)
+    {
+        mVisibleObjectsTasksNext.clear();
+        bool expanded = false;
+        for (auto task : tasks)
+        {
+            if (task.objectsOnly || task.node->getChildren().empty())
+            {
+                mVisibleObjectsTasksNext.push_back(task);
+                continue;
+            }
+
+            mVisibleObjectsTasksNext.push_back({task.node, true});
+            for (auto child : task.node->getChildren())
+            {
+                auto sceneChild = static_cast<SceneNode*>(child);
+                if (anyVisible(sceneChild->_getWorldAABB()))
+                    mVisibleObjectsTasksNext.push_back({sceneChild, false});
+            }
+            expanded = true;
+        }
+        std::swap(tasks, mVisibleObjectsTasksNext);
+
+        if (!expanded)
+            break;
+    }
+
+    // with the organisation of the queue each camera is rendered with, which depends on its viewport
+    RenderQueue* queue = getRenderQueue();
+    Viewport* currentViewport = mCurrentViewport;
+    size_t stagingCount = tasks.size() * cameraCount;
+    if (stagings.size() < stagingCount)
+        stagings.resize(stagingCount);
+    for (size_t c = 0; c < cameraCount; ++c)
+    {
+        mCurrentViewport = cameras[c].viewport;
+        prepareRenderQueue();
+        for (size_t i = 0; i < tasks.size(); ++i)
+        {
+            auto& staging = stagings[i * cameraCount + c];
+            if (!staging.queue)
+                staging.queue = std::make_unique<RenderQueue>();
+            staging.queue->_resetStaging(queue);
+            staging.bounds.reset();
+            staging.drawnNodes.clear();
+        }
+    }
+    mCurrentViewport = currentViewport;
+
+    // the branches are disjoint, and the cameras of a branch are culled one after the other
+    Root::getSingleton().getWorkQueue()->parallelFor(tasks.size(), [&](size_t i)
+    {
+        auto [node, objectsOnly] = tasks[i];
+        const AxisAlignedBox& nodeBounds = node->_getWorldAABB();
+        for (size_t c = 0; c < cameraCount; ++c)
+        {
+            const GatheredCamera& camera = cameras[c];
+            auto& staging = stagings[i * cameraCount + c];
+            msCullingViewport = camera.viewport;
+            ShadowRenderer::msActiveCasterCulling = camera.culling;
+            if (!camera.camera->isVisible(nodeBounds))
+                staging.queue->_notifyNodesCulled(1);
+            else if (!objectsOnly)
+                node->addVisibleObjects(camera.camera, staging.queue.get(), &staging.bounds, true, mDisplayNodes,
+                                        camera.onlyShadowCasters, &staging.drawnNodes);
+            else if (_passesShadowCasterCulling(nodeBounds))
+            {
+                for (auto mo : node->getAttachedObjects())
+                    staging.queue->processVisibleObject(mo, camera.camera, camera.onlyShadowCasters,
+                                                        &staging.bounds);
+                staging.drawnNodes.push_back(node);
+            }
+        }
+        msCullingViewport = nullptr;
+        ShadowRenderer::msActiveCasterCulling = nullptr;
+    });
+}
+//-----------------------------------------------------------------------
+auto SceneManager::mergeGatheredObjects(GatheredObjects& gathered, const Camera* cam,
+                                        VisibleObjectsBoundsInfo* visibleBounds) -> bool
+{
+    auto& [cameras, tasks, stagings, frame] = gathered;
+    if (cameras.empty())
+        return false;
+    if (frame != Root::getSingleton().getNextFrameNumber())
+    {
+        cameras.clear();
+        return false;
+    }
+
+    auto camera = std::ranges::find(cameras, cam, &GatheredCamera::camera);
+    if (camera == cameras.end())
+        return false;
+    // culled again if rendered another time
+    size_t c = camera - cameras.begin();
+    camera->camera = nullptr;
+
+    RenderQueue* queue = getRenderQueue();
+    DebugDrawer* debugDrawer = getDebugDrawer();
+    size_t cameraCount = cameras.size();
+    for (size_t i = 0; i < tasks.size(); ++i)
+    {
+        auto& staging = stagings[i * cameraCount + c];
+        queue->merge(staging.queue.get());
+        staging.queue->_resetStaging(queue);
+
+        if (visibleBounds)
+            visibleBounds->merge(staging.bounds);
+        if (debugDrawer && !camera->onlyShadowCasters)
+        {
+            for (auto node : staging.drawnNodes)
+                debugDrawer->drawSceneNode(node);
+        }
+    }
+    return true;
+}
+//-----------------------------------------------------------------------
+void SceneManager::_gatherViewports(std::span<Viewport* const> viewports)
+{
+    auto& cameras = mGatheredViewportObjects.cameras;
+    cameras.clear();
+    if (!mParallelViewportCulling || !mFindVisibleObjects || !mVisibilityStages.empty() ||
+        getRenderQueue()->getRenderableListener())
+        return;
+
+    // the techniques are queued for the active material scheme
+    CompositorManager* compositors = CompositorManager::getSingletonPtr();
+    const Viewport* first = nullptr;
+    for (auto vp : viewports)
+    {
+        Camera* cam = vp->getCamera();
+        if (!cam || cam->getSceneManager() != this || findCameraGroup(cam) ||
+            (compositors && compositors->hasCompositorChain(vp)) ||
+            std::ranges::find(cameras, cam, &GatheredCamera::camera) != cameras.end())
+            continue;
+        if (!first)
+            first = vp;
+        if (vp->getMaterialScheme() == first->getMaterialScheme())
+            cameras.push_back({cam, vp, nullptr, false});
+    }
+    if (cameras.empty())
+        return;
+
+    Timer* timer = Root::getSingleton().getTimer();
+    uint64 stageStart = timer->getMicroseconds();
+    updateSceneForCamera(cameras.front().camera);
+    uint64 now = timer->getMicroseconds();
+    currentRenderLoopStats().updateMicroseconds += now - stageStart;
+
+    MaterialManager& materials = MaterialManager::getSingleton();
+    String activeScheme{materials.getActiveScheme()};
+    materials.setActiveScheme(first->getMaterialScheme());
+    gatherVisibleObjectsParallel(mGatheredViewportObjects);
+    materials.setActiveScheme(activeScheme);
+    currentRenderLoopStats().cullMicroseconds += timer->getMicroseconds() - now;
+}
+//-----------------------------------------------------------------------
+void SceneManager::_queueVisibleObjects(Camera* camera, Viewport* vp, VisibleObjectsBoundsInfo* visibleBounds)
+{
+    firePreFindVisibleObjects(vp);
+    if (!mergeCachedVisibleObjects(camera, vp, visibleBounds))
+    {
+        if (!mergeGatheredObjects(mGatheredViewportObjects, camera, visibleBounds) &&
+            !mergeGatheredObjects(mGatheredShadowObjects, camera, visibleBounds))
+            _findVisibleObjects(camera, visibleBounds,
+                mIlluminationStage == IlluminationRenderStage::RENDER_TO_TEXTURE? true : false);
+        cacheVisibleObjects(camera, vp, *visibleBounds);
+    }
+    firePostFindVisibleObjects(vp);
+}
+//-----------------------------------------------------------------------
+auto SceneManager::isVisibleObjectsCacheUsable() const -> bool
+{
+    return mReuseVisibleObjects && mIlluminationStage != IlluminationRenderStage::RENDER_TO_TEXTURE &&
+           !mVisibilityStagesActive && mRenderQueue && !mRenderQueue->getRenderableListener();
+}
+//-----------------------------------------------------------------------
+auto SceneManager::mergeCachedVisibleObjects(const Camera* cam, const Viewport* vp,
+                                             VisibleObjectsBoundsInfo* visibleBounds) -> bool
+{
+    const auto& cache = mVisibleObjectsCache;
+    if (!isVisibleObjectsCacheUsable() || cache.camera != cam ||
+        cache.frame != Root::getSingleton().getNextFrameNumber())
+        return false;
+
+    // anything that changes what gets queued, or how
+    if (cache.view != cam->getViewMatrix() || cache.projection != cam->getProjectionMatrix() ||
+        cache.width != vp->getActualWidth() || cache.height != vp->getActualHeight() ||
+        cache.visibilityMask != vp->getVisibilityMask() || cache.lodBias != cam->getLodBias() ||
+        cache.materialScheme != vp->getMaterialScheme() || cache.shadowsEnabled != vp->getShadowsEnabled())
+        return false;
+
+    getRenderQueue()->merge(cache.staging.queue.get());
+    visibleBounds->merge(cache.staging.bounds);
+    return true;
+}
+//-----------------------------------------------------------------------
+void SceneManager::cacheVisibleObjects(const Camera* cam, const Viewport* vp,
+                                       const VisibleObjectsBoundsInfo& visibleBounds)
+{
+    auto& cache = mVisibleObjectsCache;
+    cache.camera = nullptr;
+    if (!isVisibleObjectsCacheUsable())
+        return;
+
+    RenderQueue* queue = getRenderQueue();
+    if (!cache.staging.queue)
+        cache.staging.queue = std::make_unique<RenderQueue>();
+    cache.staging.queue->_resetStaging(queue);
+    cache.staging.queue->merge(queue);
+    cache.staging.bounds.reset();
+    cache.staging.bounds.merge(visibleBounds);
+
+    cache.camera = cam;
+    cache.frame = Root::getSingleton().getNextFrameNumber();
+    cache.view = cam->getViewMatrix();
+    cache.projection = cam->getProjectionMatrix();
+    cache.width = vp->getActualWidth();
+    cache.height = vp->getActualHeight();
+    cache.visibilityMask = vp->getVisibilityMask();
+    cache.lodBias = cam->getLodBias();
+    cache.materialScheme = vp->getMaterialScheme();
+    cache.shadowsEnabled = vp->getShadowsEnabled();
+}
+//-----------------------------------------------------------------------
 void SceneManager::renderVisibleObjectsDefaultSequence()
 {
     firePreRenderQueues();
@@ -1553,6 +2422,10 @@ void SceneManager::renderVisibleObjectsDefaultSequence()
 //-----------------------------------------------------------------------
 void SceneManager::SceneMgrQueuedRenderableVisitor::visit(const Pass* p, RenderableList& rs)
 {
+    // Keep in step with the prepared list, whether rendered or not
+    const PreparedRenderable* first = prepared ? prepared + preparedCursor : nullptr;
+    preparedCursor += rs.size();
+
     // Give SM a chance to eliminate this pass
     if (!targetSceneMgr->validatePassForRendering(p))
         return;
@@ -1560,19 +2433,45 @@ void SceneManager::SceneMgrQueuedRenderableVisitor::visit(const Pass* p, Rendera
     // Set pass, store the actual one used
     mUsedPass = targetSceneMgr->_setPass(p);
 
-    for (Renderable* r : rs)
+    RenderSystem* renderSystem = targetSceneMgr->mDestRenderSystem;
+    bool instancing = targetSceneMgr->mAutoInstancing && mUsedPass->getAutoInstancing() &&
+                      mUsedPass->hasVertexProgram() && !renderSystem->getGlobalInstanceVertexBuffer() &&
+                      renderSystem->getCapabilities()->hasCapability(Capabilities::VERTEX_BUFFER_INSTANCE_DATA);
+    bool multiDraw = renderSystem->getCapabilities()->hasCapability(Capabilities::MULTI_DRAW);
+
+    for (size_t i = 0; i < rs.size();)
     {
+        Renderable* r = rs[i];
         // Give SM a chance to eliminate
         if (!targetSceneMgr->validateRenderableForRendering(mUsedPass, r))
+        {
+            ++i;
             continue;
+        }
+
+        size_t run = instancing ? targetSceneMgr->findInstanceRun(mUsedPass, rs, i, autoLights) : 1;
+        if (run > 1)
+            targetSceneMgr->prepareInstances(rs, i, run, first ? first + i : nullptr);
+        else if (multiDraw)
+        {
+            run = targetSceneMgr->findMultiDrawRun(mUsedPass, rs, i, autoLights);
+            targetSceneMgr->mCurrentMultiDraw = {rs.data() + i + 1, run - 1};
+        }
 
         // Render a single object, this will set up auto params if required
+        targetSceneMgr->mCurrentPreparedRenderable = first ? first + i : nullptr;
         targetSceneMgr->renderSingleObject(r, mUsedPass, scissoring, autoLights, manualLightList);
+        targetSceneMgr->mCurrentNumInstances = 0;
+        targetSceneMgr->mCurrentMultiDraw = {};
+        i += run;
     }
+    targetSceneMgr->mCurrentPreparedRenderable = nullptr;
 }
 //-----------------------------------------------------------------------
 void SceneManager::SceneMgrQueuedRenderableVisitor::visit(RenderablePass* rp)
 {
+    const PreparedRenderable* current = prepared ? prepared + preparedCursor++ : nullptr;
+
     // Skip this one if we're in transparency cast shadows mode & it doesn't
     // Don't need to implement this one in the other visit methods since
     // transparents are never grouped, always sorted
@@ -1584,8 +2483,10 @@ void SceneManager::SceneMgrQueuedRenderableVisitor::visit(RenderablePass* rp)
     if (targetSceneMgr->validateRenderableForRendering(rp->pass, rp->renderable))
     {
         mUsedPass = targetSceneMgr->_setPass(rp->pass);
+        targetSceneMgr->mCurrentPreparedRenderable = current;
         targetSceneMgr->renderSingleObject(rp->renderable, mUsedPass, scissoring, 
             autoLights, manualLightList);
+        targetSceneMgr->mCurrentPreparedRenderable = nullptr;
     }
 }
 //-----------------------------------------------------------------------
@@ -1598,9 +2499,234 @@ void SceneManager::SceneMgrQueuedRenderableVisitor::renderObjects(const QueuedRe
     manualLightList = _manualLightList;
     transparentShadowCastersMode = _transparentShadowCastersMode;
     scissoring = lightScissoringClipping;
+    prepared = targetSceneMgr->mParallelRenderPreparation && targetSceneMgr->prepareRenderables(objs, om)
+                   ? targetSceneMgr->mPreparedRenderables.data()
+                   : nullptr;
+    preparedCursor = 0;
     // Use visitor
     objs.acceptVisitor(this, om);
     transparentShadowCastersMode = false;
+    prepared = nullptr;
+}
+//-----------------------------------------------------------------------
+auto SceneManager::prepareRenderables(const QueuedRenderableCollection& objs,
+                                      QueuedRenderableCollection::OrganisationMode om) -> bool
+{
+    // not worth the dispatch below this
+    static const size_t constexpr MIN_RENDERABLES = 64;
+
+    /// Records the renderables in the order they will be visited for rendering
+    struct Recorder : public QueuedRenderableVisitor
+    {
+        std::vector<PreparedRenderable>& list;
+        explicit Recorder(std::vector<PreparedRenderable>& l) : list(l) {}
+        void visit(RenderablePass* rp) override { list.push_back({rp->renderable, 0, 0}); }
+        void visit(const Pass* p, RenderableList& rs) override
+        {
+            (void)p;
+            for (auto r : rs)
+                list.push_back({r, 0, 0});
+        }
+    };
+
+    mPreparedRenderables.clear();
+    Recorder recorder{mPreparedRenderables};
+    objs.acceptVisitor(&recorder, om);
+    if (mPreparedRenderables.size() < MIN_RENDERABLES)
+        return false;
+
+    uint32 numMatrices = 0;
+    for (auto& p : mPreparedRenderables)
+    {
+        p.firstMatrix = numMatrices;
+        p.numMatrices = p.renderable->getNumWorldTransforms();
+        numMatrices += p.numMatrices;
+    }
+    mPreparedMatrices.resize(numMatrices);
+
+    // Same as AutoParamDataSource::getWorldMatrix
+    Root::getSingleton().getWorkQueue()->parallelFor(
+        mPreparedRenderables.size(),
+        [&](size_t i)
+        {
+            const PreparedRenderable& p = mPreparedRenderables[i];
+            Affine3* matrices = &mPreparedMatrices[p.firstMatrix];
+            p.renderable->getWorldTransforms(reinterpret_cast<Matrix4*>(matrices));
+            mAutoParamDataSource->makeCameraRelative(p.renderable, matrices, p.numMatrices);
+        });
+    return true;
+}
+//-----------------------------------------------------------------------
+void SceneManager::setAutoInstancing(bool enabled, unsigned short texCoordIndex)
+{
+    if (texCoordIndex != mAutoInstancingTexCoord || !enabled)
+        destroyInstanceBuffer();
+    mAutoInstancing = enabled;
+    mAutoInstancingTexCoord = texCoordIndex;
+}
+//-----------------------------------------------------------------------
+/// Whether two renderables agree in the custom parameters the programs of a pass read
+static auto sameCustomParameters(const Pass* pass, const Renderable* a, const Renderable* b) -> bool
+{
+    for (auto type : {GpuProgramType::VERTEX_PROGRAM, GpuProgramType::FRAGMENT_PROGRAM})
+    {
+        if (!pass->hasGpuProgram(type))
+            continue;
+
+        for (const auto& entry : pass->_getGpuProgramParameters(type)->getAutoConstantList())
+        {
+            if (entry.paramType != GpuProgramParameters::AutoConstantType::CUSTOM)
+                continue;
+
+            bool hasA = a->hasCustomParameter(entry.data);
+            if (hasA != b->hasCustomParameter(entry.data) ||
+                (hasA && a->getCustomParameter(entry.data) != b->getCustomParameter(entry.data)))
+                return false;
+        }
+    }
+    return true;
+}
+//-----------------------------------------------------------------------
+auto SceneManager::findInstanceRun(const Pass* pass, const RenderableList& rs, size_t begin,
+                                   bool compareLights) -> size_t
+{
+    Renderable* first = rs[begin];
+    if (first->getNumWorldTransforms() != 1 || first->getUseIdentityView() || first->getUseIdentityProjection())
+        return 1;
+
+    RenderOperation firstOp;
+    first->getRenderOperation(firstOp);
+    if (firstOp.numberOfInstances != 1 || !firstOp.useGlobalInstancingVertexBufferIsAvailable)
+        return 1;
+
+    size_t end = begin + 1;
+    for (; end < rs.size(); ++end)
+    {
+        Renderable* r = rs[end];
+        if (r->getNumWorldTransforms() != 1 || r->getUseIdentityView() || r->getUseIdentityProjection() ||
+            !validateRenderableForRendering(pass, r))
+            break;
+
+        RenderOperation op;
+        r->getRenderOperation(op);
+        if (op.vertexData != firstOp.vertexData || op.indexData != firstOp.indexData ||
+            op.operationType != firstOp.operationType || op.useIndexes != firstOp.useIndexes ||
+            op.numberOfInstances != 1 || !op.useGlobalInstancingVertexBufferIsAvailable)
+            break;
+
+        if (compareLights && r->getLights() != first->getLights())
+            break;
+
+        // the parameters are bound once for the run, e.g. the layers of TextureArrayPacker
+        if (!sameCustomParameters(pass, first, r))
+            break;
+    }
+    return end - begin;
+}
+//-----------------------------------------------------------------------
+auto SceneManager::findMultiDrawRun(const Pass* pass, const RenderableList& rs, size_t begin,
+                                    bool compareLights) -> size_t
+{
+    Renderable* first = rs[begin];
+    if (first->getNumWorldTransforms() != 1 || first->getUseIdentityView() || first->getUseIdentityProjection())
+        return 1;
+
+    RenderOperation firstOp;
+    first->getRenderOperation(firstOp);
+    if (firstOp.numberOfInstances != 1)
+        return 1;
+
+    Matrix4 firstTransform;
+    first->getWorldTransforms(&firstTransform);
+
+    size_t end = begin + 1;
+    for (; end < rs.size(); ++end)
+    {
+        Renderable* r = rs[end];
+        if (r->getNumWorldTransforms() != 1 || r->getUseIdentityView() || r->getUseIdentityProjection() ||
+            r->getPolygonModeOverrideable() != first->getPolygonModeOverrideable() ||
+            !validateRenderableForRendering(pass, r))
+            break;
+
+        // drawn with the world matrix and the parameters set up for the first one
+        Matrix4 transform;
+        r->getWorldTransforms(&transform);
+        if (transform != firstTransform)
+            break;
+
+        RenderOperation op;
+        r->getRenderOperation(op);
+        if (op.vertexData != firstOp.vertexData || op.operationType != firstOp.operationType ||
+            op.useIndexes != firstOp.useIndexes || op.numberOfInstances != 1 ||
+            (op.useIndexes && op.indexData->indexBuffer != firstOp.indexData->indexBuffer))
+            break;
+
+        if (compareLights && r->getLights() != first->getLights())
+            break;
+
+        if (!sameCustomParameters(pass, first, r))
+            break;
+    }
+    return end - begin;
+}
+//-----------------------------------------------------------------------
+void SceneManager::prepareInstances(const RenderableList& rs, size_t begin, size_t count,
+                                    const PreparedRenderable* prepared)
+{
+    // three float4 rows per instance, as read by the RTSS instanced transform stage
+    static const size_t constexpr INSTANCE_SIZE = 12 * sizeof(float);
+
+    if (!mInstanceBuffer || mInstanceBuffer->getNumVertices() < count)
+    {
+        size_t capacity = mInstanceBuffer ? mInstanceBuffer->getNumVertices() : 64;
+        while (capacity < count)
+            capacity *= 2;
+
+        auto& hbm = HardwareBufferManager::getSingleton();
+        mInstanceBuffer = hbm.createVertexBuffer(INSTANCE_SIZE, capacity,
+                                                 HardwareBuffer::DYNAMIC_WRITE_ONLY_DISCARDABLE);
+        mInstanceBuffer->setIsInstanceData(true);
+        mInstanceBuffer->setInstanceDataStepRate(1);
+
+        if (!mInstanceDeclaration)
+        {
+            mInstanceDeclaration = hbm.createVertexDeclaration();
+            for (unsigned short row = 0; row < 3; ++row)
+                mInstanceDeclaration->addElement(0, row * 4 * sizeof(float), VertexElementType::FLOAT4,
+                                                 VertexElementSemantic::TEXTURE_COORDINATES,
+                                                 mAutoInstancingTexCoord + row);
+        }
+    }
+
+    HardwareBufferLockGuard lock(mInstanceBuffer, 0, count * INSTANCE_SIZE, HardwareBuffer::LockOptions::DISCARD);
+    auto* dest = static_cast<float*>(lock.pData);
+    for (size_t i = 0; i < count; ++i)
+    {
+        Affine3 world;
+        if (prepared)
+            world = mPreparedMatrices[prepared[i].firstMatrix];
+        else
+        {
+            rs[begin + i]->getWorldTransforms(reinterpret_cast<Matrix4*>(&world));
+            mAutoParamDataSource->makeCameraRelative(rs[begin + i], &world, 1);
+        }
+
+        for (size_t row = 0; row < 3; ++row)
+            for (size_t col = 0; col < 4; ++col)
+                *dest++ = static_cast<float>(world[row][col]);
+    }
+    mCurrentNumInstances = static_cast<uint32>(count);
+}
+//-----------------------------------------------------------------------
+void SceneManager::destroyInstanceBuffer()
+{
+    mInstanceBuffer.reset();
+    if (mInstanceDeclaration)
+    {
+        if (auto hbm = HardwareBufferManager::getSingletonPtr())
+            hbm->destroyVertexDeclaration(mInstanceDeclaration);
+        mInstanceDeclaration = nullptr;
+    }
 }
 //-----------------------------------------------------------------------
 auto SceneManager::validatePassForRendering(const Pass* pass) -> bool
@@ -1691,13 +2817,21 @@ void SceneManager::renderBasicQueueGroupObjects(RenderQueueGroup* pGroup,
     // Iterate through priorities
     auto visitor = mActiveQueuedRenderableVisitor;
 
+    bool depthPrePass = mDepthPrePass && pGroup->getDepthPrePassEnabled() &&
+                        mIlluminationStage == IlluminationRenderStage::NONE;
+    if (depthPrePass)
+        renderDepthPrePass(pGroup, om);
+
     for (const auto& [key, pPriorityGrp] : pGroup->getPriorityGroups())
     {
         // Sort the queue first
-        pPriorityGrp->sort(mCameraInProgress);
+        if (!depthPrePass)
+            sortPriorityGroup(pPriorityGrp.get());
 
         // Do solids
+        mDepthPrePassActive = depthPrePass;
         visitor->renderObjects(pPriorityGrp->getSolidsBasic(), om, true, true);
+        mDepthPrePassActive = false;
         // Do unsorted transparents
         visitor->renderObjects(pPriorityGrp->getTransparentsUnsorted(), om, true, true);
         // Do transparents (always descending)
@@ -1706,6 +2840,171 @@ void SceneManager::renderBasicQueueGroupObjects(RenderQueueGroup* pGroup,
     }// for each priority
 }
 //-----------------------------------------------------------------------
+void SceneManager::renderDepthPrePass(RenderQueueGroup* pGroup, QueuedRenderableCollection::OrganisationMode om)
+{
+    mDepthPrePassPasses.clear();
+
+    // give the RTSS a chance to generate the depth only program
+    MaterialPtr material = MaterialManager::getSingleton().getByName("Ogre/DepthPrePass");
+    material->load();
+    Technique* technique = material->getBestTechnique();
+    if (!technique)
+        return;
+
+    /// Renders the depth of the passes the pre-pass can stand in for
+    struct DepthVisitor : public QueuedRenderableVisitor
+    {
+        SceneManager* sm;
+        Pass* depthPass;
+        const Pass* usedPass{nullptr};
+        /// Passes with a renderable left out, which are rendered the ordinary way
+        std::set<const Pass*> incomplete;
+
+        void visit(const Pass* p, RenderableList& rs) override
+        {
+            if (!sm->validatePassForRendering(p) || !isDepthPrePassCompatible(p))
+                return;
+
+            // only the culling differs between the passes stood in for
+            if (!usedPass || depthPass->getCullingMode() != p->getCullingMode())
+            {
+                depthPass->setCullingMode(p->getCullingMode());
+                usedPass = sm->_setPass(depthPass);
+            }
+
+            bool complete = true;
+            for (Renderable* r : rs)
+            {
+                if (!isDepthPrePassCompatible(r))
+                {
+                    complete = false;
+                    continue;
+                }
+                if (sm->validateRenderableForRendering(usedPass, r))
+                    sm->renderSingleObject(r, usedPass, false, false);
+            }
+            (complete ? sm->mDepthPrePassPasses : incomplete).insert(p);
+        }
+        void visit(RenderablePass* rp) override
+        {
+            RenderableList rs{rp->renderable};
+            visit(rp->pass, rs);
+        }
+    } visitor;
+    visitor.sm = this;
+    visitor.depthPass = technique->getPass(0);
+
+    for (const auto& [key, pPriorityGrp] : pGroup->getPriorityGroups())
+    {
+        sortPriorityGroup(pPriorityGrp.get());
+        pPriorityGrp->getSolidsBasic().acceptVisitor(&visitor, om);
+    }
+
+    // renderables of the same pass may be spread over the priority groups
+    for (const Pass* pass : visitor.incomplete)
+        mDepthPrePassPasses.erase(pass);
+}
+//-----------------------------------------------------------------------
+auto SceneManager::isDepthPrePassCompatible(const Pass* pass) -> bool
+{
+    if (pass->getIndex() > 0 || !pass->getDepthCheckEnabled() || !pass->getDepthWriteEnabled() ||
+        pass->getDepthFunction() != CompareFunction::LESS_EQUAL || pass->isTransparent() ||
+        pass->getAlphaRejectFunction() != CompareFunction::ALWAYS_PASS || pass->isAlphaToCoverageEnabled() ||
+        pass->getDepthBiasConstant() != 0 || pass->getDepthBiasSlopeScale() != 0 ||
+        pass->getPolygonMode() != PolygonMode::SOLID)
+        return false;
+
+    if (pass->hasGeometryProgram() || pass->hasTessellationHullProgram() || pass->hasTessellationDomainProgram())
+        return false;
+
+    // the depth only program transforms the positions as they are
+    if (pass->hasVertexProgram())
+    {
+        const GpuProgramPtr& program = pass->getVertexProgram();
+        if (program->isSkeletalAnimationIncluded() || program->isMorphAnimationIncluded() ||
+            program->isPoseAnimationIncluded() || program->isVertexTextureFetchRequired())
+            return false;
+    }
+    return true;
+}
+//-----------------------------------------------------------------------
+auto SceneManager::isDepthPrePassCompatible(Renderable* rend) -> bool
+{
+    // blended or instanced matrices are left to the programs of the renderable
+    if (rend->getNumWorldTransforms() > 1)
+        return false;
+
+    RenderOperation op;
+    rend->getRenderOperation(op);
+    return op.numberOfInstances <= 1 &&
+           !(op.vertexData && op.vertexData->vertexBufferBinding->hasInstanceData());
+}
+//-----------------------------------------------------------------------
+void SceneManager::sortPriorityGroup(RenderPriorityGroup* group)
+{
+    Timer* timer = Root::getSingleton().getTimer();
+    uint64 startTime = timer->getMicroseconds();
+    group->sort(mCameraInProgress);
+    currentRenderLoopStats().sortMicroseconds += timer->getMicroseconds() - startTime;
+}
+//-----------------------------------------------------------------------
+auto SceneManager::currentRenderLoopStats() -> RenderLoopStats&
+{
+    unsigned long frameNumber = Root::getSingleton().getNextFrameNumber();
+    if (frameNumber != mRenderLoopStatsFrame)
+    {
+        mRenderLoopStats = RenderLoopStats{};
+        mRenderLoopStatsFrame = frameNumber;
+    }
+    return mRenderLoopStats;
+}
+//-----------------------------------------------------------------------
+auto SceneManager::getRenderLoopStats() const -> RenderLoopStats
+{
+    unsigned long frameNumber = Root::getSingleton().getNextFrameNumber();
+    RenderLoopStats stats;
+    if (mRenderLoopStatsFrame == frameNumber)
+        stats = mRenderLoopStats;
+    if (mSceneGraphUpdateStatsFrame == frameNumber)
+        stats.nodesUpdated = mSceneGraphUpdateStats.nodesUpdated;
+    if (mPassStateStatsFrame == frameNumber)
+        stats.passChanges = mPassStateStats.passesSet;
+    return stats;
+}
+//-----------------------------------------------------------------------
+void SceneManager::_publishRenderLoopStats() const
+{
+    RenderLoopStats stats = getRenderLoopStats();
+    Profiler& profiler = Profiler::getSingleton();
+    FrameString name{Root::getSingleton().getFrameAllocator()};
+    auto publish = [&](std::string_view counter, uint64 value)
+    {
+        name.clear();
+        std::format_to(std::back_inserter(name), "{}/{}", mName, counter);
+        profiler.setCounter(name, value);
+    };
+
+    publish("nodesUpdated", stats.nodesUpdated);
+    publish("nodesCulled", stats.nodesCulled);
+    publish("objectsVisible", stats.objectsVisible);
+    publish("objectsRejected", stats.objectsRejected);
+    publish("renderablesQueued", stats.renderablesQueued);
+    publish("sortMicroseconds", stats.sortMicroseconds);
+    publish("passChanges", stats.passChanges);
+    publish("autoConstantsUpdated", stats.autoConstantsUpdated);
+    publish("autoConstantsSkipped", stats.autoConstantsSkipped);
+    publish("updateMicroseconds", stats.updateMicroseconds);
+    publish("cullMicroseconds", stats.cullMicroseconds);
+    publish("submitMicroseconds", stats.submitMicroseconds);
+    publish("shadowMicroseconds", stats.shadowMicroseconds);
+    publish("compositorMicroseconds", stats.compositorMicroseconds);
+}
+//-----------------------------------------------------------------------
+void SceneManager::_notifyCompositorTime(uint64 microseconds)
+{
+    currentRenderLoopStats().compositorMicroseconds += microseconds;
+}
+//-----------------------------------------------------------------------
 void SceneManager::setWorldTransform(Renderable* rend)
 {
     // Issue view / projection changes if any
@@ -1771,6 +3070,16 @@ void SceneManager::renderSingleObject(Renderable* rend, const Pass* pass,
 {
     // Tell auto params object about the renderable change
     mAutoParamDataSource->setCurrentRenderable(rend);
+    if (mCurrentNumInstances)
+    {
+        // the world matrices are in the instance buffer
+        mAutoParamDataSource->setWorldMatrices(&Affine3::IDENTITY, 1);
+    }
+    else if (mCurrentPreparedRenderable)
+    {
+        mAutoParamDataSource->setWorldMatrices(&mPreparedMatrices[mCurrentPreparedRenderable->firstMatrix],
+                                               mCurrentPreparedRenderable->numMatrices);
+    }
 
     setWorldTransform(rend);
 
@@ -1809,6 +3118,7 @@ void SceneManager::renderSingleObject(Renderable* rend, const Pass* pass,
         // for same pass
         if (cullMode != mDestRenderSystem->_getCullingMode())
             mDestRenderSystem->_setCullingMode(cullMode);
+        mLastPassState.cullingMode = cullMode;
     }
 
     // Set up the solid / wireframe override
@@ -1866,7 +3176,7 @@ void SceneManager::renderSingleObject(Renderable* rend, const Pass* pass,
     size_t depthInc = 0;
 
     // Create local light list for faster light iteration setup
-    static LightList localLightList;
+    thread_local LightList localLightList;
 
     while (lightsLeft > 0)
     {
@@ -1916,9 +3226,10 @@ void SceneManager::renderSingleObject(Renderable* rend, const Pass* pass,
                     TextureUnitState* tu = pass->getTextureUnitState(tuindex);
                     const TexturePtr& shadowTex = mShadowRenderer.mShadowTextures[shadowTexIndex];
                     tu->_setTexturePtr(shadowTex);
-                    Camera *cam = shadowTex->getBuffer()->getRenderTarget()->getViewport(0)->getCamera();
+                    Camera *cam = mShadowRenderer.mShadowTextureCameras[shadowTexIndex];
                     tu->setProjectiveTexturing(!pass->hasVertexProgram(), cam);
-                    mAutoParamDataSource->setTextureProjector(cam, numShadowTextureLights);
+                    mAutoParamDataSource->setTextureProjector(cam, numShadowTextureLights,
+                        mShadowRenderer.getShadowTextureTile(shadowTexIndex));
                     ++numShadowTextureLights;
                     ++shadowTexIndex;
                     // Have to set TU on rendersystem right now, although
@@ -2228,7 +3539,7 @@ void SceneManager::_applySceneAnimations()
     {
         Animation* anim = getAnimation(state->getAnimationName());
         // Apply the animation
-        anim->apply(state->getTimePosition(), state->getWeight());
+        anim->apply(state->getTimePosition(), state->getWeight(), 1.0f, state->_getKeyIndexHint());
     }
 }
 //---------------------------------------------------------------------
@@ -2402,6 +3713,8 @@ auto SceneManager::fireRenderQueueStarted(Ogre::RenderQueueGroupID id, std::stri
     for (auto & mRenderQueueListener : mRenderQueueListeners)
     {
         mRenderQueueListener->renderQueueStarted(id, invocation, skip);
+        // listeners may change the render state, e.g. compositor operations
+        mLastPassStateValid = false;
     }
     return skip;
 }
@@ -2413,6 +3726,7 @@ auto SceneManager::fireRenderQueueEnded(Ogre::RenderQueueGroupID id, std::string
     for (auto & mRenderQueueListener : mRenderQueueListeners)
     {
         mRenderQueueListener->renderQueueEnded(id, invocation, repeat);
+        mLastPassStateValid = false;
     }
     return repeat;
 }
@@ -2479,6 +3793,8 @@ void SceneManager::fireSceneManagerDestroyed()
 void SceneManager::setViewport(Viewport* vp)
 {
     mCurrentViewport = vp;
+    // The render state may have changed since the last pass
+    mLastPassStateValid = false;
     // Tell params about viewport
     mAutoParamDataSource->setCurrentViewport(vp);
     // Set viewport in render system
@@ -2980,6 +4296,9 @@ void SceneManager::prepareShadowTextures(Camera* cam, Viewport* vp, const LightL
     if (lightList == nullptr)
         lightList = &mLightsAffectingFrustum;
 
+    Timer* timer = Root::getSingleton().getTimer();
+    uint64 startTime = timer->getMicroseconds();
+
     try
     {
         mShadowRenderer.prepareShadowTextures(cam, vp, lightList);
@@ -2992,6 +4311,7 @@ void SceneManager::prepareShadowTextures(Camera* cam, Viewport* vp, const LightL
     }
 
     mIlluminationStage = savedStage;
+    currentRenderLoopStats().shadowMicroseconds += timer->getMicroseconds() - startTime;
 }
 //---------------------------------------------------------------------
 auto SceneManager::_pauseRendering() -> SceneManager::RenderContext*
@@ -3018,7 +4338,7 @@ void SceneManager::_resumeRendering(SceneManager::RenderContext* context)
     setViewport(vp);
 
     // Tell params about camera
-    mAutoParamDataSource->setCurrentCamera(camera, mCameraRelativeRendering);
+    mAutoParamDataSource->setCurrentCamera(camera, mCameraRelativeRendering, mLargeWorldRendering);
     // Set autoparams for finite dir light extrusion
     mAutoParamDataSource->setShadowDirLightExtrusionDistance(mShadowRenderer.mShadowDirLightExtrudeDist);
 
@@ -3080,6 +4400,7 @@ void SceneManager::destroyStaticGeometry(std::string_view name)
     auto i = mStaticGeometryList.find(name);
     if (i != mStaticGeometryList.end())
     {
+        _notifyVisibleObjectsChanged();
         delete i->second;
         mStaticGeometryList.erase(i);
     }
@@ -3088,6 +4409,7 @@ void SceneManager::destroyStaticGeometry(std::string_view name)
 //---------------------------------------------------------------------
 void SceneManager::destroyAllStaticGeometry()
 {
+    _notifyVisibleObjectsChanged();
     for (auto & i : mStaticGeometryList)
     {
         delete i.second;
@@ -3144,6 +4466,7 @@ void SceneManager::destroyInstanceManager( std::string_view name )
     auto i = mInstanceManagerMap.find(name);
     if (i != mInstanceManagerMap.end())
     {
+        _notifyVisibleObjectsChanged();
         delete i->second;
         mInstanceManagerMap.erase(i);
     }
@@ -3156,6 +4479,7 @@ void SceneManager::destroyInstanceManager( InstanceManager *instanceManager )
 //---------------------------------------------------------------------
 void SceneManager::destroyAllInstanceManagers()
 {
+    _notifyVisibleObjectsChanged();
     for (auto const& itor : mInstanceManagerMap)
     {
         delete itor.second;
@@ -3198,6 +4522,7 @@ void SceneManager::destroyInstancedEntity( InstancedEntity *instancedEntity )
 //---------------------------------------------------------------------
 void SceneManager::_addDirtyInstanceManager( InstanceManager *dirtyManager )
 {
+    std::unique_lock<std::mutex> dirtyLock(mDirtyInstanceManagersMutex);
     mDirtyInstanceManagers.push_back( dirtyManager );
 }
 //---------------------------------------------------------------------
@@ -3269,6 +4594,15 @@ SceneManager::createRayQuery(const Ray& ray, QueryTypeMask mask) -> ::std::uniqu
 }
 //---------------------------------------------------------------------
 auto
+SceneManager::createRayBatchQuery(const std::vector<Ray>& rays, QueryTypeMask mask) -> ::std::unique_ptr<RayBatchSceneQuery>
+{
+    ::std::unique_ptr<RayBatchSceneQuery> q{ new DefaultRayBatchSceneQuery(this)};
+    q->setRays(rays);
+    q->setQueryMask(mask);
+    return q;
+}
+//---------------------------------------------------------------------
+auto
 SceneManager::createIntersectionQuery(QueryTypeMask mask) -> ::std::unique_ptr<IntersectionSceneQuery>
 {
 
@@ -3336,7 +4670,7 @@ auto SceneManager::createMovableObject(std::string_view name,
     }
 
     MovableObject* newObj = factory->createInstance(name, this, params);
-    objectMap->map[std::string{name}] = newObj;
+    objectMap->map.emplace(name, newObj);
     return newObj;
 }
 //---------------------------------------------------------------------
@@ -3361,6 +4695,7 @@ void SceneManager::destroyMovableObject(std::string_view name, std::string_view
     auto mi = objectMap->map.find(name);
     if (mi != objectMap->map.end())
     {
+        _notifyVisibleObjectsChanged();
         factory->destroyInstance(mi->second);
         objectMap->map.erase(mi);
     }
@@ -3378,6 +4713,7 @@ void SceneManager::destroyAllMovableObjectsByType(std::string_view typeName)
     MovableObjectFactory* factory = 
         Root::getSingleton().getMovableObjectFactory(typeName);
 
+    _notifyVisibleObjectsChanged();
     for (auto const& i : objectMap->map)
     {
         // Only destroy our own
@@ -3391,6 +4727,7 @@ void SceneManager::destroyAllMovableObjectsByType(std::string_view typeName)
 //---------------------------------------------------------------------
 void SceneManager::destroyAllMovableObjects()
 {
+    _notifyVisibleObjectsChanged();
     for(auto const& [key, coll] : mMovableObjectCollectionMap)
     {
         if (Root::getSingleton().hasMovableObjectFactory(key))
@@ -3509,8 +4846,8 @@ auto SceneManager::getDestinationRenderSystem() -> RenderSystem *
 //---------------------------------------------------------------------
 auto SceneManager::_getCombinedVisibilityMask() const -> QueryTypeMask
 {
-    return mCurrentViewport ?
-        mCurrentViewport->getVisibilityMask() & mVisibilityMask : mVisibilityMask;
+    const Viewport* vp = msCullingViewport ? msCullingViewport : mCurrentViewport;
+    return vp ? vp->getVisibilityMask() & mVisibilityMask : mVisibilityMask;
 
 }
 //---------------------------------------------------------------------
@@ -3554,6 +4891,9 @@ void SceneManager::removeLodListener(LodListener *listener)
 //---------------------------------------------------------------------
 void SceneManager::_notifyMovableObjectLodChanged(MovableObjectLodChangedEvent& evt)
 {
+    // may be raised by several threads, see setParallelFindVisibleObjects
+    std::unique_lock<std::mutex> lock(mLodEventMutex);
+
     // Notify listeners and determine if event needs to be queued
     bool queueEvent = false;
     for (auto mLodListener : mLodListeners)
@@ -3569,6 +4909,8 @@ void SceneManager::_notifyMovableObjectLodChanged(MovableObjectLodChangedEvent&
 //---------------------------------------------------------------------
 void SceneManager::_notifyEntityMeshLodChanged(EntityMeshLodChangedEvent& evt)
 {
+    std::unique_lock<std::mutex> lock(mLodEventMutex);
+
     // Notify listeners and determine if event needs to be queued
     bool queueEvent = false;
     for (auto mLodListener : mLodListeners)
@@ -3584,6 +4926,8 @@ void SceneManager::_notifyEntityMeshLodChanged(EntityMeshLodChangedEvent& evt)
 //---------------------------------------------------------------------
 void SceneManager::_notifyEntityMaterialLodChanged(EntityMaterialLodChangedEvent& evt)
 {
+    std::unique_lock<std::mutex> lock(mLodEventMutex);
+
     // Notify listeners and determine if event needs to be queued
     bool queueEvent = false;
     for (auto mLodListener : mLodListeners)
@@ -3665,7 +5009,7 @@ void SceneManager::updateGpuProgramParameters(const Pass* pass)
             auto t = (GpuProgramType)i;
             if (pass->hasGpuProgram(t))
             {
-                mDestRenderSystem->bindGpuProgramParameters(t, pass->getGpuProgramParameters(t),
+                mDestRenderSystem->bindGpuProgramParameters(t, pass->_getGpuProgramParameters(t),
                                                             mGpuParamsDirty);
             }
         }
@@ -3678,6 +5022,11 @@ void SceneManager::updateGpuProgramParameters(const Pass* pass)
         mDestRenderSystem->applyFixedFunctionParams(mFixedFunctionParams, mGpuParamsDirty);
     }
 
+    auto [updated, skipped] = mAutoParamDataSource->_takeAutoConstantCounts();
+    RenderLoopStats& loopStats = currentRenderLoopStats();
+    loopStats.autoConstantsUpdated += updated;
+    loopStats.autoConstantsSkipped += skipped;
+
     mGpuParamsDirty = {};
 }
 //---------------------------------------------------------------------
@@ -3687,6 +5036,34 @@ void SceneManager::_issueRenderOp(Renderable* rend, const Pass* pass)
     if(pass)
         updateGpuProgramParameters(pass);
 
+    if (!mCurrentMultiDraw.empty())
+    {
+        // the rest of the run shares the state set up for rend, see findMultiDrawRun
+        mMultiDrawOps.clear();
+        auto addOp = [this](Renderable* r)
+        {
+            if (!r->preRender(this, mDestRenderSystem))
+                return;
+            RenderOperation& op = mMultiDrawOps.emplace_back();
+            op.srcRenderable = r;
+            r->getRenderOperation(op);
+        };
+        addOp(rend);
+        for (Renderable* r : mCurrentMultiDraw)
+            addOp(r);
+
+        mMultiDrawOpPointers.clear();
+        for (const auto& op : mMultiDrawOps)
+            mMultiDrawOpPointers.push_back(&op);
+        if (!mMultiDrawOpPointers.empty())
+            mDestRenderSystem->_renderMultiple(mMultiDrawOpPointers);
+
+        rend->postRender(this, mDestRenderSystem);
+        for (Renderable* r : mCurrentMultiDraw)
+            r->postRender(this, mDestRenderSystem);
+        return;
+    }
+
     if(rend->preRender(this, mDestRenderSystem))
     {
         RenderOperation ro;
@@ -3694,7 +5071,17 @@ void SceneManager::_issueRenderOp(Renderable* rend, const Pass* pass)
 
         rend->getRenderOperation(ro);
 
-        mDestRenderSystem->_render(ro);
+        if (mCurrentNumInstances)
+        {
+            ro.numberOfInstances = mCurrentNumInstances;
+            mDestRenderSystem->setGlobalInstanceVertexBuffer(mInstanceBuffer);
+            mDestRenderSystem->setGlobalInstanceVertexBufferVertexDeclaration(mInstanceDeclaration);
+            mDestRenderSystem->_render(ro);
+            mDestRenderSystem->setGlobalInstanceVertexBuffer(nullptr);
+            mDestRenderSystem->setGlobalInstanceVertexBufferVertexDeclaration(nullptr);
+        }
+        else
+            mDestRenderSystem->_render(ro);
     }
 
     rend->postRender(this, mDestRenderSystem);
@@ -3728,6 +5115,16 @@ void VisibleObjectsBoundsInfo::merge(const AxisAlignedBox& boxBounds, const Sphe
     maxDistanceInFrustum = std::max(maxDistanceInFrustum, camDistToCenter + sphereBounds.getRadius());
 }
 //---------------------------------------------------------------------
+void VisibleObjectsBoundsInfo::merge(const VisibleObjectsBoundsInfo& rhs)
+{
+    aabb.merge(rhs.aabb);
+    receiverAabb.merge(rhs.receiverAabb);
+    minDistance = std::min(minDistance, rhs.minDistance);
+    maxDistance = std::max(maxDistance, rhs.maxDistance);
+    minDistanceInFrustum = std::min(minDistanceInFrustum, rhs.minDistanceInFrustum);
+    maxDistanceInFrustum = std::max(maxDistanceInFrustum, rhs.maxDistanceInFrustum);
+}
+//---------------------------------------------------------------------
 void VisibleObjectsBoundsInfo::mergeNonRenderedButInFrustum(const AxisAlignedBox& boxBounds, 
                                   const Sphere& sphereBounds, const Camera* cam)
 {
@@ -55,6 +55,7 @@ namespace Ogre {
          
     {
         addFactory(&mDefaultFactory);
+        addFactory(&mOctreeFactory);
 
     }
     //-----------------------------------------------------------------------
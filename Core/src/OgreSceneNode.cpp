@@ -36,6 +36,7 @@ import :Camera;
 import :Codec;
 import :Common;
 import :Exception;
+import :Frustum;
 import :Math;
 import :Matrix3;
 import :MovableObject;
@@ -89,6 +90,13 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     void SceneNode::_update(bool updateChildren, bool parentHasChanged)
     {
+        // Static branch, the bounds can't have changed either
+        if (!parentHasChanged && !_isUpdatePending())
+        {
+            mParentNotified = false;
+            return;
+        }
+
         Node::_update(updateChildren, parentHasChanged);
         _updateBounds();
     }
@@ -259,7 +267,25 @@ namespace Ogre {
     {
         // Check self visible
         if (!cam->isVisible(mWorldAABB))
+        {
+            queue->_notifyNodesCulled(1);
             return;
+        }
+
+        addVisibleObjects(cam, queue, visibleBounds, includeChildren, displayNodes, onlyShadowCasters);
+    }
+    //-----------------------------------------------------------------------
+    void SceneNode::addVisibleObjects(Camera* cam, RenderQueue* queue,
+        VisibleObjectsBoundsInfo* visibleBounds, bool includeChildren,
+        bool displayNodes, bool onlyShadowCasters, std::vector<SceneNode*>* drawnNodes)
+    {
+        // Rejected nodes hide their whole subtree, e.g. when occluded
+        if (mCreator && ((!mObjectsByName.empty() && !mCreator->_passesVisibilityStages(this, mWorldAABB)) ||
+                         !mCreator->_passesShadowCasterCulling(mWorldAABB)))
+        {
+            queue->_notifyNodesCulled(1);
+            return;
+        }
 
         // Add all entities
         for (auto mo : mObjectsByName)
@@ -267,27 +293,44 @@ namespace Ogre {
             queue->processVisibleObject(mo, cam, onlyShadowCasters, visibleBounds);
         }
 
-        if (includeChildren)
+        const auto& children = getChildren();
+        if (includeChildren && !children.empty())
         {
-            for (auto child : getChildren())
+            AxisAlignedBoxBatch batch;
+            uint8 visible[AxisAlignedBoxBatch::CAPACITY];
+            for (size_t begin = 0; begin < children.size(); begin += AxisAlignedBoxBatch::CAPACITY)
             {
-                auto* sceneChild = static_cast<SceneNode*>(child);
-                sceneChild->_findVisibleObjects(cam, queue, visibleBounds, includeChildren, 
-                    displayNodes, onlyShadowCasters);
+                size_t end = std::min(begin + AxisAlignedBoxBatch::CAPACITY, children.size());
+
+                batch.clear();
+                for (size_t i = begin; i < end; ++i)
+                    batch.push_back(static_cast<SceneNode*>(children[i])->mWorldAABB);
+                cam->isVisible(batch, visible);
+
+                for (size_t i = begin; i < end; ++i)
+                {
+                    if (visible[i - begin])
+                        static_cast<SceneNode*>(children[i])->addVisibleObjects(
+                            cam, queue, visibleBounds, includeChildren, displayNodes, onlyShadowCasters, drawnNodes);
+                    else
+                        queue->_notifyNodesCulled(1);
+                }
             }
         }
 
-        if (mCreator && mCreator->getDebugDrawer())
+        if (drawnNodes)
+        {
+            drawnNodes->push_back(this);
+        }
+        else if (mCreator && mCreator->getDebugDrawer())
         {
             mCreator->getDebugDrawer()->drawSceneNode(this);
         }
     }
 
     //-----------------------------------------------------------------------
-    void SceneNode::updateFromParentImpl() const
+    void SceneNode::derivedTransformUpdated() const
     {
-        Node::updateFromParentImpl();
-
         // Notify objects that it has been moved
         for (auto o : mObjectsByName)
         {
@@ -307,6 +350,11 @@ namespace Ogre {
         return mCreator->createSceneNode(name);
     }
     //-----------------------------------------------------------------------
+    auto SceneNode::getQueuedUpdates() -> QueuedUpdates*
+    {
+        return mCreator ? mCreator->_getQueuedNodeUpdates() : Node::getQueuedUpdates();
+    }
+    //-----------------------------------------------------------------------
     void SceneNode::removeAndDestroyChild(std::string_view name)
     {
         auto* pChild = static_cast<SceneNode*>(getChild(name));
@@ -32,11 +32,17 @@ module;
 
 module Ogre.Core;
 
+import :Entity;
 import :Exception;
+import :Matrix3;
+import :Matrix4;
+import :Mesh;
+import :MeshTriangleBVH;
 import :SceneManager;
 import :SceneQuery;
 
 import <algorithm>;
+import <vector>;
 
 namespace Ogre {
     //-----------------------------------------------------------------------
@@ -230,6 +236,23 @@ namespace Ogre {
         return mMaxResults;
     }
     //-----------------------------------------------------------------------
+    auto RaySceneQuery::intersectsObject(MovableObject* obj) const -> RayTestResult
+    {
+        RayTestResult result = mRay.intersects(obj->getWorldBoundingBox());
+        if (!result.first || !mPreciseMeshHits || obj->getMovableType() != EntityFactory::FACTORY_TYPE_NAME)
+            return result;
+
+        const MeshPtr& mesh = static_cast<Entity*>(obj)->getMesh();
+        if (!mesh || !mesh->isLoaded())
+            return result;
+
+        // into the space of the mesh, without normalising so the distance stays the same
+        Affine3 toMesh = obj->_getParentNodeFullTransform().inverse();
+        Ray localRay{toMesh * mRay.getOrigin(), toMesh.linear() * mRay.getDirection()};
+        MeshTriangleBVH::Hit hit = mesh->getTriangleBVH().intersects(localRay);
+        return {hit.hit, hit.distance};
+    }
+    //-----------------------------------------------------------------------
     auto RaySceneQuery::execute() -> RaySceneQueryResult&
     {
         // Clear without freeing the vector buffer
@@ -291,6 +314,91 @@ namespace Ogre {
         return true;
     }
     //-----------------------------------------------------------------------
+    RayBatchSceneQuery::RayBatchSceneQuery(SceneManager* mgr) : SceneQuery(mgr)
+    {
+    }
+    //-----------------------------------------------------------------------
+    RayBatchSceneQuery::~RayBatchSceneQuery()
+    = default;
+    //-----------------------------------------------------------------------
+    void RayBatchSceneQuery::setRays(const std::vector<Ray>& rays)
+    {
+        mRays = rays;
+    }
+    //-----------------------------------------------------------------------
+    auto RayBatchSceneQuery::getRays() const noexcept -> const std::vector<Ray>&
+    {
+        return mRays;
+    }
+    //-----------------------------------------------------------------------
+    void RayBatchSceneQuery::setSortByDistance(bool sort, ushort maxresults)
+    {
+        mSortByDistance = sort;
+        mMaxResults = maxresults;
+    }
+    //-----------------------------------------------------------------------
+    auto RayBatchSceneQuery::getSortByDistance() const noexcept -> bool
+    {
+        return mSortByDistance;
+    }
+    //-----------------------------------------------------------------------
+    auto RayBatchSceneQuery::getMaxResults() const noexcept -> ushort
+    {
+        return mMaxResults;
+    }
+    //-----------------------------------------------------------------------
+    auto RayBatchSceneQuery::execute() -> RayBatchSceneQueryResult&
+    {
+        // Clear without freeing the vector buffers
+        mResult.resize(mRays.size());
+        for (auto& r : mResult)
+            r.clear();
+
+        // Call callback version with self as listener
+        this->execute(static_cast<RayBatchSceneQueryListener*>(this));
+
+        if (mSortByDistance)
+        {
+            for (auto& r : mResult)
+            {
+                if (mMaxResults != 0 && mMaxResults < r.size())
+                {
+                    // Partially sort the N smallest elements, discard others
+                    std::partial_sort(r.begin(), r.begin()+mMaxResults, r.end());
+                    r.resize(mMaxResults);
+                }
+                else
+                {
+                    std::ranges::sort(r);
+                }
+            }
+        }
+
+        return mResult;
+    }
+    //-----------------------------------------------------------------------
+    auto RayBatchSceneQuery::getLastResults() noexcept -> RayBatchSceneQueryResult&
+    {
+        return mResult;
+    }
+    //-----------------------------------------------------------------------
+    void RayBatchSceneQuery::clearResults()
+    {
+        RayBatchSceneQueryResult().swap(mResult);
+    }
+    //-----------------------------------------------------------------------
+    auto RayBatchSceneQuery::queryResult(size_t rayIndex, MovableObject* obj, Real distance) -> bool
+    {
+        // Add to internal list
+        RaySceneQueryResultEntry dets;
+        dets.distance = distance;
+        dets.movable = obj;
+        dets.worldFragment = nullptr;
+        mResult[rayIndex].push_back(dets);
+        // Continue
+        return true;
+    }
+    //-----------------------------------------------------------------------
     IntersectionSceneQuery::IntersectionSceneQuery(SceneManager* mgr)
     : SceneQuery(mgr) 
     {
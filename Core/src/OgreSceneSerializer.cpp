@@ -0,0 +1,599 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+module;
+
+#include <cstddef>
+
+module Ogre.Core;
+
+import :Entity;
+import :Exception;
+import :FileSystem;
+import :InstanceBatch;
+import :InstanceManager;
+import :InstancedEntity;
+import :Light;
+import :LogManager;
+import :Material;
+import :MaterialManager;
+import :Mesh;
+import :MeshManager;
+import :MovableObject;
+import :SceneManager;
+import :SceneNode;
+import :SceneSerializer;
+import :StaticGeometry;
+import :StreamSerialiser;
+import :SubEntity;
+import :SubMesh;
+
+import <algorithm>;
+import <format>;
+import <ios>;
+import <map>;
+import <unordered_map>;
+import <unordered_set>;
+import <utility>;
+import <vector>;
+
+namespace Ogre
+{
+namespace {
+    const uint32 SCENE_CHUNK_ID = StreamSerialiser::makeIdentifier("OSCN"); // Ogre scene snapshot
+    const uint32 NODES_CHUNK_ID = StreamSerialiser::makeIdentifier("SNOD");
+    const uint32 OBJECTS_CHUNK_ID = StreamSerialiser::makeIdentifier("SOBJ");
+    const uint32 STATIC_GEOMETRY_CHUNK_ID = StreamSerialiser::makeIdentifier("SSTG");
+    const uint32 INSTANCING_CHUNK_ID = StreamSerialiser::makeIdentifier("SINS");
+    const uint16 SCENE_VERSION = 1;
+
+    void writeString(StreamSerialiser& stream, std::string_view str)
+    {
+        String s{str};
+        stream.write(&s);
+    }
+
+    auto readString(StreamSerialiser& stream) -> String
+    {
+        String s;
+        stream.read(&s);
+        return s;
+    }
+
+    /// What Entity and Light share
+    void writeMovable(StreamSerialiser& stream, const MovableObject* obj)
+    {
+        bool flags[] = {obj->getVisible(), obj->getCastShadows()};
+        stream.write(flags, 2);
+        auto queue = std::to_underlying(obj->getRenderQueueGroup());
+        stream.write(&queue);
+        uint32 masks[] = {std::to_underlying(obj->getQueryFlags()), std::to_underlying(obj->getVisibilityFlags()),
+                          std::to_underlying(obj->getLightMask())};
+        stream.write(masks, 3);
+        Real distance = obj->getRenderingDistance();
+        stream.write(&distance);
+    }
+
+    void readMovable(StreamSerialiser& stream, MovableObject* obj)
+    {
+        bool flags[2];
+        stream.read(flags, 2);
+        obj->setVisible(flags[0]);
+        obj->setCastShadows(flags[1]);
+        std::underlying_type_t<RenderQueueGroupID> queue;
+        stream.read(&queue);
+        obj->setRenderQueueGroup(static_cast<RenderQueueGroupID>(queue));
+        uint32 masks[3];
+        stream.read(masks, 3);
+        obj->setQueryFlags(static_cast<QueryTypeMask>(masks[0]));
+        obj->setVisibilityFlags(static_cast<QueryTypeMask>(masks[1]));
+        obj->setLightMask(static_cast<QueryTypeMask>(masks[2]));
+        Real distance;
+        stream.read(&distance);
+        obj->setRenderingDistance(distance);
+    }
+}
+    //---------------------------------------------------------------------
+    void SceneSerializer::exportScene(SceneManager* sceneMgr, std::string_view filename)
+    {
+        exportScene(sceneMgr, _openFileStream(filename, std::ios::binary | std::ios::out));
+    }
+    //---------------------------------------------------------------------
+    void SceneSerializer::exportScene(SceneManager* sceneMgr, const DataStreamPtr& stream)
+    {
+        StreamSerialiser serialiser(stream);
+        serialiser.writeChunkBegin(SCENE_CHUNK_ID, SCENE_VERSION);
+        writeNodes(serialiser, sceneMgr);
+        writeObjects(serialiser, sceneMgr);
+        writeStaticGeometry(serialiser, sceneMgr);
+        writeInstancing(serialiser, sceneMgr);
+        serialiser.writeChunkEnd(SCENE_CHUNK_ID);
+
+        mNodeIndices.clear();
+    }
+    //---------------------------------------------------------------------
+    void SceneSerializer::importScene(const DataStreamPtr& stream, SceneManager* sceneMgr, SceneNode* parent)
+    {
+        StreamSerialiser serialiser(stream);
+        if (!serialiser.readChunkBegin(SCENE_CHUNK_ID, SCENE_VERSION, "SceneSerializer"))
+            OGRE_EXCEPT(ExceptionCodes::INVALIDPARAMS, ::std::format("'{}' is no scene snapshot", stream->getName()));
+
+        if (!parent)
+            parent = sceneMgr->getRootSceneNode();
+
+        while (!serialiser.isEndOfChunk(SCENE_CHUNK_ID))
+        {
+            const StreamSerialiser::Chunk* chunk = serialiser.readChunkBegin();
+            uint32 id = chunk->id;
+            if (id == NODES_CHUNK_ID)
+                readNodes(serialiser, sceneMgr, parent);
+            else if (id == OBJECTS_CHUNK_ID)
+                readObjects(serialiser, sceneMgr);
+            else if (id == STATIC_GEOMETRY_CHUNK_ID)
+                readStaticGeometry(serialiser, sceneMgr);
+            else if (id == INSTANCING_CHUNK_ID)
+                readInstancing(serialiser, sceneMgr);
+            // unknown chunks are skipped
+            serialiser.readChunkEnd(id);
+        }
+        serialiser.readChunkEnd(SCENE_CHUNK_ID);
+
+        mNodes.clear();
+        mMeshes.clear();
+        mMaterials.clear();
+    }
+    //---------------------------------------------------------------------
+    auto SceneSerializer::getNodeIndex(const Node* node) const -> uint32
+    {
+        auto it = mNodeIndices.find(node);
+        return it != mNodeIndices.end() ? it->second : NO_NODE;
+    }
+    //---------------------------------------------------------------------
+    auto SceneSerializer::getNode(uint32 index) const -> SceneNode*
+    {
+        if (index == NO_NODE)
+            return nullptr;
+        if (index >= mNodes.size())
+            OGRE_EXCEPT(ExceptionCodes::INVALIDPARAMS, ::std::format("Invalid node index {} in scene snapshot", index));
+        return mNodes[index];
+    }
+    //---------------------------------------------------------------------
+    auto SceneSerializer::getMesh(StreamSerialiser& stream) -> const MeshPtr&
+    {
+        String name = readString(stream);
+        String group = readString(stream);
+        auto [it, added] = mMeshes.try_emplace({name, group});
+        if (added)
+            it->second = MeshManager::getSingleton().load(name, group);
+        return it->second;
+    }
+    //---------------------------------------------------------------------
+    auto SceneSerializer::getMaterial(StreamSerialiser& stream) -> const MaterialPtr&
+    {
+        String name = readString(stream);
+        String group = readString(stream);
+        auto [it, added] = mMaterials.try_emplace({name, group});
+        if (added)
+        {
+            it->second = MaterialManager::getSingleton().getByName(name, group);
+            if (!it->second)
+                LogManager::getSingleton().logWarning(
+                    std::format("SceneSerializer: material '{}' of group '{}' not found", name, group));
+        }
+        return it->second;
+    }
+    //---------------------------------------------------------------------
+    void SceneSerializer::writeNodes(StreamSerialiser& stream, SceneManager* sceneMgr)
+    {
+        // the nodes the static geometry and the instance batches build for themselves
+        std::unordered_set<const Node*> internal;
+        for (const auto& [name, geom] : sceneMgr->mStaticGeometryList)
+            internal.insert(geom->getRegionTreeNodes().begin(), geom->getRegionTreeNodes().end());
+
+        // depth first, so the parents come before their children
+        std::vector<std::pair<const SceneNode*, uint32>> nodes;
+        std::vector<std::pair<const SceneNode*, uint32>> pending;
+        const auto& roots = sceneMgr->getRootSceneNode()->getChildren();
+        for (auto it = roots.rbegin(); it != roots.rend(); ++it)
+            pending.emplace_back(static_cast<const SceneNode*>(*it), NO_NODE);
+        while (!pending.empty())
+        {
+            auto [node, parent] = pending.back();
+            pending.pop_back();
+            if (internal.contains(node) ||
+                std::ranges::any_of(node->getAttachedObjects(),
+                                    [](const MovableObject* obj) { return dynamic_cast<const InstanceBatch*>(obj); }))
+                continue;
+
+            auto index = static_cast<uint32>(nodes.size());
+            mNodeIndices[node] = index;
+            nodes.emplace_back(node, parent);
+            // reversed, so the children keep their order
+            const auto& children = node->getChildren();
+            for (auto it = children.rbegin(); it != children.rend(); ++it)
+                pending.emplace_back(static_cast<const SceneNode*>(*it), index);
+        }
+
+        stream.writeChunkBegin(NODES_CHUNK_ID);
+        auto count = static_cast<uint32>(nodes.size());
+        stream.write(&count);
+        for (auto [node, parent] : nodes)
+        {
+            writeString(stream, node->getName());
+            stream.write(&parent);
+            stream.write(static_cast<const Node*>(node));
+            bool inherit[] = {node->getInheritOrientation(), node->getInheritScale()};
+            stream.write(inherit, 2);
+        }
+        stream.writeChunkEnd(NODES_CHUNK_ID);
+    }
+    //---------------------------------------------------------------------
+    void SceneSerializer::readNodes(StreamSerialiser& stream, SceneManager* sceneMgr, SceneNode* parent)
+    {
+        uint32 count;
+        stream.read(&count);
+        mNodes.reserve(count);
+        sceneMgr->mSceneNodes.reserve(sceneMgr->mSceneNodes.size() + count);
+        for (uint32 i = 0; i < count; ++i)
+        {
+            String name = readString(stream);
+            uint32 parentIndex;
+            stream.read(&parentIndex);
+            SceneNode* p = parentIndex == NO_NODE ? parent : getNode(parentIndex);
+            SceneNode* node = name.empty() ? p->createChildSceneNode() : p->createChildSceneNode(name);
+            stream.read(static_cast<Node*>(node));
+            bool inherit[2];
+            stream.read(inherit, 2);
+            node->setInheritOrientation(inherit[0]);
+            node->setInheritScale(inherit[1]);
+            mNodes.push_back(node);
+        }
+    }
+    //---------------------------------------------------------------------
+    void SceneSerializer::writeObjects(StreamSerialiser& stream, SceneManager* sceneMgr)
+    {
+        std::vector<const MovableObject*> objects;
+        for (std::string_view type : {EntityFactory::FACTORY_TYPE_NAME, LightFactory::FACTORY_TYPE_NAME})
+        {
+            for (const auto& [name, obj] : sceneMgr->getMovableObjects(type))
+            {
+                // attached to a bone or to a node that is not written
+                if (obj->isAttached() && getNodeIndex(obj->getParentNode()) == NO_NODE)
+                    continue;
+                objects.push_back(obj);
+            }
+        }
+
+        stream.writeChunkBegin(OBJECTS_CHUNK_ID);
+        auto count = static_cast<uint32>(objects.size());
+        stream.write(&count);
+        for (const MovableObject* obj : objects)
+        {
+            bool isEntity = obj->getMovableType() == EntityFactory::FACTORY_TYPE_NAME;
+            writeString(stream, obj->getMovableType());
+            writeString(stream, obj->getName());
+            uint32 node = obj->isAttached() ? getNodeIndex(obj->getParentNode()) : NO_NODE;
+            stream.write(&node);
+            // what the object is created from comes first
+            if (isEntity)
+            {
+                const MeshPtr& mesh = static_cast<const Entity*>(obj)->getMesh();
+                writeString(stream, mesh->getName());
+                writeString(stream, mesh->getGroup());
+            }
+            writeMovable(stream, obj);
+
+            if (isEntity)
+            {
+                const auto* ent = static_cast<const Entity*>(obj);
+                auto numSubs = static_cast<uint32>(ent->getNumSubEntities());
+                stream.write(&numSubs);
+                for (uint32 i = 0; i < numSubs; ++i)
+                {
+                    const SubEntity* sub = ent->getSubEntity(i);
+                    writeString(stream, sub->getMaterialName());
+                    writeString(stream, sub->getMaterial() ? sub->getMaterial()->getGroup() : RGN_DEFAULT);
+                    bool visible = sub->isVisible();
+                    stream.write(&visible);
+                }
+            }
+            else
+            {
+                const auto* light = static_cast<const Light*>(obj);
+                auto type = std::to_underlying(light->getType());
+                stream.write(&type);
+                stream.write(light->getDiffuseColour().ptr(), 4);
+                stream.write(light->getSpecularColour().ptr(), 4);
+                stream.write(light->getAttenuation().ptr(), 4);
+                Radian angles[] = {light->getSpotlightInnerAngle(), light->getSpotlightOuterAngle()};
+                stream.write(angles, 2);
+                Real values[] = {light->getSpotlightFalloff(), light->getPowerScale()};
+                stream.write(values, 2);
+            }
+        }
+        stream.writeChunkEnd(OBJECTS_CHUNK_ID);
+    }
+    //---------------------------------------------------------------------
+    void SceneSerializer::readObjects(StreamSerialiser& stream, SceneManager* sceneMgr)
+    {
+        uint32 count;
+        stream.read(&count);
+        for (uint32 i = 0; i < count; ++i)
+        {
+            String type = readString(stream);
+            String name = readString(stream);
+            uint32 nodeIndex;
+            stream.read(&nodeIndex);
+            SceneNode* node = getNode(nodeIndex);
+
+            if (type == EntityFactory::FACTORY_TYPE_NAME)
+            {
+                Entity* ent = sceneMgr->createEntity(name, getMesh(stream));
+                readMovable(stream, ent);
+                uint32 numSubs;
+                stream.read(&numSubs);
+                for (uint32 s = 0; s < numSubs; ++s)
+                {
+                    const MaterialPtr& material = getMaterial(stream);
+                    bool visible;
+                    stream.read(&visible);
+                    // the mesh changed since the export
+                    if (s >= ent->getNumSubEntities())
+                        continue;
+
+                    SubEntity* sub = ent->getSubEntity(s);
+                    if (material && material != sub->getMaterial())
+                        sub->setMaterial(material);
+                    sub->setVisible(visible);
+                }
+                if (node)
+                    node->attachObject(ent);
+            }
+            else if (type == LightFactory::FACTORY_TYPE_NAME)
+            {
+                Light* light = sceneMgr->createLight(name);
+                readMovable(stream, light);
+                std::underlying_type_t<Light::LightTypes> lightType;
+                stream.read(&lightType);
+                light->setType(static_cast<Light::LightTypes>(lightType));
+                ColourValue colour;
+                stream.read(colour.ptr(), 4);
+                light->setDiffuseColour(colour);
+                stream.read(colour.ptr(), 4);
+                light->setSpecularColour(colour);
+                float attenuation[4];
+                stream.read(attenuation, 4);
+                light->setAttenuation(attenuation[0], attenuation[1], attenuation[2], attenuation[3]);
+                Radian angles[2];
+                stream.read(angles, 2);
+                Real values[2];
+                stream.read(values, 2);
+                light->setSpotlightRange(angles[0], angles[1], values[0]);
+                light->setPowerScale(values[1]);
+                if (node)
+                    node->attachObject(light);
+            }
+            else
+                OGRE_EXCEPT(ExceptionCodes::INVALIDPARAMS,
+                            ::std::format("Unknown object type '{}' in scene snapshot", type));
+        }
+    }
+    //---------------------------------------------------------------------
+    void SceneSerializer::writeStaticGeometry(StreamSerialiser& stream, SceneManager* sceneMgr)
+    {
+        stream.writeChunkBegin(STATIC_GEOMETRY_CHUNK_ID);
+        auto count = static_cast<uint32>(sceneMgr->mStaticGeometryList.size());
+        stream.write(&count);
+        for (const auto& [name, geom] : sceneMgr->mStaticGeometryList)
+        {
+            writeString(stream, geom->getName());
+            stream.write(&geom->getRegionDimensions());
+            stream.write(&geom->getOrigin());
+            Real distances[] = {geom->getRenderingDistance(), geom->getRegionStreamingLoadDistance(),
+                                geom->getRegionStreamingUnloadDistance(), geom->getFarFieldDistance()};
+            stream.write(distances, 4);
+            bool flags[] = {geom->getCastShadows(), geom->isBuilt()};
+            stream.write(flags, 2);
+            auto visibility = std::to_underlying(geom->getVisibilityFlags());
+            stream.write(&visibility);
+            auto queue = std::to_underlying(geom->getRenderQueueGroup());
+            stream.write(&queue);
+
+            const auto& queued = geom->getQueuedSubMeshes();
+            auto numQueued = static_cast<uint32>(queued.size());
+            stream.write(&numQueued);
+            for (const auto* qsm : queued)
+            {
+                const Mesh* mesh = qsm->submesh->parent;
+                const auto& subMeshes = mesh->getSubMeshes();
+                auto index = static_cast<uint16>(std::ranges::find(subMeshes, qsm->submesh) - subMeshes.begin());
+                writeString(stream, mesh->getName());
+                writeString(stream, mesh->getGroup());
+                stream.write(&index);
+                writeString(stream, qsm->material->getName());
+                writeString(stream, qsm->material->getGroup());
+                stream.write(&qsm->position);
+                stream.write(&qsm->orientation);
+                stream.write(&qsm->scale);
+            }
+        }
+        stream.writeChunkEnd(STATIC_GEOMETRY_CHUNK_ID);
+    }
+    //---------------------------------------------------------------------
+    void SceneSerializer::readStaticGeometry(StreamSerialiser& stream, SceneManager* sceneMgr)
+    {
+        uint32 count;
+        stream.read(&count);
+        for (uint32 i = 0; i < count; ++i)
+        {
+            StaticGeometry* geom = sceneMgr->createStaticGeometry(readString(stream));
+            Vector3 dimensions, origin;
+            stream.read(&dimensions);
+            stream.read(&origin);
+            geom->setRegionDimensions(dimensions);
+            geom->setOrigin(origin);
+            Real distances[4];
+            stream.read(distances, 4);
+            geom->setRenderingDistance(distances[0]);
+            geom->setRegionStreamingDistances(distances[1], distances[2]);
+            geom->setFarFieldDistance(distances[3]);
+            bool flags[2];
+            stream.read(flags, 2);
+            geom->setCastShadows(flags[0]);
+            std::underlying_type_t<QueryTypeMask> visibility;
+            stream.read(&visibility);
+            geom->setVisibilityFlags(static_cast<QueryTypeMask>(visibility));
+            std::underlying_type_t<RenderQueueGroupID> queue;
+            stream.read(&queue);
+            geom->setRenderQueueGroup(static_cast<RenderQueueGroupID>(queue));
+
+            uint32 numQueued;
+            stream.read(&numQueued);
+            for (uint32 q = 0; q < numQueued; ++q)
+            {
+                const MeshPtr& mesh = getMesh(stream);
+                uint16 index;
+                stream.read(&index);
+                const MaterialPtr& material = getMaterial(stream);
+                Vector3 position, scale;
+                Quaternion orientation;
+                stream.read(&position);
+                stream.read(&orientation);
+                stream.read(&scale);
+                if (index >= mesh->getSubMeshes().size())
+                    OGRE_EXCEPT(ExceptionCodes::INVALIDPARAMS,
+                                ::std::format("Mesh '{}' has no submesh {}", mesh->getName(), index));
+                SubMesh* submesh = mesh->getSubMeshes()[index];
+                geom->addSubMesh(submesh, material ? material : submesh->getMaterial(), position, orientation,
+                                 scale);
+            }
+
+            if (flags[1])
+                geom->build();
+        }
+    }
+    //---------------------------------------------------------------------
+    void SceneSerializer::writeInstancing(StreamSerialiser& stream, SceneManager* sceneMgr)
+    {
+        stream.writeChunkBegin(INSTANCING_CHUNK_ID);
+        auto count = static_cast<uint32>(sceneMgr->mInstanceManagerMap.size());
+        stream.write(&count);
+        for (const auto& [name, manager] : sceneMgr->mInstanceManagerMap)
+        {
+            writeString(stream, manager->getName());
+            writeString(stream, manager->getMesh()->getName());
+            writeString(stream, manager->getMesh()->getGroup());
+            auto technique = static_cast<uint8>(manager->getInstancingTechnique());
+            stream.write(&technique);
+            auto perBatch = static_cast<uint32>(manager->getInstancesPerBatch());
+            stream.write(&perBatch);
+            auto flags = std::to_underlying(manager->getInstancingFlags());
+            stream.write(&flags);
+            uint16 subMesh = manager->getSubMeshIndex();
+            stream.write(&subMesh);
+            uint8 numParams = manager->getNumCustomParams();
+            stream.write(&numParams);
+
+            std::vector<InstancedEntity*> instances;
+            for (auto it = manager->getInstanceBatchMapIterator(); it.hasMoreElements(); it.moveNext())
+                for (const auto& batch : *it.peekNextValuePtr())
+                    for (InstancedEntity* instance : batch->getInstancedEntities())
+                        if (instance->isInUse())
+                            instances.push_back(instance);
+
+            auto numInstances = static_cast<uint32>(instances.size());
+            stream.write(&numInstances);
+            for (InstancedEntity* instance : instances)
+            {
+                writeString(stream, instance->_getOwner()->getMaterial()->getName());
+                uint32 node = instance->isAttached() ? getNodeIndex(instance->getParentNode()) : NO_NODE;
+                stream.write(&node);
+                stream.write(&instance->getPosition());
+                stream.write(&instance->getOrientation());
+                stream.write(&instance->getScale());
+                for (uint8 p = 0; p < numParams; ++p)
+                    stream.write(&instance->getCustomParam(p));
+            }
+        }
+        stream.writeChunkEnd(INSTANCING_CHUNK_ID);
+    }
+    //---------------------------------------------------------------------
+    void SceneSerializer::readInstancing(StreamSerialiser& stream, SceneManager* sceneMgr)
+    {
+        uint32 count;
+        stream.read(&count);
+        for (uint32 i = 0; i < count; ++i)
+        {
+            String name = readString(stream);
+            String meshName = readString(stream);
+            String meshGroup = readString(stream);
+            uint8 technique;
+            stream.read(&technique);
+            uint32 perBatch;
+            stream.read(&perBatch);
+            std::underlying_type_t<InstanceManagerFlags> flags;
+            stream.read(&flags);
+            uint16 subMesh;
+            stream.read(&subMesh);
+            uint8 numParams;
+            stream.read(&numParams);
+
+            InstanceManager* manager = sceneMgr->createInstanceManager(
+                name, meshName, meshGroup, static_cast<InstanceManager::InstancingTechnique>(technique), perBatch,
+                static_cast<InstanceManagerFlags>(flags), subMesh);
+            manager->setNumCustomParams(numParams);
+
+            uint32 numInstances;
+            stream.read(&numInstances);
+            for (uint32 e = 0; e < numInstances; ++e)
+            {
+                InstancedEntity* instance = manager->createInstancedEntity(readString(stream));
+                uint32 nodeIndex;
+                stream.read(&nodeIndex);
+                Vector3 position, scale;
+                Quaternion orientation;
+                stream.read(&position);
+                stream.read(&orientation);
+                stream.read(&scale);
+                if (SceneNode* node = getNode(nodeIndex))
+                    node->attachObject(instance);
+                else
+                {
+                    instance->setPosition(position, false);
+                    instance->setOrientation(orientation, false);
+                    instance->setScale(scale);
+                }
+                for (uint8 p = 0; p < numParams; ++p)
+                {
+                    Vector4 param;
+                    stream.read(&param);
+                    instance->setCustomParam(p, param);
+                }
+            }
+        }
+    }
+}
@@ -29,12 +29,15 @@ module;
 
 #include <cassert>
 #include <cstddef>
+#include <cstring>
 
 module Ogre.Core;
 
 import :BuiltinScriptTranslators;
+import :Common;
 import :DataStream;
 import :LogManager;
+import :MaterialManager;
 import :Platform;
 import :Prerequisites;
 import :ResourceGroupManager;
@@ -48,13 +51,17 @@ import :String;
 import :StringVector;
 
 import <algorithm>;
+import <any>;
+import <filesystem>;
 import <format>;
+import <fstream>;
 import <list>;
 import <map>;
 import <memory>;
 import <ostream>;
 import <ranges>;
 import <string>;
+import <thread>;
 import <type_traits>;
 import <unordered_map>;
 import <utility>;
@@ -327,6 +334,18 @@ namespace Ogre
             if(i->type == AbstractNodeType::OBJECT && static_cast<ObjectAbstractNode*>(i.get())->abstract)
                 continue;
             //LogManager::getSingleton().logMessage(static_cast<ObjectAbstractNode*>((*i).get())->name);
+            if(i->type == AbstractNodeType::OBJECT && static_cast<ObjectAbstractNode*>(i.get())->id == ID_MATERIAL)
+            {
+                MaterialManager* materialManager = MaterialManager::getSingletonPtr();
+                if(materialManager && materialManager->getLazyLoading())
+                {
+                    auto *obj = static_cast<ObjectAbstractNode*>(i.get());
+                    // views into the concrete nodes, which do not outlive this call
+                    obj->bases.clear();
+                    materialManager->_deferMaterial(obj->name, mGroup, i);
+                    continue;
+                }
+            }
             ScriptTranslator *translator = ScriptCompilerManager::getSingleton().getTranslator(i);
             if(translator)
                 translator->translate(this, i);
@@ -339,6 +358,25 @@ namespace Ogre
         return mErrors.empty();
     }
 
+    auto ScriptCompiler::_translate(const AbstractNodePtr &node, std::string_view group) -> bool
+    {
+        // may run in the middle of compile, when a script looks up a deferred material
+        String previousGroup = std::exchange(mGroup, String{group});
+        size_t errorCount = mErrors.size();
+        try
+        {
+            if(ScriptTranslator *translator = ScriptCompilerManager::getSingleton().getTranslator(node))
+                translator->translate(this, node);
+        }
+        catch(...)
+        {
+            mGroup = std::move(previousGroup);
+            throw;
+        }
+        mGroup = std::move(previousGroup);
+        return mErrors.size() == errorCount;
+    }
+
     void ScriptCompiler::addError(uint32 code, std::string_view file, int line, std::string_view msg)
     {
         if(mListener)
@@ -1558,16 +1596,152 @@ namespace Ogre
         return 90.0f;
     }
     //-----------------------------------------------------------------------
+    namespace
+    {
+        /// Header of the files in the script cache, followed by the serialised nodes
+        struct ParsedScriptHeader
+        {
+            static constexpr uint32 MAGIC = 0x31435350; // "PSC1"
+            /// bump when the lexer, the parser or the layout below change
+            static constexpr uint32 VERSION = 1;
+            uint32 magic;
+            uint32 version;
+            uint32 engineVersion;
+            uint32 sourceSize;
+        };
+
+        // per node: type as uint8, line, token size and number of children as uint32, the token and the children
+        void writeNodes(const ConcreteNodeList& nodes, std::string& out)
+        {
+            auto put = [&out](uint32 v) { out.append((const char*)&v, sizeof(v)); };
+            for (const auto& node : nodes)
+            {
+                out.push_back(char(node->type));
+                put(node->line);
+                put(uint32(node->token.size()));
+                put(uint32(node->children.size()));
+                out.append(node->token);
+                writeNodes(node->children, out);
+            }
+        }
+
+        /// Reads count nodes at pos, false if the buffer is cut off or corrupt
+        auto readNodes(std::string_view in, size_t& pos, uint32 count, std::string_view file, ConcreteNode* parent,
+                       ConcreteNodeList& nodes) -> bool
+        {
+            for (uint32 i = 0; i < count; ++i)
+            {
+                constexpr size_t fixedSize = 1 + 3 * sizeof(uint32);
+                if (in.size() - pos < fixedSize || uint8(in[pos]) > uint8(ConcreteNodeType::COLON))
+                    return false;
+
+                uint32 fields[3];
+                memcpy(fields, in.data() + pos + 1, sizeof(fields));
+                ConcreteNodePtr node(new ConcreteNode());
+                node->type = ConcreteNodeType(in[pos]);
+                node->line = fields[0];
+                node->file = file;
+                node->parent = parent;
+                pos += fixedSize;
+
+                if (in.size() - pos < fields[1])
+                    return false;
+                node->token = in.substr(pos, fields[1]);
+                pos += fields[1];
+
+                if (!readNodes(in, pos, fields[2], file, node.get(), node->children))
+                    return false;
+                nodes.push_back(std::move(node));
+            }
+            return true;
+        }
+
+        /// Tokenizes and parses source, going through the cache directory unless it is empty
+        auto parseCached(std::string_view source, std::string_view file, std::string_view cacheLocation)
+            -> ConcreteNodeListPtr
+        {
+            if (cacheLocation.empty())
+                return ScriptParser::parse(ScriptLexer::tokenize(source, file), file);
+
+            ParsedScriptHeader header{ParsedScriptHeader::MAGIC, ParsedScriptHeader::VERSION,
+                                      (/*OGRE_VERSION_MAJOR*/13 << 16) | (/*OGRE_VERSION_MINOR*/3 << 8) | /*OGRE_VERSION_PATCH*/3,
+                                      uint32(source.size())};
+            uint32 seed = FastHash((const char*)&header, sizeof(header));
+            uint64 key = uint64(FastHash(source.data(), source.size(), seed)) << 32 |
+                         FastHash(source.data(), source.size(), ~seed);
+            std::filesystem::path path = std::filesystem::path(cacheLocation) / ::std::format("{:016x}.osc", key);
+
+            std::error_code ec;
+            if (auto size = std::filesystem::file_size(path, ec); !ec && size >= sizeof(header) + sizeof(uint32))
+            {
+                std::string buffer(size, '\0');
+                std::ifstream in(path, std::ios::binary);
+                if (in.read(buffer.data(), std::streamsize(size)) && memcmp(buffer.data(), &header, sizeof(header)) == 0)
+                {
+                    uint32 count;
+                    memcpy(&count, buffer.data() + sizeof(header), sizeof(count));
+                    size_t pos = sizeof(header) + sizeof(count);
+                    ConcreteNodeListPtr nodes(new ConcreteNodeList());
+                    if (readNodes(buffer, pos, count, file, nullptr, *nodes) && pos == buffer.size())
+                        return nodes;
+                }
+                LogManager::getSingleton().logWarning(
+                    ::std::format("ignoring corrupt script cache file '{}' of '{}'", path.string(), file));
+            }
+
+            ConcreteNodeListPtr nodes = ScriptParser::parse(ScriptLexer::tokenize(source, file), file);
+
+            std::string out((const char*)&header, sizeof(header));
+            auto count = uint32(nodes->size());
+            out.append((const char*)&count, sizeof(count));
+            writeNodes(*nodes, out);
+
+            // write next to it and rename, so a concurrent or interrupted load never reads half a file
+            std::filesystem::create_directories(path.parent_path(), ec);
+            auto tmpPath = path;
+            tmpPath += ::std::format(".{}", std::hash<std::thread::id>{}(std::this_thread::get_id()));
+            std::ofstream stream(tmpPath, std::ios::binary);
+            stream.write(out.data(), std::streamsize(out.size()));
+            stream.close();
+            if (stream)
+                std::filesystem::rename(tmpPath, path, ec);
+            if (!stream || ec)
+            {
+                std::filesystem::remove(tmpPath, ec);
+                LogManager::getSingleton().logWarning(
+                    ::std::format("could not write '{}' to the script cache", path.string()));
+            }
+            return nodes;
+        }
+    }
+
     void ScriptCompilerManager::parseScript(DataStreamPtr& stream, std::string_view groupName)
     {
-        ConcreteNodeListPtr nodes =
-            ScriptParser::parse(ScriptLexer::tokenize(stream->getAsString(), stream->getName()), stream->getName());
+        ConcreteNodeListPtr nodes = parseCached(stream->getAsString(), stream->getName(), mCacheLocation);
         {
             // compile is not reentrant
             mScriptCompiler.compile(nodes, groupName);
         }
     }
 
+    auto ScriptCompilerManager::_prepareScript(DataStreamPtr& stream) const -> std::any
+    {
+        ConcreteNodeListPtr nodes = parseCached(stream->getAsString(), stream->getName(), mCacheLocation);
+        stream->seek(0);
+        return nodes;
+    }
+
+    void ScriptCompilerManager::_parsePreparedScript(DataStreamPtr& stream, std::string_view groupName,
+                                                     const std::any& prepared)
+    {
+        mScriptCompiler.compile(std::any_cast<const ConcreteNodeListPtr&>(prepared), groupName);
+    }
+
+    auto ScriptCompilerManager::_translateDeferred(const AbstractNodePtr& node, std::string_view groupName) -> bool
+    {
+        return mScriptCompiler._translate(node, groupName);
+    }
+
     //-------------------------------------------------------------------------
     std::string_view const constinit PreApplyTextureAliasesScriptCompilerEvent::eventType = "preApplyTextureAliases";
     //-------------------------------------------------------------------------
@@ -56,13 +56,18 @@ namespace Ogre {
         const wchar_t varopener = '$', quote = '\"', slash = '/', backslash = '\\', openbrace = '{', closebrace = '}', colon = ':', star = '*', cr = '\r', lf = '\n';
         char lastc = 0;
 
-        String lexeme;
+        // the lexemes are views of str, from start to the current character
+        size_t start = 0;
         uint32 line = 1, state = READY, lastQuote = 0, firstOpenBrace = 0, braceLayer = 0;
         ScriptTokenList tokens;
+        // about one token every 4 characters in typical scripts
+        tokens.reserve(str.size() / 4);
 
         // Iterate over the input
-        for (auto const& c : str)
+        for (size_t pos = 0; pos < str.size(); ++pos)
         {
+            const char c = str[pos];
+            std::string_view current = str.substr(pos, 1);
             if(c == quote)
                 lastQuote = line;
             
@@ -95,35 +100,32 @@ namespace Ogre {
             case READY:
                 if(c == slash && lastc == slash)
                 {
-                    // Comment start, clear out the lexeme
-                    lexeme = "";
+                    // Comment start
                     state = COMMENT;
                 }
                 else if(c == star && lastc == slash)
                 {
-                    lexeme = "";
                     state = MULTICOMMENT;
                 }
                 else if(c == quote)
                 {
-                    // Clear out the lexeme ready to be filled with quotes!
-                    lexeme = c;
+                    // Start the lexeme, to be filled with quotes!
+                    start = pos;
                     state = QUOTE;
                 }
                 else if(c == varopener)
                 {
                     // Set up to read in a variable
-                    lexeme = c;
+                    start = pos;
                     state = VAR;
                 }
                 else if(isNewline(c))
                 {
-                    lexeme = c;
-                    setToken(lexeme, line, tokens);
+                    setToken(current, line, tokens);
                 }
                 else if(!isWhitespace(c))
                 {
-                    lexeme = c;
+                    start = pos;
                     if(c == slash)
                         state = POSSIBLECOMMENT;
                     else
@@ -133,8 +135,7 @@ namespace Ogre {
             case COMMENT:
                 if(isNewline(c))
                 {
-                    lexeme = c;
-                    setToken(lexeme, line, tokens);
+                    setToken(current, line, tokens);
                     state = READY;
                 }
                 break;
@@ -145,13 +146,11 @@ namespace Ogre {
             case POSSIBLECOMMENT:
                 if(c == slash && lastc == slash)
                 {
-                    lexeme = "";
                     state = COMMENT;
                     break;  
                 }
                 else if(c == star && lastc == slash)
                 {
-                    lexeme = "";
                     state = MULTICOMMENT;
                     break;
                 }
@@ -161,78 +160,26 @@ namespace Ogre {
                     [[fallthrough]];
                 }
             case WORD:
-                if(isNewline(c))
+            case VAR:
+                if(isNewline(c) || c == openbrace || c == closebrace || c == colon)
                 {
-                    setToken(lexeme, line, tokens);
-                    lexeme = c;
-                    setToken(lexeme, line, tokens);
+                    setToken(str.substr(start, pos - start), line, tokens);
+                    setToken(current, line, tokens);
                     state = READY;
                 }
                 else if(isWhitespace(c))
                 {
-                    setToken(lexeme, line, tokens);
-                    state = READY;
-                }
-                else if(c == openbrace || c == closebrace || c == colon)
-                {
-                    setToken(lexeme, line, tokens);
-                    lexeme = c;
-                    setToken(lexeme, line, tokens);
+                    setToken(str.substr(start, pos - start), line, tokens);
                     state = READY;
                 }
-                else
-                {
-                    lexeme += c;
-                }
                 break;
             case QUOTE:
-                if(c != backslash)
-                {
-                    // Allow embedded quotes with escaping
-                    if(c == quote && lastc == backslash)
-                    {
-                        lexeme += c;
-                    }
-                    else if(c == quote)
-                    {
-                        lexeme += c;
-                        setToken(lexeme, line, tokens);
-                        state = READY;
-                    }
-                    else
-                    {
-                        // Backtrack here and allow a backslash normally within the quote
-                        if(lastc == backslash)
-                            lexeme = ::std::format("{}\\{}", lexeme , c);
-                        else
-                            lexeme += c;
-                    }
-                }
-                break;
-            case VAR:
-                if(isNewline(c))
+                // Allow embedded quotes with escaping, ScriptParser resolves them
+                if(c == quote && lastc != backslash)
                 {
-                    setToken(lexeme, line, tokens);
-                    lexeme = c;
-                    setToken(lexeme, line, tokens);
+                    setToken(str.substr(start, pos - start + 1), line, tokens);
                     state = READY;
                 }
-                else if(isWhitespace(c))
-                {
-                    setToken(lexeme, line, tokens);
-                    state = READY;
-                }
-                else if(c == openbrace || c == closebrace || c == colon)
-                {
-                    setToken(lexeme, line, tokens);
-                    lexeme = c;
-                    setToken(lexeme, line, tokens);
-                    state = READY;
-                }
-                else
-                {
-                    lexeme += c;
-                }
                 break;
             }
 
@@ -246,8 +193,7 @@ namespace Ogre {
         // Check for valid exit states
         if(state == WORD || state == VAR)
         {
-            if(!lexeme.empty())
-                setToken(lexeme, line, tokens);
+            setToken(str.substr(start), line, tokens);
         }
         else
         {
@@ -63,8 +63,11 @@ namespace Ogre {
     */
     struct ScriptToken
     {
-        /// This is the lexeme for this token
-        std::string lexeme;
+        /** This is the lexeme for this token, a view of the tokenized input
+
+            Quoted lexemes include the quotes and the escaping backslashes.
+        */
+        std::string_view lexeme;
         /// This is the id associated with the lexeme, which comes from a lexeme-token id mapping
         uint32 type;
         /// This holds the line number of the input stream where the token was found.
@@ -75,7 +78,10 @@ namespace Ogre {
     class ScriptLexer : public ScriptCompilerAlloc
     {
     public:
-        /** Tokenizes the given input and returns the list of tokens found */
+        /** Tokenizes the given input and returns the list of tokens found
+
+            The tokens refer to str, which must outlive them.
+        */
         static auto tokenize(std::string_view str, std::string_view source) -> ScriptTokenList;
     private: // Private utility operations
         static auto _tokenize(std::string_view str, const char* source, String& error) -> ScriptTokenList;
@@ -40,15 +40,66 @@ import <vector>;
 
 namespace Ogre
 {
+    /// Resolves the escaping backslashes the lexer leaves in quoted lexemes
+    static auto unescaped(std::string_view str) -> String
+    {
+        if (str.find('\\') == std::string_view::npos)
+            return String{str};
+
+        // a backslash is dropped, and kept in front of anything but a quote that follows it
+        String ret;
+        ret.reserve(str.size());
+        char lastc = 0;
+        for (char c : str)
+        {
+            if (c != '\\')
+            {
+                if (lastc == '\\' && c != '\"')
+                    ret += '\\';
+                ret += c;
+            }
+            lastc = c;
+        }
+        return ret;
+    }
+
     static auto unquoted(std::string_view str, bool trim = true) -> String
     {
-        return String{trim ? str.substr(1, str.size() - 2) : str};
+        return trim ? unescaped(str.substr(1, str.size() - 2)) : String{str};
+    }
+
+    namespace
+    {
+        /** Hands out the nodes of one parse from blocks, instead of two heap allocations each.
+
+            The nodes at the top level share the ownership of all blocks, so the whole tree stays
+            valid as long as the returned list or one of them is around. The pointers to the children
+            own nothing, as the blocks holding them would keep themselves alive otherwise.
+        */
+        class ConcreteNodeArena
+        {
+            static constexpr size_t BLOCK_SIZE = 256;
+            using Blocks = std::vector<std::vector<ConcreteNode>>;
+            SharedPtr<Blocks> mBlocks{new Blocks()};
+        public:
+            auto create() -> ConcreteNodePtr
+            {
+                // reserved, so the nodes never move
+                if (mBlocks->empty() || mBlocks->back().size() == BLOCK_SIZE)
+                    mBlocks->emplace_back().reserve(BLOCK_SIZE);
+                return {ConcreteNodePtr(), &mBlocks->back().emplace_back()};
+            }
+
+            /// Shares the ownership of the blocks with a node at the top level
+            [[nodiscard]] auto own(const ConcreteNodePtr& node) const -> ConcreteNodePtr { return {mBlocks, node.get()}; }
+        };
     }
 
     auto ScriptParser::parse(const ScriptTokenList &tokens, std::string_view file) -> ConcreteNodeListPtr
     {
         // MEMCATEGORY_GENERAL because SharedPtr can only free using that category
         ConcreteNodeListPtr nodes(new ConcreteNodeList());
+        ConcreteNodeArena arena;
 
         enum{READY, OBJECT};
         uint32 state = READY;
@@ -68,7 +119,7 @@ namespace Ogre
                 {
                     if(token->lexeme == "import")
                     {
-                        node = ConcreteNodePtr(new ConcreteNode());
+                        node = arena.create();
                         node->token = token->lexeme;
                         node->file = file;
                         node->line = token->line;
@@ -80,7 +131,7 @@ namespace Ogre
                             OGRE_EXCEPT(ExceptionCodes::INVALID_STATE, 
                                 std::format("expected import target at line {}", node->line),
                                 "ScriptParser::parse");
-                        ConcreteNodePtr temp(new ConcreteNode());
+                        ConcreteNodePtr temp = arena.create();
                         temp->parent = node.get();
                         temp->file = file;
                         temp->line = i->line;
@@ -95,7 +146,7 @@ namespace Ogre
                             OGRE_EXCEPT(ExceptionCodes::INVALID_STATE, 
                                 std::format("expected import source at line {}", node->line),
                                 "ScriptParser::parse");
-                        temp = ConcreteNodePtr(new ConcreteNode());
+                        temp = arena.create();
                         temp->parent = node.get();
                         temp->file = file;
                         temp->line = i->line;
@@ -115,13 +166,13 @@ namespace Ogre
                         else
                         {
                             node->parent = nullptr;
-                            nodes->push_back(node);
+                            nodes->push_back(arena.own(node));
                         }
                         node = ConcreteNodePtr();
                     }
                     else if(token->lexeme == "set")
                     {
-                        node = ConcreteNodePtr(new ConcreteNode());
+                        node = arena.create();
                         node->token = token->lexeme;
                         node->file = file;
                         node->line = token->line;
@@ -133,7 +184,7 @@ namespace Ogre
                             OGRE_EXCEPT(ExceptionCodes::INVALID_STATE, 
                                 std::format("expected variable name at line {}", node->line),
                                 "ScriptParser::parse");
-                        ConcreteNodePtr temp(new ConcreteNode());
+                        ConcreteNodePtr temp = arena.create();
                         temp->parent = node.get();
                         temp->file = file;
                         temp->line = i->line;
@@ -147,7 +198,7 @@ namespace Ogre
                             OGRE_EXCEPT(ExceptionCodes::INVALID_STATE, 
                                 std::format("expected variable value at line {}", node->line),
                                 "ScriptParser::parse");
-                        temp = ConcreteNodePtr(new ConcreteNode());
+                        temp = arena.create();
                         temp->parent = node.get();
                         temp->file = file;
                         temp->line = i->line;
@@ -167,13 +218,13 @@ namespace Ogre
                         else
                         {
                             node->parent = nullptr;
-                            nodes->push_back(node);
+                            nodes->push_back(arena.own(node));
                         }
                         node = ConcreteNodePtr();
                     }
                     else
                     {
-                        node = ConcreteNodePtr(new ConcreteNode());
+                        node = arena.create();
                         node->file = file;
                         node->line = token->line;
                         node->type = token->type == TID_WORD ? ConcreteNodeType::WORD : ConcreteNodeType::QUOTE;
@@ -188,7 +239,7 @@ namespace Ogre
                         else
                         {
                             node->parent = nullptr;
-                            nodes->push_back(node);
+                            nodes->push_back(arena.own(node));
                         }
 
                         // Set the parent
@@ -206,7 +257,7 @@ namespace Ogre
                     if(parent)
                         parent = parent->parent;
 
-                    node = ConcreteNodePtr(new ConcreteNode());
+                    node = arena.create();
                     node->token = token->lexeme;
                     node->file = file;
                     node->line = token->line;
@@ -224,7 +275,7 @@ namespace Ogre
                     else
                     {
                         node->parent = nullptr;
-                        nodes->push_back(node);
+                        nodes->push_back(arena.own(node));
                     }
 
                     // Move up another level
@@ -249,7 +300,7 @@ namespace Ogre
                 }
                 else if(token->type == TID_COLON)
                 {
-                    node = ConcreteNodePtr(new ConcreteNode());
+                    node = arena.create();
                     node->token = token->lexeme;
                     node->file = file;
                     node->line = token->line;
@@ -268,8 +319,8 @@ namespace Ogre
 
                     while(j != end && (j->type == TID_WORD || j->type == TID_QUOTE))
                     {
-                        ConcreteNodePtr tempNode = ConcreteNodePtr(new ConcreteNode());
-                        tempNode->token = j->lexeme;
+                        ConcreteNodePtr tempNode = arena.create();
+                        tempNode->token = j->type == TID_QUOTE ? unescaped(j->lexeme) : String{j->lexeme};
                         tempNode->file = file;
                         tempNode->line = j->line;
                         tempNode->type = j->type == TID_WORD ? ConcreteNodeType::WORD : ConcreteNodeType::QUOTE;
@@ -290,13 +341,13 @@ namespace Ogre
                     else
                     {
                         node->parent = nullptr;
-                        nodes->push_back(node);
+                        nodes->push_back(arena.own(node));
                     }
                     node = ConcreteNodePtr();
                 }
                 else if(token->type == TID_LBRACKET)
                 {
-                    node = ConcreteNodePtr(new ConcreteNode());
+                    node = arena.create();
                     node->token = token->lexeme;
                     node->file = file;
                     node->line = token->line;
@@ -314,7 +365,7 @@ namespace Ogre
                     else
                     {
                         node->parent = nullptr;
-                        nodes->push_back(node);
+                        nodes->push_back(arena.own(node));
                     }
 
                     // Set the parent
@@ -335,7 +386,7 @@ namespace Ogre
                     if(parent && parent->type == ConcreteNodeType::LBRACE && parent->parent)
                         parent = parent->parent;
 
-                    node = ConcreteNodePtr(new ConcreteNode());
+                    node = arena.create();
                     node->token = token->lexeme;
                     node->file = file;
                     node->line = token->line;
@@ -353,7 +404,7 @@ namespace Ogre
                     else
                     {
                         node->parent = nullptr;
-                        nodes->push_back(node);
+                        nodes->push_back(arena.own(node));
                     }
 
                     // Move up another level
@@ -365,7 +416,7 @@ namespace Ogre
                 }
                 else if(token->type == TID_VARIABLE)
                 {
-                    node = ConcreteNodePtr(new ConcreteNode());
+                    node = arena.create();
                     node->token = token->lexeme;
                     node->file = file;
                     node->line = token->line;
@@ -380,13 +431,13 @@ namespace Ogre
                     else
                     {
                         node->parent = nullptr;
-                        nodes->push_back(node);
+                        nodes->push_back(arena.own(node));
                     }
                     node = ConcreteNodePtr();
                 }
                 else if(token->type == TID_QUOTE)
                 {
-                    node = ConcreteNodePtr(new ConcreteNode());
+                    node = arena.create();
                     node->token = unquoted(token->lexeme);
                     node->file = file;
                     node->line = token->line;
@@ -401,13 +452,13 @@ namespace Ogre
                     else
                     {
                         node->parent = nullptr;
-                        nodes->push_back(node);
+                        nodes->push_back(arena.own(node));
                     }
                     node = ConcreteNodePtr();
                 }
                 else if(token->type == TID_WORD)
                 {
-                    node = ConcreteNodePtr(new ConcreteNode());
+                    node = arena.create();
                     node->token = token->lexeme;
                     node->file = file;
                     node->line = token->line;
@@ -422,7 +473,7 @@ namespace Ogre
                     else
                     {
                         node->parent = nullptr;
-                        nodes->push_back(node);
+                        nodes->push_back(arena.own(node));
                     }
                     node = ConcreteNodePtr();
                 }
@@ -439,6 +490,7 @@ namespace Ogre
     {
         // MEMCATEGORY_GENERAL because SharedPtr can only free using that category
         ConcreteNodeListPtr nodes(new ConcreteNodeList());
+        ConcreteNodeArena arena;
 
         ConcreteNodePtr node;
         const ScriptToken *token = nullptr;
@@ -449,7 +501,7 @@ namespace Ogre
             switch(token->type)
             {
             case TID_VARIABLE:
-                node = ConcreteNodePtr(new ConcreteNode());
+                node = arena.create();
                 node->file = file;
                 node->line = token->line;
                 node->parent = nullptr;
@@ -457,7 +509,7 @@ namespace Ogre
                 node->type = ConcreteNodeType::VARIABLE;
                 break;
             case TID_WORD:
-                node = ConcreteNodePtr(new ConcreteNode());
+                node = arena.create();
                 node->file = file;
                 node->line = token->line;
                 node->parent = nullptr;
@@ -465,7 +517,7 @@ namespace Ogre
                 node->type = ConcreteNodeType::WORD;
                 break;
             case TID_QUOTE:
-                node = ConcreteNodePtr(new ConcreteNode());
+                node = arena.create();
                 node->file = file;
                 node->line = token->line;
                 node->parent = nullptr;
@@ -480,7 +532,7 @@ namespace Ogre
             }
 
             if(node)
-                nodes->push_back(node);
+                nodes->push_back(arena.own(node));
         }
 
         return nodes;
@@ -998,12 +998,30 @@ namespace Ogre{
     /**************************************************************************
      * MaterialTranslator
      *************************************************************************/
+    /** Restores a member of a translator when translate returns
+
+        A material deferred by MaterialManager::setLazyLoading is translated when it is first looked
+        up, which can happen while the same translators are busy with another one, e.g. for its
+        shadow_caster_material.
+    */
+    template<typename T>
+    struct TranslatorStateGuard
+    {
+        T& state;
+        T saved;
+        explicit TranslatorStateGuard(T& s) : state(s), saved(s) {}
+        TranslatorStateGuard(const TranslatorStateGuard&) = delete;
+        ~TranslatorStateGuard() { state = std::move(saved); }
+    };
+    //-------------------------------------------------------------------------
     MaterialTranslator::MaterialTranslator()
         
     = default;
     //-------------------------------------------------------------------------
     void MaterialTranslator::translate(ScriptCompiler *compiler, const AbstractNodePtr &node)
     {
+        TranslatorStateGuard materialGuard(mMaterial);
+        TranslatorStateGuard aliasesGuard(mTextureAliases);
         auto *obj = static_cast<ObjectAbstractNode*>(node.get());
         if(obj->name.empty())
             compiler->addError(ScriptCompiler::CE_OBJECTNAMEEXPECTED, obj->file, obj->line);
@@ -1164,6 +1182,7 @@ namespace Ogre{
     //-------------------------------------------------------------------------
     void TechniqueTranslator::translate(ScriptCompiler *compiler, const AbstractNodePtr &node)
     {
+        TranslatorStateGuard guard(mTechnique);
         auto *obj = static_cast<ObjectAbstractNode*>(node.get());
 
         // Create the technique from the material
@@ -1343,6 +1362,7 @@ namespace Ogre{
     //-------------------------------------------------------------------------
     void PassTranslator::translate(ScriptCompiler *compiler, const AbstractNodePtr &node)
     {
+        TranslatorStateGuard guard(mPass);
         auto *obj = static_cast<ObjectAbstractNode*>(node.get());
 
         auto *technique = any_cast<Technique*>(obj->parent->context);
@@ -2547,6 +2567,7 @@ namespace Ogre{
 
     void TextureUnitTranslator::translate(ScriptCompiler *compiler, const Ogre::AbstractNodePtr &node)
     {
+        TranslatorStateGuard guard(mUnit);
         auto *obj = static_cast<ObjectAbstractNode*>(node.get());
 
         Pass *pass = any_cast<Pass*>(obj->parent->context);
@@ -3625,6 +3646,7 @@ namespace Ogre{
 
         prog->setMorphAnimationIncluded(false);
         prog->setPoseAnimationIncluded(0);
+        prog->setPoseTextureAnimationIncluded(false);
         prog->setSkeletalAnimationIncluded(false);
         prog->setVertexTextureFetchRequired(false);
         prog->_notifyOrigin(obj->file);
@@ -0,0 +1,146 @@
+// This file is part of the OGRE project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at https://www.ogre3d.org/licensing.
+module;
+
+#include <cassert>
+#include <cstddef>
+
+module Ogre.Core;
+
+import :Material;
+import :Pass;
+import :Platform;
+import :Root;
+import :ShaderTelemetry;
+import :Singleton;
+import :Technique;
+
+import <chrono>;
+import <format>;
+import <mutex>;
+import <ostream>;
+import <set>;
+import <string>;
+import <string_view>;
+import <tuple>;
+import <utility>;
+import <vector>;
+
+namespace Ogre {
+
+namespace {
+    auto steadyMicroseconds() -> uint64
+    {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    auto getTypeName(ShaderTelemetry::EventType type) -> std::string_view
+    {
+        using enum ShaderTelemetry::EventType;
+        switch (type)
+        {
+        case GENERATION:
+            return "generation";
+        case COMPILE:
+            return "compile";
+        case LINK:
+            break;
+        }
+        return "link";
+    }
+}
+    //---------------------------------------------------------------------
+    template<> ShaderTelemetry* Singleton<ShaderTelemetry>::msSingleton = nullptr;
+    auto ShaderTelemetry::getSingletonPtr() noexcept -> ShaderTelemetry*
+    {
+        return msSingleton;
+    }
+    auto ShaderTelemetry::getSingleton() noexcept -> ShaderTelemetry&
+    {
+        assert( msSingleton );  return ( *msSingleton );
+    }
+    thread_local const Pass* ShaderTelemetry::msCurrentPass = nullptr;
+    //---------------------------------------------------------------------
+    ShaderTelemetry::Scope::Scope(EventType type, std::string_view program)
+        : mEvent{type}
+    {
+        ShaderTelemetry* telemetry = getSingletonPtr();
+        if (!telemetry || !telemetry->isEnabled())
+            return;
+
+        mEvent.program = program;
+        if (const Pass* pass = msCurrentPass)
+        {
+            const Technique* technique = pass->getParent();
+            const Material* material = technique->getParent();
+            mEvent.variant.material = material->getName();
+            mEvent.variant.group = material->getGroup();
+            mEvent.variant.scheme = technique->getSchemeName();
+        }
+        if (Root* root = Root::getSingletonPtr())
+            mEvent.frame = root->getNextFrameNumber();
+        mRecording = true;
+        mStart = steadyMicroseconds();
+    }
+    //---------------------------------------------------------------------
+    ShaderTelemetry::Scope::~Scope()
+    {
+        if (!mRecording)
+            return;
+        mEvent.microseconds = steadyMicroseconds() - mStart;
+        if (ShaderTelemetry* telemetry = getSingletonPtr())
+            telemetry->record(std::move(mEvent));
+    }
+    //---------------------------------------------------------------------
+    ShaderTelemetry::ShaderTelemetry() = default;
+    //---------------------------------------------------------------------
+    ShaderTelemetry::~ShaderTelemetry() = default;
+    //---------------------------------------------------------------------
+    void ShaderTelemetry::record(Event event)
+    {
+        std::lock_guard lock{mMutex};
+        mEvents.push_back(std::move(event));
+    }
+    //---------------------------------------------------------------------
+    auto ShaderTelemetry::getEvents() const -> std::vector<Event>
+    {
+        std::lock_guard lock{mMutex};
+        return mEvents;
+    }
+    //---------------------------------------------------------------------
+    void ShaderTelemetry::clear()
+    {
+        std::lock_guard lock{mMutex};
+        mEvents.clear();
+    }
+    //---------------------------------------------------------------------
+    void ShaderTelemetry::writeEvents(std::ostream& stream) const
+    {
+        stream << "type\tprogram\tmaterial\tgroup\tsourceScheme\tscheme\tframe\tmicroseconds\tcacheHit\n";
+        for (const Event& event : getEvents())
+        {
+            stream << std::format("{}\t{}\t{}\t{}\t{}\t{}\t{}\t{}\t{}\n", getTypeName(event.type), event.program,
+                                  event.variant.material, event.variant.group, event.variant.sourceScheme,
+                                  event.variant.scheme, event.frame, event.microseconds, int(event.cacheHit));
+        }
+    }
+    //---------------------------------------------------------------------
+    void ShaderTelemetry::writeVariantManifest(std::ostream& stream) const
+    {
+        using VariantKey = std::tuple<std::string_view, std::string_view, std::string_view, std::string_view, bool>;
+        std::vector<Event> events = getEvents();
+        std::set<VariantKey> written;
+        for (const Event& event : events)
+        {
+            const Variant& v = event.variant;
+            if (event.type != EventType::GENERATION || v.material.empty() ||
+                !written.emplace(v.material, v.group, v.sourceScheme, v.scheme, v.overProgrammable).second)
+                continue;
+
+            stream << std::format("{}\t{}\t{}\t{}\t{}\n", v.material, v.group, v.sourceScheme, v.scheme,
+                                  int(v.overProgrammable));
+        }
+    }
+}
@@ -29,6 +29,7 @@ THE SOFTWARE.
 module Ogre.Core;
 
 import :Camera;
+import :ConvexPolytope;
 import :Exception;
 import :Frustum;
 import :Light;
@@ -294,10 +295,8 @@ namespace Ogre
     void FocusedShadowCameraSetup::calculateLVS(const SceneManager& sm, const Camera& cam, 
         const Light& light, const AxisAlignedBox& sceneBB, PointListBody *out_LVS) const
     {
-        ConvexBody bodyLVS;
-
         // init body with view frustum
-        bodyLVS.define(cam);
+        mBodyLVS.define(cam);
 
         // clip the body with the light frustum (point + spot)
         // for a directional light the space of the intersected
@@ -312,14 +311,14 @@ namespace Ogre
                 calculateShadowMappingMatrix(sm, cam, light, nullptr, nullptr, mLightFrustumCamera.get());
                 mLightFrustumCameraCalculated = true;
             }
-            bodyLVS.clip(*mLightFrustumCamera);
+            mBodyLVS.clip(*mLightFrustumCamera);
         }
 
         // clip the body with the scene bounding box
-        bodyLVS.clip(sceneBB);
+        mBodyLVS.clip(sceneBB);
 
         // extract bodyLVS vertices
-        out_LVS->build(bodyLVS);
+        out_LVS->build(mBodyLVS);
     }
     //-----------------------------------------------------------------------
     auto FocusedShadowCameraSetup::getLSProjViewDir(const Matrix4& lightSpace, 
@@ -494,7 +493,7 @@ namespace Ogre
         mBodyPoints.reserve(12);
     }
     //-----------------------------------------------------------------------
-    FocusedShadowCameraSetup::PointListBody::PointListBody(const ConvexBody& body)
+    FocusedShadowCameraSetup::PointListBody::PointListBody(const ConvexPolytope& body)
     {
         build(body);
     }
@@ -511,20 +510,20 @@ namespace Ogre
         }
     }
     //-----------------------------------------------------------------------
-    void FocusedShadowCameraSetup::PointListBody::build(const ConvexBody& body, bool filterDuplicates)
+    void FocusedShadowCameraSetup::PointListBody::build(const ConvexPolytope& body, bool filterDuplicates)
     {
         // erase list
         mBodyPoints.clear();
 
         // Try to reserve a representative amount of memory
-        mBodyPoints.reserve(body.getPolygonCount() * 6);
+        mBodyPoints.reserve(body.getFaceCount() * 6);
 
         // build new list
-        for (size_t i = 0; i < body.getPolygonCount(); ++i)
+        for (size_t i = 0; i < body.getFaceCount(); ++i)
         {
             for (size_t j = 0; j < body.getVertexCount(i); ++j)
             {
-                const Vector3 &vInsert = body.getVertex(i, j);
+                const Vector3 vInsert = body.getVertex(i, j);
 
                 // duplicates allowed?
                 if (filterDuplicates)
@@ -542,14 +541,14 @@ namespace Ogre
 
                     if (bPresent == false)
                     {
-                        mBodyPoints.push_back(body.getVertex(i, j));
+                        mBodyPoints.push_back(vInsert);
                     }
                 }
 
                 // else insert directly
                 else
                 {
-                    mBodyPoints.push_back(body.getVertex(i, j));
+                    mBodyPoints.push_back(vInsert);
                 }
             }
         }
@@ -560,7 +559,7 @@ namespace Ogre
     }
     //-----------------------------------------------------------------------
     void FocusedShadowCameraSetup::PointListBody::buildAndIncludeDirection(
-        const ConvexBody& body, Real extrudeDist, const Vector3& dir)
+        const ConvexPolytope& body, Real extrudeDist, const Vector3& dir)
     {
         // reset point list
         this->reset();
@@ -568,7 +567,7 @@ namespace Ogre
         // intersect the rays formed by the points in the list with the given direction and
         // insert them into the list
 
-        const size_t polyCount = body.getPolygonCount();
+        const size_t polyCount = body.getFaceCount();
         for (size_t iPoly = 0; iPoly < polyCount; ++iPoly)
         {
 
@@ -576,14 +575,11 @@ namespace Ogre
             // if the currently processed point hits a different plane than the previous point an 
             // intersection point is calculated that lies on the two planes' intersection edge
 
-            // fetch current polygon
-            const Polygon& p = body.getPolygon(iPoly);
-
-            size_t pointCount = p.getVertexCount();
+            size_t pointCount = body.getVertexCount(iPoly);
             for (size_t iPoint = 0; iPoint < pointCount ; ++iPoint)
             {
                 // base point
-                const Vector3& pt = p.getVertex(iPoint);
+                const Vector3 pt = body.getVertex(iPoly, iPoint);
 
                 // add the base point
                 this->addPoint(pt);
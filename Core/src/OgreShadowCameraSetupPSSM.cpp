@@ -0,0 +1,226 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+module;
+
+#include <cmath>
+
+module Ogre.Core;
+
+import :AxisAlignedBox;
+import :Camera;
+import :Exception;
+import :Frustum;
+import :Light;
+import :Math;
+import :Matrix3;
+import :Node;
+import :Quaternion;
+import :SceneManager;
+import :SceneNode;
+import :ShadowCameraSetupPSSM;
+import :Vector;
+import :Viewport;
+
+import <algorithm>;
+import <array>;
+
+namespace Ogre
+{
+    //---------------------------------------------------------------------
+    PSSMShadowCameraSetup::PSSMShadowCameraSetup()
+    {
+        calculateSplitPoints(3, 100, 100000);
+    }
+    //---------------------------------------------------------------------
+    PSSMShadowCameraSetup::~PSSMShadowCameraSetup() = default;
+    //---------------------------------------------------------------------
+    void PSSMShadowCameraSetup::calculateSplitPoints(size_t splitCount, Real nearDist, Real farDist, Real lambda)
+    {
+        OgreAssert(splitCount >= 1, "Cannot specify less than 1 split");
+        OgreAssert(nearDist > 0 && farDist > nearDist, "Invalid split range");
+
+        mSplitPoints.resize(splitCount + 1);
+        mSplitPoints[0] = nearDist;
+        for (size_t i = 1; i < splitCount; ++i)
+        {
+            Real fraction = Real(i) / Real(splitCount);
+            Real splitPoint = lambda * nearDist * std::pow(farDist / nearDist, fraction) +
+                (1 - lambda) * (nearDist + fraction * (farDist - nearDist));
+
+            mSplitPoints[i] = splitPoint;
+        }
+        mSplitPoints[splitCount] = farDist;
+        mOptimalAdjustFactors.resize(splitCount, 1);
+        mUpdateIntervals.resize(splitCount, 1);
+    }
+    //---------------------------------------------------------------------
+    void PSSMShadowCameraSetup::setSplitPoints(const SplitPointList& newSplitPoints)
+    {
+        OgreAssert(newSplitPoints.size() >= 2, "Cannot specify less than 2 splits");
+        OgreAssert(std::is_sorted(newSplitPoints.begin(), newSplitPoints.end()), "Split points must be ascending");
+        mSplitPoints = newSplitPoints;
+        mOptimalAdjustFactors.resize(getSplitCount(), 1);
+        mUpdateIntervals.resize(getSplitCount(), 1);
+    }
+    //---------------------------------------------------------------------
+    void PSSMShadowCameraSetup::setOptimalAdjustFactor(size_t splitIndex, Real factor)
+    {
+        OgreAssert(splitIndex < getSplitCount(), "Split index out of range");
+        mOptimalAdjustFactors[splitIndex] = factor;
+    }
+    //---------------------------------------------------------------------
+    auto PSSMShadowCameraSetup::getOptimalAdjustFactor() const noexcept -> Real
+    {
+        return mOptimalAdjustFactors[mCurrentIteration];
+    }
+    //---------------------------------------------------------------------
+    auto PSSMShadowCameraSetup::getOptimalAdjustFactor(size_t splitIndex) const -> Real
+    {
+        OgreAssert(splitIndex < getSplitCount(), "Split index out of range");
+        return mOptimalAdjustFactors[splitIndex];
+    }
+    //---------------------------------------------------------------------
+    void PSSMShadowCameraSetup::setUpdateInterval(size_t splitIndex, size_t frames)
+    {
+        OgreAssert(splitIndex < getSplitCount(), "Split index out of range");
+        OgreAssert(frames > 0, "Update interval must be at least 1 frame");
+        mUpdateIntervals[splitIndex] = frames;
+    }
+    //---------------------------------------------------------------------
+    auto PSSMShadowCameraSetup::getUpdateInterval(size_t iteration) const -> size_t
+    {
+        return iteration < mUpdateIntervals.size() ? mUpdateIntervals[iteration] : 1;
+    }
+    //---------------------------------------------------------------------
+    void PSSMShadowCameraSetup::getShadowCamera(const SceneManager *sm, const Camera *cam,
+        const Viewport *vp, const Light *light, Camera *texCam, size_t iteration) const
+    {
+        OgreAssert(iteration < getSplitCount(), "More shadow textures than splits");
+
+        // overlap the neighbouring splits a little
+        Real nearDist = mSplitPoints[iteration];
+        Real farDist = mSplitPoints[iteration + 1];
+        if (iteration > 0)
+            nearDist = std::max(nearDist - mSplitPadding, mSplitPoints[0]);
+        if (iteration + 1 < getSplitCount())
+            farDist += mSplitPadding;
+
+        if (mStableCascades && light->getType() == Light::LightTypes::DIRECTIONAL)
+        {
+            getStableShadowCamera(sm, cam, light, texCam, nearDist, farDist);
+            return;
+        }
+
+        // focus on the split by narrowing the view of the camera, just while LiSPSM looks at it
+        auto* splitCam = const_cast<Camera*>(cam);
+        Real oldNear = cam->getNearClipDistance();
+        Real oldFar = cam->getFarClipDistance();
+        splitCam->setNearClipDistance(nearDist);
+        splitCam->setFarClipDistance(farDist);
+
+        mCurrentIteration = iteration;
+        LiSPSMShadowCameraSetup::getShadowCamera(sm, cam, vp, light, texCam, iteration);
+
+        splitCam->setNearClipDistance(oldNear);
+        splitCam->setFarClipDistance(oldFar);
+    }
+    //---------------------------------------------------------------------
+    void PSSMShadowCameraSetup::getStableShadowCamera(const SceneManager *sm, const Camera *cam,
+        const Light *light, Camera *texCam, Real nearDist, Real farDist) const
+    {
+        // corners of the split in view space, scaled from the extents at the near plane
+        RealRect extents = cam->getFrustumExtents();
+        Real camNear = cam->getNearClipDistance();
+        bool perspective = cam->getProjectionType() == ProjectionType::PERSPECTIVE;
+        std::array<Vector3, 8> corners;
+        for (size_t i = 0; i < 2; ++i)
+        {
+            Real dist = i == 0 ? nearDist : farDist;
+            Real scale = perspective ? dist / camNear : 1;
+            corners[i * 4 + 0] = {extents.left * scale, extents.top * scale, -dist};
+            corners[i * 4 + 1] = {extents.right * scale, extents.top * scale, -dist};
+            corners[i * 4 + 2] = {extents.left * scale, extents.bottom * scale, -dist};
+            corners[i * 4 + 3] = {extents.right * scale, extents.bottom * scale, -dist};
+        }
+
+        // the bounding sphere only depends on the shape of the split, not on the camera
+        // orientation, so the size of the projection stays the same while turning
+        Vector3 center = Vector3::ZERO;
+        for (const auto& corner : corners)
+            center += corner;
+        center /= Real(corners.size());
+        Real radius = 0;
+        for (const auto& corner : corners)
+            radius = std::max(radius, corner.squaredDistance(center));
+        // round up to hide precision noise
+        radius = std::ceil(std::sqrt(radius) * 16) / 16;
+        center = cam->getDerivedOrientation() * center + cam->getDerivedPosition();
+
+        // fixed orientation, see DefaultShadowCameraSetup
+        Vector3 dir = -light->getDerivedDirection(); // backwards since point down -z
+        dir.normalise();
+        Vector3 up = Vector3::UNIT_Y;
+        if (Math::Abs(up.dotProduct(dir)) >= 1.0f)
+            up = Vector3::UNIT_Z;
+        Matrix3 rot = Math::lookRotation(dir, up);
+
+        // move in whole texels only, the tile may be not square
+        const Viewport* texView = texCam->getViewport();
+        Vector3 lightSpaceCenter = rot.transpose() * center;
+        Real texelWidth = radius * 2 / texView->getActualWidth();
+        Real texelHeight = radius * 2 / texView->getActualHeight();
+        lightSpaceCenter.x = std::floor(lightSpaceCenter.x / texelWidth) * texelWidth;
+        lightSpaceCenter.y = std::floor(lightSpaceCenter.y / texelHeight) * texelHeight;
+        center = rot * lightSpaceCenter;
+
+        // reach back to whatever might cast a shadow into the sphere
+        Real back = radius;
+        const AxisAlignedBox& sceneBounds = const_cast<SceneManager*>(sm)->getRootSceneNode()->_getWorldAABB();
+        if (sceneBounds.isFinite())
+        {
+            for (const auto& corner : sceneBounds.getAllCorners())
+                back = std::max(back, (corner - center).dotProduct(dir));
+        }
+        else
+        {
+            back = std::max(back, sm->getShadowDirectionalLightExtrusionDistance());
+        }
+        // keep the closest casters away from the near plane
+        Real nearClip = radius / 100;
+        back += nearClip;
+
+        texCam->setCustomViewMatrix(false);
+        texCam->setCustomProjectionMatrix(false);
+        texCam->setProjectionType(ProjectionType::ORTHOGRAPHIC);
+        texCam->setOrthoWindow(radius * 2, radius * 2);
+        texCam->setNearClipDistance(nearClip);
+        texCam->setFarClipDistance(back + radius);
+        texCam->getParentSceneNode()->setPosition(center + dir * back);
+        texCam->getParentNode()->setOrientation(Quaternion::FromMatrix3(rot));
+    }
+}
@@ -29,6 +29,7 @@ module;
 
 #include <cassert>
 #include <cstddef>
+#include <cstring>
 
 module Ogre.Core;
 
@@ -54,6 +55,7 @@ import :StringConverter;
 import :Vector;
 import :VertexIndexData;
 
+import <algorithm>;
 import <memory>;
 import <span>;
 import <string>;
@@ -129,6 +131,8 @@ namespace Ogre {
         return ll;
     }
     // ------------------------------------------------------------------------
+    size_t ShadowCaster::msShadowVolumeCacheSize = 4;
+    // ------------------------------------------------------------------------
     void ShadowCaster::clearShadowRenderableList(ShadowRenderableList& shadowRenderables)
     {
         for(auto & shadowRenderable : shadowRenderables)
@@ -206,6 +210,47 @@ namespace Ogre {
     void ShadowCaster::generateShadowVolume(EdgeData* edgeData, 
         const HardwareIndexBufferSharedPtr& indexBuffer, size_t& indexBufferUsedSize, 
         const Light* light, ShadowRenderableList& shadowRenderables, ShadowRenderableFlags flags)
+    {
+        buildShadowVolume(edgeData, light, shadowRenderables, flags, mShadowVolumeScratch);
+        writeShadowVolume(mShadowVolumeScratch, indexBuffer, indexBufferUsedSize, shadowRenderables);
+    }
+    // ------------------------------------------------------------------------
+    void ShadowCaster::updateShadowVolume(EdgeData* edgeData, const Vector4& lightPos,
+        const HardwareIndexBufferSharedPtr& indexBuffer, size_t& indexBufferUsedSize,
+        const Light* light, ShadowRenderableList& shadowRenderables, ShadowRenderableFlags flags,
+        bool geometryChanged)
+    {
+        if (geometryChanged || msShadowVolumeCacheSize == 0)
+        {
+            mShadowVolumeCache.clear();
+            updateEdgeListLightFacing(edgeData, lightPos);
+            generateShadowVolume(edgeData, indexBuffer, indexBufferUsedSize, light, shadowRenderables, flags);
+            return;
+        }
+        if (mShadowVolumeCache.size() > msShadowVolumeCacheSize)
+            mShadowVolumeCache.resize(msShadowVolumeCacheSize);
+
+        // the same position relative to the caster gives the same silhouette
+        ++mShadowVolumeCacheUse;
+        auto volume = std::ranges::find_if(mShadowVolumeCache, [&](const ShadowVolume& v)
+            { return v.edgeData == edgeData && v.flags == flags && v.lightPos == lightPos; });
+        if (volume == mShadowVolumeCache.end())
+        {
+            volume = mShadowVolumeCache.size() < msShadowVolumeCacheSize ?
+                mShadowVolumeCache.emplace(mShadowVolumeCache.end()) :
+                std::ranges::min_element(mShadowVolumeCache, {}, &ShadowVolume::lastUse);
+            updateEdgeListLightFacing(edgeData, lightPos);
+            buildShadowVolume(edgeData, light, shadowRenderables, flags, *volume);
+            volume->lightPos = lightPos;
+            volume->edgeData = edgeData;
+        }
+        volume->lastUse = mShadowVolumeCacheUse;
+
+        writeShadowVolume(*volume, indexBuffer, indexBufferUsedSize, shadowRenderables);
+    }
+    // ------------------------------------------------------------------------
+    void ShadowCaster::buildShadowVolume(EdgeData* edgeData, const Light* light,
+        const ShadowRenderableList& shadowRenderables, ShadowRenderableFlags flags, ShadowVolume& volume)
     {
         // Edge groups should be 1:1 with shadow renderables
         assert(edgeData->edgeGroups.size() == shadowRenderables.size());
@@ -217,112 +262,172 @@ namespace Ogre {
         // or when light position is too close to light cap bound.
         bool useMcGuire = edgeData->edgeGroups.size() <= 1 && 
             (lightType == Light::LightTypes::DIRECTIONAL || isBoundOkForMcGuire(getLightCapBounds(), light->getDerivedPosition()));
+        // directional lights extruded to infinity converge to a single point
+        bool extrudeToPoint = lightType == Light::LightTypes::DIRECTIONAL &&
+            !!(flags & ShadowRenderableFlags::EXTRUDE_TO_INFINITY);
+        bool darkCap = !!(flags & ShadowRenderableFlags::INCLUDE_DARK_CAP);
+        bool lightCap = !!(flags & ShadowRenderableFlags::INCLUDE_LIGHT_CAP);
+
+        volume.flags = flags;
+        volume.indexCounts.clear();
+        // single pass, the previous size is a good guess for the next one
+        std::vector<unsigned short>& indexes = volume.indexes;
+        indexes.clear();
 
-        // pre-count the size of index data we need since it makes a big perf difference
-        // to GL in particular if we lock a smaller area of the index buffer
-        size_t preCountIndexes = 0;
-
+        // Iterate over the groups and form renderables for each based on their
+        // lightFacing
         for (auto si = shadowRenderables.begin();
-            const EdgeData::EdgeGroup& eg : edgeData->edgeGroups)
+                const EdgeData::EdgeGroup& eg : edgeData->edgeGroups)
         {
+            size_t groupStart = indexes.size();
+            // original number of verts (without extruded copy)
+            size_t originalVertexCount = eg.vertexData->vertexCount;
             bool  firstDarkCapTri = true;
+            unsigned short darkCapStart = 0;
 
             for (const auto & edge : eg.edges)
             {
                 // Silhouette edge, when two tris has opposite light facing, or
                 // degenerate edge where only tri 1 is valid and the tri light facing
-                char lightFacing = edgeData->triangleLightFacings[edge.triIndex[0]];
-                if ((edge.degenerate && lightFacing) ||
-                    (!edge.degenerate && (lightFacing != edgeData->triangleLightFacings[edge.triIndex[1]])))
+                bool lightFacing = edgeData->triangleLightFacings[edge.triIndex[0]];
+                bool otherLightFacing = !edge.degenerate && edgeData->triangleLightFacings[edge.triIndex[1]];
+                if (lightFacing == otherLightFacing)
+                    continue;
+
+                size_t v0 = edge.vertIndex[0];
+                size_t v1 = edge.vertIndex[1];
+                if (!lightFacing)
                 {
+                    // Inverse edge indexes when t1 is light away
+                    std::swap(v0, v1);
+                }
 
-                    preCountIndexes += 3;
+                /* Note edge(v0, v1) run anticlockwise along the edge from
+                the light facing tri so to point shadow volume tris outward,
+                light cap indexes have to be backwards
+
+                We emit 2 tris if light is a point light, 1 if light 
+                is directional, because directional lights cause all
+                points to converge to a single point at infinity.
+
+                First side tri = near1, near0, far0
+                Second tri = far0, far1, near1
+
+                'far' indexes are 'near' index + originalVertexCount
+                because 'far' verts are in the second half of the 
+                buffer
+                */
+                assert(v1 < 65536 && v0 < 65536 && (v0 + originalVertexCount) < 65536 &&
+                    "Vertex count exceeds 16-bit index limit!");
+                auto near0 = static_cast<unsigned short>(v0);
+                auto near1 = static_cast<unsigned short>(v1);
+                auto far0 = static_cast<unsigned short>(v0 + originalVertexCount);
+                auto far1 = static_cast<unsigned short>(v1 + originalVertexCount);
+                indexes.insert(indexes.end(), {near1, near0, far0});
+
+                // Are we extruding to infinity?
+                if (!extrudeToPoint)
+                {
+                    // additional tri to make quad
+                    indexes.insert(indexes.end(), {far0, far1, near1});
+                }
 
-                    // Are we extruding to infinity?
-                    if (!(lightType == Light::LightTypes::DIRECTIONAL &&
-                        !!(flags & ShadowRenderableFlags::EXTRUDE_TO_INFINITY)))
+                // Do dark cap tri
+                // Use McGuire et al method, a triangle fan covering all silhouette
+                // edges and one point (taken from the initial tri)
+                if (useMcGuire && darkCap)
+                {
+                    if (firstDarkCapTri)
                     {
-                        preCountIndexes += 3;
+                        darkCapStart = far0;
+                        firstDarkCapTri = false;
                     }
-
-                    if(useMcGuire)
+                    else
                     {
-                        // Do dark cap tri
-                        // Use McGuire et al method, a triangle fan covering all silhouette
-                        // edges and one point (taken from the initial tri)
-                        if (!!(flags & ShadowRenderableFlags::INCLUDE_DARK_CAP))
-                        {
-                            if (firstDarkCapTri)
-                            {
-                                firstDarkCapTri = false;
-                            }
-                            else
-                            {
-                                preCountIndexes += 3;
-                            }
-                        }
+                        indexes.insert(indexes.end(), {darkCapStart, far1, far0});
                     }
                 }
-
             }
 
-            if(useMcGuire)
+            if(!useMcGuire && darkCap)
             {
-                // Do light cap
-                if (!!(flags & ShadowRenderableFlags::INCLUDE_LIGHT_CAP))
+                // Iterate over the triangles which are using this vertex set
+                for (auto lfi = edgeData->triangleLightFacings.begin() + eg.triStart;
+                    const EdgeData::Triangle& t : std::span{edgeData->triangles.begin() + eg.triStart, eg.triCount})
                 {
-                    // Iterate over the triangles which are using this vertex set
-                    for (auto lfi = edgeData->triangleLightFacings.begin() + eg.triStart;
-                        auto const& ti[[maybe_unused]] : std::span{edgeData->triangles.begin() + eg.triStart, eg.triCount})
+                    assert(t.vertexSet == eg.vertexSet);
+                    // Check it's light facing
+                    if (*lfi)
                     {
-                        assert(ti.vertexSet == eg.vertexSet);
-                        // Check it's light facing
-                        if (*lfi)
-                        {
-                            preCountIndexes += 3;
-                        }
-                        ++lfi;
+                        assert(t.vertIndex[0] < 65536 && t.vertIndex[1] < 65536 &&
+                            t.vertIndex[2] < 65536 && 
+                            "16-bit index limit exceeded!");
+                        indexes.insert(indexes.end(), {
+                            static_cast<unsigned short>(t.vertIndex[1] + originalVertexCount),
+                            static_cast<unsigned short>(t.vertIndex[0] + originalVertexCount),
+                            static_cast<unsigned short>(t.vertIndex[2] + originalVertexCount)});
                     }
-
+                    ++lfi;
                 }
             }
-            else
+
+            // Do light cap
+            if (lightCap)
             {
-                // Do both caps
-                int increment = (!!(flags & ShadowRenderableFlags::INCLUDE_DARK_CAP) ? 3 : 0) + (!!(flags & ShadowRenderableFlags::INCLUDE_LIGHT_CAP) ? 3 : 0);
-                if(increment != 0)
+                // separate light cap?
+                if ((*si)->isLightCapSeparate())
+                {
+                    // the light cap starts after the volume of this renderable
+                    volume.indexCounts.push_back(indexes.size() - groupStart);
+                    groupStart = indexes.size();
+                }
+
+                // Iterate over the triangles which are using this vertex set
+                for (auto lfi = edgeData->triangleLightFacings.begin() + eg.triStart;
+                    const EdgeData::Triangle& t : std::span{edgeData->triangles.begin() + eg.triStart, eg.triCount})
                 {
-                    // Iterate over the triangles which are using this vertex set
-                    for (auto lfi = edgeData->triangleLightFacings.begin() + eg.triStart;
-                        auto const& ti[[maybe_unused]] : std::span{edgeData->triangles.begin() + eg.triStart, eg.triCount})
+                    assert(t.vertexSet == eg.vertexSet);
+                    // Check it's light facing
+                    if (*lfi)
                     {
-                        assert(ti.vertexSet == eg.vertexSet);
-                        // Check it's light facing
-                        if (*lfi)
-                            preCountIndexes += increment;
-                        ++lfi;
+                        assert(t.vertIndex[0] < 65536 && t.vertIndex[1] < 65536 &&
+                            t.vertIndex[2] < 65536 && 
+                            "16-bit index limit exceeded!");
+                        indexes.insert(indexes.end(), {
+                            static_cast<unsigned short>(t.vertIndex[0]),
+                            static_cast<unsigned short>(t.vertIndex[1]),
+                            static_cast<unsigned short>(t.vertIndex[2])});
                     }
+                    ++lfi;
                 }
             }
+
+            // index count of either this shadow renderable or its light cap
+            volume.indexCounts.push_back(indexes.size() - groupStart);
             ++si;
         }
-        // End pre-count
-        
+    }
+    // ------------------------------------------------------------------------
+    void ShadowCaster::writeShadowVolume(const ShadowVolume& volume, const HardwareIndexBufferSharedPtr& indexBuffer,
+        size_t& indexBufferUsedSize, ShadowRenderableList& shadowRenderables)
+    {
+        size_t indexCount = volume.indexes.size();
+
         //Check if index buffer is to small 
-        if (preCountIndexes > indexBuffer->getNumIndexes())
+        if (indexCount > indexBuffer->getNumIndexes())
         {
             LogManager::getSingleton().logWarning(
                 std::format("shadow index buffer size to small. Auto increasing buffer size to{}",
-                sizeof(unsigned short) * preCountIndexes));
+                sizeof(unsigned short) * indexCount));
 
             SceneManager* pManager = Root::getSingleton()._getCurrentSceneManager();
             if (pManager)
             {
-                pManager->setShadowIndexBufferSize(preCountIndexes);
+                pManager->setShadowIndexBufferSize(indexCount);
             }
             
             //Check that the index buffer size has actually increased
-            if (preCountIndexes > indexBuffer->getNumIndexes())
+            if (indexCount > indexBuffer->getNumIndexes())
             {
                 //increasing index buffer size has failed
                 OGRE_EXCEPT(ExceptionCodes::INVALIDPARAMS,
@@ -330,183 +435,47 @@ namespace Ogre {
                     "ShadowCaster::generateShadowVolume");
             }
         }
-        else if(indexBufferUsedSize + preCountIndexes > indexBuffer->getNumIndexes())
+        else if(indexBufferUsedSize + indexCount > indexBuffer->getNumIndexes())
         {
             indexBufferUsedSize = 0;
         }
 
-        // Lock index buffer for writing, just enough length as we need
-        HardwareBufferLockGuard indexLock(indexBuffer,
-            sizeof(unsigned short) * indexBufferUsedSize, sizeof(unsigned short) * preCountIndexes,
-            indexBufferUsedSize == 0 ? HardwareBuffer::LockOptions::DISCARD : HardwareBuffer::LockOptions::NO_OVERWRITE);
-        auto* pIdx = static_cast<unsigned short*>(indexLock.pData);
-        size_t numIndices = indexBufferUsedSize;
-        
-        // Iterate over the groups and form renderables for each based on their
-        // lightFacing
-        for (auto si = shadowRenderables.begin();
-                const EdgeData::EdgeGroup& eg : edgeData->edgeGroups)
+        if (indexCount)
         {
-            // Initialise the index start for this shadow renderable
-            IndexData* indexData = (*si)->getRenderOperationForUpdate()->indexData;
+            // Lock index buffer for writing, just enough length as we need
+            HardwareBufferLockGuard indexLock(indexBuffer,
+                sizeof(unsigned short) * indexBufferUsedSize, sizeof(unsigned short) * indexCount,
+                indexBufferUsedSize == 0 ? HardwareBuffer::LockOptions::DISCARD : HardwareBuffer::LockOptions::NO_OVERWRITE);
+            memcpy(indexLock.pData, volume.indexes.data(), sizeof(unsigned short) * indexCount);
+        }
 
+        // the index ranges of the renderables, in the order they were generated in
+        bool lightCap = !!(volume.flags & ShadowRenderableFlags::INCLUDE_LIGHT_CAP);
+        size_t numIndices = indexBufferUsedSize;
+        for (auto count = volume.indexCounts.begin();
+            ShadowRenderable* sr : shadowRenderables)
+        {
+            IndexData* indexData = sr->getRenderOperationForUpdate()->indexData;
             if (indexData->indexBuffer != indexBuffer)
             {
-                (*si)->rebindIndexBuffer(indexBuffer);
-                indexData = (*si)->getRenderOperationForUpdate()->indexData;
+                sr->rebindIndexBuffer(indexBuffer);
+                indexData = sr->getRenderOperationForUpdate()->indexData;
             }
-
             indexData->indexStart = numIndices;
-            // original number of verts (without extruded copy)
-            size_t originalVertexCount = eg.vertexData->vertexCount;
-            bool  firstDarkCapTri = true;
-            unsigned short darkCapStart = 0;
-
-            for (const auto & edge : eg.edges)
-            {
-                // Silhouette edge, when two tris has opposite light facing, or
-                // degenerate edge where only tri 1 is valid and the tri light facing
-                char lightFacing = edgeData->triangleLightFacings[edge.triIndex[0]];
-                if ((edge.degenerate && lightFacing) ||
-                    (!edge.degenerate && (lightFacing != edgeData->triangleLightFacings[edge.triIndex[1]])))
-                {
-                    size_t v0 = edge.vertIndex[0];
-                    size_t v1 = edge.vertIndex[1];
-                    if (!lightFacing)
-                    {
-                        // Inverse edge indexes when t1 is light away
-                        std::swap(v0, v1);
-                    }
-
-                    /* Note edge(v0, v1) run anticlockwise along the edge from
-                    the light facing tri so to point shadow volume tris outward,
-                    light cap indexes have to be backwards
-
-                    We emit 2 tris if light is a point light, 1 if light 
-                    is directional, because directional lights cause all
-                    points to converge to a single point at infinity.
-
-                    First side tri = near1, near0, far0
-                    Second tri = far0, far1, near1
-
-                    'far' indexes are 'near' index + originalVertexCount
-                    because 'far' verts are in the second half of the 
-                    buffer
-                    */
-                    assert(v1 < 65536 && v0 < 65536 && (v0 + originalVertexCount) < 65536 &&
-                        "Vertex count exceeds 16-bit index limit!");
-                    *pIdx++ = static_cast<unsigned short>(v1);
-                    *pIdx++ = static_cast<unsigned short>(v0);
-                    *pIdx++ = static_cast<unsigned short>(v0 + originalVertexCount);
-                    numIndices += 3;
-
-                    // Are we extruding to infinity?
-                    if (!(lightType == Light::LightTypes::DIRECTIONAL &&
-                        !!(flags & ShadowRenderableFlags::EXTRUDE_TO_INFINITY)))
-                    {
-                        // additional tri to make quad
-                        *pIdx++ = static_cast<unsigned short>(v0 + originalVertexCount);
-                        *pIdx++ = static_cast<unsigned short>(v1 + originalVertexCount);
-                        *pIdx++ = static_cast<unsigned short>(v1);
-                        numIndices += 3;
-                    }
-
-                    if(useMcGuire)
-                    {
-                        // Do dark cap tri
-                        // Use McGuire et al method, a triangle fan covering all silhouette
-                        // edges and one point (taken from the initial tri)
-                        if (!!(flags & ShadowRenderableFlags::INCLUDE_DARK_CAP))
-                        {
-                            if (firstDarkCapTri)
-                            {
-                                darkCapStart = static_cast<unsigned short>(v0 + originalVertexCount);
-                                firstDarkCapTri = false;
-                            }
-                            else
-                            {
-                                *pIdx++ = darkCapStart;
-                                *pIdx++ = static_cast<unsigned short>(v1 + originalVertexCount);
-                                *pIdx++ = static_cast<unsigned short>(v0 + originalVertexCount);
-                                numIndices += 3;
-                            }
-
-                        }
-                    }
-                }
-
-            }
-
-            if(!useMcGuire)
-            {
-                // Do dark cap
-                if (!!(flags & ShadowRenderableFlags::INCLUDE_DARK_CAP))
-                {
-                    // Iterate over the triangles which are using this vertex set
-                    for (auto lfi = edgeData->triangleLightFacings.begin() + eg.triStart;
-                        const EdgeData::Triangle& t : std::span{edgeData->triangles.begin() + eg.triStart, eg.triCount})
-                    {
-                        assert(t.vertexSet == eg.vertexSet);
-                        // Check it's light facing
-                        if (*lfi)
-                        {
-                            assert(t.vertIndex[0] < 65536 && t.vertIndex[1] < 65536 &&
-                                t.vertIndex[2] < 65536 && 
-                                "16-bit index limit exceeded!");
-                            *pIdx++ = static_cast<unsigned short>(t.vertIndex[1] + originalVertexCount);
-                            *pIdx++ = static_cast<unsigned short>(t.vertIndex[0] + originalVertexCount);
-                            *pIdx++ = static_cast<unsigned short>(t.vertIndex[2] + originalVertexCount);
-                            numIndices += 3;
-                        }
-                        ++lfi;
-                    }
-
-                }
-            }
+            indexData->indexCount = *count++;
+            numIndices += indexData->indexCount;
 
-            // Do light cap
-            if (!!(flags & ShadowRenderableFlags::INCLUDE_LIGHT_CAP))
+            if (lightCap && sr->isLightCapSeparate())
             {
-                // separate light cap?
-                if ((*si)->isLightCapSeparate())
-                {
-                    // update index count for this shadow renderable
-                    indexData->indexCount = numIndices - indexData->indexStart;
-
-                    // get light cap index data for update
-                    indexData = (*si)->getLightCapRenderable()->getRenderOperationForUpdate()->indexData;
-                    // start indexes after the current total
-                    indexData->indexStart = numIndices;
-                }
-
-                // Iterate over the triangles which are using this vertex set
-                for (auto lfi = edgeData->triangleLightFacings.begin() + eg.triStart;
-                    const EdgeData::Triangle& t : std::span{edgeData->triangles.begin() + eg.triStart, eg.triCount})
-                {
-                    assert(t.vertexSet == eg.vertexSet);
-                    // Check it's light facing
-                    if (*lfi)
-                    {
-                        assert(t.vertIndex[0] < 65536 && t.vertIndex[1] < 65536 &&
-                            t.vertIndex[2] < 65536 && 
-                            "16-bit index limit exceeded!");
-                        *pIdx++ = static_cast<unsigned short>(t.vertIndex[0]);
-                        *pIdx++ = static_cast<unsigned short>(t.vertIndex[1]);
-                        *pIdx++ = static_cast<unsigned short>(t.vertIndex[2]);
-                        numIndices += 3;
-                    }
-                    ++lfi;
-                }
-
+                indexData = sr->getLightCapRenderable()->getRenderOperationForUpdate()->indexData;
+                indexData->indexStart = numIndices;
+                indexData->indexCount = *count++;
+                numIndices += indexData->indexCount;
             }
-
-            // update index count for current index data (either this shadow renderable or its light cap)
-            indexData->indexCount = numIndices - indexData->indexStart;
-            ++si;
         }
 
         // In debug mode, check we didn't overrun the index buffer
-        assert(numIndices == indexBufferUsedSize + preCountIndexes);
+        assert(numIndices == indexBufferUsedSize + indexCount);
         assert(numIndices <= indexBuffer->getNumIndexes() &&
             "Index buffer overrun while generating shadow volume!! "
             "You must increase the size of the shadow index buffer.");
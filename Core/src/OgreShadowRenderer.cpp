@@ -28,6 +28,7 @@ THE SOFTWARE.
 module;
 
 #include <cassert>
+#include <cmath>
 #include <cstddef>
 
 module Ogre.Core;
@@ -38,7 +39,11 @@ import :BlendMode;
 import :Camera;
 import :ColourValue;
 import :Common;
+import :CompositorChain;
+import :CompositorInstance;
+import :CompositorManager;
 import :Exception;
+import :FrameAllocator;
 import :GpuProgram;
 import :HardwareBuffer;
 import :HardwareBufferManager;
@@ -47,6 +52,7 @@ import :HardwarePixelBuffer;
 import :Light;
 import :LogManager;
 import :Material;
+import :Math;
 import :MaterialManager;
 import :MeshManager;
 import :MovableObject;
@@ -63,6 +69,7 @@ import :RenderSystemCapabilities;
 import :RenderTarget;
 import :RenderTexture;
 import :ResourceGroupManager;
+import :Root;
 import :SceneManager;
 import :SceneNode;
 import :SceneQuery;
@@ -80,9 +87,13 @@ import :Vector;
 import :Viewport;
 
 import <algorithm>;
+import <bit>;
+import <limits>;
 import <map>;
 import <memory>;
+import <numeric>;
 import <ranges>;
+import <span>;
 import <string>;
 import <utility>;
 import <vector>;
@@ -91,6 +102,7 @@ namespace Ogre {
 
 GpuProgramParametersSharedPtr SceneManager::ShadowRenderer::msInfiniteExtrusionParams;
 GpuProgramParametersSharedPtr SceneManager::ShadowRenderer::msFiniteExtrusionParams;
+thread_local const SceneManager::ShadowRenderer::ShadowCasterCulling* SceneManager::ShadowRenderer::msActiveCasterCulling = nullptr;
 
 SceneManager::ShadowRenderer::ShadowRenderer(SceneManager* owner) :
 mSceneManager(owner),
@@ -162,7 +174,7 @@ void SceneManager::ShadowRenderer::renderAdditiveStencilShadowedQueueGroupObject
     for (const auto& [key, pPriorityGrp] : pGroup->getPriorityGroups())
     {
         // Sort the queue first
-        pPriorityGrp->sort(mSceneManager->mCameraInProgress);
+        mSceneManager->sortPriorityGroup(pPriorityGrp.get());
 
         // Render all the ambient passes first, no light iteration, no lights
         visitor->renderObjects(pPriorityGrp->getSolidsBasic(), om, false, false);
@@ -250,7 +262,7 @@ void SceneManager::ShadowRenderer::renderModulativeStencilShadowedQueueGroupObje
     for (const auto& [key, pPriorityGrp] : pGroup->getPriorityGroups())
     {
         // Sort the queue first
-        pPriorityGrp->sort(mSceneManager->mCameraInProgress);
+        mSceneManager->sortPriorityGroup(pPriorityGrp.get());
 
         // Do (shadowable) solids
         visitor->renderObjects(pPriorityGrp->getSolidsBasic(), om, true, true);
@@ -335,7 +347,7 @@ void SceneManager::ShadowRenderer::renderTextureShadowCasterQueueGroupObjects(
     for (const auto& [key, pPriorityGrp] : pGroup->getPriorityGroups())
     {
         // Sort the queue first
-        pPriorityGrp->sort(mSceneManager->mCameraInProgress);
+        mSceneManager->sortPriorityGroup(pPriorityGrp.get());
 
         // Do solids, override light list incase any vertex programs use them
         visitor->renderObjects(pPriorityGrp->getSolidsBasic(), om, false, false);
@@ -369,7 +381,7 @@ void SceneManager::ShadowRenderer::renderModulativeTextureShadowedQueueGroupObje
     for (const auto& [key, pPriorityGrp] : pGroup->getPriorityGroups())
     {
         // Sort the queue first
-        pPriorityGrp->sort(mSceneManager->mCameraInProgress);
+        mSceneManager->sortPriorityGroup(pPriorityGrp.get());
 
         // Do solids
         visitor->renderObjects(pPriorityGrp->getSolidsBasic(), om, true, true);
@@ -397,7 +409,7 @@ void SceneManager::ShadowRenderer::renderModulativeTextureShadowedQueueGroupObje
                 continue;
 
             // Get camera for current shadow texture
-            Camera *cam = mShadowTextures[si]->getBuffer()->getRenderTarget()->getViewport(0)->getCamera();
+            Camera *cam = mShadowTextureCameras[si];
             // Hook up receiver texture
             Pass* targetPass = mShadowTextureCustomReceiverPass ?
                     mShadowTextureCustomReceiverPass : mShadowReceiverPass;
@@ -433,7 +445,7 @@ void SceneManager::ShadowRenderer::renderModulativeTextureShadowedQueueGroupObje
                 }
 
                 t->setProjectiveTexturing(!targetPass->hasVertexProgram(), cam);
-                mSceneManager->mAutoParamDataSource->setTextureProjector(cam, 1);
+                mSceneManager->mAutoParamDataSource->setTextureProjector(cam, 1, getShadowTextureTile(si));
             }
             else
             {
@@ -496,7 +508,7 @@ void SceneManager::ShadowRenderer::renderAdditiveTextureShadowedQueueGroupObject
     for (const auto& [key, pPriorityGrp] : pGroup->getPriorityGroups())
     {
         // Sort the queue first
-        pPriorityGrp->sort(mSceneManager->mCameraInProgress);
+        mSceneManager->sortPriorityGroup(pPriorityGrp.get());
 
         // Render all the ambient passes first, no light iteration, no lights
         visitor->renderObjects(pPriorityGrp->getSolidsBasic(), om, false, false);
@@ -634,7 +646,21 @@ void SceneManager::ShadowRenderer::ensureShadowTexturesCreated()
     if (mShadowTextureConfigDirty)
     {
         destroyShadowTextures();
-        ShadowTextureManager::getSingleton().getShadowTextures(mShadowTextureConfigList, mShadowTextures);
+        if (mShadowAtlas && !mShadowTextureConfigList.empty())
+        {
+            // only the texture of the first config, all indices refer to it
+            ShadowTextureConfigList atlasConfig{mShadowTextureConfigList[0]};
+            ShadowTextureManager::getSingleton().getShadowTextures(atlasConfig, mOwnShadowTextures);
+            uint32 tilesPerSide = std::min(atlasConfig[0].width, atlasConfig[0].height) / mShadowAtlasMinTileSize;
+            OgreAssert(mShadowTextureConfigList.size() <= size_t{tilesPerSide} * tilesPerSide,
+                "the shadow atlas is too small for the shadow texture count at the minimum tile size");
+            mShadowTextures.assign(mShadowTextureConfigList.size(), mOwnShadowTextures[0]);
+        }
+        else
+        {
+            ShadowTextureManager::getSingleton().getShadowTextures(mShadowTextureConfigList, mShadowTextures);
+            mOwnShadowTextures = mShadowTextures;
+        }
 
         // clear shadow cam - light mapping
         mShadowCamLightMapping.clear();
@@ -644,8 +670,9 @@ void SceneManager::ShadowRenderer::ensureShadowTexturesCreated()
         for (size_t __i = 0;
              const TexturePtr& shadowTex  : mShadowTextures)
         {
-            // Camera names are local to SM
-            String camName = ::std::format("{}Cam", shadowTex->getName());
+            // Camera names are local to SM, and all indices of an atlas share the texture
+            String camName = mShadowAtlas ? ::std::format("{}Cam{}", shadowTex->getName(), __i) :
+                ::std::format("{}Cam", shadowTex->getName());
             // Material names are global to SM, make specific
             String matName = ::std::format("{}Mat{}", shadowTex->getName() , mSceneManager->getName());
 
@@ -661,6 +688,7 @@ void SceneManager::ShadowRenderer::ensureShadowTexturesCreated()
             cam->setAspectRatio((Real)shadowTex->getWidth() / (Real)shadowTex->getHeight());
             mSceneManager->getRootSceneNode()->createChildSceneNode()->attachObject(cam);
             mShadowTextureCameras.push_back(cam);
+            mShadowTextureCaches.emplace_back();
 
             // Create a viewport, if not there already
             if (shadowRTT->getNumViewports() == 0)
@@ -671,6 +699,7 @@ void SceneManager::ShadowRenderer::ensureShadowTexturesCreated()
                 // remove overlays
                 v->setOverlaysEnabled(false);
             }
+            addShadowTextureCompositor(shadowRTT->getViewport(0));
 
             // Don't update automatically - we'll do it when required
             shadowRTT->setAutoUpdated(false);
@@ -719,10 +748,57 @@ void SceneManager::ShadowRenderer::ensureShadowTexturesCreated()
 
 }
 //---------------------------------------------------------------------
+void SceneManager::ShadowRenderer::addShadowTextureCompositor(Viewport* vp)
+{
+    if (mShadowTextureCompositor.empty())
+        return;
+
+    CompositorChain* chain = CompositorManager::getSingleton().getCompositorChain(vp);
+    if (chain->getCompositorPosition(mShadowTextureCompositor) != CompositorChain::NPOS)
+        return;
+    if (CompositorInstance* inst = CompositorManager::getSingleton().addCompositor(vp, mShadowTextureCompositor))
+        inst->setEnabled(true);
+}
+//---------------------------------------------------------------------
+void SceneManager::ShadowRenderer::removeShadowTextureCompositor()
+{
+    auto* compositors = CompositorManager::getSingletonPtr();
+    if (mShadowTextureCompositor.empty() || !compositors)
+        return;
+
+    // the textures are pooled, so their viewports outlive this renderer
+    for (const TexturePtr& shadowTex : mOwnShadowTextures)
+    {
+        RenderTarget* shadowRTT = shadowTex->getBuffer()->getRenderTarget();
+        for (unsigned short i = 0; i < shadowRTT->getNumViewports(); ++i)
+        {
+            Viewport* v = shadowRTT->getViewport(i);
+            if (!compositors->hasCompositorChain(v))
+                continue;
+            CompositorChain* chain = compositors->getCompositorChain(v);
+            size_t pos = chain->getCompositorPosition(mShadowTextureCompositor);
+            if (pos != CompositorChain::NPOS)
+                chain->removeCompositor(pos);
+        }
+    }
+}
+//---------------------------------------------------------------------
+void SceneManager::ShadowRenderer::setShadowTextureCompositor(std::string_view name)
+{
+    if (name == mShadowTextureCompositor)
+        return;
+
+    // off the viewports by the old name, they get the new one when recreated
+    destroyShadowTextures();
+    mShadowTextureCompositor = name;
+    mShadowTextureConfigDirty = true;
+}
+//---------------------------------------------------------------------
 void SceneManager::ShadowRenderer::destroyShadowTextures()
 {
+    removeShadowTextureCompositor();
 
-    for (auto & shadowTex : mShadowTextures)
+    for (auto & shadowTex : mOwnShadowTextures)
     {
         // Cleanup material that references this texture
         String matName = ::std::format("{}Mat{}", shadowTex->getName() , mSceneManager->getName());
@@ -736,6 +812,13 @@ void SceneManager::ShadowRenderer::destroyShadowTextures()
 
     }
 
+    for (auto& cache : mShadowTextureCaches)
+    {
+        if (cache.staticLayer)
+            TextureManager::getSingleton().remove(cache.staticLayer);
+    }
+    mShadowTextureCaches.clear();
+
     for (auto cam : mShadowTextureCameras)
     {
         mSceneManager->getRootSceneNode()->removeAndDestroyChild(cam->getParentSceneNode());
@@ -743,6 +826,7 @@ void SceneManager::ShadowRenderer::destroyShadowTextures()
         mSceneManager->destroyCamera(cam);
     }
     mShadowTextures.clear();
+    mOwnShadowTextures.clear();
     mShadowTextureCameras.clear();
 
     // set by render*TextureShadowedQueueGroupObjects
@@ -754,6 +838,424 @@ void SceneManager::ShadowRenderer::destroyShadowTextures()
     mShadowTextureConfigDirty = true;
 }
 //---------------------------------------------------------------------
+auto SceneManager::ShadowRenderer::setShadowTextureTiles(RenderTarget* target, size_t tiles)
+    -> const std::vector<Viewport*>&
+{
+    // as square as possible, e.g. 2x2 for 3 or 4 tiles
+    auto columns = static_cast<size_t>(std::ceil(std::sqrt(Real(tiles))));
+    size_t rows = (tiles + columns - 1) / columns;
+    Real width = Real(1) / columns;
+    Real height = Real(1) / rows;
+    mShadowTileRects.clear();
+    for (size_t t = 0; t < tiles; ++t)
+        mShadowTileRects.emplace_back((t % columns) * width, (t / columns) * height, width, height);
+    return setShadowTextureTiles(target, mShadowTileRects);
+}
+//---------------------------------------------------------------------
+auto SceneManager::ShadowRenderer::setShadowTextureTiles(RenderTarget* target, std::span<const Vector4> tiles)
+    -> const std::vector<Viewport*>&
+{
+    // the viewport created along with the texture is the first tile
+    Viewport* first = target->getViewport(0);
+    mShadowTextureTileViewports.clear();
+    for (size_t t = 0; t < tiles.size(); ++t)
+    {
+        auto zOrder = static_cast<int>(t);
+        Viewport* v = t == 0 ? first :
+            target->hasViewportWithZOrder(zOrder) ? target->getViewportByZOrder(zOrder) : nullptr;
+        if (!v)
+        {
+            v = target->addViewport(first->getCamera(), zOrder);
+            v->setClearEveryFrame(true);
+            v->setOverlaysEnabled(false);
+        }
+        const Vector4& tile = tiles[t];
+        if (v->getLeft() != tile[0] || v->getTop() != tile[1] || v->getWidth() != tile[2] || v->getHeight() != tile[3])
+            v->setDimensions(tile[0], tile[1], tile[2], tile[3]);
+        addShadowTextureCompositor(v);
+        mShadowTextureTileViewports.push_back(v);
+    }
+
+    // tiles of an earlier layout, the cameras must not keep referring to them
+    while (target->getNumViewports() > tiles.size())
+    {
+        auto zOrder = static_cast<int>(target->getNumViewports() - 1);
+        Viewport* v = target->getViewportByZOrder(zOrder);
+        for (Camera* texCam : mShadowTextureCameras)
+            if (texCam->getViewport() == v)
+                texCam->_notifyViewport(nullptr);
+        target->removeViewport(zOrder);
+    }
+
+    return mShadowTextureTileViewports;
+}
+//---------------------------------------------------------------------
+void SceneManager::ShadowRenderer::updateShadowTexture(const TexturePtr& shadowTex, size_t first,
+    std::span<const ShadowTile> tiles)
+{
+    RenderTarget* shadowRTT = shadowTex->getBuffer()->getRenderTarget();
+    bool full = false;
+    bool cached = false;
+    for (const ShadowTile& tile : tiles)
+    {
+        full |= tile.update == ShadowTileUpdate::FULL || tile.update == ShadowTileUpdate::STATIC;
+        cached |= tile.update == ShadowTileUpdate::STATIC || tile.update == ShadowTileUpdate::DYNAMIC;
+    }
+
+    // tiles without a cached layer, of which only the static casters if caching
+    if (full)
+    {
+        shadowRTT->_beginUpdate();
+        for (const ShadowTile& tile : tiles)
+        {
+            if (tile.update != ShadowTileUpdate::FULL && tile.update != ShadowTileUpdate::STATIC)
+                continue;
+            tile.view->setVisibilityMask(tile.update == ShadowTileUpdate::STATIC ?
+                tile.casterMask & mShadowStaticCasterMask : tile.casterMask);
+            msActiveCasterCulling = tile.culling;
+            shadowRTT->_updateViewport(tile.view);
+        }
+        msActiveCasterCulling = nullptr;
+        shadowRTT->_endUpdate();
+    }
+
+    if (!cached)
+        return;
+
+    TexturePtr& staticLayer = mShadowTextureCaches[first].staticLayer;
+    if (!staticLayer || staticLayer->getWidth() != shadowTex->getWidth() ||
+        staticLayer->getHeight() != shadowTex->getHeight() || staticLayer->getFormat() != shadowTex->getFormat())
+    {
+        if (staticLayer)
+            TextureManager::getSingleton().remove(staticLayer);
+        // not a render target, so that copying from it is fast
+        staticLayer = TextureManager::getSingleton().createManual(
+            ::std::format("{}StaticCasters{}", shadowTex->getName(), mSceneManager->getName()),
+            ResourceGroupManager::INTERNAL_RESOURCE_GROUP_NAME, TextureType::_2D,
+            shadowTex->getWidth(), shadowTex->getHeight(), TextureMipmap{}, shadowTex->getFormat());
+    }
+
+    // keep the fresh static casters, or start from the cached ones
+    const HardwarePixelBufferSharedPtr& shadowBuffer = shadowTex->getBuffer();
+    for (const ShadowTile& tile : tiles)
+    {
+        const Viewport* v = tile.view;
+        Box box{uint32(v->getActualLeft()), uint32(v->getActualTop()),
+            uint32(v->getActualLeft() + v->getActualWidth()), uint32(v->getActualTop() + v->getActualHeight())};
+        if (tile.update == ShadowTileUpdate::STATIC)
+            staticLayer->getBuffer()->blit(shadowBuffer, box, box);
+        else if (tile.update == ShadowTileUpdate::DYNAMIC)
+            shadowBuffer->blit(staticLayer->getBuffer(), box, box);
+    }
+
+    // the other casters on top, only clearing a separate depth buffer
+    FrameBufferType clearBuffers = PixelUtil::isDepth(shadowTex->getFormat()) ? FrameBufferType{} : FrameBufferType::DEPTH;
+    mShadowCasterMinBlend = true;
+    shadowRTT->_beginUpdate();
+    for (const ShadowTile& tile : tiles)
+    {
+        if (tile.update != ShadowTileUpdate::STATIC && tile.update != ShadowTileUpdate::DYNAMIC)
+            continue;
+        Viewport* v = tile.view;
+        v->setVisibilityMask(tile.casterMask & ~mShadowStaticCasterMask);
+        v->setClearEveryFrame(clearBuffers != FrameBufferType{}, clearBuffers);
+        msActiveCasterCulling = tile.culling;
+        shadowRTT->_updateViewport(v);
+        v->setClearEveryFrame(true);
+    }
+    msActiveCasterCulling = nullptr;
+    shadowRTT->_endUpdate();
+    mShadowCasterMinBlend = false;
+}
+//---------------------------------------------------------------------
+void SceneManager::ShadowRenderer::ShadowCasterCulling::prepare(const SceneManager* sm, const Light* light,
+    const Camera* cam, bool byReceivers)
+{
+    camera = cam;
+    bool directional = light->getType() == Light::LightTypes::DIRECTIONAL;
+    lightInFrustum = !directional && cam->isVisible(light->getDerivedPosition());
+    frustumVolumes = light->_getFrustumClipVolumes(cam);
+
+    receiverVolume.planes.clear();
+    const AxisAlignedBox& receivers = sm->getVisibleObjectsBoundsInfo(cam).receiverAabb;
+    if (!byReceivers || !receivers.isFinite())
+        return;
+
+    // the faces of the receiver box towards the light, the normals point inwards
+    const Vector3& minimum = receivers.getMinimum();
+    const Vector3& maximum = receivers.getMaximum();
+    const Vector3& dir = light->getDerivedDirection();
+    const Vector3& pos = light->getDerivedPosition();
+    bool kept[3][2];
+    for (int a = 0; a < 3; ++a)
+    {
+        for (int side = 0; side < 2; ++side)
+        {
+            Vector3 normal = Vector3::ZERO;
+            normal[a] = side ? 1 : -1;
+            const Vector3& point = side ? maximum : minimum;
+            // the extrusion does not leave the box through this face
+            kept[a][side] = directional ? normal.dotProduct(dir) >= 0 : normal.dotProduct(pos - point) <= 0;
+            if (kept[a][side])
+                receiverVolume.planes.push_back(Plane::Redefine(-normal, point));
+        }
+    }
+
+    // and the planes through the silhouette edges along the extrusion
+    Vector3 centre = receivers.getCenter();
+    for (int a = 0; a < 3; ++a)
+    {
+        int b = (a + 1) % 3;
+        int c = (a + 2) % 3;
+        for (int sideB = 0; sideB < 2; ++sideB)
+        {
+            for (int sideC = 0; sideC < 2; ++sideC)
+            {
+                if (kept[b][sideB] == kept[c][sideC])
+                    continue;
+                Vector3 v0 = minimum;
+                v0[b] = sideB ? maximum[b] : minimum[b];
+                v0[c] = sideC ? maximum[c] : minimum[c];
+                Vector3 v1 = v0;
+                v1[a] = maximum[a];
+                Vector3 normal = (v1 - v0).crossProduct(directional ? dir : v0 - pos);
+                if (normal.isZeroLength())
+                    continue;
+                normal.normalise();
+                if (normal.dotProduct(centre - v0) < 0)
+                    normal = -normal;
+                receiverVolume.planes.push_back(Plane::Redefine(normal, v0));
+            }
+        }
+    }
+}
+//---------------------------------------------------------------------
+auto SceneManager::ShadowRenderer::ShadowCasterCulling::isVisible(const AxisAlignedBox& bounds) const -> bool
+{
+    if (bounds.isInfinite())
+        return true;
+    if (!receiverVolume.planes.empty() && !receiverVolume.intersects(bounds))
+        return false;
+
+    // in the view, or between the view and the light
+    if (camera->isVisible(bounds))
+        return true;
+    if (lightInFrustum)
+        return false;
+    return std::ranges::any_of(frustumVolumes,
+        [&bounds](const PlaneBoundedVolume& volume) { return volume.intersects(bounds); });
+}
+//---------------------------------------------------------------------
+auto SceneManager::ShadowRenderer::getShadowTextureTile(size_t shadowIndex) const -> Vector4
+{
+    // the camera renders into its tile, which is the whole texture without an atlas
+    const Viewport* v = mShadowTextureCameras[shadowIndex]->getViewport();
+    if (!v)
+        return {0, 0, 1, 1};
+    return {v->getLeft(), v->getTop(), v->getWidth(), v->getHeight()};
+}
+//---------------------------------------------------------------------
+auto SceneManager::ShadowRenderer::prepareShadowTile(Camera* cam, Viewport* vp, Light* light,
+    ShadowCameraSetup* cameraSetup, size_t shadowIndex, size_t iteration, Viewport* shadowView,
+    unsigned long frame) -> ShadowTileUpdate
+{
+    Camera *texCam = mShadowTextureCameras[shadowIndex];
+    // rebind camera, incase another SM in use which has switched to its cam
+    shadowView->setCamera(texCam);
+
+    // keep the texture of an iteration which is not due, along with its camera
+    ShadowTextureCache& cache = mShadowTextureCaches[shadowIndex];
+    Vector4 tile{shadowView->getLeft(), shadowView->getTop(), shadowView->getWidth(), shadowView->getHeight()};
+    size_t interval = std::max(cameraSetup->getUpdateInterval(iteration), size_t{1});
+    if (interval > 1 && cache.light == light && cache.camera == cam && cache.tile == tile &&
+        (frame + iteration) % interval != 0 && frame - cache.updateFrame < interval)
+        return ShadowTileUpdate::SKIP;
+
+    // Associate main view camera as LOD camera
+    texCam->setLodCamera(cam);
+    // set base
+    if (light->getType() != Light::LightTypes::POINT)
+        texCam->getParentSceneNode()->setDirection(light->getDerivedDirection(), Node::TransformSpace::WORLD);
+    if (light->getType() != Light::LightTypes::DIRECTIONAL)
+        texCam->getParentSceneNode()->setPosition(light->getDerivedPosition());
+
+    // Use the material scheme of the main viewport
+    // This is required to pick up the correct shadow_caster_material and similar properties.
+    shadowView->setMaterialScheme(vp->getMaterialScheme());
+
+    // update shadow cam - light mapping
+    auto camLightIt = mShadowCamLightMapping.find( texCam );
+    assert(camLightIt != mShadowCamLightMapping.end());
+    camLightIt->second = light;
+
+    cameraSetup->getShadowCamera(mSceneManager, cam, vp, light, texCam, iteration);
+
+    // Setup background colour
+    shadowView->setBackgroundColour(ColourValue::White);
+
+    // Fire shadow caster update, callee can alter camera settings
+    fireShadowTexturesPreCaster(light, texCam, iteration);
+
+    // the static casters are still valid if they were rendered from the same view
+    bool staticLayerValid = cache.staticLayerValid && cache.light == light &&
+        cache.revision == mShadowCacheRevision && cache.tile == tile &&
+        cache.view == texCam->getViewMatrix() && cache.projection == texCam->getProjectionMatrix();
+    ShadowTileUpdate update = mShadowStaticCasterMask == QueryTypeMask{} ? ShadowTileUpdate::FULL :
+        staticLayerValid ? ShadowTileUpdate::DYNAMIC : ShadowTileUpdate::STATIC;
+
+    cache.light = light;
+    cache.camera = cam;
+    cache.view = texCam->getViewMatrix();
+    cache.projection = texCam->getProjectionMatrix();
+    cache.tile = tile;
+    cache.revision = mShadowCacheRevision;
+    cache.updateFrame = frame;
+    cache.staticLayerValid = mShadowStaticCasterMask != QueryTypeMask{};
+    return update;
+}
+//---------------------------------------------------------------------
+void SceneManager::ShadowRenderer::packShadowAtlas(uint8 maxLevel)
+{
+    // largest first, so that every tile starts at a multiple of its own area along the curve
+    FrameVector<size_t> order(mShadowAtlasTiles.size(), Root::getSingleton().getFrameAllocator());
+    std::iota(order.begin(), order.end(), 0);
+    std::ranges::stable_sort(order, {}, [this](size_t t) { return mShadowAtlasTiles[t].level; });
+
+    // the cursor counts tiles of maxLevel, its bits interleave their column and row
+    mShadowTileRects.resize(mShadowAtlasTiles.size());
+    Real cell = std::ldexp(Real(1), -maxLevel);
+    uint64 cursor = 0;
+    for (size_t t : order)
+    {
+        uint8 level = mShadowAtlasTiles[t].level;
+        OgreAssert(level <= maxLevel, "shadow atlas tile smaller than the minimum tile size");
+        uint32 column = 0;
+        uint32 row = 0;
+        for (uint8 bit = 0; bit < maxLevel; ++bit)
+        {
+            column |= uint32((cursor >> (2 * bit)) & 1) << bit;
+            row |= uint32((cursor >> (2 * bit + 1)) & 1) << bit;
+        }
+        Real size = std::ldexp(Real(1), -level);
+        mShadowTileRects[t] = {column * cell, row * cell, size, size};
+        cursor += uint64{1} << (2 * (maxLevel - level));
+    }
+    OgreAssert(cursor <= uint64{1} << (2 * maxLevel), "shadow atlas tiles exceed the atlas");
+}
+//---------------------------------------------------------------------
+void SceneManager::ShadowRenderer::prepareShadowAtlas(Camera* cam, Viewport* vp, const LightList* lightList,
+    unsigned long frame)
+{
+    // a tile per iteration of the shadow casting lights, as many as there are shadow texture indices
+    mShadowAtlasTiles.clear();
+    size_t shadowTextureIndex = 0;
+    for (Light* light : *lightList)
+    {
+        if (shadowTextureIndex >= mShadowTextures.size())
+            break;
+        if (!light->getCastShadows())
+            continue;
+
+        // the share of the screen the range of the light may cover
+        Real coverage = 1;
+        if (light->getType() != Light::LightTypes::DIRECTIONAL)
+        {
+            Real distance = light->getDerivedPosition().distance(cam->getDerivedPosition());
+            Real range = light->getAttenuationRange();
+            if (distance > range)
+                coverage = std::min(Math::Sqr(range / (distance * Math::Tan(cam->getFOVy() * 0.5))), Real(1));
+        }
+        Real priority = std::max(coverage * light->getShadowImportance(), std::numeric_limits<Real>::min());
+
+        size_t textureCountPerLight = mShadowTextureCountPerType[std::to_underlying(light->getType())];
+        size_t textureCount = std::min(textureCountPerLight, mShadowTextures.size() - shadowTextureIndex);
+        for (size_t j = 0; j < textureCount; ++j)
+            mShadowAtlasTiles.push_back({light, j, shadowTextureIndex + j, priority});
+
+        // set the first shadow texture index for this light.
+        mShadowTextureIndexLightList.push_back(shadowTextureIndex);
+        shadowTextureIndex += textureCountPerLight;
+    }
+    if (mShadowAtlasTiles.empty())
+        return;
+
+    // the side of a tile follows the side of the light on screen, down to the minimum tile size
+    const TexturePtr& atlas = mOwnShadowTextures[0];
+    auto maxLevel = static_cast<uint8>(std::bit_width(
+        uint32(std::min(atlas->getWidth(), atlas->getHeight()) / mShadowAtlasMinTileSize)) - 1);
+    Real area = 0;
+    for (ShadowAtlasTile& tile : mShadowAtlasTiles)
+    {
+        tile.level = static_cast<uint8>(std::clamp(std::ceil(Real(-0.5) * std::log2(tile.priority)),
+            Real(0), Real(maxLevel)));
+        area += std::ldexp(Real(1), -2 * tile.level);
+    }
+
+    // halve the tiles taking the most area for their priority until all fit, which they do
+    // at maxLevel as the shadow texture count is limited to the number of minimum tiles
+    while (area > 1)
+    {
+        auto tile = std::ranges::max_element(mShadowAtlasTiles, {}, [maxLevel](const ShadowAtlasTile& t)
+            { return t.level < maxLevel ? std::ldexp(Real(1), -2 * t.level) / t.priority : Real(-1); });
+        area -= std::ldexp(Real(0.75), -2 * tile->level);
+        ++tile->level;
+    }
+    packShadowAtlas(maxLevel);
+
+    RenderTarget* atlasRTT = atlas->getBuffer()->getRenderTarget();
+    const auto& tileViews = setShadowTextureTiles(atlasRTT, mShadowTileRects);
+    mShadowTiles.clear();
+    const Light* culledLight = nullptr;
+    for (size_t t = 0; t < mShadowAtlasTiles.size(); ++t)
+    {
+        const ShadowAtlasTile& tile = mShadowAtlasTiles[t];
+        Light* light = tile.light;
+        const ShadowCameraSetupPtr& cameraSetup = light->getCustomShadowCameraSetup() ?
+            light->getCustomShadowCameraSetup() : mDefaultShadowCameraSetup;
+        if (mShadowCasterCulling && light != culledLight)
+        {
+            mCasterCullings.emplace_back().prepare(mSceneManager, light, cam, mShadowCasterCullingByReceivers);
+            culledLight = light;
+        }
+        ShadowTileUpdate update = prepareShadowTile(cam, vp, light, cameraSetup.get(),
+            tile.index, tile.iteration, tileViews[t], frame);
+        mShadowTiles.push_back({tileViews[t], update, light->getLightMask() & vp->getVisibilityMask(),
+            mShadowCasterCulling ? &mCasterCullings.back() : nullptr});
+    }
+
+    // all lights with one bind of the target
+    if (mSceneManager->mParallelShadowTextureCulling)
+        gatherShadowTiles(cam, vp);
+    updateShadowTexture(atlas, 0, mShadowTiles);
+}
+//---------------------------------------------------------------------
+void SceneManager::ShadowRenderer::gatherShadowTiles(Camera* cam, Viewport* vp)
+{
+    std::vector<GatheredCamera>& cameras = mSceneManager->mGatheredShadowObjects.cameras;
+    cameras.clear();
+    if (mSceneManager->getRenderQueue()->getRenderableListener())
+        return;
+
+    // the cached tiles are culled once per caster layer when rendered
+    for (const ShadowTile& tile : mShadowTiles)
+    {
+        if (tile.update != ShadowTileUpdate::FULL)
+            continue;
+        tile.view->setVisibilityMask(tile.casterMask);
+        cameras.push_back({tile.view->getCamera(), tile.view, tile.culling, true});
+    }
+
+    // the main camera last, objects building geometry per camera keep its one, unless culled with the viewports
+    const auto& viewportObjects = mSceneManager->mGatheredViewportObjects;
+    bool viewportGathered = viewportObjects.frame == Root::getSingleton().getNextFrameNumber() &&
+        std::ranges::find(viewportObjects.cameras, cam, &GatheredCamera::camera) != viewportObjects.cameras.end();
+    if (mSceneManager->mFindVisibleObjects && mSceneManager->mVisibilityStages.empty() &&
+        !mSceneManager->findCameraGroup(cam) && !viewportGathered)
+        cameras.push_back({cam, vp, nullptr, false});
+
+    mSceneManager->gatherVisibleObjectsParallel(mSceneManager->mGatheredShadowObjects);
+}
+//---------------------------------------------------------------------
 void SceneManager::ShadowRenderer::prepareShadowTextures(Camera* cam, Viewport* vp, const LightList* lightList)
 {
     // create shadow textures if needed
@@ -788,73 +1290,92 @@ void SceneManager::ShadowRenderer::prepareShadowTextures(Camera* cam, Viewport*
     // start of the light list, therefore we do not need to deal with potential
     // mismatches in the light<->shadow texture list any more
 
-    auto ci = mShadowTextureCameras.begin();
     mShadowTextureIndexLightList.clear();
+    unsigned long frame = Root::getSingleton().getNextFrameNumber();
+    // the tiles point to the culling of their light
+    mCasterCullings.clear();
+    mCasterCullings.reserve(lightList->size());
+    if (mShadowAtlas)
+    {
+        prepareShadowAtlas(cam, vp, lightList, frame);
+        fireShadowTexturesUpdated(std::min(lightList->size(), mShadowTextures.size()));
+        ShadowTextureManager::getSingleton().clearUnused();
+        return;
+    }
+
     size_t shadowTextureIndex = 0;
-    for (auto si = mShadowTextures.begin();
-         Light* light : *lightList)
-    {
-        if(si == mShadowTextures.end())
+    // slot of the next shadow texture and its camera
+    size_t si = 0;
+    // the textures of all lights are rendered after culling them at once if parallel
+    bool gather = mSceneManager->mParallelShadowTextureCulling;
+    mShadowTiles.clear();
+    mShadowTextureTiles.clear();
+    for (Light* light : *lightList)
+    {
+        if(si == mShadowTextures.size())
             break;
 
         // skip light if shadows are disabled
         if (!light->getCastShadows())
             continue;
 
-        // texture iteration per light.
+        const ShadowCameraSetupPtr& cameraSetup = light->getCustomShadowCameraSetup() ?
+            light->getCustomShadowCameraSetup() : mDefaultShadowCameraSetup;
+
+        // texture iteration per light, the first texture holds all of them if they are tiles
         size_t textureCountPerLight = mShadowTextureCountPerType[std::to_underlying(light->getType())];
-        for (size_t j = 0; j < textureCountPerLight && si != mShadowTextures.end(); ++j)
+        size_t textureCount = std::min(textureCountPerLight, mShadowTextures.size() - si);
+        size_t tiles = std::min(cameraSetup->getAtlasTileCount(), textureCount);
+        if (tiles <= 1)
+            tiles = 1;
+        QueryTypeMask casterMask = light->getLightMask() & vp->getVisibilityMask();
+        const ShadowCasterCulling* culling = nullptr;
+        if (mShadowCasterCulling)
         {
-            TexturePtr &shadowTex = *si;
-            RenderTarget *shadowRTT = shadowTex->getBuffer()->getRenderTarget();
-            Viewport *shadowView = shadowRTT->getViewport(0);
-            Camera *texCam = *ci;
-            // rebind camera, incase another SM in use which has switched to its cam
-            shadowView->setCamera(texCam);
-
-            // Associate main view camera as LOD camera
-            texCam->setLodCamera(cam);
-            // set base
-            if (light->getType() != Light::LightTypes::POINT)
-                texCam->getParentSceneNode()->setDirection(light->getDerivedDirection(), Node::TransformSpace::WORLD);
-            if (light->getType() != Light::LightTypes::DIRECTIONAL)
-                texCam->getParentSceneNode()->setPosition(light->getDerivedPosition());
-
-            // Use the material scheme of the main viewport
-            // This is required to pick up the correct shadow_caster_material and similar properties.
-            shadowView->setMaterialScheme(vp->getMaterialScheme());
-
-            // Set the viewport visibility flags
-            shadowView->setVisibilityMask(light->getLightMask() & vp->getVisibilityMask());
-
-            // update shadow cam - light mapping
-            auto camLightIt = mShadowCamLightMapping.find( texCam );
-            assert(camLightIt != mShadowCamLightMapping.end());
-            camLightIt->second = light;
-
-            if (!light->getCustomShadowCameraSetup())
-                mDefaultShadowCameraSetup->getShadowCamera(mSceneManager, cam, vp, light, texCam, j);
-            else
-                light->getCustomShadowCameraSetup()->getShadowCamera(mSceneManager, cam, vp, light, texCam, j);
-
-            // Setup background colour
-            shadowView->setBackgroundColour(ColourValue::White);
+            mCasterCullings.emplace_back().prepare(mSceneManager, light, cam, mShadowCasterCullingByReceivers);
+            culling = &mCasterCullings.back();
+        }
 
-            // Fire shadow caster update, callee can alter camera settings
-            fireShadowTexturesPreCaster(light, texCam, j);
+        for (size_t first = si; first < si + textureCount; first += tiles)
+        {
+            size_t count = std::min(tiles, si + textureCount - first);
+            TexturePtr& shadowTex = mOwnShadowTextures[first];
+            RenderTarget *shadowRTT = shadowTex->getBuffer()->getRenderTarget();
+            const auto& tileViews = setShadowTextureTiles(shadowRTT, tiles);
+            if (!gather)
+                mShadowTiles.clear();
+            size_t tileStart = mShadowTiles.size();
 
-            // Update target
-            shadowRTT->update();
+            for (size_t t = 0; t < count; ++t)
+            {
+                mShadowTextures[first + t] = tiles > 1 ? shadowTex : mOwnShadowTextures[first + t];
+                ShadowTileUpdate update = prepareShadowTile(cam, vp, light, cameraSetup.get(),
+                    first + t, first - si + t, tileViews[t], frame);
+                mShadowTiles.push_back({tileViews[t], update, casterMask, culling});
+            }
 
-            ++si; // next shadow texture
-            ++ci; // next camera
+            // Update target, all tiles at once
+            if (gather)
+                mShadowTextureTiles.push_back({shadowTex, first, tileStart, count});
+            else
+                updateShadowTexture(shadowTex, first, mShadowTiles);
         }
+        si += textureCount;
 
         // set the first shadow texture index for this light.
         mShadowTextureIndexLightList.push_back(shadowTextureIndex);
         shadowTextureIndex += textureCountPerLight;
     }
 
+    if (gather)
+    {
+        gatherShadowTiles(cam, vp);
+        for (const ShadowTextureTiles& textureTiles : mShadowTextureTiles)
+            updateShadowTexture(textureTiles.texture, textureTiles.first,
+                std::span{mShadowTiles}.subspan(textureTiles.tileStart, textureTiles.tileCount));
+        mShadowTextureTiles.clear();
+    }
+
     fireShadowTexturesUpdated(std::min(lightList->size(), mShadowTextures.size()));
 
     ShadowTextureManager::getSingleton().clearUnused();
@@ -873,6 +1394,9 @@ void SceneManager::ShadowRenderer::renderShadowVolumesToStencil(const Light* lig
         return;
     }
 
+    // The state is set directly below, not through _setPass
+    mSceneManager->_invalidatePassState();
+
     // Add light to internal list for use in render call
     LightList lightList;
     // const_cast is forgiveable here since we pass this const
@@ -1062,6 +1586,7 @@ void SceneManager::ShadowRenderer::renderShadowVolumesToStencil(const Light* lig
                 true, false, false);
             mDestRenderSystem->setColourBlendState(disabled);
             mDestRenderSystem->_setDepthBufferParams(true, false, CompareFunction::LESS);
+            mSceneManager->_invalidatePassState();
             mShadowColour = shadowColour;
         }
     }
@@ -1077,6 +1602,7 @@ void SceneManager::ShadowRenderer::renderShadowVolumesToStencil(const Light* lig
         mSceneManager->resetScissor();
     }
 
+    mSceneManager->_invalidatePassState();
 }
 //---------------------------------------------------------------------
 void SceneManager::ShadowRenderer::renderShadowVolumeObjects(const ShadowCaster::ShadowRenderableList& shadowRenderables,
@@ -1703,7 +2229,7 @@ void SceneManager::ShadowRenderer::resolveShadowTexture(TextureUnitState* tu, si
     {
         shadowTex = mShadowTextures[shadowIndex];
         // Hook up projection frustum
-        cam = shadowTex->getBuffer()->getRenderTarget()->getViewport(0)->getCamera();
+        cam = mShadowTextureCameras[shadowIndex];
         // Enable projective texturing if fixed-function, but also need to
         // disable it explicitly for program pipeline.
         tu->setProjectiveTexturing(!tu->getParent()->hasVertexProgram(), cam);
@@ -1715,7 +2241,8 @@ void SceneManager::ShadowRenderer::resolveShadowTexture(TextureUnitState* tu, si
         shadowTex = mNullShadowTexture;
         tu->setProjectiveTexturing(false);
     }
-    mSceneManager->mAutoParamDataSource->setTextureProjector(cam, shadowTexUnitIndex);
+    mSceneManager->mAutoParamDataSource->setTextureProjector(cam, shadowTexUnitIndex,
+        cam ? getShadowTextureTile(shadowIndex) : Vector4{0, 0, 1, 1});
     tu->_setTexturePtr(shadowTex);
 }
 
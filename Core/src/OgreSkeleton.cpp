@@ -42,6 +42,8 @@ import :KeyFrame;
 import :Log;
 import :LogManager;
 import :Math;
+import :Node;
+import :NodeTransformSoA;
 import :Prerequisites;
 import :Quaternion;
 import :Resource;
@@ -53,6 +55,7 @@ import :SkeletonManager;
 import :SkeletonSerializer;
 import :StringConverter;
 import :StringVector;
+import :TagPoint;
 import :Vector;
 
 import <algorithm>;
@@ -61,6 +64,7 @@ import <iterator>;
 import <list>;
 import <map>;
 import <memory>;
+import <mutex>;
 import <ostream>;
 import <string>;
 import <utility>;
@@ -98,6 +102,7 @@ namespace Ogre {
     void Skeleton::prepareImpl()
     {
         SkeletonSerializer serializer;
+        serializer.setDeferAnimationTracks(mDeferAnimationTracks);
 
         if (getCreator()->getVerbose())
             LogManager::getSingleton().stream() << "Skeleton: Loading " << mName;
@@ -133,6 +138,8 @@ namespace Ogre {
             delete ai.second;
         }
         mAnimationsList.clear();
+        mDeferredTracks.clear();
+        mNumDeferredTracks = 0;
 
         // Remove all linked skeletons
         mLinkedSkeletonAnimSourceList.clear();
@@ -211,12 +218,14 @@ namespace Ogre {
     }
 
     //---------------------------------------------------------------------
-    void Skeleton::setAnimationState(const AnimationStateSet& animSet)
+    void Skeleton::setAnimationState(const AnimationStateSet& animSet,
+        const AnimationState::BoneBlendMask* boneMask)
     {
         /* 
         Algorithm:
-          1. Reset all bone positions
-          2. Iterate per AnimationState, if enabled get Animation and call Animation::apply
+          1. Reset all bone positions, and copy them to the local pose buffer
+          2. Iterate per AnimationState, if enabled blend its Animation into the pose buffer
+          3. Write the pose back to the bones which changed
         */
 
         // Reset bones
@@ -244,6 +253,18 @@ namespace Ogre {
             }
         }
 
+        // Blend in a local pose buffer, starting from the reset (or manual) bone transforms
+        size_t numBones = mBoneList.size();
+        mLocalPose.position.resize(numBones);
+        mLocalPose.orientation.resize(numBones);
+        mLocalPose.scale.resize(numBones);
+        for (size_t h = 0; h < numBones; ++h)
+        {
+            mLocalPose.position[h] = mBoneList[h]->getPosition();
+            mLocalPose.orientation[h] = mBoneList[h]->getOrientation();
+            mLocalPose.scale[h] = mBoneList[h]->getScale();
+        }
+
         // Per enabled animation state
         for (auto animState : animSet.getEnabledAnimationStates())
         {
@@ -252,20 +273,49 @@ namespace Ogre {
             // tolerate state entries for animations we're not aware of
             if (anim)
             {
-              if(animState->hasBlendMask())
-              {
-                anim->apply(this, animState->getTimePosition(), animState->getWeight() * weightFactor,
-                  animState->getBlendMask(), linked ? linked->scale : 1.0f);
-              }
-              else
-              {
-                anim->apply(this, animState->getTimePosition(), 
-                  animState->getWeight() * weightFactor, linked ? linked->scale : 1.0f);
-              }
+                // same as Animation::apply, but into the pose buffer
+                anim->_applyBaseKeyFrame();
+                TimeIndex timeIndex = anim->_getTimeIndex(animState->getTimePosition(), animState->_getKeyIndexHint());
+                Real weight = animState->getWeight() * weightFactor;
+                const AnimationState::BoneBlendMask* blendMask = animState->getBlendMask();
+                Real scale = linked ? linked->scale : 1.0f;
+
+                for (const auto& [handle, track] : anim->_getNodeTrackList())
+                {
+                    assert(handle < numBones && "Index out of bounds");
+                    Real boneWeight = blendMask ? (*blendMask)[handle] * weight : weight;
+                    if (boneMask && handle < boneMask->size())
+                        boneWeight *= (*boneMask)[handle];
+                    track->applyToTransform(timeIndex, boneWeight, scale,
+                                            mLocalPose.position[handle], mLocalPose.orientation[handle],
+                                            mLocalPose.scale[handle]);
+                }
+            }
+        }
+
+        // one write per animated bone, so untouched manual bones are not flagged dirty
+        for (size_t h = 0; h < numBones; ++h)
+        {
+            Bone* bone = mBoneList[h];
+            if (mLocalPose.position[h] != bone->getPosition() ||
+                mLocalPose.orientation[h] != bone->getOrientation() || mLocalPose.scale[h] != bone->getScale())
+            {
+                bone->setPosition(mLocalPose.position[h]);
+                bone->setOrientation(mLocalPose.orientation[h]);
+                bone->setScale(mLocalPose.scale[h]);
             }
         }
 
 
+    }
+    //---------------------------------------------------------------------
+    void Skeleton::_prepareAnimationState(const AnimationStateSet& animSet)
+    {
+        for (auto animState : animSet.getEnabledAnimationStates())
+        {
+            if (Animation* anim = _getAnimationImpl(animState->getAnimationName()))
+                anim->_prepareForApply();
+        }
     }
     //---------------------------------------------------------------------
     void Skeleton::setBindingPose()
@@ -330,7 +380,11 @@ namespace Ogre {
     //---------------------------------------------------------------------
     auto Skeleton::hasAnimation(std::string_view name) const -> bool
     {
-        return _getAnimationImpl(name) != nullptr;
+        // without reading deferred tracks
+        if (mAnimationsList.contains(name))
+            return true;
+        return std::ranges::any_of(mLinkedSkeletonAnimSourceList, [name](const LinkedSkeletonAnimationSource& link)
+                                   { return link.pSkeleton && link.pSkeleton->hasAnimation(name); });
     }
     //---------------------------------------------------------------------
     auto Skeleton::_getAnimationImpl(std::string_view name, 
@@ -361,6 +415,7 @@ namespace Ogre {
             if (linker)
                 *linker = nullptr;
             ret = i->second;
+            loadDeferredTracks(ret);
         }
 
         return ret;
@@ -377,6 +432,10 @@ namespace Ogre {
             "Skeleton::getAnimation");
         }
 
+        {
+            std::lock_guard lock{mDeferredTracksMutex};
+            mNumDeferredTracks -= mDeferredTracks.erase(i->second);
+        }
         delete i->second;
 
         mAnimationsList.erase(i);
@@ -490,6 +549,7 @@ namespace Ogre {
 
         std::advance(i, index);
 
+        loadDeferredTracks(i->second);
         return i->second;
     }
     //---------------------------------------------------------------------
@@ -537,6 +597,7 @@ namespace Ogre {
     //---------------------------------------------------------------------
     void Skeleton::_dumpContents(std::string_view filename)
     {
+        loadDeferredAnimations();
         std::ofstream of;
 
         Quaternion q;
@@ -606,15 +667,58 @@ namespace Ogre {
     //---------------------------------------------------------------------
     void Skeleton::_updateTransforms()
     {
-        for (auto & mRootBone : mRootBones)
+        if (updatePackedBones())
+        {
+            for (auto& packed : mPackedBones)
+            {
+                packed.update();
+            }
+        }
+        else
         {
-            mRootBone->_update(true, false);
+            for (auto & mRootBone : mRootBones)
+            {
+                mRootBone->_update(true, false);
+            }
         }
         mManualBonesDirty = false;
     }
     //---------------------------------------------------------------------
+    auto Skeleton::updatePackedBones() -> bool
+    {
+        bool upToDate = mPackedBonesVersion == Node::_getHierarchyVersion() &&
+                        mPackedBones.size() == mRootBones.size();
+        for (size_t r = 0; upToDate && r < mRootBones.size(); ++r)
+            upToDate = mPackedBones[r].getRoot() == mRootBones[r];
+        if (upToDate)
+            return mPackedBonesSupported;
+
+        mPackedBonesVersion = Node::_getHierarchyVersion();
+        mPackedBonesSupported = !mRootBones.empty();
+        mPackedBones.resize(mRootBones.size());
+        for (size_t r = 0; r < mRootBones.size(); ++r)
+        {
+            NodeTransformSoA& packed = mPackedBones[r];
+            packed.build(mRootBones[r]);
+
+            // TagPoints and other attached nodes combine their transforms differently
+            for (size_t l = 0; l < packed.getNumLevels(); ++l)
+            {
+                auto [begin, end] = packed.getLevelRange(l);
+                for (size_t slot = begin; slot < end; ++slot)
+                {
+                    Node* node = packed.getNode(slot);
+                    if (node && (!dynamic_cast<Bone*>(node) || dynamic_cast<TagPoint*>(node)))
+                        mPackedBonesSupported = false;
+                }
+            }
+        }
+        return mPackedBonesSupported;
+    }
+    //---------------------------------------------------------------------
     void Skeleton::optimiseAllAnimations(bool preservingIdentityNodeTracks)
     {
+        loadDeferredAnimations();
         if (!preservingIdentityNodeTracks)
         {
             Animation::TrackHandleList tracksToDestroy;
@@ -646,6 +750,59 @@ namespace Ogre {
         }
     }
     //---------------------------------------------------------------------
+    auto Skeleton::compressAllAnimations(const CompressedNodeTrack::Tolerance& tolerance) -> size_t
+    {
+        loadDeferredAnimations();
+        size_t bytes = 0;
+        // re-base all animations first, the base may come from another animation
+        for (auto& ai : mAnimationsList)
+        {
+            ai.second->_applyBaseKeyFrame();
+        }
+        for (auto& ai : mAnimationsList)
+        {
+            for (const auto& [handle, track] : ai.second->_getNodeTrackList())
+            {
+                track->compress(tolerance);
+                if (const CompressedNodeTrack* compressed = track->getCompressed())
+                    bytes += compressed->getMemoryUsage();
+            }
+        }
+        return bytes;
+    }
+    //---------------------------------------------------------------------
+    void Skeleton::_deferAnimationTracks(Animation* anim, const DataStreamPtr& tracks, bool flipEndian)
+    {
+        std::lock_guard lock{mDeferredTracksMutex};
+        mDeferredTracks[anim] = {tracks, flipEndian};
+        mNumDeferredTracks = mDeferredTracks.size();
+    }
+    //---------------------------------------------------------------------
+    void Skeleton::loadDeferredTracks(Animation* anim) const
+    {
+        if (mNumDeferredTracks == 0)
+            return;
+
+        std::lock_guard lock{mDeferredTracksMutex};
+        auto it = mDeferredTracks.find(anim);
+        if (it == mDeferredTracks.end())
+            return;
+
+        SkeletonSerializer serializer;
+        serializer._importAnimationTracks(it->second.stream, it->second.flipEndian, anim, const_cast<Skeleton*>(this));
+        // only once read, so other threads looking up the animation wait for its tracks
+        mDeferredTracks.erase(it);
+        mNumDeferredTracks = mDeferredTracks.size();
+    }
+    //---------------------------------------------------------------------
+    void Skeleton::loadDeferredAnimations()
+    {
+        for (auto& ai : mAnimationsList)
+        {
+            loadDeferredTracks(ai.second);
+        }
+    }
+    //---------------------------------------------------------------------
     void Skeleton::addLinkedSkeletonAnimationSource(std::string_view skelName, 
         Real scale)
     {
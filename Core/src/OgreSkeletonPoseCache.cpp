@@ -0,0 +1,149 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+module;
+
+#include <cstddef>
+
+module Ogre.Core;
+
+import :Animation;
+import :AnimationState;
+import :Matrix4;
+import :Root;
+import :Skeleton;
+import :SkeletonInstance;
+import :SkeletonPoseCache;
+
+import <algorithm>;
+import <bit>;
+import <cmath>;
+import <map>;
+import <mutex>;
+import <vector>;
+
+namespace Ogre {
+
+    namespace {
+        auto quantise(Real value, Real step) -> uint64
+        {
+            return static_cast<uint64>(std::llround(value / step));
+        }
+    }
+    //-----------------------------------------------------------------------
+    auto SkeletonPoseCache::makeKey(const SkeletonInstance& skeleton, const AnimationStateSet& animSet,
+                                    const AnimationState::BoneBlendMask* boneMask, Key& key) const -> bool
+    {
+        if (skeleton.hasManualBones())
+            return false;
+
+        key.clear();
+        key.push_back(skeleton.getHandle());
+        key.push_back(static_cast<uint64>(skeleton.getBlendMode()));
+
+        for (auto animState : animSet.getEnabledAnimationStates())
+        {
+            const LinkedSkeletonAnimationSource* linked = nullptr;
+            Animation* anim = skeleton._getAnimationImpl(animState->getAnimationName(), &linked);
+            if (!anim)
+                continue;
+
+            // the animation itself rather than its name, so linked sources are told apart
+            key.push_back(reinterpret_cast<uintptr_t>(anim));
+            key.push_back(std::bit_cast<uint32>(linked ? linked->scale : 1.0f));
+            key.push_back(quantise(animState->getTimePosition(), mTimeStep));
+            key.push_back(quantise(animState->getWeight(), mWeightStep));
+            if (const AnimationState::BoneBlendMask* blendMask = animState->getBlendMask())
+            {
+                for (float weight : *blendMask)
+                    key.push_back(quantise(weight, mWeightStep));
+            }
+            // separates the states, whether they have a blend mask or not
+            key.push_back(~uint64{0});
+        }
+
+        if (boneMask)
+        {
+            for (float weight : *boneMask)
+                key.push_back(quantise(weight, mWeightStep));
+        }
+        return true;
+    }
+    //-----------------------------------------------------------------------
+    auto SkeletonPoseCache::find(const Key& key, Affine3* matrices, size_t count) -> bool
+    {
+        std::scoped_lock lock{mMutex};
+        beginFrame();
+
+        auto it = mPoses.find(key);
+        if (it == mPoses.end() || it->second.size() != count)
+        {
+            ++mStatistics.misses;
+            return false;
+        }
+        std::ranges::copy(it->second, matrices);
+        ++mStatistics.hits;
+        return true;
+    }
+    //-----------------------------------------------------------------------
+    void SkeletonPoseCache::insert(const Key& key, const Affine3* matrices, size_t count)
+    {
+        std::scoped_lock lock{mMutex};
+        beginFrame();
+        mPoses[key].assign(matrices, matrices + count);
+    }
+    //-----------------------------------------------------------------------
+    void SkeletonPoseCache::clear()
+    {
+        std::scoped_lock lock{mMutex};
+        mPoses.clear();
+        mStatistics = {};
+    }
+    //-----------------------------------------------------------------------
+    auto SkeletonPoseCache::getNumPoses() const -> size_t
+    {
+        std::scoped_lock lock{mMutex};
+        return mFrame == Root::getSingleton().getNextFrameNumber() ? mPoses.size() : 0;
+    }
+    //-----------------------------------------------------------------------
+    auto SkeletonPoseCache::getStatistics() const -> Statistics
+    {
+        std::scoped_lock lock{mMutex};
+        return mFrame == Root::getSingleton().getNextFrameNumber() ? mStatistics : Statistics{};
+    }
+    //-----------------------------------------------------------------------
+    void SkeletonPoseCache::beginFrame()
+    {
+        unsigned long frame = Root::getSingleton().getNextFrameNumber();
+        if (frame != mFrame)
+        {
+            mPoses.clear();
+            mStatistics = {};
+            mFrame = frame;
+        }
+    }
+}
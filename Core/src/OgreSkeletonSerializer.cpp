@@ -47,6 +47,7 @@ import :Vector;
 import <format>;
 import <ios>;
 import <map>;
+import <memory>;
 import <string>;
 import <string_view>;
 import <utility>;
@@ -56,6 +57,8 @@ namespace Ogre {
     /// stream overhead = ID + size
     const long SSTREAM_OVERHEAD_SIZE = sizeof(uint16) + sizeof(uint32);
     const uint16 HEADER_STREAM_ID_EXT = 0x1000;
+    /// The version with ANIMATION_TRACK_KEYFRAMES
+    const std::string_view PACKED_KEYFRAMES_VERSION = "[Serializer_v2.00]";
     //---------------------------------------------------------------------
     SkeletonSerializer::SkeletonSerializer()
     {
@@ -137,7 +140,8 @@ namespace Ogre {
         // Read version
         String ver = readString(stream);
         if ((ver != "[Serializer_v1.10]") &&
-            (ver != "[Serializer_v1.80]"))
+            (ver != "[Serializer_v1.80]") &&
+            (ver != PACKED_KEYFRAMES_VERSION))
         {
             OGRE_EXCEPT(ExceptionCodes::INTERNAL_ERROR,
                 "Invalid file: version incompatible, file reports " + String(ver),
@@ -190,7 +194,9 @@ namespace Ogre {
     {
         if (ver == SkeletonVersion::_1_0)
             mVersion = "[Serializer_v1.10]";
-        else mVersion = "[Serializer_v1.80]";
+        else if (ver == SkeletonVersion::_1_8)
+            mVersion = "[Serializer_v1.80]";
+        else mVersion = PACKED_KEYFRAMES_VERSION;
     }
     //---------------------------------------------------------------------
     void SkeletonSerializer::writeSkeleton(const Skeleton* pSkel, SkeletonVersion ver)
@@ -294,7 +300,7 @@ namespace Ogre {
         // Write all tracks
         for (const auto& it : anim->_getNodeTrackList())
         {
-            writeAnimationTrack(pSkel, it.second);
+            writeAnimationTrack(pSkel, it.second, ver);
         }
         }
         popInnerChunk(mStream);
@@ -302,19 +308,31 @@ namespace Ogre {
     }
     //---------------------------------------------------------------------
     void SkeletonSerializer::writeAnimationTrack(const Skeleton* pSkel, 
-        const NodeAnimationTrack* track)
+        const NodeAnimationTrack* track, SkeletonVersion ver)
     {
-        writeChunkHeader(std::to_underlying(SkeletonChunkID::ANIMATION_TRACK), calcAnimationTrackSize(pSkel, track));
+        if (track->getCompressed())
+        {
+            OGRE_EXCEPT(ExceptionCodes::INVALIDPARAMS, "Compressed animation tracks can not be exported, "
+                        "call NodeAnimationTrack::decompress first", "SkeletonSerializer::writeAnimationTrack");
+        }
+        writeChunkHeader(std::to_underlying(SkeletonChunkID::ANIMATION_TRACK), calcAnimationTrackSize(pSkel, track, ver));
 
         // unsigned short boneIndex     : Index of bone to apply to
         Bone* bone = static_cast<Bone*>(track->getAssociatedNode());
         unsigned short boneid = bone->getHandle();
         writeShorts(&boneid, 1);
         pushInnerChunk(mStream);
-        // Write all keyframes
-        for (unsigned short i = 0; i < track->getNumKeyFrames(); ++i)
+        if (ver > SkeletonVersion::_1_8)
+        {
+            writeKeyFrames(pSkel, track);
+        }
+        else
         {
-            writeKeyFrame(pSkel, track->getNodeKeyFrame(i));
+            // Write all keyframes
+            for (unsigned short i = 0; i < track->getNumKeyFrames(); ++i)
+            {
+                writeKeyFrame(pSkel, track->getNodeKeyFrame(i));
+            }
         }
         popInnerChunk(mStream);
     }
@@ -339,6 +357,61 @@ namespace Ogre {
         }
     }
     //---------------------------------------------------------------------
+    void SkeletonSerializer::writeKeyFrames(const Skeleton* pSkel, const NodeAnimationTrack* track)
+    {
+        writeChunkHeader(std::to_underlying(SkeletonChunkID::ANIMATION_TRACK_KEYFRAMES), calcKeyFramesSize(track));
+
+        auto numKeys = static_cast<uint32>(track->getNumKeyFrames());
+        std::vector<float> times;
+        std::vector<Quaternion> rotates;
+        std::vector<Vector3> translates, scales;
+        times.reserve(numKeys);
+        rotates.reserve(numKeys);
+        translates.reserve(numKeys);
+        scales.reserve(numKeys);
+        bool hasScale = false;
+        for (uint32 i = 0; i < numKeys; ++i)
+        {
+            const TransformKeyFrame* key = track->getNodeKeyFrame(i);
+            times.push_back(key->getTime());
+            rotates.push_back(key->getRotation());
+            translates.push_back(key->getTranslate());
+            scales.push_back(key->getScale());
+            hasScale |= key->getScale() != Vector3::UNIT_SCALE;
+        }
+
+        // unsigned int numKeyFrames     : Number of keyframes
+        writeInts(&numKeys, 1);
+        // bool hasScale                 : Whether the scales follow
+        writeBools(&hasScale, 1);
+        if (numKeys == 0)
+            return;
+        // one array per component, each written and read in one go
+        writeFloats(times.data(), numKeys);
+        writeFloats(rotates.data()->ptr(), numKeys * 4);
+        writeFloats(translates.data()->ptr(), numKeys * 3);
+        if (hasScale)
+            writeFloats(scales.data()->ptr(), numKeys * 3);
+    }
+    //---------------------------------------------------------------------
+    auto SkeletonSerializer::calcKeyFramesSize(const NodeAnimationTrack* pTrack) -> size_t
+    {
+        size_t size = SSTREAM_OVERHEAD_SIZE;
+
+        // unsigned int numKeyFrames, bool hasScale
+        size += sizeof(uint32) + sizeof(bool);
+
+        size_t numKeys = pTrack->getNumKeyFrames();
+        bool hasScale = false;
+        for (size_t i = 0; i < numKeys; ++i)
+            hasScale |= pTrack->getNodeKeyFrame(i)->getScale() != Vector3::UNIT_SCALE;
+
+        // time, rotation, translation and optional scale per key
+        size += numKeys * sizeof(float) * (hasScale ? 11 : 8);
+
+        return size;
+    }
+    //---------------------------------------------------------------------
     auto SkeletonSerializer::calcBoneSize(const Skeleton* pSkel, 
         const Bone* pBone) -> size_t
     {
@@ -411,20 +484,25 @@ namespace Ogre {
         // Nested animation tracks
         for (const auto& it : pAnim->_getNodeTrackList())
         {
-            size += calcAnimationTrackSize(pSkel, it.second);
+            size += calcAnimationTrackSize(pSkel, it.second, ver);
         }
 
         return size;
     }
     //---------------------------------------------------------------------
     auto SkeletonSerializer::calcAnimationTrackSize(const Skeleton* pSkel, 
-        const NodeAnimationTrack* pTrack) -> size_t
+        const NodeAnimationTrack* pTrack, SkeletonVersion ver) -> size_t
     {
         size_t size = SSTREAM_OVERHEAD_SIZE;
 
         // unsigned short boneIndex     : Index of bone to apply to
         size += sizeof(unsigned short);
 
+        if (ver > SkeletonVersion::_1_8)
+        {
+            return size + calcKeyFramesSize(pTrack);
+        }
+
         // Nested keyframes
         for (unsigned short i = 0; i < pTrack->getNumKeyFrames(); ++i)
         {
@@ -517,6 +595,7 @@ namespace Ogre {
     //---------------------------------------------------------------------
     void SkeletonSerializer::readAnimation(DataStreamPtr& stream, Skeleton* pSkel)
     {
+        size_t chunkEnd = stream->tell() - SSTREAM_OVERHEAD_SIZE + mCurrentstreamLen;
         // char* name                       : Name of the animation
         String name;
         name = readString(stream);
@@ -548,6 +627,19 @@ namespace Ogre {
                 }
             }
             
+            if (mDeferAnimationTracks && mVersion == PACKED_KEYFRAMES_VERSION &&
+                streamID == SkeletonChunkID::ANIMATION_TRACK)
+            {
+                // the remaining chunks of the animation are all tracks, keep them as they are
+                backpedalChunkHeader(stream);
+                size_t size = chunkEnd - stream->tell();
+                auto tracks = std::make_shared<MemoryDataStream>(size);
+                stream->read(tracks->getPtr(), size);
+                pSkel->_deferAnimationTracks(pAnim, tracks, mFlipEndian);
+                popInnerChunk(stream);
+                return;
+            }
+
             while(streamID == SkeletonChunkID::ANIMATION_TRACK && !stream->eof())
             {
                 readAnimationTrack(stream, pAnim, pSkel);
@@ -585,6 +677,14 @@ namespace Ogre {
         {
             pushInnerChunk(stream);
             auto streamID = static_cast<SkeletonChunkID>(readChunk(stream));
+            if (streamID == SkeletonChunkID::ANIMATION_TRACK_KEYFRAMES)
+            {
+                readKeyFrames(stream, pTrack);
+                if (!stream->eof())
+                {
+                    streamID = static_cast<SkeletonChunkID>(readChunk(stream));
+                }
+            }
             while(streamID == SkeletonChunkID::ANIMATION_TRACK_KEYFRAME && !stream->eof())
             {
                 readKeyFrame(stream, pTrack, pSkel);
@@ -632,6 +732,51 @@ namespace Ogre {
         }
     }
     //---------------------------------------------------------------------
+    void SkeletonSerializer::readKeyFrames(const DataStreamPtr& stream, NodeAnimationTrack* track)
+    {
+        // unsigned int numKeyFrames     : Number of keyframes
+        uint32 numKeys;
+        readInts(stream, &numKeys, 1);
+        // bool hasScale                 : Whether the scales follow
+        bool hasScale;
+        readBools(stream, &hasScale, 1);
+        if (numKeys == 0)
+            return;
+
+        std::vector<Real> times(numKeys);
+        std::vector<Quaternion> rotates(numKeys);
+        std::vector<Vector3> translates(numKeys), scales;
+        readFloats(stream, times.data(), numKeys);
+        readFloats(stream, rotates.data()->ptr(), numKeys * 4);
+        readFloats(stream, translates.data()->ptr(), numKeys * 3);
+        if (hasScale)
+        {
+            scales.resize(numKeys);
+            readFloats(stream, scales.data()->ptr(), numKeys * 3);
+        }
+
+        track->_appendKeyFrames(times, std::move(translates), std::move(rotates), std::move(scales));
+    }
+    //---------------------------------------------------------------------
+    void SkeletonSerializer::_importAnimationTracks(const DataStreamPtr& stream, bool flipEndian, Animation* anim,
+                                                    Skeleton* pSkel)
+    {
+        mFlipEndian = flipEndian;
+        mVersion = PACKED_KEYFRAMES_VERSION;
+
+        DataStreamPtr tracks = stream;
+        while (!tracks->eof())
+        {
+            auto streamID = static_cast<SkeletonChunkID>(readChunk(tracks));
+            if (streamID != SkeletonChunkID::ANIMATION_TRACK)
+            {
+                tracks->skip(mCurrentstreamLen - SSTREAM_OVERHEAD_SIZE);
+                continue;
+            }
+            readAnimationTrack(tracks, anim, pSkel);
+        }
+    }
+    //---------------------------------------------------------------------
     void SkeletonSerializer::writeSkeletonAnimationLink(const Skeleton* pSkel, 
         const LinkedSkeletonAnimationSource& link)
     {
@@ -0,0 +1,143 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+module;
+
+#include <cassert>
+#include <cstddef>
+
+module Ogre.Core;
+
+import :HardwareBufferManager;
+import :HardwareVertexBuffer;
+import :Matrix4;
+import :RenderOperation;
+import :RenderToVertexBuffer;
+import :SkinnedVertexCache;
+import :VertexIndexData;
+
+import <memory>;
+import <string_view>;
+import <vector>;
+
+namespace Ogre {
+    //-----------------------------------------------------------------------
+    SkinnedVertexCache::SkinnedVertexCache(const VertexData* sourceData,
+                                           const std::vector<unsigned short>& blendIndexToBoneIndexMap,
+                                           std::string_view materialName)
+        : mSourceData(sourceData)
+        , mBlendIndexToBoneIndexMap(blendIndexToBoneIndexMap)
+    {
+        const VertexDeclaration* sourceDecl = mSourceData->vertexDeclaration;
+        const VertexElement* posElem = sourceDecl->findElementBySemantic(VertexElementSemantic::POSITION);
+        const VertexElement* normElem = sourceDecl->findElementBySemantic(VertexElementSemantic::NORMAL);
+        assert(posElem && "Skinned vertex data without positions!");
+        mIncludesNormals = normElem != nullptr;
+
+        // the skinning pass writes interleaved positions and normals, one point per source vertex.
+        // Normals travel in the first texture coordinate, which every transform feedback
+        // implementation is able to capture
+        mRenderToBuffer = HardwareBufferManager::getSingleton().createRenderToVertexBuffer();
+        VertexDeclaration* outDecl = mRenderToBuffer->getVertexDeclaration();
+        outDecl->addElement(0, 0, VertexElementType::FLOAT3, VertexElementSemantic::POSITION);
+        if (mIncludesNormals)
+            outDecl->addElement(0, VertexElement::getTypeSize(VertexElementType::FLOAT3),
+                                VertexElementType::FLOAT3, VertexElementSemantic::TEXTURE_COORDINATES);
+        mRenderToBuffer->setOperationType(RenderOperation::OperationType::POINT_LIST);
+        mRenderToBuffer->setMaxVertexCount(static_cast<unsigned int>(mSourceData->vertexCount));
+        mRenderToBuffer->setResetsEveryUpdate(true);
+        mRenderToBuffer->setSourceRenderable(this);
+        mRenderToBuffer->setRenderToBufferMaterialName(materialName);
+        mMaterial = mRenderToBuffer->getRenderToBufferMaterial();
+
+        // Share everything but position and normal with the source, which are redirected
+        // to a new source bound to the transform feedback output on every update
+        mVertexData.reset(mSourceData->clone(false));
+        VertexDeclaration* decl = mVertexData->vertexDeclaration;
+        VertexBufferBinding* bind = mVertexData->vertexBufferBinding;
+        unsigned short posSource = posElem->getSource();
+        unsigned short normSource = mIncludesNormals ? normElem->getSource() : posSource;
+        decl->removeElement(VertexElementSemantic::POSITION);
+        if (mIncludesNormals)
+            decl->removeElement(VertexElementSemantic::NORMAL);
+        for (unsigned short source : {posSource, normSource})
+        {
+            if (bind->isBufferBound(source) && decl->findElementsBySource(source).empty())
+                bind->unsetBinding(source);
+        }
+
+        unsigned short skinnedSource = bind->getNextIndex();
+        decl->addElement(skinnedSource, 0, VertexElementType::FLOAT3, VertexElementSemantic::POSITION);
+        if (mIncludesNormals)
+            decl->addElement(skinnedSource, VertexElement::getTypeSize(VertexElementType::FLOAT3),
+                             VertexElementType::FLOAT3, VertexElementSemantic::NORMAL);
+        // bind something for now so the gaps get closed around the new source
+        bind->setBinding(skinnedSource, mSourceData->vertexBufferBinding->getBuffer(posSource));
+        mVertexData->closeGapsInBindings();
+        mSkinnedBufferSource = decl->findElementBySemantic(VertexElementSemantic::POSITION)->getSource();
+    }
+    //-----------------------------------------------------------------------
+    SkinnedVertexCache::~SkinnedVertexCache() = default;
+    //-----------------------------------------------------------------------
+    void SkinnedVertexCache::update(const Affine3* boneMatrices, SceneManager* sceneMgr)
+    {
+        mBoneMatrices = boneMatrices;
+        mRenderToBuffer->update(sceneMgr);
+        mBoneMatrices = nullptr;
+
+        // the render to vertex buffer may have swapped or reallocated its buffer
+        RenderOperation op;
+        mRenderToBuffer->getRenderOperation(op);
+        mVertexData->vertexBufferBinding->setBinding(mSkinnedBufferSource,
+                                                     op.vertexData->vertexBufferBinding->getBuffer(0));
+    }
+    //-----------------------------------------------------------------------
+    void SkinnedVertexCache::getRenderOperation(RenderOperation& op)
+    {
+        // every source vertex becomes exactly one skinned vertex, in order, so the
+        // original index data can still be used to draw the result
+        op.operationType = RenderOperation::OperationType::POINT_LIST;
+        op.useIndexes = false;
+        op.indexData = nullptr;
+        op.vertexData = const_cast<VertexData*>(mSourceData);
+    }
+    //-----------------------------------------------------------------------
+    void SkinnedVertexCache::getWorldTransforms(Matrix4* xform) const
+    {
+        assert(mBoneMatrices && "Bone matrices are only available during update!");
+        for (auto boneIndex : mBlendIndexToBoneIndexMap)
+        {
+            *xform = mBoneMatrices[boneIndex];
+            ++xform;
+        }
+    }
+    //-----------------------------------------------------------------------
+    auto SkinnedVertexCache::getNumWorldTransforms() const noexcept -> unsigned short
+    {
+        return static_cast<unsigned short>(mBlendIndexToBoneIndexMap.size());
+    }
+}
@@ -0,0 +1,376 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+module;
+
+#include <cstddef>
+
+module Ogre.Core;
+
+import :AxisAlignedBox;
+import :Camera;
+import :Entity;
+import :HardwareBuffer;
+import :HardwareIndexBuffer;
+import :HardwareVertexBuffer;
+import :Matrix4;
+import :Mesh;
+import :RenderOperation;
+import :Root;
+import :SceneNode;
+import :SoftwareOcclusionCulling;
+import :SubMesh;
+import :Timer;
+import :Vector;
+import :VertexIndexData;
+
+import <algorithm>;
+import <cmath>;
+import <limits>;
+import <map>;
+import <unordered_set>;
+import <utility>;
+import <vector>;
+
+namespace Ogre {
+
+    namespace {
+        /// Inclusive range of the pixels touched by [minCoord, maxCoord], first > last if none
+        auto pixelRange(Real minCoord, Real maxCoord, uint32 size) -> std::pair<int32, int32>
+        {
+            Real first = std::max(std::floor(minCoord), Real(0));
+            Real last = std::min(std::floor(maxCoord), Real(size) - 1);
+            if (!(first <= last))
+                return {1, 0};
+            return {int32(first), int32(last)};
+        }
+    }
+    //-----------------------------------------------------------------------
+    SoftwareOcclusionCulling::SoftwareOcclusionCulling() = default;
+    //-----------------------------------------------------------------------
+    SoftwareOcclusionCulling::~SoftwareOcclusionCulling() = default;
+    //-----------------------------------------------------------------------
+    void SoftwareOcclusionCulling::setResolution(uint32 width, uint32 height)
+    {
+        OgreAssert(width > 0 && height > 0, "empty depth buffer");
+        mWidth = width;
+        mHeight = height;
+    }
+    //-----------------------------------------------------------------------
+    void SoftwareOcclusionCulling::addOccluder(Entity* ent)
+    {
+        OgreAssert(ent, "null occluder");
+        if (std::find(mOccluders.begin(), mOccluders.end(), ent) != mOccluders.end())
+            return;
+
+        const Mesh* mesh = ent->getMesh().get();
+        if (!mMeshTriangles.contains(mesh))
+            mMeshTriangles[mesh] = buildTriangles(mesh);
+        mOccluders.push_back(ent);
+    }
+    //-----------------------------------------------------------------------
+    void SoftwareOcclusionCulling::removeOccluder(Entity* ent)
+    {
+        auto it = std::find(mOccluders.begin(), mOccluders.end(), ent);
+        if (it == mOccluders.end())
+            return;
+        mOccluders.erase(it);
+
+        // drop the triangles once no occluder uses the mesh any more
+        const Mesh* mesh = ent->getMesh().get();
+        if (std::none_of(mOccluders.begin(), mOccluders.end(),
+                         [mesh](const Entity* e) { return e->getMesh().get() == mesh; }))
+            mMeshTriangles.erase(mesh);
+    }
+    //-----------------------------------------------------------------------
+    void SoftwareOcclusionCulling::removeAllOccluders()
+    {
+        mOccluders.clear();
+        mMeshTriangles.clear();
+        mOccluderNodes.clear();
+    }
+    //-----------------------------------------------------------------------
+    auto SoftwareOcclusionCulling::buildTriangles(const Mesh* mesh) -> TriangleList
+    {
+        TriangleList triangles;
+        for (const SubMesh* sub : mesh->getSubMeshes())
+        {
+            const VertexData* vertexData = sub->useSharedVertices ? mesh->sharedVertexData : sub->vertexData.get();
+            const IndexData* indexData = sub->indexData.get();
+            if (!vertexData)
+                continue;
+
+            bool indexed = indexData && indexData->indexCount > 0;
+            size_t count = indexed ? indexData->indexCount : vertexData->vertexCount;
+            size_t iterations;
+
+            using enum RenderOperation::OperationType;
+            switch (sub->operationType)
+            {
+            case TRIANGLE_LIST:
+                iterations = count / 3;
+                break;
+            case TRIANGLE_FAN:
+            case TRIANGLE_STRIP:
+                iterations = count < 2 ? 0 : count - 2;
+                break;
+            default:
+                continue; // no area to occlude with
+            };
+
+            // locate position element & the buffer to go with it
+            const VertexElement* posElem =
+                vertexData->vertexDeclaration->findElementBySemantic(VertexElementSemantic::POSITION);
+            if (!posElem || iterations == 0)
+                continue;
+            HardwareVertexBufferSharedPtr vbuf = vertexData->vertexBufferBinding->getBuffer(posElem->getSource());
+            HardwareBufferLockGuard vertexLock(vbuf, HardwareBuffer::LockOptions::READ_ONLY);
+            auto* pBaseVertex = static_cast<unsigned char*>(vertexLock.pData) +
+                vertexData->vertexStart * vbuf->getVertexSize();
+
+            HardwareBufferLockGuard indexLock;
+            bool idx32bit = false;
+            if (indexed)
+            {
+                idx32bit = indexData->indexBuffer->getType() == HardwareIndexBuffer::IndexType::_32BIT;
+                indexLock.lock(indexData->indexBuffer.get(), HardwareBuffer::LockOptions::READ_ONLY);
+            }
+            auto* p16Idx = static_cast<unsigned short*>(indexLock.pData) + (indexed ? indexData->indexStart : 0);
+            auto* p32Idx = static_cast<unsigned int*>(indexLock.pData) + (indexed ? indexData->indexStart : 0);
+
+            auto position = [&](size_t i) -> Vector3
+            {
+                size_t vertex = !indexed ? i : idx32bit ? p32Idx[i] : p16Idx[i];
+                float* pFloat;
+                posElem->baseVertexPointerToElement(pBaseVertex + vertex * vbuf->getVertexSize(), &pFloat);
+                return {pFloat[0], pFloat[1], pFloat[2]};
+            };
+
+            triangles.reserve(triangles.size() + iterations * 3);
+            for (size_t t = 0; t < iterations; ++t)
+            {
+                // the winding does not matter, both faces are rasterized
+                switch (sub->operationType)
+                {
+                case TRIANGLE_LIST:
+                    triangles.push_back(position(t * 3));
+                    triangles.push_back(position(t * 3 + 1));
+                    triangles.push_back(position(t * 3 + 2));
+                    break;
+                case TRIANGLE_FAN:
+                    triangles.push_back(position(0));
+                    triangles.push_back(position(t + 1));
+                    triangles.push_back(position(t + 2));
+                    break;
+                default:
+                    triangles.push_back(position(t));
+                    triangles.push_back(position(t + 1));
+                    triangles.push_back(position(t + 2));
+                    break;
+                }
+            }
+        }
+        return triangles;
+    }
+    //-----------------------------------------------------------------------
+    void SoftwareOcclusionCulling::_beginFrame(const Camera* cam, SceneManager* sceneMgr)
+    {
+        (void)sceneMgr;
+        mActive = true;
+        mStats = {};
+        mOccluderNodes.clear();
+        mDepth.assign(size_t(mWidth) * mHeight, std::numeric_limits<float>::max());
+        mViewProj = cam->getProjectionMatrix() * cam->getViewMatrix();
+
+        Timer* timer = Root::getSingleton().getTimer();
+        uint64 start = timer->getMicroseconds();
+        for (auto ent : mOccluders)
+        {
+            if (!ent->isInScene() || !ent->isVisible() || !cam->isVisible(ent->getWorldBoundingBox(true)))
+                continue;
+
+            if (const SceneNode* node = ent->getParentSceneNode())
+                mOccluderNodes.insert(node);
+            ++mStats.occludersRasterized;
+            rasterizeOccluder(ent, mMeshTriangles[ent->getMesh().get()]);
+        }
+        mStats.rasterizeMicroseconds = timer->getMicroseconds() - start;
+    }
+    //-----------------------------------------------------------------------
+    auto SoftwareOcclusionCulling::_isVisible(const SceneNode* node, const AxisAlignedBox& bounds) -> bool
+    {
+        if (!mActive)
+            return true;
+
+        ++mStats.nodesTested;
+        if (!bounds.isFinite() || mOccluderNodes.contains(node))
+            return true;
+
+        // screen rectangle and closest depth of the bounds
+        Real minX = std::numeric_limits<Real>::max(), maxX = -minX;
+        Real minY = minX, maxY = maxX;
+        Real minZ = minX;
+        for (const Vector3& corner : bounds.getAllCorners())
+        {
+            Vector4 clip = mViewProj * Vector4{corner.x, corner.y, corner.z, 1};
+            // crossing the near plane, the box surrounds the camera
+            if (clip.z + clip.w <= 0)
+                return true;
+
+            Vector3 screen = toScreen(clip);
+            minX = std::min(minX, screen.x); maxX = std::max(maxX, screen.x);
+            minY = std::min(minY, screen.y); maxY = std::max(maxY, screen.y);
+            minZ = std::min(minZ, screen.z);
+        }
+
+        auto [x0, x1] = pixelRange(minX, maxX, mWidth);
+        auto [y0, y1] = pixelRange(minY, maxY, mHeight);
+        // the frustum culling decides about bounds off the screen
+        if (x0 > x1 || y0 > y1)
+            return true;
+
+        for (int32 y = y0; y <= y1; ++y)
+        {
+            const float* row = &mDepth[size_t(y) * mWidth];
+            for (int32 x = x0; x <= x1; ++x)
+            {
+                if (row[x] >= minZ)
+                    return true;
+            }
+        }
+
+        ++mStats.nodesCulled;
+        return false;
+    }
+    //-----------------------------------------------------------------------
+    void SoftwareOcclusionCulling::_endFrame(SceneManager* sceneMgr)
+    {
+        (void)sceneMgr;
+        mActive = false;
+    }
+    //-----------------------------------------------------------------------
+    void SoftwareOcclusionCulling::_notifyAllNodesDestroyed()
+    {
+        removeAllOccluders();
+    }
+    //-----------------------------------------------------------------------
+    void SoftwareOcclusionCulling::rasterizeOccluder(const Entity* ent, const TriangleList& triangles)
+    {
+        Matrix4 worldViewProj = mViewProj * ent->_getParentNodeFullTransform();
+
+        mClipVertices.resize(triangles.size());
+        for (size_t i = 0; i < triangles.size(); ++i)
+        {
+            const Vector3& p = triangles[i];
+            mClipVertices[i] = worldViewProj * Vector4{p.x, p.y, p.z, 1};
+        }
+
+        for (size_t i = 0; i + 2 < mClipVertices.size(); i += 3)
+            rasterizeTriangle(mClipVertices[i], mClipVertices[i + 1], mClipVertices[i + 2]);
+    }
+    //-----------------------------------------------------------------------
+    void SoftwareOcclusionCulling::rasterizeTriangle(const Vector4& a, const Vector4& b, const Vector4& c)
+    {
+        const Vector4* in[3] = {&a, &b, &c};
+        // signed distances to the near plane, z >= -w
+        Real dist[3] = {a.z + a.w, b.z + b.w, c.z + c.w};
+        if (dist[0] < 0 && dist[1] < 0 && dist[2] < 0)
+            return;
+
+        // clipping a triangle by one plane leaves at most a quad
+        Vector4 clipped[4];
+        size_t numClipped = 0;
+        for (size_t i = 0; i < 3; ++i)
+        {
+            size_t j = (i + 1) % 3;
+            if (dist[i] >= 0)
+                clipped[numClipped++] = *in[i];
+            if ((dist[i] >= 0) != (dist[j] >= 0))
+            {
+                Real t = dist[i] / (dist[i] - dist[j]);
+                clipped[numClipped++] = *in[i] + (*in[j] - *in[i]) * t;
+            }
+        }
+
+        if (numClipped < 3)
+            return;
+        Vector3 s0 = toScreen(clipped[0]);
+        rasterizeScreenTriangle(s0, toScreen(clipped[1]), toScreen(clipped[2]));
+        if (numClipped == 4)
+            rasterizeScreenTriangle(s0, toScreen(clipped[2]), toScreen(clipped[3]));
+    }
+    //-----------------------------------------------------------------------
+    void SoftwareOcclusionCulling::rasterizeScreenTriangle(Vector3 a, Vector3 b, Vector3 c)
+    {
+        auto edge = [](const Vector3& e0, const Vector3& e1, Real px, Real py)
+        { return (e1.x - e0.x) * (py - e0.y) - (e1.y - e0.y) * (px - e0.x); };
+
+        // counter clockwise in screen space, so that the inside is positive
+        Real area = edge(a, b, c.x, c.y);
+        if (!(area != 0))
+            return;
+        if (area < 0)
+        {
+            std::swap(b, c);
+            area = -area;
+        }
+
+        auto [x0, x1] = pixelRange(std::min({a.x, b.x, c.x}), std::max({a.x, b.x, c.x}), mWidth);
+        auto [y0, y1] = pixelRange(std::min({a.y, b.y, c.y}), std::max({a.y, b.y, c.y}), mHeight);
+        if (x0 > x1 || y0 > y1)
+            return;
+        ++mStats.trianglesRasterized;
+
+        // the edge functions, z' = z / w being linear in screen space too, are stepped
+        // along the rows, giving a branch free loop the compiler can vectorise
+        Real invArea = 1 / area;
+        Real stepX0 = b.y - c.y, stepX1 = c.y - a.y, stepX2 = a.y - b.y;
+        Real px = Real(x0) + 0.5f;
+        for (int32 y = y0; y <= y1; ++y)
+        {
+            Real py = Real(y) + 0.5f;
+            Real w0 = edge(b, c, px, py), w1 = edge(c, a, px, py), w2 = edge(a, b, px, py);
+            float* row = &mDepth[size_t(y) * mWidth];
+            for (int32 x = x0; x <= x1; ++x)
+            {
+                Real i = Real(x - x0);
+                Real e0 = w0 + stepX0 * i, e1 = w1 + stepX1 * i, e2 = w2 + stepX2 * i;
+                auto z = float((e0 * a.z + e1 * b.z + e2 * c.z) * invArea);
+                bool inside = (e0 >= 0) & (e1 >= 0) & (e2 >= 0);
+                row[x] = inside ? std::min(row[x], z) : row[x];
+            }
+        }
+    }
+    //-----------------------------------------------------------------------
+    auto SoftwareOcclusionCulling::toScreen(const Vector4& clip) const -> Vector3
+    {
+        Real invW = 1 / clip.w;
+        return {(clip.x * invW * 0.5f + 0.5f) * Real(mWidth),
+                (0.5f - clip.y * invW * 0.5f) * Real(mHeight),
+                clip.z * invW};
+    }
+}
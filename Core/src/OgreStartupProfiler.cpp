@@ -0,0 +1,282 @@
+// This file is part of the OGRE project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at https://www.ogre3d.org/licensing.
+module;
+
+#include <cassert>
+#include <cstddef>
+
+module Ogre.Core;
+
+import :Log;
+import :LogManager;
+import :Platform;
+import :Singleton;
+import :StartupProfiler;
+import :String;
+
+import <algorithm>;
+import <array>;
+import <chrono>;
+import <format>;
+import <mutex>;
+import <ostream>;
+import <string>;
+import <string_view>;
+import <thread>;
+import <vector>;
+
+namespace Ogre {
+    //---------------------------------------------------------------------
+    template<> StartupProfiler* Singleton<StartupProfiler>::msSingleton = nullptr;
+    auto StartupProfiler::getSingletonPtr() noexcept -> StartupProfiler*
+    {
+        return msSingleton;
+    }
+    auto StartupProfiler::getSingleton() noexcept -> StartupProfiler&
+    {
+        assert( msSingleton );  return ( *msSingleton );
+    }
+    thread_local size_t StartupProfiler::msCurrentPhase = StartupProfiler::NO_PHASE;
+    //---------------------------------------------------------------------
+    StartupProfiler::Scope::Scope(PhaseType type, std::string_view name)
+    {
+        StartupProfiler* profiler = getSingletonPtr();
+        if (profiler && profiler->isRecording())
+        {
+            mProfiler = profiler;
+            mPhase = profiler->beginPhase(type, name);
+        }
+    }
+    //---------------------------------------------------------------------
+    StartupProfiler::Scope::~Scope()
+    {
+        if (mProfiler)
+            mProfiler->endPhase(mPhase);
+    }
+    //---------------------------------------------------------------------
+    StartupProfiler::StartupProfiler()
+        : mEpoch(std::chrono::duration_cast<std::chrono::nanoseconds>(
+              std::chrono::steady_clock::now().time_since_epoch()).count())
+    {
+        mThreads.push_back(std::this_thread::get_id());
+    }
+    //---------------------------------------------------------------------
+    StartupProfiler::~StartupProfiler() = default;
+    //---------------------------------------------------------------------
+    auto StartupProfiler::now() const -> uint64
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count() - mEpoch;
+    }
+    //---------------------------------------------------------------------
+    auto StartupProfiler::getTypeName(PhaseType type) -> std::string_view
+    {
+        using enum PhaseType;
+        switch (type)
+        {
+        case PLUGIN_LOAD:
+            return "Plugin loading";
+        case RENDER_SYSTEM_INIT:
+            return "RenderSystem initialisation";
+        case CAPABILITIES:
+            return "Capability detection";
+        case RESOURCE_GROUP:
+            return "Resource group initialisation";
+        case SCRIPT_PARSE:
+            return "Script parsing";
+        case SHADER_COMPILE:
+            return "Shader compilation";
+        case MESH_LOAD:
+            return "Mesh loading";
+        case OTHER:
+            break;
+        }
+        return "Other";
+    }
+    //---------------------------------------------------------------------
+    auto StartupProfiler::beginPhase(PhaseType type, std::string_view name) -> size_t
+    {
+        uint64 start = now();
+        std::lock_guard lock{mMutex};
+
+        auto thread = std::ranges::find(mThreads, std::this_thread::get_id());
+        if (thread == mThreads.end())
+            thread = mThreads.insert(thread, std::this_thread::get_id());
+
+        size_t parent = msCurrentPhase;
+        uint32 depth = 0;
+        if (parent != NO_PHASE && parent < mPhases.size())
+        {
+            mPhases[parent].hasChildren = true;
+            depth = mPhases[parent].depth + 1;
+        }
+        else
+            parent = NO_PHASE;
+
+        mPhases.push_back({type, String{name}, static_cast<uint32>(thread - mThreads.begin()), depth, parent,
+                           start, 0, false});
+        msCurrentPhase = mPhases.size() - 1;
+        return msCurrentPhase;
+    }
+    //---------------------------------------------------------------------
+    void StartupProfiler::endPhase(size_t phase)
+    {
+        uint64 end = now();
+        std::lock_guard lock{mMutex};
+        Phase& p = mPhases[phase];
+        msCurrentPhase = p.parent;
+        // the phases are left as they are once finished
+        if (isRecording())
+            p.duration = std::max<uint64>(end - p.start, 1);
+    }
+    //---------------------------------------------------------------------
+    void StartupProfiler::finish()
+    {
+        {
+            std::lock_guard lock{mMutex};
+            if (!isRecording())
+                return;
+            mDuration = now();
+            mRecording.store(false, std::memory_order_relaxed);
+        }
+
+        std::vector<PathSpan> path = getCriticalPath();
+
+        Log::Stream stream = LogManager::getSingleton().stream();
+        stream << std::format("Startup took {:.1f} ms until the first frame, {} phases on {} threads. Critical path:",
+                              mDuration / 1e6, mPhases.size(), mThreads.size());
+
+        // runs of phases of one type under the same parent, like the scripts of a group, are summed up
+        for (size_t i = 0; i < path.size();)
+        {
+            const PathSpan& span = path[i];
+            uint64 duration = span.duration;
+            size_t count = 1;
+            if (span.phase != NO_PHASE && !span.self)
+            {
+                const Phase& phase = mPhases[span.phase];
+                for (; i + count < path.size(); ++count)
+                {
+                    const PathSpan& next = path[i + count];
+                    if (next.phase == NO_PHASE || next.self || mPhases[next.phase].type != phase.type ||
+                        mPhases[next.phase].parent != phase.parent)
+                        break;
+                    duration += next.duration;
+                }
+            }
+
+            String label;
+            if (span.phase == NO_PHASE)
+                label = "outside of any phase";
+            else if (count > 1)
+                label = std::format("{} x{}", getTypeName(mPhases[span.phase].type), count);
+            else
+                label = std::format("{} '{}'{}", getTypeName(mPhases[span.phase].type), mPhases[span.phase].name,
+                                    span.self ? ", own work" : "");
+            stream << std::format("\n  {:9.2f} ms {:5.1f}%  {}", duration / 1e6, 100.0 * duration / mDuration, label);
+            i += count;
+        }
+
+        // the time of every type, not counting the phases nested in one of the same type twice
+        std::array<uint64, size_t(PhaseType::OTHER) + 1> typeTotals{};
+        for (const Phase& phase : mPhases)
+        {
+            size_t parent = phase.parent;
+            while (parent != NO_PHASE && mPhases[parent].type != phase.type)
+                parent = mPhases[parent].parent;
+            if (parent == NO_PHASE)
+                typeTotals[size_t(phase.type)] += phase.duration;
+        }
+        stream << "\nTime per phase type, summed over all threads:";
+        for (size_t type = 0; type < typeTotals.size(); ++type)
+        {
+            if (typeTotals[type])
+                stream << std::format("\n  {:9.2f} ms  {}", typeTotals[type] / 1e6, getTypeName(PhaseType(type)));
+        }
+    }
+    //---------------------------------------------------------------------
+    auto StartupProfiler::getCriticalPath() const -> std::vector<PathSpan>
+    {
+        std::vector<PathSpan> path;
+
+        // the time between leaves goes to the innermost phase around it
+        auto addGap = [&](uint64 begin, uint64 end)
+        {
+            size_t owner = NO_PHASE;
+            for (size_t i = 0; i < mPhases.size(); ++i)
+            {
+                const Phase& p = mPhases[i];
+                if (p.duration && p.start <= begin && p.start + p.duration >= end &&
+                    (owner == NO_PHASE || p.start >= mPhases[owner].start))
+                    owner = i;
+            }
+            if (!path.empty() && path.back().phase == owner && path.back().self && path.back().start == end)
+            {
+                path.back().start = begin;
+                path.back().duration += end - begin;
+            }
+            else
+                path.push_back({owner, begin, end - begin, owner != NO_PHASE});
+        };
+
+        std::vector<size_t> leaves;
+        for (size_t i = 0; i < mPhases.size(); ++i)
+        {
+            if (mPhases[i].duration && !mPhases[i].hasChildren)
+                leaves.push_back(i);
+        }
+        std::ranges::sort(leaves, std::ranges::greater{},
+                          [this](size_t i) { return mPhases[i].start + mPhases[i].duration; });
+
+        // back from the end, always to the leaf which ended last before
+        uint64 time = mDuration;
+        for (size_t i : leaves)
+        {
+            const Phase& leaf = mPhases[i];
+            uint64 end = leaf.start + leaf.duration;
+            if (end > time)
+                continue;
+            if (end < time)
+                addGap(end, time);
+            path.push_back({i, leaf.start, leaf.duration, false});
+            time = leaf.start;
+        }
+        if (time > 0)
+            addGap(0, time);
+
+        std::ranges::reverse(path);
+        return path;
+    }
+    //---------------------------------------------------------------------
+    void StartupProfiler::writeTrace(std::ostream& stream) const
+    {
+        stream << "{\"traceEvents\":[\n";
+        stream << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":2,\"tid\":0,\"args\":{\"name\":\"Critical path\"}}";
+        for (size_t i = 0; i < mThreads.size(); ++i)
+        {
+            stream << std::format(",\n{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":{},"
+                                  "\"args\":{{\"name\":\"{}\"}}}}",
+                                  i, i == 0 ? String("Main") : std::format("Thread {}", i));
+        }
+
+        for (const Phase& phase : mPhases)
+        {
+            if (!phase.duration)
+                continue;
+            stream << std::format(",\n{{\"name\":\"{}\",\"cat\":\"{}\",\"ph\":\"X\",\"ts\":{:.3f},"
+                                  "\"dur\":{:.3f},\"pid\":1,\"tid\":{}}}",
+                                  StringUtil::escapeJson(phase.name), getTypeName(phase.type), phase.start / 1000.0,
+                                  phase.duration / 1000.0, phase.thread);
+        }
+        for (const PathSpan& span : getCriticalPath())
+        {
+            stream << std::format(",\n{{\"name\":\"{}\",\"cat\":\"Critical path\",\"ph\":\"X\",\"ts\":{:.3f},"
+                                  "\"dur\":{:.3f},\"pid\":2,\"tid\":0}}",
+                                  span.phase == NO_PHASE ? String("Outside of any phase")
+                                                         : StringUtil::escapeJson(mPhases[span.phase].name),
+                                  span.start / 1000.0, span.duration / 1000.0);
+        }
+        stream << "\n],\"displayTimeUnit\":\"ms\"}\n";
+    }
+}
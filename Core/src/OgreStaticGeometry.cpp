@@ -58,13 +58,30 @@ import :SubEntity;
 import :SubMesh;
 import :Technique;
 import :VertexIndexData;
+import :WorkQueue;
 
 import <algorithm>;
 import <memory>;
 import <ostream>;
+import <set>;
 import <utility>;
 
 namespace Ogre {
+namespace {
+    /// Regions per cluster at the bottom of the region tree
+    constexpr size_t REGION_CLUSTER_SIZE = 8;
+    /// IDs of far-field regions start above those of packed region indexes
+    constexpr uint32 FAR_FIELD_ID_BASE = 1u << 30;
+
+    void unlockSources(StaticGeometry::SourceLockMap& sourceLocks)
+    {
+        for (auto const& [buffer, pData] : sourceLocks)
+        {
+            buffer->unlock();
+        }
+        sourceLocks.clear();
+    }
+}
 
     #define REGION_RANGE 1024
     #define REGION_HALF_RANGE 512
@@ -313,21 +330,41 @@ namespace Ogre {
         for (uint i = 0; i < ent->getNumSubEntities(); ++i)
         {
             SubEntity* se = ent->getSubEntity(i);
-            auto* q = new QueuedSubMesh();
-
-            // Get the geometry for this SubMesh
-            q->submesh = se->getSubMesh();
-            q->material = se->getMaterial();
-            q->geometryLodList = determineGeometry(q->submesh);
-            q->orientation = orientation;
-            q->position = position;
-            q->scale = scale;
-            // Determine the bounds based on the highest LOD
-            q->worldBounds = calculateBounds(
-                (*q->geometryLodList)[0].vertexData,
-                    position, orientation, scale);
-
-            mQueuedSubMeshes.push_back(q);
+            addSubMesh(se->getSubMesh(), se->getMaterial(), position, orientation, scale);
+        }
+    }
+    //--------------------------------------------------------------------------
+    void StaticGeometry::addSubMesh(SubMesh* submesh, const MaterialPtr& material, const Vector3& position,
+        const Quaternion& orientation, const Vector3& scale)
+    {
+        auto* q = new QueuedSubMesh();
+
+        // Get the geometry for this SubMesh
+        q->submesh = submesh;
+        q->material = material;
+        q->geometryLodList = determineGeometry(q->submesh);
+        q->orientation = orientation;
+        q->position = position;
+        q->scale = scale;
+        // Determine the bounds based on the highest LOD
+        q->worldBounds = calculateBounds(
+            (*q->geometryLodList)[0].vertexData,
+                position, orientation, scale);
+
+        mQueuedSubMeshes.push_back(q);
+
+        // Already built, only the region this goes to needs rebuilding
+        if (mBuilt)
+        {
+            Region* region = getRegion(q->worldBounds, true);
+            region->assign(q);
+            region->setVisibilityFlags(mVisibilityFlags);
+            mDirtyRegions.insert(region->getID());
+            if (Region* farField = region->getFarField())
+            {
+                farField->assign(q);
+                mDirtyFarFields.insert(farField);
+            }
         }
     }
     //--------------------------------------------------------------------------
@@ -546,25 +583,227 @@ namespace Ogre {
             Region* region = getRegion(qsm->worldBounds, true);
             region->assign(qsm);
         }
+        mBuilt = true;
+
+        std::vector<Region*> regions;
+        for (auto & ri : mRegionMap)
+        {
+            // Set the visibility flags on these regions
+            ri.second->setVisibilityFlags(mVisibilityFlags);
+
+            // Streamed regions wait for updateStreaming
+            if (!isRegionStreamingEnabled())
+                regions.push_back(ri.second);
+        }
+
+        // Group the regions so they can be culled together
+        if (!mRegionMap.empty())
+        {
+            std::vector<Region*> treeRegions;
+            for (auto & ri : mRegionMap)
+                treeRegions.push_back(ri.second);
+
+            SceneNode* treeRoot = mOwner->getRootSceneNode()->createChildSceneNode();
+            mRegionTreeNodes.push_back(treeRoot);
+            buildRegionTree(treeRoot, treeRegions.begin(), treeRegions.end());
+        }
+        regions.insert(regions.end(), mFarFieldRegions.begin(), mFarFieldRegions.end());
+
+        // Now tell each region to build itself
+        buildRegions(regions);
+    }
+    //--------------------------------------------------------------------------
+    void StaticGeometry::buildRegions(const std::vector<Region*>& regions)
+    {
         bool stencilShadows = false;
         if (mCastShadows && mOwner->isShadowTechniqueStencilBased())
         {
             stencilShadows = true;
         }
 
-        // Now tell each region to build itself
-        for (auto & ri : mRegionMap)
+        std::vector<GeometryBucket*> buckets;
+        for (auto region : regions)
         {
-            ri.second->build(stencilShadows);
-            
-            // Set the visibility flags on these regions
-            ri.second->setVisibilityFlags(mVisibilityFlags);
+            region->prepare();
+            for (auto const& lodBucket : region->getLODBuckets())
+                for (auto const& [name, matBucket] : lodBucket->getMaterialBuckets())
+                    for (auto const& geomBucket : matBucket->getGeometryList())
+                        buckets.push_back(geomBucket.get());
+        }
+
+        // The buffers can only be locked and created here, but the transforms of
+        // all buckets can run at once in between
+        Root* root = Root::getSingletonPtr();
+        if (buckets.size() > 1 && root && root->getWorkQueue())
+        {
+            SourceLockMap sourceLocks;
+            for (auto bucket : buckets)
+                bucket->lockSources(sourceLocks);
+
+            root->getWorkQueue()->parallelFor(buckets.size(), [&](size_t i) { buckets[i]->merge(sourceLocks); });
+
+            unlockSources(sourceLocks);
+        }
+
+        for (auto region : regions)
+        {
+            region->finishBuild(stencilShadows);
+            mDirtyRegions.erase(region->getID());
+        }
+    }
+    //--------------------------------------------------------------------------
+    void StaticGeometry::buildRegionTree(SceneNode* node, std::vector<Region*>::iterator first,
+                                         std::vector<Region*>::iterator last)
+    {
+        auto count = static_cast<size_t>(last - first);
+        if (count <= REGION_CLUSTER_SIZE)
+        {
+            // Bottom of the tree, one far-field region for the whole cluster
+            Region* farField = nullptr;
+            if (mSquaredFarFieldDistance > 0 && count > 1)
+            {
+                AxisAlignedBox clusterBounds;
+                for (auto it = first; it != last; ++it)
+                {
+                    const AxisAlignedBox& localBounds = (*it)->getBoundingBox();
+                    clusterBounds.merge(localBounds.getMinimum() + (*it)->getCentre());
+                    clusterBounds.merge(localBounds.getMaximum() + (*it)->getCentre());
+                }
+
+                auto index = static_cast<uint32>(mFarFieldRegions.size());
+                StringStream str;
+                str << mName << ":FarField:" << index;
+                farField = new Region(this, str.str(), mOwner, FAR_FIELD_ID_BASE + index, clusterBounds.getCenter());
+                farField->_setIsFarField();
+                farField->_setTreeNode(node);
+                mOwner->injectMovableObject(farField);
+                farField->setVisible(mVisible);
+                farField->setCastShadows(mCastShadows);
+                if (mRenderQueueIDSet)
+                {
+                    farField->setRenderQueueGroup(mRenderQueueID);
+                }
+                farField->setVisibilityFlags(mVisibilityFlags);
+                mFarFieldRegions.push_back(farField);
+            }
+
+            for (auto it = first; it != last; ++it)
+            {
+                (*it)->_setTreeNode(node);
+                if (farField)
+                    (*it)->_setFarField(farField);
+            }
+            return;
+        }
+
+        // Split at the median of the longest axis
+        AxisAlignedBox centres;
+        for (auto it = first; it != last; ++it)
+            centres.merge((*it)->getCentre());
+        Vector3 size = centres.getSize();
+        size_t axis = size.x >= size.y && size.x >= size.z ? 0 : (size.y >= size.z ? 1 : 2);
+
+        auto middle = first + count / 2;
+        std::nth_element(first, middle, last,
+                         [axis](Region* a, Region* b) { return a->getCentre()[axis] < b->getCentre()[axis]; });
+
+        for (auto [childFirst, childLast] : {std::pair{first, middle}, std::pair{middle, last}})
+        {
+            SceneNode* child = node->createChildSceneNode();
+            mRegionTreeNodes.push_back(child);
+            buildRegionTree(child, childFirst, childLast);
+        }
+    }
+    //--------------------------------------------------------------------------
+    void StaticGeometry::takeDirtyFarFields(std::vector<Region*>& regions)
+    {
+        for (auto farField : mDirtyFarFields)
+        {
+            if (farField->isBuilt())
+                farField->unload();
+            regions.push_back(farField);
+        }
+        mDirtyFarFields.clear();
+    }
+    //--------------------------------------------------------------------------
+    void StaticGeometry::rebuildDirtyRegions()
+    {
+        std::vector<Region*> regions;
+        for (auto index : mDirtyRegions)
+        {
+            Region* region = getRegion(index);
+            if (!region)
+                continue;
+
+            if (region->isBuilt())
+            {
+                region->unload();
+                regions.push_back(region);
+            }
+            else if (!isRegionStreamingEnabled())
+            {
+                // new region
+                regions.push_back(region);
+            }
+        }
+        mDirtyRegions.clear();
+        takeDirtyFarFields(regions);
+
+        buildRegions(regions);
+    }
+    //--------------------------------------------------------------------------
+    void StaticGeometry::setRegionStreamingDistances(Real loadDistance, Real unloadDistance)
+    {
+        OgreAssert(loadDistance <= unloadDistance, "unloadDistance must not be smaller than loadDistance");
+        mStreamingLoadDistance = loadDistance;
+        mStreamingUnloadDistance = unloadDistance;
+    }
+    //--------------------------------------------------------------------------
+    void StaticGeometry::updateStreaming(const Vector3& position)
+    {
+        if (!mBuilt || !isRegionStreamingEnabled())
+            return;
+
+        const Real loadDistanceSq = mStreamingLoadDistance * mStreamingLoadDistance;
+        const Real unloadDistanceSq = mStreamingUnloadDistance * mStreamingUnloadDistance;
+
+        std::vector<Region*> regions;
+        for (auto const& [index, region] : mRegionMap)
+        {
+            // Bounds are relative to the region centre
+            const AxisAlignedBox& localBounds = region->getBoundingBox();
+            AxisAlignedBox bounds{AxisAlignedBox::Extent::Finite, localBounds.getMinimum() + region->getCentre(),
+                                  localBounds.getMaximum() + region->getCentre()};
+            Real distanceSq = bounds.squaredDistance(position);
+
+            if (region->isBuilt())
+            {
+                if (distanceSq > unloadDistanceSq)
+                {
+                    region->unload();
+                }
+                else if (mDirtyRegions.contains(index))
+                {
+                    region->unload();
+                    regions.push_back(region);
+                }
+            }
+            else if (distanceSq <= loadDistanceSq)
+            {
+                regions.push_back(region);
+            }
         }
+        takeDirtyFarFields(regions);
 
+        buildRegions(regions);
     }
     //--------------------------------------------------------------------------
     void StaticGeometry::destroy()
     {
+        mBuilt = false;
+        mDirtyRegions.clear();
+        mDirtyFarFields.clear();
+
         // delete the regions
         for (auto & i : mRegionMap)
         {
@@ -572,6 +811,18 @@ namespace Ogre {
             delete i.second;
         }
         mRegionMap.clear();
+        for (auto farField : mFarFieldRegions)
+        {
+            mOwner->extractMovableObject(farField);
+            delete farField;
+        }
+        mFarFieldRegions.clear();
+        // children before their parents
+        for (auto node = mRegionTreeNodes.rbegin(); node != mRegionTreeNodes.rend(); ++node)
+        {
+            mOwner->destroySceneNode(*node);
+        }
+        mRegionTreeNodes.clear();
     }
     //--------------------------------------------------------------------------
     void StaticGeometry::reset()
@@ -605,6 +856,10 @@ namespace Ogre {
         {
             ri.second->setVisible(visible);
         }
+        for (auto farField : mFarFieldRegions)
+        {
+            farField->setVisible(visible);
+        }
     }
     //--------------------------------------------------------------------------
     void StaticGeometry::setCastShadows(bool castShadows)
@@ -615,6 +870,10 @@ namespace Ogre {
         {
             ri.second->setCastShadows(castShadows);
         }
+        for (auto farField : mFarFieldRegions)
+        {
+            farField->setCastShadows(castShadows);
+        }
 
     }
     //--------------------------------------------------------------------------
@@ -628,6 +887,10 @@ namespace Ogre {
         {
             ri.second->setRenderQueueGroup(queueID);
         }
+        for (auto farField : mFarFieldRegions)
+        {
+            farField->setRenderQueueGroup(queueID);
+        }
     }
     //--------------------------------------------------------------------------
     auto StaticGeometry::getRenderQueueGroup() const noexcept -> RenderQueueGroupID
@@ -642,6 +905,10 @@ namespace Ogre {
         {
             ri.second->setVisibilityFlags(flags);
         }
+        for (auto farField : mFarFieldRegions)
+        {
+            farField->setVisibilityFlags(flags);
+        }
     }
     //--------------------------------------------------------------------------
     auto StaticGeometry::getVisibilityFlags() const noexcept -> QueryTypeMask
@@ -660,6 +927,7 @@ namespace Ogre {
         of << "-------------------------------------------------" << std::endl;
         of << "Number of queued submeshes: " << mQueuedSubMeshes.size() << std::endl;
         of << "Number of regions: " << mRegionMap.size() << std::endl;
+        of << "Number of far-field regions: " << mFarFieldRegions.size() << std::endl;
         of << "Region dimensions: " << mRegionDimensions << std::endl;
         of << "Origin: " << mOrigin << std::endl;
         of << "Max distance: " << mUpperDistance << std::endl;
@@ -679,6 +947,10 @@ namespace Ogre {
         {
             ri.second->visitRenderables(visitor, debugRenderables);
         }
+        for (auto farField : mFarFieldRegions)
+        {
+            farField->visitRenderables(visitor, debugRenderables);
+        }
 
     }
 
@@ -745,6 +1017,9 @@ namespace Ogre {
         // update LOD values
         ushort lodLevels = qmesh->submesh->parent->getNumLodLevels();
         assert(qmesh->geometryLodList->size() == lodLevels);
+        // far-field regions only ever show the lowest LOD
+        if (mIsFarField)
+            lodLevels = 1;
 
         while(mLodValues.size() < lodLevels)
         {
@@ -770,10 +1045,11 @@ namespace Ogre {
 
     }
     //--------------------------------------------------------------------------
-    void StaticGeometry::Region::build(bool stencilShadows)
+    void StaticGeometry::Region::prepare()
     {
         // Create a node
-        mManager->getRootSceneNode()->createChildSceneNode(mCentre)->attachObject(this);
+        SceneNode* parentNode = mTreeNode ? mTreeNode : mManager->getRootSceneNode();
+        parentNode->createChildSceneNode(mCentre)->attachObject(this);
         // We need to create enough LOD buckets to deal with the highest LOD
         // we encountered in all the meshes queued
         for (ushort lod = 0; lod < mLodValues.size(); ++lod)
@@ -784,14 +1060,52 @@ namespace Ogre {
             // LOD bucket will pick the right LOD to use
             for (auto & mQueuedSubMeshe : mQueuedSubMeshes)
             {
-                lodBucket->assign(mQueuedSubMeshe, lod);
+                lodBucket->assign(mQueuedSubMeshe,
+                    mIsFarField ? static_cast<ushort>(mQueuedSubMeshe->geometryLodList->size() - 1) : lod);
             }
-            // now build
+        }
+    }
+    //--------------------------------------------------------------------------
+    void StaticGeometry::Region::finishBuild(bool stencilShadows)
+    {
+        for (auto const& lodBucket : mLodBucketList)
+        {
             lodBucket->build(stencilShadows);
         }
-
-
-
+    }
+    //--------------------------------------------------------------------------
+    void StaticGeometry::Region::build(bool stencilShadows)
+    {
+        prepare();
+        finishBuild(stencilShadows);
+    }
+    //--------------------------------------------------------------------------
+    void StaticGeometry::Region::_setFarField(Region* farField)
+    {
+        mFarField = farField;
+        for (auto qmesh : mQueuedSubMeshes)
+        {
+            farField->assign(qmesh);
+        }
+    }
+    //--------------------------------------------------------------------------
+    auto StaticGeometry::Region::isFarFieldActive(const Camera* cam) const -> bool
+    {
+        AxisAlignedBox bounds{AxisAlignedBox::Extent::Finite, mAABB.getMinimum() + mCentre,
+                              mAABB.getMaximum() + mCentre};
+        return bounds.squaredDistance(cam->getLodCamera()->getDerivedPosition()) >
+               mParent->mSquaredFarFieldDistance;
+    }
+    //--------------------------------------------------------------------------
+    void StaticGeometry::Region::unload()
+    {
+        mLodBucketList.clear();
+        mCurrentLod = 0;
+        if (mParentNode)
+        {
+            mManager->destroySceneNode(static_cast<SceneNode*>(mParentNode));
+            mParentNode = nullptr;
+        }
     }
     //--------------------------------------------------------------------------
     auto StaticGeometry::Region::getMovableType() const noexcept -> std::string_view
@@ -808,6 +1122,12 @@ namespace Ogre {
         // Cache squared view depth for use by GeometryBucket
         mSquaredViewDepth = mParentNode->getSquaredViewDepth(cam->getLodCamera());
 
+        // Either the far-field region or the regions it replaces are shown
+        if (mIsFarField)
+            mFarFieldHidden = !isFarFieldActive(cam);
+        else
+            mFarFieldHidden = mFarField && mFarField->isFarFieldActive(cam);
+
         // No LOD strategy set yet, skip (this indicates that there are no submeshes)
         if (mLodStrategy == nullptr)
             return;
@@ -853,7 +1173,7 @@ namespace Ogre {
     //--------------------------------------------------------------------------
     auto StaticGeometry::Region::isVisible() const noexcept -> bool
     {
-        if(!mVisible || mBeyondFarDistance)
+        if(!mVisible || mBeyondFarDistance || mFarFieldHidden)
             return false;
 
         SceneManager* sm = Root::getSingleton()._getCurrentSceneManager();
@@ -882,11 +1202,8 @@ namespace Ogre {
         EdgeData* edgeList = mLodBucketList[mCurrentLod]->getEdgeList();
         ShadowRenderableList& shadowRendList = mLodBucketList[mCurrentLod]->getShadowRenderableList();
 
-        // Calc triangle light facing
-        updateEdgeListLightFacing(edgeList, lightPos);
-
-        // Generate indexes and update renderables
-        generateShadowVolume(edgeList, indexBuffer, indexBufferUsedSize, light, shadowRendList, flags);
+        // Calc triangle light facing and generate indexes, unless cached, and update renderables
+        updateShadowVolume(edgeList, lightPos, indexBuffer, indexBufferUsedSize, light, shadowRendList, flags, false);
 
         return shadowRendList;
 
@@ -1336,44 +1653,47 @@ namespace Ogre {
             }
         }
     }
-    void StaticGeometry::GeometryBucket::build(bool stencilShadows)
+    void StaticGeometry::GeometryBucket::lockSources(SourceLockMap& sourceLocks) const
     {
-        // Need to double the vertex count for the position buffer
-        // if we're doing stencil shadows
-        OgreAssert(!stencilShadows || mVertexData->vertexCount * 2 <= mMaxVertexIndex,
-                   "Index range exceeded when using stencil shadows, consider reducing your region size or "
-                   "reducing poly count");
+        auto lockSource = [&](HardwareBuffer* buffer)
+        {
+            if (!sourceLocks.contains(buffer))
+                sourceLocks[buffer] = static_cast<const uchar*>(buffer->lock(HardwareBuffer::LockOptions::READ_ONLY));
+        };
 
+        for (auto geom : mQueuedGeometry)
+        {
+            lockSource(geom->geometry->indexData->indexBuffer.get());
+            VertexBufferBinding* srcBinds = geom->geometry->vertexData->vertexBufferBinding;
+            for (ushort b = 0; b < mVertexData->vertexBufferBinding->getBufferCount(); ++b)
+            {
+                lockSource(srcBinds->getBuffer(b).get());
+            }
+        }
+    }
+    //--------------------------------------------------------------------------
+    void StaticGeometry::GeometryBucket::merge(const SourceLockMap& sourceLocks)
+    {
         // Ok, here's where we transfer the vertices and indexes to the shared
-        // buffers
+        // buffers, in system memory for now
         // Shortcuts
         VertexDeclaration* dcl = mVertexData->vertexDeclaration;
         VertexBufferBinding* binds = mVertexData->vertexBufferBinding;
 
-        // create index buffer, and lock
         auto indexType = mIndexData->indexBuffer->getType();
-        mIndexData->indexBuffer = HardwareBufferManager::getSingleton()
-            .createIndexBuffer(indexType, mIndexData->indexCount,
-                HardwareBuffer::STATIC_WRITE_ONLY);
-        HardwareBufferLockGuard dstIndexLock(mIndexData->indexBuffer, HardwareBuffer::LockOptions::DISCARD);
-        auto* p32Dest = static_cast<uint32*>(dstIndexLock.pData);
-        auto* p16Dest = static_cast<uint16*>(dstIndexLock.pData);
-        // create all vertex buffers, and lock
+        size_t indexSize = indexType == HardwareIndexBuffer::IndexType::_32BIT ? sizeof(uint32) : sizeof(uint16);
+        mStagingIndexes.resize(indexSize * mIndexData->indexCount);
+        auto* p32Dest = reinterpret_cast<uint32*>(mStagingIndexes.data());
+        auto* p16Dest = reinterpret_cast<uint16*>(mStagingIndexes.data());
         ushort b;
 
         std::vector<uchar*> destBufferLocks;
         std::vector<VertexDeclaration::VertexElementList> bufferElements;
+        mStagingVertices.resize(binds->getBufferCount());
         for (b = 0; b < binds->getBufferCount(); ++b)
         {
-            HardwareVertexBufferSharedPtr vbuf =
-                HardwareBufferManager::getSingleton().createVertexBuffer(
-                    dcl->getVertexSize(b),
-                    mVertexData->vertexCount,
-                    HardwareBuffer::STATIC_WRITE_ONLY);
-            binds->setBinding(b, vbuf);
-            auto* pLock = static_cast<uchar*>(
-                vbuf->lock(HardwareBuffer::LockOptions::DISCARD));
-            destBufferLocks.push_back(pLock);
+            mStagingVertices[b].resize(dcl->getVertexSize(b) * mVertexData->vertexCount);
+            destBufferLocks.push_back(mStagingVertices[b].data());
             // Pre-cache vertex elements per buffer
             bufferElements.push_back(dcl->findElementsBySource(b));
         }
@@ -1386,24 +1706,20 @@ namespace Ogre {
         {
             // Copy indexes across with offset
             IndexData* srcIdxData = geom->geometry->indexData;
-            HardwareBufferLockGuard srcIdxLock(srcIdxData->indexBuffer,
-                                               srcIdxData->indexStart * srcIdxData->indexBuffer->getIndexSize(), 
-                                               srcIdxData->indexCount * srcIdxData->indexBuffer->getIndexSize(),
-                                               HardwareBuffer::LockOptions::READ_ONLY);
+            const uchar* pSrcIdx = sourceLocks.at(srcIdxData->indexBuffer.get()) +
+                                   srcIdxData->indexStart * srcIdxData->indexBuffer->getIndexSize();
             if (indexType == HardwareIndexBuffer::IndexType::_32BIT)
             {
-                auto* pSrc = static_cast<uint32*>(srcIdxLock.pData);
+                auto* pSrc = reinterpret_cast<const uint32*>(pSrcIdx);
                 copyIndexes(pSrc, p32Dest, srcIdxData->indexCount, indexOffset);
                 p32Dest += srcIdxData->indexCount;
             }
             else
             {
-                // Lock source indexes
-                auto* pSrc = static_cast<uint16*>(srcIdxLock.pData);
+                auto* pSrc = reinterpret_cast<const uint16*>(pSrcIdx);
                 copyIndexes(pSrc, p16Dest, srcIdxData->indexCount, indexOffset);
                 p16Dest += srcIdxData->indexCount;
             }
-            srcIdxLock.unlock();
 
             // Now deal with vertex buffers
             // we can rely on buffer counts / formats being the same
@@ -1411,10 +1727,8 @@ namespace Ogre {
             VertexBufferBinding* srcBinds = srcVData->vertexBufferBinding;
             for (b = 0; b < binds->getBufferCount(); ++b)
             {
-                // lock source
-                HardwareVertexBufferSharedPtr srcBuf = srcBinds->getBuffer(b);
-                HardwareBufferLockGuard srcBufLock(srcBuf, HardwareBuffer::LockOptions::READ_ONLY);
-                auto* pSrcBase = static_cast<uchar*>(srcBufLock.pData);
+                HardwareVertexBuffer* srcBuf = srcBinds->getBuffer(b).get();
+                auto* pSrcBase = const_cast<uchar*>(sourceLocks.at(srcBuf));
                 // Get buffer lock pointer, we'll update this later
                 uchar* pDstBase = destBufferLocks[b];
                 size_t bufInc = srcBuf->getVertexSize();
@@ -1487,19 +1801,61 @@ namespace Ogre {
             indexOffset += geom->geometry->vertexData->vertexCount;
         }
 
-        // Unlock everything
-        dstIndexLock.unlock();
-        for (b = 0; b < binds->getBufferCount(); ++b)
+        mMerged = true;
+    }
+    //--------------------------------------------------------------------------
+    void StaticGeometry::GeometryBucket::upload(bool stencilShadows)
+    {
+        // Need to double the vertex count for the position buffer
+        // if we're doing stencil shadows
+        OgreAssert(!stencilShadows || mVertexData->vertexCount * 2 <= mMaxVertexIndex,
+                   "Index range exceeded when using stencil shadows, consider reducing your region size or "
+                   "reducing poly count");
+        OgreAssert(mMerged, "merge() must be called first");
+
+        VertexDeclaration* dcl = mVertexData->vertexDeclaration;
+        VertexBufferBinding* binds = mVertexData->vertexBufferBinding;
+
+        // create index buffer, and fill it
+        mIndexData->indexBuffer = HardwareBufferManager::getSingleton()
+            .createIndexBuffer(mIndexData->indexBuffer->getType(), mIndexData->indexCount,
+                HardwareBuffer::STATIC_WRITE_ONLY);
+        mIndexData->indexBuffer->writeData(0, mStagingIndexes.size(), mStagingIndexes.data(), true);
+        // create all vertex buffers, and fill them
+        for (ushort b = 0; b < binds->getBufferCount(); ++b)
         {
-            binds->getBuffer(b)->unlock();
+            HardwareVertexBufferSharedPtr vbuf =
+                HardwareBufferManager::getSingleton().createVertexBuffer(
+                    dcl->getVertexSize(b),
+                    mVertexData->vertexCount,
+                    HardwareBuffer::STATIC_WRITE_ONLY);
+            binds->setBinding(b, vbuf);
+            vbuf->writeData(0, mStagingVertices[b].size(), mStagingVertices[b].data(), true);
         }
 
+        // Staging memory is not needed anymore
+        mStagingIndexes = {};
+        mStagingVertices = {};
+        mMerged = false;
+
         if (stencilShadows)
         {
             mVertexData->prepareForShadowVolume();
         }
     }
     //--------------------------------------------------------------------------
+    void StaticGeometry::GeometryBucket::build(bool stencilShadows)
+    {
+        if (!mMerged)
+        {
+            SourceLockMap sourceLocks;
+            lockSources(sourceLocks);
+            merge(sourceLocks);
+            unlockSources(sourceLocks);
+        }
+        upload(stencilShadows);
+    }
+    //--------------------------------------------------------------------------
     void StaticGeometry::GeometryBucket::dump(std::ofstream& of) const
     {
         of << "Geometry Bucket" << std::endl;
@@ -492,4 +492,24 @@ namespace Ogre {
         }
         return result;
     }
+    //-----------------------------------------------------------------------
+    auto StringUtil::escapeJson(std::string_view text) -> String
+    {
+        String escaped;
+        escaped.reserve(text.size());
+        for (char c : text)
+        {
+            if (c == '"' || c == '\')
+                escaped += '\';
+            if (static_cast<unsigned char>(c) < 0x20)
+            {
+                char code[7];
+                std::snprintf(code, sizeof(code), "\\u%04x", static_cast<unsigned char>(c));
+                escaped += code;
+            }
+            else
+                escaped += c;
+        }
+        return escaped;
+    }
 }
@@ -42,7 +42,9 @@ import :Math;
 import :Matrix4;
 import :Mesh;
 import :Node;
+import :Pose;
 import :RenderOperation;
+import :SkinnedVertexCache;
 import :SubEntity;
 import :SubMesh;
 import :Vector;
@@ -67,6 +69,7 @@ namespace Ogre {
         mSkelAnimVertexData = nullptr;
         mVertexAnimationAppliedThisFrame = false;
         mHardwarePoseCount = 0;
+        mHardwarePoseTexture = false;
         mIndexStart = 0;
         mIndexEnd = 0;
         setMaterial(MaterialManager::getSingleton().getDefaultMaterial());
@@ -191,7 +194,8 @@ namespace Ogre {
             case SOFTWARE_MORPH:
                 return mSoftwareVertexAnimVertexData.get();
             case SOFTWARE_SKELETAL:
-                return mSkelAnimVertexData.get();
+                return mParentEntity->isSkinningCacheActive() && mSkinnedVertexCache ?
+                    mSkinnedVertexCache->getVertexData() : mSkelAnimVertexData.get();
             };
             // keep compiler happy
             return mSubMesh->vertexData.get();
@@ -199,6 +203,11 @@ namespace Ogre {
         }
     }
     //-----------------------------------------------------------------------
+    auto SubEntity::getWorldTransformNode() const noexcept -> const Node*
+    {
+        return mParentEntity->getParentNode();
+    }
+    //-----------------------------------------------------------------------
     void SubEntity::getWorldTransforms(Matrix4* xform) const
     {
         if (!mParentEntity->mNumBoneMatrices ||
@@ -305,6 +314,7 @@ namespace Ogre {
         mSkelAnimVertexData.reset();
         mSoftwareVertexAnimVertexData.reset();
         mHardwareVertexAnimVertexData.reset();
+        mSkinnedVertexCache.reset();
 
         if (!mSubMesh->useSharedVertices)
         {
@@ -392,6 +402,28 @@ namespace Ogre {
             // set the parametric morph value
             params->_writeRawConstant(constantEntry.physicalIndex, val);
         }
+        else if (constantEntry.paramType == GpuProgramParameters::AutoConstantType::ANIMATION_POSE_WEIGHTS)
+        {
+            // The rows of the pose texture are the poses of our geometry in mesh order
+            const MeshPtr& mesh = mParentEntity->getMesh();
+            const auto& vd = mSubMesh->useSharedVertices ? mParentEntity->mHardwareVertexAnimVertexData : mHardwareVertexAnimVertexData;
+            ushort target = 0;
+            if (!mSubMesh->useSharedVertices)
+                target = ushort(std::ranges::find(mesh->getSubMeshes(), mSubMesh) - mesh->getSubMeshes().begin() + 1);
+
+            size_t rowCount = size_t(constantEntry.data) * 4;
+            size_t row = 0;
+            const PoseList& poses = mesh->getPoseList();
+            for (size_t i = 0; i < poses.size() && row < rowCount; ++i)
+            {
+                if (poses[i]->getTarget() != target)
+                    continue;
+                float weight = vd && i < vd->hwPoseWeights.size() ? vd->hwPoseWeights[i] : 0.0f;
+                params->_writeRawConstants(constantEntry.physicalIndex + row++, &weight, 1);
+            }
+            for (float weight = 0.0f; row < rowCount; ++row)
+                params->_writeRawConstants(constantEntry.physicalIndex + row, &weight, 1);
+        }
         else
         {
             // default
@@ -32,6 +32,7 @@ import :MovableObject;
 import :Node;
 import :Prerequisites;
 import :Quaternion;
+import :SceneManager;
 import :TagPoint;
 import :Vector;
 
@@ -48,6 +49,12 @@ namespace Ogre {
         return mParentEntity;
     }
     //-----------------------------------------------------------------------------
+    auto TagPoint::getQueuedUpdates() -> QueuedUpdates*
+    {
+        SceneManager* sceneMgr = mParentEntity ? mParentEntity->_getManager() : nullptr;
+        return sceneMgr ? sceneMgr->_getQueuedNodeUpdates() : Bone::getQueuedUpdates();
+    }
+    //-----------------------------------------------------------------------------
     auto TagPoint::getChildObject() const noexcept -> MovableObject*
     {
         return mChildObject;
@@ -148,10 +155,13 @@ namespace Ogre {
                 }
 
                 // Change position vector based on parent entity's orientation & scale
-                mDerivedPosition = parentOrientation * (parentScale * mDerivedPosition);
+                Vector3 offset = parentOrientation * (parentScale * mDerivedPosition);
 
-                // Add altered position vector to parent entity
-                mDerivedPosition += entityParentNode->_getDerivedPosition();
+                // Add altered position vector to parent entity, in double precision as Node does
+                mDerivedPositionDouble = entityParentNode->_getDerivedPositionDouble() +
+                    Vector3d{offset.x, offset.y, offset.z};
+                mDerivedPosition = {Real(mDerivedPositionDouble[0]), Real(mDerivedPositionDouble[1]),
+                                    Real(mDerivedPositionDouble[2])};
             }
         }
 
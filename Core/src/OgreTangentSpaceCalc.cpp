@@ -39,10 +39,12 @@ import :Log;
 import :LogManager;
 import :Math;
 import :Platform;
+import :Root;
 import :SharedPtr;
 import :TangentSpaceCalc;
 import :VertexIndexData;
 
+import <algorithm>;
 import <map>;
 import <memory>;
 
@@ -268,6 +270,7 @@ namespace Ogre
             // loop through all faces to calculate the tangents and normals
             size_t faceCount = opType == RenderOperation::OperationType::TRIANGLE_LIST ? 
                 i_in->indexCount / 3 : i_in->indexCount - 2;
+            mFaces.resize(faceCount);
             for (size_t f = 0; f < faceCount; ++f)
             {
                 bool invertOrdering = false;
@@ -302,31 +305,52 @@ namespace Ogre
                 }
 
                 // deal with strip inversion of winding
-                size_t localVertInd[3];
-                localVertInd[0] = vertInd[0];
+                FaceInfo& face = mFaces[f];
+                face.vertInd[0] = vertInd[0];
                 if (invertOrdering)
                 {
-                    localVertInd[1] = vertInd[2];
-                    localVertInd[2] = vertInd[1];
+                    face.vertInd[1] = vertInd[2];
+                    face.vertInd[2] = vertInd[1];
                 }
                 else
                 {
-                    localVertInd[1] = vertInd[1];
-                    localVertInd[2] = vertInd[2];
+                    face.vertInd[1] = vertInd[1];
+                    face.vertInd[2] = vertInd[2];
                 }
+            }
 
+            // For each triangle
+            //   Calculate tangent & binormal per triangle
+            //   Note these are not normalised, are weighted by UV area
+            // The faces are independent, so this runs in blocks on the WorkQueue
+            static const size_t constexpr BLOCK_SIZE = 4096;
+            size_t numBlocks = (faceCount + BLOCK_SIZE - 1) / BLOCK_SIZE;
+            auto calculateBlock = [this, faceCount](size_t block)
+            {
+                size_t end = std::min(faceCount, (block + 1) * BLOCK_SIZE);
+                for (size_t f = block * BLOCK_SIZE; f < end; ++f)
+                {
+                    FaceInfo& face = mFaces[f];
+                    calculateFaceTangentSpace(face.vertInd, face.tsU, face.tsV, face.norm);
+                }
+            };
+            Root* root = Root::getSingletonPtr();
+            if (numBlocks > 1 && root && root->getWorkQueue())
+                root->getWorkQueue()->parallelFor(numBlocks, calculateBlock);
+            else
+                for (size_t block = 0; block < numBlocks; ++block)
+                    calculateBlock(block);
 
-                // For each triangle
-                //   Calculate tangent & binormal per triangle
-                //   Note these are not normalised, are weighted by UV area
-                Vector3 faceTsU, faceTsV, faceNorm;
-                calculateFaceTangentSpace(localVertInd, faceTsU, faceTsV, faceNorm);
+            // Accumulating into the vertices may split them, so it stays in face order
+            for (size_t f = 0; f < faceCount; ++f)
+            {
+                FaceInfo& face = mFaces[f];
 
                 // Skip invalid UV space triangles
-                if (faceTsU.isZeroLength() || faceTsV.isZeroLength())
+                if (face.tsU.isZeroLength() || face.tsV.isZeroLength())
                     continue;
 
-                addFaceTangentSpaceToVertices(i, f, localVertInd, faceTsU, faceTsV, faceNorm, result);
+                addFaceTangentSpaceToVertices(i, f, face.vertInd, face.tsU, face.tsV, face.norm, result);
 
             }
         }
@@ -470,7 +494,7 @@ namespace Ogre
     }
     //---------------------------------------------------------------------
     void TangentSpaceCalc::calculateFaceTangentSpace(const size_t* vertInd, 
-        Vector3& tsU, Vector3& tsV, Vector3& tsN)
+        Vector3& tsU, Vector3& tsV, Vector3& tsN) const
     {
         const VertexInfo& v0 = mVertexArray[vertInd[0]];
         const VertexInfo& v1 = mVertexArray[vertInd[1]];
@@ -0,0 +1,475 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+module;
+
+#include <cstddef>
+
+module Ogre.Core;
+
+import :Exception;
+import :TaskScheduler;
+
+import <algorithm>;
+import <atomic>;
+import <exception>;
+import <functional>;
+import <memory>;
+import <mutex>;
+import <thread>;
+import <utility>;
+import <vector>;
+
+namespace Ogre {
+    namespace {
+        /// The scheduler and queue index of the current worker thread
+        thread_local const void* tlsScheduler = nullptr;
+        thread_local size_t tlsQueueIndex = 0;
+
+        /// Worker rounds without any work before going to sleep
+        constexpr int SPIN_COUNT = 64;
+    }
+    //---------------------------------------------------------------------
+    auto TaskGraph::addTask(std::function<void()> func) -> TaskID
+    {
+        mTasks.emplace_back(std::move(func));
+        return mTasks.size() - 1;
+    }
+    //---------------------------------------------------------------------
+    void TaskGraph::addDependency(TaskID task, TaskID dependsOn)
+    {
+        OgreAssert(task < mTasks.size() && dependsOn < mTasks.size(), "invalid TaskID");
+        OgreAssert(task != dependsOn, "a task can not depend on itself");
+
+        mTasks[dependsOn].successors.push_back(task);
+        ++mTasks[task].numDependencies;
+    }
+    //---------------------------------------------------------------------
+    auto TaskGraph::getExecutionOrder() const -> std::vector<TaskID>
+    {
+        std::vector<uint32> pending;
+        std::vector<TaskID> order;
+        pending.reserve(mTasks.size());
+        order.reserve(mTasks.size());
+
+        for (TaskID i = 0; i < mTasks.size(); ++i)
+        {
+            pending.push_back(mTasks[i].numDependencies);
+            if (!pending.back())
+                order.push_back(i);
+        }
+
+        for (size_t i = 0; i < order.size(); ++i)
+        {
+            for (auto succ : mTasks[order[i]].successors)
+            {
+                if (--pending[succ] == 0)
+                    order.push_back(succ);
+            }
+        }
+
+        if (order.size() != mTasks.size())
+            OGRE_EXCEPT(ExceptionCodes::INVALIDPARAMS, "TaskGraph contains a dependency cycle");
+
+        return order;
+    }
+    //---------------------------------------------------------------------
+    //---------------------------------------------------------------------
+    TaskScheduler::JobQueue::JobQueue()
+        : mJobs(new std::atomic<Job*>[QUEUE_CAPACITY])
+    {
+    }
+    //---------------------------------------------------------------------
+    auto TaskScheduler::JobQueue::push(Job* job) -> bool
+    {
+        int64 b = mBottom.load(std::memory_order_relaxed);
+        int64 t = mTop.load(std::memory_order_acquire);
+        if (b - t >= int64(QUEUE_CAPACITY))
+            return false;
+
+        mJobs[b & (QUEUE_CAPACITY - 1)].store(job, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        mBottom.store(b + 1, std::memory_order_relaxed);
+        return true;
+    }
+    //---------------------------------------------------------------------
+    auto TaskScheduler::JobQueue::pop() -> Job*
+    {
+        int64 b = mBottom.load(std::memory_order_relaxed) - 1;
+        mBottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64 t = mTop.load(std::memory_order_relaxed);
+
+        if (t > b)
+        {
+            // empty
+            mBottom.store(b + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        Job* job = mJobs[b & (QUEUE_CAPACITY - 1)].load(std::memory_order_relaxed);
+        if (t == b)
+        {
+            // last one, race the thieves for it
+            if (!mTop.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                job = nullptr;
+            mBottom.store(b + 1, std::memory_order_relaxed);
+        }
+        return job;
+    }
+    //---------------------------------------------------------------------
+    auto TaskScheduler::JobQueue::steal() -> Job*
+    {
+        int64 t = mTop.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64 b = mBottom.load(std::memory_order_acquire);
+        if (t >= b)
+            return nullptr;
+
+        Job* job = mJobs[t & (QUEUE_CAPACITY - 1)].load(std::memory_order_relaxed);
+        if (!mTop.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            return nullptr;
+        return job;
+    }
+    //---------------------------------------------------------------------
+    auto TaskScheduler::JobQueue::empty() const -> bool
+    {
+        return mTop.load(std::memory_order_acquire) >= mBottom.load(std::memory_order_acquire);
+    }
+    //---------------------------------------------------------------------
+    //---------------------------------------------------------------------
+    TaskScheduler::TaskScheduler(size_t numWorkers, ThreadCallback threadStarted, ThreadCallback threadStopped)
+        : mOwnerThread(std::this_thread::get_id())
+    {
+        static_assert((QUEUE_CAPACITY & (QUEUE_CAPACITY - 1)) == 0, "QUEUE_CAPACITY must be a power of two");
+
+        for (size_t i = 0; i <= numWorkers; ++i)
+            mQueues.push_back(std::make_unique<JobQueue>());
+
+        mWorkers.reserve(numWorkers);
+        for (size_t i = 0; i < numWorkers; ++i)
+            mWorkers.emplace_back(&TaskScheduler::workerMain, this, i, threadStarted, threadStopped);
+    }
+    //---------------------------------------------------------------------
+    TaskScheduler::~TaskScheduler()
+    {
+        {
+            std::unique_lock<std::mutex> sleepLock(mSleepMutex);
+            mShuttingDown = true;
+            mSleepCondition.notify_all();
+        }
+
+        for (auto& worker : mWorkers)
+            worker.join();
+
+        // all queues are ours now
+        for (auto& queue : mQueues)
+        {
+            while (Job* job = queue->steal())
+                delete job;
+        }
+        for (auto job : mSharedQueue)
+            delete job;
+        for (auto job : mBackgroundQueue)
+            delete job;
+    }
+    //---------------------------------------------------------------------
+    void TaskScheduler::workerMain(size_t index, const ThreadCallback& threadStarted,
+                                   const ThreadCallback& threadStopped)
+    {
+        tlsScheduler = this;
+        tlsQueueIndex = index;
+
+        if (threadStarted)
+            threadStarted();
+
+        int idleRounds = 0;
+        while (!mShuttingDown.load(std::memory_order_relaxed))
+        {
+            Job* job = findJob();
+            if (!job)
+                job = findBackgroundJob();
+            if (job)
+            {
+                execute(job);
+                idleRounds = 0;
+                continue;
+            }
+
+            if (++idleRounds < SPIN_COUNT)
+            {
+                std::this_thread::yield();
+                continue;
+            }
+
+            std::unique_lock<std::mutex> sleepLock(mSleepMutex);
+            ++mNumSleeping;
+            // pairs with the fence in wakeWorkers, so either we see the new job or they see us
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (!hasJobs() && !mShuttingDown)
+                mSleepCondition.wait(sleepLock);
+            --mNumSleeping;
+            idleRounds = 0;
+        }
+
+        if (threadStopped)
+            threadStopped();
+
+        tlsScheduler = nullptr;
+    }
+    //---------------------------------------------------------------------
+    auto TaskScheduler::getLocalQueue() -> JobQueue*
+    {
+        if (tlsScheduler == this)
+            return mQueues[tlsQueueIndex].get();
+        if (std::this_thread::get_id() == mOwnerThread)
+            return mQueues.back().get();
+        return nullptr;
+    }
+    //---------------------------------------------------------------------
+    auto TaskScheduler::findJob() -> Job*
+    {
+        JobQueue* local = getLocalQueue();
+        if (local)
+        {
+            if (Job* job = local->pop())
+                return job;
+        }
+
+        if (mSharedQueueSize.load(std::memory_order_acquire))
+        {
+            std::unique_lock<std::mutex> sharedLock(mSharedQueueMutex);
+            if (!mSharedQueue.empty())
+            {
+                Job* job = mSharedQueue.front();
+                mSharedQueue.pop_front();
+                --mSharedQueueSize;
+                return job;
+            }
+        }
+
+        // steal, starting next to our own queue so thieves spread out
+        size_t start = tlsScheduler == this ? tlsQueueIndex + 1 : 0;
+        for (size_t i = 0; i < mQueues.size(); ++i)
+        {
+            JobQueue* victim = mQueues[(start + i) % mQueues.size()].get();
+            if (victim == local)
+                continue;
+            if (Job* job = victim->steal())
+                return job;
+        }
+        return nullptr;
+    }
+    //---------------------------------------------------------------------
+    auto TaskScheduler::findBackgroundJob() -> Job*
+    {
+        if (!mBackgroundQueueSize.load(std::memory_order_acquire))
+            return nullptr;
+
+        std::unique_lock<std::mutex> backgroundLock(mBackgroundQueueMutex);
+        if (mBackgroundQueue.empty())
+            return nullptr;
+
+        Job* job = mBackgroundQueue.front();
+        mBackgroundQueue.pop_front();
+        --mBackgroundQueueSize;
+        return job;
+    }
+    //---------------------------------------------------------------------
+    auto TaskScheduler::hasJobs() -> bool
+    {
+        if (mSharedQueueSize.load(std::memory_order_acquire) || mBackgroundQueueSize.load(std::memory_order_acquire))
+            return true;
+        return std::ranges::any_of(mQueues, [](const auto& queue) { return !queue->empty(); });
+    }
+    //---------------------------------------------------------------------
+    void TaskScheduler::execute(Job* job)
+    {
+        job->func();
+        if (job->pending)
+            job->pending->fetch_sub(1, std::memory_order_acq_rel);
+        delete job;
+    }
+    //---------------------------------------------------------------------
+    void TaskScheduler::wakeWorkers()
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (mNumSleeping.load(std::memory_order_relaxed))
+        {
+            std::unique_lock<std::mutex> sleepLock(mSleepMutex);
+            mSleepCondition.notify_one();
+        }
+    }
+    //---------------------------------------------------------------------
+    void TaskScheduler::schedule(std::function<void()> task, std::atomic<size_t>* pending)
+    {
+        auto job = new Job{std::move(task), pending};
+
+        if (JobQueue* local = getLocalQueue())
+        {
+            if (!local->push(job))
+            {
+                // too much work queued up already, do it now
+                execute(job);
+                return;
+            }
+        }
+        else
+        {
+            std::unique_lock<std::mutex> sharedLock(mSharedQueueMutex);
+            mSharedQueue.push_back(job);
+            ++mSharedQueueSize;
+        }
+
+        wakeWorkers();
+    }
+    //---------------------------------------------------------------------
+    void TaskScheduler::scheduleBackground(std::function<void()> task)
+    {
+        {
+            std::unique_lock<std::mutex> backgroundLock(mBackgroundQueueMutex);
+            mBackgroundQueue.push_back(new Job{std::move(task), nullptr});
+            ++mBackgroundQueueSize;
+        }
+
+        wakeWorkers();
+    }
+    //---------------------------------------------------------------------
+    auto TaskScheduler::_executeNextTask() -> bool
+    {
+        Job* job = findJob();
+        if (!job)
+            return false;
+
+        execute(job);
+        return true;
+    }
+    //---------------------------------------------------------------------
+    void TaskScheduler::wait(const std::atomic<size_t>& pending)
+    {
+        while (pending.load(std::memory_order_acquire))
+        {
+            if (!_executeNextTask())
+                std::this_thread::yield();
+        }
+    }
+    //---------------------------------------------------------------------
+    void TaskScheduler::run(TaskGraph& graph)
+    {
+        // validates the graph before anything is started
+        auto order = graph.getExecutionOrder();
+        if (order.empty())
+            return;
+
+        auto& tasks = graph.mTasks;
+        for (auto& task : tasks)
+            task.pending.store(task.numDependencies, std::memory_order_relaxed);
+
+        std::atomic<size_t> pending{tasks.size()};
+        std::exception_ptr error;
+        std::mutex errorMutex;
+
+        std::function<void(TaskGraph::TaskID)> start = [&](TaskGraph::TaskID id)
+        {
+            schedule([&, id]()
+            {
+                try
+                {
+                    tasks[id].func();
+                }
+                catch (...)
+                {
+                    std::unique_lock<std::mutex> errorLock(errorMutex);
+                    if (!error)
+                        error = std::current_exception();
+                }
+
+                // successors are started before this task counts as done
+                for (auto succ : tasks[id].successors)
+                {
+                    if (tasks[succ].pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                        start(succ);
+                }
+            }, &pending);
+        };
+
+        for (auto id : order)
+        {
+            if (tasks[id].numDependencies)
+                break;
+            start(id);
+        }
+
+        wait(pending);
+
+        if (error)
+            std::rethrow_exception(error);
+    }
+    //---------------------------------------------------------------------
+    void TaskScheduler::parallelFor(size_t count, const std::function<void(size_t)>& func, size_t grainSize)
+    {
+        if (!count)
+            return;
+
+        if (!grainSize)
+            grainSize = std::max<size_t>(1, count / (4 * mQueues.size()));
+
+        std::atomic<size_t> pending{0};
+        std::exception_ptr error;
+        std::mutex errorMutex;
+
+        std::function<void(size_t, size_t)> process = [&](size_t begin, size_t end)
+        {
+            // hand out the upper halves, keep splitting the lower one
+            while (end - begin > grainSize)
+            {
+                size_t mid = begin + (end - begin) / 2;
+                pending.fetch_add(1, std::memory_order_relaxed);
+                schedule([&process, mid, end]() { process(mid, end); }, &pending);
+                end = mid;
+            }
+
+            try
+            {
+                for (size_t i = begin; i < end; ++i)
+                    func(i);
+            }
+            catch (...)
+            {
+                std::unique_lock<std::mutex> errorLock(errorMutex);
+                if (!error)
+                    error = std::current_exception();
+            }
+        };
+
+        process(0, count);
+        wait(pending);
+
+        if (error)
+            std::rethrow_exception(error);
+    }
+}
@@ -395,6 +395,11 @@ namespace Ogre {
 
     //-----------------------------------------------------------------------------
     auto Technique::operator=(const Technique& rhs) -> Technique&
+    {
+        return _assign(rhs, false);
+    }
+    //-----------------------------------------------------------------------------
+    auto Technique::_assign(const Technique& rhs, bool shareParameters) -> Technique&
     {
         mName = rhs.mName;
         this->mIsSupported = rhs.mIsSupported;
@@ -411,7 +416,7 @@ namespace Ogre {
         removeAllPasses();
         for (auto mPasse : rhs.mPasses)
         {
-            Pass* p = new Pass(this, mPasse->getIndex(), *mPasse);
+            Pass* p = new Pass(this, mPasse->getIndex(), *mPasse, shareParameters);
             mPasses.push_back(p);
         }
         // Compile for categorised illumination on demand
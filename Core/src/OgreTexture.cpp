@@ -28,12 +28,17 @@ THE SOFTWARE.
 module;
 
 #include <cassert>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
 
 module Ogre.Core;
 
 import :Bitwise;
+import :BlockDecoder;
 import :Common;
 import :Exception;
+import :HardwareBuffer;
 import :HardwarePixelBuffer;
 import :Image;
 import :Log;
@@ -46,10 +51,17 @@ import :Root;
 import :String;
 import :Texture;
 import :TextureManager;
+import :Vector;
+import :WorkQueue;
 
 import <algorithm>;
 import <atomic>;
+import <filesystem>;
+import <fstream>;
 import <memory>;
+import <thread>;
+import <utility>;
+import <vector>;
 
 namespace Ogre {
     const char* Texture::CUBEMAP_SUFFIXES[] = {"_rt", "_lf", "_up", "_dn", "_fr", "_bk"};
@@ -74,6 +86,7 @@ namespace Ogre {
             TextureManager& tmgr = TextureManager::getSingleton();
             setNumMipmaps(tmgr.getDefaultNumMipmaps());
             setDesiredBitDepths(tmgr.getPreferredIntegerBitDepth(), tmgr.getPreferredFloatBitDepth());
+            setMipStreaming(tmgr.getMipStreaming());
         }
 
         
@@ -156,7 +169,16 @@ namespace Ogre {
     //--------------------------------------------------------------------------
     auto Texture::calculateSize() const -> size_t
     {
-        return getNumFaces() * PixelUtil::getMemorySize(mWidth, mHeight, mDepth, mFormat);
+        // the whole mip chain is resident in video memory, not just the top level
+        uint32 maxMips = Bitwise::mostSignificantBitSet(std::max({mWidth, mHeight, mDepth, 1u}));
+        auto mipmaps = static_cast<TextureMipmap>(std::min(std::to_underlying(mNumMipmaps), maxMips));
+        size_t size = Image::calculateSize(mipmaps, getNumFaces(), mWidth, mHeight, mDepth, mFormat);
+
+        // multisampled render targets keep a separate surface which is resolved into the texture
+        if (mFSAA > 1)
+            size += size_t(mFSAA) * getNumFaces() * PixelUtil::getMemorySize(mWidth, mHeight, mDepth, mFormat);
+
+        return size;
     }
     //--------------------------------------------------------------------------
     auto Texture::getNumFaces() const noexcept -> uint32
@@ -256,9 +278,101 @@ namespace Ogre {
                 << buf->getWidth() << "x" << buf->getHeight() << "x" << buf->getDepth() << ".";
         }
         
-        // Main loading loop
         // imageMips == 0 if the image has no custom mipmaps, otherwise contains the number of custom mips
-        for(uint32 mip = 0; mip <= std::to_underlying(std::min(mNumMipmaps, imageMips)); ++mip)
+        uint32 lastMip = std::to_underlying(std::min(mNumMipmaps, imageMips));
+
+        // streamed textures start with the small levels, there is no source to fetch the others from for manual ones
+        // and the GPU could not generate the missing levels from the ones not uploaded yet
+        mResidentMip = mStreamingStartMip = 0;
+        if (mMipStreaming && !mIsManual && mNumMipmaps > TextureMipmap{} && imageMips >= mNumMipmaps && mDepth == 1)
+        {
+            uint32 firstMip = 0;
+            while (firstMip < lastMip && std::max(mWidth >> firstMip, mHeight >> firstMip) > MIP_STREAMING_INITIAL_SIZE)
+                ++firstMip;
+            if (firstMip > 0 && setMostDetailedMipImpl(firstMip))
+            {
+                mResidentMip = mStreamingStartMip = mRequestedMip = firstMip;
+                TextureManager::getSingleton()._notifyMipStreaming(mHandle);
+            }
+        }
+
+        uploadMipLevels(images, mResidentMip, lastMip);
+
+        // Update size (the final size, not including temp space)
+        mSize = calculateSize();
+
+    }
+    //-----------------------------------------------------------------------------
+    namespace
+    {
+        /// Size of the bands of rows converted at once, small enough to stay in the cache
+        constexpr size_t UPLOAD_TILE_SIZE = 64 * 1024;
+
+        /** Converts src to the format of buffer and applies gamma, band by band right in its locked memory
+
+            Saves the full size temporary image and conversion pass the blitFromMemory path needs for this.
+            The bands are processed in parallel on the WorkQueue of Root, if there is one.
+        */
+        void uploadTiled(HardwarePixelBuffer* buffer, const PixelBox& src, const Box& dst, float gamma)
+        {
+            bool entireBuffer = dst.getOrigin() == Vector<3, uint32>{0, 0, 0} && dst.getSize() == buffer->getSize();
+            const PixelBox& staging =
+                buffer->lock(dst, entireBuffer ? HardwareBuffer::LockOptions::DISCARD : HardwareBuffer::LockOptions::WRITE_ONLY);
+
+            uint32 width = src.getWidth(), height = src.getHeight();
+            size_t rowSize = width * std::max(PixelUtil::getNumElemBytes(src.format), PixelUtil::getNumElemBytes(staging.format));
+            uint32 bandRows = uint32(std::clamp<size_t>(UPLOAD_TILE_SIZE / std::max<size_t>(rowSize, 1), 1, height));
+            uint32 numBands = (height + bandRows - 1) / bandRows;
+
+            auto convertBand = [&](size_t i)
+            {
+                uint32 z = uint32(i / numBands);
+                uint32 top = uint32(i % numBands) * bandRows;
+                uint32 bottom = std::min(top + bandRows, height);
+                PixelBox srcBand = src.getSubVolume(
+                    {src.left, src.top + top, src.right, src.top + bottom, src.front + z, src.front + z + 1});
+                PixelBox dstBand = staging.getSubVolume({staging.left, staging.top + top, staging.right,
+                                                         staging.top + bottom, staging.front + z, staging.front + z + 1});
+
+                if (gamma == 1.0f)
+                {
+                    PixelUtil::bulkPixelConversion(srcBand, dstBand);
+                    return;
+                }
+
+                // correct a packed copy in the source format, like the Image based path does
+                std::vector<uchar> tmp(PixelUtil::getMemorySize(width, bottom - top, 1, src.format));
+                PixelBox corrected(width, bottom - top, 1, src.format, tmp.data());
+                PixelUtil::bulkPixelConversion(srcBand, corrected);
+                Image::applyGamma(tmp.data(), gamma, tmp.size(), uchar(PixelUtil::getNumElemBits(src.format)));
+                PixelUtil::bulkPixelConversion(corrected, dstBand);
+            };
+
+            size_t numTiles = size_t(numBands) * src.getDepth();
+            Root* root = Root::getSingletonPtr();
+            if (root && root->getWorkQueue() && numTiles > 1)
+                root->getWorkQueue()->parallelFor(numTiles, convertBand);
+            else
+                for (size_t i = 0; i < numTiles; ++i)
+                    convertBand(i);
+
+            buffer->unlock();
+        }
+    }
+    //-----------------------------------------------------------------------------
+    void Texture::uploadMipLevels(const ConstImagePtrList& images, uint32 firstMip, uint32 lastMip)
+    {
+        // Check if we're loading one image with multiple faces
+        // or a vector of images representing the faces
+        bool multiImage = images.size() > 1; // Load from multiple images?
+        uint32 faces = multiImage ? uint32(images.size()) : images[0]->getNumFaces();
+
+        // Check whether number of faces in images exceeds number of faces
+        // in this texture. If so, clamp it.
+        if(faces > getNumFaces())
+            faces = getNumFaces();
+
+        for(uint32 mip = firstMip; mip <= lastMip; ++mip)
         {
             for(uint32 i = 0; i < std::max(faces, uint32(images.size())); ++i)
             {
@@ -285,7 +399,14 @@ namespace Ogre {
                     src = images[0]->getPixelBox(i, static_cast<TextureMipmap>(mip));
                 }
 
-                if(mGamma != 1.0f) {
+                bool convert = src.format != buffer->getFormat() || mGamma != 1.0f;
+                if (convert && src.getSize() == dst.getSize() && !PixelUtil::isCompressed(src.format) &&
+                    !PixelUtil::isCompressed(buffer->getFormat()))
+                {
+                    // no scaling, so convert straight into the staging memory of the buffer
+                    uploadTiled(buffer.get(), src, dst, mGamma);
+                }
+                else if(mGamma != 1.0f) {
                     // Apply gamma correction
                     // Do not overwrite original image but do gamma correction in temporary buffer
                     Image tmp(src.format, src.getWidth(), getHeight(), src.getDepth());
@@ -307,9 +428,6 @@ namespace Ogre {
                 
             }
         }
-        // Update size (the final size, not including temp space)
-        mSize = getNumFaces() * PixelUtil::getMemorySize(mWidth, mHeight, mDepth, mFormat);
-
     }
     //-----------------------------------------------------------------------------
     void Texture::createInternalResources()
@@ -424,14 +542,123 @@ namespace Ogre {
     {
     }
 
-    void Texture::readImage(LoadedImages& imgs, std::string_view name, std::string_view ext, bool haveNPOT)
+    namespace
+    {
+        /// Whether the RenderSystem can sample the block compressed format, true for the others
+        auto isCompressionSupported(PixelFormat fmt, const RenderSystemCapabilities* caps) -> bool
+        {
+            using enum PixelFormat;
+            switch (fmt)
+            {
+            case DXT1:
+            case DXT2:
+            case DXT3:
+            case DXT4:
+            case DXT5:
+                return caps->hasCapability(Capabilities::TEXTURE_COMPRESSION_DXT);
+            case BC4_UNORM:
+            case BC5_UNORM:
+                return caps->hasCapability(Capabilities::TEXTURE_COMPRESSION_BC4_BC5);
+            case BC7_UNORM:
+                return caps->hasCapability(Capabilities::TEXTURE_COMPRESSION_BC6H_BC7);
+            case ETC1_RGB8:
+                return caps->hasCapability(Capabilities::TEXTURE_COMPRESSION_ETC1) ||
+                       caps->hasCapability(Capabilities::TEXTURE_COMPRESSION_ETC2);
+            case ETC2_RGB8:
+            case ETC2_RGBA8:
+            case ETC2_RGB8A1:
+                return caps->hasCapability(Capabilities::TEXTURE_COMPRESSION_ETC2);
+            default:
+                if (fmt >= ASTC_RGBA_4X4_LDR && fmt <= ASTC_RGBA_12X12_LDR)
+                    return caps->hasCapability(Capabilities::TEXTURE_COMPRESSION_ASTC);
+                return true;
+            }
+        }
+
+        /// Header of the files in the decompression cache, followed by the BYTE_RGBA image
+        struct DecompressedHeader
+        {
+            static constexpr uint32 MAGIC = 0x31434F44; // "DOC1"
+            uint32 magic;
+            uint32 width, height, depth, faces, mipmaps;
+        };
+
+        /// Decodes img to BYTE_RGBA, going through the cache directory unless it is empty
+        void decompressCached(Image& img, std::string_view cacheLocation)
+        {
+            if (cacheLocation.empty())
+            {
+                img.decompress();
+                return;
+            }
+
+            DecompressedHeader header{DecompressedHeader::MAGIC, img.getWidth(), img.getHeight(), img.getDepth(),
+                                      img.getNumFaces(), std::to_underlying(img.getNumMipmaps())};
+            uint32 seed = HashCombine(FastHash((const char*)&header, sizeof(header)), img.getFormat());
+            auto data = (const char*)img.getData();
+            uint64 key = uint64(FastHash(data, img.getSize(), seed)) << 32 | FastHash(data, img.getSize(), ~seed);
+            std::filesystem::path path = std::filesystem::path(cacheLocation) / ::std::format("{:016x}.rgba", key);
+
+            size_t size = Image::calculateSize(img.getNumMipmaps(), header.faces, header.width, header.height,
+                                               header.depth, PixelFormat::BYTE_RGBA);
+            std::ifstream in(path, std::ios::binary);
+            DecompressedHeader cached{};
+            if (in && in.read((char*)&cached, sizeof(cached)) && std::memcmp(&cached, &header, sizeof(header)) == 0)
+            {
+                // allocated like Image::create, so that the image can own it
+                auto buffer = static_cast<uchar*>(malloc(size));
+                if (in.read((char*)buffer, std::streamsize(size)))
+                {
+                    img.loadDynamicImage(buffer, header.width, header.height, header.depth, PixelFormat::BYTE_RGBA,
+                                         true, header.faces, img.getNumMipmaps());
+                    return;
+                }
+                free(buffer);
+            }
+            in.close();
+
+            img.decompress();
+
+            // write next to it and rename, so a concurrent or interrupted load never reads half a file
+            std::error_code ec;
+            std::filesystem::create_directories(path.parent_path(), ec);
+            auto tmpPath = path;
+            tmpPath += ::std::format(".{}", std::hash<std::thread::id>{}(std::this_thread::get_id()));
+            std::ofstream out(tmpPath, std::ios::binary);
+            out.write((const char*)&header, sizeof(header));
+            out.write((const char*)img.getData(), std::streamsize(size));
+            out.close();
+            if (out)
+                std::filesystem::rename(tmpPath, path, ec);
+            if (!out || ec)
+            {
+                std::filesystem::remove(tmpPath, ec);
+                LogManager::getSingleton().logWarning(
+                    ::std::format("could not write '{}' to the decompression cache", path.string()));
+            }
+        }
+    }
+
+    void Texture::readImage(Image& img, std::string_view name, bool haveNPOT)
     {
+        std::string_view baseName, ext;
+        StringUtil::splitBaseFilename(name, baseName, ext);
+
         DataStreamPtr dstream = ResourceGroupManager::getSingleton().openResource(name, mGroup, this);
 
-        imgs.push_back(Image());
-        Image& img = imgs.back();
         img.load(dstream, ext);
 
+        // expand the formats the RenderSystem can not sample
+        const RenderSystemCapabilities* caps = Root::getSingleton().getRenderSystem()->getCapabilities();
+        if (PixelUtil::isCompressed(img.getFormat()) && BlockDecoder::isSupported(img.getFormat()) &&
+            !isCompressionSupported(img.getFormat(), caps))
+        {
+            LogManager::getSingleton().logMessage(::std::format(
+                "Texture '{}': {} is not supported, decoding it on the CPU", name,
+                PixelUtil::getFormatName(img.getFormat())));
+            decompressCached(img, TextureManager::getSingleton().getDecompressionCacheLocation());
+        }
+
         if( haveNPOT )
             return;
 
@@ -442,6 +669,58 @@ namespace Ogre {
             img.resize(w, h);
     }
 
+    namespace
+    {
+        /// The block compressed format used for fmt by TextureManager::setRuntimeCompression
+        auto getRuntimeCompressionFormat(PixelFormat fmt, const RenderSystemCapabilities* caps) -> PixelFormat
+        {
+            using enum PixelFormat;
+            bool bc4bc5 = caps->hasCapability(Capabilities::TEXTURE_COMPRESSION_BC4_BC5);
+            bool bc7 = caps->hasCapability(Capabilities::TEXTURE_COMPRESSION_BC6H_BC7);
+            bool dxt = caps->hasCapability(Capabilities::TEXTURE_COMPRESSION_DXT);
+            bool etc2 = caps->hasCapability(Capabilities::TEXTURE_COMPRESSION_ETC2);
+            bool etc1 = caps->hasCapability(Capabilities::TEXTURE_COMPRESSION_ETC1);
+            switch (fmt)
+            {
+            case R8:
+                return bc4bc5 ? BC4_UNORM : UNKNOWN;
+            case R8G8:
+                return bc4bc5 ? BC5_UNORM : UNKNOWN;
+            case R8G8B8:
+            case B8G8R8:
+            case X8R8G8B8:
+            case X8B8G8R8:
+                return dxt ? DXT1 : etc2 ? ETC2_RGB8 : etc1 ? ETC1_RGB8 : UNKNOWN;
+            case A8R8G8B8:
+            case A8B8G8R8:
+            case B8G8R8A8:
+            case R8G8B8A8:
+                return bc7 ? BC7_UNORM : dxt ? DXT5 : etc2 ? ETC2_RGBA8 : UNKNOWN;
+            default:
+                return UNKNOWN;
+            }
+        }
+    }
+
+    void Texture::applyRuntimeCompression(LoadedImages& images) const
+    {
+        if (!TextureManager::getSingleton().getRuntimeCompression() || mDesiredFormat != PixelFormat::UNKNOWN ||
+            mTextureType == TextureType::_3D)
+            return;
+
+        const RenderSystemCapabilities* renderCaps = Root::getSingleton().getRenderSystem()->getCapabilities();
+        for (Image& img : images)
+        {
+            PixelFormat format = getRuntimeCompressionFormat(img.getFormat(), renderCaps);
+            if (format == PixelFormat::UNKNOWN)
+                continue;
+            // the GPU can not generate them for all compressed formats
+            if (mNumMipmaps != TextureMipmap{} && img.getNumMipmaps() == TextureMipmap{})
+                img.generateMipmaps(mHwGamma);
+            img.compress(format);
+        }
+    }
+
     void Texture::prepareImpl()
     {
         if (!!(mUsage & TextureUsage::RENDERTARGET))
@@ -462,7 +741,8 @@ namespace Ogre {
         {
             if(mLayerNames.empty())
             {
-                readImage(loadedImages, mName, ext, haveNPOT);
+                loadedImages.resize(1);
+                readImage(loadedImages[0], mName, haveNPOT);
 
                 // If this is a volumetric texture set the texture type flag accordingly.
                 // If this is a cube map, set the texture type flag accordingly.
@@ -475,6 +755,7 @@ namespace Ogre {
         }
         catch(const FileNotFoundException&)
         {
+            loadedImages.clear();
             if(mTextureType == TextureType::CUBE_MAP)
             {
                 mLayerNames.resize(6);
@@ -488,13 +769,21 @@ namespace Ogre {
                 throw; // rethrow
         }
 
-        // read sub-images
-        for(std::string_view name : mLayerNames)
+        // read sub-images, the layers are independent so decode them concurrently
+        if (!mLayerNames.empty())
         {
-            StringUtil::splitBaseFilename(name, baseName, ext);
-            readImage(loadedImages, name, ext, haveNPOT);
+            loadedImages.resize(mLayerNames.size());
+            auto readLayer = [&](size_t i) { readImage(loadedImages[i], mLayerNames[i], haveNPOT); };
+
+            if (WorkQueue* queue = Root::getSingleton().getWorkQueue())
+                queue->parallelFor(mLayerNames.size(), readLayer);
+            else
+                for (size_t i = 0; i < mLayerNames.size(); ++i)
+                    readLayer(i);
         }
 
+        applyRuntimeCompression(loadedImages);
+
         // If compressed and 0 custom mipmap, disable auto mip generation and
         // disable software mipmap creation.
         // Not supported by GLES.
@@ -539,4 +828,123 @@ namespace Ogre {
 
         _loadImages(imagePtrs);
     }
+    //-----------------------------------------------------------------------
+    void Texture::_requestMipLevel(uint32 mip)
+    {
+        unsigned long frame = Root::getSingleton().getNextFrameNumber();
+        if (mMipRequestFrame != frame)
+            mRequestedMip = mip;
+        else
+            mRequestedMip = std::min(mRequestedMip, mip);
+        mMipRequestFrame = frame;
+    }
+    //-----------------------------------------------------------------------
+    void Texture::_requestScreenSize(Real pixels)
+    {
+        if (!_isMipStreamed())
+            return;
+
+        // one texel per pixel, rounded to the more detailed level
+        Real texels = std::max(mWidth, mHeight);
+        auto mip = uint32(std::max(Real(0), std::floor(std::log2(texels / std::max(pixels, Real(1))))));
+        _requestMipLevel(std::min(mip, mStreamingStartMip));
+    }
+    //-----------------------------------------------------------------------
+    auto Texture::_getMipChainSize(uint32 mip) const -> size_t
+    {
+        size_t size = 0;
+        for (; mip <= std::to_underlying(mNumMipmaps); ++mip)
+        {
+            size += getNumFaces() *
+                    PixelUtil::getMemorySize(std::max(mWidth >> mip, 1u), std::max(mHeight >> mip, 1u), 1, mFormat);
+        }
+        return size;
+    }
+    //-----------------------------------------------------------------------
+    void Texture::_streamMipLevel(uint32 mip)
+    {
+        mip = std::min(mip, mStreamingStartMip);
+        if (!_isMipStreamed() || mMipFetchPending || mip == mResidentMip)
+            return;
+
+        if (mip > mResidentMip)
+        {
+            // the levels stay allocated, but are not sampled any more
+            setMostDetailedMipImpl(mip);
+            mResidentMip = mip;
+            return;
+        }
+
+        // keeps the texture alive while the worker reads it
+        auto self = static_pointer_cast<Texture>(mCreator->getByHandle(mHandle));
+        mFetchedMip = mip;
+        mMipFetchPending = true;
+        // streamed textures have mipmaps, so there is no limited NPOT support
+        bool haveNPOT = Root::getSingleton().getRenderSystem()->getCapabilities()->hasCapability(
+            Capabilities::NON_POWER_OF_2_TEXTURES);
+        auto fetch = [self, haveNPOT]()
+        {
+            LoadedImages images;
+            try
+            {
+                if (self->mLayerNames.empty())
+                {
+                    images.resize(1);
+                    self->readImage(images[0], self->mName, haveNPOT);
+                }
+                else
+                {
+                    images.resize(self->mLayerNames.size());
+                    for (size_t i = 0; i < images.size(); ++i)
+                        self->readImage(images[i], self->mLayerNames[i], haveNPOT);
+                }
+                self->applyRuntimeCompression(images);
+            }
+            catch (const Exception& e)
+            {
+                LogManager::getSingleton().logError(
+                    ::std::format("Texture '{}': streaming mipmaps failed: {}", self->mName, e.getDescription()));
+                images.clear();
+                // do not retry every frame
+                self->mStreamingStartMip = 0;
+            }
+            self->mFetchedImages = std::move(images);
+            self->mMipFetchPending = false;
+        };
+
+        if (WorkQueue* queue = Root::getSingleton().getWorkQueue())
+            queue->addTask(fetch);
+        else
+            fetch();
+    }
+    //-----------------------------------------------------------------------
+    void Texture::_updateMipStreaming()
+    {
+        if (mMipFetchPending || mFetchedImages.empty())
+            return;
+
+        LoadedImages images;
+        std::swap(images, mFetchedImages);
+        if (!isLoaded())
+            return;
+
+        // the file changed or was resized on loading, keep what we have
+        const Image& img = images[0];
+        if (img.getWidth() != mSrcWidth || img.getHeight() != mSrcHeight || img.getFormat() != mSrcFormat ||
+            img.getNumMipmaps() < mNumMipmaps)
+        {
+            LogManager::getSingleton().logWarning(
+                ::std::format("Texture '{}': the source does not match, mipmap streaming stopped", mName));
+            mStreamingStartMip = 0;
+            return;
+        }
+
+        ConstImagePtrList imagePtrs;
+        for (const auto& image : images)
+            imagePtrs.push_back(&image);
+
+        uploadMipLevels(imagePtrs, mFetchedMip, mResidentMip - 1);
+        setMostDetailedMipImpl(mFetchedMip);
+        mResidentMip = mFetchedMip;
+    }
 }
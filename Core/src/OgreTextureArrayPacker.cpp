@@ -0,0 +1,213 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+module;
+
+#include <cstddef>
+
+module Ogre.Core;
+
+import :Entity;
+import :Exception;
+import :Image;
+import :Material;
+import :Pass;
+import :PixelFormat;
+import :SubEntity;
+import :Technique;
+import :Texture;
+import :TextureArrayPacker;
+import :TextureManager;
+import :TextureUnitState;
+import :Vector;
+
+import <algorithm>;
+import <format>;
+import <map>;
+import <string>;
+import <utility>;
+import <vector>;
+
+namespace Ogre
+{
+    //-----------------------------------------------------------------------
+    void TextureArrayPacker::addMaterial(const MaterialPtr& material)
+    {
+        if (material->getNumTechniques() != 1 || material->getTechnique(0)->getNumPasses() != 1)
+            return;
+
+        const Pass* pass = material->getTechnique(0)->getPass(0);
+        if (pass->isProgrammable() || pass->getNumTextureUnitStates() == 0)
+            return;
+
+        Candidate candidate{material, {}};
+        for (const TextureUnitState* tus : pass->getTextureUnitStates())
+        {
+            if (tus->getContentType() != TextureUnitState::ContentType::NAMED ||
+                tus->getTextureType() != TextureType::_2D || tus->getNumFrames() != 1 || !tus->getEffects().empty())
+                return;
+
+            std::string_view name = tus->getTextureName();
+            std::string_view group = material->getGroup();
+            TexturePtr tex = TextureManager::getSingleton().getByName(name, group);
+            if (tex && tex->isLoaded())
+            {
+                candidate.textures.push_back({tex->getSrcWidth(), tex->getSrcHeight(), tex->getSrcFormat()});
+                continue;
+            }
+
+            // only the header would do, but the codecs have no way to read it alone
+            Image image;
+            image.load(name, tex ? tex->getGroup() : group);
+            candidate.textures.push_back({image.getWidth(), image.getHeight(), image.getFormat()});
+        }
+        mCandidates.push_back(std::move(candidate));
+    }
+    //-----------------------------------------------------------------------
+    auto TextureArrayPacker::isCompatible(const Candidate& a, const Candidate& b) -> bool
+    {
+        if (a.textures != b.textures)
+            return false;
+
+        const Pass* pa = a.material->getTechnique(0)->getPass(0);
+        const Pass* pb = b.material->getTechnique(0)->getPass(0);
+        if (pa->getAmbient() != pb->getAmbient() || pa->getDiffuse() != pb->getDiffuse() ||
+            pa->getSpecular() != pb->getSpecular() || pa->getSelfIllumination() != pb->getSelfIllumination() ||
+            pa->getShininess() != pb->getShininess() || pa->getVertexColourTracking() != pb->getVertexColourTracking() ||
+            pa->getLightingEnabled() != pb->getLightingEnabled() || pa->getBlendState() != pb->getBlendState() ||
+            pa->getDepthCheckEnabled() != pb->getDepthCheckEnabled() ||
+            pa->getDepthWriteEnabled() != pb->getDepthWriteEnabled() ||
+            pa->getDepthFunction() != pb->getDepthFunction() ||
+            pa->getDepthBiasConstant() != pb->getDepthBiasConstant() ||
+            pa->getDepthBiasSlopeScale() != pb->getDepthBiasSlopeScale() ||
+            pa->getCullingMode() != pb->getCullingMode() || pa->getManualCullingMode() != pb->getManualCullingMode() ||
+            pa->getShadingMode() != pb->getShadingMode() || pa->getPolygonMode() != pb->getPolygonMode() ||
+            pa->getAlphaRejectFunction() != pb->getAlphaRejectFunction() ||
+            pa->getAlphaRejectValue() != pb->getAlphaRejectValue() ||
+            pa->getTransparentSortingEnabled() != pb->getTransparentSortingEnabled() ||
+            pa->getFogOverride() != pb->getFogOverride() || pa->getAutoInstancing() != pb->getAutoInstancing() ||
+            pa->getMaxSimultaneousLights() != pb->getMaxSimultaneousLights() ||
+            pa->getIteratePerLight() != pb->getIteratePerLight() ||
+            a.material->getReceiveShadows() != b.material->getReceiveShadows())
+            return false;
+
+        for (size_t i = 0; i < pa->getNumTextureUnitStates(); ++i)
+        {
+            const TextureUnitState* ta = pa->getTextureUnitState(i);
+            const TextureUnitState* tb = pb->getTextureUnitState(i);
+            if (ta->getTextureCoordSet() != tb->getTextureCoordSet() ||
+                ta->getSampler()->getHash() != tb->getSampler()->getHash() ||
+                !(ta->getColourBlendMode() == tb->getColourBlendMode()) ||
+                !(ta->getAlphaBlendMode() == tb->getAlphaBlendMode()) ||
+                ta->getTextureTransform() != tb->getTextureTransform() ||
+                ta->getNumMipmaps() != tb->getNumMipmaps() || ta->getGamma() != tb->getGamma() ||
+                ta->isHardwareGammaEnabled() != tb->isHardwareGammaEnabled() ||
+                ta->getDesiredFormat() != tb->getDesiredFormat())
+                return false;
+        }
+        return true;
+    }
+    //-----------------------------------------------------------------------
+    auto TextureArrayPacker::pack() -> size_t
+    {
+        // indices into mCandidates, the first one standing for the group
+        std::vector<std::vector<size_t>> groups;
+        for (size_t i = 0; i < mCandidates.size(); ++i)
+        {
+            if (mPacked.contains(mCandidates[i].material->getName()))
+                continue;
+
+            auto it = std::ranges::find_if(groups, [&](const std::vector<size_t>& group)
+            {
+                return group.size() < mMaxLayers && isCompatible(mCandidates[group.front()], mCandidates[i]);
+            });
+            if (it != groups.end())
+                it->push_back(i);
+            else
+                groups.push_back({i});
+        }
+
+        size_t numPacked = 0;
+        for (const auto& group : groups)
+        {
+            if (group.size() < 2)
+                continue;
+
+            const MaterialPtr& first = mCandidates[group.front()].material;
+            MaterialPtr packed = first->clone(std::format("TextureArray/{}", first->getName()));
+            Pass* pass = packed->getTechnique(0)->getPass(0);
+            for (unsigned short unit = 0; unit < pass->getNumTextureUnitStates(); ++unit)
+            {
+                std::vector<String> layers;
+                bool differ = false;
+                for (size_t member : group)
+                {
+                    const Pass* src = mCandidates[member].material->getTechnique(0)->getPass(0);
+                    layers.emplace_back(src->getTextureUnitState(unit)->getTextureName());
+                    differ = differ || layers.back() != layers.front();
+                }
+                // units sharing their texture across the group stay as they are
+                if (differ)
+                    pass->getTextureUnitState(unit)->setLayerArrayNames(TextureType::_2D_ARRAY, layers);
+            }
+
+            for (uint32 layer = 0; layer < group.size(); ++layer)
+                mPacked.emplace(mCandidates[group[layer]].material->getName(), Packed{packed, layer});
+            numPacked += group.size();
+        }
+        mCandidates.clear();
+        return numPacked;
+    }
+    //-----------------------------------------------------------------------
+    auto TextureArrayPacker::getPackedMaterial(std::string_view name) const -> MaterialPtr
+    {
+        auto it = mPacked.find(name);
+        return it != mPacked.end() ? it->second.material : nullptr;
+    }
+    //-----------------------------------------------------------------------
+    auto TextureArrayPacker::getLayer(std::string_view name) const -> uint32
+    {
+        auto it = mPacked.find(name);
+        if (it == mPacked.end())
+            OGRE_EXCEPT(ExceptionCodes::ITEM_NOT_FOUND, ::std::format("Material '{}' is not packed", name));
+        return it->second.layer;
+    }
+    //-----------------------------------------------------------------------
+    void TextureArrayPacker::apply(Entity* entity) const
+    {
+        for (size_t i = 0; i < entity->getNumSubEntities(); ++i)
+        {
+            SubEntity* sub = entity->getSubEntity(i);
+            auto it = mPacked.find(sub->getMaterialName());
+            if (it == mPacked.end())
+                continue;
+
+            sub->setMaterial(it->second.material);
+            sub->setCustomParameter(mLayerParameter, Vector4{Real(it->second.layer), 0, 0, 0});
+        }
+    }
+}
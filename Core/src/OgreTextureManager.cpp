@@ -49,11 +49,14 @@ import :Texture;
 import :TextureManager;
 import :TextureUnitState;
 
+import <algorithm>;
+import <functional>;
 import <map>;
 import <memory>;
 import <string>;
 import <unordered_map>;
 import <utility>;
+import <vector>;
 
 namespace Ogre {
 
@@ -229,9 +232,9 @@ namespace Ogre {
         if (reloadTextures)
         {
             // Iterate through all textures
-            for (auto & mResource : mResources)
+            for (auto const& resource : collectResources([](const ResourcePtr&) { return true; }))
             {
-                auto* texture = static_cast<Texture*>(mResource.second.get());
+                auto* texture = static_cast<Texture*>(resource.get());
                 // Reload loaded and reloadable texture only
                 if (texture->isLoaded() && texture->isReloadable())
                 {
@@ -259,9 +262,9 @@ namespace Ogre {
         if (reloadTextures)
         {
             // Iterate through all textures
-            for (auto & mResource : mResources)
+            for (auto const& resource : collectResources([](const ResourcePtr&) { return true; }))
             {
-                auto* texture = static_cast<Texture*>(mResource.second.get());
+                auto* texture = static_cast<Texture*>(resource.get());
                 // Reload loaded and reloadable texture only
                 if (texture->isLoaded() && texture->isReloadable())
                 {
@@ -290,9 +293,9 @@ namespace Ogre {
         if (reloadTextures)
         {
             // Iterate through all textures
-            for (auto & mResource : mResources)
+            for (auto const& resource : collectResources([](const ResourcePtr&) { return true; }))
             {
-                auto* texture = static_cast<Texture*>(mResource.second.get());
+                auto* texture = static_cast<Texture*>(resource.get());
                 // Reload loaded and reloadable texture only
                 if (texture->isLoaded() && texture->isReloadable())
                 {
@@ -370,4 +373,69 @@ namespace Ogre {
 
         return mDefaultSampler;
     }
+    //-----------------------------------------------------------------------
+    void TextureManager::_notifyMipStreaming(ResourceHandle handle)
+    {
+        // reloaded textures notify again
+        if (std::ranges::find(mStreamedTextures, handle) == mStreamedTextures.end())
+            mStreamedTextures.push_back(handle);
+    }
+    //-----------------------------------------------------------------------
+    void TextureManager::_updateMipStreaming()
+    {
+        struct Entry
+        {
+            TexturePtr texture;
+            uint32 wantedMip;
+        };
+        std::vector<Entry> textures;
+        unsigned long frame = Root::getSingleton().getNextFrameNumber();
+
+        mMipStreamingUsage = 0;
+        std::erase_if(mStreamedTextures,
+                      [&](ResourceHandle handle)
+                      {
+                          auto tex = static_pointer_cast<Texture>(getByHandle(handle));
+                          if (!tex || !tex->isLoaded() || !tex->_isMipStreamed())
+                              return true;
+
+                          tex->_updateMipStreaming();
+                          mMipStreamingUsage += tex->_getMipChainSize(tex->getMostDetailedMip());
+                          // requests of the last rendered frame are still valid
+                          bool requested = tex->_getMipRequestFrame() + 1 >= frame;
+                          textures.push_back({tex, requested ? tex->_getRequestedMip() : tex->_getStreamingStartMip()});
+                          return false;
+                      });
+
+        // most recently requested first
+        std::ranges::stable_sort(textures, std::greater<>{},
+                                 [](const Entry& e) { return e.texture->_getMipRequestFrame(); });
+
+        auto usage = [](const Entry& e, uint32 mip) { return e.texture->_getMipChainSize(mip); };
+        if (mMipStreamingBudget)
+        {
+            // drop the least recently requested first
+            for (auto it = textures.rbegin(); it != textures.rend() && mMipStreamingUsage > mMipStreamingBudget; ++it)
+            {
+                uint32 resident = it->texture->getMostDetailedMip();
+                if (it->wantedMip <= resident || it->texture->_isMipFetchPending())
+                    continue;
+                mMipStreamingUsage -= usage(*it, resident) - usage(*it, it->wantedMip);
+                it->texture->_streamMipLevel(it->wantedMip);
+            }
+        }
+
+        for (const auto& e : textures)
+        {
+            uint32 resident = e.texture->getMostDetailedMip();
+            if (e.wantedMip >= resident || e.texture->_isMipFetchPending())
+                continue;
+
+            size_t cost = usage(e, e.wantedMip) - usage(e, resident);
+            if (mMipStreamingBudget && mMipStreamingUsage + cost > mMipStreamingBudget)
+                continue;
+            mMipStreamingUsage += cost;
+            e.texture->_streamMipLevel(e.wantedMip);
+        }
+    }
 }
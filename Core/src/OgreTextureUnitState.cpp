@@ -32,6 +32,7 @@ module;
 
 module Ogre.Core;
 
+import :Controller;
 import :ControllerManager;
 import :Exception;
 import :LogManager;
@@ -125,6 +126,20 @@ namespace Ogre {
         return mMinFilter;
     }
     //-----------------------------------------------------------------------
+    auto Sampler::getHash() const -> uint32
+    {
+        uint32 hash = HashCombine(0, mBorderColour);
+        hash = HashCombine(hash, mMaxAniso);
+        hash = HashCombine(hash, mMipmapBias);
+        hash = HashCombine(hash, mAddressMode);
+        hash = HashCombine(hash, mMinFilter);
+        hash = HashCombine(hash, mMagFilter);
+        hash = HashCombine(hash, mMipFilter);
+        hash = HashCombine(hash, mCompareFunc);
+        hash = HashCombine(hash, bool(mCompareEnabled));
+        return hash ? hash : 1;
+    }
+    //-----------------------------------------------------------------------
     TextureUnitState::TextureUnitState(Pass* parent)
         : mCurrentFrame(0)
         , mAnimDuration(0)
@@ -1074,6 +1089,7 @@ namespace Ogre {
             mAnimController = nullptr;
         }
         mAnimController = ControllerManager::getSingleton().createTextureAnimator(this, mAnimDuration);
+        mAnimController->_setDeferrable(true);
 
     }
     //-----------------------------------------------------------------------
@@ -1109,6 +1125,20 @@ namespace Ogre {
         default:
             break;
         }
+        // applied by _applyHeldControllerInput
+        if (effect.controller)
+            effect.controller->_setDeferrable(true);
+    }
+    //-----------------------------------------------------------------------
+    void TextureUnitState::_applyHeldControllerInput()
+    {
+        if (mAnimController)
+            mAnimController->_applyHeldInput();
+        for (auto& effect : mEffects)
+        {
+            if (effect.second.controller)
+                effect.second.controller->_applyHeldInput();
+        }
     }
     //-----------------------------------------------------------------------
     auto TextureUnitState::getTextureUScroll() const -> Real
@@ -53,6 +53,11 @@ auto Timer::clocksToMicroseconds(long double clocks) -> long double
     return clocksToMilliseconds(clocks * 1000.0l);
 }
 
+auto Timer::microsecondsToClocks(long double microseconds) -> long double
+{
+    return microseconds * (long double)CLOCKS_PER_SEC / 1000000.0l;
+}
+
 //--------------------------------------------------------------------------------//
 Timer::Timer()
 {
@@ -198,6 +198,14 @@ namespace Ogre
             return false;
     }
     //-----------------------------------------------------------------------
+    auto UnifiedHighLevelGpuProgram::isPoseTextureAnimationIncluded() const noexcept -> bool
+    {
+        if (_getDelegate())
+            return _getDelegate()->isPoseTextureAnimationIncluded();
+        else
+            return false;
+    }
+    //-----------------------------------------------------------------------
     auto UnifiedHighLevelGpuProgram::getNumberOfPosesIncluded() const noexcept -> ushort
     {
         if (_getDelegate())
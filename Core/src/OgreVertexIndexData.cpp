@@ -137,6 +137,7 @@ namespace Ogre {
         // copy anim data
         dest->hwAnimationDataList = hwAnimationDataList;
         dest->hwAnimDataItemsUsed = hwAnimDataItemsUsed;
+        dest->hwPoseWeights = hwPoseWeights;
 
         
         return dest;
@@ -76,8 +76,8 @@ namespace Ogre {
         mOrientationMode = mDefaultOrientationMode;
             
         // Set the default material scheme
-        RenderSystem* rs = Root::getSingleton().getRenderSystem();
-        mMaterialSchemeName = rs->_getDefaultViewportMaterialScheme();
+        if (RenderSystem* rs = Root::getSingleton().getRenderSystem())
+            mMaterialSchemeName = rs->_getDefaultViewportMaterialScheme();
         
         // Calculate actual dimensions
         _updateDimensions();
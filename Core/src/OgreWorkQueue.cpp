@@ -25,15 +25,27 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 THE SOFTWARE.
 -----------------------------------------------------------------------------
 */
+module;
+
+#include <cstddef>
+
 module Ogre.Core;
 
 import :Log;
 import :LogManager;
+import :RenderSystem;
 import :Root;
+import :TaskScheduler;
 import :Timer;
 import :WorkQueue;
 
 import <algorithm>;
+import <atomic>;
+import <condition_variable>;
+import <exception>;
+import <functional>;
+import <memory>;
+import <mutex>;
 import <ostream>;
 import <ranges>;
 import <thread>;
@@ -53,6 +65,32 @@ namespace Ogre {
         return i->second;
     }
     //---------------------------------------------------------------------
+    void WorkQueue::parallelFor(size_t count, const std::function<void(size_t)>& func)
+    {
+        for (size_t i = 0; i < count; ++i)
+            func(i);
+    }
+    //---------------------------------------------------------------------
+    void WorkQueue::runTaskGraph(TaskGraph& graph)
+    {
+        std::exception_ptr error;
+        for (auto id : graph.getExecutionOrder())
+        {
+            try
+            {
+                graph.mTasks[id].func();
+            }
+            catch (...)
+            {
+                if (!error)
+                    error = std::current_exception();
+            }
+        }
+
+        if (error)
+            std::rethrow_exception(error);
+    }
+    //---------------------------------------------------------------------
     WorkQueue::Request::Request(uint16 channel, uint16 rtype, ::std::any  rData, uint8 retry, RequestID rid)
         : mChannel(channel), mType(rtype), mData(std::move(rData)), mRetryCount(retry), mID(rid) 
     {
@@ -69,6 +107,12 @@ namespace Ogre {
     {
     }
     //---------------------------------------------------------------------
+    DefaultWorkQueueBase::~DefaultWorkQueueBase()
+    {
+        std::unique_lock<std::recursive_mutex> ogrenameLock(mResponseMutex);
+        collectResponses();
+    }
+    //---------------------------------------------------------------------
     auto DefaultWorkQueueBase::getName() const noexcept -> std::string_view
     {
         return mName;
@@ -141,19 +185,19 @@ namespace Ogre {
     //---------------------------------------------------------------------
     void DefaultWorkQueueBase::addResponseHandler(uint16 channel, ResponseHandler* rh)
     {
-        auto i = mResponseHandlers.emplace(channel, ResponseHandlerList()).first;
+        if (channel >= mResponseHandlers.size())
+            mResponseHandlers.resize(channel + 1);
 
-        ResponseHandlerList& handlers = i->second;
+        ResponseHandlerList& handlers = mResponseHandlers[channel];
         if (std::ranges::find(handlers, rh) == handlers.end())
             handlers.push_back(rh);
     }
     //---------------------------------------------------------------------
     void DefaultWorkQueueBase::removeResponseHandler(uint16 channel, ResponseHandler* rh)
     {
-        auto i = mResponseHandlers.find(channel);
-        if (i != mResponseHandlers.end())
+        if (channel < mResponseHandlers.size())
         {
-            ResponseHandlerList& handlers = i->second;
+            ResponseHandlerList& handlers = mResponseHandlers[channel];
             auto j = std::ranges::find(handlers, rh);
             if (j != handlers.end())
                 handlers.erase(j);
@@ -203,6 +247,92 @@ namespace Ogre {
 
     }
     //---------------------------------------------------------------------
+    void DefaultWorkQueueBase::addTask(std::function<void()> task)
+    {
+        std::unique_lock<std::recursive_mutex> ogrenameLock(mRequestMutex);
+
+        if (mShuttingDown)
+            return;
+
+        mTaskQueue.push_back(std::move(task));
+        notifyWorkers();
+    }
+    //---------------------------------------------------------------------
+    auto DefaultWorkQueueBase::processNextTask() -> bool
+    {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::recursive_mutex> ogrenameLock(mRequestMutex);
+            if (mTaskQueue.empty())
+                return false;
+
+            task = std::move(mTaskQueue.front());
+            mTaskQueue.pop_front();
+        }
+
+        task();
+        return true;
+    }
+    //---------------------------------------------------------------------
+    void DefaultWorkQueueBase::parallelFor(size_t count, const std::function<void(size_t)>& func)
+    {
+        if (!mIsRunning || mShuttingDown || mWorkerThreadCount == 0 || count < 2)
+        {
+            WorkQueue::parallelFor(count, func);
+            return;
+        }
+
+        // shared with the helper tasks, which may only get to run after we returned
+        struct ParallelForState
+        {
+            std::function<void(size_t)> func;
+            size_t count;
+            std::atomic<size_t> next{0};
+            std::atomic<size_t> done{0};
+            std::mutex mutex;
+            std::condition_variable finished;
+            std::exception_ptr error;
+        };
+        auto state = std::make_shared<ParallelForState>();
+        state->func = func;
+        state->count = count;
+
+        auto run = [state]()
+        {
+            for (size_t i = state->next++; i < state->count; i = state->next++)
+            {
+                try
+                {
+                    state->func(i);
+                }
+                catch (...)
+                {
+                    std::unique_lock<std::mutex> errorLock(state->mutex);
+                    if (!state->error)
+                        state->error = std::current_exception();
+                }
+
+                if (++state->done == state->count)
+                {
+                    std::unique_lock<std::mutex> doneLock(state->mutex);
+                    state->finished.notify_all();
+                }
+            }
+        };
+
+        size_t helpers = std::min(mWorkerThreadCount, count - 1);
+        for (size_t i = 0; i < helpers; ++i)
+            addTask(run);
+
+        run();
+
+        std::unique_lock<std::mutex> waitLock(state->mutex);
+        state->finished.wait(waitLock, [&state]() { return state->done == state->count; });
+
+        if (state->error)
+            std::rethrow_exception(state->error);
+    }
+    //---------------------------------------------------------------------
     void DefaultWorkQueueBase::addRequestWithRID(WorkQueue::RequestID rid, uint16 channel, 
         uint16 requestType, ::std::any const& rData, uint8 retryCount)
     {
@@ -265,6 +395,7 @@ namespace Ogre {
 
         {
             std::unique_lock<std::recursive_mutex> ogrenameLock4(mResponseMutex);
+            collectResponses();
 
             for (auto & i : mResponseQueue)
             {
@@ -348,6 +479,7 @@ namespace Ogre {
 
         {
             std::unique_lock<std::recursive_mutex> ogrenameLock4(mResponseMutex);
+            collectResponses();
 
             for (auto & i : mResponseQueue)
             {
@@ -421,6 +553,7 @@ namespace Ogre {
 
         {
             std::unique_lock<std::recursive_mutex> ogrenameLock3(mResponseMutex);
+            collectResponses();
 
             for (auto & i : mResponseQueue)
             {
@@ -456,6 +589,10 @@ namespace Ogre {
     //---------------------------------------------------------------------
     void DefaultWorkQueueBase::_processNextRequest()
     {
+        if(processNextTask()){
+            // Tasks are usually waited upon, so they go first.
+            return;
+        }
         if(processIdleRequests()){
             // Found idle requests.
             return;
@@ -486,6 +623,11 @@ namespace Ogre {
     {
         Response* response = processRequest(r);
 
+        // the GPU side of what the worker created must be complete before the
+        // main thread sees the response
+        if (mWorkerRenderSystemAccess && !synchronous)
+            Root::getSingleton().getRenderSystem()->_finishThreadWork();
+
         std::unique_lock<std::recursive_mutex> ogrenameLock1(mProcessMutex);
 
         for(auto it = mProcessQueue.begin(); it != mProcessQueue.end(); ++it )
@@ -528,8 +670,7 @@ namespace Ogre {
                     response->abortRequest();
                 }
                 // Queue response
-                std::unique_lock<std::recursive_mutex> ogrenameLock2(mResponseMutex);
-                mResponseQueue.emplace_back(response);
+                queueResponse(response);
                 // no need to wake thread, this is processed by the main thread
             }
 
@@ -549,9 +690,37 @@ namespace Ogre {
 
     }
     //---------------------------------------------------------------------
+    void DefaultWorkQueueBase::queueResponse(Response* r)
+    {
+        Response* head = mIncomingResponses.load(std::memory_order_relaxed);
+        do
+            r->mNext = head;
+        while (!mIncomingResponses.compare_exchange_weak(head, r, std::memory_order_release,
+                                                         std::memory_order_relaxed));
+    }
+    //---------------------------------------------------------------------
+    void DefaultWorkQueueBase::collectResponses()
+    {
+        Response* r = mIncomingResponses.exchange(nullptr, std::memory_order_acquire);
+        if (!r)
+            return;
+
+        // the list is newest first
+        size_t first = mResponseQueue.size();
+        while (r)
+        {
+            Response* next = r->mNext;
+            r->mNext = nullptr;
+            mResponseQueue.emplace_back(r);
+            r = next;
+        }
+        std::reverse(mResponseQueue.begin() + first, mResponseQueue.end());
+    }
+    //---------------------------------------------------------------------
     void DefaultWorkQueueBase::processResponses() 
     {
-        unsigned long msStart = Root::getSingleton().getTimer()->getMilliseconds();
+        Timer* timer = Root::getSingleton().getTimer();
+        unsigned long msStart = timer->getMilliseconds();
         unsigned long msCurrent = 0;
 
         // keep going until we run out of responses or out of time
@@ -559,8 +728,11 @@ namespace Ogre {
         {
             Response* response = nullptr;
             {
+                // the workers do not take this lock, so it is uncontended
                 std::unique_lock<std::recursive_mutex> ogrenameLock(mResponseMutex);
 
+                if (mResponseQueue.empty())
+                    collectResponses();
                 if (mResponseQueue.empty())
                     break; // exit loop
                 else
@@ -581,7 +753,7 @@ namespace Ogre {
             // time limit
             if (mResposeTimeLimitMS)
             {
-                msCurrent = Root::getSingleton().getTimer()->getMilliseconds();
+                msCurrent = timer->getMilliseconds();
                 if (msCurrent - msStart > mResposeTimeLimitMS)
                     break;
             }
@@ -633,30 +805,43 @@ namespace Ogre {
     //---------------------------------------------------------------------
     void DefaultWorkQueueBase::processResponse(Response* r)
     {
+        // formatting the trace costs more than delivering most responses
+        Log* log = LogManager::getSingleton().getDefaultLog();
+        bool trace = log && log->getMinLogLevel() <= LogMessageLevel::Trivial;
+
         StringStream dbgMsg;
-        dbgMsg << "thread:" <<
-            std::this_thread::get_id()
-            << "): ID=" << r->getRequest()->getID()
-            << " success=" << r->succeeded() << " messages=[" << r->getMessages() << "] channel=" 
-            << r->getRequest()->getChannel() << " requestType=" << r->getRequest()->getType();
+        if (trace)
+        {
+            dbgMsg << "thread:" <<
+                std::this_thread::get_id()
+                << "): ID=" << r->getRequest()->getID()
+                << " success=" << r->succeeded() << " messages=[" << r->getMessages() << "] channel=" 
+                << r->getRequest()->getChannel() << " requestType=" << r->getRequest()->getType();
 
-        LogManager::getSingleton().stream(LogMessageLevel::Trivial) << 
-            "DefaultWorkQueueBase('" << mName << "') - PROCESS_RESPONSE_START(" << dbgMsg.str();
+            LogManager::getSingleton().stream(LogMessageLevel::Trivial) << 
+                "DefaultWorkQueueBase('" << mName << "') - PROCESS_RESPONSE_START(" << dbgMsg.str();
+        }
 
-        auto i = mResponseHandlers.find(r->getRequest()->getChannel());
-        if (i != mResponseHandlers.end())
+        uint16 channel = r->getRequest()->getChannel();
+        if (channel < mResponseHandlers.size())
         {
-            ResponseHandlerList& handlers = i->second;
-            for (auto & handler : std::ranges::reverse_view(handlers))
+            // by index, handlers may be removed while handling
+            for (size_t i = mResponseHandlers[channel].size(); i-- > 0;)
             {
+                const ResponseHandlerList& handlers = mResponseHandlers[channel];
+                if (i >= handlers.size())
+                    continue;
+                ResponseHandler* handler = handlers[i];
                 if (handler->canHandleResponse(r, this))
                 {
                     handler->handleResponse(r, this);
                 }
             }
         }
-        LogManager::getSingleton().stream(LogMessageLevel::Trivial) << 
-            "DefaultWorkQueueBase('" << mName << "') - PROCESS_RESPONSE_END(" << dbgMsg.str();
+
+        if (trace)
+            LogManager::getSingleton().stream(LogMessageLevel::Trivial) << 
+                "DefaultWorkQueueBase('" << mName << "') - PROCESS_RESPONSE_END(" << dbgMsg.str();
 
     }
 
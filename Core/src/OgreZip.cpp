@@ -27,10 +27,11 @@ THE SOFTWARE.
 */
 module;
 
-#include <zip.h>
 #include <cstddef>
+#include <cstring>
 // NOLINTBEGIN
-#include <zip.h>
+#define MINIZ_HEADER_FILE_ONLY
+#include <miniz.h>
 
 module Ogre.Core;
 
@@ -58,14 +59,44 @@ import <vector>;
 // NOLINTEND
 namespace Ogre {
 namespace {
+    /// Read-only view of an entry stored uncompressed, keeping the archive data alive
+    class ZipEntryView : public MemoryDataStream
+    {
+        MemoryDataStreamPtr mArchiveData;
+    public:
+        ZipEntryView(std::string_view name, MemoryDataStreamPtr archiveData, uchar* data, size_t size)
+            : MemoryDataStream(name, data, size, false, true), mArchiveData(std::move(archiveData))
+        {
+        }
+    };
+
+    /** Archive over a zip file held in memory.
+    @remarks
+        The central directory is read once on load, after which open() only reads
+        immutable state, so entries can be opened from many threads at once.
+        Entries stored uncompressed are returned as views of the archive data.
+    */
     class ZipArchive : public Archive
     {
     protected:
-        /// Handle to root zip file
-        zip_t* mZipFile{nullptr};
+        /// Where the data of an entry is located in mBuffer
+        struct Entry
+        {
+            size_t offset;
+            size_t compressedSize;
+            size_t size;
+            uint16 method;
+        };
+        using EntryMap = std::map<std::string, Entry, std::less<>>;
+
         MemoryDataStreamPtr mBuffer;
-        /// File list (since zziplib seems to only allow scanning of dir tree once)
+        EntryMap mEntries;
+        bool mLoaded{false};
+        /// File list, built on load
         FileInfoList mFileList;
+
+        /// Gets the position of the data following the local header at the given offset, 0 if invalid
+        [[nodiscard]] auto getDataOffset(size_t localHeader, size_t compressedSize) const -> size_t;
     public:
         ZipArchive(std::string_view name, std::string_view archType, const uint8* externBuf = nullptr, size_t externBufSz = 0);
         ~ZipArchive() override;
@@ -122,55 +153,105 @@ namespace {
     //-----------------------------------------------------------------------
     void ZipArchive::load()
     {
-        if (!mZipFile)
-        {
-            if(!mBuffer)
-                mBuffer = std::make_shared<MemoryDataStream>(_openFileStream(mName, std::ios::binary));
+        if (mLoaded)
+            return;
 
-            mZipFile = zip_stream_open((const char*)mBuffer->getPtr(), mBuffer->size(), 0, 'r');
-
-            // Cache names
-            int n = zip_entries_total(mZipFile);
-            for (int i = 0; i < n; ++i) {
-                FileInfo info;
-                info.archive = this;
+        if(!mBuffer)
+        {
+            DataStreamPtr stream = _openFileStream(mName, std::ios::binary);
+            // memory mapped files are used as they are
+            mBuffer = std::dynamic_pointer_cast<MemoryDataStream>(stream);
+            if (!mBuffer)
+                mBuffer = std::make_shared<MemoryDataStream>(stream);
+        }
 
-                zip_entry_openbyindex(mZipFile, i);
+        mz_zip_archive zip;
+        memset(&zip, 0, sizeof(zip));
+        if (!mz_zip_reader_init_mem(&zip, mBuffer->getPtr(), mBuffer->size(), 0))
+        {
+            OGRE_EXCEPT(ExceptionCodes::INVALIDPARAMS, ::std::format("could not open {}: {}", mName,
+                        mz_zip_get_error_string(mz_zip_get_last_error(&zip))));
+        }
 
-                info.filename = zip_entry_name(mZipFile);
-                // Get basename / path
-                std::string_view basename, path;
+        // Cache names
+        mz_uint n = mz_zip_reader_get_num_files(&zip);
+        for (mz_uint i = 0; i < n; ++i) {
+            mz_zip_archive_file_stat stat;
+            if (!mz_zip_reader_file_stat(&zip, i, &stat))
+                continue;
+
+            FileInfo info;
+            info.archive = this;
+
+            info.filename = stat.m_filename;
+            // Get basename / path
+            std::string_view basename, path;
+            StringUtil::splitFilename(info.filename, basename, path);
+            info.basename = basename;
+            info.path = path;
+
+            // Get sizes
+            info.uncompressedSize = stat.m_uncomp_size;
+            info.compressedSize = stat.m_comp_size;
+
+            if (stat.m_is_directory)
+            {
+                info.filename = info.filename.substr(0, info.filename.length() - 1);
                 StringUtil::splitFilename(info.filename, basename, path);
                 info.basename = basename;
                 info.path = path;
-
-                // Get sizes
-                info.uncompressedSize = zip_entry_size(mZipFile);
-                info.compressedSize = zip_entry_comp_size(mZipFile);
-
-                if (zip_entry_isdir(mZipFile))
-                {
-                    info.filename = info.filename.substr(0, info.filename.length() - 1);
-                    StringUtil::splitFilename(info.filename, basename, path);
-                    info.basename = basename;
-                    info.path = path;
-                    // Set compressed size to -1 for folders; anyway nobody will check
-                    // the compressed size of a folder, and if he does, its useless anyway
-                    info.compressedSize = size_t(-1);
-                }
-
-                zip_entry_close(mZipFile);
-                mFileList.push_back(info);
+                // Set compressed size to -1 for folders; anyway nobody will check
+                // the compressed size of a folder, and if he does, its useless anyway
+                info.compressedSize = size_t(-1);
             }
+            else if (stat.m_is_supported)
+            {
+                if (size_t offset = getDataOffset(stat.m_local_header_ofs, stat.m_comp_size))
+                    mEntries.emplace(info.filename,
+                                     Entry{offset, size_t(stat.m_comp_size), size_t(stat.m_uncomp_size), stat.m_method});
+            }
+
+            mFileList.push_back(info);
         }
+
+        mz_zip_reader_end(&zip);
+        mLoaded = true;
+    }
+    //-----------------------------------------------------------------------
+    auto ZipArchive::getDataOffset(size_t localHeader, size_t compressedSize) const -> size_t
+    {
+        // see the local file header in APPNOTE.TXT
+        constexpr uint32 LOCAL_HEADER_SIG = 0x04034b50;
+        constexpr size_t LOCAL_HEADER_SIZE = 30;
+
+        const uchar* data = mBuffer->getPtr();
+        size_t size = mBuffer->size();
+        if (localHeader + LOCAL_HEADER_SIZE > size)
+            return 0;
+
+        auto readLE = [data](size_t pos, size_t bytes)
+        {
+            uint32 value = 0;
+            for (size_t i = 0; i < bytes; ++i)
+                value |= uint32(data[pos + i]) << (8 * i);
+            return value;
+        };
+
+        if (readLE(localHeader, 4) != LOCAL_HEADER_SIG)
+            return 0;
+
+        size_t offset = localHeader + LOCAL_HEADER_SIZE + readLE(localHeader + 26, 2) + readLE(localHeader + 28, 2);
+        if (offset + compressedSize > size)
+            return 0;
+        return offset;
     }
     //-----------------------------------------------------------------------
     void ZipArchive::unload()
     {
-        if (mZipFile)
+        if (mLoaded)
         {
-            zip_close(mZipFile);
-            mZipFile = nullptr;
+            mLoaded = false;
+            mEntries.clear();
             mFileList.clear();
             mBuffer.reset();
         }
@@ -179,22 +260,38 @@ namespace {
     //-----------------------------------------------------------------------
     auto ZipArchive::open(std::string_view filename, bool readOnly) const -> DataStreamPtr
     {
-        // zip is not threadsafe
-        String lookUpFileName{ filename };
+        auto it = mEntries.find(filename);
+        if (it == mEntries.end())
+        {
+            OGRE_EXCEPT(ExceptionCodes::FILE_NOT_FOUND, ::std::format("could not open {}", filename));
+        }
+
+        const Entry& entry = it->second;
+        uchar* data = mBuffer->getPtr() + entry.offset;
 
-        bool open = zip_entry_open(mZipFile, lookUpFileName.c_str(), true) == 0;
+        if (entry.method == 0)
+        {
+            if (readOnly)
+                return std::make_shared<ZipEntryView>(filename, mBuffer, data, entry.size);
+
+            auto ret = std::make_shared<MemoryDataStream>(filename, entry.size);
+            memcpy(ret->getPtr(), data, entry.size);
+            return ret;
+        }
 
-        if (!open)
+        if (entry.method != MZ_DEFLATED)
         {
-            OGRE_EXCEPT(ExceptionCodes::FILE_NOT_FOUND, ::std::format("could not open {}", lookUpFileName));
+            OGRE_EXCEPT(ExceptionCodes::NOT_IMPLEMENTED,
+                        ::std::format("unsupported compression method {} for {}", entry.method, filename));
         }
 
         // Construct & return stream
-        auto ret = std::make_shared<MemoryDataStream>(zip_entry_size(mZipFile));
+        auto ret = std::make_shared<MemoryDataStream>(filename, entry.size);
 
-        if(zip_entry_noallocread(mZipFile, ret->getPtr(), ret->size()) < 0)
-            OGRE_EXCEPT(ExceptionCodes::FILE_NOT_FOUND, ::std::format("could not read {}", lookUpFileName));
-        zip_entry_close(mZipFile);
+        // a pure function of its arguments, so safe to call from any thread
+        if (entry.size &&
+            tinfl_decompress_mem_to_mem(ret->getPtr(), entry.size, data, entry.compressedSize, 0) != entry.size)
+            OGRE_EXCEPT(ExceptionCodes::FILE_NOT_FOUND, ::std::format("could not read {}", filename));
 
         return ret;
     }
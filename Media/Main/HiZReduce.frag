@@ -0,0 +1,35 @@
+#include <OgreUnifiedShader.h>
+
+SAMPLER2D(source, 0);
+
+OGRE_UNIFORMS(
+    // width, height and level of the source, 1 in w if it is the input
+    uniform vec4 sourceSize;
+)
+
+MAIN_PARAMETERS
+MAIN_DECLARATION
+{
+    // the 2x2 texels below, the last texel of a row or column also takes the odd one left over
+    vec2 target = floor(gl_FragCoord.xy);
+    vec2 targetSize = max(floor(sourceSize.xy * 0.5), vec2(1.0, 1.0));
+    vec2 first = target * 2.0;
+    vec2 last = mix(first + 1.0, sourceSize.xy - 1.0, step(targetSize - 1.0, target));
+    last = min(last, sourceSize.xy - 1.0);
+
+    float depth = 0.0;
+    for (int y = 0; y < 3; ++y)
+    {
+        for (int x = 0; x < 3; ++x)
+        {
+            vec2 texel = min(first + vec2(float(x), float(y)), last);
+            vec4 value = texture2DLod(source, (texel + 0.5) / sourceSize.xy, sourceSize.z);
+            float d = sourceSize.w > 0.0 ? value.w : value.x;
+            // nothing was rendered where the input is still cleared
+            if (sourceSize.w > 0.0 && d <= 0.0)
+                d = 1.0;
+            depth = max(depth, d);
+        }
+    }
+    gl_FragColor = vec4(depth, depth, depth, depth);
+}
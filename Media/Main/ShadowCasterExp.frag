@@ -0,0 +1,31 @@
+#include <OgreUnifiedShader.h>
+
+// keep in sync with SGXLib_IntegratedPSSM
+#ifndef ESM_EXPONENT
+#define ESM_EXPONENT 80.0
+#endif
+#ifndef EVSM_POSITIVE_EXPONENT
+#define EVSM_POSITIVE_EXPONENT 40.0
+#endif
+#ifndef EVSM_NEGATIVE_EXPONENT
+#define EVSM_NEGATIVE_EXPONENT 5.0
+#endif
+
+MAIN_PARAMETERS
+MAIN_DECLARATION
+{
+    float depth = gl_FragCoord.z;
+#ifdef OGRE_REVERSED_Z
+    depth = 1.0 - depth;
+#endif
+
+    // warped to 1 at the far plane, so that the white clear of shadow textures means no caster
+#ifdef EVSM
+    // both warps with their squares, for a Chebyshev bound each
+    float pos = exp(EVSM_POSITIVE_EXPONENT * (depth - 1.0));
+    float neg = 2.0 - exp(EVSM_NEGATIVE_EXPONENT * (1.0 - depth));
+    gl_FragColor = vec4(pos, pos * pos, neg, neg * neg);
+#else
+    gl_FragColor = vec4_splat(exp(ESM_EXPONENT * (depth - 1.0)));
+#endif
+}
@@ -0,0 +1,22 @@
+#include <OgreUnifiedShader.h>
+
+SAMPLER2D(shadowMap, 0);
+
+OGRE_UNIFORMS(
+    uniform vec4 invTexSize;
+    uniform vec2 direction;
+)
+
+MAIN_PARAMETERS
+IN(vec2 oUv0, TEXCOORD0)
+MAIN_DECLARATION
+{
+    // 9 tap gaussian along direction, point sampled as float textures may not be filterable
+    vec2 offset = direction * invTexSize.xy;
+    vec4 sum = texture2D(shadowMap, oUv0) * 0.2270270;
+    sum += (texture2D(shadowMap, oUv0 + offset) + texture2D(shadowMap, oUv0 - offset)) * 0.1945946;
+    sum += (texture2D(shadowMap, oUv0 + 2.0 * offset) + texture2D(shadowMap, oUv0 - 2.0 * offset)) * 0.1216216;
+    sum += (texture2D(shadowMap, oUv0 + 3.0 * offset) + texture2D(shadowMap, oUv0 - 3.0 * offset)) * 0.0540541;
+    sum += (texture2D(shadowMap, oUv0 + 4.0 * offset) + texture2D(shadowMap, oUv0 - 4.0 * offset)) * 0.0162162;
+    gl_FragColor = sum;
+}
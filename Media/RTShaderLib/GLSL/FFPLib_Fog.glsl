@@ -132,3 +132,45 @@ void FFP_PixelFog_Exp2(in float depth,
 	
 	oColor = mix(fogColor, baseColor, fogFactor);		
 }
+
+//-----------------------------------------------------------------------------
+// Fog of any mode, as used by the uber shaders of RTSS. fogMode holds the
+// FogMode enum: 0 none, 1 exp, 2 exp2, 3 linear.
+//-----------------------------------------------------------------------------
+float FFP_Fog_Generic_Factor(in float distance,
+				   in vec4 fogParams,
+				   in float fogMode)
+{
+	if (fogMode == 3.0)
+		return clamp((fogParams.z - distance) * fogParams.w, 0.0, 1.0);
+
+	float x = distance*fogParams.x;
+	if (fogMode == 2.0)
+		x *= x;
+	else if (fogMode != 1.0)
+		return 1.0;
+
+	return clamp(1.0 / exp(x), 0.0, 1.0);
+}
+
+//-----------------------------------------------------------------------------
+void FFP_VertexFog_Generic(in vec4 vOutPos,
+				   in vec4 fogParams,
+				   in float fogMode,
+				   out float oFogFactor)
+{
+	oFogFactor = FFP_Fog_Generic_Factor(abs(vOutPos.w), fogParams, fogMode);
+}
+
+//-----------------------------------------------------------------------------
+void FFP_PixelFog_Generic(in float depth,
+				   in vec4 fogParams,
+				   in float fogMode,
+				   in vec4 fogColor,
+				   in vec4 baseColor,
+				   out vec4 oColor)
+{
+	float fogFactor = FFP_Fog_Generic_Factor(abs(depth), fogParams, fogMode);
+
+	oColor = mix(fogColor, baseColor, fogFactor);
+}
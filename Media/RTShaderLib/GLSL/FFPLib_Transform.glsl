@@ -108,6 +108,53 @@ void FFP_Transform(in mat4 m,
 #endif
 }
 
+//-----------------------------------------------------------------------------
+// Expands the shared quad of an instanced BillboardSet, uv holds the corner in 0..1 on input
+void FFP_ExpandBillboard(in vec4 axisX,
+                         in vec4 axisY,
+                         in vec4 offsets,
+                         in vec3 sizeRotation,
+                         in vec4 texcoordRect,
+                         inout vec3 pos,
+                         inout vec2 uv)
+{
+	vec2 corner = uv;
+	vec2 offset = vec2(mix(offsets.x, offsets.y, corner.x) * sizeRotation.x,
+	                   mix(offsets.z, offsets.w, corner.y) * sizeRotation.y);
+	float c = cos(sizeRotation.z);
+	float s = sin(sizeRotation.z);
+
+	uv = mix(texcoordRect.xy, texcoordRect.zw, corner);
+	if (axisX.w > 0.5)
+	{
+		// rotate the texture coordinates around the centre of the rect
+		vec2 halfSize = (texcoordRect.zw - texcoordRect.xy) * 0.5;
+		vec2 d = (corner * 2.0 - 1.0) * halfSize;
+		uv = texcoordRect.xy + halfSize + vec2(d.x * c - d.y * s, d.x * s + d.y * c);
+	}
+	else
+	{
+		// rotate the vertices around the billboard position
+		offset = vec2(offset.x * c + offset.y * s, offset.y * c - offset.x * s);
+	}
+
+	pos += offset.x * axisX.xyz + offset.y * axisY.xyz;
+}
+
+//-----------------------------------------------------------------------------
+// Offsets a BillboardChain vertex perpendicular to the chain and the view direction,
+// expansion holds the chain tangent and the signed half width
+void FFP_ExpandChain(in vec3 eyePos,
+                     in vec4 expansion,
+                     inout vec3 pos)
+{
+	vec3 perpendicular = cross(expansion.xyz, eyePos - pos);
+	float len = dot(perpendicular, perpendicular);
+	// zero for vertices the CPU expanded already
+	if (len > 0.0)
+		pos += perpendicular * (inversesqrt(len) * expansion.w);
+}
+
 //-----------------------------------------------------------------------------
 void FFP_DerivePointSize(in vec4 params,
                          in float d,
@@ -0,0 +1,80 @@
+// This file is part of the OGRE project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at https://www.ogre3d.org/licensing.
+// SPDX-License-Identifier: MIT
+
+// Lights binned into view space clusters, see RTShader::LightClusters for the layout.
+// Requires SGXLib_PerPixelLighting.
+//
+// grid:   clusters in x, y and z, count of directional lights
+// depth:  near clip distance, slices per log depth, 1 / light capacity
+// texels: index texture width, 1 / index texture width, 1 / index texture height
+
+//-----------------------------------------------------------------------------
+void SGX_Light_Clustered_Apply(
+				    in float light,
+				    in vec3 vNormal,
+				    in vec3 vViewPos,
+				    in vec4 depth,
+				    in sampler2D lightData,
+				    in vec3 vSurfaceDiffuse,
+				    in vec3 vSurfaceSpecular,
+				    in float fSpecularPower,
+				    inout vec3 vOutDiffuse,
+				    inout vec3 vOutSpecular)
+{
+	float u = (light + 0.5) * depth.z;
+	vec4 position  = texture2D(lightData, vec2(u, 0.5 / 6.0));
+	vec4 direction = texture2D(lightData, vec2(u, 1.5 / 6.0));
+	vec4 atten     = texture2D(lightData, vec2(u, 2.5 / 6.0));
+	vec4 spot      = texture2D(lightData, vec2(u, 3.5 / 6.0));
+	vec4 diffuse   = texture2D(lightData, vec2(u, 4.5 / 6.0));
+	vec4 specular  = texture2D(lightData, vec2(u, 5.5 / 6.0));
+
+	SGX_Light_Generic_DiffuseSpecular(vNormal, vViewPos, position, direction.xyz, atten, spot,
+									  diffuse.rgb * vSurfaceDiffuse, specular.rgb * vSurfaceSpecular,
+									  fSpecularPower, vOutDiffuse, vOutSpecular);
+}
+
+//-----------------------------------------------------------------------------
+void SGX_Light_Clustered(
+				    in vec3 vNormal,
+				    in vec3 vViewPos,
+				    in mat4 mProj,
+				    in vec4 grid,
+				    in vec4 depth,
+				    in vec4 texels,
+				    in sampler2D lightData,
+				    in sampler2D clusterData,
+				    in sampler2D lightIndices,
+				    in vec3 vSurfaceDiffuse,
+				    in vec3 vSurfaceSpecular,
+				    in float fSpecularPower,
+				    inout vec3 vOutDiffuse,
+				    inout vec3 vOutSpecular)
+{
+	// directional lights come first and affect all clusters
+	for (float i = 0.0; i < grid.w; i += 1.0)
+	{
+		SGX_Light_Clustered_Apply(i, vNormal, vViewPos, depth, lightData, vSurfaceDiffuse, vSurfaceSpecular,
+								  fSpecularPower, vOutDiffuse, vOutSpecular);
+	}
+
+	// the culling uses the projection of the camera, without render target flipping
+	vec4 clip = mul(mProj, vec4(vViewPos, 1.0));
+	vec2 tile = floor(clamp((clip.xy / clip.w) * 0.5 + 0.5, 0.0, 0.9999) * grid.xy);
+	float slice = floor(clamp(log(max(-vViewPos.z, depth.x) / depth.x) * depth.y, 0.0, grid.z - 1.0));
+
+	vec2 range = texture2D(clusterData, vec2((tile.x + tile.y * grid.x + 0.5) / (grid.x * grid.y),
+											 (slice + 0.5) / grid.z)).xy;
+
+	for (float i = range.x; i < range.x + range.y; i += 1.0)
+	{
+		float row = floor(i * texels.y);
+		float col = i - row * texels.x;
+		float light = texture2D(lightIndices, vec2((col + 0.5) * texels.y, (row + 0.5) * texels.z)).x;
+
+		SGX_Light_Clustered_Apply(light, vNormal, vViewPos, depth, lightData, vSurfaceDiffuse, vSurfaceSpecular,
+								  fSpecularPower, vOutDiffuse, vOutSpecular);
+	}
+}
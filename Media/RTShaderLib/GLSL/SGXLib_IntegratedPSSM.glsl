@@ -46,6 +46,26 @@ STATIC vec3 pssm_lod_info = vec3(0.0, 0.0, 0.0);
 #define PCF_XSAMPLES 2.0
 #endif
 
+// exponential shadow maps, keep in sync with ShadowCasterExp.frag
+#ifndef ESM_EXPONENT
+#define ESM_EXPONENT 80.0
+#endif
+#ifndef EVSM_POSITIVE_EXPONENT
+#define EVSM_POSITIVE_EXPONENT 40.0
+#endif
+#ifndef EVSM_NEGATIVE_EXPONENT
+#define EVSM_NEGATIVE_EXPONENT 5.0
+#endif
+// minimum variance as a share of the warp slope and the cut off tail against light bleeding
+#define EVSM_DEPTH_SCALE 0.0001
+#define EVSM_BLEED_REDUCTION 0.2
+
+#if defined(PSSM_ESM) || defined(PSSM_EVSM)
+#define SGX_ShadowFilter SGX_ShadowExp
+#else
+#define SGX_ShadowFilter SGX_ShadowPCF4
+#endif
+
 //-----------------------------------------------------------------------------
 void SGX_ApplyShadowFactor_Diffuse(in vec4 ambient, 
 					  in vec4 lightSum, 
@@ -97,6 +117,50 @@ void SGX_ShadowPCF4(in SAMPLER_TYPE shadowMap, in vec4 shadowMapPos, in vec2 inv
 	c /= PCF_XSAMPLES * PCF_XSAMPLES;
 }
 
+//-----------------------------------------------------------------------------
+float chebyshevUpperBound(vec2 moments, float t, float minVariance)
+{
+	if (t <= moments.x)
+		return 1.0;
+	float variance = max(moments.y - moments.x * moments.x, minVariance);
+	float d = t - moments.x;
+	float p = variance / (variance + d * d);
+	return saturate((p - EVSM_BLEED_REDUCTION) / (1.0 - EVSM_BLEED_REDUCTION));
+}
+
+//-----------------------------------------------------------------------------
+// Single tap of a pre-filtered ESM or EVSM shadow map, see ShadowCasterExp.frag for the warps
+void SGX_ShadowExp(in sampler2D shadowMap, in vec4 shadowMapPos, in vec2 invTexSize, out float c)
+{
+	shadowMapPos = shadowMapPos / shadowMapPos.w;
+#if !defined(OGRE_REVERSED_Z) && !defined(OGRE_HLSL) && !defined(VULKAN)
+	shadowMapPos.z = shadowMapPos.z * 0.5 + 0.5; // convert -1..1 to 0..1
+#endif
+	vec2 uv = shadowMapPos.xy;
+	float depth = clamp(shadowMapPos.z, 0.0, 1.0);
+#ifdef OGRE_REVERSED_Z
+	depth = 1.0 - depth;
+#endif
+
+	// the texture is clamped, nothing casts outside of it
+	if (uv.x < 0.0 || uv.y < 0.0 || uv.x > 1.0 || uv.y > 1.0)
+	{
+		c = 1.0;
+		return;
+	}
+
+	vec4 moments = texture2D(shadowMap, uv);
+#ifdef PSSM_EVSM
+	float pos = exp(EVSM_POSITIVE_EXPONENT * (depth - 1.0));
+	float neg = 2.0 - exp(EVSM_NEGATIVE_EXPONENT * (1.0 - depth));
+	vec2 depthScale = EVSM_DEPTH_SCALE * vec2(EVSM_POSITIVE_EXPONENT * pos, EVSM_NEGATIVE_EXPONENT * (2.0 - neg));
+	c = min(chebyshevUpperBound(moments.xy, pos, depthScale.x * depthScale.x),
+			chebyshevUpperBound(moments.zw, neg, depthScale.y * depthScale.y));
+#else
+	c = saturate(moments.x * exp(-ESM_EXPONENT * (depth - 1.0)));
+#endif
+}
+
 //-----------------------------------------------------------------------------
 void SGX_ComputeShadowFactor_PSSM3(in float fDepth,
 							in vec4 vSplitPoints,	
@@ -132,7 +196,7 @@ void SGX_ComputeShadowFactor_PSSM3(in float fDepth,
 #ifdef PSSM_SAMPLE_COLOUR
 		oShadowFactor = texture2DProj(shadowMap0, lightPosition0).x;
 #else
-		SGX_ShadowPCF4(shadowMap0, lightPosition0, invShadowMapSize0, oShadowFactor);
+		SGX_ShadowFilter(shadowMap0, lightPosition0, invShadowMapSize0, oShadowFactor);
 #endif
 #ifdef DEBUG_PSSM
         pssm_lod_info.r = 1.0;
@@ -144,7 +208,7 @@ void SGX_ComputeShadowFactor_PSSM3(in float fDepth,
 #ifdef PSSM_SAMPLE_COLOUR
 		oShadowFactor = texture2DProj(shadowMap1, lightPosition1).x;
 #else
-		SGX_ShadowPCF4(shadowMap1, lightPosition1, invShadowMapSize1, oShadowFactor);
+		SGX_ShadowFilter(shadowMap1, lightPosition1, invShadowMapSize1, oShadowFactor);
 #endif
 #ifdef DEBUG_PSSM
         pssm_lod_info.g = 1.0;
@@ -157,7 +221,7 @@ void SGX_ComputeShadowFactor_PSSM3(in float fDepth,
 #ifdef PSSM_SAMPLE_COLOUR
 		oShadowFactor = texture2DProj(shadowMap2, lightPosition2).x;
 #else
-		SGX_ShadowPCF4(shadowMap2, lightPosition2, invShadowMapSize2, oShadowFactor);
+		SGX_ShadowFilter(shadowMap2, lightPosition2, invShadowMapSize2, oShadowFactor);
 #endif
 #ifdef DEBUG_PSSM
 		pssm_lod_info.r = 1.0;
@@ -170,7 +234,7 @@ void SGX_ComputeShadowFactor_PSSM3(in float fDepth,
 #ifdef PSSM_SAMPLE_COLOUR
 		oShadowFactor = texture2DProj(shadowMap3, lightPosition3).x;
 #else
-		SGX_ShadowPCF4(shadowMap3, lightPosition3, invShadowMapSize3, oShadowFactor);
+		SGX_ShadowFilter(shadowMap3, lightPosition3, invShadowMapSize3, oShadowFactor);
 #endif
 #ifdef DEBUG_PSSM
         pssm_lod_info.b = 1.0;
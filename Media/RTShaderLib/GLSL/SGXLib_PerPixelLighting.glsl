@@ -234,3 +234,98 @@ void SGX_Light_Spot_DiffuseSpecular(
 	}
 }
 
+
+//-----------------------------------------------------------------------------
+// Light of any type, as used by the uber shaders of RTSS. The type is
+// selected at runtime: vLightPos.w is 0 for directional lights and
+// vSpotParams.w is 0 for all but spot lights. Unused light slots are
+// black and do not contribute.
+//-----------------------------------------------------------------------------
+float SGX_Light_Generic_Factor(
+				    in vec3 vViewPos,
+				    in vec4 vLightPos,
+				    in vec3 vLightDirView,
+				    in vec4 vAttParams,
+				    in vec4 vSpotParams,
+				    out vec3 vLightView)
+{
+	if (vLightPos.w == 0.0)
+	{
+		vLightView = normalize(vLightPos.xyz);
+		return 1.0;
+	}
+
+	vLightView         = vLightPos.xyz - vViewPos;
+	float fLightD      = length(vLightView);
+	vLightView		   = normalize(vLightView);
+
+	if (fLightD > vAttParams.x)
+		return 0.0;
+
+	float fAtten	= 1.0 / (vAttParams.y + vAttParams.z*fLightD + vAttParams.w*fLightD*fLightD);
+	if (vSpotParams.w != 0.0)
+	{
+		float rho		= dot(-vLightDirView, vLightView);
+		float fSpotE	= clamp((rho - vSpotParams.y) / (vSpotParams.x - vSpotParams.y), 0.0, 1.0);
+		fAtten		   *= pow(fSpotE, vSpotParams.z);
+	}
+	return fAtten;
+}
+
+//-----------------------------------------------------------------------------
+void SGX_Light_Generic_Diffuse(
+				    in vec3 vNormal,
+				    in vec3 vViewPos,
+				    in vec4 vLightPos,
+				    in vec3 vLightDirView,
+				    in vec4 vAttParams,
+				    in vec4 vSpotParams,
+				    in vec3 vDiffuseColour, 
+				    inout vec3 vOut)
+{
+	vec3 vLightView;
+	float fAtten       = SGX_Light_Generic_Factor(vViewPos, vLightPos, vLightDirView, vAttParams, vSpotParams, vLightView);
+	vec3 vNormalView = normalize(vNormal);
+	float nDotL        = dot(vNormalView, vLightView);
+
+	if (nDotL > 0.0)
+	{
+		vOut += vDiffuseColour * nDotL * fAtten;
+        vOut = clamp(vOut, 0.0, 1.0);
+	}
+}
+
+//-----------------------------------------------------------------------------
+void SGX_Light_Generic_DiffuseSpecular(
+				    in vec3 vNormal,
+				    in vec3 vViewPos,
+				    in vec4 vLightPos,
+				    in vec3 vLightDirView,
+				    in vec4 vAttParams,
+				    in vec4 vSpotParams,
+				    in vec3 vDiffuseColour, 
+				    in vec3 vSpecularColour, 
+					in float fSpecularPower,
+					inout vec3 vOutDiffuse,
+					inout vec3 vOutSpecular)
+{
+	vec3 vLightView;
+	float fAtten       = SGX_Light_Generic_Factor(vViewPos, vLightPos, vLightDirView, vAttParams, vSpotParams, vLightView);
+	vec3 vNormalView = normalize(vNormal);
+	float nDotL        = dot(vNormalView, vLightView);
+
+	if (nDotL > 0.0)
+	{
+		vec3 vView       = -normalize(vViewPos);
+		vec3 vHalfWay    = normalize(vView + vLightView);
+		float nDotH        = dot(vNormalView, vHalfWay);
+
+		vOutDiffuse  += vDiffuseColour * nDotL * fAtten;
+#ifdef NORMALISED
+		vSpecularColour *= (fSpecularPower + 8.0)/(8.0 * M_PI);
+#endif
+		vOutSpecular += vSpecularColour * pow(clamp(nDotH, 0.0, 1.0), fSpecularPower) * fAtten;
+        vOutDiffuse = clamp(vOutDiffuse, 0.0, 1.0);
+        vOutSpecular = clamp(vOutSpecular, 0.0, 1.0);
+	}
+}
@@ -0,0 +1,9 @@
+/**
+ * Adds a splatted layer to the terrain colour
+ * @param scale: repetitions of the layer over the tile
+ * @param weight: channel of the splat map for the layer
+ */
+void blendTerrainLayer(sampler2D layer, vec2 uv, float scale, float weight, inout vec4 colour)
+{
+    colour += texture2D(layer, uv * scale) * weight;
+}
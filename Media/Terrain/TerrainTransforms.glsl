@@ -33,4 +33,48 @@ void expandVertex(mat4 idxToObjectSpace, float baseUVScale, vec2 idx, float heig
 {
     position = mul(idxToObjectSpace, vec4(idx, height, 1));
     uv = vec2(idx.x * baseUVScale, 1.0 - idx.y * baseUVScale);
-}
\ No newline at end of file
+}
+
+/**
+ * @param uv: tile coordinates, 0 to 1 over the tile
+ * @param samples: heights per side
+ * @return the coordinates of a texture holding one texel per height
+ */
+vec2 terrainTexelUV(vec2 uv, float samples)
+{
+    return (uv * (samples - 1.0) + 0.5) / samples;
+}
+
+/**
+ * Places a vertex of the shared grid on its CDLOD patch. Towards the end of the range of the
+ * patch level the odd vertices collapse onto their even neighbours, morphing to the next level.
+ * @param gridPos: grid coordinates, 0 to the grid size (vertex attribute)
+ * @param patch: minimum corner x/z, size and level of the patch (instance attribute)
+ * @param lodParams: range of the finest level, morph start as fraction of the range, grid size (uniform)
+ * @param tileParams: size of the tile, heights per side (uniform)
+ * @param uv: tile coordinates, 0 to 1 over the tile
+ */
+void expandCDLODVertex(sampler2D heightMap, vec3 eyePos, vec2 gridPos, vec4 patch, vec3 lodParams, vec2 tileParams,
+                       out vec4 position, out vec2 uv)
+{
+    float spacing = patch.z / lodParams.z;
+    vec2 pos = patch.xy + gridPos * spacing;
+    float height = texture2DLod(heightMap, terrainTexelUV(pos / tileParams.x, tileParams.y), 0.0).x;
+
+    float range = lodParams.x * exp2(patch.w);
+    float morphStart = range * lodParams.y;
+    float morph = clamp((distance(eyePos, vec3(pos.x, height, pos.y)) - morphStart) / (range - morphStart), 0.0, 1.0);
+    pos -= fract(gridPos * 0.5) * 2.0 * spacing * morph;
+
+    uv = pos / tileParams.x;
+    height = texture2DLod(heightMap, terrainTexelUV(uv, tileParams.y), 0.0).x;
+    position = vec4(pos.x, height, pos.y, 1.0);
+}
+
+/**
+ * @param normalMap: one texel per height, encoded as n * 0.5 + 0.5
+ */
+void sampleTerrainNormal(sampler2D normalMap, vec2 uv, vec2 tileParams, out vec3 normal)
+{
+    normal = normalize(texture2DLod(normalMap, terrainTexelUV(uv, tileParams.y), 0.0).xyz * 2.0 - 1.0);
+}
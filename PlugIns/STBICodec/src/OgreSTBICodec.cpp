@@ -44,6 +44,7 @@ module Ogre.PlugIns.STBICodec;
 
 import Ogre.Core;
 
+import <algorithm>;
 import <format>;
 import <memory>;
 import <ostream>;
@@ -51,11 +52,15 @@ import <string>;
 import <utility>;
 import <vector>;
 
+/// Level of the PNG being encoded on this thread, as the one of stb_image_write is global
+thread_local int tlsCompressionLevel = -1;
+
 extern "C" auto custom_zlib_compress(Ogre::uchar* data, int data_len, int* out_len, int /*quality*/) -> Ogre::uchar*
 {
     unsigned long destLen = compressBound(data_len);
     auto* dest = (Ogre::uchar*)malloc(destLen);
-    int ret = compress(dest, &destLen, data, data_len); // use default quality
+    int level = tlsCompressionLevel < 0 ? Z_DEFAULT_COMPRESSION : std::min(tlsCompressionLevel, 9);
+    int ret = compress2(dest, &destLen, data, data_len, level);
     if (ret != Z_OK)
     {
         free(dest);
@@ -137,6 +142,7 @@ namespace Ogre {
         int channels = (int)PixelUtil::getComponentCount(format);
         int stride = pImgData->width * (int)PixelUtil::getNumElemBytes(format);
         int len;
+        tlsCompressionLevel = pImgData->compressionLevel;
         uchar* data = stbi_write_png_to_mem(inputData, stride, pImgData->width, pImgData->height, channels, &len);
 
         if(tempData)
@@ -169,11 +175,27 @@ namespace Ogre {
     //---------------------------------------------------------------------
     auto STBIImageCodec::decode(const DataStreamPtr& input) const -> ImageCodec::DecodeResult
     {
-        String contents = input->getAsString();
-
+        // decode memory streams, e.g. memory mapped files, in place, and read others as needed,
+        // so that the encoded file is never copied. The pixels are handed to the Image as they are.
         int width, height, components;
-        stbi_uc* pixelData = stbi_load_from_memory((const uchar*)contents.data(),
-                static_cast<int>(contents.size()), &width, &height, &components, 0);
+        stbi_uc* pixelData;
+        if (auto memory = dynamic_cast<MemoryDataStream*>(input.get()))
+        {
+            const uchar* encoded = memory->getCurrentPtr();
+            size_t encodedSize = memory->size() - memory->tell();
+            memory->seek(memory->size());
+            pixelData = stbi_load_from_memory(encoded,
+                static_cast<int>(encodedSize), &width, &height, &components, 0);
+        }
+        else
+        {
+            stbi_io_callbacks callbacks;
+            callbacks.read = [](void* user, char* data, int size) -> int
+            { return static_cast<int>(static_cast<DataStream*>(user)->read(data, size)); };
+            callbacks.skip = [](void* user, int n) { static_cast<DataStream*>(user)->skip(n); };
+            callbacks.eof = [](void* user) -> int { return static_cast<DataStream*>(user)->eof(); };
+            pixelData = stbi_load_from_callbacks(&callbacks, input.get(), &width, &height, &components, 0);
+        }
 
         if (!pixelData)
         {
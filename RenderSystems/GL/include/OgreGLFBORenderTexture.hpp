@@ -72,7 +72,8 @@ namespace Ogre {
     class GLFBOManager: public GLRTTManager
     {
     public:
-        GLFBOManager(bool atimode);
+        /** @param floatDepth probe and prefer the float depth formats, for the reversed depth */
+        GLFBOManager(bool atimode, bool floatDepth = false);
         ~GLFBOManager() override;
         
         /** Bind a certain render target if it is a FBO. If it is not a FBO, bind the
@@ -106,6 +107,8 @@ namespace Ogre {
         
         /// Buggy ATI driver?
         bool mATIMode;
+        /// Float depth formats probed?
+        bool mFloatDepth;
         
         /** Detect allowed FBO formats */
         void detectFBOFormats();
@@ -52,7 +52,7 @@ public:
     /// Execute the unbinding functions for this program
     void unbindProgram() override;
     /// Execute the param binding functions for this program
-    void bindProgramParameters(GpuProgramParametersSharedPtr params, GpuParamVariability mask) override;
+    void bindProgramParameters(const GpuProgramParametersSharedPtr& params, GpuParamVariability mask) override;
 
     /// Get the assigned GL program id
     auto getProgramID() const noexcept -> GLuint
@@ -44,7 +44,7 @@ namespace Ogre {
         /// Execute the binding functions for this program
         virtual void unbindProgram() = 0;
         /// Execute the param binding functions for this program
-        virtual void bindProgramParameters(GpuProgramParametersSharedPtr params, GpuParamVariability mask) = 0;
+        virtual void bindProgramParameters(const GpuProgramParametersSharedPtr& params, GpuParamVariability mask) = 0;
         /// Test whether attribute index for a given semantic is valid
         virtual auto isAttributeValid(VertexElementSemantic semantic, uint index) -> bool;
     };
@@ -74,7 +74,7 @@ namespace Ogre {
         /// Execute the unbinding functions for this program
         void unbindProgram() override;
         /// Execute the param binding functions for this program
-        void bindProgramParameters(GpuProgramParametersSharedPtr params, Ogre::GpuParamVariability mask) override;
+        void bindProgramParameters(const GpuProgramParametersSharedPtr& params, Ogre::GpuParamVariability mask) override;
 
         /// Get the GL type for the program
         auto getProgramType() const -> GLenum;
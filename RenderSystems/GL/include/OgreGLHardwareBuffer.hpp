@@ -34,6 +34,8 @@ export module Ogre.RenderSystems.GL:HardwareBuffer;
 
 export import Ogre.Core;
 
+export import <memory>;
+
 export
 namespace Ogre {
 
@@ -50,8 +52,31 @@ namespace Ogre {
         size_t mScratchSize{0};
         void* mScratchPtr{nullptr};
         bool mScratchUploadOnUnlock{false};
+        /// Bytes written through the mapped buffer, reported on unlock
+        size_t mMappedUploadSize{0};
         GLRenderSystem* mRenderSystem;
 
+        /// Offset of the contents in the streaming ring buffer, if streamed
+        size_t mStreamingOffset;
+        /// Streaming generation the region was allocated in
+        uint32 mStreamingGeneration{0};
+        bool mLockedToStreaming{false};
+        /// CPU side copy written while locked to the streaming ring buffer
+        std::unique_ptr<uint8[]> mStreamingStaging;
+
+        /// Offset of the contents in a shared static buffer, if sub-allocated from one
+        size_t mPoolOffset;
+        bool mLockedToPool{false};
+        /// CPU side copy of the locked range of a sub-allocated buffer, which is never mapped
+        std::unique_ptr<uint8[]> mPoolStaging;
+
+        /// Whether the contents live in a region of the streaming ring buffer, which was not orphaned since
+        [[nodiscard]] auto isStreamed() const noexcept -> bool;
+        /// Stops streaming, uploading the staging copy to the storage of the buffer if keepContents is set
+        void leaveStreaming(bool keepContents);
+        /// Whether the contents live in a region of a shared static buffer
+        [[nodiscard]] auto isPooled() const noexcept -> bool;
+
     protected:
         /** See HardwareBuffer. */
         auto lockImpl(size_t offset, size_t length, LockOptions options) -> void* override;
@@ -68,7 +93,14 @@ namespace Ogre {
         /** See HardwareBuffer. */
         void _updateFromShadow() override;
 
-        [[nodiscard]] auto getGLBufferId() const noexcept -> GLuint { return mBufferId; }
+        /** Gets the GL buffer holding the contents, the streaming ring buffer if streamed.
+        @remarks
+            Restores the contents of buffers whose ring region was orphaned, so call this
+            before getGLBufferOffset.
+        */
+        [[nodiscard]] auto getGLBufferId() -> GLuint;
+        /// Gets the offset of the contents in the buffer returned by getGLBufferId
+        [[nodiscard]] auto getGLBufferOffset() const noexcept -> size_t;
     };
     using GLHardwareBuffer = GLHardwareVertexBuffer;
 
@@ -34,6 +34,9 @@ export module Ogre.RenderSystems.GL:HardwareBufferManager;
 
 export import Ogre.Core;
 
+export import <map>;
+export import <vector>;
+
 export
 namespace Ogre {
 
@@ -52,6 +55,26 @@ namespace Ogre {
         char* mScratchBufferPool{nullptr};
         size_t mMapBufferThreshold;
 
+        /// The ring buffer discardable dynamic buffers are streamed through
+        GLuint mStreamingBufferId{0};
+        size_t mStreamingBufferSize{0};
+        size_t mStreamingCapacity{0};
+        size_t mStreamingOffset{0};
+        uint32 mStreamingGeneration{0};
+
+        /// A shared buffer static buffers are sub-allocated from
+        struct StaticPool
+        {
+            GLenum target;
+            GLuint bufferId;
+            /// Free regions by offset, with their sizes
+            std::map<size_t, size_t> freeRegions;
+            /// Number of regions handed out
+            size_t allocations;
+        };
+        std::vector<StaticPool> mStaticPools;
+        size_t mStaticPoolSize{0};
+
     public:
         GLHardwareBufferManager();
         ~GLHardwareBufferManager() override;
@@ -88,5 +111,63 @@ namespace Ogre {
         */
         [[nodiscard]] auto getGLMapBufferThreshold() const -> size_t;
         void setGLMapBufferThreshold( const size_t value );
+
+        /// Returned by _allocateStreaming if the ring buffer can't take the region
+        static constexpr size_t NO_STREAMING = ~size_t(0);
+
+        /** Sets the size of the ring buffer which dynamic buffers are streamed through.
+        @remarks
+            Locking a buffer created with HardwareBufferUsage::CPU_ONLY (i.e. dynamic) using
+            LockOptions::DISCARD then sub-allocates a fresh region of one large buffer instead
+            of orphaning or mapping the storage of the buffer itself. The writes go to a CPU
+            side copy and are uploaded on unlock into a part of the ring no pending draw refers
+            to, so the driver does not have to synchronize. When the ring is full its storage is
+            orphaned, and buffers whose region was dropped that way move their contents back
+            into their own storage the next time they are used.
+        @par
+            The CPU side copy doubles the memory used by streamed buffers, but also serves
+            reads without a GPU round trip. Buffers with a shadow buffer are never streamed.
+        @param size Size in bytes, 0 (the default) disables streaming
+        */
+        void setStreamingBufferSize(size_t size);
+        [[nodiscard]] auto getStreamingBufferSize() const noexcept -> size_t { return mStreamingBufferSize; }
+
+        /** Sub-allocates a region of the streaming ring buffer.
+        @return The offset of the region, or NO_STREAMING
+        */
+        auto _allocateStreaming(size_t size) -> size_t;
+        /// Gets the GL name of the streaming ring buffer
+        [[nodiscard]] auto _getStreamingBufferId() const noexcept -> GLuint { return mStreamingBufferId; }
+        /// Gets the number of times the ring buffer storage was orphaned, invalidating the regions
+        [[nodiscard]] auto _getStreamingGeneration() const noexcept -> uint32 { return mStreamingGeneration; }
+
+        /// Returned by _allocateStatic if the buffer gets storage of its own
+        static constexpr size_t NO_POOL = ~size_t(0);
+
+        /** Sets the size of the shared buffers static geometry is sub-allocated from.
+        @remarks
+            Vertex and index buffers created with HardwareBufferUsage::GPU_ONLY (i.e. static) of
+            up to a quarter of this size then get a region of a large GL buffer shared with
+            others instead of a buffer object of their own. Thousands of small meshes so live in
+            a handful of buffer objects, and the draws of different meshes bind the same buffers,
+            which the state cache does not bind again.
+        @par
+            Regions are handed out first fit and merged when freed, an empty shared buffer is
+            deleted. Sub-allocated buffers are never mapped, their locks go through a CPU side
+            copy of the locked range. Changing the size affects the buffers created afterwards.
+        @param size Size in bytes, 0 (the default) disables sub-allocation
+        */
+        void setStaticBufferPoolSize(size_t size) { mStaticPoolSize = size; }
+        [[nodiscard]] auto getStaticBufferPoolSize() const noexcept -> size_t { return mStaticPoolSize; }
+
+        /** Sub-allocates a region of a shared static buffer.
+        @param target The binding target of the buffer
+        @param size Size of the region in bytes
+        @param bufferId Set to the GL name of the shared buffer
+        @return The offset of the region, or NO_POOL
+        */
+        auto _allocateStatic(GLenum target, size_t size, GLuint& bufferId) -> size_t;
+        /// Returns a region handed out by _allocateStatic
+        void _freeStatic(GLuint bufferId, size_t offset, size_t size);
     };
 }
@@ -54,8 +54,13 @@ namespace Ogre {
         void bindToFramebuffer(uint32 attachment, uint32 zoffset) override;
         /// @copydoc HardwarePixelBuffer::getRenderTarget
         auto getRenderTarget(size_t slice) -> RenderTexture*;
-        /// Upload a box of pixels to this buffer on the card
+        /** Upload a box of pixels to this buffer on the card
+        @remarks
+            May be deferred, see GLRenderSystem::setTextureUploadBudget.
+        */
         void upload(const PixelBox &data, const Box &dest) override;
+        /// Upload a box of pixels right away, from the bound pixel unpack buffer if any
+        void _uploadNow(const PixelBox &data, const Box &dest);
         /// Download a box of pixels from the card
         void download(const PixelBox &data) override;
   
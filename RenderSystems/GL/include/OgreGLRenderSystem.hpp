@@ -35,6 +35,8 @@ export module Ogre.RenderSystems.GL:RenderSystem;
 export import Ogre.Core;
 export import Ogre.RenderSystems.GLSupport;
 
+export import <deque>;
+export import <map>;
 export import <vector>;
 
 export
@@ -51,6 +53,7 @@ namespace Ogre {
     class GLGpuProgramManager;
     class GLStateCacheManager;
     class GLGpuProgramBase;
+    class GLTextureBuffer;
     /**
       Implementation of GL as a rendering system.
      */
@@ -117,6 +120,100 @@ namespace Ogre {
         std::vector<GLuint> mRenderAttribsBound;
         std::vector<GLuint> mRenderInstanceAttribsBound;
 
+        /** Description of the vertex arrays set up on the current context, so draws with the
+            same geometry and program can skip specifying them again */
+        std::vector<size_t> mVertexArraySignature;
+        std::vector<size_t> mVertexArraySignatureScratch;
+        bool mVertexArraysBound{false};
+        /// Number of texture units whose coordinate arrays may be enabled
+        ushort mNumTexCoordArraysBound{0};
+
+        /// Describes the vertex arrays the operation needs, see mVertexArraySignature
+        void buildVertexArraySignature(const RenderOperation& op, const HardwareVertexBufferSharedPtr& instanceBuffer,
+                                       const VertexDeclaration* instanceDeclaration, std::vector<size_t>& signature) const;
+        /// Disables the vertex arrays bound on the current context
+        void unbindVertexArrays();
+        /// Specifies the vertex arrays of the operation, unless they are still bound
+        void bindVertexArrays(const RenderOperation& op);
+        [[nodiscard]] auto getGLPrimitiveType(RenderOperation::OperationType operationType) const -> GLint;
+
+        /// A started readback, see _startReadback
+        struct PendingReadback
+        {
+            /// Pixel pack buffer the rows are read into, 0 if read into data
+            GLuint buffer{0};
+            std::vector<uchar> data;
+            /// Layout of the rows, which GL delivers bottom-up
+            PixelBox box;
+        };
+        std::map<uint32, PendingReadback> mPendingReadbacks;
+        /// Pixel pack buffers of finished readbacks, for reuse
+        std::vector<GLuint> mFreeReadbackBuffers;
+        uint32 mLastReadbackTicket{0};
+
+        /// A texture upload deferred by the upload budget, see setTextureUploadBudget
+        struct PendingTextureUpload
+        {
+            GLTextureBuffer* target;
+            /// Pixel unpack buffer holding the pixels
+            GLuint buffer;
+            /// Consecutive layout of the pixels, at offset 0 of the buffer
+            PixelBox data;
+            Box dest;
+        };
+        std::deque<PendingTextureUpload> mPendingTextureUploads;
+        /// Pixel unpack buffers of issued uploads, for reuse
+        std::vector<GLuint> mFreeUploadBuffers;
+        size_t mTextureUploadBudget{0};
+
+        void issueTextureUpload(const PendingTextureUpload& upload);
+
+        /// GL_ARB_timer_query entry points, which the loader does not provide
+        using QueryCounterProc = void (APIENTRYP)(GLuint id, GLenum target);
+        using GetQueryObjectui64vProc = void (APIENTRYP)(GLuint id, GLenum pname, GLuint64* params);
+        QueryCounterProc mQueryCounter{nullptr};
+        GetQueryObjectui64vProc mGetQueryObjectui64v{nullptr};
+
+        /// GL_ARB_sync entry points, which the loader does not provide
+        using FenceSyncProc = GLsync (APIENTRYP)(GLenum condition, GLbitfield flags);
+        using ClientWaitSyncProc = GLenum (APIENTRYP)(GLsync sync, GLbitfield flags, GLuint64 timeout);
+        using DeleteSyncProc = void (APIENTRYP)(GLsync sync);
+        FenceSyncProc mFenceSync{nullptr};
+        ClientWaitSyncProc mClientWaitSync{nullptr};
+        DeleteSyncProc mDeleteSync{nullptr};
+
+        /// GL_ARB_clip_control entry point, which the loader does not provide
+        using ClipControlProc = void (APIENTRYP)(GLenum origin, GLenum depth);
+        ClipControlProc mClipControl{nullptr};
+
+        /// Fences of the swapped frames the GPU may not have finished yet, oldest first
+        std::deque<GLsync> mFrameFences;
+        void releaseFrameFences();
+
+        /// A profile event timed on the GPU, see setProfileEventTiming
+        struct TimedProfileEvent
+        {
+            String name;
+            uint32 depth;
+            /// Timestamp queries, end is 0 until the event ended
+            GLuint begin;
+            GLuint end{0};
+        };
+        /// Timed events in the order they began, until their results are read
+        std::deque<TimedProfileEvent> mTimedProfileEvents;
+        /// Events which did not end yet, innermost last, @c nullptr for those not timed
+        std::vector<TimedProfileEvent*> mOpenProfileEvents;
+        /// Timestamp queries of read events, for reuse
+        std::vector<GLuint> mFreeTimerQueries;
+
+        auto allocateTimerQuery() -> GLuint;
+        /// Drops the pending timed events and their queries
+        void releaseTimerQueries();
+
+        /// Index counts and offsets of the operations merged by _renderMultiple
+        std::vector<GLsizei> mMultiDrawCounts;
+        std::vector<const void*> mMultiDrawIndices;
+
         /// is fixed pipeline enabled
         bool mEnableFixedPipeline;
 
@@ -130,6 +227,8 @@ namespace Ogre {
             established.
         */
         void initialiseExtensions();
+        /// Sets what depends on the context rather than the device, also on cached capabilities
+        void setContextCapabilities(RenderSystemCapabilities* rsc) const;
     public:
         // Default constructor / destructor
         GLRenderSystem();
@@ -243,6 +342,9 @@ namespace Ogre {
 
         void _render(const RenderOperation& op) override;
 
+        void _prelinkGpuPrograms(const Pass* pass) override;
+        void _renderMultiple(std::span<const RenderOperation* const> ops) override;
+
         void bindGpuProgram(GpuProgram* prg) override;
 
         void unbindGpuProgram(GpuProgramType gptype) override;
@@ -263,6 +365,11 @@ namespace Ogre {
         /** Switch GL context, dealing with involved internal cached states too
         */
         void _switchContext(GLContext *context);
+        /** Makes the next draw specify all vertex arrays again.
+            @note Called when a GL buffer is deleted, as its name may be reused while the
+            arrays still refer to the deleted buffer.
+        */
+        void _invalidateVertexArrays() { mVertexArraySignature.clear(); }
         /**
          * Set current render target to target, enabling its GL context if needed
          */
@@ -276,7 +383,47 @@ namespace Ogre {
          */
         void _unregisterContext(GLContext *context) override;
 
-        auto _getStateCacheManager() noexcept -> GLStateCacheManager * { return mStateCacheManager; }
+        /** Gets the state cache of the calling thread's context
+        @remarks
+            Background threads set up by registerThread use the cache of their own
+            context, all other threads the one of the current context.
+        */
+        auto _getStateCacheManager() noexcept -> GLStateCacheManager *;
+
+        /** @copydoc RenderSystem::_finishThreadWork
+        @note Waits on a fence with GL 3.2 or GL_ARB_sync, otherwise uses glFinish.
+        */
+        void _finishThreadWork() override;
+
+        /** @copydoc RenderSystem::_swapAllRenderTargetBuffers
+        @note Fences the frame with GL 3.2 or GL_ARB_sync, to track the frames in flight.
+        */
+        void _swapAllRenderTargetBuffers() override;
+
+        void _waitForFramesInFlight(uint32 frames) override;
+
+        /** Sets how many bytes of texture data may be copied into textures per frame.
+        @remarks
+            With a budget, texture uploads are staged in pixel unpack buffers and the
+            copies into the textures are issued at the end of the frames, as many as fit
+            into the budget but at least one per frame. This spreads the cost of streaming
+            many textures in over several frames, at the price of textures showing their
+            previous contents until their copies are issued. Reading from or rendering to
+            a texture issues its pending copies first.
+        @par
+            The default of 0 uploads right away. Requires GL_ARB_pixel_buffer_object.
+        */
+        void setTextureUploadBudget(size_t bytesPerFrame);
+        [[nodiscard]] auto getTextureUploadBudget() const noexcept -> size_t { return mTextureUploadBudget; }
+        /** Stages an upload for later, see setTextureUploadBudget
+        @return false if the upload must be done right away
+        */
+        auto _queueTextureUpload(GLTextureBuffer* target, const PixelBox& data, const Box& dest) -> bool;
+        /** Issues the staged uploads of the given buffer, or as many uploads as fit into the
+            budget if @c nullptr */
+        void _flushTextureUploads(GLTextureBuffer* target = nullptr);
+        /// Drops the staged uploads of a buffer which is destroyed
+        void _discardTextureUploads(GLTextureBuffer* target);
         
         /// @copydoc RenderSystem::beginProfileEvent
         void beginProfileEvent( std::string_view eventName ) override;
@@ -287,8 +434,16 @@ namespace Ogre {
         /// @copydoc RenderSystem::markProfileEvent
         void markProfileEvent( std::string_view eventName ) override;
 
+        /** @copydoc RenderSystem::setProfileEventTiming
+        @note Requires GL 3.3 or GL_ARB_timer_query, events are only timed on the main context.
+        */
+        void setProfileEventTiming(bool enabled) override;
+        void _getProfileEventTimings(ProfileEventTimings& timings) override;
+
         /** @copydoc RenderTarget::copyContentsToMemory */
         void _copyContentsToMemory(Viewport* vp, const Box& src, const PixelBox &dst, RenderWindow::FrameBuffer buffer) override;
+        auto _startReadback(Viewport* vp, const Box& src, PixelFormat format, RenderWindow::FrameBuffer buffer) -> uint32 override;
+        void _finishReadback(uint32 ticket, const PixelBox& dst, bool bottomUp) override;
     };
     /** @} */
     /** @} */
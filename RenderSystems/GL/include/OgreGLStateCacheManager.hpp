@@ -37,6 +37,7 @@ export import Ogre.RenderSystems.GLSupport;
 
 export import <set>;
 export import <unordered_map>;
+export import <vector>;
 
 export
 namespace Ogre
@@ -47,6 +48,8 @@ namespace Ogre
         struct TextureUnitParams
         {
             TexParameteriMap mTexParameteriMap;
+            /// Sampler::getHash of the sampler the parameters were set from, 0 if unknown
+            uint32 mSamplerHash{0};
         };
 
         using TexUnitsMap = std::unordered_map<GLuint, TextureUnitParams>;
@@ -56,8 +59,13 @@ namespace Ogre
          which is especially important on mobile or embedded systems.
          */
 
-        /// Stores textures currently bound to each texture stage
-        std::unordered_map <GLenum, GLuint> mBoundTextures;
+        struct BoundTexture
+        {
+            GLenum target{0};
+            GLuint texture{0};
+        };
+        /// Stores the texture last bound to each texture stage, no entry if unknown
+        std::unordered_map <size_t, BoundTexture> mBoundTextures;
 
         struct TexGenParams
         {
@@ -72,6 +80,8 @@ namespace Ogre
         GLenum mPolygonMode;
         /// Stores the last bound texture id
         GLuint mLastBoundTexID;
+        /// Stores the framebuffer object bound to both framebuffer targets
+        GLuint mBoundFrameBuffer;
 
         GLenum mShadeModel;
 
@@ -86,6 +96,54 @@ namespace Ogre
         GLfloat mPointSize;
         GLfloat mPointSizeMin;
         GLfloat mPointSizeMax;
+
+        /// The deferrable state, as last issued to GL
+        struct AppliedState
+        {
+            /// Enabled flags, no entry if unknown
+            std::unordered_map<GLenum, bool> enabled;
+            GLenum blendEquation[2];
+            GLenum blendFunc[4];
+            GLenum depthFunc;
+            GLenum cullFace;
+            GLboolean colourMask[4];
+            GLboolean depthMask;
+        };
+        AppliedState mApplied;
+
+        /// Deferrable state requested but not yet flushed
+        enum DirtyState : uint8
+        {
+            DIRTY_BLEND_EQUATION = 1 << 0,
+            DIRTY_BLEND_FUNC = 1 << 1,
+            DIRTY_DEPTH_FUNC = 1 << 2,
+            DIRTY_DEPTH_MASK = 1 << 3,
+            DIRTY_COLOUR_MASK = 1 << 4,
+            DIRTY_CULL_FACE = 1 << 5
+        };
+        uint8 mDirtyState{0};
+        /// Enabled flags requested but not yet flushed
+        std::unordered_map<GLenum, bool> mPendingEnables;
+
+        bool mDeferStateChanges{false};
+        size_t mStateChangesRequested{0};
+        size_t mStateChangesIssued{0};
+
+        /// Saved by pushAttrib
+        struct SavedState
+        {
+            AppliedState applied;
+            bool deferStateChanges;
+        };
+        std::vector<SavedState> mSavedStates;
+
+        void applyEnabled(GLenum flag, bool enabled);
+        void applyBlendEquation();
+        void applyBlendFunc();
+        void applyDepthFunc();
+        void applyDepthMask();
+        void applyColourMask();
+        void applyCullFace();
     public:
         GLStateCacheManager();
         
@@ -103,6 +161,19 @@ namespace Ogre
          */
         void bindGLBuffer(GLenum target, GLuint buffer, bool force = false);
 
+        /** Bind an OpenGL framebuffer object to both the draw and read framebuffer targets.
+         @remarks
+            Skipped if the framebuffer is bound already, so switching back and forth
+            between render targets only binds on actual changes.
+         @param fb The framebuffer ID, 0 for the window system provided framebuffer.
+         @param force Optional parameter to force an update, e.g. after binding the
+            targets separately.
+         */
+        void bindGLFrameBuffer(GLuint fb, bool force = false);
+
+        /// Gets the framebuffer object bound with bindGLFrameBuffer
+        [[nodiscard]] auto getBoundFrameBuffer() const noexcept -> GLuint { return mBoundFrameBuffer; }
+
         /** Delete an OpenGL buffer of any type.
          @param target The buffer target.
          @param buffer The buffer ID.
@@ -120,6 +191,12 @@ namespace Ogre
          */
         void invalidateStateForTexture(GLuint texture);
 
+        /** Forgets the texture bindings, after they were changed bypassing the cache.
+         @remarks
+            E.g. after glPopAttrib restored them. The active texture unit is set again.
+         */
+        void invalidateTextureBindings();
+
         /** Sets an integer parameter value per texture target.
          @param target The texture target.
          @param pname The parameter name.
@@ -127,6 +204,58 @@ namespace Ogre
          */
         void setTexParameteri(GLenum target, GLenum pname, GLint param);
 
+        /** Gets the sampler the parameters of the texture bound to the active unit were
+            set from.
+         @return The Sampler::getHash value passed to setTexSamplerHash, 0 if parameters
+            were changed since or are unknown.
+         */
+        [[nodiscard]] auto getTexSamplerHash() const -> uint32;
+
+        /** Records that the parameters of the texture bound to the active unit were set
+            from the given sampler, so that binding it again can skip setting them.
+         @param hash The Sampler::getHash value.
+         */
+        void setTexSamplerHash(uint32 hash);
+
+        /** Defers the state changes which only affect drawing.
+         @remarks
+            While deferred, setEnabled, setBlendEquation, setBlendFunc, setDepthFunc,
+            setDepthMask, setColourMask and setCullFace only record the requested state.
+            flushDeferredState then issues the calls for the state which differs from
+            what was last issued, so state toggled and restored between two draws
+            causes no GL calls at all. Disabling the mode flushes.
+         @note
+            Anything consuming this state, e.g. draw calls, glClear or framebuffer
+            blits, must call flushDeferredState first.
+         */
+        void setDeferStateChanges(bool defer);
+        [[nodiscard]] auto getDeferStateChanges() const noexcept -> bool { return mDeferStateChanges; }
+
+        /** Issues the deferred state changes which differ from the current GL state.
+         */
+        void flushDeferredState();
+
+        /** Flushes and saves the state with glPushAttrib, deferring no changes until popAttrib.
+         @param mask The attribute groups, see glPushAttrib.
+         */
+        void pushAttrib(GLbitfield mask);
+
+        /** Restores the state with glPopAttrib, along with the cached values.
+         @remarks
+            The texture bindings are forgotten, as with invalidateTextureBindings.
+         */
+        void popAttrib();
+
+        /// Gets the number of deferrable state changes requested so far
+        [[nodiscard]] auto getStateChangesRequested() const noexcept -> size_t { return mStateChangesRequested; }
+        /// Gets the number of GL calls issued for deferrable state changes so far
+        [[nodiscard]] auto getStateChangesIssued() const noexcept -> size_t { return mStateChangesIssued; }
+        /// Gets the number of deferrable state changes which needed no GL call so far
+        [[nodiscard]] auto getStateChangesFiltered() const noexcept -> size_t
+        {
+            return mStateChangesRequested - mStateChangesIssued;
+        }
+
         /** Activate an OpenGL texture unit.
          @param unit The texture unit to activate.
          @return Whether or not the texture unit was successfully activated.
@@ -56,6 +56,8 @@ namespace Ogre {
         void createInternalResourcesImpl() override;
         /// @copydoc Texture::freeInternalResourcesImpl
         void freeInternalResourcesImpl() override;
+        /// @copydoc Texture::setMostDetailedMipImpl
+        auto setMostDetailedMipImpl(uint32 mip) -> bool override;
 
         /** internal method, create GLHardwarePixelBuffers for every face and
              mipmap level. This method must be called after the GL texture object was created,
@@ -59,8 +59,19 @@ namespace Ogre {
         /// Custom attribute bindings
         AttributeSet mValidAttributes;
 
+        /// glLinkProgram was called, but the status was not queried yet
+        bool mLinkPending{false};
+        /// startLink was called, but the uniforms and attributes were not extracted yet
+        bool mSetupPending{false};
+        /// The binary came from the microcode cache
+        bool mLinkedFromCache{false};
+
         /// Compiles and links the the vertex and fragment programs
         void compileAndLink() override;
+        /// Attaches the shaders and issues the link, without waiting for it
+        void startCompileAndLink();
+        /// Queries the link status and puts the linked binary in the microcode cache
+        void finishCompileAndLink();
         /// Get the the binary data of a program from the microcode cache
         void getMicrocodeFromCache(uint32 id);
     public:
@@ -73,12 +84,26 @@ namespace Ogre {
         */
         void activate() override;
 
+        /** Issues the link of the program object, unless it is linked already.
+        @remarks
+            Uses the microcode cache if possible. The link status is not queried, so drivers
+            which compile and link in the background are not waited for until link() or
+            activate() is called.
+        */
+        void startLink();
+
+        /** Links the program object, unless it is linked already.
+        @remarks
+            Completes a link issued by startLink. Does not put the program in use.
+        */
+        void link();
+
         auto isAttributeValid(VertexElementSemantic semantic, uint index) -> bool;
         
         /** Updates program object uniforms using data from GpuProgramParameters.
         normally called by GLSLGpuProgram::bindParameters() just before rendering occurs.
         */
-        void updateUniforms(GpuProgramParametersSharedPtr params, GpuParamVariability mask, GpuProgramType fromProgType) override;
+        void updateUniforms(const GpuProgramParametersSharedPtr& params, GpuParamVariability mask, GpuProgramType fromProgType) override;
 
         /// Get the GL Handle for the program object
         [[nodiscard]] auto getGLHandle() const noexcept -> uint { return mGLProgramHandle; }
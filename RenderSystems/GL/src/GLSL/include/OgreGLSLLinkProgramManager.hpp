@@ -39,6 +39,9 @@ namespace Ogre::GLSL {
     private:
         GLSLLinkProgram* mActiveLinkProgram{nullptr};
 
+        /// Key of the link program of the given shaders in mPrograms, 0 if there are none
+        static auto getProgramKey(const GLShaderList& shaders) -> uint32;
+
         /// Find where the data for a specific uniform should come from, populate
         static auto completeParamSource(std::string_view paramName,
             const GpuConstantDefinitionMap* vertexConstantDefs, 
@@ -57,6 +60,18 @@ namespace Ogre::GLSL {
         */
         auto getActiveLinkProgram() noexcept -> GLSLLinkProgram*;
 
+        /** Links the program object of the given shader combination ahead of its first use.
+        @remarks
+            Linking when the combination is first drawn causes a hitch. This only issues the
+            link, see GLSLLinkProgram::startLink, so drivers linking in the background work on
+            all prelinked combinations while loading continues. With
+            GpuProgramManager::setSaveMicrocodesToCache enabled, the linked binaries are put in
+            the microcode cache once used, so a cache saved once can be shipped and later runs
+            skip the link.
+        @return The link program, @c nullptr if there are no shaders
+        */
+        auto prelinkProgram(const GLShaderList& shaders) -> GLSLLinkProgram*;
+
         /** Set the active fragment shader for the next rendering state.
             The active program object will be cleared.
             Normally called from the GLSLGpuProgram::bindProgram and unbindProgram methods
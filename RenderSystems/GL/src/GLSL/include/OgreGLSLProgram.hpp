@@ -103,7 +103,7 @@ namespace Ogre {
 
         void bindProgram() override;
         void unbindProgram() override;
-        void bindProgramParameters(GpuProgramParametersSharedPtr params, GpuParamVariability mask) override;
+        void bindProgramParameters(const GpuProgramParametersSharedPtr& params, GpuParamVariability mask) override;
         auto isAttributeValid(VertexElementSemantic semantic, uint index) -> bool override;
     protected:
         void loadFromSource() override;
@@ -100,34 +100,8 @@ namespace Ogre::GLSL {
     //-----------------------------------------------------------------------
     void GLSLLinkProgram::activate()
     {
-        if (!mLinked)
-        {           
-            glGetError(); //Clean up the error. Otherwise will flood log.
-
-            mGLProgramHandle = (size_t)glCreateProgramObjectARB();
-
-            GLenum glErr = glGetError();
-            if(glErr != GL_NO_ERROR)
-            {
-                reportGLSLError( glErr, "GLSLLinkProgram::activate", "Error Creating GLSL Program Object", 0 );
-            }
-
-            uint32 hash = getCombinedHash();
-
-            if ( GpuProgramManager::getSingleton().canGetCompiledShaderBuffer() &&
-                 GpuProgramManager::getSingleton().isMicrocodeAvailableInCache(hash) &&
-                 !mShaders[std::to_underlying(GpuProgramType::GEOMETRY_PROGRAM)])
-            {
-                getMicrocodeFromCache(hash);
-            }
-            else
-            {
-                compileAndLink();
+        link();
 
-            }
-            buildGLUniformReferences();
-            extractAttributes();
-        }
         if (mLinked)
         {
             glUseProgramObjectARB( (GLhandleARB)mGLProgramHandle );
@@ -141,6 +115,53 @@ namespace Ogre::GLSL {
         }
     }
     //-----------------------------------------------------------------------
+    void GLSLLinkProgram::startLink()
+    {
+        if (mLinked || mSetupPending)
+            return;
+
+        ShaderTelemetry::Scope telemetry{ShaderTelemetry::EventType::LINK, getCombinedName()};
+        glGetError(); //Clean up the error. Otherwise will flood log.
+
+        mGLProgramHandle = (size_t)glCreateProgramObjectARB();
+
+        GLenum glErr = glGetError();
+        if(glErr != GL_NO_ERROR)
+        {
+            reportGLSLError( glErr, "GLSLLinkProgram::activate", "Error Creating GLSL Program Object", 0 );
+        }
+
+        uint32 hash = getCombinedHash();
+
+        if ( GpuProgramManager::getSingleton().canGetCompiledShaderBuffer() &&
+             GpuProgramManager::getSingleton().isMicrocodeAvailableInCache(hash) &&
+             !mShaders[std::to_underlying(GpuProgramType::GEOMETRY_PROGRAM)])
+        {
+            getMicrocodeFromCache(hash);
+        }
+        else
+        {
+            startCompileAndLink();
+        }
+        telemetry.setCacheHit(mLinkedFromCache);
+        mSetupPending = true;
+    }
+    //-----------------------------------------------------------------------
+    void GLSLLinkProgram::link()
+    {
+        startLink();
+        if (!mSetupPending)
+            return;
+
+        // recorded apart from startLink, which may have run a while before
+        ShaderTelemetry::Scope telemetry{ShaderTelemetry::EventType::LINK, getCombinedName()};
+        telemetry.setCacheHit(mLinkedFromCache);
+        mSetupPending = false;
+        finishCompileAndLink();
+        buildGLUniformReferences();
+        extractAttributes();
+    }
+    //-----------------------------------------------------------------------
     void GLSLLinkProgram::getMicrocodeFromCache(uint32 id)
     {
         GpuProgramManager::Microcode cacheMicrocode = 
@@ -156,6 +177,7 @@ namespace Ogre::GLSL {
                         );
 
         glGetProgramiv(mGLProgramHandle, GL_LINK_STATUS, &mLinked);
+        mLinkedFromCache = mLinked;
         if (!mLinked)
         {
             //
@@ -224,7 +246,7 @@ namespace Ogre::GLSL {
     }
 
     //-----------------------------------------------------------------------
-    void GLSLLinkProgram::updateUniforms(GpuProgramParametersSharedPtr params, 
+    void GLSLLinkProgram::updateUniforms(const GpuProgramParametersSharedPtr& params, 
         GpuParamVariability mask, GpuProgramType fromProgType)
     {
         // iterate through uniform reference list and update uniform values
@@ -363,7 +385,12 @@ namespace Ogre::GLSL {
     //-----------------------------------------------------------------------
     void GLSLLinkProgram::compileAndLink()
     {
-        uint32 hash = 0;
+        startCompileAndLink();
+        finishCompileAndLink();
+    }
+    //-----------------------------------------------------------------------
+    void GLSLLinkProgram::startCompileAndLink()
+    {
         if (mShaders[std::to_underlying(GpuProgramType::VERTEX_PROGRAM)])
         {
             // attach Vertex Program
@@ -381,7 +408,6 @@ namespace Ogre::GLSL {
             size_t numAttribs = sizeof(msCustomAttributes)/sizeof(CustomAttribute);
             std::string_view vpSource = mShaders[std::to_underlying(GpuProgramType::VERTEX_PROGRAM)]->getSource();
             
-            hash = mShaders[std::to_underlying(GpuProgramType::VERTEX_PROGRAM)]->_getHash(hash);
             for (size_t i = 0; i < numAttribs; ++i)
             {
                 const CustomAttribute& a = msCustomAttributes[i];
@@ -417,7 +443,6 @@ namespace Ogre::GLSL {
 
         if (auto gshader = static_cast<GLSLProgram*>(mShaders[std::to_underlying(GpuProgramType::GEOMETRY_PROGRAM)]))
         {
-            hash = mShaders[std::to_underlying(GpuProgramType::GEOMETRY_PROGRAM)]->_getHash(hash);
             // attach Geometry Program
             mShaders[std::to_underlying(GpuProgramType::GEOMETRY_PROGRAM)]->attachToProgramObject(mGLProgramHandle);
 
@@ -438,15 +463,23 @@ namespace Ogre::GLSL {
 
         if (mShaders[std::to_underlying(GpuProgramType::FRAGMENT_PROGRAM)])
         {
-            hash = mShaders[std::to_underlying(GpuProgramType::FRAGMENT_PROGRAM)]->_getHash(hash);
             // attach Fragment Program
             mShaders[std::to_underlying(GpuProgramType::FRAGMENT_PROGRAM)]->attachToProgramObject(mGLProgramHandle);
         }
 
         
-        // now the link
+        // now the link, the driver may carry it out in the background until the status is queried
 
         glLinkProgramARB( (GLhandleARB)mGLProgramHandle );
+        mLinkPending = true;
+    }
+    //-----------------------------------------------------------------------
+    void GLSLLinkProgram::finishCompileAndLink()
+    {
+        if (!mLinkPending)
+            return;
+        mLinkPending = false;
+
         glGetObjectParameterivARB( (GLhandleARB)mGLProgramHandle, GL_OBJECT_LINK_STATUS_ARB, &mLinked );
 
         // force logging and raise exception if not linked
@@ -488,7 +521,7 @@ namespace Ogre::GLSL {
                 memcpy(newMicrocode->getPtr(), &binaryFormat, sizeof(GLenum));
 
                 // add to the microcode to the cache
-                GpuProgramManager::getSingleton().addMicrocodeToCache(hash, newMicrocode);
+                GpuProgramManager::getSingleton().addMicrocodeToCache(getCombinedHash(), newMicrocode);
             }
         }
     }
@@ -41,6 +41,7 @@ import Ogre.Core;
 import Ogre.RenderSystems.GLSupport;
 
 import <map>;
+import <memory>;
 import <utility>;
 
 namespace Ogre {
@@ -77,12 +78,7 @@ namespace Ogre {
 
         // no active link program so find one or make a new one
         // is there an active key?
-        uint32 activeKey = 0;
-        for(auto shader : mActiveShader)
-        {
-            if(!shader) continue;
-            activeKey = HashCombine(activeKey, shader->getShaderID());
-        }
+        uint32 activeKey = getProgramKey(mActiveShader);
 
         // only return a link program object if a vertex, geometry or fragment program exist
         if (activeKey > 0)
@@ -108,6 +104,32 @@ namespace Ogre {
 
     }
 
+    //-----------------------------------------------------------------------
+    auto GLSLLinkProgramManager::getProgramKey(const GLShaderList& shaders) -> uint32
+    {
+        uint32 key = 0;
+        for(auto shader : shaders)
+        {
+            if(!shader) continue;
+            key = HashCombine(key, shader->getShaderID());
+        }
+        return key;
+    }
+    //-----------------------------------------------------------------------
+    auto GLSLLinkProgramManager::prelinkProgram(const GLShaderList& shaders) -> GLSLLinkProgram*
+    {
+        uint32 key = getProgramKey(shaders);
+        if (key == 0)
+            return nullptr;
+
+        auto& program = mPrograms[key];
+        if (!program)
+            program = ::std::make_unique<GLSLLinkProgram>(shaders);
+
+        auto* linkProgram = static_cast<GLSLLinkProgram*>(program.get());
+        linkProgram->startLink();
+        return linkProgram;
+    }
     //-----------------------------------------------------------------------
     void GLSLLinkProgramManager::setActiveShader(GpuProgramType type, GLSLProgram* gpuProgram)
     {
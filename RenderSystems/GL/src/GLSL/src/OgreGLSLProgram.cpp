@@ -378,7 +378,7 @@ namespace Ogre {
     }
 
     //-----------------------------------------------------------------------------
-    void GLSLProgram::bindProgramParameters(GpuProgramParametersSharedPtr params, GpuParamVariability mask)
+    void GLSLProgram::bindProgramParameters(const GpuProgramParametersSharedPtr& params, GpuParamVariability mask)
     {
         // link can throw exceptions, ignore them at this point
         try
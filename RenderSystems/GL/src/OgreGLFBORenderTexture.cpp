@@ -35,6 +35,8 @@ module Ogre.RenderSystems.GL;
 import :FBORenderTexture;
 import :HardwarePixelBuffer;
 import :PixelFormat;
+import :RenderSystem;
+import :StateCacheManager;
 
 import Ogre.Core;
 import Ogre.RenderSystems.GLSupport;
@@ -131,16 +133,27 @@ static const GLenum constexpr depthFormats[] =
     GL_DEPTH_COMPONENT16,
     GL_DEPTH_COMPONENT24,    // Prefer 24 bit depth
     GL_DEPTH_COMPONENT32,
-    GL_DEPTH24_STENCIL8_EXT // packed depth / stencil
+    GL_DEPTH24_STENCIL8_EXT, // packed depth / stencil
+    GL_DEPTH_COMPONENT32F,   // float, only probed for the reversed depth
+    GL_DEPTH32F_STENCIL8     // packed float depth / stencil
 };
 static const uchar constexpr depthBits[] =
 {
-    0,16,24,32,24
+    0,16,24,32,24,32,32
 };
 #define DEPTHFORMAT_COUNT (sizeof(depthFormats)/sizeof(GLenum))
 
-    GLFBOManager::GLFBOManager(bool atimode):
-        mATIMode(atimode)
+static constexpr auto isPackedDepthStencil(GLenum format) -> bool
+{
+    return format == GL_DEPTH24_STENCIL8_EXT || format == GL_DEPTH32F_STENCIL8;
+}
+static constexpr auto isFloatDepth(GLenum format) -> bool
+{
+    return format == GL_DEPTH_COMPONENT32F || format == GL_DEPTH32F_STENCIL8;
+}
+
+    GLFBOManager::GLFBOManager(bool atimode, bool floatDepth):
+        mATIMode(atimode), mFloatDepth(floatDepth)
     {
         detectFBOFormats();
         
@@ -347,7 +360,10 @@ static const uchar constexpr depthBits[] =
                 // For each depth/stencil formats
                 for (uchar depth = 0; depth < DEPTHFORMAT_COUNT; ++depth)
                 {
-                    if (depthFormats[depth] != GL_DEPTH24_STENCIL8_EXT)
+                    if (isFloatDepth(depthFormats[depth]) && !mFloatDepth)
+                        continue;
+
+                    if (!isPackedDepthStencil(depthFormats[depth]))
                     {
                         // General depth/stencil combination
 
@@ -362,7 +378,8 @@ static const uchar constexpr depthBits[] =
                             if (_tryFormat(depthFormats[depth], stencilFormats[stencil]))
                             {
                                 /// Add mode to allowed modes
-                                str << std::format("D{}S{} ", depthBits[depth], stencilBits[stencil]);
+                                str << std::format("D{}{}S{} ", depthBits[depth],
+                                                   isFloatDepth(depthFormats[depth]) ? "F" : "", stencilBits[stencil]);
                                 FormatProperties::Mode mode;
                                 mode.depth = depth;
                                 mode.stencil = stencil;
@@ -389,7 +406,8 @@ static const uchar constexpr depthBits[] =
                         if (_tryPackedFormat(depthFormats[depth]))
                         {
                             /// Add mode to allowed modes
-                            str << "Packed-D" << int(depthBits[depth]) << "S8";
+                            str << "Packed-D" << int(depthBits[depth])
+                                << (isFloatDepth(depthFormats[depth]) ? "F" : "") << "S8 ";
                             FormatProperties::Mode mode;
                             mode.depth = depth;
                             mode.stencil = 0;   // unuse
@@ -465,8 +483,10 @@ static const uchar constexpr depthBits[] =
                 desirability += 2000;
             if(depthBits[props.modes[mode].depth]==24) // Prefer 24 bit for now
                 desirability += 500;
-            if((depthFormats[props.modes[mode].depth]==GL_DEPTH24_STENCIL8_EXT) && !requestDepthOnly) // Prefer 24/8 packed
+            if(isPackedDepthStencil(depthFormats[props.modes[mode].depth]) && !requestDepthOnly) // Prefer packed
                 desirability += 5000;
+            if(isFloatDepth(depthFormats[props.modes[mode].depth])) // Only probed to be preferred
+                desirability += 10000;
             desirability += stencilBits[props.modes[mode].stencil] + depthBits[props.modes[mode].depth];
             
             if(desirability>bestscore)
@@ -493,7 +513,8 @@ static const uchar constexpr depthBits[] =
             fbo->bind(true);
         else
             // Old style context (window/pbuffer) or copying render texture
-            glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, 0);
+            static_cast<GLRenderSystem*>(Root::getSingleton().getRenderSystem())
+                ->_getStateCacheManager()->bindGLFrameBuffer(0);
     }
     
     auto GLFBOManager::requestRenderBuffer(GLenum format, uint32 width, uint32 height, uint fsaa) -> GLSurfaceDesc
@@ -33,6 +33,8 @@ module Ogre.RenderSystems.GL;
 
 import :FBORenderTexture;
 import :FrameBufferObject;
+import :RenderSystem;
+import :StateCacheManager;
 
 import Ogre.Core;
 import Ogre.RenderSystems.GLSupport;
@@ -41,6 +43,13 @@ import <algorithm>;
 import <ostream>;
 
 namespace Ogre {
+    namespace {
+        auto getStateCacheManager() -> GLStateCacheManager*
+        {
+            auto rs = static_cast<GLRenderSystem*>(Root::getSingleton().getRenderSystem());
+            return rs ? rs->_getStateCacheManager() : nullptr;
+        }
+    }
 //-----------------------------------------------------------------------------
     GLFrameBufferObject::GLFrameBufferObject(GLFBOManager *manager, uint fsaa):
         GLFrameBufferObjectCommon(fsaa), mManager(manager)
@@ -75,9 +84,17 @@ namespace Ogre {
         mManager->releaseRenderBuffer(mStencil);
         mManager->releaseRenderBuffer(mMultisampleColourBuffer);
         // Delete framebuffer object
-        glDeleteFramebuffersEXT(1, &mFB);        
-        if (mMultisampleFB)
-            glDeleteFramebuffersEXT(1, &mMultisampleFB);
+        if (auto stateCacheManager = getStateCacheManager())
+        {
+            stateCacheManager->deleteGLBuffer(GL_FRAMEBUFFER, mFB);
+            stateCacheManager->deleteGLBuffer(GL_FRAMEBUFFER, mMultisampleFB);
+        }
+        else
+        {
+            glDeleteFramebuffersEXT(1, &mFB);
+            if (mMultisampleFB)
+                glDeleteFramebuffersEXT(1, &mMultisampleFB);
+        }
 
     }
     void GLFrameBufferObject::initialise()
@@ -108,7 +125,8 @@ namespace Ogre {
         ushort maxSupportedMRTs = rsc->getNumMultiRenderTargets();
 
         // Bind simple buffer to add colour attachments
-        glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, mFB);
+        auto stateCacheManager = getStateCacheManager();
+        stateCacheManager->bindGLFrameBuffer(mFB);
 
         // Bind all attachment points to frame buffer
         for(unsigned int x=0; x<maxSupportedMRTs; ++x)
@@ -148,7 +166,7 @@ namespace Ogre {
         if (mMultisampleFB && !PixelUtil::isDepth(getFormat()))
         {
             // Bind multisample buffer
-            glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, mMultisampleFB);
+            stateCacheManager->bindGLFrameBuffer(mMultisampleFB);
 
             // Create AA render buffer (colour)
             // note, this can be shared too because we blit it to the final FBO
@@ -199,7 +217,7 @@ namespace Ogre {
         status = glCheckFramebufferStatusEXT(GL_FRAMEBUFFER_EXT);
         
         // Bind main buffer
-        glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, 0);
+        stateCacheManager->bindGLFrameBuffer(0);
         
         switch(status)
         {
@@ -221,7 +239,7 @@ namespace Ogre {
     {
         // Bind it to FBO
         const GLuint fb = mMultisampleFB ? mMultisampleFB : mFB;
-        glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, fb);
+        getStateCacheManager()->bindGLFrameBuffer(fb);
         return mContext != nullptr;
     }
 
@@ -229,18 +247,19 @@ namespace Ogre {
     {
         if (mMultisampleFB)
         {
-            GLint oldfb = 0;
-            glGetIntegerv(GL_FRAMEBUFFER_BINDING_EXT, &oldfb);
+            auto stateCacheManager = getStateCacheManager();
 
             // Blit from multisample buffer to final buffer, triggers resolve
             uint32 width = mColour[0].buffer->getWidth();
             uint32 height = mColour[0].buffer->getHeight();
             glBindFramebufferEXT(GL_READ_FRAMEBUFFER_EXT, mMultisampleFB);
             glBindFramebufferEXT(GL_DRAW_FRAMEBUFFER_EXT, mFB);
+            // the blit is subject to the scissor test
+            stateCacheManager->flushDeferredState();
             glBlitFramebufferEXT(0, 0, width, height, 0, 0, width, height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
 
-            // Unbind
-            glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, oldfb);
+            // Unbind, the targets were bound separately
+            stateCacheManager->bindGLFrameBuffer(stateCacheManager->getBoundFrameBuffer(), true);
         }
     }
 
@@ -248,7 +267,7 @@ namespace Ogre {
     {
         auto glDepthBuffer = static_cast<GLDepthBufferCommon*>(depthBuffer);
 
-        glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, mMultisampleFB ? mMultisampleFB : mFB );
+        getStateCacheManager()->bindGLFrameBuffer(mMultisampleFB ? mMultisampleFB : mFB);
 
         if( glDepthBuffer )
         {
@@ -274,7 +293,7 @@ namespace Ogre {
     //-----------------------------------------------------------------------------
     void GLFrameBufferObject::detachDepthBuffer()
     {
-        glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, mMultisampleFB ? mMultisampleFB : mFB );
+        getStateCacheManager()->bindGLFrameBuffer(mMultisampleFB ? mMultisampleFB : mFB);
         glFramebufferRenderbufferEXT( GL_FRAMEBUFFER_EXT, GL_DEPTH_ATTACHMENT_EXT, GL_RENDERBUFFER_EXT, 0 );
         glFramebufferRenderbufferEXT( GL_FRAMEBUFFER_EXT, GL_STENCIL_ATTACHMENT_EXT,
                                       GL_RENDERBUFFER_EXT, 0 );
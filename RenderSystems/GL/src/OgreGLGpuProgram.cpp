@@ -124,7 +124,7 @@ void GLArbGpuProgram::unbindProgram()
     glDisable(getProgramType());
 }
 
-void GLArbGpuProgram::bindProgramParameters(GpuProgramParametersSharedPtr params, Ogre::GpuParamVariability mask)
+void GLArbGpuProgram::bindProgramParameters(const GpuProgramParametersSharedPtr& params, Ogre::GpuParamVariability mask)
 {
     GLenum type = getProgramType();
     
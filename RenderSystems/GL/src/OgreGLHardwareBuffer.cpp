@@ -28,6 +28,7 @@ THE SOFTWARE.
 module;
 
 #include "glad/glad.h"
+#include <cstring>
 
 module Ogre.RenderSystems.GL;
 
@@ -45,11 +46,21 @@ namespace Ogre {
     //---------------------------------------------------------------------
     GLHardwareVertexBuffer::GLHardwareVertexBuffer(GLenum target, size_t sizeInBytes,
         Usage usage, bool useShadowBuffer)
-        : HardwareBuffer(usage, false, useShadowBuffer), mTarget(target) 
+        : HardwareBuffer(usage, false, useShadowBuffer), mTarget(target),
+          mStreamingOffset(GLHardwareBufferManager::NO_STREAMING), mPoolOffset(GLHardwareBufferManager::NO_POOL)
     {
         mSizeInBytes = sizeInBytes;
         mRenderSystem = static_cast<GLRenderSystem*>(Root::getSingleton().getRenderSystem());
 
+        // static geometry may share the storage of a larger buffer
+        if (usage == HardwareBufferUsage::GPU_ONLY)
+        {
+            auto* glBufManager = static_cast<GLHardwareBufferManager*>(HardwareBufferManager::getSingletonPtr());
+            mPoolOffset = glBufManager->_allocateStatic(mTarget, mSizeInBytes, mBufferId);
+            if (isPooled())
+                return;
+        }
+
         glGenBuffersARB( 1, &mBufferId );
 
         if (!mBufferId)
@@ -67,8 +78,66 @@ namespace Ogre {
     //---------------------------------------------------------------------
     GLHardwareVertexBuffer::~GLHardwareVertexBuffer()
     {
-        if(GLStateCacheManager* stateCacheManager = mRenderSystem->_getStateCacheManager())
+        if (isPooled())
+        {
+            if (auto* glBufManager = static_cast<GLHardwareBufferManager*>(HardwareBufferManager::getSingletonPtr()))
+                glBufManager->_freeStatic(mBufferId, mPoolOffset, mSizeInBytes);
+        }
+        else if(GLStateCacheManager* stateCacheManager = mRenderSystem->_getStateCacheManager())
             stateCacheManager->deleteGLBuffer(mTarget, mBufferId);
+        if (mTarget == GL_ARRAY_BUFFER_ARB)
+            mRenderSystem->_invalidateVertexArrays();
+    }
+    //---------------------------------------------------------------------
+    auto GLHardwareVertexBuffer::getGLBufferId() -> GLuint
+    {
+        if (mStreamingOffset == GLHardwareBufferManager::NO_STREAMING)
+            return mBufferId;
+
+        auto* glBufManager = static_cast<GLHardwareBufferManager*>(HardwareBufferManager::getSingletonPtr());
+        if (mStreamingGeneration == glBufManager->_getStreamingGeneration())
+            return glBufManager->_getStreamingBufferId();
+
+        // the ring was orphaned since the upload, restore the contents from the staging copy
+        leaveStreaming(true);
+        return mBufferId;
+    }
+    //---------------------------------------------------------------------
+    auto GLHardwareVertexBuffer::getGLBufferOffset() const noexcept -> size_t
+    {
+        if (isPooled())
+            return mPoolOffset;
+        return mStreamingOffset == GLHardwareBufferManager::NO_STREAMING ? 0 : mStreamingOffset;
+    }
+    //---------------------------------------------------------------------
+    auto GLHardwareVertexBuffer::isPooled() const noexcept -> bool
+    {
+        return mPoolOffset != GLHardwareBufferManager::NO_POOL;
+    }
+    //---------------------------------------------------------------------
+    auto GLHardwareVertexBuffer::isStreamed() const noexcept -> bool
+    {
+        return mStreamingOffset != GLHardwareBufferManager::NO_STREAMING &&
+               mStreamingGeneration ==
+                   static_cast<GLHardwareBufferManager*>(HardwareBufferManager::getSingletonPtr())
+                       ->_getStreamingGeneration();
+    }
+    //---------------------------------------------------------------------
+    void GLHardwareVertexBuffer::leaveStreaming(bool keepContents)
+    {
+        if (mStreamingOffset == GLHardwareBufferManager::NO_STREAMING)
+            return;
+
+        mStreamingOffset = GLHardwareBufferManager::NO_STREAMING;
+        mRenderSystem->_invalidateVertexArrays();
+
+        if (!keepContents)
+            return;
+
+        // the staging copy always holds the complete contents
+        mRenderSystem->_getStateCacheManager()->bindGLBuffer(mTarget, mBufferId);
+        glBufferDataARB(mTarget, mSizeInBytes, mStreamingStaging.get(), GLHardwareBufferManager::getGLUsage(mUsage));
+        mRenderSystem->_notifyBufferUpload(mSizeInBytes);
     }
     //---------------------------------------------------------------------
     auto GLHardwareVertexBuffer::lockImpl(size_t offset, 
@@ -78,6 +147,35 @@ namespace Ogre {
 
         auto* glBufManager = static_cast<GLHardwareBufferManager*>(HardwareBufferManager::getSingletonPtr());
 
+        // Discarding the contents of a dynamic buffer, move them to a fresh region of the ring
+        if (options == LockOptions::DISCARD && !!(mUsage & HardwareBufferUsage::CPU_ONLY))
+        {
+            size_t streamingOffset = glBufManager->_allocateStreaming(mSizeInBytes);
+            if (streamingOffset != GLHardwareBufferManager::NO_STREAMING)
+            {
+                if (!mStreamingStaging)
+                    mStreamingStaging = std::make_unique<uint8[]>(mSizeInBytes);
+
+                mStreamingOffset = streamingOffset;
+                mStreamingGeneration = glBufManager->_getStreamingGeneration();
+                mLockedToStreaming = true;
+                return mStreamingStaging.get() + offset;
+            }
+        }
+
+        leaveStreaming(options != LockOptions::DISCARD);
+
+        // the storage is shared, so mapping or orphaning it would affect the other regions
+        if (isPooled())
+        {
+            mPoolStaging = std::make_unique<uint8[]>(length);
+            if (options != LockOptions::DISCARD && options != LockOptions::NO_OVERWRITE)
+                readData(offset, length, mPoolStaging.get());
+            mLockedToPool = true;
+            mScratchUploadOnUnlock = (options != LockOptions::READ_ONLY);
+            return mPoolStaging.get();
+        }
+
         // Try to use scratch buffers for smaller buffers
         if( length < glBufManager->getGLMapBufferThreshold() )
         {
@@ -128,6 +226,7 @@ namespace Ogre {
             retPtr = static_cast<void*>(static_cast<unsigned char*>(pBuffer) + offset);
 
             mLockedToScratch = false;
+            mMappedUploadSize = options == LockOptions::READ_ONLY ? 0 : length;
         }
 
         return retPtr;
@@ -135,7 +234,27 @@ namespace Ogre {
     //---------------------------------------------------------------------
     void GLHardwareVertexBuffer::unlockImpl()
     {
-        if (mLockedToScratch)
+        if (mLockedToStreaming)
+        {
+            auto* glBufManager = static_cast<GLHardwareBufferManager*>(HardwareBufferManager::getSingletonPtr());
+            mRenderSystem->_getStateCacheManager()->bindGLBuffer(mTarget, glBufManager->_getStreamingBufferId());
+            glBufferSubDataARB(mTarget, mStreamingOffset + mLockStart, mLockSize, mStreamingStaging.get() + mLockStart);
+            mRenderSystem->_notifyBufferUpload(mLockSize);
+
+            mLockedToStreaming = false;
+        }
+        else if (mLockedToPool)
+        {
+            if (mScratchUploadOnUnlock)
+            {
+                mRenderSystem->_getStateCacheManager()->bindGLBuffer(mTarget, mBufferId);
+                glBufferSubDataARB(mTarget, mPoolOffset + mLockStart, mLockSize, mPoolStaging.get());
+                mRenderSystem->_notifyBufferUpload(mLockSize);
+            }
+            mPoolStaging.reset();
+            mLockedToPool = false;
+        }
+        else if (mLockedToScratch)
         {
             if (mScratchUploadOnUnlock)
             {
@@ -158,6 +277,10 @@ namespace Ogre {
             {
                 OGRE_EXCEPT(ExceptionCodes::INTERNAL_ERROR, "Buffer data corrupted, please reload");
             }
+
+            if (mMappedUploadSize)
+                mRenderSystem->_notifyBufferUpload(mMappedUploadSize);
+            mMappedUploadSize = 0;
         }
     }
     //---------------------------------------------------------------------
@@ -168,18 +291,25 @@ namespace Ogre {
         {
             mShadowBuffer->readData(offset, length, pDest);
         }
+        else if (isStreamed())
+        {
+            memcpy(pDest, mStreamingStaging.get() + offset, length);
+        }
         else
         {
             // get data from the real buffer
+            leaveStreaming(true);
             mRenderSystem->_getStateCacheManager()->bindGLBuffer(mTarget, mBufferId);
 
-            glGetBufferSubDataARB(mTarget, offset, length, pDest);
+            glGetBufferSubDataARB(mTarget, getGLBufferOffset() + offset, length, pDest);
         }
     }
     //---------------------------------------------------------------------
     void GLHardwareVertexBuffer::writeData(size_t offset, size_t length, 
             const void* pSource, bool discardWholeBuffer)
     {
+        leaveStreaming(!discardWholeBuffer && !(offset == 0 && length == mSizeInBytes));
+
         mRenderSystem->_getStateCacheManager()->bindGLBuffer(mTarget, mBufferId);
 
         // Update the shadow buffer
@@ -188,7 +318,11 @@ namespace Ogre {
             mShadowBuffer->writeData(offset, length, pSource, discardWholeBuffer);
         }
 
-        if (offset == 0 && length == mSizeInBytes)
+        if (isPooled())
+        {
+            glBufferSubDataARB(mTarget, mPoolOffset + offset, length, pSource);
+        }
+        else if (offset == 0 && length == mSizeInBytes)
         {
             glBufferDataARB(mTarget, mSizeInBytes, pSource,
                 GLHardwareBufferManager::getGLUsage(mUsage));
@@ -204,6 +338,8 @@ namespace Ogre {
             // Now update the real buffer
             glBufferSubDataARB(mTarget, offset, length, pSource);
         }
+
+        mRenderSystem->_notifyBufferUpload(length);
     }
     //---------------------------------------------------------------------
     void GLHardwareVertexBuffer::_updateFromShadow()
@@ -215,7 +351,11 @@ namespace Ogre {
             mRenderSystem->_getStateCacheManager()->bindGLBuffer(mTarget, mBufferId);
 
             // Update whole buffer if possible, otherwise normal
-            if (mLockStart == 0 && mLockSize == mSizeInBytes)
+            if (isPooled())
+            {
+                glBufferSubDataARB(mTarget, mPoolOffset + mLockStart, mLockSize, shadowLock.pData);
+            }
+            else if (mLockStart == 0 && mLockSize == mSizeInBytes)
             {
                 glBufferDataARB(mTarget, mSizeInBytes, shadowLock.pData,
                     GLHardwareBufferManager::getGLUsage(mUsage));
@@ -224,6 +364,7 @@ namespace Ogre {
             {
                 glBufferSubDataARB(mTarget, mLockStart, mLockSize, shadowLock.pData);
             }
+            mRenderSystem->_notifyBufferUpload(mLockSize);
 
             mShadowUpdated = false;
         }
@@ -39,7 +39,18 @@ import :RenderToVertexBuffer;
 
 import Ogre.Core;
 
+import <algorithm>;
+import <iterator>;
+import <map>;
 import <memory>;
+import <vector>;
+
+#ifndef GL_HALF_FLOAT
+#define GL_HALF_FLOAT                     0x140B
+#endif
+#ifndef GL_INT_2_10_10_10_REV
+#define GL_INT_2_10_10_10_REV             0x8D9F
+#endif
 
 namespace Ogre {
     //-----------------------------------------------------------------------
@@ -73,6 +84,15 @@ namespace Ogre {
         destroyAllDeclarations();
         destroyAllBindings();
 
+        setStreamingBufferSize(0);
+
+        for (const StaticPool& pool : mStaticPools)
+        {
+            if (GLStateCacheManager* stateCacheManager = getStateCacheManager())
+                stateCacheManager->deleteGLBuffer(pool.target, pool.bufferId);
+        }
+        mStaticPools.clear();
+
         ::Ogre::AlignedMemory::deallocate(mScratchBufferPool);
     }
     //-----------------------------------------------------------------------
@@ -142,6 +162,11 @@ namespace Ogre {
             case USHORT2_NORM:
             case USHORT4_NORM:
                 return GL_UNSIGNED_SHORT;
+            case HALF2:
+            case HALF4:
+                return GL_HALF_FLOAT;
+            case INT_10_10_10_2_NORM:
+                return GL_INT_2_10_10_10_REV;
             default:
                 return 0;
         };
@@ -261,4 +286,140 @@ namespace Ogre {
     {
         mMapBufferThreshold = value;
     }
+    //---------------------------------------------------------------------
+    void GLHardwareBufferManager::setStreamingBufferSize(size_t size)
+    {
+        if (mStreamingBufferId)
+        {
+            if (GLStateCacheManager* stateCacheManager = getStateCacheManager())
+                stateCacheManager->deleteGLBuffer(GL_ARRAY_BUFFER_ARB, mStreamingBufferId);
+            mRenderSystem->_invalidateVertexArrays();
+            mStreamingBufferId = 0;
+        }
+
+        // the regions handed out so far are gone
+        mStreamingBufferSize = size;
+        mStreamingCapacity = 0;
+        mStreamingOffset = 0;
+        ++mStreamingGeneration;
+    }
+    //---------------------------------------------------------------------
+    auto GLHardwareBufferManager::_allocateStreaming(size_t size) -> size_t
+    {
+        // keep the regions aligned for any vertex or index type
+        static const size_t constexpr ALIGNMENT = 16;
+
+        if (size > mStreamingBufferSize)
+            return NO_STREAMING;
+
+        if (!mStreamingBufferId)
+        {
+            glGenBuffersARB(1, &mStreamingBufferId);
+            if (!mStreamingBufferId)
+                return NO_STREAMING;
+
+            getStateCacheManager()->bindGLBuffer(GL_ARRAY_BUFFER_ARB, mStreamingBufferId);
+            glBufferDataARB(GL_ARRAY_BUFFER_ARB, mStreamingBufferSize, nullptr, GL_STREAM_DRAW_ARB);
+            mStreamingCapacity = mStreamingBufferSize;
+            mStreamingOffset = 0;
+        }
+
+        size_t offset = (mStreamingOffset + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+        if (offset + size > mStreamingCapacity)
+        {
+            // The draws issued so far keep the old storage, the buffers
+            // with regions in it notice the generation change
+            getStateCacheManager()->bindGLBuffer(GL_ARRAY_BUFFER_ARB, mStreamingBufferId);
+            glBufferDataARB(GL_ARRAY_BUFFER_ARB, mStreamingCapacity, nullptr, GL_STREAM_DRAW_ARB);
+            ++mStreamingGeneration;
+            offset = 0;
+        }
+
+        mStreamingOffset = offset + size;
+        return offset;
+    }
+    //---------------------------------------------------------------------
+    auto GLHardwareBufferManager::_allocateStatic(GLenum target, size_t size, GLuint& bufferId) -> size_t
+    {
+        // keep the regions aligned for any vertex or index type
+        static const size_t constexpr ALIGNMENT = 16;
+
+        // larger buffers gain little from sharing, but would fragment the pools
+        if (size == 0 || size > mStaticPoolSize / 4)
+            return NO_POOL;
+        size = (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+
+        auto allocate = [&](StaticPool& pool) -> size_t
+        {
+            for (auto it = pool.freeRegions.begin(); it != pool.freeRegions.end(); ++it)
+            {
+                auto [offset, regionSize] = *it;
+                if (regionSize < size)
+                    continue;
+
+                pool.freeRegions.erase(it);
+                if (regionSize > size)
+                    pool.freeRegions.emplace(offset + size, regionSize - size);
+                ++pool.allocations;
+                bufferId = pool.bufferId;
+                return offset;
+            }
+            return NO_POOL;
+        };
+
+        for (StaticPool& pool : mStaticPools)
+        {
+            if (pool.target != target)
+                continue;
+            if (size_t offset = allocate(pool); offset != NO_POOL)
+                return offset;
+        }
+
+        StaticPool pool{target, 0, {{0, mStaticPoolSize}}, 0};
+        glGenBuffersARB(1, &pool.bufferId);
+        if (!pool.bufferId)
+            return NO_POOL;
+
+        getStateCacheManager()->bindGLBuffer(target, pool.bufferId);
+        glBufferDataARB(target, mStaticPoolSize, nullptr, GL_STATIC_DRAW_ARB);
+        mStaticPools.push_back(std::move(pool));
+        return allocate(mStaticPools.back());
+    }
+    //---------------------------------------------------------------------
+    void GLHardwareBufferManager::_freeStatic(GLuint bufferId, size_t offset, size_t size)
+    {
+        static const size_t constexpr ALIGNMENT = 16;
+        size = (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+
+        auto pool = std::ranges::find(mStaticPools, bufferId, &StaticPool::bufferId);
+        if (pool == mStaticPools.end())
+            return;
+
+        if (--pool->allocations == 0)
+        {
+            if (GLStateCacheManager* stateCacheManager = getStateCacheManager())
+                stateCacheManager->deleteGLBuffer(pool->target, pool->bufferId);
+            if (pool->target == GL_ARRAY_BUFFER_ARB)
+                mRenderSystem->_invalidateVertexArrays();
+            mStaticPools.erase(pool);
+            return;
+        }
+
+        // merge with the free regions on either side
+        auto region = pool->freeRegions.emplace(offset, size).first;
+        if (auto next = std::next(region);
+            next != pool->freeRegions.end() && region->first + region->second == next->first)
+        {
+            region->second += next->second;
+            pool->freeRegions.erase(next);
+        }
+        if (region != pool->freeRegions.begin())
+        {
+            if (auto previous = std::prev(region); previous->first + previous->second == region->first)
+            {
+                previous->second += region->second;
+                pool->freeRegions.erase(region);
+            }
+        }
+    }
 }
@@ -159,9 +159,21 @@ GLTextureBuffer::GLTextureBuffer(GLRenderSystem* renderSystem, GLTexture* parent
     }
 }
 GLTextureBuffer::~GLTextureBuffer()
-= default;
+{
+    mRenderSystem->_discardTextureUploads(this);
+}
 //-----------------------------------------------------------------------------
 void GLTextureBuffer::upload(const PixelBox &data, const Box &dest)
+{
+    if(mRenderSystem->_queueTextureUpload(this, data, dest))
+        return;
+
+    // keep the order of the uploads, the earlier ones must not overwrite this one
+    mRenderSystem->_flushTextureUploads(this);
+    _uploadNow(data, dest);
+}
+//-----------------------------------------------------------------------------
+void GLTextureBuffer::_uploadNow(const PixelBox &data, const Box &dest)
 {
     mRenderSystem->_getStateCacheManager()->bindGLTexture( mTarget, mTextureID );
     if(PixelUtil::isCompressed(data.format))
@@ -169,7 +181,7 @@ void GLTextureBuffer::upload(const PixelBox &data, const Box &dest)
         if(data.format != mFormat || !data.isConsecutive())
             OGRE_EXCEPT(ExceptionCodes::INVALIDPARAMS, 
             "Compressed images must be consecutive, in the source format",
-            "GLTextureBuffer::upload");
+            "GLTextureBuffer::_uploadNow");
         GLenum format = GLPixelUtil::getGLInternalFormat(mFormat, mHwGamma);
         // Data must be consecutive and at beginning of buffer as PixelStorei not allowed
         // for compressed formats
@@ -304,6 +316,7 @@ void GLTextureBuffer::download(const PixelBox &data)
     if(data.getSize() != getSize())
         OGRE_EXCEPT(ExceptionCodes::INVALIDPARAMS, "only download of entire buffer is supported by GL",
             "GLTextureBuffer::download");
+    mRenderSystem->_flushTextureUploads(this);
     mRenderSystem->_getStateCacheManager()->bindGLTexture( mTarget, mTextureID );
     if(PixelUtil::isCompressed(data.format))
     {
@@ -339,6 +352,7 @@ void GLTextureBuffer::download(const PixelBox &data)
 void GLTextureBuffer::bindToFramebuffer(uint32 attachment, uint32 zoffset)
 {
     assert(zoffset < mDepth);
+    mRenderSystem->_flushTextureUploads(this);
     switch(mTarget)
     {
     case GL_TEXTURE_1D:
@@ -360,6 +374,7 @@ void GLTextureBuffer::bindToFramebuffer(uint32 attachment, uint32 zoffset)
 //-----------------------------------------------------------------------------
 void GLTextureBuffer::copyFromFramebuffer(uint32 zoffset)
 {
+    mRenderSystem->_flushTextureUploads(this);
     mRenderSystem->_getStateCacheManager()->bindGLTexture(mTarget, mTextureID);
     switch(mTarget)
     {
@@ -380,6 +395,8 @@ void GLTextureBuffer::copyFromFramebuffer(uint32 zoffset)
 void GLTextureBuffer::blit(const HardwarePixelBufferSharedPtr &src, const Box &srcBox, const Box &dstBox)
 {
     auto *srct = static_cast<GLTextureBuffer *>(src.get());
+    mRenderSystem->_flushTextureUploads(srct);
+    mRenderSystem->_flushTextureUploads(this);
     /// Check for FBO support first
     /// Destination texture must be 1D, 2D, 3D, or Cube
     /// Source texture must be 1D, 2D or 3D
@@ -414,7 +431,7 @@ void GLTextureBuffer::blitFromTexture(GLTextureBuffer *src, const Box &srcBox, c
     auto *fboMan = static_cast<GLFBOManager *>(GLRTTManager::getSingletonPtr());
     
     /// Save and clear GL state for rendering
-    glPushAttrib(GL_COLOR_BUFFER_BIT | GL_CURRENT_BIT | GL_DEPTH_BUFFER_BIT | GL_ENABLE_BIT | 
+    mRenderSystem->_getStateCacheManager()->pushAttrib(GL_COLOR_BUFFER_BIT | GL_CURRENT_BIT | GL_DEPTH_BUFFER_BIT | GL_ENABLE_BIT | 
         GL_FOG_BIT | GL_LIGHTING_BIT | GL_POLYGON_BIT | GL_SCISSOR_BIT | GL_STENCIL_BUFFER_BIT |
         GL_TEXTURE_BIT | GL_VIEWPORT_BIT);
 
@@ -485,11 +502,10 @@ void GLTextureBuffer::blitFromTexture(GLTextureBuffer *src, const Box &srcBox, c
     mRenderSystem->_getStateCacheManager()->setTexParameteri(src->mTarget, GL_TEXTURE_BASE_LEVEL, src->mLevel);
     
     /// Store old binding so it can be restored later
-    GLint oldfb;
-    glGetIntegerv(GL_FRAMEBUFFER_BINDING_EXT, &oldfb);
+    GLuint oldfb = mRenderSystem->_getStateCacheManager()->getBoundFrameBuffer();
     
     /// Set up temporary FBO
-    glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, fboMan->getTemporaryFBO());
+    mRenderSystem->_getStateCacheManager()->bindGLFrameBuffer(fboMan->getTemporaryFBO());
     
     TexturePtr tempTex;
     if(!fboMan->checkFormat(mFormat))
@@ -596,7 +612,7 @@ void GLTextureBuffer::blitFromTexture(GLTextureBuffer *src, const Box &srcBox, c
     glFramebufferRenderbufferEXT(GL_FRAMEBUFFER_EXT, GL_COLOR_ATTACHMENT0_EXT,
                     GL_RENDERBUFFER_EXT, 0);
     /// Restore old framebuffer
-    glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, oldfb);
+    mRenderSystem->_getStateCacheManager()->bindGLFrameBuffer(oldfb);
     /// Restore matrix stacks and render state
     glMatrixMode(GL_TEXTURE);
     glPopMatrix();
@@ -604,7 +620,7 @@ void GLTextureBuffer::blitFromTexture(GLTextureBuffer *src, const Box &srcBox, c
     glPopMatrix();
     glMatrixMode(GL_MODELVIEW);
     glPopMatrix();
-    glPopAttrib();
+    mRenderSystem->_getStateCacheManager()->popAttrib();
 
     if(tempTex)
         TextureManager::getSingleton().remove(tempTex);
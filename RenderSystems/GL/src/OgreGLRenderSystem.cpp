@@ -38,6 +38,8 @@ module Ogre.RenderSystems.GL;
 import :CopyingRenderTexture;
 import :FBOMultiRenderTarget;
 import :FBORenderTexture;
+import :GLSL.SLLinkProgramManager;
+import :GLSL.SLProgram;
 import :GLSL.SLProgramFactory;
 import :GpuNvparseProgram;
 import :GpuProgram;
@@ -59,16 +61,35 @@ import Ogre.Core;
 import Ogre.RenderSystems.GLSupport;
 
 import <algorithm>;
+import <deque>;
 import <istream>;
 import <list>;
 import <map>;
 import <memory>;
 import <set>;
+import <span>;
 import <string>;
 import <utility>;
 
 // Convenience macro from ARB_vertex_buffer_object spec
 #define VBO_BUFFER_OFFSET(i) ((char *)(i))
+// From ARB_timer_query, which the loader does not provide
+#ifndef GL_TIMESTAMP
+#define GL_TIMESTAMP 0x8E28
+#endif
+// From ARB_sync, which the loader does not provide
+#ifndef GL_SYNC_GPU_COMMANDS_COMPLETE
+#define GL_SYNC_GPU_COMMANDS_COMPLETE 0x9117
+#define GL_SYNC_FLUSH_COMMANDS_BIT 0x00000001
+#define GL_TIMEOUT_IGNORED 0xFFFFFFFFFFFFFFFFull
+#define GL_ALREADY_SIGNALED 0x911A
+#define GL_CONDITION_SATISFIED 0x911C
+#define GL_WAIT_FAILED 0x911D
+#endif
+// From ARB_clip_control, which the loader does not provide
+#ifndef GL_ZERO_TO_ONE
+#define GL_ZERO_TO_ONE 0x935F
+#endif
 namespace Ogre {
 
     static GLNativeSupport constinit*  glsupport;
@@ -368,24 +389,21 @@ namespace Ogre {
         opt.immutable = false;
 
         mOptions["Fixed Pipeline Enabled"] = opt;
+
+        opt.name = "Reversed Z-Buffer";
+        opt.currentValue = opt.possibleValues[1];
+        mOptions["Reversed Z-Buffer"] = opt;
     }
 
     auto GLRenderSystem::createRenderSystemCapabilities() const -> RenderSystemCapabilities*
     {
         auto* rsc = new RenderSystemCapabilities();
 
-        rsc->setCategoryRelevant(CapabilitiesCategory::GL, true);
-        rsc->setDriverVersion(mDriverVersion);
         const char* deviceName = (const char*)glGetString(GL_RENDERER);
         rsc->setDeviceName(deviceName);
         rsc->setRenderSystemName(getName());
         rsc->setVendor(mVendor);
-
-        if (mEnableFixedPipeline)
-        {
-            // Supports fixed-function
-            rsc->setCapability(Capabilities::FIXED_FUNCTION);
-        }
+        setContextCapabilities(rsc);
 
         rsc->setCapability(Capabilities::AUTOMIPMAP_COMPRESSED);
 
@@ -419,29 +437,8 @@ namespace Ogre {
             rsc->setCapability(Capabilities::POINT_SPRITES);
         }
 
-        if(GLAD_GL_ARB_point_parameters)
-        {
-            glPointParameterf = glPointParameterfARB;
-            glPointParameterfv = glPointParameterfvARB;
-        }
-        else if(GLAD_GL_EXT_point_parameters)
-        {
-            glPointParameterf = glPointParameterfEXT;
-            glPointParameterfv = glPointParameterfvEXT;
-        }
-
         rsc->setCapability(Capabilities::POINT_EXTENDED_PARAMETERS);
 
-
-        // Check for hardware stencil support and set bit depth
-        GLint stencil;
-        glGetIntegerv(GL_STENCIL_BITS,&stencil);
-
-        if(stencil)
-        {
-            rsc->setCapability(Capabilities::HWSTENCIL);
-        }
-
         rsc->setCapability(Capabilities::HW_GAMMA);
 
         rsc->setCapability(Capabilities::MAPBUFFER);
@@ -573,6 +570,9 @@ namespace Ogre {
                 rsc->setCapability(Capabilities::CAN_GET_COMPILED_SHADER_BUFFER);
         }
 
+        if (GLAD_GL_VERSION_1_4)
+            rsc->setCapability(Capabilities::MULTI_DRAW);
+
         if (hasMinGLVersion(3, 3) || GLAD_GL_ARB_instanced_arrays)
         {
             // states 3.3 here: http://www.opengl.org/sdk/docs/man3/xhtml/glVertexAttribDivisor.xml
@@ -691,6 +691,33 @@ namespace Ogre {
         return rsc;
     }
 
+    void GLRenderSystem::setContextCapabilities(RenderSystemCapabilities* rsc) const
+    {
+        // the cache holds neither of these
+        rsc->setCategoryRelevant(CapabilitiesCategory::GL, true);
+        rsc->setDriverVersion(mDriverVersion);
+
+        // set by the config and the pixel format of the window, not the device
+        if (mEnableFixedPipeline)
+        {
+            // Supports fixed-function
+            rsc->setCapability(Capabilities::FIXED_FUNCTION);
+        }
+        else
+            rsc->unsetCapability(Capabilities::FIXED_FUNCTION);
+
+        // Check for hardware stencil support and set bit depth
+        GLint stencil;
+        glGetIntegerv(GL_STENCIL_BITS,&stencil);
+
+        if(stencil)
+        {
+            rsc->setCapability(Capabilities::HWSTENCIL);
+        }
+        else
+            rsc->unsetCapability(Capabilities::HWSTENCIL);
+    }
+
     void GLRenderSystem::initialiseFromRenderSystemCapabilities(RenderSystemCapabilities* caps, RenderTarget* primary)
     {
         if(caps->getRenderSystemName() != getName())
@@ -732,6 +759,17 @@ namespace Ogre {
             glUnmapBufferARB = glUnmapBuffer;
         }
 
+        if(GLAD_GL_ARB_point_parameters)
+        {
+            glPointParameterf = glPointParameterfARB;
+            glPointParameterfv = glPointParameterfvARB;
+        }
+        else if(GLAD_GL_EXT_point_parameters)
+        {
+            glPointParameterf = glPointParameterfEXT;
+            glPointParameterfv = glPointParameterfvEXT;
+        }
+
         mHardwareBufferManager = new GLHardwareBufferManager;
 
         // XXX Need to check for nv2 support and make a program manager for it
@@ -893,7 +931,10 @@ namespace Ogre {
 
             // Create FBO manager
             LogManager::getSingleton().logMessage("GL: Using GL_EXT_framebuffer_object for rendering to textures (best)");
-            mRTTManager = new GLFBOManager(false);
+            bool floatDepth = mIsReverseDepthBufferEnabled && (hasMinGLVersion(3, 0) || GLAD_GL_ARB_depth_buffer_float);
+            mRTTManager = new GLFBOManager(false, floatDepth);
+            // the format probing binds textures bypassing the state cache
+            mStateCacheManager->invalidateTextureBindings();
             //TODO: Check if we're using OpenGL 3.0 and add Capabilities::RTT_DEPTHBUFFER_RESOLUTION_LESSEQUAL flag
         }
         else
@@ -951,6 +992,30 @@ namespace Ogre {
         }
         mBackgroundContextList.clear();
 
+        for (auto& [ticket, readback] : mPendingReadbacks)
+            mFreeReadbackBuffers.push_back(readback.buffer);
+        if (mStateCacheManager)
+        {
+            for (auto buffer : mFreeReadbackBuffers)
+                mStateCacheManager->deleteGLBuffer(GL_PIXEL_PACK_BUFFER_ARB, buffer);
+        }
+        mPendingReadbacks.clear();
+        mFreeReadbackBuffers.clear();
+
+        for (auto& upload : mPendingTextureUploads)
+            mFreeUploadBuffers.push_back(upload.buffer);
+        if (mStateCacheManager)
+        {
+            for (auto buffer : mFreeUploadBuffers)
+                mStateCacheManager->deleteGLBuffer(GL_PIXEL_UNPACK_BUFFER_ARB, buffer);
+        }
+        mPendingTextureUploads.clear();
+        mFreeUploadBuffers.clear();
+
+        releaseTimerQueries();
+        mOpenProfileEvents.clear();
+        releaseFrameFences();
+
         // Deleting the GPU program manager and hardware buffer manager.  Has to be done before the mGLSupport->stop().
         delete mGpuProgramManager;
         mGpuProgramManager = nullptr;
@@ -1014,9 +1079,30 @@ namespace Ogre {
                 mEnableFixedPipeline = StringConverter::parseBool(it->second.currentValue);
             }
 
+            it = mOptions.find("Reversed Z-Buffer");
+            if (it != mOptions.end())
+            {
+                mIsReverseDepthBufferEnabled = StringConverter::parseBool(it->second.currentValue);
+            }
+            if (mIsReverseDepthBufferEnabled && !mClipControl)
+            {
+                LogManager::getSingleton().logWarning(
+                    "GL: Reversed Z-Buffer requires GL_ARB_clip_control, using the standard depth range");
+                mIsReverseDepthBufferEnabled = false;
+            }
+
             // Initialise GL after the first window has been created
             // TODO: fire this from emulation options, and don't duplicate Real and Current capabilities
-            mRealCapabilities.reset(createRenderSystemCapabilities());
+            StartupProfiler::Scope capabilities{StartupProfiler::PhaseType::CAPABILITIES, getName()};
+            mRealCapabilities.reset(
+                loadCachedCapabilities(mVendor, (const char*)glGetString(GL_RENDERER), mDriverVersion));
+            if (mRealCapabilities)
+                setContextCapabilities(mRealCapabilities.get());
+            else
+            {
+                mRealCapabilities.reset(createRenderSystemCapabilities());
+                saveCachedCapabilities(mRealCapabilities.get());
+            }
             initFixedFunctionParams(); // create params
 
             // use real capabilities if custom capabilities are not available
@@ -1062,7 +1148,7 @@ namespace Ogre {
                                                               fbo->getHeight(), fbo->getFSAA() );
 
             GLRenderBuffer *stencilBuffer = nullptr;
-            if ( depthFormat == GL_DEPTH24_STENCIL8_EXT)
+            if (depthFormat == GL_DEPTH24_STENCIL8_EXT || depthFormat == GL_DEPTH32F_STENCIL8)
             {
                 // If we have a packed format, the stencilBuffer is the same as the depthBuffer
                 stencilBuffer = depthBuffer;
@@ -1101,7 +1187,30 @@ namespace Ogre {
         // Get extension function pointers
         initialiseExtensions();
 
+        if (hasMinGLVersion(3, 3) || checkExtension("GL_ARB_timer_query"))
+        {
+            mQueryCounter = reinterpret_cast<QueryCounterProc>(get_proc("glQueryCounter"));
+            mGetQueryObjectui64v = reinterpret_cast<GetQueryObjectui64vProc>(get_proc("glGetQueryObjectui64v"));
+            if (!mGetQueryObjectui64v)
+                mQueryCounter = nullptr;
+        }
+
+        if (hasMinGLVersion(3, 2) || checkExtension("GL_ARB_sync"))
+        {
+            mFenceSync = reinterpret_cast<FenceSyncProc>(get_proc("glFenceSync"));
+            mClientWaitSync = reinterpret_cast<ClientWaitSyncProc>(get_proc("glClientWaitSync"));
+            mDeleteSync = reinterpret_cast<DeleteSyncProc>(get_proc("glDeleteSync"));
+            if (!mClientWaitSync || !mDeleteSync)
+                mFenceSync = nullptr;
+        }
+
+        if (hasMinGLVersion(4, 5) || checkExtension("GL_ARB_clip_control"))
+        {
+            mClipControl = reinterpret_cast<ClipControlProc>(get_proc("glClipControl"));
+        }
+
         mStateCacheManager = mCurrentContext->createOrRetrieveStateCacheManager<GLStateCacheManager>();
+        mStateCacheManager->setDeferStateChanges(true);
 
         LogManager::getSingleton().logMessage("***************************");
         LogManager::getSingleton().logMessage("*** GL Renderer Started ***");
@@ -1393,6 +1502,18 @@ namespace Ogre {
         if (!mStateCacheManager->activateGLTextureUnit(unit))
             return;
 
+        // per unit state, so not part of the texture parameters
+        if (mCurrentCapabilities->hasCapability(Capabilities::MIPMAP_LOD_BIAS))
+        {
+            glTexEnvf(GL_TEXTURE_FILTER_CONTROL_EXT, GL_TEXTURE_LOD_BIAS_EXT, sampler.getMipmapBias());
+        }
+
+        // the parameters are stored with the texture, skip them if they are already set from
+        // an identical sampler
+        uint32 samplerHash = sampler.getHash();
+        if (mStateCacheManager->getTexSamplerHash() == samplerHash)
+            return;
+
         GLenum target = mTextureTypes[unit];
 
         const Sampler::UVWAddressingMode& uvw = sampler.getAddressingMode();
@@ -1403,11 +1524,6 @@ namespace Ogre {
         if (uvw.u == TextureAddressingMode::BORDER || uvw.v == TextureAddressingMode::BORDER || uvw.w == TextureAddressingMode::BORDER)
             glTexParameterfv( target, GL_TEXTURE_BORDER_COLOR, sampler.getBorderColour().ptr());
 
-        if (mCurrentCapabilities->hasCapability(Capabilities::MIPMAP_LOD_BIAS))
-        {
-            glTexEnvf(GL_TEXTURE_FILTER_CONTROL_EXT, GL_TEXTURE_LOD_BIAS_EXT, sampler.getMipmapBias());
-        }
-
         if (mCurrentCapabilities->hasCapability(Capabilities::ANISOTROPY))
             mStateCacheManager->setTexParameteri(
                 target, GL_TEXTURE_MAX_ANISOTROPY_EXT,
@@ -1419,8 +1535,14 @@ namespace Ogre {
                                                  sampler.getCompareEnabled() ? GL_COMPARE_REF_DEPTH_TO_TEXTURE_EXT
                                                                              : GL_NONE);
             if (sampler.getCompareEnabled())
+            {
+                // the reference is the reversed depth as well
+                CompareFunction compareFunction = sampler.getCompareFunction();
+                if (mIsReverseDepthBufferEnabled)
+                    compareFunction = reverseCompareFunction(compareFunction);
                 mStateCacheManager->setTexParameteri(target, GL_TEXTURE_COMPARE_FUNC,
-                                                     convertCompareFunction(sampler.getCompareFunction()));
+                                                     convertCompareFunction(compareFunction));
+            }
         }
 
         // Combine with existing mip filter
@@ -1440,6 +1562,8 @@ namespace Ogre {
             mStateCacheManager->setTexParameteri(target, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
             break;
         }
+
+        mStateCacheManager->setTexSamplerHash(samplerHash);
     }
 
     //-----------------------------------------------------------------------------
@@ -1727,6 +1851,9 @@ namespace Ogre {
         // outside via the resource manager
         unbindGpuProgram(GpuProgramType::VERTEX_PROGRAM);
         unbindGpuProgram(GpuProgramType::FRAGMENT_PROGRAM);
+
+        // issue this frame's share of the staged texture uploads
+        _flushTextureUploads();
     }
 
     //-----------------------------------------------------------------------------
@@ -1771,7 +1898,7 @@ namespace Ogre {
     {
         if (enabled)
         {
-            mStateCacheManager->setClearDepth(1.0f);
+            mStateCacheManager->setClearDepth(mIsReverseDepthBufferEnabled ? 0.0f : 1.0f);
         }
         mStateCacheManager->setEnabled(GL_DEPTH_TEST, enabled);
     }
@@ -1786,6 +1913,8 @@ namespace Ogre {
     //-----------------------------------------------------------------------------
     void GLRenderSystem::_setDepthBufferFunction(CompareFunction func)
     {
+        if (mIsReverseDepthBufferEnabled)
+            func = reverseCompareFunction(func);
         mStateCacheManager->setDepthFunc(convertCompareFunction(func));
     }
     //-----------------------------------------------------------------------------
@@ -1798,7 +1927,11 @@ namespace Ogre {
 
         if (enable)
         {
-            glPolygonOffset(-slopeScaleBias, -constantBias);
+            // pull towards the camera, which is the larger depth when reversed
+            if (mIsReverseDepthBufferEnabled)
+                glPolygonOffset(slopeScaleBias, constantBias);
+            else
+                glPolygonOffset(-slopeScaleBias, -constantBias);
         }
     }
     //-----------------------------------------------------------------------------
@@ -2292,10 +2425,6 @@ namespace Ogre {
         // Call super class
         RenderSystem::_render(op);
 
-        mMaxBuiltInTextureAttribIndex = 0;
-
-        HardwareVertexBufferSharedPtr globalInstanceVertexBuffer = getGlobalInstanceVertexBuffer();
-        VertexDeclaration* globalVertexDeclaration = getGlobalInstanceVertexBufferVertexDeclaration();
         size_t numberOfInstances = op.numberOfInstances;
 
         if (op.useGlobalInstancingVertexBufferIsAvailable)
@@ -2303,36 +2432,156 @@ namespace Ogre {
             numberOfInstances *= getGlobalNumberOfInstances();
         }
 
-        const VertexDeclaration::VertexElementList& decl =
-            op.vertexData->vertexDeclaration->getElements();
-        for (const auto & elem : decl)
+        bindVertexArrays(op);
+        mStateCacheManager->flushDeferredState();
+
+        GLint primType = getGLPrimitiveType(op.operationType);
+
+        if (op.useIndexes)
+        {
+            void* pBufferData = nullptr;
+            GLHardwareBuffer* hwGlIndexBuffer = op.indexData->indexBuffer->_getImpl<GLHardwareBuffer>();
+            mStateCacheManager->bindGLBuffer(GL_ELEMENT_ARRAY_BUFFER_ARB, hwGlIndexBuffer->getGLBufferId());
+
+            pBufferData = VBO_BUFFER_OFFSET(hwGlIndexBuffer->getGLBufferOffset() +
+                op.indexData->indexStart * op.indexData->indexBuffer->getIndexSize());
+
+            GLenum indexType = (op.indexData->indexBuffer->getType() == HardwareIndexBuffer::IndexType::_16BIT) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+
+            do
+            {
+                if(numberOfInstances > 1)
+                {
+                    glDrawElementsInstancedARB(primType, op.indexData->indexCount, indexType, pBufferData, numberOfInstances);
+                }
+                else
+                {
+                    glDrawElements(primType, op.indexData->indexCount, indexType, pBufferData);
+                }
+            } while (updatePassIterationRenderState());
+
+        }
+        else
+        {
+            do
+            {
+                if(numberOfInstances > 1)
+                {
+                    glDrawArraysInstancedARB(primType, 0, op.vertexData->vertexCount, numberOfInstances);
+                }
+                else
+                {
+                    glDrawArrays(primType, 0, op.vertexData->vertexCount);
+                }
+            } while (updatePassIterationRenderState());
+        }
+
+    }
+    //---------------------------------------------------------------------
+    void GLRenderSystem::_renderMultiple(std::span<const RenderOperation* const> ops)
+    {
+        // glMultiDrawElements takes one set of arrays, one index buffer and one primitive type
+        const RenderOperation& first = *ops.front();
+        bool canMerge = ops.size() > 1 && first.useIndexes && getCapabilities()->hasCapability(Capabilities::MULTI_DRAW);
+        for (auto op : ops)
         {
-            size_t source = elem.getSource();
+            if (!canMerge)
+                break;
+            canMerge = op->useIndexes && op->vertexData == first.vertexData &&
+                       op->indexData->indexBuffer == first.indexData->indexBuffer &&
+                       op->operationType == first.operationType && op->numberOfInstances <= 1 &&
+                       !(op->useGlobalInstancingVertexBufferIsAvailable && getGlobalInstanceVertexBuffer());
+        }
 
-            if (!op.vertexData->vertexBufferBinding->isBufferBound(source))
-                continue; // skip unbound elements
+        if (!canMerge)
+        {
+            RenderSystem::_renderMultiple(ops);
+            return;
+        }
+
+        // account for the faces and vertices of every operation, but for one batch and draw call
+        for (auto op : ops)
+            RenderSystem::_render(*op);
+        mBatchCount -= (ops.size() - 1) * mCurrentPassIterationCount;
+        currentRenderStats().drawCalls -= (ops.size() - 1) * mCurrentPassIterationCount;
+
+        bindVertexArrays(first);
+        mStateCacheManager->flushDeferredState();
 
-            HardwareVertexBufferSharedPtr vertexBuffer =
-                op.vertexData->vertexBufferBinding->getBuffer(source);
+        GLint primType = getGLPrimitiveType(first.operationType);
 
-            bindVertexElementToGpu(elem, vertexBuffer, op.vertexData->vertexStart);
+        HardwareIndexBuffer* indexBuffer = first.indexData->indexBuffer.get();
+        GLHardwareBuffer* hwGlIndexBuffer = indexBuffer->_getImpl<GLHardwareBuffer>();
+        mStateCacheManager->bindGLBuffer(GL_ELEMENT_ARRAY_BUFFER_ARB, hwGlIndexBuffer->getGLBufferId());
+
+        mMultiDrawCounts.clear();
+        mMultiDrawIndices.clear();
+        for (auto op : ops)
+        {
+            mMultiDrawCounts.push_back(static_cast<GLsizei>(op->indexData->indexCount));
+            mMultiDrawIndices.push_back(VBO_BUFFER_OFFSET(hwGlIndexBuffer->getGLBufferOffset() +
+                                                          op->indexData->indexStart * indexBuffer->getIndexSize()));
         }
 
-        if( globalInstanceVertexBuffer && globalVertexDeclaration != nullptr )
+        GLenum indexType = (indexBuffer->getType() == HardwareIndexBuffer::IndexType::_16BIT) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+
+        do
         {
-            for (const auto & elem : globalVertexDeclaration->getElements())
+            glMultiDrawElements(primType, mMultiDrawCounts.data(), indexType, mMultiDrawIndices.data(),
+                                static_cast<GLsizei>(ops.size()));
+        } while (updatePassIterationRenderState());
+    }
+    //---------------------------------------------------------------------
+    void GLRenderSystem::bindVertexArrays(const RenderOperation& op)
+    {
+        HardwareVertexBufferSharedPtr globalInstanceVertexBuffer = getGlobalInstanceVertexBuffer();
+        VertexDeclaration* globalVertexDeclaration = getGlobalInstanceVertexBufferVertexDeclaration();
+
+        // The arrays stay bound after the draw, so consecutive draws of the same geometry
+        // with the same program only have to compare the signatures
+        buildVertexArraySignature(op, globalInstanceVertexBuffer, globalVertexDeclaration,
+                                  mVertexArraySignatureScratch);
+        if (!mVertexArraysBound || mVertexArraySignatureScratch != mVertexArraySignature)
+        {
+            unbindVertexArrays();
+
+            const VertexDeclaration::VertexElementList& decl =
+                op.vertexData->vertexDeclaration->getElements();
+            for (const auto & elem : decl)
             {
-                bindVertexElementToGpu(elem, globalInstanceVertexBuffer, 0);
+                size_t source = elem.getSource();
+
+                if (!op.vertexData->vertexBufferBinding->isBufferBound(source))
+                    continue; // skip unbound elements
+
+                HardwareVertexBufferSharedPtr vertexBuffer =
+                    op.vertexData->vertexBufferBinding->getBuffer(source);
+
+                bindVertexElementToGpu(elem, vertexBuffer, op.vertexData->vertexStart);
             }
-        }
 
-        bool multitexturing = (getCapabilities()->getNumTextureUnits() > 1);
-        if (multitexturing)
-            glClientActiveTextureARB(GL_TEXTURE0);
+            if( globalInstanceVertexBuffer && globalVertexDeclaration != nullptr )
+            {
+                for (const auto & elem : globalVertexDeclaration->getElements())
+                {
+                    bindVertexElementToGpu(elem, globalInstanceVertexBuffer, 0);
+                }
+            }
 
-        // Find the correct type to render
+            if (getCapabilities()->getNumTextureUnits() > 1)
+                glClientActiveTextureARB(GL_TEXTURE0);
+
+            // only valid up to GL_MAX_TEXTURE_UNITS, which is recorded in mFixedFunctionTextureUnits
+            mNumTexCoordArraysBound = std::max(std::min((unsigned short)mDisabledTexUnitsFrom, mFixedFunctionTextureUnits),
+                                               (unsigned short)(mMaxBuiltInTextureAttribIndex + 1));
+            std::swap(mVertexArraySignature, mVertexArraySignatureScratch);
+            mVertexArraysBound = true;
+        }
+    }
+    //---------------------------------------------------------------------
+    auto GLRenderSystem::getGLPrimitiveType(RenderOperation::OperationType operationType) const -> GLint
+    {
         GLint primType;
-        auto operationType = op.operationType;
         using enum RenderOperation::OperationType;
         // Use adjacency if there is a geometry program and it requested adjacency info
         if(mGeometryProgramBound && mCurrentGeometryProgram && dynamic_cast<GpuProgram*>(mCurrentGeometryProgram)->isAdjacencyInfoRequired())
@@ -2371,52 +2620,61 @@ namespace Ogre {
             primType = GL_TRIANGLE_FAN;
             break;
         }
+        return primType;
+    }
+    //---------------------------------------------------------------------
+    void GLRenderSystem::buildVertexArraySignature(const RenderOperation& op,
+                                                   const HardwareVertexBufferSharedPtr& instanceBuffer,
+                                                   const VertexDeclaration* instanceDeclaration,
+                                                   std::vector<size_t>& signature) const
+    {
+        signature.clear();
+
+        // the program decides which elements are passed as generic attributes
+        signature.push_back(reinterpret_cast<size_t>(mCurrentVertexProgram));
+        signature.push_back(mEnableFixedPipeline);
+        if (!mCurrentVertexProgram)
+        {
+            // the fixed function texture units pick their coordinates by index
+            signature.push_back(mDisabledTexUnitsFrom);
+            for (size_t i = 0; i < std::min<size_t>(mDisabledTexUnitsFrom, mFixedFunctionTextureUnits); ++i)
+                signature.push_back(mTextureCoordIndex[i]);
+        }
+
+        // the buffer names and offsets, as the binding may have changed under the same pointers
+        auto addElement = [&](const VertexElement& elem, const HardwareVertexBufferSharedPtr& buffer, size_t vertexStart)
+        {
+            GLHardwareBuffer* hwGlBuffer = buffer->_getImpl<GLHardwareBuffer>();
+            signature.push_back(hwGlBuffer->getGLBufferId());
+            signature.push_back(hwGlBuffer->getGLBufferOffset() + elem.getOffset() + vertexStart * buffer->getVertexSize());
+            signature.push_back(buffer->getVertexSize());
+            signature.push_back(std::to_underlying(elem.getType()) | std::to_underlying(elem.getSemantic()) << 8 |
+                                size_t(elem.getIndex()) << 16);
+            signature.push_back(buffer->isInstanceData() ? buffer->getInstanceDataStepRate() : 0);
+        };
 
-        if (op.useIndexes)
+        const VertexBufferBinding* binding = op.vertexData->vertexBufferBinding;
+        for (const auto& elem : op.vertexData->vertexDeclaration->getElements())
         {
-            void* pBufferData = nullptr;
-            mStateCacheManager->bindGLBuffer(GL_ELEMENT_ARRAY_BUFFER_ARB,
-                                op.indexData->indexBuffer->_getImpl<GLHardwareBuffer>()->getGLBufferId());
-
-            pBufferData = VBO_BUFFER_OFFSET(
-                op.indexData->indexStart * op.indexData->indexBuffer->getIndexSize());
-
-            GLenum indexType = (op.indexData->indexBuffer->getType() == HardwareIndexBuffer::IndexType::_16BIT) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
-
-            do
-            {
-                if(numberOfInstances > 1)
-                {
-                    glDrawElementsInstancedARB(primType, op.indexData->indexCount, indexType, pBufferData, numberOfInstances);
-                }
-                else
-                {
-                    glDrawElements(primType, op.indexData->indexCount, indexType, pBufferData);
-                }
-            } while (updatePassIterationRenderState());
-
+            if (binding->isBufferBound(elem.getSource()))
+                addElement(elem, binding->getBuffer(elem.getSource()), op.vertexData->vertexStart);
         }
-        else
+
+        if (instanceBuffer && instanceDeclaration)
         {
-            do
-            {
-                if(numberOfInstances > 1)
-                {
-                    glDrawArraysInstancedARB(primType, 0, op.vertexData->vertexCount, numberOfInstances);
-                }
-                else
-                {
-                    glDrawArrays(primType, 0, op.vertexData->vertexCount);
-                }
-            } while (updatePassIterationRenderState());
+            for (const auto& elem : instanceDeclaration->getElements())
+                addElement(elem, instanceBuffer, 0);
         }
+    }
+    //---------------------------------------------------------------------
+    void GLRenderSystem::unbindVertexArrays()
+    {
+        mVertexArraysBound = false;
 
         glDisableClientState( GL_VERTEX_ARRAY );
-        // only valid up to GL_MAX_TEXTURE_UNITS, which is recorded in mFixedFunctionTextureUnits
-        if (multitexturing)
+        if (getCapabilities()->getNumTextureUnits() > 1)
         {
-            unsigned short mNumEnabledTextures = std::max(std::min((unsigned short)mDisabledTexUnitsFrom, mFixedFunctionTextureUnits), (unsigned short)(mMaxBuiltInTextureAttribIndex + 1));		
-            for (unsigned short i = 0; i < mNumEnabledTextures; i++)
+            for (unsigned short i = 0; i < mNumTexCoordArraysBound; i++)
             {
                 // No need to disable for texture units that weren't used
                 glClientActiveTextureARB(GL_TEXTURE0 + i);
@@ -2448,7 +2706,8 @@ namespace Ogre {
 
         mRenderAttribsBound.clear();
         mRenderInstanceAttribsBound.clear();
-
+        mMaxBuiltInTextureAttribIndex = 0;
+        mNumTexCoordArraysBound = 0;
     }
     //---------------------------------------------------------------------
     void GLRenderSystem::setNormaliseNormals(bool normalise)
@@ -2551,6 +2810,29 @@ namespace Ogre {
 
     }
     //---------------------------------------------------------------------
+    void GLRenderSystem::_prelinkGpuPrograms(const Pass* pass)
+    {
+        auto* linkProgramManager = GLSL::GLSLLinkProgramManager::getSingletonPtr();
+        if (!linkProgramManager)
+            return;
+
+        GLShaderList shaders{};
+        for (auto type : {GpuProgramType::VERTEX_PROGRAM, GpuProgramType::GEOMETRY_PROGRAM,
+                          GpuProgramType::FRAGMENT_PROGRAM})
+        {
+            if (!pass->hasGpuProgram(type))
+                continue;
+
+            // only GLSL programs are linked, the pass may also mix in other kinds
+            auto* shader = dynamic_cast<GLSL::GLSLProgram*>(pass->getGpuProgram(type)->_getBindingDelegate());
+            if (!shader)
+                return;
+            shaders[std::to_underlying(type)] = shader;
+        }
+
+        linkProgramManager->prelinkProgram(shaders);
+    }
+    //---------------------------------------------------------------------
     void GLRenderSystem::bindGpuProgramParameters(GpuProgramType gptype, const GpuProgramParametersPtr& params, GpuParamVariability mask)
     {
         if (!!(mask & GpuParamVariability::GLOBAL))
@@ -2561,19 +2843,27 @@ namespace Ogre {
             params->_copySharedParams();
         }
 
+        // the parameters of a pass are bound again for every renderable, only take a new
+        // reference when they change
+        auto setActive = [&](GpuProgramParametersSharedPtr& active)
+        {
+            if (active != params)
+                active = params;
+        };
+
         using enum GpuProgramType;
         switch (gptype)
         {
         case VERTEX_PROGRAM:
-            mActiveVertexGpuProgramParameters = params;
+            setActive(mActiveVertexGpuProgramParameters);
             mCurrentVertexProgram->bindProgramParameters(params, mask);
             break;
         case GEOMETRY_PROGRAM:
-            mActiveGeometryGpuProgramParameters = params;
+            setActive(mActiveGeometryGpuProgramParameters);
             mCurrentGeometryProgram->bindProgramParameters(params, mask);
             break;
         case FRAGMENT_PROGRAM:
-            mActiveFragmentGpuProgramParameters = params;
+            setActive(mActiveFragmentGpuProgramParameters);
             mCurrentFragmentProgram->bindProgramParameters(params, mask);
             break;
         case COMPUTE_PROGRAM:
@@ -2682,7 +2972,7 @@ namespace Ogre {
             {
                 mStateCacheManager->setDepthMask( GL_TRUE );
             }
-            mStateCacheManager->setClearDepth(depth);
+            mStateCacheManager->setClearDepth(mIsReverseDepthBufferEnabled ? 1.0f - depth : depth);
         }
         if (!!(buffers & FrameBufferType::STENCIL))
         {
@@ -2704,6 +2994,7 @@ namespace Ogre {
         }
 
         // Clear buffers
+        mStateCacheManager->flushDeferredState();
         glClear(flags);
 
         // Restore scissor test
@@ -2740,8 +3031,10 @@ namespace Ogre {
         // Set nicer lighting model -- d3d9 has this by default
         glLightModeli(GL_LIGHT_MODEL_COLOR_CONTROL, GL_SEPARATE_SPECULAR_COLOR);
         glLightModeli(GL_LIGHT_MODEL_LOCAL_VIEWER, 1);
-        mStateCacheManager->setEnabled(GL_COLOR_SUM, true);
-        mStateCacheManager->setEnabled(GL_DITHER, false);
+        // also called on background threads, which have their own state cache
+        GLStateCacheManager* stateCache = _getStateCacheManager();
+        stateCache->setEnabled(GL_COLOR_SUM, true);
+        stateCache->setEnabled(GL_DITHER, false);
 
         // Check for FSAA
         // Enable the extension if it was enabled by the GLSupport
@@ -2751,7 +3044,7 @@ namespace Ogre {
             glGetIntegerv(GL_SAMPLE_BUFFERS_ARB,(GLint*)&fsaa_active);
             if(fsaa_active)
             {
-                mStateCacheManager->setEnabled(GL_MULTISAMPLE_ARB, true);
+                stateCache->setEnabled(GL_MULTISAMPLE_ARB, true);
                 LogManager::getSingleton().logMessage("Using FSAA from GL_ARB_multisample extension.");
             }            
         }
@@ -2761,6 +3054,82 @@ namespace Ogre {
             // Enable seamless cube maps
             glEnable(GL_TEXTURE_CUBE_MAP_SEAMLESS);
 		}
+
+        // _convertProjectionMatrix maps the near plane to 1 and the far plane to 0, which
+        // needs the clip space depth range of D3D to keep the precision of float buffers
+        if (mIsReverseDepthBufferEnabled)
+            mClipControl(GL_LOWER_LEFT, GL_ZERO_TO_ONE);
+    }
+
+    //---------------------------------------------------------------------
+    auto GLRenderSystem::_getStateCacheManager() noexcept -> GLStateCacheManager*
+    {
+        if (GLContext* threadContext = _getThreadContext())
+            return threadContext->createOrRetrieveStateCacheManager<GLStateCacheManager>();
+        return mStateCacheManager;
+    }
+
+    //---------------------------------------------------------------------
+    void GLRenderSystem::_finishThreadWork()
+    {
+        if (!_getThreadContext())
+            return;
+
+        if (!mFenceSync)
+        {
+            glFinish();
+            return;
+        }
+
+        // flushing makes sure the fence is ever reached
+        GLsync fence = mFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        if (mClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED) == GL_WAIT_FAILED)
+            glFinish();
+        mDeleteSync(fence);
+    }
+    //---------------------------------------------------------------------
+    void GLRenderSystem::_swapAllRenderTargetBuffers()
+    {
+        RenderSystem::_swapAllRenderTargetBuffers();
+
+        if (!mFenceSync)
+            return;
+
+        mFrameFences.push_back(mFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+
+        // drop the frames which are done already, so the queue stays short without waiting
+        while (mFrameFences.size() > 1)
+        {
+            GLenum status = mClientWaitSync(mFrameFences.front(), 0, 0);
+            if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+                break;
+            mDeleteSync(mFrameFences.front());
+            mFrameFences.pop_front();
+        }
+
+        if (mMaxFramesInFlight > 0)
+            _waitForFramesInFlight(mMaxFramesInFlight);
+    }
+    //---------------------------------------------------------------------
+    void GLRenderSystem::_waitForFramesInFlight(uint32 frames)
+    {
+        while (mFrameFences.size() > frames)
+        {
+            // flushing makes sure the fence is ever reached
+            mClientWaitSync(mFrameFences.front(), GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+            mDeleteSync(mFrameFences.front());
+            mFrameFences.pop_front();
+        }
+    }
+    //---------------------------------------------------------------------
+    void GLRenderSystem::releaseFrameFences()
+    {
+        if (mDeleteSync)
+        {
+            for (auto fence : mFrameFences)
+                mDeleteSync(fence);
+        }
+        mFrameFences.clear();
     }
 
     //---------------------------------------------------------------------
@@ -2786,15 +3155,21 @@ namespace Ogre {
         // Disable textures
         _disableTextureUnitsFrom(0);
 
+        // The arrays are client state of the old context
+        if (mVertexArraysBound)
+            unbindVertexArrays();
+
         // It's ready for switching
         if (mCurrentContext!=context)
         {
+            mStateCacheManager->flushDeferredState();
             mCurrentContext->endCurrent();
             mCurrentContext = context;
         }
         mCurrentContext->setCurrent();
 
         mStateCacheManager = mCurrentContext->createOrRetrieveStateCacheManager<GLStateCacheManager>();
+        mStateCacheManager->setDeferStateChanges(true);
 
         // Check if the context has already done one-time initialisation
         if(!mCurrentContext->getInitialized())
@@ -2884,12 +3259,100 @@ namespace Ogre {
     void GLRenderSystem::beginProfileEvent( std::string_view eventName )
     {
         markProfileEvent(::std::format("Begin Event: {}", eventName));
+
+        // bound the pending events, in case nobody collects them
+        static constexpr size_t MAX_TIMED_EVENTS = 4096;
+
+        TimedProfileEvent* event = nullptr;
+        if (mProfileEventTiming && mQueryCounter && mCurrentContext == mMainContext &&
+            mTimedProfileEvents.size() < MAX_TIMED_EVENTS)
+        {
+            event = &mTimedProfileEvents.emplace_back(
+                String{eventName}, static_cast<uint32>(mOpenProfileEvents.size()), allocateTimerQuery());
+            mQueryCounter(event->begin, GL_TIMESTAMP);
+        }
+        mOpenProfileEvents.push_back(event);
     }
 
     //---------------------------------------------------------------------
     void GLRenderSystem::endProfileEvent( )
     {
         markProfileEvent("End Event");
+
+        if (mOpenProfileEvents.empty())
+            return;
+        if (TimedProfileEvent* event = mOpenProfileEvents.back())
+        {
+            event->end = allocateTimerQuery();
+            mQueryCounter(event->end, GL_TIMESTAMP);
+        }
+        mOpenProfileEvents.pop_back();
+    }
+
+    //---------------------------------------------------------------------
+    void GLRenderSystem::setProfileEventTiming(bool enabled)
+    {
+        RenderSystem::setProfileEventTiming(enabled);
+        if (!enabled)
+            releaseTimerQueries();
+    }
+
+    //---------------------------------------------------------------------
+    void GLRenderSystem::_getProfileEventTimings(ProfileEventTimings& timings)
+    {
+        // timestamps complete in order, so stop at the first pending event
+        while (!mTimedProfileEvents.empty())
+        {
+            TimedProfileEvent& event = mTimedProfileEvents.front();
+            if (!event.end)
+                break;
+
+            GLuint available = GL_FALSE;
+            glGetQueryObjectuiv(event.end, GL_QUERY_RESULT_AVAILABLE, &available);
+            if (!available)
+                break;
+
+            GLuint64 begin = 0, end = 0;
+            mGetQueryObjectui64v(event.begin, GL_QUERY_RESULT, &begin);
+            mGetQueryObjectui64v(event.end, GL_QUERY_RESULT, &end);
+            timings.push_back({std::move(event.name), event.depth, end > begin ? end - begin : 0});
+
+            mFreeTimerQueries.push_back(event.begin);
+            mFreeTimerQueries.push_back(event.end);
+            mTimedProfileEvents.pop_front();
+        }
+    }
+
+    //---------------------------------------------------------------------
+    auto GLRenderSystem::allocateTimerQuery() -> GLuint
+    {
+        if (mFreeTimerQueries.empty())
+        {
+            GLuint query;
+            glGenQueries(1, &query);
+            return query;
+        }
+        GLuint query = mFreeTimerQueries.back();
+        mFreeTimerQueries.pop_back();
+        return query;
+    }
+
+    //---------------------------------------------------------------------
+    void GLRenderSystem::releaseTimerQueries()
+    {
+        for (auto& event : mTimedProfileEvents)
+        {
+            mFreeTimerQueries.push_back(event.begin);
+            if (event.end)
+                mFreeTimerQueries.push_back(event.end);
+        }
+        mTimedProfileEvents.clear();
+        // still open events end without being timed
+        std::ranges::fill(mOpenProfileEvents, nullptr);
+
+        if (mMainContext && !mFreeTimerQueries.empty())
+            glDeleteQueries(static_cast<GLsizei>(mFreeTimerQueries.size()), mFreeTimerQueries.data());
+        mFreeTimerQueries.clear();
     }
 
     //---------------------------------------------------------------------
@@ -2908,11 +3371,11 @@ namespace Ogre {
                                                 const size_t vertexStart)
     {
         void* pBufferData = nullptr;
-        const GLHardwareBuffer* hwGlBuffer = vertexBuffer->_getImpl<GLHardwareBuffer>();
+        GLHardwareBuffer* hwGlBuffer = vertexBuffer->_getImpl<GLHardwareBuffer>();
 
         mStateCacheManager->bindGLBuffer(GL_ARRAY_BUFFER_ARB, 
                         hwGlBuffer->getGLBufferId());
-        pBufferData = VBO_BUFFER_OFFSET(elem.getOffset());
+        pBufferData = VBO_BUFFER_OFFSET(hwGlBuffer->getGLBufferOffset() + elem.getOffset());
 
         if (vertexStart)
         {
@@ -2952,6 +3415,7 @@ namespace Ogre {
             case USHORT2_NORM:
             case SHORT4_NORM:
             case USHORT4_NORM:
+            case INT_10_10_10_2_NORM:
                 normalised = GL_TRUE;
                 break;
             default:
@@ -3080,6 +3544,207 @@ namespace Ogre {
         glPixelStorei(GL_PACK_ROW_LENGTH, 0);
 
         PixelUtil::bulkPixelVerticalFlip(dst);
+    }
+    //---------------------------------------------------------------------
+    auto GLRenderSystem::_startReadback(Viewport* vp, const Box& src, PixelFormat format,
+                                        RenderWindow::FrameBuffer buffer) -> uint32
+    {
+        GLenum glFormat = GLPixelUtil::getGLOriginFormat(format);
+        GLenum type = GLPixelUtil::getGLOriginDataType(format);
+
+        if ((glFormat == GL_NONE) || (type == 0))
+        {
+            OGRE_EXCEPT(ExceptionCodes::INVALIDPARAMS, "Unsupported format.", "GLRenderSystem::_startReadback" );
+        }
+
+        // Switch context if different from current one
+        _setViewport(vp);
+
+        auto& readback = mPendingReadbacks[++mLastReadbackTicket];
+        readback.box = PixelBox(src.getWidth(), src.getHeight(), 1, format);
+        size_t size = readback.box.getConsecutiveSize();
+
+        // Reading into a pixel pack buffer returns without waiting for the GPU
+        void* pDest = nullptr;
+        if (GLAD_GL_ARB_pixel_buffer_object)
+        {
+            if (mFreeReadbackBuffers.empty())
+            {
+                GLuint id = 0;
+                glGenBuffersARB(1, &id);
+                mFreeReadbackBuffers.push_back(id);
+            }
+            readback.buffer = mFreeReadbackBuffers.back();
+            mFreeReadbackBuffers.pop_back();
+
+            mStateCacheManager->bindGLBuffer(GL_PIXEL_PACK_BUFFER_ARB, readback.buffer);
+            glBufferDataARB(GL_PIXEL_PACK_BUFFER_ARB, size, nullptr, GL_STREAM_READ_ARB);
+        }
+        else
+        {
+            readback.data.resize(size);
+            pDest = readback.data.data();
+        }
+
+        glPixelStorei(GL_PACK_ALIGNMENT, 1);
+        glReadBuffer((buffer == RenderWindow::FrameBuffer::FRONT)? GL_FRONT : GL_BACK);
+
+        uint32_t height = vp->getTarget()->getHeight();
+        glReadPixels((GLint)src.left, (GLint)(height - src.bottom),
+                     (GLsizei)src.getWidth(), (GLsizei)src.getHeight(),
+                     glFormat, type, pDest);
+
+        glPixelStorei(GL_PACK_ALIGNMENT, 4);
+        if (readback.buffer)
+            mStateCacheManager->bindGLBuffer(GL_PIXEL_PACK_BUFFER_ARB, 0);
+
+        return mLastReadbackTicket;
+    }
+    //---------------------------------------------------------------------
+    void GLRenderSystem::_finishReadback(uint32 ticket, const PixelBox& dst, bool bottomUp)
+    {
+        auto it = mPendingReadbacks.find(ticket);
+        OgreAssert(it != mPendingReadbacks.end(), "Unknown readback ticket");
+        PendingReadback& readback = it->second;
+
+        PixelBox src = readback.box;
+        src.data = readback.data.data();
+        if (readback.buffer)
+        {
+            mStateCacheManager->bindGLBuffer(GL_PIXEL_PACK_BUFFER_ARB, readback.buffer);
+            src.data = static_cast<uchar*>(glMapBufferARB(GL_PIXEL_PACK_BUFFER_ARB, GL_READ_ONLY_ARB));
+            if (!src.data)
+            {
+                OGRE_EXCEPT(ExceptionCodes::INTERNAL_ERROR, "Cannot map readback buffer");
+            }
+        }
+
+        if (dst.format == src.format && !bottomUp)
+        {
+            // flip the rows while copying them
+            size_t rowSize = PixelUtil::getMemorySize(src.getWidth(), 1, 1, src.format);
+            size_t dstRowPitch = dst.rowPitch * PixelUtil::getNumElemBytes(dst.format);
+            const uchar* srcRow = src.data + rowSize * (src.getHeight() - 1);
+            uchar* dstRow = dst.getTopLeftFrontPixelPtr();
+            for (uint32 y = 0; y < src.getHeight(); ++y, srcRow -= rowSize, dstRow += dstRowPitch)
+                memcpy(dstRow, srcRow, rowSize);
+        }
+        else
+        {
+            PixelUtil::bulkPixelConversion(src, dst);
+            if (!bottomUp)
+                PixelUtil::bulkPixelVerticalFlip(dst);
+        }
+
+        if (readback.buffer)
+        {
+            glUnmapBufferARB(GL_PIXEL_PACK_BUFFER_ARB);
+            mStateCacheManager->bindGLBuffer(GL_PIXEL_PACK_BUFFER_ARB, 0);
+            mFreeReadbackBuffers.push_back(readback.buffer);
+        }
+        mPendingReadbacks.erase(it);
+    }
+    //---------------------------------------------------------------------
+    void GLRenderSystem::setTextureUploadBudget(size_t bytesPerFrame)
+    {
+        mTextureUploadBudget = bytesPerFrame;
+        if (!mTextureUploadBudget)
+        {
+            while (!mPendingTextureUploads.empty())
+            {
+                issueTextureUpload(mPendingTextureUploads.front());
+                mPendingTextureUploads.pop_front();
+            }
+        }
+    }
+    //---------------------------------------------------------------------
+    auto GLRenderSystem::_queueTextureUpload(GLTextureBuffer* target, const PixelBox& data, const Box& dest) -> bool
+    {
+        if (!mTextureUploadBudget || !GLAD_GL_ARB_pixel_buffer_object)
+            return false;
+
+        bool compressed = PixelUtil::isCompressed(data.format);
+        // let the direct path report the error
+        if (compressed && !data.isConsecutive())
+            return false;
+
+        if (mFreeUploadBuffers.empty())
+        {
+            GLuint id = 0;
+            glGenBuffersARB(1, &id);
+            mFreeUploadBuffers.push_back(id);
+        }
+
+        PendingTextureUpload upload{target, mFreeUploadBuffers.back(),
+                                    PixelBox(data.getWidth(), data.getHeight(), data.getDepth(), data.format), dest};
+        mFreeUploadBuffers.pop_back();
+        size_t size = upload.data.getConsecutiveSize();
+
+        // orphan the previous contents, so a reused buffer does not wait for its last copy
+        mStateCacheManager->bindGLBuffer(GL_PIXEL_UNPACK_BUFFER_ARB, upload.buffer);
+        glBufferDataARB(GL_PIXEL_UNPACK_BUFFER_ARB, size, nullptr, GL_STREAM_DRAW_ARB);
+        void* pDest = glMapBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, GL_WRITE_ONLY_ARB);
+        if (compressed)
+            memcpy(pDest, data.data, size);
+        else
+            PixelUtil::bulkPixelConversion(data, PixelBox(data.getWidth(), data.getHeight(), data.getDepth(), data.format, pDest));
+        glUnmapBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB);
+        mStateCacheManager->bindGLBuffer(GL_PIXEL_UNPACK_BUFFER_ARB, 0);
+
+        mPendingTextureUploads.push_back(upload);
+        return true;
+    }
+    //---------------------------------------------------------------------
+    void GLRenderSystem::issueTextureUpload(const PendingTextureUpload& upload)
+    {
+        // the pixels are sourced from the buffer, the copy does not stall on client memory
+        mStateCacheManager->bindGLBuffer(GL_PIXEL_UNPACK_BUFFER_ARB, upload.buffer);
+        upload.target->_uploadNow(upload.data, upload.dest);
+        mStateCacheManager->bindGLBuffer(GL_PIXEL_UNPACK_BUFFER_ARB, 0);
+        mFreeUploadBuffers.push_back(upload.buffer);
+    }
+    //---------------------------------------------------------------------
+    void GLRenderSystem::_flushTextureUploads(GLTextureBuffer* target)
+    {
+        if (target)
+        {
+            for (auto it = mPendingTextureUploads.begin(); it != mPendingTextureUploads.end();)
+            {
+                if (it->target != target)
+                {
+                    ++it;
+                    continue;
+                }
+                issueTextureUpload(*it);
+                it = mPendingTextureUploads.erase(it);
+            }
+            return;
+        }
+
+        size_t bytes = 0;
+        while (!mPendingTextureUploads.empty())
+        {
+            const PendingTextureUpload& upload = mPendingTextureUploads.front();
+            size_t size = upload.data.getConsecutiveSize();
+            // always make progress, even if a single upload exceeds the budget
+            if (bytes && bytes + size > mTextureUploadBudget)
+                break;
+            issueTextureUpload(upload);
+            mPendingTextureUploads.pop_front();
+            bytes += size;
+        }
+    }
+    //---------------------------------------------------------------------
+    void GLRenderSystem::_discardTextureUploads(GLTextureBuffer* target)
+    {
+        std::erase_if(mPendingTextureUploads,
+                      [&](const PendingTextureUpload& upload)
+                      {
+                          if (upload.target != target)
+                              return false;
+                          mFreeUploadBuffers.push_back(upload.buffer);
+                          return true;
+                      });
     }
 	//---------------------------------------------------------------------
     void GLRenderSystem::initialiseExtensions()
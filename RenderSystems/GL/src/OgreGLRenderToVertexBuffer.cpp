@@ -155,7 +155,15 @@ namespace Ogre {
 
         bindVerticesOutput(r2vbPass);
 
-        r2vbPass->_updateAutoParams(sceneMgr->_getAutoParamDataSource(), GpuParamVariability::GLOBAL);
+        // per object params (e.g. bone matrices) come from the source renderable
+        AutoParamDataSource* autoParamSource = sceneMgr->_getAutoParamDataSource();
+        GpuParamVariability variability = GpuParamVariability::GLOBAL;
+        if (mSourceRenderable)
+        {
+            autoParamSource->setCurrentRenderable(mSourceRenderable);
+            variability = variability | GpuParamVariability::PER_OBJECT;
+        }
+        r2vbPass->_updateAutoParams(autoParamSource, variability);
 
         RenderOperation renderOp;
         size_t targetBufferIndex;
@@ -182,7 +190,7 @@ namespace Ogre {
         GLuint bufferId = vertexBuffer->getGLBufferId();
 
         //Bind the target buffer
-        glBindBufferOffsetNV(GL_TRANSFORM_FEEDBACK_BUFFER_NV, 0, bufferId, 0);
+        glBindBufferOffsetNV(GL_TRANSFORM_FEEDBACK_BUFFER_NV, 0, bufferId, vertexBuffer->getGLBufferOffset());
 
         glBeginTransformFeedbackNV(getR2VBPrimitiveType(mOperationType));
 
@@ -37,6 +37,8 @@ import :StateCacheManager;
 
 import Ogre.Core;
 
+import <algorithm>;
+
 namespace Ogre {
     
     GLStateCacheManager::GLStateCacheManager()
@@ -86,6 +88,18 @@ namespace Ogre {
         glColorMask(mColourMask[0], mColourMask[1], mColourMask[2], mColourMask[3]);
 
         glPolygonMode(GL_FRONT_AND_BACK, mPolygonMode);
+
+        mApplied.enabled.clear();
+        mApplied.blendEquation[0] = mApplied.blendEquation[1] = GL_FUNC_ADD;
+        mApplied.blendFunc[0] = mApplied.blendFunc[2] = GL_ONE;
+        mApplied.blendFunc[1] = mApplied.blendFunc[3] = GL_ZERO;
+        mApplied.depthFunc = mDepthFunc;
+        mApplied.cullFace = mCullFace;
+        mApplied.depthMask = mDepthMask;
+        std::ranges::copy(mColourMask, mApplied.colourMask);
+        // deferred changes from before the reset must not be flushed onto it
+        mPendingEnables.clear();
+        mDirtyState = 0;
     }
 
     void GLStateCacheManager::clearCache()
@@ -99,6 +113,7 @@ namespace Ogre {
         mActiveTextureUnit = 0;
         mClearDepth = 1.0f;
         mLastBoundTexID = 0;
+        mBoundFrameBuffer = 0;
         mShininess = 0.0f;
         mPolygonMode = GL_FILL;
         mShadeModel = GL_SMOOTH;
@@ -115,6 +130,7 @@ namespace Ogre {
 
         mActiveBufferMap.clear();
         mTexUnitsMap.clear();
+        mBoundTextures.clear();
         mTextureCoordGen.clear();
 
         mAmbient[0] = 0.2f;
@@ -148,13 +164,25 @@ namespace Ogre {
         mPointAttenuation[0] = 1.0f;
         mPointAttenuation[1] = 0.0f;
         mPointAttenuation[2] = 0.0f;
+
+        // the GL defaults, matching the values above
+        mApplied.enabled.clear();
+        mApplied.blendEquation[0] = mApplied.blendEquation[1] = GL_FUNC_ADD;
+        mApplied.blendFunc[0] = mApplied.blendFunc[2] = GL_ONE;
+        mApplied.blendFunc[1] = mApplied.blendFunc[3] = GL_ZERO;
+        mApplied.depthFunc = GL_LESS;
+        mApplied.cullFace = GL_BACK;
+        mApplied.depthMask = GL_TRUE;
+        std::ranges::fill(mApplied.colourMask, GL_TRUE);
+        mPendingEnables.clear();
+        mDirtyState = 0;
     }
 
     void GLStateCacheManager::bindGLBuffer(GLenum target, GLuint buffer, bool force)
     {
         if(target == GL_FRAMEBUFFER)
         {
-            OgreAssert(false, "not implemented");
+            bindGLFrameBuffer(buffer, force);
         }
         else if(target == GL_RENDERBUFFER)
         {
@@ -166,6 +194,15 @@ namespace Ogre {
         }
     }
 
+    void GLStateCacheManager::bindGLFrameBuffer(GLuint fb, bool force)
+    {
+        if (mBoundFrameBuffer == fb && !force)
+            return;
+        mBoundFrameBuffer = fb;
+
+        glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, fb);
+    }
+
     void GLStateCacheManager::deleteGLBuffer(GLenum target, GLuint buffer)
     {
         // Buffer name 0 is reserved and we should never try to delete it
@@ -174,7 +211,10 @@ namespace Ogre {
         
         if(target == GL_FRAMEBUFFER)
         {
-            glDeleteFramebuffers(1, &buffer);
+            glDeleteFramebuffersEXT(1, &buffer);
+            // deleting the bound framebuffer binds 0, and the name may be reused
+            if (mBoundFrameBuffer == buffer)
+                mBoundFrameBuffer = 0;
         }
         else if(target == GL_RENDERBUFFER)
         {
@@ -188,17 +228,67 @@ namespace Ogre {
 
     void GLStateCacheManager::invalidateStateForTexture(GLuint texture)
     {
+        // the name may be reused by a new texture
+        mTexUnitsMap.erase(texture);
+
+        // deleting a texture binds 0 in its place
+        for (auto& [unit, bound] : mBoundTextures)
+        {
+            if (bound.texture == texture)
+                bound.texture = 0;
+        }
+    }
+
+    void GLStateCacheManager::invalidateTextureBindings()
+    {
+        mBoundTextures.clear();
+        glActiveTexture(GL_TEXTURE0 + mActiveTextureUnit);
     }
 
     // TODO: Store as high/low bits of a GLuint, use vector instead of map for TexParameteriMap
     void GLStateCacheManager::setTexParameteri(GLenum target, GLenum pname, GLint param)
     {
+        auto unit = mBoundTextures.find(mActiveTextureUnit);
+        if (unit != mBoundTextures.end())
+        {
+            auto it = mTexUnitsMap.find(unit->second.texture);
+            if (it != mTexUnitsMap.end())
+                it->second.mSamplerHash = 0;
+        }
+        else
+        {
+            // the texture is unknown, so might be any of them
+            for (auto& [texture, params] : mTexUnitsMap)
+                params.mSamplerHash = 0;
+        }
+
         glTexParameteri(target, pname, param);
     }
+
+    auto GLStateCacheManager::getTexSamplerHash() const -> uint32
+    {
+        auto unit = mBoundTextures.find(mActiveTextureUnit);
+        if (unit == mBoundTextures.end() || !unit->second.texture)
+            return 0;
+        auto it = mTexUnitsMap.find(unit->second.texture);
+        return it != mTexUnitsMap.end() ? it->second.mSamplerHash : 0;
+    }
+
+    void GLStateCacheManager::setTexSamplerHash(uint32 hash)
+    {
+        auto unit = mBoundTextures.find(mActiveTextureUnit);
+        if (unit != mBoundTextures.end() && unit->second.texture)
+            mTexUnitsMap[unit->second.texture].mSamplerHash = hash;
+    }
     
     void GLStateCacheManager::bindGLTexture(GLenum target, GLuint texture)
     {
         mLastBoundTexID = texture;
+
+        auto& bound = mBoundTextures[mActiveTextureUnit];
+        if (bound.target == target && bound.texture == texture)
+            return;
+        bound = {target, texture};
         
         // Update GL
         glBindTexture(target, texture);
@@ -209,6 +299,9 @@ namespace Ogre {
         if (unit >= Root::getSingleton().getRenderSystem()->getCapabilities()->getNumTextureUnits())
             return false;
 
+        if (mActiveTextureUnit == unit)
+            return true;
+
         glActiveTexture(GL_TEXTURE0 + unit);
         mActiveTextureUnit = unit;
         return true;
@@ -221,21 +314,57 @@ namespace Ogre {
         mBlendFuncSourceAlpha = sourceA;
         mBlendFuncDestAlpha = destA;
 
-        glBlendFuncSeparate(source, dest, sourceA, destA);
+        ++mStateChangesRequested;
+        if (mDeferStateChanges)
+            mDirtyState |= DIRTY_BLEND_FUNC;
+        else
+            applyBlendFunc();
+    }
+
+    void GLStateCacheManager::applyBlendFunc()
+    {
+        glBlendFuncSeparate(mBlendFuncSource, mBlendFuncDest, mBlendFuncSourceAlpha, mBlendFuncDestAlpha);
+        mApplied.blendFunc[0] = mBlendFuncSource;
+        mApplied.blendFunc[1] = mBlendFuncDest;
+        mApplied.blendFunc[2] = mBlendFuncSourceAlpha;
+        mApplied.blendFunc[3] = mBlendFuncDestAlpha;
+        ++mStateChangesIssued;
     }
 
     void GLStateCacheManager::setDepthMask(GLboolean mask)
     {
         mDepthMask = mask;
 
-        glDepthMask(mask);
+        ++mStateChangesRequested;
+        if (mDeferStateChanges)
+            mDirtyState |= DIRTY_DEPTH_MASK;
+        else
+            applyDepthMask();
+    }
+
+    void GLStateCacheManager::applyDepthMask()
+    {
+        glDepthMask(mDepthMask);
+        mApplied.depthMask = mDepthMask;
+        ++mStateChangesIssued;
     }
     
     void GLStateCacheManager::setDepthFunc(GLenum func)
     {
         mDepthFunc = func;
 
-        glDepthFunc(func);
+        ++mStateChangesRequested;
+        if (mDeferStateChanges)
+            mDirtyState |= DIRTY_DEPTH_FUNC;
+        else
+            applyDepthFunc();
+    }
+
+    void GLStateCacheManager::applyDepthFunc()
+    {
+        glDepthFunc(mDepthFunc);
+        mApplied.depthFunc = mDepthFunc;
+        ++mStateChangesIssued;
     }
     
     void GLStateCacheManager::setClearDepth(GLclampf depth)
@@ -262,7 +391,18 @@ namespace Ogre {
         mColourMask[2] = blue;
         mColourMask[3] = alpha;
 
+        ++mStateChangesRequested;
+        if (mDeferStateChanges)
+            mDirtyState |= DIRTY_COLOUR_MASK;
+        else
+            applyColourMask();
+    }
+
+    void GLStateCacheManager::applyColourMask()
+    {
         glColorMask(mColourMask[0], mColourMask[1], mColourMask[2], mColourMask[3]);
+        std::ranges::copy(mColourMask, mApplied.colourMask);
+        ++mStateChangesIssued;
     }
     
     void GLStateCacheManager::setStencilMask(GLuint mask)
@@ -273,6 +413,15 @@ namespace Ogre {
     }
     
     void GLStateCacheManager::setEnabled(GLenum flag, bool enabled)
+    {
+        ++mStateChangesRequested;
+        if (mDeferStateChanges)
+            mPendingEnables[flag] = enabled;
+        else
+            applyEnabled(flag, enabled);
+    }
+
+    void GLStateCacheManager::applyEnabled(GLenum flag, bool enabled)
     {
         if(!enabled)
         {
@@ -282,6 +431,8 @@ namespace Ogre {
         {
             glEnable(flag);
         }
+        mApplied.enabled[flag] = enabled;
+        ++mStateChangesIssued;
     }
 
     void GLStateCacheManager::setViewport(const Rect& r)
@@ -294,7 +445,18 @@ namespace Ogre {
     {
         mCullFace = face;
 
-        glCullFace(face);
+        ++mStateChangesRequested;
+        if (mDeferStateChanges)
+            mDirtyState |= DIRTY_CULL_FACE;
+        else
+            applyCullFace();
+    }
+
+    void GLStateCacheManager::applyCullFace()
+    {
+        glCullFace(mCullFace);
+        mApplied.cullFace = mCullFace;
+        ++mStateChangesIssued;
     }
 
     void GLStateCacheManager::setBlendEquation(GLenum eqRGB, GLenum eqAlpha)
@@ -302,18 +464,105 @@ namespace Ogre {
         mBlendEquationRGB = eqRGB;
         mBlendEquationAlpha = eqAlpha;
 
+        ++mStateChangesRequested;
+        if (mDeferStateChanges)
+            mDirtyState |= DIRTY_BLEND_EQUATION;
+        else
+            applyBlendEquation();
+    }
+
+    void GLStateCacheManager::applyBlendEquation()
+    {
         if(GLAD_GL_VERSION_2_0)
         {
-            glBlendEquationSeparate(eqRGB, eqAlpha);
+            glBlendEquationSeparate(mBlendEquationRGB, mBlendEquationAlpha);
         }
         else if(GLAD_GL_EXT_blend_equation_separate)
         {
-            glBlendEquationSeparateEXT(eqRGB, eqAlpha);
+            glBlendEquationSeparateEXT(mBlendEquationRGB, mBlendEquationAlpha);
         }
         else
         {
-            glBlendEquation(eqRGB);
+            glBlendEquation(mBlendEquationRGB);
         }
+        mApplied.blendEquation[0] = mBlendEquationRGB;
+        mApplied.blendEquation[1] = mBlendEquationAlpha;
+        ++mStateChangesIssued;
+    }
+
+    void GLStateCacheManager::setDeferStateChanges(bool defer)
+    {
+        if (!defer)
+            flushDeferredState();
+        mDeferStateChanges = defer;
+    }
+
+    void GLStateCacheManager::flushDeferredState()
+    {
+        for (auto [flag, enabled] : mPendingEnables)
+        {
+            auto it = mApplied.enabled.find(flag);
+            if (it == mApplied.enabled.end() || it->second != enabled)
+                applyEnabled(flag, enabled);
+        }
+        mPendingEnables.clear();
+
+        if (!mDirtyState)
+            return;
+
+        if ((mDirtyState & DIRTY_BLEND_EQUATION) &&
+            (mApplied.blendEquation[0] != mBlendEquationRGB || mApplied.blendEquation[1] != mBlendEquationAlpha))
+            applyBlendEquation();
+        if ((mDirtyState & DIRTY_BLEND_FUNC) &&
+            (mApplied.blendFunc[0] != mBlendFuncSource || mApplied.blendFunc[1] != mBlendFuncDest ||
+             mApplied.blendFunc[2] != mBlendFuncSourceAlpha || mApplied.blendFunc[3] != mBlendFuncDestAlpha))
+            applyBlendFunc();
+        if ((mDirtyState & DIRTY_DEPTH_FUNC) && mApplied.depthFunc != mDepthFunc)
+            applyDepthFunc();
+        if ((mDirtyState & DIRTY_DEPTH_MASK) && mApplied.depthMask != mDepthMask)
+            applyDepthMask();
+        if ((mDirtyState & DIRTY_COLOUR_MASK) && !std::ranges::equal(mApplied.colourMask, mColourMask))
+            applyColourMask();
+        if ((mDirtyState & DIRTY_CULL_FACE) && mApplied.cullFace != mCullFace)
+            applyCullFace();
+
+        mDirtyState = 0;
+    }
+
+    void GLStateCacheManager::pushAttrib(GLbitfield mask)
+    {
+        flushDeferredState();
+        mSavedStates.push_back({mApplied, mDeferStateChanges});
+        mDeferStateChanges = false;
+
+        glPushAttrib(mask);
+    }
+
+    void GLStateCacheManager::popAttrib()
+    {
+        OgreAssert(!mSavedStates.empty(), "popAttrib without pushAttrib");
+        glPopAttrib();
+
+        // GL is back to the flushed state of pushAttrib
+        const SavedState& saved = mSavedStates.back();
+        mApplied = saved.applied;
+        mDeferStateChanges = saved.deferStateChanges;
+        mSavedStates.pop_back();
+
+        mPendingEnables.clear();
+        mDirtyState = 0;
+        mBlendEquationRGB = mApplied.blendEquation[0];
+        mBlendEquationAlpha = mApplied.blendEquation[1];
+        mBlendFuncSource = mApplied.blendFunc[0];
+        mBlendFuncDest = mApplied.blendFunc[1];
+        mBlendFuncSourceAlpha = mApplied.blendFunc[2];
+        mBlendFuncDestAlpha = mApplied.blendFunc[3];
+        mDepthFunc = mApplied.depthFunc;
+        mCullFace = mApplied.cullFace;
+        mDepthMask = mApplied.depthMask;
+        std::ranges::copy(mApplied.colourMask, mColourMask);
+
+        invalidateTextureBindings();
     }
 
     void GLStateCacheManager::setMaterialDiffuse(GLfloat r, GLfloat g, GLfloat b, GLfloat a)
@@ -254,6 +254,24 @@ namespace Ogre {
         }
     }
     
+    //---------------------------------------------------------------------------------------------
+    auto GLTexture::setMostDetailedMipImpl(uint32 mip) -> bool
+    {
+        // the levels streamed in may still be staged, they must be complete before sampling them
+        for (uint32 level = mip; level < mResidentMip; ++level)
+        {
+            for (uint32 face = 0; face < getNumFaces(); ++face)
+            {
+                auto buffer = static_cast<GLTextureBuffer*>(getBuffer(face, TextureMipmap(level)).get());
+                mRenderSystem->_flushTextureUploads(buffer);
+            }
+        }
+
+        mRenderSystem->_getStateCacheManager()->bindGLTexture(getGLTextureTarget(), mTextureID);
+        mRenderSystem->_getStateCacheManager()->setTexParameteri(getGLTextureTarget(), GL_TEXTURE_BASE_LEVEL,
+                                                                 static_cast<GLint>(mip));
+        return true;
+    }
     //---------------------------------------------------------------------------------------------
     void GLTexture::_createSurfaceList()
     {
@@ -71,7 +71,7 @@ void ATI_FS_GLGpuProgram::unbindProgram()
 }
 
 
-void ATI_FS_GLGpuProgram::bindProgramParameters(GpuProgramParametersSharedPtr params, Ogre::GpuParamVariability mask)
+void ATI_FS_GLGpuProgram::bindProgramParameters(const GpuProgramParametersSharedPtr& params, Ogre::GpuParamVariability mask)
 {
     // only supports float constants
     GpuLogicalBufferStructPtr floatStruct = params->getLogicalBufferStruct();
@@ -9,6 +9,7 @@ export import :GLRenderSystemCommon;
 export import :GLRenderTarget;
 export import :GLRenderTexture;
 export import :GLSL.Preprocessor;
+export import :GLSL.PreprocessorCache;
 export import :GLSL.ProgramCommon;
 export import :GLSL.ProgramManagerCommon;
 export import :GLSL.ShaderCommon;
@@ -17,7 +18,13 @@ export import :GLTextureCommon;
 export import :GLUniformCache;
 export import :GLUtil;
 export import :GLWindow;
+#ifdef OGRE_GLSUPPORT_USE_EGL
+export import :EGL.Context;
+export import :EGL.GLSupport;
+export import :EGL.Window;
+#else
 export import :GLX.Context;
 export import :GLX.GLSupport;
 export import :GLX.RenderTexture;
 export import :GLX.Window;
+#endif
@@ -0,0 +1,45 @@
+// This file is part of the OGRE project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at https://www.ogre3d.org/licensing.
+module;
+
+#include <EGL/egl.h>
+
+export module Ogre.RenderSystems.GLSupport:EGL.Context;
+
+export import :GLContext;
+
+export
+namespace Ogre {
+class EGLGLSupport;
+
+    class EGLContext: public GLContext
+    {
+    public:
+        /**
+         * @param drawable       The surface to render to, EGL_NO_SURFACE for a surfaceless context
+         * @param ownsDrawable   Whether the surface is destroyed along with the context
+         */
+        EGLContext(EGLGLSupport* glsupport, ::EGLConfig config, ::EGLSurface drawable, bool ownsDrawable = false);
+
+        ~EGLContext() override;
+
+        /// @copydoc GLContext::setCurrent
+        void setCurrent() override;
+
+        /// @copydoc GLContext::endCurrent
+        void endCurrent() override;
+
+        /// @copydoc GLContext::clone
+        /// The clone is surfaceless with EGL_KHR_surfaceless_context, else it gets a pbuffer of its own
+        [[nodiscard]] auto clone() const -> GLContext* override;
+
+        ::EGLSurface  mDrawable;
+        ::EGLContext  mContext;
+
+    private:
+        ::EGLConfig   mConfig;
+        EGLGLSupport* mGLSupport;
+        bool mOwnsDrawable;
+    };
+}
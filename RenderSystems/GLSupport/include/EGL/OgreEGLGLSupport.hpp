@@ -0,0 +1,76 @@
+// This file is part of the OGRE project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at https://www.ogre3d.org/licensing.
+module;
+
+#include <EGL/egl.h>
+
+export module Ogre.RenderSystems.GLSupport:EGL.GLSupport;
+
+export import :GLNativeSupport;
+
+export import Ogre.Core;
+
+export
+namespace Ogre {
+
+    /** Headless GL context creation with EGL.
+    @remarks
+        Needs no display server, which makes it the backend for rendering on GPU servers.
+        The display is opened on the first device reported by EGL_EXT_device_enumeration,
+        falling back to the default display. Render windows are offscreen pbuffer surfaces,
+        see EGLWindow, whose contents are read back with RenderTarget::copyContentsToMemory
+        or RenderTarget::startContentsReadback.
+    */
+    class EGLGLSupport : public GLNativeSupport
+    {
+    public:
+        EGLGLSupport(GLNativeSupport::ContextProfile profile);
+        ~EGLGLSupport() override;
+
+        /// @copydoc RenderSystem::createRenderWindow
+        auto newWindow(std::string_view name, unsigned int width, unsigned int height,
+                                bool fullScreen, const NameValuePairList *miscParams = nullptr) -> RenderWindow* override;
+
+        /** @copydoc see GLNativeSupport::start */
+        void start() override;
+
+        /** @copydoc see GLNativeSupport::stop */
+        void stop() override;
+
+        /** @copydoc see GLNativeSupport::getProcAddress */
+        auto getProcAddress(const char* procname) const -> void* override;
+
+        // The remaining functions are internal to the EGL Rendersystem:
+
+        [[nodiscard]] auto getGLDisplay() const noexcept -> ::EGLDisplay { return mGLDisplay; }
+
+        /**
+         * Select an EGLConfig for pbuffer surfaces
+         *
+         * @param fsaa       Desired number of samples, fewer are accepted
+         * @returns          EGLConfig or nullptr when unsupported
+         */
+        auto chooseConfig(uint fsaa) const -> ::EGLConfig;
+
+        /**
+         * Create a context of the configured ContextProfile
+         */
+        auto createNewContext(::EGLConfig config, ::EGLContext shareList) const -> ::EGLContext;
+
+        /**
+         * Create a pbuffer surface
+         *
+         * @param hwGamma    Whether to use an sRGB colour buffer, needs EGL_KHR_gl_colorspace
+         */
+        auto createPbufferSurface(::EGLConfig config, uint32 width, uint32 height, bool hwGamma = false) const -> ::EGLSurface;
+
+        /// Whether contexts can be made current without a surface, see EGL_KHR_surfaceless_context
+        [[nodiscard]] auto hasSurfacelessContext() const -> bool { return checkExtension("EGL_KHR_surfaceless_context"); }
+
+    private:
+        ::EGLDisplay mGLDisplay;
+        int mEGLVerMajor{0};
+        int mEGLVerMinor{0};
+    };
+}
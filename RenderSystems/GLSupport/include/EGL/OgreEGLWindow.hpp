@@ -0,0 +1,55 @@
+// This file is part of the OGRE project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at https://www.ogre3d.org/licensing.
+export module Ogre.RenderSystems.GLSupport:EGL.Window;
+
+export import :GLWindow;
+
+export import Ogre.Core;
+
+export
+namespace Ogre
+{
+    class EGLGLSupport;
+
+    /** An offscreen render window, backed by an EGL pbuffer surface.
+    @remarks
+        It is never shown, so it is always reported as visible and swapping its buffers
+        only flushes the rendering. The supported miscParams are FSAA and gamma. All
+        windows share their resources with the first one.
+    */
+    class EGLWindow : public GLWindow
+    {
+    public:
+        EGLWindow(EGLGLSupport* glsupport);
+        ~EGLWindow() override;
+
+        void create(std::string_view name, unsigned int width, unsigned int height,
+                    bool fullScreen, const NameValuePairList *miscParams) override;
+
+        /** @copydoc see RenderWindow::destroy */
+        void destroy() override;
+
+        /** @copydoc see RenderWindow::setVSyncEnabled */
+        void setVSyncEnabled(bool vsync) override;
+
+        /** @copydoc see RenderWindow::resize */
+        void resize(unsigned int width, unsigned int height) override;
+
+        /** @copydoc see RenderWindow::swapBuffers */
+        void swapBuffers() override;
+
+        /**
+           @remarks
+           * Get custom attribute; the following attributes are valid:
+           * GLCONTEXT    The Ogre GLContext used for rendering.
+           * DISPLAY      The EGLDisplay behind that context.
+           */
+        void getCustomAttribute(std::string_view name, void* pData) override;
+
+        [[nodiscard]] auto suggestPixelFormat() const noexcept -> PixelFormat override;
+
+    private:
+        EGLGLSupport* mGLSupport;
+    };
+}
@@ -0,0 +1,102 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+module;
+
+#include <cstddef>
+
+export module Ogre.RenderSystems.GLSupport:GLSL.PreprocessorCache;
+
+export import Ogre.Core;
+
+export import <atomic>;
+export import <mutex>;
+export import <unordered_map>;
+export import <utility>;
+export import <vector>;
+
+export
+namespace Ogre {
+
+    /** Memoises the preparation of GLSL sources for the driver, shared by all GLSL programs.
+    @remarks
+        The RTSS generates hundreds of programs which include the same shader libraries and
+        differ in a few defines only. While enabled, every include file is read and expanded once,
+        and the output of the CPreprocessor is kept per source and macros, so that programs
+        which come out the same are preprocessed once. Sources which hold nothing for the
+        CPreprocessor to do are handed to the driver as they are.
+    @par
+        The cache is disabled by default, as it does not notice changes of the include files.
+        Call clear after reloading them.
+    */
+    class GLSLPreprocessorCache
+    {
+    public:
+        /// Macro names and values, as returned by HighLevelGpuProgram::parseDefines
+        using Macros = std::vector<std::pair<const char*, const char*>>;
+
+        /// Enables the cache, disabling clears it
+        void setEnabled(bool enabled);
+        [[nodiscard]] auto isEnabled() const noexcept -> bool { return mEnabled; }
+
+        /// Forgets all include expansions and preprocessed sources
+        void clear();
+
+        /** Replaces the include directives of a source by the files they include.
+            @see HighLevelGpuProgram::_resolveIncludes
+        */
+        auto resolveIncludes(std::string_view source, Resource* resourceBeingLoaded, std::string_view fileName)
+            -> String;
+
+        /** Runs the CPreprocessor over a source with the includes resolved.
+        @param source The source to preprocess
+        @param macros The macros predefined for the source
+        @param programName The name of the program, for the error message
+        @throw RENDERINGAPI_ERROR if the source fails to preprocess
+        */
+        auto preprocess(String source, const Macros& macros, std::string_view programName) -> String;
+
+        /** Whether the driver takes a source as well as its output of the CPreprocessor.
+        @remarks
+            That is the case when the source holds no directives other than version, extension,
+            line and pragma, and uses none of the macros but the reserved ones the driver defines
+            as well, like __VERSION__ and GL_ES. Any occurrence of a macro name counts as a use.
+        */
+        [[nodiscard]] static auto isPassThrough(std::string_view source, const Macros& macros) -> bool;
+
+        /// The number of include files and of preprocessed sources held
+        [[nodiscard]] auto getIncludeCount() const -> size_t;
+        [[nodiscard]] auto getSourceCount() const -> size_t;
+
+    private:
+        mutable std::mutex mMutex;
+        std::atomic<bool> mEnabled{false};
+        HighLevelGpuProgram::IncludeCache mIncludes;
+        /// Preprocessed sources by their macros and source
+        std::unordered_map<String, String> mSources;
+    };
+}
@@ -71,7 +71,7 @@ public:
     /** Updates program object uniforms using data from GpuProgramParameters.
         Normally called by GLSLShader::bindParameters() just before rendering occurs.
     */
-    virtual void updateUniforms(GpuProgramParametersPtr params, GpuParamVariability mask, GpuProgramType fromProgType) = 0;
+    virtual void updateUniforms(const GpuProgramParametersPtr& params, GpuParamVariability mask, GpuProgramType fromProgType) = 0;
 
     /** Get the fixed attribute bindings normally used by GL for a semantic. */
     static auto getFixedAttributeIndex(VertexElementSemantic semantic, uint index) -> int32;
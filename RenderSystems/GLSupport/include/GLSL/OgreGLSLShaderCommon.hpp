@@ -27,6 +27,7 @@ THE SOFTWARE.
 */
 export module Ogre.RenderSystems.GLSupport:GLSL.ShaderCommon;
 
+export import :GLSL.PreprocessorCache;
 export import :GLUniformCache;
 
 export import Ogre.Core;
@@ -107,12 +108,16 @@ namespace Ogre {
 
         /// GLSL does not provide access to the low level code of the shader, so use this shader for binding as well
         auto _getBindingDelegate() noexcept -> GpuProgram* override { return this; }
+
+        /// The cache of include expansions and preprocessed sources shared by all GLSL programs
+        static auto getPreprocessorCache() noexcept -> GLSLPreprocessorCache& { return msPreprocessorCache; }
     protected:
         /// GLSL does not provide access to the low level implementation of the shader, so this method s a no-op
         void createLowLevelImpl() override {}
 
         static CmdAttach msCmdAttach;
         static CmdColumnMajorMatrices msCmdColumnMajorMatrices;
+        static GLSLPreprocessorCache msPreprocessorCache;
 
         auto getResourceLogName() const -> String;
 
@@ -37,6 +37,7 @@ export import Ogre.Core;
 
 export import <list>;
 export import <memory>;
+export import <mutex>;
 export import <set>;
 
 export
@@ -73,6 +74,8 @@ namespace Ogre {
         using GLContextList = std::list<GLContext *>;
         /// List of background thread contexts
         GLContextList mBackgroundContextList;
+        /// Guards mBackgroundContextList, as workers register concurrently
+        std::mutex mBackgroundContextMutex;
 
         /** One time initialization for the RenderState of a context. Things that
             only need to be set once, like the LightingModel can be defined here.
@@ -84,7 +87,7 @@ namespace Ogre {
 
         | Key |  Default | Description |
         |-----|---------------|---------|
-        | Reversed Z-Buffer | false | Use reverse depth buffer to improve depth precision (GL3+ only) |
+        | Reversed Z-Buffer | false | Use reverse depth buffer to improve depth precision. Render textures get float depth buffers if supported (GL with GL_ARB_clip_control and GL3+) |
         | Separate Shader Objects | false | Compile shaders individually instad of using monolithic programs. Better introspection. Allows mixing GLSL and SPIRV shaders (GL3+ only)  |
         | Fixed Pipeline Enabled | true | Use fixed function units where possible. Disable to test migration to shader-only pipeline (GL only) |
         */
@@ -96,12 +99,22 @@ namespace Ogre {
         virtual void _copyContentsToMemory(Viewport* vp, const Box& src, const PixelBox& dst,
                                            RenderWindow::FrameBuffer buffer) = 0;
 
+        /** @copydoc RenderTarget::startContentsReadback */
+        virtual auto _startReadback(Viewport* vp, const Box& src, PixelFormat format,
+                                    RenderWindow::FrameBuffer buffer) -> uint32 = 0;
+        /** @copydoc RenderTarget::finishContentsReadback */
+        virtual void _finishReadback(uint32 ticket, const PixelBox& dst, bool bottomUp) = 0;
+
         /** Returns the main context */
         auto _getMainContext() noexcept -> GLContext* { return mMainContext; }
 
         /** Returns the current context */
         auto _getCurrentContext() noexcept -> GLContext* { return mCurrentContext; }
 
+        /** Returns the context of the calling thread if it was set up by registerThread,
+            @c nullptr on the main thread */
+        static auto _getThreadContext() noexcept -> GLContext*;
+
         /**
         * Check if GL Version is supported
         */
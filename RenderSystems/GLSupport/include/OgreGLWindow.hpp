@@ -50,10 +50,15 @@ namespace Ogre
         void setVSyncInterval(unsigned int interval) override;
 
         void copyContentsToMemory(const Box& src, const PixelBox &dst, FrameBuffer buffer) override;
+        auto startContentsReadback(const Box& src, PixelFormat format, FrameBuffer buffer) -> ReadbackTicket override;
+        void finishContentsReadback(ReadbackTicket ticket, const PixelBox& dst, bool bottomUp) override;
         [[nodiscard]] auto requiresTextureFlipping() const noexcept -> bool override { return false; }
         [[nodiscard]] auto getContext() const noexcept -> GLContext* override { return mContext.get(); }
 
     protected:
+        /// Validates the region and resolves FrameBuffer::AUTO
+        auto checkReadback(const Box& src, FrameBuffer buffer) const -> FrameBuffer;
+
         bool mVisible;
         bool mHidden;
         bool mIsTopLevel;
@@ -0,0 +1,61 @@
+// This file is part of the OGRE project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at https://www.ogre3d.org/licensing.
+module;
+
+#include <EGL/egl.h>
+
+module Ogre.RenderSystems.GLSupport;
+
+import :EGL.Context;
+import :EGL.GLSupport;
+import :GLRenderSystemCommon;
+
+import Ogre.Core;
+
+namespace Ogre
+{
+    EGLContext::EGLContext(EGLGLSupport* glsupport, ::EGLConfig config, ::EGLSurface drawable, bool ownsDrawable) :
+        mDrawable(drawable), mConfig(config), mGLSupport(glsupport), mOwnsDrawable(ownsDrawable)
+    {
+        auto *renderSystem = static_cast<GLRenderSystemCommon*>(Root::getSingleton().getRenderSystem());
+        auto* mainContext = static_cast<EGLContext*>(renderSystem->_getMainContext());
+        ::EGLContext shareContext = mainContext ? mainContext->mContext : EGL_NO_CONTEXT;
+
+        mContext = mGLSupport->createNewContext(mConfig, shareContext);
+
+        if (mContext == EGL_NO_CONTEXT)
+        {
+            OGRE_EXCEPT(ExceptionCodes::RENDERINGAPI_ERROR, "Unable to create a suitable EGLContext", "EGLContext::EGLContext");
+        }
+    }
+
+    EGLContext::~EGLContext()
+    {
+        auto *rs = static_cast<GLRenderSystemCommon*>(Root::getSingleton().getRenderSystem());
+
+        eglDestroyContext(mGLSupport->getGLDisplay(), mContext);
+        if (mOwnsDrawable && mDrawable != EGL_NO_SURFACE)
+            eglDestroySurface(mGLSupport->getGLDisplay(), mDrawable);
+
+        rs->_unregisterContext(this);
+    }
+
+    void EGLContext::setCurrent()
+    {
+        eglMakeCurrent(mGLSupport->getGLDisplay(), mDrawable, mDrawable, mContext);
+    }
+
+    void EGLContext::endCurrent()
+    {
+        eglMakeCurrent(mGLSupport->getGLDisplay(), EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    }
+
+    auto EGLContext::clone() const -> GLContext*
+    {
+        if (mGLSupport->hasSurfacelessContext())
+            return new EGLContext(mGLSupport, mConfig, EGL_NO_SURFACE);
+
+        return new EGLContext(mGLSupport, mConfig, mGLSupport->createPbufferSurface(mConfig, 1, 1), true);
+    }
+}
@@ -0,0 +1,209 @@
+// This file is part of the OGRE project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at https://www.ogre3d.org/licensing.
+module;
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+module Ogre.RenderSystems.GLSupport;
+
+import :EGL.GLSupport;
+import :EGL.Window;
+import :GLUtil;
+
+import Ogre.Core;
+
+import <format>;
+import <ranges>;
+import <string_view>;
+
+namespace Ogre {
+
+    auto getGLSupport(GLNativeSupport::ContextProfile profile) -> GLNativeSupport*
+    {
+        return new EGLGLSupport(profile);
+    }
+
+    //-------------------------------------------------------------------------------------------------//
+    EGLGLSupport::EGLGLSupport(GLNativeSupport::ContextProfile profile) : GLNativeSupport(profile)
+    {
+        mGLDisplay = EGL_NO_DISPLAY;
+
+        // a GPU rather than a display server, if the driver enumerates them
+        auto queryDevices = reinterpret_cast<PFNEGLQUERYDEVICESEXTPROC>(eglGetProcAddress("eglQueryDevicesEXT"));
+        auto getPlatformDisplay =
+            reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(eglGetProcAddress("eglGetPlatformDisplayEXT"));
+        if (queryDevices && getPlatformDisplay)
+        {
+            EGLDeviceEXT device;
+            EGLint numDevices = 0;
+            if (queryDevices(1, &device, &numDevices) && numDevices > 0)
+                mGLDisplay = getPlatformDisplay(EGL_PLATFORM_DEVICE_EXT, device, nullptr);
+        }
+
+        if (mGLDisplay == EGL_NO_DISPLAY)
+            mGLDisplay = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+
+        if (mGLDisplay == EGL_NO_DISPLAY || !eglInitialize(mGLDisplay, &mEGLVerMajor, &mEGLVerMinor))
+        {
+            OGRE_EXCEPT(ExceptionCodes::RENDERINGAPI_ERROR, "Couldn't open an EGL display", "EGLGLSupport::EGLGLSupport");
+        }
+
+        // there is no screen, offer the common sizes for the offscreen windows
+        for (auto [width, height] : {std::pair<uint32, uint32>{640, 480}, {1280, 720}, {1920, 1080}, {2560, 1440}, {3840, 2160}})
+        {
+            mVideoModes.push_back({width, height, 0, 32});
+        }
+
+        mFSAALevels = {0, 2, 4, 8, 16};
+    }
+
+    //-------------------------------------------------------------------------------------------------//
+    EGLGLSupport::~EGLGLSupport()
+    {
+        if (mGLDisplay != EGL_NO_DISPLAY)
+            eglTerminate(mGLDisplay);
+    }
+
+    //-------------------------------------------------------------------------------------------------//
+    auto EGLGLSupport::newWindow(std::string_view name, unsigned int width, unsigned int height, bool fullScreen, const NameValuePairList *miscParams) -> RenderWindow*
+    {
+        auto* window = new EGLWindow(this);
+
+        window->create(name, width, height, fullScreen, miscParams);
+
+        return window;
+    }
+
+    //-------------------------------------------------------------------------------------------------//
+    void EGLGLSupport::start()
+    {
+        LogManager::getSingleton().logMessage(
+            "******************************\n"
+            "*** Starting EGL Subsystem ***\n"
+            "******************************");
+
+        LogManager::getSingleton().logMessage(::std::format("EGL_VERSION = {}.{}", mEGLVerMajor, mEGLVerMinor));
+
+        // the string is owned by the display, so the list can refer to it
+        const char* extensionsString = eglQueryString(mGLDisplay, EGL_EXTENSIONS);
+        LogManager::getSingleton().logMessage(::std::format("EGL_EXTENSIONS = {}", extensionsString));
+
+        for (auto ext : std::string_view{extensionsString} | std::views::split(' '))
+        {
+            if (!ext.empty())
+                extensionList.insert(std::string_view{ext.begin(), ext.end()});
+        }
+    }
+
+    //-------------------------------------------------------------------------------------------------//
+    void EGLGLSupport::stop()
+    {
+        LogManager::getSingleton().logMessage(
+            "******************************\n"
+            "*** Stopping EGL Subsystem ***\n"
+            "******************************");
+    }
+
+    //-------------------------------------------------------------------------------------------------//
+    auto EGLGLSupport::getProcAddress(const char* procname) const -> void* {
+        return (void*)eglGetProcAddress(procname);
+    }
+
+    //-------------------------------------------------------------------------------------------------//
+    auto EGLGLSupport::chooseConfig(uint fsaa) const -> ::EGLConfig
+    {
+        EGLint renderable = mContextProfile == ContextProfile::ES ? EGL_OPENGL_ES2_BIT : EGL_OPENGL_BIT;
+
+        // try the desired samples first, then halve them until a config is found
+        for (EGLint samples = fsaa; ; samples /= 2)
+        {
+            EGLint attribs[] = {
+                EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+                EGL_RENDERABLE_TYPE, renderable,
+                EGL_RED_SIZE, 8,
+                EGL_GREEN_SIZE, 8,
+                EGL_BLUE_SIZE, 8,
+                EGL_ALPHA_SIZE, 8,
+                EGL_DEPTH_SIZE, 24,
+                EGL_STENCIL_SIZE, 8,
+                EGL_SAMPLE_BUFFERS, samples > 1 ? 1 : 0,
+                EGL_SAMPLES, samples > 1 ? samples : 0,
+                EGL_NONE
+            };
+
+            ::EGLConfig config = nullptr;
+            EGLint numConfigs = 0;
+            if (eglChooseConfig(mGLDisplay, attribs, &config, 1, &numConfigs) && numConfigs > 0)
+                return config;
+
+            if (samples <= 1)
+                break;
+        }
+
+        return nullptr;
+    }
+
+    //-------------------------------------------------------------------------------------------------//
+    auto EGLGLSupport::createNewContext(::EGLConfig config, ::EGLContext shareList) const -> ::EGLContext
+    {
+        using enum ContextProfile;
+
+        eglBindAPI(mContextProfile == ES ? EGL_OPENGL_ES_API : EGL_OPENGL_API);
+
+        EGLint majorVersion;
+        EGLint minorVersion = 0;
+        EGLint profile = EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT_KHR;
+
+        switch(mContextProfile) {
+        case COMPATIBILITY:
+            profile = EGL_CONTEXT_OPENGL_COMPATIBILITY_PROFILE_BIT_KHR;
+            majorVersion = 1;
+            break;
+        case ES:
+            majorVersion = 2;
+            break;
+        default:
+            majorVersion = 3;
+            minorVersion = 3; // 3.1 would be sufficient per spec, but we need 3.3 anyway..
+            break;
+        }
+
+        EGLint contextAttribs[] = {
+            EGL_CONTEXT_MAJOR_VERSION_KHR, majorVersion,
+            EGL_CONTEXT_MINOR_VERSION_KHR, minorVersion,
+            EGL_CONTEXT_OPENGL_PROFILE_MASK_KHR, profile,
+            EGL_NONE
+        };
+
+        // the profile mask is not valid for ES contexts
+        if (mContextProfile == ES)
+            contextAttribs[4] = EGL_NONE;
+
+        return eglCreateContext(mGLDisplay, config, shareList ? shareList : EGL_NO_CONTEXT, contextAttribs);
+    }
+
+    //-------------------------------------------------------------------------------------------------//
+    auto EGLGLSupport::createPbufferSurface(::EGLConfig config, uint32 width, uint32 height, bool hwGamma) const -> ::EGLSurface
+    {
+        EGLint attribs[] = {
+            EGL_WIDTH, EGLint(width),
+            EGL_HEIGHT, EGLint(height),
+            EGL_GL_COLORSPACE_KHR, EGL_GL_COLORSPACE_SRGB_KHR,
+            EGL_NONE
+        };
+
+        if (!hwGamma || !checkExtension("EGL_KHR_gl_colorspace"))
+            attribs[4] = EGL_NONE;
+
+        ::EGLSurface surface = eglCreatePbufferSurface(mGLDisplay, config, attribs);
+        if (surface == EGL_NO_SURFACE)
+        {
+            OGRE_EXCEPT(ExceptionCodes::RENDERINGAPI_ERROR,
+                        ::std::format("Unable to create a {}x{} pbuffer surface, error {:#x}", width, height, eglGetError()),
+                        "EGLGLSupport::createPbufferSurface");
+        }
+        return surface;
+    }
+}
@@ -0,0 +1,163 @@
+// This file is part of the OGRE project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at https://www.ogre3d.org/licensing.
+module;
+
+#include <EGL/egl.h>
+#include <GL/gl.h>
+
+module Ogre.RenderSystems.GLSupport;
+
+import :EGL.Context;
+import :EGL.GLSupport;
+import :EGL.Window;
+import :GLContext;
+import :GLNativeSupport;
+
+import Ogre.Core;
+
+import <format>;
+import <map>;
+import <string>;
+
+namespace Ogre
+{
+    //-------------------------------------------------------------------------------------------------//
+    EGLWindow::EGLWindow(EGLGLSupport *glsupport) : GLWindow(),
+        mGLSupport(glsupport)
+    {
+    }
+
+    //-------------------------------------------------------------------------------------------------//
+    EGLWindow::~EGLWindow()
+    {
+        destroy();
+    }
+
+    //-------------------------------------------------------------------------------------------------//
+    void EGLWindow::create(std::string_view name, uint width, uint height,
+                           bool fullScreen, const NameValuePairList *miscParams)
+    {
+        uint fsaa = 0;
+        mHwGamma = false;
+
+        if(miscParams)
+        {
+            NameValuePairList::const_iterator opt;
+            auto end = miscParams->end();
+
+            if((opt = miscParams->find("FSAA")) != end)
+                fsaa = StringConverter::parseUnsignedInt(opt->second);
+
+            if ((opt = miscParams->find("gamma")) != end)
+                mHwGamma = StringConverter::parseBool(opt->second);
+        }
+
+        ::EGLConfig config = mGLSupport->chooseConfig(fsaa);
+        if (!config)
+        {
+            OGRE_EXCEPT(ExceptionCodes::RENDERINGAPI_ERROR, "Unexpected failure to determine a EGLConfig", "EGLWindow::create");
+        }
+
+        EGLint samples = 0;
+        eglGetConfigAttrib(mGLSupport->getGLDisplay(), config, EGL_SAMPLES, &samples);
+        mFSAA = samples;
+
+        // the offscreen surface takes the place of the window
+        ::EGLSurface surface = mGLSupport->createPbufferSurface(config, width, height, mHwGamma);
+
+        mContext = ::std::make_unique<EGLContext>(mGLSupport, config, surface, true);
+
+        LogManager::getSingleton().logMessage(
+            ::std::format("EGLWindow::create {}x{} offscreen, gamma={} FSAA={}", width, height, mHwGamma, mFSAA));
+
+        mName = name;
+        mWidth = width;
+        mHeight = height;
+        mLeft = 0;
+        mTop = 0;
+        mIsFullScreen = false;
+        mActive = true;
+        mClosed = false;
+        mVisible = true;
+    }
+
+    //-------------------------------------------------------------------------------------------------//
+    void EGLWindow::destroy()
+    {
+        if (mClosed)
+            return;
+
+        mClosed = true;
+        mActive = false;
+    }
+
+    //-------------------------------------------------------------------------------------------------//
+    void EGLWindow::setVSyncEnabled(bool vsync)
+    {
+        // nothing is presented, so frames are never synchronised to a display
+        mVSync = vsync;
+    }
+
+    //-------------------------------------------------------------------------------------------------//
+    void EGLWindow::resize(uint width, uint height)
+    {
+        if (mClosed)
+            return;
+
+        if(mWidth == width && mHeight == height)
+            return;
+
+        if(width != 0 && height != 0)
+        {
+            // pbuffers have a fixed size, so the surface is replaced
+            auto* context = static_cast<EGLContext*>(mContext.get());
+            ::EGLConfig config = mGLSupport->chooseConfig(mFSAA);
+            ::EGLSurface surface = mGLSupport->createPbufferSurface(config, width, height, mHwGamma);
+
+            bool current = eglGetCurrentContext() == context->mContext;
+            eglMakeCurrent(mGLSupport->getGLDisplay(), EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+            eglDestroySurface(mGLSupport->getGLDisplay(), context->mDrawable);
+            context->mDrawable = surface;
+            if (current)
+                context->setCurrent();
+
+            mWidth = width;
+            mHeight = height;
+
+            for (auto & it : mViewportList)
+                it.second->_updateDimensions();
+        }
+    }
+
+    //-------------------------------------------------------------------------------------------------//
+    void EGLWindow::swapBuffers()
+    {
+        if (mClosed)
+            return;
+
+        // nothing is presented, just make sure the frame is submitted
+        glFlush();
+    }
+
+    //-------------------------------------------------------------------------------------------------//
+    void EGLWindow::getCustomAttribute( std::string_view name, void* pData )
+    {
+        if( name == "DISPLAY" )
+        {
+            *static_cast<::EGLDisplay*>(pData) = mGLSupport->getGLDisplay();
+            return;
+        }
+        else if( name == "GLCONTEXT" )
+        {
+            *static_cast<GLContext**>(pData) = mContext.get();
+            return;
+        }
+    }
+
+    //-------------------------------------------------------------------------------------------------//
+    auto EGLWindow::suggestPixelFormat() const noexcept -> PixelFormat
+    {
+        return mGLSupport->getContextProfile() == GLNativeSupport::ContextProfile::ES ? PixelFormat::BYTE_RGBA : PixelFormat::BYTE_RGB;
+    }
+}
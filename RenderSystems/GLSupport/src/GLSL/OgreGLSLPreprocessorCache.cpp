@@ -0,0 +1,175 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+module;
+
+#include <cctype>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+
+module Ogre.RenderSystems.GLSupport;
+
+import :GLSL.Preprocessor;
+import :GLSL.PreprocessorCache;
+
+import Ogre.Core;
+
+import <algorithm>;
+import <format>;
+import <mutex>;
+import <string>;
+import <utility>;
+
+namespace Ogre {
+    //-----------------------------------------------------------------------
+    void GLSLPreprocessorCache::setEnabled(bool enabled)
+    {
+        mEnabled = enabled;
+        if (!enabled)
+            clear();
+    }
+    //-----------------------------------------------------------------------
+    void GLSLPreprocessorCache::clear()
+    {
+        std::scoped_lock lock{mMutex};
+        mIncludes.clear();
+        mSources.clear();
+    }
+    //-----------------------------------------------------------------------
+    auto GLSLPreprocessorCache::getIncludeCount() const -> size_t
+    {
+        std::scoped_lock lock{mMutex};
+        return mIncludes.size();
+    }
+    //-----------------------------------------------------------------------
+    auto GLSLPreprocessorCache::getSourceCount() const -> size_t
+    {
+        std::scoped_lock lock{mMutex};
+        return mSources.size();
+    }
+    //-----------------------------------------------------------------------
+    auto GLSLPreprocessorCache::resolveIncludes(std::string_view source, Resource* resourceBeingLoaded,
+                                                std::string_view fileName) -> String
+    {
+        if (!mEnabled)
+            return HighLevelGpuProgram::_resolveIncludes(source, resourceBeingLoaded, fileName);
+
+        std::scoped_lock lock{mMutex};
+        return HighLevelGpuProgram::_resolveIncludes(source, resourceBeingLoaded, fileName, false, &mIncludes);
+    }
+    //-----------------------------------------------------------------------
+    auto GLSLPreprocessorCache::preprocess(String source, const Macros& macros, std::string_view programName) -> String
+    {
+        String key;
+        if (mEnabled)
+        {
+            if (isPassThrough(source, macros))
+                return source;
+
+            // the C strings of the macros can't hold the separators
+            key = std::format("{}\n", macros.size());
+            for (const auto& [name, value] : macros)
+            {
+                key.append(name).push_back('\0');
+                key.append(value).push_back('\0');
+            }
+            key.append(source);
+
+            std::scoped_lock lock{mMutex};
+            auto it = mSources.find(key);
+            if (it != mSources.end())
+                return it->second;
+        }
+
+        CPreprocessor cpp;
+        for (const auto& [name, value] : macros)
+            cpp.Define(name, strlen(name), value, strlen(value));
+
+        size_t outSize = 0;
+        const char* src = source.c_str();
+        char* out = cpp.Parse(src, source.size(), outSize);
+        if (!out || !outSize)
+            // Failed to preprocess, break out
+            OGRE_EXCEPT(ExceptionCodes::RENDERINGAPI_ERROR, ::std::format("Failed to preprocess shader {}", programName));
+
+        String result{out, outSize};
+        if (out < src || out > src + source.size())
+            free(out);
+
+        if (!key.empty())
+        {
+            std::scoped_lock lock{mMutex};
+            mSources.emplace(std::move(key), result);
+        }
+        return result;
+    }
+    //-----------------------------------------------------------------------
+    auto GLSLPreprocessorCache::isPassThrough(std::string_view source, const Macros& macros) -> bool
+    {
+        for (size_t lineStart = 0; lineStart < source.size();)
+        {
+            size_t lineEnd = std::min(source.find('\n', lineStart), source.size());
+            std::string_view line = source.substr(lineStart, lineEnd - lineStart);
+            lineStart = lineEnd + 1;
+
+            size_t hashPos = line.find_first_not_of(" \t\r");
+            if (hashPos == std::string_view::npos || line[hashPos] != '#')
+                continue;
+
+            std::string_view directive = line.substr(hashPos + 1);
+            directive.remove_prefix(std::min(directive.find_first_not_of(" \t"), directive.size()));
+            directive = directive.substr(0, std::ranges::find_if_not(directive, [](char c)
+            {
+                return std::isalpha(static_cast<unsigned char>(c)) != 0;
+            }) - directive.begin());
+
+            if (!directive.empty() && directive != "version" && directive != "extension" && directive != "line" &&
+                directive != "pragma")
+                return false;
+        }
+
+        auto isIdentifierChar = [](char c) { return std::isalnum(static_cast<unsigned char>(c)) != 0 || c == '_'; };
+        for (const auto& [name, value] : macros)
+        {
+            std::string_view macro{name};
+            // reserved for GLSL, so the driver defines them as well
+            if (macro.empty() || macro.starts_with("GL_") || macro.find("__") != std::string_view::npos)
+                continue;
+
+            for (size_t pos = source.find(macro); pos != std::string_view::npos; pos = source.find(macro, pos + 1))
+            {
+                size_t end = pos + macro.size();
+                if ((pos == 0 || !isIdentifierChar(source[pos - 1])) &&
+                    (end == source.size() || !isIdentifierChar(source[end])))
+                    return false;
+            }
+        }
+
+        return true;
+    }
+}
@@ -27,17 +27,16 @@ THE SOFTWARE.
 */
 module;
 
-#include <cstdlib>
-#include <cstring>
-
 module Ogre.RenderSystems.GLSupport;
 
-import :GLSL.Preprocessor;
+import :GLSL.PreprocessorCache;
 import :GLSL.ShaderCommon;
 
 import Ogre.Core;
 
+import <algorithm>;
 import <format>;
+import <iterator>;
 import <string>;
 import <utility>;
 
@@ -48,6 +47,7 @@ namespace Ogre {
 
     GLSLShaderCommon::CmdAttach GLSLShaderCommon::msCmdAttach;
     GLSLShaderCommon::CmdColumnMajorMatrices GLSLShaderCommon::msCmdColumnMajorMatrices;
+    GLSLPreprocessorCache GLSLShaderCommon::msPreprocessorCache;
 
     auto GLSLShaderCommon::getResourceLogName() const -> String
     {
@@ -61,12 +61,10 @@ namespace Ogre {
     {
         HighLevelGpuProgram::prepareImpl(); // loads source
 
-        // Preprocess the GLSL shader in order to get a clean source
-        CPreprocessor cpp;
-
         // Define "predefined" macros.
+        GLSLPreprocessorCache::Macros macros;
         if(getLanguage() == "glsles")
-            cpp.Define("GL_ES", 5, "1", 1);
+            macros.emplace_back("GL_ES", "1");
 
         size_t versionPos = mSource.find("#version");
         if(versionPos != String::npos)
@@ -75,29 +73,16 @@ namespace Ogre {
         }
         String verStr = std::to_string(mShaderVersion);
 
-        cpp.Define("__VERSION__", 11, verStr.c_str(), verStr.size());
+        macros.emplace_back("__VERSION__", verStr.c_str());
 
         String defines = appendBuiltinDefines(mPreprocessorDefines);
+        std::ranges::copy(parseDefines(defines), std::back_inserter(macros));
 
-        for(const auto& def : parseDefines(defines))
-        {
-            cpp.Define(def.first, strlen(def.first), def.second, strlen(def.second));
-        }
-
-		// deal with includes
-		mSource = _resolveIncludes(mSource, this, mFilename);
+        // deal with includes
+        mSource = msPreprocessorCache.resolveIncludes(mSource, this, mFilename);
 
-        size_t out_size = 0;
-        const char *src = mSource.c_str ();
-        size_t src_len = mSource.size ();
-        char *out = cpp.Parse (src, src_len, out_size);
-        if (!out || !out_size)
-            // Failed to preprocess, break out
-            OGRE_EXCEPT(ExceptionCodes::RENDERINGAPI_ERROR, ::std::format("Failed to preprocess shader {}", mName));
-
-        mSource = String (out, out_size);
-        if (out < src || out > src + src_len)
-            free (out);
+        // Preprocess the GLSL shader in order to get a clean source
+        mSource = msPreprocessorCache.preprocess(std::move(mSource), macros, mName);
     }
     //-----------------------------------------------------------------------
     GLSLShaderCommon::GLSLShaderCommon(ResourceManager* creator, 
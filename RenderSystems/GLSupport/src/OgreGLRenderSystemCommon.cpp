@@ -37,11 +37,15 @@ import Ogre.Core;
 import <algorithm>;
 import <format>;
 import <map>;
+import <mutex>;
 import <string>;
 import <utility>;
 import <vector>;
 
 namespace Ogre {
+    /// Context set up by registerThread on a background thread
+    static thread_local GLContext* tlsThreadContext = nullptr;
+
     static void removeDuplicates(std::vector<String>& c)
     {
         std::ranges::sort(c);
@@ -238,11 +242,16 @@ namespace Ogre {
         // will ensure that resources are shared with the main context
         // We want a separate context so that we can safely create GL
         // objects in parallel with the main thread
-        GLContext* newContext = mMainContext->clone();
-        mBackgroundContextList.push_back(newContext);
+        GLContext* newContext;
+        {
+            std::lock_guard lock{mBackgroundContextMutex};
+            newContext = mMainContext->clone();
+            mBackgroundContextList.push_back(newContext);
+        }
 
         // Bind this new context to this thread.
         newContext->setCurrent();
+        tlsThreadContext = newContext;
 
         _oneTimeContextInitialization();
         newContext->setInitialized();
@@ -250,9 +259,17 @@ namespace Ogre {
 
     void GLRenderSystemCommon::unregisterThread()
     {
-        // nothing to do here?
-        // Don't need to worry about active context, just make sure we delete
-        // on shutdown.
+        // the context itself is deleted on shutdown
+        if (tlsThreadContext)
+        {
+            tlsThreadContext->endCurrent();
+            tlsThreadContext = nullptr;
+        }
+    }
+
+    auto GLRenderSystemCommon::_getThreadContext() noexcept -> GLContext*
+    {
+        return tlsThreadContext;
     }
 
     void GLRenderSystemCommon::preExtraThreadsStarted()
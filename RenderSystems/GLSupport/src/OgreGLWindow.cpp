@@ -54,13 +54,9 @@ void GLWindow::setVSyncInterval(unsigned int interval)
         setVSyncEnabled(true);
 }
 
-void GLWindow::copyContentsToMemory(const Box& src, const PixelBox& dst, FrameBuffer buffer)
+auto GLWindow::checkReadback(const Box& src, FrameBuffer buffer) const -> FrameBuffer
 {
-    if (mClosed)
-        return;
-
-    if (src.right > mWidth || src.bottom > mHeight || src.front != 0 || src.back != 1 ||
-        dst.getWidth() != src.getWidth() || dst.getHeight() != src.getHeight() || dst.getDepth() != 1)
+    if (src.right > mWidth || src.bottom > mHeight || src.front != 0 || src.back != 1)
     {
         OGRE_EXCEPT(ExceptionCodes::INVALIDPARAMS, "Invalid box");
     }
@@ -69,8 +65,35 @@ void GLWindow::copyContentsToMemory(const Box& src, const PixelBox& dst, FrameBu
     {
         buffer = mIsFullScreen ? FrameBuffer::FRONT : FrameBuffer::BACK;
     }
+    return buffer;
+}
+
+void GLWindow::copyContentsToMemory(const Box& src, const PixelBox& dst, FrameBuffer buffer)
+{
+    if (mClosed)
+        return;
+
+    if (dst.getWidth() != src.getWidth() || dst.getHeight() != src.getHeight() || dst.getDepth() != 1)
+    {
+        OGRE_EXCEPT(ExceptionCodes::INVALIDPARAMS, "Invalid box");
+    }
+    buffer = checkReadback(src, buffer);
 
     static_cast<GLRenderSystemCommon*>(Root::getSingleton().getRenderSystem())
         ->_copyContentsToMemory(getViewport(0), src, dst, buffer);
 }
+
+auto GLWindow::startContentsReadback(const Box& src, PixelFormat format, FrameBuffer buffer) -> ReadbackTicket
+{
+    buffer = checkReadback(src, buffer);
+
+    return static_cast<GLRenderSystemCommon*>(Root::getSingleton().getRenderSystem())
+        ->_startReadback(getViewport(0), src, format, buffer);
+}
+
+void GLWindow::finishContentsReadback(ReadbackTicket ticket, const PixelBox& dst, bool bottomUp)
+{
+    static_cast<GLRenderSystemCommon*>(Root::getSingleton().getRenderSystem())
+        ->_finishReadback(ticket, dst, bottomUp);
+}
 } // namespace Ogre
@@ -28,6 +28,7 @@
 module Ogre.Samples;
 
 import :DefaultSamplesPlugin;
+import :DeferredShading;
 import :NewInstancing;
 
 import Ogre.Components.Bites;
@@ -38,5 +39,6 @@ using namespace Ogre;
 using namespace OgreBites;
 DefaultSamplesPlugin::DefaultSamplesPlugin() : SamplePlugin("DefaultSamplesPlugin")
 {
+    addSample(new Sample_DeferredShading);
     addSample(new Sample_NewInstancing);
 }
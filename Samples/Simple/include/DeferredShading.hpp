@@ -0,0 +1,56 @@
+// This file is part of the OGRE project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at https://www.ogre3d.org/licensing.
+export module Ogre.Samples:DeferredShading;
+
+export import :SdkSample;
+
+export import Ogre.Components.Bites;
+export import Ogre.Core;
+
+export import <memory>;
+export import <vector>;
+
+using namespace Ogre;
+using namespace OgreBites;
+
+/** Lights the G-buffer of DeferredShading/GBuffer in the render_custom DeferredLight pass.
+@remarks
+    The G-buffer is the one the RTSS GBuffer sub render state writes with the diffuse_specular
+    and normal_viewdepth layouts. Every light affecting the frustum is drawn once over the
+    pixels it may reach, directional lights as a screen quad and point and spot lights as a
+    sphere around their range, so the cost scales with the pixels lit rather than with the
+    objects times the lights.
+@par
+    The lights casting shadows share the shadow textures of the scene manager, which are all
+    rendered at once before the lights, into tiles of a single texture with
+    SceneManager::setShadowAtlas.
+*/
+export
+class DeferredLightCompositionPass : public CustomCompositionPass
+{
+public:
+    auto createOperation(CompositorInstance* instance, const CompositionPass* pass)
+        -> CompositorInstance::RenderSystemOperation* override;
+};
+
+export
+class Sample_DeferredShading : public SdkSample
+{
+public:
+    Sample_DeferredShading();
+
+    auto frameRenderingQueued(const FrameEvent& evt) noexcept -> bool override;
+
+protected:
+    void setupContent() override;
+    void setupGBuffer();
+    void setupLights();
+    void cleanupContent() override;
+
+    DeferredLightCompositionPass mLightPass;
+    /// Leaves the materials that cannot be lit from the G-buffer to the forward passes
+    std::unique_ptr<MaterialManager::Listener> mSchemeListener;
+    /// Parent of the point lights circling the scene
+    SceneNode* mLightRing;
+};
@@ -0,0 +1,486 @@
+// This file is part of the OGRE project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at https://www.ogre3d.org/licensing.
+module Ogre.Samples;
+
+import :DeferredShading;
+
+import Ogre.Components.RTShaderSystem;
+import Ogre.Core;
+
+import <algorithm>;
+import <format>;
+import <memory>;
+import <vector>;
+
+using namespace Ogre;
+using namespace OgreBites;
+
+namespace {
+    /// The permutations of LightMaterial_ps.glsl, LIGHT_TYPE in the lowest bits
+    enum LightPermutation : uint32
+    {
+        LIGHT_POINT = 1,
+        LIGHT_SPOT = 2,
+        LIGHT_DIRECTIONAL = 3,
+        LIGHT_TYPE_MASK = 3,
+        LIGHT_SPECULAR = 4,
+        LIGHT_ATTENUATED = 8,
+        LIGHT_SHADOW_CASTER = 16
+    };
+
+    auto getPermutation(const Light* light, bool shadowed) -> uint32
+    {
+        uint32 permutation = LIGHT_ATTENUATED;
+        switch (light->getType())
+        {
+        case Light::LightTypes::POINT:
+            permutation |= LIGHT_POINT;
+            break;
+        case Light::LightTypes::SPOTLIGHT:
+            permutation |= LIGHT_SPOT;
+            break;
+        case Light::LightTypes::DIRECTIONAL:
+            permutation = LIGHT_DIRECTIONAL;
+            break;
+        }
+        if (light->getSpecularColour() != ColourValue::Black)
+            permutation |= LIGHT_SPECULAR;
+        if (shadowed)
+            permutation |= LIGHT_SHADOW_CASTER;
+        return permutation;
+    }
+
+    /// The lighting material of a permutation, cloned from those of deferred_post_minilight.material
+    auto getLightMaterial(uint32 permutation) -> MaterialPtr
+    {
+        auto& materialManager = MaterialManager::getSingleton();
+        String name = std::format("DeferredShading/LightMaterial/{}", permutation);
+        if (MaterialPtr material = materialManager.getByName(name, RGN_DEFAULT))
+            return material;
+
+        uint32 type = permutation & LIGHT_TYPE_MASK;
+        bool quad = type == LIGHT_DIRECTIONAL;
+        bool shadowed = permutation & LIGHT_SHADOW_CASTER;
+        MaterialPtr material = materialManager.getByName(std::format("DeferredShading/LightMaterial/{}{}",
+            quad ? "Quad" : "Geometry", shadowed ? "Shadow" : ""), RGN_DEFAULT)->clone(name);
+
+        String defines = std::format("LIGHT_TYPE={},IS_SPECULAR={},IS_ATTENUATED={}", type,
+                                     permutation & LIGHT_SPECULAR ? 1 : 0, permutation & LIGHT_ATTENUATED ? 1 : 0);
+        if (shadowed)
+            defines += ",IS_SHADOW_CASTER";
+        GpuProgramPtr program = GpuProgramManager::getSingleton().createProgram(
+            name, RGN_DEFAULT, "glsl", GpuProgramType::FRAGMENT_PROGRAM);
+        program->setSourceFile("LightMaterial_ps.glsl");
+        program->setParameter("preprocessor_defines", defines);
+
+        Pass* pass = material->getTechnique(0)->getPass(0);
+        pass->setVertexProgram(quad ? "DeferredShading/post/vs" : "DeferredShading/post/LightMaterial_vs");
+        pass->setFragmentProgram(name);
+
+        // the permutations leave out some of these
+        const GpuProgramParametersSharedPtr& params = pass->getFragmentProgramParameters();
+        params->setIgnoreMissingParams(true);
+        using enum GpuProgramParameters::AutoConstantType;
+        params->setNamedAutoConstant("vpWidth", VIEWPORT_WIDTH);
+        params->setNamedAutoConstant("vpHeight", VIEWPORT_HEIGHT);
+        params->setNamedAutoConstant("invView", INVERSE_VIEW_MATRIX);
+        params->setNamedAutoConstant("flip", RENDER_TARGET_FLIPPING);
+        params->setNamedAutoConstant("lightDiffuseColor", LIGHT_DIFFUSE_COLOUR);
+        params->setNamedAutoConstant("lightSpecularColor", LIGHT_SPECULAR_COLOUR);
+        params->setNamedAutoConstant("lightFalloff", LIGHT_ATTENUATION);
+        params->setNamedAutoConstant("lightPos", LIGHT_POSITION_VIEW_SPACE);
+        params->setNamedAutoConstant("lightDir", LIGHT_DIRECTION_VIEW_SPACE);
+        params->setNamedAutoConstant("spotParams", SPOTLIGHT_PARAMS);
+        params->setNamedAutoConstant("farClipDistance", FAR_CLIP_DISTANCE);
+        // maps to the tile of the light with a shadow atlas
+        params->setNamedAutoConstant("shadowViewProjMat", TEXTURE_VIEWPROJ_MATRIX);
+        params->setNamedConstant("Tex0", 0);
+        params->setNamedConstant("Tex1", 1);
+        params->setNamedConstant("ShadowTex", 2);
+
+        material->load();
+        return material;
+    }
+
+    void setFarCorner(Pass* pass, const Vector3& farCorner)
+    {
+        for (const GpuProgramParametersSharedPtr& params :
+             {pass->getVertexProgramParameters(), pass->getFragmentProgramParameters()})
+        {
+            if (params->_findNamedConstantDefinition("farCorner"))
+                params->setNamedConstant("farCorner", farCorner);
+        }
+    }
+
+    /// A sphere around the range of a point or spot light
+    class LightVolume : public SimpleRenderable
+    {
+    public:
+        LightVolume();
+        ~LightVolume() override;
+
+        void setLight(const Light* light);
+        /// Whether the camera is within the sphere, where only its back faces are in front of it
+        [[nodiscard]] auto containsCamera(const Camera* cam) const -> bool;
+
+        [[nodiscard]] auto getSquaredViewDepth(const Camera* cam) const -> Real override
+        {
+            return (cam->getDerivedPosition() - mCentre).squaredLength();
+        }
+        [[nodiscard]] auto getBoundingRadius() const -> Real override { return mRadius; }
+        void getWorldTransforms(Matrix4* xform) const override { *xform = mTransform; }
+
+    private:
+        static int constexpr RINGS = 8;
+        static int constexpr SEGMENTS = 16;
+
+        Vector3 mCentre{Vector3::ZERO};
+        Real mRadius{0};
+    };
+    //---------------------------------------------------------------------
+    LightVolume::LightVolume()
+    {
+        mRenderOp.vertexData = new VertexData();
+        mRenderOp.indexData = new IndexData();
+        mRenderOp.operationType = RenderOperation::OperationType::TRIANGLE_LIST;
+        mRenderOp.useIndexes = true;
+
+        std::vector<float> positions;
+        positions.reserve((RINGS + 1) * (SEGMENTS + 1) * 3);
+        for (int ring = 0; ring <= RINGS; ++ring)
+        {
+            Radian polar{ring * Math::PI / RINGS};
+            for (int segment = 0; segment <= SEGMENTS; ++segment)
+            {
+                Radian azimuth{segment * Math::TWO_PI / SEGMENTS};
+                positions.push_back(Math::Sin(polar) * Math::Sin(azimuth));
+                positions.push_back(Math::Cos(polar));
+                positions.push_back(Math::Sin(polar) * Math::Cos(azimuth));
+            }
+        }
+        // anticlockwise seen from the outside
+        std::vector<uint16> indices;
+        indices.reserve(RINGS * SEGMENTS * 6);
+        for (int ring = 0; ring < RINGS; ++ring)
+        {
+            for (int segment = 0; segment < SEGMENTS; ++segment)
+            {
+                auto top = static_cast<uint16>(ring * (SEGMENTS + 1) + segment);
+                auto bottom = static_cast<uint16>(top + SEGMENTS + 1);
+                indices.insert(indices.end(), {top, bottom, uint16(top + 1), bottom, uint16(bottom + 1), uint16(top + 1)});
+            }
+        }
+
+        auto& hbm = HardwareBufferManager::getSingleton();
+        VertexData* vertexData = mRenderOp.vertexData;
+        vertexData->vertexCount = positions.size() / 3;
+        vertexData->vertexDeclaration->addElement(0, 0, VertexElementType::FLOAT3, VertexElementSemantic::POSITION);
+        auto vbuf = hbm.createVertexBuffer(vertexData->vertexDeclaration->getVertexSize(0), vertexData->vertexCount,
+                                           HardwareBuffer::STATIC_WRITE_ONLY);
+        vbuf->writeData(0, vbuf->getSizeInBytes(), positions.data(), true);
+        vertexData->vertexBufferBinding->setBinding(0, vbuf);
+
+        IndexData* indexData = mRenderOp.indexData;
+        indexData->indexCount = indices.size();
+        indexData->indexBuffer = hbm.createIndexBuffer(HardwareIndexBuffer::IndexType::_16BIT, indexData->indexCount,
+                                                       HardwareBuffer::STATIC_WRITE_ONLY);
+        indexData->indexBuffer->writeData(0, indexData->indexBuffer->getSizeInBytes(), indices.data(), true);
+    }
+    //---------------------------------------------------------------------
+    LightVolume::~LightVolume()
+    {
+        delete mRenderOp.vertexData;
+        delete mRenderOp.indexData;
+    }
+    //---------------------------------------------------------------------
+    void LightVolume::setLight(const Light* light)
+    {
+        mCentre = light->getDerivedPosition();
+        // the faces are within the unit sphere, so it is scaled until they enclose the range
+        mRadius = light->getAttenuationRange() /
+                  (Math::Cos(Radian{Math::PI / RINGS}) * Math::Cos(Radian{Math::PI / SEGMENTS}));
+        mTransform.makeTransform(mCentre, Vector3{mRadius}, Quaternion::IDENTITY);
+        setBoundingBox({Vector3{-mRadius}, Vector3{mRadius}});
+    }
+    //---------------------------------------------------------------------
+    auto LightVolume::containsCamera(const Camera* cam) const -> bool
+    {
+        // the corners of the near plane must be outside too
+        Real margin = cam->getNearClipDistance() * 2;
+        return getSquaredViewDepth(cam) < Math::Sqr(mRadius + margin);
+    }
+
+    class DeferredLightRenderOperation : public CompositorInstance::RenderSystemOperation
+    {
+    public:
+        DeferredLightRenderOperation(CompositorInstance* instance);
+        ~DeferredLightRenderOperation() override;
+
+        void execute(SceneManager* sm, RenderSystem* rs) override;
+
+    private:
+        Viewport* mViewport;
+        /// Covers the screen for the ambient and the directional lights
+        Rectangle2D mScreenQuad;
+        LightVolume mVolume;
+        MaterialPtr mAmbientMaterial;
+        /// Where the shadow camera setup places the camera of a light, for its far clip distance
+        Camera* mShadowCamera;
+    };
+    //---------------------------------------------------------------------
+    DeferredLightRenderOperation::DeferredLightRenderOperation(CompositorInstance* instance)
+        : mViewport(instance->getChain()->getViewport())
+        , mAmbientMaterial(MaterialManager::getSingleton().getByName("DeferredShading/AmbientLight", RGN_DEFAULT))
+    {
+        mAmbientMaterial->load();
+        SceneManager* sm = mViewport->getCamera()->getSceneManager();
+        mShadowCamera = sm->createCamera(std::format("DeferredShading/ShadowCamera/{}", static_cast<void*>(this)));
+    }
+    //---------------------------------------------------------------------
+    DeferredLightRenderOperation::~DeferredLightRenderOperation()
+    {
+        mShadowCamera->getSceneManager()->destroyCamera(mShadowCamera);
+    }
+    //---------------------------------------------------------------------
+    void DeferredLightRenderOperation::execute(SceneManager* sm, RenderSystem* rs)
+    {
+        Camera* cam = mViewport->getCamera();
+        Vector3 farCorner = cam->getViewMatrix(true) * cam->getWorldSpaceCorners()[4];
+
+        // writes the depth of the G-buffer, which the light volumes and forward passes test against
+        Pass* ambient = mAmbientMaterial->getTechnique(0)->getPass(0);
+        setFarCorner(ambient, farCorner);
+        sm->_injectRenderWithPass(ambient, &mScreenQuad, false);
+
+        // all shadows at once, which with an atlas is a single bind of its target
+        const LightList& lights = sm->_getLightsAffectingFrustum();
+        LightList shadowLights;
+        if (sm->isShadowTechniqueTextureBased())
+        {
+            for (Light* light : lights)
+            {
+                if (light->getCastShadows() && shadowLights.size() < sm->getShadowTextureConfigList().size())
+                    shadowLights.push_back(light);
+            }
+        }
+        if (!shadowLights.empty())
+        {
+            SceneManager::RenderContext* context = sm->_pauseRendering();
+            sm->prepareShadowTextures(cam, mViewport, &shadowLights);
+            sm->_resumeRendering(context);
+        }
+
+        LightList lightList(1);
+        for (Light* light : lights)
+        {
+            auto shadow = std::ranges::find(shadowLights, light);
+            bool shadowed = shadow != shadowLights.end();
+            Pass* pass = getLightMaterial(getPermutation(light, shadowed))->getTechnique(0)->getPass(0);
+            setFarCorner(pass, farCorner);
+
+            if (shadowed)
+            {
+                // picks the shadow texture and projector prepared for the light
+                pass->setStartLight(static_cast<unsigned short>(shadow - shadowLights.begin()));
+                const ShadowCameraSetupPtr& setup =
+                    light->getCustomShadowCameraSetup() ? light->getCustomShadowCameraSetup() : sm->getShadowCameraSetup();
+                setup->getShadowCamera(sm, cam, mViewport, light, mShadowCamera, 0);
+                const GpuProgramParametersSharedPtr& params = pass->getFragmentProgramParameters();
+                params->setNamedConstant("shadowFarClip", mShadowCamera->getFarClipDistance());
+                params->setNamedConstant("shadowCamPos", mShadowCamera->getDerivedPosition());
+            }
+
+            Renderable* rend = &mScreenQuad;
+            if (light->getType() != Light::LightTypes::DIRECTIONAL)
+            {
+                // inside the volume, the back faces in front of the G-buffer are lit instead
+                mVolume.setLight(light);
+                bool inside = mVolume.containsCamera(cam);
+                pass->setCullingMode(inside ? CullingMode::ANTICLOCKWISE : CullingMode::CLOCKWISE);
+                pass->setDepthFunction(inside ? CompareFunction::GREATER_EQUAL : CompareFunction::LESS_EQUAL);
+                rend = &mVolume;
+            }
+            lightList[0] = light;
+            sm->_injectRenderWithPass(pass, rend, false, false, &lightList);
+        }
+    }
+
+    /// Gives the materials that cannot be lit from the G-buffer an empty GBuffer technique, and all others an empty NoGBuffer one
+    class GBufferSchemeListener : public MaterialManager::Listener
+    {
+    public:
+        auto handleSchemeNotFound(unsigned short schemeIndex, std::string_view schemeName, Material* originalMaterial,
+                                  unsigned short lodIndex, const Renderable* rend) -> Technique* override
+        {
+            bool forward = originalMaterial->isTransparent();
+            if (schemeName == "GBuffer")
+            {
+                // the RTSS generates it
+                if (!forward)
+                    return nullptr;
+            }
+            else if (forward)
+            {
+                Technique* technique = originalMaterial->createTechnique();
+                *technique = *originalMaterial->getTechnique(0);
+                technique->setSchemeName(schemeName);
+                return technique;
+            }
+
+            // so the listener is called once per material
+            Technique* empty = originalMaterial->createTechnique();
+            empty->removeAllPasses();
+            empty->setSchemeName(schemeName);
+            return empty;
+        }
+    };
+}
+//---------------------------------------------------------------------
+auto DeferredLightCompositionPass::createOperation(CompositorInstance* instance, const CompositionPass* pass)
+    -> CompositorInstance::RenderSystemOperation*
+{
+    return new DeferredLightRenderOperation(instance);
+}
+
+//------------------------------------------------------------------------------
+Sample_DeferredShading::Sample_DeferredShading()
+{
+    mInfo["Title"] = "Deferred Shading";
+    mInfo["Description"] = "Lights the scene from a G-buffer, drawing a volume per light "
+        "instead of a pass per object and light.";
+    mInfo["Thumbnail"] = "thumb_deferred.png";
+    mInfo["Category"] = "Lighting";
+    mInfo["Help"] = "The point lights are drawn as spheres around their range, the spot light "
+        "casts its shadow from the shadow atlas.";
+}
+
+//------------------------------------------------------------------------------
+auto Sample_DeferredShading::frameRenderingQueued(const FrameEvent& evt) noexcept -> bool
+{
+    mLightRing->yaw(Radian{evt.timeSinceLastFrame * 0.3f});
+    return SdkSample::frameRenderingQueued(evt);
+}
+
+//------------------------------------------------------------------------------
+void Sample_DeferredShading::setupContent()
+{
+    setupGBuffer();
+
+    mSceneMgr->setShadowTechnique(ShadowTechnique::TEXTURE_ADDITIVE);
+    mSceneMgr->setShadowTextureCasterMaterial(
+        MaterialManager::getSingleton().getByName("DeferredShading/Shadows/Caster", RGN_DEFAULT));
+    mSceneMgr->setShadowTextureSettings(1024, 4, PixelFormat::FLOAT16_R);
+    mSceneMgr->setShadowAtlas(true);
+
+    mSceneMgr->setSkyBox(true, "DeferredDemo/SkyBox", 500);
+
+    MeshManager::getSingleton().createPlane("DeferredShading/Ground", RGN_DEFAULT, Plane{Vector3::UNIT_Y, 0}, 400,
+                                            400, 10, 10, true, 1, 8, 8, Vector3::UNIT_Z);
+    Entity* ground = mSceneMgr->createEntity("DeferredShading/Ground");
+    ground->setMaterialName("DeferredDemo/Ground");
+    ground->setCastShadows(false);
+    mSceneMgr->getRootSceneNode()->attachObject(ground);
+
+    Entity* athene = mSceneMgr->createEntity("athene.mesh");
+    athene->setMaterialName("DeferredDemo/DeferredAthena");
+    SceneNode* atheneNode = mSceneMgr->getRootSceneNode()->createChildSceneNode(Vector3{0, 34, 0});
+    atheneNode->setScale(Vector3{0.4f});
+    atheneNode->attachObject(athene);
+
+    for (int i = 0; i < 8; ++i)
+    {
+        Entity* column = mSceneMgr->createEntity("column.mesh");
+        column->setMaterialName("DeferredDemo/RockWall");
+        Radian angle{i * Math::TWO_PI / 8};
+        mSceneMgr->getRootSceneNode()
+            ->createChildSceneNode(Vector3{Math::Cos(angle) * 120, 0, Math::Sin(angle) * 120})
+            ->attachObject(column);
+    }
+
+    setupLights();
+
+    mCamera->setNearClipDistance(1);
+    mCamera->setFarClipDistance(1000);
+    mCameraNode->setPosition(0, 120, 260);
+    mCameraNode->lookAt(Vector3{0, 30, 0}, Node::TransformSpace::WORLD);
+    setDragLook(true);
+}
+
+//------------------------------------------------------------------------------
+void Sample_DeferredShading::setupGBuffer()
+{
+    // diffuse colour and shininess, then the view space normal and distance
+    RTShader::RenderState* gbufferState = mShaderGenerator->createOrRetrieveRenderState("GBuffer").first;
+    auto* gbuffer = mShaderGenerator->createSubRenderState<RTShader::GBuffer>();
+    gbuffer->setOutBuffers({RTShader::GBuffer::TargetLayout::DIFFUSE_SPECULAR,
+                            RTShader::GBuffer::TargetLayout::NORMAL_VIEWDEPTH});
+    gbufferState->addTemplateSubRenderState(gbuffer);
+
+    mSchemeListener = std::make_unique<GBufferSchemeListener>();
+    MaterialManager::getSingleton().addListener(mSchemeListener.get(), "GBuffer");
+    MaterialManager::getSingleton().addListener(mSchemeListener.get(), "NoGBuffer");
+
+    CompositorManager& compositorManager = CompositorManager::getSingleton();
+    compositorManager.registerCustomCompositionPass("DeferredLight", &mLightPass);
+    compositorManager.addCompositor(mViewport, "DeferredShading/GBuffer");
+    compositorManager.addCompositor(mViewport, "DeferredShading/ShowLit");
+    compositorManager.setCompositorEnabled(mViewport, "DeferredShading/GBuffer", true);
+    compositorManager.setCompositorEnabled(mViewport, "DeferredShading/ShowLit", true);
+}
+
+//------------------------------------------------------------------------------
+void Sample_DeferredShading::setupLights()
+{
+    mSceneMgr->setAmbientLight(ColourValue{0.15f, 0.15f, 0.15f});
+
+    Light* sun = mSceneMgr->createLight(Light::LightTypes::DIRECTIONAL);
+    sun->setDiffuseColour(0.3f, 0.3f, 0.35f);
+    sun->setSpecularColour(ColourValue::Black);
+    sun->setCastShadows(false);
+    SceneNode* sunNode = mSceneMgr->getRootSceneNode()->createChildSceneNode();
+    sunNode->setDirection(Vector3{-1, -1, -0.5f}.normalisedCopy());
+    sunNode->attachObject(sun);
+
+    // only its volume is lit, many point lights cost little
+    mLightRing = mSceneMgr->getRootSceneNode()->createChildSceneNode();
+    int constexpr POINT_LIGHTS = 24;
+    for (int i = 0; i < POINT_LIGHTS; ++i)
+    {
+        Light* light = mSceneMgr->createLight(Light::LightTypes::POINT);
+        ColourValue colour;
+        colour.setHSB(static_cast<float>(i) / POINT_LIGHTS, 0.8f, 1.0f);
+        light->setDiffuseColour(colour);
+        light->setSpecularColour(colour);
+        light->setAttenuation(60, 1, 0.02f, 0.001f);
+        light->setCastShadows(false);
+        Radian angle{i * Math::TWO_PI / POINT_LIGHTS};
+        Real radius = i % 2 ? 80 : 150;
+        mLightRing->createChildSceneNode(Vector3{Math::Cos(angle) * radius, 10, Math::Sin(angle) * radius})
+            ->attachObject(light);
+    }
+
+    Light* spot = mSceneMgr->createLight(Light::LightTypes::SPOTLIGHT);
+    spot->setDiffuseColour(1.0f, 0.95f, 0.8f);
+    spot->setSpecularColour(1.0f, 1.0f, 1.0f);
+    spot->setAttenuation(400, 1, 0.001f, 0);
+    spot->setSpotlightRange(Degree{30}, Degree{45});
+    spot->setCastShadows(true);
+    SceneNode* spotNode = mSceneMgr->getRootSceneNode()->createChildSceneNode(Vector3{60, 160, 60});
+    spotNode->setDirection((Vector3{0, 20, 0} - spotNode->getPosition()).normalisedCopy(), Node::TransformSpace::WORLD);
+    spotNode->attachObject(spot);
+}
+
+//------------------------------------------------------------------------------
+void Sample_DeferredShading::cleanupContent()
+{
+    CompositorManager& compositorManager = CompositorManager::getSingleton();
+    compositorManager.removeCompositorChain(mViewport);
+    compositorManager.unregisterCustomCompositionPass("DeferredLight");
+
+    MaterialManager::getSingleton().removeListener(mSchemeListener.get(), "GBuffer");
+    MaterialManager::getSingleton().removeListener(mSchemeListener.get(), "NoGBuffer");
+    mSchemeListener.reset();
+
+    MeshManager::getSingleton().remove("DeferredShading/Ground", RGN_DEFAULT);
+}
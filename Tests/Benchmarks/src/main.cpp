@@ -0,0 +1,489 @@
+// This file is part of the OGRE project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at https://www.ogre3d.org/licensing.
+
+// Microbenchmarks of the core hot paths.
+//
+// Every benchmark is calibrated to run at least --min_time seconds, then measured --repetitions
+// times. The results go to stdout as JSON in the layout of Google Benchmark, one entry per
+// benchmark with the median of the repetitions, so its compare tools can track them across
+// versions. The inputs are generated from fixed seeds, so runs on the same machine compare.
+//
+//   OgreBenchmarks [--filter=<substring>] [--repetitions=5] [--min_time=0.1] [--out=<file>]
+
+#include <cstddef>
+#include <ctime>
+
+import Ogre.Core;
+
+import <algorithm>;
+import <atomic>;
+import <chrono>;
+import <cmath>;
+import <format>;
+import <fstream>;
+import <functional>;
+import <iostream>;
+import <memory>;
+import <random>;
+import <string>;
+import <string_view>;
+import <thread>;
+import <vector>;
+
+using namespace Ogre;
+
+namespace
+{
+    struct Benchmark
+    {
+        std::string_view name;
+        /// Items processed by one iteration, for the throughput
+        size_t items;
+        std::function<void()> iteration;
+    };
+
+    struct Result
+    {
+        std::string_view name;
+        size_t iterations;
+        double realNanoseconds;
+        double cpuNanoseconds;
+        double itemsPerSecond;
+    };
+
+    struct Options
+    {
+        std::string_view filter;
+        size_t repetitions{5};
+        double minTime{0.1};
+        std::string_view out;
+    };
+
+    /// Keeps the compiler from discarding what a benchmark computed
+    std::atomic<size_t> gSink{0};
+
+    auto measure(const Benchmark& benchmark, const Options& options) -> Result
+    {
+        using Clock = std::chrono::steady_clock;
+        auto run = [&benchmark](size_t iterations, double& cpuSeconds)
+        {
+            std::clock_t cpuStart = std::clock();
+            auto start = Clock::now();
+            for (size_t i = 0; i < iterations; ++i)
+                benchmark.iteration();
+            std::chrono::duration<double> elapsed = Clock::now() - start;
+            cpuSeconds = double(std::clock() - cpuStart) / CLOCKS_PER_SEC;
+            return elapsed.count();
+        };
+
+        // warm up the caches, then grow the iterations until a repetition is long enough
+        double cpuSeconds;
+        run(1, cpuSeconds);
+        size_t iterations = 1;
+        for (double seconds = run(iterations, cpuSeconds); seconds < options.minTime && iterations < (1u << 30);
+             seconds = run(iterations, cpuSeconds))
+        {
+            double factor = seconds > 0 ? 1.4 * options.minTime / seconds : 10;
+            iterations = std::max(iterations + 1, size_t(iterations * std::min(factor, 10.0)));
+        }
+
+        std::vector<double> real, cpu;
+        for (size_t r = 0; r < options.repetitions; ++r)
+        {
+            real.push_back(run(iterations, cpuSeconds) * 1e9 / iterations);
+            cpu.push_back(cpuSeconds * 1e9 / iterations);
+        }
+        auto median = [](std::vector<double>& values)
+        {
+            std::ranges::nth_element(values, values.begin() + values.size() / 2);
+            return values[values.size() / 2];
+        };
+
+        double realNanoseconds = median(real);
+        return {benchmark.name, iterations, realNanoseconds, median(cpu),
+                benchmark.items * 1e9 / realNanoseconds};
+    }
+
+    void writeJson(std::ostream& out, const std::vector<Result>& results, const Options& options)
+    {
+        auto now = std::chrono::system_clock::now();
+        out << "{\n  \"context\": {\n";
+        out << std::format("    \"date\": \"{:%Y-%m-%dT%H:%M:%S}\",\n", std::chrono::floor<std::chrono::seconds>(now));
+        out << std::format("    \"num_cpus\": {},\n", std::thread::hardware_concurrency());
+#ifdef NDEBUG
+        out << "    \"library_build_type\": \"release\",\n";
+#else
+        out << "    \"library_build_type\": \"debug\",\n";
+#endif
+        out << std::format("    \"repetitions\": {}\n  }},\n  \"benchmarks\": [\n", options.repetitions);
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            const Result& result = results[i];
+            out << std::format("    {{\"name\": \"{}\", \"run_type\": \"iteration\", \"iterations\": {}, "
+                               "\"real_time\": {:.3f}, \"cpu_time\": {:.3f}, \"time_unit\": \"ns\", "
+                               "\"items_per_second\": {:.1f}}}{}\n",
+                               result.name, result.iterations, result.realNanoseconds, result.cpuNanoseconds,
+                               result.itemsPerSecond, i + 1 < results.size() ? "," : "");
+        }
+        out << "  ]\n}\n";
+    }
+
+    /// A Root without RenderSystem and the resources of the samples, as for the unit tests
+    struct Environment
+    {
+        Environment()
+        {
+            LogManager::getSingleton().createLog("OgreBenchmarks.log", true, false, true);
+            mRoot = std::make_unique<Root>("");
+            mBuffers = std::make_unique<DefaultHardwareBufferManager>();
+            MaterialManager::getSingleton().initialise();
+
+            ConfigFile cf;
+            cf.load(FileSystemLayer(/*OGRE_VERSION_NAME*/"Tsathoggua").getConfigFilePath("resources.cfg"));
+            for (auto const& [secName, settings] : cf.getSettingsBySection())
+            {
+                for (auto const& [typeName, archName] : settings)
+                    ResourceGroupManager::getSingleton().addResourceLocation(archName, typeName, secName);
+            }
+        }
+
+        LogManager mLogManager;
+        std::unique_ptr<Root> mRoot;
+        std::unique_ptr<DefaultHardwareBufferManager> mBuffers;
+    };
+
+    auto randomBetween(std::minstd_rand& rng, float min, float max) -> float
+    {
+        return min + (max - min) * float(rng() - rng.min()) / float(rng.max() - rng.min());
+    }
+
+    /// 64 branches of 63 nodes, the branches turning every iteration
+    void addNodeBenchmarks(std::vector<Benchmark>& benchmarks, SceneManager* sceneMgr)
+    {
+        static size_t constexpr BRANCHES = 64, LEAVES = 63;
+        std::minstd_rand rng;
+        SceneNode* root = sceneMgr->getRootSceneNode();
+        auto branches = std::make_shared<std::vector<SceneNode*>>();
+        for (size_t b = 0; b < BRANCHES; ++b)
+        {
+            SceneNode* branch = root->createChildSceneNode(
+                Vector3{randomBetween(rng, -1000, 1000), 0, randomBetween(rng, -1000, 1000)});
+            for (size_t l = 0; l < LEAVES; ++l)
+                branch->createChildSceneNode(Vector3{randomBetween(rng, -10, 10), randomBetween(rng, -10, 10),
+                                                     randomBetween(rng, -10, 10)});
+            branches->push_back(branch);
+        }
+
+        benchmarks.push_back({"Node/update/4096", BRANCHES * (LEAVES + 1), [root, branches]
+        {
+            for (auto branch : *branches)
+                branch->yaw(Degree{1});
+            root->_update(true, false);
+            gSink += root->getChild(0)->getChild(0)->_getDerivedPosition().x > 0;
+        }});
+    }
+
+    void addCullingBenchmarks(std::vector<Benchmark>& benchmarks, SceneManager* sceneMgr)
+    {
+        static size_t constexpr BOXES = 10000;
+        Camera* camera = sceneMgr->createCamera("CullingCamera");
+        camera->setNearClipDistance(1);
+        camera->setFarClipDistance(2000);
+        SceneNode* node = sceneMgr->getRootSceneNode()->createChildSceneNode();
+        node->attachObject(camera);
+        node->_update(true, false);
+
+        std::minstd_rand rng;
+        auto boxes = std::make_shared<std::vector<AxisAlignedBox>>();
+        for (size_t i = 0; i < BOXES; ++i)
+        {
+            Vector3 centre{randomBetween(rng, -2000, 2000), randomBetween(rng, -2000, 2000),
+                           randomBetween(rng, -2000, 2000)};
+            Vector3 half{randomBetween(rng, 1, 20), randomBetween(rng, 1, 20), randomBetween(rng, 1, 20)};
+            boxes->emplace_back(centre - half, centre + half);
+        }
+
+        benchmarks.push_back({"Camera/isVisible/10000", BOXES, [camera, boxes]
+        {
+            size_t visible = 0;
+            for (const auto& box : *boxes)
+                visible += camera->isVisible(box);
+            gSink += visible;
+        }});
+    }
+
+    /// The sub entities of 2000 spheres, sorted as transparents and front to back
+    void addSortBenchmarks(std::vector<Benchmark>& benchmarks, SceneManager* sceneMgr)
+    {
+        static size_t constexpr ENTITIES = 2000;
+        Camera* camera = sceneMgr->createCamera("SortCamera");
+        SceneNode* cameraNode = sceneMgr->getRootSceneNode()->createChildSceneNode(Vector3{0, 0, 2500});
+        cameraNode->attachObject(camera);
+
+        std::minstd_rand rng;
+        auto renderables = std::make_shared<std::vector<std::pair<Pass*, Renderable*>>>();
+        for (size_t i = 0; i < ENTITIES; ++i)
+        {
+            Entity* entity = sceneMgr->createEntity("sphere.mesh");
+            sceneMgr->getRootSceneNode()
+                ->createChildSceneNode(Vector3{randomBetween(rng, -2000, 2000), randomBetween(rng, -2000, 2000),
+                                               randomBetween(rng, -2000, 2000)})
+                ->attachObject(entity);
+            for (size_t s = 0; s < entity->getNumSubEntities(); ++s)
+            {
+                SubEntity* subEntity = entity->getSubEntity(s);
+                renderables->emplace_back(subEntity->getTechnique()->getPass(0), subEntity);
+            }
+        }
+        sceneMgr->getRootSceneNode()->_update(true, false);
+
+        auto addSort = [&](std::string_view name, QueuedRenderableCollection::OrganisationMode mode)
+        {
+            auto collection = std::make_shared<QueuedRenderableCollection>();
+            collection->addOrganisationMode(mode);
+            benchmarks.push_back({name, renderables->size(), [collection, renderables, camera]
+            {
+                collection->clear();
+                for (auto [pass, renderable] : *renderables)
+                    collection->addRenderable(pass, renderable);
+                collection->sort(camera);
+            }});
+        };
+        addSort("QueuedRenderableCollection/sort/descending/2000",
+                QueuedRenderableCollection::OrganisationMode::SORT_DESCENDING);
+        addSort("QueuedRenderableCollection/sort/front_to_back/2000",
+                QueuedRenderableCollection::OrganisationMode::PASS_GROUP_FRONT_TO_BACK);
+    }
+
+    /// 10000 vertices with positions and normals, 4 weights of 64 bones each
+    void addSkinningBenchmarks(std::vector<Benchmark>& benchmarks)
+    {
+        static size_t constexpr VERTICES = 10000, WEIGHTS = 4, BONES = 64;
+        struct Data
+        {
+            std::vector<float> positions, normals, destPositions, destNormals, weights;
+            std::vector<unsigned char> indices;
+            std::vector<Affine3> bones;
+            std::vector<const Affine3*> bonePointers;
+        };
+        auto data = std::make_shared<Data>();
+
+        std::minstd_rand rng;
+        for (size_t v = 0; v < VERTICES * 3; ++v)
+        {
+            data->positions.push_back(randomBetween(rng, -1, 1));
+            data->normals.push_back(randomBetween(rng, -1, 1));
+        }
+        data->destPositions.resize(VERTICES * 3);
+        data->destNormals.resize(VERTICES * 3);
+        for (size_t v = 0; v < VERTICES; ++v)
+        {
+            float total = 0;
+            for (size_t w = 0; w < WEIGHTS; ++w)
+            {
+                data->weights.push_back(randomBetween(rng, 0.1f, 1));
+                data->indices.push_back(static_cast<unsigned char>(rng() % BONES));
+                total += data->weights.back();
+            }
+            for (size_t w = 0; w < WEIGHTS; ++w)
+                data->weights[v * WEIGHTS + w] /= total;
+        }
+        for (size_t b = 0; b < BONES; ++b)
+        {
+            auto orientation = Quaternion::FromAngleAndAxis(Radian{randomBetween(rng, 0, Math::TWO_PI)}, Vector3::UNIT_Y);
+            data->bones.push_back(Affine3::MakeTransform(Vector3{randomBetween(rng, -1, 1), 0, 0}, orientation));
+        }
+        for (const auto& bone : data->bones)
+            data->bonePointers.push_back(&bone);
+
+        benchmarks.push_back({"OptimisedUtil/softwareVertexSkinning/10000", VERTICES, [data]
+        {
+            OptimisedUtil::getImplementation()->softwareVertexSkinning(
+                data->positions.data(), data->destPositions.data(), data->normals.data(), data->destNormals.data(),
+                data->weights.data(), data->indices.data(), data->bonePointers.data(), 3 * sizeof(float),
+                3 * sizeof(float), 3 * sizeof(float), 3 * sizeof(float), WEIGHTS * sizeof(float), WEIGHTS,
+                WEIGHTS, VERTICES);
+            gSink += data->destPositions[0] > 0;
+        }});
+    }
+
+    /// One 1024x1024 image between common formats
+    void addPixelConversionBenchmarks(std::vector<Benchmark>& benchmarks)
+    {
+        static size_t constexpr PIXELS = 1024 * 1024;
+        auto addConversion = [&](std::string_view name, PixelFormat srcFormat, PixelFormat dstFormat)
+        {
+            auto src = std::make_shared<std::vector<uchar>>(PixelUtil::getMemorySize(1024, 1024, 1, srcFormat));
+            auto dst = std::make_shared<std::vector<uchar>>(PixelUtil::getMemorySize(1024, 1024, 1, dstFormat));
+            std::minstd_rand rng;
+            std::ranges::generate(*src, [&rng] { return static_cast<uchar>(rng()); });
+            benchmarks.push_back({name, PIXELS, [src, dst, srcFormat, dstFormat]
+            {
+                PixelUtil::bulkPixelConversion(PixelBox(1024, 1024, 1, srcFormat, src->data()),
+                                               PixelBox(1024, 1024, 1, dstFormat, dst->data()));
+                gSink += (*dst)[0];
+            }});
+        };
+        addConversion("PixelUtil/bulkPixelConversion/A8R8G8B8-A8B8G8R8", PixelFormat::A8R8G8B8, PixelFormat::A8B8G8R8);
+        addConversion("PixelUtil/bulkPixelConversion/R8G8B8-A8R8G8B8", PixelFormat::R8G8B8, PixelFormat::A8R8G8B8);
+        addConversion("PixelUtil/bulkPixelConversion/A8R8G8B8-FLOAT32_RGBA", PixelFormat::A8R8G8B8,
+                      PixelFormat::FLOAT32_RGBA);
+    }
+
+    /// knot.mesh from memory into a new mesh
+    void addMeshSerializerBenchmarks(std::vector<Benchmark>& benchmarks)
+    {
+        auto file = ResourceGroupManager::getSingleton().openResource(
+            "knot.mesh", ResourceGroupManager::AUTODETECT_RESOURCE_GROUP_NAME);
+        auto data = std::make_shared<MemoryDataStream>(file);
+
+        benchmarks.push_back({"MeshSerializer/importMesh/knot", 1, [data]
+        {
+            MeshPtr mesh = MeshManager::getSingleton().createManual("BenchmarkMesh", RGN_DEFAULT);
+            data->seek(0);
+            MeshSerializer().importMesh(
+                std::make_shared<MemoryDataStream>(data->getPtr(), data->size(), false, true), mesh.get());
+            gSink += mesh->getNumSubMeshes();
+            MeshManager::getSingleton().remove(mesh);
+        }});
+    }
+
+    /// Examples.material up to the abstract syntax tree, without creating the materials
+    void addScriptCompilerBenchmarks(std::vector<Benchmark>& benchmarks)
+    {
+        struct ParseOnly : public ScriptCompilerListener
+        {
+            auto postConversion(ScriptCompiler*, const AbstractNodeListPtr& nodes) -> bool override
+            {
+                gSink += nodes->size();
+                return false;
+            }
+        };
+
+        auto script = std::make_shared<String>(ResourceGroupManager::getSingleton()
+                                                   .openResource("Examples.material",
+                                                                 ResourceGroupManager::AUTODETECT_RESOURCE_GROUP_NAME)
+                                                   ->getAsString());
+        auto compiler = std::make_shared<ScriptCompiler>();
+        auto listener = std::make_shared<ParseOnly>();
+        compiler->setListener(listener.get());
+
+        benchmarks.push_back({"ScriptCompiler/compile/Examples.material", script->size(), [script, compiler, listener]
+        {
+            compiler->compile(*script, "Examples.material", RGN_DEFAULT);
+        }});
+    }
+
+    /// Small jobs, to show the overhead of scheduling rather than the jobs
+    void addWorkQueueBenchmarks(std::vector<Benchmark>& benchmarks)
+    {
+        static size_t constexpr JOBS = 4096;
+        auto queue = std::make_shared<DefaultWorkQueue>("Benchmarks");
+        queue->setWorkerThreadCount(std::max(1u, std::thread::hardware_concurrency()));
+        queue->startup();
+
+        benchmarks.push_back({"WorkQueue/parallelFor/4096", JOBS, [queue]
+        {
+            std::atomic<size_t> sum{0};
+            queue->parallelFor(JOBS, [&sum](size_t i) { sum.fetch_add(i, std::memory_order_relaxed); });
+            gSink += sum;
+        }});
+
+        benchmarks.push_back({"WorkQueue/addTask/4096", JOBS, [queue]
+        {
+            std::atomic<size_t> done{0};
+            for (size_t i = 0; i < JOBS; ++i)
+                queue->addTask([&done] { done.fetch_add(1, std::memory_order_release); });
+            while (done.load(std::memory_order_acquire) != JOBS)
+                std::this_thread::yield();
+        }});
+    }
+
+    /// 64 bit keys like those of the render queue, serially and on a work queue
+    void addRadixSortBenchmarks(std::vector<Benchmark>& benchmarks)
+    {
+        static size_t constexpr ITEMS = 100000;
+        using Sorter = RadixSort<std::vector<uint64>, uint64, uint64>;
+        auto queue = std::make_shared<DefaultWorkQueue>("RadixSortBenchmarks");
+        queue->setWorkerThreadCount(std::max(1u, std::thread::hardware_concurrency()));
+        queue->startup();
+
+        std::minstd_rand rng;
+        auto keys = std::make_shared<std::vector<uint64>>(ITEMS);
+        std::ranges::generate(*keys, [&rng] { return (uint64(rng() % 64) << 32) | rng(); });
+
+        auto addSort = [&](std::string_view name, WorkQueue* workQueue)
+        {
+            auto sorter = std::make_shared<Sorter>();
+            sorter->setWorkQueue(workQueue);
+            auto items = std::make_shared<std::vector<uint64>>();
+            benchmarks.push_back({name, ITEMS, [sorter, items, keys, queue]
+            {
+                *items = *keys;
+                sorter->sort(*items, [](uint64 key) { return key; });
+            }});
+        };
+        addSort("RadixSort/uint64/serial/100000", nullptr);
+        addSort("RadixSort/uint64/parallel/100000", queue.get());
+    }
+
+    auto parseOptions(int argc, char* argv[]) -> Options
+    {
+        Options options;
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string_view arg = argv[i];
+            auto value = [arg](std::string_view option) { return arg.substr(option.size()); };
+            if (arg.starts_with("--filter="))
+                options.filter = value("--filter=");
+            else if (arg.starts_with("--repetitions="))
+                options.repetitions = std::max<size_t>(1, StringConverter::parseSizeT(value("--repetitions=")));
+            else if (arg.starts_with("--min_time="))
+                options.minTime = StringConverter::parseReal(value("--min_time="));
+            else if (arg.starts_with("--out="))
+                options.out = value("--out=");
+            else
+                std::cerr << "Unknown option " << arg << '\n';
+        }
+        return options;
+    }
+}
+
+auto main(int argc, char* argv[]) -> int
+{
+    Options options = parseOptions(argc, argv);
+    Environment environment;
+
+    SceneManager* sceneMgr = environment.mRoot->createSceneManager();
+    std::vector<Benchmark> benchmarks;
+    addNodeBenchmarks(benchmarks, sceneMgr);
+    addCullingBenchmarks(benchmarks, sceneMgr);
+    addSortBenchmarks(benchmarks, environment.mRoot->createSceneManager());
+    addSkinningBenchmarks(benchmarks);
+    addPixelConversionBenchmarks(benchmarks);
+    addMeshSerializerBenchmarks(benchmarks);
+    addScriptCompilerBenchmarks(benchmarks);
+    addWorkQueueBenchmarks(benchmarks);
+    addRadixSortBenchmarks(benchmarks);
+
+    std::vector<Result> results;
+    for (const auto& benchmark : benchmarks)
+    {
+        if (benchmark.name.find(options.filter) == std::string_view::npos)
+            continue;
+        results.push_back(measure(benchmark, options));
+        std::cerr << std::format("{:<56} {:>14.1f} ns {:>16.0f} items/s\n", benchmark.name,
+                                 results.back().realNanoseconds, results.back().itemsPerSecond);
+    }
+    benchmarks.clear();
+
+    if (options.out.empty())
+        writeJson(std::cout, results, options);
+    else
+    {
+        std::ofstream out{String(options.out)};
+        writeJson(out, results, options);
+    }
+    return 0;
+}
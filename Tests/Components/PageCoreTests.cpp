@@ -0,0 +1,176 @@
+// This file is part of the OGRE project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at https://www.ogre3d.org/licensing.
+module;
+
+#include <gtest/gtest.h>
+#include <cstddef>
+
+module Ogre.Tests;
+
+import :Core.RootWithoutRenderSystemFixture;
+
+import Ogre.Components.Paging;
+import Ogre.Core;
+
+import <memory>;
+import <vector>;
+
+using namespace Ogre;
+
+namespace {
+    /// Two tasks per page, each adding a node with a light, no pages west of x = 0 if bounded
+    struct TestPageProvider : public PageProvider
+    {
+        bool bounded{false};
+        unsigned long taskMicros{0};
+        size_t defined{0};
+        size_t deactivated{0};
+
+        auto definePage(Page& page) -> bool override
+        {
+            if (bounded && page.getID().x < 0)
+                return false;
+            ++defined;
+            for (int i = 0; i < 2; ++i)
+            {
+                page.addActivationTask([this](Page& p) {
+                    Timer* timer = Root::getSingleton().getTimer();
+                    unsigned long start = timer->getMicroseconds();
+                    while (timer->getMicroseconds() - start < taskMicros) {}
+
+                    SceneNode* node = p.getSceneNode()->createChildSceneNode();
+                    node->attachObject(p.getWorld()->getSceneManager()->createLight());
+                });
+            }
+            return true;
+        }
+        void deactivatePage(Page& page) override
+        {
+            (void)page;
+            ++deactivated;
+        }
+    };
+}
+
+struct PagedWorldTests : public RootWithoutRenderSystemFixture
+{
+    SceneManager* mSceneMgr;
+    Camera* mCamera;
+    SceneNode* mCameraNode;
+    TestPageProvider mProvider;
+    std::unique_ptr<PagedWorld> mWorld;
+
+    void SetUp() override
+    {
+        RootWithoutRenderSystemFixture::SetUp();
+
+        mSceneMgr = mRoot->createSceneManager();
+        mCamera = mSceneMgr->createCamera("Camera");
+        mCameraNode = mSceneMgr->getRootSceneNode()->createChildSceneNode();
+        mCameraNode->attachObject(mCamera);
+        mCameraNode->setPosition(50, 0, 50);
+
+        mWorld = std::make_unique<PagedWorld>(mSceneMgr, &mProvider, 100);
+        mWorld->setLoadRadius(100);
+        mWorld->setCamera(mCamera);
+    }
+    void TearDown() override
+    {
+        mWorld.reset();
+        RootWithoutRenderSystemFixture::TearDown();
+    }
+};
+
+TEST_F(PagedWorldTests, LoadsPagesAroundCamera)
+{
+    mWorld->update();
+
+    // the 3x3 cells around the camera, the corners are 70.7 away
+    EXPECT_EQ(mWorld->getNumPages(), 9u);
+    EXPECT_EQ(mWorld->getSceneNode()->numChildren(), 9);
+    for (int32 y = -1; y <= 1; ++y)
+    {
+        for (int32 x = -1; x <= 1; ++x)
+        {
+            Page* page = mWorld->getPage({x, y});
+            ASSERT_TRUE(page);
+            EXPECT_EQ(page->getState(), Page::State::ACTIVE);
+            EXPECT_EQ(page->getSceneNode()->numChildren(), 2);
+            EXPECT_EQ(page->getSceneNode()->getPosition(), Vector3(Real(x) * 100, 0, Real(y) * 100));
+        }
+    }
+    EXPECT_FALSE(mWorld->getPage({2, 0}));
+}
+
+TEST_F(PagedWorldTests, KeepsPagesWithinUnloadRadius)
+{
+    mWorld->update();
+
+    // the two western columns are 150 and 250 away, within the default unload radius of 300
+    mCameraNode->setPosition(250, 0, 50);
+    mWorld->update();
+    EXPECT_TRUE(mWorld->getPage({-1, 0}));
+    EXPECT_TRUE(mWorld->getPage({3, 0}));
+    EXPECT_EQ(mProvider.deactivated, 0u);
+
+    mWorld->setUnloadRadius(100);
+    mWorld->update();
+    EXPECT_FALSE(mWorld->getPage({-1, 0}));
+    EXPECT_FALSE(mWorld->getPage({0, 0}));
+    EXPECT_EQ(mWorld->getNumPages(), 9u);
+    EXPECT_EQ(mProvider.deactivated, 6u);
+}
+
+TEST_F(PagedWorldTests, UnloadsPagesOutOfRange)
+{
+    mWorld->update();
+    size_t lights = mSceneMgr->getMovableObjects("Light").size();
+    EXPECT_EQ(lights, 18u);
+
+    mCameraNode->setPosition(5050, 0, 50);
+    mWorld->update();
+    EXPECT_EQ(mProvider.deactivated, 9u);
+    EXPECT_EQ(mProvider.defined, 18u);
+    EXPECT_EQ(mWorld->getNumPages(), 9u);
+    EXPECT_TRUE(mWorld->getPage({50, 0}));
+    EXPECT_EQ(mSceneMgr->getMovableObjects("Light").size(), lights);
+
+    mWorld->unloadAllPages();
+    EXPECT_EQ(mWorld->getNumPages(), 0u);
+    EXPECT_EQ(mWorld->getSceneNode()->numChildren(), 0);
+    EXPECT_TRUE(mSceneMgr->getMovableObjects("Light").empty());
+}
+
+TEST_F(PagedWorldTests, SkipsEmptyCells)
+{
+    mProvider.bounded = true;
+    mWorld->update();
+    EXPECT_EQ(mWorld->getNumPages(), 6u);
+    EXPECT_FALSE(mWorld->getPage({-1, 0}));
+
+    // not asked again while in range
+    mWorld->update();
+    EXPECT_EQ(mProvider.defined, 6u);
+}
+
+TEST_F(PagedWorldTests, ActivatesWithinBudget)
+{
+    // every task outlasts the budget, so one runs per update
+    mProvider.taskMicros = 20;
+    mWorld->setActivationBudget(10);
+
+    mWorld->update();
+    EXPECT_EQ(mWorld->getPage({0, 0})->getState(), Page::State::ACTIVATING);
+    EXPECT_EQ(mWorld->getPage({0, 0})->getNumPendingTasks(), 1u);
+    EXPECT_EQ(mWorld->getSceneNode()->numChildren(), 1);
+
+    mWorld->update();
+    EXPECT_EQ(mWorld->getPage({0, 0})->getState(), Page::State::ACTIVE);
+
+    for (int i = 0; i < 16; ++i)
+        mWorld->update();
+    for (int32 y = -1; y <= 1; ++y)
+        for (int32 x = -1; x <= 1; ++x)
+            EXPECT_EQ(mWorld->getPage({x, y})->getState(), Page::State::ACTIVE);
+}
@@ -37,7 +37,11 @@ import :Core.RootWithoutRenderSystemFixture;
 import Ogre.Components.RTShaderSystem;
 import Ogre.Core;
 
+import <cmath>;
+import <filesystem>;
+import <format>;
 import <memory>;
+import <vector>;
 
 using namespace Ogre;
 
@@ -76,6 +80,58 @@ TEST_F(RTShaderSystem, createShaderBasedTechnique)
 
     EXPECT_TRUE(shaderGen.removeShaderBasedTechnique(mat->getTechniques()[0], "MyScheme"));
 }
+TEST_F(RTShaderSystem, validateScheme)
+{
+    auto& shaderGen = RTShader::ShaderGenerator::getSingleton();
+    std::vector<MaterialPtr> mats;
+    for (int i = 0; i < 4; i++)
+    {
+        mats.push_back(MaterialManager::getSingleton().create(std::format("TestMat{}", i), RGN_DEFAULT));
+        // differing programs for some of them
+        mats.back()->setLightingEnabled(i % 2);
+        EXPECT_TRUE(shaderGen.createShaderBasedTechnique(mats.back()->getTechniques()[0], "MyScheme"));
+    }
+    shaderGen.getRenderState("MyScheme")->setLightCountAutoUpdate(false);
+
+    // the sources of all are written at once
+    EXPECT_TRUE(shaderGen.validateScheme("MyScheme"));
+    for (auto& mat : mats)
+    {
+        ASSERT_EQ(mat->getTechniques().size(), size_t(2));
+        auto pass = mat->getTechniques()[1]->getPasses()[0];
+        EXPECT_TRUE(pass->hasGpuProgram(GpuProgramType::VERTEX_PROGRAM));
+        EXPECT_TRUE(pass->hasGpuProgram(GpuProgramType::FRAGMENT_PROGRAM));
+    }
+    // identical sources share the program
+    EXPECT_EQ(mats[0]->getTechniques()[1]->getPasses()[0]->getVertexProgram(),
+              mats[2]->getTechniques()[1]->getPasses()[0]->getVertexProgram());
+}
+TEST_F(RTShaderSystem, UberShaders)
+{
+    auto& shaderGen = RTShader::ShaderGenerator::getSingleton();
+    auto matA = MaterialManager::getSingleton().create("TestMatA", RGN_DEFAULT);
+    auto matB = MaterialManager::getSingleton().create("TestMatB", RGN_DEFAULT);
+    shaderGen.createShaderBasedTechnique(matA->getTechniques()[0], "MyScheme");
+    shaderGen.createShaderBasedTechnique(matB->getTechniques()[0], "MyScheme");
+    shaderGen.getRenderState("MyScheme")->setLightCountAutoUpdate(false);
+    shaderGen.getRenderState("MyScheme")->setUberShaders(true);
+
+    // as many lights, but of different types
+    auto rstateA = shaderGen.getRenderState("MyScheme", *matA);
+    rstateA->setLightCountAutoUpdate(false);
+    rstateA->setLightCount(Vector3i{1, 1, 0});
+    auto rstateB = shaderGen.getRenderState("MyScheme", *matB);
+    rstateB->setLightCountAutoUpdate(false);
+    rstateB->setLightCount(Vector3i{0, 1, 1});
+
+    EXPECT_TRUE(shaderGen.validateScheme("MyScheme"));
+
+    auto vsA = matA->getTechniques()[1]->getPasses()[0]->getVertexProgram();
+    auto vsB = matB->getTechniques()[1]->getPasses()[0]->getVertexProgram();
+    EXPECT_EQ(vsA, vsB);
+    EXPECT_TRUE(vsA->getSource().find("SGX_Light_Generic_Diffuse") != String::npos);
+    EXPECT_TRUE(vsA->getSource().find("FFP_VertexFog_Generic") != String::npos);
+}
 TEST_F(RTShaderSystem, MaterialSerializer)
 {
     auto& shaderGen = RTShader::ShaderGenerator::getSingleton();
@@ -94,6 +150,37 @@ TEST_F(RTShaderSystem, MaterialSerializer)
     ser.queueForExport(mat);
     EXPECT_TRUE(ser.getQueuedAsString().find("colour_stage") != String::npos);
 }
+TEST_F(RTShaderSystem, VariantManifest)
+{
+    auto& shaderGen = RTShader::ShaderGenerator::getSingleton();
+    auto cachePath = std::filesystem::temp_directory_path() / "OgreVariantManifest";
+    std::filesystem::create_directories(cachePath);
+    shaderGen.setShaderCachePath(cachePath.generic_string() + "/");
+
+    auto mat = MaterialManager::getSingleton().create("TestMat", RGN_DEFAULT);
+    MaterialManager::getSingleton().create("Unused", RGN_DEFAULT);
+    shaderGen.createShaderBasedTechnique(mat->getTechniques()[0], "MyScheme");
+    EXPECT_TRUE(shaderGen.createShaderBasedTechnique(*MaterialManager::getSingleton().getByName("Unused"),
+                                                     MaterialManager::DEFAULT_SCHEME_NAME, "MyScheme"));
+    shaderGen.getRenderState("MyScheme")->setLightCountAutoUpdate(false);
+    shaderGen.validateMaterial("MyScheme", *mat);
+
+    // only the generated variants are recorded
+    shaderGen.writeVariantManifest();
+    shaderGen.removeAllShaderBasedTechniques();
+    EXPECT_FALSE(shaderGen.hasShaderBasedTechnique("TestMat", RGN_DEFAULT, MaterialManager::DEFAULT_SCHEME_NAME,
+                                                   "MyScheme"));
+
+    EXPECT_EQ(shaderGen.warmUpVariants(), 1u);
+    EXPECT_TRUE(shaderGen.hasShaderBasedTechnique("TestMat", RGN_DEFAULT, MaterialManager::DEFAULT_SCHEME_NAME,
+                                                  "MyScheme"));
+    EXPECT_FALSE(shaderGen.hasShaderBasedTechnique("Unused", RGN_DEFAULT, MaterialManager::DEFAULT_SCHEME_NAME,
+                                                   "MyScheme"));
+    EXPECT_EQ(mat->getTechniques().back()->getSchemeName(), "MyScheme");
+
+    shaderGen.setShaderCachePath("");
+    std::filesystem::remove_all(cachePath);
+}
 TEST_F(RTShaderSystem, TargetRenderState)
 {
     auto mat = MaterialManager::getSingleton().create("TestMat", RGN_DEFAULT);
@@ -125,3 +212,46 @@ TEST_F(RTShaderSystem, FunctionInvocationOrder)
     EXPECT_TRUE(c == a);
     EXPECT_FALSE(c < a);
 }
+TEST_F(RTShaderSystem, IntegratedPSSM3Filter)
+{
+    RTShader::IntegratedPSSM3 pssm;
+    EXPECT_TRUE(pssm.setParameter("filter", "pcf16"));
+    EXPECT_TRUE(pssm.setParameter("filter", "esm"));
+    EXPECT_TRUE(pssm.setParameter("filter", "evsm"));
+    EXPECT_FALSE(pssm.setParameter("filter", "vsm"));
+}
+TEST_F(RTShaderSystem, LightClusters)
+{
+    SceneManager* sm = mRoot->createSceneManager();
+    Camera* cam = sm->createCamera("Camera");
+    cam->setNearClipDistance(1);
+    cam->setFarClipDistance(1000);
+    sm->getRootSceneNode()->attachObject(cam);
+
+    Light* sun = sm->createLight(Light::LightTypes::DIRECTIONAL);
+    sm->getRootSceneNode()->attachObject(sun);
+    Light* lamp = sm->createLight(Light::LightTypes::POINT);
+    lamp->setAttenuation(10, 1, 0, 0);
+    sm->getRootSceneNode()->createChildSceneNode(Vector3{0, 0, -50})->attachObject(lamp);
+    sm->_updateSceneGraph(cam);
+
+    // local lights are given after the directional ones
+    LightList lights;
+    lights.push_back(lamp);
+    lights.push_back(sun);
+
+    RTShader::LightClusters clusters;
+    clusters.assign(cam, lights);
+    EXPECT_EQ(clusters.getDirectionalLightCount(), 1u);
+    EXPECT_EQ(clusters.getLightCount(), 2u);
+
+    // 50 units away, in the middle of the screen
+    uint32 slice = uint32(std::log(50.0f) * clusters.getDepthParams().y);
+    auto centre = clusters.getClusterLights(RTShader::LightClusters::GRID_X / 2, RTShader::LightClusters::GRID_Y / 2, slice);
+    ASSERT_EQ(centre.size(), 1u);
+    EXPECT_EQ(centre[0], 1.0f);
+
+    EXPECT_TRUE(clusters.getClusterLights(0, 0, 0).empty());
+    EXPECT_TRUE(clusters.getClusterLights(RTShader::LightClusters::GRID_X / 2, RTShader::LightClusters::GRID_Y / 2,
+                                          RTShader::LightClusters::GRID_Z - 1).empty());
+}
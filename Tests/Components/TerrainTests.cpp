@@ -0,0 +1,135 @@
+// This file is part of the OGRE project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at https://www.ogre3d.org/licensing.
+module;
+
+#include <gtest/gtest.h>
+#include <cstddef>
+
+module Ogre.Tests;
+
+import :Core.RootWithoutRenderSystemFixture;
+
+import Ogre.Components.Terrain;
+import Ogre.Core;
+
+import <memory>;
+import <vector>;
+
+using namespace Ogre;
+
+namespace {
+    /// samples * samples heights rising by dx per step along X and dz along Z
+    auto makeRamp(uint32 samples, float dx, float dz) -> std::vector<float>
+    {
+        std::vector<float> heights;
+        heights.reserve(size_t(samples) * samples);
+        for (uint32 z = 0; z < samples; ++z)
+            for (uint32 x = 0; x < samples; ++x)
+                heights.push_back(float(x) * dx + float(z) * dz);
+        return heights;
+    }
+
+    auto coveredArea(const std::vector<TerrainQuadTree::Patch>& patches) -> Real
+    {
+        Real area = 0;
+        for (const auto& patch : patches)
+            area += Real(patch.size) * Real(patch.size);
+        return area;
+    }
+}
+
+TEST(TerrainQuadTreeTests, BuildsLevelsAndBounds)
+{
+    auto heights = makeRamp(257, 1, 0);
+    TerrainQuadTree tree{heights.data(), 257, 32, 1};
+
+    EXPECT_EQ(tree.getNumLeaves(), 8u);
+    EXPECT_EQ(tree.getNumLevels(), 4u);
+    EXPECT_EQ(tree.getBounds().getMinimum(), Vector3(0, 0, 0));
+    EXPECT_EQ(tree.getBounds().getMaximum(), Vector3(256, 256, 256));
+
+    // the leaf borders are shared with the neighbours
+    AxisAlignedBox leaf = tree.getNodeBounds(0, 1, 0);
+    EXPECT_EQ(leaf.getMinimum(), Vector3(32, 32, 0));
+    EXPECT_EQ(leaf.getMaximum(), Vector3(64, 64, 32));
+}
+
+TEST(TerrainQuadTreeTests, SelectsByDistance)
+{
+    auto heights = makeRamp(257, 0, 0);
+    TerrainQuadTree tree{heights.data(), 257, 32, 1};
+    std::vector<TerrainQuadTree::Patch> patches;
+
+    tree.select({0, 0, 0}, 64, patches);
+    ASSERT_FALSE(patches.empty());
+    EXPECT_EQ(patches.front().size, 32.0f);
+    EXPECT_EQ(patches.front().level, 0.0f);
+    EXPECT_GT(patches.size(), 4u);
+    EXPECT_LT(patches.size(), 64u);
+    EXPECT_EQ(coveredArea(patches), Real(256 * 256));
+
+    tree.select({10000, 0, 10000}, 64, patches);
+    ASSERT_EQ(patches.size(), 1u);
+    EXPECT_EQ(patches.front().size, 256.0f);
+    EXPECT_EQ(patches.front().level, 3.0f);
+}
+
+struct TerrainTileTests : public RootWithoutRenderSystemFixture
+{
+    TerrainTileFactory mFactory;
+    SceneManager* mSceneMgr;
+    std::shared_ptr<TerrainGrid> mGrid;
+
+    void SetUp() override
+    {
+        RootWithoutRenderSystemFixture::SetUp();
+        mRoot->addMovableObjectFactory(&mFactory);
+        mSceneMgr = mRoot->createSceneManager();
+        mGrid = std::make_shared<TerrainGrid>(32);
+    }
+    void TearDown() override
+    {
+        mGrid.reset();
+        mRoot->destroySceneManager(mSceneMgr);
+        mRoot->removeMovableObjectFactory(&mFactory);
+        RootWithoutRenderSystemFixture::TearDown();
+    }
+};
+
+TEST_F(TerrainTileTests, InterpolatesHeights)
+{
+    auto* tile = static_cast<TerrainTile*>(mSceneMgr->createMovableObject("Tile", TerrainTileFactory::FACTORY_TYPE_NAME));
+    tile->setHeights(mGrid, 64, 33, makeRamp(33, 1, 2));
+
+    EXPECT_EQ(tile->getBoundingBox().getMaximum(), Vector3(64, 96, 64));
+    EXPECT_FLOAT_EQ(tile->getHeightAt(3, 5), 6.5f);
+    EXPECT_FLOAT_EQ(tile->getHeightAt(-10, 100), 64.0f);
+    EXPECT_FLOAT_EQ(tile->getHeightAt(64, 64), 96.0f);
+}
+
+TEST_F(TerrainTileTests, CullsPatchesAgainstCamera)
+{
+    auto* tile = static_cast<TerrainTile*>(mSceneMgr->createMovableObject("Tile", TerrainTileFactory::FACTORY_TYPE_NAME));
+    tile->setHeights(mGrid, 128, 65, makeRamp(65, 0, 0));
+    mSceneMgr->getRootSceneNode()->attachObject(tile);
+
+    // looking down -Z onto the tile
+    Camera* camera = mSceneMgr->createCamera("Camera");
+    camera->setNearClipDistance(1);
+    SceneNode* node = mSceneMgr->getRootSceneNode()->createChildSceneNode(Vector3(64, 10, 200));
+    node->attachObject(camera);
+
+    // within the range of the leaves
+    tile->updatePatches(camera);
+    EXPECT_EQ(tile->getNumPatches(), 4u);
+
+    // beyond the range of the root
+    tile->setLodDistance(16);
+    tile->updatePatches(camera);
+    EXPECT_EQ(tile->getNumPatches(), 1u);
+
+    node->yaw(Degree(180));
+    tile->updatePatches(camera);
+    EXPECT_EQ(tile->getNumPatches(), 0u);
+}
@@ -0,0 +1,179 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+export module Ogre.Tests:Core.RecordingRenderSystem;
+
+export import Ogre.Core;
+
+import <span>;
+import <string_view>;
+import <utility>;
+import <vector>;
+
+/// An occlusion query returning the samples set by the test
+export
+class RecordingOcclusionQuery : public Ogre::HardwareOcclusionQuery
+{
+public:
+    /// The number of samples the query returns
+    unsigned int samples{0};
+    /// Whether the result is not available yet
+    bool outstanding{false};
+    /// Number of beginOcclusionQuery calls
+    size_t queriesIssued{0};
+
+    void beginOcclusionQuery() override { ++queriesIssued; }
+    void endOcclusionQuery() override {}
+    auto pullOcclusionQuery(unsigned int* numOfFragments) -> bool override
+    {
+        mPixelCount = samples;
+        *numOfFragments = mPixelCount;
+        return true;
+    }
+    auto isStillOutstanding() noexcept -> bool override { return outstanding; }
+};
+
+/** A RenderSystem which draws nothing, but records the state calls the tests look at.
+@remarks
+    Only the fixed function pipeline is supported, so passes must not use programs
+    nor texture units. Give it to a SceneManager with _setDestinationRenderSystem.
+*/
+export
+class RecordingRenderSystem : public Ogre::RenderSystem
+{
+public:
+    /// The arguments of every _setDepthBias call
+    std::vector<std::pair<float, float>> depthBiasCalls;
+    /// Number of setColourBlendState calls
+    size_t blendStateCalls{0};
+    /// The last _setPolygonMode argument
+    Ogre::PolygonMode polygonMode{Ogre::PolygonMode::SOLID};
+    /// The occlusion queries created, in order
+    std::vector<RecordingOcclusionQuery*> occlusionQueries;
+    /// The number of operations of every _render and _renderMultiple call
+    std::vector<size_t> draws;
+
+    RecordingRenderSystem()
+    {
+        mRealCapabilities.reset(createRenderSystemCapabilities());
+        mCurrentCapabilities = mRealCapabilities.get();
+    }
+
+    /// Adds a capability, e.g. Capabilities::MULTI_DRAW
+    void setCapability(Ogre::Capabilities c) { mRealCapabilities->setCapability(c); }
+
+    [[nodiscard]] auto getName() const noexcept -> std::string_view override { return "Recording"; }
+    void setConfigOption(std::string_view name, std::string_view value) override { (void)name; (void)value; }
+    auto createHardwareOcclusionQuery() -> Ogre::HardwareOcclusionQuery* override
+    {
+        auto query = new RecordingOcclusionQuery();
+        mHwOcclusionQueries.push_back(query);
+        occlusionQueries.push_back(query);
+        return query;
+    }
+    [[nodiscard]] auto createRenderSystemCapabilities() const -> Ogre::RenderSystemCapabilities* override
+    {
+        auto caps = new Ogre::RenderSystemCapabilities();
+        caps->setCapability(Ogre::Capabilities::FIXED_FUNCTION);
+        return caps;
+    }
+    auto createMultiRenderTarget(std::string_view name) -> Ogre::MultiRenderTarget* override
+    {
+        (void)name;
+        return nullptr;
+    }
+    void _setSampler(size_t texUnit, Ogre::Sampler& s) override { (void)texUnit; (void)s; }
+    void _setTexture(size_t unit, bool enabled, const Ogre::TexturePtr& texPtr) override
+    {
+        (void)unit; (void)enabled; (void)texPtr;
+    }
+    void setColourBlendState(const Ogre::ColourBlendState& state) override
+    {
+        (void)state;
+        ++blendStateCalls;
+    }
+    void _setAlphaRejectSettings(Ogre::CompareFunction func, unsigned char value, bool alphaToCoverage) override
+    {
+        (void)func; (void)value; (void)alphaToCoverage;
+    }
+    auto _createDepthBufferFor(Ogre::RenderTarget* renderTarget) -> Ogre::DepthBuffer* override
+    {
+        (void)renderTarget;
+        return nullptr;
+    }
+    void _render(const Ogre::RenderOperation& op) override
+    {
+        draws.push_back(1);
+        RenderSystem::_render(op);
+    }
+    void _renderMultiple(std::span<const Ogre::RenderOperation* const> ops) override
+    {
+        draws.push_back(ops.size());
+        for (auto op : ops)
+            RenderSystem::_render(*op);
+    }
+    void _endFrame() override {}
+    void _setViewport(Ogre::Viewport* vp) override { mActiveViewport = vp; }
+    void _setCullingMode(Ogre::CullingMode mode) override { mCullingMode = mode; }
+    void _setDepthBufferParams(bool depthTest, bool depthWrite, Ogre::CompareFunction depthFunction) override
+    {
+        (void)depthTest; (void)depthWrite; (void)depthFunction;
+    }
+    void _setDepthBias(float constantBias, float slopeScaleBias) override
+    {
+        depthBiasCalls.emplace_back(constantBias, slopeScaleBias);
+    }
+    void _convertProjectionMatrix(const Ogre::Matrix4& matrix, Ogre::Matrix4& dest, bool forGpuProgram) override
+    {
+        (void)forGpuProgram;
+        dest = matrix;
+    }
+    void _setPolygonMode(Ogre::PolygonMode level) override { polygonMode = level; }
+    void setStencilState(const Ogre::StencilState& state) override { (void)state; }
+    void bindGpuProgramParameters(Ogre::GpuProgramType gptype, const Ogre::GpuProgramParametersPtr& params,
+                                  Ogre::GpuParamVariability variabilityMask) override
+    {
+        (void)gptype; (void)params; (void)variabilityMask;
+    }
+    void setScissorTest(bool enabled, const Ogre::Rect& rect) override { (void)enabled; (void)rect; }
+    void clearFrameBuffer(Ogre::FrameBufferType buffers, const Ogre::ColourValue& colour, float depth,
+                          Ogre::uint16 stencil) override
+    {
+        (void)buffers; (void)colour; (void)depth; (void)stencil;
+    }
+    auto getMinimumDepthInputValue() -> Ogre::Real override { return -1; }
+    auto getMaximumDepthInputValue() -> Ogre::Real override { return 1; }
+    void _setRenderTarget(Ogre::RenderTarget* target) override { mActiveRenderTarget = target; }
+    void beginProfileEvent(std::string_view eventName) override { (void)eventName; }
+    void endProfileEvent() override {}
+    void markProfileEvent(std::string_view event) override { (void)event; }
+    void initialiseFromRenderSystemCapabilities(Ogre::RenderSystemCapabilities* caps,
+                                                Ogre::RenderTarget* primary) override
+    {
+        (void)caps; (void)primary;
+    }
+};
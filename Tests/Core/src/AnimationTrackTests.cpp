@@ -0,0 +1,243 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+module;
+
+#include <gtest/gtest.h>
+#include <cstddef>
+
+module Ogre.Tests;
+
+import :Core.RootWithoutRenderSystemFixture;
+
+import Ogre.Core;
+
+import <cmath>;
+import <memory>;
+import <vector>;
+
+using namespace Ogre;
+
+TEST(AnimationTrackTests, KeyFramesAtTime)
+{
+    Animation anim{"test", 4};
+    NodeAnimationTrack* track = anim.createNodeTrack(0);
+    // out of order on purpose
+    for (Real time : {0.0f, 2.0f, 1.0f, 3.0f})
+        track->createNodeKeyFrame(time)->setTranslate(Vector3{time, 0, 0});
+
+    KeyFrame *kf1, *kf2;
+    unsigned short firstKeyIndex;
+    Real t = track->getKeyFramesAtTime(TimeIndex{1.5f}, &kf1, &kf2, &firstKeyIndex);
+    EXPECT_FLOAT_EQ(t, 0.5f);
+    EXPECT_EQ(kf1->getTime(), 1.0f);
+    EXPECT_EQ(kf2->getTime(), 2.0f);
+    EXPECT_EQ(firstKeyIndex, 1);
+
+    // past the last keyframe wraps around to the first one
+    t = track->getKeyFramesAtTime(TimeIndex{3.5f}, &kf1, &kf2);
+    EXPECT_FLOAT_EQ(t, 0.5f);
+    EXPECT_EQ(kf1->getTime(), 3.0f);
+    EXPECT_EQ(kf2->getTime(), 0.0f);
+
+    // the interpolation follows keyframe edits
+    TransformKeyFrame kf{nullptr, 0};
+    track->getInterpolatedKeyFrame(anim._getTimeIndex(2.5f), &kf);
+    EXPECT_FLOAT_EQ(kf.getTranslate().x, 2.5f);
+    track->getNodeKeyFrame(3)->setTranslate(Vector3{5, 0, 0});
+    track->getInterpolatedKeyFrame(anim._getTimeIndex(2.5f), &kf);
+    EXPECT_FLOAT_EQ(kf.getTranslate().x, 3.5f);
+
+    track->removeKeyFrame(1);
+    t = track->getKeyFramesAtTime(TimeIndex{1.0f}, &kf1, &kf2, &firstKeyIndex);
+    EXPECT_FLOAT_EQ(t, 0.5f);
+    EXPECT_EQ(firstKeyIndex, 0);
+}
+
+TEST(AnimationTrackTests, TimeIndexHint)
+{
+    Animation anim{"test", 10};
+    NodeAnimationTrack* track = anim.createNodeTrack(0);
+    for (int i = 0; i < 10; ++i)
+        track->createNodeKeyFrame(Real(i));
+
+    // sequential playback, including looping and jumping back
+    uint hint = 0;
+    for (Real time = 0; time < 25; time += 0.3f)
+        EXPECT_EQ(anim._getTimeIndex(time, &hint).getKeyIndex(), anim._getTimeIndex(time).getKeyIndex());
+    EXPECT_EQ(anim._getTimeIndex(1.5f, &hint).getKeyIndex(), 2u);
+    EXPECT_EQ(hint, 2u);
+
+    // an out of range hint falls back to the search
+    hint = 100;
+    EXPECT_EQ(anim._getTimeIndex(9.5f, &hint).getKeyIndex(), 10u);
+}
+
+TEST(AnimationTrackTests, CompressedNodeTrack)
+{
+    Animation anim{"test", 10};
+    NodeAnimationTrack* track = anim.createNodeTrack(0);
+    for (int i = 0; i < 100; ++i)
+    {
+        Real time = i * 0.1f;
+        TransformKeyFrame* kf = track->createNodeKeyFrame(time);
+        // linear, smooth and constant curves
+        kf->setTranslate(Vector3{time, 2 * time, -time});
+        kf->setRotation(Quaternion{Radian{0.1f * std::sin(time)}, Vector3::UNIT_Y});
+        kf->setScale(Vector3{1, 2, 3});
+    }
+
+    auto sample = [&](Real time, Vector3& translate, Quaternion& rotate, Vector3& scale)
+    {
+        TransformKeyFrame kf{nullptr, time};
+        track->getInterpolatedKeyFrame(TimeIndex{time}, &kf);
+        translate = kf.getTranslate();
+        rotate = kf.getRotation();
+        scale = kf.getScale();
+    };
+    std::vector<Vector3> translates(200), scales(200);
+    std::vector<Quaternion> rotates(200);
+    for (int i = 0; i < 200; ++i)
+        sample(i * 0.05f, translates[i], rotates[i], scales[i]);
+
+    CompressedNodeTrack::Tolerance tolerance;
+    track->compress(tolerance);
+    ASSERT_TRUE(track->getCompressed());
+    EXPECT_EQ(track->getNumKeyFrames(), 0u);
+    EXPECT_TRUE(track->hasNonZeroKeyFrames());
+    EXPECT_LT(track->getCompressed()->getNumKeys(), 60u);
+    EXPECT_LT(track->getCompressed()->getMemoryUsage(), 100 * sizeof(TransformKeyFrame));
+
+    for (int i = 0; i < 200; ++i)
+    {
+        Vector3 translate, scale;
+        Quaternion rotate;
+        sample(i * 0.05f, translate, rotate, scale);
+        // between keys the curves differ a little more than at the keys
+        EXPECT_LE(translate.distance(translates[i]), 2 * tolerance.translate);
+        EXPECT_TRUE(rotate.equals(rotates[i], tolerance.rotate * 2));
+        EXPECT_TRUE(scale.positionEquals(scales[i], tolerance.scale));
+    }
+
+    size_t numKeys = track->getCompressed()->getKeyTimes().size();
+    track->decompress();
+    EXPECT_FALSE(track->getCompressed());
+    EXPECT_EQ(track->getNumKeyFrames(), numKeys);
+    Vector3 translate, scale;
+    Quaternion rotate;
+    sample(2.5f, translate, rotate, scale);
+    EXPECT_LE(translate.distance(translates[50]), 2 * tolerance.translate);
+}
+
+TEST(AnimationTrackTests, PackRotation)
+{
+    for (const auto& q : {Quaternion::IDENTITY, Quaternion{Degree{170}, Vector3{1, 2, 3}.normalisedCopy()},
+                          Quaternion{-0.5f, 0.5f, -0.5f, 0.5f}})
+    {
+        uint16 packed[3];
+        CompressedNodeTrack::packRotation(q, packed);
+        EXPECT_TRUE(CompressedNodeTrack::unpackRotation(packed).equals(q, Radian{1e-4f}));
+    }
+}
+
+TEST(AnimationTrackTests, HardwarePoseWeights)
+{
+    DefaultHardwareBufferManagerBase mgr;
+    VertexData data{&mgr};
+    data.vertexCount = 4;
+
+    // many more poses than there are texture coordinates for pose streams
+    std::vector<std::unique_ptr<Pose>> poses;
+    PoseList poseList;
+    for (int i = 0; i < 64; ++i)
+        poseList.push_back(poses.emplace_back(std::make_unique<Pose>(0)).get());
+    data.hwPoseWeights.assign(poseList.size(), 0.0f);
+
+    Animation anim{"test", 1};
+    VertexAnimationTrack* track = anim.createVertexTrack(0, &data, VertexAnimationType::POSE);
+    track->setTargetMode(VertexAnimationTrack::TargetMode::HARDWARE);
+    VertexPoseKeyFrame* kf = track->createVertexPoseKeyFrame(0);
+    for (ushort i = 0; i < poseList.size(); i += 2)
+        kf->addPoseReference(i, 1.0f / (i + 1));
+
+    track->applyToVertexData(&data, TimeIndex{0}, 0.5f, &poseList);
+    // influences accumulate over the tracks of a frame
+    track->applyToVertexData(&data, TimeIndex{0}, 0.5f, &poseList);
+    for (size_t i = 0; i < poseList.size(); ++i)
+        EXPECT_FLOAT_EQ(data.hwPoseWeights[i], i % 2 ? 0.0f : 1.0f / (i + 1));
+
+    // nothing to bind
+    EXPECT_TRUE(data.hwAnimationDataList.empty());
+    EXPECT_EQ(data.hwAnimDataItemsUsed, 0u);
+    EXPECT_FALSE(data.vertexBufferBinding->isBufferBound(0));
+}
+
+using PoseTextureTests = RootWithoutRenderSystemFixture;
+
+TEST_F(PoseTextureTests, BuildPoseImage)
+{
+    MeshPtr mesh = MeshManager::getSingleton().createManual("PoseTexture", RGN_DEFAULT);
+    mesh->sharedVertexData = new VertexData();
+    mesh->sharedVertexData->vertexCount = 3;
+    mesh->sharedVertexData->vertexDeclaration->addElement(0, 0, VertexElementType::FLOAT3, VertexElementSemantic::NORMAL);
+    HardwareVertexBufferSharedPtr normals = HardwareBufferManager::getSingleton().createVertexBuffer(
+        3 * sizeof(float), 3, HardwareBuffer::STATIC_WRITE_ONLY, true);
+    const float up[] = {0, 1, 0, 0, 1, 0, 0, 1, 0};
+    normals->writeData(0, sizeof(up), up);
+    mesh->sharedVertexData->vertexBufferBinding->setBinding(0, normals);
+
+    SubMesh* sub = mesh->createSubMesh();
+    sub->useSharedVertices = false;
+    sub->vertexData = std::make_unique<VertexData>();
+    sub->vertexData->vertexCount = 2;
+
+    mesh->createPose(0, "moved")->addVertex(2, Vector3{1, 2, 3});
+    mesh->createPose(1, "other")->addVertex(0, Vector3{5, 5, 5});
+    mesh->createPose(0, "turned")->addVertex(1, Vector3{0, 0, 1}, Vector3{1, 0, 0});
+
+    Image image;
+    mesh->buildPoseImage(0, image);
+    EXPECT_EQ(image.getFormat(), PixelFormat::FLOAT32_RGBA);
+    EXPECT_EQ(image.getWidth(), 3u);
+    // the rows of both poses of the shared geometry, then their normals
+    ASSERT_EQ(image.getHeight(), 4u);
+    auto texel = [&image](uint32 x, uint32 y)
+    {
+        const float* rgba = image.getData<float>(x, y);
+        return Vector3{rgba[0], rgba[1], rgba[2]};
+    };
+    EXPECT_EQ(texel(2, 0), Vector3(1, 2, 3));
+    EXPECT_EQ(texel(0, 0), Vector3::ZERO);
+    EXPECT_EQ(texel(1, 1), Vector3(0, 0, 1));
+    EXPECT_EQ(texel(1, 3), Vector3(1, -1, 0));
+    EXPECT_EQ(texel(2, 3), Vector3::ZERO);
+
+    mesh->buildPoseImage(1, image);
+    EXPECT_EQ(image.getWidth(), 2u);
+    ASSERT_EQ(image.getHeight(), 1u);
+    EXPECT_EQ(texel(0, 0), Vector3(5, 5, 5));
+}
@@ -96,6 +96,21 @@ TEST_F(EdgeBuilderTests,SingleIndexBufSingleVertexBuf)
     // 6 edges
     EXPECT_TRUE(eg.edges.size() == 6);
 
+    // face normals match the scalar computation
+    const Vector3 positions[] = {{0, 0, 0}, {50, 0, 0}, {0, 100, 0}, {0, 0, -50}};
+    ASSERT_EQ(edgeData->triangleFaceNormals.size(), 4u);
+    for (size_t i = 0; i < edgeData->triangles.size(); ++i)
+    {
+        const auto& t = edgeData->triangles[i];
+        Vector4 expected = Math::calculateFaceNormalWithoutNormalize(
+            positions[t.vertIndex[0]], positions[t.vertIndex[1]], positions[t.vertIndex[2]]);
+        const Vector4& n = edgeData->triangleFaceNormals[i];
+        EXPECT_FLOAT_EQ(n.x, expected.x);
+        EXPECT_FLOAT_EQ(n.y, expected.y);
+        EXPECT_FLOAT_EQ(n.z, expected.z);
+        EXPECT_FLOAT_EQ(n.w, expected.w);
+    }
+
     delete edgeData;
 }
 //--------------------------------------------------------------------------
@@ -28,6 +28,7 @@ THE SOFTWARE.
 module;
 
 #include <gtest/gtest.h>
+#include <cstring>
 
 module Ogre.Tests;
 
@@ -36,6 +37,7 @@ import :Core.FileSystemArchive;
 import Ogre.Core;
 
 import <algorithm>;
+import <filesystem>;
 import <format>;
 import <map>;
 import <string>;
@@ -303,6 +305,58 @@ TEST_F(FileSystemArchiveTests,ReadInterleave)
     EXPECT_TRUE(stream2->eof());
 }
 //--------------------------------------------------------------------------
+TEST_F(FileSystemArchiveTests,MemoryMappedRead)
+{
+    size_t threshold = FileSystemArchiveFactory::getMemoryMapThreshold();
+    FileSystemArchiveFactory::setMemoryMapThreshold(0);
+
+    DataStreamPtr stream = mArch->open("rootfile.txt");
+    FileSystemArchiveFactory::setMemoryMapThreshold(threshold);
+
+    auto mapped = dynamic_cast<MemoryMappedDataStream*>(stream.get());
+    ASSERT_TRUE(mapped);
+    EXPECT_EQ((size_t)mFileSizeRoot1, stream->size());
+    EXPECT_EQ(0, memcmp("this is line 1 in file 1", mapped->getPtr(), 24));
+    EXPECT_EQ(String("this is line 1 in file 1"), stream->getLine());
+    EXPECT_EQ(String("this is line 2 in file 1"), stream->getLine());
+
+    // writes never reach the file
+    EXPECT_EQ(0u, stream->write("x", 1));
+    stream->close();
+    EXPECT_EQ(String("this is line 1 in file 1"), mArch->open("rootfile.txt")->getLine());
+}
+//--------------------------------------------------------------------------
+TEST_F(FileSystemArchiveTests,AsyncFileRead)
+{
+    // a small depth, so some reads have to wait for a slot
+    AsyncFileReader reader(2);
+    int file = reader.openFile(mTestPath + "/rootfile.txt");
+    ASSERT_GE(file, 0);
+
+    std::vector<char> lines(4 * 24);
+    for (int i = 0; i < 4; ++i)
+        reader.read(file, i * 25, &lines[i * 24], 24, i);
+    char past[8];
+    reader.read(file, 1000, past, sizeof(past), 4);
+
+    std::vector<AsyncFileReader::Completion> completions;
+    while (reader.getNumOutstanding())
+        reader.poll(completions, true);
+    reader.closeFile(file);
+
+    ASSERT_EQ(completions.size(), 5u);
+    std::ranges::sort(completions, {}, &AsyncFileReader::Completion::userData);
+    for (int i = 0; i < 4; ++i)
+    {
+        EXPECT_EQ(completions[i].bytesRead, 24u);
+        EXPECT_EQ(completions[i].error, 0);
+        EXPECT_EQ(std::string(&lines[i * 24], 24), std::format("this is line {} in file 1", i + 1));
+    }
+    // reading past the end is not an error
+    EXPECT_EQ(completions[4].bytesRead, 0u);
+    EXPECT_EQ(completions[4].error, 0);
+}
+//--------------------------------------------------------------------------
 TEST_F(FileSystemArchiveTests,CreateAndRemoveFile)
 {
     EXPECT_TRUE(!mArch->isReadOnly());
@@ -321,3 +375,47 @@ TEST_F(FileSystemArchiveTests,CreateAndRemoveFile)
     EXPECT_TRUE(!mArch->exists(fileName));
 }
 //--------------------------------------------------------------------------
+TEST_F(FileSystemArchiveTests,BundleRoundTrip)
+{
+    BundleWriter writer;
+    writer.setAlignment(4096);
+    writer.addArchive(mArch);
+    writer.addFile("compressed.txt", mArch->open("rootfile.txt"), true);
+    writer.declareResource("file.material", "Material");
+
+    std::filesystem::path bundlePath = std::filesystem::temp_directory_path() / "OgreArchiveTest.bundle";
+    writer.write(bundlePath.string());
+
+    BundleArchiveFactory factory;
+    Archive* bundle = factory.createInstance(bundlePath.string(), true);
+    bundle->load();
+
+    auto sorted = [](StringVectorPtr vec) { std::ranges::sort(*vec); return *vec; };
+    StringVector expected = sorted(mArch->list(true));
+    expected.emplace_back("compressed.txt");
+    std::ranges::sort(expected);
+    EXPECT_EQ(expected, sorted(bundle->list(true)));
+    EXPECT_EQ(sorted(mArch->list(false)).size() + 1, bundle->list(false)->size());
+    EXPECT_EQ(sorted(mArch->list(true, true)), sorted(bundle->list(true, true)));
+    EXPECT_EQ((size_t)4, bundle->find("*.material")->size());
+    EXPECT_TRUE(bundle->exists("level1/materials/scripts/file.material"));
+    EXPECT_FALSE(bundle->exists("file.material"));
+
+    DataStreamPtr stored = bundle->open("rootfile.txt");
+    EXPECT_EQ((size_t)mFileSizeRoot1, stored->size());
+    EXPECT_EQ(String("this is line 1 in file 1"), stored->getLine());
+
+    DataStreamPtr compressed = bundle->open("compressed.txt");
+    EXPECT_EQ(stored->size(), compressed->size());
+    EXPECT_EQ(String("this is line 1 in file 1"), compressed->getLine());
+    EXPECT_EQ(String("this is line 2 in file 1"), compressed->getLine());
+    EXPECT_THROW((void)bundle->open("missing.txt"), FileNotFoundException);
+
+    ArchiveResourceDeclarationList declarations = bundle->getResourceDeclarations();
+    ASSERT_EQ((size_t)1, declarations.size());
+    EXPECT_EQ(String("file.material"), declarations[0].name);
+    EXPECT_EQ(String("Material"), declarations[0].resourceType);
+
+    factory.destroyInstance(bundle);
+    std::filesystem::remove(bundlePath);
+}
@@ -28,6 +28,7 @@ THE SOFTWARE.
 module;
 
 #include <gtest/gtest.h>
+#include <cstdio>
 #include <cstring>
 
 module Ogre.Tests;
@@ -38,11 +39,25 @@ import Ogre.Components.Bites;
 import Ogre.Core;
 import Ogre.PlugIns.STBICodec;
 
+import <algorithm>;
+import <array>;
+import <atomic>;
+import <chrono>;
+import <cmath>;
+import <filesystem>;
+import <format>;
+import <fstream>;
+import <initializer_list>;
+import <iterator>;
 import <list>;
 import <map>;
 import <memory>;
 import <random>;
+import <set>;
+import <sstream>;
+import <stdexcept>;
 import <string>;
+import <thread>;
 import <utility>;
 import <vector>;
 
@@ -62,6 +77,174 @@ TEST_F(CameraTests,customProjectionMatrix)
 
     EXPECT_EQ(extents, cam.getFrustumExtents());
 }
+TEST_F(CameraTests,batchedVisibility)
+{
+    Camera cam("", nullptr);
+    cam.setNearClipDistance(1);
+    cam.setFarClipDistance(500);
+
+    minstd_rand rng;
+    std::vector<AxisAlignedBox> boxes{AxisAlignedBox{}, AxisAlignedBox{AxisAlignedBox::Extent::Infinite}};
+    while (boxes.size() < AxisAlignedBoxBatch::CAPACITY - 1)
+    {
+        // in front of the camera, partly beyond the far plane
+        Vector3 centre{Real(rng() % 600) - 300, Real(rng() % 600) - 300, -Real(rng() % 1000)};
+        Vector3 halfSize = Vector3::UNIT_SCALE * Real(rng() % 50 + 1);
+        boxes.push_back(AxisAlignedBox{AxisAlignedBox::Extent::Finite, centre - halfSize, centre + halfSize});
+    }
+
+    AxisAlignedBoxBatch batch;
+    for (const auto& box : boxes)
+        batch.push_back(box);
+    uint8 visible[AxisAlignedBoxBatch::CAPACITY];
+
+    // with and without far plane
+    for (Real farDist : {Real(500), Real(0)})
+    {
+        cam.setFarClipDistance(farDist);
+        cam.isVisible(batch, visible);
+
+        int numVisible = 0;
+        for (size_t i = 0; i < boxes.size(); ++i)
+        {
+            EXPECT_EQ(bool(visible[i]), cam.isVisible(boxes[i])) << i;
+            numVisible += visible[i];
+        }
+        EXPECT_GT(numVisible, 1);
+        EXPECT_LT(numVisible, int(boxes.size()));
+    }
+}
+TEST(SceneManager,occlusionCullingWithoutCapability)
+{
+    Root root("");
+    SceneManager* sm = root.createSceneManager();
+    Camera* cam = sm->createCamera("Camera");
+    SceneNode* node = sm->getRootSceneNode()->createChildSceneNode();
+
+    sm->setOcclusionCulling(true);
+    ASSERT_TRUE(sm->getOcclusionCulling());
+
+    // without a render system supporting queries everything stays visible
+    OcclusionCulling* occlusion = sm->_getOcclusionCulling();
+    occlusion->_beginFrame(cam, sm);
+    AxisAlignedBox box{AxisAlignedBox::Extent::Finite, Vector3{-1, -1, -10}, Vector3{1, 1, -8}};
+    EXPECT_TRUE(occlusion->_isVisible(node, box));
+    EXPECT_EQ(occlusion->getStats().nodesTested, 0u);
+    occlusion->_endFrame(sm);
+
+    sm->destroySceneNode(node);
+    sm->destroyCamera(cam);
+    sm->setOcclusionCulling(false);
+    EXPECT_FALSE(sm->getOcclusionCulling());
+}
+TEST(SceneManager,occlusionCullingWithCapability)
+{
+    RecordingRenderSystem rs;
+    rs.getMutableCapabilities()->setCapability(Capabilities::HWOCCLUSION);
+    DefaultHardwareBufferManager hbm;
+    Root root("");
+    SceneManager* sm = root.createSceneManager();
+    sm->_setDestinationRenderSystem(&rs);
+    Camera* cam = sm->createCamera("Camera");
+    cam->setNearClipDistance(1);
+    SceneNode* front = sm->getRootSceneNode()->createChildSceneNode();
+    SceneNode* back = sm->getRootSceneNode()->createChildSceneNode();
+    AxisAlignedBox frontBox{AxisAlignedBox::Extent::Finite, Vector3{-1, -1, -10}, Vector3{1, 1, -8}};
+    AxisAlignedBox backBox{AxisAlignedBox::Extent::Finite, Vector3{-1, -1, -30}, Vector3{1, 1, -28}};
+
+    sm->setOcclusionCulling(true);
+    OcclusionCulling* occlusion = sm->_getOcclusionCulling();
+    occlusion->setVisiblePersistence(4);
+    auto frame = [&](bool frontVisible, bool backVisible)
+    {
+        occlusion->_beginFrame(cam, sm);
+        EXPECT_EQ(occlusion->_isVisible(front, frontBox), frontVisible);
+        EXPECT_EQ(occlusion->_isVisible(back, backBox), backVisible);
+        occlusion->_endFrame(sm);
+        root._fireFrameRenderingQueued();
+        return occlusion->getStats();
+    };
+
+    // everything is visible and tested at first
+    OcclusionCulling::Stats stats = frame(true, true);
+    EXPECT_EQ(stats.nodesTested, 2u);
+    EXPECT_EQ(stats.queriesIssued, 2u);
+    ASSERT_EQ(rs.occlusionQueries.size(), 2u);
+    RecordingOcclusionQuery* frontQuery = rs.occlusionQueries[0];
+    RecordingOcclusionQuery* backQuery = rs.occlusionQueries[1];
+    frontQuery->samples = 100;
+
+    // the results of the last frame are used, only the occluded node is tested again
+    stats = frame(true, false);
+    EXPECT_EQ(stats.nodesOccluded, 1u);
+    EXPECT_EQ(stats.queriesIssued, 1u);
+    EXPECT_EQ(frontQuery->queriesIssued, 1u);
+    EXPECT_EQ(backQuery->queriesIssued, 2u);
+
+    // without waiting for the result
+    backQuery->outstanding = true;
+    backQuery->samples = 50;
+    stats = frame(true, false);
+    EXPECT_EQ(stats.queriesPending, 1u);
+    EXPECT_EQ(stats.queriesIssued, 0u);
+
+    backQuery->outstanding = false;
+    stats = frame(true, true);
+    EXPECT_EQ(stats.nodesOccluded, 0u);
+    EXPECT_EQ(rs.occlusionQueries.size(), 2u);
+
+    // visible nodes are tested again after a while, with solid boxes even for a wireframe camera
+    cam->setPolygonMode(PolygonMode::WIREFRAME);
+    rs.polygonMode = PolygonMode::POINTS;
+    size_t issued = 0;
+    for (int i = 0; i < 4; ++i)
+        issued += frame(true, true).queriesIssued;
+    EXPECT_GE(issued, 2u);
+    EXPECT_EQ(rs.polygonMode, PolygonMode::SOLID);
+}
+TEST_F(CameraTests,softwareOcclusionCulling)
+{
+    SceneManager* sm = mRoot->createSceneManager();
+    Camera* cam = sm->createCamera("Camera");
+    cam->setNearClipDistance(1);
+    SceneNode* camNode = sm->getRootSceneNode()->createChildSceneNode(Vector3{0, 0, 500});
+    camNode->attachObject(cam);
+
+    // a sphere in front of the camera
+    Entity* wall = sm->createEntity("sphere.mesh");
+    SceneNode* wallNode = sm->getRootSceneNode()->createChildSceneNode();
+    wallNode->attachObject(wall);
+    SceneNode* node = sm->getRootSceneNode()->createChildSceneNode();
+    sm->_updateSceneGraph(cam);
+
+    SoftwareOcclusionCulling occlusion;
+    occlusion.addOccluder(wall);
+    sm->addVisibilityStage(&occlusion);
+    occlusion._beginFrame(cam, sm);
+    EXPECT_EQ(occlusion.getStats().occludersRasterized, 1u);
+    EXPECT_GT(occlusion.getStats().trianglesRasterized, 0u);
+
+    auto boxAt = [](const Vector3& centre)
+    {
+        Vector3 halfSize = Vector3::UNIT_SCALE * 10;
+        return AxisAlignedBox{AxisAlignedBox::Extent::Finite, centre - halfSize, centre + halfSize};
+    };
+    EXPECT_FALSE(occlusion._isVisible(node, boxAt(Vector3{0, 0, -300})));
+    EXPECT_TRUE(occlusion._isVisible(node, boxAt(Vector3{0, 0, 300})));
+    EXPECT_TRUE(occlusion._isVisible(node, boxAt(Vector3{350, 0, -300})));
+    // around the camera
+    EXPECT_TRUE(occlusion._isVisible(node, boxAt(Vector3{0, 0, 500})));
+    // the occluder does not hide itself
+    EXPECT_TRUE(occlusion._isVisible(wallNode, wallNode->_getWorldAABB()));
+    occlusion._endFrame(sm);
+
+    EXPECT_EQ(occlusion.getStats().nodesTested, 5u);
+    EXPECT_EQ(occlusion.getStats().nodesCulled, 1u);
+    EXPECT_TRUE(occlusion._isVisible(node, boxAt(Vector3{0, 0, -300})));
+
+    sm->removeVisibilityStage(&occlusion);
+    EXPECT_TRUE(sm->getVisibilityStages().empty());
+}
 TEST(Root,shutdown)
 {
     Root root("");
@@ -78,6 +261,249 @@ TEST(SceneManager,removeAndDestroyAllChildren)
     sm->getRootSceneNode()->createChildSceneNode();
     sm->getRootSceneNode()->removeAndDestroyAllChildren();
 }
+TEST(SceneManager, NamedObjectLookups)
+{
+    Root root("");
+    SceneManager* sm = root.createSceneManager();
+    for (int i = 0; i < 1000; ++i)
+    {
+        std::string name = "Object" + std::to_string(i);
+        sm->createLight(name);
+        sm->createCamera(name);
+        sm->createSceneNode(name);
+    }
+    EXPECT_EQ(sm->getMovableObjects("Light").size(), 1000u);
+    EXPECT_EQ(sm->getCameras().size(), 1000u);
+    EXPECT_EQ(sm->getLight("Object500")->getName(), "Object500");
+    EXPECT_EQ(sm->getCamera("Object999")->getName(), "Object999");
+    EXPECT_EQ(sm->getSceneNode("Object0")->getName(), "Object0");
+
+    sm->destroyLight("Object500");
+    sm->destroySceneNode("Object0");
+    EXPECT_FALSE(sm->hasLight("Object500"));
+    EXPECT_FALSE(sm->hasSceneNode("Object0"));
+    EXPECT_TRUE(sm->hasLight("Object501"));
+
+    sm->destroyAllCameras();
+    EXPECT_TRUE(sm->getCameras().empty());
+}
+TEST(TaskScheduler, parallelFor)
+{
+    TaskScheduler scheduler{3};
+
+    std::vector<std::atomic<int>> visits(10000);
+    scheduler.parallelFor(visits.size(), [&](size_t i) { ++visits[i]; }, 16);
+    EXPECT_TRUE(std::ranges::all_of(visits, [](const auto& v) { return v == 1; }));
+
+    EXPECT_THROW(scheduler.parallelFor(100, [](size_t i) { if (i == 42) throw std::runtime_error("42"); }),
+                 std::runtime_error);
+}
+TEST(TaskScheduler, TaskGraph)
+{
+    TaskScheduler scheduler{3};
+
+    // a diamond: b and c wait for a, d waits for both
+    std::atomic<int> step{0};
+    int a = -1, b = -1, c = -1, d = -1;
+    TaskGraph graph;
+    auto ta = graph.addTask([&]() { a = step++; });
+    auto tb = graph.addTask([&]() { b = step++; });
+    auto tc = graph.addTask([&]() { c = step++; });
+    auto td = graph.addTask([&]() { d = step++; });
+    graph.addDependency(tb, ta);
+    graph.addDependency(tc, ta);
+    graph.addDependency(td, tb);
+    graph.addDependency(td, tc);
+
+    scheduler.run(graph);
+    EXPECT_EQ(a, 0);
+    EXPECT_GT(b, a);
+    EXPECT_GT(c, a);
+    EXPECT_EQ(d, 3);
+
+    // graphs can be run again
+    scheduler.run(graph);
+    EXPECT_EQ(d, 7);
+
+    graph.addDependency(ta, td);
+    EXPECT_THROW(scheduler.run(graph), InvalidParametersException);
+}
+static void createRandomHierarchy(SceneNode* parent, int depth, minstd_rand& rng)
+{
+    for (int i = 0; i < 4; ++i)
+    {
+        SceneNode* node = parent->createChildSceneNode(Vector3{Real(rng() % 100), Real(rng() % 100), Real(rng() % 100)});
+        node->yaw(Degree{Real(rng() % 360)});
+        node->setScale(Vector3::UNIT_SCALE * Real(1 + rng() % 3));
+        if (depth > 0)
+            createRandomHierarchy(node, depth - 1, rng);
+    }
+}
+TEST(SceneManager, parallelSceneGraphUpdate)
+{
+    Root root("");
+    root.getWorkQueue()->startup();
+
+    SceneManager* serial = root.createSceneManager();
+    SceneManager* parallel = root.createSceneManager();
+    parallel->setParallelSceneGraphUpdate(true);
+
+    minstd_rand rng1, rng2;
+    createRandomHierarchy(serial->getRootSceneNode(), 4, rng1);
+    createRandomHierarchy(parallel->getRootSceneNode(), 4, rng2);
+
+    // objects on every third node, so the world bounds differ from those of the children
+    auto attachObjects = [](SceneManager* sm)
+    {
+        std::vector<Node*> nodes{sm->getRootSceneNode()};
+        for (size_t i = 0; !nodes.empty(); ++i)
+        {
+            auto node = static_cast<SceneNode*>(nodes.back());
+            nodes.pop_back();
+            if (i % 3 == 0)
+            {
+                ManualObject* obj = sm->createManualObject();
+                obj->setBoundingBox({AxisAlignedBox::Extent::Finite, Vector3{-Real(i % 7), -1, -2}, Vector3{1, Real(i % 5), 2}});
+                node->attachObject(obj);
+            }
+            nodes.insert(nodes.end(), node->getChildren().begin(), node->getChildren().end());
+        }
+    };
+    attachObjects(serial);
+    attachObjects(parallel);
+
+    serial->_updateSceneGraph(nullptr);
+    parallel->_updateSceneGraph(nullptr);
+
+    EXPECT_EQ(serial->getSceneGraphUpdateStats().nodesUpdated, parallel->getSceneGraphUpdateStats().nodesUpdated);
+    EXPECT_GT(parallel->getSceneGraphUpdateStats().subtreesDispatched, 0u);
+
+    std::vector<Node*> serialNodes{serial->getRootSceneNode()}, parallelNodes{parallel->getRootSceneNode()};
+    while (!serialNodes.empty())
+    {
+        Node* a = serialNodes.back();
+        Node* b = parallelNodes.back();
+        serialNodes.pop_back();
+        parallelNodes.pop_back();
+        ASSERT_EQ(a->_getFullTransform(), b->_getFullTransform());
+        ASSERT_EQ(static_cast<SceneNode*>(a)->_getWorldAABB(), static_cast<SceneNode*>(b)->_getWorldAABB());
+        ASSERT_EQ(a->getChildren().size(), b->getChildren().size());
+        serialNodes.insert(serialNodes.end(), a->getChildren().begin(), a->getChildren().end());
+        parallelNodes.insert(parallelNodes.end(), b->getChildren().begin(), b->getChildren().end());
+    }
+}
+TEST(SceneManager, packedTransformUpdate)
+{
+    Root root("");
+
+    SceneManager* reference = root.createSceneManager();
+    SceneManager* packed = root.createSceneManager();
+    packed->setPackedTransformUpdate(true);
+
+    minstd_rand rng1, rng2;
+    createRandomHierarchy(reference->getRootSceneNode(), 4, rng1);
+    createRandomHierarchy(packed->getRootSceneNode(), 4, rng2);
+
+    auto compare = [&]()
+    {
+        std::vector<Node*> referenceNodes{reference->getRootSceneNode()}, packedNodes{packed->getRootSceneNode()};
+        while (!referenceNodes.empty())
+        {
+            Node* a = referenceNodes.back();
+            Node* b = packedNodes.back();
+            referenceNodes.pop_back();
+            packedNodes.pop_back();
+            // allow for differently contracted floating point operations
+            Real tolerance = std::max(Real(1), a->_getDerivedPosition().length()) * 1e-5f;
+            ASSERT_TRUE(a->_getDerivedPosition().positionEquals(b->_getDerivedPosition(), tolerance));
+            ASSERT_TRUE(a->_getDerivedOrientation().orientationEquals(b->_getDerivedOrientation(), 1e-5f));
+            ASSERT_TRUE(a->_getDerivedScale().positionEquals(b->_getDerivedScale(), 1e-5f));
+            ASSERT_EQ(a->getChildren().size(), b->getChildren().size());
+            referenceNodes.insert(referenceNodes.end(), a->getChildren().begin(), a->getChildren().end());
+            packedNodes.insert(packedNodes.end(), b->getChildren().begin(), b->getChildren().end());
+        }
+    };
+
+    reference->_updateSceneGraph(nullptr);
+    packed->_updateSceneGraph(nullptr);
+    compare();
+
+    // move one node and reparent another, forcing a rebuild of the packed layout
+    for (auto mgr : {reference, packed})
+    {
+        Node* first = mgr->getRootSceneNode()->getChildren().front();
+        first->translate(Vector3{1, 2, 3});
+        Node* moved = first->getChildren().back();
+        first->removeChild(moved);
+        mgr->getRootSceneNode()->getChildren().back()->addChild(moved);
+        mgr->_updateSceneGraph(nullptr);
+    }
+    compare();
+}
+TEST(SceneManager, staticBranchesSkipped)
+{
+    Root root("");
+    SceneManager* sm = root.createSceneManager();
+
+    minstd_rand rng;
+    createRandomHierarchy(sm->getRootSceneNode(), 4, rng);
+    sm->_updateSceneGraph(nullptr);
+    EXPECT_GT(sm->getSceneGraphUpdateStats().nodesVisited, 0u);
+
+    // nothing moved, nothing visited
+    root._fireFrameRenderingQueued();
+    sm->_updateSceneGraph(nullptr);
+    EXPECT_EQ(sm->getSceneGraphUpdateStats().nodesVisited, 0u);
+    EXPECT_EQ(sm->getSceneGraphUpdateStats().nodesUpdated, 0u);
+
+    // moving a leaf only visits its ancestors
+    Node* node = sm->getRootSceneNode();
+    size_t depth = 0;
+    while (!node->getChildren().empty())
+    {
+        node = node->getChildren().back();
+        ++depth;
+    }
+    node->translate(Vector3::UNIT_X);
+
+    root._fireFrameRenderingQueued();
+    sm->_updateSceneGraph(nullptr);
+    EXPECT_EQ(sm->getSceneGraphUpdateStats().nodesVisited, depth + 1);
+    EXPECT_EQ(sm->getSceneGraphUpdateStats().nodesUpdated, 1u);
+}
+struct CountingSimulation : public FrameSimulation
+{
+    int steps{0};
+    int applied{-1};
+    std::thread::id simulationThread;
+
+    void simulate(const FrameEvent& evt) override
+    {
+        simulationThread = std::this_thread::get_id();
+        ++steps;
+    }
+    void apply() override { applied = steps; }
+};
+TEST(Root, FrameSimulationIsPipelined)
+{
+    Root root("");
+    CountingSimulation simulation;
+    root.setFrameSimulation(&simulation);
+
+    // the first frame has nothing to apply yet
+    ASSERT_TRUE(root._fireFrameStarted());
+    EXPECT_EQ(simulation.applied, -1);
+
+    // the next frame shows the step simulated during the previous one
+    ASSERT_TRUE(root._fireFrameStarted());
+    EXPECT_EQ(simulation.applied, 1);
+    EXPECT_NE(simulation.simulationThread, std::this_thread::get_id());
+
+    // the pending step completes, but is not applied
+    root.setFrameSimulation(nullptr);
+    EXPECT_EQ(simulation.steps, 2);
+    EXPECT_EQ(simulation.applied, 1);
+}
 static void createRandomEntityClones(Entity* ent, size_t cloneCount, const Vector3& min,
 
                                      const Vector3& max, SceneManager* mgr)
@@ -103,11 +529,66 @@ static void createRandomEntityClones(Entity* ent, size_t cloneCount, const Vecto
     }
 }
 
+namespace {
+    /// Collects the renderables visited in a render queue, in order and per pass group
+    struct QueueCollector : public QueuedRenderableVisitor
+    {
+        std::vector<Renderable*> renderables;
+        std::vector<std::pair<const Pass*, std::vector<Renderable*>>> groups;
+        void visit(RenderablePass* rp) override { renderables.push_back(rp->renderable); }
+        void visit(const Pass* p, RenderableList& rs) override
+        {
+            renderables.insert(renderables.end(), rs.begin(), rs.end());
+            groups.emplace_back(p, rs);
+        }
+    };
+
+    /// A render target drawing nothing, for the viewports the scene manager needs
+    struct NullTarget : public RenderTarget
+    {
+        NullTarget() { mWidth = mHeight = 256; }
+        void copyContentsToMemory(const Box& src, const PixelBox& dst, FrameBuffer buffer) override
+        {
+            (void)src; (void)dst; (void)buffer;
+        }
+        [[nodiscard]] auto requiresTextureFlipping() const -> bool override { return false; }
+    };
+}
+
 struct SceneQueryTest : public RootWithoutRenderSystemFixture {
     SceneManager* mSceneMgr;
     Camera* mCamera;
     SceneNode* mCameraNode;
 
+    /// The solids in the render queue by pass groups, sorted for cam first if sort is set
+    auto collectQueued(const Camera* cam, bool sort = false) -> QueueCollector
+    {
+        QueueCollector collector;
+        for (const auto& group : mSceneMgr->getRenderQueue()->_getQueueGroups())
+        {
+            if (!group)
+                continue;
+            for (const auto& [priority, priorityGroup] : group->getPriorityGroups())
+            {
+                if (sort)
+                    priorityGroup->sort(cam);
+                priorityGroup->getSolidsBasic().acceptVisitor(
+                    &collector, QueuedRenderableCollection::OrganisationMode::PASS_GROUP);
+            }
+        }
+        return collector;
+    }
+
+    /// Queues what cam sees into an empty render queue, see collectQueued
+    auto findVisible(Camera* cam, VisibleObjectsBoundsInfo* bounds = nullptr, bool sort = false) -> QueueCollector
+    {
+        mSceneMgr->getRenderQueue()->clear();
+        if (bounds)
+            bounds->reset();
+        mSceneMgr->_findVisibleObjects(cam, bounds, false);
+        return collectQueued(cam, sort);
+    }
+
     void SetUp() override {
         RootWithoutRenderSystemFixture::SetUp();
 
@@ -156,6 +637,38 @@ TEST_F(SceneQueryTest,Intersection)
     }
     // printf("\n");
 }
+TEST_F(SceneQueryTest, IntersectionAfterMove)
+{
+    auto intersectionQuery = mSceneMgr->createIntersectionQuery();
+    intersectionQuery->setQueryTypeMask(QueryTypeMask::ENTITY);
+    intersectionQuery->execute();
+
+    // shuffle the balls, so the order kept from the first execution is stale
+    std::minstd_rand rng;
+    for (auto node : mSceneMgr->getRootSceneNode()->getChildren())
+    {
+        if (node != mCameraNode)
+            node->setPosition(Real(rng() % 2000) - 1000, Real(rng() % 2000) - 1000, Real(rng() % 2000) - 1000);
+    }
+    mSceneMgr->_updateSceneGraph(mCamera);
+
+    std::vector<std::pair<MovableObject*, MovableObject*>> expected;
+    const auto& entities = mSceneMgr->getMovableObjects(EntityFactory::FACTORY_TYPE_NAME);
+    for (auto a = entities.begin(); a != entities.end(); ++a)
+    {
+        for (auto b = std::next(a); b != entities.end(); ++b)
+        {
+            if (a->second->getWorldBoundingBox().intersects(b->second->getWorldBoundingBox()))
+                expected.emplace_back(a->second, b->second);
+        }
+    }
+
+    IntersectionSceneQueryResult& results = intersectionQuery->execute();
+    EXPECT_GT(expected.size(), 51u);
+    EXPECT_EQ(std::vector<std::pair<MovableObject*, MovableObject*>>(results.movables2movables.begin(),
+                                                                      results.movables2movables.end()),
+              expected);
+}
 TEST_F(SceneQueryTest, Ray) {
     auto rayQuery = mSceneMgr->createRayQuery(mCamera->getCameraToViewportRay(0.5, 0.5));
     rayQuery->setSortByDistance(true, 2);
@@ -165,126 +678,1407 @@ TEST_F(SceneQueryTest, Ray) {
     ASSERT_EQ("501", results[0].movable->getName());
     ASSERT_EQ("397", results[1].movable->getName());
 }
-TEST(MaterialSerializer, Basic)
+TEST_F(SceneQueryTest, PreciseMeshHits)
 {
-    Root root;
-    DefaultTextureManager texMgr;
-
-    String group = "General";
-
-    auto mat = std::make_shared<Material>(nullptr, "Material Name", 0, group);
-    auto pass = mat->createTechnique()->createPass();
-    auto tus = pass->createTextureUnitState();
-    tus->setContentType(TextureUnitState::ContentType::SHADOW);
-    tus->setName("Test TUS");
-    pass->setAmbient(ColourValue::Green);
+    Entity* sphere = mSceneMgr->getEntity("501");
+    Real halfSize = sphere->getBoundingBox().getHalfSize().x;
 
-    pass->createTextureUnitState("TextureName");
+    auto findSphere = [&](const RaySceneQueryResult& results) -> const RaySceneQueryResultEntry*
+    {
+        for (const auto& entry : results)
+        {
+            if (entry.movable == sphere)
+                return &entry;
+        }
+        return nullptr;
+    };
 
-    // export to string
-    MaterialSerializer ser;
-    ser.queueForExport(mat);
-    std::string str{ser.getQueuedAsString()};
+    // through a corner of the bounds, beside the sphere
+    Ray corner{Vector3{0.9f * halfSize, 0.9f * halfSize, 500}, Vector3::NEGATIVE_UNIT_Z};
+    auto rayQuery = mSceneMgr->createRayQuery(corner);
+    EXPECT_FALSE(rayQuery->getPreciseMeshHits());
+    EXPECT_TRUE(findSphere(rayQuery->execute()));
+
+    rayQuery->setPreciseMeshHits(true);
+    EXPECT_FALSE(findSphere(rayQuery->execute()));
+
+    // the pole of the sphere touches the bounds
+    rayQuery->setRay(Ray{Vector3{0, 0, 500}, Vector3::NEGATIVE_UNIT_Z});
+    const RaySceneQueryResultEntry* entry = findSphere(rayQuery->execute());
+    ASSERT_TRUE(entry);
+    EXPECT_NEAR(entry->distance, 500 - halfSize, 0.05f * halfSize);
+
+    const MeshTriangleBVH& bvh = sphere->getMesh()->getTriangleBVH();
+    EXPECT_GT(bvh.getTriangleCount(), MeshTriangleBVH::MAX_LEAF_TRIANGLES);
+    EXPECT_GT(bvh.getNodeCount(), 1u);
+    EXPECT_EQ(&bvh, &sphere->getMesh()->getTriangleBVH());
+}
+TEST_F(SceneQueryTest, ParallelFindVisibleObjects)
+{
+    mRoot->getWorkQueue()->startup();
 
-    // printf("%s\n", str.c_str());
+    VisibleObjectsBoundsInfo serialBounds, parallelBounds;
+    auto serial = findVisible(mCamera, &serialBounds).renderables;
+    mSceneMgr->setParallelFindVisibleObjects(true);
+    auto parallel = findVisible(mCamera, &parallelBounds).renderables;
 
-    // load again
-    DataStreamPtr stream = std::make_shared<MemoryDataStream>("memory.material", &str[0], str.size());
-    MaterialManager::getSingleton().parseScript(stream, group);
+    EXPECT_FALSE(serial.empty());
+    EXPECT_EQ(serial, parallel);
+    EXPECT_EQ(serialBounds.aabb, parallelBounds.aabb);
+    EXPECT_EQ(serialBounds.minDistance, parallelBounds.minDistance);
+    EXPECT_EQ(serialBounds.maxDistance, parallelBounds.maxDistance);
 
-    auto mat2 = MaterialManager::getSingleton().getByName("Material Name", group);
-    ASSERT_TRUE(mat2);
-    EXPECT_EQ(mat2->getTechniques().size(), mat->getTechniques().size());
-    EXPECT_EQ(mat2->getTechniques()[0]->getPasses()[0]->getAmbient(), ColourValue::Green);
-    EXPECT_EQ(mat2->getTechniques()[0]->getPasses()[0]->getTextureUnitState(0)->getName(),
-              "Test TUS");
-    EXPECT_EQ(mat2->getTechniques()[0]->getPasses()[0]->getTextureUnitState("Test TUS")->getContentType(),
-              TextureUnitState::ContentType::SHADOW);
-    EXPECT_EQ(mat2->getTechniques()[0]->getPasses()[0]->getTextureUnitState(1)->getTextureName(),
-              "TextureName");
+    // the staging queues don't keep anything between frames
+    EXPECT_EQ(findVisible(mCamera, &parallelBounds).renderables, parallel);
 }
-TEST(Image, FlipV)
+TEST_F(SceneQueryTest, CameraGroup)
 {
-    ResourceGroupManager mgr;
-    STBIImageCodec::startup();
-    ConfigFile cf;
-    cf.load(FileSystemLayer(/*OGRE_VERSION_NAME*/"Tsathoggua").getConfigFilePath("resources.cfg"));
-    auto testPath = cf.getSettings("Tests").begin()->second;
-
-    Image ref;
-    ref.load(Root::openFileStream(::std::format("{}/decal1vflip.png", testPath)), "png");
+    // the other eye
+    Camera* right = mSceneMgr->createCamera("Right");
+    SceneNode* rightNode = mCameraNode->createChildSceneNode(Vector3{50, 0, 0});
+    rightNode->attachObject(right);
+    mSceneMgr->_updateSceneGraph(mCamera);
+
+    auto left = findVisible(mCamera).renderables;
+    auto rightVisible = findVisible(right).renderables;
+
+    mSceneMgr->addCameraGroup({mCamera, right});
+    EXPECT_FALSE(left.empty());
+    EXPECT_EQ(findVisible(mCamera).renderables, left);
+    EXPECT_EQ(findVisible(right).renderables, rightVisible);
+
+    mSceneMgr->removeCameraGroup(right);
+    EXPECT_EQ(findVisible(right).renderables, rightVisible);
+}
+TEST_F(SceneQueryTest, RenderQueueStats)
+{
+    RenderQueue* queue = mSceneMgr->getRenderQueue();
+    auto findVisible = [&]()
+    {
+        queue->clear();
+        mSceneMgr->_findVisibleObjects(mCamera, nullptr, false);
+        return queue->getStats();
+    };
 
-    Image img;
-    img.load(Root::openFileStream(::std::format("{}/decal1.png", testPath)), "png");
-    img.flipAroundX();
+    size_t visibleNodes = 0, numChildren = mSceneMgr->getRootSceneNode()->numChildren();
+    for (auto node : mSceneMgr->getRootSceneNode()->getChildren())
+        visibleNodes += mCamera->isVisible(static_cast<SceneNode*>(node)->_getWorldAABB());
+
+    auto serial = findVisible();
+    ASSERT_GT(visibleNodes, 0u);
+    EXPECT_EQ(serial.nodesCulled, numChildren - visibleNodes);
+    EXPECT_GE(serial.objectsVisible, visibleNodes);
+    EXPECT_GE(serial.renderablesQueued, serial.objectsVisible - 1); // the camera queues nothing
+
+    // the staging queues add up to the same counts
+    mRoot->getWorkQueue()->startup();
+    mSceneMgr->setParallelFindVisibleObjects(true);
+    auto parallel = findVisible();
+    EXPECT_EQ(parallel.nodesCulled, serial.nodesCulled);
+    EXPECT_EQ(parallel.objectsVisible, serial.objectsVisible);
+    EXPECT_EQ(parallel.objectsRejected, serial.objectsRejected);
+    EXPECT_EQ(parallel.renderablesQueued, serial.renderablesQueued);
+
+    queue->clear();
+    EXPECT_EQ(queue->getStats().renderablesQueued, 0u);
+}
+TEST_F(SceneQueryTest, ReuseVisibleObjects)
+{
+    NullTarget target;
+    Viewport* vp = target.addViewport(mCamera);
 
-    // img.save(::std::format("{}/decal1vflip.png", testPath));
+    auto render = [&]()
+    {
+        VisibleObjectsBoundsInfo bounds;
+        mSceneMgr->getRenderQueue()->clear();
+        mSceneMgr->_queueVisibleObjects(mCamera, vp, &bounds);
+        return collectQueued(mCamera).renderables;
+    };
+    auto queued = [](const std::vector<Renderable*>& renderables, Entity* ent)
+    { return std::ranges::find(renderables, ent->getSubEntity(0)) != renderables.end(); };
 
-    STBIImageCodec::shutdown();
-    ASSERT_TRUE(!memcmp(img.getData(), ref.getData(), ref.getSize()));
+    Entity* hidden = mSceneMgr->getEntity("501");
+    Entity* destroyed = nullptr;
+    for (auto [name, mo] : mSceneMgr->getMovableObjects("Entity"))
+    {
+        if (mo != hidden && mCamera->isVisible(mo->getWorldBoundingBox(true)))
+            destroyed = static_cast<Entity*>(mo);
+    }
+    ASSERT_TRUE(destroyed);
+    Renderable* destroyedRenderable = destroyed->getSubEntity(0);
+
+    mSceneMgr->setReuseVisibleObjects(true);
+    auto first = render();
+    ASSERT_TRUE(queued(first, hidden));
+
+    // not culled again, so the change is not seen
+    hidden->setVisible(false);
+    EXPECT_EQ(render(), first);
+
+    // the kept queue must not outlive the objects in it
+    mSceneMgr->destroyEntity(destroyed);
+    auto culled = render();
+    EXPECT_EQ(std::ranges::find(culled, destroyedRenderable), culled.end());
+    EXPECT_FALSE(queued(culled, hidden));
+    EXPECT_EQ(render(), culled);
+
+    // a different view is culled again
+    hidden->setVisible(true);
+    mCameraNode->translate(Vector3{0, 0, 1});
+    mSceneMgr->_updateSceneGraph(mCamera);
+    EXPECT_TRUE(queued(render(), hidden));
 }
-TEST(Image, Resize)
+/// Prepares the queued renderables like rendering with setParallelRenderPreparation does
+struct PreparingSceneManager : public DefaultSceneManager
 {
-    ResourceGroupManager mgr;
-    STBIImageCodec::startup();
-    ConfigFile cf;
-    cf.load(FileSystemLayer(/*OGRE_VERSION_NAME*/"Tsathoggua").getConfigFilePath("resources.cfg"));
-    auto testPath = cf.getSettings("Tests").begin()->second;
+    using DefaultSceneManager::DefaultSceneManager;
 
-    Image ref;
-    ref.load(Root::openFileStream(::std::format("{}/decal1small.png", testPath)), "png");
+    /// The prepared world matrices of the collection, by renderable in visiting order
+    auto prepare(const QueuedRenderableCollection& objs, Camera* cam)
+        -> std::vector<std::pair<const Renderable*, std::vector<Affine3>>>
+    {
+        mAutoParamDataSource->setCurrentCamera(cam, mCameraRelativeRendering);
+        std::vector<std::pair<const Renderable*, std::vector<Affine3>>> prepared;
+        if (!prepareRenderables(objs, QueuedRenderableCollection::OrganisationMode::PASS_GROUP))
+            return prepared;
+
+        for (const auto& p : mPreparedRenderables)
+        {
+            auto first = mPreparedMatrices.begin() + p.firstMatrix;
+            prepared.emplace_back(p.renderable, std::vector<Affine3>{first, first + p.numMatrices});
+        }
+        return prepared;
+    }
 
-    Image img;
-    img.load(Root::openFileStream(::std::format("{}/decal1.png", testPath)), "png");
-    img.resize(128, 128);
+    /// The world matrices rendering gets without preparation
+    auto serialWorldMatrices(const Renderable* rend) -> std::vector<Affine3>
+    {
+        mAutoParamDataSource->setCurrentRenderable(rend);
+        const Affine3* matrices = mAutoParamDataSource->getWorldMatrixArray();
+        return {matrices, matrices + mAutoParamDataSource->getWorldMatrixCount()};
+    }
+};
+using RenderPreparationTests = RootWithoutRenderSystemFixture;
+TEST_F(RenderPreparationTests, ParallelMatchesSerial)
+{
+    PreparingSceneManager sceneMgr{"Preparing"};
+    Camera* cam = sceneMgr.createCamera("Camera");
+    SceneNode* camNode = sceneMgr.getRootSceneNode()->createChildSceneNode(Vector3{0, 0, 500});
+    camNode->attachObject(cam);
 
-    //img.save(::std::format("{}/decal1small.png", testPath));
+    // several entities share a node, and so its cached transform
+    minstd_rand rng;
+    std::uniform_real_distribution<float> dist{-100, 100};
+    for (int n = 0; n < 100; ++n)
+    {
+        SceneNode* node = sceneMgr.getRootSceneNode()->createChildSceneNode(Vector3{dist(rng), dist(rng), dist(rng)});
+        node->setOrientation(Quaternion::FromAngleAndAxis(Radian(dist(rng)), Vector3{1, 2, 3}.normalisedCopy()));
+        node->setScale(Vector3{Real(1 + n % 3), 1, 0.5f});
+        for (int e = 0; e < 3; ++e)
+            node->attachObject(sceneMgr.createEntity("sphere.mesh"));
+    }
+    sceneMgr._updateSceneGraph(cam);
 
-    STBIImageCodec::shutdown();
-    ASSERT_TRUE(!memcmp(img.getData(), ref.getData(), ref.getSize()));
+    for (bool cameraRelative : {false, true})
+    {
+        sceneMgr.setCameraRelativeRendering(cameraRelative);
+        sceneMgr.getRenderQueue()->clear();
+        sceneMgr._findVisibleObjects(cam, nullptr, false);
+
+        size_t numPrepared = 0;
+        for (const auto& group : sceneMgr.getRenderQueue()->_getQueueGroups())
+        {
+            if (!group)
+                continue;
+            for (const auto& [priority, priorityGroup] : group->getPriorityGroups())
+            {
+                const QueuedRenderableCollection& solids = priorityGroup->getSolidsBasic();
+                QueueCollector collector;
+                solids.acceptVisitor(&collector, QueuedRenderableCollection::OrganisationMode::PASS_GROUP);
+
+                auto prepared = sceneMgr.prepare(solids, cam);
+                ASSERT_EQ(prepared.size(), collector.renderables.size());
+                for (size_t i = 0; i < prepared.size(); ++i)
+                {
+                    // in the order they are rendered
+                    EXPECT_EQ(prepared[i].first, collector.renderables[i]);
+                    EXPECT_EQ(prepared[i].second, sceneMgr.serialWorldMatrices(collector.renderables[i]));
+                }
+                numPrepared += prepared.size();
+            }
+        }
+        EXPECT_EQ(numPrepared, 300u);
+    }
 }
-TEST(Image, Combine)
+/// Exposes the instanced run detection of setAutoInstancing, and what rendering a collection needs
+struct InstancingSceneManager : public DefaultSceneManager
 {
-    ResourceGroupManager mgr;
-    FileSystemArchiveFactory fs;
-    ArchiveManager amgr;
-    amgr.addArchiveFactory(&fs);
-    STBIImageCodec::startup();
-    ConfigFile cf;
-    cf.load(FileSystemLayer(/*OGRE_VERSION_NAME*/"Tsathoggua").getConfigFilePath("resources.cfg"));
-    mgr.addResourceLocation(::std::format("{}/../materials/textures", cf.getSettings("General").begin()->second), fs.getType());
-    mgr.initialiseAllResourceGroups();
+    using DefaultSceneManager::DefaultSceneManager;
+    using SceneManager::findInstanceRun;
+    using SceneManager::mCameraInProgress;
+    using SceneManager::mCurrentViewport;
+};
+/// A renderable drawing a given render operation
+struct OperationRenderable : public Renderable
+{
+    RenderOperation operation;
+    MaterialPtr material;
+    LightList lights;
+    Real depth{0};
+
+    [[nodiscard]] auto getMaterial() const noexcept -> const MaterialPtr& override { return material; }
+    void getRenderOperation(RenderOperation& op) override { op = operation; }
+    void getWorldTransforms(Matrix4* xform) const override { *xform = Matrix4::IDENTITY; }
+    auto getSquaredViewDepth(const Camera* cam) const -> Real override { (void)cam; return depth; }
+    [[nodiscard]] auto getLights() const noexcept -> const LightList& override { return lights; }
+};
+TEST_F(RenderPreparationTests, InstanceRuns)
+{
+    InstancingSceneManager sceneMgr{"Instancing"};
+    NullTarget target;
+    sceneMgr.mCurrentViewport = target.addViewport(sceneMgr.createCamera("Camera"));
+    auto mat = std::make_shared<Material>(nullptr, "Instanced", 0, RGN_DEFAULT);
+    Pass* pass = mat->createTechnique()->createPass();
+
+    VertexData shared, other;
+    std::array<OperationRenderable, 8> renderables;
+    for (size_t i = 0; i < renderables.size(); ++i)
+        renderables[i].operation.vertexData = i < 6 ? &shared : &other;
+    // a RenderOperation which cannot take the global instance buffer, in the middle and at the start of a run
+    renderables[3].operation.useGlobalInstancingVertexBufferIsAvailable = false;
+    renderables[4].operation.useGlobalInstancingVertexBufferIsAvailable = false;
+    renderables[7].operation.numberOfInstances = 2;
+
+    RenderableList rs;
+    for (auto& r : renderables)
+        rs.push_back(&r);
+
+    auto run = [&](size_t begin) { return sceneMgr.findInstanceRun(pass, rs, begin, false); };
+    EXPECT_EQ(run(0), 3u);
+    EXPECT_EQ(run(1), 2u);
+    EXPECT_EQ(run(3), 1u);
+    EXPECT_EQ(run(4), 1u);
+    // stops at other geometry, and at renderables instanced themselves
+    EXPECT_EQ(run(5), 1u);
+    EXPECT_EQ(run(6), 1u);
+    EXPECT_EQ(run(7), 1u);
+
+    renderables[6].operation.vertexData = &shared;
+    EXPECT_EQ(run(5), 2u);
+    renderables[4].operation.useGlobalInstancingVertexBufferIsAvailable = true;
+    EXPECT_EQ(run(4), 3u);
+}
+TEST_F(RenderPreparationTests, SortKeyGroupingSharedHash)
+{
+    RecordingRenderSystem rs;
+    InstancingSceneManager sceneMgr{"SortKeys"};
+    sceneMgr._setDestinationRenderSystem(&rs);
+    NullTarget target;
+    Camera* cam = sceneMgr.createCamera("Camera");
+    sceneMgr.mCurrentViewport = target.addViewport(cam);
+    sceneMgr.mCameraInProgress = cam;
+
+    // neither has textures, so both passes hash the same
+    std::array<MaterialPtr, 2> mats;
+    std::array<Pass*, 2> passes;
+    for (size_t i = 0; i < mats.size(); ++i)
+    {
+        mats[i] = std::make_shared<Material>(nullptr, std::format("SharedHash{}", i), 0, RGN_DEFAULT);
+        passes[i] = mats[i]->createTechnique()->createPass();
+    }
+    ASSERT_EQ(passes[0]->getHash(), passes[1]->getHash());
+
+    // the passes alternate with the depth
+    VertexData vertexData;
+    std::array<OperationRenderable, 8> renderables;
+    QueuedRenderableCollection collection;
+    collection.setSortKeyGrouping(true);
+    collection.addOrganisationMode(QueuedRenderableCollection::OrganisationMode::PASS_GROUP);
+    for (size_t i = 0; i < renderables.size(); ++i)
+    {
+        renderables[i].operation.vertexData = &vertexData;
+        renderables[i].operation.useIndexes = false;
+        renderables[i].depth = Real(10 * (i + 1));
+        collection.addRenderable(passes[i % 2], &renderables[i]);
+    }
+    collection.sort(cam);
 
-    auto testPath = cf.getSettings("Tests").begin()->second;
-    Image ref;
-    ref.load(Root::openFileStream(::std::format("{}/rockwall_flare.png", testPath)), "png");
+    sceneMgr.getQueuedRenderableVisitor()->renderObjects(
+        collection, QueuedRenderableCollection::OrganisationMode::PASS_GROUP, false, false);
+    EXPECT_EQ(sceneMgr.getPassStateStats().passesSet, 2u);
+}
+TEST_F(RenderPreparationTests, MultiDrawRuns)
+{
+    RecordingRenderSystem rs;
+    InstancingSceneManager sceneMgr{"MultiDraw"};
+    sceneMgr._setDestinationRenderSystem(&rs);
+    NullTarget target;
+    Camera* cam = sceneMgr.createCamera("Camera");
+    sceneMgr.mCurrentViewport = target.addViewport(cam);
+    sceneMgr.mCameraInProgress = cam;
+    auto mat = std::make_shared<Material>(nullptr, "MultiDraw", 0, RGN_DEFAULT);
+    Pass* pass = mat->createTechnique()->createPass();
+
+    // the last one has other geometry, so it ends the run
+    VertexData shared, other;
+    std::array<OperationRenderable, 4> renderables;
+    QueuedRenderableCollection collection;
+    collection.addOrganisationMode(QueuedRenderableCollection::OrganisationMode::PASS_GROUP);
+    for (size_t i = 0; i < renderables.size(); ++i)
+    {
+        renderables[i].operation.vertexData = i < 3 ? &shared : &other;
+        renderables[i].operation.useIndexes = false;
+        collection.addRenderable(pass, &renderables[i]);
+    }
 
-    Image combined;
-    // pick 2 files that are the same size, alpha texture will be made greyscale
-    combined.loadTwoImagesAsRGBA("rockwall.tga", "flare.png", RGN_DEFAULT, PixelFormat::BYTE_RGBA);
+    auto render = [&]
+    {
+        rs.draws.clear();
+        sceneMgr.getQueuedRenderableVisitor()->renderObjects(
+            collection, QueuedRenderableCollection::OrganisationMode::PASS_GROUP, false, false);
+    };
+    render();
+    EXPECT_EQ(rs.draws, (std::vector<size_t>{1, 1, 1, 1}));
 
-    // combined.save(::std::format("{}/rockwall_flare.png", testPath));
-    STBIImageCodec::shutdown();
-    ASSERT_TRUE(!memcmp(combined.getData(), ref.getData(), ref.getSize()));
+    rs.setCapability(Capabilities::MULTI_DRAW);
+    render();
+    EXPECT_EQ(rs.draws, (std::vector<size_t>{3, 1}));
 }
-
-struct UsePreviousResourceLoadingListener : public ResourceLoadingListener
+struct CountingHandler : public WorkQueue::RequestHandler, public WorkQueue::ResponseHandler
 {
-    auto resourceCollision(Resource *resource, ResourceManager *resourceManager) noexcept -> bool override { return false; }
-};
+    size_t handled{0};
+    std::set<WorkQueue::RequestID> ids;
 
-using ResourceLoading = RootWithoutRenderSystemFixture;
-TEST_F(ResourceLoading, CollsionUseExisting)
+    auto handleRequest(const WorkQueue::Request* req, const WorkQueue* srcQ) -> WorkQueue::Response* override
+    {
+        return new WorkQueue::Response{std::unique_ptr<const WorkQueue::Request>{req}, true, req->getData()};
+    }
+    void handleResponse(const WorkQueue::Response* res, const WorkQueue* srcQ) override
+    {
+        ++handled;
+        ids.insert(res->getRequest()->getID());
+    }
+};
+using WorkQueueTests = RootWithoutRenderSystemFixture;
+TEST_F(WorkQueueTests, DeliversAllResponses)
 {
-    UsePreviousResourceLoadingListener listener;
-    ResourceGroupManager::getSingleton().setLoadingListener(&listener);
+    WorkQueue* wq = mRoot->getWorkQueue();
+    wq->startup();
+    wq->setResponseProcessingTimeLimit(0);
+
+    CountingHandler handler, other;
+    uint16 channel = wq->getChannel("WorkQueueTests");
+    wq->addRequestHandler(channel, &handler);
+    wq->addResponseHandler(channel, &handler);
+    // registered for a later channel, so the table grows
+    wq->addResponseHandler(channel + 1, &other);
+
+    std::set<WorkQueue::RequestID> ids;
+    for (int i = 0; i < 1000; ++i)
+        ids.insert(wq->addRequest(channel, 0, i));
+
+    for (int i = 0; i < 1000 && handler.handled < ids.size(); ++i)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        wq->processResponses();
+    }
+    EXPECT_EQ(handler.ids, ids);
+    EXPECT_EQ(handler.handled, ids.size());
+    EXPECT_EQ(other.handled, 0u);
 
-    MaterialPtr mat = MaterialManager::getSingleton().create("Collision", "Tests");
-    EXPECT_TRUE(mat);
-    EXPECT_FALSE(MaterialManager::getSingleton().create("Collision", "Tests"));
-    EXPECT_FALSE(mat->clone("Collision"));
+    wq->removeResponseHandler(channel + 1, &other);
+    wq->removeResponseHandler(channel, &handler);
+    wq->removeRequestHandler(channel, &handler);
+}
+using ResourceBackgroundQueueTests = RootWithoutRenderSystemFixture;
+TEST_F(ResourceBackgroundQueueTests, PendingRequests)
+{
+    WorkQueue* wq = mRoot->getWorkQueue();
+    auto& rbq = ResourceBackgroundQueue::getSingleton();
+    rbq.initialise();
+    wq->startup();
+    wq->setPaused(true);
+
+    // only the first request goes to the WorkQueue, the others wait
+    rbq.setMaxRequestsInFlight(1);
+    auto first = rbq.prepareResourceGroup(RGN_DEFAULT);
+    auto second = rbq.prepareResourceGroup(RGN_DEFAULT);
+    auto third = rbq.prepareResourceGroup(RGN_DEFAULT);
+    EXPECT_EQ(rbq.getNumPendingRequests(), 2u);
+
+    EXPECT_FALSE(rbq.updateRequestPriority(first, {1}));
+    EXPECT_TRUE(rbq.updateRequestPriority(third, {1}));
+
+    rbq.abortRequest(second);
+    EXPECT_EQ(rbq.getNumPendingRequests(), 1u);
+    EXPECT_TRUE(rbq.isProcessComplete(second));
+    EXPECT_FALSE(rbq.isProcessComplete(third));
+
+    wq->setPaused(false);
+    for (int i = 0; i < 1000 && !rbq.isProcessComplete(third); ++i)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        wq->processResponses();
+        rbq._update();
+    }
+    EXPECT_TRUE(rbq.isProcessComplete(first));
+    EXPECT_TRUE(rbq.isProcessComplete(third));
+    EXPECT_EQ(rbq.getNumPendingRequests(), 0u);
+}
+TEST_F(ResourceBackgroundQueueTests, EntityInBackground)
+{
+    WorkQueue* wq = mRoot->getWorkQueue();
+    auto& rbq = ResourceBackgroundQueue::getSingleton();
+    rbq.initialise();
+    wq->startup();
+    wq->setPaused(true);
+
+    SceneManager* sm = mRoot->createSceneManager();
+    AxisAlignedBox proxy{AxisAlignedBox::Extent::Finite, Vector3{-1, -1, -1}, Vector3{1, 1, 1}};
+    Entity* ent = sm->createEntityInBackground("Background", "sphere.mesh", RGN_DEFAULT, proxy);
+    sm->getRootSceneNode()->attachObject(ent);
+
+    // returned at once, standing in with the proxy
+    EXPECT_FALSE(ent->isInitialised());
+    EXPECT_FALSE(ent->getMesh()->isLoaded());
+    EXPECT_EQ(ent->getBoundingBox(), proxy);
+    EXPECT_EQ(ent->getNumSubEntities(), 0u);
+
+    wq->setPaused(false);
+    for (int i = 0; i < 1000 && !ent->isInitialised(); ++i)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        wq->processResponses();
+        rbq._update();
+    }
+    ASSERT_TRUE(ent->isInitialised());
+    EXPECT_GT(ent->getNumSubEntities(), 0u);
+    EXPECT_EQ(ent->getBoundingBox(), ent->getMesh()->getBounds());
 
-    MeshPtr mesh = MeshManager::getSingleton().create("Collision", "Tests");
+    sm->destroyEntity(ent);
+    mRoot->destroySceneManager(sm);
+}
+namespace {
+    auto loadSphere(CancellationToken token) -> Async<MeshPtr>
+    {
+        MeshPtr mesh = co_await MeshManager::getSingleton().loadAsync("sphere.mesh", RGN_DEFAULT, token);
+        co_return mesh;
+    }
+}
+TEST_F(ResourceBackgroundQueueTests, AwaitLoad)
+{
+    WorkQueue* wq = mRoot->getWorkQueue();
+    auto& rbq = ResourceBackgroundQueue::getSingleton();
+    rbq.initialise();
+    wq->startup();
+
+    CancellationToken token;
+    Async<MeshPtr> loading = loadSphere(token);
+    for (int i = 0; i < 1000 && !loading.isReady(); ++i)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        wq->processResponses();
+        rbq._update();
+    }
+    ASSERT_TRUE(loading.isReady());
+    MeshPtr mesh = loading.get();
+    ASSERT_TRUE(mesh);
+    EXPECT_TRUE(mesh->isLoaded());
+
+    // loaded already, so nothing is queued
+    EXPECT_TRUE(loadSphere(token).isReady());
+}
+TEST_F(ResourceBackgroundQueueTests, CancelAwaitedLoad)
+{
+    WorkQueue* wq = mRoot->getWorkQueue();
+    auto& rbq = ResourceBackgroundQueue::getSingleton();
+    rbq.initialise();
+    wq->startup();
+    wq->setPaused(true);
+
+    CancellationToken token;
+    Async<MeshPtr> loading = loadSphere(token);
+    EXPECT_FALSE(loading.isReady());
+
+    // resumed from within cancel
+    token.cancel();
+    ASSERT_TRUE(loading.isReady());
+    EXPECT_FALSE(loading.get());
+
+    // cancelled before it is awaited
+    EXPECT_TRUE(loadSphere(token).isReady());
+    wq->setPaused(false);
+}
+using ResourceGroupManagerTests = RootWithoutRenderSystemFixture;
+TEST_F(ResourceGroupManagerTests, ParallelPreparation)
+{
+    // each mesh creates another one in its group while being prepared
+    struct CascadingLoader : public ManualResourceLoader
+    {
+        void prepareResource(Resource* resource) override
+        {
+            if (!resource->getName().starts_with("Cascaded"))
+                MeshManager::getSingleton().createManual(::std::format("Cascaded{}", resource->getName()),
+                                                         resource->getGroup(), this);
+        }
+        void loadResource(Resource* resource) override { (void)resource; }
+    } loader;
+    struct CreatedListener : public ResourceGroupListener
+    {
+        std::thread::id thread;
+        size_t created{0}, otherThread{0}, prepareStarted{0};
+        void resourceCreated(const ResourcePtr& resource) override
+        {
+            (void)resource;
+            ++created;
+            otherThread += std::this_thread::get_id() != thread;
+        }
+        void resourcePrepareStarted(const ResourcePtr& resource) override
+        {
+            (void)resource;
+            ++prepareStarted;
+        }
+    } listener;
+    listener.thread = std::this_thread::get_id();
+
+    auto& rgm = ResourceGroupManager::getSingleton();
+    rgm.createResourceGroup("ParallelPrepare");
+    std::vector<MeshPtr> meshes;
+    for (int i = 0; i < 64; ++i)
+        meshes.push_back(
+            MeshManager::getSingleton().createManual(::std::format("Mesh{}", i), "ParallelPrepare", &loader));
+
+    mRoot->getWorkQueue()->startup();
+    rgm.setParallelPreparation(true);
+    rgm.addResourceGroupListener(&listener);
+    rgm.prepareResourceGroup("ParallelPrepare");
+    rgm.removeResourceGroupListener(&listener);
+
+    // the cascaded meshes were added to the group and prepared in a further batch
+    EXPECT_EQ(listener.created, meshes.size());
+    EXPECT_EQ(listener.otherThread, 0u);
+    EXPECT_EQ(listener.prepareStarted, 2 * meshes.size());
+    for (const auto& mesh : meshes)
+    {
+        EXPECT_TRUE(mesh->isPrepared());
+        auto cascaded = MeshManager::getSingleton().getByName(::std::format("Cascaded{}", mesh->getName()),
+                                                                "ParallelPrepare");
+        ASSERT_TRUE(cascaded);
+        EXPECT_TRUE(cascaded->isPrepared());
+    }
+}
+TEST(Profiler, Counters)
+{
+    Profiler profiler;
+    profiler.setCounter("drawCalls", 10);
+    profiler.setCounter("drawCalls", 12);
+    profiler.setCounter("textureBinds", 3);
+
+    const auto& counters = profiler.getCounters();
+    ASSERT_EQ(counters.size(), 2u);
+    EXPECT_EQ(counters.at("drawCalls"), 12u);
+    EXPECT_EQ(counters.at("textureBinds"), 3u);
+
+    profiler.reset();
+    EXPECT_TRUE(profiler.getCounters().empty());
+}
+TEST(Profiler, TraceCapture)
+{
+    Profiler profiler;
+    Timer timer;
+    profiler.setTimer(&timer);
+    EXPECT_FALSE(profiler.getTraceCapture());
+    {
+        Profile ignored("Ignored");
+    }
+    profiler.setTraceCapture(true);
+    {
+        Profile outer("Outer");
+        Profile inner("Inner");
+    }
+    std::thread([] { Profile worker("Worker"); }).join();
+    profiler._collectTrace();
+
+    const auto& events = profiler.getTraceEvents();
+    ASSERT_EQ(events.size(), 3u);
+    EXPECT_EQ(events[0].name, "Inner");
+    EXPECT_EQ(events[0].depth, 1u);
+    EXPECT_EQ(events[1].name, "Outer");
+    EXPECT_EQ(events[1].thread, 0u);
+    EXPECT_LE(events[1].start, events[0].start);
+    EXPECT_EQ(events[2].name, "Worker");
+    EXPECT_EQ(events[2].thread, 1u);
+    EXPECT_EQ(profiler.getTraceDroppedEvents(), 0u);
+
+    std::ostringstream trace;
+    profiler.exportTrace(trace);
+    EXPECT_NE(trace.str().find(R"("name":"Worker","cat":"Ogre","ph":"X")"), String::npos);
+    profiler.setTraceCapture(false);
+}
+TEST(HitchMonitor, ReportsLongFrames)
+{
+    Profiler profiler;
+    Timer timer;
+    profiler.setTimer(&timer);
+    HitchMonitor monitor;
+    monitor.setThreshold(20000);
+    monitor.setFrameHistory(4);
+    monitor.setEnabled(true);
+    EXPECT_TRUE(profiler.getTraceCapture());
+
+    monitor._frameEnded(1);
+    {
+        Profile profile("Hitch");
+        HitchMonitor::Scope load{HitchMonitor::ActivityType::RESOURCE_LOAD, "slow.mesh"};
+        std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    }
+    profiler._collectTrace();
+    monitor._frameEnded(2);
+    EXPECT_EQ(monitor.getHitchCount(), 1u);
+
+    auto frames = monitor.getFrames();
+    ASSERT_EQ(frames.size(), 2u);
+    ASSERT_EQ(frames[1]->activities.size(), 1u);
+    EXPECT_EQ(frames[1]->activities[0].name, "slow.mesh");
+    EXPECT_GE(frames[1]->activities[0].duration, 30000000u);
+    ASSERT_EQ(frames[1]->events.size(), 1u);
+    EXPECT_EQ(frames[1]->events[0].name, "Hitch");
+
+    std::ostringstream report;
+    monitor.writeReport(report);
+    EXPECT_NE(report.str().find(R"("name":"slow.mesh","cat":"Resource load")"), String::npos);
+
+    // only the last frames are kept
+    for (unsigned long frame = 3; frame < 8; ++frame)
+        monitor._frameEnded(frame);
+    frames = monitor.getFrames();
+    ASSERT_EQ(frames.size(), 4u);
+    EXPECT_EQ(frames.front()->number, 4u);
+    EXPECT_TRUE(frames.back()->activities.empty());
+
+    monitor.setEnabled(false);
+    EXPECT_FALSE(profiler.getTraceCapture());
+}
+TEST(StartupProfiler, CriticalPath)
+{
+    using enum StartupProfiler::PhaseType;
+    auto sleep = [](int ms) { std::this_thread::sleep_for(std::chrono::milliseconds(ms)); };
+
+    StartupProfiler profiler;
+    {
+        StartupProfiler::Scope group{RESOURCE_GROUP, "General"};
+        // the worker ends after the script of the main thread, so the group waits for it
+        std::thread worker([&] {
+            StartupProfiler::Scope shader{SHADER_COMPILE, "Slow.glsl"};
+            sleep(40);
+        });
+        {
+            StartupProfiler::Scope script{SCRIPT_PARSE, "Fast.material"};
+            sleep(10);
+        }
+        worker.join();
+        StartupProfiler::Scope mesh{MESH_LOAD, "Knot.mesh"};
+        sleep(10);
+    }
+    profiler.finish();
+    EXPECT_FALSE(profiler.isRecording());
+
+    const auto& phases = profiler.getPhases();
+    ASSERT_EQ(phases.size(), 4u);
+    auto find = [&](std::string_view name)
+    { return std::ranges::find(phases, name, &StartupProfiler::Phase::name) - phases.begin(); };
+    const auto& script = phases[find("Fast.material")];
+    EXPECT_EQ(script.parent, size_t(find("General")));
+    EXPECT_EQ(script.depth, 1u);
+    const auto& shader = phases[find("Slow.glsl")];
+    EXPECT_EQ(shader.thread, 1u);
+    EXPECT_EQ(shader.parent, StartupProfiler::NO_PHASE);
+    EXPECT_GE(shader.duration, 40000000u);
+
+    std::vector<String> leaves;
+    uint64 total = 0;
+    for (const auto& span : profiler.getCriticalPath())
+    {
+        total += span.duration;
+        if (span.phase != StartupProfiler::NO_PHASE && !span.self)
+            leaves.push_back(phases[span.phase].name);
+    }
+    EXPECT_EQ(leaves, (std::vector<String>{"Slow.glsl", "Knot.mesh"}));
+    EXPECT_EQ(total, profiler.getDuration());
+
+    std::ostringstream trace;
+    profiler.writeTrace(trace);
+    EXPECT_NE(trace.str().find(R"("name":"Slow.glsl","cat":"Shader compilation")"), String::npos);
+}
+TEST(ShaderTelemetry, VariantManifest)
+{
+    Root root;
+    ShaderTelemetry& telemetry = ShaderTelemetry::getSingleton();
+    {
+        ShaderTelemetry::Scope disabled{ShaderTelemetry::EventType::COMPILE, "Disabled"};
+        EXPECT_FALSE(disabled.isRecording());
+    }
+    telemetry.setEnabled(true);
+
+    auto mat = std::make_shared<Material>(nullptr, "Telemetry", 0, "General");
+    Technique* tech = mat->createTechnique();
+    tech->setSchemeName("Scheme");
+    {
+        ShaderTelemetry::PassScope pass{tech->createPass()};
+        ShaderTelemetry::Scope compile{ShaderTelemetry::EventType::COMPILE, "Telemetry_VS"};
+        compile.setCacheHit(true);
+    }
+    for (int i = 0; i < 2; ++i)
+    {
+        ShaderTelemetry::Scope generation{ShaderTelemetry::EventType::GENERATION, "Telemetry"};
+        generation.setVariant({"Telemetry", "General", "", "Scheme", true});
+    }
+    {
+        ShaderTelemetry::Scope batch{ShaderTelemetry::EventType::GENERATION, "RTSS programs"};
+    }
+
+    auto events = telemetry.getEvents();
+    ASSERT_EQ(events.size(), 4u);
+    EXPECT_EQ(events[0].program, "Telemetry_VS");
+    EXPECT_EQ(events[0].variant.material, "Telemetry");
+    EXPECT_EQ(events[0].variant.scheme, "Scheme");
+    EXPECT_EQ(events[0].frame, root.getNextFrameNumber());
+    EXPECT_TRUE(events[0].cacheHit);
+    // the pass is no longer current
+    EXPECT_TRUE(events[3].variant.material.empty());
+
+    // every variant once, in the format read by the RTSS
+    std::ostringstream manifest;
+    telemetry.writeVariantManifest(manifest);
+    EXPECT_EQ(manifest.str(), "Telemetry\tGeneral\t\tScheme\t1\n");
+
+    std::ostringstream table;
+    telemetry.writeEvents(table);
+    EXPECT_EQ(std::ranges::count(table.str(), '\n'), 5);
+
+    telemetry.clear();
+    EXPECT_TRUE(telemetry.getEvents().empty());
+}
+TEST(Log, AsyncWriter)
+{
+    auto path = (std::filesystem::temp_directory_path() / "OgreAsyncLog.log").string();
+    {
+        Log log(path, false);
+        log.setTimeStampEnabled(false);
+        log.setAsync(true);
+        EXPECT_TRUE(log.isAsync());
+
+        for (int i = 0; i < 3; ++i)
+            log.logMessage("repeated");
+        log.logMessage("other");
+
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t)
+            threads.emplace_back([&log, t] {
+                for (int i = 0; i < 100; ++i)
+                    log.stream() << "thread " << t << " message " << i;
+            });
+        for (auto& thread : threads)
+            thread.join();
+        log.flush();
+        log.setAsync(false);
+        log.logMessage("sync");
+    }
+
+    std::ifstream file(path);
+    size_t messages = 0, repeated = 0, repeats = 0;
+    for (String line; std::getline(file, line);)
+    {
+        int count;
+        if (std::sscanf(line.c_str(), "Last message repeated %d times", &count) == 1)
+            repeats += count;
+        else if (line == "repeated")
+            ++repeated;
+        else
+            ++messages;
+    }
+    EXPECT_EQ(repeated, 1u);
+    EXPECT_EQ(repeats, 2u);
+    EXPECT_EQ(messages, 402u);
+    file.close();
+    std::filesystem::remove(path);
+}
+TEST(MemoryTracker, CountsPerCategory)
+{
+    struct Tracked : public GeometryAllocatedObject
+    {
+        char data[256];
+    };
+
+    MemoryTracker::resetPeaks();
+    auto before = MemoryTracker::getStats(MemoryCategory::GEOMETRY);
+    auto general = MemoryTracker::getStats(MemoryCategory::GENERAL);
+
+    auto single = std::make_unique<Tracked>();
+    auto array = new Tracked[4];
+    auto during = MemoryTracker::getStats(MemoryCategory::GEOMETRY);
+    EXPECT_GE(during.liveBytes - before.liveBytes, 5 * sizeof(Tracked));
+    EXPECT_EQ(during.allocations - before.allocations, 2u);
+    EXPECT_EQ(during.allocatedBytes - before.allocatedBytes, during.liveBytes - before.liveBytes);
+
+    delete[] array;
+    single.reset();
+    auto after = MemoryTracker::getStats(MemoryCategory::GEOMETRY);
+    EXPECT_EQ(after.liveBytes, before.liveBytes);
+    EXPECT_EQ(after.peakBytes, during.liveBytes);
+    EXPECT_EQ(MemoryTracker::getStats(MemoryCategory::GENERAL).allocations, general.allocations);
+    EXPECT_EQ(MemoryTracker::getCategoryName(MemoryCategory::GEOMETRY), "Geometry");
+}
+TEST(MemoryTracker, CategoryAllocators)
+{
+    SmallObjectAllocator pool;
+    void* first = pool.allocate(40, 16);
+    pool.deallocate(first, 40, 16);
+    // the freed block is cached by the thread
+    EXPECT_EQ(pool.allocate(33, 16), first);
+    pool.deallocate(first, 33, 16);
+
+    std::vector<void*> blocks;
+    for (int i = 0; i < 1000; ++i)
+        blocks.push_back(pool.allocate(24, 16));
+    std::thread([&] {
+        for (void* block : blocks)
+            pool.deallocate(block, 24, 16);
+    }).join();
+    EXPECT_LE(pool.getReservedBytes(), 2 * 64 * 1024u);
+
+    LinearAllocator arena(256);
+    auto a = static_cast<uchar*>(arena.allocate(10, 8));
+    auto b = static_cast<uchar*>(arena.allocate(10, 32));
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(b) % 32, 0u);
+    EXPECT_GE(b, a + 10);
+    void* overflow = arena.allocate(1024, 8);
+    arena.deallocate(overflow, 1024, 8);
+    EXPECT_EQ(arena.getUsed(), size_t(b + 10 - a));
+    arena.reset();
+    EXPECT_EQ(arena.allocate(10, 8), a);
+
+    struct Tracked : public AnimationAllocatedObject
+    {
+        Real time;
+    };
+    if (MemoryTracker::getStats(MemoryCategory::ANIMATION).liveBytes != 0)
+        GTEST_SKIP() << "animation memory is in use";
+
+    MemoryTracker::setAllocator(MemoryCategory::ANIMATION, &pool);
+    EXPECT_EQ(MemoryTracker::getAllocator(MemoryCategory::ANIMATION), &pool);
+    auto tracked = std::make_unique<Tracked>();
+    EXPECT_THROW(MemoryTracker::setAllocator(MemoryCategory::ANIMATION, nullptr), Exception);
+    tracked.reset();
+    MemoryTracker::setAllocator(MemoryCategory::ANIMATION, nullptr);
+}
+TEST(FrameAllocator, GrowsToThePeak)
+{
+    FrameAllocator scratch{1024};
+    FrameVector<uint32> small{&scratch};
+    small.reserve(16);
+    EXPECT_EQ(scratch.getUsed(), 16 * sizeof(uint32));
+
+    // does not fit, taken from the heap until the next reset
+    FrameVector<uint64> large(1000, 0, &scratch);
+    EXPECT_EQ(scratch.getUsed(), 16 * sizeof(uint32) + 1000 * sizeof(uint64));
+    EXPECT_EQ(scratch.getCapacity(), 1024u);
+
+    small = FrameVector<uint32>{&scratch};
+    large = FrameVector<uint64>{&scratch};
+    scratch.reset();
+    EXPECT_EQ(scratch.getUsed(), 0u);
+    EXPECT_GE(scratch.getPeak(), 16 * sizeof(uint32) + 1000 * sizeof(uint64));
+    EXPECT_GE(scratch.getCapacity(), scratch.getPeak());
+
+    // the same frame again fits into the buffer, so it is kept
+    size_t capacity = scratch.getCapacity();
+    FrameVector<uint32> again{&scratch};
+    again.reserve(16);
+    FrameVector<uint64> fits(1000, 0, &scratch);
+    auto begin = reinterpret_cast<const uint8*>(again.data());
+    auto end = reinterpret_cast<const uint8*>(fits.data() + fits.size());
+    EXPECT_LE(size_t(end - begin), capacity);
+    again = FrameVector<uint32>{&scratch};
+    fits = FrameVector<uint64>{&scratch};
+    scratch.reset();
+    EXPECT_EQ(scratch.getCapacity(), capacity);
+
+    FrameString name{&scratch};
+    std::format_to(std::back_inserter(name), "{}/{}", "SceneManager", "nodesUpdated");
+    EXPECT_EQ(name, "SceneManager/nodesUpdated");
+}
+TEST_F(SceneQueryTest, SortKeyGrouping)
+{
+    auto mapped = findVisible(mCamera, nullptr, true).groups;
+    mSceneMgr->getRenderQueue()->setSortKeyGrouping(true);
+    auto keyed = findVisible(mCamera, nullptr, true).groups;
+
+    // all spheres share one pass
+    ASSERT_EQ(mapped.size(), 1u);
+    ASSERT_EQ(keyed.size(), 1u);
+    EXPECT_EQ(mapped[0].first, keyed[0].first);
+
+    auto& renderables = keyed[0].second;
+    EXPECT_EQ(std::set<Renderable*>(renderables.begin(), renderables.end()),
+              std::set<Renderable*>(mapped[0].second.begin(), mapped[0].second.end()));
+    // front to back within the pass
+    EXPECT_TRUE(std::is_sorted(renderables.begin(), renderables.end(), [this](Renderable* a, Renderable* b)
+                               { return a->getSquaredViewDepth(mCamera) < b->getSquaredViewDepth(mCamera); }));
+}
+TEST_F(SceneQueryTest, FrontToBackGrouping)
+{
+    auto mainGroup = mSceneMgr->getRenderQueue()->getQueueGroup(RenderQueueGroupID::MAIN);
+    mainGroup->resetOrganisationModes();
+    mainGroup->addOrganisationMode(QueuedRenderableCollection::OrganisationMode::PASS_GROUP_FRONT_TO_BACK);
+
+    // the scene manager asks for pass groups, which this mode stands in for
+    auto groups = findVisible(mCamera, nullptr, true).groups;
+
+    // all spheres share one pass, ordered front to back up to the quantisation
+    ASSERT_EQ(groups.size(), 1u);
+    auto& renderables = groups[0].second;
+    EXPECT_GT(renderables.size(), 1u);
+    for (size_t i = 1; i < renderables.size(); ++i)
+        EXPECT_LE(renderables[i - 1]->getSquaredViewDepth(mCamera),
+                  renderables[i]->getSquaredViewDepth(mCamera) * 1.01f);
+}
+TEST_F(SceneQueryTest, LightGrid)
+{
+    std::minstd_rand rng;
+    LightList lights;
+    for (int i = 0; i < 200; ++i)
+    {
+        Light* light = mSceneMgr->createLight();
+        light->setType(i % 5 ? Light::LightTypes::POINT : Light::LightTypes::SPOTLIGHT);
+        light->setAttenuation(float(50 + rng() % 400), 1, 0, 0);
+        Vector3 pos{Real(rng() % 5000) - 2500, Real(rng() % 5000) - 2500, Real(rng() % 5000) - 2500};
+        mSceneMgr->getRootSceneNode()->createChildSceneNode(pos)->attachObject(light);
+        lights.push_back(light);
+    }
+    lights.push_back(mSceneMgr->createLight(Light::LightTypes::DIRECTIONAL));
+    mSceneMgr->getRootSceneNode()->attachObject(lights.back());
+    mSceneMgr->_updateSceneGraph(mCamera);
+
+    LightGrid grid;
+    grid.build(lights);
+
+    std::vector<uint32> candidates;
+    for (auto node : mSceneMgr->getRootSceneNode()->getChildren())
+    {
+        auto sn = static_cast<SceneNode*>(node);
+        if (sn->getAttachedObjects().empty() || !dynamic_cast<Entity*>(sn->getAttachedObject(0)))
+            continue;
+        Sphere sphere{sn->_getDerivedPosition(), sn->getAttachedObject(0)->getBoundingRadius()};
+
+        std::vector<uint32> expected;
+        for (uint32 i = 0; i < lights.size(); ++i)
+        {
+            if (lights[i]->isInLightRange(sphere))
+                expected.push_back(i);
+        }
+
+        ASSERT_TRUE(grid.findCandidates(sphere, candidates));
+        EXPECT_TRUE(std::ranges::is_sorted(candidates));
+        std::erase_if(candidates, [&](uint32 i) { return !lights[i]->isInLightRange(sphere); });
+        EXPECT_EQ(candidates, expected);
+    }
+}
+TEST_F(SceneQueryTest, RetainSortOrder)
+{
+    std::vector<RenderablePass> queued;
+    for (auto node : mSceneMgr->getRootSceneNode()->getChildren())
+    {
+        for (auto mo : static_cast<SceneNode*>(node)->getAttachedObjects())
+        {
+            if (auto ent = dynamic_cast<Entity*>(mo))
+                queued.push_back({ent->getSubEntity(0), ent->getSubEntity(0)->getTechnique()->getPass(0)});
+        }
+    }
+    ASSERT_EQ(queued.size(), 501u);
+
+    auto sort = [&](QueuedRenderableCollection& collection, size_t begin, size_t end)
+    {
+        collection.clear();
+        for (size_t i = begin; i < end; ++i)
+            collection.addRenderable(queued[i].pass, queued[i].renderable);
+        collection.sort(mCamera);
+
+        QueueCollector collector;
+        collection.acceptVisitor(&collector, QueuedRenderableCollection::OrganisationMode::SORT_DESCENDING);
+        return collector.renderables;
+    };
+
+    QueuedRenderableCollection regular, retained;
+    regular.addOrganisationMode(QueuedRenderableCollection::OrganisationMode::SORT_DESCENDING);
+    retained.addOrganisationMode(QueuedRenderableCollection::OrganisationMode::SORT_DESCENDING);
+    retained.setRetainSortOrder(true);
+
+    EXPECT_EQ(sort(retained, 0, 400), sort(regular, 0, 400));
+
+    // the camera moves a bit, some renderables come and go
+    mCameraNode->translate(Vector3{20, 0, 0});
+    mSceneMgr->_updateSceneGraph(mCamera);
+    EXPECT_EQ(sort(retained, 10, 410), sort(regular, 10, 410));
+
+    // everything changes
+    mCameraNode->setPosition(0, 0, -500);
+    mSceneMgr->_updateSceneGraph(mCamera);
+    EXPECT_EQ(sort(retained, 0, 501), sort(regular, 0, 501));
+}
+TEST(MaterialSerializer, Basic)
+{
+    Root root;
+    DefaultTextureManager texMgr;
+
+    String group = "General";
+
+    auto mat = std::make_shared<Material>(nullptr, "Material Name", 0, group);
+    auto pass = mat->createTechnique()->createPass();
+    auto tus = pass->createTextureUnitState();
+    tus->setContentType(TextureUnitState::ContentType::SHADOW);
+    tus->setName("Test TUS");
+    pass->setAmbient(ColourValue::Green);
+
+    pass->createTextureUnitState("TextureName");
+
+    // export to string
+    MaterialSerializer ser;
+    ser.queueForExport(mat);
+    std::string str{ser.getQueuedAsString()};
+
+    // printf("%s\n", str.c_str());
+
+    // load again
+    DataStreamPtr stream = std::make_shared<MemoryDataStream>("memory.material", &str[0], str.size());
+    MaterialManager::getSingleton().parseScript(stream, group);
+
+    auto mat2 = MaterialManager::getSingleton().getByName("Material Name", group);
+    ASSERT_TRUE(mat2);
+    EXPECT_EQ(mat2->getTechniques().size(), mat->getTechniques().size());
+    EXPECT_EQ(mat2->getTechniques()[0]->getPasses()[0]->getAmbient(), ColourValue::Green);
+    EXPECT_EQ(mat2->getTechniques()[0]->getPasses()[0]->getTextureUnitState(0)->getName(),
+              "Test TUS");
+    EXPECT_EQ(mat2->getTechniques()[0]->getPasses()[0]->getTextureUnitState("Test TUS")->getContentType(),
+              TextureUnitState::ContentType::SHADOW);
+    EXPECT_EQ(mat2->getTechniques()[0]->getPasses()[0]->getTextureUnitState(1)->getTextureName(),
+              "TextureName");
+}
+TEST(ScriptCompilerManager, ParsedScriptCache)
+{
+    Root root;
+    DefaultTextureManager texMgr;
+
+    std::filesystem::path cache = std::filesystem::temp_directory_path() / "OgreParsedScriptCache";
+    std::filesystem::remove_all(cache);
+    ScriptCompilerManager::getSingleton().setCacheLocation(cache.string());
+
+    String script = "material Cached { technique { pass { ambient 0 1 0\n texture_unit \"quoted unit\" {} } } }";
+    auto parse = [&]()
+    {
+        if (MaterialManager::getSingleton().resourceExists("Cached", "General"))
+            MaterialManager::getSingleton().remove("Cached", "General");
+        DataStreamPtr stream = std::make_shared<MemoryDataStream>("cached.material", &script[0], script.size());
+        MaterialManager::getSingleton().parseScript(stream, "General");
+        auto mat = MaterialManager::getSingleton().getByName("Cached", "General");
+        ASSERT_TRUE(mat);
+        EXPECT_EQ(mat->getTechniques()[0]->getPasses()[0]->getAmbient(), ColourValue::Green);
+        EXPECT_EQ(mat->getTechniques()[0]->getPasses()[0]->getTextureUnitState(0)->getName(), "quoted unit");
+    };
+
+    // the first load writes the cache, the second one reads it
+    parse();
+    std::vector<std::filesystem::path> files(std::filesystem::directory_iterator{cache}, {});
+    ASSERT_EQ(files.size(), 1u);
+    auto size = std::filesystem::file_size(files[0]);
+    parse();
+
+    // a corrupt file is parsed again and replaced
+    std::filesystem::resize_file(files[0], size - 3);
+    parse();
+    EXPECT_EQ(std::filesystem::file_size(files[0]), size);
+
+    ScriptCompilerManager::getSingleton().setCacheLocation("");
+    std::filesystem::remove_all(cache);
+}
+TEST(ScriptCompilerManager, ParallelScriptParsing)
+{
+    Root root;
+    DefaultTextureManager texMgr;
+
+    struct SkipListener : public ResourceGroupListener
+    {
+        std::vector<String> started;
+        void scriptParseStarted(std::string_view scriptName, bool& skipThisScript) override
+        {
+            started.emplace_back(scriptName);
+            skipThisScript = scriptName == "skipped.material";
+        }
+    } listener;
+
+    std::filesystem::path dir = std::filesystem::temp_directory_path() / "OgreParallelScripts";
+    std::filesystem::create_directories(dir);
+    std::vector<String> names = {"a", "b", "c", "d", "e", "f", "skipped"};
+    for (size_t i = 0; i < names.size(); ++i)
+        std::ofstream(dir / (names[i] + ".material"))
+            << ::std::format("material Parallel_{} {{ technique {{ pass {{ ambient {} 0 0 }} }} }}", names[i], i / 8.0);
+
+    auto& rgm = ResourceGroupManager::getSingleton();
+    rgm.addResourceGroupListener(&listener);
+    rgm.addResourceLocation(dir.string(), "FileSystem", "Parallel");
+    rgm.initialiseResourceGroup("Parallel");
+    rgm.removeResourceGroupListener(&listener);
+
+    // the scripts are still translated one by one, and the listener sees all of them
+    EXPECT_EQ(listener.started.size(), names.size());
+    for (size_t i = 0; i < names.size() - 1; ++i)
+    {
+        auto mat = MaterialManager::getSingleton().getByName("Parallel_" + names[i], "Parallel");
+        ASSERT_TRUE(mat);
+        EXPECT_EQ(mat->getTechniques()[0]->getPasses()[0]->getAmbient().r, i / 8.0f);
+    }
+    EXPECT_FALSE(MaterialManager::getSingleton().getByName("Parallel_skipped", "Parallel"));
+
+    rgm.destroyResourceGroup("Parallel");
+    std::filesystem::remove_all(dir);
+}
+TEST(ScriptCompilerManager, QuotedTokens)
+{
+    Root root;
+    DefaultTextureManager texMgr;
+
+    // the lexemes are views of the source, the parser resolves the escaping
+    String script = "material Quoted { technique \"a\\\\b\" {\r\n pass \"\\\"escaped\\\" c\\d\"{/* } */} } }\n"
+                    "material Quoted2 : Quoted {}";
+    DataStreamPtr stream = std::make_shared<MemoryDataStream>("quoted.material", &script[0], script.size());
+    MaterialManager::getSingleton().parseScript(stream, "General");
+
+    auto mat = MaterialManager::getSingleton().getByName("Quoted2", "General");
+    ASSERT_TRUE(mat);
+    EXPECT_EQ(mat->getTechniques()[0]->getName(), "a\\b");
+    EXPECT_EQ(mat->getTechniques()[0]->getPasses()[0]->getName(), "\"escaped\" c\\d");
+}
+TEST(MaterialManager, LazyLoading)
+{
+    Root root;
+    DefaultTextureManager texMgr;
+
+    auto& mm = MaterialManager::getSingleton();
+    auto countMaterials = [&mm]
+    {
+        size_t count = 0;
+        for (auto it = mm.getResourceIterator(); it.hasMoreElements(); it.moveNext())
+            ++count;
+        return count;
+    };
+    size_t builtin = countMaterials();
+
+    mm.setLazyLoading(true);
+    String script = "material Caster { technique { pass { ambient 0.5 0.5 0.5 } } }\n"
+                    "material Lit { technique { shadow_caster_material Caster\n pass {} } }";
+    DataStreamPtr stream = std::make_shared<MemoryDataStream>("lazy.material", &script[0], script.size());
+    mm.parseScript(stream, "General");
+
+    // nothing is translated before the lookup
+    EXPECT_EQ(countMaterials(), builtin);
+    ResourceGroupManager::getSingleton().createResourceGroup("Lazy", false);
+    EXPECT_FALSE(mm.getByName("Lit", "Lazy"));
+    EXPECT_EQ(countMaterials(), builtin);
+
+    // translating Lit looks up Caster from within the translators
+    auto lit = mm.getByName("Lit");
+    ASSERT_TRUE(lit);
+    EXPECT_EQ(lit->getGroup(), "General");
+    auto caster = lit->getTechniques()[0]->getShadowCasterMaterial();
+    ASSERT_TRUE(caster);
+    EXPECT_EQ(caster->getName(), "Caster");
+    EXPECT_EQ(caster->getTechniques()[0]->getPasses()[0]->getAmbient(), ColourValue(0.5, 0.5, 0.5));
+    EXPECT_EQ(lit->getTechniques()[0]->getPasses().size(), 1u);
+    EXPECT_EQ(countMaterials(), builtin + 2);
+    EXPECT_EQ(mm.getByName("Caster", "General"), caster);
+}
+TEST(Pass, CompiledState)
+{
+    Root root;
+
+    auto mat = std::make_shared<Material>(nullptr, "Compiled", 0, "General");
+    auto pass = mat->createTechnique()->createPass();
+    EXPECT_EQ(pass->_getCompiledState().depthFunction, CompareFunction::LESS_EQUAL);
+    EXPECT_EQ(pass->_getCompiledState().numTextureUnits, 0u);
+
+    // every change is picked up on the next use
+    pass->setDepthFunction(CompareFunction::GREATER);
+    pass->setSceneBlending(SceneBlendType::TRANSPARENT_ALPHA);
+    pass->setDepthBias(2, 1);
+    pass->setCullingMode(CullingMode::NONE);
+    pass->createTextureUnitState();
+
+    const auto& state = pass->_getCompiledState();
+    EXPECT_EQ(state.depthFunction, CompareFunction::GREATER);
+    EXPECT_EQ(state.blendState, pass->getBlendState());
+    EXPECT_EQ(state.depthBiasConstant, 2);
+    EXPECT_EQ(state.depthBiasSlopeScale, 1);
+    EXPECT_EQ(state.cullingMode, CullingMode::NONE);
+    EXPECT_EQ(state.numTextureUnits, 1u);
+}
+TEST(SceneManager, PassStateFiltering)
+{
+    RecordingRenderSystem rs;
+    Root root("");
+    SceneManager* sm = root.createSceneManager();
+    sm->_setDestinationRenderSystem(&rs);
+    sm->setPassStateFiltering(true);
+
+    auto mat = std::make_shared<Material>(nullptr, "Filtered", 0, "General");
+    auto technique = mat->createTechnique();
+    auto opaque = technique->createPass();
+    auto transparent = technique->createPass();
+    transparent->setSceneBlending(SceneBlendType::TRANSPARENT_ALPHA);
+    auto iterated = technique->createPass();
+    iterated->setIterationDepthBias(1);
+
+    // nothing is known about the render system yet
+    sm->_setPass(opaque);
+    EXPECT_EQ(rs.blendStateCalls, 1u);
+    EXPECT_EQ(rs.depthBiasCalls.size(), 1u);
+    size_t issued = sm->getPassStateStats().stateCallsIssued;
+
+    sm->_setPass(opaque);
+    EXPECT_EQ(rs.blendStateCalls, 1u);
+    EXPECT_EQ(rs.depthBiasCalls.size(), 1u);
+    EXPECT_EQ(sm->getPassStateStats().stateCallsIssued, issued);
+    EXPECT_EQ(sm->getPassStateStats().stateCallsSkipped, issued);
+
+    // only what differs
+    sm->_setPass(transparent);
+    EXPECT_EQ(rs.blendStateCalls, 2u);
+    EXPECT_EQ(rs.depthBiasCalls.size(), 1u);
+
+    // the bias is changed while rendering the iterations, so the next pass sets it again
+    sm->_setPass(iterated);
+    EXPECT_EQ(rs.blendStateCalls, 3u);
+    EXPECT_EQ(rs.depthBiasCalls.size(), 1u);
+    sm->_setPass(opaque);
+    EXPECT_EQ(rs.blendStateCalls, 3u);
+    ASSERT_EQ(rs.depthBiasCalls.size(), 2u);
+    EXPECT_EQ(rs.depthBiasCalls.back(), std::pair(0.0f, 0.0f));
+
+    // direct changes of the render system
+    sm->_invalidatePassState();
+    sm->_setPass(opaque);
+    EXPECT_EQ(rs.blendStateCalls, 4u);
+    EXPECT_EQ(rs.depthBiasCalls.size(), 3u);
+    EXPECT_EQ(sm->getPassStateStats().passesSet, 6u);
+}
+TEST(Material, CloneSharedParameters)
+{
+    Root root;
+
+    auto prog = HighLevelGpuProgramManager::getSingleton().createProgram("Shared", RGN_DEFAULT, "null",
+                                                                         GpuProgramType::VERTEX_PROGRAM);
+    auto mat = MaterialManager::getSingleton().create("SharedBase", RGN_DEFAULT);
+    mat->getTechniques()[0]->getPasses()[0]->setGpuProgram(GpuProgramType::VERTEX_PROGRAM, prog);
+    auto pass = mat->getTechniques()[0]->getPasses()[0];
+    auto params = pass->_getGpuProgramParameters(GpuProgramType::VERTEX_PROGRAM);
+
+    auto copy = mat->clone("SharedCopy")->getTechniques()[0]->getPasses()[0];
+    EXPECT_NE(copy->_getGpuProgramParameters(GpuProgramType::VERTEX_PROGRAM), params);
+
+    auto clone = mat->clone("SharedClone", RGN_DEFAULT, true)->getTechniques()[0]->getPasses()[0];
+    EXPECT_EQ(clone->_getGpuProgramParameters(GpuProgramType::VERTEX_PROGRAM), params);
+
+    // handing them out for changing them copies them
+    auto cloneParams = clone->getGpuProgramParameters(GpuProgramType::VERTEX_PROGRAM);
+    EXPECT_NE(cloneParams, params);
+    EXPECT_EQ(clone->_getGpuProgramParameters(GpuProgramType::VERTEX_PROGRAM), cloneParams);
+    params.reset();
+
+    // the original holds the last reference, so it keeps its parameters
+    auto* original = pass->_getGpuProgramParameters(GpuProgramType::VERTEX_PROGRAM).get();
+    EXPECT_EQ(pass->getGpuProgramParameters(GpuProgramType::VERTEX_PROGRAM).get(), original);
+}
+TEST(Image, FlipV)
+{
+    ResourceGroupManager mgr;
+    STBIImageCodec::startup();
+    ConfigFile cf;
+    cf.load(FileSystemLayer(/*OGRE_VERSION_NAME*/"Tsathoggua").getConfigFilePath("resources.cfg"));
+    auto testPath = cf.getSettings("Tests").begin()->second;
+
+    Image ref;
+    ref.load(Root::openFileStream(::std::format("{}/decal1vflip.png", testPath)), "png");
+
+    Image img;
+    img.load(Root::openFileStream(::std::format("{}/decal1.png", testPath)), "png");
+    img.flipAroundX();
+
+    // img.save(::std::format("{}/decal1vflip.png", testPath));
+
+    STBIImageCodec::shutdown();
+    ASSERT_TRUE(!memcmp(img.getData(), ref.getData(), ref.getSize()));
+}
+TEST(Image, Resize)
+{
+    ResourceGroupManager mgr;
+    STBIImageCodec::startup();
+    ConfigFile cf;
+    cf.load(FileSystemLayer(/*OGRE_VERSION_NAME*/"Tsathoggua").getConfigFilePath("resources.cfg"));
+    auto testPath = cf.getSettings("Tests").begin()->second;
+
+    Image ref;
+    ref.load(Root::openFileStream(::std::format("{}/decal1small.png", testPath)), "png");
+
+    Image img;
+    img.load(Root::openFileStream(::std::format("{}/decal1.png", testPath)), "png");
+    img.resize(128, 128);
+
+    //img.save(::std::format("{}/decal1small.png", testPath));
+
+    STBIImageCodec::shutdown();
+    ASSERT_TRUE(!memcmp(img.getData(), ref.getData(), ref.getSize()));
+}
+TEST(Image, Combine)
+{
+    ResourceGroupManager mgr;
+    FileSystemArchiveFactory fs;
+    ArchiveManager amgr;
+    amgr.addArchiveFactory(&fs);
+    STBIImageCodec::startup();
+    ConfigFile cf;
+    cf.load(FileSystemLayer(/*OGRE_VERSION_NAME*/"Tsathoggua").getConfigFilePath("resources.cfg"));
+    mgr.addResourceLocation(::std::format("{}/../materials/textures", cf.getSettings("General").begin()->second), fs.getType());
+    mgr.initialiseAllResourceGroups();
+
+    auto testPath = cf.getSettings("Tests").begin()->second;
+    Image ref;
+    ref.load(Root::openFileStream(::std::format("{}/rockwall_flare.png", testPath)), "png");
+
+    Image combined;
+    // pick 2 files that are the same size, alpha texture will be made greyscale
+    combined.loadTwoImagesAsRGBA("rockwall.tga", "flare.png", RGN_DEFAULT, PixelFormat::BYTE_RGBA);
+
+    // combined.save(::std::format("{}/rockwall_flare.png", testPath));
+    STBIImageCodec::shutdown();
+    ASSERT_TRUE(!memcmp(combined.getData(), ref.getData(), ref.getSize()));
+}
+
+struct UsePreviousResourceLoadingListener : public ResourceLoadingListener
+{
+    auto resourceCollision(Resource *resource, ResourceManager *resourceManager) noexcept -> bool override { return false; }
+};
+
+using ResourceLoading = RootWithoutRenderSystemFixture;
+TEST_F(ResourceLoading, CollsionUseExisting)
+{
+    UsePreviousResourceLoadingListener listener;
+    ResourceGroupManager::getSingleton().setLoadingListener(&listener);
+
+    MaterialPtr mat = MaterialManager::getSingleton().create("Collision", "Tests");
+    EXPECT_TRUE(mat);
+    EXPECT_FALSE(MaterialManager::getSingleton().create("Collision", "Tests"));
+    EXPECT_FALSE(mat->clone("Collision"));
+
+    MeshPtr mesh = MeshManager::getSingleton().create("Collision", "Tests");
     EXPECT_TRUE(mesh);
     EXPECT_FALSE(MeshManager::getSingleton().create("Collision", "Tests"));
     EXPECT_FALSE(mesh->clone("Collision"));
@@ -311,30 +2105,395 @@ struct DeletePreviousResourceLoadingListener : public ResourceLoadingListener
 };
 TEST_F(ResourceLoading, CollsionDeleteExisting)
 {
-    DeletePreviousResourceLoadingListener listener;
-    ResourceGroupManager::getSingleton().setLoadingListener(&listener);
-    ResourceGroupManager::getSingleton().createResourceGroup("EmptyGroup", false);
+    DeletePreviousResourceLoadingListener listener;
+    ResourceGroupManager::getSingleton().setLoadingListener(&listener);
+    ResourceGroupManager::getSingleton().createResourceGroup("EmptyGroup", false);
+
+    MaterialPtr mat = MaterialManager::getSingleton().create("Collision", "EmptyGroup");
+    EXPECT_TRUE(mat);
+    EXPECT_TRUE(MaterialManager::getSingleton().create("Collision", "EmptyGroup"));
+    EXPECT_TRUE(mat->clone("Collision"));
+}
+
+using TextureTests = RootWithoutRenderSystemFixture;
+TEST_F(TextureTests, Blank)
+{
+    auto mat = std::make_shared<Material>(nullptr, "Material Name", 0, "Group");
+    auto tus = mat->createTechnique()->createPass()->createTextureUnitState();
+
+    EXPECT_EQ(tus->isBlank(), true);
+    EXPECT_EQ(tus->getTextureName(), "");
+    EXPECT_EQ(tus->getTextureType(), TextureType::_2D);
+    EXPECT_EQ(tus->getNumMipmaps(), TextureMipmap::DEFAULT);
+    EXPECT_EQ(tus->getDesiredFormat(), PixelFormat::UNKNOWN);
+    EXPECT_EQ(tus->getFrameTextureName(0), "");
+    EXPECT_EQ(tus->getGamma(), 1.0f);
+    EXPECT_EQ(tus->isHardwareGammaEnabled(), false);
+}
+TEST_F(TextureTests, SizeIncludesMipChainAndFSAA)
+{
+    DefaultTextureManager texMgr;
+
+    auto loadedSize = [&](std::string_view name, uint32 size, TextureMipmap mips, uint fsaa, TextureType type)
+    {
+        TexturePtr tex = texMgr.create(name, RGN_DEFAULT);
+        // render targets are not read from a file
+        tex->setUsage(TextureUsage::RENDERTARGET);
+        tex->setTextureType(type);
+        tex->setWidth(size);
+        tex->setHeight(size);
+        tex->setFormat(PixelFormat::BYTE_RGBA);
+        tex->setNumMipmaps(mips);
+        tex->setFSAA(fsaa, "");
+        tex->load();
+        return tex->getSize();
+    };
+
+    EXPECT_EQ(loadedSize("Plain", 64, TextureMipmap{}, 0, TextureType::_2D), 64u * 64 * 4);
+    EXPECT_EQ(loadedSize("Mipped", 64, TextureMipmap{2}, 0, TextureType::_2D), (64u * 64 + 32 * 32 + 16 * 16) * 4);
+    // more mipmaps than the texture has levels count as the full chain
+    EXPECT_EQ(loadedSize("FullChain", 4, TextureMipmap{10}, 0, TextureType::_2D), (4u * 4 + 2 * 2 + 1) * 4);
+    EXPECT_EQ(loadedSize("Cube", 4, TextureMipmap{}, 0, TextureType::CUBE_MAP), 6u * 4 * 4 * 4);
+    // the multisampled surface holds the top level only, once per sample
+    EXPECT_EQ(loadedSize("Multisampled", 64, TextureMipmap{2}, 4, TextureType::_2D),
+              (64u * 64 + 32 * 32 + 16 * 16) * 4 + 4 * 64 * 64 * 4);
+    EXPECT_EQ(texMgr.getMemoryUsage(), 64u * 64 * 4 + 2 * (64 * 64 + 32 * 32 + 16 * 16) * 4 + (4 * 4 + 2 * 2 + 1) * 4 +
+                                           6 * 4 * 4 * 4 + 4 * 64 * 64 * 4);
+}
+TEST_F(TextureTests, BudgetUnloadsLeastRecentlyUsed)
+{
+    DefaultTextureManager texMgr;
+    const size_t textureSize = 64 * 64 * 4;
+
+    auto load = [&](std::string_view name)
+    {
+        // no reference is kept, so the texture can be unloaded
+        TexturePtr tex = texMgr.create(name, RGN_DEFAULT);
+        tex->setUsage(TextureUsage::RENDERTARGET);
+        tex->setWidth(64);
+        tex->setHeight(64);
+        tex->setFormat(PixelFormat::BYTE_RGBA);
+        tex->touch();
+    };
+    auto touch = [&](std::string_view name) { texMgr.getByName(name)->touch(); };
+    auto isLoaded = [&](std::string_view name) { return texMgr.getByName(name)->isLoaded(); };
+
+    // frame 1
+    mRoot->_fireFrameRenderingQueued();
+    for (auto name : {"A", "B", "C", "D", "E"})
+        load(name);
+    // frame 2
+    mRoot->_fireFrameRenderingQueued();
+    touch("B");
+    touch("C");
+    // frame 3
+    mRoot->_fireFrameRenderingQueued();
+    touch("C");
+    touch("E");
+    // frame 4
+    mRoot->_fireFrameRenderingQueued();
+    touch("D");
+    EXPECT_EQ(texMgr.getMemoryUsage(), 5 * textureSize);
+
+    // A and B are the least recently used, C must stay to get within the budget
+    texMgr.setMemoryBudget(3 * textureSize);
+    EXPECT_FALSE(isLoaded("A"));
+    EXPECT_FALSE(isLoaded("B"));
+    EXPECT_TRUE(isLoaded("C"));
+    EXPECT_TRUE(isLoaded("D"));
+    EXPECT_TRUE(isLoaded("E"));
+    EXPECT_EQ(texMgr.getMemoryUsage(), 3 * textureSize);
+
+    // referenced textures are never unloaded, however old
+    TexturePtr held = texMgr.getByName("C");
+    texMgr.setMemoryBudget(2 * textureSize);
+    EXPECT_TRUE(isLoaded("C"));
+    // E was used in the previous frame, D in the current one
+    EXPECT_TRUE(isLoaded("D"));
+    EXPECT_TRUE(isLoaded("E"));
+    EXPECT_EQ(texMgr.getMemoryUsage(), 3 * textureSize);
+
+    // C is the only one not used in the last two frames
+    held.reset();
+    mRoot->_fireFrameRenderingQueued();
+    touch("D");
+    touch("E");
+    texMgr.setMemoryBudget(2 * textureSize);
+    EXPECT_FALSE(isLoaded("C"));
+    EXPECT_TRUE(isLoaded("D"));
+    EXPECT_TRUE(isLoaded("E"));
+    EXPECT_EQ(texMgr.getMemoryUsage(), 2 * textureSize);
+
+    // E is unloaded once it is older than the previous frame
+    for (bool expectLoaded : {true, false})
+    {
+        mRoot->_fireFrameRenderingQueued();
+        touch("D");
+        texMgr.setMemoryBudget(textureSize);
+        EXPECT_EQ(isLoaded("E"), expectLoaded);
+        EXPECT_TRUE(isLoaded("D"));
+    }
+    EXPECT_EQ(texMgr.getMemoryUsage(), textureSize);
+}
+using TextureArrayPackerTests = RootWithoutRenderSystemFixture;
+TEST_F(TextureArrayPackerTests, MergesMaterialsDifferingInTextures)
+{
+    DefaultTextureManager texMgr;
+
+    auto createMaterial = [&](std::string_view name, std::string_view texture, uint32 size)
+    {
+        TexturePtr tex = texMgr.create(texture, RGN_DEFAULT, true);
+        tex->setWidth(size);
+        tex->setHeight(size);
+        tex->load();
+
+        MaterialPtr mat = MaterialManager::getSingleton().create(name, RGN_DEFAULT);
+        Pass* pass = mat->getTechnique(0)->getPass(0);
+        pass->createTextureUnitState(texture);
+        pass->createTextureUnitState("Shared");
+        return mat;
+    };
+    texMgr.create("Shared", RGN_DEFAULT, true)->load();
+
+    TextureArrayPacker packer{3};
+    packer.addMaterial(createMaterial("A", "a.png", 64));
+    packer.addMaterial(createMaterial("B", "b.png", 64));
+    packer.addMaterial(createMaterial("C", "c.png", 64));
+    // another size, and another blend mode
+    packer.addMaterial(createMaterial("D", "d.png", 32));
+    MaterialPtr blended = createMaterial("E", "e.png", 64);
+    blended->setSceneBlending(SceneBlendType::ADD);
+    packer.addMaterial(blended);
+
+    EXPECT_EQ(packer.pack(), 3u);
+    EXPECT_FALSE(packer.getPackedMaterial("D"));
+    EXPECT_FALSE(packer.getPackedMaterial("E"));
+
+    MaterialPtr packed = packer.getPackedMaterial("A");
+    ASSERT_TRUE(packed);
+    EXPECT_EQ(packer.getPackedMaterial("C"), packed);
+    EXPECT_EQ(packer.getLayer("A"), 0u);
+    EXPECT_EQ(packer.getLayer("B"), 1u);
+    EXPECT_EQ(packer.getLayer("C"), 2u);
+
+    Pass* pass = packed->getTechnique(0)->getPass(0);
+    EXPECT_EQ(pass->getTextureUnitState(0)->getTextureType(), TextureType::_2D_ARRAY);
+    EXPECT_EQ(pass->getTextureUnitState(1)->getTextureType(), TextureType::_2D);
+    EXPECT_EQ(pass->getTextureUnitState(1)->getTextureName(), "Shared");
+}
+using SceneSerializerTests = RootWithoutRenderSystemFixture;
+TEST_F(SceneSerializerTests, RoundTrip)
+{
+    SceneManager* sm = mRoot->createSceneManager();
+    MaterialPtr red = MaterialManager::getSingleton().create("Red", RGN_DEFAULT);
+
+    SceneNode* parent = sm->getRootSceneNode()->createChildSceneNode("Parent", Vector3(1, 2, 3));
+    SceneNode* child = parent->createChildSceneNode(Vector3(0, 5, 0), Quaternion(Degree(90), Vector3::UNIT_Y));
+    child->setScale(2, 2, 2);
+    child->setInheritScale(false);
+
+    Entity* ent = sm->createEntity("Ball", "sphere.mesh");
+    ent->setMaterial(red);
+    ent->setCastShadows(false);
+    ent->setQueryFlags(QueryTypeMask{0x10});
+    child->attachObject(ent);
+
+    Light* light = sm->createLight("Sun", Light::LightTypes::SPOTLIGHT);
+    light->setDiffuseColour(ColourValue(1, 0.5, 0.25));
+    light->setAttenuation(100, 1, 0.5, 0.25);
+    parent->attachObject(light);
+
+    StaticGeometry* geom = sm->createStaticGeometry("Rocks");
+    geom->setRegionDimensions(Vector3(50, 50, 50));
+    geom->addEntity(sm->createEntity("sphere.mesh"), Vector3(10, 0, 0));
+
+    auto stream = std::make_shared<MemoryDataStream>(4096, true, false);
+    SceneSerializer{}.exportScene(sm, stream);
+    sm->clearScene();
+    stream->seek(0);
+    SceneSerializer{}.importScene(stream, sm);
+
+    parent = sm->getSceneNode("Parent");
+    EXPECT_EQ(parent->getPosition(), Vector3(1, 2, 3));
+    ASSERT_EQ(parent->getChildren().size(), 1u);
+    child = static_cast<SceneNode*>(parent->getChildren()[0]);
+    EXPECT_EQ(child->getPosition(), Vector3(0, 5, 0));
+    EXPECT_EQ(child->getScale(), Vector3(2, 2, 2));
+    EXPECT_FALSE(child->getInheritScale());
+
+    ent = sm->getEntity("Ball");
+    EXPECT_EQ(ent->getParentSceneNode(), child);
+    EXPECT_EQ(ent->getSubEntity(0)->getMaterial(), red);
+    EXPECT_FALSE(ent->getCastShadows());
+    EXPECT_EQ(ent->getQueryFlags(), QueryTypeMask{0x10});
+
+    light = sm->getLight("Sun");
+    EXPECT_EQ(light->getParentSceneNode(), parent);
+    EXPECT_EQ(light->getType(), Light::LightTypes::SPOTLIGHT);
+    EXPECT_EQ(light->getDiffuseColour(), ColourValue(1, 0.5, 0.25));
+    EXPECT_EQ(light->getAttenuationRange(), 100);
+
+    geom = sm->getStaticGeometry("Rocks");
+    EXPECT_EQ(geom->getRegionDimensions(), Vector3(50, 50, 50));
+    ASSERT_EQ(geom->getQueuedSubMeshes().size(), 1u);
+    EXPECT_EQ(geom->getQueuedSubMeshes()[0]->position, Vector3(10, 0, 0));
+    EXPECT_FALSE(geom->isBuilt());
+}
+using ConcurrentSceneTests = RootWithoutRenderSystemFixture;
+TEST_F(ConcurrentSceneTests, IndependentSceneManagers)
+{
+    MeshManager::getSingleton().load("sphere.mesh", RGN_DEFAULT);
+    std::vector<SceneManager*> scenes;
+    for (int t = 0; t < 4; ++t)
+        scenes.push_back(mRoot->createSceneManager());
+
+    std::atomic<int> created{0};
+    std::vector<size_t> hits(scenes.size());
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < scenes.size(); ++t)
+        threads.emplace_back([&, t] {
+            SceneManager* sm = scenes[t];
+            for (int i = 0; i < 50; ++i)
+            {
+                Entity* ent = sm->createEntity("sphere.mesh");
+                sm->getRootSceneNode()->createChildSceneNode(Vector3(Real(i) * 200, 0, 0))->attachObject(ent);
+
+                MaterialManager::getSingleton().create(std::format("Scene{}/{}", t, i), RGN_DEFAULT);
+                if (MaterialManager::getSingleton().createOrRetrieve("Shared", RGN_DEFAULT).second)
+                    ++created;
+            }
+            sm->_updateSceneGraph(nullptr);
+            auto rayQuery = sm->createRayQuery(Ray(Vector3(-500, 0, 0), Vector3::UNIT_X));
+            hits[t] = rayQuery->execute().size();
+        });
+    for (auto& thread : threads)
+        thread.join();
+
+    EXPECT_EQ(created, 1);
+    for (size_t t = 0; t < scenes.size(); ++t)
+    {
+        EXPECT_EQ(hits[t], 50u);
+        EXPECT_TRUE(MaterialManager::getSingleton().resourceExists(std::format("Scene{}/49", t), RGN_DEFAULT));
+        mRoot->destroySceneManager(scenes[t]);
+    }
+}
+using CompositorTests = RootWithoutRenderSystemFixture;
+TEST_F(CompositorTests, TextureLifetimes)
+{
+    auto opaque = std::make_shared<Material>(nullptr, "Opaque", 0, "Group");
+    opaque->createTechnique()->createPass();
+    auto blended = std::make_shared<Material>(nullptr, "Blended", 0, "Group");
+    blended->createTechnique()->createPass()->setSceneBlending(SceneBlendType::TRANSPARENT_ALPHA);
+
+    CompositionTechnique tech{nullptr};
+    auto addTarget = [&](std::string_view output, std::string_view input, const MaterialPtr& mat)
+    {
+        auto tp = tech.createTargetPass();
+        tp->setOutputName(output);
+        auto pass = tp->createPass();
+        pass->setMaterial(mat);
+        if (!input.empty())
+            pass->setInput(0, input);
+        return tp;
+    };
+
+    addTarget("a", "", opaque);
+    addTarget("b", "a", opaque);
+    auto tp = tech.createTargetPass();
+    tp->setOutputName("c");
+    tp->createPass(CompositionPass::PassType::CLEAR);
+    auto pass = tp->createPass();
+    pass->setMaterial(blended);
+    pass->setInput(0, "b");
+    addTarget("d", "", blended);
+    auto out = tech.getOutputTargetPass()->createPass();
+    out->setMaterial(opaque);
+    out->setInput(0, "c");
+
+    auto lifetimes = tech.computeTextureLifetimes();
+    ASSERT_EQ(lifetimes.size(), 4u);
+    EXPECT_EQ(lifetimes["a"].firstUse, 0u);
+    EXPECT_EQ(lifetimes["a"].lastUse, 1u);
+    EXPECT_EQ(lifetimes["b"].firstUse, 1u);
+    EXPECT_EQ(lifetimes["b"].lastUse, 2u);
+    EXPECT_EQ(lifetimes["c"].firstUse, 2u);
+    EXPECT_EQ(lifetimes["c"].lastUse, 4u);
+    EXPECT_FALSE(lifetimes["a"].persistent);
+    EXPECT_FALSE(lifetimes["b"].persistent);
+    // cleared first, so the blended quad does not observe old contents
+    EXPECT_FALSE(lifetimes["c"].persistent);
+    // blending over the previous frame
+    EXPECT_TRUE(lifetimes["d"].persistent);
+
+    // read before being written
+    tech.getTargetPass(0)->getPasses()[0]->setInput(1, "d");
+    EXPECT_TRUE(tech.computeTextureLifetimes()["d"].persistent);
+
+    tech.getTargetPass(1)->createPass(CompositionPass::PassType::COMPUTE);
+    for (const auto& [name, lifetime] : tech.computeTextureLifetimes())
+        EXPECT_TRUE(lifetime.persistent) << name;
+}
+TEST(CompositorChain, CullUnusedOperations)
+{
+    auto op = [](std::vector<ResourceHandle> writes, std::vector<ResourceHandle> reads)
+    {
+        CompositorInstance::TargetOperation ret(nullptr);
+        ret.writes = std::move(writes);
+        ret.reads = std::move(reads);
+        return ret;
+    };
 
-    MaterialPtr mat = MaterialManager::getSingleton().create("Collision", "EmptyGroup");
-    EXPECT_TRUE(mat);
-    EXPECT_TRUE(MaterialManager::getSingleton().create("Collision", "EmptyGroup"));
-    EXPECT_TRUE(mat->clone("Collision"));
+    // 1 -> 2 -> output, 3 is never sampled, 4 only by 3
+    CompositorInstance::CompiledState ops{op({1}, {}), op({4}, {}), op({2}, {1}), op({3}, {4})};
+    auto output = op({}, {2});
+    auto culled = ops;
+    EXPECT_EQ(CompositorChain::_cullUnusedOperations(culled, output), 2u);
+    ASSERT_EQ(culled.size(), 2u);
+    EXPECT_EQ(culled[0].writes[0], 1u);
+    EXPECT_EQ(culled[1].writes[0], 2u);
+
+    // sampled in the next frame
+    culled = ops;
+    culled[0].reads.push_back(3);
+    EXPECT_EQ(CompositorChain::_cullUnusedOperations(culled, output), 0u);
+
+    // everything before may be sampled by the scene
+    culled = ops;
+    culled[2].readsAnything = true;
+    EXPECT_EQ(CompositorChain::_cullUnusedOperations(culled, output), 1u);
+    EXPECT_EQ(culled.back().writes[0], 2u);
+
+    culled = ops;
+    culled[3].keepAlive = true;
+    EXPECT_EQ(CompositorChain::_cullUnusedOperations(culled, output), 0u);
 }
+TEST(CompositorChain, ResolutionScale)
+{
+    // on target, and too fast at full resolution
+    EXPECT_EQ(CompositorChain::_computeResolutionScale(0.8f, 16, 16, 0.5f), 0.8f);
+    EXPECT_EQ(CompositorChain::_computeResolutionScale(1, 8, 16, 0.5f), 1);
 
-using TextureTests = RootWithoutRenderSystemFixture;
-TEST_F(TextureTests, Blank)
+    // twice the time takes half the pixels, approached in steps
+    Real scale = 1;
+    for (int i = 0; i < 100; i++)
+        scale = CompositorChain::_computeResolutionScale(scale, 32 * scale * scale, 16, 0.5f);
+    EXPECT_NEAR(scale, std::sqrt(0.5f), 0.05f);
+
+    EXPECT_EQ(CompositorChain::_computeResolutionScale(0.5f, 100, 16, 0.5f), 0.5f);
+}
+TEST(Sampler, Hash)
 {
-    auto mat = std::make_shared<Material>(nullptr, "Material Name", 0, "Group");
-    auto tus = mat->createTechnique()->createPass()->createTextureUnitState();
+    Sampler a, b;
+    EXPECT_NE(a.getHash(), 0u);
+    EXPECT_EQ(a.getHash(), b.getHash());
 
-    EXPECT_EQ(tus->isBlank(), true);
-    EXPECT_EQ(tus->getTextureName(), "");
-    EXPECT_EQ(tus->getTextureType(), TextureType::_2D);
-    EXPECT_EQ(tus->getNumMipmaps(), TextureMipmap::DEFAULT);
-    EXPECT_EQ(tus->getDesiredFormat(), PixelFormat::UNKNOWN);
-    EXPECT_EQ(tus->getFrameTextureName(0), "");
-    EXPECT_EQ(tus->getGamma(), 1.0f);
-    EXPECT_EQ(tus->isHardwareGammaEnabled(), false);
+    b.setFiltering(TextureFilterOptions::TRILINEAR);
+    EXPECT_NE(a.getHash(), b.getHash());
+    a.setFiltering(TextureFilterOptions::TRILINEAR);
+    EXPECT_EQ(a.getHash(), b.getHash());
+
+    b.setAddressingMode(TextureAddressingMode::CLAMP);
+    EXPECT_NE(a.getHash(), b.getHash());
 }
 TEST(GpuSharedParameters, align)
 {
@@ -358,6 +2517,243 @@ TEST(GpuSharedParameters, align)
     EXPECT_EQ(params.getConstantDefinition("d").logicalIndex, 48uz);
 }
 
+TEST(GpuSharedParameters, BufferLayout)
+{
+    Root root("");
+    GpuSharedParameters params("dummy");
+    params.addConstantDefinition("a", GpuConstantType::FLOAT1);
+    params.addConstantDefinition("b", GpuConstantType::FLOAT3);
+    params.addConstantDefinition("m", GpuConstantType::MATRIX_4X4);
+    params.addConstantDefinition("arr", GpuConstantType::FLOAT2, 2);
+
+    using Copies = GpuConstantBufferLayout::CopyList;
+    // array elements are padded to a vec4 in std140, the matrix is a single copy
+    const auto& layout = params.getBufferLayout();
+    EXPECT_EQ(layout.bufferSize, 128uz);
+    EXPECT_EQ(layout.copies, (Copies{{0, 0, 4}, {4, 16, 12}, {16, 32, 64}, {80, 96, 8}, {88, 112, 8}}));
+
+    auto packed = GpuConstantBufferLayout::build(params.getConstantDefinitions(),
+                                                 GpuConstantBufferLayout::Packing::STD430);
+    EXPECT_EQ(packed.bufferSize, 112uz);
+    EXPECT_EQ(packed.copies, (Copies{{0, 0, 4}, {4, 16, 12}, {16, 32, 64}, {80, 96, 16}}));
+
+    float arr[] = {1, 2, 3, 4};
+    params.setNamedConstant("arr", arr, 4);
+    std::vector<float> buffer(layout.bufferSize / sizeof(float));
+    layout.pack(params.getConstantList(), buffer.data());
+    EXPECT_EQ(buffer[24], 1.0f);
+    EXPECT_EQ(buffer[28], 3.0f);
+
+    // the layout follows the definitions
+    params.removeAllConstantDefinitions();
+    EXPECT_TRUE(params.getBufferLayout().copies.empty());
+}
+
+namespace {
+    /// A vertex buffer shadowing a system memory buffer, as a render system would a hardware one
+    struct ShadowedVertexBuffer : public HardwareVertexBuffer
+    {
+        ShadowedVertexBuffer(HardwareBufferManagerBase* mgr, size_t numVertices)
+            : HardwareVertexBuffer(mgr, sizeof(float), numVertices, HardwareBufferUsage::GPU_TO_CPU, false, true)
+        {
+            mDelegate = std::make_unique<DefaultHardwareBuffer>(mSizeInBytes);
+        }
+    };
+}
+
+TEST(HardwareBufferTests, DiscardStaticShadowBuffers)
+{
+    DefaultHardwareBufferManagerBase mgr;
+    mgr.setDiscardStaticShadowBuffers(true);
+    size_t resident = HardwareBufferManagerBase::getShadowBufferBytes();
+    {
+        ShadowedVertexBuffer buffer{&mgr, 16};
+        EXPECT_EQ(HardwareBufferManagerBase::getShadowBufferBytes(), resident + 64);
+
+        std::vector<float> data(16);
+        for (size_t i = 0; i < data.size(); ++i)
+            data[i] = float(i);
+        buffer.writeData(0, 64, data.data());
+        EXPECT_TRUE(buffer.isShadowBufferDiscarded());
+        EXPECT_TRUE(buffer.hasShadowBuffer());
+        EXPECT_EQ(HardwareBufferManagerBase::getShadowBufferBytes(), resident);
+
+        // read back for the duration of the lock
+        {
+            HardwareBufferLockGuard lock(&buffer, HardwareBuffer::LockOptions::READ_ONLY);
+            EXPECT_EQ(HardwareBufferManagerBase::getShadowBufferBytes(), resident + 64);
+            EXPECT_EQ(memcmp(lock.pData, data.data(), 64), 0);
+        }
+        EXPECT_EQ(HardwareBufferManagerBase::getShadowBufferBytes(), resident);
+
+        // a partial write keeps the rest
+        {
+            HardwareBufferLockGuard lock(&buffer, 0, sizeof(float), HardwareBuffer::LockOptions::WRITE_ONLY);
+            *static_cast<float*>(lock.pData) = 42;
+        }
+        data[0] = 42;
+        std::vector<float> readBack(16);
+        buffer.readData(0, 64, readBack.data());
+        EXPECT_EQ(readBack, data);
+        EXPECT_TRUE(buffer.isShadowBufferDiscarded());
+    }
+    EXPECT_EQ(HardwareBufferManagerBase::getShadowBufferBytes(), resident);
+}
+
+TEST(GpuSharedParameters, CopiedOnlyWhenChanged)
+{
+    Root root("");
+    auto shared = std::make_shared<GpuSharedParameters>("shared");
+    shared->addConstantDefinition("a", GpuConstantType::FLOAT4);
+
+    // a program using the same definition
+    auto constants = std::make_shared<GpuNamedConstants>(shared->getConstantDefinitions());
+    constants->bufferSize = 4;
+    auto params = std::make_shared<GpuProgramParameters>();
+    params->_setNamedConstants(constants);
+    params->addSharedParameters(shared);
+
+    shared->setNamedConstant("a", Vector4{1, 2, 3, 4});
+    params->_copySharedParams();
+    float* a = params->getFloatPointer(params->getConstantDefinition("a").physicalIndex);
+    EXPECT_EQ(a[3], 4.0f);
+
+    // unchanged values are not copied again
+    a[3] = 0;
+    params->_copySharedParams();
+    EXPECT_EQ(a[3], 0.0f);
+
+    shared->setNamedConstant("a", Vector4{5, 6, 7, 8});
+    params->_copySharedParams();
+    EXPECT_EQ(a[3], 8.0f);
+}
+TEST(GpuProgramParameters, AutoParamsSkippedWhenSourcesUnchanged)
+{
+    Root root("");
+    GpuSharedParameters definitions("definitions");
+    definitions.addConstantDefinition("diffuse", GpuConstantType::FLOAT4);
+    auto constants = std::make_shared<GpuNamedConstants>(definitions.getConstantDefinitions());
+    constants->bufferSize = 4;
+
+    auto params = std::make_shared<GpuProgramParameters>();
+    params->_setNamedConstants(constants);
+    params->setNamedAutoConstant("diffuse", GpuProgramParameters::AutoConstantType::SURFACE_DIFFUSE_COLOUR);
+    float* diffuse = params->getFloatPointer(params->getConstantDefinition("diffuse").physicalIndex);
+
+    auto mat = std::make_shared<Material>(nullptr, "Material Name", 0, "Group");
+    auto pass = mat->createTechnique()->createPass();
+    pass->setDiffuse(ColourValue{1, 2, 3, 4});
+
+    AutoParamDataSource source;
+    source.setCurrentPass(pass);
+    params->_updateAutoParams(&source, GpuParamVariability::GLOBAL);
+    EXPECT_EQ(diffuse[3], 4.0f);
+
+    // the renderable is no source of the surface colour
+    diffuse[3] = 0;
+    source.setCurrentRenderable(nullptr);
+    params->_updateAutoParams(&source, GpuParamVariability::GLOBAL);
+    EXPECT_EQ(diffuse[3], 0.0f);
+
+    source.setPassNumber(0);
+    params->_updateAutoParams(&source, GpuParamVariability::GLOBAL);
+    EXPECT_EQ(diffuse[3], 4.0f);
+    EXPECT_EQ(source._takeAutoConstantCounts(), std::make_pair(2uz, 1uz));
+
+    // versions of another source are not comparable
+    diffuse[3] = 0;
+    AutoParamDataSource otherSource;
+    otherSource.setCurrentPass(pass);
+    params->_updateAutoParams(&otherSource, GpuParamVariability::GLOBAL);
+    EXPECT_EQ(diffuse[3], 4.0f);
+}
+
+using AutoParamDataSourceTest = RootWithoutRenderSystemFixture;
+TEST_F(AutoParamDataSourceTest, DerivedMatricesMatchPerRenderable)
+{
+    SceneManager* sm = mRoot->createSceneManager();
+    Camera* cam = sm->createCamera("Camera");
+    SceneNode* camNode = sm->getRootSceneNode()->createChildSceneNode(Vector3{10, 20, 500});
+    camNode->attachObject(cam);
+    camNode->lookAt(Vector3{0, 0, 0}, Node::TransformSpace::WORLD);
+
+    std::vector<Affine3> worlds;
+    for (int i = 0; i < 5; ++i)
+        worlds.push_back(Affine3::MakeTransform(Vector3(i * 10.0f, -i * 5.0f, 3),
+                                                Quaternion::FromAngleAndAxis(Degree(i * 30.0f), Vector3::UNIT_Y),
+                                                Vector3(1, 2, 1 + i)));
+    std::vector<AutoParamDataSource::DerivedMatrices> derived(worlds.size());
+
+    auto expectNear = [](const TransformBaseReal& a, const TransformBaseReal& b)
+    {
+        for (int r = 0; r < 4; ++r)
+            for (int c = 0; c < 4; ++c)
+                EXPECT_NEAR(a[r][c], b[r][c], 1e-3f);
+    };
+
+    for (bool cameraRelative : {false, true})
+    {
+        AutoParamDataSource source;
+        source.setCurrentCamera(cam, cameraRelative);
+        source.computeDerivedMatrices(worlds, derived);
+
+        for (size_t i = 0; i < worlds.size(); ++i)
+        {
+            Affine3 world = worlds[i];
+            if (cameraRelative)
+                world.setTrans(world.getTrans() - camNode->_getDerivedPosition());
+            source.setWorldMatrices(&world, 1);
+            expectNear(derived[i].worldView, source.getWorldViewMatrix());
+            expectNear(derived[i].worldViewProj, source.getWorldViewProjMatrix());
+            expectNear(derived[i].inverseTransposeWorldView, source.getInverseTransposeWorldViewMatrix());
+        }
+    }
+}
+TEST_F(AutoParamDataSourceTest, LargeWorldRendering)
+{
+    SceneManager* sm = mRoot->createSceneManager();
+    EXPECT_FALSE(sm->getLargeWorldRendering());
+    sm->setLargeWorldRendering(true);
+    EXPECT_TRUE(sm->getCameraRelativeRendering());
+
+    Camera* cam = sm->createCamera("Camera");
+    SceneNode* camNode = sm->getRootSceneNode()->createChildSceneNode();
+    camNode->setPositionDouble({1e7, 0.0, -3e7});
+    camNode->attachObject(cam);
+
+    // single precision positions are a whole unit apart out there
+    SceneNode* node = sm->getRootSceneNode()->createChildSceneNode();
+    node->setPositionDouble({1e7 + 0.25, 2.0, -3e7});
+    SceneNode* child = node->createChildSceneNode(Vector3{0.5f, 0, 0});
+    Entity* ent = sm->createEntity("sphere.mesh");
+    child->attachObject(ent);
+    sm->_updateSceneGraph(cam);
+    EXPECT_EQ(child->_getDerivedPositionDouble()[0], 1e7 + 0.75);
+
+    SubEntity* sub = ent->getSubEntity(0);
+    EXPECT_EQ(sub->getWorldTransformNode(), child);
+    Affine3 world;
+    AutoParamDataSource source;
+    source.setCurrentCamera(cam, true, true);
+    sub->getWorldTransforms(reinterpret_cast<Matrix4*>(&world));
+    source.makeCameraRelative(sub, &world, 1);
+    EXPECT_FLOAT_EQ(world.getTrans().x, 0.75f);
+    EXPECT_FLOAT_EQ(world.getTrans().y, 2);
+    EXPECT_FLOAT_EQ(world.getTrans().z, 0);
+
+    // rounded before made relative otherwise
+    source.setCurrentCamera(cam, true);
+    sub->getWorldTransforms(reinterpret_cast<Matrix4*>(&world));
+    source.makeCameraRelative(sub, &world, 1);
+    EXPECT_EQ(world.getTrans().x, std::round(world.getTrans().x));
+
+    // translations accumulate in double precision
+    child->translate(Vector3{0.125f, 0, 0});
+    sm->_updateSceneGraph(cam);
+    EXPECT_EQ(child->_getDerivedPositionDouble()[0], 1e7 + 0.875);
+    EXPECT_EQ(child->getPositionDouble()[0], 0.625);
+}
+
 using HighLevelGpuProgramTest = RootWithoutRenderSystemFixture;
 TEST_F(HighLevelGpuProgramTest, resolveIncludes)
 {
@@ -412,3 +2808,1044 @@ TEST_F(SkeletonTests, linkedSkeletonAnimationSource)
     entity->refreshAvailableAnimationState();
     EXPECT_TRUE(entity->getAnimationState("Stealth")); // animation from ninja.sekeleton
 }
+TEST_F(SkeletonTests, PoseBufferMatchesAnimationApply)
+{
+    auto createSkeleton = [](std::string_view name)
+    {
+        SkeletonPtr skel = SkeletonManager::getSingleton().create(name, RGN_DEFAULT);
+        Bone* root = skel->createBone("root", 0);
+        Bone* child = root->createChild(1, Vector3{0, 1, 0});
+        child->createChild(2, Vector3{0, 1, 0}, Quaternion{Degree{30}, Vector3::UNIT_Z});
+        child->createChild(3, Vector3{1, 0, 0});
+        skel->setBindingPose();
+
+        for (auto [animName, sign] : {std::pair{"walk", 1.0f}, std::pair{"wave", -1.0f}})
+        {
+            Animation* anim = skel->createAnimation(animName, 1);
+            for (unsigned short h = 0; h < 3; ++h)
+            {
+                NodeAnimationTrack* track = anim->createNodeTrack(h, skel->getBone(h));
+                track->createNodeKeyFrame(0);
+                TransformKeyFrame* kf = track->createNodeKeyFrame(1);
+                kf->setTranslate(Vector3{sign * h, 0.5f, 0});
+                kf->setRotation(Quaternion{Degree{sign * 45}, Vector3::UNIT_Y});
+                kf->setScale(Vector3{1, 1 + 0.5f * h, 1});
+            }
+        }
+        return skel;
+    };
+    SkeletonPtr skel = createSkeleton("PoseBuffer");
+    SkeletonPtr ref = createSkeleton("PoseBufferRef");
+
+    AnimationStateSet states;
+    skel->_initAnimationState(&states);
+    AnimationState* walk = states.getAnimationState("walk");
+    AnimationState* wave = states.getAnimationState("wave");
+    walk->setEnabled(true);
+    walk->setWeight(0.8f);
+    walk->setTimePosition(0.25f);
+    wave->setEnabled(true);
+    wave->setWeight(0.7f);
+    wave->setTimePosition(0.6f);
+    wave->createBlendMask(skel->getNumBones());
+    wave->setBlendMaskEntry(1, 0.5f);
+    skel->setAnimationState(states);
+    skel->_updateTransforms();
+
+    // weights are averaged, as they add up to more than 1
+    Real weightFactor = 1 / 1.5f;
+    ref->reset();
+    ref->getAnimation("walk")->apply(ref.get(), 0.25f, 0.8f * weightFactor);
+    ref->getAnimation("wave")->apply(ref.get(), 0.6f, 0.7f * weightFactor, wave->getBlendMask(), 1);
+    ref->getRootBones().front()->_update(true, false);
+
+    for (unsigned short h = 0; h < 4; ++h)
+    {
+        Bone* bone = skel->getBone(h);
+        Bone* refBone = ref->getBone(h);
+        EXPECT_TRUE(bone->getPosition().positionEquals(refBone->getPosition(), 1e-5f));
+        EXPECT_TRUE(bone->getOrientation().equals(refBone->getOrientation(), Radian{1e-5f}));
+        EXPECT_TRUE(bone->getScale().positionEquals(refBone->getScale(), 1e-5f));
+        EXPECT_TRUE(bone->_getDerivedPosition().positionEquals(refBone->_getDerivedPosition(), 1e-5f));
+        EXPECT_TRUE(bone->_getDerivedOrientation().equals(refBone->_getDerivedOrientation(), Radian{1e-5f}));
+        EXPECT_TRUE(bone->_getDerivedScale().positionEquals(refBone->_getDerivedScale(), 1e-5f));
+    }
+}
+TEST_F(SkeletonTests, AnimationLodThrottlesUpdates)
+{
+    auto sceneMgr = mRoot->createSceneManager();
+    auto camera = sceneMgr->createCamera("Camera");
+    sceneMgr->getRootSceneNode()->createChildSceneNode()->attachObject(camera);
+
+    auto entity = sceneMgr->createEntity("jaiqua.mesh");
+    SceneNode* node = sceneMgr->getRootSceneNode()->createChildSceneNode(Vector3{0, 0, -1000});
+    node->attachObject(entity);
+    sceneMgr->_updateSceneGraph(camera);
+
+    AnimationState* state = entity->getAllAnimationStates()->getAnimationStates().begin()->second;
+    state->setEnabled(true);
+
+    entity->setAnimationLodLevels({{.userValue = 500, .updateInterval = 4}});
+    entity->_notifyCurrentCamera(camera);
+    EXPECT_EQ(entity->getCurrentAnimationLodIndex(), 1);
+
+    std::vector<bool> updated;
+    for (int frame = 0; frame < 8; ++frame)
+    {
+        state->addTime(0.05f);
+        updated.push_back(entity->_updateBoneMatrices());
+        mRoot->_fireFrameRenderingQueued();
+    }
+    EXPECT_EQ(updated, (std::vector<bool>{true, false, false, false, true, false, false, false}));
+
+    // interpolated frames in between
+    entity->setAnimationLodInterpolation(true);
+    for (int frame = 0; frame < 4; ++frame)
+    {
+        state->addTime(0.05f);
+        EXPECT_TRUE(entity->_updateBoneMatrices());
+        mRoot->_fireFrameRenderingQueued();
+    }
+
+    // close to the camera the skeleton is evaluated every frame
+    node->setPosition(0, 0, -100);
+    sceneMgr->_updateSceneGraph(camera);
+    mRoot->_fireFrameRenderingQueued();
+    entity->_notifyCurrentCamera(camera);
+    EXPECT_EQ(entity->getCurrentAnimationLodIndex(), 0);
+    EXPECT_TRUE(entity->_updateBoneMatrices());
+}
+TEST_F(SkeletonTests, PoseCacheSharesBoneMatrices)
+{
+    auto sceneMgr = mRoot->createSceneManager();
+    sceneMgr->setSkeletonPoseSharing(true);
+    SkeletonPoseCache* cache = sceneMgr->getSkeletonPoseCache();
+    ASSERT_TRUE(cache);
+
+    std::vector<Entity*> entities;
+    for (int i = 0; i < 3; ++i)
+    {
+        auto entity = sceneMgr->createEntity("jaiqua.mesh");
+        AnimationState* state = entity->getAllAnimationStates()->getAnimationStates().begin()->second;
+        state->setEnabled(true);
+        // the last one is just outside the time step
+        state->setTimePosition(i < 2 ? 0.5f : 0.5f + 2 * cache->getTimeStep());
+        entities.push_back(entity);
+    }
+
+    for (auto entity : entities)
+        EXPECT_TRUE(entity->_updateBoneMatrices());
+    EXPECT_EQ(cache->getNumPoses(), 2u);
+    EXPECT_EQ(cache->getStatistics().hits, 1u);
+    EXPECT_EQ(cache->getStatistics().misses, 2u);
+
+    // the shared palette is the one the skeleton evaluates to
+    std::vector<Affine3> shared{entities[1]->_getBoneMatrices(),
+                                entities[1]->_getBoneMatrices() + entities[1]->_getNumBoneMatrices()};
+    sceneMgr->setSkeletonPoseSharing(false);
+    mRoot->_fireFrameRenderingQueued();
+    EXPECT_TRUE(entities[1]->_updateBoneMatrices());
+    for (size_t b = 0; b < shared.size(); ++b)
+        EXPECT_EQ(shared[b], entities[1]->_getBoneMatrices()[b]);
+}
+TEST_F(SkeletonTests, SoftwareVertexBlendInRanges)
+{
+    // several blocks, so the blend is split into vertex ranges
+    const size_t numVertices = 5000;
+    auto& hbm = HardwareBufferManager::getSingleton();
+
+    VertexData source;
+    source.vertexCount = numVertices;
+    source.vertexDeclaration->addElement(0, 0, VertexElementType::FLOAT3, VertexElementSemantic::POSITION);
+    source.vertexDeclaration->addElement(1, 0, VertexElementType::UBYTE4, VertexElementSemantic::BLEND_INDICES);
+    source.vertexDeclaration->addElement(1, 4, VertexElementType::FLOAT2, VertexElementSemantic::BLEND_WEIGHTS);
+    auto posBuf = hbm.createVertexBuffer(sizeof(float) * 3, numVertices, HardwareBuffer::STATIC, true);
+    auto blendBuf = hbm.createVertexBuffer(4 + sizeof(float) * 2, numVertices, HardwareBuffer::STATIC, true);
+    source.vertexBufferBinding->setBinding(0, posBuf);
+    source.vertexBufferBinding->setBinding(1, blendBuf);
+    {
+        HardwareBufferLockGuard posLock(posBuf, HardwareBuffer::LockOptions::DISCARD);
+        HardwareBufferLockGuard blendLock(blendBuf, HardwareBuffer::LockOptions::DISCARD);
+        auto* pos = static_cast<float*>(posLock.pData);
+        auto* blend = static_cast<uint8*>(blendLock.pData);
+        for (size_t i = 0; i < numVertices; ++i)
+        {
+            pos[i * 3 + 0] = float(i); pos[i * 3 + 1] = 0; pos[i * 3 + 2] = 0;
+            uint8* v = blend + i * blendBuf->getVertexSize();
+            v[0] = 0; v[1] = 1; v[2] = 0; v[3] = 0;
+            float weights[2] = {0.75f, 0.25f};
+            memcpy(v + 4, weights, sizeof(weights));
+        }
+    }
+
+    VertexData target;
+    target.vertexCount = numVertices;
+    target.vertexDeclaration->addElement(0, 0, VertexElementType::FLOAT3, VertexElementSemantic::POSITION);
+    auto destBuf = hbm.createVertexBuffer(sizeof(float) * 3, numVertices, HardwareBuffer::DYNAMIC, true);
+    target.vertexBufferBinding->setBinding(0, destBuf);
+
+    // blend matrices must be SIMD aligned
+    alignas(16) Affine3 m0 = Affine3::IDENTITY;
+    alignas(16) Affine3 m1 = Affine3::IDENTITY;
+    m0.setTrans(Vector3{1, 0, 0});
+    m1.setTrans(Vector3{0, 4, 0});
+    const Affine3* matrices[] = {&m0, &m1};
+    Mesh::softwareVertexBlend(&source, &target, matrices, 2, false);
+
+    HardwareBufferLockGuard destLock(destBuf, HardwareBuffer::LockOptions::READ_ONLY);
+    auto* dest = static_cast<float*>(destLock.pData);
+    for (size_t i = 0; i < numVertices; ++i)
+    {
+        ASSERT_FLOAT_EQ(dest[i * 3 + 0], float(i) + 0.75f);
+        ASSERT_FLOAT_EQ(dest[i * 3 + 1], 1.0f);
+        ASSERT_FLOAT_EQ(dest[i * 3 + 2], 0.0f);
+    }
+}
+TEST_F(SkeletonTests, SkinningCacheFallsBackToSoftware)
+{
+    auto sceneMgr = mRoot->createSceneManager();
+    auto entity = sceneMgr->createEntity("jaiqua.mesh");
+    sceneMgr->getRootSceneNode()->attachObject(entity);
+
+    AnimationState* state = entity->getAllAnimationStates()->getAnimationStates().begin()->second;
+    state->setEnabled(true);
+    state->addTime(0.05f);
+
+    // without render to vertex buffer support the vertices are blended in software
+    entity->setSkinningCacheMaterialName("BaseWhite");
+    EXPECT_EQ(entity->getSkinningCacheMaterialName(), "BaseWhite");
+    entity->_updateAnimation();
+    EXPECT_FALSE(entity->isSkinningCacheActive());
+
+    SubEntity* sub = entity->getSubEntity(0);
+    VertexData* blended = sub->getSubMesh()->useSharedVertices ? entity->_getSkelAnimVertexData()
+                                                                : sub->_getSkelAnimVertexData();
+    EXPECT_EQ(sub->getVertexDataForBinding(), blended);
+}
+TEST_F(SceneQueryTest, StaticGeometryIncrementalAndStreamed)
+{
+    Entity* ent = mSceneMgr->getEntity("501");
+
+    StaticGeometry* geom = mSceneMgr->createStaticGeometry("static");
+    geom->addEntity(ent, Vector3{0, 0, 0});
+    geom->addEntity(ent, Vector3{10, 0, 0});
+    geom->build();
+    ASSERT_EQ(geom->getRegions().size(), 1u);
+    StaticGeometry::Region* centre = geom->getRegions().begin()->second;
+    EXPECT_TRUE(centre->isBuilt());
+
+    // adding after build only touches the region the entity goes to
+    auto& centreBuckets = centre->getLODBuckets().front()->getMaterialBuckets().begin()->second->getGeometryList();
+    size_t centreVertices = centreBuckets.front()->getVertexData()->vertexCount;
+    geom->addEntity(ent, Vector3{5000, 0, 0});
+    geom->rebuildDirtyRegions();
+    ASSERT_EQ(geom->getRegions().size(), 2u);
+    EXPECT_EQ(centre->getLODBuckets().front()->getMaterialBuckets().begin()->second->getGeometryList().front()
+                  ->getVertexData()->vertexCount, centreVertices);
+    for (auto const& [index, region] : geom->getRegions())
+        EXPECT_TRUE(region->isBuilt());
+
+    geom->setRegionStreamingDistances(1000, 2000);
+    geom->build();
+    for (auto const& [index, region] : geom->getRegions())
+        EXPECT_FALSE(region->isBuilt());
+
+    geom->updateStreaming(Vector3{0, 0, 0});
+    for (auto const& [index, region] : geom->getRegions())
+        EXPECT_EQ(region->isBuilt(), region->getCentre().length() < 1000);
+
+    geom->updateStreaming(Vector3{5000, 0, 0});
+    for (auto const& [index, region] : geom->getRegions())
+        EXPECT_EQ(region->isBuilt(), region->getCentre().length() > 1000);
+
+    mSceneMgr->destroyStaticGeometry(geom);
+}
+TEST_F(SceneQueryTest, StaticGeometryRegionTreeAndFarField)
+{
+    Entity* ent = mSceneMgr->getEntity("501");
+
+    StaticGeometry* geom = mSceneMgr->createStaticGeometry("static");
+    for (int x = 0; x < 6; ++x)
+        for (int z = 0; z < 6; ++z)
+            geom->addEntity(ent, Vector3{x * 1000.0f, 0, z * 1000.0f});
+    geom->setFarFieldDistance(5000);
+    geom->build();
+    ASSERT_EQ(geom->getRegions().size(), 36u);
+    ASSERT_FALSE(geom->getFarFieldRegions().empty());
+
+    // regions hang below a tree of nodes, every one replaced by a far-field region
+    for (auto const& [index, region] : geom->getRegions())
+    {
+        EXPECT_NE(region->getParentSceneNode()->getParent(), mSceneMgr->getRootSceneNode());
+        ASSERT_TRUE(region->getFarField());
+        EXPECT_TRUE(region->getFarField()->isBuilt());
+    }
+
+    auto visibleFrom = [&](const Vector3& position)
+    {
+        mCameraNode->setPosition(position);
+        mCameraNode->_update(true, false);
+        size_t regions = 0, farFields = 0;
+        for (auto const& [index, region] : geom->getRegions())
+        {
+            region->_notifyCurrentCamera(mCamera);
+            regions += region->isVisible();
+        }
+        for (auto farField : geom->getFarFieldRegions())
+        {
+            farField->_notifyCurrentCamera(mCamera);
+            farFields += farField->isVisible();
+        }
+        return std::pair{regions, farFields};
+    };
+
+    EXPECT_EQ(visibleFrom(Vector3{2500, 0, 2500}), std::pair(size_t{36}, size_t{0}));
+    EXPECT_EQ(visibleFrom(Vector3{100000, 0, 0}), std::pair(size_t{0}, geom->getFarFieldRegions().size()));
+
+    mSceneMgr->destroyStaticGeometry(geom);
+}
+TEST(ParticleArrays, GatherScatterAndIntegrate)
+{
+    // odd count, so the SIMD paths also run their leftover loop
+    std::vector<Particle> storage(13);
+    std::vector<Particle*> particles;
+    for (size_t i = 0; i < storage.size(); ++i)
+    {
+        Particle& p = storage[i];
+        p.mPosition = Vector3(i, 2.0f * i, -1.0f * i);
+        p.mDirection = Vector3(1, -0.5f, 0.25f * i);
+        p.mColour = ColourValue(i / 12.0f, 0.5f, 1, 0.25f).getAsBYTE();
+        p.mTimeToLive = 5.0f + i;
+        p.mRotation = Radian(0.1f * i);
+        particles.push_back(&p);
+    }
+    std::vector<Particle> expected = storage;
+
+    ParticleArrays arrays;
+    arrays.gather(particles);
+    ASSERT_EQ(arrays.count, particles.size());
+
+    // gather followed by scatter does not change anything
+    arrays.scatter(particles);
+    for (size_t i = 0; i < storage.size(); ++i)
+    {
+        EXPECT_EQ(storage[i].mColour, expected[i].mColour);
+        EXPECT_EQ(storage[i].mPosition, expected[i].mPosition);
+        EXPECT_EQ(storage[i].mRotation, expected[i].mRotation);
+    }
+
+    OptimisedUtil::getImplementation()->integrateArrays(
+        arrays.positionX.data(), arrays.positionY.data(), arrays.positionZ.data(),
+        arrays.directionX.data(), arrays.directionY.data(), arrays.directionZ.data(),
+        0.5f, arrays.count);
+    arrays.scatter(particles);
+    for (size_t i = 0; i < storage.size(); ++i)
+    {
+        Vector3 pos = expected[i].mPosition + expected[i].mDirection * 0.5f;
+        EXPECT_TRUE(storage[i].mPosition.positionEquals(pos, 1e-5f));
+    }
+}
+TEST_F(SceneQueryTest, ParallelParticleSystemUpdates)
+{
+    auto& mgr = ParticleSystemManager::getSingleton();
+    mgr.setParallelUpdatesEnabled(true);
+    // small chunks, so the per system split and the bounds merge run too
+    size_t chunkSize = ParticleSystem::getParallelChunkSize();
+    ParticleSystem::setParallelChunkSize(3);
+
+    std::vector<ParticleSystem*> systems;
+    for (int i = 0; i < 3; ++i)
+    {
+        ParticleSystem* ps = mSceneMgr->createParticleSystem(10);
+        mSceneMgr->getRootSceneNode()->createChildSceneNode()->attachObject(ps);
+        ps->_beginConcurrentUpdate();
+        ps->_endConcurrentUpdate();
+        for (int j = 0; j < 8; ++j)
+        {
+            Particle* p = ps->createParticle();
+            ASSERT_TRUE(p);
+            p->mPosition = Vector3(j, i, 0);
+            p->mDirection = Vector3::UNIT_Y;
+        }
+        mgr._queueUpdate(ps, 2);
+        systems.push_back(ps);
+    }
+
+    // destroyed systems leave the queue
+    ParticleSystem* destroyed = mSceneMgr->createParticleSystem(10);
+    mSceneMgr->getRootSceneNode()->createChildSceneNode()->attachObject(destroyed);
+    mgr._queueUpdate(destroyed, 2);
+    mSceneMgr->destroyParticleSystem(destroyed);
+
+    mgr._updateQueuedSystems();
+
+    for (int i = 0; i < 3; ++i)
+    {
+        ParticleSystem* ps = systems[i];
+        ASSERT_EQ(ps->getNumParticles(), 8u);
+        EXPECT_EQ(ps->getParticle(0)->mPosition.y, i + 2);
+        EXPECT_EQ(ps->getBoundingBox().getMinimum(), Vector3(0, i + 2, 0));
+        EXPECT_EQ(ps->getBoundingBox().getMaximum(), Vector3(7, i + 2, 0));
+    }
+
+    ParticleSystem::setParallelChunkSize(chunkSize);
+    mgr.setParallelUpdatesEnabled(false);
+}
+
+TEST_F(SceneQueryTest, GpuParticleRenderer)
+{
+    ParticleSystem* ps = mSceneMgr->createParticleSystem(10);
+    mSceneMgr->getRootSceneNode()->createChildSceneNode()->attachObject(ps);
+    ps->setRenderer("gpu");
+
+    auto renderer = dynamic_cast<GpuParticleRenderer*>(ps->getRenderer());
+    ASSERT_TRUE(renderer);
+    EXPECT_TRUE(renderer->setParameter("force_vector", "0 -10 0"));
+    EXPECT_TRUE(renderer->setParameter("max_particles", "1000"));
+    EXPECT_EQ(renderer->getForce(), Vector3(0, -10, 0));
+    EXPECT_EQ(renderer->getMaxParticles(), 1000u);
+    EXPECT_EQ(renderer->getParameter("max_particles"), "1000");
+
+    // the renderer owns the simulation, no CPU particles are updated
+    Particle* p = ps->createParticle();
+    ASSERT_TRUE(p);
+    p->mDirection = Vector3::UNIT_X;
+    ps->_update(1);
+    EXPECT_EQ(p->mPosition, Vector3::ZERO);
+    EXPECT_TRUE(ps->getBoundingBox().isNull());
+
+    mSceneMgr->destroyParticleSystem(ps);
+}
+TEST(RadixSort, CoherentSort)
+{
+    using Values = std::vector<std::unique_ptr<float>>;
+    auto key = [](std::unique_ptr<float> const& v) { return *v; };
+
+    minstd_rand rng(7);
+    std::uniform_real_distribution<float> dist(-100, 100);
+    Values values;
+    for (int i = 0; i < 1000; ++i)
+        values.push_back(std::make_unique<float>(dist(rng)));
+
+    // already sorted input must come back untouched
+    RadixSort<Values, std::unique_ptr<float>, float> radix;
+    std::ranges::sort(values, {}, key);
+    radix.sort(values, key);
+    ASSERT_TRUE(std::ranges::all_of(values, [](auto const& v) { return v != nullptr; }));
+
+    CoherentSort<Values, std::unique_ptr<float>> sorter;
+    for (bool quantized : {false, true})
+    {
+        sorter.setQuantized(quantized);
+        // quantized keys only order the values up to a step of the range
+        float tolerance = quantized ? 200.0f / 65535 : 0.0f;
+        auto expectSorted = [&] {
+            for (size_t i = 1; i < values.size(); ++i)
+                EXPECT_LE(*values[i - 1], *values[i] + tolerance);
+        };
+
+        // nearly sorted, handled by the insertion sort
+        for (size_t i = 0; i + 1 < values.size(); i += 50)
+            std::swap(values[i], values[i + 1]);
+        sorter.sort(values.begin(), values.end(), key);
+        expectSorted();
+
+        // shuffled, handled by the radix sort
+        std::ranges::shuffle(values, rng);
+        sorter.sort(values.begin(), values.end(), key);
+        expectSorted();
+    }
+}
+TEST_F(WorkQueueTests, ParallelRadixSort)
+{
+    mRoot->getWorkQueue()->startup();
+
+    // sort keys like those of the render queue, with the index to check the stability
+    using Item = std::pair<uint64, int>;
+    minstd_rand rng(3);
+    std::vector<Item> items;
+    for (int i = 0; i < 100000; ++i)
+        items.emplace_back((uint64(rng() % 64) << 32) | uint32(rng() % 4096), i);
+    std::vector<Item> expected = items;
+    std::ranges::stable_sort(expected, {}, &Item::first);
+
+    RadixSort<std::vector<Item>, Item, uint64> radix;
+    radix.setWorkQueue(mRoot->getWorkQueue());
+    radix.sort(items, [](const Item& p) { return p.first; });
+    EXPECT_EQ(items, expected);
+
+    // below the threshold the same sorter sorts serially
+    items.resize(1000);
+    std::ranges::reverse(items);
+    expected = items;
+    std::ranges::stable_sort(expected, {}, &Item::first);
+    radix.sort(items, [](const Item& p) { return p.first; });
+    EXPECT_EQ(items, expected);
+
+    // depths of a large billboard set
+    std::uniform_real_distribution<float> dist(-1000, 1000);
+    std::vector<float> depths(100000);
+    std::ranges::generate(depths, [&] { return dist(rng); });
+    CoherentSort<std::vector<float>, float> sorter;
+    sorter.setWorkQueue(mRoot->getWorkQueue());
+    sorter.sort(depths.begin(), depths.end(), [](float v) { return v; });
+    EXPECT_TRUE(std::ranges::is_sorted(depths));
+}
+TEST(ConvexPolytope, MatchesConvexBody)
+{
+    AxisAlignedBox box{AxisAlignedBox::Extent::Finite, {-1, -1, -1}, {1, 1, 1}};
+    AxisAlignedBox bounds{AxisAlignedBox::Extent::Finite, {-2, -0.5, -2}, {2, 3, 0.5}};
+    Plane cut = Plane::Redefine(Vector3{1, 1, 0}.normalisedCopy(), {0.5, 0, 0});
+
+    ConvexBody body;
+    body.define(box);
+    body.clip(cut);
+    body.extend({-2.5, 0, 0});
+    body.clip(bounds);
+
+    ConvexPolytope polytope;
+    polytope.define(box);
+    polytope.clip(cut);
+    polytope.extend({-2.5, 0, 0});
+    polytope.clip(bounds);
+
+    EXPECT_TRUE(polytope.getAABB().getMinimum().positionEquals(body.getAABB().getMinimum()));
+    EXPECT_TRUE(polytope.getAABB().getMaximum().positionEquals(body.getAABB().getMaximum()));
+
+    // every vertex on the kept side of the planes
+    Vector3 tolerance = Vector3::UNIT_SCALE * 1e-4f;
+    for (size_t f = 0; f < polytope.getFaceCount(); ++f)
+        for (size_t i = 0; i < polytope.getVertexCount(f); ++i)
+        {
+            Vector3 vertex = polytope.getVertex(f, i);
+            EXPECT_LE(cut.getDistance(vertex), 1e-4f);
+            EXPECT_TRUE(bounds.intersects(AxisAlignedBox{AxisAlignedBox::Extent::Finite, vertex - tolerance,
+                                                           vertex + tolerance}));
+        }
+
+    // clipping everything away leaves nothing
+    polytope.clip(Plane::Redefine(Vector3::NEGATIVE_UNIT_Y, {0, 5, 0}));
+    EXPECT_EQ(polytope.getFaceCount(), 0u);
+    EXPECT_TRUE(polytope.getAABB().isNull());
+}
+TEST_F(SceneQueryTest, BillboardChainIncrementalUpdates)
+{
+    struct TestChain : public BillboardChain
+    {
+        using BillboardChain::BillboardChain;
+        using BillboardChain::updateVertexBuffer;
+        using BillboardChain::mDirtyElements;
+        using BillboardChain::mVertexData;
+    };
+
+    TestChain chain("chain", 10, 1, true, true, true);
+    chain.setIncrementalUpdatesEnabled(true);
+    mSceneMgr->getRootSceneNode()->attachObject(&chain);
+
+    for (int i = 0; i < 3; ++i)
+        chain.addChainElement(0, BillboardChain::Element(Vector3(0, 0, -i), 2, 0, ColourValue::White,
+                                                         Quaternion::IDENTITY));
+    chain.updateVertexBuffer(mCamera);
+    EXPECT_TRUE(chain.mDirtyElements.empty());
+
+    // only the new head and the previous head get written
+    chain.addChainElement(0, BillboardChain::Element(Vector3(0, 0, 1), 4, 0, ColourValue::White,
+                                                     Quaternion::IDENTITY));
+    EXPECT_EQ(chain.mDirtyElements.size(), 3u);
+    chain.updateVertexBuffer(mCamera);
+    EXPECT_TRUE(chain.mDirtyElements.empty());
+
+    // the head grows backwards from the end of the ring, so it is now in slot 6
+    auto buffer = chain.mVertexData->vertexBufferBinding->getBuffer(0);
+    size_t vertexFloats = buffer->getVertexSize() / sizeof(float);
+    std::vector<float> vertices(2 * vertexFloats);
+    buffer->readData(6 * 2 * buffer->getVertexSize(), 2 * buffer->getVertexSize(), vertices.data());
+    for (size_t v = 0; v < 2; ++v)
+    {
+        const float* vertex = &vertices[v * vertexFloats];
+        // unexpanded position and the tangent towards the next element
+        EXPECT_EQ(Vector3(vertex[0], vertex[1], vertex[2]), Vector3(0, 0, 1));
+        EXPECT_EQ(Vector3(vertex[6], vertex[7], vertex[8]), Vector3(0, 0, -1));
+        EXPECT_EQ(vertex[9], v == 0 ? -2 : 2);
+    }
+
+    mSceneMgr->getRootSceneNode()->detachObject(&chain);
+}
+
+TEST_F(SceneQueryTest, ParticleSystemLodAndBudget)
+{
+    auto& mgr = ParticleSystemManager::getSingleton();
+
+    ParticleSystem* ps = mSceneMgr->createParticleSystem(20);
+    mSceneMgr->getRootSceneNode()->createChildSceneNode()->attachObject(ps);
+    ps->setLodLevels({{100, 0.5f, 0.1f, 5}, {1000, 0, 0, 1}});
+    EXPECT_EQ(ps->getCurrentLodIndex(), 0);
+    EXPECT_EQ(ps->getEffectiveParticleQuota(), 20u);
+
+    // the camera is 500 units away
+    ps->_notifyCurrentCamera(mCamera);
+    EXPECT_EQ(ps->getCurrentLodIndex(), 1);
+    EXPECT_EQ(ps->getEffectiveParticleQuota(), 5u);
+    EXPECT_FLOAT_EQ(ps->_getSquaredCameraDistance(), 500 * 500);
+
+    // the most important and closest systems are served first
+    ParticleSystem* nearPs = mSceneMgr->createParticleSystem(10);
+    ParticleSystem* farPs = mSceneMgr->createParticleSystem(10);
+    mSceneMgr->getRootSceneNode()->createChildSceneNode(Vector3{0, 0, 400})->attachObject(nearPs);
+    mSceneMgr->getRootSceneNode()->createChildSceneNode(Vector3{0, 0, -500})->attachObject(farPs);
+    for (auto system : {ps, nearPs, farPs})
+    {
+        system->_beginConcurrentUpdate();
+        system->_endConcurrentUpdate();
+        system->_notifyCurrentCamera(mCamera);
+        for (int i = 0; i < 4; ++i)
+            ASSERT_TRUE(system->createParticle());
+        mgr._addToBudget(system);
+    }
+    ps->setBudgetPriority(1);
+
+    mgr.setParticleBudget(10);
+    mgr._updateQueuedSystems();
+    EXPECT_EQ(ps->_getBudgetQuota(), 10u);
+    EXPECT_EQ(nearPs->_getBudgetQuota(), 6u);
+    EXPECT_EQ(farPs->_getBudgetQuota(), 2u);
+    EXPECT_EQ(farPs->getEffectiveParticleQuota(), 2u);
+    mgr.setParticleBudget(0);
+
+    mSceneMgr->destroyParticleSystem(ps);
+    mSceneMgr->destroyParticleSystem(nearPs);
+    mSceneMgr->destroyParticleSystem(farPs);
+}
+
+namespace {
+struct PlainEmitter : public ParticleEmitter
+{
+    PlainEmitter(ParticleSystem* psys) : ParticleEmitter(psys) { mType = "Plain"; }
+};
+struct PlainEmitterFactory : public ParticleEmitterFactory
+{
+    [[nodiscard]] auto getName() const -> String override { return "Plain"; }
+    auto createEmitter(ParticleSystem* psys) -> ParticleEmitter* override
+    {
+        mEmitters.push_back(new PlainEmitter(psys));
+        return mEmitters.back();
+    }
+};
+}
+
+TEST_F(SceneQueryTest, EmittedEmitterPools)
+{
+    PlainEmitterFactory factory;
+    ParticleSystemManager::getSingleton().addEmitterFactory(&factory);
+
+    ParticleSystem* ps = mSceneMgr->createParticleSystem(10);
+    mSceneMgr->getRootSceneNode()->createChildSceneNode()->attachObject(ps);
+    ps->setEmittedEmitterQuota(3);
+    ParticleEmitter* child = ps->addEmitter("Plain");
+    child->setName("child");
+    ParticleEmitter* parent = ps->addEmitter("Plain");
+    parent->setEmittedEmitter("child");
+
+    // 10 emitters are requested, the pool of the child has 3
+    ps->_update(1);
+    EXPECT_TRUE(child->isEmitted());
+    ASSERT_EQ(ps->getNumParticles(), 3u);
+    EXPECT_FALSE(ps->createEmitterParticle("child"));
+    for (size_t i = 0; i < ps->getNumParticles(); ++i)
+    {
+        EXPECT_EQ(ps->getParticle(i)->mParticleType, Particle::ParticleType::Emitter);
+        ps->getParticle(i)->mTimeToLive = 0;
+    }
+
+    // expired ones return to the pool
+    ps->_update(0.01f);
+    EXPECT_EQ(ps->getNumParticles(), 0u);
+    for (int i = 0; i < 3; ++i)
+        EXPECT_TRUE(ps->createEmitterParticle("child"));
+    EXPECT_FALSE(ps->createEmitterParticle("child"));
+    EXPECT_FALSE(ps->createEmitterParticle("unknown"));
+
+    mSceneMgr->destroyParticleSystem(ps);
+}
+
+TEST_F(AutoParamDataSourceTest, ShadowCascadesInAtlasTiles)
+{
+    auto setup = std::static_pointer_cast<PSSMShadowCameraSetup>(PSSMShadowCameraSetup::create());
+    setup->calculateSplitPoints(4, 1, 1000, 1);
+    const auto& splits = setup->getSplitPoints();
+    ASSERT_EQ(setup->getSplitCount(), 4u);
+    // purely logarithmic
+    EXPECT_FLOAT_EQ(splits[0], 1);
+    EXPECT_NEAR(splits[1], std::pow(1000.0f, 0.25f), 1e-3f);
+    EXPECT_NEAR(splits[2], std::pow(1000.0f, 0.5f), 1e-3f);
+    EXPECT_FLOAT_EQ(splits[4], 1000);
+    setup->calculateSplitPoints(2, 10, 110, 0);
+    EXPECT_FLOAT_EQ(setup->getSplitPoints()[1], 60);
+
+    EXPECT_EQ(setup->getAtlasTileCount(), 2u);
+    setup->setAtlasEnabled(false);
+    EXPECT_EQ(setup->getAtlasTileCount(), 1u);
+    EXPECT_EQ(DefaultShadowCameraSetup::create()->getAtlasTileCount(), 1u);
+
+    // the projection of a tile covers only its part of the texture
+    SceneManager* sm = mRoot->createSceneManager();
+    Camera* cam = sm->createCamera("Camera");
+    sm->getRootSceneNode()->createChildSceneNode(Vector3{10, 20, 500})->attachObject(cam);
+    Camera* texCam = sm->createCamera("Projector");
+    sm->getRootSceneNode()->createChildSceneNode()->attachObject(texCam);
+
+    AutoParamDataSource source;
+    source.setCurrentCamera(cam, false);
+    source.setTextureProjector(texCam, 0);
+    Matrix4 full = source.getTextureViewProjMatrix(0);
+    source.setTextureProjector(texCam, 0, Vector4{0.5, 0, 0.5, 0.5});
+    Matrix4 tile = source.getTextureViewProjMatrix(0);
+
+    Vector4 p{3, -7, -100, 1};
+    Vector4 uvFull = full * p;
+    Vector4 uvTile = tile * p;
+    EXPECT_NEAR(uvTile.x / uvTile.w, 0.5f + uvFull.x / uvFull.w * 0.5f, 1e-5f);
+    EXPECT_NEAR(uvTile.y / uvTile.w, uvFull.y / uvFull.w * 0.5f, 1e-5f);
+    EXPECT_NEAR(uvTile.z, uvFull.z, 1e-5f);
+}
+
+TEST(ShadowCameraSetup, UpdateIntervals)
+{
+    PSSMShadowCameraSetup setup;
+    setup.calculateSplitPoints(3, 1, 1000);
+    EXPECT_EQ(setup.getUpdateInterval(2), 1u);
+    setup.setUpdateInterval(2, 4);
+    EXPECT_EQ(setup.getUpdateInterval(2), 4u);
+    EXPECT_EQ(setup.getUpdateInterval(0), 1u);
+    // splits beyond the configured ones are not throttled
+    EXPECT_EQ(setup.getUpdateInterval(5), 1u);
+    EXPECT_EQ(DefaultShadowCameraSetup().getUpdateInterval(0), 1u);
+
+    Root root("");
+    SceneManager* sm = root.createSceneManager();
+    EXPECT_EQ(sm->getShadowStaticCasterMask(), QueryTypeMask{});
+    sm->setShadowStaticCasterMask(QueryTypeMask::STATICGEOMETRY);
+    EXPECT_EQ(sm->getShadowStaticCasterMask(), QueryTypeMask::STATICGEOMETRY);
+}
+
+TEST(SceneManager, ShadowCasterCullingSettings)
+{
+    Root root("");
+    SceneManager* sm = root.createSceneManager();
+    EXPECT_FALSE(sm->getShadowCasterCulling());
+    sm->setShadowCasterCulling(true, false);
+    EXPECT_TRUE(sm->getShadowCasterCulling());
+    EXPECT_FALSE(sm->getShadowCasterCullingByReceivers());
+    // only applies while rendering shadow textures
+    EXPECT_TRUE(sm->_passesShadowCasterCulling(AxisAlignedBox{Vector3{1e6f, 1e6f, 1e6f}, Vector3{1e6f + 1, 1e6f + 1, 1e6f + 1}}));
+}
+
+TEST(SceneManager, ShadowAtlasSettings)
+{
+    Root root("");
+    SceneManager* sm = root.createSceneManager();
+    EXPECT_FALSE(sm->getShadowAtlas());
+    EXPECT_EQ(sm->getShadowAtlasMinTileSize(), 64);
+    sm->setShadowAtlas(true, 128);
+    EXPECT_TRUE(sm->getShadowAtlas());
+    EXPECT_EQ(sm->getShadowAtlasMinTileSize(), 128);
+
+    Light* light = sm->createLight();
+    EXPECT_EQ(light->getShadowImportance(), 1);
+    light->setShadowImportance(4);
+    EXPECT_EQ(light->getShadowImportance(), 4);
+}
+
+TEST(ShadowCaster, ShadowVolumeCacheSize)
+{
+    EXPECT_EQ(ShadowCaster::getShadowVolumeCacheSize(), 4);
+    ShadowCaster::setShadowVolumeCacheSize(0);
+    EXPECT_EQ(ShadowCaster::getShadowVolumeCacheSize(), 0);
+    ShadowCaster::setShadowVolumeCacheSize(4);
+}
+
+TEST(SceneManager, ParallelShadowTextureCulling)
+{
+    Root root("");
+    SceneManager* sm = root.createSceneManager();
+    EXPECT_FALSE(sm->getParallelShadowTextureCulling());
+    sm->setParallelShadowTextureCulling(true);
+    EXPECT_TRUE(sm->getParallelShadowTextureCulling());
+}
+
+TEST(SceneManager, ParallelViewportCulling)
+{
+    Root root("");
+    SceneManager* sm = root.createSceneManager();
+    EXPECT_FALSE(sm->getParallelViewportCulling());
+    sm->setParallelViewportCulling(true);
+    EXPECT_TRUE(sm->getParallelViewportCulling());
+    // nothing to cull without viewports
+    sm->_gatherViewports({});
+}
+
+TEST(Image, DecodeStreamAndMemory)
+{
+    ResourceGroupManager mgr;
+    STBIImageCodec::startup();
+    ConfigFile cf;
+    cf.load(FileSystemLayer(/*OGRE_VERSION_NAME*/"Tsathoggua").getConfigFilePath("resources.cfg"));
+    auto testPath = cf.getSettings("Tests").begin()->second;
+    auto fileName = ::std::format("{}/decal1.png", testPath);
+
+    // read through stb callbacks and decoded in place
+    Image streamed;
+    streamed.load(Root::openFileStream(fileName), "png");
+    Image inMemory;
+    inMemory.load(std::make_shared<MemoryDataStream>(Root::openFileStream(fileName)), "png");
+
+    STBIImageCodec::shutdown();
+    ASSERT_EQ(streamed.getSize(), inMemory.getSize());
+    ASSERT_TRUE(!memcmp(streamed.getData(), inMemory.getData(), inMemory.getSize()));
+}
+
+TEST(Image, GenerateMipmaps)
+{
+    // checker of black and white, alpha alternating the other way round
+    Image img(PixelFormat::BYTE_RGBA, 8, 4);
+    for (uint32 y = 0; y < 4; ++y)
+    {
+        for (uint32 x = 0; x < 8; ++x)
+        {
+            float v = (x + y) % 2 ? 1.0f : 0.0f;
+            img.setColourAt(ColourValue(v, v, v, 1.0f - v), x, y, 0);
+        }
+    }
+    Image linear = img;
+
+    img.generateMipmaps();
+    EXPECT_EQ(img.getNumMipmaps(), TextureMipmap(3));
+    EXPECT_EQ(img.getPixelBox(0, TextureMipmap(3)).getWidth(), 1u);
+    const uint8* mip1 = img.getPixelBox(0, TextureMipmap(1)).data;
+    EXPECT_EQ(mip1[0], 128);
+    EXPECT_EQ(mip1[3], 128);
+
+    // the average of black and white in linear space, alpha is not converted
+    linear.generateMipmaps(true);
+    mip1 = linear.getPixelBox(0, TextureMipmap(1)).data;
+    EXPECT_EQ(mip1[0], 188);
+    EXPECT_EQ(mip1[3], 128);
+
+    // the sharper filter keeps the flat areas
+    Image flat(PixelFormat::BYTE_RGBA, 16, 16);
+    for (uint32 y = 0; y < 16; ++y)
+        for (uint32 x = 0; x < 16; ++x)
+            flat.setColourAt(ColourValue(0.5f, 0.25f, 1.0f, 1.0f), x, y, 0);
+    flat.generateMipmaps(false, Image::Filter::KAISER);
+    EXPECT_EQ(flat.getColourAt(0, 0, 0), flat.getPixelBox(0, TextureMipmap(2)).getColourAt(1, 1, 0));
+}
+
+TEST(Image, Compress)
+{
+    // red on the left and blue on the right of each block
+    Image img(PixelFormat::BYTE_RGBA, 8, 4);
+    for (uint32 y = 0; y < 4; ++y)
+        for (uint32 x = 0; x < 8; ++x)
+            img.setColourAt(x % 4 < 2 ? ColourValue::Red : ColourValue::Blue, x, y, 0);
+
+    Image bc1 = img;
+    bc1.compress(PixelFormat::DXT1);
+    EXPECT_EQ(bc1.getFormat(), PixelFormat::DXT1);
+    ASSERT_EQ(bc1.getSize(), 16u);
+    const uint8 expected[8] = {0x00, 0xF8, 0x1F, 0x00, 0x50, 0x50, 0x50, 0x50};
+    EXPECT_TRUE(std::equal(expected, expected + 8, bc1.getData()));
+
+    // partial blocks and the mipmaps are encoded too
+    Image odd(PixelFormat::BYTE_RGB, 6, 5);
+    memset(odd.getData(), 128, odd.getSize());
+    odd.generateMipmaps();
+    odd.compress(PixelFormat::ETC2_RGBA8);
+    EXPECT_EQ(odd.getNumMipmaps(), TextureMipmap(2));
+    EXPECT_EQ(odd.getSize(), (4 + 1 + 1) * 16u);
+
+    EXPECT_THROW(img.compress(PixelFormat::BC6H_UF16), InvalidParametersException);
+}
+
+TEST(Image, Decompress)
+{
+    // the DXT1 block of the compress test, red on the left and blue on the right
+    uint8 bc1[8] = {0x00, 0xF8, 0x1F, 0x00, 0x50, 0x50, 0x50, 0x50};
+    Image img;
+    img.loadDynamicImage(bc1, 4, 4, 1, PixelFormat::DXT1);
+    img.decompress();
+    EXPECT_EQ(img.getFormat(), PixelFormat::BYTE_RGBA);
+    EXPECT_EQ(img.getColourAt(1, 2, 0), ColourValue::Red);
+    EXPECT_EQ(img.getColourAt(2, 1, 0), ColourValue::Blue);
+
+    // an ASTC void extent block is a constant colour
+    uint8 astc[16] = {0xFC, 0xFD, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x10, 0x00, 0x80, 0x00, 0xFF, 0xFF, 0xFF};
+    img.loadDynamicImage(astc, 5, 5, 1, PixelFormat::ASTC_RGBA_5X5_LDR);
+    img.decompress();
+    const uint8 expected[4] = {0x10, 0x80, 0xFF, 0xFF};
+    EXPECT_TRUE(std::equal(expected, expected + 4, img.getData(4, 4, 0)));
+
+    // round trip through the encoder
+    Image grey(PixelFormat::BYTE_RGBA, 8, 8);
+    memset(grey.getData(), 128, grey.getSize());
+    for (auto format : {PixelFormat::BC7_UNORM, PixelFormat::ETC2_RGBA8})
+    {
+        Image decoded = grey;
+        decoded.compress(format).decompress();
+        for (uint32 i = 0; i < decoded.getSize(); ++i)
+            EXPECT_NEAR(decoded.getData()[i], 128, 2);
+    }
+
+    img.loadDynamicImage(astc, 1, 1, 1, PixelFormat::BC6H_UF16);
+    EXPECT_THROW(img.decompress(), InvalidParametersException);
+}
+
+using KTX2CodecTests = RootWithoutRenderSystemFixture;
+TEST_F(KTX2CodecTests, Decode)
+{
+    std::vector<uint8> file = {0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A};
+    auto append = [&file](auto v) { file.insert(file.end(), (uint8*)&v, (uint8*)&v + sizeof(v)); };
+    // VK_FORMAT_R8G8B8A8_UNORM, 2x2 with 2 levels, no supercompression
+    for (uint32 v : {37u, 1u, 2u, 2u, 0u, 0u, 1u, 2u, 0u, 0u, 0u, 0u, 0u})
+        append(v);
+    append(uint64(0));
+    append(uint64(0));
+    // the level index, the smallest level comes first in the file
+    for (uint64 v : {132ull, 16ull, 16ull, 128ull, 4ull, 4ull})
+        append(v);
+    for (uint8 v : {10, 20, 30, 40})
+        file.push_back(v);
+    for (uint8 i = 0; i < 16; ++i)
+        file.push_back(i);
+
+    Image img;
+    img.load(std::make_shared<MemoryDataStream>(file.data(), file.size()), "ktx2");
+    EXPECT_EQ(img.getFormat(), PixelFormat::BYTE_RGBA);
+    EXPECT_EQ(img.getWidth(), 2u);
+    EXPECT_EQ(img.getNumMipmaps(), TextureMipmap(1));
+    EXPECT_EQ(img.getData()[4], 4);
+    const uint8* mip1 = img.getPixelBox(0, TextureMipmap(1)).data;
+    EXPECT_EQ(mip1[3], 40);
+
+    EXPECT_EQ(Image::getFileExtFromMagic(std::make_shared<MemoryDataStream>(file.data(), file.size())), "ktx2");
+}
+using QOICodecTests = RootWithoutRenderSystemFixture;
+TEST_F(QOICodecTests, RoundTrip)
+{
+    // runs, small differences, repeated colours and alpha changes
+    Image img(PixelFormat::BYTE_RGBA, 33, 7);
+    std::mt19937 rng(1);
+    for (uint32 y = 0; y < 7; ++y)
+        for (uint32 x = 0; x < 33; ++x)
+        {
+            uint8* px = img.getData(x, y);
+            px[0] = x < 20 ? 10 : uint8(rng());
+            px[1] = uint8(x * 3);
+            px[2] = uint8(y * 40 + x);
+            px[3] = x % 11 ? 255 : uint8(x * 7);
+        }
+
+    DataStreamPtr encoded = img.encode("qoi");
+    EXPECT_EQ(Image::getFileExtFromMagic(encoded), "qoi");
+    Image decoded;
+    decoded.load(encoded, "qoi");
+    ASSERT_EQ(decoded.getFormat(), PixelFormat::BYTE_RGBA);
+    ASSERT_EQ(decoded.getWidth(), 33u);
+    ASSERT_EQ(decoded.getHeight(), 7u);
+    EXPECT_EQ(memcmp(decoded.getData(), img.getData(), img.getSize()), 0);
+
+    // formats without alpha are stored as RGB
+    Image rgb(PixelFormat::R8G8B8, 4, 4);
+    memset(rgb.getData(), 200, rgb.getSize());
+    decoded.load(rgb.encode("qoi"), "qoi");
+    EXPECT_EQ(decoded.getFormat(), PixelFormat::BYTE_RGB);
+    EXPECT_EQ(decoded.getColourAt(3, 3, 0), rgb.getColourAt(3, 3, 0));
+}
+
+using ManualObjectTests = RootWithoutRenderSystemFixture;
+TEST_F(ManualObjectTests, Streaming)
+{
+    ManualObject obj("streamed");
+    obj.setBufferUsage(HardwareBufferUsage::CPU_TO_GPU);
+    obj.setStreaming(true);
+    obj.estimateVertexCount(4);
+
+    auto readPositions = [&obj]
+    {
+        const VertexData* vertexData = obj.getSection(0)->getRenderOperation()->vertexData;
+        HardwareVertexBufferSharedPtr vbuf = vertexData->vertexBufferBinding->getBuffer(0);
+        HardwareBufferLockGuard lock(vbuf, HardwareBuffer::LockOptions::READ_ONLY);
+        std::vector<float> x;
+        for (size_t v = 0; v < vertexData->vertexCount; ++v)
+            x.push_back(static_cast<float*>(lock.pData)[v * vbuf->getVertexSize() / sizeof(float)]);
+        return x;
+    };
+
+    // more vertices than estimated grows the buffer while streaming
+    obj.begin("BaseWhiteNoLighting", RenderOperation::OperationType::LINE_LIST);
+    for (int i = 0; i < 60; ++i)
+    {
+        obj.position(float(i), 0, 0);
+        obj.colour(ColourValue::White);
+    }
+    obj.end();
+    std::vector<float> expected;
+    for (int i = 0; i < 60; ++i)
+        expected.push_back(float(i));
+    EXPECT_EQ(readPositions(), expected);
+
+    // updates within the size reuse the buffer
+    HardwareVertexBuffer* vbuf =
+        obj.getSection(0)->getRenderOperation()->vertexData->vertexBufferBinding->getBuffer(0).get();
+    obj.beginUpdate(0);
+    for (int i = 0; i < 3; ++i)
+    {
+        obj.position(float(10 * i), 0, 0);
+        obj.colour(ColourValue::White);
+        obj.index(i);
+    }
+    obj.index(0);
+    obj.end();
+    EXPECT_EQ(obj.getSection(0)->getRenderOperation()->vertexData->vertexBufferBinding->getBuffer(0).get(), vbuf);
+    EXPECT_EQ(readPositions(), (std::vector<float>{0, 10, 20}));
+    EXPECT_EQ(obj.getSection(0)->getRenderOperation()->indexData->indexCount, 4u);
+}
+
+namespace {
+    struct InputValue : public ControllerValue<Real>
+    {
+        Real value{0};
+        [[nodiscard]] auto getValue() const -> Real override { return value; }
+        void setValue(Real v) override { value = v; }
+    };
+}
+
+TEST(Controller, HeldInput)
+{
+    using FunctionFactory = ControllerFunctionRealPtr (*)();
+    std::initializer_list<FunctionFactory> factories = {
+        [] { return ScaleControllerFunction::create(0.3, true); },
+        [] { return ScaleControllerFunction::create(0.3, false); },
+        [] { return AnimationControllerFunction::create(2); },
+        [] { return WaveformControllerFunction::create(WaveformType::SINE, 0, 0.4, 0, 1, true); }};
+    for (FunctionFactory factory : factories)
+    {
+        auto input = std::make_shared<InputValue>();
+        auto updated = std::make_shared<InputValue>(), held = std::make_shared<InputValue>();
+        Controller<Real> updating{input, updated, factory()};
+        Controller<Real> holding{input, held, factory()};
+        for (Real time : {0.25, 0.5, 0.75})
+        {
+            input->value = time;
+            updating.update();
+            holding._holdInput();
+        }
+        EXPECT_EQ(held->value, 0);
+
+        holding._applyHeldInput();
+        EXPECT_NEAR(held->value, updated->value, 1e-5);
+        // applied only once
+        held->value = 0;
+        holding._applyHeldInput();
+        EXPECT_EQ(held->value, 0);
+    }
+}
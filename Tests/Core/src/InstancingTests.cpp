@@ -36,6 +36,9 @@ import :Core.RootWithoutRenderSystemFixture;
 
 import Ogre.Core;
 
+import <set>;
+import <vector>;
+
 using namespace Ogre;
 
 using Instancing = RootWithoutRenderSystemFixture;
@@ -56,3 +59,90 @@ TEST_F(Instancing, Bounds) {
     EXPECT_EQ(instanced_entity.getBoundingBox(), entity->getBoundingBox());
     EXPECT_EQ(instanced_entity.getBoundingRadius(), entity->getBoundingRadius());
 }
+
+struct InstanceDefragmentation : public RootWithoutRenderSystemFixture
+{
+    RecordingRenderSystem mRenderSystem;
+
+    void SetUp() override
+    {
+        RootWithoutRenderSystemFixture::SetUp();
+        mRenderSystem.getMutableCapabilities()->setCapability(Capabilities::VERTEX_BUFFER_INSTANCE_DATA);
+        mRoot->setRenderSystem(&mRenderSystem);
+    }
+    void TearDown() override
+    {
+        mRoot->setRenderSystem(nullptr);
+        RootWithoutRenderSystemFixture::TearDown();
+    }
+};
+TEST_F(InstanceDefragmentation, Incremental) {
+    SceneManager* sceneMgr = mRoot->createSceneManager();
+    InstanceManager* mgr =
+        sceneMgr->createInstanceManager("Defrag", "sphere.mesh", RGN_DEFAULT, InstanceManager::HWInstancingBasic, 4);
+    mgr->setNumCustomParams(1);
+
+    auto batchCount = [&]
+    {
+        size_t count = 0;
+        for (auto it = mgr->getInstanceBatchIterator("BaseWhite"); it.hasMoreElements(); it.moveNext())
+            ++count;
+        return count;
+    };
+
+    // 16 instances filling 4 batches
+    std::vector<InstancedEntity*> entities;
+    std::vector<SceneNode*> nodes;
+    for (int i = 0; i < 16; ++i)
+    {
+        InstancedEntity* entity = sceneMgr->createInstancedEntity("BaseWhite", "Defrag");
+        entity->setCustomParam(0, Vector4{Real(i), 0, 0, 1});
+        nodes.push_back(sceneMgr->getRootSceneNode()->createChildSceneNode(Vector3{Real(i), 0, 0}));
+        nodes.back()->attachObject(entity);
+        entities.push_back(entity);
+    }
+    ASSERT_EQ(batchCount(), 4u);
+
+    // leaves 2, 3, 2 and 1 instances in the batches, which fit into 2
+    for (int i : {0, 2, 5, 9, 10, 13, 14, 15})
+    {
+        sceneMgr->destroyInstancedEntity(entities[i]);
+        entities[i] = nullptr;
+    }
+    mgr->_updateDirtyBatches();
+    EXPECT_EQ(batchCount(), 4u);
+
+    // disabled by default
+    EXPECT_EQ(mgr->_updateIncrementalDefragmentation(), 0u);
+
+    mgr->setIncrementalDefragmentation(2);
+    size_t frames = 0, migrated = 0;
+    while (size_t count = mgr->_updateIncrementalDefragmentation())
+    {
+        EXPECT_LE(count, 2u);
+        migrated += count;
+        mgr->_updateDirtyBatches();
+        ASSERT_LT(++frames, 10u);
+    }
+    // the single instance of the last batch, then the two of the first one
+    EXPECT_EQ(frames, 2u);
+    EXPECT_EQ(migrated, 3u);
+    EXPECT_EQ(batchCount(), 2u);
+
+    std::set<InstanceBatch*> batches;
+    for (auto it = mgr->getInstanceBatchIterator("BaseWhite"); it.hasMoreElements(); it.moveNext())
+    {
+        EXPECT_TRUE((*it.peekNextPtr())->isBatchFull());
+        batches.insert(it.peekNextPtr()->get());
+    }
+
+    for (size_t i = 0; i < entities.size(); ++i)
+    {
+        if (!entities[i])
+            continue;
+        EXPECT_TRUE(entities[i]->isInUse()) << i;
+        EXPECT_TRUE(batches.contains(entities[i]->_getOwner())) << i;
+        EXPECT_EQ(entities[i]->getParentSceneNode(), nodes[i]) << i;
+        EXPECT_EQ(entities[i]->getCustomParam(0), Vector4{Real(i), 0, 0, 1}) << i;
+    }
+}
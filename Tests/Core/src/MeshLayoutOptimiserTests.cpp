@@ -0,0 +1,88 @@
+// This file is part of the OGRE project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at https://www.ogre3d.org/licensing.
+module;
+
+#include <gtest/gtest.h>
+#include <cstddef>
+#include <cstring>
+
+module Ogre.Tests;
+
+import :Core.RootWithoutRenderSystemFixture;
+
+import Ogre.Core;
+
+import <vector>;
+
+using namespace Ogre;
+
+using MeshLayoutOptimiserTests = RootWithoutRenderSystemFixture;
+
+namespace {
+    /// The floats of an element of all vertices
+    auto readElement(const VertexData* vertexData, VertexElementSemantic semantic) -> std::vector<float>
+    {
+        const VertexElement* elem = vertexData->vertexDeclaration->findElementBySemantic(semantic);
+        HardwareVertexBufferSharedPtr vbuf = vertexData->vertexBufferBinding->getBuffer(elem->getSource());
+        HardwareBufferLockGuard lock(vbuf, HardwareBuffer::LockOptions::READ_ONLY);
+
+        size_t elemFloats = VertexElement::getTypeCount(elem->getType());
+        std::vector<float> values(vertexData->vertexCount * elemFloats);
+        for (size_t v = 0; v < vertexData->vertexCount; ++v)
+        {
+            auto* vertex = static_cast<unsigned char*>(lock.pData) + (vertexData->vertexStart + v) * vbuf->getVertexSize();
+            std::memcpy(&values[v * elemFloats], vertex + elem->getOffset(), elemFloats * sizeof(float));
+        }
+        return values;
+    }
+
+    auto getVertexData(const Mesh* mesh) -> const VertexData*
+    {
+        const SubMesh* sub = mesh->getSubMeshes().front();
+        return sub->useSharedVertices ? mesh->sharedVertexData : sub->vertexData.get();
+    }
+}
+
+TEST_F(MeshLayoutOptimiserTests, SeparatePositions)
+{
+    MeshPtr mesh = MeshManager::getSingleton().load("knot.mesh", RGN_DEFAULT);
+    auto positions = readElement(getVertexData(mesh.get()), VertexElementSemantic::POSITION);
+    auto normals = readElement(getVertexData(mesh.get()), VertexElementSemantic::NORMAL);
+    auto texCoords = readElement(getVertexData(mesh.get()), VertexElementSemantic::TEXTURE_COORDINATES);
+
+    auto stats = MeshLayoutOptimiser::optimise(mesh.get());
+    EXPECT_EQ(stats.vertexDataChanged, 1u);
+    EXPECT_EQ(stats.buffersAfter, 2u);
+
+    // the positions alone, the other attributes interleaved
+    const VertexData* vertexData = getVertexData(mesh.get());
+    const VertexDeclaration* decl = vertexData->vertexDeclaration;
+    const VertexElement* position = decl->findElementBySemantic(VertexElementSemantic::POSITION);
+    EXPECT_EQ(position->getSource(), 0);
+    EXPECT_EQ(decl->findElementsBySource(0).size(), 1u);
+    EXPECT_EQ(vertexData->vertexBufferBinding->getBuffer(0)->getVertexSize(), 12u);
+    EXPECT_EQ(decl->findElementBySemantic(VertexElementSemantic::NORMAL)->getSource(), 1);
+    EXPECT_EQ(decl->findElementBySemantic(VertexElementSemantic::TEXTURE_COORDINATES)->getSource(), 1);
+
+    EXPECT_EQ(readElement(vertexData, VertexElementSemantic::POSITION), positions);
+    EXPECT_EQ(readElement(vertexData, VertexElementSemantic::NORMAL), normals);
+    EXPECT_EQ(readElement(vertexData, VertexElementSemantic::TEXTURE_COORDINATES), texCoords);
+
+    // already organised
+    stats = MeshLayoutOptimiser::optimise(mesh.get());
+    EXPECT_EQ(stats.vertexDataChanged, 0u);
+    EXPECT_EQ(stats.buffersBefore, stats.buffersAfter);
+}
+
+TEST_F(MeshLayoutOptimiserTests, MorphKeepsNormalsWithPositions)
+{
+    MeshPtr mesh = MeshManager::getSingleton().load("knot.mesh", RGN_DEFAULT);
+    VertexDeclaration* decl = MeshLayoutOptimiser::getOptimisedDeclaration(
+        getVertexData(mesh.get())->vertexDeclaration, false, true, true);
+
+    EXPECT_EQ(decl->findElementBySemantic(VertexElementSemantic::NORMAL)->getSource(), 0);
+    EXPECT_EQ(decl->findElementBySemantic(VertexElementSemantic::NORMAL)->getOffset(), 12u);
+    EXPECT_EQ(decl->findElementBySemantic(VertexElementSemantic::TEXTURE_COORDINATES)->getSource(), 1);
+    HardwareBufferManager::getSingleton().destroyVertexDeclaration(decl);
+}
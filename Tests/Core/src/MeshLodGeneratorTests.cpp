@@ -0,0 +1,157 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+module;
+
+#include <gtest/gtest.h>
+#include <cstddef>
+
+module Ogre.Tests;
+
+import :Core.RootWithoutRenderSystemFixture;
+
+import Ogre.Core;
+
+import <vector>;
+
+using namespace Ogre;
+
+using MeshLodGeneratorTests = RootWithoutRenderSystemFixture;
+
+namespace {
+    auto lodIndexCount(const Mesh* mesh, ushort level) -> size_t
+    {
+        size_t count = 0;
+        for (auto sub : mesh->getSubMeshes())
+            count += level == 0 ? sub->indexData->indexCount : sub->mLodFaceList[level - 1]->indexCount;
+        return count;
+    }
+}
+
+TEST_F(MeshLodGeneratorTests, SimplifyKeepsBorders)
+{
+    // flat 10x10 grid, only the interior vertices can be collapsed
+    std::vector<Vector3> positions;
+    std::vector<uint32> indices;
+    for (int y = 0; y <= 10; ++y)
+        for (int x = 0; x <= 10; ++x)
+            positions.push_back({Real(x), Real(y), 0});
+    for (uint32 y = 0; y < 10; ++y)
+    {
+        for (uint32 x = 0; x < 10; ++x)
+        {
+            uint32 a = y * 11 + x, b = a + 11;
+            indices.insert(indices.end(), {a, b, a + 1, a + 1, b, b + 1});
+        }
+    }
+
+    auto result = MeshLodGenerator::simplify(positions, indices, 0);
+    // a fan over the 40 border vertices
+    EXPECT_EQ(result.size(), 38u * 3);
+
+    std::vector<bool> used(positions.size());
+    for (size_t i = 0; i < result.size(); i += 3)
+    {
+        const Vector3& p0 = positions[result[i]];
+        Vector3 n = (positions[result[i + 1]] - p0).crossProduct(positions[result[i + 2]] - p0);
+        EXPECT_LT(n.z, 0);
+        for (size_t k = 0; k < 3; ++k)
+            used[result[i + k]] = true;
+    }
+    for (int i = 0; i <= 10; ++i)
+    {
+        EXPECT_TRUE(used[i]);
+        EXPECT_TRUE(used[110 + i]);
+        EXPECT_TRUE(used[i * 11]);
+        EXPECT_TRUE(used[i * 11 + 10]);
+    }
+
+    EXPECT_EQ(MeshLodGenerator::simplify(positions, indices, 300).size(), 300u);
+}
+
+TEST_F(MeshLodGeneratorTests, GeneratesIndexOnlyLevels)
+{
+    MeshPtr mesh = MeshManager::getSingleton().load("sphere.mesh", RGN_DEFAULT);
+    size_t vertexCount = mesh->sharedVertexData ? mesh->sharedVertexData->vertexCount
+                                                : mesh->getSubMeshes()[0]->vertexData->vertexCount;
+
+    MeshLodGenerator::generateLodLevels(mesh.get(), {{100, 0.5}, {200, 0.8}});
+    ASSERT_EQ(mesh->getNumLodLevels(), 3);
+
+    size_t full = lodIndexCount(mesh.get(), 0);
+    EXPECT_LE(lodIndexCount(mesh.get(), 1), full / 2);
+    EXPECT_LT(lodIndexCount(mesh.get(), 2), lodIndexCount(mesh.get(), 1));
+    EXPECT_GT(lodIndexCount(mesh.get(), 2), 0u);
+
+    for (auto sub : mesh->getSubMeshes())
+    {
+        for (IndexData* lod : sub->mLodFaceList)
+        {
+            ASSERT_EQ(lod->indexBuffer->getType(), sub->indexData->indexBuffer->getType());
+            HardwareBufferLockGuard lock(lod->indexBuffer, HardwareBuffer::LockOptions::READ_ONLY);
+            for (size_t i = 0; i < lod->indexCount; ++i)
+            {
+                size_t index = lod->indexBuffer->getType() == HardwareIndexBuffer::IndexType::_32BIT
+                    ? static_cast<uint32*>(lock.pData)[i] : static_cast<uint16*>(lock.pData)[i];
+                EXPECT_LT(index, vertexCount);
+            }
+        }
+    }
+
+    // the default distance strategy selects them by distance
+    const LodStrategy* strategy = mesh->getLodStrategy();
+    EXPECT_EQ(mesh->getLodIndex(strategy->transformUserValue(50)), 0);
+    EXPECT_EQ(mesh->getLodIndex(strategy->transformUserValue(150)), 1);
+    EXPECT_EQ(mesh->getLodIndex(strategy->transformUserValue(300)), 2);
+}
+
+TEST_F(MeshLodGeneratorTests, PixelCountStrategy)
+{
+    MeshPtr mesh = MeshManager::getSingleton().load("sphere.mesh", RGN_DEFAULT);
+    mesh->setLodStrategy(&AbsolutePixelCountLodStrategy::getSingleton());
+
+    // pixel counts decrease with the detail
+    EXPECT_THROW(MeshLodGenerator::generateLodLevels(mesh.get(), {{1000, 0.5}, {10000, 0.8}}),
+                 InvalidParametersException);
+
+    MeshLodGenerator::generateLodLevels(mesh.get(), {{10000, 0.5}, {1000, 0.8}});
+    ASSERT_EQ(mesh->getNumLodLevels(), 3);
+    const LodStrategy* strategy = mesh->getLodStrategy();
+    EXPECT_EQ(mesh->getLodIndex(strategy->transformUserValue(100000)), 0);
+    EXPECT_EQ(mesh->getLodIndex(strategy->transformUserValue(5000)), 1);
+    EXPECT_EQ(mesh->getLodIndex(strategy->transformUserValue(100)), 2);
+}
+
+TEST_F(MeshLodGeneratorTests, GeneratesOnLoad)
+{
+    MeshManager::getSingleton().setAutoLodLevels({{100, 0.5}});
+    MeshPtr mesh = MeshManager::getSingleton().load("knot.mesh", RGN_DEFAULT);
+    MeshManager::getSingleton().setAutoLodLevels({});
+
+    ASSERT_EQ(mesh->getNumLodLevels(), 2);
+    EXPECT_LE(lodIndexCount(mesh.get(), 1), lodIndexCount(mesh.get(), 0) / 2 + 3);
+}
@@ -0,0 +1,144 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+module;
+
+#include <gtest/gtest.h>
+#include <cstddef>
+
+module Ogre.Tests;
+
+import :Core.RootWithoutRenderSystemFixture;
+
+import Ogre.Core;
+
+import <algorithm>;
+import <array>;
+import <numeric>;
+import <random>;
+import <vector>;
+
+using namespace Ogre;
+
+using MeshOptimiserTests = RootWithoutRenderSystemFixture;
+
+namespace {
+    using Triangle = std::array<Real, 9>;
+
+    /// The triangles of all full detail SubMeshes by position
+    auto collectTriangles(const Mesh* mesh) -> std::vector<Triangle>
+    {
+        std::vector<Triangle> triangles;
+        for (auto sub : mesh->getSubMeshes())
+        {
+            const VertexData* vertexData = sub->useSharedVertices ? mesh->sharedVertexData : sub->vertexData.get();
+            const VertexElement* elemPos =
+                vertexData->vertexDeclaration->findElementBySemantic(VertexElementSemantic::POSITION);
+            HardwareVertexBufferSharedPtr vbuf = vertexData->vertexBufferBinding->getBuffer(elemPos->getSource());
+            HardwareBufferLockGuard vertexLock(vbuf, HardwareBuffer::LockOptions::READ_ONLY);
+            const IndexData* indexData = sub->indexData.get();
+            HardwareBufferLockGuard indexLock(indexData->indexBuffer, HardwareBuffer::LockOptions::READ_ONLY);
+
+            for (size_t i = 0; i + 2 < indexData->indexCount; i += 3)
+            {
+                Triangle t;
+                for (size_t k = 0; k < 3; ++k)
+                {
+                    size_t index = indexData->indexStart + i + k;
+                    size_t v = indexData->indexBuffer->getType() == HardwareIndexBuffer::IndexType::_32BIT
+                        ? static_cast<uint32*>(indexLock.pData)[index] : static_cast<uint16*>(indexLock.pData)[index];
+                    auto* vertex = static_cast<unsigned char*>(vertexLock.pData) +
+                                   (vertexData->vertexStart + v) * vbuf->getVertexSize();
+                    float* pFloat;
+                    elemPos->baseVertexPointerToElement(vertex, &pFloat);
+                    std::copy_n(pFloat, 3, &t[k * 3]);
+                }
+                triangles.push_back(t);
+            }
+        }
+        std::ranges::sort(triangles);
+        return triangles;
+    }
+}
+
+TEST_F(MeshOptimiserTests, VertexCacheOrder)
+{
+    // 40x40 grid with the triangles in random order
+    std::vector<uint32> indices;
+    for (uint32 y = 0; y < 40; ++y)
+    {
+        for (uint32 x = 0; x < 40; ++x)
+        {
+            uint32 a = y * 41 + x, b = a + 41;
+            indices.insert(indices.end(), {a, b, a + 1, a + 1, b, b + 1});
+        }
+    }
+    std::vector<size_t> order(indices.size() / 3);
+    std::iota(order.begin(), order.end(), 0);
+    std::ranges::shuffle(order, std::minstd_rand{});
+    std::vector<uint32> shuffled;
+    for (size_t t : order)
+        shuffled.insert(shuffled.end(), indices.begin() + t * 3, indices.begin() + t * 3 + 3);
+
+    Real before = MeshOptimiser::calculateACMR(shuffled);
+    EXPECT_GT(before, 2.5);
+
+    std::vector<uint32> optimised = shuffled;
+    MeshOptimiser::optimiseVertexCache(optimised, 41 * 41);
+    EXPECT_LT(MeshOptimiser::calculateACMR(optimised), 0.8);
+
+    // same triangles, same winding
+    auto sortedTriangles = [](const std::vector<uint32>& list)
+    {
+        std::vector<std::array<uint32, 3>> triangles;
+        for (size_t i = 0; i < list.size(); i += 3)
+            triangles.push_back({list[i], list[i + 1], list[i + 2]});
+        std::ranges::sort(triangles);
+        return triangles;
+    };
+    EXPECT_EQ(sortedTriangles(optimised), sortedTriangles(shuffled));
+
+    std::span<const uint32> lists[] = {optimised};
+    auto remap = MeshOptimiser::buildVertexFetchRemap(lists, 41 * 41 + 1);
+    EXPECT_EQ(remap[optimised[0]], 0u);
+    EXPECT_EQ(remap.back(), 41u * 41);
+}
+
+TEST_F(MeshOptimiserTests, OptimiseMesh)
+{
+    MeshPtr mesh = MeshManager::getSingleton().load("knot.mesh", RGN_DEFAULT);
+    auto triangles = collectTriangles(mesh.get());
+
+    auto stats = MeshOptimiser::optimise(mesh.get());
+    EXPECT_GT(stats.acmrBefore, 0);
+    EXPECT_LE(stats.acmrAfter, stats.acmrBefore * 1.05f);
+
+    // vertices moved, but the surface is unchanged
+    EXPECT_EQ(collectTriangles(mesh.get()), triangles);
+    for (auto sub : mesh->getSubMeshes())
+        EXPECT_EQ(sub->indexData->indexBuffer->getType(), HardwareIndexBuffer::IndexType::_16BIT);
+}
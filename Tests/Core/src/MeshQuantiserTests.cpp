@@ -0,0 +1,131 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+module;
+
+#include <gtest/gtest.h>
+#include <cstddef>
+#include <cstring>
+
+module Ogre.Tests;
+
+import :Core.RootWithoutRenderSystemFixture;
+
+import Ogre.Core;
+
+import <algorithm>;
+import <cmath>;
+import <vector>;
+
+using namespace Ogre;
+
+using MeshQuantiserTests = RootWithoutRenderSystemFixture;
+
+namespace {
+    auto decodeSnorm10(uint32 bits) -> float { return std::max(float(int32(bits << 22) >> 22) / 511, -1.0f); }
+
+    /// The values of an element of all vertices, decoded to floats
+    auto readElement(const VertexData* vertexData, VertexElementSemantic semantic) -> std::vector<float>
+    {
+        const VertexElement* elem = vertexData->vertexDeclaration->findElementBySemantic(semantic);
+        HardwareVertexBufferSharedPtr vbuf = vertexData->vertexBufferBinding->getBuffer(elem->getSource());
+        HardwareBufferLockGuard lock(vbuf, HardwareBuffer::LockOptions::READ_ONLY);
+
+        std::vector<float> values;
+        for (size_t v = 0; v < vertexData->vertexCount; ++v)
+        {
+            auto* vertex = static_cast<unsigned char*>(lock.pData) + (vertexData->vertexStart + v) * vbuf->getVertexSize();
+            auto* data = vertex + elem->getOffset();
+            switch (elem->getType())
+            {
+            case VertexElementType::FLOAT2:
+            case VertexElementType::FLOAT3:
+                for (unsigned short c = 0; c < elem->getTypeCount(elem->getType()); ++c)
+                    values.push_back(reinterpret_cast<float*>(data)[c]);
+                break;
+            case VertexElementType::HALF2:
+                for (unsigned short c = 0; c < 2; ++c)
+                    values.push_back(Bitwise::halfToFloat(reinterpret_cast<uint16*>(data)[c]));
+                break;
+            case VertexElementType::INT_10_10_10_2_NORM:
+            {
+                uint32 packed;
+                std::memcpy(&packed, data, sizeof(packed));
+                for (unsigned short c = 0; c < 3; ++c)
+                    values.push_back(decodeSnorm10(packed >> (c * 10)));
+                break;
+            }
+            default:
+                ADD_FAILURE() << "unexpected vertex element type";
+            }
+        }
+        return values;
+    }
+
+    auto getVertexData(const Mesh* mesh) -> const VertexData*
+    {
+        const SubMesh* sub = mesh->getSubMeshes().front();
+        return sub->useSharedVertices ? mesh->sharedVertexData : sub->vertexData.get();
+    }
+}
+
+TEST_F(MeshQuantiserTests, PackInt1010102)
+{
+    uint32 packed = MeshQuantiser::packInt1010102(1, -1, 0, -1);
+    EXPECT_EQ(packed & 0x3FF, 511u);
+    EXPECT_FLOAT_EQ(decodeSnorm10(packed >> 10), -1);
+    EXPECT_EQ((packed >> 20) & 0x3FF, 0u);
+    EXPECT_EQ(packed >> 30, 3u);
+}
+
+TEST_F(MeshQuantiserTests, QuantiseMesh)
+{
+    MeshPtr mesh = MeshManager::getSingleton().load("knot.mesh", RGN_DEFAULT);
+    auto normals = readElement(getVertexData(mesh.get()), VertexElementSemantic::NORMAL);
+    auto texCoords = readElement(getVertexData(mesh.get()), VertexElementSemantic::TEXTURE_COORDINATES);
+
+    auto stats = MeshQuantiser::quantise(mesh.get());
+    EXPECT_LT(stats.bytesAfter, stats.bytesBefore);
+
+    const VertexData* vertexData = getVertexData(mesh.get());
+    const VertexDeclaration* decl = vertexData->vertexDeclaration;
+    EXPECT_EQ(decl->findElementBySemantic(VertexElementSemantic::POSITION)->getType(), VertexElementType::FLOAT3);
+    EXPECT_EQ(decl->findElementBySemantic(VertexElementSemantic::NORMAL)->getType(),
+              VertexElementType::INT_10_10_10_2_NORM);
+    EXPECT_EQ(decl->findElementBySemantic(VertexElementSemantic::TEXTURE_COORDINATES)->getType(),
+              VertexElementType::HALF2);
+
+    auto quantisedNormals = readElement(vertexData, VertexElementSemantic::NORMAL);
+    ASSERT_EQ(quantisedNormals.size(), normals.size());
+    for (size_t i = 0; i < normals.size(); ++i)
+        EXPECT_NEAR(quantisedNormals[i], normals[i], 1.0f / 511);
+
+    auto quantisedTexCoords = readElement(vertexData, VertexElementSemantic::TEXTURE_COORDINATES);
+    ASSERT_EQ(quantisedTexCoords.size(), texCoords.size());
+    for (size_t i = 0; i < texCoords.size(); ++i)
+        EXPECT_NEAR(quantisedTexCoords[i], texCoords[i], MeshQuantiser::MAX_TEXCOORD_ERROR);
+}
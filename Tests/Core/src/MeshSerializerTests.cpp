@@ -162,6 +162,41 @@ TEST_F(MeshSerializerTests,Skeleton_Version_1_8)
     }
 }
 //--------------------------------------------------------------------------
+TEST_F(MeshSerializerTests,Skeleton_Version_2_0)
+{
+    if (mSkeleton) {
+        Animation* anim = mSkeleton->getAnimation(0);
+        String animName{anim->getName()};
+        const auto& [handle, track] = *anim->_getNodeTrackList().begin();
+        size_t numKeys = track->getNumKeyFrames();
+        auto key = static_cast<unsigned short>(numKeys / 2);
+        Real time = track->getNodeKeyFrame(key)->getTime();
+        Quaternion rotate = track->getNodeKeyFrame(key)->getRotation();
+        Vector3 translate = track->getNodeKeyFrame(key)->getTranslate();
+        unsigned short trackHandle = handle;
+
+        SkeletonSerializer skeletonSerializer;
+        skeletonSerializer.exportSkeleton(mSkeleton.get(), mSkeletonFullPath, SkeletonVersion::_2_0);
+        mSkeleton->setDeferAnimationTracks(true);
+        mSkeleton->reload();
+
+        unsigned short numAnims = mSkeleton->getNumAnimations();
+        EXPECT_EQ(mSkeleton->getNumDeferredAnimations(), numAnims);
+        EXPECT_TRUE(mSkeleton->hasAnimation(animName));
+        EXPECT_EQ(mSkeleton->getNumDeferredAnimations(), numAnims);
+
+        NodeAnimationTrack* loaded = mSkeleton->getAnimation(animName)->getNodeTrack(trackHandle);
+        EXPECT_EQ(mSkeleton->getNumDeferredAnimations(), numAnims - 1u);
+        ASSERT_EQ(loaded->getNumKeyFrames(), numKeys);
+        EXPECT_EQ(loaded->getNodeKeyFrame(key)->getTime(), time);
+        EXPECT_EQ(loaded->getNodeKeyFrame(key)->getRotation(), rotate);
+        EXPECT_EQ(loaded->getNodeKeyFrame(key)->getTranslate(), translate);
+
+        mSkeleton->loadDeferredAnimations();
+        EXPECT_EQ(mSkeleton->getNumDeferredAnimations(), 0u);
+    }
+}
+//--------------------------------------------------------------------------
 TEST_F(MeshSerializerTests,Skeleton_Version_1_0)
 {
     if (mSkeleton) {
@@ -171,11 +206,16 @@ TEST_F(MeshSerializerTests,Skeleton_Version_1_0)
     }
 }
 //--------------------------------------------------------------------------
-TEST_F(MeshSerializerTests,Mesh_Version_1_10)
+TEST_F(MeshSerializerTests,Mesh_Version_1_11)
 {
     testMesh(MeshVersion::LATEST);
 }
 //--------------------------------------------------------------------------
+TEST_F(MeshSerializerTests,Mesh_Version_1_10)
+{
+    testMesh(MeshVersion::_1_10);
+}
+//--------------------------------------------------------------------------
 TEST_F(MeshSerializerTests,Mesh_Version_1_8)
 {
     testMesh(MeshVersion::_1_8);
@@ -0,0 +1,187 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+module;
+
+#include <gtest/gtest.h>
+#include <cstddef>
+
+module Ogre.Tests;
+
+import :Core.RootWithoutRenderSystemFixture;
+
+import Ogre.Core;
+
+import <memory>;
+import <random>;
+import <set>;
+import <string>;
+import <vector>;
+
+using namespace Ogre;
+
+struct OctreeSceneManagerTest : public RootWithoutRenderSystemFixture {
+    OctreeSceneManager* mSceneMgr;
+    Camera* mCamera;
+    Entity* mEntity;
+
+    void SetUp() override {
+        RootWithoutRenderSystemFixture::SetUp();
+
+        mSceneMgr = static_cast<OctreeSceneManager*>(
+            mRoot->createSceneManager(OctreeSceneManagerFactory::FACTORY_TYPE_NAME));
+        mCamera = mSceneMgr->createCamera("Camera");
+        SceneNode* cameraNode = mSceneMgr->getRootSceneNode()->createChildSceneNode();
+        cameraNode->attachObject(mCamera);
+        cameraNode->setPosition(0, 0, 500);
+        cameraNode->lookAt(Vector3{0, 0, 0}, Node::TransformSpace::PARENT);
+
+        mEntity = mSceneMgr->createEntity("sphere.mesh");
+
+        // we want cross platform consistent sequence
+        std::minstd_rand rng;
+        for (int i = 0; i < 500; ++i)
+        {
+            Vector3 pos{Real(rng() % 5000) - 2500, Real(rng() % 5000) - 2500, Real(rng() % 5000) - 2500};
+            SceneNode* node = mSceneMgr->getRootSceneNode()->createChildSceneNode(pos);
+            node->attachObject(mEntity->clone(std::to_string(i)));
+        }
+
+        mSceneMgr->_updateSceneGraph(mCamera);
+    }
+
+    auto findVisibleNodes() -> std::set<const SceneNode*>
+    {
+        std::set<const SceneNode*> visible;
+        mSceneMgr->getOctree().walk([this](const AxisAlignedBox& box) { return mCamera->isVisible(box); },
+                                    [&](OctreeSceneNode* node)
+                                    {
+                                        if (mCamera->isVisible(node->getObjectBounds()))
+                                            visible.insert(node);
+                                        return true;
+                                    });
+        return visible;
+    }
+
+    auto bruteForceVisibleNodes() -> std::set<const SceneNode*>
+    {
+        std::set<const SceneNode*> visible;
+        for (auto node : mSceneMgr->getRootSceneNode()->getChildren())
+        {
+            auto sn = static_cast<SceneNode*>(node);
+            if (!sn->getAttachedObjects().empty() && mCamera->isVisible(sn->_getWorldAABB()))
+                visible.insert(sn);
+        }
+        return visible;
+    }
+};
+TEST_F(OctreeSceneManagerTest, FindsSameNodesAsBruteForce)
+{
+    // all nodes with objects are indexed, the empty root is not
+    EXPECT_EQ(mSceneMgr->getOctree().getNumNodes(), 501u);
+
+    auto visible = findVisibleNodes();
+    EXPECT_FALSE(visible.empty());
+    EXPECT_EQ(visible, bruteForceVisibleNodes());
+}
+TEST_F(OctreeSceneManagerTest, RelocatesMovedNodes)
+{
+    auto node = static_cast<OctreeSceneNode*>(mSceneMgr->getRootSceneNode()->getChildren().back());
+    auto octant = node->getOctant();
+    ASSERT_TRUE(octant);
+
+    node->setPosition(octant->cellBounds.getCenter() + octant->cellBounds.getSize());
+    mSceneMgr->_updateSceneGraph(mCamera);
+    EXPECT_NE(node->getOctant(), octant);
+    EXPECT_TRUE(node->getOctant()->looseBounds.contains(node->getObjectBounds()));
+    EXPECT_EQ(findVisibleNodes(), bruteForceVisibleNodes());
+
+    // detached subtrees leave the octree
+    mSceneMgr->getRootSceneNode()->removeChild(node);
+    EXPECT_EQ(node->getOctant(), nullptr);
+    EXPECT_EQ(mSceneMgr->getOctree().getNumNodes(), 500u);
+}
+TEST_F(OctreeSceneManagerTest, QueriesMatchDefaultImplementation)
+{
+    auto toSet = [](const SceneQueryResult& result)
+    { return std::set<MovableObject*>{result.movables.begin(), result.movables.end()}; };
+    auto raySet = [](const RaySceneQueryResult& result)
+    {
+        std::set<MovableObject*> movables;
+        for (const auto& entry : result)
+            movables.insert(entry.movable);
+        return movables;
+    };
+
+    AxisAlignedBox box{AxisAlignedBox::Extent::Finite, Vector3{-800, -800, -800}, Vector3{800, 800, 800}};
+    std::unique_ptr<AxisAlignedBoxSceneQuery> boxQuery{mSceneMgr->createAABBQuery(box)};
+    DefaultAxisAlignedBoxSceneQuery defaultBoxQuery{mSceneMgr};
+    defaultBoxQuery.setBox(box);
+    auto boxResult = toSet(boxQuery->execute());
+    EXPECT_FALSE(boxResult.empty());
+    EXPECT_EQ(boxResult, toSet(defaultBoxQuery.execute()));
+
+    Sphere sphere{Vector3{500, 0, 0}, 1000};
+    std::unique_ptr<SphereSceneQuery> sphereQuery{mSceneMgr->createSphereQuery(sphere)};
+    DefaultSphereSceneQuery defaultSphereQuery{mSceneMgr};
+    defaultSphereQuery.setSphere(sphere);
+    auto sphereResult = toSet(sphereQuery->execute());
+    EXPECT_FALSE(sphereResult.empty());
+    EXPECT_EQ(sphereResult, toSet(defaultSphereQuery.execute()));
+
+    Ray ray{Vector3{-3000, 0, 0}, Vector3{1, 0.1f, 0.2f}.normalisedCopy()};
+    auto rayQuery = mSceneMgr->createRayQuery(ray);
+    DefaultRaySceneQuery defaultRayQuery{mSceneMgr};
+    defaultRayQuery.setRay(ray);
+    EXPECT_EQ(raySet(rayQuery->execute()), raySet(defaultRayQuery.execute()));
+}
+TEST_F(OctreeSceneManagerTest, RayBatchMatchesSingleRays)
+{
+    // aim at some of the nodes, so every ray has at least one hit
+    std::vector<Ray> rays;
+    Vector3 origin{0, 0, 500};
+    for (auto node : mSceneMgr->getRootSceneNode()->getChildren())
+    {
+        if (rays.size() == 16)
+            break;
+        if (node->_getDerivedPosition() != origin)
+            rays.push_back(Ray{origin, (node->_getDerivedPosition() - origin).normalisedCopy()});
+    }
+
+    auto batchQuery = mSceneMgr->createRayBatchQuery(rays);
+    batchQuery->setSortByDistance(true);
+    auto& batchResult = batchQuery->execute();
+    ASSERT_EQ(batchResult.size(), rays.size());
+
+    for (size_t i = 0; i < rays.size(); ++i)
+    {
+        auto rayQuery = mSceneMgr->createRayQuery(rays[i]);
+        rayQuery->setSortByDistance(true);
+        EXPECT_FALSE(batchResult[i].empty());
+        EXPECT_EQ(batchResult[i], rayQuery->execute());
+    }
+}
@@ -244,3 +244,29 @@ TEST_F(PixelFormatTests,BulkConversion)
     testCase(PixelFormat::X8B8G8R8, PixelFormat::R8G8B8A8);
 }
 //--------------------------------------------------------------------------
+//--------------------------------------------------------------------------
+TEST_F(PixelFormatTests,VectorisedConversion)
+{
+    // Swizzles and luminance expansion
+    testCase(PixelFormat::BYTE_LA, PixelFormat::A8B8G8R8);
+    testCase(PixelFormat::BYTE_LA, PixelFormat::R8G8B8);
+    testCase(PixelFormat::L8, PixelFormat::B8G8R8);
+    testCase(PixelFormat::R8G8B8A8, PixelFormat::BYTE_LA);
+    testCase(PixelFormat::B8G8R8, PixelFormat::R8G8B8A8);
+
+    // 8 bit and float
+    testCase(PixelFormat::R8G8B8, PixelFormat::FLOAT32_RGBA);
+    testCase(PixelFormat::A8R8G8B8, PixelFormat::FLOAT32_RGB);
+    testCase(PixelFormat::L8, PixelFormat::FLOAT32_R);
+    testCase(PixelFormat::BYTE_LA, PixelFormat::FLOAT32_GR);
+    testCase(PixelFormat::FLOAT32_RGBA, PixelFormat::A8B8G8R8);
+    testCase(PixelFormat::FLOAT32_RGB, PixelFormat::B8G8R8A8);
+    testCase(PixelFormat::FLOAT32_GR, PixelFormat::R8G8B8);
+    testCase(PixelFormat::FLOAT32_R, PixelFormat::L8);
+
+    // Half and float
+    testCase(PixelFormat::FLOAT16_RGBA, PixelFormat::FLOAT32_RGBA);
+    testCase(PixelFormat::FLOAT16_GR, PixelFormat::FLOAT32_GR);
+    testCase(PixelFormat::FLOAT32_RGBA, PixelFormat::FLOAT16_RGBA);
+    testCase(PixelFormat::FLOAT32_R, PixelFormat::FLOAT16_R);
+}
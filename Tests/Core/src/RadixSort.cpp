@@ -37,6 +37,7 @@ import :Core.RadixSort;
 
 import Ogre.Core;
 
+import <algorithm>;
 import <list>;
 import <vector>;
 
@@ -216,3 +217,39 @@ TEST_F(RadixSortTests,IntVector)
     }
 }
 //--------------------------------------------------------------------------
+TEST_F(RadixSortTests,UnsignedInt64Vector)
+{
+    std::vector<uint64> container;
+    RadixSort<std::vector<uint64>, uint64, uint64> sorter;
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        // differing in the upper and the lower half
+        container.push_back((uint64(rand() % 16) << 32) | uint32(UINT_MAX * double(Math::UnitRandom())));
+    }
+
+    sorter.sort(container, [](const uint64& p) { return p; });
+
+    EXPECT_TRUE(std::is_sorted(container.begin(), container.end()));
+}
+//--------------------------------------------------------------------------
+TEST_F(RadixSortTests,DoubleAndInt16Vector)
+{
+    std::vector<double> doubles;
+    RadixSort<std::vector<double>, double, double> doubleSorter;
+    std::vector<int16> shorts;
+    RadixSort<std::vector<int16>, int16, int16> shortSorter;
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        doubles.push_back(Math::RangeRandom(-1e10, 1e10) * 1e100);
+        shorts.push_back(int16(rand() % 65536 - 32768));
+    }
+
+    doubleSorter.sort(doubles, [](const double& p) { return p; });
+    shortSorter.sort(shorts, [](const int16& p) { return p; });
+
+    EXPECT_TRUE(std::is_sorted(doubles.begin(), doubles.end()));
+    EXPECT_TRUE(std::is_sorted(shorts.begin(), shorts.end()));
+}
+//--------------------------------------------------------------------------
@@ -366,6 +366,7 @@ TEST_F(RenderSystemCapabilitiesTests,WriteAllTrueCapabilities)
     caps.setCapability(Capabilities::PERSTAGECONSTANT);
     caps.setCapability(Capabilities::SEPARATE_SHADER_OBJECTS);
     caps.setCapability(Capabilities::VAO);
+    caps.setCapability(Capabilities::MULTI_DRAW);
 
     // write them to file
     serializer.writeScript(&caps, name, filename);
@@ -424,6 +425,7 @@ TEST_F(RenderSystemCapabilitiesTests,WriteAllTrueCapabilities)
     EXPECT_TRUE(find(lines.begin(), lines.end(), "\tperstageconstant true") != lines.end());
     EXPECT_TRUE(find(lines.begin(), lines.end(), "\tseparate_shader_objects true") != lines.end());
     EXPECT_TRUE(find(lines.begin(), lines.end(), "\tvao true") != lines.end());
+    EXPECT_TRUE(find(lines.begin(), lines.end(), "\tmulti_draw true") != lines.end());
 }
 //--------------------------------------------------------------------------
 TEST_F(RenderSystemCapabilitiesTests,WriteAndReadComplexCapabilities)
@@ -549,3 +551,34 @@ TEST_F(RenderSystemCapabilitiesTests,WriteAndReadComplexCapabilities)
     dataStreamPtr.reset();
 }
 //--------------------------------------------------------------------------
+TEST_F(RenderSystemCapabilitiesTests,WriteAndReadCachedCapabilities)
+{
+    using namespace Ogre;
+    using namespace std;
+    String name = "cached caps";
+
+    // what the render systems probe besides the .rendercaps of the media
+    RenderSystemCapabilitiesSerializer serializer;
+    RenderSystemCapabilities caps;
+    caps.setCapability(Capabilities::TEXTURE_2D_ARRAY);
+    caps.setCapability(Capabilities::VERTEX_BUFFER_INSTANCE_DATA);
+    caps.setCapability(Capabilities::CAN_GET_COMPILED_SHADER_BUFFER);
+    caps.setCapability(Capabilities::HW_GAMMA);
+    caps.setMaxSupportedAnisotropy(16);
+    caps.setNumVertexAttributes(29);
+
+    String script = serializer.writeString(&caps, name);
+    DataStreamPtr stream(new MemoryDataStream(script.data(), script.size()));
+    serializer.parseScript(stream);
+
+    RenderSystemCapabilities* caps2 = RenderSystemCapabilitiesManager::getSingleton().loadParsedCapabilities(name);
+    ASSERT_TRUE(caps2 != nullptr);
+    EXPECT_TRUE(caps2->hasCapability(Capabilities::TEXTURE_2D_ARRAY));
+    EXPECT_FALSE(caps2->hasCapability(Capabilities::TEXTURE_3D));
+    EXPECT_TRUE(caps2->hasCapability(Capabilities::VERTEX_BUFFER_INSTANCE_DATA));
+    EXPECT_TRUE(caps2->hasCapability(Capabilities::CAN_GET_COMPILED_SHADER_BUFFER));
+    EXPECT_TRUE(caps2->hasCapability(Capabilities::HW_GAMMA));
+    EXPECT_EQ(caps2->getMaxSupportedAnisotropy(), 16);
+    EXPECT_EQ(caps2->getNumVertexAttributes(), 29);
+}
+//--------------------------------------------------------------------------
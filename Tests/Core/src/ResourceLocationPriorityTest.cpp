@@ -35,7 +35,11 @@ import :Core.ResourceLocationPriority;
 
 import Ogre.Core;
 
+import <filesystem>;
+import <fstream>;
+import <iterator>;
 import <memory>;
+import <string>;
 
 TEST(ResourceGroupLocationTest, ResourceLocationPriority)
 {
@@ -61,3 +65,57 @@ TEST(ResourceGroupLocationTest, ResourceLocationPriority)
     resGrpMgr.removeResourceLocation("ResourceLocationPriority0");
     resGrpMgr.removeResourceLocation("ResourceLocationPriority1");
 }
+
+TEST(ResourceGroupLocationTest, ResourceIndex)
+{
+    std::unique_ptr<DummyArchiveFactory> fact = std::make_unique<DummyArchiveFactory>();
+    Ogre::Root root("");
+    Ogre::ArchiveManager::getSingleton().addArchiveFactory(fact.get());
+
+    Ogre::ResourceGroupManager& resGrpMgr = Ogre::ResourceGroupManager::getSingleton();
+    resGrpMgr.addResourceLocation("ResourceIndexB", "DummyArchive", "B");
+    resGrpMgr.addResourceLocation("ResourceIndexA", "DummyArchive", "A");
+
+    // groups are searched by name
+    EXPECT_TRUE(resGrpMgr.resourceExistsInAnyGroup("dummyArchiveTest"));
+    EXPECT_EQ(resGrpMgr.findGroupContainingResource("dummyArchiveTest"), "A");
+    EXPECT_FALSE(resGrpMgr.resourceExistsInAnyGroup("missing"));
+
+    resGrpMgr.removeResourceLocation("ResourceIndexA", "A");
+    EXPECT_FALSE(resGrpMgr.resourceExists("A", "dummyArchiveTest"));
+    EXPECT_EQ(resGrpMgr.findGroupContainingResource("dummyArchiveTest"), "B");
+
+    std::filesystem::path indexPath = std::filesystem::temp_directory_path() / "OgreResourceIndex.txt";
+    resGrpMgr.saveResourceIndex(indexPath.string());
+    resGrpMgr.destroyResourceGroup("B");
+    EXPECT_FALSE(resGrpMgr.resourceExistsInAnyGroup("dummyArchiveTest"));
+
+    // edit the cached names, to tell them apart from a scan of the archive
+    std::string text;
+    {
+        std::ifstream in{indexPath};
+        text.assign(std::istreambuf_iterator<char>{in}, {});
+    }
+    auto pos = text.find("\ndummyArchiveTest\n");
+    ASSERT_NE(pos, std::string::npos);
+    text.replace(pos + 1, 16, "cachedName");
+    {
+        std::ofstream out{indexPath};
+        out << text;
+    }
+
+    EXPECT_TRUE(resGrpMgr.loadResourceIndex(indexPath.string()));
+    resGrpMgr.addResourceLocation("ResourceIndexB", "DummyArchive", "C");
+    EXPECT_TRUE(resGrpMgr.resourceExists("C", "cachedName"));
+    EXPECT_FALSE(resGrpMgr.resourceExists("C", "dummyArchiveTest"));
+
+    // other locations are still listed
+    resGrpMgr.addResourceLocation("ResourceIndexA", "DummyArchive", "C");
+    EXPECT_TRUE(resGrpMgr.resourceExists("C", "dummyArchiveTest"));
+
+    EXPECT_FALSE(resGrpMgr.loadResourceIndex("missing.index"));
+    std::filesystem::remove(indexPath);
+
+    resGrpMgr.removeResourceLocation("ResourceIndexB", "C");
+    resGrpMgr.removeResourceLocation("ResourceIndexA", "C");
+}
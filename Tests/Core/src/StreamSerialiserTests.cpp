@@ -34,6 +34,11 @@ module Ogre.Tests;
 
 import Ogre.Core;
 
+import <algorithm>;
+import <memory>;
+import <random>;
+import <vector>;
+
 using namespace Ogre;
 //--------------------------------------------------------------------------
 TEST(StreamSerialiserTests,WriteBasic)
@@ -94,3 +99,41 @@ TEST(StreamSerialiserTests,WriteBasic)
     factory.destroyInstance(arch);
 }
 //--------------------------------------------------------------------------
+//--------------------------------------------------------------------------
+TEST(StreamSerialiserTests,DeflateStreamSeek)
+{
+    std::vector<unsigned char> data(200000);
+    std::minstd_rand rng;
+    for (auto& c : data)
+        c = static_cast<unsigned char>(rng() % 16);
+
+    auto compressed = std::make_shared<MemoryDataStream>(data.size());
+    {
+        DeflateStream deflate(compressed);
+        deflate.setStreamingWrite(true);
+        EXPECT_EQ(deflate.write(data.data(), data.size()), data.size());
+        EXPECT_EQ(deflate.tell(), data.size());
+    }
+
+    auto input = std::make_shared<MemoryDataStream>(compressed->getPtr(), compressed->tell(), false, true);
+    DeflateStream inflate(input);
+    ASSERT_TRUE(inflate.isCompressedStreamValid());
+    inflate.setRestartInterval(4096);
+
+    std::vector<unsigned char> out(1000);
+    auto readAt = [&](size_t pos)
+    {
+        inflate.seek(pos);
+        EXPECT_EQ(inflate.tell(), pos);
+        size_t count = inflate.read(out.data(), out.size());
+        EXPECT_EQ(count, std::min(out.size(), data.size() - pos));
+        return std::equal(out.begin(), out.begin() + count, data.begin() + pos);
+    };
+
+    // forwards past the read data, back to restart points and within the cache
+    for (size_t pos : {150000u, 1000u, 70000u, 70500u, 69900u, 199500u, 5u})
+        EXPECT_TRUE(readAt(pos)) << pos;
+
+    inflate.skip(-500);
+    EXPECT_EQ(inflate.tell(), 505u);
+}
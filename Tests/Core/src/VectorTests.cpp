@@ -33,6 +33,11 @@ module Ogre.Tests;
 
 import Ogre.Core;
 
+import <algorithm>;
+import <random>;
+import <utility>;
+import <vector>;
+
 using namespace Ogre;
 //--------------------------------------------------------------------------
 TEST(VectorTests,Vector2Scaler)
@@ -231,3 +236,289 @@ TEST(VectorTests, TypeCasts)
 
     EXPECT_EQ(imat.getTrans(), vec);
 }
+//--------------------------------------------------------------------------
+TEST(VectorTests, OptimisedBatches)
+{
+    // counts which are no multiple of the SIMD width, to cover the remainders too
+    constexpr size_t NUM_MATRICES = 11;
+    constexpr size_t NUM_QUATERNIONS = 19;
+    OptimisedUtil* util = OptimisedUtil::getImplementation();
+
+    Affine3 lhs[NUM_MATRICES], rhs[NUM_MATRICES], dst[NUM_MATRICES];
+    Matrix4 lhs4[NUM_MATRICES], rhs4[NUM_MATRICES], dst4[NUM_MATRICES];
+    Vector3 points[NUM_MATRICES], transformed[NUM_MATRICES];
+    for (size_t i = 0; i < NUM_MATRICES; ++i)
+    {
+        Vector3 axis = Vector3(1, Real(i), 2).normalisedCopy();
+        lhs[i] = Affine3::MakeTransform(Vector3(Real(i), 2, -3), Quaternion::FromAngleAndAxis(Radian(0.3f * i), axis),
+                                        Vector3(1, 2, 0.5f + i));
+        rhs[i] = Affine3::MakeTransform(Vector3(-1, Real(i), 4), Quaternion::FromAngleAndAxis(Radian(-0.7f * i), axis));
+        lhs4[i] = Matrix4::FromPtr(lhs[i][0]);
+        lhs4[i][3][0] = 0.25f * i;
+        rhs4[i] = Matrix4::FromPtr(rhs[i][0]);
+        rhs4[i][3][2] = -0.5f;
+        points[i] = Vector3(Real(i), -2.0f * i, 3);
+    }
+
+    auto expectNear = [](const TransformBaseReal& a, const TransformBaseReal& b)
+    {
+        for (size_t r = 0; r < 4; ++r)
+            for (size_t c = 0; c < 4; ++c)
+                EXPECT_NEAR(a[r][c], b[r][c], 1e-4f) << r << ", " << c;
+    };
+
+    util->multiplyMatrices(lhs4, rhs4, dst4, NUM_MATRICES);
+    for (size_t i = 0; i < NUM_MATRICES; ++i)
+        expectNear(dst4[i], lhs4[i] * rhs4[i]);
+
+    util->multiplyAffineMatrices(lhs, rhs, dst, NUM_MATRICES);
+    for (size_t i = 0; i < NUM_MATRICES; ++i)
+        expectNear(dst[i], lhs[i] * rhs[i]);
+
+    // in place
+    util->inverseAffineMatrices(dst, dst, NUM_MATRICES);
+    for (size_t i = 0; i < NUM_MATRICES; ++i)
+        expectNear(dst[i], (lhs[i] * rhs[i]).inverse());
+
+    util->transformPoints(lhs[3], points, transformed, NUM_MATRICES);
+    for (size_t i = 0; i < NUM_MATRICES; ++i)
+        EXPECT_TRUE(transformed[i].positionEquals(lhs[3] * points[i], 1e-4f));
+
+    util->transformDirections(lhs[3], points, transformed, NUM_MATRICES);
+    for (size_t i = 0; i < NUM_MATRICES; ++i)
+        EXPECT_TRUE(transformed[i].positionEquals(lhs[3].linear() * points[i], 1e-4f));
+
+    Quaternion from[NUM_QUATERNIONS], to[NUM_QUATERNIONS], result[NUM_QUATERNIONS];
+    float t[NUM_QUATERNIONS];
+    for (size_t i = 0; i < NUM_QUATERNIONS; ++i)
+    {
+        from[i] = Quaternion::FromAngleAndAxis(Radian(0.4f * i), Vector3(1, 1, Real(i)).normalisedCopy());
+        // beyond 180 degrees apart for some, which takes the other way round along the shortest path
+        to[i] = Quaternion::FromAngleAndAxis(Radian(-0.5f * i), Vector3(Real(i), 0, 1).normalisedCopy());
+        t[i] = i / Real(NUM_QUATERNIONS - 1);
+    }
+    // identical and opposite quaternions
+    to[2] = from[2];
+    to[5] = -from[5];
+
+    for (bool shortestPath : {true, false})
+    {
+        util->slerpQuaternions(from, to, t, result, NUM_QUATERNIONS, shortestPath);
+        for (size_t i = 0; i < NUM_QUATERNIONS; ++i)
+        {
+            Quaternion expected = Quaternion::Slerp(t[i], from[i], to[i], shortestPath);
+            for (size_t c = 0; c < 4; ++c)
+                EXPECT_NEAR(result[i][c], expected[c], 1e-5f) << i;
+        }
+
+        util->nlerpQuaternions(from, to, t, result, NUM_QUATERNIONS, shortestPath);
+        for (size_t i = 0; i < NUM_QUATERNIONS; ++i)
+        {
+            Quaternion expected = Quaternion::nlerp(t[i], from[i], to[i], shortestPath);
+            for (size_t c = 0; c < 4; ++c)
+                EXPECT_NEAR(result[i][c], expected[c], 1e-5f) << i;
+        }
+    }
+}
+//--------------------------------------------------------------------------
+TEST(VectorTests, OptimisedUtilMatchesGeneral)
+{
+    // counts which are no multiple of the SIMD widths, to cover the remainders too
+    constexpr size_t NUM_VERTICES = 37;
+    constexpr size_t NUM_MATRICES = 13;
+    constexpr size_t NUM_TRIANGLES = 29;
+    OptimisedUtil* util = OptimisedUtil::getImplementation();
+    OptimisedUtil* general = OptimisedUtil::_getGeneralImplementation();
+
+    std::minstd_rand rng;
+    std::uniform_real_distribution<float> dist{-10, 10};
+    auto randomFloats = [&](size_t count)
+    {
+        std::vector<float> values(count);
+        for (auto& v : values)
+            v = dist(rng);
+        return values;
+    };
+    auto expectNear = [](const float* result, const float* expected, size_t count, float tolerance)
+    {
+        for (size_t i = 0; i < count; ++i)
+            EXPECT_NEAR(result[i], expected[i], tolerance * std::max(1.0f, Math::Abs(expected[i]))) << i;
+    };
+
+    aligned_vector<Affine3> matrices(NUM_MATRICES), concatenated(NUM_MATRICES), expectedMatrices(NUM_MATRICES);
+    std::vector<const Affine3*> blendMatrices;
+    for (auto& m : matrices)
+    {
+        Vector3 axis = Vector3{dist(rng), dist(rng), 11}.normalisedCopy();
+        m = Affine3::MakeTransform(Vector3{dist(rng), dist(rng), dist(rng)},
+                                   Quaternion::FromAngleAndAxis(Radian(dist(rng)), axis), Vector3::UNIT_SCALE);
+        blendMatrices.push_back(&m);
+    }
+
+    // skinning, with positions and normals interleaved
+    for (size_t numWeights = 1; numWeights <= 4; ++numWeights)
+    {
+        auto src = randomFloats(NUM_VERTICES * 6);
+        std::vector<float> weights(NUM_VERTICES * numWeights);
+        std::vector<unsigned char> indices(weights.size());
+        for (size_t i = 0; i < weights.size(); ++i)
+        {
+            weights[i] = float(1 + rng() % 100) / (100.0f * numWeights);
+            indices[i] = static_cast<unsigned char>(rng() % NUM_MATRICES);
+        }
+        for (bool withNormals : {true, false})
+        {
+            std::vector<float> result(src.size()), expected(src.size());
+            for (auto [impl, dst] : {std::pair{general, &expected}, std::pair{util, &result}})
+                impl->softwareVertexSkinning(src.data(), dst->data(), withNormals ? src.data() + 3 : nullptr,
+                                             dst->data() + 3, weights.data(), indices.data(), blendMatrices.data(),
+                                             6 * sizeof(float), 6 * sizeof(float), 6 * sizeof(float),
+                                             6 * sizeof(float), numWeights * sizeof(float), numWeights, numWeights,
+                                             NUM_VERTICES);
+            expectNear(result.data(), expected.data(), result.size(), 1e-4f);
+        }
+    }
+
+    // morphing, with and without normals
+    for (bool morphNormals : {false, true})
+    {
+        size_t vertexSize = (morphNormals ? 6 : 3) * sizeof(float);
+        auto from = randomFloats(NUM_VERTICES * vertexSize / sizeof(float));
+        auto to = randomFloats(from.size());
+        std::vector<float> result(from.size()), expected(from.size());
+        for (auto [impl, dst] : {std::pair{general, &expected}, std::pair{util, &result}})
+            impl->softwareVertexMorph(0.3f, from.data(), to.data(), dst->data(), vertexSize, vertexSize, vertexSize,
+                                      NUM_VERTICES, morphNormals);
+        expectNear(result.data(), expected.data(), result.size(), 1e-5f);
+    }
+
+    general->concatenateAffineMatrices(matrices[1], matrices.data(), expectedMatrices.data(), NUM_MATRICES);
+    util->concatenateAffineMatrices(matrices[1], matrices.data(), concatenated.data(), NUM_MATRICES);
+    for (size_t i = 0; i < NUM_MATRICES; ++i)
+        for (size_t r = 0; r < 3; ++r)
+            expectNear(concatenated[i][r], expectedMatrices[i][r], 4, 1e-5f);
+
+    // shadow volumes, from point and directional lights
+    auto positions = randomFloats(NUM_VERTICES * 3);
+    std::vector<EdgeData::Triangle> triangles(NUM_TRIANGLES);
+    for (auto& t : triangles)
+        for (auto& index : t.vertIndex)
+            index = rng() % NUM_VERTICES;
+    aligned_vector<Vector4> faceNormals(NUM_TRIANGLES), expectedNormals(NUM_TRIANGLES);
+    general->calculateFaceNormals(positions.data(), triangles.data(), expectedNormals.data(), NUM_TRIANGLES);
+    util->calculateFaceNormals(positions.data(), triangles.data(), faceNormals.data(), NUM_TRIANGLES);
+    expectNear(faceNormals[0].ptr(), expectedNormals[0].ptr(), 4 * NUM_TRIANGLES, 1e-5f);
+
+    for (Real w : {0, 1})
+    {
+        Vector4 lightPos{dist(rng), dist(rng), dist(rng), w};
+        std::vector<char> facings(NUM_TRIANGLES), expectedFacings(NUM_TRIANGLES);
+        general->calculateLightFacing(lightPos, expectedNormals.data(), expectedFacings.data(), NUM_TRIANGLES);
+        util->calculateLightFacing(lightPos, expectedNormals.data(), facings.data(), NUM_TRIANGLES);
+        EXPECT_EQ(facings, expectedFacings);
+
+        std::vector<float> extruded(positions.size()), expectedExtruded(positions.size());
+        general->extrudeVertices(lightPos, 100, positions.data(), expectedExtruded.data(), NUM_VERTICES);
+        util->extrudeVertices(lightPos, 100, positions.data(), extruded.data(), NUM_VERTICES);
+        expectNear(extruded.data(), expectedExtruded.data(), extruded.size(), 1e-5f);
+    }
+
+    // culling, with boxes on either side of and across the planes
+    std::vector<float> planes;
+    for (int i = 0; i < 6; ++i)
+    {
+        Vector3 normal = Vector3{dist(rng), dist(rng), dist(rng)}.normalisedCopy();
+        planes.insert(planes.end(), {normal.x, normal.y, normal.z, dist(rng)});
+    }
+    auto centreX = randomFloats(NUM_VERTICES), centreY = randomFloats(NUM_VERTICES), centreZ = randomFloats(NUM_VERTICES);
+    std::vector<float> halfSizeX(NUM_VERTICES), halfSizeY(NUM_VERTICES), halfSizeZ(NUM_VERTICES);
+    for (size_t i = 0; i < NUM_VERTICES; ++i)
+    {
+        halfSizeX[i] = Math::Abs(dist(rng)) / 2;
+        halfSizeY[i] = Math::Abs(dist(rng)) / 2;
+        halfSizeZ[i] = Math::Abs(dist(rng)) / 2;
+    }
+    for (size_t numPlanes : {1, 6})
+    {
+        std::vector<uint8> visible(NUM_VERTICES), expectedVisible(NUM_VERTICES);
+        for (auto [impl, dst] : {std::pair{general, &expectedVisible}, std::pair{util, &visible}})
+            impl->cullBoxes(planes.data(), numPlanes, centreX.data(), centreY.data(), centreZ.data(),
+                            halfSizeX.data(), halfSizeY.data(), halfSizeZ.data(), dst->data(), NUM_VERTICES);
+        EXPECT_EQ(visible, expectedVisible);
+    }
+
+    std::vector<float> distances(NUM_VERTICES), expectedDistances(NUM_VERTICES);
+    general->calculatePlaneDistances(planes.data(), centreX.data(), centreY.data(), centreZ.data(),
+                                     expectedDistances.data(), NUM_VERTICES);
+    util->calculatePlaneDistances(planes.data(), centreX.data(), centreY.data(), centreZ.data(), distances.data(),
+                                  NUM_VERTICES);
+    expectNear(distances.data(), expectedDistances.data(), NUM_VERTICES, 1e-5f);
+
+    // particle motion, the half sizes standing in for velocities
+    std::vector<std::vector<float>> moved{centreX, centreY, centreZ}, expectedMoved{centreX, centreY, centreZ};
+    general->integrateArrays(expectedMoved[0].data(), expectedMoved[1].data(), expectedMoved[2].data(),
+                             halfSizeX.data(), halfSizeY.data(), halfSizeZ.data(), 0.25f, NUM_VERTICES);
+    util->integrateArrays(moved[0].data(), moved[1].data(), moved[2].data(), halfSizeX.data(), halfSizeY.data(),
+                          halfSizeZ.data(), 0.25f, NUM_VERTICES);
+    for (size_t c = 0; c < 3; ++c)
+        expectNear(moved[c].data(), expectedMoved[c].data(), NUM_VERTICES, 1e-6f);
+}
+
+TEST(VectorTests, BatchRayIntersection)
+{
+    // a count which is no multiple of the SIMD width, to cover the remainders too
+    constexpr size_t COUNT = 21;
+    Ray ray{Vector3(0.5f, -1, -10), Vector3(0.1f, 0.2f, 1)};
+
+    Real minX[COUNT], minY[COUNT], minZ[COUNT], maxX[COUNT], maxY[COUNT], maxZ[COUNT];
+    Real ax[COUNT], ay[COUNT], az[COUNT], e1x[COUNT], e1y[COUNT], e1z[COUNT], e2x[COUNT], e2y[COUNT], e2z[COUNT];
+    AxisAlignedBox boxes[COUNT];
+    Vector3 corners[COUNT][3];
+    for (size_t i = 0; i < COUNT; ++i)
+    {
+        Real offset = Real(i % 7) - 3;
+        boxes[i] = AxisAlignedBox(Vector3(offset, offset * 0.5f, Real(i)), Vector3(offset + 2, offset + 1, Real(i) + 1));
+        minX[i] = boxes[i].getMinimum().x, minY[i] = boxes[i].getMinimum().y, minZ[i] = boxes[i].getMinimum().z;
+        maxX[i] = boxes[i].getMaximum().x, maxY[i] = boxes[i].getMaximum().y, maxZ[i] = boxes[i].getMaximum().z;
+
+        // wound either way round
+        corners[i][0] = Vector3(offset, -2, Real(i));
+        corners[i][1] = Vector3(offset + 3, -2, Real(i) + 0.5f);
+        corners[i][2] = Vector3(offset, 3, Real(i) - 0.5f);
+        if (i % 2)
+            std::swap(corners[i][1], corners[i][2]);
+        Vector3 e1 = corners[i][1] - corners[i][0], e2 = corners[i][2] - corners[i][0];
+        ax[i] = corners[i][0].x, ay[i] = corners[i][0].y, az[i] = corners[i][0].z;
+        e1x[i] = e1.x, e1y[i] = e1.y, e1z[i] = e1.z;
+        e2x[i] = e2.x, e2y[i] = e2.y, e2z[i] = e2.z;
+    }
+    // the ray starting inside
+    boxes[4] = AxisAlignedBox(Vector3(0, -2, -11), Vector3(1, 0, -9));
+    minX[4] = 0, minY[4] = -2, minZ[4] = -11, maxX[4] = 1, maxY[4] = 0, maxZ[4] = -9;
+
+    Real distances[COUNT];
+    Math::intersects(ray, Math::BoxArrays{minX, minY, minZ, maxX, maxY, maxZ}, COUNT, distances);
+    for (size_t i = 0; i < COUNT; ++i)
+    {
+        RayTestResult expected = Math::intersects(ray, boxes[i]);
+        if (expected.first)
+            EXPECT_NEAR(distances[i], expected.second, 1e-4f) << i;
+        else
+            EXPECT_EQ(distances[i], Math::POS_INFINITY) << i;
+    }
+
+    Math::TriangleArrays triangles{ax, ay, az, e1x, e1y, e1z, e2x, e2y, e2z};
+    for (auto [positiveSide, negativeSide] : {std::pair{true, true}, {true, false}, {false, true}})
+    {
+        Math::intersects(ray, triangles, COUNT, distances, positiveSide, negativeSide);
+        for (size_t i = 0; i < COUNT; ++i)
+        {
+            RayTestResult expected =
+                Math::intersects(ray, corners[i][0], corners[i][1], corners[i][2], positiveSide, negativeSide);
+            if (expected.first)
+                EXPECT_NEAR(distances[i], expected.second, 1e-4f) << i;
+            else
+                EXPECT_EQ(distances[i], Math::POS_INFINITY) << i;
+        }
+    }
+}
@@ -36,9 +36,11 @@ import :Core.ZipArchive;
 
 import Ogre.Core;
 
+import <atomic>;
 import <format>;
 import <map>;
 import <string>;
+import <thread>;
 import <utility>;
 import <vector>;
 
@@ -255,3 +257,34 @@ TEST_F(ZipArchiveTests,ReadInterleave)
     EXPECT_TRUE(stream2->eof());
 }
 //--------------------------------------------------------------------------
+TEST_F(ZipArchiveTests,ConcurrentRead)
+{
+    std::vector<String> expected;
+    for (auto name : {"rootfile.txt", "rootfile2.txt"})
+        expected.push_back(arch->open(name)->getAsString());
+
+    // streams outlive the archive data they were opened from
+    DataStreamPtr early = arch->open("rootfile.txt");
+
+    std::atomic<int> mismatches{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t)
+    {
+        threads.emplace_back([&, t]()
+        {
+            for (int i = 0; i < 100; ++i)
+            {
+                size_t f = (t + i) % 2;
+                if (arch->open(f ? "rootfile2.txt" : "rootfile.txt")->getAsString() != expected[f])
+                    ++mismatches;
+            }
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+    EXPECT_EQ(0, mismatches);
+
+    arch->unload();
+    EXPECT_EQ(expected[0], early->getAsString());
+}
+//--------------------------------------------------------------------------
@@ -181,3 +181,43 @@ TEST(CPreprocessorTests, MacroConcat)
     EXPECT_EQ(str, "HelloWorld");
     free(out);
 }
+TEST(GLSLPreprocessorCacheTests, PassThrough)
+{
+    GLSLPreprocessorCache::Macros macros{{"__VERSION__", "330"}, {"OGRE_GLSL", "330"}, {"OGRE_VERTEX_SHADER", "1"}};
+
+    EXPECT_TRUE(GLSLPreprocessorCache::isPassThrough("#version 330\n#extension GL_ARB_foo : enable\n"
+                                                     "  # line 5\nvoid main() { OGRE_GLSLX = 1; }", macros));
+    EXPECT_FALSE(GLSLPreprocessorCache::isPassThrough("#version 330\n #ifdef FOO\n#endif\n", macros));
+    EXPECT_FALSE(GLSLPreprocessorCache::isPassThrough("void main() { int v = OGRE_GLSL; }", macros));
+}
+TEST(GLSLPreprocessorCacheTests, ReusesOutput)
+{
+    GLSLPreprocessorCache cache;
+    GLSLPreprocessorCache::Macros macros{{"OGRE_VERTEX_SHADER", "1"}};
+    String src = "#ifdef OGRE_VERTEX_SHADER\nvertex\n#else\nfragment\n#endif\n";
+    String passThrough = "#version 330\nvoid main() {}\n";
+
+    String out = cache.preprocess(src, macros, "test");
+    std::string_view trimmed = out;
+    StringUtil::trim(trimmed);
+    EXPECT_EQ(trimmed, "vertex");
+    EXPECT_EQ(cache.getSourceCount(), 0u);
+
+    cache.setEnabled(true);
+    EXPECT_EQ(cache.preprocess(src, macros, "test"), out);
+    EXPECT_EQ(cache.preprocess(src, macros, "test"), out);
+    EXPECT_EQ(cache.getSourceCount(), 1u);
+
+    // other macros, other output
+    String fragment = cache.preprocess(src, {}, "test");
+    trimmed = fragment;
+    StringUtil::trim(trimmed);
+    EXPECT_EQ(trimmed, "fragment");
+    EXPECT_EQ(cache.getSourceCount(), 2u);
+
+    EXPECT_EQ(cache.preprocess(passThrough, macros, "test"), passThrough);
+    EXPECT_EQ(cache.getSourceCount(), 2u);
+
+    cache.setEnabled(false);
+    EXPECT_EQ(cache.getSourceCount(), 0u);
+}
@@ -6,6 +6,7 @@ export import :Core.MeshSerializer;
 export import :Core.MeshWithoutIndexData;
 export import :Core.PixelFormat;
 export import :Core.RadixSort;
+export import :Core.RecordingRenderSystem;
 export import :Core.RenderSystemCapabilities;
 export import :Core.ResourceLocationPriority;
 export import :Core.RootWithoutRenderSystemFixture;
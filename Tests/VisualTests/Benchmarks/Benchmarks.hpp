@@ -0,0 +1,4 @@
+export module Ogre.Tests.VisualTests.Benchmarks;
+
+export import :Plugin;
+export import :Scenes;
@@ -0,0 +1,108 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+export module Ogre.Tests.VisualTests.Benchmarks:Scenes;
+
+export import Ogre.Core;
+export import Ogre.Tests.VisualTests.Common;
+
+using namespace Ogre;
+//---------------------------------------------------------------------------
+/** 100k static entities, mostly stresses the culling */
+
+export
+class Benchmark_StaticEntities : public FrameBenchmark
+{
+public:
+
+    Benchmark_StaticEntities();
+
+protected:
+
+    void setupContent() override;
+
+};
+//---------------------------------------------------------------------------
+/** A crowd of 2k skeletally animated robots */
+
+export
+class Benchmark_SkinnedCrowd : public FrameBenchmark
+{
+public:
+
+    Benchmark_SkinnedCrowd();
+
+protected:
+
+    void setupContent() override;
+
+};
+//---------------------------------------------------------------------------
+/** 100 spotlights casting texture shadows onto a field of objects */
+
+export
+class Benchmark_ShadowedLights : public FrameBenchmark
+{
+public:
+
+    Benchmark_ShadowedLights();
+
+protected:
+
+    void setupContent() override;
+
+};
+//---------------------------------------------------------------------------
+/** 50 particle systems */
+
+export
+class Benchmark_ParticleSystems : public FrameBenchmark
+{
+public:
+
+    Benchmark_ParticleSystems();
+
+protected:
+
+    void setupContent() override;
+
+};
+//---------------------------------------------------------------------------
+/** A scene rendered through a chain of post processing compositors */
+
+export
+class Benchmark_CompositorChain : public FrameBenchmark
+{
+public:
+
+    Benchmark_CompositorChain();
+
+protected:
+
+    void setupContent() override;
+
+};
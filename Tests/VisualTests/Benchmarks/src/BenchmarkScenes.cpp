@@ -0,0 +1,244 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+module Ogre.Tests.VisualTests.Benchmarks;
+
+import :Scenes;
+
+import Ogre.Core;
+
+import <format>;
+
+using namespace Ogre;
+
+namespace {
+    /** A lit ground plane of the given size at y = 0 */
+    void createGround(SceneManager* sceneMgr, Real size)
+    {
+        Plane plane{Vector3::UNIT_Y, 0};
+        MeshManager::getSingleton().createPlane("BenchmarkGround", TRANSIENT_RESOURCE_GROUP, plane,
+            size, size, 20, 20, true, 1, size / 200, size / 200, Vector3::UNIT_Z);
+        Entity* ground = sceneMgr->createEntity("BenchmarkGround", "BenchmarkGround");
+        ground->setMaterialName("Examples/Rocky");
+        ground->setCastShadows(false);
+        sceneMgr->getRootSceneNode()->createChildSceneNode()->attachObject(ground);
+    }
+
+    void createSunLight(SceneManager* sceneMgr)
+    {
+        sceneMgr->setAmbientLight(ColourValue{0.3, 0.3, 0.3});
+
+        Light* light = sceneMgr->createLight("Sun", Light::LightTypes::DIRECTIONAL);
+        light->setDiffuseColour(0.8f, 0.8f, 0.75f);
+        SceneNode* node = sceneMgr->getRootSceneNode()->createChildSceneNode();
+        node->setDirection(Vector3{-1, -2, -1}.normalisedCopy());
+        node->attachObject(light);
+    }
+}
+
+//---------------------------------------------------------------------------
+Benchmark_StaticEntities::Benchmark_StaticEntities()
+{
+    mInfo["Title"] = "Benchmark_StaticEntities";
+    mInfo["Description"] = "100k static entities.";
+}
+
+//---------------------------------------------------------------------------
+void Benchmark_StaticEntities::setupContent()
+{
+    createSunLight(mSceneMgr);
+
+    // a field of 400 x 250 knots
+    const int width = 400, depth = 250;
+    const Real spacing = 25;
+    for (int z = 0; z < depth; ++z)
+    {
+        for (int x = 0; x < width; ++x)
+        {
+            Entity* ent = mSceneMgr->createEntity("knot.mesh");
+            ent->setMaterialName("Examples/RustySteel");
+            SceneNode* node = mSceneMgr->getRootSceneNode()->createChildSceneNode(
+                Vector3{(x - width / 2) * spacing, 10, (z - depth / 2) * spacing});
+            node->setScale(0.1, 0.1, 0.1);
+            node->attachObject(ent);
+        }
+    }
+
+    setCameraOrbit(Vector3::ZERO, 2500, 600);
+}
+
+//---------------------------------------------------------------------------
+Benchmark_SkinnedCrowd::Benchmark_SkinnedCrowd()
+{
+    mInfo["Title"] = "Benchmark_SkinnedCrowd";
+    mInfo["Description"] = "A crowd of 2k skinned robots.";
+}
+
+//---------------------------------------------------------------------------
+void Benchmark_SkinnedCrowd::setupContent()
+{
+    createSunLight(mSceneMgr);
+    createGround(mSceneMgr, 4000);
+
+    // 50 x 40 robots, walking out of step
+    const int width = 50, depth = 40;
+    const Real spacing = 60;
+    for (int z = 0; z < depth; ++z)
+    {
+        for (int x = 0; x < width; ++x)
+        {
+            Entity* ent = mSceneMgr->createEntity("robot.mesh");
+            SceneNode* node = mSceneMgr->getRootSceneNode()->createChildSceneNode(
+                Vector3{(x - width / 2) * spacing, 0, (z - depth / 2) * spacing});
+            node->yaw(Degree{Real((x * 37 + z * 11) % 360)});
+            node->attachObject(ent);
+
+            AnimationState* animState = ent->getAnimationState("Walk");
+            animState->setEnabled(true);
+            animState->setTimePosition(animState->getLength() * Real((x + z * width) % 16) / 16);
+            mAnimStateList.push_back(animState);
+        }
+    }
+
+    setCameraOrbit(Vector3::ZERO, 1200, 300);
+}
+
+//---------------------------------------------------------------------------
+Benchmark_ShadowedLights::Benchmark_ShadowedLights()
+{
+    mInfo["Title"] = "Benchmark_ShadowedLights";
+    mInfo["Description"] = "100 spotlights casting texture shadows.";
+}
+
+//---------------------------------------------------------------------------
+void Benchmark_ShadowedLights::setupContent()
+{
+    mSceneMgr->setAmbientLight(ColourValue{0.1, 0.1, 0.1});
+
+    mSceneMgr->setShadowTechnique(ShadowTechnique::TEXTURE_ADDITIVE);
+    mSceneMgr->setShadowTextureSettings(512, 100);
+    mSceneMgr->setShadowFarDistance(3000);
+
+    createGround(mSceneMgr, 3000);
+
+    const int count = 10;
+    const Real spacing = 250;
+    for (int z = 0; z < count; ++z)
+    {
+        for (int x = 0; x < count; ++x)
+        {
+            Vector3 pos{(x - count / 2 + 0.5f) * spacing, 0, (z - count / 2 + 0.5f) * spacing};
+
+            Entity* ent = mSceneMgr->createEntity((x + z) % 2 ? "ogrehead.mesh" : "knot.mesh");
+            ent->setCastShadows(true);
+            SceneNode* node = mSceneMgr->getRootSceneNode()->createChildSceneNode(pos + Vector3{0, 60, 0});
+            node->setScale(0.5, 0.5, 0.5);
+            node->attachObject(ent);
+
+            // one spotlight above every object, slightly off centre for longer shadows
+            Light* light = mSceneMgr->createLight(std::format("Spot{}", x + z * count), Light::LightTypes::SPOTLIGHT);
+            light->setDiffuseColour(0.3f + 0.07f * x, 0.3f + 0.07f * z, 0.6f);
+            light->setSpecularColour(0, 0, 0);
+            light->setAttenuation(800, 1, 0.002, 0);
+            light->setSpotlightRange(Degree{40}, Degree{60});
+            light->setCastShadows(true);
+            SceneNode* lightNode = mSceneMgr->getRootSceneNode()->createChildSceneNode(pos + Vector3{60, 400, 60});
+            lightNode->setDirection(Vector3{-0.15, -1, -0.15}.normalisedCopy(), Node::TransformSpace::WORLD);
+            lightNode->attachObject(light);
+        }
+    }
+
+    setCameraOrbit(Vector3::ZERO, 1400, 700);
+}
+
+//---------------------------------------------------------------------------
+Benchmark_ParticleSystems::Benchmark_ParticleSystems()
+{
+    mInfo["Title"] = "Benchmark_ParticleSystems";
+    mInfo["Description"] = "50 particle systems.";
+}
+
+//---------------------------------------------------------------------------
+void Benchmark_ParticleSystems::setupContent()
+{
+    createSunLight(mSceneMgr);
+    createGround(mSceneMgr, 3000);
+
+    // two rings of fountains and smoke
+    const int count = 50;
+    for (int i = 0; i < count; ++i)
+    {
+        ParticleSystem* psys = mSceneMgr->createParticleSystem(std::format("Particles{}", i),
+            i % 2 ? "Examples/Smoke" : "Examples/PurpleFountain");
+
+        Radian angle{Math::TWO_PI * i / count};
+        Real radius = i % 2 ? 600 : 300;
+        mSceneMgr->getRootSceneNode()->createChildSceneNode(
+            Vector3{radius * Math::Cos(angle), 0, radius * Math::Sin(angle)})->attachObject(psys);
+    }
+
+    setCameraOrbit(Vector3{0, 100, 0}, 1000, 400);
+}
+
+//---------------------------------------------------------------------------
+Benchmark_CompositorChain::Benchmark_CompositorChain()
+{
+    mInfo["Title"] = "Benchmark_CompositorChain";
+    mInfo["Description"] = "A scene rendered through a chain of post processing compositors.";
+}
+
+//---------------------------------------------------------------------------
+void Benchmark_CompositorChain::setupContent()
+{
+    createSunLight(mSceneMgr);
+    createGround(mSceneMgr, 2000);
+
+    const int count = 20;
+    const Real spacing = 80;
+    for (int z = 0; z < count; ++z)
+    {
+        for (int x = 0; x < count; ++x)
+        {
+            Entity* ent = mSceneMgr->createEntity("ogrehead.mesh");
+            SceneNode* node = mSceneMgr->getRootSceneNode()->createChildSceneNode(
+                Vector3{(x - count / 2) * spacing, 30, (z - count / 2) * spacing});
+            node->setScale(0.8, 0.8, 0.8);
+            node->attachObject(ent);
+        }
+    }
+
+    // each one adds full screen passes, Bloom and Gaussian Blur several at reduced size
+    CompositorManager& compositors = CompositorManager::getSingleton();
+    for (auto name : {"Bloom", "Gaussian Blur", "Radial Blur", "Sharpen Edges", "Posterize", "Old TV"})
+    {
+        compositors.addCompositor(mViewport, name);
+        compositors.setCompositorEnabled(mViewport, name, true);
+    }
+
+    setCameraOrbit(Vector3::ZERO, 900, 300);
+}
+//-----------------------------------------------------------------------
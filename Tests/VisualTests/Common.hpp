@@ -1,6 +1,7 @@
 export module Ogre.Tests.VisualTests.Common;
 
 export import :CppUnitResultWriter;
+export import :FrameBenchmark;
 export import :HTMLWriter;
 export import :ImageValidator;
 export import :TestBatch;
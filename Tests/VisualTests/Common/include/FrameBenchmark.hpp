@@ -0,0 +1,263 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+module;
+
+#include <cmath>
+#include <cstddef>
+
+export module Ogre.Tests.VisualTests.Common:FrameBenchmark;
+
+export import :VisualTest;
+
+export import Ogre.Core;
+export import Ogre.Samples;
+
+import <algorithm>;
+import <array>;
+import <format>;
+import <fstream>;
+import <string>;
+import <string_view>;
+import <vector>;
+
+/** The base class for a benchmark scene
+
+    Instead of taking screenshots, a benchmark plays back a camera path as a function
+    of the frame number. Along with the fixed timestep and the seeded rand of the
+    TestContext every run renders the same frames, so runs of different engine builds
+    can be compared.
+
+    After some warm up frames the CPU time of the frame, the time of the render loop
+    stages and the GPU time are recorded every frame. When the path has been played
+    back, their 50th, 95th and 99th percentiles in milliseconds are written to the log
+    and, if set, to the result file as JSON.
+    @remarks
+        The stage times are the counters Root publishes while the Profiler is enabled,
+        see SceneManager::RenderLoopStats, so the Profiler is enabled while the
+        benchmark runs. GPU times are only available if the build has profiling enabled
+        and the RenderSystem supports timing its profile events. As GPU timings arrive
+        some frames late, they lag behind the CPU times.
+*/
+export
+class FrameBenchmark : public VisualTest
+{
+ public:
+
+    /** @param warmupFrames Frames rendered before recording, to let caches, shaders and
+            particle systems settle
+        @param measuredFrames Frames recorded, the duration of the camera path */
+    FrameBenchmark(int warmupFrames = 60, int measuredFrames = 600)
+        : mWarmupFrames(warmupFrames), mMeasuredFrames(measuredFrames)
+    {
+        mInfo["Category"] = "Benchmarks";
+        for (auto& samples : mSamples)
+            samples.reserve(measuredFrames);
+    }
+
+    /** Sets the file the percentiles are written to as JSON, none by default */
+    void setResultFile(std::string_view path) { mResultFile = path; }
+
+    /** set up the camera and enable the profiler for the stage timings */
+    void setupView() override
+    {
+        VisualTest::setupView();
+
+        Ogre::Profiler& profiler = Ogre::Profiler::getSingleton();
+        mProfilerEnabled = profiler.getEnabled();
+        mProfilerGPUTiming = profiler.getGPUTiming();
+        profiler.setEnabled(true);
+        profiler.setGPUTiming(true);
+
+        mFrame = 0;
+        for (auto& samples : mSamples)
+            samples.clear();
+    }
+
+    void _shutdown() override
+    {
+        Ogre::Profiler& profiler = Ogre::Profiler::getSingleton();
+        profiler.setGPUTiming(mProfilerGPUTiming);
+        profiler.setEnabled(mProfilerEnabled);
+
+        VisualTest::_shutdown();
+    }
+
+    /** Advances the animations and moves the camera along the path */
+    auto frameStarted(const Ogre::FrameEvent& evt) noexcept -> bool override
+    {
+        VisualTest::frameStarted(evt);
+        updateCameraPath(Ogre::Real(mFrame) / Ogre::Real(mWarmupFrames + mMeasuredFrames));
+        ++mFrame;
+        return true;
+    }
+
+    /** Records the timings, Root publishes them right before this is called */
+    auto frameRenderingQueued(const Ogre::FrameEvent& evt) noexcept -> bool override
+    {
+        if (mFrame > mWarmupFrames)
+            recordFrame();
+        return true;
+    }
+
+    /** No screenshots, reports the percentiles when the path has been played back */
+    auto isScreenshotFrame(int frame) -> bool override
+    {
+        if (!mDone && frame >= mWarmupFrames + mMeasuredFrames)
+        {
+            report();
+            mDone = true;
+        }
+        return false;
+    }
+
+ protected:
+
+    /** Sets the default camera path, an orbit around centre at the given radius and height */
+    void setCameraOrbit(const Ogre::Vector3& centre, Ogre::Real radius, Ogre::Real height)
+    {
+        mOrbitCentre = centre;
+        mOrbitRadius = radius;
+        mOrbitHeight = height;
+    }
+
+    /** Places the camera on its path
+        @param t The progress along the path, from 0 at the start of the warm up to 1
+            at the last recorded frame */
+    virtual void updateCameraPath(Ogre::Real t)
+    {
+        Ogre::Radian angle{t * Ogre::Math::TWO_PI};
+        mCameraNode->setPosition(mOrbitCentre + Ogre::Vector3{mOrbitRadius * Ogre::Math::Cos(angle), mOrbitHeight,
+                                                              mOrbitRadius * Ogre::Math::Sin(angle)});
+        mCameraNode->lookAt(mOrbitCentre, Ogre::Node::TransformSpace::WORLD);
+    }
+
+ private:
+    /// the name in the report and the counter of a stage, counters with a leading '/'
+    /// belong to the SceneManager of the sample
+    struct Stage
+    {
+        std::string_view name;
+        std::string_view counter;
+    };
+    static constexpr std::array<Stage, 7> STAGES{{
+        {"cpu", "Frame/cpuMicroseconds"},
+        {"update", "/updateMicroseconds"},
+        {"cull", "/cullMicroseconds"},
+        {"shadow", "/shadowMicroseconds"},
+        {"sort", "/sortMicroseconds"},
+        {"submit", "/submitMicroseconds"},
+        {"compositor", "/compositorMicroseconds"},
+    }};
+
+    struct Percentiles
+    {
+        double p50, p95, p99;
+    };
+
+    void recordFrame()
+    {
+        const Ogre::Profiler& profiler = Ogre::Profiler::getSingleton();
+        const auto& counters = profiler.getCounters();
+
+        for (size_t i = 0; i < STAGES.size(); ++i)
+        {
+            auto name = STAGES[i].counter.starts_with('/')
+                ? std::format("{}{}", mSceneMgr->getName(), STAGES[i].counter)
+                : std::string{STAGES[i].counter};
+            auto it = counters.find(name);
+            mSamples[i].push_back(it != counters.end() ? double(it->second) / 1000.0 : 0.0);
+        }
+        mSamples.back().push_back(profiler.getGPUFrameTime());
+    }
+
+    /// nearest rank percentiles
+    static auto percentiles(std::vector<double> samples) -> Percentiles
+    {
+        if (samples.empty())
+            return {0, 0, 0};
+
+        std::ranges::sort(samples);
+        auto rank = [&](double p)
+        {
+            auto n = size_t(std::ceil(p / 100.0 * double(samples.size())));
+            return samples[std::clamp<size_t>(n, 1, samples.size()) - 1];
+        };
+        return {rank(50), rank(95), rank(99)};
+    }
+
+    void report()
+    {
+        std::string_view title = mInfo["Title"];
+        std::string json = std::format(R"({{"name": "{}", "frames": {}, "timestep": {}, "stages": {{)", title,
+                                       mSamples.front().size(), Ogre::ControllerManager::getSingleton().getFrameDelay());
+
+        for (size_t i = 0; i < mSamples.size(); ++i)
+        {
+            // without GPU timing there is nothing to report
+            bool gpu = i == STAGES.size();
+            if (gpu && std::ranges::all_of(mSamples[i], [](double ms) { return ms == 0; }))
+                continue;
+
+            std::string_view name = gpu ? "gpu" : STAGES[i].name;
+            Percentiles p = percentiles(mSamples[i]);
+            Ogre::LogManager::getSingleton().logMessage(
+                std::format("FrameBenchmark {} {}: p50 {:.3f} ms, p95 {:.3f} ms, p99 {:.3f} ms", title, name,
+                            p.p50, p.p95, p.p99));
+            json += std::format(R"({}"{}": {{"p50": {:.4f}, "p95": {:.4f}, "p99": {:.4f}}})", i ? ", " : "", name,
+                                p.p50, p.p95, p.p99);
+        }
+        json += "}}\n";
+
+        if (mResultFile.empty())
+            return;
+
+        std::ofstream file{mResultFile};
+        if (!file)
+        {
+            Ogre::LogManager::getSingleton().logError(std::format("FrameBenchmark could not write {}", mResultFile));
+            return;
+        }
+        file << json;
+    }
+
+    int mWarmupFrames;
+    int mMeasuredFrames;
+    int mFrame{0};
+
+    Ogre::Vector3 mOrbitCentre{Ogre::Vector3::ZERO};
+    Ogre::Real mOrbitRadius{500};
+    Ogre::Real mOrbitHeight{200};
+
+    /// the recorded milliseconds of each stage, followed by the GPU
+    std::array<std::vector<double>, STAGES.size() + 1> mSamples;
+
+    std::string mResultFile;
+
+    bool mProfilerEnabled{false};
+    bool mProfilerGPUTiming{false};
+};
@@ -36,6 +36,7 @@ import Ogre.Components.Bites;
 import Ogre.Components.Overlay;
 import Ogre.Core;
 import Ogre.Samples;
+import Ogre.Tests.VisualTests.Benchmarks;
 import Ogre.Tests.VisualTests.Common;
 import Ogre.Tests.VisualTests.PlayPen;
 import Ogre.Tests.VisualTests.VTests;
@@ -128,8 +129,16 @@ void TestContext::setup()
     Ogre::TextureManager::getSingleton().setDefaultNumMipmaps(Ogre::TextureMipmap{5});
     mRoot->addFrameListener(this);
 
-    mPluginNameMap.emplace("VTests", new VTestPlugin());
-    mPluginNameMap.emplace("PlayPenTests", new PlaypenTestPlugin());
+    // the benchmarks take long and produce timings instead of images, so they run on their own
+    if (mTestSetName == "Benchmarks")
+    {
+        mPluginNameMap.emplace("Benchmarks", new FrameBenchmarkPlugin());
+    }
+    else
+    {
+        mPluginNameMap.emplace("VTests", new VTestPlugin());
+        mPluginNameMap.emplace("PlayPenTests", new PlaypenTestPlugin());
+    }
 
     Ogre::String batchName = "";
     time_t raw = time(nullptr);
@@ -297,6 +306,10 @@ void TestContext::runSample(OgreBites::Sample* sampleToRun)
     // Give a fixed timestep for particles and other time-dependent things in OGRE
     Ogre::ControllerManager::getSingleton().setFrameDelay(mTimestep);
 
+    // benchmarks write their timings next to the screenshots
+    if (auto benchmark = dynamic_cast<FrameBenchmark*>(sampleToRun))
+        benchmark->setResultFile(std::format("{}{}/{}.json", mOutputDir, mBatch->name, sampleToRun->getInfo()["Title"]));
+
     if(sampleToRun)
         LogManager::getSingleton().logMessage(
             ::std::format("----- Running Visual Test {} -----", sampleToRun->getInfo()["Title"]));
@@ -336,7 +349,7 @@ void TestContext::go(OgreBites::Sample* initialSample, ulong frameCount)
         std::cout<<"\t-d           Force config dialog.\n";
         std::cout<<"\t-h, --help   Show usage details.\n";
         std::cout<<"\t-m [comment] Optional comment.\n";
-        std::cout<<"\t-ts [name]   Name of the test set to use.\n";
+        std::cout<<"\t-ts [name]   Name of the test set to use, Benchmarks for the frame benchmarks.\n";
         std::cout<<"\t-c [name]    Name of the test result batch to compare against.\n";
         std::cout<<"\t-n [name]    Name for this result image set.\n";
         std::cout<<"\t-rs [name]   Render system to use.\n";
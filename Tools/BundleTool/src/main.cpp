@@ -0,0 +1,117 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+import Ogre.Core;
+
+import <charconv>;
+import <iostream>;
+import <string>;
+import <string_view>;
+
+namespace
+{
+    void printUsage()
+    {
+        std::cout << "Usage: OgreBundleTool [options] <source directory> <bundle>\n\n"
+                     "Packs all files below the source directory into a bundle, which is\n"
+                     "added as a resource location of type 'Bundle'.\n\n"
+                     "  -z                   deflate the files\n"
+                     "  -a <bytes>           payload alignment, a power of two (default 65536)\n"
+                     "  -d <type>:<name>     declare a resource when the bundle is added\n";
+    }
+}
+
+auto main(int argc, char** argv) -> int
+{
+    bool compress = false;
+    size_t alignment = Ogre::BundleWriter::DEFAULT_ALIGNMENT;
+    Ogre::ArchiveResourceDeclarationList declarations;
+    std::string_view source, target;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string_view arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "-z")
+            compress = true;
+        else if (arg == "-a" && hasValue)
+        {
+            std::string_view value = argv[++i];
+            std::from_chars(value.data(), value.data() + value.size(), alignment);
+        }
+        else if (arg == "-d" && hasValue)
+        {
+            std::string_view value = argv[++i];
+            auto colon = value.find(':');
+            if (colon == std::string_view::npos)
+            {
+                printUsage();
+                return 1;
+            }
+            declarations.push_back({std::string{value.substr(colon + 1)}, std::string{value.substr(0, colon)}});
+        }
+        else if (source.empty())
+            source = arg;
+        else if (target.empty())
+            target = arg;
+        else
+        {
+            printUsage();
+            return 1;
+        }
+    }
+
+    if (target.empty())
+    {
+        printUsage();
+        return 1;
+    }
+
+    try
+    {
+        Ogre::FileSystemArchiveFactory factory;
+        Ogre::Archive* archive = factory.createInstance(source, true);
+        archive->load();
+
+        Ogre::BundleWriter writer;
+        writer.setAlignment(alignment);
+        writer.addArchive(archive, compress);
+        for (auto const& dcl : declarations)
+            writer.declareResource(dcl.name, dcl.resourceType);
+        writer.write(target);
+
+        std::cout << "Wrote " << archive->list()->size() << " files to " << target << "\n";
+        factory.destroyInstance(archive);
+    }
+    catch (const Ogre::Exception& e)
+    {
+        std::cerr << e.getFullDescription() << "\n";
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,138 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+import Ogre.Core;
+
+import <charconv>;
+import <iostream>;
+import <string>;
+import <string_view>;
+
+namespace
+{
+    void printUsage()
+    {
+        std::cout << "Usage: OgreMeshLodTool [options] <source mesh> <target mesh>\n\n"
+                     "Replaces the LOD levels of a mesh by generated ones and saves it.\n\n"
+                     "  -l <value>:<reduction>  add a level, value is the LOD strategy value and\n"
+                     "                          reduction the fraction of triangles to remove\n"
+                     "  -s <strategy>           LOD strategy, e.g. distance_sphere or pixel_count\n";
+    }
+
+    auto parseReal(std::string_view value, Ogre::Real& out) -> bool
+    {
+        auto [ptr, ec] = std::from_chars(value.data(), value.data() + value.size(), out);
+        return ec == std::errc{} && ptr == value.data() + value.size();
+    }
+}
+
+auto main(int argc, char** argv) -> int
+{
+    Ogre::MeshLodGenerator::LodLevelList levels;
+    std::string_view strategyName, source, target;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string_view arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "-l" && hasValue)
+        {
+            std::string_view value = argv[++i];
+            auto colon = value.find(':');
+            Ogre::MeshLodGenerator::LodLevel level;
+            if (colon == std::string_view::npos || !parseReal(value.substr(0, colon), level.userValue) ||
+                !parseReal(value.substr(colon + 1), level.reduction))
+            {
+                printUsage();
+                return 1;
+            }
+            levels.push_back(level);
+        }
+        else if (arg == "-s" && hasValue)
+            strategyName = argv[++i];
+        else if (source.empty())
+            source = arg;
+        else if (target.empty())
+            target = arg;
+        else
+        {
+            printUsage();
+            return 1;
+        }
+    }
+
+    if (target.empty() || levels.empty())
+    {
+        printUsage();
+        return 1;
+    }
+
+    try
+    {
+        // the buffers must outlive the meshes the root unloads
+        Ogre::DefaultHardwareBufferManager bufferManager;
+        Ogre::Root root{""};
+        Ogre::MaterialManager::getSingleton().initialise();
+
+        std::string_view baseName, path;
+        Ogre::StringUtil::splitFilename(source, baseName, path);
+        std::string meshName{baseName};
+        Ogre::ResourceGroupManager::getSingleton().addResourceLocation(path.empty() ? "." : path, "FileSystem");
+
+        Ogre::MeshPtr mesh = Ogre::MeshManager::getSingleton().load(
+            meshName, Ogre::ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+        if (!strategyName.empty())
+        {
+            Ogre::LodStrategy* strategy = Ogre::LodStrategyManager::getSingleton().getStrategy(strategyName);
+            if (!strategy)
+            {
+                std::cerr << "Unknown LOD strategy " << strategyName << "\n";
+                return 1;
+            }
+            mesh->setLodStrategy(strategy);
+        }
+
+        Ogre::MeshLodGenerator::generateLodLevels(mesh.get(), levels);
+        Ogre::MeshSerializer{}.exportMesh(mesh.get(), target);
+
+        for (unsigned short l = 1; l < mesh->getNumLodLevels(); ++l)
+        {
+            size_t indexCount = 0;
+            for (auto sub : mesh->getSubMeshes())
+                indexCount += sub->mLodFaceList[l - 1]->indexCount;
+            std::cout << "LOD " << l << ": " << indexCount / 3 << " triangles\n";
+        }
+        std::cout << "Wrote " << target << "\n";
+    }
+    catch (const Ogre::Exception& e)
+    {
+        std::cerr << e.getFullDescription() << "\n";
+        return 1;
+    }
+
+    return 0;
+}